@@ -0,0 +1,247 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+// Times JSONPath, JSON Pointer and JSON Patch operations on generated documents of 1K
+// to 10M nodes, with json and ojson, and reports operations per second and heap
+// allocations per operation.
+//
+// Usage: extension_benchmarks [max nodes]
+//
+// Documents are generated with 1K, 10K, ... nodes up to max nodes (default 1000000),
+// so that 10000000 runs the largest size.
+
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/jsonpath/json_query.hpp>
+#include <jsoncons_ext/jsonpointer/jsonpointer.hpp>
+#include <jsoncons_ext/jsonpatch/jsonpatch.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+// Allocation counting, for the whole program
+
+namespace {
+
+size_t allocation_count = 0;
+size_t allocated_bytes = 0;
+
+}
+
+void* operator new(std::size_t size)
+{
+    ++allocation_count;
+    allocated_bytes += size;
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) JSONCONS_NOEXCEPT
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) JSONCONS_NOEXCEPT
+{
+    std::free(p);
+}
+
+namespace {
+
+// Harness
+
+struct benchmark_result
+{
+    double ops_per_second;
+    double allocations_per_op;
+    double bytes_per_op;
+};
+
+template <class F>
+benchmark_result run_benchmark(F f)
+{
+    const double min_seconds = 0.3;
+
+    f(); // warm up
+
+    size_t iterations = 0;
+    size_t allocations = allocation_count;
+    size_t bytes = allocated_bytes;
+    auto start = std::chrono::high_resolution_clock::now();
+    double seconds = 0;
+    do
+    {
+        f();
+        ++iterations;
+        seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+    while (seconds < min_seconds);
+
+    benchmark_result result;
+    result.ops_per_second = iterations / seconds;
+    result.allocations_per_op = static_cast<double>(allocation_count - allocations) / iterations;
+    result.bytes_per_op = static_cast<double>(allocated_bytes - bytes) / iterations;
+    return result;
+}
+
+void report(const std::string& document, const std::string& name, const benchmark_result& result)
+{
+    std::cout << std::left << std::setw(16) << document
+              << std::setw(52) << name
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(14) << result.ops_per_second << " ops/s"
+              << std::setw(14) << result.allocations_per_op << " allocs/op"
+              << std::setw(16) << result.bytes_per_op << " bytes/op"
+              << std::endl;
+}
+
+// Documents
+
+// An array of items of 10 nodes each: the item, its 5 members, and a tags array of 3 strings
+template <class Json>
+Json generate_document(size_t nodes)
+{
+    const size_t count = (std::max)(nodes / 10, static_cast<size_t>(1));
+    Json items = typename Json::array();
+    items.reserve(count);
+    uint64_t state = 88172645463325252ull;
+    for (size_t i = 0; i < count; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        Json item;
+        item["id"] = i;
+        item["name"] = "item " + std::to_string(i);
+        item["price"] = static_cast<double>(state % 10000) / 100.0;
+        item["active"] = (state & 1) != 0;
+        Json tags = typename Json::array();
+        tags.push_back("red");
+        tags.push_back("green");
+        tags.push_back("blue");
+        item["tags"] = std::move(tags);
+        items.push_back(std::move(item));
+    }
+    Json root;
+    root["items"] = std::move(items);
+    return root;
+}
+
+template <class Json>
+void run_benchmarks(const std::string& type, size_t nodes)
+{
+    const std::string document = type + " " + std::to_string(nodes);
+    Json root = generate_document<Json>(nodes);
+    const size_t middle = root["items"].size() / 2;
+    const std::string item_pointer = "/items/" + std::to_string(middle);
+
+    // JSONPath
+
+    const std::vector<std::string> paths = {"$.items[0].name",
+                                            "$.items[*].id",
+                                            "$..name",
+                                            "$.items[?(@.price > 90)].id"};
+    for (const auto& path : paths)
+    {
+        report(document, "json_query " + path, run_benchmark([&]()
+        {
+            Json result = jsonpath::json_query(root, path);
+        }));
+
+        auto expr = jsonpath::compile<Json>(path);
+        report(document, "compiled " + path, run_benchmark([&]()
+        {
+            Json result = expr.evaluate(root);
+        }));
+    }
+
+    report(document, "json_replace $.items[0].price", run_benchmark([&]()
+    {
+        jsonpath::json_replace(root, "$.items[0].price", 1.5);
+    }));
+
+    report(document, "json_replace $.items[*].active", run_benchmark([&]()
+    {
+        jsonpath::json_replace(root, "$.items[*].active", false);
+    }));
+
+    // JSON Pointer
+
+    report(document, "jsonpointer::get " + item_pointer + "/name", run_benchmark([&]()
+    {
+        auto result = jsonpointer::get(root, item_pointer + "/name");
+    }));
+
+    jsonpointer::json_pointer name_pointer(item_pointer + "/name");
+    report(document, "jsonpointer::get json_pointer", run_benchmark([&]()
+    {
+        auto result = jsonpointer::get(root, name_pointer);
+    }));
+
+    report(document, "jsonpointer::insert and remove member", run_benchmark([&]()
+    {
+        jsonpointer::insert(root, item_pointer + "/extra", Json(1));
+        jsonpointer::remove(root, item_pointer + "/extra");
+    }));
+
+    report(document, "jsonpointer::insert and remove element", run_benchmark([&]()
+    {
+        jsonpointer::insert(root, item_pointer + "/tags/1", Json("yellow"));
+        jsonpointer::remove(root, item_pointer + "/tags/1");
+    }));
+
+    // JSON Patch
+
+    // Leaves the document as it was, so that each run patches the same document
+    Json patch = typename Json::array();
+    Json add;
+    add["op"] = "add";
+    add["path"] = item_pointer + "/extra";
+    add["value"] = "value";
+    patch.push_back(add);
+    Json replace;
+    replace["op"] = "replace";
+    replace["path"] = item_pointer + "/extra";
+    replace["value"] = 2;
+    patch.push_back(replace);
+    Json remove;
+    remove["op"] = "remove";
+    remove["path"] = item_pointer + "/extra";
+    patch.push_back(remove);
+    report(document, "jsonpatch::patch add, replace, remove", run_benchmark([&]()
+    {
+        jsonpatch::patch(root, patch);
+    }));
+
+    Json target = root;
+    target["items"][middle]["name"] = "renamed";
+    target["items"][0]["tags"].push_back("black");
+    target["items"].erase(target["items"].array_range().end() - 1);
+    report(document, "jsonpatch::diff 3 changes", run_benchmark([&]()
+    {
+        Json result = jsonpatch::diff(root, target);
+    }));
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    size_t max_nodes = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 1000000;
+
+    for (size_t nodes = 1000; nodes <= max_nodes; nodes *= 10)
+    {
+        run_benchmarks<json>("json", nodes);
+        run_benchmarks<ojson>("ojson", nodes);
+    }
+}
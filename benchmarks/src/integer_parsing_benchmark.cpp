@@ -0,0 +1,95 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+// Parses arrays of integers with basic_json_parser, reporting MB/s. Build with
+// JSONCONS_NO_INTEGER_ACCUMULATION defined to compare with the buffered conversion.
+
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/json_parser.hpp>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using namespace jsoncons;
+
+namespace {
+
+// Counts values without building a document, so the timings are the parser's
+class counting_handler : public json_input_handler
+{
+public:
+    size_t count = 0;
+private:
+    void do_begin_json() override {}
+    void do_end_json() override {}
+    void do_begin_object(const parsing_context&) override {}
+    void do_end_object(const parsing_context&) override {}
+    void do_begin_array(const parsing_context&) override {}
+    void do_end_array(const parsing_context&) override {}
+    void do_name(const string_view_type&, const parsing_context&) override {}
+    void do_string_value(const string_view_type&, const parsing_context&) override {++count;}
+    void do_integer_value(int64_t, const parsing_context&) override {++count;}
+    void do_uinteger_value(uint64_t, const parsing_context&) override {++count;}
+    void do_byte_string_value(const uint8_t*, size_t, const parsing_context&) override {++count;}
+    void do_double_value(double, uint8_t, const parsing_context&) override {++count;}
+    void do_bool_value(bool, const parsing_context&) override {++count;}
+    void do_null_value(const parsing_context&) override {++count;}
+};
+
+std::string make_array(size_t n, uint64_t modulus, bool negative)
+{
+    std::string s = "[";
+    uint64_t state = 88172645463325252ull;
+    for (size_t i = 0; i < n; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        if (i > 0)
+        {
+            s.push_back(',');
+        }
+        if (negative && (state & 1))
+        {
+            s.push_back('-');
+        }
+        s += std::to_string(modulus == 0 ? state : state % modulus);
+    }
+    s.push_back(']');
+    return s;
+}
+
+void run(const char* name, const std::string& text, size_t repetitions)
+{
+    counting_handler handler;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < repetitions; ++i)
+    {
+        json_parser parser(handler);
+        parser.set_source(text.data(), text.length());
+        parser.parse();
+        parser.end_parse();
+        parser.check_done();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    double mb = static_cast<double>(text.length()) * repetitions / (1024.0 * 1024.0);
+    std::cout << name << ": " << (mb / seconds) << " MB/s, " 
+              << (handler.count / repetitions) << " values" << std::endl;
+}
+
+}
+
+int main()
+{
+#if defined(JSONCONS_NO_INTEGER_ACCUMULATION)
+    std::cout << "Integer digits buffered" << std::endl;
+#else
+    std::cout << "Integer digits accumulated" << std::endl;
+#endif
+    const size_t n = 1000000;
+    run("uint64 ids", make_array(n, 0, false), 10);
+    run("small integers", make_array(n, 10000, true), 10);
+    run("int64", make_array(n, 9223372036854775807ull, true), 10);
+}
@@ -0,0 +1,349 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+// Times parsing, streaming, serializing, CBOR, MessagePack, CSV and JSONPath, and reports
+// MB/s and heap allocations per document.
+//
+// Usage: jsoncons_benchmarks [corpus directory]
+//
+// canada.json, twitter.json and citm_catalog.json are read from the corpus directory
+// (default benchmarks/input) when present, otherwise documents of the same shape are
+// generated, so that runs without the corpora can still be compared with each other.
+
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_reader.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/json_serializer.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/msgpack/msgpack.hpp>
+#include <jsoncons_ext/csv/csv_reader.hpp>
+#include <jsoncons_ext/jsonpath/json_query.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+// Allocation counting, for the whole program
+
+namespace {
+
+size_t allocation_count = 0;
+size_t allocated_bytes = 0;
+
+}
+
+void* operator new(std::size_t size)
+{
+    ++allocation_count;
+    allocated_bytes += size;
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) JSONCONS_NOEXCEPT
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) JSONCONS_NOEXCEPT
+{
+    std::free(p);
+}
+
+namespace {
+
+// Harness
+
+struct benchmark_result
+{
+    double mb_per_second;
+    double allocations_per_iteration;
+    double bytes_per_iteration;
+};
+
+template <class F>
+benchmark_result run_benchmark(size_t input_bytes, F f)
+{
+    const double min_seconds = 0.5;
+
+    f(); // warm up
+
+    size_t iterations = 0;
+    size_t allocations = allocation_count;
+    size_t bytes = allocated_bytes;
+    auto start = std::chrono::high_resolution_clock::now();
+    double seconds = 0;
+    do
+    {
+        f();
+        ++iterations;
+        seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+    while (seconds < min_seconds);
+
+    benchmark_result result;
+    result.mb_per_second = (static_cast<double>(input_bytes) * iterations / (1024.0 * 1024.0)) / seconds;
+    result.allocations_per_iteration = static_cast<double>(allocation_count - allocations) / iterations;
+    result.bytes_per_iteration = static_cast<double>(allocated_bytes - bytes) / iterations;
+    return result;
+}
+
+void report(const std::string& corpus, const std::string& name, const benchmark_result& result)
+{
+    std::cout << std::left << std::setw(18) << corpus
+              << std::setw(48) << name
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << result.mb_per_second << " MB/s"
+              << std::setw(12) << result.allocations_per_iteration << " allocs/doc"
+              << std::setw(14) << result.bytes_per_iteration << " bytes/doc"
+              << std::endl;
+}
+
+// Corpora
+
+struct xorshift
+{
+    uint64_t state;
+
+    explicit xorshift(uint64_t seed)
+        : state(seed)
+    {
+    }
+
+    uint64_t operator()()
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    double uniform()
+    {
+        return static_cast<double>((*this)() >> 11) / 9007199254740992.0;
+    }
+};
+
+// Mostly arrays of coordinate pairs, like canada.json
+std::string generate_canada()
+{
+    xorshift rand(1);
+    std::ostringstream os;
+    os << std::setprecision(15);
+    os << "{\"type\":\"FeatureCollection\",\"features\":[{\"type\":\"Feature\",\"properties\":{\"name\":\"Canada\"},"
+       << "\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[";
+    for (size_t i = 0; i < 480; ++i)
+    {
+        os << (i > 0 ? ",[" : "[");
+        for (size_t j = 0; j < 200; ++j)
+        {
+            os << (j > 0 ? "," : "") << "[" << (-141.0 + 89.0 * rand.uniform()) << "," << (41.0 + 42.0 * rand.uniform()) << "]";
+        }
+        os << "]";
+    }
+    os << "]}}]}";
+    return os.str();
+}
+
+// Objects with many short strings, some non ASCII and escaped, like twitter.json
+std::string generate_twitter()
+{
+    xorshift rand(2);
+    const char* words[] = {"json", "parse", "\\u3053\\u3093\\u306b\\u3061\\u306f", "benchmark", "caf\xc3\xa9",
+                           "\\\"quoted\\\"", "http:\\/\\/example.com\\/", "RT", "@user", "#tag"};
+    std::ostringstream os;
+    os << "{\"statuses\":[";
+    for (size_t i = 0; i < 100; ++i)
+    {
+        os << (i > 0 ? "," : "") << "{\"created_at\":\"Sun Aug 31 00:29:15 +0000 2014\",\"id\":" << (505874924095815681ull + rand() % 1000000)
+           << ",\"text\":\"";
+        for (size_t j = 0; j < 12; ++j)
+        {
+            os << (j > 0 ? " " : "") << words[rand() % 10];
+        }
+        os << "\",\"truncated\":false,\"in_reply_to_status_id\":null,\"user\":{\"id\":" << (rand() % 3000000000ull)
+           << ",\"name\":\"" << words[rand() % 10] << "\",\"screen_name\":\"user" << i
+           << "\",\"followers_count\":" << (rand() % 10000) << ",\"verified\":" << ((rand() & 1) ? "true" : "false")
+           << ",\"profile_background_color\":\"C0DEED\"},\"retweet_count\":" << (rand() % 100)
+           << ",\"favorited\":false,\"entities\":{\"hashtags\":[],\"urls\":[],\"user_mentions\":[{\"screen_name\":\"u\",\"indices\":[0,"
+           << (rand() % 140) << "]}]},\"lang\":\"ja\"}";
+    }
+    os << "],\"search_metadata\":{\"completed_in\":0.087,\"count\":100}}";
+    return os.str();
+}
+
+// Many small objects keyed by integer ids, mostly integers and nulls, like citm_catalog.json
+std::string generate_citm()
+{
+    xorshift rand(3);
+    std::ostringstream os;
+    os << "{\"events\":{";
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        uint64_t id = 138586341 + i;
+        os << (i > 0 ? "," : "") << "\"" << id << "\":{\"description\":null,\"id\":" << id
+           << ",\"logo\":null,\"name\":\"Event " << i << "\",\"subTopicIds\":[" << (337184269 + rand() % 100) << "," << (337184283 + rand() % 100)
+           << "],\"subjectCode\":null,\"subtitle\":null,\"topicIds\":[" << (324846099 + rand() % 100) << "," << (107888604 + rand() % 100) << "]}";
+    }
+    os << "},\"performances\":[";
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        os << (i > 0 ? "," : "") << "{\"eventId\":" << (138586341 + i) << ",\"id\":" << (339887544 + i)
+           << ",\"logo\":\"/images/UE0AAAAACEKo6QAAAAVDSVRN\",\"name\":null,\"prices\":[{\"amount\":" << (90250 + rand() % 1000)
+           << ",\"audienceSubCategoryId\":337100890,\"seatCategoryId\":338937295}],\"seatCategories\":[{\"areas\":[{\"areaId\":205705999,\"blockIds\":[]}],\"seatCategoryId\":338937295}],"
+           << "\"seatMapImage\":null,\"start\":" << (1372701600000ull + rand() % 1000000) << ",\"venueCode\":\"PLEYEL_PLEYEL\"}";
+    }
+    os << "]}";
+    return os.str();
+}
+
+std::string read_file(const std::string& path)
+{
+    std::ifstream is(path, std::ios::binary);
+    if (!is)
+    {
+        return std::string();
+    }
+    std::ostringstream os;
+    os << is.rdbuf();
+    return os.str();
+}
+
+std::string load_corpus(const std::string& dir, const std::string& name, std::string (*generate)())
+{
+    std::string s = read_file(dir + "/" + name);
+    if (s.empty())
+    {
+        s = generate();
+        std::cout << name << " not found in " << dir << ", using a generated document of " << s.length() << " bytes" << std::endl;
+    }
+    return s;
+}
+
+// A CSV table generated from the citm performances
+std::string generate_csv()
+{
+    xorshift rand(4);
+    std::ostringstream os;
+    os << "eventId,id,amount,name,start,venueCode\n";
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        os << (138586341 + i) << "," << (339887544 + i) << "," << (90250 + rand() % 1000) / 100.0
+           << ",\"Event " << i << ", Paris\"," << (1372701600000ull + rand() % 1000000) << ",PLEYEL_PLEYEL\n";
+    }
+    return os.str();
+}
+
+void run_json_benchmarks(const std::string& corpus, const std::string& text, const std::vector<std::string>& paths)
+{
+    const size_t size = text.length();
+
+    report(corpus, "json::parse", run_benchmark(size, [&]()
+    {
+        json j = json::parse(text);
+    }));
+
+    report(corpus, "json_reader", run_benchmark(size, [&]()
+    {
+        std::istringstream is(text);
+        json_decoder<json> decoder;
+        json_reader reader(is, decoder);
+        reader.read();
+    }));
+
+    json j = json::parse(text);
+
+    report(corpus, "serialize compact", run_benchmark(size, [&]()
+    {
+        std::ostringstream os;
+        json_serializer serializer(os);
+        j.dump(serializer);
+    }));
+
+    report(corpus, "serialize pretty", run_benchmark(size, [&]()
+    {
+        std::ostringstream os;
+        json_serializer serializer(os, true);
+        j.dump(serializer);
+    }));
+
+    report(corpus, "encode_cbor", run_benchmark(size, [&]()
+    {
+        std::vector<uint8_t> v = cbor::encode_cbor(j);
+    }));
+
+    std::vector<uint8_t> cbor_bytes = cbor::encode_cbor(j);
+    report(corpus, "decode_cbor", run_benchmark(cbor_bytes.size(), [&]()
+    {
+        json k = cbor::decode_cbor<json>(cbor_bytes);
+    }));
+
+    report(corpus, "encode_msgpack", run_benchmark(size, [&]()
+    {
+        std::vector<uint8_t> v = msgpack::encode_msgpack(j);
+    }));
+
+    std::vector<uint8_t> msgpack_bytes = msgpack::encode_msgpack(j);
+    report(corpus, "decode_msgpack", run_benchmark(msgpack_bytes.size(), [&]()
+    {
+        json k = msgpack::decode_msgpack<json>(msgpack_bytes);
+    }));
+
+    for (const auto& path : paths)
+    {
+        report(corpus, "json_query " + path, run_benchmark(size, [&]()
+        {
+            json result = jsonpath::json_query(j, path);
+        }));
+
+        auto expr = jsonpath::compile<json>(path);
+        report(corpus, "compiled " + path, run_benchmark(size, [&]()
+        {
+            json result = expr.evaluate(j);
+        }));
+
+        report(corpus, "select " + path, run_benchmark(size, [&]()
+        {
+            size_t count = 0;
+            expr.select(j, [&](const json&){++count;});
+        }));
+    }
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    std::string dir = argc > 1 ? argv[1] : "benchmarks/input";
+
+    std::string canada = load_corpus(dir, "canada.json", generate_canada);
+    std::string twitter = load_corpus(dir, "twitter.json", generate_twitter);
+    std::string citm = load_corpus(dir, "citm_catalog.json", generate_citm);
+
+    run_json_benchmarks("canada.json", canada, {"$.features[0].geometry.type"});
+    run_json_benchmarks("twitter.json", twitter, {"$.statuses[*].user.screen_name", "$..id"});
+    run_json_benchmarks("citm_catalog.json", citm, {"$.performances[?(@.eventId > 138587000)].id"});
+
+    std::string csv = generate_csv();
+    csv::csv_parameters params;
+    params.assume_header(true);
+    report("generated.csv", "csv_reader", run_benchmark(csv.length(), [&]()
+    {
+        std::istringstream is(csv);
+        json_decoder<json> decoder;
+        csv::csv_reader reader(is, decoder, params);
+        reader.read();
+    }));
+}
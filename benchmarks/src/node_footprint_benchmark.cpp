@@ -0,0 +1,156 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+// Parses number heavy documents into json and compact_json, reporting the bytes held
+// per value and the time to sum the numbers.
+
+#include <jsoncons/json.hpp>
+#include <jsoncons/compact_json.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+using namespace jsoncons;
+
+namespace {
+
+// Bytes in use, each block keeps its size in front of it
+size_t live_bytes = 0;
+
+}
+
+void* operator new(std::size_t n)
+{
+    void* p = std::malloc(n + 16);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    *static_cast<std::size_t*>(p) = n;
+    live_bytes += n;
+    return static_cast<char*>(p) + 16;
+}
+
+void operator delete(void* p) noexcept
+{
+    if (p != nullptr)
+    {
+        void* block = static_cast<char*>(p) - 16;
+        live_bytes -= *static_cast<std::size_t*>(block);
+        std::free(block);
+    }
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    operator delete(p);
+}
+
+namespace {
+
+uint64_t next(uint64_t& state)
+{
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// Integers and doubles, alternately
+std::string make_numbers(size_t n)
+{
+    std::string s = "[";
+    uint64_t state = 88172645463325252ull;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (i > 0)
+        {
+            s.push_back(',');
+        }
+        uint64_t r = next(state) % 1000000;
+        s += (i & 1) ? std::to_string(r) + ".25" : std::to_string(r);
+    }
+    s.push_back(']');
+    return s;
+}
+
+// Small records, {"id":n,"x":d,"tag":"ab"}
+std::string make_records(size_t n)
+{
+    std::string s = "[";
+    uint64_t state = 88172645463325252ull;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (i > 0)
+        {
+            s.push_back(',');
+        }
+        s += "{\"id\":" + std::to_string(i) + ",\"x\":" + std::to_string(next(state) % 1000) + ".5,\"tag\":\"ab\"}";
+    }
+    s.push_back(']');
+    return s;
+}
+
+template <class Value>
+double sum(const Value& val)
+{
+    if (val.is_number())
+    {
+        return val.as_double();
+    }
+    double total = 0;
+    if (val.is_array())
+    {
+        for (const auto& element : val.elements())
+        {
+            total += sum(element);
+        }
+    }
+    else if (val.is_object())
+    {
+        for (const auto& member : val.members())
+        {
+            total += sum(member.value());
+        }
+    }
+    return total;
+}
+
+template <class Value>
+void run(const char* name, const std::string& text, size_t values)
+{
+    // The footprint is taken from a copy, as json::parse keeps its decoder's stack for reuse
+    Value parsed = Value::parse(text);
+    size_t before = live_bytes;
+    Value val = parsed;
+    size_t bytes = live_bytes - before;
+
+    const size_t repetitions = 10;
+    double total = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < repetitions; ++i)
+    {
+        total += sum(val);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration<double,std::milli>(end - start).count() / repetitions;
+    std::cout << name << ": " << (static_cast<double>(bytes) / values) << " bytes/value held, "
+              << ms << " ms to sum (" << total << ")" << std::endl;
+}
+
+}
+
+int main()
+{
+    const size_t n = 1000000;
+
+    std::string numbers = make_numbers(n);
+    run<json>("json numbers", numbers, n);
+    run<compact_json>("compact_json numbers", numbers, n);
+
+    std::string records = make_records(n/4);
+    run<json>("json records", records, n);
+    run<compact_json>("compact_json records", records, n);
+}
@@ -0,0 +1,343 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+// Runs independent parsers on 1, 2, 4, ... threads at once, and reports how throughput
+// scales with the number of threads, for four ways of allocating the result:
+//
+//   default       json, with std::allocator, so every thread allocates from the global heap
+//   arena         a json with an arena_allocator, with an arena per thread released after each document
+//   fixed buffer  a json whose allocator bumps a pointer through a buffer per thread,
+//                 allocated once and reused for every document
+//   pool          a json with a pool_allocator, with size class free lists cached per thread
+//
+// Usage: parallel_parse_benchmark [max threads]
+//
+// max threads defaults to std::thread::hardware_concurrency(). Throughput that stops growing
+// with threads while the fixed buffer keeps scaling points to contention in the heap.
+
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_parser.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/arena_allocator.hpp>
+#include <jsoncons/pool_allocator.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace jsoncons;
+
+namespace {
+
+// A buffer allocated once per thread, and a stateful allocator that bumps a pointer through it.
+// Deallocation does nothing, and reset makes the whole buffer available again.
+
+struct fixed_buffer
+{
+    std::vector<char> data;
+    size_t used;
+
+    explicit fixed_buffer(size_t capacity)
+        : data(capacity), used(0)
+    {
+    }
+
+    void* allocate(size_t n, size_t alignment)
+    {
+        size_t offset = (used + alignment - 1) / alignment * alignment;
+        if (offset + n > data.size())
+        {
+            throw std::bad_alloc();
+        }
+        used = offset + n;
+        return data.data() + offset;
+    }
+
+    void reset()
+    {
+        used = 0;
+    }
+};
+
+template <class T>
+class fixed_buffer_allocator
+{
+    template <class U> friend class fixed_buffer_allocator;
+
+    fixed_buffer* buffer_;
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    template <class U>
+    struct rebind
+    {
+        typedef fixed_buffer_allocator<U> other;
+    };
+
+    fixed_buffer_allocator(fixed_buffer& buffer) JSONCONS_NOEXCEPT
+        : buffer_(&buffer)
+    {
+    }
+
+    template <class U>
+    fixed_buffer_allocator(const fixed_buffer_allocator<U>& other) JSONCONS_NOEXCEPT
+        : buffer_(other.buffer_)
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(buffer_->allocate(n*sizeof(T), JSONCONS_ALIGNOF(T)));
+    }
+
+    void deallocate(T*, size_t) JSONCONS_NOEXCEPT
+    {
+    }
+
+    template <class U>
+    bool operator==(const fixed_buffer_allocator<U>& other) const JSONCONS_NOEXCEPT
+    {
+        return buffer_ == other.buffer_;
+    }
+
+    template <class U>
+    bool operator!=(const fixed_buffer_allocator<U>& other) const JSONCONS_NOEXCEPT
+    {
+        return buffer_ != other.buffer_;
+    }
+};
+
+typedef basic_json<char,sorted_policy,arena_allocator<char>> arena_json;
+typedef basic_json<char,sorted_policy,fixed_buffer_allocator<char>> fixed_buffer_json;
+typedef basic_json<char,sorted_policy,pool_allocator<char>> pool_json;
+
+// Parses text into a Json built with allocator
+template <class Json>
+void parse(const std::string& text, const typename Json::allocator_type& allocator)
+{
+    json_decoder<Json> decoder(allocator);
+    json_parser parser(decoder);
+    parser.set_source(text.data(), text.length());
+    parser.parse();
+    parser.end_parse();
+    parser.check_done();
+    Json j = decoder.get_result();
+}
+
+enum class allocation_mode {default_heap, arena, fixed_buffer, pool};
+
+const char* mode_name(allocation_mode mode)
+{
+    switch (mode)
+    {
+        case allocation_mode::default_heap:
+            return "default";
+        case allocation_mode::arena:
+            return "arena";
+        case allocation_mode::pool:
+            return "pool";
+        default:
+            return "fixed buffer";
+    }
+}
+
+// Parses text over and over on one thread until stop is set, and returns how many times
+size_t run_thread(const std::string& text, allocation_mode mode, size_t buffer_capacity,
+                  const std::atomic<bool>& start, const std::atomic<bool>& stop)
+{
+    arena a;
+    fixed_buffer buffer(mode == allocation_mode::fixed_buffer ? buffer_capacity : 0);
+    while (!start.load(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+    size_t count = 0;
+    while (!stop.load(std::memory_order_relaxed))
+    {
+        switch (mode)
+        {
+            case allocation_mode::default_heap:
+                parse<json>(text, std::allocator<char>());
+                break;
+            case allocation_mode::arena:
+                parse<arena_json>(text, arena_allocator<char>(a));
+                a.release();
+                break;
+            case allocation_mode::fixed_buffer:
+                parse<fixed_buffer_json>(text, fixed_buffer_allocator<char>(buffer));
+                buffer.reset();
+                break;
+            case allocation_mode::pool:
+                parse<pool_json>(text, pool_allocator<char>());
+                break;
+        }
+        ++count;
+    }
+    return count;
+}
+
+// Returns the MB/s of threads parsers running at once
+double measure(const std::string& text, allocation_mode mode, size_t buffer_capacity, size_t threads)
+{
+    const double seconds = 1.0;
+
+    // Each count on its own cache line
+    struct slot
+    {
+        size_t count;
+        char padding[64 - sizeof(size_t)];
+    };
+    std::vector<slot> counts(threads);
+    std::atomic<bool> start(false);
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < threads; ++i)
+    {
+        workers.emplace_back([&, i]()
+        {
+            counts[i].count = run_thread(text, mode, buffer_capacity, start, stop);
+        });
+    }
+    auto begin = std::chrono::high_resolution_clock::now();
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop.store(true);
+    for (auto& t : workers)
+    {
+        t.join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+
+    size_t total = 0;
+    for (const auto& c : counts)
+    {
+        total += c.count;
+    }
+    return static_cast<double>(text.length()) * total / (1024.0 * 1024.0) / elapsed;
+}
+
+// Documents
+
+struct xorshift
+{
+    uint64_t state;
+
+    explicit xorshift(uint64_t seed)
+        : state(seed)
+    {
+    }
+
+    uint64_t operator()()
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+};
+
+// Arrays of coordinate pairs, mostly doubles
+std::string generate_numbers()
+{
+    xorshift rand(1);
+    std::ostringstream os;
+    os << std::setprecision(15) << "[";
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        os << (i > 0 ? "," : "") << "[" << static_cast<double>(rand() % 100000000) / 1000000.0 - 50.0
+           << "," << static_cast<double>(rand() % 100000000) / 1000000.0 << "]";
+    }
+    os << "]";
+    return os.str();
+}
+
+// Small objects with strings, integers and nested arrays, many nodes per byte
+std::string generate_records()
+{
+    xorshift rand(2);
+    std::ostringstream os;
+    os << "[";
+    for (size_t i = 0; i < 5000; ++i)
+    {
+        os << (i > 0 ? "," : "") << "{\"id\":" << i << ",\"name\":\"record number " << i
+           << "\",\"status\":\"" << ((rand() & 1) ? "active" : "inactive") << "\",\"score\":" << rand() % 1000
+           << ",\"tags\":[\"a\",\"b\",\"c\"],\"owner\":{\"id\":" << rand() % 100000 << ",\"verified\":"
+           << ((rand() & 1) ? "true" : "false") << "}}";
+    }
+    os << "]";
+    return os.str();
+}
+
+void run(const std::string& document, const std::string& text, size_t max_threads)
+{
+    // Room for the largest document the arena needs, with some to spare
+    arena a;
+    parse<arena_json>(text, arena_allocator<char>(a));
+    const size_t buffer_capacity = a.bytes_allocated() * 2 + 4096;
+    a.release();
+
+    std::vector<size_t> thread_counts;
+    for (size_t n = 1; n < max_threads; n *= 2)
+    {
+        thread_counts.push_back(n);
+    }
+    thread_counts.push_back(max_threads);
+
+    std::cout << document << ", " << text.length() << " bytes" << std::endl;
+    std::cout << std::left << std::setw(16) << "allocation" << std::right << std::setw(10) << "threads"
+              << std::setw(14) << "MB/s" << std::setw(18) << "MB/s per thread" << std::setw(12) << "speedup"
+              << std::setw(14) << "efficiency" << std::endl;
+    for (allocation_mode mode : {allocation_mode::default_heap, allocation_mode::arena, allocation_mode::fixed_buffer, allocation_mode::pool})
+    {
+        double single = 0;
+        for (size_t threads : thread_counts)
+        {
+            double mb_per_second = measure(text, mode, buffer_capacity, threads);
+            if (threads == 1)
+            {
+                single = mb_per_second;
+            }
+            double speedup = mb_per_second / single;
+            std::cout << std::left << std::setw(16) << mode_name(mode)
+                      << std::right << std::setw(10) << threads
+                      << std::fixed << std::setprecision(1)
+                      << std::setw(14) << mb_per_second
+                      << std::setw(18) << mb_per_second / threads
+                      << std::setw(12) << speedup
+                      << std::setw(13) << std::setprecision(0) << 100.0 * speedup / threads << "%"
+                      << std::endl;
+        }
+    }
+    std::cout << std::endl;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    size_t max_threads = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10))
+                                  : static_cast<size_t>(std::thread::hardware_concurrency());
+    if (max_threads == 0)
+    {
+        max_threads = 1;
+    }
+
+    run("generated numbers", generate_numbers(), max_threads);
+    run("generated records", generate_records(), max_threads);
+}
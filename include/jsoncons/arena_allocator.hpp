@@ -0,0 +1,198 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_ARENA_ALLOCATOR_HPP
+#define JSONCONS_ARENA_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <memory>
+#include <type_traits>
+#include <jsoncons/detail/jsoncons_config.hpp>
+
+namespace jsoncons {
+
+// A monotonic memory resource. Allocation bumps a pointer through a chain of blocks,
+// deallocation does nothing, and all memory is returned at once by release() or
+// by the destructor.
+
+class arena
+{
+    struct block
+    {
+        block* next;
+        size_t size;
+    };
+
+    static const size_t default_initial_block_size = 4096;
+
+    block* head_;
+    char* p_;
+    char* last_;
+    size_t next_block_size_;
+    size_t initial_block_size_;
+    size_t bytes_allocated_;
+
+    // Noncopyable and nonmoveable
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+public:
+    arena()
+        : arena(default_initial_block_size)
+    {
+    }
+
+    explicit arena(size_t initial_block_size)
+        : head_(nullptr),
+          p_(nullptr),
+          last_(nullptr),
+          next_block_size_(initial_block_size > 0 ? initial_block_size : default_initial_block_size),
+          initial_block_size_(next_block_size_),
+          bytes_allocated_(0)
+    {
+    }
+
+    ~arena()
+    {
+        release();
+    }
+
+    void* allocate(size_t n, size_t alignment)
+    {
+        char* p = align(p_, alignment);
+        if (JSONCONS_UNLIKELY(p == nullptr || p > last_ || static_cast<size_t>(last_ - p) < n))
+        {
+            add_block(n + alignment);
+            p = align(p_, alignment);
+        }
+        p_ = p + n;
+        bytes_allocated_ += n;
+        return p;
+    }
+
+    // Returns all blocks to the system. Memory allocated from the arena must no longer be used.
+    void release()
+    {
+        while (head_ != nullptr)
+        {
+            block* next = head_->next;
+            std::free(head_);
+            head_ = next;
+        }
+        p_ = last_ = nullptr;
+        next_block_size_ = initial_block_size_;
+        bytes_allocated_ = 0;
+    }
+
+    size_t bytes_allocated() const
+    {
+        return bytes_allocated_;
+    }
+
+private:
+    static char* align(char* p, size_t alignment)
+    {
+        if (p == nullptr)
+        {
+            return nullptr;
+        }
+        uintptr_t u = reinterpret_cast<uintptr_t>(p);
+        return p + ((alignment - (u % alignment)) % alignment);
+    }
+
+    void add_block(size_t min_size)
+    {
+        size_t size = next_block_size_;
+        while (size - sizeof(block) < min_size)
+        {
+            size *= 2;
+        }
+        block* b = static_cast<block*>(std::malloc(size));
+        if (b == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        b->next = head_;
+        b->size = size;
+        head_ = b;
+        p_ = reinterpret_cast<char*>(b) + sizeof(block);
+        last_ = reinterpret_cast<char*>(b) + size;
+        next_block_size_ = size * 2;
+    }
+};
+
+// An allocator that allocates from an arena. Use it as the Allocator template parameter of
+// basic_json (e.g. basic_json<char,sorted_policy,arena_allocator<char>>) to make node
+// allocation a pointer bump and releasing a whole document a single arena release.
+
+template <class T>
+class arena_allocator
+{
+    template <class U> friend class arena_allocator;
+
+    arena* arena_;
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    template <class U>
+    struct rebind
+    {
+        typedef arena_allocator<U> other;
+    };
+
+    arena_allocator(arena& a) JSONCONS_NOEXCEPT
+        : arena_(&a)
+    {
+    }
+
+    template <class U>
+    arena_allocator(const arena_allocator<U>& other) JSONCONS_NOEXCEPT
+        : arena_(other.arena_)
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(arena_->allocate(n*sizeof(T), JSONCONS_ALIGNOF(T)));
+    }
+
+    void deallocate(T*, size_t) JSONCONS_NOEXCEPT
+    {
+    }
+
+    arena& get_arena() const
+    {
+        return *arena_;
+    }
+
+    template <class U>
+    bool operator==(const arena_allocator<U>& other) const JSONCONS_NOEXCEPT
+    {
+        return arena_ == other.arena_;
+    }
+
+    template <class U>
+    bool operator!=(const arena_allocator<U>& other) const JSONCONS_NOEXCEPT
+    {
+        return arena_ != other.arena_;
+    }
+};
+
+}
+
+#endif
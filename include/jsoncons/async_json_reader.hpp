@@ -0,0 +1,312 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_ASYNC_JSON_READER_HPP
+#define JSONCONS_ASYNC_JSON_READER_HPP
+
+#include <cstddef>
+#include <vector>
+#include <functional>
+#include <atomic>
+#include <system_error>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/json_input_handler.hpp>
+#include <jsoncons/parse_error_handler.hpp>
+#include <jsoncons/json_push_parser.hpp>
+
+namespace jsoncons {
+
+// Reads JSON texts from a source that completes its reads asynchronously, such as a socket
+// served by Asio or an io_uring loop, so that a connection waiting for data holds no thread.
+// The caller supplies the read as a function that starts reading into the reader's buffer
+// and calls the handler it is given with the number of characters read, 0 at the end of the
+// input, or an error. The handler may be called from inside the function, or later from any
+// thread, but one read is outstanding at a time. The reader parses each buffer with a
+// basic_json_push_parser, and calls the completion handler of async_read_next on the thread
+// that completed the last read, once a whole text has been reported to the input handler.
+// Reads that complete inside the read function are handled in a loop, not by recursion, so
+// a source that always has data ready does not grow the stack.
+
+template<class CharT>
+class basic_async_json_reader
+{
+public:
+    typedef std::function<void(size_t, const std::error_code&)> read_handler;
+    typedef std::function<void(CharT*, size_t, read_handler)> async_read_function;
+    typedef std::function<void(const std::error_code&)> completion_handler;
+private:
+    static const size_t default_max_buffer_length = 16384;
+    static const int read_idle = 0;
+    static const int read_pending = 1;
+    static const int read_started = 2;
+    static const int read_completed = 3;
+
+    basic_json_push_parser<CharT> parser_;
+    async_read_function read_some_;
+    completion_handler completion_;
+    std::vector<CharT> buffer_;
+    size_t buffer_length_;
+    size_t position_;
+    size_t length_;
+    bool started_;
+    bool input_ended_;
+    bool eof_;
+    bool completing_;
+    bool restarted_;
+    std::atomic<int> read_state_;
+    size_t read_count_;
+    std::error_code read_ec_;
+
+    // Noncopyable and nonmoveable
+    basic_async_json_reader(const basic_async_json_reader&) = delete;
+    basic_async_json_reader& operator=(const basic_async_json_reader&) = delete;
+
+public:
+    basic_async_json_reader(async_read_function read_some,
+                            basic_json_input_handler<CharT>& handler)
+        : parser_(handler),
+          read_some_(read_some),
+          buffer_length_(default_max_buffer_length),
+          position_(0),
+          length_(0),
+          started_(false),
+          input_ended_(false),
+          eof_(false),
+          completing_(false),
+          restarted_(false),
+          read_state_(read_idle),
+          read_count_(0)
+    {
+    }
+
+    basic_async_json_reader(async_read_function read_some,
+                            basic_json_input_handler<CharT>& handler,
+                            parse_error_handler& err_handler)
+        : parser_(handler,err_handler),
+          read_some_(read_some),
+          buffer_length_(default_max_buffer_length),
+          position_(0),
+          length_(0),
+          started_(false),
+          input_ended_(false),
+          eof_(false),
+          completing_(false),
+          restarted_(false),
+          read_state_(read_idle),
+          read_count_(0)
+    {
+    }
+
+    size_t buffer_length() const
+    {
+        return buffer_length_;
+    }
+
+    // Takes effect when the buffer is next empty
+    void buffer_length(size_t length)
+    {
+        buffer_length_ = length;
+    }
+
+    size_t max_nesting_depth() const
+    {
+        return parser_.max_nesting_depth();
+    }
+
+    void max_nesting_depth(size_t depth)
+    {
+        parser_.max_nesting_depth(depth);
+    }
+
+    size_t max_input_length() const
+    {
+        return parser_.max_input_length();
+    }
+
+    void max_input_length(size_t length)
+    {
+        parser_.max_input_length(length);
+    }
+
+    size_t max_string_length() const
+    {
+        return parser_.max_string_length();
+    }
+
+    void max_string_length(size_t length)
+    {
+        parser_.max_string_length(length);
+    }
+
+    size_t max_items() const
+    {
+        return parser_.max_items();
+    }
+
+    void max_items(size_t count)
+    {
+        parser_.max_items(count);
+    }
+
+    // True once the input has ended with no more texts in it. The completion handler of a
+    // read that finds the end of the input before another text begins is called without an
+    // error, and should check eof. A text that ends with the input is read as any other.
+    bool eof() const
+    {
+        return eof_;
+    }
+
+    size_t line_number() const
+    {
+        return parser_.line_number();
+    }
+
+    size_t column_number() const
+    {
+        return parser_.column_number();
+    }
+
+    // Reads the next text, which may follow others in the input, and calls completion once
+    // it has been reported to the input handler, or with the error that stopped it. The
+    // reader and the input handler must exist until completion is called. Called from a
+    // completion handler, it starts once the handler returns, so that reading text after
+    // text from the buffer does not grow the stack.
+    void async_read_next(completion_handler completion)
+    {
+        completion_ = completion;
+        started_ = false;
+        parser_.reset();
+        if (completing_)
+        {
+            restarted_ = true;
+            return;
+        }
+        run();
+    }
+
+private:
+    // Parses buffered input, and reads more, until the text is done or a read is pending
+    void run()
+    {
+        for (;;)
+        {
+            std::error_code ec;
+            if (position_ < length_)
+            {
+                parse_buffer(ec);
+                if (ec || parser_.done())
+                {
+                    if (!complete(ec))
+                    {
+                        return;
+                    }
+                    continue;
+                }
+            }
+            if (input_ended_)
+            {
+                if (started_)
+                {
+                    parser_.finish(ec);
+                }
+                else
+                {
+                    eof_ = true;
+                }
+                if (!complete(ec))
+                {
+                    return;
+                }
+                continue;
+            }
+            if (buffer_.size() != buffer_length_)
+            {
+                buffer_.resize(buffer_length_);
+            }
+            position_ = 0;
+            length_ = 0;
+            read_state_ = read_pending;
+            read_some_(buffer_.data(), buffer_.size(),
+                       [this](size_t count, const std::error_code& ec) {on_read(count, ec);});
+            // Whichever of this and on_read comes second carries on
+            if (read_state_.exchange(read_started) != read_completed)
+            {
+                return;
+            }
+            if (!take_read())
+            {
+                return;
+            }
+        }
+    }
+
+    void on_read(size_t count, const std::error_code& ec)
+    {
+        read_count_ = count;
+        read_ec_ = ec;
+        if (read_state_.exchange(read_completed) == read_started && take_read())
+        {
+            run();
+        }
+    }
+
+    // Takes in the result of a completed read, and returns false if that ends the operation
+    bool take_read()
+    {
+        if (read_ec_)
+        {
+            return complete(read_ec_);
+        }
+        if (read_count_ == 0)
+        {
+            input_ended_ = true;
+        }
+        length_ = read_count_;
+        return true;
+    }
+
+    void parse_buffer(std::error_code& ec)
+    {
+        if (!started_)
+        {
+            // Whitespace between texts is not the start of another
+            while (position_ < length_ && is_whitespace(buffer_[position_]))
+            {
+                ++position_;
+            }
+            if (position_ == length_)
+            {
+                return;
+            }
+            started_ = true;
+        }
+        position_ += parser_.update(buffer_.data() + position_, length_ - position_, ec);
+    }
+
+    // Calls the completion handler, and returns true if it asked for the next text
+    bool complete(const std::error_code& ec)
+    {
+        completion_handler completion;
+        completion.swap(completion_);
+        completing_ = true;
+        restarted_ = false;
+        completion(ec);
+        completing_ = false;
+        return restarted_;
+    }
+
+    static bool is_whitespace(CharT c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+};
+
+typedef basic_async_json_reader<char> async_json_reader;
+typedef basic_async_json_reader<wchar_t> wasync_json_reader;
+
+}
+
+#endif
@@ -0,0 +1,1432 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_COMPACT_JSON_HPP
+#define JSONCONS_COMPACT_JSON_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_filter.hpp>
+
+namespace jsoncons {
+
+// basic_compact_json
+// A JSON value in 8 bytes, for documents of many small values, such as long arrays of
+// numbers, that a basic_json holds in twice the memory the data needs.
+//
+// A double is held as itself, with every NaN made the positive quiet NaN. Any other value
+// is a negative quiet NaN, with its kind in the 3 bits below the top 13 and a 48 bit
+// payload below those:
+//
+//   null, bool            the bool in the payload
+//   integer               an integer that fits in 48 bits, sign extended
+//   short string          up to 5 narrow characters and their count, in place
+//   string, array,        a pointer to a block on the heap, which must be in the low 48 bits
+//   object, long integer  of the address space, as user space is on x86-64 and AArch64
+//
+// A string block holds the length and the characters, an array block the size, capacity
+// and elements, an object block the size, capacity and members sorted by name, and a long
+// integer block an integer or unsigned integer that does not fit in 48 bits. The blocks are
+// allocated with Allocator, which must be stateless, as a value has no room for one.
+//
+// Doubles keep no precision, and are written in shortest form. Byte strings are held as
+// their base64url text, as json_serializer writes them.
+
+template <class CharT, class Allocator = std::allocator<char>>
+class basic_compact_json
+{
+public:
+    typedef CharT char_type;
+    typedef Allocator allocator_type;
+    typedef std::char_traits<char_type> char_traits_type;
+#if !defined(JSONCONS_HAS_STRING_VIEW)
+    typedef Basic_string_view_<char_type,char_traits_type> string_view_type;
+#else
+    typedef std::basic_string_view<char_type,char_traits_type> string_view_type;
+#endif
+    typedef std::basic_string<char_type> string_type;
+
+    class member;
+
+    typedef basic_compact_json* element_iterator;
+    typedef const basic_compact_json* const_element_iterator;
+    typedef member* member_iterator;
+    typedef const member* const_member_iterator;
+
+    static const size_t short_string_capacity = sizeof(char_type) == 1 ? 5 : 0;
+private:
+    static_assert(std::is_empty<Allocator>::value, "basic_compact_json needs a stateless allocator");
+
+    static const uint64_t boxed_bits = 0xFFF8000000000000ull;
+    static const uint64_t payload_mask = 0x0000FFFFFFFFFFFFull;
+    static const uint64_t quiet_nan_bits = 0x7FF8000000000000ull;
+
+    enum class kind : uint8_t
+    {
+        null_k = 0,
+        bool_k,
+        integer_k,
+        short_string_k,
+        string_k,
+        array_k,
+        object_k,
+        long_integer_k
+    };
+
+    struct string_block
+    {
+        size_t length_;
+    };
+
+    struct array_block
+    {
+        size_t size_;
+        size_t capacity_;
+    };
+
+    struct object_block
+    {
+        size_t size_;
+        size_t capacity_;
+    };
+
+    struct long_integer_block
+    {
+        uint64_t value_;
+        bool is_unsigned_;
+    };
+
+    typedef typename std::allocator_traits<Allocator>:: template rebind_alloc<uint64_t> word_allocator_type;
+
+    static const int64_t min_integer = -(int64_t(1) << 47);
+    static const int64_t max_integer = (int64_t(1) << 47) - 1;
+
+    uint64_t bits_;
+public:
+    basic_compact_json() JSONCONS_NOEXCEPT
+        : bits_(boxed(kind::null_k, 0))
+    {
+    }
+
+    basic_compact_json(null_type) JSONCONS_NOEXCEPT
+        : bits_(boxed(kind::null_k, 0))
+    {
+    }
+
+    basic_compact_json(bool val) JSONCONS_NOEXCEPT
+        : bits_(boxed(kind::bool_k, val ? 1 : 0))
+    {
+    }
+
+    template <class T>
+    basic_compact_json(T val, typename std::enable_if<detail::is_integer_like<T>::value>::type* = 0)
+    {
+        init_integer(static_cast<int64_t>(val));
+    }
+
+    template <class T>
+    basic_compact_json(T val, typename std::enable_if<detail::is_uinteger_like<T>::value>::type* = 0)
+    {
+        init_uinteger(static_cast<uint64_t>(val));
+    }
+
+    template <class T>
+    basic_compact_json(T val, typename std::enable_if<detail::is_floating_point_like<T>::value>::type* = 0)
+    {
+        init_double(static_cast<double>(val));
+    }
+
+    basic_compact_json(const char_type* s)
+    {
+        init_string(s, char_traits_type::length(s));
+    }
+
+    basic_compact_json(const string_view_type& s)
+    {
+        init_string(s.data(), s.length());
+    }
+
+    basic_compact_json(const string_type& s)
+    {
+        init_string(s.data(), s.length());
+    }
+
+    basic_compact_json(const basic_compact_json& val)
+    {
+        init_copy(val);
+    }
+
+    basic_compact_json(basic_compact_json&& val) JSONCONS_NOEXCEPT
+        : bits_(val.bits_)
+    {
+        val.bits_ = boxed(kind::null_k, 0);
+    }
+
+    ~basic_compact_json()
+    {
+        destroy();
+    }
+
+    basic_compact_json& operator=(const basic_compact_json& val)
+    {
+        if (this != &val)
+        {
+            basic_compact_json temp(val);
+            swap(temp);
+        }
+        return *this;
+    }
+
+    basic_compact_json& operator=(basic_compact_json&& val) JSONCONS_NOEXCEPT
+    {
+        if (this != &val)
+        {
+            destroy();
+            bits_ = val.bits_;
+            val.bits_ = boxed(kind::null_k, 0);
+        }
+        return *this;
+    }
+
+    void swap(basic_compact_json& val) JSONCONS_NOEXCEPT
+    {
+        std::swap(bits_, val.bits_);
+    }
+
+    // An empty array, with room for capacity elements
+    static basic_compact_json make_array(size_t capacity = 0)
+    {
+        basic_compact_json val;
+        val.bits_ = boxed(kind::array_k, to_payload(allocate_array(capacity)));
+        return val;
+    }
+
+    // An empty object, with room for capacity members
+    static basic_compact_json make_object(size_t capacity = 0)
+    {
+        basic_compact_json val;
+        val.bits_ = boxed(kind::object_k, to_payload(allocate_object(capacity)));
+        return val;
+    }
+
+    static basic_compact_json parse(const string_view_type& s);
+
+    static basic_compact_json parse(std::basic_istream<char_type>& is);
+
+    bool is_null() const JSONCONS_NOEXCEPT
+    {
+        return is_kind(kind::null_k);
+    }
+
+    bool is_bool() const JSONCONS_NOEXCEPT
+    {
+        return is_kind(kind::bool_k);
+    }
+
+    bool is_integer() const JSONCONS_NOEXCEPT
+    {
+        return is_kind(kind::integer_k) ||
+               (is_kind(kind::long_integer_k) && (!long_integer()->is_unsigned_ || long_integer()->value_ <= uint64_t((std::numeric_limits<int64_t>::max)())));
+    }
+
+    bool is_uinteger() const JSONCONS_NOEXCEPT
+    {
+        return (is_kind(kind::integer_k) && integer_payload() >= 0) ||
+               (is_kind(kind::long_integer_k) && (long_integer()->is_unsigned_ || static_cast<int64_t>(long_integer()->value_) >= 0));
+    }
+
+    bool is_double() const JSONCONS_NOEXCEPT
+    {
+        return !is_boxed();
+    }
+
+    bool is_number() const JSONCONS_NOEXCEPT
+    {
+        return !is_boxed() || is_kind(kind::integer_k) || is_kind(kind::long_integer_k);
+    }
+
+    bool is_string() const JSONCONS_NOEXCEPT
+    {
+        return is_kind(kind::short_string_k) || is_kind(kind::string_k);
+    }
+
+    bool is_array() const JSONCONS_NOEXCEPT
+    {
+        return is_kind(kind::array_k);
+    }
+
+    bool is_object() const JSONCONS_NOEXCEPT
+    {
+        return is_kind(kind::object_k);
+    }
+
+    // The number of elements of an array or members of an object, otherwise 0
+    size_t size() const JSONCONS_NOEXCEPT
+    {
+        if (is_array())
+        {
+            return array()->size_;
+        }
+        if (is_object())
+        {
+            return object()->size_;
+        }
+        return 0;
+    }
+
+    bool empty() const JSONCONS_NOEXCEPT
+    {
+        return size() == 0;
+    }
+
+    size_t capacity() const JSONCONS_NOEXCEPT
+    {
+        if (is_array())
+        {
+            return array()->capacity_;
+        }
+        if (is_object())
+        {
+            return object()->capacity_;
+        }
+        return 0;
+    }
+
+    bool as_bool() const
+    {
+        if (is_kind(kind::bool_k))
+        {
+            return (bits_ & payload_mask) != 0;
+        }
+        if (is_kind(kind::integer_k) || is_kind(kind::long_integer_k))
+        {
+            return as_uinteger() != 0;
+        }
+        JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a bool");
+    }
+
+    int64_t as_integer() const
+    {
+        if (!is_boxed())
+        {
+            return static_cast<int64_t>(double_value());
+        }
+        switch (get_kind())
+        {
+        case kind::integer_k:
+            return integer_payload();
+        case kind::long_integer_k:
+            return static_cast<int64_t>(long_integer()->value_);
+        case kind::bool_k:
+            return static_cast<int64_t>(bits_ & payload_mask);
+        default:
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an integer");
+        }
+    }
+
+    uint64_t as_uinteger() const
+    {
+        if (!is_boxed())
+        {
+            return static_cast<uint64_t>(double_value());
+        }
+        switch (get_kind())
+        {
+        case kind::integer_k:
+            return static_cast<uint64_t>(integer_payload());
+        case kind::long_integer_k:
+            return long_integer()->value_;
+        case kind::bool_k:
+            return bits_ & payload_mask;
+        default:
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an unsigned integer");
+        }
+    }
+
+    double as_double() const
+    {
+        if (!is_boxed())
+        {
+            return double_value();
+        }
+        switch (get_kind())
+        {
+        case kind::integer_k:
+            return static_cast<double>(integer_payload());
+        case kind::long_integer_k:
+            return long_integer()->is_unsigned_ ? static_cast<double>(long_integer()->value_)
+                                                : static_cast<double>(static_cast<int64_t>(long_integer()->value_));
+        default:
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a double");
+        }
+    }
+
+    // The characters of a string, in the value for a short string and otherwise in its block
+    string_view_type as_string_view() const
+    {
+        switch (is_boxed() ? get_kind() : kind::null_k)
+        {
+        case kind::short_string_k:
+            return string_view_type(reinterpret_cast<const char_type*>(short_string_bytes()), short_string_length());
+        case kind::string_k:
+            return string_view_type(string_chars(string()), string()->length_);
+        default:
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a string");
+        }
+    }
+
+    // The text of a string, otherwise the value serialized
+    string_type as_string() const
+    {
+        if (is_string())
+        {
+            string_view_type sv = as_string_view();
+            return string_type(sv.data(), sv.length());
+        }
+        return to_string();
+    }
+
+    // Converts to T, to a basic_json with a copy of the value, and to other types
+    // through a basic_json<CharT> unless T is bool, a number or a string
+    template <class T>
+    T as() const;
+
+    basic_compact_json& at(size_t i)
+    {
+        return const_cast<basic_compact_json&>(static_cast<const basic_compact_json&>(*this).at(i));
+    }
+
+    const basic_compact_json& at(size_t i) const
+    {
+        if (!is_array())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Index on non-array value not supported");
+        }
+        if (i >= array()->size_)
+        {
+            JSONCONS_THROW_EXCEPTION(std::out_of_range,"Invalid array subscript");
+        }
+        return elements_of(array())[i];
+    }
+
+    basic_compact_json& at(const string_view_type& name)
+    {
+        return const_cast<basic_compact_json&>(static_cast<const basic_compact_json&>(*this).at(name));
+    }
+
+    const basic_compact_json& at(const string_view_type& name) const
+    {
+        if (!is_object())
+        {
+            JSONCONS_THROW_EXCEPTION_1(std::runtime_error,"Attempting to get %s from a value that is not an object",name);
+        }
+        const_member_iterator it = find(name);
+        if (it == members_of(object()) + object()->size_)
+        {
+            JSONCONS_THROW_EXCEPTION_1(std::out_of_range,"%s not found",name);
+        }
+        return it->value();
+    }
+
+    basic_compact_json& operator[](size_t i)
+    {
+        return at(i);
+    }
+
+    const basic_compact_json& operator[](size_t i) const
+    {
+        return at(i);
+    }
+
+    basic_compact_json& operator[](const string_view_type& name)
+    {
+        return at(name);
+    }
+
+    const basic_compact_json& operator[](const string_view_type& name) const
+    {
+        return at(name);
+    }
+
+    bool has_key(const string_view_type& name) const
+    {
+        return is_object() && find(name) != members_of(object()) + object()->size_;
+    }
+
+    size_t count(const string_view_type& name) const
+    {
+        return has_key(name) ? 1 : 0;
+    }
+
+    // The member with the given name, or the end of members() if there is none
+    member_iterator find(const string_view_type& name)
+    {
+        return const_cast<member_iterator>(static_cast<const basic_compact_json&>(*this).find(name));
+    }
+
+    const_member_iterator find(const string_view_type& name) const
+    {
+        if (!is_object())
+        {
+            return nullptr;
+        }
+        const_member_iterator first = members_of(object());
+        const_member_iterator last = first + object()->size_;
+        const_member_iterator it = lower_bound(first, last, name);
+        return it != last && it->key() == name ? it : last;
+    }
+
+    range<element_iterator> elements()
+    {
+        if (!is_array())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an array");
+        }
+        return range<element_iterator>(elements_of(array()), elements_of(array()) + array()->size_);
+    }
+
+    range<const_element_iterator> elements() const
+    {
+        if (!is_array())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an array");
+        }
+        return range<const_element_iterator>(elements_of(array()), elements_of(array()) + array()->size_);
+    }
+
+    range<member_iterator> members()
+    {
+        if (!is_object())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an object");
+        }
+        return range<member_iterator>(members_of(object()), members_of(object()) + object()->size_);
+    }
+
+    range<const_member_iterator> members() const
+    {
+        if (!is_object())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an object");
+        }
+        return range<const_member_iterator>(members_of(object()), members_of(object()) + object()->size_);
+    }
+
+    void reserve(size_t n)
+    {
+        if (is_array())
+        {
+            if (n > array()->capacity_)
+            {
+                grow_array(n);
+            }
+        }
+        else if (is_object())
+        {
+            if (n > object()->capacity_)
+            {
+                grow_object(n);
+            }
+        }
+        else
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Attempting to reserve space in a value that is not an array or object");
+        }
+    }
+
+    void push_back(basic_compact_json val)
+    {
+        if (!is_array())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Attempting to insert into a value that is not an array");
+        }
+        if (array()->size_ == array()->capacity_)
+        {
+            grow_array(array()->capacity_ < 4 ? 4 : 2*array()->capacity_);
+        }
+        array_block* block = array();
+        new(elements_of(block) + block->size_)basic_compact_json(std::move(val));
+        ++block->size_;
+    }
+
+    // Sets the member with the given name, inserting it in order if there is none
+    void insert_or_assign(const string_view_type& name, basic_compact_json val)
+    {
+        if (!is_object())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Attempting to insert into a value that is not an object");
+        }
+        member* first = members_of(object());
+        member* last = first + object()->size_;
+        member* it = const_cast<member*>(lower_bound(first, last, name));
+        if (it != last && it->key() == name)
+        {
+            it->value() = std::move(val);
+            return;
+        }
+        size_t pos = it - first;
+        if (object()->size_ == object()->capacity_)
+        {
+            grow_object(object()->capacity_ < 4 ? 4 : 2*object()->capacity_);
+        }
+        object_block* block = object();
+        first = members_of(block);
+        // Members are moved up by their bits, they own nothing that refers back to them
+        std::memmove(static_cast<void*>(first + pos + 1), static_cast<const void*>(first + pos), (block->size_ - pos)*sizeof(member));
+        new(first + pos)member(basic_compact_json(name), std::move(val));
+        ++block->size_;
+    }
+
+    // Removes the member with the given name, if there is one
+    void erase(const string_view_type& name)
+    {
+        if (!is_object())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Attempting to erase a member of a value that is not an object");
+        }
+        member* it = find(name);
+        object_block* block = object();
+        member* last = members_of(block) + block->size_;
+        if (it != last)
+        {
+            it->~member();
+            std::memmove(static_cast<void*>(it), static_cast<const void*>(it + 1), (last - it - 1)*sizeof(member));
+            --block->size_;
+        }
+    }
+
+    friend bool operator==(const basic_compact_json& lhs, const basic_compact_json& rhs)
+    {
+        if (lhs.is_number() && rhs.is_number())
+        {
+            if (lhs.is_double() || rhs.is_double())
+            {
+                return lhs.as_double() == rhs.as_double();
+            }
+            if (lhs.is_integer() && rhs.is_integer())
+            {
+                return lhs.as_integer() == rhs.as_integer();
+            }
+            return lhs.is_uinteger() && rhs.is_uinteger() && lhs.as_uinteger() == rhs.as_uinteger();
+        }
+        if (lhs.is_string() && rhs.is_string())
+        {
+            return lhs.as_string_view() == rhs.as_string_view();
+        }
+        if (lhs.is_array() && rhs.is_array())
+        {
+            return lhs.size() == rhs.size() &&
+                   std::equal(elements_of(lhs.array()), elements_of(lhs.array()) + lhs.size(), elements_of(rhs.array()));
+        }
+        if (lhs.is_object() && rhs.is_object())
+        {
+            return lhs.size() == rhs.size() &&
+                   std::equal(members_of(lhs.object()), members_of(lhs.object()) + lhs.size(), members_of(rhs.object()));
+        }
+        return lhs.bits_ == rhs.bits_;
+    }
+
+    friend bool operator!=(const basic_compact_json& lhs, const basic_compact_json& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    void dump_fragment(basic_json_output_handler<char_type>& handler) const
+    {
+        if (!is_boxed())
+        {
+            handler.double_value(double_value(), 0);
+            return;
+        }
+        switch (get_kind())
+        {
+        case kind::null_k:
+            handler.null_value();
+            break;
+        case kind::bool_k:
+            handler.bool_value(as_bool());
+            break;
+        case kind::integer_k:
+            handler.integer_value(integer_payload());
+            break;
+        case kind::long_integer_k:
+            if (long_integer()->is_unsigned_)
+            {
+                handler.uinteger_value(long_integer()->value_);
+            }
+            else
+            {
+                handler.integer_value(static_cast<int64_t>(long_integer()->value_));
+            }
+            break;
+        case kind::short_string_k:
+        case kind::string_k:
+            handler.string_value(as_string_view());
+            break;
+        case kind::array_k:
+            handler.begin_array();
+            for (const auto& element : elements())
+            {
+                element.dump_fragment(handler);
+            }
+            handler.end_array();
+            break;
+        case kind::object_k:
+            handler.begin_object();
+            for (const auto& m : members())
+            {
+                handler.name(m.key());
+                m.value().dump_fragment(handler);
+            }
+            handler.end_object();
+            break;
+        default:
+            JSONCONS_UNREACHABLE();
+            break;
+        }
+    }
+
+    void dump(basic_json_output_handler<char_type>& handler) const
+    {
+        handler.begin_json();
+        dump_fragment(handler);
+        handler.end_json();
+    }
+
+    void dump(std::basic_ostream<char_type>& os) const
+    {
+        basic_json_serializer<char_type> serializer(os);
+        dump(serializer);
+    }
+
+    void dump(std::basic_ostream<char_type>& os, bool pprint) const
+    {
+        basic_json_serializer<char_type> serializer(os, pprint);
+        dump(serializer);
+    }
+
+    void dump(std::basic_ostream<char_type>& os, const basic_serialization_options<char_type>& options) const
+    {
+        basic_json_serializer<char_type> serializer(os, options);
+        dump(serializer);
+    }
+
+    string_type to_string() const
+    {
+        string_type s;
+        basic_string_sink<string_type> sink(s);
+        {
+            basic_json_serializer<char_type> serializer(sink);
+            dump_fragment(serializer);
+        }
+        return s;
+    }
+
+    friend std::basic_ostream<char_type>& operator<<(std::basic_ostream<char_type>& os, const basic_compact_json& o)
+    {
+        o.dump(os);
+        return os;
+    }
+private:
+    static uint64_t boxed(kind k, uint64_t payload)
+    {
+        return boxed_bits | (static_cast<uint64_t>(k) << 48) | payload;
+    }
+
+    bool is_boxed() const
+    {
+        return (bits_ & boxed_bits) == boxed_bits;
+    }
+
+    kind get_kind() const
+    {
+        return static_cast<kind>((bits_ >> 48) & 7);
+    }
+
+    bool is_kind(kind k) const
+    {
+        return is_boxed() && get_kind() == k;
+    }
+
+    double double_value() const
+    {
+        double d;
+        std::memcpy(&d, &bits_, sizeof(double));
+        return d;
+    }
+
+    int64_t integer_payload() const
+    {
+        // Sign extends the low 48 bits
+        return static_cast<int64_t>(bits_ << 16) >> 16;
+    }
+
+    template <class T>
+    T* block() const
+    {
+        return reinterpret_cast<T*>(static_cast<uintptr_t>(bits_ & payload_mask));
+    }
+
+    string_block* string() const
+    {
+        return block<string_block>();
+    }
+
+    array_block* array() const
+    {
+        return block<array_block>();
+    }
+
+    object_block* object() const
+    {
+        return block<object_block>();
+    }
+
+    long_integer_block* long_integer() const
+    {
+        return block<long_integer_block>();
+    }
+
+    static uint64_t to_payload(const void* p)
+    {
+        uint64_t payload = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(p));
+        JSONCONS_ASSERT((payload & ~payload_mask) == 0);
+        return payload;
+    }
+
+    // The payload bytes are the low 48 bits of the value, at the start of it on a little
+    // endian machine and after the two bytes with the kind on a big endian one. The count of
+    // a short string is in the last payload byte.
+    static size_t payload_offset()
+    {
+        const uint16_t one = 1;
+        return *reinterpret_cast<const unsigned char*>(&one) == 1 ? 0 : 2;
+    }
+
+    const unsigned char* short_string_bytes() const
+    {
+        return reinterpret_cast<const unsigned char*>(&bits_) + payload_offset();
+    }
+
+    size_t short_string_length() const
+    {
+        return short_string_bytes()[5];
+    }
+
+    static size_t words_for(size_t bytes)
+    {
+        return (bytes + sizeof(uint64_t) - 1)/sizeof(uint64_t);
+    }
+
+    static void* allocate_words(size_t n)
+    {
+        word_allocator_type alloc;
+        return to_plain_pointer(alloc.allocate(n));
+    }
+
+    static void deallocate_words(void* p, size_t n)
+    {
+        word_allocator_type alloc;
+        alloc.deallocate(static_cast<uint64_t*>(p), n);
+    }
+
+    static size_t string_words(size_t length)
+    {
+        return words_for(sizeof(string_block) + (length + 1)*sizeof(char_type));
+    }
+
+    static char_type* string_chars(string_block* block)
+    {
+        return reinterpret_cast<char_type*>(block + 1);
+    }
+
+    static size_t array_words(size_t capacity)
+    {
+        return words_for(sizeof(array_block) + capacity*sizeof(basic_compact_json));
+    }
+
+    static basic_compact_json* elements_of(array_block* block)
+    {
+        return reinterpret_cast<basic_compact_json*>(block + 1);
+    }
+
+    static size_t object_words(size_t capacity)
+    {
+        return words_for(sizeof(object_block) + capacity*sizeof(member));
+    }
+
+    static member* members_of(object_block* block)
+    {
+        return reinterpret_cast<member*>(block + 1);
+    }
+
+    static array_block* allocate_array(size_t capacity)
+    {
+        array_block* block = static_cast<array_block*>(allocate_words(array_words(capacity)));
+        block->size_ = 0;
+        block->capacity_ = capacity;
+        return block;
+    }
+
+    static object_block* allocate_object(size_t capacity)
+    {
+        object_block* block = static_cast<object_block*>(allocate_words(object_words(capacity)));
+        block->size_ = 0;
+        block->capacity_ = capacity;
+        return block;
+    }
+
+    static const_member_iterator lower_bound(const_member_iterator first, const_member_iterator last, const string_view_type& name)
+    {
+        return std::lower_bound(first, last, name,
+                                [](const member& m, const string_view_type& k){return m.key().compare(k) < 0;});
+    }
+
+    void init_integer(int64_t val)
+    {
+        if (val >= min_integer && val <= max_integer)
+        {
+            bits_ = boxed(kind::integer_k, static_cast<uint64_t>(val) & payload_mask);
+        }
+        else
+        {
+            init_long_integer(static_cast<uint64_t>(val), false);
+        }
+    }
+
+    void init_uinteger(uint64_t val)
+    {
+        if (val <= static_cast<uint64_t>(max_integer))
+        {
+            bits_ = boxed(kind::integer_k, val);
+        }
+        else
+        {
+            init_long_integer(val, true);
+        }
+    }
+
+    void init_long_integer(uint64_t val, bool is_unsigned)
+    {
+        long_integer_block* block = static_cast<long_integer_block*>(allocate_words(words_for(sizeof(long_integer_block))));
+        block->value_ = val;
+        block->is_unsigned_ = is_unsigned;
+        bits_ = boxed(kind::long_integer_k, to_payload(block));
+    }
+
+    void init_double(double val)
+    {
+        if (val != val)
+        {
+            bits_ = quiet_nan_bits;
+        }
+        else
+        {
+            std::memcpy(&bits_, &val, sizeof(double));
+        }
+    }
+
+    void init_string(const char_type* s, size_t length)
+    {
+        if (length <= short_string_capacity)
+        {
+            bits_ = boxed(kind::short_string_k, 0);
+            unsigned char* bytes = reinterpret_cast<unsigned char*>(&bits_) + payload_offset();
+            std::memcpy(bytes, s, length*sizeof(char_type));
+            bytes[5] = static_cast<unsigned char>(length);
+        }
+        else
+        {
+            string_block* block = static_cast<string_block*>(allocate_words(string_words(length)));
+            block->length_ = length;
+            char_type* p = string_chars(block);
+            std::memcpy(p, s, length*sizeof(char_type));
+            p[length] = 0;
+            bits_ = boxed(kind::string_k, to_payload(block));
+        }
+    }
+
+    // If an element fails to copy, those copied so far are destroyed and the block freed
+    void init_copy(const basic_compact_json& val)
+    {
+        bits_ = val.bits_;
+        if (!val.is_boxed())
+        {
+            return;
+        }
+        switch (val.get_kind())
+        {
+        case kind::string_k:
+            init_string(string_chars(val.string()), val.string()->length_);
+            break;
+        case kind::long_integer_k:
+            init_long_integer(val.long_integer()->value_, val.long_integer()->is_unsigned_);
+            break;
+        case kind::array_k:
+            {
+                const size_t n = val.array()->size_;
+                array_block* block = allocate_array(n);
+                bits_ = boxed(kind::array_k, to_payload(block));
+                const basic_compact_json* source = elements_of(val.array());
+                try
+                {
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        new(elements_of(block) + i)basic_compact_json(source[i]);
+                        ++block->size_;
+                    }
+                }
+                catch (...)
+                {
+                    destroy();
+                    bits_ = boxed(kind::null_k, 0);
+                    throw;
+                }
+            }
+            break;
+        case kind::object_k:
+            {
+                const size_t n = val.object()->size_;
+                object_block* block = allocate_object(n);
+                bits_ = boxed(kind::object_k, to_payload(block));
+                const member* source = members_of(val.object());
+                try
+                {
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        new(members_of(block) + i)member(source[i]);
+                        ++block->size_;
+                    }
+                }
+                catch (...)
+                {
+                    destroy();
+                    bits_ = boxed(kind::null_k, 0);
+                    throw;
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    void destroy()
+    {
+        if (!is_boxed())
+        {
+            return;
+        }
+        switch (get_kind())
+        {
+        case kind::string_k:
+            deallocate_words(string(), string_words(string()->length_));
+            break;
+        case kind::long_integer_k:
+            deallocate_words(long_integer(), words_for(sizeof(long_integer_block)));
+            break;
+        case kind::array_k:
+            {
+                array_block* block = array();
+                basic_compact_json* elements = elements_of(block);
+                for (size_t i = 0; i < block->size_; ++i)
+                {
+                    elements[i].~basic_compact_json();
+                }
+                deallocate_words(block, array_words(block->capacity_));
+            }
+            break;
+        case kind::object_k:
+            {
+                object_block* block = object();
+                member* members = members_of(block);
+                for (size_t i = 0; i < block->size_; ++i)
+                {
+                    members[i].~member();
+                }
+                deallocate_words(block, object_words(block->capacity_));
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    // Values are moved to a new block by their bits, as they own nothing that refers back
+    void grow_array(size_t capacity)
+    {
+        array_block* block = array();
+        array_block* new_block = allocate_array(capacity);
+        std::memcpy(static_cast<void*>(elements_of(new_block)), static_cast<const void*>(elements_of(block)), block->size_*sizeof(basic_compact_json));
+        new_block->size_ = block->size_;
+        deallocate_words(block, array_words(block->capacity_));
+        bits_ = boxed(kind::array_k, to_payload(new_block));
+    }
+
+    void grow_object(size_t capacity)
+    {
+        object_block* block = object();
+        object_block* new_block = allocate_object(capacity);
+        std::memcpy(static_cast<void*>(members_of(new_block)), static_cast<const void*>(members_of(block)), block->size_*sizeof(member));
+        new_block->size_ = block->size_;
+        deallocate_words(block, object_words(block->capacity_));
+        bits_ = boxed(kind::object_k, to_payload(new_block));
+    }
+
+    template <class C, class A>
+    friend class basic_compact_json_decoder;
+};
+
+// A member of an object, a name held as a string value and the value
+
+template <class CharT, class Allocator>
+class basic_compact_json<CharT,Allocator>::member
+{
+    basic_compact_json key_;
+    basic_compact_json value_;
+public:
+    member(basic_compact_json&& key, basic_compact_json&& value)
+        : key_(std::move(key)), value_(std::move(value))
+    {
+    }
+
+    string_view_type key() const
+    {
+        return key_.as_string_view();
+    }
+
+    basic_compact_json& value()
+    {
+        return value_;
+    }
+
+    const basic_compact_json& value() const
+    {
+        return value_;
+    }
+
+    friend bool operator==(const member& lhs, const member& rhs)
+    {
+        return lhs.key() == rhs.key() && lhs.value_ == rhs.value_;
+    }
+};
+
+// basic_compact_json_decoder
+// Builds a basic_compact_json from parse events. Values are collected on a stack and
+// moved into a block of the exact size when their array or object ends.
+
+template <class CharT, class Allocator = std::allocator<char>>
+class basic_compact_json_decoder final : public basic_json_input_handler<CharT>
+{
+public:
+    using typename basic_json_input_handler<CharT>::string_view_type;
+    typedef basic_compact_json<CharT,Allocator> value_type;
+private:
+    typedef typename value_type::member member;
+
+    struct stack_item
+    {
+        value_type name_;
+        value_type value_;
+    };
+
+    struct structure
+    {
+        size_t offset_;
+        bool is_object_;
+    };
+
+    std::vector<stack_item> stack_;
+    std::vector<structure> structures_;
+    value_type name_;
+    value_type result_;
+    bool is_valid_;
+public:
+    basic_compact_json_decoder()
+        : is_valid_(false)
+    {
+    }
+
+    bool is_valid() const
+    {
+        return is_valid_;
+    }
+
+    value_type get_result()
+    {
+        is_valid_ = false;
+        return std::move(result_);
+    }
+
+    void reset()
+    {
+        stack_.clear();
+        structures_.clear();
+        is_valid_ = false;
+    }
+private:
+    void do_begin_json() override
+    {
+        is_valid_ = false;
+    }
+
+    void do_end_json() override
+    {
+        if (!stack_.empty())
+        {
+            result_ = std::move(stack_.back().value_);
+            stack_.clear();
+        }
+        is_valid_ = true;
+    }
+
+    void do_begin_object(const parsing_context&) override
+    {
+        structures_.push_back(structure{stack_.size(), true});
+        add_value(value_type());
+    }
+
+    void do_end_object(const parsing_context&) override
+    {
+        const size_t offset = structures_.back().offset_;
+        structures_.pop_back();
+        auto first = stack_.begin() + (offset + 1);
+        auto last = stack_.end();
+        std::stable_sort(first, last,
+                         [](const stack_item& a, const stack_item& b){return a.name_.as_string_view() < b.name_.as_string_view();});
+        // The last of members with the same name wins, as in basic_json
+        size_t count = 0;
+        for (auto it = first; it != last; ++it)
+        {
+            if (it + 1 == last || it->name_.as_string_view() != (it + 1)->name_.as_string_view())
+            {
+                ++count;
+            }
+        }
+        value_type val = value_type::make_object(count);
+        typename value_type::object_block* block = val.object();
+        for (auto it = first; it != last; ++it)
+        {
+            if (it + 1 == last || it->name_.as_string_view() != (it + 1)->name_.as_string_view())
+            {
+                new(value_type::members_of(block) + block->size_)member(std::move(it->name_), std::move(it->value_));
+                ++block->size_;
+            }
+        }
+        stack_.erase(first, last);
+        stack_.back().value_ = std::move(val);
+    }
+
+    void do_begin_array(const parsing_context&) override
+    {
+        structures_.push_back(structure{stack_.size(), false});
+        add_value(value_type());
+    }
+
+    void do_end_array(const parsing_context&) override
+    {
+        const size_t offset = structures_.back().offset_;
+        structures_.pop_back();
+        auto first = stack_.begin() + (offset + 1);
+        auto last = stack_.end();
+        value_type val = value_type::make_array(last - first);
+        typename value_type::array_block* block = val.array();
+        for (auto it = first; it != last; ++it)
+        {
+            new(value_type::elements_of(block) + block->size_)value_type(std::move(it->value_));
+            ++block->size_;
+        }
+        stack_.erase(first, last);
+        stack_.back().value_ = std::move(val);
+    }
+
+    void do_name(const string_view_type& name, const parsing_context&) override
+    {
+        name_ = value_type(name);
+    }
+
+    void do_string_value(const string_view_type& value, const parsing_context&) override
+    {
+        add_value(value_type(value));
+    }
+
+    void do_byte_string_value(const uint8_t* data, size_t length, const parsing_context&) override
+    {
+        std::basic_string<CharT> s(encoded_base64url_length(length), CharT());
+        s.resize(encode_base64url(data, length, &s[0]));
+        add_value(value_type(s));
+    }
+
+    void do_integer_value(int64_t value, const parsing_context&) override
+    {
+        add_value(value_type(value));
+    }
+
+    void do_uinteger_value(uint64_t value, const parsing_context&) override
+    {
+        add_value(value_type(value));
+    }
+
+    void do_double_value(double value, uint8_t, const parsing_context&) override
+    {
+        add_value(value_type(value));
+    }
+
+    void do_bool_value(bool value, const parsing_context&) override
+    {
+        add_value(value_type(value));
+    }
+
+    void do_null_value(const parsing_context&) override
+    {
+        add_value(value_type());
+    }
+
+    void add_value(value_type&& val)
+    {
+        stack_.push_back(stack_item{std::move(name_), std::move(val)});
+    }
+};
+
+typedef basic_compact_json<char> compact_json;
+typedef basic_compact_json<wchar_t> wcompact_json;
+typedef basic_compact_json_decoder<char> compact_json_decoder;
+typedef basic_compact_json_decoder<wchar_t> wcompact_json_decoder;
+
+// Converts a basic_json value to a compact one
+template <class Json>
+basic_compact_json<typename Json::char_type> compact(const Json& val)
+{
+    basic_compact_json_decoder<typename Json::char_type> decoder;
+    basic_json_output_input_handler_adapter<typename Json::char_type> adapter(decoder);
+    val.dump(adapter);
+    return decoder.get_result();
+}
+
+template <class CharT, class Allocator>
+basic_compact_json<CharT,Allocator> basic_compact_json<CharT,Allocator>::parse(const string_view_type& s)
+{
+    auto result = unicons::skip_bom(s.begin(), s.end());
+    if (result.ec != unicons::encoding_errc())
+    {
+        throw parse_error(result.ec,1,1);
+    }
+    size_t offset = result.it - s.begin();
+
+    basic_compact_json_decoder<CharT,Allocator> decoder;
+    basic_json_parser<CharT,basic_compact_json_decoder<CharT,Allocator>> parser(decoder);
+    parser.set_source(s.data() + offset, s.size() - offset);
+    parser.parse();
+    parser.end_parse();
+    parser.check_done();
+    if (!decoder.is_valid())
+    {
+        JSONCONS_THROW_EXCEPTION(std::runtime_error,"Failed to parse json string");
+    }
+    return decoder.get_result();
+}
+
+template <class CharT, class Allocator>
+basic_compact_json<CharT,Allocator> basic_compact_json<CharT,Allocator>::parse(std::basic_istream<char_type>& is)
+{
+    basic_compact_json_decoder<CharT,Allocator> decoder;
+    basic_json_reader<CharT> reader(is, decoder);
+    reader.read();
+    reader.check_done();
+    if (!decoder.is_valid())
+    {
+        JSONCONS_THROW_EXCEPTION(std::runtime_error,"Failed to parse json stream");
+    }
+    return decoder.get_result();
+}
+
+namespace detail {
+
+template <class T, class Compact, class Enable = void>
+struct compact_json_as
+{
+    static T as(const Compact& val)
+    {
+        return val.template as<basic_json<typename Compact::char_type>>().template as<T>();
+    }
+};
+
+template <class Json, class Compact>
+struct compact_json_as<Json, Compact, typename std::enable_if<is_basic_json<Json>::value>::type>
+{
+    static Json as(const Compact& val)
+    {
+        json_decoder<Json> decoder;
+        basic_json_output_input_handler_adapter<typename Compact::char_type> adapter(decoder);
+        val.dump(adapter);
+        return decoder.get_result();
+    }
+};
+
+template <class Compact>
+struct compact_json_as<bool, Compact>
+{
+    static bool as(const Compact& val)
+    {
+        return val.as_bool();
+    }
+};
+
+template <class T, class Compact>
+struct compact_json_as<T, Compact, typename std::enable_if<is_integer_like<T>::value>::type>
+{
+    static T as(const Compact& val)
+    {
+        return static_cast<T>(val.as_integer());
+    }
+};
+
+template <class T, class Compact>
+struct compact_json_as<T, Compact, typename std::enable_if<is_uinteger_like<T>::value>::type>
+{
+    static T as(const Compact& val)
+    {
+        return static_cast<T>(val.as_uinteger());
+    }
+};
+
+template <class T, class Compact>
+struct compact_json_as<T, Compact, typename std::enable_if<is_floating_point_like<T>::value>::type>
+{
+    static T as(const Compact& val)
+    {
+        return static_cast<T>(val.as_double());
+    }
+};
+
+template <class Compact>
+struct compact_json_as<std::basic_string<typename Compact::char_type>, Compact>
+{
+    static std::basic_string<typename Compact::char_type> as(const Compact& val)
+    {
+        return val.as_string();
+    }
+};
+
+}
+
+template <class CharT, class Allocator>
+template <class T>
+T basic_compact_json<CharT,Allocator>::as() const
+{
+    return detail::compact_json_as<T,basic_compact_json>::as(*this);
+}
+
+}
+
+#endif
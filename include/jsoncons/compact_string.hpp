@@ -0,0 +1,348 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_COMPACT_STRING_HPP
+#define JSONCONS_COMPACT_STRING_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <iterator>
+#include <ostream>
+#include <type_traits>
+#include <jsoncons/detail/jsoncons_config.hpp>
+#include <jsoncons/detail/type_traits_helper.hpp>
+
+namespace jsoncons {
+
+// A string in 16 bytes (plus the allocator, if it has state), half a std::string. Up to
+// inline_capacity characters are held in place, 14 for char, and longer strings in a block
+// with their length. The last byte tells which: the number of characters in place, or
+// heap_tag. Used as the key_storage of compact_policy, where it makes a member of an
+// object 32 bytes rather than 48, and names of up to 14 characters allocate nothing.
+
+template <class CharT, class CharTraits = std::char_traits<CharT>, class Allocator = std::allocator<CharT>>
+class basic_compact_string
+{
+    static const size_t storage_size = 16;
+    static const unsigned char heap_tag = 0xFF;
+public:
+    static const size_t inline_capacity = (storage_size - 1)/sizeof(CharT) - 1;
+private:
+    struct header
+    {
+        size_t length_;
+    };
+
+    union storage_unit
+    {
+        size_t count_;
+        void* p_;
+    };
+
+    typedef typename std::allocator_traits<Allocator>:: template rebind_alloc<storage_unit> storage_allocator_type;
+    typedef std::allocator_traits<storage_allocator_type> storage_traits;
+    typedef typename storage_traits::pointer storage_pointer;
+
+    static_assert(std::is_pointer<storage_pointer>::value, "basic_compact_string needs an allocator with plain pointers");
+    static_assert(inline_capacity < heap_tag, "inline_capacity must fit in the tag byte");
+
+    // Derives from the allocator so that a stateless one takes no space
+    struct impl : storage_allocator_type
+    {
+        union
+        {
+            storage_pointer ptr_;
+            CharT chars_[storage_size/sizeof(CharT)];
+            unsigned char bytes_[storage_size];
+        };
+
+        impl(const storage_allocator_type& a)
+            : storage_allocator_type(a)
+        {
+            std::memset(bytes_, 0, storage_size);
+        }
+    };
+
+    impl impl_;
+public:
+    typedef CharT value_type;
+    typedef CharTraits traits_type;
+    typedef Allocator allocator_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef const CharT& reference;
+    typedef const CharT& const_reference;
+    typedef const CharT* pointer;
+    typedef const CharT* const_pointer;
+    typedef const CharT* iterator;
+    typedef const CharT* const_iterator;
+#if !defined(JSONCONS_HAS_STRING_VIEW)
+    typedef Basic_string_view_<CharT,CharTraits> string_view_type;
+#else
+    typedef std::basic_string_view<CharT,CharTraits> string_view_type;
+#endif
+
+    basic_compact_string()
+        : impl_(storage_allocator_type())
+    {
+    }
+
+    explicit basic_compact_string(const Allocator& a)
+        : impl_(storage_allocator_type(a))
+    {
+    }
+
+    basic_compact_string(const CharT* s, size_t length, const Allocator& a = Allocator())
+        : impl_(storage_allocator_type(a))
+    {
+        create(s, length);
+    }
+
+    basic_compact_string(const CharT* s, const Allocator& a = Allocator())
+        : impl_(storage_allocator_type(a))
+    {
+        create(s, CharTraits::length(s));
+    }
+
+    template <class ForwardIt, class = typename std::enable_if<!std::is_integral<ForwardIt>::value>::type>
+    basic_compact_string(ForwardIt first, ForwardIt last, const Allocator& a = Allocator())
+        : impl_(storage_allocator_type(a))
+    {
+        const size_t length = static_cast<size_t>(std::distance(first, last));
+        CharT* p = reserve(length);
+        std::copy(first, last, p);
+        p[length] = 0;
+    }
+
+    template <class StringAllocator>
+    explicit basic_compact_string(const std::basic_string<CharT,CharTraits,StringAllocator>& s, const Allocator& a = Allocator())
+        : impl_(storage_allocator_type(a))
+    {
+        create(s.data(), s.length());
+    }
+
+    basic_compact_string(const basic_compact_string& other)
+        : impl_(storage_traits::select_on_container_copy_construction(other.impl_))
+    {
+        create(other.data(), other.length());
+    }
+
+    basic_compact_string(const basic_compact_string& other, const Allocator& a)
+        : impl_(storage_allocator_type(a))
+    {
+        create(other.data(), other.length());
+    }
+
+    basic_compact_string(basic_compact_string&& other) JSONCONS_NOEXCEPT
+        : impl_(other.impl_)
+    {
+        other.set_empty();
+    }
+
+    basic_compact_string(basic_compact_string&& other, const Allocator& a)
+        : impl_(storage_allocator_type(a))
+    {
+        if (!other.is_heap() || static_cast<const storage_allocator_type&>(impl_) == static_cast<const storage_allocator_type&>(other.impl_))
+        {
+            std::memcpy(impl_.bytes_, other.impl_.bytes_, storage_size);
+            other.set_empty();
+        }
+        else
+        {
+            create(other.data(), other.length());
+        }
+    }
+
+    ~basic_compact_string()
+    {
+        release();
+    }
+
+    basic_compact_string& operator=(const basic_compact_string& other)
+    {
+        if (this != &other)
+        {
+            basic_compact_string temp(other, get_allocator());
+            swap(temp);
+        }
+        return *this;
+    }
+
+    basic_compact_string& operator=(basic_compact_string&& other)
+    {
+        if (this != &other)
+        {
+            basic_compact_string temp(std::move(other), get_allocator());
+            swap(temp);
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const
+    {
+        return allocator_type(static_cast<const storage_allocator_type&>(impl_));
+    }
+
+    const CharT* data() const
+    {
+        return is_heap() ? heap_chars() : impl_.chars_;
+    }
+
+    const CharT* c_str() const
+    {
+        return data();
+    }
+
+    size_t size() const
+    {
+        return is_heap() ? get_header()->length_ : impl_.bytes_[storage_size - 1];
+    }
+
+    size_t length() const
+    {
+        return size();
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    const_iterator begin() const
+    {
+        return data();
+    }
+
+    const_iterator end() const
+    {
+        return data() + size();
+    }
+
+    // True if the characters are held in place
+    bool is_inline() const
+    {
+        return !is_heap();
+    }
+
+    void swap(basic_compact_string& other) JSONCONS_NOEXCEPT
+    {
+        if (storage_traits::propagate_on_container_swap::value)
+        {
+            std::swap(static_cast<storage_allocator_type&>(impl_), static_cast<storage_allocator_type&>(other.impl_));
+        }
+        unsigned char temp[storage_size];
+        std::memcpy(temp, impl_.bytes_, storage_size);
+        std::memcpy(impl_.bytes_, other.impl_.bytes_, storage_size);
+        std::memcpy(other.impl_.bytes_, temp, storage_size);
+    }
+
+    void shrink_to_fit()
+    {
+    }
+
+    int compare(const basic_compact_string& other) const
+    {
+        return string_view_type(*this).compare(string_view_type(other));
+    }
+
+    operator string_view_type() const JSONCONS_NOEXCEPT
+    {
+        return string_view_type(data(), size());
+    }
+
+    friend bool operator==(const basic_compact_string& lhs, const basic_compact_string& rhs)
+    {
+        return lhs.size() == rhs.size() && CharTraits::compare(lhs.data(), rhs.data(), lhs.size()) == 0;
+    }
+
+    friend bool operator!=(const basic_compact_string& lhs, const basic_compact_string& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    friend bool operator<(const basic_compact_string& lhs, const basic_compact_string& rhs)
+    {
+        return lhs.compare(rhs) < 0;
+    }
+
+    friend std::basic_ostream<CharT>& operator<<(std::basic_ostream<CharT>& os, const basic_compact_string& s)
+    {
+        os.write(s.data(), s.size());
+        return os;
+    }
+
+    friend void swap(basic_compact_string& a, basic_compact_string& b) JSONCONS_NOEXCEPT
+    {
+        a.swap(b);
+    }
+private:
+    bool is_heap() const
+    {
+        return impl_.bytes_[storage_size - 1] == heap_tag;
+    }
+
+    void set_empty()
+    {
+        std::memset(impl_.bytes_, 0, storage_size);
+    }
+
+    static size_t units_needed(size_t length)
+    {
+        return (sizeof(header) + (length+1)*sizeof(CharT) + sizeof(storage_unit) - 1)/sizeof(storage_unit);
+    }
+
+    header* get_header() const
+    {
+        return reinterpret_cast<header*>(impl_.ptr_);
+    }
+
+    CharT* heap_chars() const
+    {
+        return reinterpret_cast<CharT*>(reinterpret_cast<char*>(impl_.ptr_) + sizeof(header));
+    }
+
+    // Makes room for length characters and the terminating null, and returns where they go
+    CharT* reserve(size_t length)
+    {
+        if (length <= inline_capacity)
+        {
+            impl_.bytes_[storage_size - 1] = static_cast<unsigned char>(length);
+            return impl_.chars_;
+        }
+        impl_.ptr_ = storage_traits::allocate(impl_, units_needed(length));
+        new(reinterpret_cast<void*>(impl_.ptr_))header{length};
+        impl_.bytes_[storage_size - 1] = heap_tag;
+        return heap_chars();
+    }
+
+    void create(const CharT* s, size_t length)
+    {
+        CharT* p = reserve(length);
+        std::memcpy(p, s, length*sizeof(CharT));
+        p[length] = 0;
+    }
+
+    void release()
+    {
+        if (is_heap())
+        {
+            storage_traits::deallocate(impl_, impl_.ptr_, units_needed(get_header()->length_));
+            set_empty();
+        }
+    }
+};
+
+template <class CharT, class CharTraits, class Allocator>
+const size_t basic_compact_string<CharT,CharTraits,Allocator>::inline_capacity;
+
+typedef basic_compact_string<char> compact_string;
+typedef basic_compact_string<wchar_t> wcompact_string;
+
+}
+
+#endif
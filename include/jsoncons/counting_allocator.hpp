@@ -0,0 +1,129 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_COUNTING_ALLOCATOR_HPP
+#define JSONCONS_COUNTING_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <jsoncons/detail/jsoncons_config.hpp>
+
+namespace jsoncons {
+
+// Counts of allocations made through counting_allocators that share it
+
+struct allocation_stats
+{
+    size_t allocations;
+    size_t deallocations;
+    size_t bytes_allocated;
+    size_t bytes_in_use;
+    size_t peak_bytes_in_use;
+
+    allocation_stats()
+        : allocations(0),
+          deallocations(0),
+          bytes_allocated(0),
+          bytes_in_use(0),
+          peak_bytes_in_use(0)
+    {
+    }
+
+    // Clears the counts, and makes the peak the bytes currently in use
+    void reset()
+    {
+        allocations = 0;
+        deallocations = 0;
+        bytes_allocated = 0;
+        peak_bytes_in_use = bytes_in_use;
+    }
+};
+
+// An allocator that allocates with std::allocator and records each allocation and
+// deallocation in an allocation_stats. Use it as the Allocator template parameter of
+// basic_json (e.g. basic_json<char,sorted_policy,counting_allocator<char>>) to see what
+// building a document costs. The counts are not synchronized, an allocation_stats should
+// be used by one thread at a time.
+
+template <class T>
+class counting_allocator
+{
+    template <class U> friend class counting_allocator;
+
+    allocation_stats* stats_;
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    template <class U>
+    struct rebind
+    {
+        typedef counting_allocator<U> other;
+    };
+
+    counting_allocator(allocation_stats& stats) JSONCONS_NOEXCEPT
+        : stats_(&stats)
+    {
+    }
+
+    template <class U>
+    counting_allocator(const counting_allocator<U>& other) JSONCONS_NOEXCEPT
+        : stats_(other.stats_)
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        T* p = std::allocator<T>().allocate(n);
+        const size_t bytes = n*sizeof(T);
+        ++stats_->allocations;
+        stats_->bytes_allocated += bytes;
+        stats_->bytes_in_use += bytes;
+        if (stats_->bytes_in_use > stats_->peak_bytes_in_use)
+        {
+            stats_->peak_bytes_in_use = stats_->bytes_in_use;
+        }
+        return p;
+    }
+
+    void deallocate(T* p, size_t n) JSONCONS_NOEXCEPT
+    {
+        std::allocator<T>().deallocate(p, n);
+        ++stats_->deallocations;
+        stats_->bytes_in_use -= n*sizeof(T);
+    }
+
+    allocation_stats& get_stats() const
+    {
+        return *stats_;
+    }
+
+    template <class U>
+    bool operator==(const counting_allocator<U>& other) const JSONCONS_NOEXCEPT
+    {
+        return stats_ == other.stats_;
+    }
+
+    template <class U>
+    bool operator!=(const counting_allocator<U>& other) const JSONCONS_NOEXCEPT
+    {
+        return stats_ != other.stats_;
+    }
+};
+
+}
+
+#endif
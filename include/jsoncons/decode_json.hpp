@@ -0,0 +1,1431 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_DECODE_JSON_HPP
+#define JSONCONS_DECODE_JSON_HPP
+
+#include <algorithm>
+#include <array>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/json_input_handler.hpp>
+#include <jsoncons/json_member_traits.hpp>
+#include <jsoncons/json_parser.hpp>
+#include <jsoncons/json_reader.hpp>
+#include <jsoncons/parse_error_handler.hpp>
+
+namespace jsoncons {
+
+// decode_frame
+
+// Receives the events inside an object or array that is being decoded into a value.
+// begin_object and begin_array return the frame for a nested container, or null when
+// this frame receives its events itself. end_object and end_array return true when
+// the container of this frame has ended.
+
+template <class CharT>
+class decode_frame
+{
+public:
+    typedef typename basic_json_input_handler<CharT>::string_view_type string_view_type;
+
+    virtual ~decode_frame() = default;
+
+    virtual std::unique_ptr<decode_frame> begin_object(const parsing_context& context) = 0;
+    virtual std::unique_ptr<decode_frame> begin_array(const parsing_context& context) = 0;
+    virtual bool end_object(const parsing_context& context) = 0;
+    virtual bool end_array(const parsing_context& context) = 0;
+    virtual void name(const string_view_type& name, const parsing_context& context) = 0;
+    virtual void string_value(const string_view_type& value, const parsing_context& context) = 0;
+    virtual void byte_string_value(const uint8_t* data, size_t length, const parsing_context& context) = 0;
+    virtual void integer_value(int64_t value, const parsing_context& context) = 0;
+    virtual void uinteger_value(uint64_t value, const parsing_context& context) = 0;
+    virtual void double_value(double value, uint8_t precision, const parsing_context& context) = 0;
+    virtual void bool_value(bool value, const parsing_context& context) = 0;
+    virtual void null_value(const parsing_context& context) = 0;
+};
+
+namespace detail {
+
+inline void throw_invalid_value(const parsing_context& context)
+{
+    throw parse_error(json_parser_errc::invalid_value, context.line_number(), context.column_number());
+}
+
+template <class T, class Json>
+void assign_from_json(T& val, const Json& j, const parsing_context& context)
+{
+    if (!j.template is<T>())
+    {
+        throw_invalid_value(context);
+    }
+    val = j.template as<T>();
+}
+
+// Rejects every event, for decode_traits that accept only some
+
+template <class T, class CharT>
+struct decode_traits_base
+{
+    typedef typename decode_frame<CharT>::string_view_type string_view_type;
+
+    static void string_value(T&, const string_view_type&, const parsing_context& context)
+    {
+        throw_invalid_value(context);
+    }
+    static void byte_string_value(T&, const uint8_t*, size_t, const parsing_context& context)
+    {
+        throw_invalid_value(context);
+    }
+    static void integer_value(T&, int64_t, const parsing_context& context)
+    {
+        throw_invalid_value(context);
+    }
+    static void uinteger_value(T&, uint64_t, const parsing_context& context)
+    {
+        throw_invalid_value(context);
+    }
+    static void double_value(T&, double, uint8_t, const parsing_context& context)
+    {
+        throw_invalid_value(context);
+    }
+    static void bool_value(T&, bool, const parsing_context& context)
+    {
+        throw_invalid_value(context);
+    }
+    static void null_value(T&, const parsing_context& context)
+    {
+        throw_invalid_value(context);
+    }
+    static std::unique_ptr<decode_frame<CharT>> begin_object(T&, const parsing_context& context)
+    {
+        throw_invalid_value(context);
+        return nullptr;
+    }
+    static std::unique_ptr<decode_frame<CharT>> begin_array(T&, const parsing_context& context)
+    {
+        throw_invalid_value(context);
+        return nullptr;
+    }
+};
+
+// Builds a basic_json from the events of a nested container and converts it with
+// json_type_traits when the container ends
+
+template <class T, class CharT>
+class json_value_frame : public decode_frame<CharT>
+{
+    typedef basic_json<CharT> json_type;
+public:
+    using typename decode_frame<CharT>::string_view_type;
+private:
+    T& val_;
+    json_decoder<json_type> decoder_;
+    size_t depth_;
+public:
+    json_value_frame(T& val)
+        : val_(val), depth_(0)
+    {
+        decoder_.begin_json();
+    }
+
+    std::unique_ptr<decode_frame<CharT>> begin_object(const parsing_context& context) override
+    {
+        ++depth_;
+        decoder_.begin_object(context);
+        return nullptr;
+    }
+
+    std::unique_ptr<decode_frame<CharT>> begin_array(const parsing_context& context) override
+    {
+        ++depth_;
+        decoder_.begin_array(context);
+        return nullptr;
+    }
+
+    bool end_object(const parsing_context& context) override
+    {
+        decoder_.end_object(context);
+        return end_container(context);
+    }
+
+    bool end_array(const parsing_context& context) override
+    {
+        decoder_.end_array(context);
+        return end_container(context);
+    }
+
+    void name(const string_view_type& name, const parsing_context& context) override
+    {
+        decoder_.name(name, context);
+    }
+
+    void string_value(const string_view_type& value, const parsing_context& context) override
+    {
+        decoder_.string_value(value, context);
+    }
+
+    void byte_string_value(const uint8_t* data, size_t length, const parsing_context& context) override
+    {
+        decoder_.byte_string_value(data, length, context);
+    }
+
+    void integer_value(int64_t value, const parsing_context& context) override
+    {
+        decoder_.integer_value(value, context);
+    }
+
+    void uinteger_value(uint64_t value, const parsing_context& context) override
+    {
+        decoder_.uinteger_value(value, context);
+    }
+
+    void double_value(double value, uint8_t precision, const parsing_context& context) override
+    {
+        decoder_.double_value(value, precision, context);
+    }
+
+    void bool_value(bool value, const parsing_context& context) override
+    {
+        decoder_.bool_value(value, context);
+    }
+
+    void null_value(const parsing_context& context) override
+    {
+        decoder_.null_value(context);
+    }
+private:
+    bool end_container(const parsing_context& context)
+    {
+        if (--depth_ > 0)
+        {
+            return false;
+        }
+        decoder_.end_json();
+        assign_from_json(val_, decoder_.get_result(), context);
+        return true;
+    }
+};
+
+// Skips the value of a member that T does not have
+
+template <class CharT>
+class skip_frame : public decode_frame<CharT>
+{
+    size_t depth_;
+public:
+    using typename decode_frame<CharT>::string_view_type;
+
+    skip_frame()
+        : depth_(1)
+    {
+    }
+
+    std::unique_ptr<decode_frame<CharT>> begin_object(const parsing_context&) override
+    {
+        ++depth_;
+        return nullptr;
+    }
+
+    std::unique_ptr<decode_frame<CharT>> begin_array(const parsing_context&) override
+    {
+        ++depth_;
+        return nullptr;
+    }
+
+    bool end_object(const parsing_context&) override
+    {
+        return --depth_ == 0;
+    }
+
+    bool end_array(const parsing_context&) override
+    {
+        return --depth_ == 0;
+    }
+
+    void name(const string_view_type&, const parsing_context&) override {}
+    void string_value(const string_view_type&, const parsing_context&) override {}
+    void byte_string_value(const uint8_t*, size_t, const parsing_context&) override {}
+    void integer_value(int64_t, const parsing_context&) override {}
+    void uinteger_value(uint64_t, const parsing_context&) override {}
+    void double_value(double, uint8_t, const parsing_context&) override {}
+    void bool_value(bool, const parsing_context&) override {}
+    void null_value(const parsing_context&) override {}
+};
+
+}
+
+// decode_traits
+
+// Decodes the parse events of a value straight into a T. The default builds a
+// basic_json for the value and converts it with json_type_traits, the specializations
+// below assign numbers, bools, strings, the elements of sequence containers, std::array,
+// std::tuple and std::pair, the values of maps with string keys, and the members of
+// structs with json_member_traits without one. Events that do not fit T throw
+// parse_error with json_parser_errc::invalid_value.
+
+template <class T, class CharT, class Enable = void>
+struct decode_traits
+{
+    typedef basic_json<CharT> json_type;
+    typedef typename decode_frame<CharT>::string_view_type string_view_type;
+
+    static void string_value(T& val, const string_view_type& value, const parsing_context& context)
+    {
+        detail::assign_from_json(val, json_type(value.data(), value.length()), context);
+    }
+    static void byte_string_value(T& val, const uint8_t* data, size_t length, const parsing_context& context)
+    {
+        detail::assign_from_json(val, json_type(data, length), context);
+    }
+    static void integer_value(T& val, int64_t value, const parsing_context& context)
+    {
+        detail::assign_from_json(val, json_type(value), context);
+    }
+    static void uinteger_value(T& val, uint64_t value, const parsing_context& context)
+    {
+        detail::assign_from_json(val, json_type(value), context);
+    }
+    static void double_value(T& val, double value, uint8_t precision, const parsing_context& context)
+    {
+        detail::assign_from_json(val, json_type(value, precision), context);
+    }
+    static void bool_value(T& val, bool value, const parsing_context& context)
+    {
+        detail::assign_from_json(val, json_type(value), context);
+    }
+    static void null_value(T& val, const parsing_context& context)
+    {
+        detail::assign_from_json(val, json_type::null(), context);
+    }
+    static std::unique_ptr<decode_frame<CharT>> begin_object(T& val, const parsing_context& context)
+    {
+        std::unique_ptr<decode_frame<CharT>> frame(new detail::json_value_frame<T,CharT>(val));
+        frame->begin_object(context);
+        return frame;
+    }
+    static std::unique_ptr<decode_frame<CharT>> begin_array(T& val, const parsing_context& context)
+    {
+        std::unique_ptr<decode_frame<CharT>> frame(new detail::json_value_frame<T,CharT>(val));
+        frame->begin_array(context);
+        return frame;
+    }
+};
+
+// integer
+
+template <class T, class CharT>
+struct decode_traits<T, CharT,
+    typename std::enable_if<detail::is_integer_like<T>::value
+>::type> : detail::decode_traits_base<T,CharT>
+{
+    static void integer_value(T& val, int64_t value, const parsing_context& context)
+    {
+        if (value < static_cast<int64_t>((std::numeric_limits<T>::min)()) ||
+            value > static_cast<int64_t>((std::numeric_limits<T>::max)()))
+        {
+            detail::throw_invalid_value(context);
+        }
+        val = static_cast<T>(value);
+    }
+    static void uinteger_value(T& val, uint64_t value, const parsing_context& context)
+    {
+        if (value > static_cast<uint64_t>((std::numeric_limits<T>::max)()))
+        {
+            detail::throw_invalid_value(context);
+        }
+        val = static_cast<T>(value);
+    }
+};
+
+// uinteger
+
+template <class T, class CharT>
+struct decode_traits<T, CharT,
+    typename std::enable_if<detail::is_uinteger_like<T>::value
+>::type> : detail::decode_traits_base<T,CharT>
+{
+    static void integer_value(T& val, int64_t value, const parsing_context& context)
+    {
+        if (value < 0 || static_cast<uint64_t>(value) > static_cast<uint64_t>((std::numeric_limits<T>::max)()))
+        {
+            detail::throw_invalid_value(context);
+        }
+        val = static_cast<T>(value);
+    }
+    static void uinteger_value(T& val, uint64_t value, const parsing_context& context)
+    {
+        if (value > static_cast<uint64_t>((std::numeric_limits<T>::max)()))
+        {
+            detail::throw_invalid_value(context);
+        }
+        val = static_cast<T>(value);
+    }
+};
+
+// double
+
+template <class T, class CharT>
+struct decode_traits<T, CharT,
+    typename std::enable_if<detail::is_floating_point_like<T>::value
+>::type> : detail::decode_traits_base<T,CharT>
+{
+    static void integer_value(T& val, int64_t value, const parsing_context&)
+    {
+        val = static_cast<T>(value);
+    }
+    static void uinteger_value(T& val, uint64_t value, const parsing_context&)
+    {
+        val = static_cast<T>(value);
+    }
+    static void double_value(T& val, double value, uint8_t, const parsing_context&)
+    {
+        val = static_cast<T>(value);
+    }
+};
+
+// bool
+
+template <class CharT>
+struct decode_traits<bool, CharT> : detail::decode_traits_base<bool,CharT>
+{
+    static void bool_value(bool& val, bool value, const parsing_context&)
+    {
+        val = value;
+    }
+};
+
+// string
+
+template <class T, class CharT>
+struct decode_traits<T, CharT,
+    typename std::enable_if<detail::is_string_like<T>::value &&
+                            std::is_same<typename T::value_type,CharT>::value
+>::type> : detail::decode_traits_base<T,CharT>
+{
+    typedef typename decode_frame<CharT>::string_view_type string_view_type;
+
+    static void string_value(T& val, const string_view_type& value, const parsing_context&)
+    {
+        val.assign(value.data(), value.length());
+    }
+};
+
+namespace detail {
+
+// decode_traits<T,CharT> for a T known only by its address, so that the members of a
+// struct, which have different types, can be decoded through one table
+
+template <class CharT>
+struct erased_decode_traits
+{
+    typedef typename decode_frame<CharT>::string_view_type string_view_type;
+
+    void (*string_value)(void*, const string_view_type&, const parsing_context&);
+    void (*byte_string_value)(void*, const uint8_t*, size_t, const parsing_context&);
+    void (*integer_value)(void*, int64_t, const parsing_context&);
+    void (*uinteger_value)(void*, uint64_t, const parsing_context&);
+    void (*double_value)(void*, double, uint8_t, const parsing_context&);
+    void (*bool_value)(void*, bool, const parsing_context&);
+    void (*null_value)(void*, const parsing_context&);
+    std::unique_ptr<decode_frame<CharT>> (*begin_object)(void*, const parsing_context&);
+    std::unique_ptr<decode_frame<CharT>> (*begin_array)(void*, const parsing_context&);
+};
+
+template <class T, class CharT>
+struct erased_decode_traits_of
+{
+    typedef decode_traits<T,CharT> traits_type;
+    typedef typename decode_frame<CharT>::string_view_type string_view_type;
+
+    static void string_value(void* p, const string_view_type& value, const parsing_context& context)
+    {
+        traits_type::string_value(*static_cast<T*>(p), value, context);
+    }
+    static void byte_string_value(void* p, const uint8_t* data, size_t length, const parsing_context& context)
+    {
+        traits_type::byte_string_value(*static_cast<T*>(p), data, length, context);
+    }
+    static void integer_value(void* p, int64_t value, const parsing_context& context)
+    {
+        traits_type::integer_value(*static_cast<T*>(p), value, context);
+    }
+    static void uinteger_value(void* p, uint64_t value, const parsing_context& context)
+    {
+        traits_type::uinteger_value(*static_cast<T*>(p), value, context);
+    }
+    static void double_value(void* p, double value, uint8_t precision, const parsing_context& context)
+    {
+        traits_type::double_value(*static_cast<T*>(p), value, precision, context);
+    }
+    static void bool_value(void* p, bool value, const parsing_context& context)
+    {
+        traits_type::bool_value(*static_cast<T*>(p), value, context);
+    }
+    static void null_value(void* p, const parsing_context& context)
+    {
+        traits_type::null_value(*static_cast<T*>(p), context);
+    }
+    static std::unique_ptr<decode_frame<CharT>> begin_object(void* p, const parsing_context& context)
+    {
+        return traits_type::begin_object(*static_cast<T*>(p), context);
+    }
+    static std::unique_ptr<decode_frame<CharT>> begin_array(void* p, const parsing_context& context)
+    {
+        return traits_type::begin_array(*static_cast<T*>(p), context);
+    }
+
+    static const erased_decode_traits<CharT> value;
+};
+
+template <class T, class CharT>
+const erased_decode_traits<CharT> erased_decode_traits_of<T,CharT>::value =
+{
+    &erased_decode_traits_of<T,CharT>::string_value,
+    &erased_decode_traits_of<T,CharT>::byte_string_value,
+    &erased_decode_traits_of<T,CharT>::integer_value,
+    &erased_decode_traits_of<T,CharT>::uinteger_value,
+    &erased_decode_traits_of<T,CharT>::double_value,
+    &erased_decode_traits_of<T,CharT>::bool_value,
+    &erased_decode_traits_of<T,CharT>::null_value,
+    &erased_decode_traits_of<T,CharT>::begin_object,
+    &erased_decode_traits_of<T,CharT>::begin_array
+};
+
+template <class T, class CharT>
+struct member_decoder
+{
+    uint64_t hash;
+    const char* name;
+    size_t length;
+    void* (*address)(T&);
+    const erased_decode_traits<CharT>* traits;
+};
+
+template <class T, class Member>
+void* member_address(T& val)
+{
+    return std::addressof(Member::get(val));
+}
+
+// The members of T sorted by the hashes of their names, which were computed at compile
+// time. Built once per T and CharT.
+
+template <class T, class CharT>
+class member_decoder_table
+{
+    std::vector<member_decoder<T,CharT>> members_;
+
+    struct collector
+    {
+        std::vector<member_decoder<T,CharT>>& members;
+
+        template <class Member>
+        void operator()(const char* name, size_t length, uint64_t hash, Member)
+        {
+            member_decoder<T,CharT> m = {hash, name, length, &member_address<T,Member>,
+                                         &erased_decode_traits_of<typename Member::value_type,CharT>::value};
+            members.push_back(m);
+        }
+    };
+
+    member_decoder_table()
+    {
+        collector c{members_};
+        json_member_traits<T>::members(c);
+        std::stable_sort(members_.begin(), members_.end(),
+                         [](const member_decoder<T,CharT>& a, const member_decoder<T,CharT>& b){return a.hash < b.hash;});
+    }
+public:
+    static const member_decoder_table& instance()
+    {
+        static const member_decoder_table table;
+        return table;
+    }
+
+    const member_decoder<T,CharT>* find(const CharT* s, size_t length) const
+    {
+        uint64_t hash = member_name_hash(s, length);
+        auto it = std::lower_bound(members_.begin(), members_.end(), hash,
+                                   [](const member_decoder<T,CharT>& a, uint64_t h){return a.hash < h;});
+        for (; it != members_.end() && it->hash == hash; ++it)
+        {
+            if (member_name_equals(it->name, it->length, s, length))
+            {
+                return std::addressof(*it);
+            }
+        }
+        return nullptr;
+    }
+};
+
+// Assigns the members of an object to the members of T with the same names. Members
+// that T does not have are skipped, members of T that are missing keep their values.
+
+template <class T, class CharT>
+class struct_frame : public decode_frame<CharT>
+{
+public:
+    using typename decode_frame<CharT>::string_view_type;
+private:
+    T& val_;
+    const member_decoder_table<T,CharT>& table_;
+    const member_decoder<T,CharT>* current_;
+public:
+    struct_frame(T& val)
+        : val_(val), table_(member_decoder_table<T,CharT>::instance()), current_(nullptr)
+    {
+    }
+
+    std::unique_ptr<decode_frame<CharT>> begin_object(const parsing_context& context) override
+    {
+        if (current_ == nullptr)
+        {
+            return std::unique_ptr<decode_frame<CharT>>(new skip_frame<CharT>());
+        }
+        return current_->traits->begin_object(current_->address(val_), context);
+    }
+
+    std::unique_ptr<decode_frame<CharT>> begin_array(const parsing_context& context) override
+    {
+        if (current_ == nullptr)
+        {
+            return std::unique_ptr<decode_frame<CharT>>(new skip_frame<CharT>());
+        }
+        return current_->traits->begin_array(current_->address(val_), context);
+    }
+
+    bool end_object(const parsing_context&) override
+    {
+        return true;
+    }
+
+    bool end_array(const parsing_context&) override
+    {
+        return true;
+    }
+
+    void name(const string_view_type& name, const parsing_context&) override
+    {
+        current_ = table_.find(name.data(), name.length());
+    }
+
+    void string_value(const string_view_type& value, const parsing_context& context) override
+    {
+        if (current_ != nullptr)
+        {
+            current_->traits->string_value(current_->address(val_), value, context);
+        }
+    }
+
+    void byte_string_value(const uint8_t* data, size_t length, const parsing_context& context) override
+    {
+        if (current_ != nullptr)
+        {
+            current_->traits->byte_string_value(current_->address(val_), data, length, context);
+        }
+    }
+
+    void integer_value(int64_t value, const parsing_context& context) override
+    {
+        if (current_ != nullptr)
+        {
+            current_->traits->integer_value(current_->address(val_), value, context);
+        }
+    }
+
+    void uinteger_value(uint64_t value, const parsing_context& context) override
+    {
+        if (current_ != nullptr)
+        {
+            current_->traits->uinteger_value(current_->address(val_), value, context);
+        }
+    }
+
+    void double_value(double value, uint8_t precision, const parsing_context& context) override
+    {
+        if (current_ != nullptr)
+        {
+            current_->traits->double_value(current_->address(val_), value, precision, context);
+        }
+    }
+
+    void bool_value(bool value, const parsing_context& context) override
+    {
+        if (current_ != nullptr)
+        {
+            current_->traits->bool_value(current_->address(val_), value, context);
+        }
+    }
+
+    void null_value(const parsing_context& context) override
+    {
+        if (current_ != nullptr)
+        {
+            current_->traits->null_value(current_->address(val_), context);
+        }
+    }
+};
+
+}
+
+// struct with json_member_traits
+
+template <class T, class CharT>
+struct decode_traits<T, CharT,
+    typename std::enable_if<json_member_traits<T>::is_specialized
+>::type> : detail::decode_traits_base<T,CharT>
+{
+    static std::unique_ptr<decode_frame<CharT>> begin_object(T& val, const parsing_context&)
+    {
+        return std::unique_ptr<decode_frame<CharT>>(new detail::struct_frame<T,CharT>(val));
+    }
+};
+
+namespace detail {
+
+template <class T, class Enable = void>
+struct has_push_back : std::false_type {};
+
+template <class T>
+struct has_push_back<T, 
+    typename std::enable_if<std::is_void<decltype(std::declval<T&>().push_back(std::declval<typename T::value_type>()))>::value
+>::type> : std::true_type {};
+
+// Appends the elements of an array to a sequence container. Scalars are decoded into a
+// temporary and moved in, a nested container into the new last element, which stays in
+// place until the container ends, as nothing else is appended before then.
+
+template <class T, class CharT>
+class sequence_frame : public decode_frame<CharT>
+{
+public:
+    using typename decode_frame<CharT>::string_view_type;
+private:
+    typedef typename T::value_type value_type;
+    typedef decode_traits<value_type,CharT> traits_type;
+
+    T& val_;
+public:
+    sequence_frame(T& val)
+        : val_(val)
+    {
+    }
+
+    std::unique_ptr<decode_frame<CharT>> begin_object(const parsing_context& context) override
+    {
+        return begin_element(context, true, std::is_same<value_type,bool>());
+    }
+
+    std::unique_ptr<decode_frame<CharT>> begin_array(const parsing_context& context) override
+    {
+        return begin_element(context, false, std::is_same<value_type,bool>());
+    }
+
+    bool end_object(const parsing_context&) override
+    {
+        return true;
+    }
+
+    bool end_array(const parsing_context&) override
+    {
+        return true;
+    }
+
+    void name(const string_view_type&, const parsing_context& context) override
+    {
+        throw_invalid_value(context);
+    }
+
+    void string_value(const string_view_type& value, const parsing_context& context) override
+    {
+        value_type element = value_type();
+        traits_type::string_value(element, value, context);
+        val_.push_back(std::move(element));
+    }
+
+    void byte_string_value(const uint8_t* data, size_t length, const parsing_context& context) override
+    {
+        value_type element = value_type();
+        traits_type::byte_string_value(element, data, length, context);
+        val_.push_back(std::move(element));
+    }
+
+    void integer_value(int64_t value, const parsing_context& context) override
+    {
+        value_type element = value_type();
+        traits_type::integer_value(element, value, context);
+        val_.push_back(std::move(element));
+    }
+
+    void uinteger_value(uint64_t value, const parsing_context& context) override
+    {
+        value_type element = value_type();
+        traits_type::uinteger_value(element, value, context);
+        val_.push_back(std::move(element));
+    }
+
+    void double_value(double value, uint8_t precision, const parsing_context& context) override
+    {
+        value_type element = value_type();
+        traits_type::double_value(element, value, precision, context);
+        val_.push_back(std::move(element));
+    }
+
+    void bool_value(bool value, const parsing_context& context) override
+    {
+        value_type element = value_type();
+        traits_type::bool_value(element, value, context);
+        val_.push_back(std::move(element));
+    }
+
+    void null_value(const parsing_context& context) override
+    {
+        value_type element = value_type();
+        traits_type::null_value(element, context);
+        val_.push_back(std::move(element));
+    }
+private:
+    std::unique_ptr<decode_frame<CharT>> begin_element(const parsing_context& context, bool is_object, std::false_type)
+    {
+        val_.push_back(value_type());
+        return is_object ? traits_type::begin_object(val_.back(), context) : traits_type::begin_array(val_.back(), context);
+    }
+
+    // std::vector<bool> has no element references, and bools are not containers
+    std::unique_ptr<decode_frame<CharT>> begin_element(const parsing_context& context, bool, std::true_type)
+    {
+        throw_invalid_value(context);
+        return nullptr;
+    }
+};
+
+// Assigns the members of an object to the mapped values of their names. A name that
+// occurs more than once decodes into the same value again.
+
+template <class T, class CharT>
+class map_frame : public decode_frame<CharT>
+{
+public:
+    using typename decode_frame<CharT>::string_view_type;
+private:
+    typedef typename T::key_type key_type;
+    typedef typename T::mapped_type mapped_type;
+    typedef decode_traits<mapped_type,CharT> traits_type;
+
+    T& val_;
+    mapped_type* current_;
+public:
+    map_frame(T& val)
+        : val_(val), current_(nullptr)
+    {
+    }
+
+    std::unique_ptr<decode_frame<CharT>> begin_object(const parsing_context& context) override
+    {
+        return traits_type::begin_object(*current_, context);
+    }
+
+    std::unique_ptr<decode_frame<CharT>> begin_array(const parsing_context& context) override
+    {
+        return traits_type::begin_array(*current_, context);
+    }
+
+    bool end_object(const parsing_context&) override
+    {
+        return true;
+    }
+
+    bool end_array(const parsing_context&) override
+    {
+        return true;
+    }
+
+    void name(const string_view_type& name, const parsing_context&) override
+    {
+        current_ = std::addressof(val_.emplace(key_type(name.data(), name.length()), mapped_type()).first->second);
+    }
+
+    void string_value(const string_view_type& value, const parsing_context& context) override
+    {
+        traits_type::string_value(*current_, value, context);
+    }
+
+    void byte_string_value(const uint8_t* data, size_t length, const parsing_context& context) override
+    {
+        traits_type::byte_string_value(*current_, data, length, context);
+    }
+
+    void integer_value(int64_t value, const parsing_context& context) override
+    {
+        traits_type::integer_value(*current_, value, context);
+    }
+
+    void uinteger_value(uint64_t value, const parsing_context& context) override
+    {
+        traits_type::uinteger_value(*current_, value, context);
+    }
+
+    void double_value(double value, uint8_t precision, const parsing_context& context) override
+    {
+        traits_type::double_value(*current_, value, precision, context);
+    }
+
+    void bool_value(bool value, const parsing_context& context) override
+    {
+        traits_type::bool_value(*current_, value, context);
+    }
+
+    void null_value(const parsing_context& context) override
+    {
+        traits_type::null_value(*current_, context);
+    }
+};
+
+// Assigns the elements of an array of exactly N elements to the elements of a std::array
+
+template <class T, size_t N, class CharT>
+class fixed_array_frame : public decode_frame<CharT>
+{
+public:
+    using typename decode_frame<CharT>::string_view_type;
+private:
+    typedef decode_traits<T,CharT> traits_type;
+
+    std::array<T,N>& val_;
+    size_t index_;
+public:
+    fixed_array_frame(std::array<T,N>& val)
+        : val_(val), index_(0)
+    {
+    }
+
+    std::unique_ptr<decode_frame<CharT>> begin_object(const parsing_context& context) override
+    {
+        return traits_type::begin_object(next(context), context);
+    }
+
+    std::unique_ptr<decode_frame<CharT>> begin_array(const parsing_context& context) override
+    {
+        return traits_type::begin_array(next(context), context);
+    }
+
+    bool end_object(const parsing_context&) override
+    {
+        return true;
+    }
+
+    bool end_array(const parsing_context& context) override
+    {
+        if (index_ != N)
+        {
+            throw_invalid_value(context);
+        }
+        return true;
+    }
+
+    void name(const string_view_type&, const parsing_context& context) override
+    {
+        throw_invalid_value(context);
+    }
+
+    void string_value(const string_view_type& value, const parsing_context& context) override
+    {
+        traits_type::string_value(next(context), value, context);
+    }
+
+    void byte_string_value(const uint8_t* data, size_t length, const parsing_context& context) override
+    {
+        traits_type::byte_string_value(next(context), data, length, context);
+    }
+
+    void integer_value(int64_t value, const parsing_context& context) override
+    {
+        traits_type::integer_value(next(context), value, context);
+    }
+
+    void uinteger_value(uint64_t value, const parsing_context& context) override
+    {
+        traits_type::uinteger_value(next(context), value, context);
+    }
+
+    void double_value(double value, uint8_t precision, const parsing_context& context) override
+    {
+        traits_type::double_value(next(context), value, precision, context);
+    }
+
+    void bool_value(bool value, const parsing_context& context) override
+    {
+        traits_type::bool_value(next(context), value, context);
+    }
+
+    void null_value(const parsing_context& context) override
+    {
+        traits_type::null_value(next(context), context);
+    }
+private:
+    T& next(const parsing_context& context)
+    {
+        if (index_ >= N)
+        {
+            throw_invalid_value(context);
+        }
+        return val_[index_++];
+    }
+};
+
+// The elements of a std::tuple or std::pair, which have different types, as a table
+// indexed by position
+
+template <class T, class CharT>
+struct element_decoder
+{
+    void* (*address)(T&);
+    const erased_decode_traits<CharT>* traits;
+};
+
+template <class T, size_t I>
+void* tuple_element_address(T& val)
+{
+    return std::addressof(std::get<I>(val));
+}
+
+template <class T, class CharT, size_t Pos>
+struct tuple_decoder_builder
+{
+    static void build(element_decoder<T,CharT>* decoders)
+    {
+        typedef typename std::tuple_element<Pos-1,T>::type element_type;
+        decoders[Pos-1].address = &tuple_element_address<T,Pos-1>;
+        decoders[Pos-1].traits = &erased_decode_traits_of<element_type,CharT>::value;
+        tuple_decoder_builder<T,CharT,Pos-1>::build(decoders);
+    }
+};
+
+template <class T, class CharT>
+struct tuple_decoder_builder<T,CharT,0>
+{
+    static void build(element_decoder<T,CharT>*)
+    {
+    }
+};
+
+template <class T, class CharT>
+class tuple_decoder_table
+{
+    static const size_t size = std::tuple_size<T>::value;
+
+    element_decoder<T,CharT> elements_[size > 0 ? size : 1];
+
+    tuple_decoder_table()
+    {
+        tuple_decoder_builder<T,CharT,size>::build(elements_);
+    }
+public:
+    static const tuple_decoder_table& instance()
+    {
+        static const tuple_decoder_table table;
+        return table;
+    }
+
+    const element_decoder<T,CharT>& operator[](size_t i) const
+    {
+        return elements_[i];
+    }
+};
+
+// Assigns the elements of an array with as many elements as T to the elements of T
+
+template <class T, class CharT>
+class tuple_frame : public decode_frame<CharT>
+{
+public:
+    using typename decode_frame<CharT>::string_view_type;
+private:
+    static const size_t size = std::tuple_size<T>::value;
+
+    T& val_;
+    const tuple_decoder_table<T,CharT>& table_;
+    size_t index_;
+public:
+    tuple_frame(T& val)
+        : val_(val), table_(tuple_decoder_table<T,CharT>::instance()), index_(0)
+    {
+    }
+
+    std::unique_ptr<decode_frame<CharT>> begin_object(const parsing_context& context) override
+    {
+        const element_decoder<T,CharT>& e = next(context);
+        return e.traits->begin_object(e.address(val_), context);
+    }
+
+    std::unique_ptr<decode_frame<CharT>> begin_array(const parsing_context& context) override
+    {
+        const element_decoder<T,CharT>& e = next(context);
+        return e.traits->begin_array(e.address(val_), context);
+    }
+
+    bool end_object(const parsing_context&) override
+    {
+        return true;
+    }
+
+    bool end_array(const parsing_context& context) override
+    {
+        if (index_ != size)
+        {
+            throw_invalid_value(context);
+        }
+        return true;
+    }
+
+    void name(const string_view_type&, const parsing_context& context) override
+    {
+        throw_invalid_value(context);
+    }
+
+    void string_value(const string_view_type& value, const parsing_context& context) override
+    {
+        const element_decoder<T,CharT>& e = next(context);
+        e.traits->string_value(e.address(val_), value, context);
+    }
+
+    void byte_string_value(const uint8_t* data, size_t length, const parsing_context& context) override
+    {
+        const element_decoder<T,CharT>& e = next(context);
+        e.traits->byte_string_value(e.address(val_), data, length, context);
+    }
+
+    void integer_value(int64_t value, const parsing_context& context) override
+    {
+        const element_decoder<T,CharT>& e = next(context);
+        e.traits->integer_value(e.address(val_), value, context);
+    }
+
+    void uinteger_value(uint64_t value, const parsing_context& context) override
+    {
+        const element_decoder<T,CharT>& e = next(context);
+        e.traits->uinteger_value(e.address(val_), value, context);
+    }
+
+    void double_value(double value, uint8_t precision, const parsing_context& context) override
+    {
+        const element_decoder<T,CharT>& e = next(context);
+        e.traits->double_value(e.address(val_), value, precision, context);
+    }
+
+    void bool_value(bool value, const parsing_context& context) override
+    {
+        const element_decoder<T,CharT>& e = next(context);
+        e.traits->bool_value(e.address(val_), value, context);
+    }
+
+    void null_value(const parsing_context& context) override
+    {
+        const element_decoder<T,CharT>& e = next(context);
+        e.traits->null_value(e.address(val_), context);
+    }
+private:
+    const element_decoder<T,CharT>& next(const parsing_context& context)
+    {
+        if (index_ >= size)
+        {
+            throw_invalid_value(context);
+        }
+        return table_[index_++];
+    }
+};
+
+}
+
+// sequence container (except string and array)
+
+template <class T, class CharT>
+struct decode_traits<T, CharT,
+    typename std::enable_if<detail::is_vector_like<T>::value &&
+                            detail::has_push_back<T>::value &&
+                            !detail::is_basic_json<T>::value
+>::type> : detail::decode_traits_base<T,CharT>
+{
+    static std::unique_ptr<decode_frame<CharT>> begin_array(T& val, const parsing_context&)
+    {
+        return std::unique_ptr<decode_frame<CharT>>(new detail::sequence_frame<T,CharT>(val));
+    }
+};
+
+// associative container with string keys
+
+template <class T, class CharT>
+struct decode_traits<T, CharT,
+    typename std::enable_if<detail::is_map_like<T>::value &&
+                            detail::is_string_like<typename T::key_type>::value &&
+                            std::is_same<typename T::key_type::value_type,CharT>::value &&
+                            !detail::is_basic_json<T>::value
+>::type> : detail::decode_traits_base<T,CharT>
+{
+    static std::unique_ptr<decode_frame<CharT>> begin_object(T& val, const parsing_context&)
+    {
+        return std::unique_ptr<decode_frame<CharT>>(new detail::map_frame<T,CharT>(val));
+    }
+};
+
+// std::array
+
+template <class E, size_t N, class CharT>
+struct decode_traits<std::array<E,N>, CharT> : detail::decode_traits_base<std::array<E,N>,CharT>
+{
+    static std::unique_ptr<decode_frame<CharT>> begin_array(std::array<E,N>& val, const parsing_context&)
+    {
+        return std::unique_ptr<decode_frame<CharT>>(new detail::fixed_array_frame<E,N,CharT>(val));
+    }
+};
+
+// std::tuple and std::pair
+
+template <class CharT, typename... E>
+struct decode_traits<std::tuple<E...>, CharT> : detail::decode_traits_base<std::tuple<E...>,CharT>
+{
+    static std::unique_ptr<decode_frame<CharT>> begin_array(std::tuple<E...>& val, const parsing_context&)
+    {
+        return std::unique_ptr<decode_frame<CharT>>(new detail::tuple_frame<std::tuple<E...>,CharT>(val));
+    }
+};
+
+template <class T1, class T2, class CharT>
+struct decode_traits<std::pair<T1,T2>, CharT> : detail::decode_traits_base<std::pair<T1,T2>,CharT>
+{
+    static std::unique_ptr<decode_frame<CharT>> begin_array(std::pair<T1,T2>& val, const parsing_context&)
+    {
+        return std::unique_ptr<decode_frame<CharT>>(new detail::tuple_frame<std::pair<T1,T2>,CharT>(val));
+    }
+};
+
+// basic_value_decoder
+
+// A json_input_handler that decodes the text into a T with decode_traits, without
+// building a basic_json for it. T must be default constructible.
+
+template <class T, class CharT = char>
+class basic_value_decoder final : public basic_json_input_handler<CharT>
+{
+public:
+    using typename basic_json_input_handler<CharT>::string_view_type;
+private:
+    typedef decode_traits<T,CharT> traits_type;
+
+    T result_;
+    std::vector<std::unique_ptr<decode_frame<CharT>>> stack_;
+    bool is_valid_;
+public:
+    basic_value_decoder()
+        : result_(), is_valid_(false)
+    {
+    }
+
+    bool is_valid() const
+    {
+        return is_valid_;
+    }
+
+    T get_result()
+    {
+        is_valid_ = false;
+        return std::move(result_);
+    }
+private:
+    void push(std::unique_ptr<decode_frame<CharT>>&& frame)
+    {
+        if (frame)
+        {
+            stack_.push_back(std::move(frame));
+        }
+    }
+
+    void do_begin_json() override
+    {
+        result_ = T();
+        stack_.clear();
+        is_valid_ = false;
+    }
+
+    void do_end_json() override
+    {
+        is_valid_ = true;
+    }
+
+    void do_begin_object(const parsing_context& context) override
+    {
+        push(stack_.empty() ? traits_type::begin_object(result_, context) : stack_.back()->begin_object(context));
+    }
+
+    void do_end_object(const parsing_context& context) override
+    {
+        if (stack_.back()->end_object(context))
+        {
+            stack_.pop_back();
+        }
+    }
+
+    void do_begin_array(const parsing_context& context) override
+    {
+        push(stack_.empty() ? traits_type::begin_array(result_, context) : stack_.back()->begin_array(context));
+    }
+
+    void do_end_array(const parsing_context& context) override
+    {
+        if (stack_.back()->end_array(context))
+        {
+            stack_.pop_back();
+        }
+    }
+
+    void do_name(const string_view_type& name, const parsing_context& context) override
+    {
+        stack_.back()->name(name, context);
+    }
+
+    void do_string_value(const string_view_type& value, const parsing_context& context) override
+    {
+        if (stack_.empty())
+        {
+            traits_type::string_value(result_, value, context);
+        }
+        else
+        {
+            stack_.back()->string_value(value, context);
+        }
+    }
+
+    void do_byte_string_value(const uint8_t* data, size_t length, const parsing_context& context) override
+    {
+        if (stack_.empty())
+        {
+            traits_type::byte_string_value(result_, data, length, context);
+        }
+        else
+        {
+            stack_.back()->byte_string_value(data, length, context);
+        }
+    }
+
+    void do_integer_value(int64_t value, const parsing_context& context) override
+    {
+        if (stack_.empty())
+        {
+            traits_type::integer_value(result_, value, context);
+        }
+        else
+        {
+            stack_.back()->integer_value(value, context);
+        }
+    }
+
+    void do_uinteger_value(uint64_t value, const parsing_context& context) override
+    {
+        if (stack_.empty())
+        {
+            traits_type::uinteger_value(result_, value, context);
+        }
+        else
+        {
+            stack_.back()->uinteger_value(value, context);
+        }
+    }
+
+    void do_double_value(double value, uint8_t precision, const parsing_context& context) override
+    {
+        if (stack_.empty())
+        {
+            traits_type::double_value(result_, value, precision, context);
+        }
+        else
+        {
+            stack_.back()->double_value(value, precision, context);
+        }
+    }
+
+    void do_bool_value(bool value, const parsing_context& context) override
+    {
+        if (stack_.empty())
+        {
+            traits_type::bool_value(result_, value, context);
+        }
+        else
+        {
+            stack_.back()->bool_value(value, context);
+        }
+    }
+
+    void do_null_value(const parsing_context& context) override
+    {
+        if (stack_.empty())
+        {
+            traits_type::null_value(result_, context);
+        }
+        else
+        {
+            stack_.back()->null_value(context);
+        }
+    }
+};
+
+template <class T>
+using value_decoder = basic_value_decoder<T,char>;
+
+// decode_json
+
+// Parses the JSON text in s into a T with decode_traits, without building a basic_json
+
+template <class T, class CharT>
+T decode_json(const CharT* s, size_t length)
+{
+    auto result = unicons::skip_bom(s, s + length);
+    if (result.ec != unicons::encoding_errc())
+    {
+        throw parse_error(result.ec,1,1);
+    }
+    size_t offset = result.it - s;
+
+    basic_value_decoder<T,CharT> decoder;
+    basic_json_parser<CharT,basic_value_decoder<T,CharT>> parser(decoder);
+    parser.set_source(s + offset, length - offset);
+    parser.parse();
+    parser.end_parse();
+    parser.check_done();
+    return decoder.get_result();
+}
+
+template <class T, class CharT, class Traits, class Allocator>
+T decode_json(const std::basic_string<CharT,Traits,Allocator>& s)
+{
+    return decode_json<T>(s.data(), s.length());
+}
+
+template <class T, class CharT>
+T decode_json(std::basic_istream<CharT>& is)
+{
+    basic_value_decoder<T,CharT> decoder;
+    basic_json_reader<CharT> reader(is, decoder);
+    reader.read();
+    if (!decoder.is_valid())
+    {
+        JSONCONS_THROW_EXCEPTION(std::runtime_error,"Failed to parse json stream");
+    }
+    return decoder.get_result();
+}
+
+}
+
+#endif
@@ -0,0 +1,361 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_DETAIL_BASE64_HPP
+#define JSONCONS_DETAIL_BASE64_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <jsoncons/detail/jsoncons_config.hpp>
+#include <jsoncons/detail/string_scan.hpp>
+
+// The vector kernels need pshufb, an SSSE3 instruction, which AVX2 implies
+#if defined(JSONCONS_HAS_AVX2) || (defined(JSONCONS_HAS_SSE2) && defined(__SSSE3__))
+#define JSONCONS_HAS_SSSE3
+#include <tmmintrin.h>
+#endif
+
+namespace jsoncons { namespace detail {
+
+// The value of each character of a base64 or base64url alphabet, 0xff for a character
+// outside it, and 0xfe for the fill character '='
+
+struct base64_decode_table
+{
+    uint8_t values[256];
+
+    explicit base64_decode_table(const char* alphabet)
+    {
+        std::memset(values, 0xff, sizeof(values));
+        for (uint8_t i = 0; i < 64; ++i)
+        {
+            values[static_cast<uint8_t>(alphabet[i])] = i;
+        }
+        values[static_cast<uint8_t>('=')] = 0xfe;
+    }
+};
+
+inline
+const char* base64_chars()
+{
+    return "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+}
+
+inline
+const char* base64url_chars()
+{
+    return "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+}
+
+inline
+const uint8_t* base64_values()
+{
+    static const base64_decode_table table(base64_chars());
+    return table.values;
+}
+
+inline
+const uint8_t* base64url_values()
+{
+    static const base64_decode_table table(base64url_chars());
+    return table.values;
+}
+
+#if defined(JSONCONS_HAS_SSSE3)
+
+// Encoding and decoding of 12 bytes in 16 characters, after
+// W. Mula and D. Lemire, Faster Base64 Encoding and Decoding using AVX2 Instructions,
+// ACM Transactions on the Web 12 (3), 2018. c62 and c63 are the last two characters
+// of the alphabet.
+
+// Spreads the 24 bits of each group of 3 bytes in the first 12 bytes over 4 bytes
+// of 6 bits, and maps them to the characters of the alphabet
+inline
+__m128i base64_encode_block(__m128i in, const __m128i& shift_lut)
+{
+    in = _mm_shuffle_epi8(in, _mm_setr_epi8(1,0,2,1, 4,3,5,4, 7,6,8,7, 10,9,11,10));
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    const __m128i indices = _mm_or_si128(t1, t3);
+
+    // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+    __m128i ranges = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    ranges = _mm_or_si128(ranges, _mm_and_si128(less, _mm_set1_epi8(13)));
+    return _mm_add_epi8(indices, _mm_shuffle_epi8(shift_lut, ranges));
+}
+
+inline
+__m128i base64_shift_lut(char c62, char c63)
+{
+    return _mm_setr_epi8('a'-26, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52,
+                         '0'-52, '0'-52, '0'-52, static_cast<char>(c62-62), static_cast<char>(c63-63), 'A', 0, 0);
+}
+
+#if defined(JSONCONS_HAS_AVX2)
+
+inline
+__m256i base64_encode_block(__m256i in, const __m256i& shift_lut)
+{
+    in = _mm256_shuffle_epi8(in, _mm256_setr_epi8(1,0,2,1, 4,3,5,4, 7,6,8,7, 10,9,11,10,
+                                                  1,0,2,1, 4,3,5,4, 7,6,8,7, 10,9,11,10));
+    const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+    const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+    const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+    const __m256i indices = _mm256_or_si256(t1, t3);
+
+    __m256i ranges = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+    ranges = _mm256_or_si256(ranges, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+    return _mm256_add_epi8(indices, _mm256_shuffle_epi8(shift_lut, ranges));
+}
+
+#endif
+
+// Encodes as many whole blocks of [first,last) as the vector loads allow, and returns
+// a pointer past the last byte encoded
+inline
+const uint8_t* encode_base64_blocks(const uint8_t* first, const uint8_t* last, char c62, char c63, char*& out)
+{
+    const __m128i shift_lut = base64_shift_lut(c62, c63);
+#if defined(JSONCONS_HAS_AVX2)
+    const __m256i shift_lut2 = _mm256_broadcastsi128_si256(shift_lut);
+    // Each lane reads 16 bytes and encodes the first 12
+    while (last - first >= 28)
+    {
+        const __m256i in = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first))),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + 12)), 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), base64_encode_block(in, shift_lut2));
+        first += 24;
+        out += 32;
+    }
+#endif
+    while (last - first >= 16)
+    {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), base64_encode_block(in, shift_lut));
+        first += 12;
+        out += 16;
+    }
+    return first;
+}
+
+// Translates the 16 base64 characters of in to their 6 bit values, and packs them into
+// the first 12 bytes. Returns false, with in unchanged, if a character is outside the alphabet.
+inline
+bool base64_decode_block(__m128i& in)
+{
+    const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                         0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                         0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                           0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask_2f = _mm_set1_epi8(0x2f);
+
+    // Each character is classified by its high and low nibbles, the classes of a
+    // character outside the alphabet have a bit in common. Masking with 0x2f clears
+    // the high bit, for which pshufb would select zero, pshufb ignores bits 4 to 6.
+    const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask_2f);
+    const __m128i lo_nibbles = _mm_and_si128(in, mask_2f);
+    const __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+    const __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+    if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0)
+    {
+        return false;
+    }
+    const __m128i eq_2f = _mm_cmpeq_epi8(in, mask_2f);
+    const __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles));
+    const __m128i values = _mm_add_epi8(in, roll);
+
+    const __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const __m128i packed = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+    in = _mm_shuffle_epi8(packed, _mm_setr_epi8(2,1,0, 6,5,4, 10,9,8, 14,13,12, -1,-1,-1,-1));
+    return true;
+}
+
+// Rewrites the base64url characters '-' and '_' as '+' and '/'. Returns false if the
+// block has a '+' or '/', which are outside the base64url alphabet.
+inline
+bool base64url_to_base64(__m128i& in)
+{
+    const __m128i plus_or_slash = _mm_or_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('+')),
+                                               _mm_cmpeq_epi8(in, _mm_set1_epi8('/')));
+    if (_mm_movemask_epi8(plus_or_slash) != 0)
+    {
+        return false;
+    }
+    const __m128i minus = _mm_and_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('-')), _mm_set1_epi8('-' - '+'));
+    const __m128i underscore = _mm_and_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('_')), _mm_set1_epi8('_' - '/'));
+    in = _mm_sub_epi8(in, _mm_or_si128(minus, underscore));
+    return true;
+}
+
+inline
+void store_12_bytes(uint8_t* out, __m128i bytes)
+{
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out), bytes);
+    const uint32_t last4 = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(bytes, 8)));
+    std::memcpy(out + 8, &last4, 4);
+}
+
+// Decodes blocks of 16 characters of [first,last) until fewer remain, or a block has a
+// character outside the alphabet (including the fill character), and returns a pointer
+// past the last character decoded. Writes exactly 12 bytes to out for each block.
+inline
+const char* decode_base64_blocks(const char* first, const char* last, bool url, uint8_t*& out)
+{
+    while (last - first >= 16)
+    {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        if ((url && !base64url_to_base64(in)) || !base64_decode_block(in))
+        {
+            break;
+        }
+        store_12_bytes(out, in);
+        first += 16;
+        out += 12;
+    }
+    return first;
+}
+
+#endif
+
+// Encodes [first,last) with the alphabet, padded with '=' if pad, and returns a pointer
+// past the last character written to out. out must have room for the encoded length.
+template <class CharT>
+CharT* encode_base64_chars(const uint8_t* first, const uint8_t* last, const char* alphabet, bool pad, CharT* out)
+{
+    while (last - first >= 3)
+    {
+        const uint32_t group = (static_cast<uint32_t>(first[0]) << 16) |
+                               (static_cast<uint32_t>(first[1]) << 8) | first[2];
+        out[0] = static_cast<CharT>(alphabet[group >> 18]);
+        out[1] = static_cast<CharT>(alphabet[(group >> 12) & 0x3f]);
+        out[2] = static_cast<CharT>(alphabet[(group >> 6) & 0x3f]);
+        out[3] = static_cast<CharT>(alphabet[group & 0x3f]);
+        first += 3;
+        out += 4;
+    }
+    if (first != last)
+    {
+        const uint32_t group = (static_cast<uint32_t>(first[0]) << 16) |
+                               (last - first == 2 ? static_cast<uint32_t>(first[1]) << 8 : 0);
+        *out++ = static_cast<CharT>(alphabet[group >> 18]);
+        *out++ = static_cast<CharT>(alphabet[(group >> 12) & 0x3f]);
+        if (last - first == 2)
+        {
+            *out++ = static_cast<CharT>(alphabet[(group >> 6) & 0x3f]);
+        }
+        else if (pad)
+        {
+            *out++ = '=';
+        }
+        if (pad)
+        {
+            *out++ = '=';
+        }
+    }
+    return out;
+}
+
+template <class CharT>
+CharT* encode_base64(const uint8_t* first, const uint8_t* last, bool url, CharT* out)
+{
+    return encode_base64_chars(first, last, url ? base64url_chars() : base64_chars(), !url, out);
+}
+
+template <>
+inline
+char* encode_base64<char>(const uint8_t* first, const uint8_t* last, bool url, char* out)
+{
+#if defined(JSONCONS_HAS_SSSE3)
+    first = encode_base64_blocks(first, last, url ? '-' : '+', url ? '_' : '/', out);
+#endif
+    return encode_base64_chars(first, last, url ? base64url_chars() : base64_chars(), !url, out);
+}
+
+// Decodes [first,last) up to the first fill character '=' or the end, and advances out
+// past the last byte written. Returns false if a character before the fill is outside
+// the alphabet. A final group of one character decodes to no bytes.
+template <class CharT>
+bool decode_base64(const CharT* first, const CharT* last, bool url, uint8_t*& out)
+{
+    const uint8_t* values = url ? base64url_values() : base64_values();
+    auto value = [values](CharT c) -> uint32_t
+    {
+        return static_cast<uint32_t>(c) <= 0xff ? values[static_cast<uint32_t>(c)] : 0xff;
+    };
+    while (last - first >= 4)
+    {
+        const uint32_t a = value(first[0]), b = value(first[1]), c = value(first[2]), d = value(first[3]);
+        if (((a | b | c | d) & 0x80) != 0)
+        {
+            break;
+        }
+        const uint32_t group = (a << 18) | (b << 12) | (c << 6) | d;
+        out[0] = static_cast<uint8_t>(group >> 16);
+        out[1] = static_cast<uint8_t>(group >> 8);
+        out[2] = static_cast<uint8_t>(group);
+        first += 4;
+        out += 3;
+    }
+
+    // The last group, which may be short or padded, or a character outside the alphabet
+    uint32_t group = 0;
+    int n = 0;
+    for (; first != last; ++first)
+    {
+        const uint32_t v = value(*first);
+        if (v == 0xfe)
+        {
+            break;
+        }
+        if (v == 0xff)
+        {
+            return false;
+        }
+        group = (group << 6) | v;
+        if (++n == 4)
+        {
+            *out++ = static_cast<uint8_t>(group >> 16);
+            *out++ = static_cast<uint8_t>(group >> 8);
+            *out++ = static_cast<uint8_t>(group);
+            group = 0;
+            n = 0;
+        }
+    }
+    if (n >= 2)
+    {
+        group <<= 6*(4 - n);
+        *out++ = static_cast<uint8_t>(group >> 16);
+        if (n == 3)
+        {
+            *out++ = static_cast<uint8_t>(group >> 8);
+        }
+    }
+    return true;
+}
+
+template <>
+inline
+bool decode_base64<char>(const char* first, const char* last, bool url, uint8_t*& out)
+{
+#if defined(JSONCONS_HAS_SSSE3)
+    first = decode_base64_blocks(first, last, url, out);
+#endif
+    return decode_base64<unsigned char>(reinterpret_cast<const unsigned char*>(first),
+                                        reinterpret_cast<const unsigned char*>(last), url, out);
+}
+
+}}
+
+#endif
@@ -0,0 +1,676 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_DETAIL_BLOCKVECTOR_HPP
+#define JSONCONS_DETAIL_BLOCKVECTOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <initializer_list>
+#include <type_traits>
+#include <jsoncons/detail/jsoncons_config.hpp>
+#include <jsoncons/detail/type_traits_helper.hpp>
+
+namespace jsoncons { namespace detail {
+
+// A sequence with the interface of a vector, held in blocks of block_size elements that are
+// found through a directory of pointers to them. Element i is at a fixed block and offset,
+// so access by position is as cheap as for a deque. Growing adds a block, and never moves
+// the elements already there, so references to them stay valid as elements are added at
+// either end, and growing a large sequence does not need room for it twice. Inserting or
+// erasing in the middle moves the elements on the nearer side of the position. Blocks left
+// empty at the back are kept, as capacity, until shrink_to_fit or clear.
+
+template <class T, class Allocator = std::allocator<T>>
+class block_vector
+{
+public:
+    static const size_t block_shift = 8;
+    static const size_t block_size = size_t(1) << block_shift;
+private:
+    static const size_t block_mask = block_size - 1;
+
+    typedef typename std::allocator_traits<Allocator>:: template rebind_alloc<T> element_allocator_type;
+    typedef std::allocator_traits<element_allocator_type> element_traits;
+    typedef typename element_traits::pointer block_pointer;
+    typedef typename std::allocator_traits<Allocator>:: template rebind_alloc<block_pointer> directory_allocator_type;
+
+    // The first element is at front_ in blocks_[0], front_ < block_size while there are blocks
+    std::vector<block_pointer,directory_allocator_type> blocks_;
+    size_t front_;
+    size_t size_;
+
+    template <class Container, class Value>
+    class iterator_base
+    {
+        friend class block_vector;
+        template <class C, class V> friend class iterator_base;
+
+        Container* container_;
+        size_t index_;
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef ptrdiff_t difference_type;
+        typedef Value* pointer;
+        typedef Value& reference;
+
+        iterator_base()
+            : container_(nullptr), index_(0)
+        {
+        }
+
+        iterator_base(Container* container, size_t index)
+            : container_(container), index_(index)
+        {
+        }
+
+        // An iterator converts to a const_iterator
+        template <class C, class V, class = typename std::enable_if<std::is_convertible<V*,Value*>::value>::type>
+        iterator_base(const iterator_base<C,V>& other)
+            : container_(other.container_), index_(other.index_)
+        {
+        }
+
+        reference operator*() const
+        {
+            return *container_->element(index_);
+        }
+
+        pointer operator->() const
+        {
+            return container_->element(index_);
+        }
+
+        reference operator[](difference_type n) const
+        {
+            return *container_->element(index_ + n);
+        }
+
+        iterator_base& operator++()
+        {
+            ++index_;
+            return *this;
+        }
+
+        iterator_base operator++(int)
+        {
+            iterator_base temp(*this);
+            ++index_;
+            return temp;
+        }
+
+        iterator_base& operator--()
+        {
+            --index_;
+            return *this;
+        }
+
+        iterator_base operator--(int)
+        {
+            iterator_base temp(*this);
+            --index_;
+            return temp;
+        }
+
+        iterator_base& operator+=(difference_type n)
+        {
+            index_ += n;
+            return *this;
+        }
+
+        iterator_base& operator-=(difference_type n)
+        {
+            index_ -= n;
+            return *this;
+        }
+
+        friend iterator_base operator+(iterator_base it, difference_type n)
+        {
+            return it += n;
+        }
+
+        friend iterator_base operator+(difference_type n, iterator_base it)
+        {
+            return it += n;
+        }
+
+        friend iterator_base operator-(iterator_base it, difference_type n)
+        {
+            return it -= n;
+        }
+
+        template <class C, class V>
+        difference_type operator-(const iterator_base<C,V>& other) const
+        {
+            return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+        }
+
+        template <class C, class V>
+        bool operator==(const iterator_base<C,V>& other) const
+        {
+            return index_ == other.index_;
+        }
+
+        template <class C, class V>
+        bool operator!=(const iterator_base<C,V>& other) const
+        {
+            return index_ != other.index_;
+        }
+
+        template <class C, class V>
+        bool operator<(const iterator_base<C,V>& other) const
+        {
+            return index_ < other.index_;
+        }
+
+        template <class C, class V>
+        bool operator>(const iterator_base<C,V>& other) const
+        {
+            return index_ > other.index_;
+        }
+
+        template <class C, class V>
+        bool operator<=(const iterator_base<C,V>& other) const
+        {
+            return index_ <= other.index_;
+        }
+
+        template <class C, class V>
+        bool operator>=(const iterator_base<C,V>& other) const
+        {
+            return index_ >= other.index_;
+        }
+    };
+public:
+    typedef T value_type;
+    typedef Allocator allocator_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef iterator_base<block_vector,T> iterator;
+    typedef iterator_base<const block_vector,const T> const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    block_vector()
+        : front_(0), size_(0)
+    {
+    }
+
+    explicit block_vector(const Allocator& a)
+        : blocks_(directory_allocator_type(a)), front_(0), size_(0)
+    {
+    }
+
+    explicit block_vector(size_t n, const Allocator& a = Allocator())
+        : blocks_(directory_allocator_type(a)), front_(0), size_(0)
+    {
+        resize(n);
+    }
+
+    block_vector(size_t n, const T& value, const Allocator& a = Allocator())
+        : blocks_(directory_allocator_type(a)), front_(0), size_(0)
+    {
+        resize(n, value);
+    }
+
+    template <class InputIt, class = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+    block_vector(InputIt first, InputIt last, const Allocator& a = Allocator())
+        : blocks_(directory_allocator_type(a)), front_(0), size_(0)
+    {
+        append(first, last);
+    }
+
+    block_vector(std::initializer_list<T> init, const Allocator& a = Allocator())
+        : blocks_(directory_allocator_type(a)), front_(0), size_(0)
+    {
+        append(init.begin(), init.end());
+    }
+
+    block_vector(const block_vector& other)
+        : blocks_(directory_allocator_type(element_traits::select_on_container_copy_construction(element_allocator_type(other.get_allocator())))),
+          front_(0), size_(0)
+    {
+        append(other.begin(), other.end());
+    }
+
+    block_vector(const block_vector& other, const Allocator& a)
+        : blocks_(directory_allocator_type(a)), front_(0), size_(0)
+    {
+        append(other.begin(), other.end());
+    }
+
+    block_vector(block_vector&& other) JSONCONS_NOEXCEPT
+        : blocks_(std::move(other.blocks_)), front_(other.front_), size_(other.size_)
+    {
+        other.blocks_.clear();
+        other.front_ = 0;
+        other.size_ = 0;
+    }
+
+    block_vector(block_vector&& other, const Allocator& a)
+        : blocks_(directory_allocator_type(a)), front_(0), size_(0)
+    {
+        if (other.get_allocator() == a)
+        {
+            swap(other);
+        }
+        else
+        {
+            append(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+        }
+    }
+
+    ~block_vector()
+    {
+        clear();
+    }
+
+    block_vector& operator=(const block_vector& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            append(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    block_vector& operator=(block_vector&& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            if (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+                get_allocator() == other.get_allocator())
+            {
+                blocks_ = std::move(other.blocks_);
+                front_ = other.front_;
+                size_ = other.size_;
+                other.blocks_.clear();
+                other.front_ = 0;
+                other.size_ = 0;
+            }
+            else
+            {
+                append(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+            }
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const
+    {
+        return allocator_type(blocks_.get_allocator());
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    // The elements the blocks hold, from the first element to the end of the last block
+    size_t capacity() const
+    {
+        return blocks_.empty() ? 0 : blocks_.size()*block_size - front_;
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    iterator begin() {return iterator(this, 0);}
+
+    iterator end() {return iterator(this, size_);}
+
+    const_iterator begin() const {return const_iterator(this, 0);}
+
+    const_iterator end() const {return const_iterator(this, size_);}
+
+    const_iterator cbegin() const {return begin();}
+
+    const_iterator cend() const {return end();}
+
+    reverse_iterator rbegin() {return reverse_iterator(end());}
+
+    reverse_iterator rend() {return reverse_iterator(begin());}
+
+    const_reverse_iterator rbegin() const {return const_reverse_iterator(end());}
+
+    const_reverse_iterator rend() const {return const_reverse_iterator(begin());}
+
+    T& operator[](size_t i) {return *element(i);}
+
+    const T& operator[](size_t i) const {return *element(i);}
+
+    T& front() {return *element(0);}
+
+    const T& front() const {return *element(0);}
+
+    T& back() {return *element(size_ - 1);}
+
+    const T& back() const {return *element(size_ - 1);}
+
+    // Reserves room in the directory for the blocks that n elements fill. The blocks
+    // themselves are allocated as they are needed.
+    void reserve(size_t n)
+    {
+        blocks_.reserve((front_ + n + block_size - 1) >> block_shift);
+    }
+
+    // Gives back the blocks after the last element
+    void shrink_to_fit()
+    {
+        if (size_ == 0)
+        {
+            clear();
+        }
+        else
+        {
+            const size_t needed = ((front_ + size_ - 1) >> block_shift) + 1;
+            for (size_t i = needed; i < blocks_.size(); ++i)
+            {
+                deallocate_block(blocks_[i]);
+            }
+            blocks_.erase(blocks_.begin() + needed, blocks_.end());
+        }
+        blocks_.shrink_to_fit();
+    }
+
+    // Destroys the elements and gives back the blocks
+    void clear()
+    {
+        for (size_t i = 0; i < size_; ++i)
+        {
+            destroy(element(i));
+        }
+        for (size_t i = 0; i < blocks_.size(); ++i)
+        {
+            deallocate_block(blocks_[i]);
+        }
+        blocks_.clear();
+        front_ = 0;
+        size_ = 0;
+    }
+
+    void resize(size_t n)
+    {
+        if (n < size_)
+        {
+            erase(begin() + n, end());
+        }
+        else
+        {
+            reserve(n);
+            while (size_ < n)
+            {
+                emplace_back();
+            }
+        }
+    }
+
+    void resize(size_t n, const T& value)
+    {
+        if (n < size_)
+        {
+            erase(begin() + n, end());
+        }
+        else
+        {
+            reserve(n);
+            while (size_ < n)
+            {
+                emplace_back(value);
+            }
+        }
+    }
+
+    template <class... Args>
+    void emplace_back(Args&&... args)
+    {
+        if (front_ + size_ == blocks_.size()*block_size)
+        {
+            add_block(blocks_.end());
+        }
+        construct(element(size_), std::forward<Args>(args)...);
+        ++size_;
+    }
+
+    void push_back(const T& value)
+    {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    void pop_back()
+    {
+        destroy(element(size_ - 1));
+        --size_;
+    }
+
+    template <class... Args>
+    void emplace_front(Args&&... args)
+    {
+        if (size_ == 0)
+        {
+            emplace_back(std::forward<Args>(args)...);
+            return;
+        }
+        const bool added = front_ == 0;
+        if (added)
+        {
+            add_block(blocks_.begin());
+            front_ = block_size;
+        }
+        try
+        {
+            construct(to_plain_pointer(blocks_[0]) + (front_ - 1), std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            if (added)
+            {
+                deallocate_block(blocks_[0]);
+                blocks_.erase(blocks_.begin());
+                front_ = 0;
+            }
+            throw;
+        }
+        --front_;
+        ++size_;
+    }
+
+    template <class... Args>
+    iterator emplace(const_iterator pos, Args&&... args)
+    {
+        const size_t index = pos.index_;
+        if (index == size_)
+        {
+            emplace_back(std::forward<Args>(args)...);
+        }
+        else if (index == 0)
+        {
+            emplace_front(std::forward<Args>(args)...);
+        }
+        else
+        {
+            T value(std::forward<Args>(args)...);
+            if (index < size_/2)
+            {
+                // The elements before the position move down one
+                emplace_front(std::move(front()));
+                std::move(begin() + 2, begin() + (index + 1), begin() + 1);
+            }
+            else
+            {
+                emplace_back(std::move(back()));
+                std::move_backward(begin() + index, end() - 2, end() - 1);
+            }
+            *element(index) = std::move(value);
+        }
+        return begin() + index;
+    }
+
+    iterator insert(const_iterator pos, const T& value)
+    {
+        return emplace(pos, value);
+    }
+
+    iterator insert(const_iterator pos, T&& value)
+    {
+        return emplace(pos, std::move(value));
+    }
+
+    template <class InputIt, class = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+    iterator insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        // Appends the new elements and rotates them into place
+        const size_t index = pos.index_;
+        const size_t old_size = size_;
+        append(first, last);
+        std::rotate(begin() + index, begin() + old_size, end());
+        return begin() + index;
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> init)
+    {
+        return insert(pos, init.begin(), init.end());
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        const size_t index = first.index_;
+        const size_t count = static_cast<size_t>(last - first);
+        if (count == 0)
+        {
+            return begin() + index;
+        }
+        if (index < size_ - (index + count))
+        {
+            // The elements before the range move up, and the front ones are removed
+            std::move_backward(begin(), begin() + index, begin() + (index + count));
+            for (size_t i = 0; i < count; ++i)
+            {
+                destroy(element(i));
+            }
+            front_ += count;
+            size_ -= count;
+            const size_t emptied = front_ >> block_shift;
+            for (size_t i = 0; i < emptied; ++i)
+            {
+                deallocate_block(blocks_[i]);
+            }
+            blocks_.erase(blocks_.begin(), blocks_.begin() + emptied);
+            front_ &= block_mask;
+        }
+        else
+        {
+            std::move(begin() + (index + count), end(), begin() + index);
+            for (size_t i = size_ - count; i < size_; ++i)
+            {
+                destroy(element(i));
+            }
+            size_ -= count;
+        }
+        return begin() + index;
+    }
+
+    void swap(block_vector& other) JSONCONS_NOEXCEPT
+    {
+        blocks_.swap(other.blocks_);
+        std::swap(front_, other.front_);
+        std::swap(size_, other.size_);
+    }
+
+    friend void swap(block_vector& a, block_vector& b) JSONCONS_NOEXCEPT
+    {
+        a.swap(b);
+    }
+
+    friend bool operator==(const block_vector& a, const block_vector& b)
+    {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+
+    friend bool operator!=(const block_vector& a, const block_vector& b)
+    {
+        return !(a == b);
+    }
+
+    // The number of blocks, for tests
+    size_t block_count() const
+    {
+        return blocks_.size();
+    }
+private:
+    T* element(size_t i) const
+    {
+        const size_t p = front_ + i;
+        return to_plain_pointer(blocks_[p >> block_shift]) + (p & block_mask);
+    }
+
+    // Inserts a new block into the directory before pos
+    void add_block(typename std::vector<block_pointer,directory_allocator_type>::iterator pos)
+    {
+        const size_t offset = static_cast<size_t>(pos - blocks_.begin());
+        // Room in the directory first, so that the insert cannot throw once the block is allocated
+        if (blocks_.size() == blocks_.capacity())
+        {
+            blocks_.reserve(blocks_.size() < 4 ? 4 : blocks_.size()*2);
+        }
+        element_allocator_type alloc(get_allocator());
+        block_pointer p = element_traits::allocate(alloc, block_size);
+        blocks_.insert(blocks_.begin() + offset, p);
+    }
+
+    void deallocate_block(block_pointer p)
+    {
+        element_allocator_type alloc(get_allocator());
+        element_traits::deallocate(alloc, p, block_size);
+    }
+
+    template <class... Args>
+    void construct(T* p, Args&&... args)
+    {
+        element_allocator_type alloc(get_allocator());
+        element_traits::construct(alloc, p, std::forward<Args>(args)...);
+    }
+
+    void destroy(T* p)
+    {
+        element_allocator_type alloc(get_allocator());
+        element_traits::destroy(alloc, p);
+    }
+
+    template <class InputIt>
+    void append(InputIt first, InputIt last)
+    {
+        for (; first != last; ++first)
+        {
+            emplace_back(*first);
+        }
+    }
+};
+
+}}
+
+#endif
@@ -0,0 +1,556 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_DETAIL_CHUNKEDVECTOR_HPP
+#define JSONCONS_DETAIL_CHUNKEDVECTOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <stdexcept>
+#include <jsoncons/detail/jsoncons_config.hpp>
+
+namespace jsoncons { namespace detail {
+
+// A sequence with the interface of a vector, held in chunks of at most max_chunk_size
+// elements. Inserting or erasing in the middle moves the elements of one chunk and updates
+// the start positions of the chunks after it, instead of moving every element after the
+// position, so keeping n elements sorted by inserting them one by one is no longer O(n^2)
+// element moves. The iterators are random access, moving within a chunk is as cheap as for
+// a pointer, and jumping to a position is a binary search of the chunk starts. Like those of
+// a vector, they are invalidated by inserting and erasing.
+
+template <class T, class Allocator = std::allocator<T>>
+class chunked_vector
+{
+public:
+    static const size_t max_chunk_size = 128;
+private:
+    typedef std::vector<T,Allocator> chunk_type;
+    typedef typename std::allocator_traits<Allocator>:: template rebind_alloc<chunk_type> chunk_allocator_type;
+    typedef typename std::allocator_traits<Allocator>:: template rebind_alloc<size_t> start_allocator_type;
+
+    // No chunk is empty, starts_[i] is the position of the first element of chunks_[i]
+    std::vector<chunk_type,chunk_allocator_type> chunks_;
+    std::vector<size_t,start_allocator_type> starts_;
+    size_t size_;
+
+    template <class Container, class Value>
+    class iterator_base
+    {
+        friend class chunked_vector;
+        template <class C, class V> friend class iterator_base;
+
+        Container* container_;
+        size_t chunk_;
+        size_t offset_;
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef ptrdiff_t difference_type;
+        typedef Value* pointer;
+        typedef Value& reference;
+
+        iterator_base()
+            : container_(nullptr), chunk_(0), offset_(0)
+        {
+        }
+
+        iterator_base(Container* container, size_t chunk, size_t offset)
+            : container_(container), chunk_(chunk), offset_(offset)
+        {
+        }
+
+        // An iterator converts to a const_iterator
+        template <class C, class V, class = typename std::enable_if<std::is_convertible<V*,Value*>::value>::type>
+        iterator_base(const iterator_base<C,V>& other)
+            : container_(other.container_), chunk_(other.chunk_), offset_(other.offset_)
+        {
+        }
+
+        reference operator*() const
+        {
+            return container_->chunks_[chunk_][offset_];
+        }
+
+        pointer operator->() const
+        {
+            return &container_->chunks_[chunk_][offset_];
+        }
+
+        reference operator[](difference_type n) const
+        {
+            return *(*this + n);
+        }
+
+        iterator_base& operator++()
+        {
+            if (++offset_ == container_->chunks_[chunk_].size() && chunk_ + 1 < container_->chunks_.size())
+            {
+                ++chunk_;
+                offset_ = 0;
+            }
+            return *this;
+        }
+
+        iterator_base operator++(int)
+        {
+            iterator_base temp(*this);
+            ++*this;
+            return temp;
+        }
+
+        iterator_base& operator--()
+        {
+            if (offset_ == 0)
+            {
+                --chunk_;
+                offset_ = container_->chunks_[chunk_].size() - 1;
+            }
+            else
+            {
+                --offset_;
+            }
+            return *this;
+        }
+
+        iterator_base operator--(int)
+        {
+            iterator_base temp(*this);
+            --*this;
+            return temp;
+        }
+
+        iterator_base& operator+=(difference_type n)
+        {
+            const difference_type offset = static_cast<difference_type>(offset_) + n;
+            if (n == 0)
+            {
+                return *this;
+            }
+            if (offset >= 0 && static_cast<size_t>(offset) < container_->chunks_[chunk_].size())
+            {
+                offset_ = static_cast<size_t>(offset);
+            }
+            else
+            {
+                container_->locate(index() + n, chunk_, offset_);
+            }
+            return *this;
+        }
+
+        iterator_base& operator-=(difference_type n)
+        {
+            return *this += -n;
+        }
+
+        friend iterator_base operator+(iterator_base it, difference_type n)
+        {
+            return it += n;
+        }
+
+        friend iterator_base operator+(difference_type n, iterator_base it)
+        {
+            return it += n;
+        }
+
+        friend iterator_base operator-(iterator_base it, difference_type n)
+        {
+            return it -= n;
+        }
+
+        template <class C, class V>
+        difference_type operator-(const iterator_base<C,V>& other) const
+        {
+            return static_cast<difference_type>(index()) - static_cast<difference_type>(other.index());
+        }
+
+        template <class C, class V>
+        bool operator==(const iterator_base<C,V>& other) const
+        {
+            return chunk_ == other.chunk_ && offset_ == other.offset_;
+        }
+
+        template <class C, class V>
+        bool operator!=(const iterator_base<C,V>& other) const
+        {
+            return !(*this == other);
+        }
+
+        template <class C, class V>
+        bool operator<(const iterator_base<C,V>& other) const
+        {
+            return chunk_ < other.chunk_ || (chunk_ == other.chunk_ && offset_ < other.offset_);
+        }
+
+        template <class C, class V>
+        bool operator>(const iterator_base<C,V>& other) const
+        {
+            return other < *this;
+        }
+
+        template <class C, class V>
+        bool operator<=(const iterator_base<C,V>& other) const
+        {
+            return !(other < *this);
+        }
+
+        template <class C, class V>
+        bool operator>=(const iterator_base<C,V>& other) const
+        {
+            return !(*this < other);
+        }
+    private:
+        size_t index() const
+        {
+            return container_->chunks_.empty() ? 0 : container_->starts_[chunk_] + offset_;
+        }
+    };
+public:
+    typedef T value_type;
+    typedef Allocator allocator_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef iterator_base<chunked_vector,T> iterator;
+    typedef iterator_base<const chunked_vector,const T> const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    chunked_vector()
+        : size_(0)
+    {
+    }
+
+    explicit chunked_vector(const Allocator& a)
+        : chunks_(chunk_allocator_type(a)), starts_(start_allocator_type(a)), size_(0)
+    {
+    }
+
+    chunked_vector(const chunked_vector& other)
+        : chunks_(other.chunks_), starts_(other.starts_), size_(other.size_)
+    {
+    }
+
+    chunked_vector(const chunked_vector& other, const Allocator& a)
+        : chunks_(chunk_allocator_type(a)), starts_(other.starts_, start_allocator_type(a)), size_(other.size_)
+    {
+        copy_chunks(other, a);
+    }
+
+    chunked_vector(chunked_vector&& other) JSONCONS_NOEXCEPT
+        : chunks_(std::move(other.chunks_)), starts_(std::move(other.starts_)), size_(other.size_)
+    {
+        other.size_ = 0;
+    }
+
+    chunked_vector(chunked_vector&& other, const Allocator& a)
+        : chunks_(chunk_allocator_type(a)), starts_(start_allocator_type(a)), size_(0)
+    {
+        if (other.get_allocator() == a)
+        {
+            chunks_ = std::move(other.chunks_);
+            starts_ = std::move(other.starts_);
+            size_ = other.size_;
+            other.size_ = 0;
+        }
+        else
+        {
+            starts_ = other.starts_;
+            size_ = other.size_;
+            copy_chunks(other, a);
+        }
+    }
+
+    chunked_vector& operator=(const chunked_vector& other)
+    {
+        if (this != &other)
+        {
+            chunks_ = other.chunks_;
+            starts_ = other.starts_;
+            size_ = other.size_;
+        }
+        return *this;
+    }
+
+    chunked_vector& operator=(chunked_vector&& other)
+    {
+        if (this != &other)
+        {
+            chunks_ = std::move(other.chunks_);
+            starts_ = std::move(other.starts_);
+            size_ = other.size_;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const
+    {
+        return allocator_type(chunks_.get_allocator());
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    size_t capacity() const
+    {
+        size_t n = 0;
+        for (const auto& chunk : chunks_)
+        {
+            n += chunk.capacity();
+        }
+        return n;
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    iterator begin() {return iterator(this, 0, 0);}
+
+    iterator end() {return chunks_.empty() ? iterator(this, 0, 0) : iterator(this, chunks_.size() - 1, chunks_.back().size());}
+
+    const_iterator begin() const {return const_iterator(this, 0, 0);}
+
+    const_iterator end() const {return chunks_.empty() ? const_iterator(this, 0, 0) : const_iterator(this, chunks_.size() - 1, chunks_.back().size());}
+
+    const_iterator cbegin() const {return begin();}
+
+    const_iterator cend() const {return end();}
+
+    reverse_iterator rbegin() {return reverse_iterator(end());}
+
+    reverse_iterator rend() {return reverse_iterator(begin());}
+
+    const_reverse_iterator rbegin() const {return const_reverse_iterator(end());}
+
+    const_reverse_iterator rend() const {return const_reverse_iterator(begin());}
+
+    T& operator[](size_t i) {return begin()[i];}
+
+    const T& operator[](size_t i) const {return begin()[i];}
+
+    T& front() {return chunks_.front().front();}
+
+    const T& front() const {return chunks_.front().front();}
+
+    T& back() {return chunks_.back().back();}
+
+    const T& back() const {return chunks_.back().back();}
+
+    // Reserves room for the chunks that n elements fill when appended
+    void reserve(size_t n)
+    {
+        const size_t chunks = (n + max_chunk_size - 1)/max_chunk_size;
+        chunks_.reserve(chunks);
+        starts_.reserve(chunks);
+    }
+
+    void shrink_to_fit()
+    {
+        for (auto& chunk : chunks_)
+        {
+            chunk.shrink_to_fit();
+        }
+        chunks_.shrink_to_fit();
+        starts_.shrink_to_fit();
+    }
+
+    void clear()
+    {
+        chunks_.clear();
+        starts_.clear();
+        size_ = 0;
+    }
+
+    template <class... Args>
+    void emplace_back(Args&&... args)
+    {
+        if (chunks_.empty() || chunks_.back().size() >= max_chunk_size)
+        {
+            chunks_.emplace_back(get_allocator());
+            starts_.push_back(size_);
+        }
+        chunks_.back().emplace_back(std::forward<Args>(args)...);
+        ++size_;
+    }
+
+    void push_back(const T& value)
+    {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    template <class... Args>
+    iterator emplace(const_iterator pos, Args&&... args)
+    {
+        if (chunks_.empty())
+        {
+            emplace_back(std::forward<Args>(args)...);
+            return begin();
+        }
+        size_t chunk = pos.chunk_;
+        size_t offset = pos.offset_;
+        chunk_type& target = chunks_[chunk];
+        target.emplace(target.begin() + offset, std::forward<Args>(args)...);
+        ++size_;
+        for (size_t i = chunk + 1; i < starts_.size(); ++i)
+        {
+            ++starts_[i];
+        }
+        if (target.size() > max_chunk_size)
+        {
+            split(chunk);
+            if (offset >= chunks_[chunk].size())
+            {
+                offset -= chunks_[chunk].size();
+                ++chunk;
+            }
+        }
+        return iterator(this, chunk, offset);
+    }
+
+    iterator insert(const_iterator pos, const T& value)
+    {
+        return emplace(pos, value);
+    }
+
+    iterator insert(const_iterator pos, T&& value)
+    {
+        return emplace(pos, std::move(value));
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        const size_t index = first.index();
+        size_t count = static_cast<size_t>(last - first);
+        if (count == 0)
+        {
+            return begin() + index;
+        }
+        size_t chunk = first.chunk_;
+        size_t offset = first.offset_;
+        while (count > 0)
+        {
+            chunk_type& target = chunks_[chunk];
+            const size_t n = (std::min)(count, target.size() - offset);
+            target.erase(target.begin() + offset, target.begin() + (offset + n));
+            count -= n;
+            size_ -= n;
+            if (target.empty())
+            {
+                chunks_.erase(chunks_.begin() + chunk);
+                starts_.erase(starts_.begin() + chunk);
+            }
+            else
+            {
+                ++chunk;
+            }
+            offset = 0;
+        }
+        update_starts(first.chunk_);
+        iterator it;
+        it.container_ = this;
+        locate(index, it.chunk_, it.offset_);
+        return it;
+    }
+
+    void swap(chunked_vector& other) JSONCONS_NOEXCEPT
+    {
+        chunks_.swap(other.chunks_);
+        starts_.swap(other.starts_);
+        std::swap(size_, other.size_);
+    }
+
+    friend void swap(chunked_vector& a, chunked_vector& b) JSONCONS_NOEXCEPT
+    {
+        a.swap(b);
+    }
+
+    friend bool operator==(const chunked_vector& a, const chunked_vector& b)
+    {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+
+    friend bool operator!=(const chunked_vector& a, const chunked_vector& b)
+    {
+        return !(a == b);
+    }
+
+    // The number of chunks, for tests
+    size_t chunk_count() const
+    {
+        return chunks_.size();
+    }
+private:
+    // Finds the chunk and offset of position i, the end position if i is the size
+    void locate(size_t i, size_t& chunk, size_t& offset) const
+    {
+        if (i >= size_)
+        {
+            chunk = chunks_.empty() ? 0 : chunks_.size() - 1;
+            offset = chunks_.empty() ? 0 : chunks_.back().size();
+            return;
+        }
+        auto it = std::upper_bound(starts_.begin(), starts_.end(), i);
+        chunk = static_cast<size_t>(it - starts_.begin()) - 1;
+        offset = i - starts_[chunk];
+    }
+
+    // Moves the upper half of a chunk into a new chunk after it
+    void split(size_t chunk)
+    {
+        chunk_type& source = chunks_[chunk];
+        const size_t half = source.size()/2;
+        chunk_type upper(std::make_move_iterator(source.begin() + half),
+                         std::make_move_iterator(source.end()),
+                         get_allocator());
+        source.erase(source.begin() + half, source.end());
+        chunks_.insert(chunks_.begin() + (chunk + 1), std::move(upper));
+        starts_.insert(starts_.begin() + (chunk + 1), starts_[chunk] + half);
+    }
+
+    // Recomputes the starts of the chunks from the given one on
+    void update_starts(size_t from)
+    {
+        size_t start = from == 0 ? 0 : starts_[from - 1] + chunks_[from - 1].size();
+        for (size_t i = from; i < chunks_.size(); ++i)
+        {
+            starts_[i] = start;
+            start += chunks_[i].size();
+        }
+    }
+
+    void copy_chunks(const chunked_vector& other, const Allocator& a)
+    {
+        chunks_.reserve(other.chunks_.size());
+        for (const auto& chunk : other.chunks_)
+        {
+            chunks_.emplace_back(chunk, a);
+        }
+    }
+};
+
+}}
+
+#endif
@@ -0,0 +1,604 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_DETAIL_COMPACTVECTOR_HPP
+#define JSONCONS_DETAIL_COMPACTVECTOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include <initializer_list>
+#include <stdexcept>
+#include <jsoncons/detail/jsoncons_config.hpp>
+#include <jsoncons/detail/type_traits_helper.hpp>
+
+namespace jsoncons { namespace detail {
+
+// A vector that is a single pointer (plus the allocator, if it has state). The size and
+// capacity are kept at the start of the block that holds the elements, so an empty
+// compact_vector allocates nothing, and a non empty one allocates once.
+
+template <class T, class Allocator = std::allocator<T>>
+class compact_vector
+{
+    struct header
+    {
+        size_t size_;
+        size_t capacity_;
+    };
+
+    // The block is allocated in units aligned for any scalar type, and the elements start
+    // at the first unit after the header. T may be incomplete here, as it may be for
+    // std::vector, so nothing at class scope depends on its size.
+    union storage_unit
+    {
+        header header_;
+        long double ld_;
+        long long ll_;
+        void* p_;
+    };
+    static const size_t header_units = 1;
+
+    typedef typename std::allocator_traits<Allocator>:: template rebind_alloc<storage_unit> storage_allocator_type;
+    typedef std::allocator_traits<storage_allocator_type> storage_traits;
+    typedef typename storage_traits::pointer storage_pointer;
+
+    typedef typename std::allocator_traits<Allocator>:: template rebind_alloc<T> element_allocator_type;
+    typedef std::allocator_traits<element_allocator_type> element_traits;
+
+    // Derives from the allocator so that a stateless one takes no space
+    struct impl : storage_allocator_type
+    {
+        storage_pointer ptr_;
+
+        impl(const storage_allocator_type& a)
+            : storage_allocator_type(a), ptr_(nullptr)
+        {
+        }
+    };
+
+    impl impl_;
+public:
+    typedef T value_type;
+    typedef Allocator allocator_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    compact_vector()
+        : impl_(storage_allocator_type())
+    {
+    }
+
+    explicit compact_vector(const Allocator& a)
+        : impl_(storage_allocator_type(a))
+    {
+    }
+
+    explicit compact_vector(size_t n, const Allocator& a = Allocator())
+        : impl_(storage_allocator_type(a))
+    {
+        resize(n);
+    }
+
+    compact_vector(size_t n, const T& value, const Allocator& a = Allocator())
+        : impl_(storage_allocator_type(a))
+    {
+        resize(n, value);
+    }
+
+    template <class InputIt, class = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+    compact_vector(InputIt first, InputIt last, const Allocator& a = Allocator())
+        : impl_(storage_allocator_type(a))
+    {
+        append(first, last, typename std::iterator_traits<InputIt>::iterator_category());
+    }
+
+    compact_vector(std::initializer_list<T> init, const Allocator& a = Allocator())
+        : impl_(storage_allocator_type(a))
+    {
+        append(init.begin(), init.end(), std::random_access_iterator_tag());
+    }
+
+    compact_vector(const compact_vector& other)
+        : impl_(storage_traits::select_on_container_copy_construction(other.impl_))
+    {
+        append(other.begin(), other.end(), std::random_access_iterator_tag());
+    }
+
+    compact_vector(const compact_vector& other, const Allocator& a)
+        : impl_(storage_allocator_type(a))
+    {
+        append(other.begin(), other.end(), std::random_access_iterator_tag());
+    }
+
+    compact_vector(compact_vector&& other) JSONCONS_NOEXCEPT
+        : impl_(other.impl_)
+    {
+        other.impl_.ptr_ = nullptr;
+    }
+
+    compact_vector(compact_vector&& other, const Allocator& a)
+        : impl_(storage_allocator_type(a))
+    {
+        if (static_cast<const storage_allocator_type&>(impl_) == static_cast<const storage_allocator_type&>(other.impl_))
+        {
+            std::swap(impl_.ptr_, other.impl_.ptr_);
+        }
+        else
+        {
+            append(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()), std::random_access_iterator_tag());
+        }
+    }
+
+    ~compact_vector()
+    {
+        release();
+    }
+
+    compact_vector& operator=(const compact_vector& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            if (storage_traits::propagate_on_container_copy_assignment::value &&
+                static_cast<const storage_allocator_type&>(impl_) != static_cast<const storage_allocator_type&>(other.impl_))
+            {
+                release();
+                static_cast<storage_allocator_type&>(impl_) = static_cast<const storage_allocator_type&>(other.impl_);
+            }
+            append(other.begin(), other.end(), std::random_access_iterator_tag());
+        }
+        return *this;
+    }
+
+    compact_vector& operator=(compact_vector&& other)
+    {
+        if (this != &other)
+        {
+            if (storage_traits::propagate_on_container_move_assignment::value ||
+                static_cast<const storage_allocator_type&>(impl_) == static_cast<const storage_allocator_type&>(other.impl_))
+            {
+                release();
+                static_cast<storage_allocator_type&>(impl_) = static_cast<const storage_allocator_type&>(other.impl_);
+                std::swap(impl_.ptr_, other.impl_.ptr_);
+            }
+            else
+            {
+                clear();
+                append(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()), std::random_access_iterator_tag());
+            }
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const
+    {
+        return allocator_type(static_cast<const storage_allocator_type&>(impl_));
+    }
+
+    size_t size() const
+    {
+        return impl_.ptr_ == nullptr ? 0 : get_header()->size_;
+    }
+
+    size_t capacity() const
+    {
+        return impl_.ptr_ == nullptr ? 0 : get_header()->capacity_;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    size_t max_size() const
+    {
+        return (storage_traits::max_size(impl_) - header_units)*sizeof(storage_unit)/sizeof(T);
+    }
+
+    T* data()
+    {
+        return elements();
+    }
+
+    const T* data() const
+    {
+        return elements();
+    }
+
+    iterator begin() {return elements();}
+
+    iterator end() {return elements() + size();}
+
+    const_iterator begin() const {return elements();}
+
+    const_iterator end() const {return elements() + size();}
+
+    const_iterator cbegin() const {return begin();}
+
+    const_iterator cend() const {return end();}
+
+    reverse_iterator rbegin() {return reverse_iterator(end());}
+
+    reverse_iterator rend() {return reverse_iterator(begin());}
+
+    const_reverse_iterator rbegin() const {return const_reverse_iterator(end());}
+
+    const_reverse_iterator rend() const {return const_reverse_iterator(begin());}
+
+    T& operator[](size_t i) {return elements()[i];}
+
+    const T& operator[](size_t i) const {return elements()[i];}
+
+    T& at(size_t i)
+    {
+        if (i >= size())
+        {
+            throw std::out_of_range("Invalid compact_vector index");
+        }
+        return elements()[i];
+    }
+
+    const T& at(size_t i) const
+    {
+        if (i >= size())
+        {
+            throw std::out_of_range("Invalid compact_vector index");
+        }
+        return elements()[i];
+    }
+
+    T& front() {return elements()[0];}
+
+    const T& front() const {return elements()[0];}
+
+    T& back() {return elements()[size()-1];}
+
+    const T& back() const {return elements()[size()-1];}
+
+    void reserve(size_t n)
+    {
+        if (n > capacity())
+        {
+            reallocate(n);
+        }
+    }
+
+    void shrink_to_fit()
+    {
+        if (impl_.ptr_ != nullptr)
+        {
+            if (size() == 0)
+            {
+                release();
+            }
+            else if (size() < capacity())
+            {
+                reallocate(size());
+            }
+        }
+    }
+
+    void clear()
+    {
+        if (impl_.ptr_ != nullptr)
+        {
+            destroy(elements(), elements() + size());
+            get_header()->size_ = 0;
+        }
+    }
+
+    void resize(size_t n)
+    {
+        if (n < size())
+        {
+            erase(begin() + n, end());
+        }
+        else
+        {
+            reserve(n);
+            while (size() < n)
+            {
+                construct_at_end();
+            }
+        }
+    }
+
+    void resize(size_t n, const T& value)
+    {
+        if (n < size())
+        {
+            erase(begin() + n, end());
+        }
+        else
+        {
+            reserve(n);
+            while (size() < n)
+            {
+                construct_at_end(value);
+            }
+        }
+    }
+
+    template <class... Args>
+    void emplace_back(Args&&... args)
+    {
+        if (size() == capacity())
+        {
+            // The new element is built in the new block before the old elements are moved,
+            // in case args refers to one of them
+            emplace_reallocate(size(), std::forward<Args>(args)...);
+        }
+        else
+        {
+            construct_at_end(std::forward<Args>(args)...);
+        }
+    }
+
+    void push_back(const T& value)
+    {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    void pop_back()
+    {
+        T* p = elements() + size() - 1;
+        destroy(p, p + 1);
+        --get_header()->size_;
+    }
+
+    template <class... Args>
+    iterator emplace(const_iterator pos, Args&&... args)
+    {
+        const size_t index = static_cast<size_t>(pos - begin());
+        if (size() == capacity())
+        {
+            emplace_reallocate(index, std::forward<Args>(args)...);
+        }
+        else if (index == size())
+        {
+            construct_at_end(std::forward<Args>(args)...);
+        }
+        else
+        {
+            T value(std::forward<Args>(args)...);
+            T* p = elements();
+            construct_at_end(std::move(p[size()-1]));
+            std::move_backward(p + index, p + size() - 2, p + size() - 1);
+            p[index] = std::move(value);
+        }
+        return begin() + index;
+    }
+
+    iterator insert(const_iterator pos, const T& value)
+    {
+        return emplace(pos, value);
+    }
+
+    iterator insert(const_iterator pos, T&& value)
+    {
+        return emplace(pos, std::move(value));
+    }
+
+    template <class InputIt, class = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+    iterator insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        // Appends the new elements and rotates them into place
+        const size_t index = static_cast<size_t>(pos - begin());
+        const size_t old_size = size();
+        append(first, last, typename std::iterator_traits<InputIt>::iterator_category());
+        std::rotate(begin() + index, begin() + old_size, end());
+        return begin() + index;
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> init)
+    {
+        return insert(pos, init.begin(), init.end());
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        T* p = elements();
+        T* from = p + (first - p);
+        T* to = p + (last - p);
+        if (from != to)
+        {
+            T* new_end = std::move(to, p + size(), from);
+            destroy(new_end, p + size());
+            get_header()->size_ -= static_cast<size_t>(to - from);
+        }
+        return from;
+    }
+
+    void swap(compact_vector& other) JSONCONS_NOEXCEPT
+    {
+        if (storage_traits::propagate_on_container_swap::value)
+        {
+            std::swap(static_cast<storage_allocator_type&>(impl_), static_cast<storage_allocator_type&>(other.impl_));
+        }
+        std::swap(impl_.ptr_, other.impl_.ptr_);
+    }
+
+    friend void swap(compact_vector& a, compact_vector& b) JSONCONS_NOEXCEPT
+    {
+        a.swap(b);
+    }
+
+    friend bool operator==(const compact_vector& a, const compact_vector& b)
+    {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+
+    friend bool operator!=(const compact_vector& a, const compact_vector& b)
+    {
+        return !(a == b);
+    }
+private:
+    header* get_header() const
+    {
+        return reinterpret_cast<header*>(to_plain_pointer(impl_.ptr_));
+    }
+
+    T* elements() const
+    {
+        return impl_.ptr_ == nullptr ? nullptr : reinterpret_cast<T*>(to_plain_pointer(impl_.ptr_) + header_units);
+    }
+
+    static size_t units_needed(size_t capacity)
+    {
+        return header_units + (capacity*sizeof(T) + sizeof(storage_unit) - 1)/sizeof(storage_unit);
+    }
+
+    size_t grown_capacity(size_t n) const
+    {
+        // Short containers start with room for a few elements rather than one
+        size_t cap = capacity() < 2 ? 4 : capacity() + capacity()/2;
+        return cap < n ? n : cap;
+    }
+
+    storage_pointer allocate(size_t capacity)
+    {
+        static_assert(JSONCONS_ALIGNOF(T) <= JSONCONS_ALIGNOF(storage_unit), "compact_vector elements must not need more than scalar alignment");
+        storage_pointer p = storage_traits::allocate(impl_, units_needed(capacity));
+        header* h = reinterpret_cast<header*>(to_plain_pointer(p));
+        h->size_ = 0;
+        h->capacity_ = capacity;
+        return p;
+    }
+
+    void deallocate(storage_pointer p)
+    {
+        storage_traits::deallocate(impl_, p, units_needed(reinterpret_cast<header*>(to_plain_pointer(p))->capacity_));
+    }
+
+    void destroy(T* first, T* last)
+    {
+        element_allocator_type alloc(static_cast<const storage_allocator_type&>(impl_));
+        for (; first != last; ++first)
+        {
+            element_traits::destroy(alloc, first);
+        }
+    }
+
+    void release()
+    {
+        if (impl_.ptr_ != nullptr)
+        {
+            destroy(elements(), elements() + size());
+            deallocate(impl_.ptr_);
+            impl_.ptr_ = nullptr;
+        }
+    }
+
+    // Moves the elements into a new block with room for capacity elements
+    void reallocate(size_t capacity)
+    {
+        storage_pointer p = allocate(capacity);
+        T* dest = reinterpret_cast<T*>(to_plain_pointer(p) + header_units);
+        const size_t n = size();
+        relocate(elements(), n, dest);
+        reinterpret_cast<header*>(to_plain_pointer(p))->size_ = n;
+        if (impl_.ptr_ != nullptr)
+        {
+            deallocate(impl_.ptr_);
+        }
+        impl_.ptr_ = p;
+    }
+
+    void relocate(T* source, size_t n, T* dest)
+    {
+        element_allocator_type alloc(static_cast<const storage_allocator_type&>(impl_));
+        for (size_t i = 0; i < n; ++i)
+        {
+            element_traits::construct(alloc, dest + i, std::move_if_noexcept(source[i]));
+            element_traits::destroy(alloc, source + i);
+        }
+    }
+
+    template <class... Args>
+    void emplace_reallocate(size_t index, Args&&... args)
+    {
+        const size_t n = size();
+        storage_pointer p = allocate(grown_capacity(n + 1));
+        T* dest = reinterpret_cast<T*>(to_plain_pointer(p) + header_units);
+        element_allocator_type alloc(static_cast<const storage_allocator_type&>(impl_));
+        try
+        {
+            element_traits::construct(alloc, dest + index, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            deallocate(p);
+            throw;
+        }
+        T* source = elements();
+        relocate(source, index, dest);
+        relocate(source + index, n - index, dest + index + 1);
+        reinterpret_cast<header*>(to_plain_pointer(p))->size_ = n + 1;
+        if (impl_.ptr_ != nullptr)
+        {
+            deallocate(impl_.ptr_);
+        }
+        impl_.ptr_ = p;
+    }
+
+    // Requires size() < capacity()
+    template <class... Args>
+    void construct_at_end(Args&&... args)
+    {
+        element_allocator_type alloc(static_cast<const storage_allocator_type&>(impl_));
+        element_traits::construct(alloc, elements() + size(), std::forward<Args>(args)...);
+        ++get_header()->size_;
+    }
+
+    template <class InputIt>
+    void append(InputIt first, InputIt last, std::input_iterator_tag)
+    {
+        for (; first != last; ++first)
+        {
+            emplace_back(*first);
+        }
+    }
+
+    template <class ForwardIt>
+    void append(ForwardIt first, ForwardIt last, std::forward_iterator_tag)
+    {
+        const size_t n = static_cast<size_t>(std::distance(first, last));
+        if (n > 0)
+        {
+            reserve(size() + n);
+            for (; first != last; ++first)
+            {
+                construct_at_end(*first);
+            }
+        }
+    }
+};
+
+}}
+
+#endif
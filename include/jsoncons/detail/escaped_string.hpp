@@ -0,0 +1,102 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_DETAIL_ESCAPEDSTRING_HPP
+#define JSONCONS_DETAIL_ESCAPEDSTRING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <jsoncons/detail/jsoncons_config.hpp>
+#include <jsoncons/detail/unicode_traits.hpp>
+
+namespace jsoncons { namespace detail {
+
+template <class CharT>
+uint32_t read_hex4(const CharT* p)
+{
+    uint32_t cp = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        const CharT c = p[i];
+        cp *= 16;
+        if (c >= '0' && c <= '9')
+        {
+            cp += c - '0';
+        }
+        else if (c >= 'a' && c <= 'f')
+        {
+            cp += c - 'a' + 10;
+        }
+        else
+        {
+            cp += c - 'A' + 10;
+        }
+    }
+    return cp;
+}
+
+// Appends to s the characters of [p, p+length), the text between the quotation marks of a
+// JSON string, with its escapes replaced. The text must be valid, as the parser checks it.
+// Never appends more characters than length.
+
+template <class CharT, class String>
+void unescape_string(const CharT* p, size_t length, String& s)
+{
+    const CharT* last = p + length;
+    const CharT* sb = p;
+    while (p < last)
+    {
+        if (*p != '\\')
+        {
+            ++p;
+            continue;
+        }
+        s.append(sb, p - sb);
+        ++p;
+        switch (*p++)
+        {
+            case 'b':
+                s.push_back('\b');
+                break;
+            case 'f':
+                s.push_back('\f');
+                break;
+            case 'n':
+                s.push_back('\n');
+                break;
+            case 'r':
+                s.push_back('\r');
+                break;
+            case 't':
+                s.push_back('\t');
+                break;
+            case 'u':
+            {
+                uint32_t cp = read_hex4(p);
+                p += 4;
+                if (unicons::is_high_surrogate(cp) && last - p >= 6 && p[0] == '\\' && p[1] == 'u')
+                {
+                    uint32_t cp2 = read_hex4(p + 2);
+                    p += 6;
+                    cp = 0x10000 + ((cp & 0x3FF) << 10) + (cp2 & 0x3FF);
+                }
+                unicons::convert(&cp, &cp + 1, std::back_inserter(s));
+                break;
+            }
+            default:
+                // '"', '\\' and '/' stand for themselves
+                s.push_back(p[-1]);
+                break;
+        }
+        sb = p;
+    }
+    s.append(sb, p - sb);
+}
+
+}}
+
+#endif
@@ -0,0 +1,302 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_DETAIL_GRISU2_HPP
+#define JSONCONS_DETAIL_GRISU2_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <jsoncons/detail/jsoncons_config.hpp>
+
+namespace jsoncons { namespace detail {
+
+// Grisu2 (Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately
+// with Integers", PLDI 2010). Produces the digits of a positive finite double such
+// that reading them back gives the same double, in almost all cases the shortest
+// such digits, using only 64 bit integer arithmetic.
+
+namespace grisu2_impl {
+
+struct diy_fp
+{
+    uint64_t f;
+    int e;
+
+    diy_fp(uint64_t f_, int e_)
+        : f(f_), e(e_)
+    {
+    }
+
+    static diy_fp sub(const diy_fp& x, const diy_fp& y)
+    {
+        return diy_fp(x.f - y.f, x.e);
+    }
+
+    // The upper 64 bits of the 128 bit product, rounded
+    static diy_fp mul(const diy_fp& x, const diy_fp& y)
+    {
+        const uint64_t u_lo = x.f & 0xFFFFFFFFu;
+        const uint64_t u_hi = x.f >> 32;
+        const uint64_t v_lo = y.f & 0xFFFFFFFFu;
+        const uint64_t v_hi = y.f >> 32;
+
+        const uint64_t p0 = u_lo * v_lo;
+        const uint64_t p1 = u_lo * v_hi;
+        const uint64_t p2 = u_hi * v_lo;
+        const uint64_t p3 = u_hi * v_hi;
+
+        uint64_t q = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu);
+        q += uint64_t(1) << 31;
+
+        return diy_fp(p3 + (p2 >> 32) + (p1 >> 32) + (q >> 32), x.e + y.e + 64);
+    }
+
+    static diy_fp normalize(diy_fp x)
+    {
+        while ((x.f >> 63) == 0)
+        {
+            x.f <<= 1;
+            --x.e;
+        }
+        return x;
+    }
+
+    static diy_fp normalize_to(const diy_fp& x, int target_exponent)
+    {
+        return diy_fp(x.f << (x.e - target_exponent), target_exponent);
+    }
+};
+
+struct cached_power
+{
+    uint64_t f;
+    int e;
+    int k;
+};
+
+// Returns c = f * 2^e ~= 10^k with alpha <= e_c + e + 64 <= gamma, where e is the
+// binary exponent of a normalized diy_fp
+inline cached_power get_cached_power(int e)
+{
+    static const cached_power powers[] =
+    {
+        { 0xAB70FE17C79AC6CA, -1060, -300 },
+        { 0xFF77B1FCBEBCDC4F, -1034, -292 },
+        { 0xBE5691EF416BD60C, -1007, -284 },
+        { 0x8DD01FAD907FFC3C,  -980, -276 },
+        { 0xD3515C2831559A83,  -954, -268 },
+        { 0x9D71AC8FADA6C9B5,  -927, -260 },
+        { 0xEA9C227723EE8BCB,  -901, -252 },
+        { 0xAECC49914078536D,  -874, -244 },
+        { 0x823C12795DB6CE57,  -847, -236 },
+        { 0xC21094364DFB5637,  -821, -228 },
+        { 0x9096EA6F3848984F,  -794, -220 },
+        { 0xD77485CB25823AC7,  -768, -212 },
+        { 0xA086CFCD97BF97F4,  -741, -204 },
+        { 0xEF340A98172AACE5,  -715, -196 },
+        { 0xB23867FB2A35B28E,  -688, -188 },
+        { 0x84C8D4DFD2C63F3B,  -661, -180 },
+        { 0xC5DD44271AD3CDBA,  -635, -172 },
+        { 0x936B9FCEBB25C996,  -608, -164 },
+        { 0xDBAC6C247D62A584,  -582, -156 },
+        { 0xA3AB66580D5FDAF6,  -555, -148 },
+        { 0xF3E2F893DEC3F126,  -529, -140 },
+        { 0xB5B5ADA8AAFF80B8,  -502, -132 },
+        { 0x87625F056C7C4A8B,  -475, -124 },
+        { 0xC9BCFF6034C13053,  -449, -116 },
+        { 0x964E858C91BA2655,  -422, -108 },
+        { 0xDFF9772470297EBD,  -396, -100 },
+        { 0xA6DFBD9FB8E5B88F,  -369,  -92 },
+        { 0xF8A95FCF88747D94,  -343,  -84 },
+        { 0xB94470938FA89BCF,  -316,  -76 },
+        { 0x8A08F0F8BF0F156B,  -289,  -68 },
+        { 0xCDB02555653131B6,  -263,  -60 },
+        { 0x993FE2C6D07B7FAC,  -236,  -52 },
+        { 0xE45C10C42A2B3B06,  -210,  -44 },
+        { 0xAA242499697392D3,  -183,  -36 },
+        { 0xFD87B5F28300CA0E,  -157,  -28 },
+        { 0xBCE5086492111AEB,  -130,  -20 },
+        { 0x8CBCCC096F5088CC,  -103,  -12 },
+        { 0xD1B71758E219652C,   -77,   -4 },
+        { 0x9C40000000000000,   -50,    4 },
+        { 0xE8D4A51000000000,   -24,   12 },
+        { 0xAD78EBC5AC620000,     3,   20 },
+        { 0x813F3978F8940984,    30,   28 },
+        { 0xC097CE7BC90715B3,    56,   36 },
+        { 0x8F7E32CE7BEA5C70,    83,   44 },
+        { 0xD5D238A4ABE98068,   109,   52 },
+        { 0x9F4F2726179A2245,   136,   60 },
+        { 0xED63A231D4C4FB27,   162,   68 },
+        { 0xB0DE65388CC8ADA8,   189,   76 },
+        { 0x83C7088E1AAB65DB,   216,   84 },
+        { 0xC45D1DF942711D9A,   242,   92 },
+        { 0x924D692CA61BE758,   269,  100 },
+        { 0xDA01EE641A708DEA,   295,  108 },
+        { 0xA26DA3999AEF774A,   322,  116 },
+        { 0xF209787BB47D6B85,   348,  124 },
+        { 0xB454E4A179DD1877,   375,  132 },
+        { 0x865B86925B9BC5C2,   402,  140 },
+        { 0xC83553C5C8965D3D,   428,  148 },
+        { 0x952AB45CFA97A0B3,   455,  156 },
+        { 0xDE469FBD99A05FE3,   481,  164 },
+        { 0xA59BC234DB398C25,   508,  172 },
+        { 0xF6C69A72A3989F5C,   534,  180 },
+        { 0xB7DCBF5354E9BECE,   561,  188 },
+        { 0x88FCF317F22241E2,   588,  196 },
+        { 0xCC20CE9BD35C78A5,   614,  204 },
+        { 0x98165AF37B2153DF,   641,  212 },
+        { 0xE2A0B5DC971F303A,   667,  220 },
+        { 0xA8D9D1535CE3B396,   694,  228 },
+        { 0xFB9B7CD9A4A7443C,   720,  236 },
+        { 0xBB764C4CA7A44410,   747,  244 },
+        { 0x8BAB8EEFB6409C1A,   774,  252 },
+        { 0xD01FEF10A657842C,   800,  260 },
+        { 0x9B10A4E5E9913129,   827,  268 },
+        { 0xE7109BFBA19C0C9D,   853,  276 },
+        { 0xAC2820D9623BF429,   880,  284 },
+        { 0x80444B5E7AA7CF85,   907,  292 },
+        { 0xBF21E44003ACDD2D,   933,  300 },
+        { 0x8E679C2F5E44FF8F,   960,  308 },
+        { 0xD433179D9C8CB841,   986,  316 },
+        { 0x9E19DB92B4E31BA9,  1013,  324 }
+    };
+
+    const int alpha = -60;
+    const int min_decimal_exponent = -300;
+    const int decimal_exponent_step = 8;
+
+    const int f = alpha - e - 1;
+    const int k = (f * 78913) / (1 << 18) + (f > 0);
+    const int index = (-min_decimal_exponent + k + (decimal_exponent_step - 1)) / decimal_exponent_step;
+    return powers[index];
+}
+
+inline int find_largest_pow10(uint32_t n, uint32_t& pow10)
+{
+    static const uint32_t powers[] = {1u,10u,100u,1000u,10000u,100000u,1000000u,10000000u,100000000u,1000000000u};
+    int k = 10;
+    while (k > 1 && n < powers[k-1])
+    {
+        --k;
+    }
+    pow10 = powers[k-1];
+    return k;
+}
+
+inline void round_weed(char* buffer, int length, uint64_t dist, uint64_t delta, uint64_t rest, uint64_t ten_k)
+{
+    // Moves the last digit down while that brings the result closer to the
+    // exact value and stays inside the rounding interval
+    while (rest < dist && delta - rest >= ten_k &&
+           (rest + ten_k < dist || dist - rest > rest + ten_k - dist))
+    {
+        --buffer[length - 1];
+        rest += ten_k;
+    }
+}
+
+inline void digit_gen(char* buffer, int& length, int& decimal_exponent,
+                      const diy_fp& m_minus, const diy_fp& w, const diy_fp& m_plus)
+{
+    uint64_t delta = diy_fp::sub(m_plus, m_minus).f;
+    uint64_t dist = diy_fp::sub(m_plus, w).f;
+
+    const diy_fp one(uint64_t(1) << -m_plus.e, m_plus.e);
+
+    uint32_t p1 = static_cast<uint32_t>(m_plus.f >> -one.e);
+    uint64_t p2 = m_plus.f & (one.f - 1);
+
+    uint32_t pow10;
+    int n = find_largest_pow10(p1, pow10);
+
+    while (n > 0)
+    {
+        const uint32_t d = p1 / pow10;
+        p1 %= pow10;
+        buffer[length++] = static_cast<char>('0' + d);
+        --n;
+
+        const uint64_t rest = (uint64_t(p1) << -one.e) + p2;
+        if (rest <= delta)
+        {
+            decimal_exponent += n;
+            round_weed(buffer, length, dist, delta, rest, uint64_t(pow10) << -one.e);
+            return;
+        }
+        pow10 /= 10;
+    }
+
+    int m = 0;
+    for (;;)
+    {
+        p2 *= 10;
+        const uint64_t d = p2 >> -one.e;
+        p2 &= one.f - 1;
+        buffer[length++] = static_cast<char>('0' + d);
+        ++m;
+
+        delta *= 10;
+        dist *= 10;
+        if (p2 <= delta)
+        {
+            break;
+        }
+    }
+    decimal_exponent -= m;
+    round_weed(buffer, length, dist, delta, p2, one.f);
+}
+
+}
+
+// Writes the digits of v (positive and finite) to buffer, which must have room for
+// 17 characters, so that v ~= digits * 10^decimal_exponent. Returns the number of digits.
+
+inline int grisu2(double v, char* buffer, int& decimal_exponent)
+{
+    using grisu2_impl::diy_fp;
+
+    const uint64_t hidden_bit = uint64_t(1) << 52;
+    const int exponent_bias = 1023 + 52;
+
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    const uint64_t biased_e = bits >> 52;
+    const uint64_t fraction = bits & (hidden_bit - 1);
+
+    const diy_fp w = biased_e == 0
+        ? diy_fp(fraction, 1 - exponent_bias)
+        : diy_fp(fraction + hidden_bit, static_cast<int>(biased_e) - exponent_bias);
+
+    // The boundaries of the rounding interval, halfway to the neighbouring doubles.
+    // The lower boundary is closer when v is a power of two (other than the smallest normal)
+    const bool lower_boundary_is_closer = fraction == 0 && biased_e > 1;
+    const diy_fp upper = diy_fp::normalize(diy_fp(2*w.f + 1, w.e - 1));
+    const diy_fp lower = diy_fp::normalize_to(lower_boundary_is_closer
+                                                  ? diy_fp(4*w.f - 1, w.e - 2)
+                                                  : diy_fp(2*w.f - 1, w.e - 1),
+                                              upper.e);
+    const diy_fp wn = diy_fp::normalize(w);
+
+    const grisu2_impl::cached_power cached = grisu2_impl::get_cached_power(upper.e);
+    const diy_fp c(cached.f, cached.e);
+
+    const diy_fp scaled_w = diy_fp::mul(wn, c);
+    const diy_fp scaled_lower = diy_fp::mul(lower, c);
+    const diy_fp scaled_upper = diy_fp::mul(upper, c);
+
+    // Narrow the interval by one unit on both sides to allow for the rounding of mul
+    const diy_fp m_minus(scaled_lower.f + 1, scaled_lower.e);
+    const diy_fp m_plus(scaled_upper.f - 1, scaled_upper.e);
+
+    int length = 0;
+    decimal_exponent = -cached.k;
+    grisu2_impl::digit_gen(buffer, length, decimal_exponent, m_minus, scaled_w, m_plus);
+    return length;
+}
+
+}}
+
+#endif
@@ -22,18 +22,26 @@
 // Uncomment the following line to suppress deprecated names (recommended for new code)
 //#define JSONCONS_NO_DEPRECATED
 
+// Uncomment the following line to store strings of up to 21 bytes in a json value rather than
+// on the heap, at the cost of making each value 24 rather than 16 bytes (on 64 bit platforms).
+// It must be defined the same way in every translation unit of a program.
+//#define JSONCONS_WIDE_SMALL_STRING
+
 #if defined(__GNUC__) || defined(__clang__)
 #define JSONCONS_LIKELY(x) __builtin_expect(!!(x), 1)
 #define JSONCONS_UNLIKELY(x) __builtin_expect(!!(x), 0)
 #define JSONCONS_UNREACHABLE() __builtin_unreachable()
+#define JSONCONS_PREFETCH(p) __builtin_prefetch(p)
 #elif defined(_MSC_VER)
 #define JSONCONS_LIKELY(x) x
 #define JSONCONS_UNLIKELY(x) x
 #define JSONCONS_UNREACHABLE() __assume(0)
+#define JSONCONS_PREFETCH(p) do {} while (0)
 #else
 #define JSONCONS_LIKELY(x) x
 #define JSONCONS_UNLIKELY(x) x
 #define JSONCONS_UNREACHABLE() do {} while (0)
+#define JSONCONS_PREFETCH(p) do {} while (0)
 #endif
 
 #if defined(__GNUC__) && !defined(__INTEL_COMPILER) && !defined(__clang__) && \
@@ -59,6 +67,24 @@ namespace jsoncons
 
 //#define JSONCONS_HAS_STRING_VIEW
 
+// basic_json::as_optional, with C++17
+#if !defined(JSONCONS_HAS_OPTIONAL) && defined(__has_include)
+#if __has_include(<optional>) && ((defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L)
+#define JSONCONS_HAS_OPTIONAL
+#endif
+#endif
+
+// basic_static_json, whose text is parsed at compile time, with the relaxed constexpr of C++14
+#if !defined(JSONCONS_HAS_CONSTEXPR_PARSE) && defined(__cpp_constexpr) && __cpp_constexpr >= 201304L
+#define JSONCONS_HAS_CONSTEXPR_PARSE
+#endif
+
+// basic_json::parse keeps a parser and decoder per thread, for compilers without thread_local
+// define JSONCONS_NO_THREAD_LOCAL to construct them on each call
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define JSONCONS_NO_THREAD_LOCAL
+#endif
+
 #if defined(ANDROID) || defined(__ANDROID__)
 #define JSONCONS_HAS_STRTOLD_L
 #endif
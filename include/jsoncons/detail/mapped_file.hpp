@@ -0,0 +1,177 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_DETAIL_MAPPEDFILE_HPP
+#define JSONCONS_DETAIL_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <system_error>
+#include <jsoncons/detail/jsoncons_config.hpp>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace jsoncons { namespace detail {
+
+// A read only memory mapping of a whole file. A sequential mapping is read ahead of
+// the reader and dropped behind it, a random one is paged in as it is touched.
+
+class mapped_file
+{
+    const char* data_;
+    size_t size_;
+    bool sequential_;
+#if defined(_WIN32)
+    HANDLE file_;
+    HANDLE mapping_;
+#else
+    int fd_;
+#endif
+
+    // Noncopyable and nonmoveable
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+public:
+    mapped_file(const std::string& filename, std::error_code& ec, bool sequential = true)
+        : data_(nullptr),
+          size_(0),
+          sequential_(sequential)
+#if defined(_WIN32)
+          , file_(INVALID_HANDLE_VALUE),
+          mapping_(NULL)
+#else
+          , fd_(-1)
+#endif
+    {
+        open(filename, ec);
+    }
+
+    ~mapped_file()
+    {
+        close();
+    }
+
+    const char* data() const
+    {
+        return data_;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+private:
+#if defined(_WIN32)
+    void open(const std::string& filename, std::error_code& ec)
+    {
+        file_ = ::CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, sequential_ ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS, NULL);
+        if (file_ == INVALID_HANDLE_VALUE)
+        {
+            ec = std::error_code(static_cast<int>(::GetLastError()), std::system_category());
+            return;
+        }
+        LARGE_INTEGER size;
+        if (!::GetFileSizeEx(file_, &size))
+        {
+            ec = std::error_code(static_cast<int>(::GetLastError()), std::system_category());
+            return;
+        }
+        size_ = static_cast<size_t>(size.QuadPart);
+        if (size_ == 0)
+        {
+            return;
+        }
+        mapping_ = ::CreateFileMappingA(file_, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping_ == NULL)
+        {
+            ec = std::error_code(static_cast<int>(::GetLastError()), std::system_category());
+            size_ = 0;
+            return;
+        }
+        data_ = static_cast<const char*>(::MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+        if (data_ == nullptr)
+        {
+            ec = std::error_code(static_cast<int>(::GetLastError()), std::system_category());
+            size_ = 0;
+        }
+    }
+
+    void close()
+    {
+        if (data_ != nullptr)
+        {
+            ::UnmapViewOfFile(data_);
+        }
+        if (mapping_ != NULL)
+        {
+            ::CloseHandle(mapping_);
+        }
+        if (file_ != INVALID_HANDLE_VALUE)
+        {
+            ::CloseHandle(file_);
+        }
+    }
+#else
+    void open(const std::string& filename, std::error_code& ec)
+    {
+        fd_ = ::open(filename.c_str(), O_RDONLY);
+        if (fd_ == -1)
+        {
+            ec = std::error_code(errno, std::system_category());
+            return;
+        }
+        struct stat st;
+        if (::fstat(fd_, &st) == -1)
+        {
+            ec = std::error_code(errno, std::system_category());
+            return;
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ == 0)
+        {
+            return;
+        }
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (p == MAP_FAILED)
+        {
+            ec = std::error_code(errno, std::system_category());
+            size_ = 0;
+            return;
+        }
+        ::madvise(p, size_, sequential_ ? MADV_SEQUENTIAL : MADV_RANDOM);
+        data_ = static_cast<const char*>(p);
+    }
+
+    void close()
+    {
+        if (data_ != nullptr)
+        {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+        if (fd_ != -1)
+        {
+            ::close(fd_);
+        }
+    }
+#endif
+};
+
+}}
+
+#endif
@@ -0,0 +1,197 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_DETAIL_NUMBERTEXT_HPP
+#define JSONCONS_DETAIL_NUMBERTEXT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <jsoncons/detail/jsoncons_config.hpp>
+#include <jsoncons/detail/type_traits_helper.hpp>
+
+namespace jsoncons { namespace detail {
+
+// What the text of a JSON number converts to, by the rules the parser uses for its events:
+// an integer that fits in an int64_t if negative, or a uint64_t if not, is an integer,
+// anything else a double
+
+enum class number_text_kind : uint8_t {integer, uinteger, floating_point};
+
+struct number_text_value
+{
+    number_text_kind kind;
+    // For a double, the number of significant digits in the text, at most max_digits10
+    uint8_t precision;
+    int64_t integer;
+    uint64_t uinteger;
+    double floating_point;
+};
+
+// Whether [s, s+length) is a number by the JSON grammar
+
+template <class CharT>
+bool is_number_text(const CharT* s, size_t length)
+{
+    const CharT* p = s;
+    const CharT* last = s + length;
+    if (p < last && *p == '-')
+    {
+        ++p;
+    }
+    if (p == last || *p < '0' || *p > '9')
+    {
+        return false;
+    }
+    if (*p == '0')
+    {
+        ++p;
+    }
+    else
+    {
+        while (p < last && *p >= '0' && *p <= '9')
+        {
+            ++p;
+        }
+    }
+    if (p < last && *p == '.')
+    {
+        const CharT* fraction = ++p;
+        while (p < last && *p >= '0' && *p <= '9')
+        {
+            ++p;
+        }
+        if (p == fraction)
+        {
+            return false;
+        }
+    }
+    if (p < last && (*p == 'e' || *p == 'E'))
+    {
+        ++p;
+        if (p < last && (*p == '+' || *p == '-'))
+        {
+            ++p;
+        }
+        const CharT* exponent = p;
+        while (p < last && *p >= '0' && *p <= '9')
+        {
+            ++p;
+        }
+        if (p == exponent)
+        {
+            return false;
+        }
+    }
+    return p == last;
+}
+
+inline
+double number_text_to_double(const std::string& buffer)
+{
+#if !defined(JSONCONS_NO_THREAD_LOCAL)
+    static thread_local string_to_double to_double;
+#else
+    string_to_double to_double;
+#endif
+    return to_double(buffer.data(), buffer.length());
+}
+
+// Converts [s, s+length), which must satisfy is_number_text
+
+template <class CharT>
+number_text_value read_number_text(const CharT* s, size_t length)
+{
+    number_text_value result = {number_text_kind::uinteger, 0, 0, 0, 0.0};
+
+    const CharT* last = s + length;
+    const bool is_negative = length > 0 && *s == '-';
+    const CharT* digits = is_negative ? s + 1 : s;
+
+    const CharT* p = digits;
+    while (p < last && *p >= '0' && *p <= '9')
+    {
+        ++p;
+    }
+    size_t precision = p - digits;
+    if (p == last)
+    {
+        if (is_negative)
+        {
+            static const int64_t min_value = (std::numeric_limits<int64_t>::min)();
+            static const int64_t min_value_div_10 = min_value / 10;
+            int64_t n = 0;
+            const CharT* q = digits;
+            for (; q < last; ++q)
+            {
+                int64_t x = *q - '0';
+                if (n < min_value_div_10 || n * 10 < min_value + x)
+                {
+                    break;
+                }
+                n = n * 10 - x;
+            }
+            if (q == last)
+            {
+                result.kind = number_text_kind::integer;
+                result.integer = n;
+                return result;
+            }
+        }
+        else
+        {
+            static const uint64_t max_value = (std::numeric_limits<uint64_t>::max)();
+            static const uint64_t max_value_div_10 = max_value / 10;
+            uint64_t n = 0;
+            const CharT* q = digits;
+            for (; q < last; ++q)
+            {
+                uint64_t x = *q - '0';
+                if (n > max_value_div_10 || n * 10 > max_value - x)
+                {
+                    break;
+                }
+                n = n * 10 + x;
+            }
+            if (q == last)
+            {
+                result.kind = number_text_kind::uinteger;
+                result.uinteger = n;
+                return result;
+            }
+        }
+    }
+    else if (*p == '.')
+    {
+        const CharT* fraction = ++p;
+        while (p < last && *p >= '0' && *p <= '9')
+        {
+            ++p;
+        }
+        precision += p - fraction;
+    }
+
+    std::string buffer;
+    buffer.reserve(last - digits);
+    for (const CharT* q = digits; q < last; ++q)
+    {
+        if (*q != '+')
+        {
+            buffer.push_back(static_cast<char>(*q));
+        }
+    }
+    double d = number_text_to_double(buffer);
+    result.kind = number_text_kind::floating_point;
+    result.floating_point = is_negative ? -d : d;
+    result.precision = static_cast<uint8_t>((std::min)(precision, static_cast<size_t>(std::numeric_limits<double>::max_digits10)));
+    return result;
+}
+
+}}
+
+#endif
@@ -0,0 +1,171 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_DETAIL_PARALLELWORKERS_HPP
+#define JSONCONS_DETAIL_PARALLELWORKERS_HPP
+
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <utility>
+
+namespace jsoncons { namespace detail {
+
+// Holds the threads a caller starts and joins them when it goes out of scope, so that
+// neither a thread that fails to start nor an exception on the calling thread leaves
+// a joinable std::thread to be destroyed. A caller whose workers wait on it must wake
+// them before the threads are joined.
+
+class joining_threads
+{
+    std::vector<std::thread> threads_;
+
+    // Noncopyable and nonmoveable
+    joining_threads(const joining_threads&) = delete;
+    joining_threads& operator=(const joining_threads&) = delete;
+public:
+    explicit joining_threads(size_t capacity)
+    {
+        threads_.reserve(capacity);
+    }
+
+    ~joining_threads()
+    {
+        join();
+    }
+
+    template <class Function, class... Args>
+    void start(Function&& f, Args&&... args)
+    {
+        threads_.emplace_back(std::forward<Function>(f), std::forward<Args>(args)...);
+    }
+
+    // Joins the i-th thread started
+    void join(size_t i)
+    {
+        if (threads_[i].joinable())
+        {
+            threads_[i].join();
+        }
+    }
+
+    void join()
+    {
+        for (auto& t : threads_)
+        {
+            if (t.joinable())
+            {
+                t.join();
+            }
+        }
+        threads_.clear();
+    }
+};
+
+// Calls produce(i) for each i in [0,count) on up to workers threads, and consume(i) on
+// the calling thread in the order of i. At most twice as many items as there are workers
+// are produced ahead of the one being consumed, to bound what is held. consume returns
+// false to stop. An exception thrown by produce or consume, or by a thread failing to
+// start, stops the workers and is rethrown once they have finished.
+
+template <class Produce, class Consume>
+void run_ordered(size_t count, size_t workers, Produce produce, Consume consume)
+{
+    const size_t window = 2*workers;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic<size_t> next(0);
+    std::vector<char> ready(count, 0);
+    std::vector<std::exception_ptr> errors(count);
+    size_t delivered = 0;
+    bool stop = false;
+
+    auto work = [&]()
+    {
+        for (;;)
+        {
+            const size_t i = next++;
+            if (i >= count)
+            {
+                return;
+            }
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&]{return stop || i < delivered + window;});
+                if (stop)
+                {
+                    return;
+                }
+            }
+            try
+            {
+                produce(i);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ready[i] = 1;
+            }
+            cv.notify_all();
+        }
+    };
+
+    joining_threads threads(workers);
+    std::exception_ptr error;
+    try
+    {
+        for (size_t i = 0; i < workers; ++i)
+        {
+            threads.start(work);
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&]{return ready[i] != 0;});
+            }
+            if (errors[i])
+            {
+                std::rethrow_exception(errors[i]);
+            }
+            const bool more = consume(i);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                delivered = i + 1;
+            }
+            cv.notify_all();
+            if (!more)
+            {
+                break;
+            }
+        }
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    cv.notify_all();
+    threads.join();
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+}}
+
+#endif
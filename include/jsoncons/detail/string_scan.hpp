@@ -0,0 +1,699 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_DETAIL_STRINGSCAN_HPP
+#define JSONCONS_DETAIL_STRINGSCAN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <jsoncons/detail/jsoncons_config.hpp>
+#include <jsoncons/detail/unicode_traits.hpp>
+
+#if !defined(JSONCONS_NO_SIMD)
+#if defined(__AVX2__)
+#define JSONCONS_HAS_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JSONCONS_HAS_SSE2
+#include <emmintrin.h>
+#if defined(__SSSE3__)
+#define JSONCONS_HAS_SSSE3
+#include <tmmintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define JSONCONS_HAS_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace jsoncons { namespace detail {
+
+// Returns a pointer to the first character in [p,last) that ends a run of plain
+// string characters, i.e. a quotation mark, a reverse solidus, or a control
+// character (less than 0x20), or last if there is none.
+
+template <class CharT>
+const CharT* skip_plain_string_chars(const CharT* p, const CharT* last)
+{
+    while (p < last)
+    {
+        const auto c = *p;
+        if (c == '\"' || c == '\\' || static_cast<uint32_t>(c) < 0x20)
+        {
+            return p;
+        }
+        ++p;
+    }
+    return p;
+}
+
+#if defined(JSONCONS_HAS_AVX2) || defined(JSONCONS_HAS_SSE2)
+
+inline
+unsigned scan_trailing_zeros(uint32_t mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+#endif
+
+template <>
+inline
+const char* skip_plain_string_chars<char>(const char* p, const char* last)
+{
+#if defined(JSONCONS_HAS_AVX2)
+    const __m256i quote = _mm256_set1_epi8('\"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i max_control = _mm256_set1_epi8(0x1f);
+    while (last - p >= 32)
+    {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const __m256i is_quote = _mm256_cmpeq_epi8(chunk, quote);
+        const __m256i is_backslash = _mm256_cmpeq_epi8(chunk, backslash);
+        // unsigned chunk <= 0x1f
+        const __m256i is_control = _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, max_control), chunk);
+        const __m256i special = _mm256_or_si256(_mm256_or_si256(is_quote, is_backslash), is_control);
+        const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(special));
+        if (mask != 0)
+        {
+            return p + scan_trailing_zeros(mask);
+        }
+        p += 32;
+    }
+#endif
+#if defined(JSONCONS_HAS_AVX2) || defined(JSONCONS_HAS_SSE2)
+    const __m128i quote16 = _mm_set1_epi8('\"');
+    const __m128i backslash16 = _mm_set1_epi8('\\');
+    const __m128i max_control16 = _mm_set1_epi8(0x1f);
+    while (last - p >= 16)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i is_quote = _mm_cmpeq_epi8(chunk, quote16);
+        const __m128i is_backslash = _mm_cmpeq_epi8(chunk, backslash16);
+        const __m128i is_control = _mm_cmpeq_epi8(_mm_min_epu8(chunk, max_control16), chunk);
+        const __m128i special = _mm_or_si128(_mm_or_si128(is_quote, is_backslash), is_control);
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+        if (mask != 0)
+        {
+            return p + scan_trailing_zeros(mask);
+        }
+        p += 16;
+    }
+#elif defined(JSONCONS_HAS_NEON)
+    const uint8x16_t quote = vdupq_n_u8('\"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const uint8x16_t control_limit = vdupq_n_u8(0x20);
+    while (last - p >= 16)
+    {
+        const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+        const uint8x16_t special = vorrq_u8(vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)),
+                                            vcltq_u8(chunk, control_limit));
+        // Locate the special byte in this block with the scalar loop below
+        const uint64x2_t halves = vreinterpretq_u64_u8(special);
+        if ((vgetq_lane_u64(halves, 0) | vgetq_lane_u64(halves, 1)) != 0)
+        {
+            break;
+        }
+        p += 16;
+    }
+#endif
+    while (p < last)
+    {
+        const uint8_t c = static_cast<uint8_t>(*p);
+        if (c == '\"' || c == '\\' || c < 0x20)
+        {
+            return p;
+        }
+        ++p;
+    }
+    return p;
+}
+
+// Returns a pointer to the first character in [p,last) that escape_string must escape: a
+// quotation mark, a reverse solidus, a control character (less than 0x20, or 0x7f), a solidus
+// if escape_solidus, or a non ASCII character if escape_non_ascii. Returns last if there is none.
+
+template <class CharT>
+const CharT* find_escaped_char(const CharT* p, const CharT* last, bool escape_solidus, bool escape_non_ascii)
+{
+    while (p < last)
+    {
+        const uint32_t c = static_cast<uint32_t>(*p);
+        if (c == '\"' || c == '\\' || c < 0x20 || c == 0x7f || (escape_solidus && c == '/') || (escape_non_ascii && c >= 0x80))
+        {
+            return p;
+        }
+        ++p;
+    }
+    return p;
+}
+
+template <>
+inline
+const char* find_escaped_char<char>(const char* p, const char* last, bool escape_solidus, bool escape_non_ascii)
+{
+#if defined(JSONCONS_HAS_AVX2) || defined(JSONCONS_HAS_SSE2)
+    // Without escape_solidus, compare with the quotation mark a second time
+    const char solidus = escape_solidus ? '/' : '\"';
+#endif
+#if defined(JSONCONS_HAS_AVX2)
+    {
+        const __m256i quote = _mm256_set1_epi8('\"');
+        const __m256i backslash = _mm256_set1_epi8('\\');
+        const __m256i del = _mm256_set1_epi8(0x7f);
+        const __m256i slash = _mm256_set1_epi8(solidus);
+        const __m256i max_control = _mm256_set1_epi8(0x1f);
+        const uint32_t non_ascii_mask = escape_non_ascii ? 0xffffffff : 0;
+        while (last - p >= 32)
+        {
+            const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            const __m256i is_control = _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, max_control), chunk);
+            const __m256i special = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)),
+                                                    _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, del), _mm256_cmpeq_epi8(chunk, slash)), is_control));
+            // The high bit of each byte marks a non ASCII character
+            const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(special)) |
+                                  (static_cast<uint32_t>(_mm256_movemask_epi8(chunk)) & non_ascii_mask);
+            if (mask != 0)
+            {
+                return p + scan_trailing_zeros(mask);
+            }
+            p += 32;
+        }
+    }
+#endif
+#if defined(JSONCONS_HAS_AVX2) || defined(JSONCONS_HAS_SSE2)
+    {
+        const __m128i quote = _mm_set1_epi8('\"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i del = _mm_set1_epi8(0x7f);
+        const __m128i slash = _mm_set1_epi8(solidus);
+        const __m128i max_control = _mm_set1_epi8(0x1f);
+        const uint32_t non_ascii_mask = escape_non_ascii ? 0xffff : 0;
+        while (last - p >= 16)
+        {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            const __m128i is_control = _mm_cmpeq_epi8(_mm_min_epu8(chunk, max_control), chunk);
+            const __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                                                 _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, del), _mm_cmpeq_epi8(chunk, slash)), is_control));
+            const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(special)) |
+                                  (static_cast<uint32_t>(_mm_movemask_epi8(chunk)) & non_ascii_mask);
+            if (mask != 0)
+            {
+                return p + scan_trailing_zeros(mask);
+            }
+            p += 16;
+        }
+    }
+#elif defined(JSONCONS_HAS_NEON)
+    {
+        const uint8x16_t quote = vdupq_n_u8('\"');
+        const uint8x16_t backslash = vdupq_n_u8('\\');
+        const uint8x16_t del = vdupq_n_u8(0x7f);
+        const uint8x16_t slash = vdupq_n_u8(escape_solidus ? '/' : '\"');
+        const uint8x16_t control_limit = vdupq_n_u8(0x20);
+        const uint8x16_t high_bit = vdupq_n_u8(escape_non_ascii ? 0x80 : 0);
+        while (last - p >= 16)
+        {
+            const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+            const uint8x16_t special = vorrq_u8(vorrq_u8(vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)),
+                                                         vorrq_u8(vceqq_u8(chunk, del), vceqq_u8(chunk, slash))),
+                                                vorrq_u8(vcltq_u8(chunk, control_limit), vtstq_u8(chunk, high_bit)));
+            // Locate the special byte in this block with the scalar loop below
+            const uint64x2_t halves = vreinterpretq_u64_u8(special);
+            if ((vgetq_lane_u64(halves, 0) | vgetq_lane_u64(halves, 1)) != 0)
+            {
+                break;
+            }
+            p += 16;
+        }
+    }
+#endif
+    while (p < last)
+    {
+        const uint8_t c = static_cast<uint8_t>(*p);
+        if (c == '\"' || c == '\\' || c < 0x20 || c == 0x7f || (escape_solidus && c == '/') || (escape_non_ascii && c >= 0x80))
+        {
+            return p;
+        }
+        ++p;
+    }
+    return p;
+}
+
+// Returns a pointer to the first character in [p,last) that is one of c1, c2, c3 or c4, 
+// or last if there is none. Used by the csv parser to find the end of a field.
+
+template <class CharT>
+const CharT* find_one_of(const CharT* p, const CharT* last, CharT c1, CharT c2, CharT c3, CharT c4)
+{
+    while (p < last)
+    {
+        const CharT c = *p;
+        if (c == c1 || c == c2 || c == c3 || c == c4)
+        {
+            return p;
+        }
+        ++p;
+    }
+    return p;
+}
+
+template <>
+inline
+const char* find_one_of<char>(const char* p, const char* last, char c1, char c2, char c3, char c4)
+{
+#if defined(JSONCONS_HAS_AVX2)
+    {
+        const __m256i v1 = _mm256_set1_epi8(c1);
+        const __m256i v2 = _mm256_set1_epi8(c2);
+        const __m256i v3 = _mm256_set1_epi8(c3);
+        const __m256i v4 = _mm256_set1_epi8(c4);
+        while (last - p >= 32)
+        {
+            const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            const __m256i found = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, v1), _mm256_cmpeq_epi8(chunk, v2)),
+                                                  _mm256_or_si256(_mm256_cmpeq_epi8(chunk, v3), _mm256_cmpeq_epi8(chunk, v4)));
+            const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(found));
+            if (mask != 0)
+            {
+                return p + scan_trailing_zeros(mask);
+            }
+            p += 32;
+        }
+    }
+#endif
+#if defined(JSONCONS_HAS_AVX2) || defined(JSONCONS_HAS_SSE2)
+    {
+        const __m128i v1 = _mm_set1_epi8(c1);
+        const __m128i v2 = _mm_set1_epi8(c2);
+        const __m128i v3 = _mm_set1_epi8(c3);
+        const __m128i v4 = _mm_set1_epi8(c4);
+        while (last - p >= 16)
+        {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            const __m128i found = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, v1), _mm_cmpeq_epi8(chunk, v2)),
+                                               _mm_or_si128(_mm_cmpeq_epi8(chunk, v3), _mm_cmpeq_epi8(chunk, v4)));
+            const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(found));
+            if (mask != 0)
+            {
+                return p + scan_trailing_zeros(mask);
+            }
+            p += 16;
+        }
+    }
+#elif defined(JSONCONS_HAS_NEON)
+    {
+        const uint8x16_t v1 = vdupq_n_u8(static_cast<uint8_t>(c1));
+        const uint8x16_t v2 = vdupq_n_u8(static_cast<uint8_t>(c2));
+        const uint8x16_t v3 = vdupq_n_u8(static_cast<uint8_t>(c3));
+        const uint8x16_t v4 = vdupq_n_u8(static_cast<uint8_t>(c4));
+        while (last - p >= 16)
+        {
+            const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+            const uint8x16_t found = vorrq_u8(vorrq_u8(vceqq_u8(chunk, v1), vceqq_u8(chunk, v2)),
+                                              vorrq_u8(vceqq_u8(chunk, v3), vceqq_u8(chunk, v4)));
+            // Locate the character in this block with the scalar loop below
+            const uint64x2_t halves = vreinterpretq_u64_u8(found);
+            if ((vgetq_lane_u64(halves, 0) | vgetq_lane_u64(halves, 1)) != 0)
+            {
+                break;
+            }
+            p += 16;
+        }
+    }
+#endif
+    while (p < last)
+    {
+        const char c = *p;
+        if (c == c1 || c == c2 || c == c3 || c == c4)
+        {
+            return p;
+        }
+        ++p;
+    }
+    return p;
+}
+
+// Returns a pointer to the first character in [p,last) that is not ASCII, or last if
+// there is none
+
+inline
+const char* skip_ascii(const char* p, const char* last)
+{
+#if defined(JSONCONS_HAS_AVX2)
+    while (last - p >= 32)
+    {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(chunk));
+        if (mask != 0)
+        {
+            return p + scan_trailing_zeros(mask);
+        }
+        p += 32;
+    }
+#endif
+#if defined(JSONCONS_HAS_AVX2) || defined(JSONCONS_HAS_SSE2)
+    while (last - p >= 16)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(chunk));
+        if (mask != 0)
+        {
+            return p + scan_trailing_zeros(mask);
+        }
+        p += 16;
+    }
+#elif defined(JSONCONS_HAS_NEON)
+    const uint8x16_t high_bit = vdupq_n_u8(0x80);
+    while (last - p >= 16)
+    {
+        const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+        const uint64x2_t halves = vreinterpretq_u64_u8(vandq_u8(chunk, high_bit));
+        if ((vgetq_lane_u64(halves, 0) | vgetq_lane_u64(halves, 1)) != 0)
+        {
+            break;
+        }
+        p += 16;
+    }
+#endif
+    while (p < last && static_cast<uint8_t>(*p) < 0x80)
+    {
+        ++p;
+    }
+    return p;
+}
+
+// Checks [p,last) a sequence at a time, skipping runs of ASCII
+
+inline
+bool is_valid_utf8_scalar(const char* p, const char* last)
+{
+    for (p = skip_ascii(p, last); p < last; p = skip_ascii(p, last))
+    {
+        const size_t length = unicons::trailing_bytes_for_utf8[static_cast<uint8_t>(*p)] + 1;
+        if (length > static_cast<size_t>(last - p) || unicons::is_legal_utf8(p, length) != unicons::conv_errc())
+        {
+            return false;
+        }
+        p += length;
+    }
+    return true;
+}
+
+#if defined(JSONCONS_HAS_AVX2) || defined(JSONCONS_HAS_SSSE3) || (defined(JSONCONS_HAS_NEON) && defined(__aarch64__))
+
+// The lookup tables of the Keiser-Lemire validation algorithm ("Validating UTF-8 in less
+// than one instruction per byte", 2021). Each error that two consecutive bytes can show
+// is a bit, and the tables, indexed by the high and low nibbles of the first byte and the
+// high nibble of the second, give the errors each nibble is consistent with. A pair is
+// in error if all three agree on one. A continuation byte where a third or fourth byte
+// is expected cancels the TWO_CONTS bit, and any other combination of bytes that the
+// pairs cannot see is caught as a sequence that is too short or too long.
+
+struct utf8_lookup
+{
+    static const uint8_t too_short = 1 << 0;      // 11______ 0_______ or 11______ 11______
+    static const uint8_t too_long = 1 << 1;       // 0_______ 10______
+    static const uint8_t overlong_3 = 1 << 2;     // 11100000 100_____
+    static const uint8_t too_large = 1 << 3;      // 11110100 1001____, 11110100 101_____, 11110101 and above
+    static const uint8_t surrogate = 1 << 4;      // 11101101 101_____
+    static const uint8_t overlong_2 = 1 << 5;     // 1100000_ 10______
+    static const uint8_t too_large_1000 = 1 << 6; // 11110101 and above, 1000____
+    static const uint8_t overlong_4 = 1 << 6;     // 11110000 1000____
+    static const uint8_t two_conts = 1 << 7;      // 10______ 10______
+    static const uint8_t carry = too_short | too_long | two_conts;
+
+    // byte 1 high nibble, byte 1 low nibble, byte 2 high nibble
+    static const uint8_t* tables()
+    {
+        static const uint8_t t[48] =
+        {
+            too_long, too_long, too_long, too_long,
+            too_long, too_long, too_long, too_long,
+            two_conts, two_conts, two_conts, two_conts,
+            too_short | overlong_2,
+            too_short,
+            too_short | overlong_3 | surrogate,
+            too_short | too_large | too_large_1000 | overlong_4,
+
+            carry | overlong_3 | overlong_2 | overlong_4,
+            carry | overlong_2,
+            carry,
+            carry,
+            carry | too_large,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000 | surrogate,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+
+            too_short, too_short, too_short, too_short,
+            too_short, too_short, too_short, too_short,
+            too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+            too_long | overlong_2 | two_conts | overlong_3 | too_large,
+            too_long | overlong_2 | two_conts | surrogate | too_large,
+            too_long | overlong_2 | two_conts | surrogate | too_large,
+            too_short, too_short, too_short, too_short
+        };
+        return t;
+    }
+
+    // Greater than these in the last three bytes of a block is the start of a sequence
+    // that continues into the next block
+    static const uint8_t* incomplete_limits()
+    {
+        static const uint8_t t[32] =
+        {
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xf0 - 1, 0xe0 - 1, 0xc0 - 1
+        };
+        return t;
+    }
+};
+
+#endif
+
+#if defined(JSONCONS_HAS_AVX2)
+
+class utf8_validator
+{
+    static const size_t block_size = 32;
+
+    __m256i byte_1_high_;
+    __m256i byte_1_low_;
+    __m256i byte_2_high_;
+    __m256i limits_;
+    __m256i error_;
+    __m256i prev_input_;
+    __m256i prev_incomplete_;
+public:
+    utf8_validator()
+    {
+        const uint8_t* t = utf8_lookup::tables();
+        byte_1_high_ = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(t)));
+        byte_1_low_ = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(t + 16)));
+        byte_2_high_ = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(t + 32)));
+        limits_ = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(utf8_lookup::incomplete_limits()));
+        error_ = _mm256_setzero_si256();
+        prev_input_ = _mm256_setzero_si256();
+        prev_incomplete_ = _mm256_setzero_si256();
+    }
+
+    bool validate(const char* p, size_t length)
+    {
+        size_t i = 0;
+        for (; i + block_size <= length; i += block_size)
+        {
+            check(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)));
+        }
+        // The rest, padded with ASCII, so that a sequence it ends inside of is too short
+        char tail[block_size] = {0};
+        std::memcpy(tail, p + i, length - i);
+        check(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(tail)));
+        error_ = _mm256_or_si256(error_, prev_incomplete_);
+        return _mm256_testz_si256(error_, error_) != 0;
+    }
+private:
+    void check(__m256i input)
+    {
+        if (_mm256_movemask_epi8(input) == 0)
+        {
+            error_ = _mm256_or_si256(error_, prev_incomplete_);
+            prev_incomplete_ = _mm256_setzero_si256();
+        }
+        else
+        {
+            const __m256i low_nibble = _mm256_set1_epi8(0x0f);
+            // The previous block's upper half followed by this one's lower half
+            const __m256i shifted = _mm256_permute2x128_si256(prev_input_, input, 0x21);
+            const __m256i prev1 = _mm256_alignr_epi8(input, shifted, 15);
+            const __m256i prev2 = _mm256_alignr_epi8(input, shifted, 14);
+            const __m256i prev3 = _mm256_alignr_epi8(input, shifted, 13);
+
+            const __m256i b1h = _mm256_shuffle_epi8(byte_1_high_, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_nibble));
+            const __m256i b1l = _mm256_shuffle_epi8(byte_1_low_, _mm256_and_si256(prev1, low_nibble));
+            const __m256i b2h = _mm256_shuffle_epi8(byte_2_high_, _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble));
+            const __m256i special_cases = _mm256_and_si256(_mm256_and_si256(b1h, b1l), b2h);
+
+            // Only 111_____ is at least 0x80 after the first subtraction, 1111____ after the second
+            const __m256i third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xe0 - 0x80)));
+            const __m256i fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xf0 - 0x80)));
+            const __m256i must_be_continuation = _mm256_and_si256(_mm256_or_si256(third, fourth),
+                                                                  _mm256_set1_epi8(static_cast<char>(0x80)));
+            error_ = _mm256_or_si256(error_, _mm256_xor_si256(must_be_continuation, special_cases));
+            prev_incomplete_ = _mm256_subs_epu8(input, limits_);
+        }
+        prev_input_ = input;
+    }
+};
+
+#elif defined(JSONCONS_HAS_SSSE3) || (defined(JSONCONS_HAS_NEON) && defined(__aarch64__))
+
+class utf8_validator
+{
+    static const size_t block_size = 16;
+
+#if defined(JSONCONS_HAS_SSSE3)
+    typedef __m128i vector_type;
+#else
+    typedef uint8x16_t vector_type;
+#endif
+
+    vector_type byte_1_high_;
+    vector_type byte_1_low_;
+    vector_type byte_2_high_;
+    vector_type limits_;
+    vector_type error_;
+    vector_type prev_input_;
+    vector_type prev_incomplete_;
+public:
+    utf8_validator()
+    {
+        const uint8_t* t = utf8_lookup::tables();
+        byte_1_high_ = load(t);
+        byte_1_low_ = load(t + 16);
+        byte_2_high_ = load(t + 32);
+        limits_ = load(utf8_lookup::incomplete_limits() + 16);
+        error_ = splat(0);
+        prev_input_ = splat(0);
+        prev_incomplete_ = splat(0);
+    }
+
+    bool validate(const char* p, size_t length)
+    {
+        size_t i = 0;
+        for (; i + block_size <= length; i += block_size)
+        {
+            check(load(reinterpret_cast<const uint8_t*>(p + i)));
+        }
+        // The rest, padded with ASCII, so that a sequence it ends inside of is too short
+        uint8_t tail[block_size] = {0};
+        std::memcpy(tail, p + i, length - i);
+        check(load(tail));
+        error_ = bit_or(error_, prev_incomplete_);
+        return is_zero(error_);
+    }
+private:
+#if defined(JSONCONS_HAS_SSSE3)
+    static vector_type load(const uint8_t* p) {return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));}
+    static vector_type splat(uint8_t c) {return _mm_set1_epi8(static_cast<char>(c));}
+    static vector_type bit_or(vector_type a, vector_type b) {return _mm_or_si128(a, b);}
+    static vector_type bit_and(vector_type a, vector_type b) {return _mm_and_si128(a, b);}
+    static vector_type bit_xor(vector_type a, vector_type b) {return _mm_xor_si128(a, b);}
+    static vector_type subs(vector_type a, vector_type b) {return _mm_subs_epu8(a, b);}
+    static vector_type high_nibbles(vector_type a) {return _mm_and_si128(_mm_srli_epi16(a, 4), _mm_set1_epi8(0x0f));}
+    static vector_type lookup(vector_type table, vector_type index) {return _mm_shuffle_epi8(table, index);}
+    static bool is_ascii(vector_type a) {return _mm_movemask_epi8(a) == 0;}
+    static bool is_zero(vector_type a) {return _mm_movemask_epi8(_mm_cmpeq_epi8(a, _mm_setzero_si128())) == 0xffff;}
+    template <int N>
+    static vector_type prev(vector_type input, vector_type prev_input) {return _mm_alignr_epi8(input, prev_input, 16 - N);}
+#else
+    static vector_type load(const uint8_t* p) {return vld1q_u8(p);}
+    static vector_type splat(uint8_t c) {return vdupq_n_u8(c);}
+    static vector_type bit_or(vector_type a, vector_type b) {return vorrq_u8(a, b);}
+    static vector_type bit_and(vector_type a, vector_type b) {return vandq_u8(a, b);}
+    static vector_type bit_xor(vector_type a, vector_type b) {return veorq_u8(a, b);}
+    static vector_type subs(vector_type a, vector_type b) {return vqsubq_u8(a, b);}
+    static vector_type high_nibbles(vector_type a) {return vshrq_n_u8(a, 4);}
+    static vector_type lookup(vector_type table, vector_type index) {return vqtbl1q_u8(table, index);}
+    static bool is_ascii(vector_type a) {return vmaxvq_u8(a) < 0x80;}
+    static bool is_zero(vector_type a) {return vmaxvq_u8(a) == 0;}
+    template <int N>
+    static vector_type prev(vector_type input, vector_type prev_input) {return vextq_u8(prev_input, input, 16 - N);}
+#endif
+
+    void check(vector_type input)
+    {
+        if (is_ascii(input))
+        {
+            error_ = bit_or(error_, prev_incomplete_);
+            prev_incomplete_ = splat(0);
+        }
+        else
+        {
+            const vector_type prev1 = prev<1>(input, prev_input_);
+            const vector_type b1h = lookup(byte_1_high_, high_nibbles(prev1));
+            const vector_type b1l = lookup(byte_1_low_, bit_and(prev1, splat(0x0f)));
+            const vector_type b2h = lookup(byte_2_high_, high_nibbles(input));
+            const vector_type special_cases = bit_and(bit_and(b1h, b1l), b2h);
+
+            // Only 111_____ is at least 0x80 after the first subtraction, 1111____ after the second
+            const vector_type third = subs(prev<2>(input, prev_input_), splat(0xe0 - 0x80));
+            const vector_type fourth = subs(prev<3>(input, prev_input_), splat(0xf0 - 0x80));
+            const vector_type must_be_continuation = bit_and(bit_or(third, fourth), splat(0x80));
+            error_ = bit_or(error_, bit_xor(must_be_continuation, special_cases));
+            prev_incomplete_ = subs(input, limits_);
+        }
+        prev_input_ = input;
+    }
+};
+
+#endif
+
+// Returns true if [p,p+length) is well formed UTF-8: no bytes that cannot occur,
+// overlong encodings, surrogates, code points above U+10FFFF, or sequences that are cut
+// short. It accepts exactly what unicons::validate does, but checks a whole buffer at
+// once, 16 or 32 bytes at a time with the Keiser-Lemire algorithm where SSSE3, AVX2 or
+// AArch64 NEON is available, otherwise skipping ASCII a vector at a time and checking
+// the rest a sequence at a time. It does not say where the error is, for that
+// unicons::validate should be used.
+
+inline
+bool is_valid_utf8(const char* p, size_t length)
+{
+#if defined(JSONCONS_HAS_AVX2) || defined(JSONCONS_HAS_SSSE3) || (defined(JSONCONS_HAS_NEON) && defined(__aarch64__))
+    const char* last = p + length;
+    // Text that starts with a long run of ASCII is common enough to skip straight to the rest
+    const char* q = skip_ascii(p, last);
+    if (q == last)
+    {
+        return true;
+    }
+    utf8_validator validator;
+    return validator.validate(q, static_cast<size_t>(last - q));
+#else
+    return is_valid_utf8_scalar(p, p + length);
+#endif
+}
+
+}}
+
+#endif
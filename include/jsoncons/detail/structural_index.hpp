@@ -0,0 +1,232 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_DETAIL_STRUCTURALINDEX_HPP
+#define JSONCONS_DETAIL_STRUCTURALINDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <limits>
+#include <jsoncons/detail/jsoncons_config.hpp>
+#include <jsoncons/detail/string_scan.hpp>
+
+namespace jsoncons { namespace detail {
+
+// Stage one of the indexed parsing mode. Classifies a text held in memory 64 bytes
+// at a time and records the offsets of the structural characters {}[]:, outside
+// strings, of the opening quotation mark of each string, and of the first character
+// of each other token (numbers, true, false, null and anything invalid).
+
+struct structural_block_masks
+{
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t op;
+    uint64_t whitespace;
+    uint64_t slash;
+};
+
+inline
+void classify_block_scalar(const char* block, structural_block_masks& masks)
+{
+    masks.quote = masks.backslash = masks.op = masks.whitespace = masks.slash = 0;
+    for (unsigned i = 0; i < 64; ++i)
+    {
+        const uint64_t bit = uint64_t(1) << i;
+        switch (block[i])
+        {
+            case '\"':
+                masks.quote |= bit;
+                break;
+            case '\\':
+                masks.backslash |= bit;
+                break;
+            case '{': case '}': case '[': case ']': case ':': case ',':
+                masks.op |= bit;
+                break;
+            case ' ': case '\t': case '\n': case '\r':
+                masks.whitespace |= bit;
+                break;
+            case '/':
+                masks.slash |= bit;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+#if defined(JSONCONS_HAS_AVX2) || defined(JSONCONS_HAS_SSE2)
+
+inline
+void classify_block(const char* block, structural_block_masks& masks)
+{
+    masks.quote = masks.backslash = masks.op = masks.whitespace = masks.slash = 0;
+
+    const __m128i quote = _mm_set1_epi8('\"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i lower_case_bit = _mm_set1_epi8(0x20);
+    const __m128i left_brace = _mm_set1_epi8('{');
+    const __m128i right_brace = _mm_set1_epi8('}');
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i slash = _mm_set1_epi8('/');
+
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16*i));
+        // '[' and ']' differ from '{' and '}' only in bit 0x20
+        const __m128i folded = _mm_or_si128(chunk, lower_case_bit);
+        const __m128i op = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(folded, left_brace), _mm_cmpeq_epi8(folded, right_brace)),
+                                        _mm_or_si128(_mm_cmpeq_epi8(chunk, colon), _mm_cmpeq_epi8(chunk, comma)));
+        const __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+                                        _mm_or_si128(_mm_cmpeq_epi8(chunk, lf), _mm_cmpeq_epi8(chunk, cr)));
+        const unsigned shift = 16*i;
+        masks.quote |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)))) << shift;
+        masks.backslash |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, backslash)))) << shift;
+        masks.op |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(op))) << shift;
+        masks.whitespace |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(ws))) << shift;
+        masks.slash |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, slash)))) << shift;
+    }
+}
+
+#else
+
+inline
+void classify_block(const char* block, structural_block_masks& masks)
+{
+    classify_block_scalar(block, masks);
+}
+
+#endif
+
+inline
+uint64_t prefix_xor(uint64_t x)
+{
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+inline
+unsigned trailing_zeros64(uint64_t x)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+#if defined(_M_X64) || defined(_M_ARM64)
+    _BitScanForward64(&index, x);
+    return static_cast<unsigned>(index);
+#else
+    if (static_cast<uint32_t>(x) != 0)
+    {
+        _BitScanForward(&index, static_cast<uint32_t>(x));
+        return static_cast<unsigned>(index);
+    }
+    _BitScanForward(&index, static_cast<uint32_t>(x >> 32));
+    return static_cast<unsigned>(index) + 32;
+#endif
+#else
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
+}
+
+// Returns false if the text cannot be indexed, because it contains a comment or an
+// unterminated string, or is too long for 32 bit offsets. The caller should then
+// use the character by character parser, which reports these cases.
+
+inline
+bool build_structural_index(const char* data, size_t length, std::vector<uint32_t>& positions)
+{
+    positions.clear();
+    if (length >= (std::numeric_limits<uint32_t>::max)())
+    {
+        return false;
+    }
+
+    uint64_t prev_escaped = 0;     // 1 if the first character of the block is escaped
+    uint64_t prev_in_string = 0;   // all ones if the block starts inside a string
+    uint64_t prev_separator = 1;   // 1 if the character before the block ends a token
+
+    structural_block_masks masks;
+    char last_block[64];
+
+    for (size_t offset = 0; offset < length; offset += 64)
+    {
+        const char* block = data + offset;
+        if (length - offset < 64)
+        {
+            std::memset(last_block, ' ', sizeof(last_block));
+            std::memcpy(last_block, block, length - offset);
+            block = last_block;
+        }
+        classify_block(block, masks);
+
+        // Characters escaped by a backslash. Backslashes are rare, so visit them one by one.
+        uint64_t escaped = prev_escaped;
+        prev_escaped = 0;
+        uint64_t backslash = masks.backslash & ~escaped;
+        while (backslash != 0)
+        {
+            const unsigned i = trailing_zeros64(backslash);
+            if (i == 63)
+            {
+                prev_escaped = 1;
+                backslash = 0;
+            }
+            else
+            {
+                const uint64_t next = uint64_t(1) << (i + 1);
+                escaped |= next;
+                backslash &= ~(next | (next >> 1));
+            }
+        }
+
+        const uint64_t quote = masks.quote & ~escaped;
+        // Set from an opening quotation mark up to but excluding its closing quotation mark
+        const uint64_t in_string = prefix_xor(quote) ^ prev_in_string;
+        prev_in_string = uint64_t(0) - (in_string >> 63);
+
+        if ((masks.slash & ~in_string) != 0)
+        {
+            return false;
+        }
+
+        const uint64_t op = masks.op & ~in_string;
+        const uint64_t opening_quote = quote & in_string;
+        const uint64_t closing_quote = quote & ~in_string;
+        const uint64_t separator = op | (masks.whitespace & ~in_string) | closing_quote;
+        const uint64_t token_start = ~(separator | in_string) & ((separator << 1) | prev_separator);
+        prev_separator = separator >> 63;
+
+        uint64_t bits = op | opening_quote | token_start;
+        while (bits != 0)
+        {
+            const size_t pos = offset + trailing_zeros64(bits);
+            if (pos >= length)
+            {
+                break;
+            }
+            positions.push_back(static_cast<uint32_t>(pos));
+            bits &= bits - 1;
+        }
+    }
+
+    return prev_in_string == 0;
+}
+
+}}
+
+#endif
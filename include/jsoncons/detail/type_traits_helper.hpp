@@ -28,6 +28,9 @@
 #include <initializer_list>
 #include <jsoncons/detail/jsoncons_config.hpp>
 #include <jsoncons/detail/osequencestream.hpp>
+#include <jsoncons/output_sink.hpp>
+#include <jsoncons/detail/grisu2.hpp>
+#include <jsoncons/detail/decimal_to_double.hpp>
 
 #if defined(JSONCONS_HAS_STRING_VIEW)
 #include <string_view>
@@ -723,17 +726,104 @@ bool operator>(const std::basic_string<CharT,Traits,Allocator>& lhs,
 }
 #endif
 
+// format_uinteger
+
+namespace detail {
+
+inline
+const char* digit_pairs()
+{
+    return "00010203040506070809"
+           "10111213141516171819"
+           "20212223242526272829"
+           "30313233343536373839"
+           "40414243444546474849"
+           "50515253545556575859"
+           "60616263646566676869"
+           "70717273747576777879"
+           "80818283848586878889"
+           "90919293949596979899";
+}
+
+}
+
+// The most characters format_integer writes
+static const size_t max_integer_chars = 20;
+
+// The number of decimal digits of value
+inline
+size_t count_digits(uint64_t value)
+{
+    size_t n = 1;
+    for (;;)
+    {
+        if (value < 10) return n;
+        if (value < 100) return n + 1;
+        if (value < 1000) return n + 2;
+        if (value < 10000) return n + 3;
+        value /= 10000;
+        n += 4;
+    }
+}
+
+// Writes the decimal digits of value into the characters that end at last, two at a time,
+// and returns the position of the first.
+
+template <class CharT>
+CharT* format_uinteger(uint64_t value, CharT* last)
+{
+    const char* pairs = detail::digit_pairs();
+    CharT* p = last;
+    while (value >= 100)
+    {
+        const size_t i = static_cast<size_t>(value % 100)*2;
+        value /= 100;
+        *--p = static_cast<CharT>(pairs[i + 1]);
+        *--p = static_cast<CharT>(pairs[i]);
+    }
+    if (value >= 10)
+    {
+        const size_t i = static_cast<size_t>(value)*2;
+        *--p = static_cast<CharT>(pairs[i + 1]);
+        *--p = static_cast<CharT>(pairs[i]);
+    }
+    else
+    {
+        *--p = static_cast<CharT>('0' + value);
+    }
+    return p;
+}
+
+template <class CharT>
+CharT* format_integer(int64_t value, CharT* last)
+{
+    // Negate in unsigned arithmetic, so that the most negative value doesn't overflow
+    const uint64_t u = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    CharT* p = format_uinteger(u, last);
+    if (value < 0)
+    {
+        *--p = '-';
+    }
+    return p;
+}
+
+// Collects output in a buffer, and writes the buffer to a stream or an output sink
+// when it is full, when flush is called, and when it is destroyed.
+
 template <class CharT>
 class buffered_output
 {
     static const size_t default_buffer_length = 16384;
 
-    std::basic_ostream<CharT>& os_;
+    std::basic_ostream<CharT>* os_;
+    basic_output_sink<CharT>* sink_;
     std::vector<CharT> buffer_;
-    CharT * const begin_buffer_;
-    const CharT* const end_buffer_;
+    CharT* begin_buffer_;
+    const CharT* end_buffer_;
     CharT* p_;
-
+    // Characters passed on, and how many writes passed them on
+    size_t written_;
+    size_t write_count_;
 
     // Noncopyable and nonmoveable
     buffered_output(const buffered_output&) = delete;
@@ -741,24 +831,37 @@ class buffered_output
 
 public:
     buffered_output(std::basic_ostream<CharT>& os)
-        : os_(os), buffer_(default_buffer_length), begin_buffer_(buffer_.data()), end_buffer_(buffer_.data()+default_buffer_length), p_(buffer_.data())
+        : os_(std::addressof(os)), sink_(nullptr), buffer_(default_buffer_length), begin_buffer_(buffer_.data()), end_buffer_(buffer_.data()+default_buffer_length), p_(buffer_.data()), written_(0), write_count_(0)
     {
     }
     buffered_output(std::basic_ostream<CharT>& os, size_t buflen)
-        : os_(os), buffer_(buflen), begin_buffer_(buffer_.data()), end_buffer_(buffer_.data()+buflen), p_(buffer_.data())
+        : os_(std::addressof(os)), sink_(nullptr), buffer_(buflen), begin_buffer_(buffer_.data()), end_buffer_(buffer_.data()+buflen), p_(buffer_.data()), written_(0), write_count_(0)
+    {
+    }
+    buffered_output(basic_output_sink<CharT>& sink)
+        : os_(nullptr), sink_(std::addressof(sink)), buffer_(default_buffer_length), begin_buffer_(buffer_.data()), end_buffer_(buffer_.data()+default_buffer_length), p_(buffer_.data()), written_(0), write_count_(0)
+    {
+    }
+    buffered_output(basic_output_sink<CharT>& sink, size_t buflen)
+        : os_(nullptr), sink_(std::addressof(sink)), buffer_(buflen), begin_buffer_(buffer_.data()), end_buffer_(buffer_.data()+buflen), p_(buffer_.data()), written_(0), write_count_(0)
     {
     }
     ~buffered_output()
     {
-        os_.write(begin_buffer_, (p_ - begin_buffer_));
-        os_.flush();
+        flush();
     }
 
     void flush()
     {
-        os_.write(begin_buffer_, (p_ - begin_buffer_));
-        p_ = begin_buffer_;
-        os_.flush();
+        write_buffer();
+        if (sink_ != nullptr)
+        {
+            sink_->flush();
+        }
+        else
+        {
+            os_->flush();
+        }
     }
 
     void write(const CharT* s, size_t length)
@@ -769,14 +872,35 @@ public:
             std::memcpy(p_, s, length*sizeof(CharT));
             p_ += length;
         }
+        else if (sink_ != nullptr)
+        {
+            written_ += (p_ - begin_buffer_) + length;
+            ++write_count_;
+            sink_->write(begin_buffer_, (p_ - begin_buffer_), s, length);
+            p_ = begin_buffer_;
+        }
         else
         {
-            os_.write(begin_buffer_, (p_ - begin_buffer_));
-            os_.write(s, length);
+            written_ += (p_ - begin_buffer_) + length;
+            ++write_count_;
+            os_->write(begin_buffer_, (p_ - begin_buffer_));
+            os_->write(s, length);
             p_ = begin_buffer_;
         }
     }
 
+    // The number of characters output so far, including those still in the buffer
+    size_t count() const
+    {
+        return written_ + (p_ - begin_buffer_);
+    }
+
+    // The number of times the buffer has been passed on to the stream or sink
+    size_t write_count() const
+    {
+        return write_count_;
+    }
+
     void write(const std::basic_string<CharT>& s)
     {
         write(s.data(),s.length());
@@ -790,14 +914,167 @@ public:
         }
         else
         {
-            os_.write(begin_buffer_, (p_-begin_buffer_));
-            p_ = begin_buffer_;
+            write_buffer();
             *p_++ = ch;
         }
     }
 
+    // Returns a pointer to room for at least n characters, writing out the buffer first
+    // if it doesn't have that much left. Characters stored there are part of the output
+    // once commit is called with the end of them, and no other member function may be
+    // called in between.
+    CharT* reserve(size_t n)
+    {
+        if (static_cast<size_t>(end_buffer_ - p_) < n)
+        {
+            write_buffer();
+            if (buffer_.size() < n)
+            {
+                buffer_.resize(n);
+                begin_buffer_ = buffer_.data();
+                end_buffer_ = buffer_.data() + n;
+                p_ = begin_buffer_;
+            }
+        }
+        return p_;
+    }
+
+    void commit(CharT* end)
+    {
+        p_ = end;
+    }
+private:
+    void write_buffer()
+    {
+        if (p_ != begin_buffer_)
+        {
+            written_ += p_ - begin_buffer_;
+            ++write_count_;
+        }
+        if (sink_ != nullptr)
+        {
+            sink_->write(begin_buffer_, (p_ - begin_buffer_));
+        }
+        else
+        {
+            os_->write(begin_buffer_, (p_ - begin_buffer_));
+        }
+        p_ = begin_buffer_;
+    }
 };
 
+// print_shortest_double
+
+// Writes the shortest digits that read back as val, in the notation print_double uses
+// for precision digits. At the default precision, digits10, that is the whole output.
+// For other precisions it returns false without writing anything, leaving the caller
+// to round, unless precision is less than digits10 and val has at most precision
+// significant digits. The output is then the same as rounding to precision digits,
+// as no other decimal of that length is within half a unit in the last place of val.
+
+template <class CharT>
+bool print_shortest_double(double val, uint8_t precision, buffered_output<CharT>& os)
+{
+    if (val == 0)
+    {
+        if (std::signbit(val))
+        {
+            os.put('-');
+        }
+        os.put('0');
+        os.put('.');
+        os.put('0');
+        return true;
+    }
+
+    char digits[24];
+    int decimal_exponent;
+    const int length = detail::grisu2(std::fabs(val), digits, decimal_exponent);
+    if (precision != std::numeric_limits<double>::digits10 &&
+        (length > precision || precision > std::numeric_limits<double>::digits10))
+    {
+        return false;
+    }
+
+    if (val < 0)
+    {
+        os.put('-');
+    }
+
+    // Exponent of the first digit, the notation is %g's
+    const int x = length + decimal_exponent - 1;
+    if (x < -4 || x >= precision)
+    {
+        os.put(digits[0]);
+        os.put('.');
+        if (length == 1)
+        {
+            os.put('0');
+        }
+        for (int i = 1; i < length; ++i)
+        {
+            os.put(digits[i]);
+        }
+        os.put('e');
+        int e = x;
+        if (e < 0)
+        {
+            os.put('-');
+            e = -e;
+        }
+        else
+        {
+            os.put('+');
+        }
+        if (e >= 100)
+        {
+            os.put(static_cast<CharT>('0' + e / 100));
+            e %= 100;
+        }
+        os.put(static_cast<CharT>('0' + e / 10));
+        os.put(static_cast<CharT>('0' + e % 10));
+    }
+    else if (x < 0)
+    {
+        os.put('0');
+        os.put('.');
+        for (int i = x + 1; i < 0; ++i)
+        {
+            os.put('0');
+        }
+        for (int i = 0; i < length; ++i)
+        {
+            os.put(digits[i]);
+        }
+    }
+    else if (length <= x + 1)
+    {
+        for (int i = 0; i < length; ++i)
+        {
+            os.put(digits[i]);
+        }
+        for (int i = length; i <= x; ++i)
+        {
+            os.put('0');
+        }
+        os.put('.');
+        os.put('0');
+    }
+    else
+    {
+        for (int i = 0; i <= x; ++i)
+        {
+            os.put(digits[i]);
+        }
+        os.put('.');
+        for (int i = x + 1; i < length; ++i)
+        {
+            os.put(digits[i]);
+        }
+    }
+    return true;
+}
+
 // print_double
 
 #ifdef JSONCONS_HAS__ECVT_S
@@ -814,6 +1091,11 @@ public:
 
     void operator()(double val, uint8_t precision, buffered_output<CharT>& os) 
     {
+        if (precision_ == 0 && print_shortest_double(val, precision, os))
+        {
+            return;
+        }
+
         char buf[_CVTBUFSIZE];
         int decimal_point = 0;
         int sign = 0;
@@ -925,6 +1207,11 @@ public:
     }
     void operator()(double val, uint8_t precision, buffered_output<CharT>& os)
     {
+        if (precision_ == 0 && print_shortest_double(val, precision, os))
+        {
+            return;
+        }
+
         oss_.clear_sequence();
         oss_.precision((precision_ == 0) ? precision : precision_);
         oss_ << val;
@@ -938,7 +1225,7 @@ public:
         if (sbeg != send)
         {
             bool dot = false;
-            for (pexp = sbeg; *pexp != 'e' && *pexp != 'E' && pexp < send; ++pexp)
+            for (pexp = sbeg; pexp < send && *pexp != 'e' && *pexp != 'E'; ++pexp)
             {
             }
 
@@ -975,7 +1262,7 @@ public:
                 {
                     --p;
                 }
-                const CharT* qend = *(p-2) == '.' ? p : send;
+                const CharT* qend = (p >= sbeg+2 && *(p-2) == '.') ? p : send;
                 for (const CharT* q = sbeg; q < qend; ++q)
                 {
                     if (*q == '.')
@@ -1012,11 +1299,16 @@ public:
         _free_locale(locale_);
     }
 
-    double operator()(const char* s, size_t)
+    double operator()(const char* s, size_t length)
     {
+        double val;
+        if (detail::try_decimal_to_double(s, length, val))
+        {
+            return val;
+        }
         const char *begin = s;
         char *end = nullptr;
-        double val = _strtod_l(begin, &end, locale_);
+        val = _strtod_l(begin, &end, locale_);
         if (begin == end)
         {
             throw std::invalid_argument("Invalid float value");
@@ -1047,9 +1339,14 @@ public:
 
     double operator()(const char* s, size_t length)
     {
+        double val;
+        if (detail::try_decimal_to_double(s, length, val))
+        {
+            return val;
+        }
         const char *begin = s;
         char *end = nullptr;
-        double val = strtold_l(begin, &end, locale_);
+        val = strtod_l(begin, &end, locale_);
         if (begin == end)
         {
             throw std::invalid_argument("Invalid float value");
@@ -1090,6 +1387,10 @@ public:
     double operator()(const char* s, size_t length)
     {
         double val;
+        if (detail::try_decimal_to_double(s, length, val))
+        {
+            return val;
+        }
         if (is_dot_)
         {
             const char *begin = s;
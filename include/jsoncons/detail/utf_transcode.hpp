@@ -0,0 +1,400 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_DETAIL_UTF_TRANSCODE_HPP
+#define JSONCONS_DETAIL_UTF_TRANSCODE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <jsoncons/detail/unicode_traits.hpp>
+#include <jsoncons/detail/string_scan.hpp>
+
+namespace jsoncons { namespace detail {
+
+// Transcoding between UTF-8 and the UTF-16 or UTF-32 of a wide character type, chosen by
+// the size of the type, for wjson text read from or written to UTF-8. Runs of ASCII are
+// converted sixteen characters at a time where SIMD is available, and other characters
+// one sequence, or one surrogate pair, at a time, without the iterator and flag
+// machinery of unicons::convert.
+
+template <class CharT>
+struct transcode_result
+{
+    // Where the conversion stopped, last unless ec is set
+    const CharT* it;
+    // The number of characters written
+    size_t length;
+    unicons::conv_errc ec;
+};
+
+namespace utf_transcode_impl {
+
+typedef std::integral_constant<size_t,2> utf16_tag;
+typedef std::integral_constant<size_t,4> utf32_tag;
+
+#if defined(JSONCONS_HAS_AVX2) || defined(JSONCONS_HAS_SSE2)
+
+// Widens 16 ASCII characters at p to out, if they are all ASCII
+template <class WCharT>
+bool widen_ascii_block(const char* p, WCharT* out, utf16_tag)
+{
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    if (_mm_movemask_epi8(chunk) != 0)
+    {
+        return false;
+    }
+    const __m128i zero = _mm_setzero_si128();
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(chunk, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpackhi_epi8(chunk, zero));
+    return true;
+}
+
+template <class WCharT>
+bool widen_ascii_block(const char* p, WCharT* out, utf32_tag)
+{
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    if (_mm_movemask_epi8(chunk) != 0)
+    {
+        return false;
+    }
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo = _mm_unpacklo_epi8(chunk, zero);
+    const __m128i hi = _mm_unpackhi_epi8(chunk, zero);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi16(lo, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_unpackhi_epi16(lo, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpacklo_epi16(hi, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12), _mm_unpackhi_epi16(hi, zero));
+    return true;
+}
+
+// Narrows 16 characters at p to out, if they are all ASCII
+template <class WCharT>
+bool narrow_ascii_block(const WCharT* p, char* out, utf16_tag)
+{
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 8));
+    const __m128i high = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16(static_cast<short>(0xFF80)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128())) != 0xFFFF)
+    {
+        return false;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(a, b));
+    return true;
+}
+
+template <class WCharT>
+bool narrow_ascii_block(const WCharT* p, char* out, utf32_tag)
+{
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 4));
+    const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 8));
+    const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 12));
+    const __m128i any = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+    const __m128i high = _mm_and_si128(any, _mm_set1_epi32(static_cast<int>(0xFFFFFF80)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, _mm_setzero_si128())) != 0xFFFF)
+    {
+        return false;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+    return true;
+}
+
+#elif defined(JSONCONS_HAS_NEON)
+
+template <class WCharT>
+bool widen_ascii_block(const char* p, WCharT* out, utf16_tag)
+{
+    const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+    if (vmaxvq_u8(chunk) >= 0x80)
+    {
+        return false;
+    }
+    vst1q_u16(reinterpret_cast<uint16_t*>(out), vmovl_u8(vget_low_u8(chunk)));
+    vst1q_u16(reinterpret_cast<uint16_t*>(out + 8), vmovl_u8(vget_high_u8(chunk)));
+    return true;
+}
+
+template <class WCharT>
+bool widen_ascii_block(const char* p, WCharT* out, utf32_tag)
+{
+    const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+    if (vmaxvq_u8(chunk) >= 0x80)
+    {
+        return false;
+    }
+    const uint16x8_t lo = vmovl_u8(vget_low_u8(chunk));
+    const uint16x8_t hi = vmovl_u8(vget_high_u8(chunk));
+    vst1q_u32(reinterpret_cast<uint32_t*>(out), vmovl_u16(vget_low_u16(lo)));
+    vst1q_u32(reinterpret_cast<uint32_t*>(out + 4), vmovl_u16(vget_high_u16(lo)));
+    vst1q_u32(reinterpret_cast<uint32_t*>(out + 8), vmovl_u16(vget_low_u16(hi)));
+    vst1q_u32(reinterpret_cast<uint32_t*>(out + 12), vmovl_u16(vget_high_u16(hi)));
+    return true;
+}
+
+template <class WCharT>
+bool narrow_ascii_block(const WCharT* p, char* out, utf16_tag)
+{
+    const uint16x8_t a = vld1q_u16(reinterpret_cast<const uint16_t*>(p));
+    const uint16x8_t b = vld1q_u16(reinterpret_cast<const uint16_t*>(p + 8));
+    if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80)
+    {
+        return false;
+    }
+    vst1q_u8(reinterpret_cast<uint8_t*>(out), vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+    return true;
+}
+
+template <class WCharT>
+bool narrow_ascii_block(const WCharT* p, char* out, utf32_tag)
+{
+    const uint32x4_t a = vld1q_u32(reinterpret_cast<const uint32_t*>(p));
+    const uint32x4_t b = vld1q_u32(reinterpret_cast<const uint32_t*>(p + 4));
+    const uint32x4_t c = vld1q_u32(reinterpret_cast<const uint32_t*>(p + 8));
+    const uint32x4_t d = vld1q_u32(reinterpret_cast<const uint32_t*>(p + 12));
+    if (vmaxvq_u32(vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d))) >= 0x80)
+    {
+        return false;
+    }
+    const uint16x8_t ab = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+    const uint16x8_t cd = vcombine_u16(vmovn_u32(c), vmovn_u32(d));
+    vst1q_u8(reinterpret_cast<uint8_t*>(out), vcombine_u8(vmovn_u16(ab), vmovn_u16(cd)));
+    return true;
+}
+
+#else
+
+template <class WCharT, class Tag>
+bool widen_ascii_block(const char* p, WCharT* out, Tag)
+{
+    for (size_t i = 0; i < 16; ++i)
+    {
+        if (static_cast<uint8_t>(p[i]) >= 0x80)
+        {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < 16; ++i)
+    {
+        out[i] = static_cast<WCharT>(p[i]);
+    }
+    return true;
+}
+
+template <class WCharT, class Tag>
+bool narrow_ascii_block(const WCharT* p, char* out, Tag)
+{
+    uint32_t any = 0;
+    for (size_t i = 0; i < 16; ++i)
+    {
+        any |= static_cast<uint32_t>(p[i]);
+    }
+    if (any >= 0x80)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < 16; ++i)
+    {
+        out[i] = static_cast<char>(p[i]);
+    }
+    return true;
+}
+
+#endif
+
+template <class WCharT>
+void write_code_point(uint32_t cp, WCharT*& out, utf16_tag)
+{
+    if (cp <= unicons::max_bmp)
+    {
+        *out++ = static_cast<WCharT>(cp);
+    }
+    else
+    {
+        cp -= unicons::half_base;
+        *out++ = static_cast<WCharT>((cp >> unicons::half_shift) + unicons::sur_high_start);
+        *out++ = static_cast<WCharT>((cp & unicons::half_mask) + unicons::sur_low_start);
+    }
+}
+
+template <class WCharT>
+void write_code_point(uint32_t cp, WCharT*& out, utf32_tag)
+{
+    *out++ = static_cast<WCharT>(cp);
+}
+
+// Reads the code point at p, which is not ASCII, into cp, and advances p past it
+template <class WCharT>
+unicons::conv_errc read_code_point(const WCharT*& p, const WCharT* last, uint32_t& cp, utf16_tag)
+{
+    cp = static_cast<uint16_t>(*p);
+    if (unicons::is_high_surrogate(cp))
+    {
+        if (last - p < 2)
+        {
+            return unicons::conv_errc::source_exhausted;
+        }
+        const uint32_t low = static_cast<uint16_t>(p[1]);
+        if (!unicons::is_low_surrogate(low))
+        {
+            return unicons::conv_errc::unpaired_high_surrogate;
+        }
+        cp = ((cp - unicons::sur_high_start) << unicons::half_shift) + (low - unicons::sur_low_start) + unicons::half_base;
+        p += 2;
+        return unicons::conv_errc();
+    }
+    if (unicons::is_low_surrogate(cp))
+    {
+        return unicons::conv_errc::source_illegal;
+    }
+    ++p;
+    return unicons::conv_errc();
+}
+
+template <class WCharT>
+unicons::conv_errc read_code_point(const WCharT*& p, const WCharT*, uint32_t& cp, utf32_tag)
+{
+    cp = static_cast<uint32_t>(*p);
+    if (unicons::is_surrogate(cp))
+    {
+        return unicons::conv_errc::illegal_surrogate_value;
+    }
+    if (cp > unicons::max_legal_utf32)
+    {
+        return unicons::conv_errc::source_illegal;
+    }
+    ++p;
+    return unicons::conv_errc();
+}
+
+}
+
+// The most characters that n bytes of UTF-8 become, and the most bytes of UTF-8 that n
+// wide characters become
+template <class WCharT>
+size_t max_wide_length(size_t n)
+{
+    return n;
+}
+
+template <class WCharT>
+size_t max_utf8_length(size_t n)
+{
+    return sizeof(WCharT) == 2 ? 3 * n : 4 * n;
+}
+
+// Converts the UTF-8 in [first,last) to out, which has room for max_wide_length(last - first)
+// characters. Stops at the first sequence that is not valid UTF-8, or, with
+// conv_errc::source_exhausted, at a sequence that last cuts short.
+template <class WCharT>
+transcode_result<char> utf8_to_wide(const char* first, const char* last, WCharT* out)
+{
+    static_assert(sizeof(WCharT) == 2 || sizeof(WCharT) == 4, "UTF-16 or UTF-32 characters");
+    typedef std::integral_constant<size_t,sizeof(WCharT)> tag;
+
+    WCharT* const out_first = out;
+    const char* p = first;
+    while (p < last)
+    {
+        while (last - p >= 16 && utf_transcode_impl::widen_ascii_block(p, out, tag()))
+        {
+            p += 16;
+            out += 16;
+        }
+        if (p == last)
+        {
+            break;
+        }
+        const uint8_t c = static_cast<uint8_t>(*p);
+        if (c < 0x80)
+        {
+            *out++ = static_cast<WCharT>(c);
+            ++p;
+            continue;
+        }
+        const size_t extra = unicons::trailing_bytes_for_utf8[c];
+        if (extra >= static_cast<size_t>(last - p))
+        {
+            return transcode_result<char>{p, static_cast<size_t>(out - out_first), unicons::conv_errc::source_exhausted};
+        }
+        unicons::conv_errc ec = unicons::is_legal_utf8(p, extra + 1);
+        if (ec != unicons::conv_errc())
+        {
+            return transcode_result<char>{p, static_cast<size_t>(out - out_first), ec};
+        }
+        uint32_t cp = 0;
+        switch (extra)
+        {
+            case 3: cp += static_cast<uint8_t>(*p++); cp <<= 6;
+            case 2: cp += static_cast<uint8_t>(*p++); cp <<= 6;
+            case 1: cp += static_cast<uint8_t>(*p++); cp <<= 6;
+            default: cp += static_cast<uint8_t>(*p++);
+        }
+        cp -= unicons::offsets_from_utf8[extra];
+        utf_transcode_impl::write_code_point(cp, out, tag());
+    }
+    return transcode_result<char>{p, static_cast<size_t>(out - out_first), unicons::conv_errc()};
+}
+
+// Converts the wide characters in [first,last) to UTF-8 in out, which has room for
+// max_utf8_length(last - first) bytes. Stops at the first character that is not valid,
+// or, with conv_errc::source_exhausted, at a high surrogate that ends the input.
+template <class WCharT>
+transcode_result<WCharT> wide_to_utf8(const WCharT* first, const WCharT* last, char* out)
+{
+    static_assert(sizeof(WCharT) == 2 || sizeof(WCharT) == 4, "UTF-16 or UTF-32 characters");
+    typedef std::integral_constant<size_t,sizeof(WCharT)> tag;
+
+    char* const out_first = out;
+    const WCharT* p = first;
+    while (p < last)
+    {
+        while (last - p >= 16 && utf_transcode_impl::narrow_ascii_block(p, out, tag()))
+        {
+            p += 16;
+            out += 16;
+        }
+        if (p == last)
+        {
+            break;
+        }
+        uint32_t cp = static_cast<uint32_t>(*p);
+        if (cp < 0x80)
+        {
+            *out++ = static_cast<char>(cp);
+            ++p;
+            continue;
+        }
+        unicons::conv_errc ec = utf_transcode_impl::read_code_point(p, last, cp, tag());
+        if (ec != unicons::conv_errc())
+        {
+            return transcode_result<WCharT>{p, static_cast<size_t>(out - out_first), ec};
+        }
+        if (cp < 0x800)
+        {
+            *out++ = static_cast<char>(0xC0 | (cp >> 6));
+            *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else if (cp < 0x10000)
+        {
+            *out++ = static_cast<char>(0xE0 | (cp >> 12));
+            *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else
+        {
+            *out++ = static_cast<char>(0xF0 | (cp >> 18));
+            *out++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+    return transcode_result<WCharT>{p, static_cast<size_t>(out - out_first), unicons::conv_errc()};
+}
+
+}}
+
+#endif
@@ -0,0 +1,1248 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_FROZEN_JSON_HPP
+#define JSONCONS_FROZEN_JSON_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_filter.hpp>
+#include <jsoncons/detail/mapped_file.hpp>
+
+namespace jsoncons {
+
+namespace detail {
+
+// A frozen document is a tape of 64 bit words. Each value starts with a header word that
+// holds its tag in the low 8 bits and, for strings and containers, its length or size above:
+//
+//   null, true, false     header
+//   integer, uinteger     header, value
+//   double                header (with the precision), bits of the value
+//   string, byte string   header, the characters or bytes, padded to a whole word
+//   array, object         header, position past the value, position of the table
+//
+// The elements of an array follow its header in document order, then a table with the
+// position of each element. The members of an object follow its header in document order,
+// each a key (a word with its length, then its characters) then the value, then a table
+// with the position of each member, sorted by key. Everything a lookup reads is in the
+// tape, mostly in the same few cache lines.
+
+enum class frozen_tag : uint8_t
+{
+    null_t = 0,
+    true_t,
+    false_t,
+    integer_t,
+    uinteger_t,
+    double_t,
+    string_t,
+    byte_string_t,
+    array_t,
+    object_t
+};
+
+// The words of a tape are read through data_, which points into words_ for a tape that was
+// built, and into the mapping for one mapped from a snapshot file.
+
+template <class CharT>
+struct frozen_tape
+{
+    std::vector<uint64_t> words_;
+    const uint64_t* data_;
+    size_t size_;
+    std::unique_ptr<mapped_file> file_;
+
+    frozen_tape()
+        : data_(nullptr), size_(0)
+    {
+    }
+
+    frozen_tape(std::initializer_list<uint64_t> words)
+        : words_(words), data_(words_.data()), size_(words_.size())
+    {
+    }
+
+    frozen_tape(const frozen_tape&) = delete;
+    frozen_tape& operator=(const frozen_tape&) = delete;
+
+    // Points data_ at words_, after words have been added
+    void use_words()
+    {
+        data_ = words_.data();
+        size_ = words_.size();
+    }
+
+    // The number of words that hold length items of item_size bytes
+    static size_t word_count(size_t length, size_t item_size)
+    {
+        return (length*item_size + sizeof(uint64_t) - 1)/sizeof(uint64_t);
+    }
+
+    static uint64_t header(frozen_tag tag, uint64_t length = 0)
+    {
+        return static_cast<uint64_t>(tag) | (length << 8);
+    }
+
+    // The functions that read a tape take its words, so that a view can hold a pointer to
+    // them, whether they belong to a frozen_tape or to a basic_static_json
+
+    static frozen_tag tag(const uint64_t* data, size_t pos)
+    {
+        return static_cast<frozen_tag>(data[pos] & 0xff);
+    }
+
+    static size_t length(const uint64_t* data, size_t pos)
+    {
+        return static_cast<size_t>(data[pos] >> 8);
+    }
+
+    // The position of the value that follows the one at pos
+    static size_t next(const uint64_t* data, size_t pos)
+    {
+        switch (tag(data, pos))
+        {
+        case frozen_tag::null_t:
+        case frozen_tag::true_t:
+        case frozen_tag::false_t:
+            return pos + 1;
+        case frozen_tag::string_t:
+            return pos + 1 + word_count(length(data, pos), sizeof(CharT));
+        case frozen_tag::byte_string_t:
+            return pos + 1 + word_count(length(data, pos), 1);
+        case frozen_tag::array_t:
+        case frozen_tag::object_t:
+            return static_cast<size_t>(data[pos + 1]);
+        default:
+            return pos + 2;
+        }
+    }
+
+    static size_t table(const uint64_t* data, size_t pos)
+    {
+        return static_cast<size_t>(data[pos + 2]);
+    }
+
+    static const CharT* chars(const uint64_t* data, size_t pos)
+    {
+        return reinterpret_cast<const CharT*>(data + pos);
+    }
+
+    static const uint8_t* bytes(const uint64_t* data, size_t pos)
+    {
+        return reinterpret_cast<const uint8_t*>(data + pos);
+    }
+
+    // The key of the member at pos
+    template <class StringViewT>
+    static StringViewT key(const uint64_t* data, size_t pos)
+    {
+        return StringViewT(chars(data, pos + 1), static_cast<size_t>(data[pos]));
+    }
+
+    // The position of the value of the member at pos
+    static size_t member_value(const uint64_t* data, size_t pos)
+    {
+        return pos + 1 + word_count(static_cast<size_t>(data[pos]), sizeof(CharT));
+    }
+
+    template <class T>
+    void append(const T* data, size_t length)
+    {
+        const size_t pos = words_.size();
+        words_.resize(pos + word_count(length, sizeof(T)));
+        if (length > 0)
+        {
+            std::memcpy(words_.data() + pos, data, length*sizeof(T));
+        }
+    }
+};
+
+// A snapshot is a header of four words followed by the words of the tape, in the byte
+// order of the machine that wrote it. Positions in the tape are relative to its start, so
+// a snapshot can be read in place wherever it is mapped.
+//
+//   "jcfrozen"
+//   format version, size of CharT
+//   0x0102030405060708, read back in another order if the byte order differs
+//   number of words in the tape
+
+template <class CharT>
+struct frozen_snapshot
+{
+    static const size_t header_words = 4;
+    static const uint64_t version = 1;
+    static const uint64_t byte_order = 0x0102030405060708;
+
+    static uint64_t magic()
+    {
+        uint64_t value;
+        std::memcpy(&value, "jcfrozen", sizeof(value));
+        return value;
+    }
+
+    static void write(const frozen_tape<CharT>& tape, std::ostream& os)
+    {
+        const uint64_t header[header_words] = {magic(), version | (sizeof(CharT) << 8), byte_order, tape.size_};
+        os.write(reinterpret_cast<const char*>(header), sizeof(header));
+        os.write(reinterpret_cast<const char*>(tape.data_), tape.size_*sizeof(uint64_t));
+    }
+
+    // Checks the header, and returns the number of words in the tape that follows
+    static size_t check_header(const uint64_t* header, size_t available_words)
+    {
+        if (header[0] != magic())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a frozen_json snapshot");
+        }
+        if (header[1] != (version | (sizeof(CharT) << 8)))
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Unsupported frozen_json snapshot version or character type");
+        }
+        if (header[2] != byte_order)
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"frozen_json snapshot has a different byte order");
+        }
+        if (header[3] == 0 || header[3] > available_words)
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Truncated frozen_json snapshot");
+        }
+        return static_cast<size_t>(header[3]);
+    }
+};
+
+}
+
+template <class CharT>
+class basic_frozen_json_decoder;
+
+template <class CharT, size_t Words>
+class basic_static_json;
+
+// basic_frozen_json_view
+// A value in the tape of a basic_frozen_json. The values returned by at, operator[] and
+// iteration are views too. Like a string_view, a view does not own the tape, which must
+// outlive it.
+
+template <class CharT>
+class basic_frozen_json_view
+{
+public:
+    typedef basic_frozen_json_view value_type;
+    typedef basic_frozen_json_view& reference;
+    typedef const basic_frozen_json_view& const_reference;
+    typedef basic_frozen_json_view* pointer;
+    typedef const basic_frozen_json_view* const_pointer;
+    typedef CharT char_type;
+    typedef std::char_traits<char_type> char_traits_type;
+    typedef std::basic_string<char_type,char_traits_type> string_type;
+#if !defined(JSONCONS_HAS_STRING_VIEW)
+    typedef Basic_string_view_<char_type,char_traits_type> string_view_type;
+#else
+    typedef std::basic_string_view<char_type,char_traits_type> string_view_type;
+#endif
+protected:
+    typedef detail::frozen_tape<CharT> tape_type;
+    typedef detail::frozen_tag frozen_tag;
+
+    static const size_t linear_search_size = 8;
+
+    template <class C, size_t Words>
+    friend class basic_static_json;
+
+    const uint64_t* data_;
+    size_t pos_;
+
+    basic_frozen_json_view(const uint64_t* data, size_t pos)
+        : data_(data), pos_(pos)
+    {
+    }
+
+    static const tape_type& null_tape()
+    {
+        static const tape_type tape{tape_type::header(frozen_tag::null_t)};
+        return tape;
+    }
+public:
+    class member
+    {
+        const uint64_t* data_;
+        size_t pos_;
+    public:
+        member(const uint64_t* data, size_t pos)
+            : data_(data), pos_(pos)
+        {
+        }
+
+        string_view_type key() const
+        {
+            return tape_type::template key<string_view_type>(data_, pos_);
+        }
+
+        basic_frozen_json_view value() const
+        {
+            return basic_frozen_json_view(data_, tape_type::member_value(data_, pos_));
+        }
+    };
+
+    // Iterates over the elements of an array in order
+    class element_iterator
+    {
+        const uint64_t* data_;
+        size_t pos_;
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef basic_frozen_json_view value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const basic_frozen_json_view* pointer;
+        typedef basic_frozen_json_view reference;
+
+        element_iterator()
+            : data_(nullptr), pos_(0)
+        {
+        }
+
+        element_iterator(const uint64_t* data, size_t pos)
+            : data_(data), pos_(pos)
+        {
+        }
+
+        basic_frozen_json_view operator*() const
+        {
+            return basic_frozen_json_view(data_, pos_);
+        }
+
+        element_iterator& operator++()
+        {
+            pos_ = tape_type::next(data_, pos_);
+            return *this;
+        }
+
+        element_iterator operator++(int)
+        {
+            element_iterator temp(*this);
+            ++*this;
+            return temp;
+        }
+
+        friend bool operator==(const element_iterator& a, const element_iterator& b)
+        {
+            return a.pos_ == b.pos_;
+        }
+
+        friend bool operator!=(const element_iterator& a, const element_iterator& b)
+        {
+            return !(a == b);
+        }
+    };
+
+    // Iterates over the members of an object in document order
+    class member_iterator
+    {
+        const uint64_t* data_;
+        size_t pos_;
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef member value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const member* pointer;
+        typedef member reference;
+
+        member_iterator()
+            : data_(nullptr), pos_(0)
+        {
+        }
+
+        member_iterator(const uint64_t* data, size_t pos)
+            : data_(data), pos_(pos)
+        {
+        }
+
+        member operator*() const
+        {
+            return member(data_, pos_);
+        }
+
+        member_iterator& operator++()
+        {
+            pos_ = tape_type::next(data_, tape_type::member_value(data_, pos_));
+            return *this;
+        }
+
+        member_iterator operator++(int)
+        {
+            member_iterator temp(*this);
+            ++*this;
+            return temp;
+        }
+
+        friend bool operator==(const member_iterator& a, const member_iterator& b)
+        {
+            return a.pos_ == b.pos_;
+        }
+
+        friend bool operator!=(const member_iterator& a, const member_iterator& b)
+        {
+            return !(a == b);
+        }
+    };
+
+    // A null value
+    basic_frozen_json_view()
+        : data_(null_tape().data_), pos_(0)
+    {
+    }
+
+    bool is_null() const JSONCONS_NOEXCEPT
+    {
+        return tag() == frozen_tag::null_t;
+    }
+
+    bool is_bool() const JSONCONS_NOEXCEPT
+    {
+        return tag() == frozen_tag::true_t || tag() == frozen_tag::false_t;
+    }
+
+    bool is_integer() const JSONCONS_NOEXCEPT
+    {
+        return tag() == frozen_tag::integer_t;
+    }
+
+    bool is_uinteger() const JSONCONS_NOEXCEPT
+    {
+        return tag() == frozen_tag::uinteger_t;
+    }
+
+    bool is_double() const JSONCONS_NOEXCEPT
+    {
+        return tag() == frozen_tag::double_t;
+    }
+
+    bool is_number() const JSONCONS_NOEXCEPT
+    {
+        return is_integer() || is_uinteger() || is_double();
+    }
+
+    bool is_string() const JSONCONS_NOEXCEPT
+    {
+        return tag() == frozen_tag::string_t;
+    }
+
+    bool is_byte_string() const JSONCONS_NOEXCEPT
+    {
+        return tag() == frozen_tag::byte_string_t;
+    }
+
+    bool is_array() const JSONCONS_NOEXCEPT
+    {
+        return tag() == frozen_tag::array_t;
+    }
+
+    bool is_object() const JSONCONS_NOEXCEPT
+    {
+        return tag() == frozen_tag::object_t;
+    }
+
+    // The number of elements of an array or members of an object, otherwise 0
+    size_t size() const JSONCONS_NOEXCEPT
+    {
+        return is_array() || is_object() ? tape_type::length(data_, pos_) : 0;
+    }
+
+    bool empty() const JSONCONS_NOEXCEPT
+    {
+        return size() == 0;
+    }
+
+    basic_frozen_json_view at(size_t i) const
+    {
+        if (!is_array())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Index on non-array value not supported");
+        }
+        if (i >= size())
+        {
+            JSONCONS_THROW_EXCEPTION(std::out_of_range,"Invalid array subscript");
+        }
+        return basic_frozen_json_view(data_, static_cast<size_t>(data_[tape_type::table(data_, pos_) + i]));
+    }
+
+    basic_frozen_json_view at(const string_view_type& name) const
+    {
+        if (!is_object())
+        {
+            JSONCONS_THROW_EXCEPTION_1(std::runtime_error,"Attempting to get %s from a value that is not an object",name);
+        }
+        size_t member_pos;
+        if (!find_member(name, member_pos))
+        {
+            JSONCONS_THROW_EXCEPTION_1(std::out_of_range,"%s not found",name);
+        }
+        return basic_frozen_json_view(data_, tape_type::member_value(data_, member_pos));
+    }
+
+    basic_frozen_json_view operator[](size_t i) const
+    {
+        return at(i);
+    }
+
+    basic_frozen_json_view operator[](const string_view_type& name) const
+    {
+        return at(name);
+    }
+
+    bool has_key(const string_view_type& name) const
+    {
+        size_t member_pos;
+        return is_object() && find_member(name, member_pos);
+    }
+
+    size_t count(const string_view_type& name) const
+    {
+        return has_key(name) ? 1 : 0;
+    }
+
+    // The member with the given name, or the end of members() if there is none
+    member_iterator find(const string_view_type& name) const
+    {
+        size_t member_pos;
+        if (is_object() && find_member(name, member_pos))
+        {
+            return member_iterator(data_, member_pos);
+        }
+        return members_end();
+    }
+
+    range<element_iterator> elements() const
+    {
+        if (!is_array())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an array");
+        }
+        return range<element_iterator>(element_iterator(data_, pos_ + 3),
+                                       element_iterator(data_, tape_type::table(data_, pos_)));
+    }
+
+    range<member_iterator> members() const
+    {
+        if (!is_object())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an object");
+        }
+        return range<member_iterator>(member_iterator(data_, pos_ + 3), members_end());
+    }
+
+    bool as_bool() const
+    {
+        switch (tag())
+        {
+        case frozen_tag::true_t:
+            return true;
+        case frozen_tag::false_t:
+            return false;
+        case frozen_tag::integer_t:
+        case frozen_tag::uinteger_t:
+            return data_[pos_ + 1] != 0;
+        default:
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a bool");
+        }
+    }
+
+    int64_t as_integer() const
+    {
+        switch (tag())
+        {
+        case frozen_tag::integer_t:
+        case frozen_tag::uinteger_t:
+            return static_cast<int64_t>(data_[pos_ + 1]);
+        case frozen_tag::double_t:
+            return static_cast<int64_t>(double_value());
+        case frozen_tag::true_t:
+            return 1;
+        case frozen_tag::false_t:
+            return 0;
+        default:
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an integer");
+        }
+    }
+
+    uint64_t as_uinteger() const
+    {
+        switch (tag())
+        {
+        case frozen_tag::integer_t:
+        case frozen_tag::uinteger_t:
+            return data_[pos_ + 1];
+        case frozen_tag::double_t:
+            return static_cast<uint64_t>(double_value());
+        case frozen_tag::true_t:
+            return 1;
+        case frozen_tag::false_t:
+            return 0;
+        default:
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an unsigned integer");
+        }
+    }
+
+    double as_double() const
+    {
+        switch (tag())
+        {
+        case frozen_tag::integer_t:
+            return static_cast<double>(static_cast<int64_t>(data_[pos_ + 1]));
+        case frozen_tag::uinteger_t:
+            return static_cast<double>(data_[pos_ + 1]);
+        case frozen_tag::double_t:
+            return double_value();
+        default:
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a double");
+        }
+    }
+
+    // The characters of a string, in the tape
+    string_view_type as_string_view() const
+    {
+        if (!is_string())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a string");
+        }
+        return string_view_type(tape_type::chars(data_, pos_ + 1), tape_type::length(data_, pos_));
+    }
+
+    // The text of a string, otherwise the value serialized
+    string_type as_string() const
+    {
+        if (is_string())
+        {
+            string_view_type sv = as_string_view();
+            return string_type(sv.data(), sv.length());
+        }
+        return to_string();
+    }
+
+    // The bytes of a byte string, in the tape
+    const uint8_t* byte_string_data() const
+    {
+        return tape_type::bytes(data_, pos_ + 1);
+    }
+
+    size_t byte_string_length() const
+    {
+        return is_byte_string() ? tape_type::length(data_, pos_) : 0;
+    }
+
+    // Converts to T, to a basic_json with a copy of the value, and to other types
+    // through a basic_json<CharT> unless T is bool, a number or a string
+    template <class T>
+    T as() const;
+
+    void dump_fragment(basic_json_output_handler<char_type>& handler) const
+    {
+        dump_at(pos_, handler);
+    }
+
+    void dump(basic_json_output_handler<char_type>& handler) const
+    {
+        handler.begin_json();
+        dump_fragment(handler);
+        handler.end_json();
+    }
+
+    void dump(std::basic_ostream<char_type>& os) const
+    {
+        basic_json_serializer<char_type> serializer(os);
+        dump(serializer);
+    }
+
+    void dump(std::basic_ostream<char_type>& os, bool pprint) const
+    {
+        basic_json_serializer<char_type> serializer(os, pprint);
+        dump(serializer);
+    }
+
+    void dump(std::basic_ostream<char_type>& os, const basic_serialization_options<char_type>& options) const
+    {
+        basic_json_serializer<char_type> serializer(os, options);
+        dump(serializer);
+    }
+
+    string_type to_string() const
+    {
+        string_type s;
+        basic_string_sink<string_type> sink(s);
+        {
+            basic_json_serializer<char_type> serializer(sink);
+            dump_fragment(serializer);
+        }
+        return s;
+    }
+
+    friend std::basic_ostream<char_type>& operator<<(std::basic_ostream<char_type>& os, const basic_frozen_json_view& o)
+    {
+        o.dump(os);
+        return os;
+    }
+private:
+    frozen_tag tag() const
+    {
+        return tape_type::tag(data_, pos_);
+    }
+
+    double double_value() const
+    {
+        double d;
+        std::memcpy(&d, &data_[pos_ + 1], sizeof(double));
+        return d;
+    }
+
+    member_iterator members_end() const
+    {
+        return member_iterator(data_, is_object() ? tape_type::table(data_, pos_) : pos_);
+    }
+
+    // Searches the members of a small object in order, and the table of a larger one
+    bool find_member(const string_view_type& name, size_t& member_pos) const
+    {
+        if (tape_type::length(data_, pos_) <= linear_search_size)
+        {
+            const size_t last = tape_type::table(data_, pos_);
+            for (size_t p = pos_ + 3; p != last; p = tape_type::next(data_, tape_type::member_value(data_, p)))
+            {
+                if (tape_type::template key<string_view_type>(data_, p) == name)
+                {
+                    member_pos = p;
+                    return true;
+                }
+            }
+            return false;
+        }
+        const uint64_t* data = data_;
+        const uint64_t* first = data + tape_type::table(data, pos_);
+        const uint64_t* last = first + tape_type::length(data, pos_);
+        const uint64_t* it = std::lower_bound(first, last, name,
+            [data](uint64_t pos, const string_view_type& key)
+            {
+                return tape_type::template key<string_view_type>(data, static_cast<size_t>(pos)) < key;
+            });
+        if (it != last && tape_type::template key<string_view_type>(data, static_cast<size_t>(*it)) == name)
+        {
+            member_pos = static_cast<size_t>(*it);
+            return true;
+        }
+        return false;
+    }
+
+    void dump_at(size_t pos, basic_json_output_handler<char_type>& handler) const
+    {
+        switch (tape_type::tag(data_, pos))
+        {
+        case frozen_tag::null_t:
+            handler.null_value();
+            break;
+        case frozen_tag::true_t:
+            handler.bool_value(true);
+            break;
+        case frozen_tag::false_t:
+            handler.bool_value(false);
+            break;
+        case frozen_tag::integer_t:
+            handler.integer_value(static_cast<int64_t>(data_[pos + 1]));
+            break;
+        case frozen_tag::uinteger_t:
+            handler.uinteger_value(data_[pos + 1]);
+            break;
+        case frozen_tag::double_t:
+            {
+                double d;
+                std::memcpy(&d, &data_[pos + 1], sizeof(double));
+                handler.double_value(d, static_cast<uint8_t>(tape_type::length(data_, pos)));
+            }
+            break;
+        case frozen_tag::string_t:
+            handler.string_value(string_view_type(tape_type::chars(data_, pos + 1), tape_type::length(data_, pos)));
+            break;
+        case frozen_tag::byte_string_t:
+            handler.byte_string_value(tape_type::bytes(data_, pos + 1), tape_type::length(data_, pos));
+            break;
+        case frozen_tag::array_t:
+            {
+                handler.begin_array();
+                const size_t last = tape_type::table(data_, pos);
+                for (size_t p = pos + 3; p != last; p = tape_type::next(data_, p))
+                {
+                    dump_at(p, handler);
+                }
+                handler.end_array();
+            }
+            break;
+        case frozen_tag::object_t:
+            {
+                handler.begin_object();
+                const size_t last = tape_type::table(data_, pos);
+                for (size_t p = pos + 3; p != last; p = tape_type::next(data_, tape_type::member_value(data_, p)))
+                {
+                    handler.name(tape_type::template key<string_view_type>(data_, p));
+                    dump_at(tape_type::member_value(data_, p), handler);
+                }
+                handler.end_object();
+            }
+            break;
+        default:
+            JSONCONS_UNREACHABLE();
+            break;
+        }
+    }
+};
+
+// basic_frozen_json
+// Owns the tape of a frozen document and is a view of its root value. Copies share the
+// tape, which is never modified.
+
+template <class CharT>
+class basic_frozen_json : public basic_frozen_json_view<CharT>
+{
+    typedef basic_frozen_json_view<CharT> view_type;
+    using typename view_type::tape_type;
+
+    friend class basic_frozen_json_decoder<CharT>;
+
+    std::shared_ptr<const tape_type> storage_;
+
+    explicit basic_frozen_json(std::shared_ptr<const tape_type>&& storage)
+        : view_type(storage->data_, 0), storage_(std::move(storage))
+    {
+    }
+public:
+    using typename view_type::char_type;
+    using typename view_type::string_view_type;
+
+    // A null value
+    basic_frozen_json() = default;
+
+    basic_frozen_json(const basic_frozen_json&) = default;
+
+    basic_frozen_json(basic_frozen_json&& other) JSONCONS_NOEXCEPT
+        : view_type(other), storage_(std::move(other.storage_))
+    {
+        static_cast<view_type&>(other) = view_type();
+    }
+
+    basic_frozen_json& operator=(const basic_frozen_json&) = default;
+
+    basic_frozen_json& operator=(basic_frozen_json&& other) JSONCONS_NOEXCEPT
+    {
+        if (this != &other)
+        {
+            view_type::operator=(other);
+            storage_ = std::move(other.storage_);
+            static_cast<view_type&>(other) = view_type();
+        }
+        return *this;
+    }
+
+    static basic_frozen_json parse(const string_view_type& s);
+
+    static basic_frozen_json parse(std::basic_istream<char_type>& is);
+
+    // Writes a snapshot of the document, which load and map read back without parsing
+    void save(std::ostream& os) const;
+
+    static basic_frozen_json load(std::istream& is);
+
+    // Maps a snapshot file and reads it in place. The snapshot is trusted, only its header
+    // is checked.
+    static basic_frozen_json map(const std::string& filename);
+
+    // The root value
+    view_type view() const
+    {
+        return *this;
+    }
+};
+
+// basic_frozen_json_decoder
+// Writes the tape of a basic_frozen_json from parse events
+
+template <class CharT>
+class basic_frozen_json_decoder final : public basic_json_input_handler<CharT>
+{
+public:
+    using typename basic_json_input_handler<CharT>::string_view_type;
+private:
+    typedef detail::frozen_tape<CharT> tape_type;
+    typedef detail::frozen_tag frozen_tag;
+
+    // An open array or object, the positions of its elements or members are collected
+    // for its table. Items above top_ keep their vectors for reuse.
+    struct stack_item
+    {
+        size_t pos_;
+        bool is_object_;
+        std::vector<uint64_t> items_;
+    };
+
+    std::shared_ptr<tape_type> tape_;
+    std::vector<stack_item> stack_;
+    size_t top_;
+    bool is_valid_;
+public:
+    basic_frozen_json_decoder()
+        : tape_(std::make_shared<tape_type>()), top_(0), is_valid_(false)
+    {
+    }
+
+    bool is_valid() const
+    {
+        return is_valid_;
+    }
+
+    basic_frozen_json<CharT> get_result()
+    {
+        is_valid_ = false;
+        tape_->use_words();
+        std::shared_ptr<const tape_type> tape(std::move(tape_));
+        tape_ = std::make_shared<tape_type>();
+        return basic_frozen_json<CharT>(std::move(tape));
+    }
+
+    void reset()
+    {
+        tape_ = std::make_shared<tape_type>();
+        top_ = 0;
+        is_valid_ = false;
+    }
+private:
+    void do_begin_json() override
+    {
+        is_valid_ = false;
+    }
+
+    void do_end_json() override
+    {
+        is_valid_ = true;
+    }
+
+    void do_begin_object(const parsing_context&) override
+    {
+        begin_container(true);
+    }
+
+    void do_end_object(const parsing_context&) override
+    {
+        stack_item& item = stack_[top_ - 1];
+        tape_->use_words();
+        const tape_type& tape = *tape_;
+        std::stable_sort(item.items_.begin(), item.items_.end(),
+            [&tape](uint64_t a, uint64_t b)
+            {
+                return tape_type::template key<string_view_type>(tape.data_, static_cast<size_t>(a)) <
+                       tape_type::template key<string_view_type>(tape.data_, static_cast<size_t>(b));
+            });
+        end_container(frozen_tag::object_t);
+    }
+
+    void do_begin_array(const parsing_context&) override
+    {
+        begin_container(false);
+    }
+
+    void do_end_array(const parsing_context&) override
+    {
+        end_container(frozen_tag::array_t);
+    }
+
+    void do_name(const string_view_type& name, const parsing_context&) override
+    {
+        std::vector<uint64_t>& words = tape_->words_;
+        stack_[top_ - 1].items_.push_back(words.size());
+        words.push_back(name.length());
+        tape_->append(name.data(), name.length());
+    }
+
+    void do_string_value(const string_view_type& value, const parsing_context&) override
+    {
+        begin_value();
+        tape_->words_.push_back(tape_type::header(frozen_tag::string_t, value.length()));
+        tape_->append(value.data(), value.length());
+    }
+
+    void do_byte_string_value(const uint8_t* data, size_t length, const parsing_context&) override
+    {
+        begin_value();
+        tape_->words_.push_back(tape_type::header(frozen_tag::byte_string_t, length));
+        tape_->append(data, length);
+    }
+
+    void do_integer_value(int64_t value, const parsing_context&) override
+    {
+        add_value(tape_type::header(frozen_tag::integer_t), static_cast<uint64_t>(value));
+    }
+
+    void do_uinteger_value(uint64_t value, const parsing_context&) override
+    {
+        add_value(tape_type::header(frozen_tag::uinteger_t), value);
+    }
+
+    void do_double_value(double value, uint8_t precision, const parsing_context&) override
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(double));
+        add_value(tape_type::header(frozen_tag::double_t, precision), bits);
+    }
+
+    void do_bool_value(bool value, const parsing_context&) override
+    {
+        begin_value();
+        tape_->words_.push_back(tape_type::header(value ? frozen_tag::true_t : frozen_tag::false_t));
+    }
+
+    void do_null_value(const parsing_context&) override
+    {
+        begin_value();
+        tape_->words_.push_back(tape_type::header(frozen_tag::null_t));
+    }
+
+    // Array elements are recorded in the table when they begin, object members when
+    // their names are
+    void begin_value()
+    {
+        if (top_ > 0 && !stack_[top_ - 1].is_object_)
+        {
+            stack_[top_ - 1].items_.push_back(tape_->words_.size());
+        }
+    }
+
+    void add_value(uint64_t header, uint64_t payload)
+    {
+        begin_value();
+        tape_->words_.push_back(header);
+        tape_->words_.push_back(payload);
+    }
+
+    void begin_container(bool is_object)
+    {
+        begin_value();
+        std::vector<uint64_t>& words = tape_->words_;
+        if (top_ == stack_.size())
+        {
+            stack_.push_back(stack_item());
+        }
+        stack_item& item = stack_[top_++];
+        item.pos_ = words.size();
+        item.is_object_ = is_object;
+        item.items_.clear();
+        words.resize(words.size() + 3);
+    }
+
+    void end_container(frozen_tag tag)
+    {
+        stack_item& item = stack_[--top_];
+        std::vector<uint64_t>& words = tape_->words_;
+        const size_t table = words.size();
+        words.insert(words.end(), item.items_.begin(), item.items_.end());
+        words[item.pos_] = tape_type::header(tag, item.items_.size());
+        words[item.pos_ + 1] = words.size();
+        words[item.pos_ + 2] = table;
+    }
+};
+
+typedef basic_frozen_json<char> frozen_json;
+typedef basic_frozen_json<wchar_t> wfrozen_json;
+typedef basic_frozen_json_view<char> frozen_json_view;
+typedef basic_frozen_json_view<wchar_t> wfrozen_json_view;
+typedef basic_frozen_json_decoder<char> frozen_json_decoder;
+typedef basic_frozen_json_decoder<wchar_t> wfrozen_json_decoder;
+
+// Converts a basic_json value to a frozen one
+template <class Json>
+basic_frozen_json<typename Json::char_type> freeze(const Json& val)
+{
+    basic_frozen_json_decoder<typename Json::char_type> decoder;
+    basic_json_output_input_handler_adapter<typename Json::char_type> adapter(decoder);
+    val.dump(adapter);
+    return decoder.get_result();
+}
+
+template <class CharT>
+basic_frozen_json<CharT> basic_frozen_json<CharT>::parse(const string_view_type& s)
+{
+    auto result = unicons::skip_bom(s.begin(), s.end());
+    if (result.ec != unicons::encoding_errc())
+    {
+        throw parse_error(result.ec,1,1);
+    }
+    size_t offset = result.it - s.begin();
+
+    basic_frozen_json_decoder<CharT> decoder;
+    basic_json_parser<CharT,basic_frozen_json_decoder<CharT>> parser(decoder);
+    parser.set_source(s.data() + offset, s.size() - offset);
+    parser.parse();
+    parser.end_parse();
+    parser.check_done();
+    if (!decoder.is_valid())
+    {
+        JSONCONS_THROW_EXCEPTION(std::runtime_error,"Failed to parse json string");
+    }
+    return decoder.get_result();
+}
+
+template <class CharT>
+void basic_frozen_json<CharT>::save(std::ostream& os) const
+{
+    const tape_type& tape = storage_ ? *storage_ : view_type::null_tape();
+    detail::frozen_snapshot<CharT>::write(tape, os);
+}
+
+template <class CharT>
+basic_frozen_json<CharT> basic_frozen_json<CharT>::load(std::istream& is)
+{
+    typedef detail::frozen_snapshot<CharT> snapshot;
+
+    uint64_t header[snapshot::header_words];
+    if (!is.read(reinterpret_cast<char*>(header), sizeof(header)))
+    {
+        JSONCONS_THROW_EXCEPTION(std::runtime_error,"Truncated frozen_json snapshot");
+    }
+    const size_t size = snapshot::check_header(header, (std::numeric_limits<size_t>::max)()/sizeof(uint64_t));
+
+    std::shared_ptr<tape_type> tape = std::make_shared<tape_type>();
+    tape->words_.resize(size);
+    if (!is.read(reinterpret_cast<char*>(tape->words_.data()), size*sizeof(uint64_t)))
+    {
+        JSONCONS_THROW_EXCEPTION(std::runtime_error,"Truncated frozen_json snapshot");
+    }
+    tape->use_words();
+    return basic_frozen_json(std::move(tape));
+}
+
+template <class CharT>
+basic_frozen_json<CharT> basic_frozen_json<CharT>::map(const std::string& filename)
+{
+    typedef detail::frozen_snapshot<CharT> snapshot;
+
+    std::error_code ec;
+    std::unique_ptr<detail::mapped_file> file(new detail::mapped_file(filename, ec, false));
+    if (ec)
+    {
+        JSONCONS_THROW_EXCEPTION_1(std::runtime_error,"Cannot map %s",filename);
+    }
+    const size_t available_words = file->size()/sizeof(uint64_t);
+    if (available_words < snapshot::header_words)
+    {
+        JSONCONS_THROW_EXCEPTION(std::runtime_error,"Truncated frozen_json snapshot");
+    }
+    const uint64_t* header = reinterpret_cast<const uint64_t*>(file->data());
+    const size_t size = snapshot::check_header(header, available_words - snapshot::header_words);
+
+    std::shared_ptr<tape_type> tape = std::make_shared<tape_type>();
+    tape->data_ = header + snapshot::header_words;
+    tape->size_ = size;
+    tape->file_ = std::move(file);
+    return basic_frozen_json(std::move(tape));
+}
+
+template <class CharT>
+basic_frozen_json<CharT> basic_frozen_json<CharT>::parse(std::basic_istream<char_type>& is)
+{
+    basic_frozen_json_decoder<CharT> decoder;
+    basic_json_reader<CharT> reader(is, decoder);
+    reader.read();
+    reader.check_done();
+    if (!decoder.is_valid())
+    {
+        JSONCONS_THROW_EXCEPTION(std::runtime_error,"Failed to parse json stream");
+    }
+    return decoder.get_result();
+}
+
+namespace detail {
+
+template <class T, class CharT, class Enable = void>
+struct frozen_json_as
+{
+    static T as(const basic_frozen_json_view<CharT>& val)
+    {
+        return val.template as<basic_json<CharT>>().template as<T>();
+    }
+};
+
+template <class Json, class CharT>
+struct frozen_json_as<Json, CharT, typename std::enable_if<is_basic_json<Json>::value>::type>
+{
+    static Json as(const basic_frozen_json_view<CharT>& val)
+    {
+        json_decoder<Json> decoder;
+        basic_json_output_input_handler_adapter<CharT> adapter(decoder);
+        val.dump(adapter);
+        return decoder.get_result();
+    }
+};
+
+template <class CharT>
+struct frozen_json_as<bool, CharT>
+{
+    static bool as(const basic_frozen_json_view<CharT>& val)
+    {
+        return val.as_bool();
+    }
+};
+
+template <class T, class CharT>
+struct frozen_json_as<T, CharT, typename std::enable_if<is_integer_like<T>::value>::type>
+{
+    static T as(const basic_frozen_json_view<CharT>& val)
+    {
+        return static_cast<T>(val.as_integer());
+    }
+};
+
+template <class T, class CharT>
+struct frozen_json_as<T, CharT, typename std::enable_if<is_uinteger_like<T>::value>::type>
+{
+    static T as(const basic_frozen_json_view<CharT>& val)
+    {
+        return static_cast<T>(val.as_uinteger());
+    }
+};
+
+template <class T, class CharT>
+struct frozen_json_as<T, CharT, typename std::enable_if<is_floating_point_like<T>::value>::type>
+{
+    static T as(const basic_frozen_json_view<CharT>& val)
+    {
+        return static_cast<T>(val.as_double());
+    }
+};
+
+template <class CharT>
+struct frozen_json_as<std::basic_string<CharT>, CharT>
+{
+    static std::basic_string<CharT> as(const basic_frozen_json_view<CharT>& val)
+    {
+        return val.as_string();
+    }
+};
+
+}
+
+template <class CharT>
+template <class T>
+T basic_frozen_json_view<CharT>::as() const
+{
+    return detail::frozen_json_as<T,CharT>::as(*this);
+}
+
+}
+
+#endif
@@ -0,0 +1,249 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_INPUT_SOURCE_HPP
+#define JSONCONS_INPUT_SOURCE_HPP
+
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <vector>
+#include <cstring>
+#include <system_error>
+#include <jsoncons/detail/jsoncons_config.hpp>
+#include <jsoncons/detail/utf_transcode.hpp>
+
+namespace jsoncons {
+
+// Where a reader's input comes from. The readers ask a source to fill their buffer once
+// per buffer, not once per character, so the cost of the virtual call is spread over
+// many characters. A source that produces its input, for example by decompressing it,
+// can write it straight into the reader's buffer.
+
+template <class CharT>
+class basic_input_source
+{
+public:
+    typedef CharT char_type;
+
+    virtual ~basic_input_source() {}
+
+    // Reads up to length characters into data and returns how many were read. Fewer
+    // than length are read only at the end of the input or after an error.
+    size_t read(CharT* data, size_t length)
+    {
+        return do_read(data, length);
+    }
+
+    // True once a read has found the end of the input
+    bool eof() const
+    {
+        return do_eof();
+    }
+
+    // True if the input could not be read
+    bool fail() const
+    {
+        return do_fail();
+    }
+
+private:
+    virtual size_t do_read(CharT* data, size_t length) = 0;
+
+    virtual bool do_eof() const = 0;
+
+    virtual bool do_fail() const = 0;
+};
+
+// Reads from a std::basic_istream. A default constructed source has no stream, and is
+// at the end of its input until reset.
+
+template <class CharT>
+class basic_stream_source : public basic_input_source<CharT>
+{
+    std::basic_istream<CharT>* is_;
+
+    // Noncopyable and nonmoveable
+    basic_stream_source(const basic_stream_source&) = delete;
+    basic_stream_source& operator=(const basic_stream_source&) = delete;
+public:
+    basic_stream_source()
+        : is_(nullptr)
+    {
+    }
+
+    basic_stream_source(std::basic_istream<CharT>& is)
+        : is_(std::addressof(is))
+    {
+    }
+
+    void reset(std::basic_istream<CharT>& is)
+    {
+        is_ = std::addressof(is);
+    }
+
+private:
+    size_t do_read(CharT* data, size_t length) override
+    {
+        if (is_ == nullptr)
+        {
+            return 0;
+        }
+        is_->read(data, length);
+        return static_cast<size_t>(is_->gcount());
+    }
+
+    bool do_eof() const override
+    {
+        return is_ == nullptr || is_->eof();
+    }
+
+    bool do_fail() const override
+    {
+        return is_ != nullptr && is_->fail() && !is_->eof();
+    }
+};
+
+// Reads UTF-8 from a std::istream, or from a source of char, as the UTF-16 or UTF-32 of a
+// wide character type, so that a wjson_reader can read UTF-8 text. Bytes are converted
+// straight into the reader's buffer when it has room for them, and a sequence cut short
+// by the end of a read is kept for the next. Input that is not valid UTF-8 makes the
+// source fail, and error() gives the reason.
+
+template <class CharT>
+class basic_utf8_source : public basic_input_source<CharT>
+{
+    static const size_t min_read_length = 64;
+    static const size_t default_read_length = 16384;
+
+    basic_stream_source<char> stream_source_;
+    basic_input_source<char>* source_;
+    // Bytes read, of which the first pending_ are the start of a sequence not yet converted
+    std::vector<char> bytes_;
+    size_t pending_;
+    // Characters converted that did not fit in the reader's buffer, from position_
+    std::vector<CharT> chars_;
+    size_t position_;
+    std::error_code ec_;
+
+    // Noncopyable and nonmoveable
+    basic_utf8_source(const basic_utf8_source&) = delete;
+    basic_utf8_source& operator=(const basic_utf8_source&) = delete;
+public:
+    basic_utf8_source(std::istream& is)
+        : stream_source_(is),
+          source_(std::addressof(stream_source_)),
+          pending_(0),
+          position_(0)
+    {
+    }
+
+    basic_utf8_source(basic_input_source<char>& source)
+        : source_(std::addressof(source)),
+          pending_(0),
+          position_(0)
+    {
+    }
+
+    std::error_code error() const
+    {
+        return ec_;
+    }
+
+private:
+    size_t do_read(CharT* data, size_t length) override
+    {
+        size_t count = 0;
+        while (count < length && !ec_)
+        {
+            if (position_ < chars_.size())
+            {
+                size_t n = (std::min)(length - count, chars_.size() - position_);
+                std::memcpy(data + count, chars_.data() + position_, n*sizeof(CharT));
+                position_ += n;
+                count += n;
+                continue;
+            }
+            if (source_->fail())
+            {
+                break;
+            }
+            if (source_->eof() && pending_ == 0)
+            {
+                break;
+            }
+
+            // Each byte becomes at most one character, so bytes that fit in what is left
+            // of the reader's buffer are converted into it
+            size_t room = length - count;
+            size_t read_length = room >= pending_ + min_read_length ? room - pending_ : default_read_length;
+            bytes_.resize(pending_ + read_length);
+            size_t n = source_->eof() ? 0 : source_->read(bytes_.data() + pending_, read_length);
+            size_t total = pending_ + n;
+            if (total == 0)
+            {
+                break;
+            }
+
+            CharT* out;
+            if (detail::max_wide_length<CharT>(total) <= room)
+            {
+                out = data + count;
+            }
+            else
+            {
+                chars_.resize(detail::max_wide_length<CharT>(total));
+                out = chars_.data();
+            }
+            auto result = detail::utf8_to_wide(bytes_.data(), bytes_.data() + total, out);
+            if (result.ec == unicons::conv_errc::source_exhausted && n > 0)
+            {
+                pending_ = static_cast<size_t>((bytes_.data() + total) - result.it);
+                std::memmove(bytes_.data(), result.it, pending_);
+            }
+            else
+            {
+                pending_ = 0;
+                if (result.ec != unicons::conv_errc())
+                {
+                    ec_ = result.ec;
+                }
+            }
+            if (out == data + count)
+            {
+                count += result.length;
+            }
+            else
+            {
+                chars_.resize(result.length);
+                position_ = 0;
+            }
+        }
+        return count;
+    }
+
+    bool do_eof() const override
+    {
+        return source_->eof() && pending_ == 0 && position_ == chars_.size();
+    }
+
+    bool do_fail() const override
+    {
+        return source_->fail() || ec_;
+    }
+};
+
+typedef basic_input_source<char> input_source;
+typedef basic_input_source<wchar_t> winput_source;
+
+typedef basic_stream_source<char> stream_source;
+typedef basic_stream_source<wchar_t> wstream_source;
+
+typedef basic_utf8_source<wchar_t> wutf8_source;
+
+}
+
+#endif
@@ -15,12 +15,18 @@
 #include <cstring>
 #include <ostream>
 #include <memory>
+#include <atomic>
 #include <typeinfo>
 #include <cstring>
 #include <jsoncons/version.hpp>
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/jsoncons_utilities.hpp>
 #include <jsoncons/json_structures.hpp>
+#include <jsoncons/detail/compact_vector.hpp>
+#include <jsoncons/detail/chunked_vector.hpp>
+#include <jsoncons/detail/block_vector.hpp>
+#include <jsoncons/shared_key.hpp>
+#include <jsoncons/compact_string.hpp>
 #include <jsoncons/json_output_handler.hpp>
 #include <jsoncons/serialization_options.hpp>
 #include <jsoncons/json_serializer.hpp>
@@ -28,6 +34,9 @@
 #include <jsoncons/json_reader.hpp>
 #include <jsoncons/json_type_traits.hpp>
 #include <jsoncons/json_error_category.hpp>
+#if defined(JSONCONS_HAS_OPTIONAL)
+#include <optional>
+#endif
 
 #if defined(__GNUC__)
 #pragma GCC diagnostic push
@@ -41,10 +50,10 @@ struct sorted_policy
     static const bool preserve_order = false;
 
     template <class T,class Allocator>
-    using object_storage = std::vector<T,Allocator>;
+    using object_storage = jsoncons::detail::compact_vector<T,Allocator>;
 
     template <class T,class Allocator>
-    using array_storage = std::vector<T,Allocator>;
+    using array_storage = jsoncons::detail::compact_vector<T,Allocator>;
 
     template <class CharT, class CharTraits, class Allocator>
     using key_storage = std::basic_string<CharT, CharTraits,Allocator>;
@@ -60,6 +69,83 @@ struct preserve_order_policy : public sorted_policy
     static const bool preserve_order = true;
 };
 
+// Object member names are basic_shared_keys, which a json_decoder that interns keys
+// shares among all the members with the same name
+
+struct shared_key_policy : public sorted_policy
+{
+    template <class CharT, class CharTraits, class Allocator>
+    using key_storage = basic_shared_key<CharT, CharTraits,Allocator>;
+};
+
+struct preserve_order_shared_key_policy : public shared_key_policy
+{
+    static const bool preserve_order = true;
+};
+
+// Arrays and objects are reference counted, copies share them until one of the
+// copies is modified. Modifying a copy copies only the containers on the path to
+// the change, the untouched members and elements stay shared
+
+struct copy_on_write_policy : public sorted_policy
+{
+    static const bool copy_on_write = true;
+};
+
+struct preserve_order_copy_on_write_policy : public copy_on_write_policy
+{
+    static const bool preserve_order = true;
+};
+
+// Object members are held in chunks of up to 128, so that inserting a new name into a
+// large sorted object moves the members of one chunk rather than all those after it
+
+struct chunked_object_policy : public sorted_policy
+{
+    template <class T,class Allocator>
+    using object_storage = jsoncons::detail::chunked_vector<T,Allocator>;
+};
+
+// Array elements are held in blocks of 256, found through a directory of the blocks, so a
+// large array grows a block at a time, without moving its elements or needing room for them
+// twice, and references to its elements stay valid as it grows. Byte strings are kept whole.
+
+struct chunked_array_policy : public sorted_policy
+{
+    template <class T,class Allocator>
+    using array_storage = typename std::conditional<std::is_same<T,uint8_t>::value,
+                                                    jsoncons::detail::compact_vector<T,Allocator>,
+                                                    jsoncons::detail::block_vector<T,Allocator>>::type;
+};
+
+// Object member names are basic_compact_strings, which hold names of up to 14 characters in
+// place, so objects with short names allocate nothing but their members
+
+struct compact_policy : public sorted_policy
+{
+    template <class CharT, class CharTraits, class Allocator>
+    using key_storage = basic_compact_string<CharT, CharTraits,Allocator>;
+
+    template <class CharT, class CharTraits, class Allocator>
+    using string_storage = basic_compact_string<CharT, CharTraits,Allocator>;
+};
+
+struct preserve_order_compact_policy : public compact_policy
+{
+    static const bool preserve_order = true;
+};
+
+namespace detail {
+
+template <class ImplementationPolicy, class Enable = void>
+struct is_copy_on_write_policy : std::false_type {};
+
+template <class ImplementationPolicy>
+struct is_copy_on_write_policy<ImplementationPolicy,
+                               typename std::enable_if<ImplementationPolicy::copy_on_write>::type> : std::true_type {};
+
+}
+
 template <typename IteratorT>
 class range 
 {
@@ -94,7 +180,48 @@ enum class json_type_tag : uint8_t
     string_t,
     byte_string_t,
     array_t,
-    object_t
+    object_t,
+    string_view_t,
+    small_number_t,
+    number_t,
+    escaped_string_t
+};
+
+// json_memory_usage
+// The heap bytes held by a json value and its descendants, by category, as reported by
+// basic_json::memory_usage(). Bytes are those requested from the allocator, without its
+// own overhead.
+
+struct json_memory_usage
+{
+    // The elements and members of arrays and objects that are in use, and the holders
+    // and hash indexes of arrays, objects and byte strings
+    size_t node_bytes;
+    // The blocks of strings too long to be held in place, and the bytes of byte strings
+    size_t string_bytes;
+    // Object member names too long to be held in place
+    size_t key_bytes;
+    // Capacity of arrays and objects beyond their size, given back by shrink_to_fit()
+    size_t slack_bytes;
+
+    json_memory_usage()
+        : node_bytes(0), string_bytes(0), key_bytes(0), slack_bytes(0)
+    {
+    }
+
+    size_t total() const
+    {
+        return node_bytes + string_bytes + key_bytes + slack_bytes;
+    }
+
+    json_memory_usage& operator+=(const json_memory_usage& other)
+    {
+        node_bytes += other.node_bytes;
+        string_bytes += other.string_bytes;
+        key_bytes += other.key_bytes;
+        slack_bytes += other.slack_bytes;
+        return *this;
+    }
 };
                         
 template <class CharT, 
@@ -282,14 +409,18 @@ public:
 
         class small_string_data : public base_data
         {
+#if defined(JSONCONS_WIDE_SMALL_STRING)
+            static const size_t capacity = 22/sizeof(char_type);
+#else
             static const size_t capacity = 14/sizeof(char_type);
+#endif
             uint8_t length_;
             char_type data_[capacity];
         public:
-            static const size_t max_length = (14 / sizeof(char_type)) - 1;
+            static const size_t max_length = capacity - 1;
 
-            small_string_data(const char_type* p, uint8_t length)
-                : base_data(json_type_tag::small_string_t), length_(length)
+            small_string_data(const char_type* p, uint8_t length, json_type_tag id = json_type_tag::small_string_t)
+                : base_data(id), length_(length)
             {
                 JSONCONS_ASSERT(length <= max_length);
                 std::memcpy(data_,p,length*sizeof(char_type));
@@ -297,7 +428,7 @@ public:
             }
 
             small_string_data(const small_string_data& val)
-                : base_data(json_type_tag::small_string_t), length_(val.length_)
+                : base_data(val.type_id_), length_(val.length_)
             {
                 std::memcpy(data_,val.data_,val.length_*sizeof(char_type));
                 data_[length_] = 0;
@@ -320,60 +451,125 @@ public:
         };
 
         // string_data
+        // A string too long for small_string_data, held in a single block that starts with
+        // the allocator and length and is followed by the null terminated characters.
+        // small_string_data and string_data also hold the text of numbers, with the types
+        // small_number_t and number_t, and string_data the text of strings with escapes not
+        // yet replaced, with the type escaped_string_t. Under copy_on_write_policy the block
+        // also holds a reference count, and copies of the string share it.
         class string_data : public base_data
         {
-            typedef typename std::allocator_traits<Allocator>:: template rebind_alloc<string_storage_type> string_holder_allocator_type;
-            typedef typename std::allocator_traits<string_holder_allocator_type>::pointer pointer;
-
-            pointer ptr_;
-
-            template <typename... Args>
-            void create(string_holder_allocator_type allocator, Args&& ... args)
+            struct header
             {
-                typename std::allocator_traits<Allocator>:: template rebind_alloc<string_storage_type> alloc(allocator);
-                ptr_ = alloc.allocate(1);
-                try
+                Allocator allocator_;
+                size_t length_;
+
+                header(const Allocator& a, size_t length)
+                    : allocator_(a), length_(length)
                 {
-                    std::allocator_traits<string_holder_allocator_type>:: template rebind_traits<string_storage_type>::construct(alloc, to_plain_pointer(ptr_), std::forward<Args>(args)...);
                 }
-                catch (...)
+            };
+
+            // Under copy_on_write_policy copies share the block, which holds a reference count
+            struct shared_header : header
+            {
+                std::atomic<size_t> count_;
+
+                shared_header(const Allocator& a, size_t length)
+                    : header(a, length), count_(1)
                 {
-                    alloc.deallocate(ptr_,1);
-                    throw;
                 }
+            };
+
+            typedef std::integral_constant<bool,detail::is_copy_on_write_policy<ImplementationPolicy>::value> is_shared;
+            typedef typename std::conditional<is_shared::value,shared_header,header>::type block_header;
+
+            // The block is allocated in units with the alignment of the header
+            typedef typename std::aligned_storage<JSONCONS_ALIGNOF(block_header),JSONCONS_ALIGNOF(block_header)>::type storage_unit;
+            typedef typename std::allocator_traits<Allocator>:: template rebind_alloc<storage_unit> storage_allocator_type;
+            typedef typename std::allocator_traits<storage_allocator_type>::pointer pointer;
+
+            pointer ptr_;
+
+            static size_t units_needed(size_t length)
+            {
+                return (sizeof(block_header) + (length+1)*sizeof(char_type) + sizeof(storage_unit) - 1)/sizeof(storage_unit);
+            }
+
+            block_header* get_header() const
+            {
+                return reinterpret_cast<block_header*>(to_plain_pointer(ptr_));
+            }
+
+            char_type* get_chars() const
+            {
+                return reinterpret_cast<char_type*>(reinterpret_cast<char*>(to_plain_pointer(ptr_)) + sizeof(block_header));
+            }
+
+            void create(const char_type* data, size_t length, const Allocator& a)
+            {
+                storage_allocator_type alloc(a);
+                ptr_ = alloc.allocate(units_needed(length));
+                new(reinterpret_cast<void*>(to_plain_pointer(ptr_)))block_header(a, length);
+                char_type* p = get_chars();
+                std::memcpy(p, data, length*sizeof(char_type));
+                p[length] = 0;
+            }
+
+            void copy(const string_data& val, std::false_type)
+            {
+                create(val.data(), val.length(), val.get_allocator());
+            }
+
+            void copy(const string_data& val, std::true_type)
+            {
+                ptr_ = val.ptr_;
+                get_header()->count_.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            bool release(std::false_type)
+            {
+                return true;
+            }
+
+            bool release(std::true_type)
+            {
+                return get_header()->count_.fetch_sub(1, std::memory_order_acq_rel) == 1;
             }
         public:
             string_data(const string_data& val)
-                : base_data(json_type_tag::string_t)
+                : base_data(val.type_id_)
             {
-                create(val.ptr_->get_allocator(), *(val.ptr_));
+                copy(val, is_shared());
             }
 
             string_data(string_data&& val)
-                : base_data(json_type_tag::string_t), ptr_(nullptr)
+                : base_data(val.type_id_), ptr_(nullptr)
             {
                 std::swap(val.ptr_,ptr_);
             }
 
             string_data(const string_data& val, const Allocator& a)
-                : base_data(json_type_tag::string_t)
+                : base_data(val.type_id_)
             {
-                create(string_holder_allocator_type(a), *(val.ptr_), a);
+                create(val.data(), val.length(), a);
             }
 
-            string_data(const char_type* data, size_t length, const Allocator& a)
-                : base_data(json_type_tag::string_t)
+            string_data(const char_type* data, size_t length, const Allocator& a, json_type_tag id = json_type_tag::string_t)
+                : base_data(id)
             {
-                create(string_holder_allocator_type(a), data, length, a);
+                create(data, length, a);
             }
 
             ~string_data()
             {
-                if (ptr_ != nullptr)
+                if (ptr_ != nullptr && release(is_shared()))
                 {
-                    typename std::allocator_traits<string_holder_allocator_type>:: template rebind_alloc<string_storage_type> alloc(ptr_->get_allocator());
-                    std::allocator_traits<string_holder_allocator_type>:: template rebind_traits<string_storage_type>::destroy(alloc, to_plain_pointer(ptr_));
-                    alloc.deallocate(ptr_,1);
+                    block_header* h = get_header();
+                    storage_allocator_type alloc(h->allocator_);
+                    size_t n = units_needed(h->length_);
+                    h->~block_header();
+                    alloc.deallocate(ptr_, n);
                 }
             }
 
@@ -384,22 +580,61 @@ public:
 
             const char_type* data() const
             {
-                return ptr_->data();
+                return get_chars();
             }
 
             const char_type* c_str() const
             {
-                return ptr_->c_str();
+                return get_chars();
             }
 
             size_t length() const
             {
-                return ptr_->length();
+                return get_header()->length_;
+            }
+
+            // Bytes of the block
+            size_t allocated_size() const
+            {
+                return units_needed(length())*sizeof(storage_unit);
             }
 
             allocator_type get_allocator() const
             {
-                return ptr_->get_allocator();
+                return get_header()->allocator_;
+            }
+        };
+
+        // string_view_data
+        // A string that is not owned, a view into a buffer that outlives the value, such as
+        // the memory mapped file or request buffer a document was parsed from. The length is
+        // held in 32 bits, after the type, so that a view is no larger than the other members.
+        class string_view_data : public base_data
+        {
+            uint32_t length_;
+            const char_type* data_;
+        public:
+            static const size_t max_length = 0xffffffff;
+
+            string_view_data(const char_type* data, size_t length)
+                : base_data(json_type_tag::string_view_t), length_(static_cast<uint32_t>(length)), data_(data)
+            {
+                JSONCONS_ASSERT(length <= max_length);
+            }
+
+            string_view_data(const string_view_data& val)
+                : base_data(json_type_tag::string_view_t), length_(val.length_), data_(val.data_)
+            {
+            }
+
+            const char_type* data() const
+            {
+                return data_;
+            }
+
+            size_t length() const
+            {
+                return length_;
             }
         };
 
@@ -476,26 +711,46 @@ public:
                 return ptr_->size();
             }
 
+            // Bytes of the holder
+            static size_t holder_size()
+            {
+                return sizeof(byte_string_storage_type);
+            }
+
+            size_t capacity() const
+            {
+                return ptr_->capacity();
+            }
+
+            void shrink_to_fit()
+            {
+                ptr_->shrink_to_fit();
+            }
+
             allocator_type get_allocator() const
             {
                 return ptr_->get_allocator();
             }
         };
 
-        // array_data
-        class array_data : public base_data
+        // heap_holder
+        // Holds a T allocated with the json value's allocator
+        template <class T>
+        class heap_holder
         {
-            typedef typename std::allocator_traits<array_allocator>::pointer pointer;
-            pointer ptr_;
+            typedef typename std::allocator_traits<Allocator>:: template rebind_alloc<T> holder_allocator_type;
+            typedef typename std::allocator_traits<holder_allocator_type>::pointer pointer;
 
+            pointer ptr_;
+        public:
             template <typename... Args>
-            void create(array_allocator allocator, Args&& ... args)
+            heap_holder(const Allocator& a, Args&& ... args)
             {
-                typename std::allocator_traits<Allocator>:: template rebind_alloc<array> alloc(allocator);
+                holder_allocator_type alloc(a);
                 ptr_ = alloc.allocate(1);
                 try
                 {
-                    std::allocator_traits<array_allocator>:: template rebind_traits<array>::construct(alloc, to_plain_pointer(ptr_), std::forward<Args>(args)...);
+                    std::allocator_traits<holder_allocator_type>::construct(alloc, to_plain_pointer(ptr_), std::forward<Args>(args)...);
                 }
                 catch (...)
                 {
@@ -503,159 +758,364 @@ public:
                     throw;
                 }
             }
+
+            heap_holder(const heap_holder& val)
+                : heap_holder(val.value().get_allocator(), val.value())
+            {
+            }
+
+            heap_holder(heap_holder&& val) JSONCONS_NOEXCEPT
+                : ptr_(nullptr)
+            {
+                std::swap(val.ptr_,ptr_);
+            }
+
+            ~heap_holder()
+            {
+                if (ptr_ != nullptr)
+                {
+                    holder_allocator_type alloc(ptr_->get_allocator());
+                    std::allocator_traits<holder_allocator_type>::destroy(alloc, to_plain_pointer(ptr_));
+                    alloc.deallocate(ptr_,1);
+                }
+            }
+
+            void swap(heap_holder& val)
+            {
+                std::swap(val.ptr_,ptr_);
+            }
+
+            static size_t heap_size()
+            {
+                return sizeof(T);
+            }
+
+            T& value()
+            {
+                return *ptr_;
+            }
+
+            const T& value() const
+            {
+                return *ptr_;
+            }
+
+            bool unique() const
+            {
+                return true;
+            }
+        };
+
+        // inline_holder
+        // Holds a T that is no bigger than a pointer to it in the json value itself
+        template <class T>
+        class inline_holder
+        {
+            T value_;
         public:
-            array_data(const array& val)
-                : base_data(json_type_tag::array_t)
+            template <typename... Args>
+            inline_holder(const Allocator&, Args&& ... args)
+                : value_(std::forward<Args>(args)...)
             {
-                create(val.get_allocator(), val);
             }
 
-            array_data(const array& val, const Allocator& a)
-                : base_data(json_type_tag::array_t)
+            inline_holder(const inline_holder& val)
+                : value_(val.value_)
             {
-                create(array_allocator(a), val, a);
             }
 
-            array_data(const array_data& val)
-                : base_data(json_type_tag::array_t)
+            inline_holder(inline_holder&& val) JSONCONS_NOEXCEPT
+                : value_(std::move(val.value_))
             {
-                create(val.ptr_->get_allocator(), *(val.ptr_));
             }
 
-            array_data(array_data&& val)
-                : base_data(json_type_tag::array_t), ptr_(nullptr)
+            void swap(inline_holder& val)
             {
-                std::swap(val.ptr_, ptr_);
+                value_.swap(val.value_);
             }
 
-            array_data(const array_data& val, const Allocator& a)
-                : base_data(json_type_tag::array_t)
+            static size_t heap_size()
             {
-                create(array_allocator(a), *(val.ptr_), a);
+                return 0;
             }
-            ~array_data()
+
+            T& value()
             {
-                if (ptr_ != nullptr)
+                return value_;
+            }
+
+            const T& value() const
+            {
+                return value_;
+            }
+
+            bool unique() const
+            {
+                return true;
+            }
+        };
+
+        // shared_holder
+        // Holds a reference counted T that copies share, a non-const access copies it
+        // first if it is shared
+        template <class T>
+        class shared_holder
+        {
+            struct block
+            {
+                std::atomic<size_t> count_;
+                T value_;
+
+                template <typename... Args>
+                block(Args&& ... args)
+                    : count_(1), value_(std::forward<Args>(args)...)
                 {
-                    typename std::allocator_traits<array_allocator>:: template rebind_alloc<array> alloc(ptr_->get_allocator());
-                    std::allocator_traits<array_allocator>:: template rebind_traits<array>::destroy(alloc, to_plain_pointer(ptr_));
-                    alloc.deallocate(ptr_,1);
                 }
+            };
+            typedef typename std::allocator_traits<Allocator>:: template rebind_alloc<block> block_allocator_type;
+            typedef typename std::allocator_traits<block_allocator_type>::pointer pointer;
+
+            pointer ptr_;
+        public:
+            template <typename... Args>
+            shared_holder(const Allocator& a, Args&& ... args)
+                : ptr_(create(a, std::forward<Args>(args)...))
+            {
             }
 
-            allocator_type get_allocator() const
+            shared_holder(const shared_holder& val) JSONCONS_NOEXCEPT
+                : ptr_(val.ptr_)
             {
-                return ptr_->get_allocator();
+                ptr_->count_.fetch_add(1, std::memory_order_relaxed);
             }
 
-            void swap(array_data& val)
+            shared_holder(shared_holder&& val) JSONCONS_NOEXCEPT
+                : ptr_(nullptr)
             {
                 std::swap(val.ptr_,ptr_);
             }
 
-            array& value()
+            ~shared_holder()
             {
-                return *ptr_;
+                release(ptr_);
             }
 
-            const array& value() const
+            void swap(shared_holder& val)
             {
-                return *ptr_;
+                std::swap(val.ptr_,ptr_);
             }
-        };
 
-        // object_data
-        class object_data : public base_data
-        {
-            typedef typename std::allocator_traits<object_allocator>::pointer pointer;
-            pointer ptr_;
+            static size_t heap_size()
+            {
+                return sizeof(block);
+            }
+
+            T& value()
+            {
+                if (ptr_->count_.load(std::memory_order_acquire) != 1)
+                {
+                    pointer p = create(ptr_->value_.get_allocator(), static_cast<const T&>(ptr_->value_));
+                    release(ptr_);
+                    ptr_ = p;
+                }
+                return ptr_->value_;
+            }
+
+            const T& value() const
+            {
+                return ptr_->value_;
+            }
 
+            // Whether no copy shares the value, so that value() does not copy it
+            bool unique() const
+            {
+                return ptr_->count_.load(std::memory_order_acquire) == 1;
+            }
+
+        private:
             template <typename... Args>
-            void create(Allocator allocator, Args&& ... args)
+            static pointer create(const Allocator& a, Args&& ... args)
             {
-                typename std::allocator_traits<object_allocator>:: template rebind_alloc<object> alloc(allocator);
-                ptr_ = alloc.allocate(1);
+                block_allocator_type alloc(a);
+                pointer p = alloc.allocate(1);
                 try
                 {
-                    std::allocator_traits<object_allocator>:: template rebind_traits<object>::construct(alloc, to_plain_pointer(ptr_), std::forward<Args>(args)...);
+                    std::allocator_traits<block_allocator_type>::construct(alloc, to_plain_pointer(p), std::forward<Args>(args)...);
                 }
                 catch (...)
                 {
-                    alloc.deallocate(ptr_,1);
+                    alloc.deallocate(p,1);
                     throw;
                 }
+                return p;
+            }
+
+            static void release(pointer p)
+            {
+                if (p != nullptr && p->count_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    block_allocator_type alloc(p->value_.get_allocator());
+                    std::allocator_traits<block_allocator_type>::destroy(alloc, to_plain_pointer(p));
+                    alloc.deallocate(p,1);
+                }
+            }
+        };
+
+        template <class T>
+        using holder_type = typename std::conditional<detail::is_copy_on_write_policy<ImplementationPolicy>::value,
+                                                      shared_holder<T>,
+                                                      typename std::conditional<sizeof(T) <= sizeof(typename std::allocator_traits<Allocator>::pointer),
+                                                                                inline_holder<T>,
+                                                                                heap_holder<T>>::type>::type;
+
+        // array_data
+        class array_data : public base_data
+        {
+            holder_type<array> holder_;
+        public:
+            array_data(const array& val)
+                : base_data(json_type_tag::array_t), holder_(val.get_allocator(), val)
+            {
+            }
+
+            array_data(array&& val)
+                : base_data(json_type_tag::array_t), holder_(val.get_allocator(), std::move(val))
+            {
+            }
+
+            array_data(const array& val, const Allocator& a)
+                : base_data(json_type_tag::array_t), holder_(a, val, a)
+            {
+            }
+
+            template<class InputIterator>
+            array_data(InputIterator first, InputIterator last, const Allocator& a)
+                : base_data(json_type_tag::array_t), holder_(a, first, last, a)
+            {
+            }
+
+            array_data(const array_data& val)
+                : base_data(json_type_tag::array_t), holder_(val.holder_)
+            {
+            }
+
+            array_data(array_data&& val)
+                : base_data(json_type_tag::array_t), holder_(std::move(val.holder_))
+            {
             }
+
+            array_data(const array_data& val, const Allocator& a)
+                : base_data(json_type_tag::array_t), holder_(a, val.value(), a)
+            {
+            }
+
+            allocator_type get_allocator() const
+            {
+                return holder_.value().get_allocator();
+            }
+
+            void swap(array_data& val)
+            {
+                holder_.swap(val.holder_);
+            }
+
+            // Bytes of the holder, zero if the array is held in place
+            static size_t holder_size()
+            {
+                return holder_type<array>::heap_size();
+            }
+
+            array& value()
+            {
+                return holder_.value();
+            }
+
+            const array& value() const
+            {
+                return holder_.value();
+            }
+
+            bool unique() const
+            {
+                return holder_.unique();
+            }
+        };
+
+        // object_data
+        class object_data : public base_data
+        {
+            holder_type<object> holder_;
         public:
             explicit object_data(const Allocator& a)
-                : base_data(json_type_tag::object_t)
+                : base_data(json_type_tag::object_t), holder_(a, a)
             {
-                create(a,a);
             }
 
             explicit object_data(const object& val)
-                : base_data(json_type_tag::object_t)
+                : base_data(json_type_tag::object_t), holder_(val.get_allocator(), val)
+            {
+            }
+
+            explicit object_data(object&& val)
+                : base_data(json_type_tag::object_t), holder_(val.get_allocator(), std::move(val))
             {
-                create(val.get_allocator(), val);
             }
 
             explicit object_data(const object& val, const Allocator& a)
-                : base_data(json_type_tag::object_t)
+                : base_data(json_type_tag::object_t), holder_(a, val, a)
             {
-                create(object_allocator(a), val, a);
             }
 
             explicit object_data(const object_data& val)
-                : base_data(json_type_tag::object_t)
+                : base_data(json_type_tag::object_t), holder_(val.holder_)
             {
-                create(val.ptr_->get_allocator(), *(val.ptr_));
             }
 
             explicit object_data(object_data&& val)
-                : base_data(json_type_tag::object_t), ptr_(nullptr)
+                : base_data(json_type_tag::object_t), holder_(std::move(val.holder_))
             {
-                std::swap(val.ptr_,ptr_);
             }
 
             explicit object_data(const object_data& val, const Allocator& a)
-                : base_data(json_type_tag::object_t)
+                : base_data(json_type_tag::object_t), holder_(a, val.value(), a)
             {
-                create(object_allocator(a), *(val.ptr_), a);
             }
 
-            ~object_data()
+            void swap(object_data& val)
             {
-                if (ptr_ != nullptr)
-                {
-                    typename std::allocator_traits<Allocator>:: template rebind_alloc<object> alloc(ptr_->get_allocator());
-                    std::allocator_traits<Allocator>:: template rebind_traits<object>::destroy(alloc, to_plain_pointer(ptr_));
-                    alloc.deallocate(ptr_,1);
-                }
+                holder_.swap(val.holder_);
             }
 
-            void swap(object_data& val)
+            // Bytes of the holder, zero if the object is held in place
+            static size_t holder_size()
             {
-                std::swap(val.ptr_,ptr_);
+                return holder_type<object>::heap_size();
             }
 
             object& value()
             {
-                return *ptr_;
+                return holder_.value();
             }
 
             const object& value() const
             {
-                return *ptr_;
+                return holder_.value();
+            }
+
+            bool unique() const
+            {
+                return holder_.unique();
             }
 
             allocator_type get_allocator() const
             {
-                return ptr_->get_allocator();
+                return holder_.value().get_allocator();
             }
         };
 
     private:
-        static const size_t data_size = static_max<sizeof(uinteger_data),sizeof(double_data),sizeof(small_string_data), sizeof(string_data), sizeof(array_data), sizeof(object_data)>::value;
-        static const size_t data_align = static_max<JSONCONS_ALIGNOF(uinteger_data),JSONCONS_ALIGNOF(double_data),JSONCONS_ALIGNOF(small_string_data),JSONCONS_ALIGNOF(string_data),JSONCONS_ALIGNOF(array_data),JSONCONS_ALIGNOF(object_data)>::value;
+        static const size_t data_size = static_max<sizeof(uinteger_data),sizeof(double_data),sizeof(small_string_data), sizeof(string_view_data), sizeof(string_data), sizeof(array_data), sizeof(object_data)>::value;
+        static const size_t data_align = static_max<JSONCONS_ALIGNOF(uinteger_data),JSONCONS_ALIGNOF(double_data),JSONCONS_ALIGNOF(small_string_data),JSONCONS_ALIGNOF(string_view_data),JSONCONS_ALIGNOF(string_data),JSONCONS_ALIGNOF(array_data),JSONCONS_ALIGNOF(object_data)>::value;
 
         typedef typename std::aligned_storage<data_size,data_align>::type data_t;
 
@@ -731,6 +1191,45 @@ public:
                 new(reinterpret_cast<void*>(&data_))string_data(s, length, char_allocator_type());
             }
         }
+        explicit variant(const string_view_data& val)
+        {
+            new(reinterpret_cast<void*>(&data_))string_view_data(val);
+        }
+
+        // A number kept as its JSON text, which must be valid
+        static variant number_text(const char_type* s, size_t length, const Allocator& alloc)
+        {
+            variant val{null_type()};
+            if (length <= small_string_data::max_length)
+            {
+                new(reinterpret_cast<void*>(&val.data_))small_string_data(s, static_cast<uint8_t>(length), json_type_tag::small_number_t);
+            }
+            else
+            {
+                new(reinterpret_cast<void*>(&val.data_))string_data(s, length, alloc, json_type_tag::number_t);
+            }
+            return val;
+        }
+
+        // A string kept as the text between the quotation marks of a JSON string, with its
+        // escapes, which must be valid. Text short enough for small_string_data is unescaped
+        // at once, as it is no cheaper to keep.
+        static variant escaped_string(const char_type* s, size_t length, const Allocator& alloc)
+        {
+            variant val{null_type()};
+            if (length <= small_string_data::max_length)
+            {
+                std::basic_string<char_type> buf;
+                detail::unescape_string(s, length, buf);
+                new(reinterpret_cast<void*>(&val.data_))small_string_data(buf.data(), static_cast<uint8_t>(buf.length()));
+            }
+            else
+            {
+                new(reinterpret_cast<void*>(&val.data_))string_data(s, length, alloc, json_type_tag::escaped_string_t);
+            }
+            return val;
+        }
+
         variant(const uint8_t* s, size_t length)
         {
             new(reinterpret_cast<void*>(&data_))byte_string_data(s, length, byte_allocator_type());
@@ -782,6 +1281,10 @@ public:
         {
             new(reinterpret_cast<void*>(&data_))object_data(val);
         }
+        variant(object&& val)
+        {
+            new(reinterpret_cast<void*>(&data_))object_data(std::move(val));
+        }
         variant(const object& val, const Allocator& alloc)
         {
             new(reinterpret_cast<void*>(&data_))object_data(val, alloc);
@@ -790,6 +1293,10 @@ public:
         {
             new(reinterpret_cast<void*>(&data_))array_data(val);
         }
+        variant(array&& val)
+        {
+            new(reinterpret_cast<void*>(&data_))array_data(std::move(val));
+        }
         variant(const array& val, const Allocator& alloc)
         {
             new(reinterpret_cast<void*>(&data_))array_data(val,alloc);
@@ -810,19 +1317,32 @@ public:
             switch (type_id())
             {
             case json_type_tag::string_t:
+            case json_type_tag::number_t:
+            case json_type_tag::escaped_string_t:
                 reinterpret_cast<string_data*>(&data_)->~string_data();
                 break;
             case json_type_tag::byte_string_t:
                 reinterpret_cast<byte_string_data*>(&data_)->~byte_string_data();
                 break;
             case json_type_tag::object_t:
-                reinterpret_cast<object_data*>(&data_)->~object_data();
-                break;
             case json_type_tag::array_t:
+                Destroy_nested_();
+                Destroy_container_();
+                break;
+            default:
+                break;
+            }
+        }
+
+        void Destroy_container_()
+        {
+            if (type_id() == json_type_tag::array_t)
+            {
                 reinterpret_cast<array_data*>(&data_)->~array_data();
-                break;
-            default:
-                break;
+            }
+            else
+            {
+                reinterpret_cast<object_data*>(&data_)->~object_data();
             }
         }
 
@@ -852,19 +1372,23 @@ public:
                     new(reinterpret_cast<void*>(&data_))double_data(*(val.double_data_cast()));
                     break;
                 case json_type_tag::small_string_t:
+                case json_type_tag::small_number_t:
                     new(reinterpret_cast<void*>(&data_))small_string_data(*(val.small_string_data_cast()));
                     break;
+                case json_type_tag::string_view_t:
+                    new(reinterpret_cast<void*>(&data_))string_view_data(*(val.string_view_data_cast()));
+                    break;
                 case json_type_tag::string_t:
+                case json_type_tag::number_t:
+                case json_type_tag::escaped_string_t:
                     new(reinterpret_cast<void*>(&data_))string_data(*(val.string_data_cast()));
                     break;
                 case json_type_tag::byte_string_t:
                     new(reinterpret_cast<void*>(&data_))byte_string_data(*(val.byte_string_data_cast()));
                     break;
                 case json_type_tag::array_t:
-                    new(reinterpret_cast<void*>(&data_))array_data(*(val.array_data_cast()));
-                    break;
                 case json_type_tag::object_t:
-                    new(reinterpret_cast<void*>(&data_))object_data(*(val.object_data_cast()));
+                    Init_container_(val);
                     break;
                 default:
                     JSONCONS_UNREACHABLE();
@@ -935,6 +1459,11 @@ public:
             return reinterpret_cast<const string_data*>(&data_);
         }
 
+        const string_view_data* string_view_data_cast() const
+        {
+            return reinterpret_cast<const string_view_data*>(&data_);
+        }
+
         byte_string_data* byte_string_data_cast()
         {
             return reinterpret_cast<byte_string_data*>(&data_);
@@ -973,11 +1502,36 @@ public:
                 return string_view_type(small_string_data_cast()->data(),small_string_data_cast()->length());
             case json_type_tag::string_t:
                 return string_view_type(string_data_cast()->data(),string_data_cast()->length());
+            case json_type_tag::string_view_t:
+                return string_view_type(string_view_data_cast()->data(),string_view_data_cast()->length());
+            case json_type_tag::escaped_string_t:
+                unescape();
+                return string_view_type(string_data_cast()->data(),string_data_cast()->length());
             default:
                 JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a string");
             }
         }
 
+        // Replaces the escaped text of an escaped_string_t with the string it stands for, on
+        // first access. A value is changed by a read, so the first read of an escaped string
+        // must not race with others.
+        void unescape() const
+        {
+            const string_data* raw = string_data_cast();
+            std::basic_string<char_type> buf;
+            buf.reserve(raw->length());
+            detail::unescape_string(raw->data(), raw->length(), buf);
+            string_data temp(buf.data(), buf.length(), raw->get_allocator());
+            variant* self = const_cast<variant*>(this);
+            self->Destroy_();
+            new(reinterpret_cast<void*>(&self->data_))string_data(std::move(temp));
+        }
+
+        string_view_type escaped_string_view() const
+        {
+            return string_view_type(string_data_cast()->data(),string_data_cast()->length());
+        }
+
         byte_string_view as_byte_string_view() const
         {
             switch (type_id())
@@ -989,12 +1543,48 @@ public:
             }
         }
 
+        bool is_number_text() const
+        {
+            return type_id() == json_type_tag::small_number_t || type_id() == json_type_tag::number_t;
+        }
+
+        string_view_type number_text_view() const
+        {
+            return type_id() == json_type_tag::small_number_t
+                ? string_view_type(small_string_data_cast()->data(),small_string_data_cast()->length())
+                : string_view_type(string_data_cast()->data(),string_data_cast()->length());
+        }
+
+        // The integer, unsigned integer or double that a number held as text converts to
+        variant number_text_value() const
+        {
+            string_view_type text = number_text_view();
+            detail::number_text_value value = detail::read_number_text(text.data(), text.length());
+            switch (value.kind)
+            {
+            case detail::number_text_kind::integer:
+                return variant(value.integer);
+            case detail::number_text_kind::uinteger:
+                return variant(value.uinteger);
+            default:
+                return variant(value.floating_point, value.precision);
+            }
+        }
+
         bool operator==(const variant& rhs) const
         {
             if (this ==&rhs)
             {
                 return true;
             }
+            if (is_number_text() || rhs.is_number_text())
+            {
+                if (is_number_text() && rhs.is_number_text() && number_text_view() == rhs.number_text_view())
+                {
+                    return true;
+                }
+                return (is_number_text() ? number_text_value() : *this) == (rhs.is_number_text() ? rhs.number_text_value() : rhs);
+            }
             switch (type_id())
             {
             case json_type_tag::null_t:
@@ -1066,11 +1656,15 @@ public:
                 }
                 break;
             case json_type_tag::small_string_t:
+            case json_type_tag::string_t:
+            case json_type_tag::string_view_t:
+            case json_type_tag::escaped_string_t:
                 switch (rhs.type_id())
                 {
                 case json_type_tag::small_string_t:
-                    return as_string_view() == rhs.as_string_view();
                 case json_type_tag::string_t:
+                case json_type_tag::string_view_t:
+                case json_type_tag::escaped_string_t:
                     return as_string_view() == rhs.as_string_view();
                 default:
                     return false;
@@ -1087,22 +1681,11 @@ public:
                     return false;
                 }
                 break;
-            case json_type_tag::string_t:
-                switch (rhs.type_id())
-                {
-                case json_type_tag::small_string_t:
-                    return as_string_view() == rhs.as_string_view();
-                case json_type_tag::string_t:
-                    return as_string_view() == rhs.as_string_view();
-                default:
-                    return false;
-                }
-                break;
             case json_type_tag::array_t:
                 switch (rhs.type_id())
                 {
                 case json_type_tag::array_t:
-                    return array_data_cast()->value() == rhs.array_data_cast()->value();
+                    return equal_containers(*this, rhs);
                 default:
                     return false;
                 }
@@ -1113,7 +1696,7 @@ public:
                 case json_type_tag::empty_object_t:
                     return object_data_cast()->value().size() == 0;
                 case json_type_tag::object_t:
-                    return object_data_cast()->value() == rhs.object_data_cast()->value();
+                    return equal_containers(*this, rhs);
                 default:
                     return false;
                 }
@@ -1149,6 +1732,27 @@ public:
             {
                 return;
             }
+            if (type_id() == json_type_tag::string_view_t || other.type_id() == json_type_tag::string_view_t)
+            {
+                // A view is trivially copyable, so move the other value into its place
+                variant& view = type_id() == json_type_tag::string_view_t ? *this : other;
+                variant& rest = type_id() == json_type_tag::string_view_t ? other : *this;
+                string_view_data temp(*view.string_view_data_cast());
+                view.Init_rv_(std::move(rest));
+                rest.Destroy_();
+                new(reinterpret_cast<void*>(&(rest.data_)))string_view_data(temp);
+                return;
+            }
+            if (is_number_text() || other.is_number_text() ||
+                type_id() == json_type_tag::escaped_string_t || other.type_id() == json_type_tag::escaped_string_t)
+            {
+                variant temp(std::move(other));
+                other.Destroy_();
+                other.Init_rv_(std::move(*this));
+                Destroy_();
+                Init_rv_(std::move(temp));
+                return;
+            }
             switch (type_id())
             {
             case json_type_tag::null_t:
@@ -1787,53 +2391,381 @@ public:
                 new(reinterpret_cast<void*>(&data_))double_data(*(val.double_data_cast()));
                 break;
             case json_type_tag::small_string_t:
+            case json_type_tag::small_number_t:
                 new(reinterpret_cast<void*>(&data_))small_string_data(*(val.small_string_data_cast()));
                 break;
+            case json_type_tag::string_view_t:
+                new(reinterpret_cast<void*>(&data_))string_view_data(*(val.string_view_data_cast()));
+                break;
             case json_type_tag::string_t:
+            case json_type_tag::number_t:
+            case json_type_tag::escaped_string_t:
                 new(reinterpret_cast<void*>(&data_))string_data(*(val.string_data_cast()));
                 break;
             case json_type_tag::byte_string_t:
                 new(reinterpret_cast<void*>(&data_))byte_string_data(*(val.byte_string_data_cast()));
                 break;
             case json_type_tag::object_t:
-                new(reinterpret_cast<void*>(&data_))object_data(*(val.object_data_cast()));
+            case json_type_tag::array_t:
+                Init_container_(val);
+                break;
+            default:
+                break;
+            }
+        }
+
+        void Init_(const variant& val, const Allocator& a)
+        {
+            switch (val.type_id())
+            {
+            case json_type_tag::null_t:
+            case json_type_tag::empty_object_t:
+            case json_type_tag::bool_t:
+            case json_type_tag::integer_t:
+            case json_type_tag::uinteger_t:
+            case json_type_tag::double_t:
+            case json_type_tag::small_string_t:
+            case json_type_tag::string_view_t:
+            case json_type_tag::small_number_t:
+                Init_(val);
+                break;
+            case json_type_tag::string_t:
+            case json_type_tag::number_t:
+            case json_type_tag::escaped_string_t:
+                new(reinterpret_cast<void*>(&data_))string_data(*(val.string_data_cast()),a);
+                break;
+            case json_type_tag::byte_string_t:
+                new(reinterpret_cast<void*>(&data_))byte_string_data(*(val.byte_string_data_cast()),a);
                 break;
             case json_type_tag::array_t:
-                new(reinterpret_cast<void*>(&data_))array_data(*(val.array_data_cast()));
+                new(reinterpret_cast<void*>(&data_))array_data(*(val.array_data_cast()),a);
+                break;
+            case json_type_tag::object_t:
+                new(reinterpret_cast<void*>(&data_))object_data(*(val.object_data_cast()),a);
                 break;
             default:
                 break;
             }
         }
 
-        void Init_(const variant& val, const Allocator& a)
+        // Arrays and objects are copied, compared and destroyed by recursion to a depth of
+        // max_recursion_depth, and from an explicit stack below that, so that a document too
+        // deep for the call stack can still be copied, compared and destroyed. Copies recurse
+        // through the constructors, and count their depth per thread.
+
+        static const size_t max_recursion_depth = 64;
+
+        typedef std::pair<basic_json*,const basic_json*> copy_item;
+        typedef std::pair<const variant*,const variant*> compare_item;
+
+        bool is_container() const
+        {
+            return type_id() == json_type_tag::array_t || type_id() == json_type_tag::object_t;
+        }
+
+        bool has_children() const
+        {
+            switch (type_id())
+            {
+            case json_type_tag::array_t:
+                return array_data_cast()->value().size() > 0;
+            case json_type_tag::object_t:
+                return object_data_cast()->value().size() > 0;
+            default:
+                return false;
+            }
+        }
+
+        // An empty array or object of the kind of val, with its allocator
+        static basic_json empty_container(const variant& val)
+        {
+            if (val.type_id() == json_type_tag::array_t)
+            {
+                return basic_json(array(val.array_data_cast()->get_allocator()));
+            }
+            else
+            {
+                return basic_json(object(val.object_data_cast()->get_allocator()));
+            }
+        }
+
+        struct depth_guard
+        {
+            size_t& depth;
+
+            depth_guard(size_t& d)
+                : depth(d)
+            {
+                ++depth;
+            }
+
+            ~depth_guard()
+            {
+                --depth;
+            }
+        };
+
+#if !defined(JSONCONS_NO_THREAD_LOCAL)
+        // The depth of the arrays and objects being copied by recursion on this thread
+        static size_t& copy_depth()
+        {
+            static thread_local size_t depth = 0;
+            return depth;
+        }
+#endif
+
+        // Copies the array or object val. Under copy_on_write_policy the copy shares it.
+        void Init_container_(const variant& val)
+        {
+            if (detail::is_copy_on_write_policy<ImplementationPolicy>::value)
+            {
+                Init_container_copy_(val);
+                return;
+            }
+#if !defined(JSONCONS_NO_THREAD_LOCAL)
+            if (copy_depth() < max_recursion_depth)
+            {
+                depth_guard guard(copy_depth());
+                Init_container_copy_(val);
+                return;
+            }
+#endif
+            if (val.type_id() == json_type_tag::array_t)
+            {
+                new(reinterpret_cast<void*>(&data_))array_data(array(val.array_data_cast()->get_allocator()));
+            }
+            else
+            {
+                new(reinterpret_cast<void*>(&data_))object_data(object(val.object_data_cast()->get_allocator()));
+            }
+            try
+            {
+                std::vector<copy_item> stack;
+                copy_children(*this, val, stack);
+                while (!stack.empty())
+                {
+                    copy_item item = stack.back();
+                    stack.pop_back();
+                    copy_children(item.first->var_, item.second->var_, stack);
+                }
+            }
+            catch (...)
+            {
+                Destroy_();
+                new(reinterpret_cast<void*>(&data_))null_data();
+                throw;
+            }
+        }
+
+        void Init_container_copy_(const variant& val)
+        {
+            if (val.type_id() == json_type_tag::array_t)
+            {
+                new(reinterpret_cast<void*>(&data_))array_data(*(val.array_data_cast()));
+            }
+            else
+            {
+                new(reinterpret_cast<void*>(&data_))object_data(*(val.object_data_cast()));
+            }
+        }
+
+        // Copies the children of src into the empty array or object dest, with empty arrays
+        // and objects in place of those that have children, which are pushed on stack with
+        // their sources to be filled in
+        static void copy_children(variant& dest, const variant& src, std::vector<copy_item>& stack)
+        {
+            if (src.type_id() == json_type_tag::array_t)
+            {
+                const array& from = src.array_data_cast()->value();
+                array& to = dest.array_data_cast()->value();
+                to.reserve(from.size());
+                for (const auto& item : from)
+                {
+                    if (item.var_.has_children())
+                    {
+                        to.emplace_back(empty_container(item.var_));
+                    }
+                    else
+                    {
+                        to.emplace_back(item);
+                    }
+                }
+                for (size_t i = 0; i < from.size(); ++i)
+                {
+                    if (from[i].var_.has_children())
+                    {
+                        stack.emplace_back(&to[i], &from[i]);
+                    }
+                }
+            }
+            else
+            {
+                typedef typename object::value_type member_type;
+                const object& from = src.object_data_cast()->value();
+                object& to = dest.object_data_cast()->value();
+                to.insert_unique(from.begin(), from.end(), 
+                                 [](const member_type& member)
+                                 {
+                                     return member.value().var_.has_children() 
+                                         ? member_type(member, empty_container(member.value().var_)) 
+                                         : member_type(member);
+                                 });
+                auto it = to.begin();
+                for (auto from_it = from.begin(); from_it != from.end(); ++from_it, ++it)
+                {
+                    if (from_it->value().var_.has_children())
+                    {
+                        stack.emplace_back(&(it->value()), &(from_it->value()));
+                    }
+                }
+            }
+        }
+
+        // Destroys the arrays and objects with children in this one, leaving nulls in their
+        // place. Does nothing for an array or object that a copy shares. If the stack cannot
+        // grow, what is left is destroyed by the destructors.
+        void Destroy_nested_() JSONCONS_NOEXCEPT
+        {
+            std::vector<basic_json> stack;
+            try
+            {
+                destroy_children(*this, 0, stack);
+                while (!stack.empty())
+                {
+                    basic_json val(std::move(stack.back()));
+                    stack.pop_back();
+                    destroy_children(val.var_, 0, stack);
+                    val.var_.Destroy_container_();
+                    new(reinterpret_cast<void*>(&val.var_.data_))null_data();
+                }
+            }
+            catch (...)
+            {
+            }
+        }
+
+        static void destroy_children(variant& var, size_t depth, std::vector<basic_json>& stack)
+        {
+            if (var.type_id() == json_type_tag::array_t)
+            {
+                if (var.array_data_cast()->unique())
+                {
+                    for (auto& item : var.array_data_cast()->value())
+                    {
+                        destroy_child(item, depth, stack);
+                    }
+                }
+            }
+            else if (var.object_data_cast()->unique())
+            {
+                for (auto& member : var.object_data_cast()->value())
+                {
+                    destroy_child(member.value(), depth, stack);
+                }
+            }
+        }
+
+        static void destroy_child(basic_json& val, size_t depth, std::vector<basic_json>& stack)
+        {
+            if (!val.var_.has_children())
+            {
+                return;
+            }
+            if (depth < max_recursion_depth)
+            {
+                destroy_children(val.var_, depth + 1, stack);
+                val.var_.Destroy_container_();
+                new(reinterpret_cast<void*>(&val.var_.data_))null_data();
+            }
+            else
+            {
+                stack.emplace_back(std::move(val));
+            }
+        }
+
+        // Compares the arrays or objects a and b, which are of the same kind
+        static bool equal_containers(const variant& a, const variant& b)
+        {
+            std::vector<compare_item> stack;
+            if (!equal_children(a, b, 0, stack))
+            {
+                return false;
+            }
+            while (!stack.empty())
+            {
+                compare_item item = stack.back();
+                stack.pop_back();
+                if (!equal_children(*item.first, *item.second, 0, stack))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static bool equal_children(const variant& a, const variant& b, size_t depth, std::vector<compare_item>& stack)
+        {
+            if (a.type_id() == json_type_tag::array_t)
+            {
+                const array& x = a.array_data_cast()->value();
+                const array& y = b.array_data_cast()->value();
+                if (&x == &y)
+                {
+                    return true;
+                }
+                if (x.size() != y.size())
+                {
+                    return false;
+                }
+                for (size_t i = 0; i < x.size(); ++i)
+                {
+                    if (!equal_child(x[i].var_, y[i].var_, depth, stack))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            else
+            {
+                const object& x = a.object_data_cast()->value();
+                const object& y = b.object_data_cast()->value();
+                if (&x == &y)
+                {
+                    return true;
+                }
+                if (x.size() != y.size())
+                {
+                    return false;
+                }
+                // Equal objects usually have their members in the same order, and sorted
+                // objects always do, so the member in the same position is tried before
+                // looking the name up
+                auto same_position = y.begin();
+                for (auto it = x.begin(); it != x.end(); ++it, ++same_position)
+                {
+                    auto y_it = same_position->key_equals(*it) ? same_position : y.find(it->key());
+                    if (y_it == y.end() || !equal_child(it->value().var_, y_it->value().var_, depth, stack))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        }
+
+        static bool equal_child(const variant& a, const variant& b, size_t depth, std::vector<compare_item>& stack)
         {
-            switch (val.type_id())
+            if (!a.is_container() || a.type_id() != b.type_id())
             {
-            case json_type_tag::null_t:
-            case json_type_tag::empty_object_t:
-            case json_type_tag::bool_t:
-            case json_type_tag::integer_t:
-            case json_type_tag::uinteger_t:
-            case json_type_tag::double_t:
-            case json_type_tag::small_string_t:
-                Init_(val);
-                break;
-            case json_type_tag::string_t:
-                new(reinterpret_cast<void*>(&data_))string_data(*(val.string_data_cast()),a);
-                break;
-            case json_type_tag::byte_string_t:
-                new(reinterpret_cast<void*>(&data_))byte_string_data(*(val.byte_string_data_cast()),a);
-                break;
-            case json_type_tag::array_t:
-                new(reinterpret_cast<void*>(&data_))array_data(*(val.array_data_cast()),a);
-                break;
-            case json_type_tag::object_t:
-                new(reinterpret_cast<void*>(&data_))object_data(*(val.object_data_cast()),a);
-                break;
-            default:
-                break;
+                return a == b;
+            }
+            if (depth < max_recursion_depth)
+            {
+                return equal_children(a, b, depth + 1, stack);
             }
+            stack.emplace_back(&a, &b);
+            return true;
         }
 
         void Init_rv_(variant&& val) JSONCONS_NOEXCEPT
@@ -1847,9 +2779,13 @@ public:
             case json_type_tag::uinteger_t:
             case json_type_tag::bool_t:
             case json_type_tag::small_string_t:
+            case json_type_tag::string_view_t:
+            case json_type_tag::small_number_t:
                 Init_(val);
                 break;
             case json_type_tag::string_t:
+            case json_type_tag::number_t:
+            case json_type_tag::escaped_string_t:
                 {
                     new(reinterpret_cast<void*>(&data_))string_data(std::move(*val.string_data_cast()));
                     new(reinterpret_cast<void*>(&val.data_))null_data();
@@ -1895,9 +2831,13 @@ public:
             case json_type_tag::uinteger_t:
             case json_type_tag::bool_t:
             case json_type_tag::small_string_t:
+            case json_type_tag::string_view_t:
+            case json_type_tag::small_number_t:
                 Init_(std::forward<variant>(val));
                 break;
             case json_type_tag::string_t:
+            case json_type_tag::number_t:
+            case json_type_tag::escaped_string_t:
                 {
                     if (a == val.string_data_cast()->get_allocator())
                     {
@@ -1957,34 +2897,48 @@ public:
     private:
         typedef json_proxy<ParentT> proxy_type;
 
+        // A proxy lasts until the end of the full-expression that made it, as the parent of a
+        // chained proxy is a temporary of that expression, so the name refers to the argument
+        // of operator[] and is only copied into a key when a write adds the member. A const
+        // read is looked up through the parent's const overloads, so that it does not detach
+        // storage shared by copy_on_write_policy, and the value it resolves to is remembered
+        // until a non-const access through the proxy.
         ParentT& parent_;
-        key_storage_type key_;
+        string_view_type key_;
+        mutable const basic_json* cached_;
 
         json_proxy() = delete;
         json_proxy& operator = (const json_proxy& other) = delete; 
 
-        json_proxy(ParentT& parent, key_storage_type&& name)
-            : parent_(parent), key_(std::forward<key_storage_type>(name))
+        json_proxy(ParentT& parent, const string_view_type& name)
+            : parent_(parent), key_(name), cached_(nullptr)
         {
         }
 
         basic_json& evaluate() 
         {
-            return parent_.evaluate(string_view_type(key_.data(),key_.size()));
+            cached_ = nullptr;
+            return parent_.evaluate(key_);
         }
 
         const basic_json& evaluate() const
         {
-            return parent_.evaluate(string_view_type(key_.data(),key_.size()));
+            if (cached_ == nullptr)
+            {
+                cached_ = &static_cast<const ParentT&>(parent_).evaluate(key_);
+            }
+            return *cached_;
         }
 
         basic_json& evaluate_with_default()
         {
+            cached_ = nullptr;
             basic_json& val = parent_.evaluate_with_default();
-            auto it = val.find(string_view_type(key_.data(),key_.size()));
+            auto it = val.find(key_);
             if (it == val.object_range().end())
             {
-                it = val.set_(val.object_range().begin(),std::move(key_),object(val.object_value().get_allocator()));            
+                key_storage_type key(key_.begin(),key_.end(),char_allocator_type(val.object_value().get_allocator()));
+                it = val.set_(val.object_range().begin(),std::move(key),object(val.object_value().get_allocator()));            
             }
             return it->value();
         }
@@ -2094,6 +3048,11 @@ public:
             return evaluate().is_string();
         }
 
+        bool is_string_view() const JSONCONS_NOEXCEPT
+        {
+            return evaluate().is_string_view();
+        }
+
         bool is_byte_string() const JSONCONS_NOEXCEPT
         {
             return evaluate().is_byte_string();
@@ -2132,6 +3091,16 @@ public:
             return evaluate().is_double();
         }
 
+        bool is_number_text() const JSONCONS_NOEXCEPT
+        {
+            return evaluate().is_number_text();
+        }
+
+        string_view_type number_text() const
+        {
+            return evaluate().number_text();
+        }
+
         string_view_type as_string_view() const 
         {
             return evaluate().as_string_view();
@@ -2205,7 +3174,8 @@ public:
         template <class T>
         json_proxy& operator=(T&& val) 
         {
-            parent_.evaluate_with_default().set_(std::move(key_), std::forward<T>(val));
+            cached_ = nullptr;
+            parent_.evaluate_with_default().insert_or_assign(key_, std::forward<T>(val));
             return *this;
         }
 
@@ -2231,7 +3201,7 @@ public:
 
         json_proxy<proxy_type> operator[](const string_view_type& name)
         {
-            return json_proxy<proxy_type>(*this,key_storage_type(name.begin(),name.end(),key_.get_allocator()));
+            return json_proxy<proxy_type>(*this,name);
         }
 
         const basic_json& operator[](const string_view_type& name) const
@@ -2259,6 +3229,36 @@ public:
             return evaluate().at(index);
         }
 
+        const basic_json& at(const string_view_type& name, std::error_code& ec) const
+        {
+            const basic_json& val = parent_.at(key_, ec);
+            return ec ? val : val.at(name, ec);
+        }
+
+        const basic_json& at(size_t index, std::error_code& ec) const
+        {
+            const basic_json& val = parent_.at(key_, ec);
+            return ec ? val : val.at(index, ec);
+        }
+
+        // A member that is missing sets ec to json_errc::key_not_found
+        template<class T>
+        T try_as(std::error_code& ec) const
+        {
+            const basic_json& val = parent_.at(key_, ec);
+            return ec ? T() : val.template try_as<T>(ec);
+        }
+
+#if defined(JSONCONS_HAS_OPTIONAL)
+        template<class T>
+        std::optional<T> as_optional() const
+        {
+            std::error_code ec;
+            const basic_json& val = parent_.at(key_, ec);
+            return ec ? std::nullopt : val.template as_optional<T>();
+        }
+#endif
+
         object_iterator find(const string_view_type& name)
         {
             return evaluate().find(name);
@@ -2286,6 +3286,11 @@ public:
             return evaluate().get_with_default(name,default_val);
         }
 
+        json_memory_usage memory_usage() const
+        {
+            return evaluate().memory_usage();
+        }
+
         void shrink_to_fit()
         {
             evaluate_with_default().shrink_to_fit();
@@ -2481,6 +3486,17 @@ public:
             evaluate().dump(handler);
         }
 
+        size_t dump(char_type* data, size_t capacity) const
+        {
+            return evaluate().dump(data, capacity);
+        }
+
+        size_t dump(char_type* data, size_t capacity,
+                    const basic_serialization_options<char_type>& options) const
+        {
+            return evaluate().dump(data, capacity, options);
+        }
+
         void dump(std::basic_ostream<char_type>& os) const
         {
             evaluate().dump(os);
@@ -2719,14 +3735,22 @@ public:
 
     static basic_json parse(const string_view_type& s)
     {
+#if !defined(JSONCONS_NO_THREAD_LOCAL)
+        // Reuses this thread's parser and decoder, unless they are in use further up the stack
+        static thread_local reusable_parse_state state;
+        if (!state.in_use_)
+        {
+            typename reusable_parse_state::use_guard guard(state);
+            return parse(s, state.decoder_, state.parser_);
+        }
+#endif
         parse_error_handler_type err_handler;
         return parse(s,err_handler);
     }
 
     static basic_json parse(const char_type* s, size_t length)
     {
-        parse_error_handler_type err_handler;
-        return parse(s,length,err_handler);
+        return parse(string_view_type(s,length));
     }
 
     static basic_json parse(const char_type* s, size_t length, parse_error_handler& err_handler)
@@ -2738,22 +3762,7 @@ public:
     {
         json_decoder<basic_json> handler;
         basic_json_parser<char_type> parser(handler,err_handler);
-
-        auto result = unicons::skip_bom(s.begin(), s.end());
-        if (result.ec != unicons::encoding_errc())
-        {
-            throw parse_error(result.ec,1,1);
-        }
-        size_t offset = result.it - s.begin();
-        parser.set_source(s.data()+offset,s.size()-offset);
-        parser.parse();
-        parser.end_parse();
-        parser.check_done();
-        if (!handler.is_valid())
-        {
-            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Failed to parse json string");
-        }
-        return handler.get_result();
+        return parse(s, handler, parser);
     }
 
     static basic_json parse_file(const std::basic_string<char_type,char_traits_type>& filename)
@@ -2769,6 +3778,13 @@ public:
         return parse(is,err_handler);
     }
 
+    // Makes a string that is a view into s, which must outlive the value and every copy
+    // of it. The characters are neither copied nor freed. There may be at most 2^32-1 of them.
+    static basic_json make_string_view(const string_view_type& s)
+    {
+        return basic_json(variant(typename variant::string_view_data(s.data(), s.length())));
+    }
+
     static basic_json make_array()
     {
         return basic_json(variant(array()));
@@ -2984,6 +4000,18 @@ public:
         return *this;
     }
 
+    basic_json& operator=(array&& val)
+    {
+        var_ = variant(std::move(val));
+        return *this;
+    }
+
+    basic_json& operator=(object&& val)
+    {
+        var_ = variant(std::move(val));
+        return *this;
+    }
+
     template <class T>
     basic_json& operator=(const T& val)
     {
@@ -3040,7 +4068,7 @@ public:
             create_object_implicitly();
             // FALLTHRU
         case json_type_tag::object_t:
-            return json_proxy<basic_json>(*this, key_storage_type(name.begin(),name.end(),char_allocator_type(object_value().get_allocator())));
+            return json_proxy<basic_json>(*this, name);
             break;
         default:
             JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an object");
@@ -3056,26 +4084,47 @@ public:
     template <class SAllocator>
     void dump(std::basic_string<char_type,char_traits_type,SAllocator>& s) const
     {
-        std::basic_ostringstream<char_type,char_traits_type,SAllocator> os;
-        os.imbue(std::locale::classic());
+        s.clear();
+        basic_string_sink<std::basic_string<char_type,char_traits_type,SAllocator>> sink(s);
         {
-            basic_json_serializer<char_type> serializer(os);
+            basic_json_serializer<char_type> serializer(sink);
             dump(serializer);
         }
-        s = os.str();
     }
 
     template <class SAllocator>
     void dump(std::basic_string<char_type,char_traits_type,SAllocator>& s,
               const basic_serialization_options<char_type>& options) const
     {
-        std::basic_ostringstream<char_type,char_traits_type,SAllocator> os;
-        os.imbue(std::locale::classic());
+        s.clear();
+        basic_string_sink<std::basic_string<char_type,char_traits_type,SAllocator>> sink(s);
+        {
+            basic_json_serializer<char_type> serializer(sink,options);
+            dump(serializer);
+        }
+    }
+
+    // Writes at most capacity characters to data, and returns the length of the whole
+    // output. If that is greater than capacity, the output was truncated.
+    size_t dump(char_type* data, size_t capacity) const
+    {
+        basic_buffer_sink<char_type> sink(data, capacity);
+        {
+            basic_json_serializer<char_type> serializer(sink);
+            dump(serializer);
+        }
+        return sink.required_size();
+    }
+
+    size_t dump(char_type* data, size_t capacity,
+                const basic_serialization_options<char_type>& options) const
+    {
+        basic_buffer_sink<char_type> sink(data, capacity);
         {
-            basic_json_serializer<char_type> serializer(os,options);
+            basic_json_serializer<char_type> serializer(sink, options);
             dump(serializer);
         }
-        s = os.str();
+        return sink.required_size();
     }
 
 #if !defined(JSONCONS_NO_DEPRECATED)
@@ -3090,8 +4139,12 @@ public:
         {
         case json_type_tag::small_string_t:
         case json_type_tag::string_t:
+        case json_type_tag::string_view_t:
             handler.string_value(as_string_view());
             break;
+        case json_type_tag::escaped_string_t:
+            handler.escaped_string_value(var_.escaped_string_view());
+            break;
         case json_type_tag::byte_string_t:
             handler.byte_string_value(var_.byte_string_data_cast()->data(), var_.byte_string_data_cast()->length());
             break;
@@ -3104,6 +4157,10 @@ public:
         case json_type_tag::uinteger_t:
             handler.uinteger_value(var_.uinteger_data_cast()->value());
             break;
+        case json_type_tag::small_number_t:
+        case json_type_tag::number_t:
+            handler.number_value(var_.number_text_view());
+            break;
         case json_type_tag::bool_t:
             handler.bool_value(var_.bool_data_cast()->value());
             break;
@@ -3175,26 +4232,24 @@ public:
     string_type to_string(const char_allocator_type& allocator=char_allocator_type()) const JSONCONS_NOEXCEPT
     {
         string_type s(allocator);
-        std::basic_ostringstream<char_type,char_traits_type,char_allocator_type> os(s);
-        os.imbue(std::locale::classic());
+        basic_string_sink<string_type> sink(s);
         {
-            basic_json_serializer<char_type> serializer(os);
+            basic_json_serializer<char_type> serializer(sink);
             dump_fragment(serializer);
         }
-        return os.str();
+        return s;
     }
 
     string_type to_string(const basic_serialization_options<char_type>& options,
                           const char_allocator_type& allocator=char_allocator_type()) const
     {
         string_type s(allocator);
-        std::basic_ostringstream<char_type> os(s);
-        os.imbue(std::locale::classic());
+        basic_string_sink<string_type> sink(s);
         {
-            basic_json_serializer<char_type> serializer(os, options);
+            basic_json_serializer<char_type> serializer(sink, options);
             dump_fragment(serializer);
         }
-        return os.str();
+        return s;
     }
 
 #if !defined(JSONCONS_NO_DEPRECATED)
@@ -3301,7 +4356,14 @@ public:
 
     bool is_string() const JSONCONS_NOEXCEPT
     {
-        return (var_.type_id() == json_type_tag::string_t) || (var_.type_id() == json_type_tag::small_string_t);
+        return (var_.type_id() == json_type_tag::string_t) || (var_.type_id() == json_type_tag::small_string_t) ||
+               (var_.type_id() == json_type_tag::string_view_t) || (var_.type_id() == json_type_tag::escaped_string_t);
+    }
+
+    // True if the value is a string held as a view into a buffer it does not own
+    bool is_string_view() const JSONCONS_NOEXCEPT
+    {
+        return var_.type_id() == json_type_tag::string_view_t;
     }
 
     bool is_byte_string() const JSONCONS_NOEXCEPT
@@ -3326,22 +4388,51 @@ public:
 
     bool is_integer() const JSONCONS_NOEXCEPT
     {
+        if (var_.is_number_text())
+        {
+            return basic_json(var_.number_text_value()).is_integer();
+        }
         return var_.type_id() == json_type_tag::integer_t || (var_.type_id() == json_type_tag::uinteger_t&& (as_uinteger() <= static_cast<uint64_t>((std::numeric_limits<long long>::max)())));
     }
 
     bool is_uinteger() const JSONCONS_NOEXCEPT
     {
+        if (var_.is_number_text())
+        {
+            return basic_json(var_.number_text_value()).is_uinteger();
+        }
         return var_.type_id() == json_type_tag::uinteger_t || (var_.type_id() == json_type_tag::integer_t&& as_integer() >= 0);
     }
 
     bool is_double() const JSONCONS_NOEXCEPT
     {
+        if (var_.is_number_text())
+        {
+            return basic_json(var_.number_text_value()).is_double();
+        }
         return var_.type_id() == json_type_tag::double_t;
     }
 
     bool is_number() const JSONCONS_NOEXCEPT
     {
-        return var_.type_id() == json_type_tag::integer_t || var_.type_id() == json_type_tag::uinteger_t || var_.type_id() == json_type_tag::double_t;
+        return var_.type_id() == json_type_tag::integer_t || var_.type_id() == json_type_tag::uinteger_t || var_.type_id() == json_type_tag::double_t ||
+               var_.is_number_text();
+    }
+
+    // True if the value is a number held as the text it had in the source, see
+    // basic_json_decoder's keep_number_text option
+    bool is_number_text() const JSONCONS_NOEXCEPT
+    {
+        return var_.is_number_text();
+    }
+
+    string_view_type number_text() const
+    {
+        if (!var_.is_number_text())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a number held as text");
+        }
+        return var_.number_text_view();
     }
 
     bool empty() const JSONCONS_NOEXCEPT
@@ -3352,6 +4443,10 @@ public:
             return var_.small_string_data_cast()->length() == 0;
         case json_type_tag::string_t:
             return var_.string_data_cast()->length() == 0;
+        case json_type_tag::string_view_t:
+            return var_.string_view_data_cast()->length() == 0;
+        case json_type_tag::escaped_string_t:
+            return false;
         case json_type_tag::array_t:
             return array_value().size() == 0;
         case json_type_tag::empty_object_t:
@@ -3451,15 +4546,43 @@ public:
         return json_type_traits<basic_json,T>::as(*this,allocator);
     }
 
+    // Converts to T, as as<T>() does, if is<T>() or, for a floating point T, is_number().
+    // Otherwise sets ec to json_errc::not_convertible and returns T(), without throwing.
+    template<class T>
+    T try_as(std::error_code& ec) const
+    {
+        if (!detail::json_convertible<basic_json,T>::test(*this))
+        {
+            ec = json_errc::not_convertible;
+            return T();
+        }
+        ec.clear();
+        return as<T>();
+    }
+
+#if defined(JSONCONS_HAS_OPTIONAL)
+    template<class T>
+    std::optional<T> as_optional() const
+    {
+        if (!detail::json_convertible<basic_json,T>::test(*this))
+        {
+            return std::nullopt;
+        }
+        return as<T>();
+    }
+#endif
+
     bool as_bool() const 
     {
         switch (var_.type_id())
         {
         case json_type_tag::small_string_t:
         case json_type_tag::string_t:
+        case json_type_tag::string_view_t:
+        case json_type_tag::escaped_string_t:
             try
             {
-                basic_json j = basic_json::parse(as_string_view().data(),as_string_view().length());
+                auto j = basic_json<CharT,ImplementationPolicy>::parse(as_string_view().data(),as_string_view().length());
                 return j.as_bool();
             }
             catch (...)
@@ -3469,6 +4592,9 @@ public:
             break;
         case json_type_tag::bool_t:
             return var_.bool_data_cast()->value();
+        case json_type_tag::small_number_t:
+        case json_type_tag::number_t:
+            return basic_json(var_.number_text_value()).as_bool();
         case json_type_tag::double_t:
             return var_.double_data_cast()->value() != 0.0;
         case json_type_tag::integer_t:
@@ -3486,16 +4612,21 @@ public:
         {
         case json_type_tag::small_string_t:
         case json_type_tag::string_t:
+        case json_type_tag::string_view_t:
+        case json_type_tag::escaped_string_t:
             try
             {
-                basic_json j = basic_json::parse(as_string_view().data(),as_string_view().length());
-                return j.as<int64_t>();
+                auto j = basic_json<CharT,ImplementationPolicy>::parse(as_string_view().data(),as_string_view().length());
+                return j.template as<int64_t>();
             }
             catch (...)
             {
                 JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an integer");
             }
             break;
+        case json_type_tag::small_number_t:
+        case json_type_tag::number_t:
+            return basic_json(var_.number_text_value()).as_integer();
         case json_type_tag::double_t:
             return static_cast<int64_t>(var_.double_data_cast()->value());
         case json_type_tag::integer_t:
@@ -3515,16 +4646,21 @@ public:
         {
         case json_type_tag::small_string_t:
         case json_type_tag::string_t:
+        case json_type_tag::string_view_t:
+        case json_type_tag::escaped_string_t:
             try
             {
-                basic_json j = basic_json::parse(as_string_view().data(),as_string_view().length());
-                return j.as<uint64_t>();
+                auto j = basic_json<CharT,ImplementationPolicy>::parse(as_string_view().data(),as_string_view().length());
+                return j.template as<uint64_t>();
             }
             catch (...)
             {
                 JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an unsigned integer");
             }
             break;
+        case json_type_tag::small_number_t:
+        case json_type_tag::number_t:
+            return basic_json(var_.number_text_value()).as_uinteger();
         case json_type_tag::double_t:
             return static_cast<uint64_t>(var_.double_data_cast()->value());
         case json_type_tag::integer_t:
@@ -3544,6 +4680,9 @@ public:
         {
         case json_type_tag::double_t:
             return var_.double_data_cast()->precision();
+        case json_type_tag::small_number_t:
+        case json_type_tag::number_t:
+            return basic_json(var_.number_text_value()).double_precision();
         default:
             JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a double");
         }
@@ -3555,10 +4694,12 @@ public:
         {
         case json_type_tag::small_string_t:
         case json_type_tag::string_t:
+        case json_type_tag::string_view_t:
+        case json_type_tag::escaped_string_t:
             try
             {
-                basic_json j = basic_json::parse(as_string_view().data(),as_string_view().length());
-                return j.as<double>();
+                auto j = basic_json<CharT,ImplementationPolicy>::parse(as_string_view().data(),as_string_view().length());
+                return j.template as<double>();
             }
             catch (...)
             {
@@ -3567,6 +4708,9 @@ public:
             break;
         case json_type_tag::double_t:
             return var_.double_data_cast()->value();
+        case json_type_tag::small_number_t:
+        case json_type_tag::number_t:
+            return basic_json(var_.number_text_value()).as_double();
         case json_type_tag::integer_t:
             return static_cast<double>(var_.integer_data_cast()->value());
         case json_type_tag::uinteger_t:
@@ -3594,6 +4738,8 @@ public:
         {
         case json_type_tag::small_string_t:
         case json_type_tag::string_t:
+        case json_type_tag::string_view_t:
+        case json_type_tag::escaped_string_t:
             return string_type(as_string_view().data(),as_string_view().length());
         default:
             return to_string();
@@ -3607,6 +4753,8 @@ public:
         {
         case json_type_tag::small_string_t:
         case json_type_tag::string_t:
+        case json_type_tag::string_view_t:
+        case json_type_tag::escaped_string_t:
             return string_type(as_string_view().data(),as_string_view().length(),allocator);
         default:
             return to_string(allocator);
@@ -3619,6 +4767,8 @@ public:
         {
         case json_type_tag::small_string_t:
         case json_type_tag::string_t:
+        case json_type_tag::string_view_t:
+        case json_type_tag::escaped_string_t:
             return string_type(as_string_view().data(),as_string_view().length());
         default:
             return to_string(options);
@@ -3633,6 +4783,8 @@ public:
         {
         case json_type_tag::small_string_t:
         case json_type_tag::string_t:
+        case json_type_tag::string_view_t:
+        case json_type_tag::escaped_string_t:
             return string_type(as_string_view().data(),as_string_view().length(),allocator);
         default:
             return to_string(options,allocator);
@@ -3648,6 +4800,9 @@ public:
             return var_.small_string_data_cast()->c_str();
         case json_type_tag::string_t:
             return var_.string_data_cast()->c_str();
+        case json_type_tag::escaped_string_t:
+            var_.unescape();
+            return var_.string_data_cast()->c_str();
         default:
             JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a cstring");
         }
@@ -3724,6 +4879,32 @@ public:
         }
     }
 
+    // Returns the value of the member name, or sets ec and returns null() if there is none
+    // or this is not an object
+    const basic_json& at(const string_view_type& name, std::error_code& ec) const
+    {
+        switch (var_.type_id())
+        {
+        case json_type_tag::empty_object_t:
+            ec = json_errc::key_not_found;
+            return null();
+        case json_type_tag::object_t:
+            {
+                auto it = object_value().find(name);
+                if (it == object_range().end())
+                {
+                    ec = json_errc::key_not_found;
+                    return null();
+                }
+                ec.clear();
+                return it->value();
+            }
+        default:
+            ec = json_errc::not_an_object;
+            return null();
+        }
+    }
+
     basic_json& at(size_t i)
     {
         switch (var_.type_id())
@@ -3758,6 +4939,37 @@ public:
         }
     }
 
+    // Returns the element at i of an array, or the value of the member at i of an object,
+    // or sets ec and returns null() if i is out of range or this is neither
+    const basic_json& at(size_t i, std::error_code& ec) const
+    {
+        switch (var_.type_id())
+        {
+        case json_type_tag::array_t:
+            if (i >= array_value().size())
+            {
+                ec = json_errc::index_out_of_range;
+                return null();
+            }
+            ec.clear();
+            return array_value().operator[](i);
+        case json_type_tag::empty_object_t:
+            ec = json_errc::index_out_of_range;
+            return null();
+        case json_type_tag::object_t:
+            if (i >= object_value().size())
+            {
+                ec = json_errc::index_out_of_range;
+                return null();
+            }
+            ec.clear();
+            return object_value().at(i);
+        default:
+            ec = json_errc::not_an_array;
+            return null();
+        }
+    }
+
     object_iterator find(const string_view_type& name)
     {
         switch (var_.type_id())
@@ -3871,12 +5083,26 @@ public:
         }
     }
 
+    // The heap bytes held by this value and its descendants, by category. Under
+    // copy_on_write_policy, each copy that shares an array or object counts it.
+    json_memory_usage memory_usage() const
+    {
+        json_memory_usage usage;
+        add_memory_usage(usage);
+        return usage;
+    }
+
     // Modifiers
 
+    // Gives back the unused capacity of the arrays, objects, byte strings and member
+    // names in this value and its descendants, such as that left by a decoder's growth
     void shrink_to_fit()
     {
         switch (var_.type_id())
         {
+        case json_type_tag::byte_string_t:
+            var_.byte_string_data_cast()->shrink_to_fit();
+            break;
         case json_type_tag::array_t:
             array_value().shrink_to_fit();
             break;
@@ -4712,11 +5938,11 @@ public:
 
     range<object_iterator> object_range()
     {
-        static basic_json empty_object = object();
         switch (var_.type_id())
         {
         case json_type_tag::empty_object_t:
-            return range<object_iterator>(empty_object.object_range().begin(), empty_object.object_range().end());
+            // Value initialized iterators compare equal, an empty range needs no allocator 
+            return range<object_iterator>(object_iterator(), object_iterator());
         case json_type_tag::object_t:
             return range<object_iterator>(object_value().begin(),object_value().end());
         default:
@@ -4726,11 +5952,11 @@ public:
 
     range<const_object_iterator> object_range() const
     {
-        static const basic_json empty_object = object();
         switch (var_.type_id())
         {
         case json_type_tag::empty_object_t:
-            return range<const_object_iterator>(empty_object.object_range().begin(), empty_object.object_range().end());
+            // Value initialized iterators compare equal, an empty range needs no allocator 
+            return range<const_object_iterator>(const_object_iterator(), const_object_iterator());
         case json_type_tag::object_t:
             return range<const_object_iterator>(object_value().begin(),object_value().end());
         default:
@@ -4816,6 +6042,112 @@ public:
 
 private:
 
+    void add_memory_usage(json_memory_usage& usage) const
+    {
+        switch (var_.type_id())
+        {
+        case json_type_tag::string_t:
+        case json_type_tag::number_t:
+        case json_type_tag::escaped_string_t:
+            usage.string_bytes += var_.string_data_cast()->allocated_size();
+            break;
+        case json_type_tag::byte_string_t:
+            usage.node_bytes += variant::byte_string_data::holder_size();
+            usage.string_bytes += var_.byte_string_data_cast()->capacity();
+            break;
+        case json_type_tag::array_t:
+            {
+                const array& a = var_.array_data_cast()->value();
+                usage.node_bytes += variant::array_data::holder_size() + a.size()*sizeof(basic_json);
+                usage.slack_bytes += (a.capacity() - a.size())*sizeof(basic_json);
+                for (const auto& element : a)
+                {
+                    element.add_memory_usage(usage);
+                }
+            }
+            break;
+        case json_type_tag::object_t:
+            {
+                const object& o = var_.object_data_cast()->value();
+                usage.node_bytes += variant::object_data::holder_size() + o.size()*sizeof(key_value_pair_type) + o.index_size();
+                usage.slack_bytes += (o.capacity() - o.size())*sizeof(key_value_pair_type);
+                for (const auto& member : o)
+                {
+                    usage.key_bytes += member.key_heap_size();
+                    member.value().add_memory_usage(usage);
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    // A parser and decoder that are kept warm across calls to parse
+    struct reusable_parse_state
+    {
+        parse_error_handler_type err_handler_;
+        json_decoder<basic_json> decoder_;
+        basic_json_parser<char_type> parser_;
+        bool in_use_;
+
+        reusable_parse_state()
+            : parser_(decoder_, err_handler_), in_use_(false)
+        {
+        }
+
+        struct use_guard
+        {
+            reusable_parse_state& state_;
+
+            use_guard(reusable_parse_state& state)
+                : state_(state)
+            {
+                state_.in_use_ = true;
+                state_.parser_.reset();
+                state_.decoder_.reset();
+            }
+            ~use_guard()
+            {
+                state_.in_use_ = false;
+            }
+        };
+    };
+
+    // Parses s with a parser that is ready for a new text and reports to handler
+    static basic_json parse(const string_view_type& s, 
+                            json_decoder<basic_json>& handler, 
+                            basic_json_parser<char_type>& parser)
+    {
+        auto result = unicons::skip_bom(s.begin(), s.end());
+        if (result.ec != unicons::encoding_errc())
+        {
+            throw parse_error(result.ec,1,1);
+        }
+        size_t offset = result.it - s.begin();
+        parser.set_source(s.data()+offset,s.size()-offset);
+        std::error_code ec;
+        if (!parser.parse_indexed(ec))
+        {
+            parser.parse();
+        }
+        else if (ec)
+        {
+            // Parse again character by character, for recovery and precise error reporting
+            parser.reset();
+            handler.reset();
+            parser.set_source(s.data()+offset,s.size()-offset);
+            parser.parse();
+        }
+        parser.end_parse();
+        parser.check_done();
+        if (!handler.is_valid())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Failed to parse json string");
+        }
+        return handler.get_result();
+    }
+
     friend std::basic_ostream<char_type>& operator<<(std::basic_ostream<char_type>& os, const basic_json& o)
     {
         o.dump(os);
@@ -4880,6 +6212,30 @@ std::basic_istream<typename Json::char_type>& operator>>(std::basic_istream<type
     return is;
 }
 
+// The length of the compact serialization of j, as written by dump
+
+template<class Json>
+size_t serialized_size(const Json& j)
+{
+    basic_counting_sink<typename Json::char_type> sink;
+    {
+        basic_json_serializer<typename Json::char_type> serializer(sink);
+        j.dump(serializer);
+    }
+    return sink.count();
+}
+
+template<class Json>
+size_t serialized_size(const Json& j, const basic_serialization_options<typename Json::char_type>& options)
+{
+    basic_counting_sink<typename Json::char_type> sink;
+    {
+        basic_json_serializer<typename Json::char_type> serializer(sink, options);
+        j.dump(serializer);
+    }
+    return sink.count();
+}
+
 template<class Json>
 class json_printable
 {
@@ -4944,6 +6300,16 @@ json_printable<Json> pretty_print(const Json& val,
     return json_printable<Json>(val, true, options);
 }
 
+namespace detail {
+
+template <class T>
+struct is_basic_json : std::false_type {};
+
+template <class CharT, class ImplementationPolicy, class Allocator>
+struct is_basic_json<basic_json<CharT,ImplementationPolicy,Allocator>> : std::true_type {};
+
+}
+
 typedef basic_json<char,sorted_policy,std::allocator<char>> json;
 typedef basic_json<wchar_t,sorted_policy,std::allocator<wchar_t>> wjson;
 typedef basic_json<char, preserve_order_policy, std::allocator<char>> ojson;
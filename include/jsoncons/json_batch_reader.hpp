@@ -0,0 +1,323 @@
+// Copyright 2015 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSON_BATCH_READER_HPP
+#define JSONCONS_JSON_BATCH_READER_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <istream>
+#include <system_error>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/json_input_handler.hpp>
+#include <jsoncons/json_event_tape.hpp>
+#include <jsoncons/parse_error_handler.hpp>
+#include <jsoncons/json_parser.hpp>
+#include <jsoncons/input_source.hpp>
+
+namespace jsoncons {
+
+// Reads JSON text as basic_json_reader does, but rather than passing each event to the
+// handler as it is parsed, the parser records the events of each buffer of text in a
+// basic_json_event_tape, and the tape is handed to the handler's events function in one
+// call once the buffer has been parsed. The parser's calls are not virtual, and a handler
+// that overrides do_events, such as json_decoder, or basic_json_serializer and
+// cbor_serializer through basic_json_input_output_handler_adapter, runs through the
+// events in a loop of its own. Strings in the buffer are not copied to the tape. The
+// parsing_context of the events is the tape, with the line and column of the end of the
+// buffer, and a handler cannot skip values.
+
+template<class CharT>
+class basic_json_batch_reader
+{
+    static const size_t default_max_buffer_length = 16384;
+
+    basic_json_event_tape<CharT> tape_;
+    basic_json_parser<CharT,basic_json_event_tape<CharT>> parser_;
+    basic_json_input_handler<CharT>& handler_;
+    basic_stream_source<CharT> stream_source_;
+    basic_input_source<CharT>* source_;
+    bool eof_;
+    std::vector<CharT> buffer_;
+    size_t buffer_length_;
+    bool begin_;
+
+    // Noncopyable and nonmoveable
+    basic_json_batch_reader(const basic_json_batch_reader&) = delete;
+    basic_json_batch_reader& operator=(const basic_json_batch_reader&) = delete;
+
+public:
+    basic_json_batch_reader(std::basic_istream<CharT>& is,
+                            basic_json_input_handler<CharT>& handler)
+        : parser_(tape_),
+          handler_(handler),
+          stream_source_(is),
+          source_(std::addressof(stream_source_)),
+          eof_(false),
+          buffer_length_(default_max_buffer_length),
+          begin_(true)
+    {
+        buffer_.reserve(buffer_length_);
+    }
+
+    basic_json_batch_reader(std::basic_istream<CharT>& is,
+                            basic_json_input_handler<CharT>& handler,
+                            parse_error_handler& err_handler)
+       : parser_(tape_,err_handler),
+         handler_(handler),
+         stream_source_(is),
+         source_(std::addressof(stream_source_)),
+         eof_(false),
+         buffer_length_(default_max_buffer_length),
+         begin_(true)
+    {
+        buffer_.reserve(buffer_length_);
+    }
+
+    basic_json_batch_reader(basic_input_source<CharT>& source,
+                            basic_json_input_handler<CharT>& handler)
+        : parser_(tape_),
+          handler_(handler),
+          source_(std::addressof(source)),
+          eof_(false),
+          buffer_length_(default_max_buffer_length),
+          begin_(true)
+    {
+        buffer_.reserve(buffer_length_);
+    }
+
+    basic_json_batch_reader(basic_input_source<CharT>& source,
+                            basic_json_input_handler<CharT>& handler,
+                            parse_error_handler& err_handler)
+       : parser_(tape_,err_handler),
+         handler_(handler),
+         source_(std::addressof(source)),
+         eof_(false),
+         buffer_length_(default_max_buffer_length),
+         begin_(true)
+    {
+        buffer_.reserve(buffer_length_);
+    }
+
+    // The number of characters read at a time, and so the most that the events of one
+    // tape come from
+    size_t buffer_length() const
+    {
+        return buffer_length_;
+    }
+
+    void buffer_length(size_t length)
+    {
+        buffer_length_ = length;
+        buffer_.reserve(buffer_length_);
+    }
+
+    size_t max_nesting_depth() const
+    {
+        return parser_.max_nesting_depth();
+    }
+
+    void max_nesting_depth(size_t depth)
+    {
+        parser_.max_nesting_depth(depth);
+    }
+
+    bool keep_number_text() const
+    {
+        return parser_.keep_number_text();
+    }
+
+    void keep_number_text(bool value)
+    {
+        parser_.keep_number_text(value);
+    }
+
+    bool keep_escaped_strings() const
+    {
+        return parser_.keep_escaped_strings();
+    }
+
+    void keep_escaped_strings(bool value)
+    {
+        parser_.keep_escaped_strings(value);
+    }
+
+    size_t line_number() const
+    {
+        return parser_.line_number();
+    }
+
+    size_t column_number() const
+    {
+        return parser_.column_number();
+    }
+
+    bool eof() const
+    {
+        return eof_;
+    }
+
+    void read_next()
+    {
+        std::error_code ec;
+        read_next(ec);
+        if (ec)
+        {
+            throw parse_error(ec,parser_.line_number(),parser_.column_number());
+        }
+    }
+
+    void read_next(std::error_code& ec)
+    {
+        parser_.reset();
+        while (!eof_ && !parser_.done())
+        {
+            if (parser_.source_exhausted())
+            {
+                if (!source_->eof())
+                {
+                    if (source_->fail())
+                    {
+                        ec = json_parser_errc::source_error;
+                        return;
+                    }
+                    read_buffer(ec);
+                    if (ec) return;
+                }
+                else
+                {
+                    eof_ = true;
+                }
+            }
+            if (!eof_)
+            {
+                parser_.parse(ec);
+                flush();
+                if (ec) return;
+            }
+        }
+        if (eof_)
+        {
+            parser_.end_parse(ec);
+            flush();
+            if (ec) return;
+        }
+    }
+
+    void check_done()
+    {
+        std::error_code ec;
+        check_done(ec);
+        if (ec)
+        {
+            throw parse_error(ec,parser_.line_number(),parser_.column_number());
+        }
+    }
+
+    void check_done(std::error_code& ec)
+    {
+        if (eof_)
+        {
+            parser_.check_done(ec);
+            if (ec) return;
+        }
+        else
+        {
+            while (!eof_)
+            {
+                if (parser_.source_exhausted())
+                {
+                    if (!source_->eof())
+                    {
+                        if (source_->fail())
+                        {
+                            ec = json_parser_errc::source_error;
+                            return;
+                        }
+                        read_buffer(ec);
+                        if (ec) return;
+                    }
+                    else
+                    {
+                        eof_ = true;
+                    }
+                }
+                if (!eof_)
+                {
+                    parser_.check_done(ec);
+                    if (ec) return;
+                }
+            }
+        }
+    }
+
+    void read()
+    {
+        read_next();
+        check_done();
+    }
+
+    void read(std::error_code& ec)
+    {
+        read_next(ec);
+        if (!ec)
+        {
+            check_done(ec);
+        }
+    }
+
+private:
+    void read_buffer(std::error_code& ec)
+    {
+        buffer_.clear();
+        buffer_.resize(buffer_length_);
+        buffer_.resize(source_->read(buffer_.data(), buffer_length_));
+        if (source_->fail())
+        {
+            ec = json_parser_errc::source_error;
+            return;
+        }
+        if (buffer_.size() == 0)
+        {
+            eof_ = true;
+            return;
+        }
+        size_t offset = 0;
+        if (begin_)
+        {
+            auto result = unicons::skip_bom(buffer_.begin(), buffer_.end());
+            if (result.ec != unicons::encoding_errc())
+            {
+                ec = result.ec;
+                return;
+            }
+            offset = result.it - buffer_.begin();
+            begin_ = false;
+        }
+        parser_.set_source(buffer_.data()+offset,buffer_.size()-offset);
+        tape_.source(buffer_.data()+offset,buffer_.size()-offset);
+    }
+
+    // Hands the events recorded since the last call to the handler, before the buffer
+    // that their strings point into is refilled
+    void flush()
+    {
+        if (!tape_.empty())
+        {
+            tape_.position(parser_.line_number(), parser_.column_number());
+            handler_.events(tape_);
+            tape_.clear();
+        }
+    }
+};
+
+typedef basic_json_batch_reader<char> json_batch_reader;
+typedef basic_json_batch_reader<wchar_t> wjson_batch_reader;
+
+}
+
+#endif
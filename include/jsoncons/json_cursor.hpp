@@ -0,0 +1,672 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSON_CURSOR_HPP
+#define JSONCONS_JSON_CURSOR_HPP
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+#include <system_error>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/json_input_handler.hpp>
+#include <jsoncons/parse_error_handler.hpp>
+#include <jsoncons/json_parser.hpp>
+
+namespace jsoncons {
+
+enum class json_event_type : uint8_t
+{
+    begin_object,
+    end_object,
+    begin_array,
+    end_array,
+    name,
+    string_value,
+    int64_value,
+    uint64_value,
+    double_value,
+    bool_value,
+    null_value
+};
+
+// One event of a basic_json_cursor. The view returned by as_string_view is valid until the
+// cursor moves on.
+template<class CharT>
+class basic_json_event
+{
+public:
+    typedef typename basic_json_input_handler<CharT>::string_view_type string_view_type;
+private:
+    json_event_type event_type_;
+    union
+    {
+        bool bool_value_;
+        int64_t int64_value_;
+        uint64_t uint64_value_;
+        double double_value_;
+        const CharT* data_;
+    } value_;
+    size_t length_;
+    uint8_t precision_;
+public:
+    basic_json_event()
+        : event_type_(json_event_type::null_value), length_(0), precision_(0)
+    {
+        value_.data_ = nullptr;
+    }
+
+    explicit basic_json_event(json_event_type event_type)
+        : event_type_(event_type), length_(0), precision_(0)
+    {
+        value_.data_ = nullptr;
+    }
+
+    basic_json_event(json_event_type event_type, const string_view_type& s)
+        : event_type_(event_type), length_(s.length()), precision_(0)
+    {
+        value_.data_ = s.data();
+    }
+
+    explicit basic_json_event(bool value)
+        : event_type_(json_event_type::bool_value), length_(0), precision_(0)
+    {
+        value_.bool_value_ = value;
+    }
+
+    explicit basic_json_event(int64_t value)
+        : event_type_(json_event_type::int64_value), length_(0), precision_(0)
+    {
+        value_.int64_value_ = value;
+    }
+
+    explicit basic_json_event(uint64_t value)
+        : event_type_(json_event_type::uint64_value), length_(0), precision_(0)
+    {
+        value_.uint64_value_ = value;
+    }
+
+    basic_json_event(double value, uint8_t precision)
+        : event_type_(json_event_type::double_value), length_(0), precision_(precision)
+    {
+        value_.double_value_ = value;
+    }
+
+    json_event_type event_type() const
+    {
+        return event_type_;
+    }
+
+    string_view_type as_string_view() const
+    {
+        if (event_type_ != json_event_type::name && event_type_ != json_event_type::string_value)
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a name or a string");
+        }
+        return string_view_type(value_.data_, length_);
+    }
+
+    std::basic_string<CharT> as_string() const
+    {
+        string_view_type s = as_string_view();
+        return std::basic_string<CharT>(s.data(), s.length());
+    }
+
+    int64_t as_integer() const
+    {
+        switch (event_type_)
+        {
+            case json_event_type::int64_value:
+                return value_.int64_value_;
+            case json_event_type::uint64_value:
+                return static_cast<int64_t>(value_.uint64_value_);
+            case json_event_type::double_value:
+                return static_cast<int64_t>(value_.double_value_);
+            default:
+                JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a number");
+        }
+    }
+
+    uint64_t as_uinteger() const
+    {
+        switch (event_type_)
+        {
+            case json_event_type::int64_value:
+                return static_cast<uint64_t>(value_.int64_value_);
+            case json_event_type::uint64_value:
+                return value_.uint64_value_;
+            case json_event_type::double_value:
+                return static_cast<uint64_t>(value_.double_value_);
+            default:
+                JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a number");
+        }
+    }
+
+    double as_double() const
+    {
+        switch (event_type_)
+        {
+            case json_event_type::int64_value:
+                return static_cast<double>(value_.int64_value_);
+            case json_event_type::uint64_value:
+                return static_cast<double>(value_.uint64_value_);
+            case json_event_type::double_value:
+                return value_.double_value_;
+            default:
+                JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a number");
+        }
+    }
+
+    // The number of significant digits of a double_value, as it was written in the text
+    uint8_t precision() const
+    {
+        return precision_;
+    }
+
+    bool as_bool() const
+    {
+        if (event_type_ != json_event_type::bool_value)
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a bool");
+        }
+        return value_.bool_value_;
+    }
+};
+
+namespace detail {
+
+// The handler of a cursor's parser. It queues the events of one step, and stops the parser
+// after each of them. A step has more than one event only when a number is ended by the
+// brackets after it, so the queue never holds more than one string.
+template<class CharT>
+class json_cursor_handler
+{
+public:
+    typedef typename basic_json_input_handler<CharT>::string_view_type string_view_type;
+    typedef basic_json_parser<CharT,json_cursor_handler<CharT>> parser_type;
+
+    static const size_t max_events = 4;
+
+    parser_type* parser_ptr_;
+    basic_json_event<CharT> events_[max_events];
+    size_t count_;
+    bool end_json_;
+    // Strings that aren't in the source are copied here, since the parser reuses its buffer
+    std::basic_string<CharT> string_buffer_;
+    const CharT* source_first_;
+    const CharT* source_last_;
+
+    json_cursor_handler()
+        : parser_ptr_(nullptr), count_(0), end_json_(false), source_first_(nullptr), source_last_(nullptr)
+    {
+    }
+
+    void begin_json()
+    {
+    }
+
+    void end_json()
+    {
+        end_json_ = true;
+        parser_ptr_->stop();
+    }
+
+    void begin_object(const parsing_context&)
+    {
+        push(basic_json_event<CharT>(json_event_type::begin_object));
+    }
+
+    void end_object(const parsing_context&)
+    {
+        push(basic_json_event<CharT>(json_event_type::end_object));
+    }
+
+    void begin_array(const parsing_context&)
+    {
+        push(basic_json_event<CharT>(json_event_type::begin_array));
+    }
+
+    void end_array(const parsing_context&)
+    {
+        push(basic_json_event<CharT>(json_event_type::end_array));
+    }
+
+    void name(const string_view_type& name, const parsing_context&)
+    {
+        push(basic_json_event<CharT>(json_event_type::name, stable_view(name)));
+    }
+
+    void string_value(const string_view_type& value, const parsing_context&)
+    {
+        push(basic_json_event<CharT>(json_event_type::string_value, stable_view(value)));
+    }
+
+    void integer_value(int64_t value, const parsing_context&)
+    {
+        push(basic_json_event<CharT>(value));
+    }
+
+    void uinteger_value(uint64_t value, const parsing_context&)
+    {
+        push(basic_json_event<CharT>(value));
+    }
+
+    void double_value(double value, uint8_t precision, const parsing_context&)
+    {
+        push(basic_json_event<CharT>(value, precision));
+    }
+
+    void bool_value(bool value, const parsing_context&)
+    {
+        push(basic_json_event<CharT>(value));
+    }
+
+    void null_value(const parsing_context&)
+    {
+        push(basic_json_event<CharT>(json_event_type::null_value));
+    }
+private:
+    void push(const basic_json_event<CharT>& event)
+    {
+        JSONCONS_ASSERT(count_ < max_events);
+        events_[count_++] = event;
+        parser_ptr_->stop();
+    }
+
+    string_view_type stable_view(const string_view_type& s)
+    {
+        if (s.data() >= source_first_ && s.data() + s.length() <= source_last_)
+        {
+            return s;
+        }
+        string_buffer_.assign(s.data(), s.length());
+        return string_view_type(string_buffer_.data(), string_buffer_.length());
+    }
+};
+
+}
+
+// Reads a JSON text one event at a time, on demand. The events come from the same incremental
+// parser as json_reader's, which is stopped after each one, so the rest of the text is only
+// read and parsed as the caller asks for it. Names and strings are views into the source where
+// they can be, and into a buffer of the cursor's where they have escapes or cross a read.
+
+template<class CharT>
+class basic_json_cursor : private detail::json_cursor_handler<CharT>
+{
+public:
+    typedef typename basic_json_input_handler<CharT>::string_view_type string_view_type;
+private:
+    static const size_t default_max_buffer_length = 16384;
+
+    typedef detail::json_cursor_handler<CharT> handler_type;
+
+    basic_json_parser<CharT,handler_type> parser_;
+    std::basic_istream<CharT>* is_;
+    std::vector<CharT> buffer_;
+    size_t buffer_length_;
+    bool begin_;
+    bool eof_;
+    size_t index_;
+    bool done_;
+
+    // Noncopyable and nonmoveable
+    basic_json_cursor(const basic_json_cursor&) = delete;
+    basic_json_cursor& operator=(const basic_json_cursor&) = delete;
+
+public:
+    // Reads from the stream, a buffer at a time
+    basic_json_cursor(std::basic_istream<CharT>& is)
+        : parser_(static_cast<handler_type&>(*this)),
+          is_(std::addressof(is)),
+          buffer_length_(default_max_buffer_length),
+          begin_(true),
+          eof_(false),
+          index_(0),
+          done_(false)
+    {
+        this->parser_ptr_ = std::addressof(parser_);
+        buffer_.reserve(buffer_length_);
+        next();
+    }
+
+    basic_json_cursor(std::basic_istream<CharT>& is, parse_error_handler& err_handler)
+        : parser_(static_cast<handler_type&>(*this), err_handler),
+          is_(std::addressof(is)),
+          buffer_length_(default_max_buffer_length),
+          begin_(true),
+          eof_(false),
+          index_(0),
+          done_(false)
+    {
+        this->parser_ptr_ = std::addressof(parser_);
+        buffer_.reserve(buffer_length_);
+        next();
+    }
+
+    // Reads a text held in memory, which must outlive the cursor
+    basic_json_cursor(const string_view_type& s)
+        : parser_(static_cast<handler_type&>(*this)),
+          is_(nullptr),
+          buffer_length_(0),
+          begin_(false),
+          eof_(false),
+          index_(0),
+          done_(false)
+    {
+        this->parser_ptr_ = std::addressof(parser_);
+        auto result = unicons::skip_bom(s.begin(), s.end());
+        if (result.ec != unicons::encoding_errc())
+        {
+            throw parse_error(result.ec,1,1);
+        }
+        size_t offset = result.it - s.begin();
+        set_source(s.data()+offset, s.length()-offset);
+        next();
+    }
+
+    // Whether the text has been read to its end. Until then, current is the last event read.
+    bool done() const
+    {
+        return done_;
+    }
+
+    const basic_json_event<CharT>& current() const
+    {
+        return this->events_[index_];
+    }
+
+    // Reads the next event. Throws parse_error if the text is not well formed.
+    void next()
+    {
+        std::error_code ec;
+        next(ec);
+        if (ec)
+        {
+            throw parse_error(ec,parser_.line_number(),parser_.column_number());
+        }
+    }
+
+    void next(std::error_code& ec)
+    {
+        if (index_ + 1 < this->count_)
+        {
+            ++index_;
+            return;
+        }
+        index_ = 0;
+        this->count_ = 0;
+        while (this->count_ == 0)
+        {
+            if (this->end_json_ || eof_)
+            {
+                done_ = true;
+                return;
+            }
+            read_some(ec);
+            if (ec) return;
+        }
+    }
+
+    // Skips past the current value. For a begin_object or begin_array event that is the whole
+    // object or array, and for a name event the member's value, so that next reads the event
+    // after them. The skipped text is scanned only for quotes and brackets, as it is by the
+    // parser for parsing_context::skip_value.
+    void skip()
+    {
+        std::error_code ec;
+        skip(ec);
+        if (ec)
+        {
+            throw parse_error(ec,parser_.line_number(),parser_.column_number());
+        }
+    }
+
+    void skip(std::error_code& ec)
+    {
+        if (done_ || index_ + 1 < this->count_)
+        {
+            return;
+        }
+        switch (current().event_type())
+        {
+            case json_event_type::begin_object:
+            case json_event_type::begin_array:
+                // The parser leaves the closing bracket, and its end event, to be read
+                parser_.skip_current();
+                next(ec);
+                break;
+            case json_event_type::name:
+                parser_.skip_current();
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Passes the current value to the handler, as a complete JSON text, and leaves the cursor
+    // at its last event. For a begin_object or begin_array event that is the whole object or
+    // array, e.g. read_to(decoder) with a json_decoder builds a json from it, and for a name
+    // event the member's value. At an end_object or end_array event there is nothing to read.
+    void read_to(basic_json_input_handler<CharT>& handler)
+    {
+        std::error_code ec;
+        read_to(handler, ec);
+        if (ec)
+        {
+            throw parse_error(ec,parser_.line_number(),parser_.column_number());
+        }
+    }
+
+    void read_to(basic_json_input_handler<CharT>& handler, std::error_code& ec)
+    {
+        if (done_)
+        {
+            return;
+        }
+        switch (current().event_type())
+        {
+            case json_event_type::end_object:
+            case json_event_type::end_array:
+                return;
+            case json_event_type::name:
+                next(ec);
+                if (ec) return;
+                if (done_)
+                {
+                    ec = json_parser_errc::unexpected_eof;
+                    return;
+                }
+                break;
+            default:
+                break;
+        }
+        const parsing_context& context = parser_.parsing_context();
+        handler.begin_json();
+        size_t depth = 0;
+        do
+        {
+            const basic_json_event<CharT>& event = current();
+            switch (event.event_type())
+            {
+                case json_event_type::begin_object:
+                    ++depth;
+                    handler.begin_object(context);
+                    break;
+                case json_event_type::end_object:
+                    --depth;
+                    handler.end_object(context);
+                    break;
+                case json_event_type::begin_array:
+                    ++depth;
+                    handler.begin_array(context);
+                    break;
+                case json_event_type::end_array:
+                    --depth;
+                    handler.end_array(context);
+                    break;
+                case json_event_type::name:
+                    handler.name(event.as_string_view(), context);
+                    break;
+                case json_event_type::string_value:
+                    handler.string_value(event.as_string_view(), context);
+                    break;
+                case json_event_type::int64_value:
+                    handler.integer_value(event.as_integer(), context);
+                    break;
+                case json_event_type::uint64_value:
+                    handler.uinteger_value(event.as_uinteger(), context);
+                    break;
+                case json_event_type::double_value:
+                    handler.double_value(event.as_double(), event.precision(), context);
+                    break;
+                case json_event_type::bool_value:
+                    handler.bool_value(event.as_bool(), context);
+                    break;
+                case json_event_type::null_value:
+                    handler.null_value(context);
+                    break;
+            }
+            if (depth > 0)
+            {
+                next(ec);
+                if (ec) return;
+                if (done_)
+                {
+                    ec = json_parser_errc::unexpected_eof;
+                    return;
+                }
+            }
+        }
+        while (depth > 0);
+        handler.end_json();
+    }
+
+    // Checks that there is nothing but whitespace after the text
+    void check_done()
+    {
+        std::error_code ec;
+        check_done(ec);
+        if (ec)
+        {
+            throw parse_error(ec,parser_.line_number(),parser_.column_number());
+        }
+    }
+
+    void check_done(std::error_code& ec)
+    {
+        for (;;)
+        {
+            parser_.check_done(ec);
+            if (ec || is_ == nullptr || eof_)
+            {
+                return;
+            }
+            read_buffer(ec);
+            if (ec) return;
+        }
+    }
+
+    size_t buffer_length() const
+    {
+        return buffer_length_;
+    }
+
+    void buffer_length(size_t length)
+    {
+        buffer_length_ = length;
+        buffer_.reserve(buffer_length_);
+    }
+
+    size_t max_nesting_depth() const
+    {
+        return parser_.max_nesting_depth();
+    }
+
+    void max_nesting_depth(size_t depth)
+    {
+        parser_.max_nesting_depth(depth);
+    }
+
+    size_t line_number() const
+    {
+        return parser_.line_number();
+    }
+
+    size_t column_number() const
+    {
+        return parser_.column_number();
+    }
+
+private:
+    void set_source(const CharT* data, size_t length)
+    {
+        parser_.set_source(data, length);
+        this->source_first_ = data;
+        this->source_last_ = data + length;
+    }
+
+    // Parses until the parser stops after an event, or the input ends
+    void read_some(std::error_code& ec)
+    {
+        if (parser_.source_exhausted())
+        {
+            if (is_ != nullptr && !is_->eof())
+            {
+                if (is_->fail())
+                {
+                    ec = json_parser_errc::source_error;
+                    return;
+                }
+                read_buffer(ec);
+                if (ec) return;
+            }
+            else
+            {
+                eof_ = true;
+                parser_.end_parse(ec);
+                return;
+            }
+        }
+        parser_.parse(ec);
+    }
+
+    void read_buffer(std::error_code& ec)
+    {
+        buffer_.clear();
+        buffer_.resize(buffer_length_);
+        is_->read(buffer_.data(), buffer_length_);
+        buffer_.resize(static_cast<size_t>(is_->gcount()));
+        if (buffer_.size() == 0)
+        {
+            eof_ = true;
+            parser_.end_parse(ec);
+            set_source(buffer_.data(), 0);
+            return;
+        }
+        size_t offset = 0;
+        if (begin_)
+        {
+            auto result = unicons::skip_bom(buffer_.begin(), buffer_.end());
+            if (result.ec != unicons::encoding_errc())
+            {
+                ec = result.ec;
+                return;
+            }
+            offset = result.it - buffer_.begin();
+            begin_ = false;
+        }
+        set_source(buffer_.data()+offset, buffer_.size()-offset);
+    }
+};
+
+typedef basic_json_cursor<char> json_cursor;
+typedef basic_json_cursor<wchar_t> wjson_cursor;
+
+}
+
+#endif
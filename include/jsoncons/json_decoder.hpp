@@ -13,11 +13,369 @@
 #include <istream>
 #include <cstdlib>
 #include <memory>
+#include <algorithm>
+#include <iterator>
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/json_input_handler.hpp>
+#include <jsoncons/json_trace.hpp>
 
 namespace jsoncons {
 
+// The values a json_decoder has built, by type, and the deepest nesting of arrays and objects
+
+struct json_decoder_stats
+{
+    size_t objects;
+    size_t arrays;
+    size_t names;
+    size_t strings;
+    size_t byte_strings;
+    size_t integers;
+    size_t uintegers;
+    size_t doubles;
+    // Numbers kept as text
+    size_t numbers;
+    size_t bools;
+    size_t nulls;
+    size_t max_depth;
+    // Objects whose members were placed by a cached shape
+    size_t shape_hits;
+
+    json_decoder_stats()
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        objects = 0;
+        arrays = 0;
+        names = 0;
+        strings = 0;
+        byte_strings = 0;
+        integers = 0;
+        uintegers = 0;
+        doubles = 0;
+        numbers = 0;
+        bools = 0;
+        nulls = 0;
+        max_depth = 0;
+        shape_hits = 0;
+    }
+
+    size_t value_count() const
+    {
+        return objects + arrays + strings + byte_strings + integers + uintegers + doubles + numbers + bools + nulls;
+    }
+};
+
+// The distinct member names a json_decoder has seen, so that members with the same name can
+// be given copies of one key. With basic_shared_key keys (shared_key_policy) the copies share
+// their characters. An open addressing (linear probing) hash table of positions in keys_,
+// slots hold position + 1, zero marks an empty slot.
+
+template <class KeyT>
+class key_intern_table
+{
+    std::vector<KeyT> keys_;
+    std::vector<uint32_t> slots_;
+public:
+    // Names past this many are not interned, a document whose names are data (ids, say)
+    // should not grow the table without bound
+    static const size_t max_keys = 4096;
+
+    template <class StringViewT>
+    static size_t hash(const StringViewT& s)
+    {
+        // FNV-1a
+        uint32_t h = 2166136261u;
+        for (auto c : s)
+        {
+            h ^= static_cast<uint32_t>(c);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    size_t size() const
+    {
+        return keys_.size();
+    }
+
+    void clear()
+    {
+        keys_.clear();
+        slots_.clear();
+    }
+
+    // Returns the key equal to name, or nullptr if there is none
+    template <class StringViewT>
+    const KeyT* find(const StringViewT& name, size_t h) const
+    {
+        if (slots_.empty())
+        {
+            return nullptr;
+        }
+        const size_t mask = slots_.size() - 1;
+        for (size_t i = h & mask; slots_[i] != 0; i = (i + 1) & mask)
+        {
+            const KeyT& key = keys_[slots_[i] - 1];
+            if (key.size() == name.size() && 
+                std::char_traits<typename KeyT::value_type>::compare(key.data(), name.data(), name.size()) == 0)
+            {
+                return &key;
+            }
+        }
+        return nullptr;
+    }
+
+    // Adds a key that is not in the table, unless the table is full
+    void insert(const KeyT& key, size_t h)
+    {
+        if (keys_.size() >= max_keys)
+        {
+            return;
+        }
+        if (2*(keys_.size() + 1) > slots_.size())
+        {
+            rehash(slots_.empty() ? 64 : 2*slots_.size());
+        }
+        keys_.push_back(key);
+        place(h, keys_.size());
+    }
+private:
+    void place(size_t h, size_t position)
+    {
+        const size_t mask = slots_.size() - 1;
+        size_t i = h & mask;
+        while (slots_[i] != 0)
+        {
+            i = (i + 1) & mask;
+        }
+        slots_[i] = static_cast<uint32_t>(position);
+    }
+
+    void rehash(size_t capacity)
+    {
+        slots_.assign(capacity, 0);
+        for (size_t i = 0; i < keys_.size(); ++i)
+        {
+            place(hash(keys_[i]), i + 1);
+        }
+    }
+};
+
+// The distinct string values a json_decoder has seen, so that equal strings can be given
+// copies of one value. Under copy_on_write_policy the copies share their characters. Laid out
+// as key_intern_table, with values in place of keys.
+
+template <class Json>
+class string_intern_table
+{
+    typedef typename Json::string_view_type string_view_type;
+
+    std::vector<Json> values_;
+    std::vector<uint32_t> slots_;
+public:
+    // Values past this many are not interned, nor are strings longer than max_length, so
+    // that a document whose strings are mostly distinct does not grow the table without bound
+    static const size_t max_values = 4096;
+    static const size_t max_length = 64;
+
+    static size_t hash(const string_view_type& s)
+    {
+        return key_intern_table<typename Json::key_storage_type>::hash(s);
+    }
+
+    size_t size() const
+    {
+        return values_.size();
+    }
+
+    void clear()
+    {
+        values_.clear();
+        slots_.clear();
+    }
+
+    // Returns the string value equal to s, or nullptr if there is none
+    const Json* find(const string_view_type& s, size_t h) const
+    {
+        if (slots_.empty())
+        {
+            return nullptr;
+        }
+        const size_t mask = slots_.size() - 1;
+        for (size_t i = h & mask; slots_[i] != 0; i = (i + 1) & mask)
+        {
+            const Json& value = values_[slots_[i] - 1];
+            if (value.as_string_view() == s)
+            {
+                return &value;
+            }
+        }
+        return nullptr;
+    }
+
+    // Adds a string value that is not in the table, unless the table is full
+    void insert(const Json& value, size_t h)
+    {
+        if (values_.size() >= max_values)
+        {
+            return;
+        }
+        if (2*(values_.size() + 1) > slots_.size())
+        {
+            rehash(slots_.empty() ? 64 : 2*slots_.size());
+        }
+        values_.push_back(value);
+        place(h, values_.size());
+    }
+private:
+    void place(size_t h, size_t position)
+    {
+        const size_t mask = slots_.size() - 1;
+        size_t i = h & mask;
+        while (slots_[i] != 0)
+        {
+            i = (i + 1) & mask;
+        }
+        slots_[i] = static_cast<uint32_t>(position);
+    }
+
+    void rehash(size_t capacity)
+    {
+        slots_.assign(capacity, 0);
+        for (size_t i = 0; i < values_.size(); ++i)
+        {
+            place(hash(values_[i].as_string_view()), i + 1);
+        }
+    }
+};
+
+// The member names of the last object a json_decoder finished at one depth, in the order they
+// came, and their positions in ascending order of name. While the names of the next object at
+// that depth match, it takes copies of these keys, and if all match its members are placed in
+// order without sorting or looking for duplicates. Objects that miss the shape teach it their
+// names, until max_misses of them in a row have, after which it waits for a hit.
+
+template <class KeyT>
+class object_shape
+{
+    std::vector<KeyT> keys_;
+    std::vector<uint32_t> order_;
+    bool valid_;
+    bool matching_;
+    size_t misses_;
+public:
+    // Objects with more members than this are not cached
+    static const size_t max_members = 64;
+    static const size_t max_misses = 16;
+
+    object_shape()
+        : valid_(false), matching_(false), misses_(0)
+    {
+    }
+
+    bool valid() const
+    {
+        return valid_;
+    }
+
+    // Called when an object at this depth begins
+    void begin()
+    {
+        matching_ = valid_;
+    }
+
+    // Returns the key of the name at position pos of the object in progress, if the names 
+    // so far match the shape, otherwise nullptr
+    template <class StringViewT>
+    const KeyT* match(size_t pos, const StringViewT& name)
+    {
+        if (matching_)
+        {
+            if (pos < keys_.size() && keys_[pos].size() == name.size() &&
+                std::char_traits<typename KeyT::value_type>::compare(keys_[pos].data(), name.data(), name.size()) == 0)
+            {
+                return &keys_[pos];
+            }
+            matching_ = false;
+        }
+        return nullptr;
+    }
+
+    // Called when the object in progress ends with count members, returns true if the
+    // members match the shape
+    bool end(size_t count)
+    {
+        if (matching_ && count == keys_.size())
+        {
+            misses_ = 0;
+            return true;
+        }
+        matching_ = false;
+        return false;
+    }
+
+    // The positions of the members in the order the object keeps them
+    const std::vector<uint32_t>& order() const
+    {
+        return order_;
+    }
+
+    // Replaces the shape with the names of the members [first,last) of an object that missed
+    // it, unless they are too many, or not distinct, or learning has stopped. sorted is true
+    // if objects keep their members in ascending order of name.
+    template <class InputIt, class Name>
+    void learn(InputIt first, InputIt last, Name name, bool sorted)
+    {
+        if (++misses_ > max_misses)
+        {
+            return;
+        }
+        valid_ = false;
+        if (static_cast<size_t>(std::distance(first, last)) > max_members)
+        {
+            return;
+        }
+        keys_.clear();
+        order_.clear();
+        for (; first != last; ++first)
+        {
+            keys_.push_back(name(*first));
+            order_.push_back(static_cast<uint32_t>(order_.size()));
+        }
+        std::sort(order_.begin(), order_.end(), [&](uint32_t a, uint32_t b){return compare(keys_[a], keys_[b]) < 0;});
+        for (size_t i = 1; i < order_.size(); ++i)
+        {
+            if (compare(keys_[order_[i-1]], keys_[order_[i]]) == 0)
+            {
+                return;
+            }
+        }
+        if (!sorted)
+        {
+            for (size_t i = 0; i < order_.size(); ++i)
+            {
+                order_[i] = static_cast<uint32_t>(i);
+            }
+        }
+        valid_ = true;
+    }
+private:
+    static int compare(const KeyT& a, const KeyT& b)
+    {
+        const size_t n = (std::min)(a.size(), b.size());
+        int result = std::char_traits<typename KeyT::value_type>::compare(a.data(), b.data(), n);
+        if (result != 0)
+        {
+            return result;
+        }
+        return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
+    }
+};
+
 template <class Json>
 class json_decoder : public basic_json_input_handler<typename Json::char_type>
 {
@@ -26,11 +384,13 @@ public:
     using typename basic_json_input_handler<char_type>::string_view_type                                 ;
 
     static const int default_stack_size = 1000;
+    // Strings no longer than this are stored in place, and are not worth borrowing
+    static const size_t small_string_length = Json::variant::small_string_data::max_length;
 
     typedef typename Json::key_value_pair_type key_value_pair_type;
     typedef typename Json::string_type string_type;
     typedef typename Json::key_storage_type key_storage_type;
-    typedef typename string_type::allocator_type char_allocator;
+    typedef typename Json::char_allocator_type char_allocator;
     typedef typename Json::allocator_type allocator_type;
     typedef typename Json::array array;
     typedef typename array::allocator_type array_allocator;
@@ -46,28 +406,84 @@ public:
 
     struct stack_item
     {
+        stack_item(const char_allocator& sa)
+            : name_(sa)
+        {
+        }
+
         key_storage_type name_;
         Json value_;
     };
     std::vector<stack_item> stack_;
     std::vector<size_t> stack_offsets_;
     bool is_valid_;
+    bool collect_stats_;
+    // Counting for the stats, or for a trace
+    bool counting_;
+    json_decoder_stats stats_;
+    detail::trace_recorder trace_;
+    bool intern_keys_;
+    key_intern_table<key_storage_type> key_table_;
+    bool intern_strings_;
+    string_intern_table<Json> string_table_;
+    bool cache_shapes_;
+    // One shape for each depth, an object is matched against that of its depth
+    std::vector<object_shape<key_storage_type>> shapes_;
+    std::vector<stack_item*> ordered_members_;
+    const char_type* borrow_first_;
+    const char_type* borrow_last_;
 
 public:
-    json_decoder(const char_allocator& sa = char_allocator(),
-                            const allocator_type& allocator = allocator_type())
+    json_decoder(const allocator_type& allocator = allocator_type())
+        : sa_(allocator),
+          oa_(allocator),
+          aa_(allocator),
+          top_(0),
+          stack_(),
+          stack_offsets_(),
+          is_valid_(false),
+          collect_stats_(false),
+          counting_(false),
+          trace_("json_decoder"),
+          intern_keys_(false),
+          intern_strings_(false),
+          cache_shapes_(false),
+          borrow_first_(nullptr),
+          borrow_last_(nullptr)
+
+    {
+        grow_stack(default_stack_size);
+        stack_offsets_.reserve(100);
+    }
+
+    json_decoder(const char_allocator& sa,
+                 const allocator_type& allocator)
         : sa_(sa),
           oa_(allocator),
           aa_(allocator),
           top_(0),
-          stack_(default_stack_size),
+          stack_(),
           stack_offsets_(),
-          is_valid_(false) 
+          is_valid_(false),
+          collect_stats_(false),
+          counting_(false),
+          trace_("json_decoder"),
+          intern_keys_(false),
+          intern_strings_(false),
+          cache_shapes_(false),
+          borrow_first_(nullptr),
+          borrow_last_(nullptr)
 
     {
+        grow_stack(default_stack_size);
         stack_offsets_.reserve(100);
     }
 
+    allocator_type get_allocator() const
+    {
+        return allocator_type(oa_);
+    }
+
     bool is_valid() const
     {
         return is_valid_;
@@ -79,6 +495,149 @@ public:
         return std::move(result_);
     }
 
+    // Readies the decoder for the next JSON text, discarding the result and anything left
+    // over from a text that failed to parse. The stack keeps its size and the interned
+    // keys are kept, so a decoder that is reused for many texts does not allocate for them.
+    void reset()
+    {
+        for (size_t i = 0; i < top_ && i < stack_.size(); ++i)
+        {
+            stack_[i].value_ = Json();
+        }
+        top_ = 0;
+        stack_offsets_.clear();
+        result_ = Json();
+        is_valid_ = false;
+    }
+
+    // Counting is off by default. When on, the counts are cleared at the start of each JSON text.
+    void collect_stats(bool value)
+    {
+        collect_stats_ = value;
+        counting_ = collect_stats_ || trace_.tracer() != nullptr;
+    }
+
+    bool collect_stats() const
+    {
+        return collect_stats_;
+    }
+
+    const json_decoder_stats& stats() const
+    {
+        return stats_;
+    }
+
+    // The tracer is given a record for each JSON text, with the names and values decoded,
+    // the deepest nesting, and the time from its beginning to its end, which includes the
+    // time of the parser that drives the decoder. Tracing counts as collect_stats does.
+    json_tracer* tracer() const
+    {
+        return trace_.tracer();
+    }
+
+    void tracer(json_tracer* tracer)
+    {
+        trace_.tracer(tracer);
+        counting_ = collect_stats_ || tracer != nullptr;
+    }
+
+    // Interning is off by default. When on, members with the same name are given copies of
+    // the same key, kept for as long as the decoder (or until interning is turned off).
+    void intern_keys(bool value)
+    {
+        intern_keys_ = value;
+        if (!value)
+        {
+            key_table_.clear();
+        }
+    }
+
+    bool intern_keys() const
+    {
+        return intern_keys_;
+    }
+
+    // The number of distinct names interned
+    size_t interned_key_count() const
+    {
+        return key_table_.size();
+    }
+
+    // Interning is off by default. When on, string values of up to
+    // string_intern_table<Json>::max_length characters that are equal are given copies of
+    // the same value, kept for as long as the decoder (or until interning is turned off).
+    // Under copy_on_write_policy the copies share their characters, so that a field that
+    // takes a few values across many records holds each value once. Strings short enough
+    // to be stored in place are not interned, nor are those with escapes.
+    void intern_strings(bool value)
+    {
+        intern_strings_ = value;
+        if (!value)
+        {
+            string_table_.clear();
+        }
+    }
+
+    bool intern_strings() const
+    {
+        return intern_strings_;
+    }
+
+    // The number of distinct string values interned
+    size_t interned_string_count() const
+    {
+        return string_table_.size();
+    }
+
+    // Shape caching is off by default. When on, the decoder keeps the member names of the
+    // last object it finished at each depth, and an object whose names come in the same
+    // order, as the records of an array usually do, is given copies of those keys and has
+    // its members placed in order without sorting them or looking for duplicates. Shapes
+    // are kept for as long as the decoder (or until shape caching is turned off).
+    void cache_shapes(bool value)
+    {
+        cache_shapes_ = value;
+        if (!value)
+        {
+            shapes_.clear();
+        }
+    }
+
+    bool cache_shapes() const
+    {
+        return cache_shapes_;
+    }
+
+    // The number of depths with a shape to match
+    size_t cached_shape_count() const
+    {
+        size_t count = 0;
+        for (const auto& shape : shapes_)
+        {
+            if (shape.valid())
+            {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    // Borrowing is off by default. When on, a string value that the parser passes on as a
+    // view into [data, data + length), one without escapes, and that is too long to be
+    // stored in place, becomes a string view into the buffer instead of a copy. The buffer
+    // must outlive the result and every copy of it. Names are always copied, as are the
+    // strings of a text parsed from a stream. Call with nullptr to turn borrowing off.
+    void borrow_strings(const char_type* data, size_t length)
+    {
+        borrow_first_ = data;
+        borrow_last_ = data != nullptr ? data + length : nullptr;
+    }
+
+    bool borrow_strings() const
+    {
+        return borrow_first_ != nullptr;
+    }
+
 #if !defined(JSONCONS_NO_DEPRECATED)
     Json& root()
     {
@@ -88,12 +647,24 @@ public:
 
 private:
 
+    // Constructs the new items in place, rather than copying a prototype item into each,
+    // and moves the existing ones (stack_item's move constructor is noexcept)
+    void grow_stack(size_t size)
+    {
+        stack_.reserve(size);
+        while (stack_.size() < size)
+        {
+            stack_.emplace_back(sa_);
+        }
+    }
+
     void push_initial()
     {
         top_ = 0;
+        stack_offsets_.clear();
         if (top_ >= stack_.size())
         {
-            stack_.resize(top_*2);
+            grow_stack(default_stack_size);
         }
     }
 
@@ -107,11 +678,31 @@ private:
     void push_object()
     {
         stack_offsets_.push_back(top_);
+        if (counting_)
+        {
+            ++stats_.objects;
+            update_max_depth();
+        }
         stack_[top_].value_ = object(oa_);
+        if (cache_shapes_)
+        {
+            current_shape().begin();
+        }
         if (++top_ >= stack_.size())
         {
-            stack_.resize(top_*2);
+            grow_stack(top_*2);
+        }
+    }
+
+    // The shape of the object that is the innermost structure
+    object_shape<key_storage_type>& current_shape()
+    {
+        const size_t depth = stack_offsets_.size() - 1;
+        if (depth >= shapes_.size())
+        {
+            shapes_.resize(depth + 1);
         }
+        return shapes_[depth];
     }
 
     void pop_object()
@@ -123,10 +714,15 @@ private:
     void push_array()
     {
         stack_offsets_.push_back(top_);
+        if (counting_)
+        {
+            ++stats_.arrays;
+            update_max_depth();
+        }
         stack_[top_].value_ = array(aa_);
         if (++top_ >= stack_.size())
         {
-            stack_.resize(top_*2);
+            grow_stack(top_*2);
         }
     }
 
@@ -136,9 +732,22 @@ private:
         JSONCONS_ASSERT(top_ > 0);
     }
 
+    void update_max_depth()
+    {
+        if (stack_offsets_.size() > stats_.max_depth)
+        {
+            stats_.max_depth = stack_offsets_.size();
+        }
+    }
+
     void do_begin_json() override
     {
         is_valid_ = false;
+        if (counting_)
+        {
+            stats_.reset();
+        }
+        trace_.begin();
         push_initial();
     }
 
@@ -146,6 +755,12 @@ private:
     {
         is_valid_ = true;
         pop_initial();
+        if (trace_.active())
+        {
+            trace_.record().tokens = stats_.value_count() + stats_.names;
+            trace_.record().max_depth = stats_.max_depth;
+            trace_.end();
+        }
     }
 
     void do_begin_object(const parsing_context&) override
@@ -179,6 +794,11 @@ private:
         auto last = first + count;
         if (stack_[stack_offsets_.back()].value_.is_object())
         {
+            if (cache_shapes_ && end_shaped_object(structure_index, count))
+            {
+                top_ -= count;
+                return;
+            }
             stack_[structure_index].value_.object_value().insert(
                 std::make_move_iterator(first),
                 std::make_move_iterator(last),
@@ -197,73 +817,230 @@ private:
         top_ -= count;
     }
 
+    // Places the members of an object that matches its shape in order, or else has the shape
+    // learn its names, and returns false to have the members inserted as usual
+    bool end_shaped_object(size_t structure_index, size_t count)
+    {
+        auto& shape = current_shape();
+        auto first = stack_.begin() + (structure_index+1);
+        if (!shape.end(count))
+        {
+            shape.learn(first, first + count, [](const stack_item& item) -> const key_storage_type& {return item.name_;},
+                        !Json::implementation_policy::preserve_order);
+            return false;
+        }
+        if (counting_)
+        {
+            ++stats_.shape_hits;
+        }
+        ordered_members_.clear();
+        for (uint32_t pos : shape.order())
+        {
+            ordered_members_.push_back(&*(first + pos));
+        }
+        stack_[structure_index].value_.object_value().insert_unique(
+            ordered_members_.begin(),
+            ordered_members_.end(),
+            [](stack_item* item){return key_value_pair_type(std::move(item->name_),std::move(item->value_));});
+        return true;
+    }
+
     void do_name(const string_view_type& name, const parsing_context&) override
     {
-        stack_[top_].name_ = key_storage_type(name.begin(),name.end(),sa_);
+        if (counting_)
+        {
+            ++stats_.names;
+        }
+        if (cache_shapes_)
+        {
+            const key_storage_type* key = current_shape().match(top_ - stack_offsets_.back() - 1, name);
+            if (key != nullptr)
+            {
+                stack_[top_].name_ = *key;
+                return;
+            }
+        }
+        if (intern_keys_)
+        {
+            intern_name(name);
+        }
+        else
+        {
+            stack_[top_].name_ = key_storage_type(name.begin(),name.end(),sa_);
+        }
+    }
+
+    void intern_name(const string_view_type& name)
+    {
+        const size_t h = key_table_.hash(name);
+        const key_storage_type* key = key_table_.find(name, h);
+        if (key != nullptr)
+        {
+            stack_[top_].name_ = *key;
+        }
+        else
+        {
+            stack_[top_].name_ = key_storage_type(name.begin(),name.end(),sa_);
+            key_table_.insert(stack_[top_].name_, h);
+        }
     }
 
     void do_string_value(const string_view_type& val, const parsing_context&) override
     {
-        stack_[top_].value_ = Json(val.data(),val.length(),sa_);
+        if (counting_)
+        {
+            ++stats_.strings;
+        }
+        if (borrow_first_ != nullptr && val.length() > small_string_length &&
+            val.length() <= Json::variant::string_view_data::max_length &&
+            val.data() >= borrow_first_ && val.data() + val.length() <= borrow_last_)
+        {
+            stack_[top_].value_ = Json::make_string_view(val);
+        }
+        else if (intern_strings_ && val.length() > small_string_length &&
+                 val.length() <= string_intern_table<Json>::max_length)
+        {
+            intern_string(val);
+        }
+        else
+        {
+            stack_[top_].value_ = Json(val.data(),val.length(),sa_);
+        }
         if (++top_ >= stack_.size())
         {
-            stack_.resize(top_*2);
+            grow_stack(top_*2);
+        }
+    }
+
+    void intern_string(const string_view_type& val)
+    {
+        const size_t h = string_table_.hash(val);
+        const Json* value = string_table_.find(val, h);
+        if (value != nullptr)
+        {
+            stack_[top_].value_ = *value;
+        }
+        else
+        {
+            stack_[top_].value_ = Json(val.data(),val.length(),sa_);
+            string_table_.insert(stack_[top_].value_, h);
+        }
+    }
+
+    void do_escaped_string_value(const string_view_type& text, const parsing_context&) override
+    {
+        if (counting_)
+        {
+            ++stats_.strings;
+        }
+        stack_[top_].value_ = Json(Json::variant::escaped_string(text.data(),text.length(),sa_));
+        if (++top_ >= stack_.size())
+        {
+            grow_stack(top_*2);
         }
     }
 
     void do_byte_string_value(const uint8_t* data, size_t length, const parsing_context&) override
     {
+        if (counting_)
+        {
+            ++stats_.byte_strings;
+        }
         stack_[top_].value_ = Json(data,length,sa_);
         if (++top_ >= stack_.size())
         {
-            stack_.resize(top_*2);
+            grow_stack(top_*2);
         }
     }
 
     void do_integer_value(int64_t value, const parsing_context&) override
     {
+        if (counting_)
+        {
+            ++stats_.integers;
+        }
         stack_[top_].value_ = value;
         if (++top_ >= stack_.size())
         {
-            stack_.resize(top_*2);
+            grow_stack(top_*2);
         }
     }
 
     void do_uinteger_value(uint64_t value, const parsing_context&) override
     {
+        if (counting_)
+        {
+            ++stats_.uintegers;
+        }
         stack_[top_].value_ = value;
         if (++top_ >= stack_.size())
         {
-            stack_.resize(top_*2);
+            grow_stack(top_*2);
         }
     }
 
     void do_double_value(double value, uint8_t precision, const parsing_context&) override
     {
+        if (counting_)
+        {
+            ++stats_.doubles;
+        }
         stack_[top_].value_ = Json(value,precision);
         if (++top_ >= stack_.size())
         {
-            stack_.resize(top_*2);
+            grow_stack(top_*2);
+        }
+    }
+
+    // A number that the parser passes on as text, see basic_json_parser::keep_number_text,
+    // is kept as text, and converted when it is accessed
+    void do_number_value(const string_view_type& text, const parsing_context&) override
+    {
+        if (counting_)
+        {
+            ++stats_.numbers;
+        }
+        stack_[top_].value_ = Json(Json::variant::number_text(text.data(),text.length(),get_allocator()));
+        if (++top_ >= stack_.size())
+        {
+            grow_stack(top_*2);
         }
     }
 
     void do_bool_value(bool value, const parsing_context&) override
     {
+        if (counting_)
+        {
+            ++stats_.bools;
+        }
         stack_[top_].value_ = value;
         if (++top_ >= stack_.size())
         {
-            stack_.resize(top_*2);
+            grow_stack(top_*2);
         }
     }
 
     void do_null_value(const parsing_context&) override
     {
+        if (counting_)
+        {
+            ++stats_.nulls;
+        }
         stack_[top_].value_ = Json::null();
         if (++top_ >= stack_.size())
         {
-            stack_.resize(top_*2);
+            grow_stack(top_*2);
         }
     }
+
+    // The events of a tape are passed to the functions above without a virtual call each
+    void do_events(const basic_json_event_tape<char_type>& tape) override
+    {
+        detail::direct_input_events<json_decoder> handler(*this);
+        tape.replay(handler);
+    }
+
+    friend class detail::direct_input_events<json_decoder>;
 };
 
 }
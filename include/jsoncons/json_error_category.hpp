@@ -43,7 +43,10 @@ namespace jsoncons {
         over_long_utf8_sequence,
         illegal_codepoint,
         illegal_surrogate_value,
-        unpaired_high_surrogate
+        unpaired_high_surrogate,
+        max_input_length_exceeded,
+        max_string_length_exceeded,
+        max_items_exceeded
     };
 
 class json_error_category_impl
@@ -116,6 +119,12 @@ public:
             return "UTF-16 surrogate values are illegal in UTF-32";
         case json_parser_errc::unpaired_high_surrogate:
             return "Expected low surrogate following the high surrogate";
+        case json_parser_errc::max_input_length_exceeded:
+            return "Maximum input length exceeded";
+        case json_parser_errc::max_string_length_exceeded:
+            return "Maximum string length exceeded";
+        case json_parser_errc::max_items_exceeded:
+            return "Maximum number of array elements or object members exceeded";
        default:
             return "Unknown JSON parser error";
         }
@@ -136,6 +145,61 @@ std::error_code make_error_code(json_parser_errc result)
 }
 
 
+// json_errc
+// Errors of the basic_json accessors that report through a std::error_code rather than
+// throw, try_as and at
+
+enum class json_errc
+{
+    ok = 0,
+    not_convertible = 1,
+    key_not_found,
+    index_out_of_range,
+    not_an_object,
+    not_an_array
+};
+
+class json_errc_category_impl
+   : public std::error_category
+{
+public:
+    virtual const char* name() const JSONCONS_NOEXCEPT
+    {
+        return "json access";
+    }
+    virtual std::string message(int ev) const
+    {
+        switch (static_cast<json_errc>(ev))
+        {
+        case json_errc::not_convertible:
+            return "Value not convertible to the requested type";
+        case json_errc::key_not_found:
+            return "Key not found";
+        case json_errc::index_out_of_range:
+            return "Index out of range";
+        case json_errc::not_an_object:
+            return "Not an object";
+        case json_errc::not_an_array:
+            return "Not an array";
+        default:
+            return "Unknown json access error";
+        }
+    }
+};
+
+inline
+const std::error_category& json_errc_category()
+{
+  static json_errc_category_impl instance;
+  return instance;
+}
+
+inline 
+std::error_code make_error_code(json_errc result)
+{
+    return std::error_code(static_cast<int>(result),json_errc_category());
+}
+
 }
 
 namespace std {
@@ -143,6 +207,11 @@ namespace std {
     struct is_error_code_enum<jsoncons::json_parser_errc> : public true_type
     {
     };
+
+    template<>
+    struct is_error_code_enum<jsoncons::json_errc> : public true_type
+    {
+    };
 }
 
 #endif
@@ -0,0 +1,371 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSON_EVENT_TAPE_HPP
+#define JSONCONS_JSON_EVENT_TAPE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <jsoncons/jsoncons_utilities.hpp>
+#include <jsoncons/parse_error_handler.hpp>
+
+namespace jsoncons {
+
+enum class tape_event_kind : uint8_t
+{
+    begin_json,
+    end_json,
+    begin_object,
+    end_object,
+    begin_array,
+    end_array,
+    name,
+    string_value,
+    escaped_string_value,
+    byte_string_value,
+    integer_value,
+    uinteger_value,
+    double_value,
+    number_value,
+    bool_value,
+    null_value
+};
+
+// The events of a part of a text, recorded one after the other so that they can be handed
+// to a handler in one call. The tape has the same event functions as a handler, so a
+// basic_json_parser can be given it as its Handler and record into it without a virtual
+// call per event. Names, strings and the text of numbers that lie in the source, set by
+// source(), are recorded as pointers into it, and others, such as strings with escapes
+// that the parser has replaced, are copied to a buffer of the tape. The tape is a
+// parsing_context, with the line and column set by whoever fills it, and replay passes it
+// with each event.
+
+template <class CharT>
+class basic_json_event_tape : public parsing_context
+{
+public:
+    typedef CharT char_type;
+    typedef std::char_traits<char_type> char_traits_type;
+#if !defined(JSONCONS_HAS_STRING_VIEW)
+    typedef Basic_string_view_<char_type,char_traits_type> string_view_type;
+#else
+    typedef std::basic_string_view<char_type,char_traits_type> string_view_type;
+#endif
+private:
+    struct entry
+    {
+        union
+        {
+            int64_t integer;
+            uint64_t uinteger;
+            double floating_point;
+            const char_type* data;
+            size_t offset;
+            bool boolean;
+        };
+        size_t length;
+        tape_event_kind kind;
+        uint8_t precision;
+        // Whether data points into the source, rather than offset being into buffer_
+        bool in_source;
+    };
+
+    std::vector<entry> entries_;
+    std::basic_string<char_type> buffer_;
+    std::vector<uint8_t> bytes_;
+    const char_type* source_first_;
+    const char_type* source_last_;
+    size_t line_;
+    size_t column_;
+public:
+    basic_json_event_tape()
+        : source_first_(nullptr), source_last_(nullptr), line_(1), column_(1)
+    {
+    }
+
+    // The text that the strings of the events recorded until the tape is next cleared may
+    // point into, which must outlive them
+    void source(const char_type* data, size_t length)
+    {
+        source_first_ = data;
+        source_last_ = data != nullptr ? data + length : nullptr;
+    }
+
+    void position(size_t line, size_t column)
+    {
+        line_ = line;
+        column_ = column;
+    }
+
+    size_t size() const
+    {
+        return entries_.size();
+    }
+
+    bool empty() const
+    {
+        return entries_.empty();
+    }
+
+    // Removes the events, keeping the capacity of the tape
+    void clear()
+    {
+        entries_.clear();
+        buffer_.clear();
+        bytes_.clear();
+    }
+
+    void reserve(size_t count)
+    {
+        entries_.reserve(count);
+    }
+
+    tape_event_kind kind(size_t i) const
+    {
+        return entries_[i].kind;
+    }
+
+    // The name, string, escaped string or number text of event i
+    string_view_type text(size_t i) const
+    {
+        return text(entries_[i]);
+    }
+
+    const uint8_t* bytes(size_t i) const
+    {
+        return bytes_.data() + entries_[i].offset;
+    }
+
+    size_t length(size_t i) const
+    {
+        return entries_[i].length;
+    }
+
+    int64_t integer(size_t i) const
+    {
+        return entries_[i].integer;
+    }
+
+    uint64_t uinteger(size_t i) const
+    {
+        return entries_[i].uinteger;
+    }
+
+    double floating_point(size_t i) const
+    {
+        return entries_[i].floating_point;
+    }
+
+    uint8_t precision(size_t i) const
+    {
+        return entries_[i].precision;
+    }
+
+    bool boolean(size_t i) const
+    {
+        return entries_[i].boolean;
+    }
+
+    // Calls the event functions of handler for the events, in order, with the tape as the
+    // parsing_context. Handler is a basic_json_input_handler, or any class with the same
+    // event functions.
+    template <class Handler>
+    void replay(Handler& handler) const
+    {
+        const entry* last = entries_.data() + entries_.size();
+        for (const entry* e = entries_.data(); e != last; ++e)
+        {
+            switch (e->kind)
+            {
+                case tape_event_kind::begin_json:
+                    handler.begin_json();
+                    break;
+                case tape_event_kind::end_json:
+                    handler.end_json();
+                    break;
+                case tape_event_kind::begin_object:
+                    handler.begin_object(*this);
+                    break;
+                case tape_event_kind::end_object:
+                    handler.end_object(*this);
+                    break;
+                case tape_event_kind::begin_array:
+                    handler.begin_array(*this);
+                    break;
+                case tape_event_kind::end_array:
+                    handler.end_array(*this);
+                    break;
+                case tape_event_kind::name:
+                    handler.name(text(*e), *this);
+                    break;
+                case tape_event_kind::string_value:
+                    handler.string_value(text(*e), *this);
+                    break;
+                case tape_event_kind::escaped_string_value:
+                    handler.escaped_string_value(text(*e), *this);
+                    break;
+                case tape_event_kind::byte_string_value:
+                    handler.byte_string_value(bytes_.data() + e->offset, e->length, *this);
+                    break;
+                case tape_event_kind::integer_value:
+                    handler.integer_value(e->integer, *this);
+                    break;
+                case tape_event_kind::uinteger_value:
+                    handler.uinteger_value(e->uinteger, *this);
+                    break;
+                case tape_event_kind::double_value:
+                    handler.double_value(e->floating_point, e->precision, *this);
+                    break;
+                case tape_event_kind::number_value:
+                    handler.number_value(text(*e), *this);
+                    break;
+                case tape_event_kind::bool_value:
+                    handler.bool_value(e->boolean, *this);
+                    break;
+                case tape_event_kind::null_value:
+                    handler.null_value(*this);
+                    break;
+            }
+        }
+    }
+
+    // The event functions, which record the events
+
+    void begin_json()
+    {
+        push(tape_event_kind::begin_json);
+    }
+
+    void end_json()
+    {
+        push(tape_event_kind::end_json);
+    }
+
+    void begin_object(const parsing_context&)
+    {
+        push(tape_event_kind::begin_object);
+    }
+
+    void end_object(const parsing_context&)
+    {
+        push(tape_event_kind::end_object);
+    }
+
+    void begin_array(const parsing_context&)
+    {
+        push(tape_event_kind::begin_array);
+    }
+
+    void end_array(const parsing_context&)
+    {
+        push(tape_event_kind::end_array);
+    }
+
+    void name(const string_view_type& name, const parsing_context&)
+    {
+        push_text(tape_event_kind::name, name);
+    }
+
+    void string_value(const string_view_type& value, const parsing_context&)
+    {
+        push_text(tape_event_kind::string_value, value);
+    }
+
+    void escaped_string_value(const string_view_type& text, const parsing_context&)
+    {
+        push_text(tape_event_kind::escaped_string_value, text);
+    }
+
+    void byte_string_value(const uint8_t* data, size_t length, const parsing_context&)
+    {
+        entry& e = push(tape_event_kind::byte_string_value);
+        e.offset = bytes_.size();
+        e.length = length;
+        bytes_.insert(bytes_.end(), data, data + length);
+    }
+
+    void integer_value(int64_t value, const parsing_context&)
+    {
+        push(tape_event_kind::integer_value).integer = value;
+    }
+
+    void uinteger_value(uint64_t value, const parsing_context&)
+    {
+        push(tape_event_kind::uinteger_value).uinteger = value;
+    }
+
+    void double_value(double value, uint8_t precision, const parsing_context&)
+    {
+        entry& e = push(tape_event_kind::double_value);
+        e.floating_point = value;
+        e.precision = precision;
+    }
+
+    void number_value(const string_view_type& text, const parsing_context&)
+    {
+        push_text(tape_event_kind::number_value, text);
+    }
+
+    void bool_value(bool value, const parsing_context&)
+    {
+        push(tape_event_kind::bool_value).boolean = value;
+    }
+
+    void null_value(const parsing_context&)
+    {
+        push(tape_event_kind::null_value);
+    }
+private:
+    string_view_type text(const entry& e) const
+    {
+        return string_view_type(e.in_source ? e.data : buffer_.data() + e.offset, e.length);
+    }
+
+    entry& push(tape_event_kind kind)
+    {
+        entries_.emplace_back();
+        entry& e = entries_.back();
+        e.kind = kind;
+        e.precision = 0;
+        e.in_source = false;
+        e.length = 0;
+        return e;
+    }
+
+    void push_text(tape_event_kind kind, const string_view_type& s)
+    {
+        entry& e = push(kind);
+        e.length = s.length();
+        if (s.data() >= source_first_ && s.data() + s.length() <= source_last_ && source_first_ != nullptr)
+        {
+            e.data = s.data();
+            e.in_source = true;
+        }
+        else
+        {
+            e.offset = buffer_.size();
+            buffer_.append(s.data(), s.length());
+        }
+    }
+
+    size_t do_line_number() const override
+    {
+        return line_;
+    }
+
+    size_t do_column_number() const override
+    {
+        return column_;
+    }
+};
+
+typedef basic_json_event_tape<char> json_event_tape;
+typedef basic_json_event_tape<wchar_t> wjson_event_tape;
+
+}
+
+#endif
@@ -106,6 +106,16 @@ private:
         output_handler_.double_value(value, precision);
     }
 
+    void do_number_value(const string_view_type& text, const parsing_context&) override
+    {
+        output_handler_.number_value(text);
+    }
+
+    void do_escaped_string_value(const string_view_type& text, const parsing_context&) override
+    {
+        output_handler_.escaped_string_value(text);
+    }
+
     void do_bool_value(bool value, const parsing_context&) override
     {
         output_handler_.bool_value(value);
@@ -115,6 +125,11 @@ private:
     {
         output_handler_.null_value();
     }
+
+    void do_events(const basic_json_event_tape<CharT>& tape) override
+    {
+        output_handler_.events(tape);
+    }
 };
 
 template <class CharT>
@@ -220,6 +235,16 @@ private:
         input_handler_.double_value(value, precision, default_context_);
     }
 
+    void do_number_value(const string_view_type& text) override
+    {
+        input_handler_.number_value(text, default_context_);
+    }
+
+    void do_escaped_string_value(const string_view_type& text) override
+    {
+        input_handler_.escaped_string_value(text, default_context_);
+    }
+
     void do_bool_value(bool value) override
     {
         input_handler_.bool_value(value, default_context_);
@@ -229,6 +254,11 @@ private:
     {
         input_handler_.null_value(default_context_);
     }
+
+    void do_events(const basic_json_event_tape<CharT>& tape) override
+    {
+        input_handler_.events(tape);
+    }
 };
 
 template <class CharT>
@@ -345,6 +375,12 @@ private:
         downstream_handler_.uinteger_value(value,context);
     }
 
+    void do_number_value(const string_view_type& text,
+                         const parsing_context& context) override
+    {
+        downstream_handler_.number_value(text,context);
+    }
+
     void do_bool_value(bool value,
                  const parsing_context& context) override
     {
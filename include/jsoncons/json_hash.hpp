@@ -0,0 +1,167 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSON_HASH_HPP
+#define JSONCONS_JSON_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include <jsoncons/json.hpp>
+
+namespace jsoncons {
+
+namespace detail {
+
+inline
+size_t hash_combine(size_t seed, size_t h)
+{
+    return seed ^ (h + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+template <class T>
+size_t hash_chars(const T* p, size_t length)
+{
+    // FNV-1a
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; ++i)
+    {
+        h = (h ^ static_cast<uint64_t>(p[i])) * 1099511628211ULL;
+    }
+    return static_cast<size_t>(h);
+}
+
+template <class Json>
+size_t scalar_hash(const Json& val)
+{
+    if (val.is_string())
+    {
+        auto sv = val.as_string_view();
+        return hash_chars(sv.data(), sv.length());
+    }
+    else if (val.is_number())
+    {
+        double d = val.as_double();
+        if (d == 0)
+        {
+            return 0x2545f491; // 0.0 and -0.0
+        }
+        uint64_t bits;
+        std::memcpy(&bits, &d, sizeof(bits));
+        return static_cast<size_t>(bits ^ (bits >> 32));
+    }
+    else if (val.is_bool())
+    {
+        return val.as_bool() ? 0x4b7fa3c1 : 0x1d8e4e27;
+    }
+    else if (val.is_byte_string())
+    {
+        auto bs = val.as_byte_string_view();
+        return hash_combine(0x5bd1e995, hash_chars(bs.data(), bs.length()));
+    }
+    return 0x27d4eb2f; // null
+}
+
+// The hash of val, with the elements and member values of an array or object hashed by hash
+template <class Json, class Hash>
+size_t structural_hash(const Json& val, Hash hash)
+{
+    if (val.is_array())
+    {
+        size_t h = 0x9e3779b9 + val.size();
+        for (const auto& element : val.array_range())
+        {
+            h = hash_combine(h, hash(element));
+        }
+        return h;
+    }
+    else if (val.is_object())
+    {
+        // A sum of the member hashes does not depend on their order
+        size_t sum = 0;
+        for (const auto& member : val.object_range())
+        {
+            sum += hash_combine(hash_chars(member.key().data(), member.key().length()), hash(member.value()));
+        }
+        return hash_combine(0x7f4a7c15 + val.size(), sum);
+    }
+    else
+    {
+        return scalar_hash(val);
+    }
+}
+
+}
+
+// The structural hash of a json value, computed afresh on each call. Values that are equal
+// have equal hashes: numbers hash by their value as a double, as 1 and 1.0 are equal, and
+// objects hash without regard to the order of their members. std::hash<basic_json> is this
+// hash, so that values can be kept in unordered containers.
+
+template <class Json>
+struct json_hash
+{
+    size_t operator()(const Json& val) const
+    {
+        return detail::structural_hash(val, *this);
+    }
+};
+
+// Structural hashes of a json value and the arrays and objects in it, computed when first
+// asked for and kept, so that subtrees with different hashes are known to be different
+// without comparing them. The hashes are those of json_hash. They are kept by address, and
+// are only valid as long as the values are not modified. Equal hashes do not make values
+// equal, equal() compares them.
+
+template <class Json>
+class json_hash_cache
+{
+    std::unordered_map<const Json*,size_t> hashes_;
+public:
+    size_t hash(const Json& val)
+    {
+        if (!val.is_array() && !val.is_object())
+        {
+            return detail::scalar_hash(val);
+        }
+        auto it = hashes_.find(std::addressof(val));
+        if (it != hashes_.end())
+        {
+            return it->second;
+        }
+        size_t h = detail::structural_hash(val, [this](const Json& v){return hash(v);});
+        hashes_.insert(std::make_pair(std::addressof(val), h));
+        return h;
+    }
+
+    // Subtrees with different hashes are not compared
+    bool equal(const Json& a, const Json& b)
+    {
+        return std::addressof(a) == std::addressof(b) || (hash(a) == hash(b) && a == b);
+    }
+
+    void clear()
+    {
+        hashes_.clear();
+    }
+};
+
+}
+
+namespace std {
+
+template <class CharT,class JsonPolicy,class Allocator>
+struct hash<jsoncons::basic_json<CharT,JsonPolicy,Allocator>>
+    : jsoncons::json_hash<jsoncons::basic_json<CharT,JsonPolicy,Allocator>>
+{
+};
+
+}
+
+#endif
@@ -10,6 +10,9 @@
 #include <string>
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/jsoncons_utilities.hpp>
+#include <jsoncons/detail/number_text.hpp>
+#include <jsoncons/detail/escaped_string.hpp>
+#include <jsoncons/json_event_tape.hpp>
 #if !defined(JSONCONS_NO_DEPRECATED)
 #include <jsoncons/json_type_traits.hpp> // for null_type
 #endif
@@ -75,6 +78,14 @@ public:
         do_string_value(value, context);
     }
 
+    // A string as the text between its quotation marks in the source, escapes and all, for a
+    // handler that keeps it as it is. By default the escapes are replaced and the string is
+    // passed on as string_value.
+    void escaped_string_value(const string_view_type& text, const parsing_context& context) 
+    {
+        do_escaped_string_value(text, context);
+    }
+
     void byte_string_value(const uint8_t* data, size_t length, const parsing_context& context) 
     {
         do_byte_string_value(data, length, context);
@@ -107,6 +118,14 @@ public:
         }
     }
 
+    // A number as the text it has in the source, for a handler that keeps it as it is.
+    // By default the text is converted and passed on as integer_value, uinteger_value
+    // or double_value.
+    void number_value(const string_view_type& text, const parsing_context& context)
+    {
+        do_number_value(text, context);
+    }
+
     void bool_value(bool value, const parsing_context& context) 
     {
         do_bool_value(value,context);
@@ -117,6 +136,13 @@ public:
         do_null_value(context);
     }
 
+    // The events of a tape, in one call. By default they are passed to the event functions
+    // one by one.
+    void events(const basic_json_event_tape<CharT>& tape)
+    {
+        do_events(tape);
+    }
+
 #if !defined(JSONCONS_NO_DEPRECATED)
 
     void name(const CharT* p, size_t length, const parsing_context& context) 
@@ -218,6 +244,36 @@ private:
     virtual void do_uinteger_value(uint64_t value, const parsing_context& context) = 0;
 
     virtual void do_bool_value(bool value, const parsing_context& context) = 0;
+
+    virtual void do_number_value(const string_view_type& text, const parsing_context& context)
+    {
+        detail::number_text_value value = detail::read_number_text(text.data(), text.length());
+        switch (value.kind)
+        {
+            case detail::number_text_kind::integer:
+                do_integer_value(value.integer, context);
+                break;
+            case detail::number_text_kind::uinteger:
+                do_uinteger_value(value.uinteger, context);
+                break;
+            default:
+                do_double_value(value.floating_point, value.precision, context);
+                break;
+        }
+    }
+
+    virtual void do_escaped_string_value(const string_view_type& text, const parsing_context& context)
+    {
+        std::basic_string<CharT> s;
+        s.reserve(text.length());
+        detail::unescape_string(text.data(), text.length(), s);
+        do_string_value(string_view_type(s.data(), s.length()), context);
+    }
+
+    virtual void do_events(const basic_json_event_tape<CharT>& tape)
+    {
+        tape.replay(*this);
+    }
 };
 
 template <class CharT>
@@ -283,6 +339,164 @@ private:
     }
 };
 
+namespace detail {
+
+// Handlers that are not a basic_json_input_handler, as the parser and a pipeline may be given,
+// need not have number_value or escaped_string_value, and then get the converted value
+
+template <class Handler, class StringView>
+auto forward_number_value(Handler& handler, const StringView& text, const parsing_context& context, int)
+    -> decltype(handler.number_value(text, context), void())
+{
+    handler.number_value(text, context);
+}
+
+template <class Handler, class StringView>
+void forward_number_value(Handler& handler, const StringView& text, const parsing_context& context, long)
+{
+    number_text_value value = read_number_text(text.data(), text.length());
+    switch (value.kind)
+    {
+        case number_text_kind::integer:
+            handler.integer_value(value.integer, context);
+            break;
+        case number_text_kind::uinteger:
+            handler.uinteger_value(value.uinteger, context);
+            break;
+        default:
+            handler.double_value(value.floating_point, value.precision, context);
+            break;
+    }
+}
+
+template <class Handler, class StringView>
+void forward_number_value(Handler& handler, const StringView& text, const parsing_context& context)
+{
+    forward_number_value(handler, text, context, 0);
+}
+
+template <class Handler, class StringView>
+auto forward_escaped_string_value(Handler& handler, const StringView& text, const parsing_context& context, int)
+    -> decltype(handler.escaped_string_value(text, context), void())
+{
+    handler.escaped_string_value(text, context);
+}
+
+template <class Handler, class StringView>
+void forward_escaped_string_value(Handler& handler, const StringView& text, const parsing_context& context, long)
+{
+    std::basic_string<typename StringView::value_type> s;
+    s.reserve(text.length());
+    unescape_string(text.data(), text.length(), s);
+    handler.string_value(StringView(s.data(), s.length()), context);
+}
+
+template <class Handler, class StringView>
+void forward_escaped_string_value(Handler& handler, const StringView& text, const parsing_context& context)
+{
+    forward_escaped_string_value(handler, text, context, 0);
+}
+
+// Passes the events of a tape to the overrides of a handler by their qualified names, so
+// that the calls are not virtual, for a handler whose do_events replays a tape into it.
+// The handler makes it a friend. number_value and escaped_string_value, which a handler
+// need not override, are passed through the virtual functions.
+
+template <class Handler>
+class direct_input_events
+{
+    Handler& handler_;
+public:
+    typedef typename Handler::string_view_type string_view_type;
+
+    direct_input_events(Handler& handler)
+        : handler_(handler)
+    {
+    }
+
+    void begin_json()
+    {
+        handler_.Handler::do_begin_json();
+    }
+
+    void end_json()
+    {
+        handler_.Handler::do_end_json();
+    }
+
+    void begin_object(const parsing_context& context)
+    {
+        handler_.Handler::do_begin_object(context);
+    }
+
+    void end_object(const parsing_context& context)
+    {
+        handler_.Handler::do_end_object(context);
+    }
+
+    void begin_array(const parsing_context& context)
+    {
+        handler_.Handler::do_begin_array(context);
+    }
+
+    void end_array(const parsing_context& context)
+    {
+        handler_.Handler::do_end_array(context);
+    }
+
+    void name(const string_view_type& name, const parsing_context& context)
+    {
+        handler_.Handler::do_name(name, context);
+    }
+
+    void string_value(const string_view_type& value, const parsing_context& context)
+    {
+        handler_.Handler::do_string_value(value, context);
+    }
+
+    void escaped_string_value(const string_view_type& text, const parsing_context& context)
+    {
+        handler_.escaped_string_value(text, context);
+    }
+
+    void byte_string_value(const uint8_t* data, size_t length, const parsing_context& context)
+    {
+        handler_.Handler::do_byte_string_value(data, length, context);
+    }
+
+    void integer_value(int64_t value, const parsing_context& context)
+    {
+        handler_.Handler::do_integer_value(value, context);
+    }
+
+    void uinteger_value(uint64_t value, const parsing_context& context)
+    {
+        handler_.Handler::do_uinteger_value(value, context);
+    }
+
+    void double_value(double value, uint8_t precision, const parsing_context& context)
+    {
+        handler_.Handler::do_double_value(value, precision == 0 ? std::numeric_limits<double>::digits10 : precision, context);
+    }
+
+    void number_value(const string_view_type& text, const parsing_context& context)
+    {
+        handler_.number_value(text, context);
+    }
+
+    void bool_value(bool value, const parsing_context& context)
+    {
+        handler_.Handler::do_bool_value(value, context);
+    }
+
+    void null_value(const parsing_context& context)
+    {
+        handler_.Handler::do_null_value(context);
+    }
+};
+
+}
+
 typedef basic_json_input_handler<char> json_input_handler;
 typedef basic_json_input_handler<wchar_t> wjson_input_handler;
 
@@ -0,0 +1,203 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSON_MAPPED_READER_HPP
+#define JSONCONS_JSON_MAPPED_READER_HPP
+
+#include <string>
+#include <system_error>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/json_input_handler.hpp>
+#include <jsoncons/parse_error_handler.hpp>
+#include <jsoncons/json_parser.hpp>
+#include <jsoncons/detail/mapped_file.hpp>
+
+namespace jsoncons {
+
+// Reads JSON text from a memory mapped file. The whole mapping is passed to the parser
+// as one source, so unlike basic_json_reader no data is copied into an intermediate buffer.
+// Names and string values without escapes are passed to the input handler as views into
+// the mapping, which remain valid for the lifetime of the reader.
+
+template<class CharT>
+class basic_json_mapped_reader
+{
+    std::error_code open_ec_;
+    detail::mapped_file file_;
+    basic_json_parser<CharT> parser_;
+    bool begin_;
+
+    // Noncopyable and nonmoveable
+    basic_json_mapped_reader(const basic_json_mapped_reader&) = delete;
+    basic_json_mapped_reader& operator=(const basic_json_mapped_reader&) = delete;
+
+public:
+    basic_json_mapped_reader(const std::string& filename,
+                             basic_json_input_handler<CharT>& handler)
+        : file_(filename, open_ec_),
+          parser_(handler),
+          begin_(true)
+    {
+    }
+
+    basic_json_mapped_reader(const std::string& filename,
+                             basic_json_input_handler<CharT>& handler,
+                             parse_error_handler& err_handler)
+       : file_(filename, open_ec_),
+         parser_(handler,err_handler),
+         begin_(true)
+    {
+    }
+
+    size_t max_nesting_depth() const
+    {
+        return parser_.max_nesting_depth();
+    }
+
+    void max_nesting_depth(size_t depth)
+    {
+        parser_.max_nesting_depth(depth);
+    }
+
+    size_t max_input_length() const
+    {
+        return parser_.max_input_length();
+    }
+
+    void max_input_length(size_t length)
+    {
+        parser_.max_input_length(length);
+    }
+
+    size_t max_string_length() const
+    {
+        return parser_.max_string_length();
+    }
+
+    void max_string_length(size_t length)
+    {
+        parser_.max_string_length(length);
+    }
+
+    size_t max_items() const
+    {
+        return parser_.max_items();
+    }
+
+    void max_items(size_t count)
+    {
+        parser_.max_items(count);
+    }
+
+    // The error the file could not be opened or mapped with, if any
+    std::error_code open_error() const
+    {
+        return open_ec_;
+    }
+
+    void read_next()
+    {
+        std::error_code ec;
+        read_next(ec);
+        if (ec)
+        {
+            throw parse_error(ec,parser_.line_number(),parser_.column_number());
+        }
+    }
+
+    void read_next(std::error_code& ec)
+    {
+        if (open_ec_)
+        {
+            ec = open_ec_;
+            return;
+        }
+        if (begin_)
+        {
+            // A file that ends part way through a character is truncated
+            if (file_.size() % sizeof(CharT) != 0)
+            {
+                ec = json_parser_errc::unexpected_eof;
+                return;
+            }
+            const CharT* first = reinterpret_cast<const CharT*>(file_.data());
+            const CharT* last = first + file_.size()/sizeof(CharT);
+            auto result = unicons::skip_bom(first, last);
+            if (result.ec != unicons::encoding_errc())
+            {
+                ec = result.ec;
+                return;
+            }
+            parser_.set_source(result.it, last - result.it);
+            begin_ = false;
+        }
+        parser_.reset();
+        parser_.parse(ec);
+        if (ec) return;
+        if (parser_.source_exhausted())
+        {
+            parser_.end_parse(ec);
+            if (ec) return;
+        }
+    }
+
+    void check_done()
+    {
+        std::error_code ec;
+        check_done(ec);
+        if (ec)
+        {
+            throw parse_error(ec,parser_.line_number(),parser_.column_number());
+        }
+    }
+
+    void check_done(std::error_code& ec)
+    {
+        if (open_ec_)
+        {
+            ec = open_ec_;
+            return;
+        }
+        parser_.check_done(ec);
+    }
+
+    size_t line_number() const
+    {
+        return parser_.line_number();
+    }
+
+    size_t column_number() const
+    {
+        return parser_.column_number();
+    }
+
+    bool eof() const
+    {
+        return !begin_ && parser_.source_exhausted();
+    }
+
+    void read()
+    {
+        read_next();
+        check_done();
+    }
+
+    void read(std::error_code& ec)
+    {
+        read_next(ec);
+        if (!ec)
+        {
+            check_done(ec);
+        }
+    }
+};
+
+typedef basic_json_mapped_reader<char> json_mapped_reader;
+typedef basic_json_mapped_reader<wchar_t> wjson_mapped_reader;
+
+}
+
+#endif
@@ -0,0 +1,373 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSON_MEMBER_TRAITS_HPP
+#define JSONCONS_JSON_MEMBER_TRAITS_HPP
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <jsoncons/json_output_handler.hpp>
+#include <jsoncons/json_type_traits.hpp>
+#include <jsoncons/serialization_traits.hpp>
+
+namespace jsoncons {
+
+// json_member_traits
+
+// Lists the members of a struct T for serialization_traits, json_type_traits and
+// decode_json. A specialization, usually declared with JSONCONS_MEMBER_TRAITS_DECL,
+// defines
+//
+//     template <class Visitor>
+//     static void members(Visitor& visitor)
+//     {
+//         visitor("author", 6, detail::member_name_hash("author"), 
+//                 detail::member_pointer_constant<book,std::string,&book::author>());
+//         ...
+//     }
+//
+// passing each member's name, its length, its hash, and a type that names the member.
+// Names are ASCII.
+
+template <class T, class Enable = void>
+struct json_member_traits
+{
+    static const bool is_specialized = false;
+};
+
+namespace detail {
+
+// FNV-1a, usable in constant expressions for the hashes of member names, and at run
+// time for the names read from JSON text
+
+constexpr uint64_t member_name_hash_(const char* s, uint64_t h)
+{
+    return *s == 0 ? h : member_name_hash_(s + 1, (h ^ static_cast<uint8_t>(*s)) * 1099511628211ULL);
+}
+
+constexpr uint64_t member_name_hash(const char* s)
+{
+    return member_name_hash_(s, 14695981039346656037ULL);
+}
+
+template <class CharT>
+uint64_t member_name_hash(const CharT* s, size_t length)
+{
+    typedef typename std::make_unsigned<CharT>::type unsigned_type;
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; ++i)
+    {
+        h = (h ^ static_cast<uint64_t>(static_cast<unsigned_type>(s[i]))) * 1099511628211ULL;
+    }
+    return h;
+}
+
+template <class CharT>
+bool member_name_equals(const char* name, size_t length, const CharT* s, size_t n)
+{
+    if (length != n)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < length; ++i)
+    {
+        if (static_cast<CharT>(name[i]) != s[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Names the member Ptr of T, so that code that depends on it can be generated per member
+
+template <class T, class M, M T::*Ptr>
+struct member_pointer_constant
+{
+    typedef T class_type;
+    typedef M value_type;
+
+    static M& get(T& val)
+    {
+        return val.*Ptr;
+    }
+
+    static const M& get(const T& val)
+    {
+        return val.*Ptr;
+    }
+};
+
+// A member name as a string of CharT, copied only when CharT is not char
+
+template <class CharT>
+class member_name_string
+{
+    std::basic_string<CharT> s_;
+public:
+    member_name_string(const char* name, size_t length)
+        : s_(name, name + length)
+    {
+    }
+
+    const CharT* data() const
+    {
+        return s_.data();
+    }
+
+    size_t length() const
+    {
+        return s_.length();
+    }
+};
+
+template <>
+class member_name_string<char>
+{
+    const char* name_;
+    size_t length_;
+public:
+    member_name_string(const char* name, size_t length)
+        : name_(name), length_(length)
+    {
+    }
+
+    const char* data() const
+    {
+        return name_;
+    }
+
+    size_t length() const
+    {
+        return length_;
+    }
+};
+
+template <class T, class CharT>
+struct member_writer
+{
+    const T& val;
+    basic_json_output_handler<CharT>& handler;
+
+    template <class Member>
+    void operator()(const char* name, size_t length, uint64_t, Member)
+    {
+        member_name_string<CharT> s(name, length);
+        handler.name(s.data(), s.length());
+        serialization_traits<typename Member::value_type>::encode(Member::get(val), handler);
+    }
+};
+
+template <class Json, class T>
+struct member_checker
+{
+    const Json& j;
+    bool result;
+
+    template <class Member>
+    void operator()(const char* name, size_t length, uint64_t, Member)
+    {
+        if (result)
+        {
+            member_name_string<typename Json::char_type> s(name, length);
+            auto it = j.find(typename Json::string_view_type(s.data(), s.length()));
+            result = it != j.object_range().end() && 
+                     it->value().template is<typename Member::value_type>();
+        }
+    }
+};
+
+template <class Json, class T>
+struct member_reader
+{
+    const Json& j;
+    T& val;
+
+    template <class Member>
+    void operator()(const char* name, size_t length, uint64_t, Member)
+    {
+        member_name_string<typename Json::char_type> s(name, length);
+        auto it = j.find(typename Json::string_view_type(s.data(), s.length()));
+        if (it != j.object_range().end())
+        {
+            Member::get(val) = it->value().template as<typename Member::value_type>();
+        }
+    }
+};
+
+template <class Json, class T>
+struct member_inserter
+{
+    const T& val;
+    Json& j;
+
+    template <class Member>
+    void operator()(const char* name, size_t length, uint64_t, Member)
+    {
+        member_name_string<typename Json::char_type> s(name, length);
+        j.insert_or_assign(typename Json::string_view_type(s.data(), s.length()), Json(Member::get(val)));
+    }
+};
+
+}
+
+// Writes the members of T in the order they are listed, without building a basic_json
+
+template<class T>
+struct serialization_traits<T,
+    typename std::enable_if<json_member_traits<T>::is_specialized
+>::type>
+{
+    template <class CharT>
+    static void encode(const T& val, basic_json_output_handler<CharT>& handler)
+    {
+        handler.begin_object();
+        detail::member_writer<T,CharT> writer{val, handler};
+        json_member_traits<T>::members(writer);
+        handler.end_object();
+    }
+};
+
+// An object with a member for each member of T. Members missing from the object are
+// left default constructed by as, but is requires all of them.
+
+template<class Json, class T>
+struct json_type_traits<Json, T,
+    typename std::enable_if<json_member_traits<T>::is_specialized
+>::type>
+{
+    static bool is(const Json& j) JSONCONS_NOEXCEPT
+    {
+        if (!j.is_object())
+        {
+            return false;
+        }
+        detail::member_checker<Json,T> checker{j, true};
+        json_member_traits<T>::members(checker);
+        return checker.result;
+    }
+
+    static T as(const Json& j)
+    {
+        if (!j.is_object())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Attempt to cast json non-object to struct");
+        }
+        T val;
+        detail::member_reader<Json,T> reader{j, val};
+        json_member_traits<T>::members(reader);
+        return val;
+    }
+
+    static Json to_json(const T& val)
+    {
+        Json j;
+        detail::member_inserter<Json,T> inserter{val, j};
+        json_member_traits<T>::members(inserter);
+        return j;
+    }
+};
+
+}
+
+#define JSONCONS_PP_EXPAND(X) X
+#define JSONCONS_PP_NARG(...) JSONCONS_PP_EXPAND(JSONCONS_PP_NARG_(__VA_ARGS__, 64,63,62,61,60,59,58,57,56,55,54,53,52,51,50,49,48,47,46,45,44,43,42,41,40,39,38,37,36,35,34,33,32,31,30,29,28,27,26,25,24,23,22,21,20,19,18,17,16,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1))
+#define JSONCONS_PP_NARG_(_1,_2,_3,_4,_5,_6,_7,_8,_9,_10,_11,_12,_13,_14,_15,_16,_17,_18,_19,_20,_21,_22,_23,_24,_25,_26,_27,_28,_29,_30,_31,_32,_33,_34,_35,_36,_37,_38,_39,_40,_41,_42,_43,_44,_45,_46,_47,_48,_49,_50,_51,_52,_53,_54,_55,_56,_57,_58,_59,_60,_61,_62,_63,_64, N, ...) N
+#define JSONCONS_PP_CONCAT(A, B) JSONCONS_PP_CONCAT_(A, B)
+#define JSONCONS_PP_CONCAT_(A, B) A ## B
+#define JSONCONS_PP_FOR_EACH(M, T, ...) JSONCONS_PP_EXPAND(JSONCONS_PP_CONCAT(JSONCONS_PP_FOR_EACH_, JSONCONS_PP_NARG(__VA_ARGS__))(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_1(M, T, X) M(T, X)
+#define JSONCONS_PP_FOR_EACH_2(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_1(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_3(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_2(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_4(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_3(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_5(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_4(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_6(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_5(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_7(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_6(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_8(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_7(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_9(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_8(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_10(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_9(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_11(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_10(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_12(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_11(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_13(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_12(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_14(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_13(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_15(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_14(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_16(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_15(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_17(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_16(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_18(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_17(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_19(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_18(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_20(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_19(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_21(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_20(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_22(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_21(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_23(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_22(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_24(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_23(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_25(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_24(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_26(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_25(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_27(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_26(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_28(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_27(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_29(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_28(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_30(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_29(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_31(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_30(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_32(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_31(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_33(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_32(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_34(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_33(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_35(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_34(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_36(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_35(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_37(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_36(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_38(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_37(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_39(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_38(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_40(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_39(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_41(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_40(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_42(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_41(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_43(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_42(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_44(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_43(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_45(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_44(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_46(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_45(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_47(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_46(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_48(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_47(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_49(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_48(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_50(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_49(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_51(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_50(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_52(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_51(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_53(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_52(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_54(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_53(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_55(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_54(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_56(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_55(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_57(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_56(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_58(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_57(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_59(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_58(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_60(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_59(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_61(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_60(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_62(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_61(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_63(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_62(M, T, __VA_ARGS__))
+#define JSONCONS_PP_FOR_EACH_64(M, T, X, ...) M(T, X) JSONCONS_PP_EXPAND(JSONCONS_PP_FOR_EACH_63(M, T, __VA_ARGS__))
+
+#define JSONCONS_MEMBER_TRAITS_VISIT_(ValueType, Member) \
+    visitor(#Member, sizeof(#Member) - 1, \
+            std::integral_constant<uint64_t, ::jsoncons::detail::member_name_hash(#Member)>::value, \
+            ::jsoncons::detail::member_pointer_constant<ValueType, decltype(ValueType::Member), &ValueType::Member>());
+
+// Declares json_member_traits for ValueType with the members listed, up to 64 of them,
+// each serialized under its own name. Use it at global scope.
+
+#define JSONCONS_MEMBER_TRAITS_DECL(ValueType, ...) \
+namespace jsoncons \
+{ \
+    template <> \
+    struct json_member_traits<ValueType> \
+    { \
+        typedef ValueType value_type; \
+        static const bool is_specialized = true; \
+        static const size_t member_count = JSONCONS_PP_NARG(__VA_ARGS__); \
+        template <class Visitor> \
+        static void members(Visitor& visitor) \
+        { \
+            JSONCONS_PP_FOR_EACH(JSONCONS_MEMBER_TRAITS_VISIT_, ValueType, __VA_ARGS__) \
+        } \
+    }; \
+}
+
+#endif
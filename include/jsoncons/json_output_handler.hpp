@@ -10,6 +10,9 @@
 #include <string>
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/jsoncons_utilities.hpp>
+#include <jsoncons/detail/number_text.hpp>
+#include <jsoncons/detail/escaped_string.hpp>
+#include <jsoncons/json_event_tape.hpp>
 #if !defined(JSONCONS_NO_DEPRECATED)
 #include <jsoncons/json_type_traits.hpp> // for null_type
 #endif
@@ -19,37 +22,23 @@ namespace jsoncons {
 template<class CharT> 
 void print_integer(int64_t value, buffered_output<CharT>& os)
 {
-    CharT buf[255];
-    uint64_t u = (value < 0) ? static_cast<uint64_t>(-value) : static_cast<uint64_t>(value);
-    CharT* p = buf;
-    do
-    {
-        *p++ = static_cast<CharT>(48 + u%10);
-    }
-    while (u /= 10);
+    const uint64_t u = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    CharT* p = os.reserve(max_integer_chars);
     if (value < 0)
     {
-        os.put('-');
-    }
-    while (--p >= buf)
-    {
-        os.put(*p);
+        *p++ = '-';
     }
+    p += count_digits(u);
+    format_uinteger(u, p);
+    os.commit(p);
 }
 
 template<class CharT>
 void print_uinteger(uint64_t value, buffered_output<CharT>& os)
 {
-    CharT buf[255];
-    CharT* p = buf;
-    do
-    {
-        *p++ = static_cast<CharT>(48 + value % 10);
-    } while (value /= 10);
-    while (--p >= buf)
-    {
-        os.put(*p);
-    }
+    CharT* p = os.reserve(max_integer_chars) + count_digits(value);
+    format_uinteger(value, p);
+    os.commit(p);
 }
 
 template <class CharT>
@@ -109,6 +98,14 @@ public:
         do_string_value(value);
     }
 
+    // A string as the text between the quotation marks of a JSON string, escapes and all,
+    // which a serializer may write as it is. By default the escapes are replaced and the
+    // string is written as string_value would.
+    void escaped_string_value(const string_view_type& text) 
+    {
+        do_escaped_string_value(text);
+    }
+
     void byte_string_value(const uint8_t* data, size_t length) 
     {
         do_byte_string_value(data, length);
@@ -134,6 +131,13 @@ public:
         do_double_value(value, precision);
     }
 
+    // A number as JSON text, which a serializer writes as it is. By default it is 
+    // converted and written as integer_value, uinteger_value or double_value would.
+    void number_value(const string_view_type& text) 
+    {
+        do_number_value(text);
+    }
+
     void bool_value(bool value) 
     {
         do_bool_value(value);
@@ -144,6 +148,30 @@ public:
         do_null_value();
     }
 
+    // Write the elements of an array of numbers, between begin_array and end_array, as
+    // integer_value, uinteger_value and double_value would one at a time
+
+    void integer_values(const int64_t* data, size_t length) 
+    {
+        do_integer_values(data, length);
+    }
+
+    void uinteger_values(const uint64_t* data, size_t length) 
+    {
+        do_uinteger_values(data, length);
+    }
+
+    void double_values(const double* data, size_t length) 
+    {
+        do_double_values(data, length, std::numeric_limits<double>::digits10);
+    }
+
+    // The events of a tape, in one call. By default they are written one by one.
+    void events(const basic_json_event_tape<CharT>& tape)
+    {
+        do_events(tape);
+    }
+
 #if !defined(JSONCONS_NO_DEPRECATED)
 
     void name(const CharT* p, size_t length) 
@@ -241,6 +269,57 @@ private:
     virtual void do_uinteger_value(uint64_t value) = 0;
 
     virtual void do_bool_value(bool value) = 0;
+
+    virtual void do_number_value(const string_view_type& text)
+    {
+        detail::number_text_value value = detail::read_number_text(text.data(), text.length());
+        switch (value.kind)
+        {
+            case detail::number_text_kind::integer:
+                do_integer_value(value.integer);
+                break;
+            case detail::number_text_kind::uinteger:
+                do_uinteger_value(value.uinteger);
+                break;
+            default:
+                do_double_value(value.floating_point, value.precision);
+                break;
+        }
+    }
+
+    virtual void do_escaped_string_value(const string_view_type& text)
+    {
+        std::basic_string<CharT> s;
+        s.reserve(text.length());
+        detail::unescape_string(text.data(), text.length(), s);
+        do_string_value(string_view_type(s.data(), s.length()));
+    }
+
+    virtual void do_integer_values(const int64_t* data, size_t length)
+    {
+        for (size_t i = 0; i < length; ++i)
+        {
+            do_integer_value(data[i]);
+        }
+    }
+
+    virtual void do_uinteger_values(const uint64_t* data, size_t length)
+    {
+        for (size_t i = 0; i < length; ++i)
+        {
+            do_uinteger_value(data[i]);
+        }
+    }
+
+    virtual void do_double_values(const double* data, size_t length, uint8_t precision)
+    {
+        for (size_t i = 0; i < length; ++i)
+        {
+            do_double_value(data[i], precision);
+        }
+    }
+
+    virtual void do_events(const basic_json_event_tape<CharT>& tape);
 };
 
 template <class CharT>
@@ -308,6 +387,211 @@ private:
 
 };
 
+namespace detail {
+
+// Writes the events of a tape, which replay passes with a parsing_context, to an output
+// handler through its event functions
+
+template <class Handler>
+class output_handler_events
+{
+    Handler& handler_;
+public:
+    typedef typename Handler::string_view_type string_view_type;
+
+    output_handler_events(Handler& handler)
+        : handler_(handler)
+    {
+    }
+
+    void begin_json()
+    {
+        handler_.begin_json();
+    }
+
+    void end_json()
+    {
+        handler_.end_json();
+    }
+
+    void begin_object(const parsing_context&)
+    {
+        handler_.begin_object();
+    }
+
+    void end_object(const parsing_context&)
+    {
+        handler_.end_object();
+    }
+
+    void begin_array(const parsing_context&)
+    {
+        handler_.begin_array();
+    }
+
+    void end_array(const parsing_context&)
+    {
+        handler_.end_array();
+    }
+
+    void name(const string_view_type& name, const parsing_context&)
+    {
+        handler_.name(name);
+    }
+
+    void string_value(const string_view_type& value, const parsing_context&)
+    {
+        handler_.string_value(value);
+    }
+
+    void escaped_string_value(const string_view_type& text, const parsing_context&)
+    {
+        handler_.escaped_string_value(text);
+    }
+
+    void byte_string_value(const uint8_t* data, size_t length, const parsing_context&)
+    {
+        handler_.byte_string_value(data, length);
+    }
+
+    void integer_value(int64_t value, const parsing_context&)
+    {
+        handler_.integer_value(value);
+    }
+
+    void uinteger_value(uint64_t value, const parsing_context&)
+    {
+        handler_.uinteger_value(value);
+    }
+
+    void double_value(double value, uint8_t precision, const parsing_context&)
+    {
+        handler_.double_value(value, precision == 0 ? std::numeric_limits<double>::digits10 : precision);
+    }
+
+    void number_value(const string_view_type& text, const parsing_context&)
+    {
+        handler_.number_value(text);
+    }
+
+    void bool_value(bool value, const parsing_context&)
+    {
+        handler_.bool_value(value);
+    }
+
+    void null_value(const parsing_context&)
+    {
+        handler_.null_value();
+    }
+};
+
+// Writes the events of a tape to the overrides of an output handler by their qualified
+// names, so that the calls are not virtual, for a handler whose do_events replays a tape
+// into it. The handler makes it a friend. number_value and escaped_string_value, which a
+// handler need not override, are written through the virtual functions.
+
+template <class Handler>
+class direct_output_events
+{
+    Handler& handler_;
+public:
+    typedef typename Handler::string_view_type string_view_type;
+
+    direct_output_events(Handler& handler)
+        : handler_(handler)
+    {
+    }
+
+    void begin_json()
+    {
+        handler_.Handler::do_begin_json();
+    }
+
+    void end_json()
+    {
+        handler_.Handler::do_end_json();
+    }
+
+    void begin_object(const parsing_context&)
+    {
+        handler_.Handler::do_begin_object();
+    }
+
+    void end_object(const parsing_context&)
+    {
+        handler_.Handler::do_end_object();
+    }
+
+    void begin_array(const parsing_context&)
+    {
+        handler_.Handler::do_begin_array();
+    }
+
+    void end_array(const parsing_context&)
+    {
+        handler_.Handler::do_end_array();
+    }
+
+    void name(const string_view_type& name, const parsing_context&)
+    {
+        handler_.Handler::do_name(name);
+    }
+
+    void string_value(const string_view_type& value, const parsing_context&)
+    {
+        handler_.Handler::do_string_value(value);
+    }
+
+    void escaped_string_value(const string_view_type& text, const parsing_context&)
+    {
+        handler_.escaped_string_value(text);
+    }
+
+    void byte_string_value(const uint8_t* data, size_t length, const parsing_context&)
+    {
+        handler_.Handler::do_byte_string_value(data, length);
+    }
+
+    void integer_value(int64_t value, const parsing_context&)
+    {
+        handler_.Handler::do_integer_value(value);
+    }
+
+    void uinteger_value(uint64_t value, const parsing_context&)
+    {
+        handler_.Handler::do_uinteger_value(value);
+    }
+
+    void double_value(double value, uint8_t precision, const parsing_context&)
+    {
+        handler_.Handler::do_double_value(value, precision == 0 ? std::numeric_limits<double>::digits10 : precision);
+    }
+
+    void number_value(const string_view_type& text, const parsing_context&)
+    {
+        handler_.number_value(text);
+    }
+
+    void bool_value(bool value, const parsing_context&)
+    {
+        handler_.Handler::do_bool_value(value);
+    }
+
+    void null_value(const parsing_context&)
+    {
+        handler_.Handler::do_null_value();
+    }
+};
+
+}
+
+template <class CharT>
+void basic_json_output_handler<CharT>::do_events(const basic_json_event_tape<CharT>& tape)
+{
+    detail::output_handler_events<basic_json_output_handler<CharT>> handler(*this);
+    tape.replay(handler);
+}
+
 typedef basic_json_output_handler<char> json_output_handler;
 typedef basic_json_output_handler<wchar_t> wjson_output_handler;
 
@@ -19,6 +19,9 @@
 #include <jsoncons/json_input_handler.hpp>
 #include <jsoncons/parse_error_handler.hpp>
 #include <jsoncons/json_error_category.hpp>
+#include <jsoncons/detail/string_scan.hpp>
+#include <jsoncons/detail/structural_index.hpp>
+#include <jsoncons/detail/number_text.hpp>
 
 #define JSONCONS_ILLEGAL_CONTROL_CHARACTER \
         case 0x00:case 0x01:case 0x02:case 0x03:case 0x04:case 0x05:case 0x06:case 0x07:case 0x08:case 0x0b: \
@@ -78,10 +81,21 @@ enum class parse_state : uint8_t
     fals,  
     cr,
     lf,
+    skip,
+    skip_string,
+    skip_escape,
     done
 };
 
-template <class CharT>
+// Handler is basic_json_input_handler<CharT> by default, and the events are dispatched to
+// its virtual functions. Any other class with the same public event functions (begin_json,
+// end_json, begin_object, ..., null_value) may be given instead, so that the calls are known
+// at compile time and can be inlined. A filter can be a class template over the type of the
+// handler it passes the events on to. This pays for handlers that do little with each event,
+// such as validators, counters and filters; for json_decoder, whose work per event is an
+// allocation, the virtual call costs less than inlining the decoder into the parse loop.
+
+template <class CharT, class Handler = basic_json_input_handler<CharT>>
 class basic_json_parser : private parsing_context
 {
     static const int default_initial_stack_capacity_ = 100;
@@ -90,7 +104,7 @@ class basic_json_parser : private parsing_context
     basic_null_json_input_handler<CharT> default_input_handler_;
     default_parse_error_handler default_err_handler_;
 
-    basic_json_input_handler<CharT>& handler_;
+    Handler& handler_;
     parse_error_handler& err_handler_;
     uint32_t cp_;
     uint32_t cp2_;
@@ -99,20 +113,51 @@ class basic_json_parser : private parsing_context
 
     bool is_negative_;
     uint8_t precision_;
+    uint64_t integer_value_;
 
     size_t line_;
-    size_t column_;
+    // Columns are not counted as the input is consumed, but found from offsets. The offset of
+    // a character is the number consumed before it since the parser was constructed, and
+    // line_offset_ and text_offset_ are those of the first character of the current line
+    // and of the current text.
+    size_t source_offset_;
+    size_t line_offset_;
+    size_t text_offset_;
     int nesting_depth_;
+    int peak_nesting_depth_;
     int initial_stack_capacity_;
 
     int max_depth_;
+    size_t max_input_length_;
+    size_t max_string_length_;
+    size_t max_items_;
+    // The length of the sources passed to set_source since the last reset
+    size_t input_length_;
+    // The number of commas so far in the innermost array or object, and, when max_items_ is
+    // set, the counts of the arrays and objects that enclose it
+    size_t item_count_;
+    std::vector<size_t> item_count_stack_;
     string_to_double str_to_double_;
     const CharT* begin_input_;
     const CharT* end_input_;
     const CharT* p_;
+    // The end of the part of the source known to be well formed UTF-8
+    const CharT* valid_utf8_end_;
 
     parse_state state_;
     std::vector<parse_state> state_stack_;
+    std::vector<uint32_t> structural_positions_;
+    const CharT* string_data_;
+    size_t string_length_;
+    // Set by skip_value from a handler, and cleared before the events it applies to
+    mutable bool skip_requested_;
+    // Whether a skip goes to the end of the enclosing object or array, or only past a value
+    bool skip_to_end_;
+    size_t skip_depth_;
+    bool stop_;
+    bool keep_number_text_;
+    bool keep_escaped_strings_;
+    bool string_escaped_;
 
     // Noncopyable and nonmoveable
     basic_json_parser(const basic_json_parser&) = delete;
@@ -127,14 +172,33 @@ public:
          cp2_(0),
          is_negative_(false),
          precision_(0), 
+         integer_value_(0),
          line_(1),
-         column_(1),
+         source_offset_(0),
+         line_offset_(0),
+         text_offset_(0),
          nesting_depth_(0), 
+         peak_nesting_depth_(0),
          initial_stack_capacity_(default_initial_stack_capacity_),
+         max_input_length_((std::numeric_limits<size_t>::max)()),
+         max_string_length_((std::numeric_limits<size_t>::max)()),
+         max_items_((std::numeric_limits<size_t>::max)()),
+         input_length_(0),
+         item_count_(0),
          begin_input_(nullptr),
          end_input_(nullptr),
          p_(nullptr),
-         state_(parse_state::start)
+         valid_utf8_end_(nullptr),
+         state_(parse_state::start),
+         string_data_(nullptr),
+         string_length_(0),
+         skip_requested_(false),
+         skip_to_end_(false),
+         skip_depth_(0),
+         stop_(false),
+         keep_number_text_(false),
+         keep_escaped_strings_(false),
+         string_escaped_(false)
     {
         max_depth_ = (std::numeric_limits<int>::max)();
 
@@ -149,14 +213,33 @@ public:
          cp2_(0),
          is_negative_(false),
          precision_(0), 
+         integer_value_(0),
          line_(1),
-         column_(1),
+         source_offset_(0),
+         line_offset_(0),
+         text_offset_(0),
          nesting_depth_(0), 
+         peak_nesting_depth_(0),
          initial_stack_capacity_(default_initial_stack_capacity_),
+         max_input_length_((std::numeric_limits<size_t>::max)()),
+         max_string_length_((std::numeric_limits<size_t>::max)()),
+         max_items_((std::numeric_limits<size_t>::max)()),
+         input_length_(0),
+         item_count_(0),
          begin_input_(nullptr),
          end_input_(nullptr),
          p_(nullptr),
-         state_(parse_state::start)
+         valid_utf8_end_(nullptr),
+         state_(parse_state::start),
+         string_data_(nullptr),
+         string_length_(0),
+         skip_requested_(false),
+         skip_to_end_(false),
+         skip_depth_(0),
+         stop_(false),
+         keep_number_text_(false),
+         keep_escaped_strings_(false),
+         string_escaped_(false)
     {
         max_depth_ = (std::numeric_limits<int>::max)();
 
@@ -164,21 +247,40 @@ public:
         push_state(parse_state::root);
     }
 
-    basic_json_parser(basic_json_input_handler<CharT>& handler)
+    basic_json_parser(Handler& handler)
        : handler_(handler),
          err_handler_(default_err_handler_),
          cp_(0),
          cp2_(0),
          is_negative_(false),
          precision_(0), 
+         integer_value_(0),
          line_(1),
-         column_(1),
+         source_offset_(0),
+         line_offset_(0),
+         text_offset_(0),
          nesting_depth_(0), 
+         peak_nesting_depth_(0),
          initial_stack_capacity_(default_initial_stack_capacity_),
+         max_input_length_((std::numeric_limits<size_t>::max)()),
+         max_string_length_((std::numeric_limits<size_t>::max)()),
+         max_items_((std::numeric_limits<size_t>::max)()),
+         input_length_(0),
+         item_count_(0),
          begin_input_(nullptr),
          end_input_(nullptr),
          p_(nullptr),
-         state_(parse_state::start)
+         valid_utf8_end_(nullptr),
+         state_(parse_state::start),
+         string_data_(nullptr),
+         string_length_(0),
+         skip_requested_(false),
+         skip_to_end_(false),
+         skip_depth_(0),
+         stop_(false),
+         keep_number_text_(false),
+         keep_escaped_strings_(false),
+         string_escaped_(false)
     {
         max_depth_ = (std::numeric_limits<int>::max)();
 
@@ -186,7 +288,7 @@ public:
         push_state(parse_state::root);
     }
 
-    basic_json_parser(basic_json_input_handler<CharT>& handler,
+    basic_json_parser(Handler& handler,
                       parse_error_handler& err_handler)
        : handler_(handler),
          err_handler_(err_handler),
@@ -194,14 +296,33 @@ public:
          cp2_(0),
          is_negative_(false),
          precision_(0), 
+         integer_value_(0),
          line_(1),
-         column_(1),
+         source_offset_(0),
+         line_offset_(0),
+         text_offset_(0),
          nesting_depth_(0), 
+         peak_nesting_depth_(0),
          initial_stack_capacity_(default_initial_stack_capacity_),
+         max_input_length_((std::numeric_limits<size_t>::max)()),
+         max_string_length_((std::numeric_limits<size_t>::max)()),
+         max_items_((std::numeric_limits<size_t>::max)()),
+         input_length_(0),
+         item_count_(0),
          begin_input_(nullptr),
          end_input_(nullptr),
          p_(nullptr),
-         state_(parse_state::start)
+         valid_utf8_end_(nullptr),
+         state_(parse_state::start),
+         string_data_(nullptr),
+         string_length_(0),
+         skip_requested_(false),
+         skip_to_end_(false),
+         skip_depth_(0),
+         stop_(false),
+         keep_number_text_(false),
+         keep_escaped_strings_(false),
+         string_escaped_(false)
     {
         max_depth_ = (std::numeric_limits<int>::max)();
 
@@ -209,6 +330,31 @@ public:
         push_state(parse_state::root);
     }
 
+    // Off by default. When on, each number is passed to the handler's number_value as the
+    // text it has in the source, and not converted to an integer or double
+    void keep_number_text(bool value)
+    {
+        keep_number_text_ = value;
+    }
+
+    bool keep_number_text() const
+    {
+        return keep_number_text_;
+    }
+
+    // Off by default. When on, parse_indexed passes each string value that has escapes to the
+    // handler's escaped_string_value as the text between its quotation marks, with the escapes
+    // checked but not replaced. Member names, and strings read by parse, are unescaped as before.
+    void keep_escaped_strings(bool value)
+    {
+        keep_escaped_strings_ = value;
+    }
+
+    bool keep_escaped_strings() const
+    {
+        return keep_escaped_strings_;
+    }
+
     size_t line_number() const
     {
         return line_;
@@ -216,12 +362,18 @@ public:
 
     size_t column_number() const
     {
-        return column_;
+        return input_offset(p_) - line_offset_ + 1;
     }
 
     void set_column_number(size_t column)
     {
-        column_ = column;
+        line_offset_ = input_offset(p_) + 1 - column;
+    }
+
+    // The number of characters consumed since the start of the current text
+    size_t offset() const
+    {
+        return input_offset(p_) - text_offset_;
     }
 
     bool source_exhausted() const
@@ -229,6 +381,12 @@ public:
         return p_ == end_input_;
     }
 
+    // The next character to be read from the source
+    const CharT* position() const
+    {
+        return p_;
+    }
+
     const parsing_context& parsing_context() const
     {
         return *this;
@@ -238,16 +396,86 @@ public:
     {
     }
 
+    // Makes parse return after the event that is being handled, leaving the rest of the
+    // source to the next call, for a handler that consumes events one at a time
+    void stop()
+    {
+        stop_ = true;
+    }
+
+    // Skips the value of the member whose name was the last event, or the rest of the object
+    // or array whose begin_object or begin_array was, as parsing_context::skip_value would
+    // have if called from that event. For a caller that stops the parser after each event.
+    void skip_current()
+    {
+        switch (state_)
+        {
+            case parse_state::expect_colon:
+                begin_skip(false);
+                break;
+            case parse_state::expect_member_name_or_end:
+            case parse_state::expect_value_or_end:
+                begin_skip(true);
+                break;
+            default:
+                break;
+        }
+    }
+
     size_t max_nesting_depth() const
     {
         return static_cast<size_t>(max_depth_);
     }
 
+    // The deepest nesting of arrays and objects since the last reset
+    size_t peak_nesting_depth() const
+    {
+        return static_cast<size_t>(peak_nesting_depth_);
+    }
+
     void max_nesting_depth(size_t max_nesting_depth)
     {
         max_depth_ = static_cast<int>((std::min)(max_nesting_depth,static_cast<size_t>((std::numeric_limits<int>::max)())));
     }
 
+    // The limits below are unbounded by default. Exceeding one is a fatal error, reported
+    // as soon as it is found, so that a hostile text can't make the parser spend more time
+    // or memory on it than the limits allow.
+
+    // The number of characters in one JSON text, checked as each source is parsed
+    size_t max_input_length() const
+    {
+        return max_input_length_;
+    }
+
+    void max_input_length(size_t length)
+    {
+        max_input_length_ = length;
+    }
+
+    // The number of characters in a string or member name, after unescaping
+    size_t max_string_length() const
+    {
+        return max_string_length_;
+    }
+
+    void max_string_length(size_t length)
+    {
+        max_string_length_ = length;
+    }
+
+    // The number of elements in an array, or members in an object, at least 1. Set it 
+    // before parsing a text.
+    size_t max_items() const
+    {
+        return max_items_;
+    }
+
+    void max_items(size_t count)
+    {
+        max_items_ = (std::max)(count, static_cast<size_t>(1));
+    }
+
     parse_state parent() const
     {
         JSONCONS_ASSERT(state_stack_.size() >= 1);
@@ -271,7 +499,6 @@ public:
             else if (*p_ == ' ' || *p_ == '\t') 
             {
                 ++p_;
-                ++column_;                     
             } 
             else 
             {
@@ -282,7 +509,11 @@ public:
 
     void do_begin_object(std::error_code& ec)
     {
-        if (++nesting_depth_ >= max_depth_)
+        if (++nesting_depth_ > peak_nesting_depth_)
+        {
+            peak_nesting_depth_ = nesting_depth_;
+        }
+        if (nesting_depth_ >= max_depth_)
         {
             if (err_handler_.error(json_parser_errc::max_depth_exceeded, *this))
             {
@@ -290,14 +521,21 @@ public:
                 return;
             }
         } 
+        begin_item_count();
         push_state(parse_state::object);
         state_ = parse_state::expect_member_name_or_end;
+        skip_requested_ = false;
         handler_.begin_object(*this);
+        if (skip_requested_)
+        {
+            begin_skip(true);
+        }
     }
 
     void do_end_object(std::error_code& ec)
     {
         --nesting_depth_;
+        end_item_count();
         state_ = pop_state();
         if (state_ == parse_state::object)
         {
@@ -329,7 +567,11 @@ public:
 
     void do_begin_array(std::error_code& ec)
     {
-        if (++nesting_depth_ >= max_depth_)
+        if (++nesting_depth_ > peak_nesting_depth_)
+        {
+            peak_nesting_depth_ = nesting_depth_;
+        }
+        if (nesting_depth_ >= max_depth_)
         {
             if (err_handler_.error(json_parser_errc::max_depth_exceeded, *this))
             {
@@ -338,14 +580,21 @@ public:
             }
 
         }
+        begin_item_count();
         push_state(parse_state::array);
         state_ = parse_state::expect_value_or_end;
+        skip_requested_ = false;
         handler_.begin_array(*this);
+        if (skip_requested_)
+        {
+            begin_skip(true);
+        }
     }
 
     void do_end_array(std::error_code& ec)
     {
         --nesting_depth_;
+        end_item_count();
         state_ = pop_state();
         if (state_ == parse_state::array)
         {
@@ -374,6 +623,10 @@ public:
         }
     }
 
+    // Readies the parser for the next JSON text, from the rest of the current source or from
+    // a new one passed to set_source. The state stack, the string and number buffers and the
+    // structural index keep their capacity, so a parser that is reused for many small texts
+    // does not allocate once they have grown to fit.
     void reset()
     {
         state_stack_.clear();
@@ -381,8 +634,20 @@ public:
         push_state(parse_state::root);
         state_ = parse_state::start;
         line_ = 1;
-        column_ = 1;
+        line_offset_ = input_offset(p_);
+        text_offset_ = line_offset_;
         nesting_depth_ = 0;
+        peak_nesting_depth_ = 0;
+        input_length_ = end_input_ - p_;
+        item_count_ = 0;
+        item_count_stack_.clear();
+        cp_ = 0;
+        cp2_ = 0;
+        is_negative_ = false;
+        precision_ = 0;
+        integer_value_ = 0;
+        string_buffer_.clear();
+        number_buffer_.clear();
     }
 
     void check_done()
@@ -391,7 +656,7 @@ public:
         check_done(ec);
         if (ec)
         {
-            throw parse_error(ec,line_,column_);
+            throw parse_error(ec,line_,column_number());
         }
     }
 
@@ -410,8 +675,18 @@ public:
             CharT curr_char_ = *p_;
             switch (curr_char_)
             {
-            case '\n':
             case '\r':
+                if (p_ + 1 != end_input_ && *(p_ + 1) == '\n')
+                {
+                    break;
+                }
+                ++line_;
+                line_offset_ = input_offset(p_ + 1);
+                break;
+            case '\n':
+                ++line_;
+                line_offset_ = input_offset(p_ + 1);
+                break;
             case '\t':
             case ' ':
                 break;
@@ -428,15 +703,20 @@ public:
 
     void parse(std::error_code& ec)
     {
+        if (JSONCONS_UNLIKELY(input_length_ > max_input_length_))
+        {
+            limit_exceeded(json_parser_errc::max_input_length_exceeded, ec);
+            return;
+        }
         const CharT* local_end_input = end_input_;
 
-        while ((p_ < local_end_input) && (state_ != parse_state::done))
+        stop_ = false;
+        while ((p_ < local_end_input) && (state_ != parse_state::done) && !stop_)
         {
             switch (state_)
             {
             case parse_state::cr:
                 ++line_;
-                column_ = 1;
                 switch (*p_)
                 {
                 case '\n':
@@ -447,10 +727,11 @@ public:
                     state_ = pop_state();
                     break;
                 }
+                line_offset_ = input_offset(p_);
                 break;
             case parse_state::lf:
                 ++line_;
-                column_ = 1;
+                line_offset_ = input_offset(p_);
                 state_ = pop_state();
                 break;
             case parse_state::start: 
@@ -468,12 +749,10 @@ public:
                         case '\r': 
                             push_state(state_);
                             ++p_;
-                            ++column_;
                             state_ = parse_state::cr;
                             break; 
                         case '\n': 
                             ++p_;
-                            ++column_;
                             push_state(state_);
                             state_ = parse_state::lf;
                             break;   
@@ -482,7 +761,6 @@ public:
                             break;
                         case '/': 
                             ++p_;
-                            ++column_;
                             push_state(state_);
                             state_ = parse_state::slash;
                             break;
@@ -490,25 +768,22 @@ public:
                             do_begin_object(ec);
                             if (ec) return;
                             ++p_;
-                            ++column_;
                             break;
                         case '[':
                             do_begin_array(ec);
                             if (ec) return;
                             ++p_;
-                            ++column_;
                             break;
                         case '\"':
                             state_ = parse_state::string_u1;
                             ++p_;
-                            ++column_;
                             break;
                         case '-':
                             number_buffer_.clear();
                             is_negative_ = true;
                             precision_ = 0;
+                            integer_value_ = 0;
                             ++p_;
-                            ++column_;
                             state_ = parse_state::minus;
                             parse_number(ec);
                             if (ec) {return;}
@@ -516,11 +791,11 @@ public:
                         case '0': 
                             number_buffer_.clear();
                             is_negative_ = false;
-                            precision_ = 1;
-                            number_buffer_.push_back(static_cast<char>(*p_));
+                            precision_ = 0;
+                            integer_value_ = 0;
+                            append_integer_digit(*p_);
                             state_ = parse_state::positive_zero;
                             ++p_;
-                            ++column_;
                             parse_number(ec);
                             if (ec) {return;}
                             break;
@@ -528,6 +803,7 @@ public:
                             number_buffer_.clear();
                             is_negative_ = false;
                             precision_ = 0;
+                            integer_value_ = 0;
                             state_ = parse_state::positive_integer;
                             parse_number(ec);
                             if (ec) {return;}
@@ -571,17 +847,14 @@ public:
                                 return;
                             }
                             ++p_;
-                            ++column_;
                             break;
                         case '\r': 
                             ++p_;
-                            ++column_;
                             push_state(state_);
                             state_ = parse_state::cr;
                             break; 
                         case '\n': 
                             ++p_;
-                            ++column_;
                             push_state(state_);
                             state_ = parse_state::lf;
                             break;   
@@ -590,7 +863,6 @@ public:
                             break;
                         case '/':
                             ++p_;
-                            ++column_;
                             push_state(state_); 
                             state_ = parse_state::slash;
                             break;
@@ -598,19 +870,16 @@ public:
                             do_end_object(ec);
                             if (ec) return;
                             ++p_;
-                            ++column_;
                             break;
                         case ']':
                             do_end_array(ec);
                             if (ec) return;
                             ++p_;
-                            ++column_;
                             break;
                         case ',':
                             begin_member_or_element(ec);
                             if (ec) return;
                             ++p_;
-                            ++column_;
                             break;
                         default:
                             if (parent() == parse_state::array)
@@ -630,7 +899,6 @@ public:
                                 }
                             }
                             ++p_;
-                            ++column_;
                             break;
                     }
                 }
@@ -646,17 +914,14 @@ public:
                                 return;
                             }
                             ++p_;
-                            ++column_;
                             break;
                         case '\r': 
                             ++p_;
-                            ++column_;
                             push_state(state_);
                             state_ = parse_state::cr;
                             break; 
                         case '\n': 
                             ++p_;
-                            ++column_;
                             push_state(state_);
                             state_ = parse_state::lf;
                             break;   
@@ -665,7 +930,6 @@ public:
                             break;
                         case '/':
                             ++p_;
-                            ++column_;
                             push_state(state_); 
                             state_ = parse_state::slash;
                             break;
@@ -673,11 +937,9 @@ public:
                             do_end_object(ec);
                             if (ec) return;
                             ++p_;
-                            ++column_;
                             break;
                         case '\"':
                             ++p_;
-                            ++column_;
                             push_state(parse_state::member_name);
                             state_ = parse_state::string_u1;
                             break;
@@ -688,7 +950,6 @@ public:
                                 return;
                             }
                             ++p_;
-                            ++column_;
                             break;
                         default:
                             if (err_handler_.error(json_parser_errc::expected_name, *this))
@@ -697,7 +958,6 @@ public:
                                 return;
                             }
                             ++p_;
-                            ++column_;
                             break;
                     }
                 }
@@ -713,17 +973,14 @@ public:
                                 return;
                             }
                             ++p_;
-                            ++column_;
                             break;
                         case '\r': 
                             ++p_;
-                            ++column_;
                             push_state(state_);
                             state_ = parse_state::cr;
                             break; 
                         case '\n': 
                             ++p_;
-                            ++column_;
                             push_state(state_);
                             state_ = parse_state::lf;
                             break;   
@@ -732,13 +989,11 @@ public:
                             break;
                         case '/': 
                             ++p_;
-                            ++column_;
                             push_state(state_);
                             state_ = parse_state::slash;
                             break;
                         case '\"':
                             ++p_;
-                            ++column_;
                             push_state(parse_state::member_name);
                             state_ = parse_state::string_u1;
                             break;
@@ -751,7 +1006,6 @@ public:
                             do_end_object(ec);  // Recover
                             if (ec) return;
                             ++p_;
-                            ++column_;
                             break;
                         case '\'':
                             if (err_handler_.error(json_parser_errc::single_quote, *this))
@@ -760,7 +1014,6 @@ public:
                                 return;
                             }
                             ++p_;
-                            ++column_;
                             break;
                         default:
                             if (err_handler_.error(json_parser_errc::expected_name, *this))
@@ -769,7 +1022,6 @@ public:
                                 return;
                             }
                             ++p_;
-                            ++column_;
                             break;
                     }
                 }
@@ -785,19 +1037,16 @@ public:
                                 return;
                             }
                             ++p_;
-                            ++column_;
                             break;
                         case '\r': 
                             push_state(state_);
                             state_ = parse_state::cr;
                             ++p_;
-                            ++column_;
                             break; 
                         case '\n': 
                             push_state(state_);
                             state_ = parse_state::lf;
                             ++p_;
-                            ++column_;
                             break;   
                         case ' ':case '\t':
                             skip_whitespace();
@@ -806,12 +1055,10 @@ public:
                             push_state(state_);
                             state_ = parse_state::slash;
                             ++p_;
-                            ++column_;
                             break;
                         case ':':
                             state_ = parse_state::expect_value;
                             ++p_;
-                            ++column_;
                             break;
                         default:
                             if (err_handler_.error(json_parser_errc::expected_colon, *this))
@@ -820,7 +1067,6 @@ public:
                                 return;
                             }
                             ++p_;
-                            ++column_;
                             break;
                     }
                 }
@@ -837,18 +1083,15 @@ public:
                                 return;
                             }
                             ++p_;
-                            ++column_;
                             break;
                         case '\r': 
                             push_state(state_);
                             ++p_;
-                            ++column_;
                             state_ = parse_state::cr;
                             break; 
                         case '\n': 
                             push_state(state_);
                             ++p_;
-                            ++column_;
                             state_ = parse_state::lf;
                             break;   
                         case ' ':case '\t':
@@ -857,32 +1100,28 @@ public:
                         case '/': 
                             push_state(state_);
                             ++p_;
-                            ++column_;
                             state_ = parse_state::slash;
                             break;
                         case '{':
                             do_begin_object(ec);
                             if (ec) return;
                             ++p_;
-                            ++column_;
                             break;
                         case '[':
                             do_begin_array(ec);
                             if (ec) return;
                             ++p_;
-                            ++column_;
                             break;
                         case '\"':
                             ++p_;
-                            ++column_;
                             state_ = parse_state::string_u1;
                             break;
                         case '-':
                             number_buffer_.clear();
                             is_negative_ = true;
                             precision_ = 0;
+                            integer_value_ = 0;
                             ++p_;
-                            ++column_;
                             state_ = parse_state::minus;
                             parse_number(ec);
                             if (ec) {return;}
@@ -890,10 +1129,10 @@ public:
                         case '0': 
                             number_buffer_.clear();
                             is_negative_ = false;
-                            precision_ = 1;
-                            number_buffer_.push_back(static_cast<char>(*p_));
+                            precision_ = 0;
+                            integer_value_ = 0;
+                            append_integer_digit(*p_);
                             ++p_;
-                            ++column_;
                             state_ = parse_state::positive_zero;
                             parse_number(ec);
                             if (ec) {return;}
@@ -902,6 +1141,7 @@ public:
                             number_buffer_.clear();
                             is_negative_ = false;
                             precision_ = 0;
+                            integer_value_ = 0;
                             state_ = parse_state::positive_integer;
                             parse_number(ec);
                             if (ec) {return;}
@@ -938,7 +1178,6 @@ public:
                                 }
                             }
                             ++p_;
-                            ++column_;
                             break;
                         case '\'':
                             if (err_handler_.error(json_parser_errc::single_quote, *this))
@@ -947,7 +1186,6 @@ public:
                                 return;
                             }
                             ++p_;
-                            ++column_;
                             break;
                         default:
                             if (err_handler_.error(json_parser_errc::expected_value, *this))
@@ -956,7 +1194,6 @@ public:
                                 return;
                             }
                             ++p_;
-                            ++column_;
                             break;
                     }
                 }
@@ -972,17 +1209,14 @@ public:
                                 return;
                             }
                             ++p_;
-                            ++column_;
                             break;
                         case '\r': 
                             ++p_;
-                            ++column_;
                             push_state(state_);
                             state_ = parse_state::cr;
                             break; 
                         case '\n': 
                             ++p_;
-                            ++column_;
                             push_state(state_);
                             state_ = parse_state::lf;
                             break;   
@@ -991,7 +1225,6 @@ public:
                             break;
                         case '/': 
                             ++p_;
-                            ++column_;
                             push_state(state_);
                             state_ = parse_state::slash;
                             break;
@@ -999,31 +1232,27 @@ public:
                             do_begin_object(ec);
                             if (ec) return;
                             ++p_;
-                            ++column_;
                             break;
                         case '[':
                             do_begin_array(ec);
                             if (ec) return;
                             ++p_;
-                            ++column_;
                             break;
                         case ']':
                             do_end_array(ec);
                             if (ec) return;
                             ++p_;
-                            ++column_;
                             break;
                         case '\"':
                             ++p_;
-                            ++column_;
                             state_ = parse_state::string_u1;
                             break;
                         case '-':
                             number_buffer_.clear();
                             is_negative_ = true;
                             precision_ = 0;
+                            integer_value_ = 0;
                             ++p_;
-                            ++column_;
                             state_ = parse_state::minus;
                             parse_number(ec);
                             if (ec) {return;}
@@ -1031,10 +1260,10 @@ public:
                         case '0': 
                             number_buffer_.clear();
                             is_negative_ = false;
-                            precision_ = 1;
-                            number_buffer_.push_back(static_cast<char>(*p_));
+                            precision_ = 0;
+                            integer_value_ = 0;
+                            append_integer_digit(*p_);
                             ++p_;
-                            ++column_;
                             state_ = parse_state::positive_zero;
                             parse_number(ec);
                             if (ec) {return;}
@@ -1043,6 +1272,7 @@ public:
                             number_buffer_.clear();
                             is_negative_ = false;
                             precision_ = 0;
+                            integer_value_ = 0;
                             state_ = parse_state::positive_integer;
                             parse_number(ec);
                             if (ec) {return;}
@@ -1066,7 +1296,6 @@ public:
                                 return;
                             }
                             ++p_;
-                            ++column_;
                             break;
                         default:
                             if (err_handler_.error(json_parser_errc::expected_value, *this))
@@ -1075,7 +1304,6 @@ public:
                                 return;
                             }
                             ++p_;
-                            ++column_;
                             break;
                         }
                     }
@@ -1113,7 +1341,6 @@ public:
                 {
                 case 'r':
                     ++p_;
-                    ++column_;
                     state_ = parse_state::tr;
                     break;
                 default:
@@ -1134,7 +1361,6 @@ public:
                     return;
                 }
                 ++p_;
-                ++column_;
                 break;
             case parse_state::tru: 
                 switch (*p_)
@@ -1157,14 +1383,12 @@ public:
                     return;
                 }
                 ++p_;
-                ++column_;
                 break;
             case parse_state::f: 
                 switch (*p_)
                 {
                 case 'a':
                     ++p_;
-                    ++column_;
                     state_ = parse_state::fa;
                     break;
                 default:
@@ -1185,7 +1409,6 @@ public:
                     return;
                 }
                 ++p_;
-                ++column_;
                 break;
             case parse_state::fal: 
                 switch (*p_)
@@ -1199,7 +1422,6 @@ public:
                     return;
                 }
                 ++p_;
-                ++column_;
                 break;
             case parse_state::fals: 
                 switch (*p_)
@@ -1222,14 +1444,12 @@ public:
                     return;
                 }
                 ++p_;
-                ++column_;
                 break;
             case parse_state::n: 
                 switch (*p_)
                 {
                 case 'u':
                     ++p_;
-                    ++column_;
                     state_ = parse_state::nu;
                     break;
                 default:
@@ -1250,7 +1470,6 @@ public:
                     return;
                 }
                 ++p_;
-                ++column_;
                 break;
             case parse_state::nul: 
                 switch (*p_)
@@ -1273,7 +1492,6 @@ public:
                     return;
                 }
                 ++p_;
-                ++column_;
                 break;
             case parse_state::slash: 
                 {
@@ -1305,7 +1523,6 @@ public:
                     }
                 }
                 ++p_;
-                ++column_;
                 break;
             case parse_state::slash_star:  
                 {
@@ -1325,7 +1542,6 @@ public:
                     }
                 }
                 ++p_;
-                ++column_;
                 break;
             case parse_state::slash_slash: 
                 {
@@ -1339,7 +1555,6 @@ public:
                         break;
                     default:
                         ++p_;
-                        ++column_;
                     }
                 }
                 break;
@@ -1356,7 +1571,11 @@ public:
                     }
                 }
                 ++p_;
-                ++column_;
+                break;
+            case parse_state::skip: 
+            case parse_state::skip_string: 
+            case parse_state::skip_escape: 
+                skip_some();
                 break;
             default:
                 JSONCONS_ASSERT(false);
@@ -1373,7 +1592,6 @@ public:
             {
                 handler_.bool_value(true,*this);
                 p_ += 4;
-                column_ += 4;
                 if (parent() == parse_state::root)
                 {
                     handler_.end_json();
@@ -1394,7 +1612,6 @@ public:
         else
         {
             ++p_;
-            ++column_;
             state_ = parse_state::t;
         }
     }
@@ -1407,7 +1624,6 @@ public:
             {
                 handler_.null_value(*this);
                 p_ += 4;
-                column_ += 4;
                 if (parent() == parse_state::root)
                 {
                     handler_.end_json();
@@ -1428,7 +1644,6 @@ public:
         else
         {
             ++p_;
-            ++column_;
             state_ = parse_state::n;
         }
     }
@@ -1441,7 +1656,6 @@ public:
             {
                 handler_.bool_value(false,*this);
                 p_ += 5;
-                column_ += 5;
                 if (parent() == parse_state::root)
                 {
                     handler_.end_json();
@@ -1462,7 +1676,6 @@ public:
         else
         {
             ++p_;
-            ++column_;
             state_ = parse_state::f;
         }
     }
@@ -1470,7 +1683,6 @@ public:
     void parse_number(std::error_code& ec)
     {
         const CharT* local_end_input = end_input_;
-        const CharT* sb = p_;
 
         switch (state_)
         {
@@ -1506,16 +1718,12 @@ minus:
         switch (*p_)
         {
             case '0': 
-                number_buffer_.push_back(static_cast<char>(*p_));
-                ++precision_;
+                append_integer_digit(*p_);
                 ++p_;
-                ++column_;
                 goto negative_zero;
             case '1':case '2':case '3':case '4':case '5':case '6':case '7':case '8': case '9':
-                number_buffer_.push_back(static_cast<char>(*p_));
-                ++precision_;
+                append_integer_digit(*p_);
                 ++p_;
-                ++column_;
                 goto negative_integer;
             default:
                 err_handler_.error(json_parser_errc::expected_value, *this);
@@ -1531,69 +1739,63 @@ negative_zero:
         switch (*p_)
         {
             case '\r': 
-                end_negative_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_negative_integer(ec);
                 if (ec) return;
                 ++p_;
-                ++column_;
                 push_state(state_);
                 state_ = parse_state::cr;
                 return; 
             case '\n': 
-                end_negative_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_negative_integer(ec);
                 if (ec) return;
                 push_state(state_);
                 ++p_;
-                ++column_;
                 state_ = parse_state::lf;
                 return;   
             case ' ':case '\t':
-                end_negative_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_negative_integer(ec);
                 if (ec) return;
                 skip_whitespace();
                 return;
             case '/': 
-                end_negative_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_negative_integer(ec);
                 if (ec) return;
                 ++p_;
-                ++column_;
                 push_state(state_);
                 state_ = parse_state::slash;
                 return;
             case '}':
-                end_negative_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_negative_integer(ec);
                 if (ec) return;
                 do_end_object(ec);
                 ++p_;
-                ++column_;
                 if (ec) return;
                 return;
             case ']':
-                end_negative_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_negative_integer(ec);
                 if (ec) return;
                 do_end_array(ec);
                 ++p_;
-                ++column_;
                 if (ec) return;
                 return;
             case '.':
+                write_accumulated_digits();
                 JSONCONS_ASSERT(precision_ == number_buffer_.length());
                 number_buffer_.push_back(static_cast<char>(*p_));
                 ++p_;
-                ++column_;
                 goto fraction1;
             case 'e':case 'E':
+                write_accumulated_digits();
                 JSONCONS_ASSERT(precision_ == number_buffer_.length());
                 number_buffer_.push_back(static_cast<char>(*p_));
                 ++p_;
-                ++column_;
                 goto exp1;
             case ',':
-                end_negative_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_negative_integer(ec);
                 if (ec) return;
                 begin_member_or_element(ec);
                 if (ec) return;
                 ++p_;
-                ++column_;
                 return;
             case '0': case '1':case '2':case '3':case '4':case '5':case '6':case '7':case '8': case '9':
                 err_handler_.error(json_parser_errc::leading_zero, *this);
@@ -1615,75 +1817,66 @@ negative_integer:
         switch (*p_)
         {
             case '\r': 
-                end_negative_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_negative_integer(ec);
                 if (ec) return;
                 push_state(state_);
                 ++p_;
-                ++column_;
                 state_ = parse_state::cr;
                 return; 
             case '\n': 
-                end_negative_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_negative_integer(ec);
                 if (ec) return;
                 push_state(state_);
                 ++p_;
-                ++column_;
                 state_ = parse_state::lf;
                 return;   
             case ' ':case '\t':
-                end_negative_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_negative_integer(ec);
                 if (ec) return;
                 skip_whitespace();
                 return;
             case '/': 
-                end_negative_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_negative_integer(ec);
                 if (ec) return;
                 push_state(state_);
                 ++p_;
-                ++column_;
                 state_ = parse_state::slash;
                 return;
             case '}':
-                end_negative_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_negative_integer(ec);
                 if (ec) return;
                 do_end_object(ec);
                 if (ec) return;
                 ++p_;
-                ++column_;
                 return;
             case ']':
-                end_negative_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_negative_integer(ec);
                 if (ec) return;
                 do_end_array(ec);
                 if (ec) return;
                 ++p_;
-                ++column_;
                 return;
             case '0':case '1':case '2':case '3':case '4':case '5':case '6':case '7':case '8': case '9':
-                number_buffer_.push_back(static_cast<char>(*p_));
-                ++precision_;
-                ++p_;
-                ++column_;
+                append_integer_digits(local_end_input);
                 goto negative_integer;
             case ',':
-                end_negative_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_negative_integer(ec);
                 if (ec) return;
                 begin_member_or_element(ec);
                 if (ec) return;
                 ++p_;
-                ++column_;
                 return;
             case '.':
+                write_accumulated_digits();
                 JSONCONS_ASSERT(precision_ == number_buffer_.length());
                 number_buffer_.push_back(static_cast<char>(*p_));
                 ++p_;
-                ++column_;
                 goto fraction1;
             case 'e':case 'E':
+                write_accumulated_digits();
                 JSONCONS_ASSERT(precision_ == number_buffer_.length());
                 number_buffer_.push_back(static_cast<char>(*p_));
                 ++p_;
-                ++column_;
                 goto exp1;
             default:
                 err_handler_.error(json_parser_errc::invalid_number, *this);
@@ -1700,69 +1893,63 @@ positive_zero:
         switch (*p_)
         {
             case '\r': 
-                end_positive_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_positive_integer(ec);
                 if (ec) return;
                 ++p_;
-                ++column_;
                 push_state(state_);
                 state_ = parse_state::cr;
                 return; 
             case '\n': 
-                end_positive_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_positive_integer(ec);
                 if (ec) return;
                 push_state(state_);
                 ++p_;
-                ++column_;
                 state_ = parse_state::lf;
                 return;   
             case ' ':case '\t':
-                end_positive_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_positive_integer(ec);
                 if (ec) return;
                 skip_whitespace();
                 return;
             case '/': 
-                end_positive_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_positive_integer(ec);
                 if (ec) return;
                 ++p_;
-                ++column_;
                 push_state(state_);
                 state_ = parse_state::slash;
                 return;
             case '}':
-                end_positive_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_positive_integer(ec);
                 if (ec) return;
                 do_end_object(ec);
                 ++p_;
-                ++column_;
                 if (ec) return;
                 return;
             case ']':
-                end_positive_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_positive_integer(ec);
                 if (ec) return;
                 do_end_array(ec);
                 ++p_;
-                ++column_;
                 if (ec) return;
                 return;
             case '.':
+                write_accumulated_digits();
                 JSONCONS_ASSERT(precision_ == number_buffer_.length());
                 number_buffer_.push_back(static_cast<char>(*p_));
                 ++p_;
-                ++column_;
                 goto fraction1;
             case 'e':case 'E':
+                write_accumulated_digits();
                 JSONCONS_ASSERT(precision_ == number_buffer_.length());
                 number_buffer_.push_back(static_cast<char>(*p_));
                 ++p_;
-                ++column_;
                 goto exp1;
             case ',':
-                end_positive_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_positive_integer(ec);
                 if (ec) return;
                 begin_member_or_element(ec);
                 if (ec) return;
                 ++p_;
-                ++column_;
                 return;
             case '0': case '1':case '2':case '3':case '4':case '5':case '6':case '7':case '8': case '9':
                 err_handler_.error(json_parser_errc::leading_zero, *this);
@@ -1784,75 +1971,66 @@ positive_integer:
         switch (*p_)
         {
             case '\r': 
-                end_positive_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_positive_integer(ec);
                 if (ec) return;
                 push_state(state_);
                 ++p_;
-                ++column_;
                 state_ = parse_state::cr;
                 return; 
             case '\n': 
-                end_positive_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_positive_integer(ec);
                 if (ec) return;
                 push_state(state_);
                 ++p_;
-                ++column_;
                 state_ = parse_state::lf;
                 return;   
             case ' ':case '\t':
-                end_positive_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_positive_integer(ec);
                 if (ec) return;
                 skip_whitespace();
                 return;
             case '/': 
-                end_positive_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_positive_integer(ec);
                 if (ec) return;
                 push_state(state_);
                 ++p_;
-                ++column_;
                 state_ = parse_state::slash;
                 return;
             case '}':
-                end_positive_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_positive_integer(ec);
                 if (ec) return;
                 do_end_object(ec);
                 if (ec) return;
                 ++p_;
-                ++column_;
                 return;
             case ']':
-                end_positive_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_positive_integer(ec);
                 if (ec) return;
                 do_end_array(ec);
                 if (ec) return;
                 ++p_;
-                ++column_;
                 return;
-            case '0': case '1':case '2':case '3':case '4':case '5':case '6':case '7':case '8': case '9':
-                number_buffer_.push_back(static_cast<char>(*p_));
-                ++precision_;
-                ++p_;
-                ++column_;
+            case '0':case '1':case '2':case '3':case '4':case '5':case '6':case '7':case '8': case '9':
+                append_integer_digits(local_end_input);
                 goto positive_integer;
             case '.':
+                write_accumulated_digits();
                 JSONCONS_ASSERT(precision_ == number_buffer_.length());
                 number_buffer_.push_back(static_cast<char>(*p_));
                 ++p_;
-                ++column_;
                 goto fraction1;
             case 'e':case 'E':
+                write_accumulated_digits();
                 JSONCONS_ASSERT(precision_ == number_buffer_.length());
                 number_buffer_.push_back(static_cast<char>(*p_));
                 ++p_;
-                ++column_;
                 goto exp1;
             case ',':
-                end_positive_value(number_buffer_.data(), number_buffer_.length(), ec);
+                end_positive_integer(ec);
                 if (ec) return;
                 begin_member_or_element(ec);
                 if (ec) return;
                 ++p_;
-                ++column_;
                 return;
             default:
                 err_handler_.error(json_parser_errc::invalid_number, *this);
@@ -1872,7 +2050,6 @@ fraction1:
                 ++precision_;
                 number_buffer_.push_back(static_cast<char>(*p_));
                 ++p_;
-                ++column_;
                 goto fraction2;
             default:
                 err_handler_.error(json_parser_errc::invalid_number, *this);
@@ -1893,7 +2070,6 @@ fraction2:
                 if (ec) return;
                 push_state(state_);
                 ++p_;
-                ++column_;
                 state_ = parse_state::cr;
                 return; 
             case '\n': 
@@ -1901,7 +2077,6 @@ fraction2:
                 if (ec) return;
                 push_state(state_);
                 ++p_;
-                ++column_;
                 state_ = parse_state::lf;
                 return;   
             case ' ':case '\t':
@@ -1914,7 +2089,6 @@ fraction2:
                 if (ec) return;
                 push_state(state_);
                 ++p_;
-                ++column_;
                 state_ = parse_state::slash;
                 return;
             case '}':
@@ -1923,7 +2097,6 @@ fraction2:
                 do_end_object(ec);
                 if (ec) return;
                 ++p_;
-                ++column_;
                 return;
             case ']':
                 end_fraction_value(number_buffer_.data(), number_buffer_.length(), ec);
@@ -1931,7 +2104,6 @@ fraction2:
                 do_end_array(ec);
                 if (ec) return;
                 ++p_;
-                ++column_;
                 return;
             case ',':
                 end_fraction_value(number_buffer_.data(), number_buffer_.length(), ec);
@@ -1939,18 +2111,15 @@ fraction2:
                 begin_member_or_element(ec);
                 if (ec) return;
                 ++p_;
-                ++column_;
                 return;
             case '0':case '1':case '2':case '3':case '4':case '5':case '6':case '7':case '8': case '9':
                 ++precision_;
                 number_buffer_.push_back(static_cast<char>(*p_));
                 ++p_;
-                ++column_;
                 goto fraction2;
             case 'e':case 'E':
                 number_buffer_.push_back(static_cast<char>(*p_));
                 ++p_;
-                ++column_;
                 goto exp1;
             default:
                 err_handler_.error(json_parser_errc::invalid_number, *this);
@@ -1967,18 +2136,19 @@ exp1:
         switch (*p_)
         {
             case '+':
+                if (keep_number_text_)
+                {
+                    number_buffer_.push_back(static_cast<char>(*p_));
+                }
                 ++p_;
-                ++column_;
                 goto exp2;
             case '-':
                 number_buffer_.push_back(static_cast<char>(*p_));
                 ++p_;
-                ++column_;
                 goto exp2;
             case '0':case '1':case '2':case '3':case '4':case '5':case '6':case '7':case '8': case '9':
                 number_buffer_.push_back(static_cast<char>(*p_));
                 ++p_;
-                ++column_;
                 goto exp3;
             default:
                 err_handler_.error(json_parser_errc::expected_value, *this);
@@ -1997,7 +2167,6 @@ exp2:
             case '0':case '1':case '2':case '3':case '4':case '5':case '6':case '7':case '8': case '9':
                 number_buffer_.push_back(static_cast<char>(*p_));
                 ++p_;
-                ++column_;
                 goto exp3;
             default:
                 err_handler_.error(json_parser_errc::expected_value, *this);
@@ -2018,7 +2187,6 @@ exp3:
                 end_fraction_value(number_buffer_.data(), number_buffer_.length(), ec);
                 if (ec) return;
                 ++p_;
-                ++column_;
                 push_state(state_);
                 state_ = parse_state::cr;
                 return; 
@@ -2026,7 +2194,6 @@ exp3:
                 end_fraction_value(number_buffer_.data(), number_buffer_.length(), ec);
                 if (ec) return;
                 ++p_;
-                ++column_;
                 push_state(state_);
                 state_ = parse_state::lf;
                 return;   
@@ -2040,7 +2207,6 @@ exp3:
                 if (ec) return;
                 push_state(state_);
                 ++p_;
-                ++column_;
                 state_ = parse_state::slash;
                 return;
             case '}':
@@ -2049,7 +2215,6 @@ exp3:
                 do_end_object(ec);
                 if (ec) return;
                 ++p_;
-                ++column_;
                 return;
             case ']':
                 end_fraction_value(number_buffer_.data(), number_buffer_.length(), ec);
@@ -2057,7 +2222,6 @@ exp3:
                 do_end_array(ec);
                 if (ec) return;
                 ++p_;
-                ++column_;
                 return;
             case ',':
                 end_fraction_value(number_buffer_.data(), number_buffer_.length(), ec);
@@ -2065,12 +2229,10 @@ exp3:
                 begin_member_or_element(ec);
                 if (ec) return;
                 ++p_;
-                ++column_;
                 return;
             case '0':case '1':case '2':case '3':case '4':case '5':case '6':case '7':case '8': case '9':
                 number_buffer_.push_back(static_cast<char>(*p_));
                 ++p_;
-                ++column_;
                 goto exp3;
             default:
                 err_handler_.error(json_parser_errc::invalid_number, *this);
@@ -2120,23 +2282,24 @@ exp3:
 string_u1:
         if (JSONCONS_UNLIKELY(p_ >= local_end_input)) // Buffer exhausted               
         {
-            auto result = unicons::validate(sb,p_);
+            auto result = validate_utf8(sb,p_);
             if (result.ec != unicons::conv_errc())
             {
-                translate_conv_errc(result.ec,ec);
-                column_ += (result.it - sb);
+                utf8_error(result.ec, result.it, ec);
                 return;
             }
             string_buffer_.append(sb,p_-sb);
-            column_ += (p_ - sb + 1);
             state_ = parse_state::string_u1;
+            if (string_buffer_.length() > max_string_length_)
+            {
+                limit_exceeded(json_parser_errc::max_string_length_exceeded, ec);
+            }
             return;
         }
         switch (*p_)
         {
             JSONCONS_ILLEGAL_CONTROL_CHARACTER:
             {
-                column_ += (p_ - sb + 1);
                 if (err_handler_.error(json_parser_errc::illegal_control_character, *this))
                 {
                     ec = json_parser_errc::illegal_control_character;
@@ -2144,11 +2307,10 @@ string_u1:
                     return;
                 }
                 // recovery - skip
-                auto result = unicons::validate(sb,p_);
+                auto result = validate_utf8(sb,p_);
                 if (result.ec != unicons::conv_errc())
                 {
-                    translate_conv_errc(result.ec,ec);
-                    column_ += (result.it - sb);
+                    utf8_error(result.ec, result.it, ec);
                     return;
                 }
                 string_buffer_.append(sb,p_-sb);
@@ -2158,7 +2320,6 @@ string_u1:
             }
             case '\r':
             {
-                column_ += (p_ - sb + 1);
                 if (err_handler_.error(json_parser_errc::illegal_character_in_string, *this))
                 {
                     ec = json_parser_errc::illegal_character_in_string;
@@ -2166,11 +2327,10 @@ string_u1:
                     return;
                 }
                 // recovery - keep
-                auto result = unicons::validate(sb,p_);
+                auto result = validate_utf8(sb,p_);
                 if (result.ec != unicons::conv_errc())
                 {
-                    translate_conv_errc(result.ec,ec);
-                    column_ += (result.it - sb);
+                    utf8_error(result.ec, result.it, ec);
                     return;
                 }
                 string_buffer_.append(sb, p_ - sb + 1);
@@ -2181,7 +2341,6 @@ string_u1:
             }
             case '\n':
             {
-                column_ += (p_ - sb + 1);
                 if (err_handler_.error(json_parser_errc::illegal_character_in_string, *this))
                 {
                     ec = json_parser_errc::illegal_character_in_string;
@@ -2189,11 +2348,10 @@ string_u1:
                     return;
                 }
                 // recovery - keep
-                auto result = unicons::validate(sb,p_);
+                auto result = validate_utf8(sb,p_);
                 if (result.ec != unicons::conv_errc())
                 {
-                    translate_conv_errc(result.ec,ec);
-                    column_ += (result.it - sb);
+                    utf8_error(result.ec, result.it, ec);
                     return;
                 }
                 string_buffer_.append(sb, p_ - sb + 1);
@@ -2204,7 +2362,6 @@ string_u1:
             }
             case '\t':
             {
-                column_ += (p_ - sb + 1);
                 if (err_handler_.error(json_parser_errc::illegal_character_in_string, *this))
                 {
                     ec = json_parser_errc::illegal_character_in_string;
@@ -2212,11 +2369,10 @@ string_u1:
                     return;
                 }
                 // recovery - keep
-                auto result = unicons::validate(sb,p_);
+                auto result = validate_utf8(sb,p_);
                 if (result.ec != unicons::conv_errc())
                 {
-                    translate_conv_errc(result.ec,ec);
-                    column_ += (result.it - sb);
+                    utf8_error(result.ec, result.it, ec);
                     return;
                 }
                 string_buffer_.append(sb, p_ - sb + 1);
@@ -2226,45 +2382,46 @@ string_u1:
             }
             case '\\': 
             {
-                auto result = unicons::validate(sb,p_);
+                auto result = validate_utf8(sb,p_);
                 if (result.ec != unicons::conv_errc())
                 {
-                    translate_conv_errc(result.ec,ec);
-                    column_ += (result.it - sb);
+                    utf8_error(result.ec, result.it, ec);
                     return;
                 }
                 string_buffer_.append(sb,p_-sb);
-                column_ += (p_ - sb + 1);
                 ++p_;
                 goto escape;
             }
             case '\"':
             {
-                auto result = unicons::validate(sb,p_);
+                auto result = validate_utf8(sb,p_);
                 if (result.ec != unicons::conv_errc())
                 {
-                    translate_conv_errc(result.ec,ec);
-                    column_ += (result.it - sb);
+                    utf8_error(result.ec, result.it, ec);
                     return;
                 }
+                // The string is reported at the column of its first character
+                const size_t length = static_cast<size_t>(p_ - sb);
+                line_offset_ += length;
                 if (string_buffer_.length() == 0)
                 {
-                    end_string_value(sb,p_-sb, ec);
+                    end_string_value(sb, length, ec);
                     if (ec) {return;}
                 }
                 else
                 {
-                    string_buffer_.append(sb,p_-sb);
+                    string_buffer_.append(sb, length);
                     end_string_value(string_buffer_.data(),string_buffer_.length(), ec);
                     string_buffer_.clear();
                     if (ec) {return;}
                 }
-                column_ += (p_ - sb + 1);
+                line_offset_ -= length;
                 ++p_;
                 return;
             }
             default:
                 ++p_;
+                p_ = detail::skip_plain_string_chars(p_, local_end_input);
                 goto string_u1;
             }
 
@@ -2279,47 +2436,38 @@ escape:
         case '\"':
             string_buffer_.push_back('\"');
             sb = ++p_;
-            ++column_;
             goto string_u1;
         case '\\': 
             string_buffer_.push_back('\\');
             sb = ++p_;
-            ++column_;
             goto string_u1;
         case '/':
             string_buffer_.push_back('/');
             sb = ++p_;
-            ++column_;
             goto string_u1;
         case 'b':
             string_buffer_.push_back('\b');
             sb = ++p_;
-            ++column_;
             goto string_u1;
         case 'f':
             string_buffer_.push_back('\f');
             sb = ++p_;
-            ++column_;
             goto string_u1;
         case 'n':
             string_buffer_.push_back('\n');
             sb = ++p_;
-            ++column_;
             goto string_u1;
         case 'r':
             string_buffer_.push_back('\r');
             sb = ++p_;
-            ++column_;
             goto string_u1;
         case 't':
             string_buffer_.push_back('\t');
             sb = ++p_;
-            ++column_;
             goto string_u1;
         case 'u':
             cp_ = 0;
             ++p_;
-            ++column_;
             goto escape_u1;
         default:    
             err_handler_.error(json_parser_errc::illegal_escaped_character, *this);
@@ -2342,7 +2490,6 @@ escape_u1:
                 return;
             }
             ++p_;
-            ++column_;
             goto escape_u2;
         }
 
@@ -2360,7 +2507,6 @@ escape_u2:
                 return;
             }
             ++p_;
-            ++column_;
             goto escape_u3;
         }
 
@@ -2378,7 +2524,6 @@ escape_u3:
                 return;
             }
             ++p_;
-            ++column_;
             goto escape_u4;
         }
 
@@ -2398,14 +2543,12 @@ escape_u4:
             if (unicons::is_high_surrogate(cp_))
             {
                 ++p_;
-                ++column_;
                 goto escape_expect_surrogate_pair1;
             }
             else
             {
                 unicons::convert(&cp_, &cp_ + 1, std::back_inserter(string_buffer_));
                 sb = ++p_;
-                ++column_;
                 state_ = parse_state::string_u1;
                 return;
             }
@@ -2423,7 +2566,6 @@ escape_expect_surrogate_pair1:
             case '\\': 
                 cp2_ = 0;
                 ++p_;
-                ++column_;
                 goto escape_expect_surrogate_pair2;
             default:
                 err_handler_.error(json_parser_errc::expected_codepoint_surrogate_pair, *this);
@@ -2444,7 +2586,6 @@ escape_expect_surrogate_pair2:
             {
             case 'u':
                 ++p_;
-                ++column_;
                 goto escape_u6;
             default:
                 err_handler_.error(json_parser_errc::expected_codepoint_surrogate_pair, *this);
@@ -2469,7 +2610,6 @@ escape_u6:
             }
         }
         ++p_;
-        ++column_;
         goto escape_u7;
 
 escape_u7:
@@ -2486,7 +2626,6 @@ escape_u7:
                 return;
             }
             ++p_;
-            ++column_;
             goto escape_u8;
         }
 
@@ -2504,7 +2643,6 @@ escape_u8:
                 return;
             }
             ++p_;
-            ++column_;
             goto escape_u9;
         }
 
@@ -2524,13 +2662,71 @@ escape_u9:
             uint32_t cp = 0x10000 + ((cp_ & 0x3FF) << 10) + (cp2_ & 0x3FF);
             unicons::convert(&cp, &cp + 1, std::back_inserter(string_buffer_));
             sb = ++p_;
-            ++column_;
             goto string_u1;
         }
 
         JSONCONS_UNREACHABLE();               
     }
 
+    // Validates the string characters [first,last), unless they lie in the part of the
+    // source that set_source found to be well formed up front
+    unicons::convert_result<const CharT*> validate_utf8(const CharT* first, const CharT* last) const
+    {
+        if (last <= valid_utf8_end_)
+        {
+            return unicons::convert_result<const CharT*>{last, unicons::conv_errc()};
+        }
+        return unicons::validate(first, last);
+    }
+
+    // Where SIMD is available, checks the whole source with detail::is_valid_utf8 and, if it
+    // is well formed, returns its end, so that strings in it need not be validated one at a
+    // time. A sequence cut short at the end of the source, which may go on in the next one,
+    // is left out. Otherwise returns the start of the source.
+    const CharT* prevalidate_utf8(std::false_type) const
+    {
+        return begin_input_;
+    }
+
+    const CharT* prevalidate_utf8(std::true_type) const
+    {
+#if defined(JSONCONS_HAS_AVX2) || defined(JSONCONS_HAS_SSE2) || defined(JSONCONS_HAS_NEON)
+        const CharT* last = end_input_;
+        for (const CharT* p = end_input_; p > begin_input_ && end_input_ - p < 3; )
+        {
+            const uint8_t c = static_cast<uint8_t>(*--p);
+            if (c < 0x80)
+            {
+                break;
+            }
+            if (c >= 0xc0)
+            {
+                if (static_cast<size_t>(end_input_ - p) <= static_cast<size_t>(unicons::trailing_bytes_for_utf8[c]))
+                {
+                    last = p;
+                }
+                break;
+            }
+        }
+        return detail::is_valid_utf8(begin_input_, static_cast<size_t>(last - begin_input_)) ? last : begin_input_;
+#else
+        return begin_input_;
+#endif
+    }
+
+    // Reports an invalid UTF-8 sequence at the column where it begins. If the error handler
+    // lets the parse go on, it goes on from where it was.
+    void utf8_error(unicons::conv_errc result, const CharT* it, std::error_code& ec)
+    {
+        const CharT* p = p_;
+        p_ = it;
+        translate_conv_errc(result, ec);
+        if (!ec)
+        {
+            p_ = p;
+        }
+    }
+
     void translate_conv_errc(unicons::conv_errc result, std::error_code& ec)
     {
         switch (result)
@@ -2581,7 +2777,7 @@ escape_u9:
         parse(ec);
         if (ec)
         {
-            throw parse_error(ec,line_,column_);
+            throw parse_error(ec,line_,column_number());
         }
     }
 
@@ -2591,7 +2787,7 @@ escape_u9:
         end_parse(ec);
         if (ec)
         {
-            throw parse_error(ec,line_,column_);
+            throw parse_error(ec,line_,column_number());
         }
     }
 
@@ -2603,12 +2799,12 @@ escape_u9:
             {
                 case parse_state::positive_zero:  
                 case parse_state::positive_integer:
-                    end_positive_value(number_buffer_.data(), number_buffer_.length(), ec);
+                    end_positive_integer(ec);
                     if (ec) return;
                     break;
                 case parse_state::negative_zero:  
                 case parse_state::negative_integer:
-                    end_negative_value(number_buffer_.data(), number_buffer_.length(), ec);
+                    end_negative_integer(ec);
                     if (ec) return;
                     break;
                 case parse_state::fraction2:
@@ -2641,179 +2837,1096 @@ escape_u9:
 
     void set_source(const CharT* input, size_t length)
     {
+        // The new source follows on from what was consumed of the last one
+        source_offset_ = input_offset(p_);
+        input_length_ += length;
         begin_input_ = input;
         end_input_ = input + length;
         p_ = begin_input_;
+        valid_utf8_end_ = prevalidate_utf8(std::integral_constant<bool,std::is_same<CharT,char>::value>());
     }
-private:
 
-    void end_negative_value(const char* s, size_t length, std::error_code& ec)
+    bool parse_indexed()
     {
-        static const int64_t min_value = (std::numeric_limits<int64_t>::min)();
-        static const int64_t min_value_div_10 = min_value / 10;
-
-        int64_t n = 0;
-        bool overflow = false;
-        const char* end = s + length; 
-        for (; s < end; ++s)
+        std::error_code ec;
+        bool indexed = parse_indexed(ec);
+        if (ec)
         {
-            int64_t x = *s - '0';
-            if (n < min_value_div_10)
-            {
-                overflow = true;
-                break;
-            }
-            n = n * 10;
-            if (n < min_value + x)
-            {
-                overflow = true;
-                break;
-            }
-
-            n -= x;
-        }        
+            throw parse_error(ec,line_,column_number());
+        }
+        return indexed;
+    }
 
-        if (!overflow)
-        {
-            handler_.integer_value(n, *this);
+    // Parses a complete JSON text passed to set_source in two stages. The first stage
+    // indexes the offsets of all tokens, the second drives the input handler from
+    // that index. Returns false, without consuming any input, if the text cannot be 
+    // indexed (it has comments, or is not a narrow character text), parse should 
+    // then be used instead. Errors found in the second stage are returned in ec 
+    // without calling the error handler and are not recoverable, and the line and 
+    // column numbers of the parsing context are only set when they occur. Anything
+    // but whitespace after the text is returned as extra_character.
+    bool parse_indexed(std::error_code& ec)
+    {
+        return parse_indexed(ec, std::integral_constant<bool,std::is_same<CharT,char>::value>());
+    }
+private:
 
-            switch (parent())
-            {
-            case parse_state::array:
-            case parse_state::object:
-                state_ = parse_state::expect_comma_or_end;
-                break;
-            case parse_state::root:
-                state_ = parse_state::done;
-                handler_.end_json();
-                break;
-            default:
-                if (err_handler_.error(json_parser_errc::invalid_json_text, *this))
-                {
-                    ec = json_parser_errc::invalid_json_text;
-                    return;
-                }
-                break;
-            }
-        }
-        else
-        {
-            end_fraction_value(s, length, ec);
-        }
+    bool parse_indexed(std::error_code&, std::false_type)
+    {
+        return false;
     }
 
-    void end_positive_value(const char* s, size_t length, std::error_code& ec)
+    bool parse_indexed(std::error_code& ec, std::true_type)
     {
-        static const uint64_t max_value = (std::numeric_limits<uint64_t>::max)();
-        static const uint64_t max_value_div_10 = max_value / 10;
-        uint64_t n = 0;
-        bool overflow = false;
-        const char* end = s + length; 
-        for (; s < end; ++s)
+        if (state_ != parse_state::start)
         {
-            uint64_t x = *s - '0';
-            if (n > max_value_div_10)
-            {
-                overflow = true;
-                break;
-            }
-            n = n * 10;
-            if (n > max_value - x)
-            {
-                overflow = true;
-                break;
-            }
-
-            n += x;
+            return false;
         }
-
-        if (!overflow)
+        if (input_length_ > max_input_length_)
         {
-            handler_.uinteger_value(n, *this);
-
-            switch (parent())
-            {
-            case parse_state::array:
-            case parse_state::object:
-                state_ = parse_state::expect_comma_or_end;
-                break;
-            case parse_state::root:
-                state_ = parse_state::done;
-                handler_.end_json();
-                break;
-            default:
-                if (err_handler_.error(json_parser_errc::invalid_json_text, *this))
-                {
-                    ec = json_parser_errc::invalid_json_text;
-                    return;
-                }
-                break;
-            }
+            p_ = begin_input_;
+            indexed_error(json_parser_errc::max_input_length_exceeded, ec);
+            return true;
         }
-        else
+        if (!detail::build_structural_index(begin_input_, end_input_ - begin_input_, structural_positions_))
         {
-            end_fraction_value(s, length, ec);
+            return false;
         }
-    }
 
-    void end_fraction_value(const char* s, size_t length, std::error_code& ec)
-    {
-        try
-        {
-            double d = str_to_double_(s, length);
-            if (is_negative_)
-                d = -d;
+        const uint32_t* pos = structural_positions_.data();
+        const uint32_t* pos_end = pos + structural_positions_.size();
 
-            if (precision_ > std::numeric_limits<double>::max_digits10)
-            {
-                handler_.double_value(d, static_cast<uint8_t>(std::numeric_limits<double>::max_digits10), *this);
-            }
-            else
-            {
-                handler_.double_value(d, static_cast<uint8_t>(precision_), *this);
-            }
-        }
-        catch (...)
-        {
-            if (err_handler_.error(json_parser_errc::invalid_number, *this))
-            {
-                ec = json_parser_errc::invalid_number;
-                return;
-            }
-            handler_.null_value(*this); // recovery
-        }
+        handler_.begin_json();
+        state_ = parse_state::expect_value;
 
-        switch (parent())
+        while (state_ != parse_state::done)
         {
-        case parse_state::array:
-        case parse_state::object:
-            state_ = parse_state::expect_comma_or_end;
-            break;
-        case parse_state::root:
-            state_ = parse_state::done;
-            handler_.end_json();
-            break;
-        default:
-            if (err_handler_.error(json_parser_errc::invalid_json_text, *this))
+            if (JSONCONS_UNLIKELY(pos == pos_end))
             {
-                ec = json_parser_errc::invalid_json_text;
-                return;
+                p_ = end_input_;
+                indexed_error(json_parser_errc::unexpected_eof, ec);
+                return true;
             }
-            break;
-        }
-    }
+            p_ = begin_input_ + *pos++;
 
-    void append_codepoint(int c, std::error_code& ec)
-    {
-        switch (c)
-        {
-        case '0': case '1':case '2':case '3':case '4':case '5':case '6':case '7':case '8': case '9':
-        case 'a':case 'b':case 'c':case 'd':case 'e':case 'f':
-        case 'A':case 'B':case 'C':case 'D':case 'E':case 'F':
-            cp_ = append_to_codepoint(cp_, c, ec);
-            if (ec) return;
-            break;
-        default:
+            switch (state_)
+            {
+                case parse_state::expect_value:
+                case parse_state::expect_value_or_end:
+                    switch (*p_)
+                    {
+                        case '{':
+                            if (++nesting_depth_ > peak_nesting_depth_)
+                            {
+                                peak_nesting_depth_ = nesting_depth_;
+                            }
+                            if (nesting_depth_ >= max_depth_)
+                            {
+                                indexed_error(json_parser_errc::max_depth_exceeded, ec);
+                                return true;
+                            }
+                            begin_item_count();
+                            push_state(parse_state::object);
+                            state_ = parse_state::expect_member_name_or_end;
+                            skip_requested_ = false;
+                            handler_.begin_object(*this);
+                            if (skip_requested_)
+                            {
+                                pos = skip_indexed(pos, pos_end, true);
+                            }
+                            ++p_;
+                            break;
+                        case '[':
+                            if (++nesting_depth_ > peak_nesting_depth_)
+                            {
+                                peak_nesting_depth_ = nesting_depth_;
+                            }
+                            if (nesting_depth_ >= max_depth_)
+                            {
+                                indexed_error(json_parser_errc::max_depth_exceeded, ec);
+                                return true;
+                            }
+                            begin_item_count();
+                            push_state(parse_state::array);
+                            state_ = parse_state::expect_value_or_end;
+                            skip_requested_ = false;
+                            handler_.begin_array(*this);
+                            if (skip_requested_)
+                            {
+                                pos = skip_indexed(pos, pos_end, true);
+                            }
+                            ++p_;
+                            break;
+                        case ']':
+                            if (state_ == parse_state::expect_value_or_end)
+                            {
+                                end_indexed_structure();
+                                handler_.end_array(*this);
+                                after_indexed_value();
+                            }
+                            else
+                            {
+                                indexed_error(parent() == parse_state::array ? json_parser_errc::extra_comma : json_parser_errc::expected_value, ec);
+                                return true;
+                            }
+                            break;
+                        case '\"':
+                            if (keep_escaped_strings_)
+                            {
+                                scan_indexed_string(ec);
+                            }
+                            else
+                            {
+                                parse_indexed_string(ec);
+                            }
+                            if (ec) return true;
+                            if (string_escaped_)
+                            {
+                                detail::forward_escaped_string_value(handler_, string_view_type(string_data_, string_length_), *this);
+                            }
+                            else
+                            {
+                                handler_.string_value(string_view_type(string_data_, string_length_), *this);
+                            }
+                            after_indexed_value();
+                            break;
+                        case 't':
+                            if (!parse_indexed_literal("true", 4, ec)) return true;
+                            handler_.bool_value(true, *this);
+                            after_indexed_value();
+                            break;
+                        case 'f':
+                            if (!parse_indexed_literal("false", 5, ec)) return true;
+                            handler_.bool_value(false, *this);
+                            after_indexed_value();
+                            break;
+                        case 'n':
+                            if (!parse_indexed_literal("null", 4, ec)) return true;
+                            handler_.null_value(*this);
+                            after_indexed_value();
+                            break;
+                        case '-': case '0': case '1':case '2':case '3':case '4':case '5':case '6':case '7':case '8': case '9':
+                            parse_indexed_number(ec);
+                            if (ec) return true;
+                            after_indexed_value();
+                            break;
+                        case '\'':
+                            indexed_error(json_parser_errc::single_quote, ec);
+                            return true;
+                        default:
+                            indexed_error(json_parser_errc::expected_value, ec);
+                            return true;
+                    }
+                    break;
+                case parse_state::expect_member_name_or_end:
+                case parse_state::expect_member_name:
+                    switch (*p_)
+                    {
+                        case '\"':
+                            parse_indexed_string(ec);
+                            if (ec) return true;
+                            skip_requested_ = false;
+                            handler_.name(string_view_type(string_data_, string_length_), *this);
+                            state_ = parse_state::expect_colon;
+                            if (skip_requested_)
+                            {
+                                pos = skip_indexed(pos, pos_end, false);
+                            }
+                            break;
+                        case '}':
+                            if (state_ == parse_state::expect_member_name_or_end)
+                            {
+                                end_indexed_structure();
+                                handler_.end_object(*this);
+                                after_indexed_value();
+                            }
+                            else
+                            {
+                                indexed_error(json_parser_errc::extra_comma, ec);
+                                return true;
+                            }
+                            break;
+                        case '\'':
+                            indexed_error(json_parser_errc::single_quote, ec);
+                            return true;
+                        default:
+                            indexed_error(json_parser_errc::expected_name, ec);
+                            return true;
+                    }
+                    break;
+                case parse_state::expect_colon:
+                    if (*p_ != ':')
+                    {
+                        indexed_error(json_parser_errc::expected_colon, ec);
+                        return true;
+                    }
+                    ++p_;
+                    state_ = parse_state::expect_value;
+                    break;
+                case parse_state::expect_comma_or_end:
+                    if (*p_ == ',')
+                    {
+                        if (JSONCONS_UNLIKELY(++item_count_ >= max_items_))
+                        {
+                            indexed_error(json_parser_errc::max_items_exceeded, ec);
+                            return true;
+                        }
+                        ++p_;
+                        state_ = parent() == parse_state::object ? parse_state::expect_member_name : parse_state::expect_value;
+                    }
+                    else if (*p_ == '}' && parent() == parse_state::object)
+                    {
+                        end_indexed_structure();
+                        handler_.end_object(*this);
+                        after_indexed_value();
+                    }
+                    else if (*p_ == ']' && parent() == parse_state::array)
+                    {
+                        end_indexed_structure();
+                        handler_.end_array(*this);
+                        after_indexed_value();
+                    }
+                    else
+                    {
+                        indexed_error(parent() == parse_state::object ? json_parser_errc::expected_comma_or_right_brace : json_parser_errc::expected_comma_or_right_bracket, ec);
+                        return true;
+                    }
+                    break;
+                default:
+                    JSONCONS_UNREACHABLE();
+            }
+        }
+        // Anything but whitespace after the text is an error, so that parse, run again,
+        // reports it where it is
+        for (; p_ < end_input_; ++p_)
+        {
+            switch (*p_)
+            {
+                case ' ': case '\t': case '\n': case '\r':
+                    break;
+                default:
+                    indexed_error(json_parser_errc::extra_character, ec);
+                    return true;
+            }
+        }
+        return true;
+    }
+
+    // Skips the structural positions of a value, or of the rest of an array or object, up to
+    // the comma or the closing bracket that follows it. Strings and other values are single 
+    // positions in the index, so only brackets are looked at.
+    const uint32_t* skip_indexed(const uint32_t* pos, const uint32_t* pos_end, bool to_end)
+    {
+        state_ = parse_state::expect_comma_or_end;
+        size_t depth = 0;
+        for (; pos != pos_end; ++pos)
+        {
+            switch (begin_input_[*pos])
+            {
+                case '{': case '[':
+                    ++depth;
+                    break;
+                case '}': case ']':
+                    if (depth == 0)
+                    {
+                        return pos;
+                    }
+                    --depth;
+                    break;
+                case ',':
+                    if (depth == 0 && !to_end)
+                    {
+                        return pos;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        return pos;
+    }
+
+    void end_indexed_structure()
+    {
+        --nesting_depth_;
+        end_item_count();
+        pop_state();
+        ++p_;
+    }
+
+    void after_indexed_value()
+    {
+        if (parent() == parse_state::root)
+        {
+            state_ = parse_state::done;
+            handler_.end_json();
+        }
+        else
+        {
+            state_ = parse_state::expect_comma_or_end;
+        }
+    }
+
+    void indexed_error(json_parser_errc result, std::error_code& ec)
+    {
+        line_ = 1;
+        const CharT* line_begin = begin_input_;
+        for (const CharT* p = begin_input_; p < p_; ++p)
+        {
+            if (*p == '\n' || (*p == '\r' && (p + 1 == p_ || *(p + 1) != '\n')))
+            {
+                ++line_;
+                line_begin = p + 1;
+            }
+        }
+        line_offset_ = input_offset(line_begin);
+        ec = result;
+    }
+
+    static bool is_indexed_separator(CharT c)
+    {
+        switch (c)
+        {
+            case ' ': case '\t': case '\n': case '\r':
+            case '{': case '}': case '[': case ']': case ':': case ',': case '\"':
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool parse_indexed_literal(const char* literal, size_t length, std::error_code& ec)
+    {
+        if (static_cast<size_t>(end_input_ - p_) < length || std::char_traits<CharT>::compare(p_, literal, length) != 0 ||
+            (p_ + length < end_input_ && !is_indexed_separator(p_[length])))
+        {
+            indexed_error(json_parser_errc::invalid_value, ec);
+            return false;
+        }
+        p_ += length;
+        return true;
+    }
+
+    void parse_indexed_string(std::error_code& ec)
+    {
+        string_escaped_ = false;
+        string_buffer_.clear();
+        const CharT* sb = ++p_;
+        for (;;)
+        {
+            p_ = detail::skip_plain_string_chars(p_, end_input_);
+            if (JSONCONS_UNLIKELY(p_ == end_input_))
+            {
+                indexed_error(json_parser_errc::unexpected_eof, ec);
+                return;
+            }
+            switch (*p_)
+            {
+                case '\"':
+                    if (!validate_indexed_string(sb, ec)) return;
+                    if (string_buffer_.length() == 0)
+                    {
+                        string_data_ = sb;
+                        string_length_ = p_ - sb;
+                    }
+                    else
+                    {
+                        string_buffer_.append(sb, p_ - sb);
+                        string_data_ = string_buffer_.data();
+                        string_length_ = string_buffer_.length();
+                    }
+                    if (string_length_ > max_string_length_)
+                    {
+                        indexed_error(json_parser_errc::max_string_length_exceeded, ec);
+                        return;
+                    }
+                    ++p_;
+                    return;
+                case '\\':
+                    if (!validate_indexed_string(sb, ec)) return;
+                    string_buffer_.append(sb, p_ - sb);
+                    ++p_;
+                    parse_indexed_escape(ec);
+                    if (ec) return;
+                    sb = p_;
+                    break;
+                case '\r': case '\n': case '\t':
+                    indexed_error(json_parser_errc::illegal_character_in_string, ec);
+                    return;
+                default:
+                    indexed_error(json_parser_errc::illegal_control_character, ec);
+                    return;
+            }
+        }
+    }
+
+    // As parse_indexed_string, but the escapes are checked and not replaced, and the string
+    // is left as the text between its quotation marks, with string_escaped_ set if it has any
+    void scan_indexed_string(std::error_code& ec)
+    {
+        string_escaped_ = false;
+        const CharT* first = ++p_;
+        const CharT* sb = first;
+        size_t length = 0;
+        for (;;)
+        {
+            p_ = detail::skip_plain_string_chars(p_, end_input_);
+            if (JSONCONS_UNLIKELY(p_ == end_input_))
+            {
+                indexed_error(json_parser_errc::unexpected_eof, ec);
+                return;
+            }
+            switch (*p_)
+            {
+                case '\"':
+                    if (!validate_indexed_string(sb, ec)) return;
+                    length += p_ - sb;
+                    if (length > max_string_length_)
+                    {
+                        indexed_error(json_parser_errc::max_string_length_exceeded, ec);
+                        return;
+                    }
+                    string_data_ = first;
+                    string_length_ = p_ - first;
+                    ++p_;
+                    return;
+                case '\\':
+                    if (!validate_indexed_string(sb, ec)) return;
+                    length += p_ - sb;
+                    ++p_;
+                    length += scan_indexed_escape(ec);
+                    if (ec) return;
+                    string_escaped_ = true;
+                    sb = p_;
+                    break;
+                case '\r': case '\n': case '\t':
+                    indexed_error(json_parser_errc::illegal_character_in_string, ec);
+                    return;
+                default:
+                    indexed_error(json_parser_errc::illegal_control_character, ec);
+                    return;
+            }
+        }
+    }
+
+    bool validate_indexed_string(const CharT* sb, std::error_code& ec)
+    {
+        auto result = validate_utf8(sb,p_);
+        if (result.ec == unicons::conv_errc())
+        {
+            return true;
+        }
+        p_ = result.it;
+        switch (result.ec)
+        {
+            case unicons::conv_errc::over_long_utf8_sequence:
+                indexed_error(json_parser_errc::over_long_utf8_sequence, ec);
+                break;
+            case unicons::conv_errc::unpaired_high_surrogate:
+                indexed_error(json_parser_errc::unpaired_high_surrogate, ec);
+                break;
+            case unicons::conv_errc::expected_continuation_byte:
+                indexed_error(json_parser_errc::expected_continuation_byte, ec);
+                break;
+            case unicons::conv_errc::illegal_surrogate_value:
+                indexed_error(json_parser_errc::illegal_surrogate_value, ec);
+                break;
+            default:
+                indexed_error(json_parser_errc::illegal_codepoint, ec);
+                break;
+        }
+        return false;
+    }
+
+    void parse_indexed_escape(std::error_code& ec)
+    {
+        if (JSONCONS_UNLIKELY(p_ == end_input_))
+        {
+            indexed_error(json_parser_errc::unexpected_eof, ec);
+            return;
+        }
+        switch (*p_++)
+        {
+            case '\"':
+                string_buffer_.push_back('\"');
+                break;
+            case '\\':
+                string_buffer_.push_back('\\');
+                break;
+            case '/':
+                string_buffer_.push_back('/');
+                break;
+            case 'b':
+                string_buffer_.push_back('\b');
+                break;
+            case 'f':
+                string_buffer_.push_back('\f');
+                break;
+            case 'n':
+                string_buffer_.push_back('\n');
+                break;
+            case 'r':
+                string_buffer_.push_back('\r');
+                break;
+            case 't':
+                string_buffer_.push_back('\t');
+                break;
+            case 'u':
+            {
+                uint32_t cp;
+                if (!read_indexed_hex4(cp, ec)) return;
+                if (unicons::is_high_surrogate(cp))
+                {
+                    if (end_input_ - p_ < 2 || p_[0] != '\\' || p_[1] != 'u')
+                    {
+                        indexed_error(json_parser_errc::expected_codepoint_surrogate_pair, ec);
+                        return;
+                    }
+                    p_ += 2;
+                    uint32_t cp2;
+                    if (!read_indexed_hex4(cp2, ec)) return;
+                    cp = 0x10000 + ((cp & 0x3FF) << 10) + (cp2 & 0x3FF);
+                }
+                unicons::convert(&cp, &cp + 1, std::back_inserter(string_buffer_));
+                break;
+            }
+            default:
+                --p_;
+                indexed_error(json_parser_errc::illegal_escaped_character, ec);
+                break;
+        }
+    }
+
+    // Checks the escape at p_ as parse_indexed_escape does, and returns the number of
+    // characters it stands for
+    size_t scan_indexed_escape(std::error_code& ec)
+    {
+        if (JSONCONS_UNLIKELY(p_ == end_input_))
+        {
+            indexed_error(json_parser_errc::unexpected_eof, ec);
+            return 0;
+        }
+        switch (*p_++)
+        {
+            case '\"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+                return 1;
+            case 'u':
+            {
+                uint32_t cp;
+                if (!read_indexed_hex4(cp, ec)) return 0;
+                if (unicons::is_high_surrogate(cp))
+                {
+                    if (end_input_ - p_ < 2 || p_[0] != '\\' || p_[1] != 'u')
+                    {
+                        indexed_error(json_parser_errc::expected_codepoint_surrogate_pair, ec);
+                        return 0;
+                    }
+                    p_ += 2;
+                    uint32_t cp2;
+                    if (!read_indexed_hex4(cp2, ec)) return 0;
+                    return 4;
+                }
+                return cp < 0x80 ? 1 : (cp < 0x800 ? 2 : 3);
+            }
+            default:
+                --p_;
+                indexed_error(json_parser_errc::illegal_escaped_character, ec);
+                return 0;
+        }
+    }
+
+    bool read_indexed_hex4(uint32_t& cp, std::error_code& ec)
+    {
+        cp = 0;
+        for (int i = 0; i < 4; ++i, ++p_)
+        {
+            if (p_ == end_input_)
+            {
+                indexed_error(json_parser_errc::unexpected_eof, ec);
+                return false;
+            }
+            const CharT c = *p_;
+            cp *= 16;
+            if (c >= '0' && c <= '9')
+            {
+                cp += c - '0';
+            }
+            else if (c >= 'a' && c <= 'f')
+            {
+                cp += c - 'a' + 10;
+            }
+            else if (c >= 'A' && c <= 'F')
+            {
+                cp += c - 'A' + 10;
+            }
+            else
+            {
+                indexed_error(json_parser_errc::invalid_hex_escape_sequence, ec);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void parse_indexed_number(std::error_code& ec)
+    {
+        const CharT* s = p_;
+        is_negative_ = false;
+        if (*s == '-')
+        {
+            is_negative_ = true;
+            ++s;
+        }
+        const CharT* digits = s;
+        if (s == end_input_ || !(*s >= '0' && *s <= '9'))
+        {
+            p_ = s;
+            indexed_error(json_parser_errc::expected_value, ec);
+            return;
+        }
+        if (*s == '0')
+        {
+            ++s;
+            if (s < end_input_ && *s >= '0' && *s <= '9')
+            {
+                p_ = s;
+                indexed_error(json_parser_errc::leading_zero, ec);
+                return;
+            }
+        }
+        else
+        {
+            while (s < end_input_ && *s >= '0' && *s <= '9')
+            {
+                ++s;
+            }
+        }
+        size_t precision = s - digits;
+        bool is_integer = true;
+        if (s < end_input_ && *s == '.')
+        {
+            is_integer = false;
+            ++s;
+            const CharT* fraction = s;
+            while (s < end_input_ && *s >= '0' && *s <= '9')
+            {
+                ++s;
+            }
+            if (s == fraction)
+            {
+                p_ = s;
+                indexed_error(json_parser_errc::invalid_number, ec);
+                return;
+            }
+            precision += s - fraction;
+        }
+        if (s < end_input_ && (*s == 'e' || *s == 'E'))
+        {
+            is_integer = false;
+            ++s;
+            if (s < end_input_ && (*s == '+' || *s == '-'))
+            {
+                ++s;
+            }
+            const CharT* exponent = s;
+            while (s < end_input_ && *s >= '0' && *s <= '9')
+            {
+                ++s;
+            }
+            if (s == exponent)
+            {
+                p_ = s;
+                indexed_error(json_parser_errc::expected_value, ec);
+                return;
+            }
+        }
+        if (s < end_input_ && !is_indexed_separator(*s))
+        {
+            p_ = s;
+            indexed_error(json_parser_errc::invalid_number, ec);
+            return;
+        }
+        if (keep_number_text_)
+        {
+            number_text_value(string_view_type(p_, s - p_));
+            p_ = s;
+            return;
+        }
+        p_ = s;
+
+        if (is_integer)
+        {
+            if (is_negative_)
+            {
+                static const int64_t min_value = (std::numeric_limits<int64_t>::min)();
+                static const int64_t min_value_div_10 = min_value / 10;
+                int64_t n = 0;
+                const CharT* q = digits;
+                for (; q < s; ++q)
+                {
+                    int64_t x = *q - '0';
+                    if (n < min_value_div_10 || n * 10 < min_value + x)
+                    {
+                        break;
+                    }
+                    n = n * 10 - x;
+                }
+                if (q == s)
+                {
+                    handler_.integer_value(n, *this);
+                    return;
+                }
+            }
+            else
+            {
+                static const uint64_t max_value = (std::numeric_limits<uint64_t>::max)();
+                static const uint64_t max_value_div_10 = max_value / 10;
+                uint64_t n = 0;
+                const CharT* q = digits;
+                for (; q < s; ++q)
+                {
+                    uint64_t x = *q - '0';
+                    if (n > max_value_div_10 || n * 10 > max_value - x)
+                    {
+                        break;
+                    }
+                    n = n * 10 + x;
+                }
+                if (q == s)
+                {
+                    handler_.uinteger_value(n, *this);
+                    return;
+                }
+            }
+        }
+
+        number_buffer_.clear();
+        for (const CharT* q = digits; q < s; ++q)
+        {
+            if (*q != '+')
+            {
+                number_buffer_.push_back(static_cast<char>(*q));
+            }
+        }
+        try
+        {
+            double d = str_to_double_(number_buffer_.data(), number_buffer_.length());
+            if (is_negative_)
+                d = -d;
+            if (precision > static_cast<size_t>(std::numeric_limits<double>::max_digits10))
+            {
+                handler_.double_value(d, static_cast<uint8_t>(std::numeric_limits<double>::max_digits10), *this);
+            }
+            else
+            {
+                handler_.double_value(d, static_cast<uint8_t>(precision), *this);
+            }
+        }
+        catch (...)
+        {
+            indexed_error(json_parser_errc::invalid_number, ec);
+        }
+    }
+
+    // The digits of an integer are accumulated in integer_value_ while they fit in a
+    // uint64_t, and only written to number_buffer_ if the number turns out to be longer,
+    // or not an integer. Until then number_buffer_ is empty.
+    // Define JSONCONS_NO_INTEGER_ACCUMULATION to put every digit in number_buffer_.
+
+    void append_integer_digit(CharT c)
+    {
+#if !defined(JSONCONS_NO_INTEGER_ACCUMULATION)
+        static const uint64_t max_value = (std::numeric_limits<uint64_t>::max)();
+        if (number_buffer_.empty())
+        {
+            const uint64_t x = static_cast<uint64_t>(c - '0');
+            if (precision_ < 19 || (precision_ == 19 && integer_value_ <= (max_value - x) / 10))
+            {
+                integer_value_ = integer_value_*10 + x;
+                ++precision_;
+                return;
+            }
+            write_accumulated_digits();
+        }
+#endif
+        number_buffer_.push_back(static_cast<char>(c));
+        ++precision_;
+    }
+
+    // Appends the run of digits at p_, at least one
+    void append_integer_digits(const CharT* last)
+    {
+#if !defined(JSONCONS_NO_INTEGER_ACCUMULATION)
+        if (number_buffer_.empty())
+        {
+            const CharT* p = p_;
+            uint64_t n = integer_value_;
+            uint8_t digits = precision_;
+            while (digits < 19 && p < last && *p >= '0' && *p <= '9')
+            {
+                n = n*10 + static_cast<uint64_t>(*p - '0');
+                ++p;
+                ++digits;
+            }
+            p_ = p;
+            integer_value_ = n;
+            precision_ = digits;
+            if (p == last || *p < '0' || *p > '9')
+            {
+                return;
+            }
+        }
+#endif
+        append_integer_digit(*p_);
+        ++p_;
+    }
+
+    void write_accumulated_digits()
+    {
+#if !defined(JSONCONS_NO_INTEGER_ACCUMULATION)
+        if (number_buffer_.empty())
+        {
+            char buf[20];
+            char* last = buf + sizeof(buf);
+            char* first = last;
+            uint64_t n = integer_value_;
+            do
+            {
+                *--first = static_cast<char>('0' + n % 10);
+                n /= 10;
+            }
+            while (n != 0);
+            number_buffer_.append(first, last);
+        }
+#endif
+    }
+
+    void number_text_value(const string_view_type& text)
+    {
+        detail::forward_number_value(handler_, text, *this);
+    }
+
+    // The text of the number is the sign, if negative, and number_buffer_, or the
+    // accumulated digits if number_buffer_ is empty
+    void end_number_text(std::error_code& ec)
+    {
+        write_accumulated_digits();
+        string_buffer_.clear();
+        if (is_negative_)
+        {
+            string_buffer_.push_back('-');
+        }
+        for (char c : number_buffer_)
+        {
+            string_buffer_.push_back(static_cast<CharT>(c));
+        }
+        number_text_value(string_view_type(string_buffer_.data(), string_buffer_.length()));
+        string_buffer_.clear();
+        end_integer_value(ec);
+    }
+
+    void end_positive_integer(std::error_code& ec)
+    {
+        if (keep_number_text_)
+        {
+            end_number_text(ec);
+            return;
+        }
+#if !defined(JSONCONS_NO_INTEGER_ACCUMULATION)
+        if (number_buffer_.empty())
+        {
+            handler_.uinteger_value(integer_value_, *this);
+            end_integer_value(ec);
+            return;
+        }
+#endif
+        end_positive_value(number_buffer_.data(), number_buffer_.length(), ec);
+    }
+
+    void end_negative_integer(std::error_code& ec)
+    {
+        if (keep_number_text_)
+        {
+            end_number_text(ec);
+            return;
+        }
+#if !defined(JSONCONS_NO_INTEGER_ACCUMULATION)
+        static const uint64_t max_magnitude = uint64_t(1) << 63;
+        if (number_buffer_.empty())
+        {
+            if (integer_value_ <= max_magnitude)
+            {
+                int64_t n = integer_value_ == max_magnitude 
+                    ? (std::numeric_limits<int64_t>::min)() 
+                    : -static_cast<int64_t>(integer_value_);
+                handler_.integer_value(n, *this);
+                end_integer_value(ec);
+                return;
+            }
+            write_accumulated_digits();
+        }
+#endif
+        end_negative_value(number_buffer_.data(), number_buffer_.length(), ec);
+    }
+
+    void end_integer_value(std::error_code& ec)
+    {
+        switch (parent())
+        {
+        case parse_state::array:
+        case parse_state::object:
+            state_ = parse_state::expect_comma_or_end;
+            break;
+        case parse_state::root:
+            state_ = parse_state::done;
+            handler_.end_json();
+            break;
+        default:
+            if (err_handler_.error(json_parser_errc::invalid_json_text, *this))
+            {
+                ec = json_parser_errc::invalid_json_text;
+                return;
+            }
+            break;
+        }
+    }
+
+    void end_negative_value(const char* s, size_t length, std::error_code& ec)
+    {
+        static const int64_t min_value = (std::numeric_limits<int64_t>::min)();
+        static const int64_t min_value_div_10 = min_value / 10;
+
+        int64_t n = 0;
+        bool overflow = false;
+        const char* end = s + length; 
+        for (const char* q = s; q < end; ++q)
+        {
+            int64_t x = *q - '0';
+            if (n < min_value_div_10)
+            {
+                overflow = true;
+                break;
+            }
+            n = n * 10;
+            if (n < min_value + x)
+            {
+                overflow = true;
+                break;
+            }
+
+            n -= x;
+        }        
+
+        if (!overflow)
+        {
+            handler_.integer_value(n, *this);
+            end_integer_value(ec);
+        }
+        else
+        {
+            end_fraction_value(s, length, ec);
+        }
+    }
+
+    void end_positive_value(const char* s, size_t length, std::error_code& ec)
+    {
+        static const uint64_t max_value = (std::numeric_limits<uint64_t>::max)();
+        static const uint64_t max_value_div_10 = max_value / 10;
+        uint64_t n = 0;
+        bool overflow = false;
+        const char* end = s + length; 
+        for (const char* q = s; q < end; ++q)
+        {
+            uint64_t x = *q - '0';
+            if (n > max_value_div_10)
+            {
+                overflow = true;
+                break;
+            }
+            n = n * 10;
+            if (n > max_value - x)
+            {
+                overflow = true;
+                break;
+            }
+
+            n += x;
+        }
+
+        if (!overflow)
+        {
+            handler_.uinteger_value(n, *this);
+            end_integer_value(ec);
+        }
+        else
+        {
+            end_fraction_value(s, length, ec);
+        }
+    }
+
+    void end_fraction_value(const char* s, size_t length, std::error_code& ec)
+    {
+        if (keep_number_text_)
+        {
+            end_number_text(ec);
+            return;
+        }
+        try
+        {
+            double d = str_to_double_(s, length);
+            if (is_negative_)
+                d = -d;
+
+            if (precision_ > std::numeric_limits<double>::max_digits10)
+            {
+                handler_.double_value(d, static_cast<uint8_t>(std::numeric_limits<double>::max_digits10), *this);
+            }
+            else
+            {
+                handler_.double_value(d, static_cast<uint8_t>(precision_), *this);
+            }
+        }
+        catch (...)
+        {
+            if (err_handler_.error(json_parser_errc::invalid_number, *this))
+            {
+                ec = json_parser_errc::invalid_number;
+                return;
+            }
+            handler_.null_value(*this); // recovery
+        }
+
+        switch (parent())
+        {
+        case parse_state::array:
+        case parse_state::object:
+            state_ = parse_state::expect_comma_or_end;
+            break;
+        case parse_state::root:
+            state_ = parse_state::done;
+            handler_.end_json();
+            break;
+        default:
+            if (err_handler_.error(json_parser_errc::invalid_json_text, *this))
+            {
+                ec = json_parser_errc::invalid_json_text;
+                return;
+            }
+            break;
+        }
+    }
+
+    void append_codepoint(int c, std::error_code& ec)
+    {
+        switch (c)
+        {
+        case '0': case '1':case '2':case '3':case '4':case '5':case '6':case '7':case '8': case '9':
+        case 'a':case 'b':case 'c':case 'd':case 'e':case 'f':
+        case 'A':case 'B':case 'C':case 'D':case 'E':case 'F':
+            cp_ = append_to_codepoint(cp_, c, ec);
+            if (ec) return;
+            break;
+        default:
             if (err_handler_.error(json_parser_errc::expected_value, *this))
             {
                 ec = json_parser_errc::expected_value;
@@ -2846,12 +3959,22 @@ private:
 
     void end_string_value(const CharT* s, size_t length, std::error_code& ec) 
     {
+        if (length > max_string_length_)
+        {
+            limit_exceeded(json_parser_errc::max_string_length_exceeded, ec);
+            return;
+        }
         switch (parent())
         {
         case parse_state::member_name:
+            skip_requested_ = false;
             handler_.name(string_view_type(s, length), *this);
             state_ = pop_state();
             state_ = parse_state::expect_colon;
+            if (skip_requested_)
+            {
+                begin_skip(false);
+            }
             break;
         case parse_state::object:
         case parse_state::array:
@@ -2878,9 +4001,19 @@ private:
         switch (parent())
         {
         case parse_state::object:
+            if (JSONCONS_UNLIKELY(++item_count_ >= max_items_))
+            {
+                limit_exceeded(json_parser_errc::max_items_exceeded, ec);
+                return;
+            }
             state_ = parse_state::expect_member_name;
             break;
         case parse_state::array:
+            if (JSONCONS_UNLIKELY(++item_count_ >= max_items_))
+            {
+                limit_exceeded(json_parser_errc::max_items_exceeded, ec);
+                return;
+            }
             state_ = parse_state::expect_value;
             break;
         case parse_state::root:
@@ -2895,6 +4028,128 @@ private:
         }
     }
 
+    void begin_skip(bool to_end)
+    {
+        skip_to_end_ = to_end;
+        skip_depth_ = 0;
+        state_ = parse_state::skip;
+    }
+
+    // Scans to the comma or closing bracket that ends a skipped value, or the closing bracket
+    // of a skipped object or array, and leaves it for expect_comma_or_end. Only quotes, escapes 
+    // and brackets are looked at, nothing is converted or validated, and line numbers are kept.
+    void skip_some()
+    {
+        const CharT* local_end_input = end_input_;
+
+        switch (state_)
+        {
+            case parse_state::skip_string:
+                goto skip_string;
+            case parse_state::skip_escape:
+                goto skip_escape;
+            default:
+                break;
+        }
+
+skip_value:
+        for (; p_ < local_end_input; ++p_)
+        {
+            switch (*p_)
+            {
+                case '\"':
+                    ++p_;
+                    goto skip_string;
+                case '{': case '[':
+                    ++skip_depth_;
+                    break;
+                case '}': case ']':
+                    if (skip_depth_ == 0)
+                    {
+                        state_ = parse_state::expect_comma_or_end;
+                        return;
+                    }
+                    --skip_depth_;
+                    break;
+                case ',':
+                    if (skip_depth_ == 0 && !skip_to_end_)
+                    {
+                        state_ = parse_state::expect_comma_or_end;
+                        return;
+                    }
+                    break;
+                case '\n':
+                    ++line_;
+                    line_offset_ = input_offset(p_ + 1);
+                    break;
+                default:
+                    break;
+            }
+        }
+        state_ = parse_state::skip;
+        return;
+
+skip_string:
+        p_ = detail::skip_plain_string_chars(p_, local_end_input);
+        if (p_ == local_end_input)
+        {
+            state_ = parse_state::skip_string;
+            return;
+        }
+        switch (*p_)
+        {
+            case '\"':
+                ++p_;
+                goto skip_value;
+            case '\\':
+                ++p_;
+                goto skip_escape;
+            default:
+                ++p_;
+                goto skip_string;
+        }
+
+skip_escape:
+        if (p_ == local_end_input)
+        {
+            state_ = parse_state::skip_escape;
+            return;
+        }
+        ++p_;
+        goto skip_string;
+    }
+
+    void do_skip_value() const override
+    {
+        skip_requested_ = true;
+    }
+
+    // Items are counted by their separators, so the stack of counts is only kept when
+    // max_items_ is set
+    void begin_item_count()
+    {
+        if (max_items_ != (std::numeric_limits<size_t>::max)())
+        {
+            item_count_stack_.push_back(item_count_);
+        }
+        item_count_ = 0;
+    }
+
+    void end_item_count()
+    {
+        if (!item_count_stack_.empty())
+        {
+            item_count_ = item_count_stack_.back();
+            item_count_stack_.pop_back();
+        }
+    }
+
+    void limit_exceeded(json_parser_errc result, std::error_code& ec)
+    {
+        err_handler_.fatal_error(result, *this);
+        ec = result;
+    }
+
     void push_state(parse_state state)
     {
         state_stack_.push_back(state);
@@ -2941,7 +4196,17 @@ private:
 
     size_t do_column_number() const override
     {
-        return column_;
+        return column_number();
+    }
+
+    size_t do_offset() const override
+    {
+        return offset();
+    }
+
+    size_t input_offset(const CharT* p) const
+    {
+        return source_offset_ + static_cast<size_t>(p - begin_input_);
     }
 };
 
@@ -0,0 +1,722 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSON_PIPELINE_HPP
+#define JSONCONS_JSON_PIPELINE_HPP
+
+#include <string>
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <algorithm>
+#include <initializer_list>
+#include <type_traits>
+#include <jsoncons/json_input_handler.hpp>
+#include <jsoncons/parse_error_handler.hpp>
+#include <jsoncons/json_member_traits.hpp>
+
+namespace jsoncons {
+
+// Filter stages composed at compile time. A stage receives each event together with the next
+// link of the pipeline, and passes on what it wants to, with calls that the compiler can see
+// through, so a pipeline of stages ending in a handler is one handler with a single virtual
+// call per event, at the end, instead of one per stage.
+//
+// A stage derives from basic_json_pipeline_stage, which passes every event on unchanged,
+// and hides the events it changes with member function templates of the same form. A stage
+// that changes string values hides escaped_string_value as well, and one that changes numbers
+// hides number_value, as the parser may pass strings and numbers as their source text.
+
+namespace detail {
+
+struct json_pipeline_stage_tag {};
+
+}
+
+template <class CharT>
+class basic_json_pipeline_stage : public detail::json_pipeline_stage_tag
+{
+public:
+    typedef CharT char_type;
+    typedef typename basic_json_input_handler<CharT>::string_view_type string_view_type;
+
+    template <class Next>
+    void begin_json(Next& next)
+    {
+        next.begin_json();
+    }
+
+    template <class Next>
+    void end_json(Next& next)
+    {
+        next.end_json();
+    }
+
+    template <class Next>
+    void begin_object(const parsing_context& context, Next& next)
+    {
+        next.begin_object(context);
+    }
+
+    template <class Next>
+    void end_object(const parsing_context& context, Next& next)
+    {
+        next.end_object(context);
+    }
+
+    template <class Next>
+    void begin_array(const parsing_context& context, Next& next)
+    {
+        next.begin_array(context);
+    }
+
+    template <class Next>
+    void end_array(const parsing_context& context, Next& next)
+    {
+        next.end_array(context);
+    }
+
+    template <class Next>
+    void name(const string_view_type& name, const parsing_context& context, Next& next)
+    {
+        next.name(name, context);
+    }
+
+    template <class Next>
+    void string_value(const string_view_type& value, const parsing_context& context, Next& next)
+    {
+        next.string_value(value, context);
+    }
+
+    template <class Next>
+    void byte_string_value(const uint8_t* data, size_t length, const parsing_context& context, Next& next)
+    {
+        next.byte_string_value(data, length, context);
+    }
+
+    template <class Next>
+    void integer_value(int64_t value, const parsing_context& context, Next& next)
+    {
+        next.integer_value(value, context);
+    }
+
+    template <class Next>
+    void uinteger_value(uint64_t value, const parsing_context& context, Next& next)
+    {
+        next.uinteger_value(value, context);
+    }
+
+    template <class Next>
+    void double_value(double value, uint8_t precision, const parsing_context& context, Next& next)
+    {
+        next.double_value(value, precision, context);
+    }
+
+    template <class Next>
+    void number_value(const string_view_type& text, const parsing_context& context, Next& next)
+    {
+        next.number_value(text, context);
+    }
+
+    template <class Next>
+    void escaped_string_value(const string_view_type& text, const parsing_context& context, Next& next)
+    {
+        next.escaped_string_value(text, context);
+    }
+
+    template <class Next>
+    void bool_value(bool value, const parsing_context& context, Next& next)
+    {
+        next.bool_value(value, context);
+    }
+
+    template <class Next>
+    void null_value(const parsing_context& context, Next& next)
+    {
+        next.null_value(context);
+    }
+};
+
+// Drops the begin_json and end_json events, like basic_json_fragment_filter
+template <class CharT>
+class basic_fragment_stage : public basic_json_pipeline_stage<CharT>
+{
+public:
+    template <class Next>
+    void begin_json(Next&)
+    {
+    }
+
+    template <class Next>
+    void end_json(Next&)
+    {
+    }
+};
+
+// Renames object members, like basic_rename_object_member_filter, but for any number of
+// names at once. The names are kept sorted by their hashes, and a name read from the text is
+// only hashed if there is a name of its length to rename. Names are compared as views, and
+// nothing is copied.
+template <class CharT>
+class basic_rename_members_stage : public basic_json_pipeline_stage<CharT>
+{
+public:
+    using typename basic_json_pipeline_stage<CharT>::string_view_type;
+private:
+    struct entry
+    {
+        uint64_t hash;
+        std::basic_string<CharT> name;
+        std::basic_string<CharT> new_name;
+    };
+
+    std::vector<entry> entries_;
+    // Bit n is set if a name of length n, or of 63 or more for bit 63, is renamed
+    uint64_t lengths_;
+public:
+    basic_rename_members_stage(const std::basic_string<CharT>& name,
+                               const std::basic_string<CharT>& new_name)
+        : lengths_(0)
+    {
+        add(name, new_name);
+    }
+
+    basic_rename_members_stage(std::initializer_list<std::pair<std::basic_string<CharT>,std::basic_string<CharT>>> names)
+        : lengths_(0)
+    {
+        for (const auto& item : names)
+        {
+            add(item.first, item.second);
+        }
+    }
+
+    template <class Next>
+    void name(const string_view_type& name, const parsing_context& context, Next& next)
+    {
+        if (lengths_ & length_bit(name.length()))
+        {
+            uint64_t hash = detail::member_name_hash(name.data(), name.length());
+            auto it = std::lower_bound(entries_.begin(), entries_.end(), hash,
+                                       [](const entry& a, uint64_t h){return a.hash < h;});
+            for (; it != entries_.end() && it->hash == hash; ++it)
+            {
+                if (name == string_view_type(it->name.data(), it->name.length()))
+                {
+                    next.name(string_view_type(it->new_name.data(), it->new_name.length()), context);
+                    return;
+                }
+            }
+        }
+        next.name(name, context);
+    }
+private:
+    static uint64_t length_bit(size_t length)
+    {
+        return uint64_t(1) << (length < 63 ? length : 63);
+    }
+
+    void add(const std::basic_string<CharT>& name, const std::basic_string<CharT>& new_name)
+    {
+        entry e = {detail::member_name_hash(name.data(), name.length()), name, new_name};
+        auto it = std::upper_bound(entries_.begin(), entries_.end(), e.hash,
+                                   [](uint64_t h, const entry& a){return h < a.hash;});
+        entries_.insert(it, std::move(e));
+        lengths_ |= length_bit(name.length());
+    }
+};
+
+namespace detail {
+
+// The part of a pipeline from stage I on, which passes the events it is given to that stage,
+// with the link after it as the stage's next
+template <class Stages, class Handler, size_t I, bool Last = (I == std::tuple_size<Stages>::value)>
+class json_pipeline_link
+{
+    typedef json_pipeline_link<Stages,Handler,I+1> next_type;
+    typedef typename std::tuple_element<I,Stages>::type stage_type;
+    typedef typename stage_type::string_view_type string_view_type;
+
+    Stages& stages_;
+    Handler& handler_;
+public:
+    json_pipeline_link(Stages& stages, Handler& handler)
+        : stages_(stages), handler_(handler)
+    {
+    }
+
+    void begin_json()
+    {
+        next_type next(stages_, handler_);
+        std::get<I>(stages_).begin_json(next);
+    }
+
+    void end_json()
+    {
+        next_type next(stages_, handler_);
+        std::get<I>(stages_).end_json(next);
+    }
+
+    void begin_object(const parsing_context& context)
+    {
+        next_type next(stages_, handler_);
+        std::get<I>(stages_).begin_object(context, next);
+    }
+
+    void end_object(const parsing_context& context)
+    {
+        next_type next(stages_, handler_);
+        std::get<I>(stages_).end_object(context, next);
+    }
+
+    void begin_array(const parsing_context& context)
+    {
+        next_type next(stages_, handler_);
+        std::get<I>(stages_).begin_array(context, next);
+    }
+
+    void end_array(const parsing_context& context)
+    {
+        next_type next(stages_, handler_);
+        std::get<I>(stages_).end_array(context, next);
+    }
+
+    void name(const string_view_type& name, const parsing_context& context)
+    {
+        next_type next(stages_, handler_);
+        std::get<I>(stages_).name(name, context, next);
+    }
+
+    void string_value(const string_view_type& value, const parsing_context& context)
+    {
+        next_type next(stages_, handler_);
+        std::get<I>(stages_).string_value(value, context, next);
+    }
+
+    void byte_string_value(const uint8_t* data, size_t length, const parsing_context& context)
+    {
+        next_type next(stages_, handler_);
+        std::get<I>(stages_).byte_string_value(data, length, context, next);
+    }
+
+    void integer_value(int64_t value, const parsing_context& context)
+    {
+        next_type next(stages_, handler_);
+        std::get<I>(stages_).integer_value(value, context, next);
+    }
+
+    void uinteger_value(uint64_t value, const parsing_context& context)
+    {
+        next_type next(stages_, handler_);
+        std::get<I>(stages_).uinteger_value(value, context, next);
+    }
+
+    void double_value(double value, uint8_t precision, const parsing_context& context)
+    {
+        next_type next(stages_, handler_);
+        std::get<I>(stages_).double_value(value, precision, context, next);
+    }
+
+    void number_value(const string_view_type& text, const parsing_context& context)
+    {
+        next_type next(stages_, handler_);
+        std::get<I>(stages_).number_value(text, context, next);
+    }
+
+    void escaped_string_value(const string_view_type& text, const parsing_context& context)
+    {
+        next_type next(stages_, handler_);
+        std::get<I>(stages_).escaped_string_value(text, context, next);
+    }
+
+    void bool_value(bool value, const parsing_context& context)
+    {
+        next_type next(stages_, handler_);
+        std::get<I>(stages_).bool_value(value, context, next);
+    }
+
+    void null_value(const parsing_context& context)
+    {
+        next_type next(stages_, handler_);
+        std::get<I>(stages_).null_value(context, next);
+    }
+};
+
+// The end of a pipeline, which passes the events to the handler
+template <class Stages, class Handler, size_t I>
+class json_pipeline_link<Stages,Handler,I,true>
+{
+    typedef typename Handler::string_view_type string_view_type;
+
+    Handler& handler_;
+public:
+    json_pipeline_link(Stages&, Handler& handler)
+        : handler_(handler)
+    {
+    }
+
+    void begin_json()
+    {
+        handler_.begin_json();
+    }
+
+    void end_json()
+    {
+        handler_.end_json();
+    }
+
+    void begin_object(const parsing_context& context)
+    {
+        handler_.begin_object(context);
+    }
+
+    void end_object(const parsing_context& context)
+    {
+        handler_.end_object(context);
+    }
+
+    void begin_array(const parsing_context& context)
+    {
+        handler_.begin_array(context);
+    }
+
+    void end_array(const parsing_context& context)
+    {
+        handler_.end_array(context);
+    }
+
+    void name(const string_view_type& name, const parsing_context& context)
+    {
+        handler_.name(name, context);
+    }
+
+    void string_value(const string_view_type& value, const parsing_context& context)
+    {
+        handler_.string_value(value, context);
+    }
+
+    void byte_string_value(const uint8_t* data, size_t length, const parsing_context& context)
+    {
+        handler_.byte_string_value(data, length, context);
+    }
+
+    void integer_value(int64_t value, const parsing_context& context)
+    {
+        handler_.integer_value(value, context);
+    }
+
+    void uinteger_value(uint64_t value, const parsing_context& context)
+    {
+        handler_.uinteger_value(value, context);
+    }
+
+    void double_value(double value, uint8_t precision, const parsing_context& context)
+    {
+        handler_.double_value(value, precision, context);
+    }
+
+    void number_value(const string_view_type& text, const parsing_context& context)
+    {
+        detail::forward_number_value(handler_, text, context);
+    }
+
+    void escaped_string_value(const string_view_type& text, const parsing_context& context)
+    {
+        detail::forward_escaped_string_value(handler_, text, context);
+    }
+
+    void bool_value(bool value, const parsing_context& context)
+    {
+        handler_.bool_value(value, context);
+    }
+
+    void null_value(const parsing_context& context)
+    {
+        handler_.null_value(context);
+    }
+};
+
+template <class T>
+struct is_json_pipeline_stage
+    : std::integral_constant<bool,std::is_base_of<json_pipeline_stage_tag,typename std::decay<T>::type>::value>
+{};
+
+}
+
+// A sequence of stages that doesn't yet end in a handler
+template <class... Stages>
+class json_pipeline_stages
+{
+    std::tuple<Stages...> stages_;
+public:
+    explicit json_pipeline_stages(std::tuple<Stages...>&& stages)
+        : stages_(std::move(stages))
+    {
+    }
+
+    std::tuple<Stages...>& stages()
+    {
+        return stages_;
+    }
+};
+
+// A handler made of stages and the handler they end in, which it refers to. The member
+// functions for the events are inline, so the pipeline can be the Handler of a
+// basic_json_parser without any virtual calls but the handler's own. As a
+// basic_json_input_handler, e.g. for a json_reader, it adds one virtual call per event.
+
+template <class Handler, class... Stages>
+class basic_json_pipeline : public basic_json_input_handler<typename Handler::char_type>
+{
+public:
+    typedef typename Handler::char_type char_type;
+    typedef typename basic_json_input_handler<char_type>::string_view_type string_view_type;
+private:
+    typedef std::tuple<Stages...> stages_type;
+    typedef detail::json_pipeline_link<stages_type,Handler,0> head_type;
+
+    stages_type stages_;
+    Handler& handler_;
+public:
+    basic_json_pipeline(Handler& handler, Stages... stages)
+        : stages_(std::move(stages)...), handler_(handler)
+    {
+    }
+
+    basic_json_pipeline(Handler& handler, stages_type&& stages)
+        : stages_(std::move(stages)), handler_(handler)
+    {
+    }
+
+    basic_json_pipeline(basic_json_pipeline&& other)
+        : stages_(std::move(other.stages_)), handler_(other.handler_)
+    {
+    }
+
+    template <size_t I>
+    typename std::tuple_element<I,stages_type>::type& stage()
+    {
+        return std::get<I>(stages_);
+    }
+
+    Handler& handler()
+    {
+        return handler_;
+    }
+
+    void begin_json()
+    {
+        head().begin_json();
+    }
+
+    void end_json()
+    {
+        head().end_json();
+    }
+
+    void begin_object(const parsing_context& context)
+    {
+        head().begin_object(context);
+    }
+
+    void end_object(const parsing_context& context)
+    {
+        head().end_object(context);
+    }
+
+    void begin_array(const parsing_context& context)
+    {
+        head().begin_array(context);
+    }
+
+    void end_array(const parsing_context& context)
+    {
+        head().end_array(context);
+    }
+
+    void name(const string_view_type& name, const parsing_context& context)
+    {
+        head().name(name, context);
+    }
+
+    void string_value(const string_view_type& value, const parsing_context& context)
+    {
+        head().string_value(value, context);
+    }
+
+    void byte_string_value(const uint8_t* data, size_t length, const parsing_context& context)
+    {
+        head().byte_string_value(data, length, context);
+    }
+
+    void integer_value(int64_t value, const parsing_context& context)
+    {
+        head().integer_value(value, context);
+    }
+
+    void uinteger_value(uint64_t value, const parsing_context& context)
+    {
+        head().uinteger_value(value, context);
+    }
+
+    void double_value(double value, uint8_t precision, const parsing_context& context)
+    {
+        head().double_value(value, precision, context);
+    }
+
+    void number_value(const string_view_type& text, const parsing_context& context)
+    {
+        head().number_value(text, context);
+    }
+
+    void escaped_string_value(const string_view_type& text, const parsing_context& context)
+    {
+        head().escaped_string_value(text, context);
+    }
+
+    void bool_value(bool value, const parsing_context& context)
+    {
+        head().bool_value(value, context);
+    }
+
+    void null_value(const parsing_context& context)
+    {
+        head().null_value(context);
+    }
+private:
+    head_type head()
+    {
+        return head_type(stages_, handler_);
+    }
+
+    void do_begin_json() override
+    {
+        begin_json();
+    }
+
+    void do_end_json() override
+    {
+        end_json();
+    }
+
+    void do_begin_object(const parsing_context& context) override
+    {
+        begin_object(context);
+    }
+
+    void do_end_object(const parsing_context& context) override
+    {
+        end_object(context);
+    }
+
+    void do_begin_array(const parsing_context& context) override
+    {
+        begin_array(context);
+    }
+
+    void do_end_array(const parsing_context& context) override
+    {
+        end_array(context);
+    }
+
+    void do_name(const string_view_type& name, const parsing_context& context) override
+    {
+        this->name(name, context);
+    }
+
+    void do_string_value(const string_view_type& value, const parsing_context& context) override
+    {
+        string_value(value, context);
+    }
+
+    void do_byte_string_value(const uint8_t* data, size_t length, const parsing_context& context) override
+    {
+        byte_string_value(data, length, context);
+    }
+
+    void do_integer_value(int64_t value, const parsing_context& context) override
+    {
+        integer_value(value, context);
+    }
+
+    void do_uinteger_value(uint64_t value, const parsing_context& context) override
+    {
+        uinteger_value(value, context);
+    }
+
+    void do_double_value(double value, uint8_t precision, const parsing_context& context) override
+    {
+        double_value(value, precision, context);
+    }
+
+    void do_number_value(const string_view_type& text, const parsing_context& context) override
+    {
+        number_value(text, context);
+    }
+
+    void do_escaped_string_value(const string_view_type& text, const parsing_context& context) override
+    {
+        escaped_string_value(text, context);
+    }
+
+    void do_bool_value(bool value, const parsing_context& context) override
+    {
+        bool_value(value, context);
+    }
+
+    void do_null_value(const parsing_context& context) override
+    {
+        null_value(context);
+    }
+};
+
+// stage | stage
+template <class A, class B>
+typename std::enable_if<detail::is_json_pipeline_stage<A>::value && detail::is_json_pipeline_stage<B>::value,
+                        json_pipeline_stages<typename std::decay<A>::type,typename std::decay<B>::type>>::type
+operator|(A&& a, B&& b)
+{
+    return json_pipeline_stages<typename std::decay<A>::type,typename std::decay<B>::type>(
+        std::make_tuple(std::forward<A>(a), std::forward<B>(b)));
+}
+
+// stages | stage
+template <class... Stages, class B>
+typename std::enable_if<detail::is_json_pipeline_stage<B>::value,
+                        json_pipeline_stages<Stages...,typename std::decay<B>::type>>::type
+operator|(json_pipeline_stages<Stages...>&& a, B&& b)
+{
+    return json_pipeline_stages<Stages...,typename std::decay<B>::type>(
+        std::tuple_cat(std::move(a.stages()), std::make_tuple(std::forward<B>(b))));
+}
+
+// stage | handler
+template <class A, class Handler>
+typename std::enable_if<detail::is_json_pipeline_stage<A>::value && !detail::is_json_pipeline_stage<Handler>::value,
+                        basic_json_pipeline<Handler,typename std::decay<A>::type>>::type
+operator|(A&& a, Handler& handler)
+{
+    return basic_json_pipeline<Handler,typename std::decay<A>::type>(handler, std::make_tuple(std::forward<A>(a)));
+}
+
+// stages | handler
+template <class... Stages, class Handler>
+typename std::enable_if<!detail::is_json_pipeline_stage<Handler>::value,
+                        basic_json_pipeline<Handler,Stages...>>::type
+operator|(json_pipeline_stages<Stages...>&& a, Handler& handler)
+{
+    return basic_json_pipeline<Handler,Stages...>(handler, std::move(a.stages()));
+}
+
+typedef basic_json_pipeline_stage<char> json_pipeline_stage;
+typedef basic_json_pipeline_stage<wchar_t> wjson_pipeline_stage;
+typedef basic_fragment_stage<char> fragment_stage;
+typedef basic_fragment_stage<wchar_t> wfragment_stage;
+typedef basic_rename_members_stage<char> rename_members_stage;
+typedef basic_rename_members_stage<wchar_t> wrename_members_stage;
+
+}
+
+#endif
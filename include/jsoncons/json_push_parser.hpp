@@ -0,0 +1,183 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSON_PUSH_PARSER_HPP
+#define JSONCONS_JSON_PUSH_PARSER_HPP
+
+#include <cstddef>
+#include <system_error>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/json_input_handler.hpp>
+#include <jsoncons/parse_error_handler.hpp>
+#include <jsoncons/json_parser.hpp>
+
+namespace jsoncons {
+
+// Parses JSON text that the caller pushes in chunks as they arrive, such as the read buffers
+// of a socket in an event loop. The parser does not own or copy the chunks. Names and string
+// values that lie wholly inside a chunk and have no escapes are passed to the input handler
+// as views into the chunk, others as views into the parser's own buffer, and either is only
+// valid during the call. No pointer into a chunk is kept once update returns, so the caller
+// may reuse its buffer straight away. A text that ends inside a chunk stops the parse there,
+// and update returns how much of the chunk was consumed, so that the rest can be pushed again
+// after reset as the start of the next text.
+
+template<class CharT>
+class basic_json_push_parser
+{
+    basic_json_parser<CharT> parser_;
+    bool begin_;
+
+    // Noncopyable and nonmoveable
+    basic_json_push_parser(const basic_json_push_parser&) = delete;
+    basic_json_push_parser& operator=(const basic_json_push_parser&) = delete;
+
+public:
+    basic_json_push_parser(basic_json_input_handler<CharT>& handler)
+        : parser_(handler),
+          begin_(true)
+    {
+    }
+
+    basic_json_push_parser(basic_json_input_handler<CharT>& handler,
+                           parse_error_handler& err_handler)
+       : parser_(handler,err_handler),
+         begin_(true)
+    {
+    }
+
+    size_t max_nesting_depth() const
+    {
+        return parser_.max_nesting_depth();
+    }
+
+    void max_nesting_depth(size_t depth)
+    {
+        parser_.max_nesting_depth(depth);
+    }
+
+    size_t max_input_length() const
+    {
+        return parser_.max_input_length();
+    }
+
+    void max_input_length(size_t length)
+    {
+        parser_.max_input_length(length);
+    }
+
+    size_t max_string_length() const
+    {
+        return parser_.max_string_length();
+    }
+
+    void max_string_length(size_t length)
+    {
+        parser_.max_string_length(length);
+    }
+
+    size_t max_items() const
+    {
+        return parser_.max_items();
+    }
+
+    void max_items(size_t count)
+    {
+        parser_.max_items(count);
+    }
+
+    // Parses as much of the chunk [data, data+length) as belongs to the current text, and
+    // returns the number of characters consumed. That is all of them unless the text ends
+    // inside the chunk. Once done is true, nothing more is consumed until reset.
+    size_t update(const CharT* data, size_t length)
+    {
+        std::error_code ec;
+        size_t count = update(data, length, ec);
+        if (ec)
+        {
+            throw parse_error(ec,parser_.line_number(),parser_.column_number());
+        }
+        return count;
+    }
+
+    size_t update(const CharT* data, size_t length, std::error_code& ec)
+    {
+        if (parser_.done() || length == 0)
+        {
+            return 0;
+        }
+        const CharT* first = data;
+        const CharT* last = data + length;
+        if (begin_)
+        {
+            auto result = unicons::skip_bom(first, last);
+            if (result.ec != unicons::encoding_errc())
+            {
+                ec = result.ec;
+                return 0;
+            }
+            first = result.it;
+            begin_ = false;
+        }
+        parser_.set_source(first, last - first);
+        parser_.parse(ec);
+        size_t count = length - static_cast<size_t>(last - parser_.position());
+        parser_.set_source(last, 0);
+        return count;
+    }
+
+    // Signals the end of the input. Ends a number at the root, which only the end of input
+    // can delimit, and reports unexpected_eof if the text is incomplete or there was none.
+    void finish()
+    {
+        std::error_code ec;
+        finish(ec);
+        if (ec)
+        {
+            throw parse_error(ec,parser_.line_number(),parser_.column_number());
+        }
+    }
+
+    void finish(std::error_code& ec)
+    {
+        if (!parser_.done())
+        {
+            parser_.end_parse(ec);
+            if (ec) return;
+        }
+        parser_.check_done(ec);
+    }
+
+    // True once a complete text has been parsed
+    bool done() const
+    {
+        return parser_.done();
+    }
+
+    // Readies the parser for the next text, which may begin with the characters of a chunk
+    // after those a previous update consumed
+    void reset()
+    {
+        parser_.reset();
+    }
+
+    size_t line_number() const
+    {
+        return parser_.line_number();
+    }
+
+    size_t column_number() const
+    {
+        return parser_.column_number();
+    }
+};
+
+typedef basic_json_push_parser<char> json_push_parser;
+typedef basic_json_push_parser<wchar_t> wjson_push_parser;
+
+}
+
+#endif
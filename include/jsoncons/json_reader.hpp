@@ -20,6 +20,9 @@
 #include <jsoncons/json_input_handler.hpp>
 #include <jsoncons/parse_error_handler.hpp>
 #include <jsoncons/json_parser.hpp>
+#include <jsoncons/input_source.hpp>
+#include <jsoncons/json_trace.hpp>
+#include <jsoncons/detail/utf_transcode.hpp>
 
 namespace jsoncons {
 
@@ -33,6 +36,7 @@ public:
 private:
     basic_null_json_input_handler<CharT> default_input_handler_;
     basic_json_input_handler<CharT>& other_handler_;
+    std::basic_string<CharT> buffer_;
     //parse_error_handler& err_handler_;
 
     // noncopyable and nonmoveable
@@ -86,28 +90,17 @@ private:
 
     void do_name(const string_view_type& name, const parsing_context& context) override
     {
-        std::basic_string<CharT> target;
-        auto result = unicons::convert(
-            name.begin(), name.end(), std::back_inserter(target), 
-            unicons::conv_flags::strict);
-        if (result.ec != unicons::conv_errc())
-        {
-            throw parse_error(result.ec,context.line_number(),context.column_number());
-        }
-        other_handler_.name(target, context);
+        other_handler_.name(convert(name, context), context);
     }
 
     void do_string_value(const string_view_type& value, const parsing_context& context) override
     {
-        std::basic_string<CharT> target;
-        auto result = unicons::convert(
-            value.begin(), value.end(), std::back_inserter(target), 
-            unicons::conv_flags::strict);
-        if (result.ec != unicons::conv_errc())
-        {
-            throw parse_error(result.ec,context.line_number(),context.column_number());
-        }
-        other_handler_.string_value(target, context);
+        other_handler_.string_value(convert(value, context), context);
+    }
+
+    void do_byte_string_value(const uint8_t* data, size_t length, const parsing_context& context) override
+    {
+        other_handler_.byte_string_value(data, length, context);
     }
 
     void do_integer_value(int64_t value, const parsing_context& context) override
@@ -134,6 +127,18 @@ private:
     {
         other_handler_.null_value(context);
     }
+
+    // Converts s to buffer_, which is reused from one name or string to the next
+    typename basic_json_input_handler<CharT>::string_view_type convert(const string_view_type& s, const parsing_context& context)
+    {
+        buffer_.resize(detail::max_wide_length<CharT>(s.length()));
+        auto result = detail::utf8_to_wide(s.data(), s.data() + s.length(), &buffer_[0]);
+        if (result.ec != unicons::conv_errc())
+        {
+            throw parse_error(result.ec,context.line_number(),context.column_number());
+        }
+        return typename basic_json_input_handler<CharT>::string_view_type(buffer_.data(), result.length);
+    }
 };
 
 template<class CharT>
@@ -142,11 +147,13 @@ class basic_json_reader
     static const size_t default_max_buffer_length = 16384;
 
     basic_json_parser<CharT> parser_;
-    std::basic_istream<CharT>& is_;
+    basic_stream_source<CharT> stream_source_;
+    basic_input_source<CharT>* source_;
     bool eof_;
     std::vector<CharT> buffer_;
     size_t buffer_length_;
     bool begin_;
+    detail::trace_recorder trace_;
 
     // Noncopyable and nonmoveable
     basic_json_reader(const basic_json_reader&) = delete;
@@ -156,10 +163,12 @@ public:
 
     basic_json_reader(std::basic_istream<CharT>& is)
         : parser_(),
-          is_(is),
+          stream_source_(is),
+          source_(std::addressof(stream_source_)),
           eof_(false),
           buffer_length_(default_max_buffer_length),
-          begin_(true)
+          begin_(true),
+          trace_("json_reader")
     {
         buffer_.reserve(buffer_length_);
     }
@@ -167,10 +176,12 @@ public:
     basic_json_reader(std::basic_istream<CharT>& is,
                       parse_error_handler& err_handler)
        : parser_(err_handler),
-         is_(is),
+         stream_source_(is),
+         source_(std::addressof(stream_source_)),
          eof_(false),
          buffer_length_(default_max_buffer_length),
-         begin_(true)
+         begin_(true),
+         trace_("json_reader")
     {
         buffer_.reserve(buffer_length_);
     }
@@ -178,10 +189,12 @@ public:
     basic_json_reader(std::basic_istream<CharT>& is, 
                       basic_json_input_handler<CharT>& handler)
         : parser_(handler),
-          is_(is),
+          stream_source_(is),
+          source_(std::addressof(stream_source_)),
           eof_(false),
           buffer_length_(default_max_buffer_length),
-          begin_(true)
+          begin_(true),
+          trace_("json_reader")
     {
         buffer_.reserve(buffer_length_);
     }
@@ -190,14 +203,84 @@ public:
                       basic_json_input_handler<CharT>& handler,
                       parse_error_handler& err_handler)
        : parser_(handler,err_handler),
-         is_(is),
+         stream_source_(is),
+         source_(std::addressof(stream_source_)),
          eof_(false),
          buffer_length_(default_max_buffer_length),
-         begin_(true)
+         begin_(true),
+         trace_("json_reader")
+    {
+        buffer_.reserve(buffer_length_);
+    }
+
+    // Reads from a source, which fills the reader's buffer directly
+    basic_json_reader(basic_input_source<CharT>& source)
+        : parser_(),
+          source_(std::addressof(source)),
+          eof_(false),
+          buffer_length_(default_max_buffer_length),
+          begin_(true),
+          trace_("json_reader")
     {
         buffer_.reserve(buffer_length_);
     }
 
+    basic_json_reader(basic_input_source<CharT>& source,
+                      parse_error_handler& err_handler)
+       : parser_(err_handler),
+         source_(std::addressof(source)),
+         eof_(false),
+         buffer_length_(default_max_buffer_length),
+         begin_(true),
+         trace_("json_reader")
+    {
+        buffer_.reserve(buffer_length_);
+    }
+
+    basic_json_reader(basic_input_source<CharT>& source, 
+                      basic_json_input_handler<CharT>& handler)
+        : parser_(handler),
+          source_(std::addressof(source)),
+          eof_(false),
+          buffer_length_(default_max_buffer_length),
+          begin_(true),
+          trace_("json_reader")
+    {
+        buffer_.reserve(buffer_length_);
+    }
+
+    basic_json_reader(basic_input_source<CharT>& source,
+                      basic_json_input_handler<CharT>& handler,
+                      parse_error_handler& err_handler)
+       : parser_(handler,err_handler),
+         source_(std::addressof(source)),
+         eof_(false),
+         buffer_length_(default_max_buffer_length),
+         begin_(true),
+         trace_("json_reader")
+    {
+        buffer_.reserve(buffer_length_);
+    }
+
+    // Readies the reader to read from another stream, keeping the parser's and the
+    // reader's buffers. The input handler given at construction is kept.
+    void reset(std::basic_istream<CharT>& is)
+    {
+        stream_source_.reset(is);
+        reset(stream_source_);
+    }
+
+    // Readies the reader to read from another source
+    void reset(basic_input_source<CharT>& source)
+    {
+        source_ = std::addressof(source);
+        eof_ = false;
+        begin_ = true;
+        buffer_.clear();
+        parser_.reset();
+        parser_.set_source(buffer_.data(), 0);
+    }
+
     size_t buffer_length() const
     {
         return buffer_length_;
@@ -219,6 +302,46 @@ public:
         parser_.max_nesting_depth(depth);
     }
 
+    size_t max_input_length() const
+    {
+        return parser_.max_input_length();
+    }
+
+    void max_input_length(size_t length)
+    {
+        parser_.max_input_length(length);
+    }
+
+    size_t max_string_length() const
+    {
+        return parser_.max_string_length();
+    }
+
+    void max_string_length(size_t length)
+    {
+        parser_.max_string_length(length);
+    }
+
+    size_t max_items() const
+    {
+        return parser_.max_items();
+    }
+
+    void max_items(size_t count)
+    {
+        parser_.max_items(count);
+    }
+
+    bool keep_number_text() const
+    {
+        return parser_.keep_number_text();
+    }
+
+    void keep_number_text(bool value)
+    {
+        parser_.keep_number_text(value);
+    }
+
     void read_next()
     {
         std::error_code ec;
@@ -233,8 +356,13 @@ public:
     {
         buffer_.clear();
         buffer_.resize(buffer_length_);
-        is_.read(buffer_.data(), buffer_length_);
-        buffer_.resize(static_cast<size_t>(is_.gcount()));
+        buffer_.resize(trace_.active() ? trace_.read(*source_, buffer_.data(), buffer_length_)
+                                       : source_->read(buffer_.data(), buffer_length_));
+        if (source_->fail())
+        {
+            ec = json_parser_errc::source_error;
+            return;
+        }
         if (buffer_.size() == 0)
         {
             eof_ = true;
@@ -257,16 +385,40 @@ public:
         }
     }
 
+    // The tracer is given a record for each text read by read_next, with the bytes and
+    // reads taken from the source, the time spent reading, and the deepest nesting
+    json_tracer* tracer() const
+    {
+        return trace_.tracer();
+    }
+
+    void tracer(json_tracer* tracer)
+    {
+        trace_.tracer(tracer);
+    }
+
     void read_next(std::error_code& ec)
+    {
+        trace_.begin();
+        parse_next(ec);
+        if (trace_.active())
+        {
+            trace_.record().max_depth = parser_.peak_nesting_depth();
+            trace_.end();
+        }
+    }
+
+private:
+    void parse_next(std::error_code& ec)
     {
         parser_.reset();
         while (!eof_ && !parser_.done())
         {
             if (parser_.source_exhausted())
             {
-                if (!is_.eof())
+                if (!source_->eof())
                 {
-                    if (is_.fail())
+                    if (source_->fail())
                     {
                         ec = json_parser_errc::source_error;
                         return;
@@ -292,6 +444,7 @@ public:
         }
     }
 
+public:
     void check_done()
     {
         std::error_code ec;
@@ -325,9 +478,9 @@ public:
             {
                 if (parser_.source_exhausted())
                 {
-                    if (!is_.eof())
+                    if (!source_->eof())
                     {
-                        if (is_.fail())
+                        if (source_->fail())
                         {
                             ec = json_parser_errc::source_error;
                             return;
@@ -0,0 +1,254 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSON_SERIALIZATION_CACHE_HPP
+#define JSONCONS_JSON_SERIALIZATION_CACHE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <jsoncons/json.hpp>
+#include <jsoncons/output_sink.hpp>
+
+namespace jsoncons {
+
+// The compact text of the arrays and objects in a document, kept from one serialization to
+// the next, so that a document that changes in a few places is written by copying the text
+// of what has not changed. As with json_hash_cache, the text is kept by the address of the
+// value, because a json value does not know when a value inside it is modified through a
+// reference. invalidate must be called with each array or object that is modified.
+
+template <class Json>
+class json_serialization_cache
+{
+public:
+    typedef typename Json::char_type char_type;
+    typedef std::basic_string<char_type> string_type;
+    typedef typename Json::string_view_type string_view_type;
+private:
+    struct entry
+    {
+        string_type text;
+        size_t size;
+        const Json* parent;
+        // The arrays and objects in the value, as they were when the text was made
+        std::vector<const Json*> children;
+    };
+
+    // A serializer writing to a string, for each depth, reused for every array and
+    // object whose text is made at that depth
+    struct level
+    {
+        string_type text;
+        basic_string_sink<string_type> sink;
+        basic_json_serializer<char_type> serializer;
+
+        level(const basic_serialization_options<char_type>& options)
+            : sink(text), serializer(sink, options)
+        {
+        }
+    };
+
+    basic_serialization_options<char_type> options_;
+    std::unordered_map<const Json*,entry> entries_;
+    // The parents of the arrays and objects that were empty, which have no text to keep,
+    // so that invalidating one of them still reaches the values that contain it
+    std::unordered_map<const Json*,const Json*> empty_parents_;
+    std::vector<std::unique_ptr<level>> levels_;
+    size_t depth_;
+    size_t reused_;
+
+    // Noncopyable
+    json_serialization_cache(const json_serialization_cache&) = delete;
+    json_serialization_cache& operator=(const json_serialization_cache&) = delete;
+public:
+    json_serialization_cache()
+        : depth_(0), reused_(0)
+    {
+    }
+
+    explicit json_serialization_cache(const basic_serialization_options<char_type>& options)
+        : options_(options), depth_(0), reused_(0)
+    {
+    }
+
+    // Writes val to serializer, which must not indent and must have the options of the
+    // cache, with the kept text of the arrays and objects in it, and keeps the text of those
+    // that had none
+    void dump(const Json& val, basic_json_serializer<char_type>& serializer)
+    {
+        reused_ = 0;
+        serializer.begin_json();
+        write(val, nullptr, serializer);
+        serializer.end_json();
+    }
+
+    void dump(const Json& val, std::basic_ostream<char_type>& os)
+    {
+        basic_json_serializer<char_type> serializer(os, options_);
+        dump(val, serializer);
+    }
+
+    // Appends the text of val to s
+    void dump(const Json& val, string_type& s)
+    {
+        basic_string_sink<string_type> sink(s);
+        basic_json_serializer<char_type> serializer(sink, options_);
+        dump(val, serializer);
+    }
+
+    // Forgets the text of val, an array or object whose elements or members have been
+    // modified, inserted or erased, of the arrays and objects that were in it, and of those
+    // that contain it
+    void invalidate(const Json& val)
+    {
+        const Json* parent = nullptr;
+        auto it = entries_.find(std::addressof(val));
+        if (it != entries_.end())
+        {
+            parent = it->second.parent;
+            erase(it);
+        }
+        else
+        {
+            auto e = empty_parents_.find(std::addressof(val));
+            if (e == empty_parents_.end())
+            {
+                return;
+            }
+            parent = e->second;
+            empty_parents_.erase(e);
+        }
+        while (parent != nullptr)
+        {
+            auto p = entries_.find(parent);
+            if (p == entries_.end())
+            {
+                break;
+            }
+            parent = p->second.parent;
+            entries_.erase(p);
+        }
+    }
+
+    void clear()
+    {
+        entries_.clear();
+        empty_parents_.clear();
+    }
+
+    // The number of arrays and objects whose text is kept
+    size_t size() const
+    {
+        return entries_.size();
+    }
+
+    // The number of arrays and objects written from kept text by the last dump, not counting
+    // those inside them
+    size_t reused() const
+    {
+        return reused_;
+    }
+private:
+    void write(const Json& val, const Json* parent, basic_json_serializer<char_type>& serializer)
+    {
+        if ((val.is_array() || val.is_object()) && val.size() > 0)
+        {
+            const string_type& s = text(val, parent);
+            serializer.serialized_value(string_view_type(s.data(), s.length()));
+        }
+        else
+        {
+            if (val.is_array() || val.is_object())
+            {
+                empty_parents_[std::addressof(val)] = parent;
+            }
+            val.dump_fragment(serializer);
+        }
+    }
+
+    // The text of a non-empty array or object, kept or made now
+    const string_type& text(const Json& val, const Json* parent)
+    {
+        auto it = entries_.find(std::addressof(val));
+        if (it != entries_.end() && it->second.size == val.size())
+        {
+            ++reused_;
+            it->second.parent = parent;
+            return it->second.text;
+        }
+        if (it != entries_.end())
+        {
+            erase(it);
+        }
+
+        if (depth_ == levels_.size())
+        {
+            levels_.emplace_back(new level(options_));
+        }
+        level& lev = *levels_[depth_];
+        ++depth_;
+        entry e;
+        e.size = val.size();
+        e.parent = parent;
+        lev.text.clear();
+        lev.serializer.begin_json();
+        if (val.is_array())
+        {
+            lev.serializer.begin_array();
+            for (const auto& item : val.array_range())
+            {
+                add_child(item, e);
+                write(item, std::addressof(val), lev.serializer);
+            }
+            lev.serializer.end_array();
+        }
+        else
+        {
+            lev.serializer.begin_object();
+            for (const auto& member : val.object_range())
+            {
+                lev.serializer.name(member.key());
+                add_child(member.value(), e);
+                write(member.value(), std::addressof(val), lev.serializer);
+            }
+            lev.serializer.end_object();
+        }
+        lev.serializer.end_json();
+        --depth_;
+        e.text = lev.text;
+        return entries_.emplace(std::addressof(val), std::move(e)).first->second.text;
+    }
+
+    static void add_child(const Json& child, entry& e)
+    {
+        if ((child.is_array() || child.is_object()) && child.size() > 0)
+        {
+            e.children.push_back(std::addressof(child));
+        }
+    }
+
+    void erase(typename std::unordered_map<const Json*,entry>::iterator it)
+    {
+        std::vector<const Json*> children = std::move(it->second.children);
+        entries_.erase(it);
+        for (const Json* child : children)
+        {
+            auto c = entries_.find(child);
+            if (c != entries_.end())
+            {
+                erase(c);
+            }
+        }
+    }
+};
+
+}
+
+#endif
@@ -19,6 +19,7 @@
 #include <jsoncons/jsoncons_utilities.hpp>
 #include <jsoncons/serialization_options.hpp>
 #include <jsoncons/json_output_handler.hpp>
+#include <jsoncons/json_trace.hpp>
 
 namespace jsoncons {
 
@@ -30,6 +31,9 @@ public:
 
 private:
     static const size_t default_buffer_length = 16384;
+    static const size_t batch_length = 1024;
+    // A comma, a sign and 20 digits
+    static const size_t max_integer_length = 22;
 
     struct stack_item
     {
@@ -81,9 +85,12 @@ private:
     basic_serialization_options<CharT> options_;
     std::vector<stack_item> stack_;
     int indent_;
+    // A newline followed by as many spaces as the deepest indent so far
+    std::basic_string<CharT> newline_and_indent_;
     bool indenting_;
     print_double<CharT> fp_;
     buffered_output<CharT> bos_;
+    detail::trace_recorder trace_;
 
     // Noncopyable and nonmoveable
     basic_json_serializer(const basic_json_serializer&) = delete;
@@ -93,7 +100,8 @@ public:
        : indent_(0), 
          indenting_(false),
          fp_(options_.precision()),
-         bos_(os)
+         bos_(os),
+         trace_("json_serializer")
     {
     }
 
@@ -101,7 +109,8 @@ public:
        : indent_(0), 
          indenting_(pprint),
          fp_(options_.precision()),
-         bos_(os)
+         bos_(os),
+         trace_("json_serializer")
     {
     }
 
@@ -110,7 +119,8 @@ public:
          indent_(0), 
          indenting_(false),  
          fp_(options_.precision()),
-         bos_(os)
+         bos_(os),
+         trace_("json_serializer")
     {
     }
     basic_json_serializer(std::basic_ostream<CharT>& os, const basic_serialization_options<CharT>& options, bool pprint)
@@ -118,7 +128,46 @@ public:
          indent_(0), 
          indenting_(pprint),  
          fp_(options_.precision()),
-         bos_(os)
+         bos_(os),
+         trace_("json_serializer")
+    {
+    }
+
+    basic_json_serializer(basic_output_sink<CharT>& sink)
+       : indent_(0), 
+         indenting_(false),
+         fp_(options_.precision()),
+         bos_(sink),
+         trace_("json_serializer")
+    {
+    }
+
+    basic_json_serializer(basic_output_sink<CharT>& sink, bool pprint)
+       : indent_(0), 
+         indenting_(pprint),
+         fp_(options_.precision()),
+         bos_(sink),
+         trace_("json_serializer")
+    {
+    }
+
+    basic_json_serializer(basic_output_sink<CharT>& sink, const basic_serialization_options<CharT>& options)
+       : options_(options), 
+         indent_(0), 
+         indenting_(false),  
+         fp_(options_.precision()),
+         bos_(sink),
+         trace_("json_serializer")
+    {
+    }
+
+    basic_json_serializer(basic_output_sink<CharT>& sink, const basic_serialization_options<CharT>& options, bool pprint)
+       : options_(options), 
+         indent_(0), 
+         indenting_(pprint),  
+         fp_(options_.precision()),
+         bos_(sink),
+         trace_("json_serializer")
     {
     }
 
@@ -126,15 +175,43 @@ public:
     {
     }
 
+    // The tracer is given a record for each JSON text, with the characters written, the
+    // writes to the stream or sink, the names and values, the deepest nesting, and the
+    // time from begin_json to end_json
+    json_tracer* tracer() const
+    {
+        return trace_.tracer();
+    }
+
+    void tracer(json_tracer* tracer)
+    {
+        trace_.tracer(tracer);
+    }
+
+    // Writes text, the serialization of one whole value without indenting, where the next
+    // value goes, as json_serialization_cache does with the text it keeps for arrays and
+    // objects that have not changed
+    void serialized_value(const string_view_type& text)
+    {
+        if (!stack_.empty() && !stack_.back().is_object())
+        {
+            begin_scalar_value();
+        }
+        bos_.write(text.data(), text.length());
+        end_value();
+    }
+
 private:
     // Implementing methods
     void do_begin_json() override
     {
+        trace_.begin(bos_);
     }
 
     void do_end_json() override
     {
         bos_.flush();
+        trace_.end(bos_);
     }
 
     void do_begin_object() override
@@ -179,6 +256,7 @@ private:
         {
             stack_.push_back(stack_item(true));
         }
+        trace_.begin_container();
         bos_.put('{');
     }
 
@@ -194,6 +272,7 @@ private:
             }
         }
         stack_.pop_back();
+        trace_.end_container();
         bos_.put('}');
 
         end_value();
@@ -249,6 +328,7 @@ private:
             stack_.push_back(stack_item(false));
             bos_.put('[');
         }
+        trace_.begin_container();
     }
 
     void do_end_array() override
@@ -263,6 +343,7 @@ private:
             }
         }
         stack_.pop_back();
+        trace_.end_container();
         bos_.put(']');
         end_value();
     }
@@ -292,6 +373,7 @@ private:
         {
             bos_.put(' ');
         }
+        trace_.token();
     }
 
     void do_null_value() override
@@ -321,37 +403,59 @@ private:
         end_value();
     }
 
-    void do_byte_string_value(const uint8_t* data, size_t length) override
+    // The text is written as it is unless the options ask for escapes it may not have
+    void do_escaped_string_value(const string_view_type& text) override
     {
-        std::basic_string<CharT> s;
-        encode_base64url(data,data+length,s);
-        do_string_value(s);
+        if (options_.escape_all_non_ascii() || options_.escape_solidus())
+        {
+            std::basic_string<CharT> s;
+            s.reserve(text.length());
+            detail::unescape_string(text.data(), text.length(), s);
+            do_string_value(string_view_type(s.data(), s.length()));
+            return;
+        }
+        if (!stack_.empty() && !stack_.back().is_object())
+        {
+            begin_scalar_value();
+        }
+
+        bos_. put('\"');
+        bos_.write(text.data(), text.length());
+        bos_. put('\"');
+
+        end_value();
     }
 
-    void do_double_value(double value, uint8_t precision) override
+    void do_byte_string_value(const uint8_t* data, size_t length) override
     {
         if (!stack_.empty() && !stack_.back().is_object())
         {
             begin_scalar_value();
         }
 
-        if ((std::isnan)(value))
-        {
-            bos_.write(options_.nan_replacement());
-        }
-        else if (value == std::numeric_limits<double>::infinity())
-        {
-            bos_.write(options_.pos_inf_replacement());
-        }
-        else if (!(std::isfinite)(value))
+        // Encoded a chunk at a time, a multiple of 3 bytes, base64url characters need no escaping
+        const size_t chunk_length = 768;
+        CharT buf[4*chunk_length/3];
+        bos_. put('\"');
+        for (size_t i = 0; i < length; i += chunk_length)
         {
-            bos_.write(options_.neg_inf_replacement());
+            const size_t n = (std::min)(chunk_length, length - i);
+            bos_.write(buf, encode_base64url(data + i, n, buf));
         }
-        else
+        bos_. put('\"');
+
+        end_value();
+    }
+
+    void do_double_value(double value, uint8_t precision) override
+    {
+        if (!stack_.empty() && !stack_.back().is_object())
         {
-            fp_(value,precision,bos_);
+            begin_scalar_value();
         }
 
+        write_double(value, precision);
+
         end_value();
     }
 
@@ -375,6 +479,122 @@ private:
         end_value();
     }
 
+    void do_number_value(const string_view_type& text) override
+    {
+        if (!stack_.empty() && !stack_.back().is_object())
+        {
+            begin_scalar_value();
+        }
+        bos_.write(text.data(), text.length());
+        end_value();
+    }
+
+    // The first value writes the separator and indent that follow begin_array. The
+    // others, when they go on the same line, are written with only a comma before
+    // each, integers formatted straight into space reserved a batch at a time.
+
+    void do_integer_values(const int64_t* data, size_t length) override
+    {
+        if (length == 0)
+        {
+            return;
+        }
+        do_integer_value(data[0]);
+        if (!is_same_line_array())
+        {
+            for (size_t i = 1; i < length; ++i)
+            {
+                do_integer_value(data[i]);
+            }
+            return;
+        }
+
+        CharT* p = bos_.reserve(batch_length);
+        CharT* limit = p + (batch_length - max_integer_length);
+        for (size_t i = 1; i < length; ++i)
+        {
+            if (p > limit)
+            {
+                bos_.commit(p);
+                p = bos_.reserve(batch_length);
+                limit = p + (batch_length - max_integer_length);
+            }
+            *p++ = ',';
+            const int64_t value = data[i];
+            uint64_t u = static_cast<uint64_t>(value);
+            if (value < 0)
+            {
+                *p++ = '-';
+                u = 0 - u;
+            }
+            p += count_digits(u);
+            format_uinteger(u, p);
+        }
+        bos_.commit(p);
+        stack_.back().count_ += length - 1;
+        trace_.token(length - 1);
+    }
+
+    void do_uinteger_values(const uint64_t* data, size_t length) override
+    {
+        if (length == 0)
+        {
+            return;
+        }
+        do_uinteger_value(data[0]);
+        if (!is_same_line_array())
+        {
+            for (size_t i = 1; i < length; ++i)
+            {
+                do_uinteger_value(data[i]);
+            }
+            return;
+        }
+
+        CharT* p = bos_.reserve(batch_length);
+        CharT* limit = p + (batch_length - max_integer_length);
+        for (size_t i = 1; i < length; ++i)
+        {
+            if (p > limit)
+            {
+                bos_.commit(p);
+                p = bos_.reserve(batch_length);
+                limit = p + (batch_length - max_integer_length);
+            }
+            *p++ = ',';
+            p += count_digits(data[i]);
+            format_uinteger(data[i], p);
+        }
+        bos_.commit(p);
+        stack_.back().count_ += length - 1;
+        trace_.token(length - 1);
+    }
+
+    void do_double_values(const double* data, size_t length, uint8_t precision) override
+    {
+        if (length == 0)
+        {
+            return;
+        }
+        do_double_value(data[0], precision);
+        if (!is_same_line_array())
+        {
+            for (size_t i = 1; i < length; ++i)
+            {
+                do_double_value(data[i], precision);
+            }
+            return;
+        }
+
+        for (size_t i = 1; i < length; ++i)
+        {
+            bos_.put(',');
+            write_double(data[i], precision);
+        }
+        stack_.back().count_ += length - 1;
+        trace_.token(length - 1);
+    }
+
     void do_bool_value(bool value) override
     {
         if (!stack_.empty() && !stack_.back().is_object())
@@ -396,6 +616,42 @@ private:
         end_value();
     }
 
+    // The events of a tape are written without a virtual call each
+    void do_events(const basic_json_event_tape<CharT>& tape) override
+    {
+        detail::direct_output_events<basic_json_serializer<CharT>> handler(*this);
+        tape.replay(handler);
+    }
+
+    friend class detail::direct_output_events<basic_json_serializer<CharT>>;
+
+    void write_double(double value, uint8_t precision)
+    {
+        if ((std::isnan)(value))
+        {
+            bos_.write(options_.nan_replacement());
+        }
+        else if (value == std::numeric_limits<double>::infinity())
+        {
+            bos_.write(options_.pos_inf_replacement());
+        }
+        else if (!(std::isfinite)(value))
+        {
+            bos_.write(options_.neg_inf_replacement());
+        }
+        else
+        {
+            fp_(value,precision,bos_);
+        }
+    }
+
+    // True inside an array whose values after the first need only a comma before them
+    bool is_same_line_array() const
+    {
+        return !stack_.empty() && !stack_.back().is_object() && 
+               !(indenting_ && stack_.back().is_multi_line());
+    }
+
     void begin_scalar_value()
     {
         if (!stack_.empty())
@@ -438,11 +694,20 @@ private:
         {
             ++stack_.back().count_;
         }
+        trace_.token();
     }
 
     void indent()
     {
         indent_ += static_cast<int>(options_.indent());
+        if (newline_and_indent_.size() <= static_cast<size_t>(indent_))
+        {
+            if (newline_and_indent_.empty())
+            {
+                newline_and_indent_.push_back('\n');
+            }
+            newline_and_indent_.resize(static_cast<size_t>(indent_) + 1, ' ');
+        }
     }
 
     void unindent()
@@ -456,20 +721,12 @@ private:
         {
             stack_.back().unindent_at_end_ = true;
         }
-        bos_. put('\n');
-        for (int i = 0; i < indent_; ++i)
-        {
-            bos_. put(' ');
-        }
+        write_indent1();
     }
 
     void write_indent1()
     {
-        bos_. put('\n');
-        for (int i = 0; i < indent_; ++i)
-        {
-            bos_. put(' ');
-        }
+        bos_.write(newline_and_indent_.data(), static_cast<size_t>(indent_) + 1);
     }
 };
 
@@ -15,10 +15,15 @@
 #include <cstring>
 #include <iostream>
 #include <algorithm>
+#include <iterator>
 #include <sstream>
 #include <iomanip>
 #include <utility>
 #include <initializer_list>
+#include <limits>
+#include <memory>
+#include <functional>
+#include <type_traits>
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/jsoncons_utilities.hpp>
 
@@ -27,33 +32,7 @@ namespace jsoncons {
 // json_array
 
 template <class Json>
-class Json_array_base_
-{
-public:
-    typedef typename Json::allocator_type allocator_type;
-
-public:
-    Json_array_base_()
-        : self_allocator_()
-    {
-    }
-    Json_array_base_(const allocator_type& allocator)
-        : self_allocator_(allocator)
-    {
-    }
-
-    allocator_type get_allocator() const
-    {
-        return self_allocator_;
-    }
-
-    allocator_type self_allocator_;
-};
-
-// json_array
-
-template <class Json>
-class json_array: public Json_array_base_<Json>
+class json_array
 {
 public:
     typedef typename Json::allocator_type allocator_type;
@@ -68,73 +47,60 @@ public:
     typedef typename std::iterator_traits<iterator>::reference reference;
     typedef typename std::iterator_traits<const_iterator>::reference const_reference;
 
-    using Json_array_base_<Json>::get_allocator;
-
     json_array()
-        : Json_array_base_<Json>(), 
-          elements_()
+        : elements_()
     {
     }
 
     explicit json_array(const allocator_type& allocator)
-        : Json_array_base_<Json>(allocator), 
-          elements_(val_allocator_type(allocator))
+        : elements_(val_allocator_type(allocator))
     {
     }
 
     explicit json_array(size_t n, 
                         const allocator_type& allocator = allocator_type())
-        : Json_array_base_<Json>(allocator), 
-          elements_(n,Json(),val_allocator_type(allocator))
+        : elements_(n,Json(),val_allocator_type(allocator))
     {
     }
 
     explicit json_array(size_t n, 
                         const Json& value, 
                         const allocator_type& allocator = allocator_type())
-        : Json_array_base_<Json>(allocator), 
-          elements_(n,value,val_allocator_type(allocator))
+        : elements_(n,value,val_allocator_type(allocator))
     {
     }
 
     template <class InputIterator>
     json_array(InputIterator begin, InputIterator end, const allocator_type& allocator = allocator_type())
-        : Json_array_base_<Json>(allocator), 
-          elements_(begin,end,val_allocator_type(allocator))
+        : elements_(begin,end,val_allocator_type(allocator))
     {
     }
     json_array(const json_array& val)
-        : Json_array_base_<Json>(val.get_allocator()),
-          elements_(val.elements_)
+        : elements_(val.elements_)
     {
     }
     json_array(const json_array& val, const allocator_type& allocator)
-        : Json_array_base_<Json>(allocator), 
-          elements_(val.elements_,val_allocator_type(allocator))
+        : elements_(val.elements_,val_allocator_type(allocator))
     {
     }
 
     json_array(json_array&& val) JSONCONS_NOEXCEPT
-        : Json_array_base_<Json>(val.get_allocator()), 
-          elements_(std::move(val.elements_))
+        : elements_(std::move(val.elements_))
     {
     }
     json_array(json_array&& val, const allocator_type& allocator)
-        : Json_array_base_<Json>(allocator), 
-          elements_(std::move(val.elements_),val_allocator_type(allocator))
+        : elements_(std::move(val.elements_),val_allocator_type(allocator))
     {
     }
 
     json_array(std::initializer_list<Json> init)
-        : Json_array_base_<Json>(), 
-          elements_(std::move(init))
+        : elements_(std::move(init))
     {
     }
 
     json_array(std::initializer_list<Json> init, 
                const allocator_type& allocator)
-        : Json_array_base_<Json>(allocator), 
-          elements_(std::move(init),val_allocator_type(allocator))
+        : elements_(std::move(init),val_allocator_type(allocator))
     {
     }
     ~json_array()
@@ -146,6 +112,11 @@ public:
         elements_.swap(val.elements_);
     }
 
+    allocator_type get_allocator() const
+    {
+        return allocator_type(elements_.get_allocator());
+    }
+
     size_t size() const {return elements_.size();}
 
     size_t capacity() const {return elements_.capacity();}
@@ -275,6 +246,10 @@ public:
 
     bool operator==(const json_array<Json>& rhs) const
     {
+        if (this == &rhs)
+        {
+            return true;
+        }
         if (size() != rhs.size())
         {
             return false;
@@ -296,75 +271,100 @@ private:
 
 // json_object
 
+// Removes all but the last of the elements that compare equal, keeping the order of the rest,
+// and returns the new end. Elements are only moved, never copied.
+
 template <class BidirectionalIt,class BinaryPredicate>
 BidirectionalIt last_wins_unique_sequence(BidirectionalIt first, BidirectionalIt last, BinaryPredicate compare)
 {
-    
     if (first == last)
     {
         return last;
     }
 
-    typedef typename BidirectionalIt::value_type value_type;
-    typedef typename BidirectionalIt::pointer pointer;
-    std::vector<value_type> dups;
+    typedef typename std::iterator_traits<BidirectionalIt>::pointer pointer;
+    typedef std::pair<pointer,size_t> position_type;
+
+    // Sorting the positions stably puts equal elements together in sequence order 
+    std::vector<position_type> v;
+    size_t n = 0;
+    for (auto it = first; it != last; ++it, ++n)
     {
-        std::vector<pointer> v(std::distance(first,last));
-        auto p = v.begin();
-        for (auto it = first; it != last; ++it)
-        {
-            *p++ = &(*it);
-        }
-        std::sort(v.begin(), v.end(), [&](pointer a, pointer b){return compare(*a,*b)<0;});
-        auto it = v.begin();
-        auto end = v.end();
-        for (auto begin = it+1; begin != end; ++it, ++begin)
+        v.emplace_back(&(*it), n);
+    }
+    std::stable_sort(v.begin(), v.end(), [&](const position_type& a, const position_type& b){return compare(*a.first,*b.first) < 0;});
+
+    std::vector<bool> removed;
+    for (size_t i = 0; i + 1 < v.size(); ++i)
+    {
+        if (compare(*v[i].first,*v[i+1].first) == 0)
         {
-            if (compare(*(*it),*(*begin)) == 0)
+            if (removed.empty())
             {
-                dups.push_back(*(*it));
+                removed.resize(n, false);
             }
+            removed[v[i].second] = true;
         }
     }
-    if (dups.size() == 0)
+    if (removed.empty())
     {
         return last;
     }
-    
-    auto it = last;
-    for (auto p = first; p != last && p != it; )
+
+    auto out = first;
+    size_t i = 0;
+    for (auto it = first; it != last; ++it, ++i)
     {
-        bool no_dup = true;
-        if (dups.size() > 0)
-        {
-            for (auto q = dups.begin(); no_dup && q != dups.end();)
-            {
-                if (compare(*p,*q) == 0)
-                {
-                    dups.erase(q);
-                    no_dup = false;
-                }
-                else
-                {
-                    ++q;
-                }
-            }
-        }
-        if (!no_dup)
+        if (!removed[i])
         {
-            --it;
-            for (auto r = p; r != it; ++r)
+            if (out != it)
             {
-                *r = std::move(*(r+1));
+                *out = std::move(*it);
             }
+            ++out;
         }
-        else
-        {
-            ++p;
-        }
     }
-    
-    return it;
+    return out;
+}
+
+namespace detail {
+
+template <class T, class Enable=void>
+struct has_capacity : std::false_type {};
+
+template <class T>
+struct has_capacity<T, 
+                    typename std::enable_if<!std::is_void<decltype(std::declval<const T&>().capacity())>::value>::type> 
+    : std::true_type {};
+
+template <class StringT>
+typename std::enable_if<has_capacity<StringT>::value,size_t>::type
+string_capacity(const StringT& s)
+{
+    return s.capacity();
+}
+
+template <class StringT>
+typename std::enable_if<!has_capacity<StringT>::value,size_t>::type
+string_capacity(const StringT& s)
+{
+    return s.length();
+}
+
+// The bytes a string holds outside itself, zero if its characters are held in place
+template <class StringT>
+size_t string_heap_size(const StringT& s)
+{
+    const char* p = reinterpret_cast<const char*>(s.data());
+    const char* first = reinterpret_cast<const char*>(&s);
+    std::less<const char*> less;
+    if (s.empty() || (!less(p, first) && less(p, first + sizeof(StringT))))
+    {
+        return 0;
+    }
+    return (string_capacity(s) + 1)*sizeof(typename StringT::value_type);
+}
+
 }
 
 template <class KeyT, class ValueT>
@@ -401,6 +401,12 @@ public:
     {
     }
 
+    // A member with the key of member and the value val
+    key_value_pair(const key_value_pair& member, ValueT&& val)
+        : key_(member.key_), value_(std::forward<ValueT>(val))
+    {
+    }
+
     template <class T>
     key_value_pair(key_storage_type&& name, 
                    T&& val, 
@@ -414,6 +420,13 @@ public:
         return string_view_type(key_.data(),key_.size());
     }
 
+    // Keys that share their characters, as interned keys do, are equal without a comparison
+    bool key_equals(const key_value_pair& member) const
+    {
+        return (key_.data() == member.key_.data() && key_.size() == member.key_.size()) ||
+               key() == member.key();
+    }
+
     ValueT& value()
     {
         return value_;
@@ -461,6 +474,12 @@ public:
         key_.shrink_to_fit();
         value_.shrink_to_fit();
     }
+
+    // Bytes of the key held outside the pair
+    size_t key_heap_size() const
+    {
+        return detail::string_heap_size(key_);
+    }
 #if !defined(JSONCONS_NO_DEPRECATED)
     const key_storage_type& name() const
     {
@@ -490,38 +509,34 @@ public:
     typedef typename object_storage_type::const_iterator const_iterator;
 
 protected:
-    allocator_type self_allocator_;
     object_storage_type members_;
 public:
     Json_object_()
-        : self_allocator_(), members_()
+        : members_()
     {
     }
     Json_object_(const allocator_type& allocator)
-        : self_allocator_(allocator), 
-          members_(kvp_allocator_type(allocator))
+        : members_(kvp_allocator_type(allocator))
     {
     }
 
     Json_object_(const Json_object_& val)
-        : self_allocator_(val.get_allocator()), members_(val.members_)
+        : members_(val.members_)
     {
     }
 
     Json_object_(Json_object_&& val)
-        : self_allocator_(val.get_allocator()), 
-          members_(std::move(val.members_))
+        : members_(std::move(val.members_))
     {
     }
 
-    Json_object_(const Json_object_& val, const allocator_type& allocator) :
-        self_allocator_(allocator), 
-        members_(val.members_,kvp_allocator_type(allocator))
+    Json_object_(const Json_object_& val, const allocator_type& allocator)
+        : members_(val.members_,kvp_allocator_type(allocator))
     {
     }
 
-    Json_object_(Json_object_&& val,const allocator_type& allocator) :
-        self_allocator_(allocator), members_(std::move(val.members_),kvp_allocator_type(allocator))
+    Json_object_(Json_object_&& val,const allocator_type& allocator)
+        : members_(std::move(val.members_),kvp_allocator_type(allocator))
     {
     }
 
@@ -532,7 +547,172 @@ public:
 
     allocator_type get_allocator() const
     {
-        return this->self_allocator_;
+        return allocator_type(members_.get_allocator());
+    }
+protected:
+    // Appends a copy of member, or member moved, with this object's allocator
+    template <class A=allocator_type>
+    typename std::enable_if<is_stateless<A>::value>::type
+    append_member(const value_type& member)
+    {
+        members_.emplace_back(member);
+    }
+
+    template <class A=allocator_type>
+    typename std::enable_if<is_stateless<A>::value>::type
+    append_member(value_type&& member)
+    {
+        members_.emplace_back(std::move(member));
+    }
+
+    template <class A=allocator_type>
+    typename std::enable_if<!is_stateless<A>::value>::type
+    append_member(const value_type& member)
+    {
+        string_view_type key = member.key();
+        members_.emplace_back(key_storage_type(key.begin(),key.end(),get_allocator()), 
+                              member.value(),get_allocator());
+    }
+
+    template <class A=allocator_type>
+    typename std::enable_if<!is_stateless<A>::value>::type
+    append_member(value_type&& member)
+    {
+        string_view_type key = member.key();
+        members_.emplace_back(key_storage_type(key.begin(),key.end(),get_allocator()), 
+                              std::move(member.value()),get_allocator());
+    }
+
+    // Replaces the value of member with the value of source, copied or moved
+
+    template <class A=allocator_type>
+    typename std::enable_if<is_stateless<A>::value>::type
+    assign_member(value_type& member, const value_type& source)
+    {
+        member.value(source.value());
+    }
+
+    template <class A=allocator_type>
+    typename std::enable_if<is_stateless<A>::value>::type
+    assign_member(value_type& member, value_type&& source)
+    {
+        member.value(std::move(source.value()));
+    }
+
+    template <class A=allocator_type>
+    typename std::enable_if<!is_stateless<A>::value>::type
+    assign_member(value_type& member, const value_type& source)
+    {
+        member.value(Json(source.value(),get_allocator()));
+    }
+
+    template <class A=allocator_type>
+    typename std::enable_if<!is_stateless<A>::value>::type
+    assign_member(value_type& member, value_type&& source)
+    {
+        member.value(Json(std::move(source.value()),get_allocator()));
+    }
+};
+
+// object_hash_index
+
+// An open addressing (linear probing) hash table of positions into the members of
+// a preserve order json_object. Slots hold position + 1, zero marks an empty slot.
+
+template <class Allocator>
+class object_hash_index
+{
+public:
+    typedef typename std::allocator_traits<Allocator>:: template rebind_alloc<uint32_t> slot_allocator_type;
+    static const size_t npos = (size_t)-1;
+private:
+    std::vector<uint32_t,slot_allocator_type> slots_;
+    size_t count_;
+public:
+    object_hash_index(const Allocator& allocator)
+        : slots_(slot_allocator_type(allocator)), count_(0)
+    {
+    }
+
+    // Bytes of the index and its slots
+    size_t allocated_size() const
+    {
+        return sizeof(object_hash_index) + slots_.capacity()*sizeof(uint32_t);
+    }
+
+    template <class StringViewT>
+    static size_t hash(const StringViewT& s)
+    {
+        // FNV-1a
+        uint32_t h = 2166136261u;
+        for (auto c : s)
+        {
+            h ^= static_cast<uint32_t>(c);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    // Largest number of members that can be indexed
+    static size_t max_positions()
+    {
+        return (std::numeric_limits<uint32_t>::max)() - 1;
+    }
+
+    template <class Storage>
+    void rebuild(const Storage& members)
+    {
+        size_t capacity = 64;
+        while (capacity < 2*members.size())
+        {
+            capacity *= 2;
+        }
+        slots_.assign(capacity, 0);
+        count_ = 0;
+        for (size_t i = 0; i < members.size(); ++i)
+        {
+            insert(members[i].key(), i);
+        }
+    }
+
+    // Returns false if the table is too full to take another entry
+    template <class StringViewT>
+    bool try_insert(const StringViewT& key, size_t pos)
+    {
+        if (2*(count_ + 1) > slots_.size())
+        {
+            return false;
+        }
+        insert(key, pos);
+        return true;
+    }
+
+    template <class Storage, class StringViewT>
+    size_t find(const Storage& members, const StringViewT& key) const
+    {
+        const size_t mask = slots_.size() - 1;
+        for (size_t i = hash(key) & mask; slots_[i] != 0; i = (i + 1) & mask)
+        {
+            size_t pos = slots_[i] - 1;
+            if (members[pos].key() == key)
+            {
+                return pos;
+            }
+        }
+        return npos;
+    }
+private:
+    template <class StringViewT>
+    void insert(const StringViewT& key, size_t pos)
+    {
+        const size_t mask = slots_.size() - 1;
+        size_t i = hash(key) & mask;
+        while (slots_[i] != 0)
+        {
+            i = (i + 1) & mask;
+        }
+        slots_[i] = static_cast<uint32_t>(pos + 1);
+        ++count_;
     }
 };
 
@@ -653,6 +833,9 @@ public:
 
     size_t capacity() const {return this->members_.capacity();}
 
+    // Bytes of the hash index, objects that keep their members sorted have none
+    size_t index_size() const {return 0;}
+
     void clear() {this->members_.clear();}
 
     void shrink_to_fit() 
@@ -686,19 +869,12 @@ public:
 
     iterator find(const string_view_type& name)
     {
-        auto it = std::lower_bound(this->members_.begin(),this->members_.end(), name, 
-                                   [](const value_type& a, const string_view_type& k){return a.key().compare(k) < 0;});        
-        auto result = (it != this->members_.end() && it->key() == name) ? it : this->members_.end();
-        return result;
+        return find_member(this->members_.begin(),this->members_.end(), name);
     }
 
     const_iterator find(const string_view_type& name) const
     {
-        auto it = std::lower_bound(this->members_.begin(),this->members_.end(), 
-                                   name, 
-                                   [](const value_type& a, const string_view_type& k){return a.key().compare(k) < 0;});
-        auto result = (it != this->members_.end() && it->key() == name) ? it : this->members_.end();
-        return result;
+        return find_member(this->members_.begin(),this->members_.end(), name);
     }
 
     void erase(const_iterator pos) 
@@ -730,6 +906,13 @@ public:
         {
             this->members_.emplace_back(pred(*s));
         }
+        // Members that arrive in order, for example from an encoding of a sorted object, 
+        // need neither sorting nor removal of duplicates
+        if (std::adjacent_find(this->members_.begin(),this->members_.end(),
+                               [](const value_type& a, const value_type& b){return a.key().compare(b.key()) >= 0;}) == this->members_.end())
+        {
+            return;
+        }
         std::stable_sort(this->members_.begin(),this->members_.end(),
                          [](const value_type& a, const value_type& b){return a.key().compare(b.key()) < 0;});
         auto it = std::unique(this->members_.rbegin(), this->members_.rend(),
@@ -737,137 +920,80 @@ public:
         this->members_.erase(this->members_.begin(),it.base());
     }
 
+    // Appends members whose keys are known to be distinct, in ascending order, and greater
+    // than those of the members already here, without sorting or looking for duplicates
+    template <class InputIt, class UnaryPredicate>
+    void insert_unique(InputIt first, InputIt last, UnaryPredicate pred)
+    {
+        this->members_.reserve(this->members_.size() + std::distance(first,last));
+        for (auto s = first; s != last; ++s)
+        {
+            this->members_.emplace_back(pred(*s));
+        }
+    }
+
     // merge
 
+    // The members of both objects are sorted by key, so they are merged in one pass over
+    // both, rather than by a search and an insert for each member of source
+
     void merge(const json_object& source)
     {
-        for (auto it = source.begin(); it != source.end(); ++it)
+        if (&source == this)
         {
-            try_emplace(it->key(),it->value());
+            return;
         }
+        merge_members(source.begin(), source.end(), false);
     }
 
     void merge(json_object&& source)
     {
-        auto it = std::make_move_iterator(source.begin());
-        auto end = std::make_move_iterator(source.end());
-        for (; it != end; ++it)
+        if (&source == this)
         {
-            auto pos = std::lower_bound(this->members_.begin(),this->members_.end(), it->key(), 
-                                        [](const value_type& a, const string_view_type& k){return a.key().compare(k) < 0;});   
-            if (pos == this->members_.end() )
-            {
-                this->members_.emplace_back(*it);
-            }
-            else if (it->key() != pos->key())
-            {
-                this->members_.emplace(pos,*it);
-            }
+            return;
         }
+        merge_members(std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()), false);
     }
 
-    void merge(iterator hint, const json_object& source)
+    // The members of an object are kept sorted, so the hint is not needed
+    void merge(iterator, const json_object& source)
     {
-        for (auto it = source.begin(); it != source.end(); ++it)
-        {
-            hint = try_emplace(hint, it->key(),it->value());
-        }
+        merge(source);
     }
 
-    void merge(iterator hint, json_object&& source)
+    void merge(iterator, json_object&& source)
     {
-        auto it = std::make_move_iterator(source.begin());
-        auto end = std::make_move_iterator(source.end());
-        for (; it != end; ++it)
-        {
-            iterator pos;
-            if (hint != this->members_.end() && hint->key() <= it->key())
-            {
-                pos = std::lower_bound(hint,this->members_.end(), it->key(), 
-                                      [](const value_type& a, const string_view_type& k){return a.key().compare(k) < 0;});        
-            }
-            else
-            {
-                pos = std::lower_bound(this->members_.begin(),this->members_.end(), it->key(), 
-                                      [](const value_type& a, const string_view_type& k){return a.key().compare(k) < 0;});        
-            }
-            if (pos == this->members_.end() )
-            {
-                this->members_.emplace_back(*it);
-                hint = this->members_.begin() + (this->members_.size() - 1);
-            }
-            else if (it->key() != pos->key())
-            {
-                hint = this->members_.emplace(pos,*it);
-            }
-        }
+        merge(std::move(source));
     }
 
     // merge_or_update
 
     void merge_or_update(const json_object& source)
     {
-        for (auto it = source.begin(); it != source.end(); ++it)
+        if (&source == this)
         {
-            insert_or_assign(it->key(),it->value());
+            return;
         }
+        merge_members(source.begin(), source.end(), true);
     }
 
     void merge_or_update(json_object&& source)
     {
-        auto it = std::make_move_iterator(source.begin());
-        auto end = std::make_move_iterator(source.end());
-        for (; it != end; ++it)
+        if (&source == this)
         {
-            auto pos = std::lower_bound(this->members_.begin(),this->members_.end(), it->key(), 
-                                        [](const value_type& a, const string_view_type& k){return a.key().compare(k) < 0;});   
-            if (pos == this->members_.end() )
-            {
-                this->members_.emplace_back(*it);
-            }
-            else 
-            {
-                pos->value(it->value());
-            }
+            return;
         }
+        merge_members(std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()), true);
     }
 
-    void merge_or_update(iterator hint, const json_object& source)
+    void merge_or_update(iterator, const json_object& source)
     {
-        for (auto it = source.begin(); it != source.end(); ++it)
-        {
-            hint = insert_or_assign(hint, it->key(),it->value());
-        }
+        merge_or_update(source);
     }
 
-    void merge_or_update(iterator hint, json_object&& source)
+    void merge_or_update(iterator, json_object&& source)
     {
-        auto it = std::make_move_iterator(source.begin());
-        auto end = std::make_move_iterator(source.end());
-        for (; it != end; ++it)
-        {
-            iterator pos;
-            if (hint != this->members_.end() && hint->key() <= it->key())
-            {
-                pos = std::lower_bound(hint,this->members_.end(), it->key(), 
-                                      [](const value_type& a, const string_view_type& k){return a.key().compare(k) < 0;});        
-            }
-            else
-            {
-                pos = std::lower_bound(this->members_.begin(),this->members_.end(), it->key(), 
-                                      [](const value_type& a, const string_view_type& k){return a.key().compare(k) < 0;});        
-            }
-            if (pos == this->members_.end() )
-            {
-                this->members_.emplace_back(*it);
-                hint = this->members_.begin() + (this->members_.size() - 1);
-            }
-            else 
-            {
-                pos->value(it->value());
-                hint = pos;
-            }
-        }
+        merge_or_update(std::move(source));
     }
 
     // insert_or_assign
@@ -1250,16 +1376,20 @@ public:
 
     bool operator==(const json_object& rhs) const
     {
+        if (this == &rhs)
+        {
+            return true;
+        }
         if (size() != rhs.size())
         {
             return false;
         }
-        for (auto it = this->members_.begin(); it != this->members_.end(); ++it)
+        // The members of both are sorted by key with no duplicates, so equal objects
+        // have equal members in the same positions
+        auto rhs_it = rhs.begin();
+        for (auto it = this->members_.begin(); it != this->members_.end(); ++it, ++rhs_it)
         {
-
-            auto rhs_it = std::lower_bound(rhs.begin(), rhs.end(), *it, 
-                                           [](const value_type& a, const value_type& b){return a.key().compare(b.key()) < 0;});
-            if (rhs_it == rhs.end() || rhs_it->key() != it->key() || rhs_it->value() != it->value())
+            if (!it->key_equals(*rhs_it) || rhs_it->value() != it->value())
             {
                 return false;
             }
@@ -1268,6 +1398,70 @@ public:
     }
 private:
     json_object& operator=(const json_object&) = delete;
+
+    // Objects up to this size are searched linearly
+    static const size_t linear_search_threshold = 8;
+
+    // A small object is scanned comparing lengths before characters, which for names of
+    // different lengths is cheaper than the ordering comparisons of a binary search
+    template <class Iterator>
+    static Iterator find_member(Iterator first, Iterator last, const string_view_type& name)
+    {
+        if (static_cast<size_t>(last - first) <= linear_search_threshold)
+        {
+            const size_t length = name.length();
+            for (Iterator it = first; it != last; ++it)
+            {
+                auto key = it->key();
+                if (key.length() == length && 
+                    std::char_traits<char_type>::compare(key.data(), name.data(), length) == 0)
+                {
+                    return it;
+                }
+            }
+            return last;
+        }
+        auto it = std::lower_bound(first, last, name, 
+                                   [](const value_type& a, const string_view_type& k){return a.key().compare(k) < 0;});
+        return (it != last && it->key() == name) ? it : last;
+    }
+
+    // Merges the sorted members first to last. Members with new keys are appended, in
+    // order, as the two sequences are walked together, and the two sorted runs are then
+    // merged in place. With update, members with keys already present have their values
+    // replaced, otherwise they are left alone.
+    template <class InputIt>
+    void merge_members(InputIt first, InputIt last, bool update)
+    {
+        const size_t size = this->members_.size();
+        this->members_.reserve(size + std::distance(first, last));
+        size_t i = 0;
+        for (InputIt it = first; it != last; ++it)
+        {
+            string_view_type key = (*it).key();
+            while (i < size && this->members_[i].key().compare(key) < 0)
+            {
+                ++i;
+            }
+            if (i < size && this->members_[i].key() == key)
+            {
+                if (update)
+                {
+                    this->assign_member(this->members_[i], *it);
+                }
+                ++i;
+            }
+            else
+            {
+                this->append_member(*it);
+            }
+        }
+        if (this->members_.size() > size)
+        {
+            std::inplace_merge(this->members_.begin(), this->members_.begin() + size, this->members_.end(),
+                               [](const value_type& a, const value_type& b){return a.key().compare(b.key()) < 0;});
+        }
+    }
 };
 
 // Preserve order
@@ -1287,37 +1481,54 @@ public:
     using typename Json_object_<KeyT,Json>::const_iterator;
     using Json_object_<KeyT,Json>::get_allocator;
 
+    // Objects with at least this many members also keep a hash index of their keys,
+    // smaller objects are searched linearly
+    static const size_t index_threshold = 32;
+private:
+    typedef object_hash_index<allocator_type> index_type;
+    typedef typename std::allocator_traits<allocator_type>:: template rebind_alloc<index_type> index_allocator_type;
+    // The allocator's pointer type, an offset pointer for an interprocess allocator
+    typedef typename std::allocator_traits<index_allocator_type>::pointer index_pointer;
+
+    index_pointer index_;
+public:
+
     json_object()
-        : Json_object_<KeyT,Json>()
+        : Json_object_<KeyT,Json>(), index_(nullptr)
     {
     }
     json_object(const allocator_type& allocator)
-        : Json_object_<KeyT,Json>(allocator)
+        : Json_object_<KeyT,Json>(allocator), index_(nullptr)
     {
     }
 
     json_object(const json_object& val)
-        : Json_object_<KeyT,Json>(val)
+        : Json_object_<KeyT,Json>(val), index_(nullptr)
     {
+        rebuild_index();
     }
 
     json_object(json_object&& val)
-        : Json_object_<KeyT,Json>(std::forward<json_object>(val))
+        : Json_object_<KeyT,Json>(std::forward<json_object>(val)), index_(val.index_)
     {
+        val.index_ = nullptr;
     }
 
     json_object(const json_object& val, const allocator_type& allocator) 
-        : Json_object_<KeyT,Json>(val,allocator)
+        : Json_object_<KeyT,Json>(val,allocator), index_(nullptr)
     {
+        rebuild_index();
     }
 
     json_object(json_object&& val,const allocator_type& allocator) 
-        : Json_object_<KeyT,Json>(std::forward<json_object>(val),allocator)
+        : Json_object_<KeyT,Json>(std::forward<json_object>(val),allocator), index_(nullptr)
     {
+        val.destroy_index();
+        rebuild_index();
     }
 
     json_object(std::initializer_list<typename Json::array> init)
-        : Json_object_<KeyT,Json>()
+        : Json_object_<KeyT,Json>(), index_(nullptr)
     {
         for (const auto& element : init)
         {
@@ -1335,7 +1546,7 @@ public:
 
     json_object(std::initializer_list<typename Json::array> init, 
                 const allocator_type& allocator)
-        : Json_object_<KeyT,Json>(allocator)
+        : Json_object_<KeyT,Json>(allocator), index_(nullptr)
     {
         for (const auto& element : init)
         {
@@ -1351,9 +1562,15 @@ public:
         }
     }
 
+    ~json_object()
+    {
+        destroy_index();
+    }
+
     void swap(json_object& val)
     {
         Json_object_<KeyT,Json>::swap(val);
+        std::swap(index_,val.index_);
     }
 
     iterator begin()
@@ -1380,7 +1597,14 @@ public:
 
     size_t capacity() const {return this->members_.capacity();}
 
-    void clear() {this->members_.clear();}
+    // Bytes of the hash index, zero for an object too small to have one
+    size_t index_size() const {return index_ == nullptr ? 0 : index_->allocated_size();}
+
+    void clear() 
+    {
+        this->members_.clear();
+        destroy_index();
+    }
 
     void shrink_to_fit() 
     {
@@ -1413,28 +1637,27 @@ public:
 
     iterator find(const string_view_type& name)
     {
-        return std::find_if(this->members_.begin(),this->members_.end(), 
-                            [name](const value_type& kv){return kv.key() == name;});
+        return this->members_.begin() + find_position(name);
     }
 
     const_iterator find(const string_view_type& name) const
     {
-        return std::find_if(this->members_.begin(),this->members_.end(), 
-                            [name](const value_type& kv){return kv.key() == name;});
+        return this->members_.begin() + find_position(name);
     }
 
     void erase(const_iterator first, const_iterator last) 
     {
         this->members_.erase(first,last);
+        rebuild_index();
     }
 
     void erase(const string_view_type& name) 
     {
-        auto it = std::find_if(this->members_.begin(),this->members_.end(), 
-                              [name](const value_type& kv){return kv.key() == name;});
+        auto it = find(name);
         if (it != this->members_.end())
         {
             this->members_.erase(it);
+            rebuild_index();
         }
     }
 
@@ -1446,10 +1669,25 @@ public:
         for (auto s = first; s != last; ++s)
         {
             this->members_.emplace_back(pred(*s));
+            index_last_member();
         }
         auto it = last_wins_unique_sequence(this->members_.begin(), this->members_.end(),
                               [](const value_type& a, const value_type& b){ return a.key().compare(b.key());});
         this->members_.erase(it,this->members_.end());
+        rebuild_index();
+    }
+
+    // Appends members whose keys are known to be distinct, and not those of members already
+    // here, without looking for duplicates
+    template <class InputIt, class UnaryPredicate>
+    void insert_unique(InputIt first, InputIt last, UnaryPredicate pred)
+    {
+        this->members_.reserve(this->members_.size() + std::distance(first,last));
+        for (auto s = first; s != last; ++s)
+        {
+            this->members_.emplace_back(pred(*s));
+        }
+        rebuild_index();
     }
 
     // insert_or_assign
@@ -1459,13 +1697,13 @@ public:
     insert_or_assign(const string_view_type& name, T&& value)
     {
         bool inserted;
-        auto it = std::find_if(this->members_.begin(),this->members_.end(), 
-                               [name](const value_type& a){return a.key() == name;});
+        auto it = find(name);
 
         if (it == this->members_.end())
         {
             this->members_.emplace_back(key_storage_type(name.begin(),name.end()), 
                                         std::forward<T>(value));
+            index_last_member();
             it = this->members_.begin() + this->members_.size() - 1;
             inserted = true;
         }
@@ -1482,13 +1720,13 @@ public:
     insert_or_assign(const string_view_type& name, T&& value)
     {
         bool inserted;
-        auto it = std::find_if(this->members_.begin(),this->members_.end(), 
-                               [name](const value_type& a){return a.key() == name;});
+        auto it = find(name);
 
         if (it == this->members_.end())
         {
             this->members_.emplace_back(key_storage_type(name.begin(),name.end(),get_allocator()), 
                                         std::forward<T>(value),get_allocator());
+            index_last_member();
             it = this->members_.begin() + this->members_.size() - 1;
             inserted = true;
         }
@@ -1512,13 +1750,13 @@ public:
         }
         else
         {
-            it = std::find_if(this->members_.begin(),this->members_.end(), 
-                              [key](const value_type& a){return a.key() == key;});
+            it = find(key);
 
             if (it == this->members_.end())
             {
                 this->members_.emplace_back(key_storage_type(key.begin(),key.end()), 
                                             std::forward<T>(value));
+                index_last_member();
                 it = this->members_.begin() + this->members_.size() - 1;
             }
             else
@@ -1541,13 +1779,13 @@ public:
         }
         else
         {
-            it = std::find_if(this->members_.begin(),this->members_.end(), 
-                              [key](const value_type& a){return a.key() == key;});
+            it = find(key);
 
             if (it == this->members_.end())
             {
                 this->members_.emplace_back(key_storage_type(key.begin(),key.end(),get_allocator()), 
                                             std::forward<T>(value),get_allocator());
+                index_last_member();
                 it = this->members_.begin() + this->members_.size() - 1;
             }
             else
@@ -1560,107 +1798,82 @@ public:
 
     // merge
 
+    // Each key of source is looked up once, with the hash index once the object is large
+    // enough to have one, and members with new keys are appended in the order of source
+
     void merge(const json_object& source)
     {
-        for (auto it = source.begin(); it != source.end(); ++it)
+        if (&source == this)
         {
-            try_emplace(it->key(),it->value());
+            return;
         }
+        merge_members(source.begin(), source.end(), false);
     }
 
     void merge(json_object&& source)
     {
-        auto it = std::make_move_iterator(source.begin());
-        auto end = std::make_move_iterator(source.end());
-        for (; it != end; ++it)
+        if (&source == this)
         {
-            auto pos = std::find_if(this->members_.begin(),this->members_.end(), 
-                                    [it](const value_type& a){return a.key() == it->key();});
-            if (pos == this->members_.end() )
-            {
-                this->members_.emplace_back(*it);
-            }
+            return;
         }
+        merge_members(std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()), false);
     }
 
+    // Members with new keys are inserted before hint, in the order of source
     void merge(iterator hint, const json_object& source)
     {
-        for (auto it = source.begin(); it != source.end(); ++it)
+        if (&source == this)
         {
-            hint = try_emplace(hint, it->key(),it->value());
+            return;
         }
+        merge_members(hint, source.begin(), source.end(), false);
     }
 
     void merge(iterator hint, json_object&& source)
     {
-        auto it = std::make_move_iterator(source.begin());
-        auto end = std::make_move_iterator(source.end());
-        for (; it != end; ++it)
+        if (&source == this)
         {
-            auto pos = std::find_if(this->members_.begin(),this->members_.end(), 
-                                    [it](const value_type& a){return a.key() == it->key();});
-            if (pos == this->members_.end() )
-            {
-                hint = this->members_.emplace(hint,*it);
-            }
+            return;
         }
+        merge_members(hint, std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()), false);
     }
 
     // merge_or_update
 
     void merge_or_update(const json_object& source)
     {
-        for (auto it = source.begin(); it != source.end(); ++it)
+        if (&source == this)
         {
-            insert_or_assign(it->key(),it->value());
+            return;
         }
+        merge_members(source.begin(), source.end(), true);
     }
 
     void merge_or_update(json_object&& source)
     {
-        auto it = std::make_move_iterator(source.begin());
-        auto end = std::make_move_iterator(source.end());
-        for (; it != end; ++it)
+        if (&source == this)
         {
-            auto pos = std::find_if(this->members_.begin(),this->members_.end(), 
-                                    [it](const value_type& a){return a.key() == it->key();});
-            if (pos == this->members_.end() )
-            {
-                this->members_.emplace_back(*it);
-            }
-            else
-            {
-                pos->value(it->value());
-            }
+            return;
         }
+        merge_members(std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()), true);
     }
 
     void merge_or_update(iterator hint, const json_object& source)
     {
-        for (auto it = source.begin(); it != source.end(); ++it)
+        if (&source == this)
         {
-            hint = insert_or_assign(hint, it->key(),it->value());
+            return;
         }
+        merge_members(hint, source.begin(), source.end(), true);
     }
 
     void merge_or_update(iterator hint, json_object&& source)
     {
-        auto it = std::make_move_iterator(source.begin());
-        auto end = std::make_move_iterator(source.end());
-        for (; it != end; ++it)
+        if (&source == this)
         {
-            auto pos = std::find_if(this->members_.begin(),this->members_.end(), 
-                                    [it](const value_type& a){return a.key() == it->key();});
-            if (pos == this->members_.end() )
-            {
-                hint = this->members_.emplace(hint,*it);
-            }
-            else
-            {
-                pos->value(it->value());
-                hint = pos;
-            }
+            return;
         }
+        merge_members(hint, std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()), true);
     }
 
     // try_emplace
@@ -1669,13 +1882,13 @@ public:
     try_emplace(const string_view_type& key, Args&&... args)
     {
         bool inserted;
-        auto it = std::find_if(this->members_.begin(),this->members_.end(), 
-                               [key](const value_type& a){return a.key() == key;});
+        auto it = find(key);
 
         if (it == this->members_.end())
         {
             this->members_.emplace_back(key_storage_type(key.begin(),key.end()), 
                                         std::forward<Args>(args)...);
+            index_last_member();
             it = this->members_.begin() + this->members_.size() - 1;
             inserted = true;
 
@@ -1692,13 +1905,13 @@ public:
     try_emplace(const string_view_type& key, Args&&... args)
     {
         bool inserted;
-        auto it = std::find_if(this->members_.begin(),this->members_.end(), 
-                               [key](const value_type& a){return a.key() == key;});
+        auto it = find(key);
 
         if (it == this->members_.end())
         {
             this->members_.emplace_back(key_storage_type(key.begin(),key.end(), get_allocator()), 
                                         std::forward<Args>(args)...);
+            index_last_member();
             it = this->members_.begin() + this->members_.size() - 1;
             inserted = true;
 
@@ -1714,8 +1927,7 @@ public:
     typename std::enable_if<is_stateless<A>::value,iterator>::type
     try_emplace(iterator hint, const string_view_type& key, Args&&... args)
     {
-        auto it = std::find_if(this->members_.begin(),this->members_.end(), 
-                               [key](const value_type& a){return a.key() == key;});
+        auto it = find(key);
 
         if (it == this->members_.end())
         {
@@ -1723,6 +1935,7 @@ public:
             {
                 this->members_.emplace_back(key_storage_type(key.begin(),key.end()), 
                                             std::forward<Args>(args)...);
+                index_last_member();
                 it = this->members_.begin() + (this->members_.size() - 1);
             }
             else
@@ -1730,6 +1943,7 @@ public:
                 it = this->members_.emplace(hint, 
                                             key_storage_type(key.begin(),key.end()), 
                                             std::forward<Args>(args)...);
+                rebuild_index();
             }
         }
         return it;
@@ -1739,8 +1953,7 @@ public:
     typename std::enable_if<!is_stateless<A>::value,iterator>::type
     try_emplace(iterator hint, const string_view_type& key, Args&&... args)
     {
-        auto it = std::find_if(this->members_.begin(),this->members_.end(), 
-                               [key](const value_type& a){return a.key() == key;});
+        auto it = find(key);
 
         if (it == this->members_.end())
         {
@@ -1748,6 +1961,7 @@ public:
             {
                 this->members_.emplace_back(key_storage_type(key.begin(),key.end(), get_allocator()), 
                                             std::forward<Args>(args)...);
+                index_last_member();
                 it = this->members_.begin() + (this->members_.size() - 1);
             }
             else
@@ -1755,6 +1969,7 @@ public:
                 it = this->members_.emplace(hint, 
                                             key_storage_type(key.begin(),key.end(), get_allocator()), 
                                             std::forward<Args>(args)...);
+                rebuild_index();
             }
         }
         return it;
@@ -1767,13 +1982,13 @@ public:
     set_(key_storage_type&& key, T&& value)
     {
         string_view_type s(key.data(),key.size());
-        auto it = std::find_if(this->members_.begin(),this->members_.end(), 
-                               [s](const value_type& a){return a.key().compare(s) == 0;});
+        auto it = find(s);
 
         if (it == this->members_.end())
         {
             this->members_.emplace_back(std::forward<key_storage_type>(key), 
                                   std::forward<T>(value));
+            index_last_member();
         }
         else
         {
@@ -1786,13 +2001,13 @@ public:
     set_(key_storage_type&& key, T&& value)
     {
         string_view_type s(key.data(),key.size());
-        auto it = std::find_if(this->members_.begin(),this->members_.end(), 
-                               [s](const value_type& a){return a.key().compare(s) == 0;});
+        auto it = find(s);
 
         if (it == this->members_.end())
         {
             this->members_.emplace_back(std::forward<key_storage_type>(key), 
                                   std::forward<T>(value),get_allocator());
+            index_last_member();
         }
         else
         {
@@ -1810,6 +2025,7 @@ public:
         {
             this->members_.emplace_back(std::forward<key_storage_type>(key), 
                                   std::forward<T>(value));
+            index_last_member();
             it = this->members_.begin() + (this->members_.size() - 1);
         }
         else if (it->key() == key)
@@ -1821,6 +2037,7 @@ public:
             it = this->members_.emplace(it,
                                   std::forward<key_storage_type>(key),
                                   std::forward<T>(value));
+            rebuild_index();
         }
         return it;
     }
@@ -1835,6 +2052,7 @@ public:
         {
             this->members_.emplace_back(std::forward<key_storage_type>(key), 
                                   std::forward<T>(value), get_allocator());
+            index_last_member();
             it = this->members_.begin() + (this->members_.size() - 1);
         }
         else if (it->key() == key)
@@ -1846,21 +2064,28 @@ public:
             it = this->members_.emplace(it,
                                   std::forward<key_storage_type>(key),
                                   std::forward<T>(value), get_allocator());
+            rebuild_index();
         }
         return it;
     }
 
     bool operator==(const json_object& rhs) const
     {
+        if (this == &rhs)
+        {
+            return true;
+        }
         if (size() != rhs.size())
         {
             return false;
         }
-        for (auto it = this->members_.begin(); it != this->members_.end(); ++it)
+        // Objects that are equal usually have their members in the same order, so the member
+        // in the same position is tried before looking the name up
+        auto same_position = rhs.members_.begin();
+        for (auto it = this->members_.begin(); it != this->members_.end(); ++it, ++same_position)
         {
-            auto rhs_it = std::find_if(rhs.begin(),rhs.end(), 
-                                       [it](const value_type& a){return a.key() == it->key();});
-            if (rhs_it == rhs.end() || rhs_it->key() != it->key() || rhs_it->value() != it->value())
+            auto rhs_it = same_position->key_equals(*it) ? same_position : rhs.find(it->key());
+            if (rhs_it == rhs.end() || rhs_it->value() != it->value())
             {
                 return false;
             }
@@ -1869,6 +2094,119 @@ public:
     }
 private:
     json_object& operator=(const json_object&) = delete;
+
+    // Returns the position of the member with the given name, or size() if there is none
+    size_t find_position(const string_view_type& name) const
+    {
+        if (index_ != nullptr)
+        {
+            size_t pos = index_->find(this->members_, name);
+            return pos == index_type::npos ? this->members_.size() : pos;
+        }
+        size_t pos = 0;
+        while (pos < this->members_.size() && this->members_[pos].key() != name)
+        {
+            ++pos;
+        }
+        return pos;
+    }
+
+    // Appends the members first to last with keys not already present. With update, members
+    // with keys already present have their values replaced, otherwise they are left alone.
+    template <class InputIt>
+    void merge_members(InputIt first, InputIt last, bool update)
+    {
+        this->members_.reserve(this->members_.size() + std::distance(first, last));
+        for (InputIt it = first; it != last; ++it)
+        {
+            auto pos = find((*it).key());
+            if (pos == this->members_.end())
+            {
+                this->append_member(*it);
+                index_last_member();
+            }
+            else if (update)
+            {
+                this->assign_member(*pos, *it);
+            }
+        }
+    }
+
+    // As above, but the new members are then moved before hint as one block, so that the
+    // members after hint are shifted, and the index rebuilt, once rather than per member
+    template <class InputIt>
+    void merge_members(iterator hint, InputIt first, InputIt last, bool update)
+    {
+        const size_t offset = hint - this->members_.begin();
+        const size_t size = this->members_.size();
+        merge_members(first, last, update);
+        if (offset < size && this->members_.size() > size)
+        {
+            std::rotate(this->members_.begin() + offset, this->members_.begin() + size, this->members_.end());
+            rebuild_index();
+        }
+    }
+
+    // Called after a member is appended
+    void index_last_member()
+    {
+        if (index_ == nullptr)
+        {
+            if (this->members_.size() >= index_threshold)
+            {
+                rebuild_index();
+            }
+        }
+        else if (!index_->try_insert(this->members_.back().key(), this->members_.size() - 1))
+        {
+            rebuild_index();
+        }
+    }
+
+    // Called after members are inserted before the end or erased, which shifts positions
+    void rebuild_index()
+    {
+        if (this->members_.size() < index_threshold || this->members_.size() > index_type::max_positions())
+        {
+            destroy_index();
+            return;
+        }
+        if (index_ == nullptr)
+        {
+            index_allocator_type alloc(get_allocator());
+            index_pointer p = std::allocator_traits<index_allocator_type>::allocate(alloc, 1);
+            try
+            {
+                std::allocator_traits<index_allocator_type>::construct(alloc, to_plain_pointer(p), get_allocator());
+            }
+            catch (...)
+            {
+                std::allocator_traits<index_allocator_type>::deallocate(alloc, p, 1);
+                throw;
+            }
+            index_ = p;
+        }
+        try
+        {
+            index_->rebuild(this->members_);
+        }
+        catch (...)
+        {
+            destroy_index();
+            throw;
+        }
+    }
+
+    void destroy_index()
+    {
+        if (index_ != nullptr)
+        {
+            index_allocator_type alloc(get_allocator());
+            std::allocator_traits<index_allocator_type>::destroy(alloc, to_plain_pointer(index_));
+            std::allocator_traits<index_allocator_type>::deallocate(alloc, index_, 1);
+            index_ = nullptr;
+        }
+    }
 };
 
 }
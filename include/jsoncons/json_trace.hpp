@@ -0,0 +1,197 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSON_TRACE_HPP
+#define JSONCONS_JSON_TRACE_HPP
+
+#include <cstddef>
+#include <chrono>
+
+namespace jsoncons {
+
+// What a reader, decoder or serializer did in one operation: reading, decoding or
+// writing one text. Each component fills in the fields it can measure and leaves
+// the others zero.
+
+struct json_trace_record
+{
+    // The kind of component, "json_reader", "json_decoder", "json_serializer",
+    // "cbor_reader", "cbor_serializer", "msgpack_reader" or "msgpack_serializer"
+    const char* component;
+    // Characters or bytes read from the source, or written to the output
+    size_t bytes;
+    // Reads from the source, or writes to the stream or sink
+    size_t buffer_refills;
+    // Names and values decoded or serialized, arrays and objects counting as one each
+    size_t tokens;
+    // The deepest nesting of arrays and objects
+    size_t max_depth;
+    // The part of elapsed spent reading the source
+    std::chrono::nanoseconds io_time;
+    std::chrono::nanoseconds elapsed;
+
+    json_trace_record(const char* component = "")
+        : component(component),
+          bytes(0),
+          buffer_refills(0),
+          tokens(0),
+          max_depth(0),
+          io_time(0),
+          elapsed(0)
+    {
+    }
+};
+
+// Receives a record at the end of each operation of the components it is set on.
+// A component without a tracer does no timing or counting for it. do_trace is called
+// on the thread doing the operation, and must not throw.
+
+class json_tracer
+{
+public:
+    virtual ~json_tracer() = default;
+
+    void trace(const json_trace_record& record)
+    {
+        do_trace(record);
+    }
+private:
+    virtual void do_trace(const json_trace_record& record) = 0;
+};
+
+namespace detail {
+
+typedef std::chrono::steady_clock trace_clock;
+
+// Builds the record of the operation in progress, when there is a tracer to give it to
+
+class trace_recorder
+{
+    const char* component_;
+    json_tracer* tracer_;
+    bool active_;
+    size_t depth_;
+    size_t count_at_begin_;
+    size_t writes_at_begin_;
+    trace_clock::time_point start_;
+    json_trace_record record_;
+public:
+    trace_recorder(const char* component)
+        : component_(component), tracer_(nullptr), active_(false), depth_(0), count_at_begin_(0), writes_at_begin_(0)
+    {
+    }
+
+    json_tracer* tracer() const
+    {
+        return tracer_;
+    }
+
+    void tracer(json_tracer* tracer)
+    {
+        tracer_ = tracer;
+        active_ = false;
+    }
+
+    bool active() const
+    {
+        return active_;
+    }
+
+    json_trace_record& record()
+    {
+        return record_;
+    }
+
+    void begin()
+    {
+        if (tracer_ != nullptr)
+        {
+            active_ = true;
+            depth_ = 0;
+            record_ = json_trace_record(component_);
+            start_ = trace_clock::now();
+        }
+    }
+
+    void end()
+    {
+        if (active_)
+        {
+            active_ = false;
+            record_.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(trace_clock::now() - start_);
+            tracer_->trace(record_);
+        }
+    }
+
+    // Begins and ends an operation that writes to a buffered_output
+    template <class Output>
+    void begin(const Output& out)
+    {
+        begin();
+        if (active_)
+        {
+            count_at_begin_ = out.count();
+            writes_at_begin_ = out.write_count();
+        }
+    }
+
+    template <class Output>
+    void end(const Output& out)
+    {
+        if (active_)
+        {
+            record_.bytes = out.count() - count_at_begin_;
+            record_.buffer_refills = out.write_count() - writes_at_begin_;
+            end();
+        }
+    }
+
+    // Reads from source, timing the read and counting what it returns
+    template <class Source, class T>
+    size_t read(Source& source, T* data, size_t length)
+    {
+        trace_clock::time_point start = trace_clock::now();
+        size_t n = source.read(data, length);
+        record_.io_time += std::chrono::duration_cast<std::chrono::nanoseconds>(trace_clock::now() - start);
+        record_.bytes += n;
+        ++record_.buffer_refills;
+        return n;
+    }
+
+    void token(size_t count = 1)
+    {
+        if (active_)
+        {
+            record_.tokens += count;
+        }
+    }
+
+    // Keeps track of the depth of an operation that writes
+    void begin_container()
+    {
+        if (active_)
+        {
+            if (++depth_ > record_.max_depth)
+            {
+                record_.max_depth = depth_;
+            }
+        }
+    }
+
+    void end_container()
+    {
+        if (active_)
+        {
+            --depth_;
+        }
+    }
+};
+
+}
+
+}
+
+#endif
@@ -0,0 +1,239 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSON_TRAVERSAL_HPP
+#define JSONCONS_JSON_TRAVERSAL_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+#include <jsoncons/json.hpp>
+
+namespace jsoncons {
+
+// An iterator over a value and all the values in it, depth first, each array or object
+// before its elements or members. It keeps a frame for each array and object it is in,
+// rather than recursing, so a document of any depth can be traversed. As it moves to a
+// value, it prefetches the elements or members of the value after it.
+
+template <class Json>
+class depth_first_iterator
+{
+public:
+    typedef Json value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const Json* pointer;
+    typedef const Json& reference;
+    typedef std::forward_iterator_tag iterator_category;
+
+    typedef typename Json::string_view_type string_view_type;
+private:
+    typedef typename Json::const_array_iterator const_array_iterator;
+    typedef typename Json::const_object_iterator const_object_iterator;
+
+    struct frame
+    {
+        const Json* container;
+        bool is_object;
+        size_t index;
+        const_array_iterator element;
+        const_array_iterator elements_end;
+        const_object_iterator member;
+        const_object_iterator members_end;
+    };
+
+    std::vector<frame> stack_;
+    const Json* current_;
+    bool skip_;
+public:
+    // The end iterator
+    depth_first_iterator()
+        : current_(nullptr), skip_(false)
+    {
+    }
+
+    explicit depth_first_iterator(const Json& root)
+        : current_(&root), skip_(false)
+    {
+    }
+
+    reference operator*() const
+    {
+        return *current_;
+    }
+
+    pointer operator->() const
+    {
+        return current_;
+    }
+
+    // The number of arrays and objects that contain the current value, 0 for the root
+    size_t depth() const
+    {
+        return stack_.size();
+    }
+
+    // The array or object that contains the current value, nullptr for the root
+    const Json* parent() const
+    {
+        return stack_.empty() ? nullptr : stack_.back().container;
+    }
+
+    // The position of the current value in its array or object
+    size_t index() const
+    {
+        return stack_.empty() ? 0 : stack_.back().index;
+    }
+
+    // Whether the current value is the value of an object member
+    bool is_member() const
+    {
+        return !stack_.empty() && stack_.back().is_object;
+    }
+
+    // The name of the current value if it is the value of an object member, otherwise empty
+    string_view_type key() const
+    {
+        return is_member() ? stack_.back().member->key() : string_view_type();
+    }
+
+    // The next increment moves past the current value without visiting its elements or members
+    void skip_children()
+    {
+        skip_ = true;
+    }
+
+    depth_first_iterator& operator++()
+    {
+        if (!skip_ && has_children(*current_))
+        {
+            frame f;
+            f.container = current_;
+            f.index = 0;
+            f.is_object = current_->is_object();
+            if (f.is_object)
+            {
+                auto r = current_->object_range();
+                f.member = r.begin();
+                f.members_end = r.end();
+            }
+            else
+            {
+                auto r = current_->array_range();
+                f.element = r.begin();
+                f.elements_end = r.end();
+            }
+            stack_.push_back(f);
+            enter(stack_.back());
+            return *this;
+        }
+        skip_ = false;
+        while (!stack_.empty())
+        {
+            frame& f = stack_.back();
+            ++f.index;
+            if (f.is_object ? ++f.member != f.members_end : ++f.element != f.elements_end)
+            {
+                enter(f);
+                return *this;
+            }
+            stack_.pop_back();
+        }
+        current_ = nullptr;
+        return *this;
+    }
+
+    depth_first_iterator operator++(int)
+    {
+        depth_first_iterator temp(*this);
+        ++(*this);
+        return temp;
+    }
+
+    friend bool operator==(const depth_first_iterator& it1, const depth_first_iterator& it2)
+    {
+        return it1.current_ == it2.current_;
+    }
+
+    friend bool operator!=(const depth_first_iterator& it1, const depth_first_iterator& it2)
+    {
+        return !(it1 == it2);
+    }
+private:
+    static bool has_children(const Json& val)
+    {
+        return (val.is_array() || val.is_object()) && val.size() > 0;
+    }
+
+    void enter(const frame& f)
+    {
+        if (f.is_object)
+        {
+            current_ = &(f.member->value());
+            auto next = f.member;
+            if (++next != f.members_end)
+            {
+                prefetch_children(next->value());
+            }
+        }
+        else
+        {
+            current_ = &(*f.element);
+            auto next = f.element;
+            if (++next != f.elements_end)
+            {
+                prefetch_children(*next);
+            }
+        }
+    }
+
+    static void prefetch_children(const Json& val)
+    {
+        if (has_children(val))
+        {
+            if (val.is_object())
+            {
+                JSONCONS_PREFETCH(&(*val.object_range().begin()));
+            }
+            else
+            {
+                JSONCONS_PREFETCH(&(*val.array_range().begin()));
+            }
+        }
+    }
+};
+
+template <class Json>
+class depth_first_range
+{
+    const Json* root_;
+public:
+    explicit depth_first_range(const Json& root)
+        : root_(&root)
+    {
+    }
+
+    depth_first_iterator<Json> begin() const
+    {
+        return depth_first_iterator<Json>(*root_);
+    }
+
+    depth_first_iterator<Json> end() const
+    {
+        return depth_first_iterator<Json>();
+    }
+};
+
+// The values of root, depth first
+template <class Json>
+depth_first_range<Json> depth_first(const Json& root)
+{
+    return depth_first_range<Json>(root);
+}
+
+}
+
+#endif
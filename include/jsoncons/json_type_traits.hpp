@@ -956,6 +956,31 @@ struct json_type_traits<Json, std::valarray<T>>
     }
 };
 
+namespace detail {
+
+// Whether as<T>() converts a value, used by basic_json::try_as. It is is<T>(), except
+// that a floating point T, which as<T>() makes of any number, takes integers too
+
+template <class Json, class T, class Enable=void>
+struct json_convertible
+{
+    static bool test(const Json& j)
+    {
+        return json_type_traits<Json,T>::is(j);
+    }
+};
+
+template <class Json, class T>
+struct json_convertible<Json, T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+{
+    static bool test(const Json& j)
+    {
+        return j.is_number();
+    }
+};
+
+}
+
 }
 
 #if defined(__GNUC__)
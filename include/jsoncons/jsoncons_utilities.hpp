@@ -29,6 +29,8 @@
 #include <jsoncons/detail/jsoncons_config.hpp>
 #include <jsoncons/detail/osequencestream.hpp>
 #include <jsoncons/detail/type_traits_helper.hpp>
+#include <jsoncons/detail/base64.hpp>
+#include <jsoncons/json_exception.hpp>
 
 namespace jsoncons
 {
@@ -241,7 +243,8 @@ void encode_base64(InputIt first, InputIt last, const std::string& alphabet, std
 {
     unsigned char a3[3];
     unsigned char a4[4];
-    unsigned char fill = alphabet.back();
+    // base64url_alphabet has no fill character, the '\0' ends the literal
+    unsigned char fill = alphabet.size() > 64 ? alphabet[64] : 0;
     int i = 0;
     int j = 0;
 
@@ -289,70 +292,108 @@ void encode_base64(InputIt first, InputIt last, const std::string& alphabet, std
     }
 }
 
-template <class InputIt,class CharT>
-void encode_base64url(InputIt first, InputIt last, std::basic_string<CharT>& result)
+// The number of characters in the base64 encoding of length bytes, padded, and in the
+// base64url encoding, unpadded
+inline
+size_t encoded_base64_length(size_t length)
 {
-    return encode_base64(first,last,base64url_alphabet,result);
+    return 4*((length + 2)/3);
 }
 
-template <class InputIt,class CharT>
-void encode_base64(InputIt first, InputIt last, std::basic_string<CharT>& result)
+inline
+size_t encoded_base64url_length(size_t length)
 {
-    encode_base64(first,last,base64_alphabet,result);
+    return (4*length + 2)/3;
 }
 
+// The most bytes that length characters of base64 or base64url decode to
 inline
-std::string decode_base64(const std::string& base64_string)
+size_t decoded_base64_max_length(size_t length)
 {
-    std::string result;
-    size_t buflen = base64_string.size();
-    uint8_t a4[4], a3[3];
-    uint8_t i = 0;
-    uint8_t j = 0;
+    return 3*(length/4) + 3*(length % 4)/4;
+}
 
-    auto first = base64_string.begin();
-    auto last = base64_string.end();
+// Writes the base64 encoding of [data,data+length) to result, which must have room for
+// encoded_base64_length(length) characters, and returns the number of characters written
+template <class CharT>
+size_t encode_base64(const uint8_t* data, size_t length, CharT* result)
+{
+    return detail::encode_base64(data, data + length, false, result) - result;
+}
 
-    while (first != last && *first != '=')
-    {
-        JSONCONS_ASSERT(is_base64(*first));
+// Writes the base64url encoding of [data,data+length) to result, which must have room for
+// encoded_base64url_length(length) characters, and returns the number of characters written
+template <class CharT>
+size_t encode_base64url(const uint8_t* data, size_t length, CharT* result)
+{
+    return detail::encode_base64(data, data + length, true, result) - result;
+}
 
-        a4[i++] = *first++; 
-        if (i == 4)
-        {
-            for (i = 0; i < 4; ++i) 
-            {
-                a4[i] = static_cast<uint8_t>(base64_alphabet.find(a4[i]));
-            }
+// With pointers to bytes, [first,last) is encoded directly into result
 
-            a3[0] = (a4[0] << 2) + ((a4[1] & 0x30) >> 4);
-            a3[1] = ((a4[1] & 0xf) << 4) + ((a4[2] & 0x3c) >> 2);
-            a3[2] = ((a4[2] & 0x3) << 6) +   a4[3];
+template <class InputIt,class CharT>
+typename std::enable_if<std::is_convertible<InputIt,const uint8_t*>::value>::type
+encode_base64url(InputIt first, InputIt last, std::basic_string<CharT>& result)
+{
+    const size_t offset = result.size();
+    result.resize(offset + encoded_base64url_length(last - first));
+    encode_base64url(first, last - first, &result[offset]);
+}
 
-            for (i = 0; i < 3; i++) 
-            {
-                result.push_back(a3[i]);
-            }
-            i = 0;
-        }
-    }
+template <class InputIt,class CharT>
+typename std::enable_if<std::is_convertible<InputIt,const uint8_t*>::value>::type
+encode_base64(InputIt first, InputIt last, std::basic_string<CharT>& result)
+{
+    const size_t offset = result.size();
+    result.resize(offset + encoded_base64_length(last - first));
+    encode_base64(first, last - first, &result[offset]);
+}
 
-    if (i > 0)
-    {
-        for (j = 0; j < i; ++j) 
-        {
-            a4[j] = static_cast<uint8_t>(base64_alphabet.find(a4[j]));
-        }
+template <class InputIt,class CharT>
+typename std::enable_if<!std::is_convertible<InputIt,const uint8_t*>::value>::type
+encode_base64url(InputIt first, InputIt last, std::basic_string<CharT>& result)
+{
+    encode_base64(first,last,base64url_alphabet,result);
+}
 
-        a3[0] = (a4[0] << 2) + ((a4[1] & 0x30) >> 4);
-        a3[1] = ((a4[1] & 0xf) << 4) + ((a4[2] & 0x3c) >> 2);
+template <class InputIt,class CharT>
+typename std::enable_if<!std::is_convertible<InputIt,const uint8_t*>::value>::type
+encode_base64(InputIt first, InputIt last, std::basic_string<CharT>& result)
+{
+    encode_base64(first,last,base64_alphabet,result);
+}
 
-        for (j = 0; j < i - 1; ++j) 
-        {
-            result.push_back(a3[j]);
-        }
+// Decodes the base64 characters [s,s+length), up to the first fill character '=' if any,
+// to result, which must have room for decoded_base64_max_length(length) bytes, and returns
+// the number of bytes written. Throws if a character is outside the alphabet.
+template <class CharT>
+size_t decode_base64(const CharT* s, size_t length, uint8_t* result)
+{
+    uint8_t* end = result;
+    if (!detail::decode_base64(s, s + length, false, end))
+    {
+        JSONCONS_THROW_EXCEPTION(std::runtime_error,"Invalid base64 character");
+    }
+    return end - result;
+}
+
+template <class CharT>
+size_t decode_base64url(const CharT* s, size_t length, uint8_t* result)
+{
+    uint8_t* end = result;
+    if (!detail::decode_base64(s, s + length, true, end))
+    {
+        JSONCONS_THROW_EXCEPTION(std::runtime_error,"Invalid base64url character");
     }
+    return end - result;
+}
 
+inline
+std::string decode_base64(const std::string& base64_string)
+{
+    std::string result(decoded_base64_max_length(base64_string.size()), '\0');
+    result.resize(decode_base64(base64_string.data(), base64_string.size(),
+                                reinterpret_cast<uint8_t*>(&result[0])));
     return result;
 }
 
@@ -0,0 +1,376 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_NDJSON_READER_HPP
+#define JSONCONS_NDJSON_READER_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <exception>
+#include <algorithm>
+#include <system_error>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/json_error_category.hpp>
+#include <jsoncons/parse_error_handler.hpp>
+#include <jsoncons/detail/mapped_file.hpp>
+#include <jsoncons/detail/parallel_workers.hpp>
+
+namespace jsoncons {
+
+// Opts in to parsing newline delimited JSON on more than one thread. The text is split
+// into batches of about batch_size bytes at line ends, which up to max_threads workers
+// parse. When ordered, the calling thread passes the values on in the order of the lines,
+// otherwise each worker passes on the values it parses as it goes.
+
+class ndjson_options
+{
+    size_t max_threads_;
+    size_t batch_size_;
+    bool ordered_;
+public:
+    static const size_t default_batch_size = 1024*1024;
+
+    ndjson_options()
+        : max_threads_((std::max)(std::thread::hardware_concurrency(), 1u)),
+          batch_size_(default_batch_size),
+          ordered_(true)
+    {
+    }
+
+//  Accessors
+
+    size_t max_threads() const
+    {
+        return max_threads_;
+    }
+
+    size_t batch_size() const
+    {
+        return batch_size_;
+    }
+
+    bool ordered() const
+    {
+        return ordered_;
+    }
+
+//  Modifiers
+
+    ndjson_options& max_threads(size_t value)
+    {
+        max_threads_ = value;
+        return *this;
+    }
+
+    ndjson_options& batch_size(size_t value)
+    {
+        batch_size_ = value;
+        return *this;
+    }
+
+    ndjson_options& ordered(bool value)
+    {
+        ordered_ = value;
+        return *this;
+    }
+};
+
+// Reads newline delimited JSON, one text per line, from a memory mapped file or a buffer
+// the caller owns, into independent Json values. The line ends are found with
+// char_traits::find, which is memchr for char, and blank lines are skipped. A text cannot
+// span lines, as a line end inside a JSON string must be escaped, so each batch of lines
+// is parsed on its own. Without ndjson_options, or when the text is no larger than one
+// batch, the lines are parsed on the calling thread.
+
+template <class Json>
+class ndjson_reader
+{
+public:
+    typedef typename Json::char_type char_type;
+    typedef typename Json::string_view_type string_view_type;
+private:
+    struct batch
+    {
+        const char_type* first;
+        const char_type* last;
+        std::vector<Json> values;
+
+        // An error, at a line counted from the start of the batch
+        std::exception_ptr error;
+        std::error_code ec;
+        size_t line;
+        size_t column;
+
+        batch(const char_type* first, const char_type* last)
+            : first(first), last(last), line(0), column(0)
+        {
+        }
+    };
+
+    std::error_code open_ec_;
+    std::unique_ptr<detail::mapped_file> file_;
+    const char_type* data_;
+    size_t length_;
+    ndjson_options options_;
+    bool parallel_;
+
+    // Noncopyable and nonmoveable
+    ndjson_reader(const ndjson_reader&) = delete;
+    ndjson_reader& operator=(const ndjson_reader&) = delete;
+
+public:
+    ndjson_reader(const std::string& filename)
+        : file_(new detail::mapped_file(filename, open_ec_)),
+          parallel_(false)
+    {
+        init_mapping();
+    }
+
+    ndjson_reader(const std::string& filename, const ndjson_options& options)
+        : file_(new detail::mapped_file(filename, open_ec_)),
+          options_(options),
+          parallel_(true)
+    {
+        init_mapping();
+    }
+
+    ndjson_reader(const char_type* data, size_t length)
+        : data_(data), length_(length),
+          parallel_(false)
+    {
+    }
+
+    ndjson_reader(const char_type* data, size_t length, const ndjson_options& options)
+        : data_(data), length_(length),
+          options_(options),
+          parallel_(true)
+    {
+    }
+
+    // The error the file could not be opened or mapped with, if any
+    std::error_code open_error() const
+    {
+        return open_ec_;
+    }
+
+    // Calls f with each value, as a Json&&. When the values are passed on by the workers,
+    // unordered, f is called on more than one thread at once. Throws parse_error, with the
+    // line number in the whole text, for the first line that fails to parse, after passing
+    // on the values of the lines before it (and, unordered, perhaps some after it).
+    template <class Function>
+    void read(Function f)
+    {
+        if (open_ec_)
+        {
+            throw parse_error(json_parser_errc::source_error,0,0);
+        }
+        std::vector<batch> batches = split();
+        const size_t workers = parallel_ ? (std::min)(options_.max_threads(), batches.size()) : 1;
+        if (workers <= 1 || batches.size() <= 1)
+        {
+            batch b(data_, data_ + length_);
+            parse_batch(b, f);
+            throw_if_error(b);
+            return;
+        }
+        if (options_.ordered())
+        {
+            read_ordered(batches, workers, f);
+        }
+        else
+        {
+            read_unordered(batches, workers, f);
+        }
+    }
+
+    // Returns the values of all the lines, in order
+    std::vector<Json> read()
+    {
+        if (!parallel_ || options_.ordered())
+        {
+            std::vector<Json> values;
+            read([&values](Json&& val){values.push_back(std::move(val));});
+            return values;
+        }
+        std::mutex mutex;
+        std::vector<Json> values;
+        read([&](Json&& val)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            values.push_back(std::move(val));
+        });
+        return values;
+    }
+
+private:
+    void init_mapping()
+    {
+        data_ = reinterpret_cast<const char_type*>(file_->data());
+        length_ = file_->size()/sizeof(char_type);
+    }
+
+    // Splits the text after the first line end at or after every batch_size characters
+    std::vector<batch> split() const
+    {
+        std::vector<batch> batches;
+        const char_type* p = data_;
+        const char_type* end = data_ + length_;
+        const size_t size = parallel_ ? (std::max)(options_.batch_size(), size_t(1)) : length_;
+        while (p < end)
+        {
+            const char_type* q = static_cast<size_t>(end - p) > size ? p + size : end;
+            if (q < end)
+            {
+                const char_type* nl = std::char_traits<char_type>::find(q, end - q, '\n');
+                q = nl != nullptr ? nl + 1 : end;
+            }
+            batches.emplace_back(p, q);
+            p = q;
+        }
+        return batches;
+    }
+
+    // Parses the lines of b, passing the values to f, until one fails
+    template <class Function>
+    static void parse_batch(batch& b, Function& f)
+    {
+        size_t line = 0;
+        const char_type* p = b.first;
+        while (p < b.last)
+        {
+            const char_type* nl = std::char_traits<char_type>::find(p, b.last - p, '\n');
+            const char_type* q = nl != nullptr ? nl : b.last;
+            ++line;
+            if (!is_blank(p, q))
+            {
+                size_t length = static_cast<size_t>(q - p);
+                if (length > 0 && p[length-1] == '\r')
+                {
+                    --length;
+                }
+                try
+                {
+                    f(Json::parse(string_view_type(p, length)));
+                }
+                catch (const parse_error& e)
+                {
+                    b.ec = e.code();
+                    b.line = line;
+                    b.column = e.column_number();
+                    return;
+                }
+                catch (...)
+                {
+                    b.error = std::current_exception();
+                    return;
+                }
+            }
+            p = nl != nullptr ? nl + 1 : b.last;
+        }
+    }
+
+    template <class Function>
+    void read_ordered(std::vector<batch>& batches, size_t workers, Function& f)
+    {
+        size_t failed = batches.size();
+        auto produce = [&](size_t i)
+        {
+            auto push = [&batches,i](Json&& val){batches[i].values.push_back(std::move(val));};
+            parse_batch(batches[i], push);
+        };
+        auto consume = [&](size_t i) -> bool
+        {
+            std::vector<Json> values;
+            values.swap(batches[i].values);
+            for (auto& val : values)
+            {
+                f(std::move(val));
+            }
+            if (batches[i].error || batches[i].ec)
+            {
+                failed = i;
+            }
+            return failed == batches.size();
+        };
+        detail::run_ordered(batches.size(), workers, produce, consume);
+        if (failed != batches.size())
+        {
+            throw_if_error(batches[failed]);
+        }
+    }
+
+    template <class Function>
+    void read_unordered(std::vector<batch>& batches, size_t workers, Function& f)
+    {
+        std::atomic<size_t> next(0);
+        std::atomic<bool> stop(false);
+
+        auto work = [&]()
+        {
+            for (size_t i = next++; i < batches.size() && !stop; i = next++)
+            {
+                parse_batch(batches[i], f);
+                if (batches[i].error || batches[i].ec)
+                {
+                    stop = true;
+                }
+            }
+        };
+        {
+            detail::joining_threads threads(workers - 1);
+            try
+            {
+                for (size_t i = 1; i < workers; ++i)
+                {
+                    threads.start(work);
+                }
+            }
+            catch (...)
+            {
+                stop = true;
+                throw;
+            }
+            work();
+        }
+        for (auto& b : batches)
+        {
+            throw_if_error(b);
+        }
+    }
+
+    void throw_if_error(const batch& b) const
+    {
+        if (b.error)
+        {
+            std::rethrow_exception(b.error);
+        }
+        if (b.ec)
+        {
+            const size_t lines_before = static_cast<size_t>(std::count(data_, b.first, '\n'));
+            throw parse_error(b.ec, lines_before + b.line, b.column);
+        }
+    }
+
+    static bool is_blank(const char_type* p, const char_type* last)
+    {
+        for (; p < last; ++p)
+        {
+            if (!(*p == ' ' || *p == '\t' || *p == '\r'))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+}
+
+#endif
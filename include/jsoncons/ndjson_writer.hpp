@@ -0,0 +1,185 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_NDJSON_WRITER_HPP
+#define JSONCONS_NDJSON_WRITER_HPP
+
+#include <string>
+#include <ostream>
+#include <iterator>
+#include <algorithm>
+#include <jsoncons/json.hpp>
+#include <jsoncons/output_sink.hpp>
+#include <jsoncons/ndjson_reader.hpp>
+#include <jsoncons/parallel_array_writer.hpp>
+
+namespace jsoncons {
+
+// Writes newline delimited JSON, one compact text per value followed by a line end. The
+// texts are serialized back to back into one buffer, kept across values by a serializer
+// that is reused for each of them, and the buffer is written to the stream once it holds
+// buffer_length characters, when flush is called, and when the writer is destroyed.
+// Given ndjson_options, a range of values is split into batches of about batch_size
+// characters, which up to max_threads workers serialize, each batch into a string of its
+// own, and the batches are written in order, as the values are with one thread.
+
+template <class Json>
+class ndjson_writer
+{
+public:
+    typedef typename Json::char_type char_type;
+    typedef std::basic_string<char_type> buffer_type;
+
+    static const size_t default_buffer_length = 65536;
+private:
+    std::basic_ostream<char_type>& os_;
+    basic_serialization_options<char_type> options_;
+    ndjson_options parallel_options_;
+    bool parallel_;
+    size_t buffer_length_;
+    buffer_type buffer_;
+    basic_string_sink<buffer_type> sink_;
+    basic_json_serializer<char_type> serializer_;
+
+    // Noncopyable and nonmoveable
+    ndjson_writer(const ndjson_writer&) = delete;
+    ndjson_writer& operator=(const ndjson_writer&) = delete;
+
+public:
+    ndjson_writer(std::basic_ostream<char_type>& os)
+        : os_(os), parallel_(false), buffer_length_(default_buffer_length),
+          sink_(buffer_), serializer_(sink_, options_)
+    {
+        buffer_.reserve(buffer_length_);
+    }
+
+    ndjson_writer(std::basic_ostream<char_type>& os, const basic_serialization_options<char_type>& options)
+        : os_(os), options_(options), parallel_(false), buffer_length_(default_buffer_length),
+          sink_(buffer_), serializer_(sink_, options_)
+    {
+        buffer_.reserve(buffer_length_);
+    }
+
+    ndjson_writer(std::basic_ostream<char_type>& os, const basic_serialization_options<char_type>& options,
+                  const ndjson_options& parallel)
+        : os_(os), options_(options), parallel_options_(parallel), parallel_(true), buffer_length_(default_buffer_length),
+          sink_(buffer_), serializer_(sink_, options_)
+    {
+        buffer_.reserve(buffer_length_);
+    }
+
+    ~ndjson_writer()
+    {
+        flush();
+    }
+
+    size_t buffer_length() const
+    {
+        return buffer_length_;
+    }
+
+    // The number of characters held before they are written to the stream
+    ndjson_writer& buffer_length(size_t value)
+    {
+        buffer_length_ = value;
+        return *this;
+    }
+
+    // Writes val as one line
+    void write(const Json& val)
+    {
+        val.dump(serializer_);
+        buffer_.push_back('\n');
+        if (buffer_.size() >= buffer_length_)
+        {
+            write_buffer();
+        }
+    }
+
+    // Writes the values [first,last) as one line each. With ndjson_options, the values
+    // are serialized on up to max_threads threads; first and last are then random access
+    // iterators, and the values are not changed until write returns.
+    template <class InputIt>
+    void write(InputIt first, InputIt last)
+    {
+        write(first, last, typename std::iterator_traits<InputIt>::iterator_category());
+    }
+
+    // Writes the buffer to the stream and flushes the stream
+    void flush()
+    {
+        write_buffer();
+        os_.flush();
+    }
+
+private:
+    template <class InputIt, class Category>
+    void write(InputIt first, InputIt last, Category)
+    {
+        for (; first != last; ++first)
+        {
+            write(*first);
+        }
+    }
+
+    template <class RandomIt>
+    void write(RandomIt first, RandomIt last, std::random_access_iterator_tag)
+    {
+        const size_t length = static_cast<size_t>(last - first);
+        if (!parallel_ || parallel_options_.max_threads() <= 1 || length <= 1)
+        {
+            for (; first != last; ++first)
+            {
+                write(*first);
+            }
+            return;
+        }
+
+        const basic_serialization_options<char_type>& options = options_;
+        auto encode = [first,&options](size_t from, size_t to, buffer_type& buffer)
+        {
+            basic_string_sink<buffer_type> sink(buffer);
+            basic_json_serializer<char_type> serializer(sink, options);
+            for (RandomIt it = first + from; it != first + to; ++it)
+            {
+                it->dump(serializer);
+                buffer.push_back('\n');
+            }
+        };
+        auto size = [](const buffer_type& buffer)
+        {
+            return buffer.size();
+        };
+        auto write_batch = [this](const buffer_type& batch)
+        {
+            if (buffer_.size() + batch.size() < buffer_length_)
+            {
+                buffer_.append(batch);
+            }
+            else
+            {
+                write_buffer();
+                os_.write(batch.data(), batch.size());
+            }
+        };
+        parallel_array_options chunking;
+        chunking.max_threads(parallel_options_.max_threads()).chunk_size(parallel_options_.batch_size());
+        detail::write_chunks_ordered<buffer_type>(length, chunking, encode, size, write_batch);
+    }
+
+    void write_buffer()
+    {
+        if (!buffer_.empty())
+        {
+            os_.write(buffer_.data(), buffer_.size());
+            buffer_.clear();
+        }
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,404 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_OUTPUT_SINK_HPP
+#define JSONCONS_OUTPUT_SINK_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <functional>
+#include <ostream>
+#include <system_error>
+#include <jsoncons/detail/jsoncons_config.hpp>
+#include <jsoncons/detail/utf_transcode.hpp>
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <unistd.h>
+#include <sys/uio.h>
+#endif
+
+namespace jsoncons {
+
+// Where a serializer's buffer goes when it is full, and when serialization ends. The
+// serializers write to a sink once per buffer, not once per value, so the cost of the
+// virtual call is spread over many characters.
+
+template <class CharT>
+class basic_output_sink
+{
+public:
+    typedef CharT char_type;
+
+    virtual ~basic_output_sink() {}
+
+    void write(const CharT* s, size_t length)
+    {
+        do_write(s, length);
+    }
+
+    // Writes s1 followed by s2
+    void write(const CharT* s1, size_t length1, const CharT* s2, size_t length2)
+    {
+        do_write(s1, length1, s2, length2);
+    }
+
+    void flush()
+    {
+        do_flush();
+    }
+
+private:
+    virtual void do_write(const CharT* s, size_t length) = 0;
+
+    virtual void do_write(const CharT* s1, size_t length1, const CharT* s2, size_t length2)
+    {
+        do_write(s1, length1);
+        do_write(s2, length2);
+    }
+
+    virtual void do_flush()
+    {
+    }
+};
+
+// Appends to a std::basic_string or a std::vector
+
+template <class Container>
+class basic_string_sink : public basic_output_sink<typename Container::value_type>
+{
+public:
+    typedef typename Container::value_type char_type;
+private:
+    Container& s_;
+
+    // Noncopyable and nonmoveable
+    basic_string_sink(const basic_string_sink&) = delete;
+    basic_string_sink& operator=(const basic_string_sink&) = delete;
+public:
+    basic_string_sink(Container& s)
+        : s_(s)
+    {
+    }
+
+private:
+    void do_write(const char_type* s, size_t length) override
+    {
+        s_.insert(s_.end(), s, s + length);
+    }
+};
+
+// Copies into a fixed buffer supplied by the caller. Output that does not fit is dropped,
+// and overflow() becomes true.
+
+template <class CharT>
+class basic_buffer_sink : public basic_output_sink<CharT>
+{
+    CharT* data_;
+    size_t capacity_;
+    size_t size_;
+    size_t required_size_;
+    bool overflow_;
+
+    // Noncopyable and nonmoveable
+    basic_buffer_sink(const basic_buffer_sink&) = delete;
+    basic_buffer_sink& operator=(const basic_buffer_sink&) = delete;
+public:
+    basic_buffer_sink(CharT* data, size_t capacity)
+        : data_(data), capacity_(capacity), size_(0), required_size_(0), overflow_(false)
+    {
+    }
+
+    const CharT* data() const
+    {
+        return data_;
+    }
+
+    // The number of characters written to the buffer
+    size_t size() const
+    {
+        return size_;
+    }
+
+    // The number of characters written, including those that did not fit
+    size_t required_size() const
+    {
+        return required_size_;
+    }
+
+    bool overflow() const
+    {
+        return overflow_;
+    }
+
+private:
+    void do_write(const CharT* s, size_t length) override
+    {
+        required_size_ += length;
+        size_t n = length;
+        if (n > capacity_ - size_)
+        {
+            n = capacity_ - size_;
+            overflow_ = true;
+        }
+        if (n > 0)
+        {
+            std::memcpy(data_ + size_, s, n*sizeof(CharT));
+            size_ += n;
+        }
+    }
+};
+
+// Discards the output and counts its characters
+
+template <class CharT>
+class basic_counting_sink : public basic_output_sink<CharT>
+{
+    size_t count_;
+public:
+    basic_counting_sink()
+        : count_(0)
+    {
+    }
+
+    size_t count() const
+    {
+        return count_;
+    }
+
+private:
+    void do_write(const CharT*, size_t length) override
+    {
+        count_ += length;
+    }
+};
+
+// Passes each block of output to a function
+
+template <class CharT>
+class basic_callback_sink : public basic_output_sink<CharT>
+{
+public:
+    typedef std::function<void(const CharT*, size_t)> write_function;
+private:
+    write_function f_;
+public:
+    basic_callback_sink(write_function f)
+        : f_(f)
+    {
+    }
+
+private:
+    void do_write(const CharT* s, size_t length) override
+    {
+        f_(s, length);
+    }
+};
+
+// Writes the UTF-16 or UTF-32 output of a wide serializer as UTF-8, to a std::ostream or
+// to a sink of char, so that a wjson_serializer can write UTF-8 text. A surrogate pair
+// split between two writes is joined. Serializers cannot report errors, so the first
+// character that is not valid is kept and can be checked with error() when
+// serialization is done; output after an error is discarded.
+
+template <class CharT>
+class basic_utf8_sink : public basic_output_sink<CharT>
+{
+    std::ostream* os_;
+    basic_output_sink<char>* sink_;
+    std::vector<char> bytes_;
+    // A high surrogate at the end of the last write, or 0
+    CharT pending_;
+    std::error_code ec_;
+
+    // Noncopyable and nonmoveable
+    basic_utf8_sink(const basic_utf8_sink&) = delete;
+    basic_utf8_sink& operator=(const basic_utf8_sink&) = delete;
+public:
+    basic_utf8_sink(std::ostream& os)
+        : os_(std::addressof(os)), sink_(nullptr), pending_(0)
+    {
+    }
+
+    basic_utf8_sink(basic_output_sink<char>& sink)
+        : os_(nullptr), sink_(std::addressof(sink)), pending_(0)
+    {
+    }
+
+    std::error_code error() const
+    {
+        return ec_;
+    }
+
+private:
+    void do_write(const CharT* s, size_t length) override
+    {
+        if (ec_ || length == 0)
+        {
+            return;
+        }
+        if (pending_ != 0)
+        {
+            CharT pair[2] = {pending_, s[0]};
+            pending_ = 0;
+            convert(pair, 2);
+            ++s;
+            --length;
+        }
+        convert(s, length);
+    }
+
+    void do_flush() override
+    {
+        if (pending_ != 0 && !ec_)
+        {
+            ec_ = unicons::conv_errc::unpaired_high_surrogate;
+        }
+        if (os_ != nullptr)
+        {
+            os_->flush();
+        }
+        else
+        {
+            sink_->flush();
+        }
+    }
+
+    void convert(const CharT* s, size_t length)
+    {
+        if (ec_)
+        {
+            return;
+        }
+        bytes_.resize(detail::max_utf8_length<CharT>(length));
+        auto result = detail::wide_to_utf8(s, s + length, bytes_.data());
+        if (result.ec == unicons::conv_errc::source_exhausted)
+        {
+            pending_ = *result.it;
+        }
+        else if (result.ec != unicons::conv_errc())
+        {
+            ec_ = result.ec;
+        }
+        if (os_ != nullptr)
+        {
+            os_->write(bytes_.data(), result.length);
+        }
+        else
+        {
+            sink_->write(bytes_.data(), result.length);
+        }
+    }
+};
+
+#if !defined(_WIN32)
+
+// Writes to a file descriptor. A full buffer followed by a long string is written
+// with a single writev. The sink does not close the descriptor. Serializers cannot
+// report write errors, so the first one is kept and can be checked with error()
+// when serialization is done; output after an error is discarded.
+
+class fd_sink : public basic_output_sink<char>
+{
+    int fd_;
+    std::error_code ec_;
+public:
+    explicit fd_sink(int fd)
+        : fd_(fd)
+    {
+    }
+
+    std::error_code error() const
+    {
+        return ec_;
+    }
+
+private:
+    void do_write(const char* s, size_t length) override
+    {
+        while (length > 0 && !ec_)
+        {
+            ssize_t n = ::write(fd_, s, length);
+            if (n < 0)
+            {
+                if (errno != EINTR)
+                {
+                    ec_ = std::error_code(errno, std::system_category());
+                }
+                continue;
+            }
+            if (n == 0)
+            {
+                // Nothing written without an error would otherwise be retried forever
+                ec_ = std::make_error_code(std::errc::io_error);
+                return;
+            }
+            s += n;
+            length -= static_cast<size_t>(n);
+        }
+    }
+
+    void do_write(const char* s1, size_t length1, const char* s2, size_t length2) override
+    {
+        if (ec_)
+        {
+            return;
+        }
+        struct iovec iov[2];
+        iov[0].iov_base = const_cast<char*>(s1);
+        iov[0].iov_len = length1;
+        iov[1].iov_base = const_cast<char*>(s2);
+        iov[1].iov_len = length2;
+
+        ssize_t n;
+        do
+        {
+            n = ::writev(fd_, iov, 2);
+        }
+        while (n < 0 && errno == EINTR);
+        if (n < 0)
+        {
+            ec_ = std::error_code(errno, std::system_category());
+            return;
+        }
+        // Finish a partial write
+        size_t written = static_cast<size_t>(n);
+        if (written < length1)
+        {
+            do_write(s1 + written, length1 - written);
+            do_write(s2, length2);
+        }
+        else
+        {
+            do_write(s2 + (written - length1), length2 - (written - length1));
+        }
+    }
+};
+
+#endif
+
+typedef basic_output_sink<char> output_sink;
+typedef basic_output_sink<wchar_t> woutput_sink;
+
+typedef basic_string_sink<std::string> string_sink;
+typedef basic_string_sink<std::wstring> wstring_sink;
+
+typedef basic_buffer_sink<char> buffer_sink;
+typedef basic_buffer_sink<wchar_t> wbuffer_sink;
+
+typedef basic_counting_sink<char> counting_sink;
+typedef basic_counting_sink<wchar_t> wcounting_sink;
+
+typedef basic_callback_sink<char> callback_sink;
+typedef basic_callback_sink<wchar_t> wcallback_sink;
+
+typedef basic_utf8_sink<wchar_t> wutf8_sink;
+
+}
+
+#endif
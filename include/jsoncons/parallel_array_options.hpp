@@ -0,0 +1,62 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_PARALLEL_ARRAY_OPTIONS_HPP
+#define JSONCONS_PARALLEL_ARRAY_OPTIONS_HPP
+
+#include <cstddef>
+#include <thread>
+#include <algorithm>
+
+namespace jsoncons {
+
+// Opts in to reading or writing the elements of a large array on more than one thread.
+// The elements are split into chunks of about chunk_size characters or bytes, which up to
+// max_threads workers parse or serialize.
+
+class parallel_array_options
+{
+    size_t max_threads_;
+    size_t chunk_size_;
+public:
+    static const size_t default_chunk_size = 1024*1024;
+
+    parallel_array_options()
+        : max_threads_((std::max)(std::thread::hardware_concurrency(), 1u)),
+          chunk_size_(default_chunk_size)
+    {
+    }
+
+//  Accessors
+
+    size_t max_threads() const
+    {
+        return max_threads_;
+    }
+
+    size_t chunk_size() const
+    {
+        return chunk_size_;
+    }
+
+//  Modifiers
+
+    parallel_array_options& max_threads(size_t value)
+    {
+        max_threads_ = value;
+        return *this;
+    }
+
+    parallel_array_options& chunk_size(size_t value)
+    {
+        chunk_size_ = value;
+        return *this;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,378 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_PARALLEL_ARRAY_READER_HPP
+#define JSONCONS_PARALLEL_ARRAY_READER_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <exception>
+#include <algorithm>
+#include <system_error>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/parallel_array_options.hpp>
+#include <jsoncons/json_error_category.hpp>
+#include <jsoncons/parse_error_handler.hpp>
+#include <jsoncons/detail/mapped_file.hpp>
+#include <jsoncons/detail/parallel_workers.hpp>
+#include <jsoncons/detail/string_scan.hpp>
+#include <jsoncons/detail/unicode_traits.hpp>
+
+namespace jsoncons {
+
+// Reads a JSON text that is one large array, from a memory mapped file or a buffer the
+// caller owns. A pre-scan on the calling thread tracks the nesting depth, skipping over
+// strings and their escapes, to find the commas between the elements of the array, and
+// ends a chunk at the first of these after every chunk_size characters. The workers
+// parse the elements of a chunk one at a time, each with Json::parse, which reuses a
+// parser and decoder per thread, and the calling thread passes the values on in order.
+// Without parallel_array_options, when the text is no larger than one chunk, or when it
+// is not an array, the text is parsed on the calling thread.
+
+template <class Json>
+class parallel_array_reader
+{
+public:
+    typedef typename Json::char_type char_type;
+    typedef typename Json::string_view_type string_view_type;
+private:
+    struct chunk
+    {
+        const char_type* first;
+        const char_type* last;
+        std::vector<Json> values;
+
+        // An error, at a line and column counted from the start of the element it is in
+        std::exception_ptr error;
+        std::error_code ec;
+        const char_type* element;
+        size_t line;
+        size_t column;
+
+        chunk(const char_type* first, const char_type* last)
+            : first(first), last(last), element(nullptr), line(0), column(0)
+        {
+        }
+    };
+
+    std::error_code open_ec_;
+    std::unique_ptr<detail::mapped_file> file_;
+    const char_type* data_;
+    size_t length_;
+    parallel_array_options options_;
+    bool parallel_;
+
+    // Noncopyable and nonmoveable
+    parallel_array_reader(const parallel_array_reader&) = delete;
+    parallel_array_reader& operator=(const parallel_array_reader&) = delete;
+
+public:
+    parallel_array_reader(const std::string& filename)
+        : file_(new detail::mapped_file(filename, open_ec_)),
+          parallel_(false)
+    {
+        init_mapping();
+    }
+
+    parallel_array_reader(const std::string& filename, const parallel_array_options& options)
+        : file_(new detail::mapped_file(filename, open_ec_)),
+          options_(options),
+          parallel_(true)
+    {
+        init_mapping();
+    }
+
+    parallel_array_reader(const char_type* data, size_t length)
+        : data_(data), length_(length),
+          parallel_(false)
+    {
+    }
+
+    parallel_array_reader(const char_type* data, size_t length, const parallel_array_options& options)
+        : data_(data), length_(length),
+          options_(options),
+          parallel_(true)
+    {
+    }
+
+    // The error the file could not be opened or mapped with, if any
+    std::error_code open_error() const
+    {
+        return open_ec_;
+    }
+
+    // Calls f with each element of the array, in order, as a Json&&, or once with the
+    // whole value if the text is not an array. Throws parse_error, with the line and
+    // column in the whole text, for the first element that fails to parse, after passing
+    // on the elements before it.
+    template <class Function>
+    void read(Function f)
+    {
+        std::vector<chunk> chunks;
+        const size_t workers = plan(chunks);
+        if (workers <= 1)
+        {
+            Json val = Json::parse(string_view_type(data_, length_));
+            if (val.is_array())
+            {
+                for (auto& element : val.array_range())
+                {
+                    f(std::move(element));
+                }
+            }
+            else
+            {
+                f(std::move(val));
+            }
+            return;
+        }
+        read_ordered(chunks, workers, f);
+    }
+
+    // Returns the whole value, an array unless the text is not one
+    Json read()
+    {
+        std::vector<chunk> chunks;
+        const size_t workers = plan(chunks);
+        if (workers <= 1)
+        {
+            return Json::parse(string_view_type(data_, length_));
+        }
+        Json result = typename Json::array();
+        auto add = [&result](Json&& val){result.add(std::move(val));};
+        read_ordered(chunks, workers, add);
+        return result;
+    }
+
+private:
+    // Splits the text into chunks, and returns how many workers to parse them with, one
+    // meaning the calling thread parses the whole text
+    size_t plan(std::vector<chunk>& chunks) const
+    {
+        if (open_ec_)
+        {
+            throw parse_error(json_parser_errc::source_error,0,0);
+        }
+        if (!parallel_ || !split(chunks))
+        {
+            return 1;
+        }
+        return (std::min)(options_.max_threads(), chunks.size());
+    }
+
+    void init_mapping()
+    {
+        data_ = reinterpret_cast<const char_type*>(file_->data());
+        length_ = file_->size()/sizeof(char_type);
+    }
+
+    // Returns the first comma or closing bracket at the depth of p, which is the start
+    // of an element or inside one, or last if there is none before it
+    static const char_type* next_separator(const char_type* p, const char_type* last)
+    {
+        size_t depth = 0;
+        while (p < last)
+        {
+            switch (*p)
+            {
+                case '\"':
+                    for (++p; p < last; )
+                    {
+                        p = detail::find_one_of<char_type>(p, last, '\"', '\\', '\"', '\\');
+                        if (p < last && *p == '\\')
+                        {
+                            p += 2;
+                        }
+                        else
+                        {
+                            break;
+                        }
+                    }
+                    if (p >= last)
+                    {
+                        return last;
+                    }
+                    break;
+                case '[':
+                case '{':
+                    ++depth;
+                    break;
+                case ']':
+                case '}':
+                    if (depth == 0)
+                    {
+                        return p;
+                    }
+                    --depth;
+                    break;
+                case ',':
+                    if (depth == 0)
+                    {
+                        return p;
+                    }
+                    break;
+                default:
+                    break;
+            }
+            ++p;
+        }
+        return last;
+    }
+
+    // Splits the elements of the array into chunks, each ending at the separator after
+    // its last element. Returns false if the text is not an array whose brackets balance,
+    // or if it is no larger than one chunk, leaving the calling thread to parse it and
+    // report any error.
+    bool split(std::vector<chunk>& chunks) const
+    {
+        const char_type* p = data_;
+        const char_type* end = data_ + length_;
+        auto result = unicons::skip_bom(p, end);
+        if (result.ec != unicons::encoding_errc())
+        {
+            return false;
+        }
+        p = skip_whitespace(result.it, end);
+        if (p == end || *p != '[')
+        {
+            return false;
+        }
+        ++p;
+        const size_t size = (std::max)(options_.chunk_size(), size_t(1));
+        const char_type* first = p;
+        for (;;)
+        {
+            const char_type* q = next_separator(p, end);
+            if (q == end || *q == '}')
+            {
+                return false;
+            }
+            if (*q == ']')
+            {
+                if (skip_whitespace(q + 1, end) != end)
+                {
+                    return false;
+                }
+                chunks.emplace_back(first, q);
+                break;
+            }
+            if (static_cast<size_t>(q - first) >= size)
+            {
+                chunks.emplace_back(first, q);
+                first = q + 1;
+            }
+            p = q + 1;
+        }
+        return chunks.size() > 1;
+    }
+
+    // Parses the elements of c, until one fails
+    static void parse_chunk(chunk& c)
+    {
+        const char_type* p = c.first;
+        for (;;)
+        {
+            const char_type* q = next_separator(p, c.last);
+            if (skip_whitespace(p, q) == q)
+            {
+                // A comma with no element before it, or after it and before the closing bracket
+                c.ec = json_parser_errc::expected_value;
+                c.element = q;
+                c.line = 1;
+                c.column = 1;
+                return;
+            }
+            try
+            {
+                c.values.push_back(Json::parse(string_view_type(p, q - p)));
+            }
+            catch (const parse_error& e)
+            {
+                c.ec = e.code();
+                c.element = p;
+                c.line = e.line_number();
+                c.column = e.column_number();
+                return;
+            }
+            catch (...)
+            {
+                c.error = std::current_exception();
+                return;
+            }
+            if (q == c.last)
+            {
+                return;
+            }
+            p = q + 1;
+        }
+    }
+
+    template <class Function>
+    void read_ordered(std::vector<chunk>& chunks, size_t workers, Function& f)
+    {
+        size_t failed = chunks.size();
+        auto produce = [&](size_t i)
+        {
+            parse_chunk(chunks[i]);
+        };
+        auto consume = [&](size_t i) -> bool
+        {
+            std::vector<Json> values;
+            values.swap(chunks[i].values);
+            for (auto& val : values)
+            {
+                f(std::move(val));
+            }
+            if (chunks[i].error || chunks[i].ec)
+            {
+                failed = i;
+            }
+            return failed == chunks.size();
+        };
+        detail::run_ordered(chunks.size(), workers, produce, consume);
+        if (failed != chunks.size())
+        {
+            throw_if_error(chunks[failed]);
+        }
+    }
+
+    void throw_if_error(const chunk& c) const
+    {
+        if (c.error)
+        {
+            std::rethrow_exception(c.error);
+        }
+        if (c.ec)
+        {
+            const size_t lines_before = static_cast<size_t>(std::count(data_, c.element, '\n'));
+            size_t column = c.column;
+            if (c.line == 1)
+            {
+                const char_type* line_start = c.element;
+                while (line_start > data_ && *(line_start - 1) != '\n')
+                {
+                    --line_start;
+                }
+                column += static_cast<size_t>(c.element - line_start);
+            }
+            throw parse_error(c.ec, lines_before + c.line, column);
+        }
+    }
+
+    static const char_type* skip_whitespace(const char_type* p, const char_type* last)
+    {
+        while (p < last && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+        {
+            ++p;
+        }
+        return p;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,138 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_PARALLEL_ARRAY_WRITER_HPP
+#define JSONCONS_PARALLEL_ARRAY_WRITER_HPP
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <ostream>
+#include <jsoncons/json.hpp>
+#include <jsoncons/parallel_array_options.hpp>
+#include <jsoncons/detail/parallel_workers.hpp>
+
+namespace jsoncons {
+
+namespace detail {
+
+// Serializes the elements of an array in chunks on more than one thread, each chunk into
+// a Buffer of its own, and passes the buffers on in order on the calling thread.
+//
+// The calling thread first encodes a sample of up to sample_length elements, and from its
+// size takes the number of elements in a chunk of about chunk_size units. If the sample
+// is the whole array, or the array is no larger than one chunk, the calling thread
+// encodes it all. Otherwise up to max_threads workers encode the rest a chunk at a time,
+// with run_ordered.
+//
+// encode(first, last, buffer) appends the elements [first,last) to the buffer, size(buffer)
+// returns its size, and write(buffer) passes it on. An exception thrown by encode or write
+// stops the workers and is rethrown once they have finished.
+
+template <class Buffer, class Encode, class Size, class Write>
+void write_chunks_ordered(size_t length, const parallel_array_options& options,
+                          Encode encode, Size size, Write write)
+{
+    const size_t sample_length = (std::min)(length, size_t(16));
+    Buffer sample;
+    encode(0, sample_length, sample);
+    const size_t sample_size = (std::max)(size(sample), size_t(1));
+    write(sample);
+    Buffer().swap(sample);
+    if (sample_length == length)
+    {
+        return;
+    }
+    const size_t chunk_length = (std::max)(options.chunk_size()*sample_length/sample_size, size_t(1));
+    const size_t chunk_count = (length - sample_length + chunk_length - 1)/chunk_length;
+    const size_t workers = (std::min)(options.max_threads(), chunk_count);
+    if (workers <= 1)
+    {
+        Buffer rest;
+        encode(sample_length, length, rest);
+        write(rest);
+        return;
+    }
+
+    std::vector<Buffer> chunks(chunk_count);
+    auto produce = [&](size_t i)
+    {
+        const size_t first = sample_length + i*chunk_length;
+        encode(first, (std::min)(first + chunk_length, length), chunks[i]);
+    };
+    auto consume = [&](size_t i)
+    {
+        write(chunks[i]);
+        Buffer().swap(chunks[i]);
+        return true;
+    };
+    run_ordered(chunk_count, workers, produce, consume);
+}
+
+}
+
+// Writes val as compact JSON text, as val.dump(os, options) does. If val is an array, its
+// elements are serialized in chunks on up to parallel.max_threads() threads, each chunk
+// into a string of its own with the same options, and the strings written to os in order.
+// Each chunk is written as the text of an array by a serializer of its own, and is passed
+// on without its brackets.
+
+template <class Json>
+void parallel_dump(const Json& val,
+                   std::basic_ostream<typename Json::char_type>& os,
+                   const basic_serialization_options<typename Json::char_type>& options,
+                   const parallel_array_options& parallel)
+{
+    typedef typename Json::char_type char_type;
+    typedef std::basic_string<char_type> buffer_type;
+
+    if (!val.is_array() || val.size() == 0)
+    {
+        val.dump(os, options);
+        return;
+    }
+
+    auto elements = val.array_range();
+    auto encode = [&elements,&options](size_t first, size_t last, buffer_type& buffer)
+    {
+        basic_string_sink<buffer_type> sink(buffer);
+        basic_json_serializer<char_type> serializer(sink, options);
+        serializer.begin_json();
+        serializer.begin_array();
+        for (auto it = elements.begin() + first; it != elements.begin() + last; ++it)
+        {
+            it->dump_fragment(serializer);
+        }
+        serializer.end_array();
+        serializer.end_json();
+    };
+    auto size = [](const buffer_type& buffer)
+    {
+        return buffer.size();
+    };
+    bool first_chunk = true;
+    auto write = [&os,&first_chunk](const buffer_type& buffer)
+    {
+        os.put(first_chunk ? '[' : ',');
+        os.write(buffer.data() + 1, buffer.size() - 2);
+        first_chunk = false;
+    };
+    detail::write_chunks_ordered<buffer_type>(val.size(), parallel, encode, size, write);
+    os.put(']');
+    os.flush();
+}
+
+template <class Json>
+void parallel_dump(const Json& val,
+                   std::basic_ostream<typename Json::char_type>& os,
+                   const parallel_array_options& parallel)
+{
+    parallel_dump(val, os, basic_serialization_options<typename Json::char_type>(), parallel);
+}
+
+}
+
+#endif
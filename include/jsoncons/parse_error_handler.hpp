@@ -99,9 +99,31 @@ public:
         return do_column_number();
     }
 
+    // The number of characters consumed since the start of the text, or 0 if not known
+    size_t offset() const
+    {
+        return do_offset();
+    }
+
+    // Called from a name event, the value of the member is skipped, and the next event is
+    // for the member after it or the end of the object. Called from a begin_object or 
+    // begin_array event, the rest of the object or array is skipped, and the next event is
+    // its end_object or end_array. Elsewhere, or for a source that can't skip, it does nothing.
+    void skip_value() const
+    {
+        do_skip_value();
+    }
+
 private:
     virtual size_t do_line_number() const = 0;
     virtual size_t do_column_number() const = 0;
+    virtual size_t do_offset() const
+    {
+        return 0;
+    }
+    virtual void do_skip_value() const
+    {
+    }
 };
 
 class parse_error_handler
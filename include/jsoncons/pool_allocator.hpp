@@ -0,0 +1,403 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_POOL_ALLOCATOR_HPP
+#define JSONCONS_POOL_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <type_traits>
+#include <jsoncons/detail/jsoncons_config.hpp>
+
+namespace jsoncons {
+
+namespace detail {
+
+// A lock that cannot fail, for the free lists, which deallocation takes on a noexcept path.
+// It is held only while a few links are moved.
+class pool_spin_lock
+{
+    std::atomic_flag flag_;
+public:
+    pool_spin_lock() JSONCONS_NOEXCEPT
+    {
+        flag_.clear();
+    }
+
+    void lock() JSONCONS_NOEXCEPT
+    {
+        while (flag_.test_and_set(std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    void unlock() JSONCONS_NOEXCEPT
+    {
+        flag_.clear(std::memory_order_release);
+    }
+};
+
+}
+
+// A pool of blocks in size classes of 16 bytes, up to 512 bytes, which covers the variant
+// holders, the array and object headers, the short strings and the small member vectors of
+// basic_json. Blocks are carved from 64K chunks, and a freed block goes on the free list of
+// its size class, to be reused by the next allocation of that class. Chunks are kept for the
+// life of the process.
+//
+// Each thread keeps a cache of free blocks for each size class, so that most allocations and
+// deallocations take no lock. A cache that grows past its limit returns half its blocks to the
+// free lists shared by all threads, which is also where the blocks freed on one thread and
+// allocated on another pass. A thread returns its cache when it exits, and blocks it frees
+// after that, from the destructors of other thread_local objects, go straight to the free lists.
+
+class pool_resource
+{
+public:
+    static const size_t granularity = 16;
+    static const size_t max_pooled_size = 512;
+    static const size_t size_class_count = max_pooled_size / granularity;
+private:
+    static const size_t chunk_size = 65536;
+
+    struct free_block
+    {
+        free_block* next;
+    };
+
+    struct size_class
+    {
+        detail::pool_spin_lock guard;
+        free_block* free_list;
+        size_t free_count;
+        char* p;
+        char* last;
+
+        size_class()
+            : free_list(nullptr), free_count(0), p(nullptr), last(nullptr)
+        {
+        }
+    };
+
+    struct thread_cache
+    {
+        pool_resource& pool;
+        bool& destroyed;
+        free_block* free_lists[size_class_count];
+        size_t counts[size_class_count];
+
+        thread_cache(pool_resource& owner, bool& destroyed)
+            : pool(owner), destroyed(destroyed)
+        {
+            for (size_t i = 0; i < size_class_count; ++i)
+            {
+                free_lists[i] = nullptr;
+                counts[i] = 0;
+            }
+        }
+
+        ~thread_cache()
+        {
+            release();
+            destroyed = true;
+        }
+
+        void* allocate(size_t index)
+        {
+            if (JSONCONS_UNLIKELY(free_lists[index] == nullptr))
+            {
+                counts[index] = pool.take(index, batch_count(index), free_lists[index]);
+            }
+            free_block* b = free_lists[index];
+            free_lists[index] = b->next;
+            --counts[index];
+            return b;
+        }
+
+        void deallocate(void* p, size_t index)
+        {
+            free_block* b = static_cast<free_block*>(p);
+            b->next = free_lists[index];
+            free_lists[index] = b;
+            if (JSONCONS_UNLIKELY(++counts[index] > 2*batch_count(index)))
+            {
+                give(index, batch_count(index));
+            }
+        }
+
+        void release()
+        {
+            for (size_t i = 0; i < size_class_count; ++i)
+            {
+                give(i, counts[i]);
+            }
+        }
+
+        // Returns the first count blocks of a free list to the pool
+        void give(size_t index, size_t count)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+            free_block* first = free_lists[index];
+            free_block* last = first;
+            for (size_t i = 1; i < count; ++i)
+            {
+                last = last->next;
+            }
+            free_lists[index] = last->next;
+            counts[index] -= count;
+            pool.put(index, first, last, count);
+        }
+
+        // The blocks moved between a cache and the pool at a time, about 16K
+        static size_t batch_count(size_t index)
+        {
+            size_t n = 16384 / ((index + 1)*granularity);
+            return n < 8 ? 8 : n;
+        }
+    };
+
+    size_class classes_[size_class_count];
+    std::mutex chunks_mutex_;
+    void* chunks_;
+    size_t bytes_reserved_;
+
+    // Noncopyable and nonmoveable
+    pool_resource(const pool_resource&) = delete;
+    pool_resource& operator=(const pool_resource&) = delete;
+
+    pool_resource()
+        : chunks_(nullptr), bytes_reserved_(0)
+    {
+    }
+public:
+    // The pool shared by all pool_allocators. It is never destroyed, so that threads
+    // that exit during static destruction can still return their caches.
+    static pool_resource& instance()
+    {
+        static pool_resource* pool = new pool_resource();
+        return *pool;
+    }
+
+    static size_t size_class_index(size_t n)
+    {
+        return n == 0 ? 0 : (n - 1) / granularity;
+    }
+
+    void* allocate(size_t n)
+    {
+        if (n > max_pooled_size)
+        {
+            return ::operator new(n);
+        }
+#if !defined(JSONCONS_NO_THREAD_LOCAL)
+        thread_cache* c = cache();
+        if (JSONCONS_LIKELY(c != nullptr))
+        {
+            return c->allocate(size_class_index(n));
+        }
+#endif
+        free_block* b;
+        take(size_class_index(n), 1, b);
+        return b;
+    }
+
+    void deallocate(void* p, size_t n) JSONCONS_NOEXCEPT
+    {
+        if (n > max_pooled_size)
+        {
+            ::operator delete(p);
+            return;
+        }
+#if !defined(JSONCONS_NO_THREAD_LOCAL)
+        thread_cache* c = cache();
+        if (JSONCONS_LIKELY(c != nullptr))
+        {
+            c->deallocate(p, size_class_index(n));
+            return;
+        }
+#endif
+        free_block* b = static_cast<free_block*>(p);
+        put(size_class_index(n), b, b, 1);
+    }
+
+    // Returns the free blocks cached by the calling thread to the pool, for a thread that
+    // has freed many values and will not allocate again for a while
+    void release_thread_cache()
+    {
+#if !defined(JSONCONS_NO_THREAD_LOCAL)
+        thread_cache* c = cache();
+        if (c != nullptr)
+        {
+            c->release();
+        }
+#endif
+    }
+
+    // The bytes of the chunks taken from the system
+    size_t bytes_reserved()
+    {
+        std::lock_guard<std::mutex> lock(chunks_mutex_);
+        return bytes_reserved_;
+    }
+
+    // The blocks of a size class in the free lists shared by all threads, not counting
+    // those cached by threads
+    size_t free_block_count(size_t index)
+    {
+        std::lock_guard<detail::pool_spin_lock> lock(classes_[index].guard);
+        return classes_[index].free_count;
+    }
+private:
+#if !defined(JSONCONS_NO_THREAD_LOCAL)
+    // The calling thread's cache, or null once it has been destroyed. The flag has no
+    // destructor, so it can be read until the thread ends.
+    thread_cache* cache()
+    {
+        static thread_local bool destroyed = false;
+        if (JSONCONS_UNLIKELY(destroyed))
+        {
+            return nullptr;
+        }
+        static thread_local thread_cache c(*this, destroyed);
+        return &c;
+    }
+#endif
+
+    // Takes up to count blocks of a size class, at least one, and returns how many
+    size_t take(size_t index, size_t count, free_block*& first)
+    {
+        size_class& sc = classes_[index];
+        const size_t size = (index + 1)*granularity;
+
+        std::lock_guard<detail::pool_spin_lock> lock(sc.guard);
+        first = nullptr;
+        size_t n = 0;
+        while (n < count && sc.free_list != nullptr)
+        {
+            free_block* b = sc.free_list;
+            sc.free_list = b->next;
+            b->next = first;
+            first = b;
+            ++n;
+        }
+        sc.free_count -= n;
+        while (n < count)
+        {
+            if (static_cast<size_t>(sc.last - sc.p) < size)
+            {
+                if (n > 0)
+                {
+                    break;
+                }
+                sc.p = new_chunk();
+                sc.last = sc.p + (chunk_size - granularity) / size * size;
+            }
+            free_block* b = reinterpret_cast<free_block*>(sc.p);
+            sc.p += size;
+            b->next = first;
+            first = b;
+            ++n;
+        }
+        return n;
+    }
+
+    void put(size_t index, free_block* first, free_block* last, size_t count)
+    {
+        size_class& sc = classes_[index];
+        std::lock_guard<detail::pool_spin_lock> lock(sc.guard);
+        last->next = sc.free_list;
+        sc.free_list = first;
+        sc.free_count += count;
+    }
+
+    // A chunk begins with a link to the previous chunk, and its blocks start granularity
+    // bytes in
+    char* new_chunk()
+    {
+        void* chunk = std::malloc(chunk_size);
+        if (chunk == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        std::lock_guard<std::mutex> lock(chunks_mutex_);
+        *static_cast<void**>(chunk) = chunks_;
+        chunks_ = chunk;
+        bytes_reserved_ += chunk_size;
+        return static_cast<char*>(chunk) + granularity;
+    }
+};
+
+// An allocator that allocates from the pool_resource. Use it as the Allocator template
+// parameter of basic_json (e.g. basic_json<char,sorted_policy,pool_allocator<char>>) for
+// documents that live long and are modified often. It is default constructible, and all
+// pool_allocators are equal, so values may be built on one thread and destroyed on another.
+
+template <class T>
+class pool_allocator
+{
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type is_always_equal;
+
+    template <class U>
+    struct rebind
+    {
+        typedef pool_allocator<U> other;
+    };
+
+    pool_allocator() JSONCONS_NOEXCEPT
+    {
+    }
+
+    template <class U>
+    pool_allocator(const pool_allocator<U>&) JSONCONS_NOEXCEPT
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        static_assert(JSONCONS_ALIGNOF(T) <= pool_resource::granularity, "pool_allocator blocks are aligned to 16 bytes");
+        return static_cast<T*>(pool_resource::instance().allocate(n*sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) JSONCONS_NOEXCEPT
+    {
+        pool_resource::instance().deallocate(p, n*sizeof(T));
+    }
+
+    template <class U>
+    bool operator==(const pool_allocator<U>&) const JSONCONS_NOEXCEPT
+    {
+        return true;
+    }
+
+    template <class U>
+    bool operator!=(const pool_allocator<U>&) const JSONCONS_NOEXCEPT
+    {
+        return false;
+    }
+};
+
+}
+
+#endif
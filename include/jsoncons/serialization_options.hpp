@@ -17,6 +17,7 @@
 #include <cwchar>
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/jsoncons_utilities.hpp>
+#include <jsoncons/detail/string_scan.hpp>
 
 namespace jsoncons {
 
@@ -239,6 +240,23 @@ public:
     }
 };
 
+namespace detail {
+
+// Writes \u and the four hex digits of cp, and returns the position after them
+template <class CharT>
+CharT* write_codepoint_escape(uint32_t cp, CharT* p)
+{
+    *p++ = '\\';
+    *p++ = 'u';
+    *p++ = to_hex_character(cp >> 12 & 0x000F);
+    *p++ = to_hex_character(cp >> 8  & 0x000F);
+    *p++ = to_hex_character(cp >> 4  & 0x000F);
+    *p++ = to_hex_character(cp     & 0x000F);
+    return p;
+}
+
+}
+
 template<class CharT>
 void escape_string(const CharT* s,
                    size_t length,
@@ -247,46 +265,61 @@ void escape_string(const CharT* s,
 {
     const CharT* begin = s;
     const CharT* end = s + length;
+    const bool escape_solidus = options.escape_solidus();
+    const bool escape_all_non_ascii = options.escape_all_non_ascii();
     for (const CharT* it = begin; it != end; ++it)
     {
+        // Copy the run of characters that need no escaping in one write
+        const CharT* run_end = jsoncons::detail::find_escaped_char(it, end, escape_solidus, escape_all_non_ascii);
+        if (run_end != it)
+        {
+            os.write(it, run_end - it);
+            it = run_end;
+            if (it == end)
+            {
+                break;
+            }
+        }
+        // An escape is at most two \uXXXX sequences
+        CharT* p = os.reserve(12);
         CharT c = *it;
         switch (c)
         {
         case '\\':
-            os.put('\\'); 
-            os.put('\\');
+            *p++ = '\\';
+            *p++ = '\\';
             break;
         case '"':
-            os.put('\\'); 
-            os.put('\"');
+            *p++ = '\\';
+            *p++ = '\"';
             break;
         case '\b':
-            os.put('\\'); 
-            os.put('b');
+            *p++ = '\\';
+            *p++ = 'b';
             break;
         case '\f':
-            os.put('\\');
-            os.put('f');
+            *p++ = '\\';
+            *p++ = 'f';
             break;
         case '\n':
-            os.put('\\');
-            os.put('n');
+            *p++ = '\\';
+            *p++ = 'n';
             break;
         case '\r':
-            os.put('\\');
-            os.put('r');
+            *p++ = '\\';
+            *p++ = 'r';
             break;
         case '\t':
-            os.put('\\');
-            os.put('t');
+            *p++ = '\\';
+            *p++ = 't';
             break;
         default:
-            if (options.escape_solidus() && c == '/')
+            if (escape_solidus && c == '/')
             {
-                os.put('\\');
-                os.put('/');
+                *p++ = '\\';
+                *p++ = '/';
             }
-            else if (is_control_character(c) || options.escape_all_non_ascii())
+            else if (is_control_character(c) || escape_all_non_ascii)
             {
                 // convert utf8 to codepoint
                 unicons::sequence_generator<const CharT*> g(it,end,unicons::conv_flags::strict);
@@ -304,40 +337,26 @@ void escape_string(const CharT* s,
                         uint32_t first = (cp >> 10) + 0xD800;
                         uint32_t second = ((cp & 0x03FF) + 0xDC00);
 
-                        os.put('\\');
-                        os.put('u');
-                        os.put(to_hex_character(first >> 12 & 0x000F));
-                        os.put(to_hex_character(first >> 8  & 0x000F));
-                        os.put(to_hex_character(first >> 4  & 0x000F));
-                        os.put(to_hex_character(first     & 0x000F));
-                        os.put('\\');
-                        os.put('u');
-                        os.put(to_hex_character(second >> 12 & 0x000F));
-                        os.put(to_hex_character(second >> 8  & 0x000F));
-                        os.put(to_hex_character(second >> 4  & 0x000F));
-                        os.put(to_hex_character(second     & 0x000F));
+                        p = detail::write_codepoint_escape(first, p);
+                        p = detail::write_codepoint_escape(second, p);
                     }
                     else
                     {
-                        os.put('\\');
-                        os.put('u');
-                        os.put(to_hex_character(cp >> 12 & 0x000F));
-                        os.put(to_hex_character(cp >> 8  & 0x000F));
-                        os.put(to_hex_character(cp >> 4  & 0x000F));
-                        os.put(to_hex_character(cp     & 0x000F));
+                        p = detail::write_codepoint_escape(cp, p);
                     }
                 }
                 else
                 {
-                    os.put(c);
+                    *p++ = c;
                 }
             }
             else
             {
-                os.put(c);
+                *p++ = c;
             }
             break;
         }
+        os.commit(p);
     }
 }
 
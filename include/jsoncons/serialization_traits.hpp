@@ -18,6 +18,8 @@
 #include <array>
 #include <type_traits>
 #include <memory>
+#include <vector>
+#include <algorithm>
 #include <jsoncons/json_output_handler.hpp>
 #include <jsoncons/serialization_options.hpp>
 #include <jsoncons/json_serializer.hpp>
@@ -168,6 +170,111 @@ struct serialization_traits<typename type_wrapper<CharT>::const_pointer_type>
     }
 };*/
 
+namespace detail { namespace streaming {
+
+// Numbers held contiguously, written through the handler's bulk functions a chunk at a time
+
+template <class T>
+struct is_number_like : std::integral_constant<bool, detail::is_integer_like<T>::value ||
+                                                     detail::is_uinteger_like<T>::value ||
+                                                     detail::is_floating_point_like<T>::value> {};
+
+template <class T>
+struct is_contiguous_numbers : std::false_type {};
+
+template <class E, class Allocator>
+struct is_contiguous_numbers<std::vector<E,Allocator>> : is_number_like<E> {};
+
+template <class E, size_t N>
+struct is_contiguous_numbers<std::array<E,N>> : is_number_like<E> {};
+
+template <class CharT>
+void write_numbers(const int64_t* data, size_t length, basic_json_output_handler<CharT>& handler)
+{
+    handler.integer_values(data, length);
+}
+
+template <class CharT>
+void write_numbers(const uint64_t* data, size_t length, basic_json_output_handler<CharT>& handler)
+{
+    handler.uinteger_values(data, length);
+}
+
+template <class CharT>
+void write_numbers(const double* data, size_t length, basic_json_output_handler<CharT>& handler)
+{
+    handler.double_values(data, length);
+}
+
+template <class U, class T, class CharT>
+void write_numbers_as(const T* data, size_t length, basic_json_output_handler<CharT>& handler, std::true_type)
+{
+    write_numbers(data, length, handler);
+}
+
+template <class U, class T, class CharT>
+void write_numbers_as(const T* data, size_t length, basic_json_output_handler<CharT>& handler, std::false_type)
+{
+    const size_t chunk_length = 256;
+    U buf[chunk_length];
+    for (size_t i = 0; i < length; i += chunk_length)
+    {
+        const size_t n = (std::min)(chunk_length, length - i);
+        for (size_t j = 0; j < n; ++j)
+        {
+            buf[j] = static_cast<U>(data[i+j]);
+        }
+        write_numbers(buf, n, handler);
+    }
+}
+
+// Numbers of type U are passed on in place, others converted to U a chunk at a time
+
+template <class U, class T, class CharT>
+void write_numbers_as(const T* data, size_t length, basic_json_output_handler<CharT>& handler)
+{
+    write_numbers_as<U>(data, length, handler, std::is_same<T,U>());
+}
+
+template <class T, class CharT>
+typename std::enable_if<detail::is_integer_like<T>::value>::type
+encode_numbers(const T* data, size_t length, basic_json_output_handler<CharT>& handler)
+{
+    write_numbers_as<int64_t>(data, length, handler);
+}
+
+template <class T, class CharT>
+typename std::enable_if<detail::is_uinteger_like<T>::value>::type
+encode_numbers(const T* data, size_t length, basic_json_output_handler<CharT>& handler)
+{
+    write_numbers_as<uint64_t>(data, length, handler);
+}
+
+template <class T, class CharT>
+typename std::enable_if<detail::is_floating_point_like<T>::value>::type
+encode_numbers(const T* data, size_t length, basic_json_output_handler<CharT>& handler)
+{
+    write_numbers_as<double>(data, length, handler);
+}
+
+template <class T, class CharT>
+void encode_elements(const T& val, basic_json_output_handler<CharT>& handler, std::true_type)
+{
+    encode_numbers(val.data(), val.size(), handler);
+}
+
+template <class T, class CharT>
+void encode_elements(const T& val, basic_json_output_handler<CharT>& handler, std::false_type)
+{
+    typedef typename std::iterator_traits<typename T::const_iterator>::value_type value_type;
+    for (auto it = std::begin(val); it != std::end(val); ++it)
+    {
+        serialization_traits<value_type>::encode(*it,handler);
+    }
+}
+
+}}
+
 // sequence container (except string and array)
 
 template<class T>
@@ -181,10 +288,7 @@ struct serialization_traits<T,
     static void encode(const T& val, basic_json_output_handler<CharT>& handler)
     {
         handler.begin_array();
-        for (auto it = std::begin(val); it != std::end(val); ++it)
-        {
-            serialization_traits<value_type>::encode(*it,handler);
-        }
+        detail::streaming::encode_elements(val, handler, detail::streaming::is_contiguous_numbers<T>());
         handler.end_array();
     }
 };
@@ -201,10 +305,7 @@ public:
     static void encode(const std::array<T, N>& val, basic_json_output_handler<CharT>& handler)
     {
         handler.begin_array();
-        for (auto it = std::begin(val); it != std::end(val); ++it)
-        {
-            serialization_traits<value_type>::encode(*it,handler);
-        }
+        detail::streaming::encode_elements(val, handler, detail::streaming::is_contiguous_numbers<std::array<T,N>>());
         handler.end_array();
     }
 };
@@ -0,0 +1,359 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_SHARED_KEY_HPP
+#define JSONCONS_SHARED_KEY_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <iterator>
+#include <ostream>
+#include <type_traits>
+#include <jsoncons/detail/jsoncons_config.hpp>
+#include <jsoncons/detail/type_traits_helper.hpp>
+
+namespace jsoncons {
+
+// An immutable string that shares its characters with its copies. The characters are held,
+// with a reference count and the length, in a single block, and copying a key only
+// increments the count. Used as the key_storage of shared_key_policy, a json_decoder that
+// interns keys gives every member with the same name the same block, so a document with
+// many records of the same shape holds each name once, and equal keys compare by address.
+// The count is atomic, keys may be copied and destroyed on different threads.
+
+template <class CharT, class CharTraits = std::char_traits<CharT>, class Allocator = std::allocator<CharT>>
+class basic_shared_key
+{
+    struct header
+    {
+        std::atomic<size_t> ref_count_;
+        size_t length_;
+
+        header(size_t length)
+            : ref_count_(1), length_(length)
+        {
+        }
+    };
+
+    union storage_unit
+    {
+        size_t count_;
+        void* p_;
+    };
+
+    typedef typename std::allocator_traits<Allocator>:: template rebind_alloc<storage_unit> storage_allocator_type;
+    typedef std::allocator_traits<storage_allocator_type> storage_traits;
+    typedef typename storage_traits::pointer storage_pointer;
+
+    // Derives from the allocator so that a stateless one takes no space
+    struct impl : storage_allocator_type
+    {
+        storage_pointer ptr_;
+
+        impl(const storage_allocator_type& a)
+            : storage_allocator_type(a), ptr_(nullptr)
+        {
+        }
+    };
+
+    impl impl_;
+public:
+    typedef CharT value_type;
+    typedef CharTraits traits_type;
+    typedef Allocator allocator_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef const CharT& reference;
+    typedef const CharT& const_reference;
+    typedef const CharT* pointer;
+    typedef const CharT* const_pointer;
+    typedef const CharT* iterator;
+    typedef const CharT* const_iterator;
+#if !defined(JSONCONS_HAS_STRING_VIEW)
+    typedef Basic_string_view_<CharT,CharTraits> string_view_type;
+#else
+    typedef std::basic_string_view<CharT,CharTraits> string_view_type;
+#endif
+
+    basic_shared_key()
+        : impl_(storage_allocator_type())
+    {
+    }
+
+    explicit basic_shared_key(const Allocator& a)
+        : impl_(storage_allocator_type(a))
+    {
+    }
+
+    basic_shared_key(const CharT* s, size_t length, const Allocator& a = Allocator())
+        : impl_(storage_allocator_type(a))
+    {
+        create(s, length);
+    }
+
+    basic_shared_key(const CharT* s, const Allocator& a = Allocator())
+        : impl_(storage_allocator_type(a))
+    {
+        create(s, CharTraits::length(s));
+    }
+
+    template <class ForwardIt, class = typename std::enable_if<!std::is_integral<ForwardIt>::value>::type>
+    basic_shared_key(ForwardIt first, ForwardIt last, const Allocator& a = Allocator())
+        : impl_(storage_allocator_type(a))
+    {
+        const size_t length = static_cast<size_t>(std::distance(first, last));
+        if (length > 0)
+        {
+            allocate(length);
+            std::copy(first, last, chars());
+            chars()[length] = 0;
+        }
+    }
+
+    template <class StringAllocator>
+    explicit basic_shared_key(const std::basic_string<CharT,CharTraits,StringAllocator>& s, const Allocator& a = Allocator())
+        : impl_(storage_allocator_type(a))
+    {
+        create(s.data(), s.length());
+    }
+
+    basic_shared_key(const basic_shared_key& other)
+        : impl_(storage_traits::select_on_container_copy_construction(other.impl_))
+    {
+        share(other);
+    }
+
+    // Shares other's characters if the allocators are equal, otherwise copies them
+    basic_shared_key(const basic_shared_key& other, const Allocator& a)
+        : impl_(storage_allocator_type(a))
+    {
+        if (static_cast<const storage_allocator_type&>(impl_) == static_cast<const storage_allocator_type&>(other.impl_))
+        {
+            share(other);
+        }
+        else
+        {
+            create(other.data(), other.length());
+        }
+    }
+
+    basic_shared_key(basic_shared_key&& other) JSONCONS_NOEXCEPT
+        : impl_(other.impl_)
+    {
+        other.impl_.ptr_ = nullptr;
+    }
+
+    basic_shared_key(basic_shared_key&& other, const Allocator& a)
+        : impl_(storage_allocator_type(a))
+    {
+        if (static_cast<const storage_allocator_type&>(impl_) == static_cast<const storage_allocator_type&>(other.impl_))
+        {
+            std::swap(impl_.ptr_, other.impl_.ptr_);
+        }
+        else
+        {
+            create(other.data(), other.length());
+        }
+    }
+
+    ~basic_shared_key()
+    {
+        release();
+    }
+
+    basic_shared_key& operator=(const basic_shared_key& other)
+    {
+        if (impl_.ptr_ != other.impl_.ptr_)
+        {
+            basic_shared_key temp(other, get_allocator());
+            swap(temp);
+        }
+        return *this;
+    }
+
+    basic_shared_key& operator=(basic_shared_key&& other)
+    {
+        if (this != &other)
+        {
+            basic_shared_key temp(std::move(other), get_allocator());
+            swap(temp);
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const
+    {
+        return allocator_type(static_cast<const storage_allocator_type&>(impl_));
+    }
+
+    const CharT* data() const
+    {
+        return impl_.ptr_ == nullptr ? empty_chars() : chars();
+    }
+
+    const CharT* c_str() const
+    {
+        return data();
+    }
+
+    size_t size() const
+    {
+        return impl_.ptr_ == nullptr ? 0 : get_header()->length_;
+    }
+
+    size_t length() const
+    {
+        return size();
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    const_iterator begin() const
+    {
+        return data();
+    }
+
+    const_iterator end() const
+    {
+        return data() + size();
+    }
+
+    // The number of keys that share these characters
+    size_t use_count() const
+    {
+        return impl_.ptr_ == nullptr ? 0 : get_header()->ref_count_.load(std::memory_order_relaxed);
+    }
+
+    // True if both keys share the same characters
+    bool shares_with(const basic_shared_key& other) const
+    {
+        return impl_.ptr_ == other.impl_.ptr_;
+    }
+
+    void swap(basic_shared_key& other) JSONCONS_NOEXCEPT
+    {
+        if (storage_traits::propagate_on_container_swap::value)
+        {
+            std::swap(static_cast<storage_allocator_type&>(impl_), static_cast<storage_allocator_type&>(other.impl_));
+        }
+        std::swap(impl_.ptr_, other.impl_.ptr_);
+    }
+
+    void shrink_to_fit()
+    {
+    }
+
+    int compare(const basic_shared_key& other) const
+    {
+        return impl_.ptr_ == other.impl_.ptr_ ? 0 : string_view_type(*this).compare(string_view_type(other));
+    }
+
+    operator string_view_type() const JSONCONS_NOEXCEPT
+    {
+        return string_view_type(data(), size());
+    }
+
+    friend bool operator==(const basic_shared_key& lhs, const basic_shared_key& rhs)
+    {
+        return lhs.impl_.ptr_ == rhs.impl_.ptr_ ||
+               (lhs.size() == rhs.size() && CharTraits::compare(lhs.data(), rhs.data(), lhs.size()) == 0);
+    }
+
+    friend bool operator!=(const basic_shared_key& lhs, const basic_shared_key& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    friend bool operator<(const basic_shared_key& lhs, const basic_shared_key& rhs)
+    {
+        return lhs.compare(rhs) < 0;
+    }
+
+    friend std::basic_ostream<CharT>& operator<<(std::basic_ostream<CharT>& os, const basic_shared_key& key)
+    {
+        os.write(key.data(), key.size());
+        return os;
+    }
+
+    friend void swap(basic_shared_key& a, basic_shared_key& b) JSONCONS_NOEXCEPT
+    {
+        a.swap(b);
+    }
+private:
+    static const CharT* empty_chars()
+    {
+        static const CharT s[1] = {0};
+        return s;
+    }
+
+    static size_t units_needed(size_t length)
+    {
+        return (sizeof(header) + (length+1)*sizeof(CharT) + sizeof(storage_unit) - 1)/sizeof(storage_unit);
+    }
+
+    header* get_header() const
+    {
+        return reinterpret_cast<header*>(to_plain_pointer(impl_.ptr_));
+    }
+
+    CharT* chars() const
+    {
+        return reinterpret_cast<CharT*>(reinterpret_cast<char*>(to_plain_pointer(impl_.ptr_)) + sizeof(header));
+    }
+
+    void allocate(size_t length)
+    {
+        impl_.ptr_ = storage_traits::allocate(impl_, units_needed(length));
+        new(reinterpret_cast<void*>(to_plain_pointer(impl_.ptr_)))header(length);
+    }
+
+    void create(const CharT* s, size_t length)
+    {
+        if (length > 0)
+        {
+            allocate(length);
+            std::memcpy(chars(), s, length*sizeof(CharT));
+            chars()[length] = 0;
+        }
+    }
+
+    void share(const basic_shared_key& other)
+    {
+        impl_.ptr_ = other.impl_.ptr_;
+        if (impl_.ptr_ != nullptr)
+        {
+            get_header()->ref_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void release()
+    {
+        if (impl_.ptr_ != nullptr)
+        {
+            header* h = get_header();
+            if (h->ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                const size_t n = units_needed(h->length_);
+                h->~header();
+                storage_traits::deallocate(impl_, impl_.ptr_, n);
+            }
+            impl_.ptr_ = nullptr;
+        }
+    }
+};
+
+typedef basic_shared_key<char> shared_key;
+typedef basic_shared_key<wchar_t> wshared_key;
+
+}
+
+#endif
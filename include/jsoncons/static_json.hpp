@@ -0,0 +1,837 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_STATIC_JSON_HPP
+#define JSONCONS_STATIC_JSON_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <limits>
+#include <type_traits>
+#include <jsoncons/frozen_json.hpp>
+
+#if defined(JSONCONS_HAS_CONSTEXPR_PARSE)
+
+namespace jsoncons {
+
+template <class CharT, size_t Words>
+class basic_static_json;
+
+namespace detail {
+
+// A basic_static_json is the tape of a frozen document, written by a constexpr parser
+// when the program is compiled. The parser runs twice over the text, first to count the
+// words of the tape, which become the size of the array that holds them, then to write
+// them, in the same layout as basic_frozen_json_decoder, so that a basic_frozen_json_view
+// reads them in place.
+
+// Not constexpr, so that the compiler names it as the reason a literal is not a constant
+// expression. When the parser runs at run time it throws.
+inline void static_json_error(const char* message)
+{
+    JSONCONS_THROW_EXCEPTION(std::invalid_argument,message);
+}
+
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+static constexpr bool static_tape_big_endian = true;
+#else
+static constexpr bool static_tape_big_endian = false;
+#endif
+
+template <class CharT>
+struct static_tape_traits
+{
+    static constexpr size_t char_bits = 8*sizeof(CharT);
+    static constexpr size_t chars_per_word = sizeof(uint64_t)/sizeof(CharT);
+
+    static constexpr uint64_t header(frozen_tag tag, uint64_t length = 0)
+    {
+        return static_cast<uint64_t>(tag) | (length << 8);
+    }
+
+    static constexpr size_t word_count(size_t length, size_t item_size)
+    {
+        return (length*item_size + sizeof(uint64_t) - 1)/sizeof(uint64_t);
+    }
+
+    // Where the character at index i of a word is, as it would be if the word was written
+    // with memcpy
+    static constexpr size_t char_shift(size_t i)
+    {
+        return static_tape_big_endian ? 64 - char_bits*(i + 1) : char_bits*i;
+    }
+
+    static constexpr uint64_t char_mask()
+    {
+        return char_bits == 64 ? ~uint64_t(0) : (uint64_t(1) << char_bits) - 1;
+    }
+};
+
+// Counts the words of a tape
+
+template <class CharT>
+class static_tape_counter
+{
+    size_t size_;
+public:
+    constexpr static_tape_counter()
+        : size_(0)
+    {
+    }
+
+    constexpr size_t size() const
+    {
+        return size_;
+    }
+
+    constexpr void push(uint64_t)
+    {
+        ++size_;
+    }
+
+    constexpr void set(size_t, uint64_t)
+    {
+    }
+
+    constexpr void table(size_t, size_t count, bool)
+    {
+        size_ += count;
+    }
+};
+
+// Writes the words of a tape
+
+template <class CharT, size_t Words>
+class static_tape
+{
+    typedef static_tape_traits<CharT> traits;
+
+    uint64_t words_[Words];
+    size_t size_;
+public:
+    constexpr static_tape()
+        : words_{}, size_(0)
+    {
+    }
+
+    constexpr size_t size() const
+    {
+        return size_;
+    }
+
+    constexpr const uint64_t* data() const
+    {
+        return words_;
+    }
+
+    constexpr void push(uint64_t word)
+    {
+        words_[size_++] = word;
+    }
+
+    constexpr void set(size_t pos, uint64_t word)
+    {
+        words_[pos] = word;
+    }
+
+    // Writes the table of the array or object at pos, whose items have just been written,
+    // with the members of an object sorted by key
+    constexpr void table(size_t pos, size_t count, bool is_object)
+    {
+        const size_t first = size_;
+        size_t p = pos + 3;
+        for (size_t i = 0; i < count; ++i)
+        {
+            push(p);
+            p = is_object ? next(member_value(p)) : next(p);
+        }
+        if (is_object)
+        {
+            for (size_t i = first + 1; i < size_; ++i)
+            {
+                const uint64_t item = words_[i];
+                size_t j = i;
+                for (; j > first && key_less(item, words_[j - 1]); --j)
+                {
+                    words_[j] = words_[j - 1];
+                }
+                words_[j] = item;
+            }
+        }
+    }
+private:
+    constexpr size_t next(size_t pos) const
+    {
+        switch (static_cast<frozen_tag>(words_[pos] & 0xff))
+        {
+        case frozen_tag::null_t:
+        case frozen_tag::true_t:
+        case frozen_tag::false_t:
+            return pos + 1;
+        case frozen_tag::string_t:
+            return pos + 1 + traits::word_count(static_cast<size_t>(words_[pos] >> 8), sizeof(CharT));
+        case frozen_tag::array_t:
+        case frozen_tag::object_t:
+            return static_cast<size_t>(words_[pos + 1]);
+        default:
+            return pos + 2;
+        }
+    }
+
+    constexpr size_t member_value(size_t pos) const
+    {
+        return pos + 1 + traits::word_count(static_cast<size_t>(words_[pos]), sizeof(CharT));
+    }
+
+    constexpr uint64_t key_char(size_t pos, size_t i) const
+    {
+        return (words_[pos + 1 + i/traits::chars_per_word] >> traits::char_shift(i % traits::chars_per_word)) & traits::char_mask();
+    }
+
+    // Compares keys as std::char_traits<CharT>::compare does, by unsigned character, then
+    // by length
+    constexpr bool key_less(uint64_t a, uint64_t b) const
+    {
+        const size_t length_a = static_cast<size_t>(words_[a]);
+        const size_t length_b = static_cast<size_t>(words_[b]);
+        for (size_t i = 0; i < length_a && i < length_b; ++i)
+        {
+            const uint64_t ca = key_char(static_cast<size_t>(a), i);
+            const uint64_t cb = key_char(static_cast<size_t>(b), i);
+            if (ca != cb)
+            {
+                return ca < cb;
+            }
+        }
+        return length_a < length_b;
+    }
+};
+
+template <class CharT, class Tape>
+class static_json_parser
+{
+    typedef static_tape_traits<CharT> traits;
+
+    static constexpr uint64_t max_exact_integer = uint64_t(1) << 53;
+
+    const CharT* p_;
+    const CharT* last_;
+    Tape tape_;
+    // The characters of a string not yet written in a whole word
+    uint64_t word_;
+    size_t word_length_;
+public:
+    constexpr static_json_parser(const CharT* first, const CharT* last)
+        : p_(first), last_(last), tape_(), word_(0), word_length_(0)
+    {
+    }
+
+    constexpr Tape parse()
+    {
+        skip_whitespace();
+        value();
+        skip_whitespace();
+        if (p_ != last_)
+        {
+            static_json_error("Extra characters after the JSON text");
+        }
+        return tape_;
+    }
+private:
+    constexpr CharT current() const
+    {
+        return p_ < last_ ? *p_ : CharT();
+    }
+
+    constexpr void expect(CharT c)
+    {
+        if (current() != c)
+        {
+            static_json_error("Unexpected character in JSON text");
+        }
+        ++p_;
+    }
+
+    constexpr void skip_whitespace()
+    {
+        while (p_ < last_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r'))
+        {
+            ++p_;
+        }
+    }
+
+    constexpr void literal(const char* s, frozen_tag tag)
+    {
+        for (; *s != 0; ++s)
+        {
+            expect(static_cast<CharT>(*s));
+        }
+        tape_.push(traits::header(tag));
+    }
+
+    constexpr void value()
+    {
+        switch (current())
+        {
+        case '{':
+            container(true);
+            break;
+        case '[':
+            container(false);
+            break;
+        case '"':
+            {
+                const CharT* first = p_;
+                tape_.push(traits::header(frozen_tag::string_t, string_length()));
+                p_ = first;
+                string_chars();
+            }
+            break;
+        case 't':
+            literal("true", frozen_tag::true_t);
+            break;
+        case 'f':
+            literal("false", frozen_tag::false_t);
+            break;
+        case 'n':
+            literal("null", frozen_tag::null_t);
+            break;
+        default:
+            number();
+            break;
+        }
+    }
+
+    // Writes an array or object as basic_frozen_json_decoder does: a header, the
+    // position past the value and the position of the table, then the items, then the
+    // table
+    constexpr void container(bool is_object)
+    {
+        ++p_;
+        const size_t pos = tape_.size();
+        tape_.push(0);
+        tape_.push(0);
+        tape_.push(0);
+        size_t count = 0;
+        skip_whitespace();
+        const CharT close = is_object ? '}' : ']';
+        if (current() == close)
+        {
+            ++p_;
+        }
+        else
+        {
+            while (true)
+            {
+                skip_whitespace();
+                if (is_object)
+                {
+                    const CharT* first = p_;
+                    tape_.push(string_length());
+                    p_ = first;
+                    string_chars();
+                    skip_whitespace();
+                    expect(':');
+                    skip_whitespace();
+                }
+                value();
+                ++count;
+                skip_whitespace();
+                if (current() == ',')
+                {
+                    ++p_;
+                    continue;
+                }
+                expect(close);
+                break;
+            }
+        }
+        const size_t table = tape_.size();
+        tape_.table(pos, count, is_object);
+        tape_.set(pos, traits::header(is_object ? frozen_tag::object_t : frozen_tag::array_t, count));
+        tape_.set(pos + 1, tape_.size());
+        tape_.set(pos + 2, table);
+    }
+
+    // The number of characters of the string at p_, with escapes replaced
+    constexpr size_t string_length()
+    {
+        expect('"');
+        size_t length = 0;
+        while (current() != '"')
+        {
+            const bool escaped = *p_ == '\\';
+            const uint32_t cp = next_code_point();
+            length += escaped ? char_count(cp) : 1;
+        }
+        ++p_;
+        return length;
+    }
+
+    // Writes the characters of the string at p_, packed into words
+    constexpr void string_chars()
+    {
+        expect('"');
+        while (current() != '"')
+        {
+            const bool escaped = *p_ == '\\';
+            const CharT c = *p_;
+            const uint32_t cp = next_code_point();
+            if (!escaped)
+            {
+                put_char(static_cast<uint64_t>(static_cast<typename std::make_unsigned<CharT>::type>(c)));
+            }
+            else
+            {
+                put_code_point(cp);
+            }
+        }
+        ++p_;
+        if (word_length_ > 0)
+        {
+            tape_.push(word_);
+            word_ = 0;
+            word_length_ = 0;
+        }
+    }
+
+    // Reads one character, or one escape, and returns the code point of an escape. A
+    // character that is not escaped is copied as it is, one unit at a time.
+    constexpr uint32_t next_code_point()
+    {
+        if (p_ == last_)
+        {
+            static_json_error("Unterminated string in JSON text");
+        }
+        const CharT c = *p_++;
+        if (c != '\\')
+        {
+            if (static_cast<uint32_t>(static_cast<typename std::make_unsigned<CharT>::type>(c)) < 0x20)
+            {
+                static_json_error("Illegal control character in JSON string");
+            }
+            return static_cast<uint32_t>(static_cast<typename std::make_unsigned<CharT>::type>(c));
+        }
+        const CharT e = current();
+        ++p_;
+        switch (e)
+        {
+        case '"': return '"';
+        case '\\': return '\\';
+        case '/': return '/';
+        case 'b': return '\b';
+        case 'f': return '\f';
+        case 'n': return '\n';
+        case 'r': return '\r';
+        case 't': return '\t';
+        case 'u':
+            {
+                uint32_t cp = hex4();
+                if (cp >= 0xD800 && cp <= 0xDBFF)
+                {
+                    expect('\\');
+                    expect('u');
+                    const uint32_t low = hex4();
+                    if (low < 0xDC00 || low > 0xDFFF)
+                    {
+                        static_json_error("Unpaired high surrogate in JSON string");
+                    }
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                }
+                else if (cp >= 0xDC00 && cp <= 0xDFFF)
+                {
+                    static_json_error("Illegal codepoint in JSON string");
+                }
+                return cp;
+            }
+        default:
+            static_json_error("Illegal escaped character in JSON string");
+            return 0;
+        }
+    }
+
+    constexpr uint32_t hex4()
+    {
+        uint32_t cp = 0;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            const CharT c = current();
+            ++p_;
+            uint32_t digit = 0;
+            if (c >= '0' && c <= '9')
+            {
+                digit = static_cast<uint32_t>(c - '0');
+            }
+            else if (c >= 'a' && c <= 'f')
+            {
+                digit = static_cast<uint32_t>(c - 'a' + 10);
+            }
+            else if (c >= 'A' && c <= 'F')
+            {
+                digit = static_cast<uint32_t>(c - 'A' + 10);
+            }
+            else
+            {
+                static_json_error("Invalid hex digit in JSON string");
+            }
+            cp = cp*16 + digit;
+        }
+        return cp;
+    }
+
+    // The number of characters that the code point of an escape becomes
+    static constexpr size_t char_count(uint32_t cp)
+    {
+        if (sizeof(CharT) == 1)
+        {
+            return cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+        }
+        return sizeof(CharT) == 2 && cp >= 0x10000 ? 2 : 1;
+    }
+
+    constexpr void put_code_point(uint32_t cp)
+    {
+        if (sizeof(CharT) == 1)
+        {
+            if (cp < 0x80)
+            {
+                put_char(cp);
+            }
+            else if (cp < 0x800)
+            {
+                put_char(0xC0 | (cp >> 6));
+                put_char(0x80 | (cp & 0x3F));
+            }
+            else if (cp < 0x10000)
+            {
+                put_char(0xE0 | (cp >> 12));
+                put_char(0x80 | ((cp >> 6) & 0x3F));
+                put_char(0x80 | (cp & 0x3F));
+            }
+            else
+            {
+                put_char(0xF0 | (cp >> 18));
+                put_char(0x80 | ((cp >> 12) & 0x3F));
+                put_char(0x80 | ((cp >> 6) & 0x3F));
+                put_char(0x80 | (cp & 0x3F));
+            }
+        }
+        else if (sizeof(CharT) == 2 && cp >= 0x10000)
+        {
+            put_char(0xD800 + ((cp - 0x10000) >> 10));
+            put_char(0xDC00 + ((cp - 0x10000) & 0x3FF));
+        }
+        else
+        {
+            put_char(cp);
+        }
+    }
+
+    constexpr void put_char(uint64_t c)
+    {
+        word_ |= (c & traits::char_mask()) << traits::char_shift(word_length_);
+        if (++word_length_ == traits::chars_per_word)
+        {
+            tape_.push(word_);
+            word_ = 0;
+            word_length_ = 0;
+        }
+    }
+
+    // Numbers are written as basic_json_parser reports them: integers that fit in an
+    // int64_t, if negative, or a uint64_t, as integers, and others as doubles with the
+    // number of digits as the precision. A double is converted only when the conversion
+    // is exact in double arithmetic, a significand of at most 2^53 scaled by a power of
+    // ten that is exact, otherwise the text is rejected.
+    constexpr void number()
+    {
+        const bool negative = current() == '-';
+        if (negative)
+        {
+            ++p_;
+        }
+        const CharT* digits = p_;
+        if (current() == '0')
+        {
+            ++p_;
+            if (current() >= '0' && current() <= '9')
+            {
+                static_json_error("Leading zero in JSON number");
+            }
+        }
+        else if (current() >= '1' && current() <= '9')
+        {
+            while (current() >= '0' && current() <= '9')
+            {
+                ++p_;
+            }
+        }
+        else
+        {
+            static_json_error("Expected value in JSON text");
+        }
+        const CharT* integer_last = p_;
+        const CharT* fraction = p_;
+        const CharT* fraction_last = p_;
+        bool is_integer = true;
+        if (current() == '.')
+        {
+            is_integer = false;
+            fraction = ++p_;
+            while (current() >= '0' && current() <= '9')
+            {
+                ++p_;
+            }
+            fraction_last = p_;
+            if (fraction == fraction_last)
+            {
+                static_json_error("Invalid JSON number");
+            }
+        }
+        int64_t exponent = 0;
+        if (current() == 'e' || current() == 'E')
+        {
+            is_integer = false;
+            ++p_;
+            bool negative_exponent = false;
+            if (current() == '+' || current() == '-')
+            {
+                negative_exponent = current() == '-';
+                ++p_;
+            }
+            if (!(current() >= '0' && current() <= '9'))
+            {
+                static_json_error("Invalid JSON number");
+            }
+            while (current() >= '0' && current() <= '9')
+            {
+                if (exponent < 100000)
+                {
+                    exponent = exponent*10 + (*p_ - '0');
+                }
+                ++p_;
+            }
+            if (negative_exponent)
+            {
+                exponent = -exponent;
+            }
+        }
+        const size_t precision = static_cast<size_t>(integer_last - digits) + static_cast<size_t>(fraction_last - fraction);
+
+        if (is_integer)
+        {
+            if (negative)
+            {
+                const int64_t min_value = (std::numeric_limits<int64_t>::min)();
+                int64_t n = 0;
+                const CharT* q = digits;
+                for (; q < integer_last; ++q)
+                {
+                    const int64_t x = *q - '0';
+                    if (n < min_value/10 || n*10 < min_value + x)
+                    {
+                        break;
+                    }
+                    n = n*10 - x;
+                }
+                if (q == integer_last)
+                {
+                    tape_.push(traits::header(frozen_tag::integer_t));
+                    tape_.push(static_cast<uint64_t>(n));
+                    return;
+                }
+            }
+            else
+            {
+                const uint64_t max_value = (std::numeric_limits<uint64_t>::max)();
+                uint64_t n = 0;
+                const CharT* q = digits;
+                for (; q < integer_last; ++q)
+                {
+                    const uint64_t x = static_cast<uint64_t>(*q - '0');
+                    if (n > max_value/10 || n*10 > max_value - x)
+                    {
+                        break;
+                    }
+                    n = n*10 + x;
+                }
+                if (q == integer_last)
+                {
+                    tape_.push(traits::header(frozen_tag::uinteger_t));
+                    tape_.push(n);
+                    return;
+                }
+            }
+        }
+
+        // The significand, without leading zeros, and the power of ten that scales it
+        uint64_t significand = 0;
+        int64_t scale = exponent - static_cast<int64_t>(fraction_last - fraction);
+        bool full = false;
+        for (const CharT* q = digits; q < fraction_last; ++q)
+        {
+            if (q == integer_last)
+            {
+                q = fraction;
+                if (q == fraction_last)
+                {
+                    break;
+                }
+            }
+            const uint64_t x = static_cast<uint64_t>(*q - '0');
+            if (!full && significand <= (max_exact_integer - x)/10)
+            {
+                significand = significand*10 + x;
+            }
+            else if (x == 0)
+            {
+                // Trailing zeros that do not fit scale the significand instead
+                full = true;
+                ++scale;
+            }
+            else
+            {
+                static_json_error("JSON number cannot be converted exactly at compile time");
+            }
+        }
+        double d = 0.0;
+        if (significand != 0)
+        {
+            if (scale >= 0 && scale <= 22)
+            {
+                d = static_cast<double>(significand)*power_of_ten(static_cast<size_t>(scale));
+            }
+            else if (scale > 22 && scale <= 22 + 15 && significand <= max_exact_integer/integer_power_of_ten(static_cast<size_t>(scale - 22)))
+            {
+                d = static_cast<double>(significand*integer_power_of_ten(static_cast<size_t>(scale - 22)))*power_of_ten(22);
+            }
+            else if (scale < 0 && scale >= -22)
+            {
+                d = static_cast<double>(significand)/power_of_ten(static_cast<size_t>(-scale));
+            }
+            else
+            {
+                static_json_error("JSON number cannot be converted exactly at compile time");
+            }
+        }
+        const size_t max_digits10 = static_cast<size_t>(std::numeric_limits<double>::max_digits10);
+        tape_.push(traits::header(frozen_tag::double_t, precision > max_digits10 ? max_digits10 : precision));
+        tape_.push(double_bits(d, negative));
+    }
+
+    static constexpr double power_of_ten(size_t n)
+    {
+        double d = 1.0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            d *= 10.0;
+        }
+        return d;
+    }
+
+    static constexpr uint64_t integer_power_of_ten(size_t n)
+    {
+        uint64_t x = 1;
+        for (size_t i = 0; i < n; ++i)
+        {
+            x *= 10;
+        }
+        return x;
+    }
+
+    // The bits of a double, which is zero or a normal number, as memcpy would give them
+    static constexpr uint64_t double_bits(double d, bool negative)
+    {
+        const uint64_t sign = negative ? uint64_t(1) << 63 : 0;
+        if (d == 0.0)
+        {
+            return sign;
+        }
+        int64_t e = 0;
+        while (d >= 2.0)
+        {
+            d /= 2.0;
+            ++e;
+        }
+        while (d < 1.0)
+        {
+            d *= 2.0;
+            --e;
+        }
+        const uint64_t fraction = static_cast<uint64_t>((d - 1.0)*4503599627370496.0);
+        return sign | (static_cast<uint64_t>(e + 1023) << 52) | fraction;
+    }
+};
+
+template <class CharT, size_t Length>
+constexpr size_t static_json_words(const CharT (&text)[Length])
+{
+    return static_json_parser<CharT,static_tape_counter<CharT>>(text, text + Length - 1).parse().size();
+}
+
+template <size_t Words, class CharT, size_t Length>
+constexpr basic_static_json<CharT,Words> make_static_json(const CharT (&text)[Length])
+{
+    return basic_static_json<CharT,Words>(static_json_parser<CharT,static_tape<CharT,Words>>(text, text + Length - 1).parse());
+}
+
+}
+
+// basic_static_json
+// A frozen document whose tape was written when the program was compiled, from a string
+// literal given to JSONCONS_STATIC_JSON. It is a literal type that holds its tape in an
+// array, so a static constexpr one is in read only memory and needs no construction, no
+// parsing and no allocation at run time. It is read through a basic_frozen_json_view.
+
+template <class CharT, size_t Words>
+class basic_static_json
+{
+    detail::static_tape<CharT,Words> tape_;
+public:
+    typedef CharT char_type;
+    typedef basic_frozen_json_view<CharT> view_type;
+
+    explicit constexpr basic_static_json(const detail::static_tape<CharT,Words>& tape)
+        : tape_(tape)
+    {
+    }
+
+    // The root value
+    view_type view() const
+    {
+        return view_type(tape_.data(), 0);
+    }
+
+    // The words of the tape, as basic_frozen_json::save writes them
+    constexpr const uint64_t* data() const
+    {
+        return tape_.data();
+    }
+
+    constexpr size_t word_count() const
+    {
+        return Words;
+    }
+};
+
+template <size_t Words>
+using static_json = basic_static_json<char,Words>;
+
+template <size_t Words>
+using wstatic_json = basic_static_json<wchar_t,Words>;
+
+}
+
+// A basic_static_json<CharT,Words> from a string literal of JSON text, which is parsed when
+// the program is compiled. Text that is not valid JSON is a compile time error, as is a
+// number that would not be converted exactly, in a constant expression.
+#define JSONCONS_STATIC_JSON(text) \
+    ::jsoncons::detail::make_static_json< ::jsoncons::detail::static_json_words(text)>(text)
+
+#endif
+
+#endif
@@ -13,11 +13,15 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <algorithm>
 #include <istream>
 #include <limits>
 #include <memory>
 #include <sstream>
 #include <vector>
+#include <jsoncons/jsoncons_utilities.hpp>
+#include <jsoncons/detail/string_scan.hpp>
+#include <jsoncons/detail/unicode_traits.hpp>
 
 // The definitions below follow the definitions in compiler_support_p.h, https://github.com/01org/tinycbor
 // MIT license
@@ -118,6 +122,25 @@
 
 namespace jsoncons { namespace binary { 
 
+// Limits on what decode_cbor and decode_msgpack accept, unbounded by default. Lengths and
+// counts are checked as they are read, before anything is reserved for them.
+struct decode_limits
+{
+    // Arrays, maps and tags nested in each other
+    size_t max_nesting_depth;
+    // Elements of an array, or members of a map
+    size_t max_items;
+    // Bytes of a text string or a byte string
+    size_t max_string_length;
+
+    decode_limits()
+        : max_nesting_depth((std::numeric_limits<size_t>::max)()),
+          max_items((std::numeric_limits<size_t>::max)()),
+          max_string_length((std::numeric_limits<size_t>::max)())
+    {
+    }
+};
+
 namespace detail {
 
 static inline bool add_check_overflow(size_t v1, size_t v2, size_t *r)
@@ -131,6 +154,16 @@ static inline bool add_check_overflow(size_t v1, size_t v2, size_t *r)
 #endif
 }
 
+// Whether the host stores the least significant byte first, compilers fold this to a constant
+inline
+bool is_little_endian()
+{
+    const uint16_t x = 1;
+    uint8_t first;
+    std::memcpy(&first, &x, 1);
+    return first == 1;
+}
+
 inline 
 uint16_t encode_half(double val)
 {
@@ -210,13 +243,9 @@ to_big_endian(T val, std::vector<uint8_t>& v)
 {
     T x = JSONCONS_BINARY_FROM_BE16(val);
 
-    uint8_t where[sizeof(T)];
-    memcpy(where, &x, sizeof(T));
-
-    for (auto e : where)
-    {
-        v.push_back(e);
-    }
+    const size_t n = v.size();
+    v.resize(n + sizeof(T));
+    memcpy(v.data() + n, &x, sizeof(T));
 }
 
 template<typename T>
@@ -226,13 +255,9 @@ to_big_endian(T val, std::vector<uint8_t>& v)
 {
     T x = JSONCONS_BINARY_FROM_BE32(val);
 
-    uint8_t where[sizeof(T)];
-    memcpy(where, &x, sizeof(T));
-
-    for (auto e : where)
-    {
-        v.push_back(e);
-    }
+    const size_t n = v.size();
+    v.resize(n + sizeof(T));
+    memcpy(v.data() + n, &x, sizeof(T));
 }
 
 template<typename T>
@@ -242,13 +267,9 @@ to_big_endian(T val, std::vector<uint8_t>& v)
 {
     T x = JSONCONS_BINARY_FROM_BE64(val);
 
-    uint8_t where[sizeof(T)];
-    memcpy(where, &x, sizeof(T));
-
-    for (auto e : where)
-    {
-        v.push_back(e);
-    }
+    const size_t n = v.size();
+    v.resize(n + sizeof(T));
+    memcpy(v.data() + n, &x, sizeof(T));
 }
 
 inline
@@ -263,6 +284,124 @@ void to_big_endian(double val, std::vector<uint8_t>& v)
     to_big_endian(*reinterpret_cast<uint64_t*>(&val), v);
 }
 
+// to_big_endian, writing at p and advancing p
+
+template<typename T>
+typename std::enable_if<std::is_integral<T>::value && sizeof(T) == sizeof(uint8_t),void>::type
+to_big_endian(T val, uint8_t*& p)
+{
+    *p++ = static_cast<uint8_t>((val) & 0xff);
+}
+
+template<typename T>
+typename std::enable_if<std::is_integral<T>::value && 
+sizeof(T) == sizeof(uint16_t),void>::type
+to_big_endian(T val, uint8_t*& p)
+{
+    T x = JSONCONS_BINARY_FROM_BE16(val);
+    memcpy(p, &x, sizeof(T));
+    p += sizeof(T);
+}
+
+template<typename T>
+typename std::enable_if<std::is_integral<T>::value && sizeof(T) == sizeof(uint32_t),void>::type
+to_big_endian(T val, uint8_t*& p)
+{
+    T x = JSONCONS_BINARY_FROM_BE32(val);
+    memcpy(p, &x, sizeof(T));
+    p += sizeof(T);
+}
+
+template<typename T>
+typename std::enable_if<std::is_integral<T>::value && sizeof(T) == sizeof(uint64_t),void>::type
+to_big_endian(T val, uint8_t*& p)
+{
+    T x = JSONCONS_BINARY_FROM_BE64(val);
+    memcpy(p, &x, sizeof(T));
+    p += sizeof(T);
+}
+
+inline
+void to_big_endian(float val, uint8_t*& p)
+{
+    to_big_endian(*reinterpret_cast<uint32_t*>(&val), p);
+}
+
+inline
+void to_big_endian(double val, uint8_t*& p)
+{
+    to_big_endian(*reinterpret_cast<uint64_t*>(&val), p);
+}
+
+// output_buffer
+
+// Appends to a vector with a single bounded store per value. The vector grows by doubling
+// and is only trimmed to what was written when the output_buffer is destroyed, so a vector
+// that is cleared and reused for each message does not allocate once it has grown to fit,
+// and no pass is needed to size the output first. If commit has not been called when the
+// output_buffer is destroyed, for example because encoding threw, the vector is restored
+// to its former size.
+
+class output_buffer
+{
+    std::vector<uint8_t>& v_;
+    size_t start_;
+    size_t length_;
+    bool committed_;
+
+    // Noncopyable and nonmoveable
+    output_buffer(const output_buffer&) = delete;
+    output_buffer& operator=(const output_buffer&) = delete;
+public:
+    explicit output_buffer(std::vector<uint8_t>& v)
+        : v_(v), start_(v.size()), length_(v.size()), committed_(false)
+    {
+    }
+
+    ~output_buffer()
+    {
+        v_.resize(committed_ ? length_ : start_);
+    }
+
+    void commit()
+    {
+        committed_ = true;
+    }
+
+    size_t size() const
+    {
+        return length_ - start_;
+    }
+
+    template <class T>
+    void put(T val)
+    {
+        uint8_t* p = ensure(sizeof(T));
+        to_big_endian(val, p);
+        length_ += sizeof(T);
+    }
+
+    void write(const uint8_t* data, size_t length)
+    {
+        if (length > 0)
+        {
+            std::memcpy(ensure(length), data, length);
+            length_ += length;
+        }
+    }
+private:
+    uint8_t* ensure(size_t n)
+    {
+        if (v_.size() - length_ < n)
+        {
+            const size_t min_length = 64;
+            size_t new_length = (std::max)(v_.size()*2, min_length);
+            v_.resize((std::max)(new_length, length_ + n));
+        }
+        return v_.data() + length_;
+    }
+};
+
 // from_big_endian
 
 template<class T>
@@ -329,127 +468,58 @@ from_big_endian(const uint8_t* it, const uint8_t* end)
     return *reinterpret_cast<T*>(&data);
 }
 
-static const std::string base64_alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-                                           "abcdefghijklmnopqrstuvwxyz"
-                                           "0123456789+/";
+// Sets s to the UTF-8 text [first,last), and returns false if it is not well formed.
+// Text for a string of bytes is validated and copied in one go, for a string of wider
+// characters it is converted. String may be any string type constructible from a
+// pointer and a length.
+template <class String>
+typename std::enable_if<sizeof(typename String::value_type) == sizeof(uint8_t),bool>::type
+assign_utf8(String& s, const uint8_t* first, const uint8_t* last)
+{
+    const size_t length = static_cast<size_t>(last - first);
+    if (!jsoncons::detail::is_valid_utf8(reinterpret_cast<const char*>(first), length))
+    {
+        return false;
+    }
+    s = String(reinterpret_cast<const typename String::value_type*>(first), length);
+    return true;
+}
 
-inline 
-static bool is_base64(uint8_t c) 
+template <class String>
+typename std::enable_if<sizeof(typename String::value_type) != sizeof(uint8_t),bool>::type
+assign_utf8(String& s, const uint8_t* first, const uint8_t* last)
 {
-    return isalnum(c) || c == '+' || c == '/';
+    std::basic_string<typename String::value_type> target;
+    auto result = unicons::convert(first, last, std::back_inserter(target), unicons::conv_flags::strict);
+    if (result.ec != unicons::conv_errc())
+    {
+        return false;
+    }
+    s = String(target.data(), target.size());
+    return true;
 }
 
 template <class InputIt>
 std::string encode_base64(InputIt first, InputIt last)
 {
     std::string result;
-    unsigned char a3[3];
-    unsigned char a4[4];
-    int i = 0;
-    int j = 0;
-
-    while (first != last)
-    {
-        a3[i++] = *first++;
-        if (i == 3)
-        {
-            a4[0] = (a3[0] & 0xfc) >> 2;
-            a4[1] = ((a3[0] & 0x03) << 4) + ((a3[1] & 0xf0) >> 4);
-            a4[2] = ((a3[1] & 0x0f) << 2) + ((a3[2] & 0xc0) >> 6);
-            a4[3] = a3[2] & 0x3f;
-
-            for (i = 0; i < 4; i++) 
-            {
-                result.push_back(base64_alphabet[a4[i]]);
-            }
-            i = 0;
-        }
-    }
-
-    if (i > 0)
-    {
-        for (j = i; j < 3; ++j) 
-        {
-            a3[j] = '\0';
-        }
-
-        a4[0] = (a3[0] & 0xfc) >> 2;
-        a4[1] = ((a3[0] & 0x03) << 4) + ((a3[1] & 0xf0) >> 4);
-        a4[2] = ((a3[1] & 0x0f) << 2) + ((a3[2] & 0xc0) >> 6);
-
-        for (j = 0; j < i + 1; ++j) 
-        {
-            result.push_back(base64_alphabet[a4[j]]);
-        }
-
-        while (i++ < 3) 
-        {
-            result.push_back('=');
-        }
-    }
-
+    jsoncons::encode_base64(first, last, result);
     return result; 
 }
 
 inline
 std::string encode_base64(const std::string& s)
 {
-    return encode_base64(s.begin(), s.end());
+    std::string result;
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(s.data());
+    jsoncons::encode_base64(data, data + s.size(), result);
+    return result;
 }
 
 inline
 std::string decode_base64(const std::string& base64_string)
 {
-    std::string result;
-    size_t buflen = base64_string.size();
-    uint8_t a4[4], a3[3];
-    uint8_t i = 0;
-    uint8_t j = 0;
-
-    auto first = base64_string.begin();
-    auto last = base64_string.end();
-
-    while (first != last && *first != '=')
-    {
-        JSONCONS_ASSERT(is_base64(*first));
-
-        a4[i++] = *first++; 
-        if (i == 4)
-        {
-            for (i = 0; i < 4; ++i) 
-            {
-                a4[i] = static_cast<uint8_t>(base64_alphabet.find(a4[i]));
-            }
-
-            a3[0] = (a4[0] << 2) + ((a4[1] & 0x30) >> 4);
-            a3[1] = ((a4[1] & 0xf) << 4) + ((a4[2] & 0x3c) >> 2);
-            a3[2] = ((a4[2] & 0x3) << 6) +   a4[3];
-
-            for (i = 0; i < 3; i++) 
-            {
-                result.push_back(a3[i]);
-            }
-            i = 0;
-        }
-    }
-
-    if (i > 0)
-    {
-        for (j = 0; j < i; ++j) 
-        {
-            a4[j] = static_cast<uint8_t>(base64_alphabet.find(a4[j]));
-        }
-
-        a3[0] = (a4[0] << 2) + ((a4[1] & 0x30) >> 4);
-        a3[1] = ((a4[1] & 0xf) << 4) + ((a4[2] & 0x3c) >> 2);
-
-        for (j = 0; j < i - 1; ++j) 
-        {
-            result.push_back(a3[j]);
-        }
-    }
-
-    return result;
+    return jsoncons::decode_base64(base64_string);
 }
 
 }
@@ -0,0 +1,108 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_BINARY_VIEW_INDEX_HPP
+#define JSONCONS_BINARY_VIEW_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+#include <jsoncons/json_decoder.hpp>
+
+namespace jsoncons { namespace binary { namespace detail {
+
+// The offsets of the items of an encoded array or map, and for a map an open addressing
+// (linear probing) hash table of its keys. Slots hold positions + 1, zero marks an
+// empty slot. For a map, offsets_ holds the offset of each key and value, followed
+// by the offset past the last value, for an array the offset of each element,
+// followed by the offset past the last one. A derived class walks the encoding to
+// fill offsets_ and keys_, then calls index_keys.
+
+class view_index
+{
+protected:
+    size_t stride_;
+    std::vector<size_t> offsets_;
+    std::vector<std::string> keys_;
+    std::vector<uint32_t> slots_;
+
+    explicit view_index(bool is_map)
+        : stride_(is_map ? 2 : 1)
+    {
+    }
+
+    void index_keys()
+    {
+        if (stride_ != 2)
+        {
+            return;
+        }
+        size_t capacity = 16;
+        while (capacity < 2*keys_.size())
+        {
+            capacity *= 2;
+        }
+        slots_.assign(capacity, 0);
+        for (size_t i = 0; i < keys_.size(); ++i)
+        {
+            // The first of duplicate keys is found, as without an index
+            if (find(keys_[i]) == keys_.size())
+            {
+                const size_t mask = slots_.size() - 1;
+                size_t j = key_intern_table<std::string>::hash(keys_[i]) & mask;
+                while (slots_[j] != 0)
+                {
+                    j = (j + 1) & mask;
+                }
+                slots_[j] = static_cast<uint32_t>(i + 1);
+            }
+        }
+    }
+public:
+    size_t size() const
+    {
+        return (offsets_.size() - 1)/stride_;
+    }
+
+    // The offsets of the first byte and past the last byte of the value at position i
+    std::pair<size_t,size_t> value(size_t i) const
+    {
+        return std::make_pair(offsets_[stride_*i + stride_ - 1], offsets_[stride_*(i + 1)]);
+    }
+
+    // The key of the member at position i of a map
+    const std::string& key(size_t i) const
+    {
+        return keys_[i];
+    }
+
+    // The position of the member with the key, or size() if there is none
+    template <class StringViewT>
+    size_t find(const StringViewT& key) const
+    {
+        if (slots_.empty())
+        {
+            return size();
+        }
+        const size_t mask = slots_.size() - 1;
+        for (size_t j = key_intern_table<std::string>::hash(key) & mask; slots_[j] != 0; j = (j + 1) & mask)
+        {
+            const std::string& a_key = keys_[slots_[j] - 1];
+            if (a_key.size() == key.size() &&
+                std::char_traits<char>::compare(a_key.data(), key.data(), key.size()) == 0)
+            {
+                return slots_[j] - 1;
+            }
+        }
+        return size();
+    }
+};
+
+}}}
+
+#endif
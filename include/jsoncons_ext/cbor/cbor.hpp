@@ -15,8 +15,17 @@
 #include <memory>
 #include <limits>
 #include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <tuple>
+#include <type_traits>
 #include <jsoncons/json.hpp>
+#include <jsoncons/parallel_array_writer.hpp>
+#include <jsoncons/detail/string_scan.hpp>
 #include <jsoncons_ext/binary/binary_utilities.hpp>
+#include <jsoncons_ext/binary/view_index.hpp>
+#include <jsoncons_ext/cbor/cbor_typed_array.hpp>
+#include <jsoncons_ext/cbor/cbor_error_category.hpp>
 
 // Positive integer 0x00..0x17 (0..23)
 #define JSONCONS_CBOR_0x00_0x17 \
@@ -42,11 +51,26 @@
 #define JSONCONS_CBOR_0xa0_0xb7 \
         0xa0:case 0xa1:case 0xa2:case 0xa3:case 0xa4:case 0xa5:case 0xa6:case 0xa7:case 0xa8:case 0xa9:case 0xaa:case 0xab:case 0xac:case 0xad:case 0xae:case 0xaf:case 0xb0:case 0xb1:case 0xb2:case 0xb3:case 0xb4:case 0xb5:case 0xb6:case 0xb7
 
+// tag (0x00..0x17 follows)
+#define JSONCONS_CBOR_0xc0_0xd7 \
+        0xc0:case 0xc1:case 0xc2:case 0xc3:case 0xc4:case 0xc5:case 0xc6:case 0xc7:case 0xc8:case 0xc9:case 0xca:case 0xcb:case 0xcc:case 0xcd:case 0xce:case 0xcf:case 0xd0:case 0xd1:case 0xd2:case 0xd3:case 0xd4:case 0xd5:case 0xd6:case 0xd7
+
 namespace jsoncons { namespace cbor {
 
 namespace detail {
     const uint8_t* walk(const uint8_t* it, const uint8_t* end);
 
+    // Steps over the break that ends an indefinite length item
+    inline
+    const uint8_t* skip_break(const uint8_t* it, const uint8_t* end)
+    {
+        if (it == end)
+        {
+            JSONCONS_THROW_EXCEPTION(std::invalid_argument,"eof");
+        }
+        return it + 1;
+    }
+
     inline 
     std::tuple<std::string,const uint8_t*> get_fixed_length_text_string(const uint8_t* it, const uint8_t* end)
     {
@@ -99,6 +123,43 @@ namespace detail {
         }
     }
 
+    // The UTF-8 bytes of a definite length text string, in place
+    inline 
+    std::tuple<byte_string_view,const uint8_t*> get_fixed_length_text_string_view(const uint8_t* it, const uint8_t* end)
+    {
+        const uint8_t* pos = it++;
+        uint64_t len;
+        switch (*pos)
+        {
+        case JSONCONS_CBOR_0x60_0x77: // UTF-8 string (0x00..0x17 bytes follow)
+            len = *pos & 0x1f;
+            break;
+        case 0x78: // UTF-8 string (one-byte uint8_t for n follows)
+            len = binary::detail::from_big_endian<uint8_t>(it,end);
+            it += sizeof(uint8_t);
+            break;
+        case 0x79: // UTF-8 string (two-byte uint16_t for n follow)
+            len = binary::detail::from_big_endian<uint16_t>(it,end);
+            it += sizeof(uint16_t);
+            break;
+        case 0x7a: // UTF-8 string (four-byte uint32_t for n follow)
+            len = binary::detail::from_big_endian<uint32_t>(it,end);
+            it += sizeof(uint32_t);
+            break;
+        case 0x7b: // UTF-8 string (eight-byte uint64_t for n follow)
+            len = binary::detail::from_big_endian<uint64_t>(it,end);
+            it += sizeof(uint64_t);
+            break;
+        default: 
+            JSONCONS_THROW_EXCEPTION_1(std::invalid_argument,"Error decoding a cbor at position %s", std::to_string(end-pos));
+        }
+        if (it > end || static_cast<uint64_t>(end - it) < len)
+        {
+            JSONCONS_THROW_EXCEPTION(std::invalid_argument,"eof");
+        }
+        return std::make_tuple(byte_string_view(it, static_cast<size_t>(len)), it + len);
+    }
+
     inline
     std::tuple<std::string,const uint8_t*> get_text_string(const uint8_t* it, const uint8_t* end)
     {
@@ -109,16 +170,13 @@ namespace detail {
         case 0x7f: // UTF-8 string (0x00..0x17 bytes follow)
             {
                 std::string s;
-                while (*it != 0xff)
+                while (it != end && *it != 0xff)
                 {
-                    if (it == end)
-                    {
-                        JSONCONS_THROW_EXCEPTION(std::invalid_argument,"eof");
-                    }
                     std::string ss;
                     std::tie(ss,it) = detail::get_fixed_length_text_string(it,end);
                     s.append(std::move(ss));
                 }
+                it = skip_break(it, end);
                 return std::make_tuple(s,it);
             }
         default:
@@ -126,57 +184,49 @@ namespace detail {
         }
     }
 
+    // The bytes of a definite length byte string, in place
     inline 
-    std::tuple<std::vector<uint8_t>,const uint8_t*> get_fixed_length_byte_string(const uint8_t* it, const uint8_t* end)
+    std::tuple<byte_string_view,const uint8_t*> get_fixed_length_byte_string_view(const uint8_t* it, const uint8_t* end)
     {
         const uint8_t* pos = it++;
+        uint64_t len;
         switch (*pos)
         {
-        
         case JSONCONS_CBOR_0x40_0x57: // byte string (0x00..0x17 bytes follow)
-            {
-                size_t len = *pos & 0x1f;
-                const uint8_t *first = it;
-                it += len;
-                return std::make_tuple(std::vector<uint8_t>(first, it), it);
-            }
+            len = *pos & 0x1f;
+            break;
         case 0x58: // byte string (one-byte uint8_t for n follows)
-            {
-                const auto len = binary::detail::from_big_endian<uint8_t>(it,end);
-                it += sizeof(uint8_t);
-                const uint8_t *first = it;
-                it += len;
-                return std::make_tuple(std::vector<uint8_t>(first, it), it);
-            }
+            len = binary::detail::from_big_endian<uint8_t>(it,end);
+            it += sizeof(uint8_t);
+            break;
         case 0x59: // byte string (two-byte uint16_t for n follow)
-            {
-                const auto len = binary::detail::from_big_endian<uint16_t>(it,end);
-                it += sizeof(uint16_t);
-                const uint8_t* first = it;
-                it += len;
-                return std::make_tuple(std::vector<uint8_t>(first,it),it);
-            }
+            len = binary::detail::from_big_endian<uint16_t>(it,end);
+            it += sizeof(uint16_t);
+            break;
         case 0x5a: // byte string (four-byte uint32_t for n follow)
-            {
-                const auto len = binary::detail::from_big_endian<uint32_t>(it,end);
-                it += sizeof(uint32_t);
-                const uint8_t* first = it;
-                it += len;
-                return std::make_tuple(std::vector<uint8_t>(first,it),it);
-            }
+            len = binary::detail::from_big_endian<uint32_t>(it,end);
+            it += sizeof(uint32_t);
+            break;
         case 0x5b: // byte string (eight-byte uint64_t for n follow)
-            {
-                const auto len = binary::detail::from_big_endian<uint64_t>(it,end);
-                it += sizeof(uint64_t);
-                const uint8_t* first = it;
-                it += len;
-                return std::make_tuple(std::vector<uint8_t>(first,it),it);
-            }
+            len = binary::detail::from_big_endian<uint64_t>(it,end);
+            it += sizeof(uint64_t);
+            break;
         default: 
-            {
-                JSONCONS_THROW_EXCEPTION_1(std::invalid_argument,"Error decoding a cbor at position %s", std::to_string(end-pos));
-            }
+            JSONCONS_THROW_EXCEPTION_1(std::invalid_argument,"Error decoding a cbor at position %s", std::to_string(end-pos));
+        }
+        if (static_cast<uint64_t>(end - it) < len)
+        {
+            JSONCONS_THROW_EXCEPTION(std::invalid_argument,"eof");
         }
+        return std::make_tuple(byte_string_view(it, static_cast<size_t>(len)), it + len);
+    }
+
+    inline 
+    std::tuple<std::vector<uint8_t>,const uint8_t*> get_fixed_length_byte_string(const uint8_t* it, const uint8_t* end)
+    {
+        byte_string_view bs(nullptr, 0);
+        std::tie(bs,it) = get_fixed_length_byte_string_view(it, end);
+        return std::make_tuple(std::vector<uint8_t>(bs.begin(), bs.end()), it);
     }
 
     inline
@@ -188,24 +238,139 @@ namespace detail {
         
         case 0x5f: // byte string, byte strings follow, terminated by "break"
             {
+                // Sums the lengths of the chunks first, so that they are gathered with one allocation
+                size_t length = 0;
+                const uint8_t* p = it;
+                byte_string_view chunk(nullptr, 0);
+                while (p != end && *p != 0xff)
+                {
+                    std::tie(chunk,p) = detail::get_fixed_length_byte_string_view(p,end);
+                    length += chunk.length();
+                }
                 std::vector<uint8_t> v;
-                while (*it != 0xff)
+                v.reserve(length);
+                while (it != end && *it != 0xff)
                 {
-                    if (it == end)
-                    {
-                        JSONCONS_THROW_EXCEPTION(std::invalid_argument,"eof");
-                    }
-                    std::vector<uint8_t> ss;
-                    std::tie(ss,it) = detail::get_fixed_length_byte_string(it,end);
-                    v.insert(v.end(),ss.begin(),ss.end());
+                    std::tie(chunk,it) = detail::get_fixed_length_byte_string_view(it,end);
+                    v.insert(v.end(),chunk.begin(),chunk.end());
                 }
-                return std::make_tuple(v,it);
+                it = skip_break(it, end);
+                return std::make_tuple(std::move(v),it);
             }
         default:
             return detail::get_fixed_length_byte_string(pos,end);
         }
     }
 
+    // If the bytes of the byte string at it lie together in the buffer, as those of a definite
+    // length string and of an indefinite length one with at most one chunk do, sets bs to them
+    // in place and next to the position past the string, and returns true.
+    inline
+    bool get_contiguous_byte_string_view(const uint8_t* it, const uint8_t* end, 
+                                         byte_string_view& bs, const uint8_t*& next)
+    {
+        if (it >= end)
+        {
+            JSONCONS_THROW_EXCEPTION(std::invalid_argument,"eof");
+        }
+        if (*it != 0x5f)
+        {
+            std::tie(bs,next) = get_fixed_length_byte_string_view(it, end);
+            return true;
+        }
+        const uint8_t* p = it + 1;
+        bs = byte_string_view(p, 0);
+        if (p != end && *p != 0xff)
+        {
+            std::tie(bs,p) = get_fixed_length_byte_string_view(p, end);
+        }
+        if (p == end || *p != 0xff)
+        {
+            return false;
+        }
+        next = skip_break(p, end);
+        return true;
+    }
+
+    // The tag of a tagged data item, and the position of the item
+    inline
+    std::tuple<uint64_t,const uint8_t*> get_tag(const uint8_t* it, const uint8_t* end)
+    {
+        const uint8_t* pos = it++;
+        switch (*pos)
+        {
+        case JSONCONS_CBOR_0xc0_0xd7:
+            return std::make_tuple(static_cast<uint64_t>(*pos & 0x1f), it);
+        case 0xd8:
+            return std::make_tuple(static_cast<uint64_t>(binary::detail::from_big_endian<uint8_t>(it,end)), it + sizeof(uint8_t));
+        case 0xd9:
+            return std::make_tuple(static_cast<uint64_t>(binary::detail::from_big_endian<uint16_t>(it,end)), it + sizeof(uint16_t));
+        case 0xda:
+            return std::make_tuple(static_cast<uint64_t>(binary::detail::from_big_endian<uint32_t>(it,end)), it + sizeof(uint32_t));
+        case 0xdb:
+            return std::make_tuple(binary::detail::from_big_endian<uint64_t>(it,end), it + sizeof(uint64_t));
+        default:
+            JSONCONS_THROW_EXCEPTION_1(std::invalid_argument,"Error decoding a cbor at position %s", std::to_string(end-pos));
+        }
+    }
+
+    // If tag is an RFC 8746 typed array tag and the item at it a byte string, sets info, the
+    // position and length of the elements and the position past the byte string, and returns true.
+    // The elements of a definite length byte string are left in place, those of an indefinite
+    // length one are gathered in storage.
+    inline
+    bool get_typed_array(uint64_t tag, const uint8_t* it, const uint8_t* end,
+                         typed_array_info& info, std::vector<uint8_t>& storage,
+                         const uint8_t*& data, size_t& length, const uint8_t*& next)
+    {
+        if (!get_typed_array_info(tag, info) || it >= end || (*it >> 5) != 2)
+        {
+            return false;
+        }
+        const uint8_t* pos = it++;
+        const uint8_t arg = *pos & 0x1f;
+        uint64_t len;
+        if (arg < 24)
+        {
+            len = arg;
+        }
+        else if (arg < 28)
+        {
+            const size_t n = static_cast<size_t>(1) << (arg - 24);
+            if (static_cast<size_t>(end - it) < n)
+            {
+                JSONCONS_THROW_EXCEPTION(std::invalid_argument,"eof");
+            }
+            len = 0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                len = (len << 8) | *it++;
+            }
+        }
+        else
+        {
+            std::tie(storage,next) = get_byte_string(pos, end);
+            data = storage.data();
+            len = storage.size();
+            it = nullptr;
+        }
+        if (it != nullptr)
+        {
+            if (static_cast<uint64_t>(end - it) < len)
+            {
+                JSONCONS_THROW_EXCEPTION(std::invalid_argument,"eof");
+            }
+            data = it;
+            next = it + static_cast<size_t>(len);
+        }
+        if (len % info.element_size != 0)
+        {
+            JSONCONS_THROW_EXCEPTION(std::invalid_argument,"Typed array length is not a multiple of its element length");
+        }
+        length = static_cast<size_t>(len);
+        return true;
+    }
+
     inline uint64_t get_uinteger(const uint8_t* it, const uint8_t* end)
     {
         const uint8_t* pos = it++;
@@ -274,6 +439,12 @@ namespace detail {
         return it;
     }
 
+    inline
+    bool is_byte_string(uint8_t b)
+    {
+        return (b >= 0x40 && b <= 0x5b) || b == 0x5f;
+    }
+
     inline
     bool is_string(uint8_t b)
     {
@@ -289,7 +460,7 @@ namespace detail {
     inline 
     bool is_object(uint8_t b) 
     {
-        return (b >= 0xa0 && b <= 0xbb) || b == 0xb8;
+        return (b >= 0xa0 && b <= 0xbb) || b == 0xbf;
     }
 
     inline const uint8_t* walk(const uint8_t* it, const uint8_t* end)
@@ -403,14 +574,11 @@ namespace detail {
             
         case 0x5f: // byte string (indefinite length)
             {
-                while (*it != 0xff)
+                while (it != end && *it != 0xff)
                 {
-                    if (it == end)
-                    {
-                        JSONCONS_THROW_EXCEPTION(std::invalid_argument,"eof");
-                    }
                     it = walk(it, end);
                 }
+                it = skip_break(it, end);
                 return it;
             }
 
@@ -451,14 +619,11 @@ namespace detail {
             // UTF-8 string (indefinite length)
         case 0x7f:
             {
-                while (*it != 0xff)
+                while (it != end && *it != 0xff)
                 {
-                    if (it == end)
-                    {
-                        JSONCONS_THROW_EXCEPTION(std::invalid_argument,"eof");
-                    }
                     it = walk(it, end);
                 }
+                it = skip_break(it, end);
                 return it;
             }
 
@@ -503,10 +668,11 @@ namespace detail {
             // array (indefinite length)
         case 0x9f:
             {
-                while (*it != 0xff)
+                while (it != end && *it != 0xff)
                 {
                     it = walk(it, end);
                 }
+                it = skip_break(it, end);
                 return it;
             }
 
@@ -551,14 +717,27 @@ namespace detail {
             // map (indefinite length)
         case 0xbf:
             {
-                while (*it != 0xff)
+                while (it != end && *it != 0xff)
                 {
                     it = walk(it, end);
                     it = walk(it, end);
                 }
+                it = skip_break(it, end);
                 return it;
             }
 
+            // Tags are skipped, the tagged data item follows
+        case JSONCONS_CBOR_0xc0_0xd7:
+        case 0xd8:
+        case 0xd9:
+        case 0xda:
+        case 0xdb:
+            {
+                uint64_t tag;
+                std::tie(tag,it) = get_tag(pos, end);
+                return walk(it, end);
+            }
+
             // False
         case 0xf4:
             {
@@ -653,12 +832,9 @@ namespace detail {
         case 0x9f: 
         {
             size_t len = 0;
-            while (*it != 0xff)
+            for (const uint8_t* p = it; p != end && *p != 0xff; ++len)
             {
-                size_t sz;
-                std::tie(sz,it) = size(it,end);
-                len += sz;
-                it = walk(it, end);
+                p = walk(p, end);
             }
             return std::make_tuple(len,it);
         }
@@ -705,10 +881,10 @@ namespace detail {
         case 0xbf: 
         {
             size_t len = 0;
-            while (*it != 0xff)
+            for (const uint8_t* p = it; p != end && *p != 0xff; ++len)
             {
-                it = walk(it, end);
-                it = walk(it, end);
+                p = walk(p, end);
+                p = walk(p, end);
             }
             return std::make_tuple(len,it);
         }
@@ -718,12 +894,58 @@ namespace detail {
     }
 }
 
+namespace detail {
+
+    // The offsets of the items of a CBOR array or map, and for a map a hash table of its keys
+    class cbor_view_index : public binary::detail::view_index
+    {
+    public:
+        cbor_view_index(const uint8_t* buffer, size_t buflen)
+            : view_index(is_object(buffer[0]))
+        {
+            const uint8_t* end = buffer + buflen;
+            const bool indefinite = buffer[0] == 0x9f || buffer[0] == 0xbf; 
+            size_t len = 0;
+            const uint8_t* it = buffer + 1;
+            if (!indefinite)
+            {
+                std::tie(len, it) = detail::size(buffer, end);
+            }
+            for (size_t i = 0; indefinite ? (it < end && *it != 0xff) : i < len; ++i)
+            {
+                if (stride_ == 2)
+                {
+                    offsets_.push_back(it - buffer);
+                    std::string key;
+                    std::tie(key,it) = get_fixed_length_text_string(it, end);
+                    keys_.push_back(std::move(key));
+                }
+                offsets_.push_back(it - buffer);
+                it = walk(it, end);
+            }
+            offsets_.push_back(it - buffer);
+            index_keys();
+        }
+    };
+}
+
 // cbor_view
 
+class cbor_view;
+
+template<class Json>
+Json decode_cbor(const cbor_view& v);
+
+namespace detail {
+    template <class T, class Enable = void>
+    struct cbor_view_as;
+}
+
 class cbor_view 
 {
     const uint8_t* buffer_;
     size_t buflen_; 
+    std::shared_ptr<const detail::cbor_view_index> index_;
 public:
     typedef cbor_view value_type;
     typedef cbor_view& reference;
@@ -755,7 +977,7 @@ public:
     }
 
     cbor_view(const cbor_view& other)
-        : buffer_(other.buffer_), buflen_(other.buflen_)
+        : buffer_(other.buffer_), buflen_(other.buflen_), index_(other.index_)
     {
 
     }
@@ -765,6 +987,7 @@ public:
     {
         std::swap(buffer_,other.buffer_);
         std::swap(buflen_,other.buflen_);
+        index_.swap(other.index_);
     }
 
     cbor_view& operator=(const cbor_view&) = default;
@@ -775,10 +998,30 @@ public:
         {
             std::swap(buffer_,other.buffer_);
             std::swap(buflen_,other.buflen_);
+            index_.swap(other.index_);
         }
         return *this;
     }
 
+    // Returns a view of the same array or map with an index of the offsets of its items,
+    // and for a map a hash table of its keys, so that size, at and has_key take constant
+    // rather than linear time. The index is built here, with one walk over the items, and 
+    // is shared by copies of the returned view. Views of the items are not indexed.
+    cbor_view indexed() const
+    {
+        cbor_view v(*this);
+        if (buflen_ > 0 && (is_array() || is_object()) && !index_)
+        {
+            v.index_ = std::make_shared<detail::cbor_view_index>(buffer_, buflen_);
+        }
+        return v;
+    }
+
+    bool is_indexed() const
+    {
+        return index_ != nullptr;
+    }
+
     const uint8_t* buffer() const
     {
         return buffer_;
@@ -801,8 +1044,37 @@ public:
         return detail::is_object(buffer_[0]);
     }
 
+    bool is_byte_string() const
+    {
+        JSONCONS_ASSERT(buflen_ > 0);
+        return detail::is_byte_string(buffer_[0]);
+    }
+
+    // The bytes of a byte string, in place in the buffer, without copying them. Throws
+    // std::invalid_argument if the item is not a byte string, or is an indefinite length
+    // one of more than one chunk, whose bytes are not together; as<byte_string>() gathers
+    // those with one copy.
+    byte_string_view as_byte_string_view() const
+    {
+        if (buflen_ == 0 || !is_byte_string())
+        {
+            JSONCONS_THROW_EXCEPTION(std::invalid_argument,"Not a byte string");
+        }
+        byte_string_view bs(nullptr, 0);
+        const uint8_t* next;
+        if (!detail::get_contiguous_byte_string_view(buffer_, buffer_ + buflen_, bs, next))
+        {
+            JSONCONS_THROW_EXCEPTION(std::invalid_argument,"Byte string is not contiguous");
+        }
+        return bs;
+    }
+
     size_t size() const
     {
+        if (index_)
+        {
+            return index_->size();
+        }
         size_t len;
         const uint8_t* it;
         std::tie(len, it) = detail::size(buffer_,buffer_+buflen_);
@@ -812,6 +1084,14 @@ public:
     cbor_view at(size_t index) const
     {
         JSONCONS_ASSERT(is_array());
+        if (index_)
+        {
+            if (index >= index_->size())
+            {
+                JSONCONS_THROW_EXCEPTION(std::out_of_range,"Invalid array subscript");
+            }
+            return item(index);
+        }
         size_t len;
         const uint8_t* it = buffer_;
         const uint8_t* end = buffer_ + buflen_;
@@ -831,6 +1111,15 @@ public:
     cbor_view at(const string_view_type& key) const
     {
         JSONCONS_ASSERT(is_object());
+        if (index_)
+        {
+            const size_t pos = index_->find(key);
+            if (pos == index_->size())
+            {
+                JSONCONS_THROW_EXCEPTION(std::runtime_error,"Key not found");
+            }
+            return item(pos);
+        }
         size_t len;
         const uint8_t* it = buffer_;
         const uint8_t* end = buffer_ + buflen_;
@@ -853,12 +1142,74 @@ public:
         JSONCONS_THROW_EXCEPTION(std::runtime_error,"Key not found");
     }
 
+    // Sets ec, and returns an empty view, if the view is not an array or index is out of range
+    cbor_view at(size_t index, std::error_code& ec) const
+    {
+        if (buflen_ == 0 || !is_array())
+        {
+            ec = json_errc::not_an_array;
+            return cbor_view();
+        }
+        if (index >= size())
+        {
+            ec = json_errc::index_out_of_range;
+            return cbor_view();
+        }
+        ec.clear();
+        return index_ ? item(index) : value(index);
+    }
+
+    // Sets ec, and returns an empty view, if the view is not a map or has no member key
+    cbor_view at(const string_view_type& key, std::error_code& ec) const
+    {
+        if (buflen_ == 0 || !is_object())
+        {
+            ec = json_errc::not_an_object;
+            return cbor_view();
+        }
+        if (index_)
+        {
+            const size_t pos = index_->find(key);
+            if (pos == index_->size())
+            {
+                ec = json_errc::key_not_found;
+                return cbor_view();
+            }
+            ec.clear();
+            return item(pos);
+        }
+        size_t len;
+        const uint8_t* it = buffer_;
+        const uint8_t* end = buffer_ + buflen_;
+
+        std::tie(len, it) = detail::size(buffer_, end);
+
+        for (size_t i = 0; i < len; ++i)
+        {
+            string_type a_key;
+            std::tie(a_key,it) = detail::get_fixed_length_text_string(it, end);
+            const uint8_t* last = detail::walk(it, end);
+            if (a_key == key)
+            {
+                ec.clear();
+                return cbor_view(it,last-it);
+            }
+            it = last;
+        }
+        ec = json_errc::key_not_found;
+        return cbor_view();
+    }
+
     bool has_key(const string_view_type& key) const
     {
         if (!is_object())
         {
             return false;
         }
+        if (index_)
+        {
+            return index_->find(key) != index_->size();
+        }
         size_t len;
         const uint8_t* it = buffer_;
         const uint8_t* end = buffer_ + buflen_;
@@ -877,14 +1228,206 @@ public:
         }
         return false;
     }
+
+    // The key of the member at position pos of a map, in encoded order
+    string_type key(size_t pos) const
+    {
+        JSONCONS_ASSERT(is_object());
+        if (index_)
+        {
+            check_position(pos, index_->size());
+            return index_->key(pos);
+        }
+        string_type a_key;
+        const uint8_t* it = nth(pos);
+        std::tie(a_key,it) = detail::get_fixed_length_text_string(it, buffer_ + buflen_);
+        return a_key;
+    }
+
+    // A view of the element at position pos of an array, or of the value of the member
+    // at position pos of a map. Iterating over the members of a map with key and value
+    // takes linear time with an indexed view, and quadratic time without.
+    cbor_view value(size_t pos) const
+    {
+        JSONCONS_ASSERT(is_array() || is_object());
+        if (index_)
+        {
+            check_position(pos, index_->size());
+            return item(pos);
+        }
+        const uint8_t* end = buffer_ + buflen_;
+        const uint8_t* it = nth(pos);
+        if (is_object())
+        {
+            it = detail::walk(it, end);
+        }
+        const uint8_t* last = detail::walk(it, end);
+        return cbor_view(it,last-it);
+    }
+
+    // Decodes the data item, e.g. as<int64_t>() or as<std::string>(). as<std::vector<T>>()
+    // for T an integer type, float or double decodes straight into the vector, from a
+    // typed array with memcpy if its tag matches T, or from an array item by item.
+    template <class T>
+    T as() const
+    {
+        return detail::cbor_view_as<T>::as(*this);
+    }
+private:
+    cbor_view item(size_t pos) const
+    {
+        auto offsets = index_->value(pos);
+        return cbor_view(buffer_ + offsets.first, offsets.second - offsets.first);
+    }
+
+    static void check_position(size_t pos, size_t size)
+    {
+        if (pos >= size)
+        {
+            JSONCONS_THROW_EXCEPTION(std::out_of_range,"Invalid position");
+        }
+    }
+
+    // The position of the element at pos of an array, or of the key of the member at pos of a map
+    const uint8_t* nth(size_t pos) const
+    {
+        size_t len;
+        const uint8_t* it;
+        const uint8_t* end = buffer_ + buflen_;
+        std::tie(len, it) = detail::size(buffer_, end);
+        check_position(pos, len);
+        const bool is_map = is_object();
+        for (size_t i = 0; i < pos; ++i)
+        {
+            if (is_map)
+            {
+                it = detail::walk(it, end);
+            }
+            it = detail::walk(it, end);
+        }
+        return it;
+    }
 };
 
+namespace detail {
+    template <class T, class Enable>
+    struct cbor_view_as
+    {
+        static T as(const cbor_view& v)
+        {
+            return decode_cbor<json>(v).template as<T>();
+        }
+    };
+
+    template <class T>
+    struct cbor_view_as<std::vector<T>,typename std::enable_if<typed_array_traits<T>::value>::type>
+    {
+        static std::vector<T> as(const cbor_view& v)
+        {
+            std::vector<T> result;
+            const uint8_t* it = v.buffer();
+            const uint8_t* end = v.buffer() + v.buflen();
+            if (it < end && (*it >> 5) == 6)
+            {
+                uint64_t tag;
+                const uint8_t* item;
+                std::tie(tag,item) = get_tag(it, end);
+
+                typed_array_info info;
+                std::vector<uint8_t> storage;
+                const uint8_t* data;
+                size_t length;
+                const uint8_t* next;
+                if (get_typed_array(tag, item, end, info, storage, data, length, next))
+                {
+                    copy_typed_array(tag, info, data, length/info.element_size, result);
+                    return result;
+                }
+            }
+            if (it < end && is_array(*it))
+            {
+                size_t len;
+                std::tie(len, it) = size(it, end);
+                // Each element takes at least one byte
+                result.reserve((std::min)(len, static_cast<size_t>(end - it)));
+                for (size_t i = 0; i < len; ++i)
+                {
+                    const uint8_t* last = walk(it, end);
+                    result.push_back(decode_cbor<json>(cbor_view(it, last - it)).template as<T>());
+                    it = last;
+                }
+                return result;
+            }
+            return decode_cbor<json>(v).template as<std::vector<T>>();
+        }
+    };
+
+    // Copies the bytes of a byte string once, without decoding through json
+    template <class Allocator>
+    struct cbor_view_as<basic_byte_string<Allocator>>
+    {
+        static basic_byte_string<Allocator> as(const cbor_view& v)
+        {
+            const uint8_t* it = v.buffer();
+            const uint8_t* end = v.buffer() + v.buflen();
+            if (it < end && is_byte_string(*it))
+            {
+                byte_string_view bs(nullptr, 0);
+                const uint8_t* next;
+                if (get_contiguous_byte_string_view(it, end, bs, next))
+                {
+                    return basic_byte_string<Allocator>(bs);
+                }
+                std::vector<uint8_t> bytes;
+                std::tie(bytes,next) = get_byte_string(it, end);
+                return basic_byte_string<Allocator>(byte_string_view(bytes.data(), bytes.size()));
+            }
+            return decode_cbor<json>(v).template as<basic_byte_string<Allocator>>();
+        }
+    };
+
+    // Decodes straight into any basic_json, e.g. ojson, rather than through json
+    template <class T>
+    struct cbor_view_as<T,typename std::enable_if<jsoncons::detail::is_basic_json<T>::value>::type>
+    {
+        static T as(const cbor_view& v)
+        {
+            return decode_cbor<T>(v);
+        }
+    };
+}
+
+// Appends to a vector in one pass, without sizing the output first
 struct Encode_cbor_
 {
     template <typename T>
-    void operator()(T val, std::vector<uint8_t>& v)
+    void operator()(T val, binary::detail::output_buffer& out)
     {
-        binary::detail::to_big_endian(val,v);
+        out.put(val);
+    }
+
+    void operator()(const uint8_t* data, size_t length, binary::detail::output_buffer& out)
+    {
+        out.write(data, length);
+    }
+};
+
+// Writes into memory already sized with Calculate_size_
+struct Write_cbor_
+{
+    template <typename T>
+    void operator()(T val, uint8_t*& p)
+    {
+        binary::detail::to_big_endian(val,p);
+    }
+
+    void operator()(const uint8_t* data, size_t length, uint8_t*& p)
+    {
+        if (length > 0)
+        {
+            std::memcpy(p, data, length);
+            p += length;
+        }
     }
 };
 
@@ -895,6 +1438,11 @@ struct Calculate_size_
     {
         size += sizeof(T);
     }
+
+    void operator()(const uint8_t*, size_t length, size_t& size)
+    {
+        size += length;
+    }
 };
   
 template<class Json>
@@ -1013,12 +1561,35 @@ struct cbor_Encoder_
 
         case json_type_tag::byte_string_t:
             {
-                encode_byte_string(jval. template as<std::vector<uint8_t>>(), action, v);
+                encode_byte_string(jval.as_byte_string_view(), action, v);
                 break;
             }
 
+        case json_type_tag::small_number_t:
+        case json_type_tag::number_t:
+        {
+            // A number kept as text is encoded as the integer or double it converts to
+            auto text = jval.number_text();
+            jsoncons::detail::number_text_value value = jsoncons::detail::read_number_text(text.data(), text.length());
+            switch (value.kind)
+            {
+                case jsoncons::detail::number_text_kind::integer:
+                    encode(Json(value.integer), action, v);
+                    break;
+                case jsoncons::detail::number_text_kind::uinteger:
+                    encode(Json(value.uinteger), action, v);
+                    break;
+                default:
+                    encode(Json(value.floating_point), action, v);
+                    break;
+            }
+            break;
+        }
+
         case json_type_tag::small_string_t:
         case json_type_tag::string_t:
+        case json_type_tag::string_view_t:
+        case json_type_tag::escaped_string_t:
             {
                 encode_string(jval.as_string_view(), action, v);
                 break;
@@ -1026,27 +1597,7 @@ struct cbor_Encoder_
 
         case json_type_tag::array_t:
             {
-                const auto length = jval.array_value().size();
-                if (length <= 0x17)
-                {
-                    action(static_cast<uint8_t>(static_cast<uint8_t>(0x80 + length)), v);
-                } else if (length <= 0xff)
-                {
-                    action(static_cast<uint8_t>(0x98), v);
-                    action(static_cast<uint8_t>(static_cast<uint8_t>(length)), v);
-                } else if (length <= 0xffff)
-                {
-                    action(static_cast<uint8_t>(0x99), v);
-                    action(static_cast<uint16_t>(length),v);
-                } else if (length <= 0xffffffff)
-                {
-                    action(static_cast<uint8_t>(0x9a), v);
-                    action(static_cast<uint32_t>(length),v);
-                } else if (length <= 0xffffffffffffffff)
-                {
-                    action(static_cast<uint8_t>(0x9b), v);
-                    action(static_cast<uint64_t>(length),v);
-                }
+                encode_array_length(jval.array_value().size(), action, v);
 
                 // append each element
                 for (const auto& el : jval.array_range())
@@ -1098,6 +1649,23 @@ struct cbor_Encoder_
 
     template <class Action,class Result>
     static void encode_string(const string_view_type& sv, Action action, Result& v)
+    {
+        encode_string(sv, action, v, std::integral_constant<bool,sizeof(typename Json::char_type) == sizeof(uint8_t)>());
+    }
+
+    // UTF-8 strings are written as they are, once validated
+    template <class Action,class Result>
+    static void encode_string(const string_view_type& sv, Action action, Result& v, std::true_type)
+    {
+        if (!jsoncons::detail::is_valid_utf8(sv.data(), sv.length()))
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Illegal unicode");
+        }
+        encode_utf8(reinterpret_cast<const uint8_t*>(sv.data()), sv.length(), action, v);
+    }
+
+    template <class Action,class Result>
+    static void encode_string(const string_view_type& sv, Action action, Result& v, std::false_type)
     {
         std::basic_string<uint8_t> target;
         auto result = unicons::convert(
@@ -1107,8 +1675,37 @@ struct cbor_Encoder_
         {
             JSONCONS_THROW_EXCEPTION(std::runtime_error,"Illegal unicode");
         }
+        encode_utf8(target.data(), target.length(), action, v);
+    }
 
-        const size_t length = target.length();
+    template <class Action, class Result>
+    static void encode_array_length(uint64_t length, Action action, Result& v)
+    {
+        if (length <= 0x17)
+        {
+            action(static_cast<uint8_t>(static_cast<uint8_t>(0x80 + length)), v);
+        } else if (length <= 0xff)
+        {
+            action(static_cast<uint8_t>(0x98), v);
+            action(static_cast<uint8_t>(static_cast<uint8_t>(length)), v);
+        } else if (length <= 0xffff)
+        {
+            action(static_cast<uint8_t>(0x99), v);
+            action(static_cast<uint16_t>(length),v);
+        } else if (length <= 0xffffffff)
+        {
+            action(static_cast<uint8_t>(0x9a), v);
+            action(static_cast<uint32_t>(length),v);
+        } else
+        {
+            action(static_cast<uint8_t>(0x9b), v);
+            action(static_cast<uint64_t>(length),v);
+        }
+    }
+
+    template <class Action,class Result>
+    static void encode_utf8(const uint8_t* data, size_t length, Action action, Result& v)
+    {
         if (length <= 0x17)
         {
             // fixstr stores a byte array whose length is upto 31 bytes
@@ -1135,16 +1732,13 @@ struct cbor_Encoder_
             action(static_cast<uint64_t>(length),v);
         }
 
-        for (size_t i = 0; i < length; ++i)
-        {
-            action(static_cast<uint8_t>(target.data()[i]), v);
-        }
+        action(data, length, v);
     }
 
     template <class Action,class Result>
-    static void encode_byte_string(const std::vector<uint8_t>& target, Action action, Result& v)
+    static void encode_byte_string(const byte_string_view& target, Action action, Result& v)
     {
-        const size_t length = target.size();
+        const size_t length = target.length();
         if (length <= 0x17)
         {
             // fixstr stores a byte array whose length is upto 31 bytes
@@ -1171,10 +1765,7 @@ struct cbor_Encoder_
             action(static_cast<uint64_t>(length),v);
         }
 
-        for (size_t i = 0; i < length; ++i)
-        {
-            action(static_cast<uint8_t>(target.data()[i]), v);
-        }
+        action(target.data(), length, v);
     }
 };
 
@@ -1186,16 +1777,29 @@ class Decode_cbor_
     const uint8_t* begin_;
     const uint8_t* end_;
     const uint8_t* it_;
+    binary::decode_limits limits_;
+    size_t depth_;
 public:
     typedef typename Json::char_type char_type;
+    typedef typename Json::key_value_pair_type key_value_pair_type;
+    typedef typename Json::key_storage_type key_storage_type;
 
     Decode_cbor_(const uint8_t* begin, const uint8_t* end)
-        : begin_(begin), end_(end), it_(begin)
+        : begin_(begin), end_(end), it_(begin), depth_(0)
+    {
+    }
+
+    Decode_cbor_(const uint8_t* begin, const uint8_t* end, const binary::decode_limits& limits)
+        : begin_(begin), end_(end), it_(begin), limits_(limits), depth_(0)
     {
     }
 
     Json decode()
     {
+        if (it_ >= end_)
+        {
+            error(cbor_parser_errc::unexpected_eof, it_);
+        }
         const uint8_t* pos = it_++;
         switch (*pos)
         {
@@ -1277,10 +1881,26 @@ public:
         case 0x59:
         case 0x5a:
         case 0x5b:
+            {
+                // Constructed from the bytes in place, without a temporary
+                byte_string_view bs(nullptr, 0);
+                std::tie(bs,it_) = detail::get_fixed_length_byte_string_view(pos,end_);
+                check_string_length(bs.length(), pos);
+                return Json(bs.data(),bs.length());
+            }
         case 0x5f:
             {
+                byte_string_view bs(nullptr, 0);
+                const uint8_t* next;
+                if (detail::get_contiguous_byte_string_view(pos, end_, bs, next))
+                {
+                    it_ = next;
+                    check_string_length(bs.length(), pos);
+                    return Json(bs.data(),bs.length());
+                }
                 std::vector<uint8_t> v;
                 std::tie(v,it_) = detail::get_byte_string(pos,end_);
+                check_string_length(v.size(), pos);
                 return Json(v.data(),v.size());
             }
 
@@ -1294,6 +1914,7 @@ public:
             {
                 std::string s;
                 std::tie(s,it_) = detail::get_text_string(pos,end_);
+                check_string_length(s.size(), pos);
                 std::basic_string<char_type> target;
                 auto result = unicons::convert(s.begin(),s.end(),std::back_inserter(target),unicons::conv_flags::strict);
                 if (result.ec != unicons::conv_errc())
@@ -1306,7 +1927,7 @@ public:
             // array (0x00..0x17 data items follow)
         case JSONCONS_CBOR_0x80_0x97:
             {
-                return get_fixed_length_array(*pos & 0x1f);
+                return get_fixed_length_array(pos, *pos & 0x1f);
             }
 
             // array (one-byte uint8_t for n follows)
@@ -1314,7 +1935,7 @@ public:
             {
                 const auto len = binary::detail::from_big_endian<uint8_t>(it_,end_);
                 it_ += sizeof(uint8_t);
-                return get_fixed_length_array(len);
+                return get_fixed_length_array(pos, len);
             }
 
             // array (two-byte uint16_t for n follow)
@@ -1322,41 +1943,44 @@ public:
             {
                 const auto len = binary::detail::from_big_endian<uint16_t>(it_,end_);
                 it_ += sizeof(uint16_t);
-                return get_fixed_length_array(len);
+                return get_fixed_length_array(pos, len);
             }
 
             // array (four-byte uint32_t for n follow)
         case 0x9a:
             {
-                const auto len = binary::detail::from_big_endian<int32_t>(it_,end_);
+                const auto len = binary::detail::from_big_endian<uint32_t>(it_,end_);
                 it_ += sizeof(uint32_t);
-                return get_fixed_length_array(len);
+                return get_fixed_length_array(pos, len);
             }
 
             // array (eight-byte uint64_t for n follow)
         case 0x9b:
             {
-                const auto len = binary::detail::from_big_endian<int64_t>(it_,end_);
+                const auto len = binary::detail::from_big_endian<uint64_t>(it_,end_);
                 it_ += sizeof(uint64_t);
-                return get_fixed_length_array(len);
+                return get_fixed_length_array(pos, len);
             }
 
             // array (indefinite length)
         case 0x9f:
             {
+                begin_container(pos, 0);
                 Json result = typename Json::array();
-                while (*pos != 0xff)
+                while (it_ != end_ && *it_ != 0xff)
                 {
+                    check_items(result.size() + 1, pos);
                     result.push_back(decode());
-                    pos = it_;
                 }
+                it_ = detail::skip_break(it_, end_);
+                --depth_;
                 return result;
             }
 
             // map (0x00..0x17 pairs of data items follow)
         case JSONCONS_CBOR_0xa0_0xb7:
             {
-                return get_fixed_length_map(*pos & 0x1f);
+                return get_fixed_length_map(pos, *pos & 0x1f);
             }
 
             // map (one-byte uint8_t for n follows)
@@ -1364,7 +1988,7 @@ public:
             {
                 const auto len = binary::detail::from_big_endian<uint8_t>(it_,end_);
                 it_ += sizeof(uint8_t);
-                return get_fixed_length_map(len);
+                return get_fixed_length_map(pos, len);
             }
 
             // map (two-byte uint16_t for n follow)
@@ -1372,7 +1996,7 @@ public:
             {
                 const auto len = binary::detail::from_big_endian<uint16_t>(it_,end_);
                 it_ += sizeof(uint16_t);
-                return get_fixed_length_map(len);
+                return get_fixed_length_map(pos, len);
             }
 
             // map (four-byte uint32_t for n follow)
@@ -1380,7 +2004,7 @@ public:
             {
                 const auto len = binary::detail::from_big_endian<uint32_t>(it_,end_);
                 it_ += sizeof(uint32_t);
-                return get_fixed_length_map(len);
+                return get_fixed_length_map(pos, len);
             }
 
             // map (eight-byte uint64_t for n follow)
@@ -1388,19 +2012,50 @@ public:
             {
                 const auto len = binary::detail::from_big_endian<uint64_t>(it_,end_);
                 it_ += sizeof(uint64_t);
-                return get_fixed_length_map(len);
+                return get_fixed_length_map(pos, len);
             }
 
             // map (indefinite length)
         case 0xbf:
             {
-                Json result = typename Json::object();
-                while (*pos != 0xff)
+                begin_container(pos, 0);
+                std::vector<key_value_pair_type> members;
+                while (it_ != end_ && *it_ != 0xff)
                 {
-                    auto j = decode();
-                    result.set(j.as_string_view(),decode());
-                    pos = it_;
+                    check_items(members.size() + 1, pos);
+                    decode_member(members);
                 }
+                it_ = detail::skip_break(it_, end_);
+                --depth_;
+                return make_object(members);
+            }
+
+            // Typed arrays are decoded as arrays of numbers, other tags are skipped
+        case JSONCONS_CBOR_0xc0_0xd7:
+        case 0xd8:
+        case 0xd9:
+        case 0xda:
+        case 0xdb:
+            {
+                uint64_t tag;
+                const uint8_t* item;
+                std::tie(tag,item) = detail::get_tag(pos,end_);
+
+                detail::typed_array_info info;
+                std::vector<uint8_t> storage;
+                const uint8_t* data;
+                size_t length;
+                const uint8_t* next;
+                if (detail::get_typed_array(tag, item, end_, info, storage, data, length, next))
+                {
+                    it_ = next;
+                    check_items(length/info.element_size, pos);
+                    return get_typed_array(info, data, length/info.element_size);
+                }
+                it_ = item;
+                begin_container(pos, 0);
+                Json result = decode();
+                --depth_;
                 return result;
             }
 
@@ -1456,45 +2111,237 @@ public:
         }
     }
 
+    struct typed_array_decoder
+    {
+        Json& result_;
+
+        void uinteger_value(uint64_t value)
+        {
+            result_.push_back(Json(value));
+        }
+
+        void integer_value(int64_t value)
+        {
+            result_.push_back(Json(value));
+        }
+
+        void double_value(double value)
+        {
+            result_.push_back(Json(value));
+        }
+    };
+
+    Json get_typed_array(const detail::typed_array_info& info, const uint8_t* data, size_t count)
+    {
+        Json result = typename Json::array();
+        result.reserve(count);
+        typed_array_decoder decoder{result};
+        detail::visit_typed_array(info, data, count, decoder);
+        return result;
+    }
+
     template<typename T>
-    Json get_fixed_length_array(const T len)
+    Json get_fixed_length_array(const uint8_t* pos, const T len)
     {
+        begin_container(pos, len);
+        // Each element takes at least one byte
         Json result = typename Json::array();
-        result.reserve(len);
+        result.reserve(static_cast<size_t>((std::min)(static_cast<uint64_t>(len), static_cast<uint64_t>(end_ - it_))));
         for (T i = 0; i < len; ++i)
         {
             result.push_back(decode());
         }
+        --depth_;
         return result;
     }
 
     template<typename T>
-    Json get_fixed_length_map(const T len)
+    Json get_fixed_length_map(const uint8_t* pos, const T len)
     {
-        Json result = typename Json::object();
-        result.reserve(len);
+        begin_container(pos, len);
+        // Each member takes at least two bytes
+        std::vector<key_value_pair_type> members;
+        members.reserve(static_cast<size_t>((std::min)(static_cast<uint64_t>(len), static_cast<uint64_t>(end_ - it_)/2)));
         for (T i = 0; i < len; ++i)
         {
-            auto j = decode();
-            result.set(j.as_string_view(),decode());
+            decode_member(members);
+        }
+        --depth_;
+        return make_object(members);
+    }
+
+    void begin_container(const uint8_t* pos, uint64_t len)
+    {
+        if (++depth_ > limits_.max_nesting_depth)
+        {
+            error(cbor_parser_errc::max_depth_exceeded, pos);
+        }
+        check_items(len, pos);
+    }
+
+    void check_items(uint64_t count, const uint8_t* pos) const
+    {
+        if (count > limits_.max_items)
+        {
+            error(cbor_parser_errc::max_items_exceeded, pos);
+        }
+    }
+
+    void check_string_length(size_t length, const uint8_t* pos) const
+    {
+        if (length > limits_.max_string_length)
+        {
+            error(cbor_parser_errc::max_string_length_exceeded, pos);
+        }
+    }
+
+    void error(cbor_parser_errc ec, const uint8_t* pos) const
+    {
+        throw parse_error(ec, 1, (pos - begin_) + 1);
+    }
+
+    void decode_member(std::vector<key_value_pair_type>& members)
+    {
+        key_storage_type key = decode_key();
+        members.emplace_back(std::move(key), decode());
+    }
+
+    // Reads a definite length text string key straight into the key storage, without
+    // a temporary Json. Keys of other kinds are decoded, and must be strings.
+    key_storage_type decode_key()
+    {
+        if (it_ >= end_)
+        {
+            error(cbor_parser_errc::unexpected_eof, it_);
         }
+        const uint8_t* pos = it_;
+        if (*pos >= 0x60 && *pos <= 0x7b)
+        {
+            byte_string_view bytes(nullptr, 0);
+            std::tie(bytes,it_) = detail::get_fixed_length_text_string_view(pos, end_);
+            check_string_length(bytes.length(), pos);
+            key_storage_type key;
+            if (!binary::detail::assign_utf8(key, bytes.data(), bytes.data() + bytes.length()))
+            {
+                JSONCONS_THROW_EXCEPTION(std::runtime_error,"Illegal unicode");
+            }
+            return key;
+        }
+        auto j = decode();
+        auto name = j.as_string_view();
+        return key_storage_type(name.begin(), name.end());
+    }
+
+    // Builds the object with one sort of all the members, the last of duplicates wins
+    static Json make_object(std::vector<key_value_pair_type>& members)
+    {
+        Json result = typename Json::object();
+        result.object_value().insert(std::make_move_iterator(members.begin()), std::make_move_iterator(members.end()),
+                                     [](key_value_pair_type&& member){return std::move(member);});
         return result;
     }
 };
 
+template<class Json>
+size_t encoded_cbor_size(const Json& j)
+{
+    return cbor_Encoder_<Json>::calculate_size(j);
+}
+
 template<class Json>
 std::vector<uint8_t> encode_cbor(const Json& j)
 {
-    size_t n = 0;
-    cbor_Encoder_<Json>::encode(j,Calculate_size_(),n);
+    const size_t n = cbor_Encoder_<Json>::calculate_size(j);
+    std::vector<uint8_t> v(n);
+    uint8_t* p = v.data();
+    cbor_Encoder_<Json>::encode(j,Write_cbor_(),p);
+    return v;
+}
 
-    std::vector<uint8_t> v;
-    v.reserve(n);
+// Appends the encoding to v in one pass. v grows by doubling and is then trimmed
+// to the encoding, so a vector that is cleared and reused does not reallocate.
+template<class Json>
+void encode_cbor(const Json& j, std::vector<uint8_t>& v)
+{
+    binary::detail::output_buffer out(v);
+    cbor_Encoder_<Json>::encode(j,Encode_cbor_(),out);
+    out.commit();
+}
 
-    cbor_Encoder_<Json>::encode(j,Encode_cbor_(),v);
+// Appends the encoding to v as encode_cbor(j, v) does. If j is an array, its elements are
+// encoded in chunks of about options.chunk_size() bytes on up to options.max_threads()
+// threads, each chunk into a vector of its own, and appended to v in order after the
+// array's definite length.
+template<class Json>
+void encode_cbor(const Json& j, std::vector<uint8_t>& v, const parallel_array_options& options)
+{
+    if (!j.is_array() || j.size() == 0)
+    {
+        encode_cbor(j, v);
+        return;
+    }
+    {
+        binary::detail::output_buffer out(v);
+        cbor_Encoder_<Json>::encode_array_length(j.size(),Encode_cbor_(),out);
+        out.commit();
+    }
+    auto elements = j.array_range();
+    auto encode = [&elements](size_t first, size_t last, std::vector<uint8_t>& buffer)
+    {
+        binary::detail::output_buffer out(buffer);
+        for (auto it = elements.begin() + first; it != elements.begin() + last; ++it)
+        {
+            cbor_Encoder_<Json>::encode(*it,Encode_cbor_(),out);
+        }
+        out.commit();
+    };
+    auto size = [](const std::vector<uint8_t>& buffer)
+    {
+        return buffer.size();
+    };
+    auto write = [&v](const std::vector<uint8_t>& buffer)
+    {
+        v.insert(v.end(), buffer.begin(), buffer.end());
+    };
+    jsoncons::detail::write_chunks_ordered<std::vector<uint8_t>>(j.size(), options, encode, size, write);
+}
+
+// Appends the elements as an RFC 8746 typed array in the byte order of the host, a tag
+// and a byte string copied from the vector's memory
+template<class T>
+typename std::enable_if<detail::typed_array_traits<T>::value,void>::type
+encode_cbor(const std::vector<T>& data, std::vector<uint8_t>& v)
+{
+    binary::detail::output_buffer out(v);
+    out.put(static_cast<uint8_t>(0xd8));
+    out.put(detail::typed_array_traits<T>::tag());
+    cbor_Encoder_<json>::encode_byte_string(byte_string_view(reinterpret_cast<const uint8_t*>(data.data()), data.size()*sizeof(T)), 
+                                            Encode_cbor_(), out);
+    out.commit();
+}
+
+template<class T>
+typename std::enable_if<detail::typed_array_traits<T>::value,std::vector<uint8_t>>::type
+encode_cbor(const std::vector<T>& data)
+{
+    std::vector<uint8_t> v;
+    encode_cbor(data, v);
     return v;
 }
 
+// Returns the encoded size. If it is greater than capacity, nothing is written.
+template<class Json>
+size_t encode_cbor(const Json& j, uint8_t* data, size_t capacity)
+{
+    const size_t n = cbor_Encoder_<Json>::calculate_size(j);
+    if (n <= capacity)
+    {
+        uint8_t* p = data;
+        cbor_Encoder_<Json>::encode(j,Write_cbor_(),p);
+    }
+    return n;
+}
+
 template<class Json>
 Json decode_cbor(const cbor_view& v)
 {
@@ -1502,6 +2349,13 @@ Json decode_cbor(const cbor_view& v)
     return decoder.decode();
 }
 
+template<class Json>
+Json decode_cbor(const cbor_view& v, const binary::decode_limits& limits)
+{
+    Decode_cbor_<Json> decoder(v.buffer(),v.buffer()+v.buflen(),limits);
+    return decoder.decode();
+}
+
 }}
 
 #endif
@@ -0,0 +1,93 @@
+/// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_CBOR_CBOR_ERROR_CATEGORY_HPP
+#define JSONCONS_CBOR_CBOR_ERROR_CATEGORY_HPP
+
+#include <system_error>
+#include <jsoncons/json_exception.hpp>
+
+namespace jsoncons { namespace cbor {
+
+    enum class cbor_parser_errc : int
+    {
+        ok = 0,
+        unexpected_eof = 1,
+        source_error = 2,
+        invalid_initial_byte = 3,
+        unexpected_break = 4,
+        invalid_string_chunk = 5,
+        invalid_key = 6,
+        max_depth_exceeded = 7,
+        extra_data = 8,
+        invalid_typed_array = 9,
+        max_items_exceeded = 10,
+        max_string_length_exceeded = 11
+    };
+
+class cbor_error_category_impl
+   : public std::error_category
+{
+public:
+    virtual const char* name() const JSONCONS_NOEXCEPT
+    {
+        return "cbor";
+    }
+    virtual std::string message(int ev) const
+    {
+        switch (static_cast<cbor_parser_errc>(ev))
+        {
+        case cbor_parser_errc::unexpected_eof:
+            return "Unexpected end of file";
+        case cbor_parser_errc::source_error:
+            return "Source error";
+        case cbor_parser_errc::invalid_initial_byte:
+            return "Invalid or unsupported CBOR initial byte";
+        case cbor_parser_errc::unexpected_break:
+            return "Break outside an indefinite length item";
+        case cbor_parser_errc::invalid_string_chunk:
+            return "Chunk of an indefinite length string is not a definite length string of the same type";
+        case cbor_parser_errc::invalid_key:
+            return "Map key is not a text string or an integer";
+        case cbor_parser_errc::max_depth_exceeded:
+            return "Maximum nesting depth exceeded";
+        case cbor_parser_errc::extra_data:
+            return "Unexpected data after the end of the CBOR data item";
+        case cbor_parser_errc::invalid_typed_array:
+            return "Typed array length is not a multiple of its element length";
+        case cbor_parser_errc::max_items_exceeded:
+            return "Maximum number of array elements or map members exceeded";
+        case cbor_parser_errc::max_string_length_exceeded:
+            return "Maximum string length exceeded";
+        default:
+            return "Unknown CBOR parser error";
+        }
+    }
+};
+
+inline
+const std::error_category& cbor_error_category()
+{
+  static cbor_error_category_impl instance;
+  return instance;
+}
+
+inline
+std::error_code make_error_code(cbor_parser_errc result)
+{
+    return std::error_code(static_cast<int>(result),cbor_error_category());
+}
+
+}}
+
+namespace std {
+    template<>
+    struct is_error_code_enum<jsoncons::cbor::cbor_parser_errc> : public true_type
+    {
+    };
+}
+
+#endif
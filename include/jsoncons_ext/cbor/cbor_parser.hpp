@@ -0,0 +1,748 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_CBOR_CBOR_PARSER_HPP
+#define JSONCONS_CBOR_CBOR_PARSER_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <system_error>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/json_input_handler.hpp>
+#include <jsoncons/parse_error_handler.hpp>
+#include <jsoncons_ext/binary/binary_utilities.hpp>
+#include <jsoncons_ext/cbor/cbor_error_category.hpp>
+#include <jsoncons_ext/cbor/cbor_typed_array.hpp>
+
+namespace jsoncons { namespace cbor {
+
+enum class cbor_parse_state : uint8_t
+{
+    start,
+    initial_byte,
+    argument,
+    payload,
+    done
+};
+
+// Parses a CBOR data item incrementally and reports it to a basic_json_input_handler
+// as it goes, so that a data item of any size can be decoded or transcoded to JSON without
+// holding all of it. Input is passed in pieces with set_source, and parse consumes as much
+// of each piece as it can, a data item may be split across pieces at any byte. Strings that
+// lie wholly within one piece are passed to the handler without copying, only strings that
+// span pieces, and the chunks of indefinite length strings, are gathered in a buffer.
+// RFC 8746 typed arrays are reported as arrays of numbers, other tags are skipped.
+
+class cbor_parser : private parsing_context
+{
+    typedef basic_json_input_handler<char>::string_view_type string_view_type;
+
+    static const size_t initial_stack_capacity_ = 64;
+
+    enum class container_type : uint8_t {array, map, byte_string, text_string};
+
+    struct container
+    {
+        container_type type_;
+        bool indefinite_;
+        uint64_t length_;
+        uint64_t count_;
+
+        container(container_type type, bool indefinite, uint64_t length)
+            : type_(type), indefinite_(indefinite), length_(length), count_(0)
+        {
+        }
+
+        bool expects_key() const
+        {
+            return type_ == container_type::map && count_ % 2 == 0;
+        }
+    };
+
+    basic_null_json_input_handler<char> default_input_handler_;
+    basic_json_input_handler<char>& handler_;
+
+    cbor_parse_state state_;
+    std::vector<container> stack_;
+    int nesting_depth_;
+    int peak_nesting_depth_;
+    int max_depth_;
+
+    const uint8_t* begin_input_;
+    const uint8_t* end_input_;
+    const uint8_t* p_;
+    size_t source_offset_;
+
+    uint8_t initial_byte_;
+    size_t argument_remaining_;
+    uint64_t argument_;
+    uint64_t payload_remaining_;
+    std::string buffer_;
+
+    // The last tag read, and the tag of the current data item
+    bool has_tag_;
+    uint64_t tag_;
+    bool item_has_tag_;
+    uint64_t item_tag_;
+
+    // Noncopyable and nonmoveable
+    cbor_parser(const cbor_parser&) = delete;
+    cbor_parser& operator=(const cbor_parser&) = delete;
+
+public:
+    cbor_parser()
+        : handler_(default_input_handler_)
+    {
+        init();
+    }
+
+    cbor_parser(basic_json_input_handler<char>& handler)
+        : handler_(handler)
+    {
+        init();
+    }
+
+    ~cbor_parser()
+    {
+    }
+
+    const parsing_context& parsing_context() const
+    {
+        return *this;
+    }
+
+    size_t max_nesting_depth() const
+    {
+        return static_cast<size_t>(max_depth_);
+    }
+
+    // The deepest nesting of arrays and maps since the last reset
+    size_t peak_nesting_depth() const
+    {
+        return static_cast<size_t>(peak_nesting_depth_);
+    }
+
+    void max_nesting_depth(size_t max_nesting_depth)
+    {
+        max_depth_ = static_cast<int>((std::min)(max_nesting_depth,static_cast<size_t>((std::numeric_limits<int>::max)())));
+    }
+
+    bool done() const
+    {
+        return state_ == cbor_parse_state::done;
+    }
+
+    bool source_exhausted() const
+    {
+        return p_ == end_input_;
+    }
+
+    // The number of bytes consumed since the parser was constructed or reset
+    size_t position() const
+    {
+        return source_offset_ + static_cast<size_t>(p_ - begin_input_);
+    }
+
+    size_t line_number() const
+    {
+        return 1;
+    }
+
+    // One more than the position, as a byte offset is the nearest thing CBOR has to a column
+    size_t column_number() const
+    {
+        return position() + 1;
+    }
+
+    cbor_parse_state state() const
+    {
+        return state_;
+    }
+
+    // Readies the parser for the next data item, from the rest of the current source or
+    // from a new one passed to set_source. The stack and the string buffer keep their capacity.
+    void reset()
+    {
+        stack_.clear();
+        state_ = cbor_parse_state::start;
+        nesting_depth_ = 0;
+        peak_nesting_depth_ = 0;
+        source_offset_ = 0;
+        begin_input_ = p_;
+        argument_remaining_ = 0;
+        argument_ = 0;
+        payload_remaining_ = 0;
+        buffer_.clear();
+        has_tag_ = false;
+        item_has_tag_ = false;
+    }
+
+    // The bytes are not copied, they must stay valid until parse has consumed them
+    void set_source(const uint8_t* input, size_t length)
+    {
+        source_offset_ += static_cast<size_t>(p_ - begin_input_);
+        begin_input_ = input;
+        end_input_ = input + length;
+        p_ = begin_input_;
+    }
+
+    void parse()
+    {
+        std::error_code ec;
+        parse(ec);
+        if (ec)
+        {
+            throw parse_error(ec,line_number(),column_number());
+        }
+    }
+
+    // Consumes the source until it is exhausted or the data item is complete
+    void parse(std::error_code& ec)
+    {
+        while (p_ < end_input_ && state_ != cbor_parse_state::done)
+        {
+            switch (state_)
+            {
+            case cbor_parse_state::start:
+                handler_.begin_json();
+                state_ = cbor_parse_state::initial_byte;
+                break;
+            case cbor_parse_state::initial_byte:
+                parse_initial_byte(ec);
+                if (ec) return;
+                break;
+            case cbor_parse_state::argument:
+                while (p_ < end_input_ && argument_remaining_ > 0)
+                {
+                    argument_ = (argument_ << 8) | *p_++;
+                    --argument_remaining_;
+                }
+                if (argument_remaining_ == 0)
+                {
+                    parse_item(ec);
+                    if (ec) return;
+                }
+                break;
+            case cbor_parse_state::payload:
+                {
+                    size_t n = static_cast<size_t>((std::min)(payload_remaining_, static_cast<uint64_t>(end_input_ - p_)));
+                    buffer_.append(reinterpret_cast<const char*>(p_), n);
+                    p_ += n;
+                    payload_remaining_ -= n;
+                    if (payload_remaining_ == 0)
+                    {
+                        end_payload(ec);
+                        if (ec) return;
+                    }
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    void end_parse()
+    {
+        std::error_code ec;
+        end_parse(ec);
+        if (ec)
+        {
+            throw parse_error(ec,line_number(),column_number());
+        }
+    }
+
+    // Reaching the end of the source before a data item has begun is not an error
+    void end_parse(std::error_code& ec)
+    {
+        if (!(state_ == cbor_parse_state::done || state_ == cbor_parse_state::start))
+        {
+            ec = cbor_parser_errc::unexpected_eof;
+        }
+    }
+
+    void check_done()
+    {
+        std::error_code ec;
+        check_done(ec);
+        if (ec)
+        {
+            throw parse_error(ec,line_number(),column_number());
+        }
+    }
+
+    // Checks that the data item is complete and that nothing follows it in the source
+    void check_done(std::error_code& ec)
+    {
+        if (state_ != cbor_parse_state::done)
+        {
+            ec = cbor_parser_errc::unexpected_eof;
+        }
+        else if (p_ != end_input_)
+        {
+            ec = cbor_parser_errc::extra_data;
+        }
+    }
+
+private:
+    void init()
+    {
+        state_ = cbor_parse_state::start;
+        nesting_depth_ = 0;
+        peak_nesting_depth_ = 0;
+        max_depth_ = (std::numeric_limits<int>::max)();
+        begin_input_ = nullptr;
+        end_input_ = nullptr;
+        p_ = nullptr;
+        source_offset_ = 0;
+        initial_byte_ = 0;
+        argument_remaining_ = 0;
+        argument_ = 0;
+        payload_remaining_ = 0;
+        has_tag_ = false;
+        tag_ = 0;
+        item_has_tag_ = false;
+        item_tag_ = 0;
+        stack_.reserve(initial_stack_capacity_);
+    }
+
+    void parse_initial_byte(std::error_code& ec)
+    {
+        initial_byte_ = *p_++;
+        const uint8_t major_type = initial_byte_ >> 5;
+        const uint8_t info = initial_byte_ & 0x1f;
+
+        if (!stack_.empty())
+        {
+            const container& top = stack_.back();
+            if ((top.type_ == container_type::byte_string || top.type_ == container_type::text_string) && initial_byte_ != 0xff &&
+                !(major_type == (top.type_ == container_type::byte_string ? 2 : 3) && info != 31))
+            {
+                ec = cbor_parser_errc::invalid_string_chunk;
+                return;
+            }
+        }
+        if (major_type != 6 && !in_indefinite_string())
+        {
+            item_has_tag_ = has_tag_;
+            item_tag_ = tag_;
+            has_tag_ = false;
+        }
+
+        if (info < 24)
+        {
+            argument_ = info;
+            parse_item(ec);
+        }
+        else if (info < 28)
+        {
+            argument_ = 0;
+            argument_remaining_ = static_cast<size_t>(1) << (info - 24);
+            state_ = cbor_parse_state::argument;
+        }
+        else if (info == 31)
+        {
+            switch (major_type)
+            {
+            case 2:
+                begin_indefinite_string(container_type::byte_string, ec);
+                break;
+            case 3:
+                begin_indefinite_string(container_type::text_string, ec);
+                break;
+            case 4:
+                begin_array(true, 0, ec);
+                break;
+            case 5:
+                begin_map(true, 0, ec);
+                break;
+            case 7:
+                parse_break(ec);
+                break;
+            default:
+                ec = cbor_parser_errc::invalid_initial_byte;
+                break;
+            }
+        }
+        else
+        {
+            ec = cbor_parser_errc::invalid_initial_byte;
+        }
+    }
+
+    // Handles a data item once its initial byte and argument have been read
+    void parse_item(std::error_code& ec)
+    {
+        state_ = cbor_parse_state::initial_byte;
+        switch (initial_byte_ >> 5)
+        {
+        case 0:
+            if (expects_key())
+            {
+                std::string name = std::to_string(argument_);
+                handler_.name(string_view_type(name.data(), name.length()), *this);
+            }
+            else
+            {
+                handler_.uinteger_value(argument_, *this);
+            }
+            end_item();
+            break;
+        case 1:
+            if (argument_ <= static_cast<uint64_t>((std::numeric_limits<int64_t>::max)()))
+            {
+                int64_t value = -1 - static_cast<int64_t>(argument_);
+                if (expects_key())
+                {
+                    std::string name = std::to_string(value);
+                    handler_.name(string_view_type(name.data(), name.length()), *this);
+                }
+                else
+                {
+                    handler_.integer_value(value, *this);
+                }
+            }
+            else if (expects_key())
+            {
+                ec = cbor_parser_errc::invalid_key;
+                return;
+            }
+            else
+            {
+                handler_.double_value(-1.0 - static_cast<double>(argument_), 0, *this);
+            }
+            end_item();
+            break;
+        case 2:
+        case 3:
+            begin_payload(ec);
+            break;
+        case 4:
+            begin_array(false, argument_, ec);
+            break;
+        case 5:
+            begin_map(false, argument_, ec);
+            break;
+        case 6:
+            // The tagged data item follows
+            has_tag_ = true;
+            tag_ = argument_;
+            break;
+        case 7:
+            parse_simple_or_float(ec);
+            break;
+        }
+    }
+
+    void parse_simple_or_float(std::error_code& ec)
+    {
+        const uint8_t info = initial_byte_ & 0x1f;
+        if (expects_key())
+        {
+            ec = cbor_parser_errc::invalid_key;
+            return;
+        }
+        switch (info)
+        {
+        case 20:
+            handler_.bool_value(false, *this);
+            break;
+        case 21:
+            handler_.bool_value(true, *this);
+            break;
+        case 22:
+        case 23:
+            handler_.null_value(*this);
+            break;
+        case 25:
+            handler_.double_value(binary::detail::decode_half(static_cast<uint16_t>(argument_)), 0, *this);
+            break;
+        case 26:
+            {
+                uint32_t bits = static_cast<uint32_t>(argument_);
+                float value;
+                std::memcpy(&value, &bits, sizeof(value));
+                handler_.double_value(value, 0, *this);
+            }
+            break;
+        case 27:
+            {
+                double value;
+                std::memcpy(&value, &argument_, sizeof(value));
+                handler_.double_value(value, 0, *this);
+            }
+            break;
+        default:
+            ec = cbor_parser_errc::invalid_initial_byte;
+            return;
+        }
+        end_item();
+    }
+
+    void begin_payload(std::error_code& ec)
+    {
+        if (!in_indefinite_string() && expects_key() && (initial_byte_ >> 5) == 2)
+        {
+            ec = cbor_parser_errc::invalid_key;
+            return;
+        }
+        if (in_indefinite_string())
+        {
+            payload_remaining_ = argument_;
+            state_ = cbor_parse_state::payload;
+        }
+        else if (argument_ <= static_cast<uint64_t>(end_input_ - p_))
+        {
+            // The string lies within the source, pass it on in place
+            const uint8_t* data = p_;
+            p_ += static_cast<size_t>(argument_);
+            string_value((initial_byte_ >> 5) == 2, data, static_cast<size_t>(argument_), ec);
+            if (ec) return;
+            end_item();
+        }
+        else
+        {
+            buffer_.clear();
+            payload_remaining_ = argument_;
+            state_ = cbor_parse_state::payload;
+        }
+        if (state_ == cbor_parse_state::payload && payload_remaining_ == 0)
+        {
+            end_payload(ec);
+        }
+    }
+
+    void end_payload(std::error_code& ec)
+    {
+        state_ = cbor_parse_state::initial_byte;
+        if (!in_indefinite_string())
+        {
+            string_value((initial_byte_ >> 5) == 2, reinterpret_cast<const uint8_t*>(buffer_.data()), buffer_.length(), ec);
+            if (ec) return;
+            buffer_.clear();
+            end_item();
+        }
+    }
+
+    void begin_indefinite_string(container_type type, std::error_code& ec)
+    {
+        if (expects_key() && type == container_type::byte_string)
+        {
+            ec = cbor_parser_errc::invalid_key;
+            return;
+        }
+        buffer_.clear();
+        stack_.push_back(container(type, true, 0));
+    }
+
+    void begin_array(bool indefinite, uint64_t length, std::error_code& ec)
+    {
+        if (expects_key())
+        {
+            ec = cbor_parser_errc::invalid_key;
+            return;
+        }
+        if (++nesting_depth_ > peak_nesting_depth_)
+        {
+            peak_nesting_depth_ = nesting_depth_;
+        }
+        if (nesting_depth_ > max_depth_)
+        {
+            ec = cbor_parser_errc::max_depth_exceeded;
+            return;
+        }
+        handler_.begin_array(*this);
+        stack_.push_back(container(container_type::array, indefinite, length));
+        if (!indefinite && length == 0)
+        {
+            end_container();
+        }
+    }
+
+    void begin_map(bool indefinite, uint64_t length, std::error_code& ec)
+    {
+        if (expects_key())
+        {
+            ec = cbor_parser_errc::invalid_key;
+            return;
+        }
+        if (++nesting_depth_ > peak_nesting_depth_)
+        {
+            peak_nesting_depth_ = nesting_depth_;
+        }
+        if (nesting_depth_ > max_depth_)
+        {
+            ec = cbor_parser_errc::max_depth_exceeded;
+            return;
+        }
+        if (length > (std::numeric_limits<uint64_t>::max)()/2)
+        {
+            ec = cbor_parser_errc::invalid_initial_byte;
+            return;
+        }
+        handler_.begin_object(*this);
+        stack_.push_back(container(container_type::map, indefinite, 2*length));
+        if (!indefinite && length == 0)
+        {
+            end_container();
+        }
+    }
+
+    void parse_break(std::error_code& ec)
+    {
+        if (stack_.empty() || !stack_.back().indefinite_ || (stack_.back().type_ == container_type::map && !stack_.back().expects_key()))
+        {
+            ec = cbor_parser_errc::unexpected_break;
+            return;
+        }
+        switch (stack_.back().type_)
+        {
+        case container_type::byte_string:
+        case container_type::text_string:
+            {
+                bool is_byte_string = stack_.back().type_ == container_type::byte_string;
+                stack_.pop_back();
+                string_value(is_byte_string, reinterpret_cast<const uint8_t*>(buffer_.data()), buffer_.length(), ec);
+                if (ec) return;
+                buffer_.clear();
+                end_item();
+            }
+            break;
+        default:
+            end_container();
+            break;
+        }
+    }
+
+    // Closes the array or map on top of the stack, which is itself an item of its parent
+    void end_container()
+    {
+        if (stack_.back().type_ == container_type::map)
+        {
+            handler_.end_object(*this);
+        }
+        else
+        {
+            handler_.end_array(*this);
+        }
+        stack_.pop_back();
+        --nesting_depth_;
+        end_item();
+    }
+
+    // Counts a completed data item against its container, closing containers that are full
+    void end_item()
+    {
+        while (!stack_.empty())
+        {
+            container& top = stack_.back();
+            ++top.count_;
+            if (top.indefinite_ || top.count_ < top.length_)
+            {
+                return;
+            }
+            if (top.type_ == container_type::map)
+            {
+                handler_.end_object(*this);
+            }
+            else
+            {
+                handler_.end_array(*this);
+            }
+            stack_.pop_back();
+            --nesting_depth_;
+        }
+        state_ = cbor_parse_state::done;
+        handler_.end_json();
+    }
+
+    struct typed_array_reporter
+    {
+        basic_json_input_handler<char>& handler_;
+        const jsoncons::parsing_context& context_;
+
+        void uinteger_value(uint64_t value)
+        {
+            handler_.uinteger_value(value, context_);
+        }
+
+        void integer_value(int64_t value)
+        {
+            handler_.integer_value(value, context_);
+        }
+
+        void double_value(double value)
+        {
+            handler_.double_value(value, 0, context_);
+        }
+    };
+
+    void string_value(bool is_byte_string, const uint8_t* data, size_t length, std::error_code& ec)
+    {
+        detail::typed_array_info info;
+        if (is_byte_string && item_has_tag_ && detail::get_typed_array_info(item_tag_, info))
+        {
+            if (length % info.element_size != 0)
+            {
+                ec = cbor_parser_errc::invalid_typed_array;
+                return;
+            }
+            if (nesting_depth_ + 1 > max_depth_)
+            {
+                ec = cbor_parser_errc::max_depth_exceeded;
+                return;
+            }
+            if (nesting_depth_ + 1 > peak_nesting_depth_)
+            {
+                peak_nesting_depth_ = nesting_depth_ + 1;
+            }
+            handler_.begin_array(*this);
+            typed_array_reporter reporter{handler_, *this};
+            detail::visit_typed_array(info, data, length/info.element_size, reporter);
+            handler_.end_array(*this);
+        }
+        else if (is_byte_string)
+        {
+            handler_.byte_string_value(data, length, *this);
+        }
+        else if (expects_key())
+        {
+            handler_.name(string_view_type(reinterpret_cast<const char*>(data), length), *this);
+        }
+        else
+        {
+            handler_.string_value(string_view_type(reinterpret_cast<const char*>(data), length), *this);
+        }
+    }
+
+    bool expects_key() const
+    {
+        return !stack_.empty() && stack_.back().expects_key();
+    }
+
+    bool in_indefinite_string() const
+    {
+        return !stack_.empty() && (stack_.back().type_ == container_type::byte_string || stack_.back().type_ == container_type::text_string);
+    }
+
+    size_t do_line_number() const override
+    {
+        return line_number();
+    }
+
+    size_t do_column_number() const override
+    {
+        return column_number();
+    }
+};
+
+}}
+
+#endif
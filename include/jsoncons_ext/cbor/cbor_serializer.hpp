@@ -0,0 +1,240 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_CBOR_CBOR_SERIALIZER_HPP
+#define JSONCONS_CBOR_CBOR_SERIALIZER_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <ostream>
+#include <stdexcept>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/jsoncons_utilities.hpp>
+#include <jsoncons/json_output_handler.hpp>
+#include <jsoncons/json_trace.hpp>
+#include <jsoncons/output_sink.hpp>
+#include <jsoncons/detail/string_scan.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+
+namespace jsoncons { namespace cbor {
+
+// Writes CBOR as the events arrive, without a json value. The number of members or
+// elements is not known when an object or array begins, so objects and arrays are
+// written as indefinite length maps and arrays, ended by a break. Integers, strings
+// and byte strings are written with the shortest argument, doubles at double precision,
+// as encode_cbor writes them.
+
+class cbor_serializer : public basic_json_output_handler<char>
+{
+public:
+    using basic_json_output_handler<char>::string_view_type;
+private:
+    buffered_output<char> bos_;
+    jsoncons::detail::trace_recorder trace_;
+
+    // Noncopyable and nonmoveable
+    cbor_serializer(const cbor_serializer&) = delete;
+    cbor_serializer& operator=(const cbor_serializer&) = delete;
+public:
+    cbor_serializer(std::ostream& os)
+       : bos_(os),
+         trace_("cbor_serializer")
+    {
+    }
+
+    cbor_serializer(basic_output_sink<char>& sink)
+       : bos_(sink),
+         trace_("cbor_serializer")
+    {
+    }
+
+    ~cbor_serializer()
+    {
+    }
+
+    // The tracer is given a record for each data item, with the bytes written, the writes
+    // to the stream or sink, the names and values, the deepest nesting, and the time from
+    // begin_json to end_json
+    json_tracer* tracer() const
+    {
+        return trace_.tracer();
+    }
+
+    void tracer(json_tracer* tracer)
+    {
+        trace_.tracer(tracer);
+    }
+
+    // Writes the encoded data item as it is, in place of a value, so that the parts of
+    // a record that pass through unchanged are copied rather than decoded and encoded
+    void encoded_value(const cbor_view& v)
+    {
+        bos_.write(reinterpret_cast<const char*>(v.buffer()), v.buflen());
+    }
+
+private:
+    void do_begin_json() override
+    {
+        trace_.begin(bos_);
+    }
+
+    void do_end_json() override
+    {
+        bos_.flush();
+        trace_.end(bos_);
+    }
+
+    void do_begin_object() override
+    {
+        trace_.token();
+        trace_.begin_container();
+        bos_.put(static_cast<char>(0xbf));
+    }
+
+    void do_end_object() override
+    {
+        trace_.end_container();
+        bos_.put(static_cast<char>(0xff));
+    }
+
+    void do_begin_array() override
+    {
+        trace_.token();
+        trace_.begin_container();
+        bos_.put(static_cast<char>(0x9f));
+    }
+
+    void do_end_array() override
+    {
+        trace_.end_container();
+        bos_.put(static_cast<char>(0xff));
+    }
+
+    void do_name(const string_view_type& name) override
+    {
+        trace_.token();
+        write_text(name);
+    }
+
+    void do_null_value() override
+    {
+        trace_.token();
+        bos_.put(static_cast<char>(0xf6));
+    }
+
+    void do_string_value(const string_view_type& value) override
+    {
+        trace_.token();
+        write_text(value);
+    }
+
+    void do_byte_string_value(const uint8_t* data, size_t length) override
+    {
+        trace_.token();
+        write_head(0x40, length);
+        bos_.write(reinterpret_cast<const char*>(data), length);
+    }
+
+    void do_double_value(double value, uint8_t) override
+    {
+        trace_.token();
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        bos_.put(static_cast<char>(0xfb));
+        write_big_endian(bits, sizeof(bits));
+    }
+
+    void do_integer_value(int64_t value) override
+    {
+        trace_.token();
+        if (value >= 0)
+        {
+            write_head(0x00, static_cast<uint64_t>(value));
+        }
+        else
+        {
+            write_head(0x20, static_cast<uint64_t>(-1 - value));
+        }
+    }
+
+    void do_uinteger_value(uint64_t value) override
+    {
+        trace_.token();
+        write_head(0x00, value);
+    }
+
+    void do_bool_value(bool value) override
+    {
+        trace_.token();
+        bos_.put(static_cast<char>(value ? 0xf5 : 0xf4));
+    }
+
+    // The events of a tape are written without a virtual call each
+    void do_events(const basic_json_event_tape<char>& tape) override
+    {
+        jsoncons::detail::direct_output_events<cbor_serializer> handler(*this);
+        tape.replay(handler);
+    }
+
+    friend class jsoncons::detail::direct_output_events<cbor_serializer>;
+
+    // UTF-8 strings are written as they are, once validated
+    void write_text(const string_view_type& sv)
+    {
+        if (!jsoncons::detail::is_valid_utf8(sv.data(), sv.length()))
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Illegal unicode");
+        }
+        write_head(0x60, sv.length());
+        bos_.write(sv.data(), sv.length());
+    }
+
+    // Writes the initial byte of a data item of the major type in the high three bits
+    // of major, and its argument in as few bytes as it fits
+    void write_head(uint8_t major, uint64_t argument)
+    {
+        if (argument <= 0x17)
+        {
+            bos_.put(static_cast<char>(major + argument));
+        }
+        else if (argument <= 0xff)
+        {
+            bos_.put(static_cast<char>(major + 0x18));
+            write_big_endian(argument, 1);
+        }
+        else if (argument <= 0xffff)
+        {
+            bos_.put(static_cast<char>(major + 0x19));
+            write_big_endian(argument, 2);
+        }
+        else if (argument <= 0xffffffff)
+        {
+            bos_.put(static_cast<char>(major + 0x1a));
+            write_big_endian(argument, 4);
+        }
+        else
+        {
+            bos_.put(static_cast<char>(major + 0x1b));
+            write_big_endian(argument, 8);
+        }
+    }
+
+    void write_big_endian(uint64_t value, size_t length)
+    {
+        char buf[8];
+        for (size_t i = length; i-- > 0; )
+        {
+            buf[i] = static_cast<char>(value & 0xff);
+            value >>= 8;
+        }
+        bos_.write(buf, length);
+    }
+};
+
+}}
+
+#endif
@@ -0,0 +1,141 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_CBOR_CBOR_TRANSCODE_HPP
+#define JSONCONS_CBOR_CBOR_TRANSCODE_HPP
+
+#include <istream>
+#include <ostream>
+#include <system_error>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/json_filter.hpp>
+#include <jsoncons/json_reader.hpp>
+#include <jsoncons/json_serializer.hpp>
+#include <jsoncons/serialization_options.hpp>
+#include <jsoncons/input_source.hpp>
+#include <jsoncons/output_sink.hpp>
+#include <jsoncons_ext/cbor/cbor_reader.hpp>
+#include <jsoncons_ext/cbor/cbor_serializer.hpp>
+
+namespace jsoncons { namespace cbor {
+
+// Transcode between JSON text and CBOR by passing the reader's events straight to the
+// serializer, without a json value, so that memory use depends on the buffers and the
+// nesting depth, not on the size of the input. Input and output are streams, or a source
+// and a sink, e.g. a gzip_source and a zstd_sink. The overloads without an error code
+// throw a parse_error if the input is not valid.
+
+namespace detail {
+
+    template <class Input, class Output>
+    void json_to_cbor(Input& input, Output& output)
+    {
+        cbor_serializer serializer(output);
+        basic_json_input_output_handler_adapter<char> adapter(serializer);
+        json_reader reader(input, adapter);
+        reader.read();
+    }
+
+    template <class Input, class Output>
+    void json_to_cbor(Input& input, Output& output, std::error_code& ec)
+    {
+        cbor_serializer serializer(output);
+        basic_json_input_output_handler_adapter<char> adapter(serializer);
+        json_reader reader(input, adapter);
+        reader.read(ec);
+    }
+
+    template <class Input, class Output>
+    void cbor_to_json(Input& input, Output& output, const serialization_options& options)
+    {
+        json_serializer serializer(output, options);
+        basic_json_input_output_handler_adapter<char> adapter(serializer);
+        cbor_reader reader(input, adapter);
+        reader.read();
+    }
+
+    template <class Input, class Output>
+    void cbor_to_json(Input& input, Output& output, const serialization_options& options, std::error_code& ec)
+    {
+        json_serializer serializer(output, options);
+        basic_json_input_output_handler_adapter<char> adapter(serializer);
+        cbor_reader reader(input, adapter);
+        reader.read(ec);
+    }
+}
+
+// Reads a JSON text and writes it as a CBOR data item, with indefinite length maps and
+// arrays, as cbor_serializer writes them
+
+inline
+void json_to_cbor(std::istream& is, std::ostream& os)
+{
+    detail::json_to_cbor(is, os);
+}
+
+inline
+void json_to_cbor(std::istream& is, std::ostream& os, std::error_code& ec)
+{
+    detail::json_to_cbor(is, os, ec);
+}
+
+inline
+void json_to_cbor(input_source& source, output_sink& sink)
+{
+    detail::json_to_cbor(source, sink);
+}
+
+inline
+void json_to_cbor(input_source& source, output_sink& sink, std::error_code& ec)
+{
+    detail::json_to_cbor(source, sink, ec);
+}
+
+// Reads a CBOR data item and writes it as JSON text
+
+inline
+void cbor_to_json(std::istream& is, std::ostream& os, 
+                  const serialization_options& options = serialization_options())
+{
+    detail::cbor_to_json(is, os, options);
+}
+
+inline
+void cbor_to_json(std::istream& is, std::ostream& os, std::error_code& ec)
+{
+    detail::cbor_to_json(is, os, serialization_options(), ec);
+}
+
+inline
+void cbor_to_json(std::istream& is, std::ostream& os, 
+                  const serialization_options& options, std::error_code& ec)
+{
+    detail::cbor_to_json(is, os, options, ec);
+}
+
+inline
+void cbor_to_json(input_source& source, output_sink& sink, 
+                  const serialization_options& options = serialization_options())
+{
+    detail::cbor_to_json(source, sink, options);
+}
+
+inline
+void cbor_to_json(input_source& source, output_sink& sink, std::error_code& ec)
+{
+    detail::cbor_to_json(source, sink, serialization_options(), ec);
+}
+
+inline
+void cbor_to_json(input_source& source, output_sink& sink, 
+                  const serialization_options& options, std::error_code& ec)
+{
+    detail::cbor_to_json(source, sink, options, ec);
+}
+
+}}
+
+#endif
@@ -0,0 +1,202 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_CBOR_CBOR_TYPED_ARRAY_HPP
+#define JSONCONS_CBOR_CBOR_TYPED_ARRAY_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <type_traits>
+#include <jsoncons_ext/binary/binary_utilities.hpp>
+
+namespace jsoncons { namespace cbor { namespace detail {
+
+// RFC 8746 typed arrays, a tag from 64 to 87 on a byte string that holds the elements
+// packed one after another. The tag is 0b010fsell, f for float, s for signed, e for
+// little endian, and ll the log2 of the element length, or of half of it for floats.
+
+struct typed_array_info
+{
+    size_t element_size;
+    bool is_float;
+    bool is_signed;
+    bool is_little_endian;
+};
+
+// Returns false for tags that are not typed arrays, and for the reserved tag 76 and
+// the 128 bit float arrays, which are not supported
+inline
+bool get_typed_array_info(uint64_t tag, typed_array_info& info)
+{
+    if (tag < 64 || tag > 87)
+    {
+        return false;
+    }
+    const uint8_t bits = static_cast<uint8_t>(tag - 64);
+    const size_t ll = bits & 0x03;
+    info.is_float = (bits & 0x10) != 0;
+    info.is_signed = !info.is_float && (bits & 0x08) != 0;
+    info.is_little_endian = (bits & 0x04) != 0;
+    if (info.is_float)
+    {
+        if (ll == 3 || (bits & 0x08) != 0)
+        {
+            return false;
+        }
+        info.element_size = static_cast<size_t>(2) << ll;
+    }
+    else
+    {
+        if (info.is_signed && info.is_little_endian && ll == 0)
+        {
+            return false;
+        }
+        info.element_size = static_cast<size_t>(1) << ll;
+    }
+    return true;
+}
+
+// The element types that typed arrays are encoded from and decoded into with memcpy
+template <class T, class Enable = void>
+struct typed_array_traits
+{
+    static const bool value = false;
+};
+
+template <class T>
+struct typed_array_traits<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T,bool>::value && sizeof(T) <= 8>::type>
+{
+    static const bool value = true;
+
+    // The tag of an array of T in the byte order of the host
+    static uint8_t tag()
+    {
+        const uint8_t ll = sizeof(T) == 1 ? 0 : sizeof(T) == 2 ? 1 : sizeof(T) == 4 ? 2 : 3;
+        const uint8_t e = sizeof(T) > 1 && binary::detail::is_little_endian() ? 0x04 : 0;
+        return static_cast<uint8_t>(0x40 | (std::is_signed<T>::value ? 0x08 : 0) | e | ll);
+    }
+};
+
+template <class T>
+struct typed_array_traits<T, typename std::enable_if<std::is_same<T,float>::value || std::is_same<T,double>::value>::type>
+{
+    static const bool value = true;
+
+    static uint8_t tag()
+    {
+        const uint8_t ll = sizeof(T) == 4 ? 1 : 2;
+        const uint8_t e = binary::detail::is_little_endian() ? 0x04 : 0;
+        return static_cast<uint8_t>(0x50 | e | ll);
+    }
+};
+
+// Calls visitor.uinteger_value, integer_value or double_value for each element of the
+// count elements at data
+template <class Visitor>
+void visit_typed_array(const typed_array_info& info, const uint8_t* data, size_t count, Visitor& visitor)
+{
+    const size_t size = info.element_size;
+    const size_t shift = 64 - 8*size;
+    for (size_t i = 0; i < count; ++i, data += size)
+    {
+        uint64_t bits = 0;
+        if (info.is_little_endian)
+        {
+            for (size_t j = size; j-- > 0; )
+            {
+                bits = (bits << 8) | data[j];
+            }
+        }
+        else
+        {
+            for (size_t j = 0; j < size; ++j)
+            {
+                bits = (bits << 8) | data[j];
+            }
+        }
+        if (info.is_float)
+        {
+            switch (size)
+            {
+            case 2:
+                visitor.double_value(binary::detail::decode_half(static_cast<uint16_t>(bits)));
+                break;
+            case 4:
+                {
+                    const uint32_t bits32 = static_cast<uint32_t>(bits);
+                    float value;
+                    std::memcpy(&value, &bits32, sizeof(value));
+                    visitor.double_value(value);
+                }
+                break;
+            default:
+                {
+                    double value;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    visitor.double_value(value);
+                }
+                break;
+            }
+        }
+        else if (info.is_signed)
+        {
+            // Sign extends from the element size
+            visitor.integer_value(static_cast<int64_t>(bits << shift) >> shift);
+        }
+        else
+        {
+            visitor.uinteger_value(bits);
+        }
+    }
+}
+
+template <class T>
+struct typed_array_inserter
+{
+    std::vector<T>& v_;
+
+    void uinteger_value(uint64_t value)
+    {
+        v_.push_back(static_cast<T>(value));
+    }
+
+    void integer_value(int64_t value)
+    {
+        v_.push_back(static_cast<T>(value));
+    }
+
+    void double_value(double value)
+    {
+        v_.push_back(static_cast<T>(value));
+    }
+};
+
+// Appends the elements to v, with memcpy if they are of type T in the byte order of the host,
+// otherwise converting each one
+template <class T>
+void copy_typed_array(uint64_t tag, const typed_array_info& info, const uint8_t* data, size_t count, std::vector<T>& v)
+{
+    if (tag == typed_array_traits<T>::tag())
+    {
+        const size_t offset = v.size();
+        v.resize(offset + count);
+        if (count > 0)
+        {
+            std::memcpy(&v[offset], data, count*sizeof(T));
+        }
+    }
+    else
+    {
+        v.reserve(v.size() + count);
+        typed_array_inserter<T> inserter{v};
+        visit_typed_array(info, data, count, inserter);
+    }
+}
+
+}}}
+
+#endif
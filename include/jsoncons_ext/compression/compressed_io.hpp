@@ -0,0 +1,138 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_COMPRESSION_COMPRESSED_IO_HPP
+#define JSONCONS_COMPRESSION_COMPRESSED_IO_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <system_error>
+#include <jsoncons/output_sink.hpp>
+#include <jsoncons_ext/compression/compression_error_category.hpp>
+
+namespace jsoncons { namespace compression { namespace detail {
+
+// Where the compressed bytes of a source come from: a stream, read a buffer at a time,
+// or a block of memory, passed on as it is.
+
+class compressed_input
+{
+    static const size_t default_buffer_length = 16384;
+
+    std::istream* is_;
+    const uint8_t* data_;
+    size_t length_;
+    std::vector<uint8_t> buffer_;
+public:
+    compressed_input(std::istream& is)
+        : is_(std::addressof(is)), data_(nullptr), length_(0), buffer_(default_buffer_length)
+    {
+    }
+
+    compressed_input(const uint8_t* data, size_t length)
+        : is_(nullptr), data_(data), length_(length)
+    {
+    }
+
+    // Points data at up to max_length more bytes and returns how many. Returns 0 at the end
+    // of the input, or if the stream could not be read, which sets ec.
+    size_t next(const uint8_t*& data, size_t max_length, std::error_code& ec)
+    {
+        if (is_ == nullptr)
+        {
+            size_t n = (std::min)(length_, max_length);
+            data = data_;
+            data_ += n;
+            length_ -= n;
+            return n;
+        }
+        if (is_->eof())
+        {
+            return 0;
+        }
+        is_->read(reinterpret_cast<char*>(buffer_.data()), (std::min)(buffer_.size(), max_length));
+        size_t n = static_cast<size_t>(is_->gcount());
+        if (n == 0 && is_->fail() && !is_->eof())
+        {
+            ec = compression_errc::source_error;
+        }
+        data = buffer_.data();
+        return n;
+    }
+};
+
+// Where the compressed bytes of a sink go: a stream or another sink
+
+class compressed_output
+{
+    static const size_t default_buffer_length = 16384;
+
+    std::ostream* os_;
+    output_sink* sink_;
+    std::vector<uint8_t> buffer_;
+public:
+    compressed_output(std::ostream& os)
+        : os_(std::addressof(os)), sink_(nullptr), buffer_(default_buffer_length)
+    {
+    }
+
+    compressed_output(output_sink& sink)
+        : os_(nullptr), sink_(std::addressof(sink)), buffer_(default_buffer_length)
+    {
+    }
+
+    uint8_t* data()
+    {
+        return buffer_.data();
+    }
+
+    size_t capacity() const
+    {
+        return buffer_.size();
+    }
+
+    // Passes on the first length bytes of the buffer
+    void write(size_t length, std::error_code& ec)
+    {
+        if (length == 0)
+        {
+            return;
+        }
+        if (sink_ != nullptr)
+        {
+            sink_->write(reinterpret_cast<const char*>(buffer_.data()), length);
+        }
+        else
+        {
+            os_->write(reinterpret_cast<const char*>(buffer_.data()), length);
+            if (os_->fail())
+            {
+                ec = compression_errc::sink_error;
+            }
+        }
+    }
+
+    void flush()
+    {
+        if (sink_ != nullptr)
+        {
+            sink_->flush();
+        }
+        else
+        {
+            os_->flush();
+        }
+    }
+};
+
+}}}
+
+#endif
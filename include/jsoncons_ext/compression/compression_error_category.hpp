@@ -0,0 +1,78 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_COMPRESSION_COMPRESSION_ERROR_CATEGORY_HPP
+#define JSONCONS_COMPRESSION_COMPRESSION_ERROR_CATEGORY_HPP
+
+#include <system_error>
+#include <jsoncons/json_exception.hpp>
+
+namespace jsoncons { namespace compression {
+
+    enum class compression_errc : int
+    {
+        ok = 0,
+        source_error = 1,
+        sink_error = 2,
+        unexpected_eof = 3,
+        invalid_data = 4,
+        out_of_memory = 5,
+        library_error = 6
+    };
+
+class compression_error_category_impl
+   : public std::error_category
+{
+public:
+    virtual const char* name() const JSONCONS_NOEXCEPT
+    {
+        return "compression";
+    }
+    virtual std::string message(int ev) const
+    {
+        switch (static_cast<compression_errc>(ev))
+        {
+        case compression_errc::source_error:
+            return "Compressed input could not be read";
+        case compression_errc::sink_error:
+            return "Compressed output could not be written";
+        case compression_errc::unexpected_eof:
+            return "Compressed input ends inside a stream";
+        case compression_errc::invalid_data:
+            return "Compressed input is corrupt or in an unsupported format";
+        case compression_errc::out_of_memory:
+            return "Out of memory";
+        case compression_errc::library_error:
+            return "Compression library error";
+        default:
+            return "Unknown compression error";
+        }
+    }
+};
+
+inline
+const std::error_category& compression_error_category()
+{
+  static compression_error_category_impl instance;
+  return instance;
+}
+
+inline
+std::error_code make_error_code(compression_errc result)
+{
+    return std::error_code(static_cast<int>(result),compression_error_category());
+}
+
+}}
+
+namespace std {
+    template<>
+    struct is_error_code_enum<jsoncons::compression::compression_errc> : public true_type
+    {
+    };
+}
+
+#endif
@@ -0,0 +1,250 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_COMPRESSION_GZIP_HPP
+#define JSONCONS_COMPRESSION_GZIP_HPP
+
+#include <climits>
+#include <cstring>
+#include <algorithm>
+#include <zlib.h>
+#include <jsoncons/input_source.hpp>
+#include <jsoncons/output_sink.hpp>
+#include <jsoncons_ext/compression/compressed_io.hpp>
+
+// Needs zlib. Include this header and link with zlib (-lz) to use it.
+
+namespace jsoncons { namespace compression {
+
+// Decompresses gzip or zlib data straight into a reader's buffer. Members of a gzip file
+// that follow one another, as written by parallel compressors, are read as one input.
+// The readers report that a source failed as a source error; error() tells why.
+
+class gzip_source : public input_source
+{
+    detail::compressed_input input_;
+    z_stream strm_;
+    bool in_stream_;
+    bool eof_;
+    std::error_code ec_;
+
+    // Noncopyable and nonmoveable
+    gzip_source(const gzip_source&) = delete;
+    gzip_source& operator=(const gzip_source&) = delete;
+public:
+    // Reads compressed data from a stream
+    gzip_source(std::istream& is)
+        : input_(is)
+    {
+        init();
+    }
+
+    // Reads compressed data from memory, which must exist as long as the source does
+    gzip_source(const uint8_t* data, size_t length)
+        : input_(data, length)
+    {
+        init();
+    }
+
+    ~gzip_source()
+    {
+        ::inflateEnd(&strm_);
+    }
+
+    std::error_code error() const
+    {
+        return ec_;
+    }
+
+private:
+    void init()
+    {
+        std::memset(&strm_, 0, sizeof(strm_));
+        in_stream_ = false;
+        eof_ = false;
+        // 32 added to the window bits detects a gzip or zlib header
+        if (::inflateInit2(&strm_, 15 + 32) != Z_OK)
+        {
+            ec_ = compression_errc::out_of_memory;
+        }
+    }
+
+    size_t do_read(char* data, size_t length) override
+    {
+        const uInt out_length = static_cast<uInt>((std::min)(length, size_t(UINT_MAX)));
+        strm_.next_out = reinterpret_cast<Bytef*>(data);
+        strm_.avail_out = out_length;
+        while (strm_.avail_out > 0 && !eof_ && !ec_)
+        {
+            bool more = strm_.avail_in > 0;
+            if (!more)
+            {
+                const uint8_t* p;
+                size_t n = input_.next(p, UINT_MAX, ec_);
+                if (ec_)
+                {
+                    break;
+                }
+                strm_.next_in = const_cast<Bytef*>(p);
+                strm_.avail_in = static_cast<uInt>(n);
+                more = n > 0;
+            }
+            const uInt avail_out = strm_.avail_out;
+            int rc = ::inflate(&strm_, Z_NO_FLUSH);
+            switch (rc)
+            {
+            case Z_STREAM_END:
+                // Another member may follow
+                ::inflateReset(&strm_);
+                in_stream_ = false;
+                break;
+            case Z_OK:
+                in_stream_ = true;
+                break;
+            case Z_BUF_ERROR: // No progress possible
+                break;
+            case Z_MEM_ERROR:
+                ec_ = compression_errc::out_of_memory;
+                break;
+            default:
+                ec_ = compression_errc::invalid_data;
+                break;
+            }
+            if (!ec_ && !more && strm_.avail_out == avail_out)
+            {
+                if (in_stream_)
+                {
+                    ec_ = compression_errc::unexpected_eof;
+                }
+                eof_ = true;
+            }
+        }
+        return out_length - strm_.avail_out;
+    }
+
+    bool do_eof() const override
+    {
+        return eof_;
+    }
+
+    bool do_fail() const override
+    {
+        return static_cast<bool>(ec_);
+    }
+};
+
+// Compresses a serializer's output as gzip, straight from the serializer's buffer. The
+// gzip trailer is written by finish(), or when the sink is destroyed. A flush passes on
+// only what has been compressed so far, so as not to cost compression. Serializers cannot
+// report write errors, so the first one is kept and can be checked with error(); output
+// after an error, or after finish(), is discarded.
+
+class gzip_sink : public output_sink
+{
+    detail::compressed_output output_;
+    z_stream strm_;
+    bool finished_;
+    std::error_code ec_;
+
+    // Noncopyable and nonmoveable
+    gzip_sink(const gzip_sink&) = delete;
+    gzip_sink& operator=(const gzip_sink&) = delete;
+public:
+    // level is a zlib compression level, from 1 (fastest) to 9 (smallest)
+    gzip_sink(std::ostream& os, int level = Z_DEFAULT_COMPRESSION)
+        : output_(os)
+    {
+        init(level);
+    }
+
+    gzip_sink(output_sink& sink, int level = Z_DEFAULT_COMPRESSION)
+        : output_(sink)
+    {
+        init(level);
+    }
+
+    ~gzip_sink()
+    {
+        finish();
+        ::deflateEnd(&strm_);
+    }
+
+    // Compresses what is left and writes the gzip trailer
+    void finish()
+    {
+        if (!finished_)
+        {
+            deflate_buffer(nullptr, 0, Z_FINISH);
+            finished_ = true;
+            output_.flush();
+        }
+    }
+
+    std::error_code error() const
+    {
+        return ec_;
+    }
+
+private:
+    void init(int level)
+    {
+        std::memset(&strm_, 0, sizeof(strm_));
+        finished_ = false;
+        // 16 added to the window bits writes a gzip header and trailer
+        if (::deflateInit2(&strm_, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            ec_ = compression_errc::library_error;
+        }
+    }
+
+    void deflate_buffer(const char* s, size_t length, int flush)
+    {
+        if (finished_ || ec_)
+        {
+            return;
+        }
+        do
+        {
+            const uInt n = static_cast<uInt>((std::min)(length, size_t(UINT_MAX)));
+            strm_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(s));
+            strm_.avail_in = n;
+            s += n;
+            length -= n;
+            const int step = length > 0 ? Z_NO_FLUSH : flush;
+            do
+            {
+                strm_.next_out = output_.data();
+                strm_.avail_out = static_cast<uInt>(output_.capacity());
+                if (::deflate(&strm_, step) == Z_STREAM_ERROR)
+                {
+                    ec_ = compression_errc::library_error;
+                    return;
+                }
+                output_.write(output_.capacity() - strm_.avail_out, ec_);
+                if (ec_)
+                {
+                    return;
+                }
+            }
+            while (strm_.avail_out == 0);
+        }
+        while (length > 0);
+    }
+
+    void do_write(const char* s, size_t length) override
+    {
+        deflate_buffer(s, length, Z_NO_FLUSH);
+    }
+
+    void do_flush() override
+    {
+        output_.flush();
+    }
+};
+
+}}
+
+#endif
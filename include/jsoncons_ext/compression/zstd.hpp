@@ -0,0 +1,242 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_COMPRESSION_ZSTD_HPP
+#define JSONCONS_COMPRESSION_ZSTD_HPP
+
+#include <cstddef>
+#include <zstd.h>
+#include <zstd_errors.h>
+#include <jsoncons/input_source.hpp>
+#include <jsoncons/output_sink.hpp>
+#include <jsoncons_ext/compression/compressed_io.hpp>
+
+// Needs zstd 1.4 or later. Include this header and link with libzstd (-lzstd) to use it.
+
+namespace jsoncons { namespace compression {
+
+// Decompresses zstd data straight into a reader's buffer. Frames that follow one another
+// are read as one input. The readers report that a source failed as a source error;
+// error() tells why.
+
+class zstd_source : public input_source
+{
+    detail::compressed_input input_;
+    ZSTD_DCtx* dctx_;
+    ZSTD_inBuffer in_;
+    bool in_frame_;
+    bool eof_;
+    std::error_code ec_;
+
+    // Noncopyable and nonmoveable
+    zstd_source(const zstd_source&) = delete;
+    zstd_source& operator=(const zstd_source&) = delete;
+public:
+    // Reads compressed data from a stream
+    zstd_source(std::istream& is)
+        : input_(is)
+    {
+        init();
+    }
+
+    // Reads compressed data from memory, which must exist as long as the source does
+    zstd_source(const uint8_t* data, size_t length)
+        : input_(data, length)
+    {
+        init();
+    }
+
+    ~zstd_source()
+    {
+        ZSTD_freeDCtx(dctx_);
+    }
+
+    std::error_code error() const
+    {
+        return ec_;
+    }
+
+private:
+    void init()
+    {
+        in_.src = nullptr;
+        in_.size = 0;
+        in_.pos = 0;
+        in_frame_ = false;
+        eof_ = false;
+        dctx_ = ZSTD_createDCtx();
+        if (dctx_ == nullptr)
+        {
+            ec_ = compression_errc::out_of_memory;
+        }
+    }
+
+    size_t do_read(char* data, size_t length) override
+    {
+        ZSTD_outBuffer out = {data, length, 0};
+        while (out.pos < out.size && !eof_ && !ec_)
+        {
+            bool more = in_.pos < in_.size;
+            if (!more)
+            {
+                const uint8_t* p;
+                size_t n = input_.next(p, ZSTD_DStreamInSize(), ec_);
+                if (ec_)
+                {
+                    break;
+                }
+                in_.src = p;
+                in_.size = n;
+                in_.pos = 0;
+                more = n > 0;
+            }
+            const size_t in_pos = in_.pos;
+            const size_t out_pos = out.pos;
+            // Also called without input, to pass on output held back by a full buffer
+            size_t rc = ZSTD_decompressStream(dctx_, &out, &in_);
+            if (ZSTD_isError(rc))
+            {
+                ec_ = ZSTD_getErrorCode(rc) == ZSTD_error_memory_allocation
+                    ? compression_errc::out_of_memory : compression_errc::invalid_data;
+                break;
+            }
+            const bool progress = in_.pos != in_pos || out.pos != out_pos;
+            if (progress)
+            {
+                // 0 when a frame is complete and its output passed on
+                in_frame_ = rc != 0;
+            }
+            else if (!more)
+            {
+                if (in_frame_)
+                {
+                    ec_ = compression_errc::unexpected_eof;
+                }
+                eof_ = true;
+            }
+        }
+        return out.pos;
+    }
+
+    bool do_eof() const override
+    {
+        return eof_;
+    }
+
+    bool do_fail() const override
+    {
+        return static_cast<bool>(ec_);
+    }
+};
+
+// Compresses a serializer's output as a zstd frame, straight from the serializer's
+// buffer. The end of the frame is written by finish(), or when the sink is destroyed.
+// A flush passes on only what has been compressed so far, so as not to cost compression.
+// Serializers cannot report write errors, so the first one is kept and can be checked
+// with error(); output after an error, or after finish(), is discarded.
+
+class zstd_sink : public output_sink
+{
+    detail::compressed_output output_;
+    ZSTD_CCtx* cctx_;
+    bool finished_;
+    std::error_code ec_;
+
+    // Noncopyable and nonmoveable
+    zstd_sink(const zstd_sink&) = delete;
+    zstd_sink& operator=(const zstd_sink&) = delete;
+public:
+    // level is a zstd compression level, from 1 (fastest) to ZSTD_maxCLevel() (smallest)
+    zstd_sink(std::ostream& os, int level = ZSTD_CLEVEL_DEFAULT)
+        : output_(os)
+    {
+        init(level);
+    }
+
+    zstd_sink(output_sink& sink, int level = ZSTD_CLEVEL_DEFAULT)
+        : output_(sink)
+    {
+        init(level);
+    }
+
+    ~zstd_sink()
+    {
+        finish();
+        ZSTD_freeCCtx(cctx_);
+    }
+
+    // Compresses what is left and ends the frame
+    void finish()
+    {
+        if (!finished_)
+        {
+            compress(nullptr, 0, ZSTD_e_end);
+            finished_ = true;
+            output_.flush();
+        }
+    }
+
+    std::error_code error() const
+    {
+        return ec_;
+    }
+
+private:
+    void init(int level)
+    {
+        finished_ = false;
+        cctx_ = ZSTD_createCCtx();
+        if (cctx_ == nullptr)
+        {
+            ec_ = compression_errc::out_of_memory;
+        }
+        else if (ZSTD_isError(ZSTD_CCtx_setParameter(cctx_, ZSTD_c_compressionLevel, level)))
+        {
+            ec_ = compression_errc::library_error;
+        }
+    }
+
+    void compress(const char* s, size_t length, ZSTD_EndDirective directive)
+    {
+        if (finished_ || ec_)
+        {
+            return;
+        }
+        ZSTD_inBuffer in = {s, length, 0};
+        size_t remaining;
+        do
+        {
+            ZSTD_outBuffer out = {output_.data(), output_.capacity(), 0};
+            remaining = ZSTD_compressStream2(cctx_, &out, &in, directive);
+            if (ZSTD_isError(remaining))
+            {
+                ec_ = compression_errc::library_error;
+                return;
+            }
+            output_.write(out.pos, ec_);
+            if (ec_)
+            {
+                return;
+            }
+        }
+        // ZSTD_e_continue is done once the input is taken, ZSTD_e_end once the frame is written
+        while (directive == ZSTD_e_end ? remaining != 0 : in.pos < in.size);
+    }
+
+    void do_write(const char* s, size_t length) override
+    {
+        compress(s, length, ZSTD_e_continue);
+    }
+
+    void do_flush() override
+    {
+        output_.flush();
+    }
+};
+
+}}
+
+#endif
@@ -0,0 +1,502 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_CSV_CSV_COLUMN_READER_HPP
+#define JSONCONS_CSV_CSV_COLUMN_READER_HPP
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <istream>
+#include <utility>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/json_input_handler.hpp>
+#include <jsoncons_ext/csv/csv_error_category.hpp>
+#include <jsoncons_ext/csv/csv_parameters.hpp>
+#include <jsoncons_ext/csv/csv_parser.hpp>
+#include <jsoncons_ext/csv/csv_reader.hpp>
+
+namespace jsoncons { namespace csv {
+
+// basic_csv_column
+
+// The values of a CSV column, held contiguously by type: integer_t values in a vector of
+// int64_t, float_t values in a vector of double, boolean_t values in a vector of uint8_t,
+// and string_t values as their characters one after the other, with the offset of each.
+// A column's type is that of its first value. Null values, and values that are not of the
+// column's type, are held as 0, false or an empty string, and marked as null.
+
+template <class CharT>
+class basic_csv_column
+{
+public:
+#if !defined(JSONCONS_HAS_STRING_VIEW)
+    typedef Basic_string_view_<CharT> string_view_type;
+#else
+    typedef std::basic_string_view<CharT> string_view_type;
+#endif
+private:
+    std::basic_string<CharT> name_;
+    csv_column_type type_;
+    bool typed_;
+    size_t size_;
+    std::vector<bool> nulls_;
+    std::vector<int64_t> integers_;
+    std::vector<double> doubles_;
+    std::vector<uint8_t> booleans_;
+    std::basic_string<CharT> chars_;
+    std::vector<size_t> offsets_;
+public:
+    basic_csv_column()
+        : type_(csv_column_type::string_t), typed_(false), size_(0)
+    {
+        offsets_.push_back(0);
+    }
+
+    explicit basic_csv_column(const std::basic_string<CharT>& name)
+        : name_(name), type_(csv_column_type::string_t), typed_(false), size_(0)
+    {
+        offsets_.push_back(0);
+    }
+
+    const std::basic_string<CharT>& name() const
+    {
+        return name_;
+    }
+
+    // integer_t, float_t, boolean_t or string_t, string_t for a column of nulls
+    csv_column_type type() const
+    {
+        return type_;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    bool is_null(size_t i) const
+    {
+        return !nulls_.empty() && nulls_[i];
+    }
+
+    size_t null_count() const
+    {
+        size_t count = 0;
+        for (bool null : nulls_)
+        {
+            if (null)
+            {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    const std::vector<int64_t>& integers() const
+    {
+        return integers_;
+    }
+
+    const std::vector<double>& doubles() const
+    {
+        return doubles_;
+    }
+
+    const std::vector<uint8_t>& booleans() const
+    {
+        return booleans_;
+    }
+
+    // The characters of the strings of a string_t column, one after the other
+    const std::basic_string<CharT>& chars() const
+    {
+        return chars_;
+    }
+
+    // The offsets of the strings in chars(), with the offset of the end of the last one, so
+    // that string i is [offsets()[i], offsets()[i+1])
+    const std::vector<size_t>& offsets() const
+    {
+        return offsets_;
+    }
+
+    string_view_type string_at(size_t i) const
+    {
+        return string_view_type(chars_.data() + offsets_[i], offsets_[i+1] - offsets_[i]);
+    }
+
+    void push_integer(int64_t val)
+    {
+        if (!has_type(csv_column_type::integer_t))
+        {
+            if (has_type(csv_column_type::float_t))
+            {
+                push_double(static_cast<double>(val));
+            }
+            else
+            {
+                push_null();
+            }
+            return;
+        }
+        integers_.push_back(val);
+        push_valid();
+    }
+
+    void push_double(double val)
+    {
+        if (!has_type(csv_column_type::float_t))
+        {
+            push_null();
+            return;
+        }
+        doubles_.push_back(val);
+        push_valid();
+    }
+
+    void push_bool(bool val)
+    {
+        if (!has_type(csv_column_type::boolean_t))
+        {
+            push_null();
+            return;
+        }
+        booleans_.push_back(val ? 1 : 0);
+        push_valid();
+    }
+
+    void push_string(const CharT* data, size_t length)
+    {
+        if (!has_type(csv_column_type::string_t))
+        {
+            push_null();
+            return;
+        }
+        chars_.append(data, length);
+        offsets_.push_back(chars_.size());
+        push_valid();
+    }
+
+    void push_null()
+    {
+        if (nulls_.empty())
+        {
+            nulls_.resize(size_, false);
+        }
+        nulls_.push_back(true);
+        push_empty();
+    }
+
+    // Fills the column with nulls up to n values
+    void resize(size_t n)
+    {
+        while (size_ < n)
+        {
+            push_null();
+        }
+    }
+
+    void shrink_to_fit()
+    {
+        integers_.shrink_to_fit();
+        doubles_.shrink_to_fit();
+        booleans_.shrink_to_fit();
+        chars_.shrink_to_fit();
+        offsets_.shrink_to_fit();
+    }
+private:
+    // Whether the column holds values of type t, which it does from the first one
+    bool has_type(csv_column_type t)
+    {
+        if (!typed_)
+        {
+            typed_ = true;
+            type_ = t;
+            switch (t)
+            {
+            case csv_column_type::integer_t:
+                integers_.resize(size_, 0);
+                break;
+            case csv_column_type::float_t:
+                doubles_.resize(size_, 0.0);
+                break;
+            case csv_column_type::boolean_t:
+                booleans_.resize(size_, 0);
+                break;
+            default:
+                break;
+            }
+            if (t != csv_column_type::string_t)
+            {
+                offsets_.clear();
+            }
+        }
+        return type_ == t;
+    }
+
+    void push_valid()
+    {
+        if (!nulls_.empty())
+        {
+            nulls_.push_back(false);
+        }
+        ++size_;
+    }
+
+    void push_empty()
+    {
+        if (typed_)
+        {
+            switch (type_)
+            {
+            case csv_column_type::integer_t:
+                integers_.push_back(0);
+                break;
+            case csv_column_type::float_t:
+                doubles_.push_back(0.0);
+                break;
+            case csv_column_type::boolean_t:
+                booleans_.push_back(0);
+                break;
+            default:
+                offsets_.push_back(chars_.size());
+                break;
+            }
+        }
+        else
+        {
+            offsets_.push_back(chars_.size());
+        }
+        ++size_;
+    }
+};
+
+typedef basic_csv_column<char> csv_column;
+typedef basic_csv_column<wchar_t> wcsv_column;
+
+namespace detail {
+
+// Receives the events of mapping_type::n_rows, with the fields already converted to the
+// column types by the parser, and appends each value to its column.
+
+template <class CharT>
+class csv_column_handler : public basic_json_input_handler<CharT>
+{
+public:
+    using typename basic_json_input_handler<CharT>::string_view_type;
+private:
+    std::vector<basic_csv_column<CharT>>& columns_;
+    bool header_row_;
+    size_t level_;
+    size_t column_;
+    size_t rows_;
+public:
+    csv_column_handler(std::vector<basic_csv_column<CharT>>& columns,
+                       const std::vector<std::basic_string<CharT>>& column_names,
+                       bool header_row)
+        : columns_(columns), header_row_(header_row), level_(0), column_(0), rows_(0)
+    {
+        for (const auto& name : column_names)
+        {
+            columns_.emplace_back(name);
+        }
+    }
+private:
+    void do_begin_json() override
+    {
+    }
+
+    void do_end_json() override
+    {
+        for (auto& c : columns_)
+        {
+            c.shrink_to_fit();
+        }
+    }
+
+    void do_begin_object(const parsing_context& context) override
+    {
+        throw parse_error(csv_parser_errc::invalid_state, context.line_number(), context.column_number());
+    }
+
+    void do_end_object(const parsing_context&) override
+    {
+    }
+
+    void do_begin_array(const parsing_context& context) override
+    {
+        // Column types with arrays in a field are not held in columns
+        if (++level_ > 2)
+        {
+            throw parse_error(csv_parser_errc::invalid_state, context.line_number(), context.column_number());
+        }
+        column_ = 0;
+    }
+
+    void do_end_array(const parsing_context&) override
+    {
+        if (level_-- == 2)
+        {
+            if (header_row_)
+            {
+                header_row_ = false;
+            }
+            else
+            {
+                ++rows_;
+                for (size_t i = column_; i < columns_.size(); ++i)
+                {
+                    columns_[i].resize(rows_);
+                }
+            }
+        }
+    }
+
+    void do_name(const string_view_type&, const parsing_context&) override
+    {
+    }
+
+    void do_string_value(const string_view_type& value, const parsing_context&) override
+    {
+        if (header_row_)
+        {
+            columns_.emplace_back(std::basic_string<CharT>(value.data(), value.length()));
+            ++column_;
+            return;
+        }
+        next_column().push_string(value.data(), value.length());
+    }
+
+    void do_byte_string_value(const uint8_t*, size_t, const parsing_context&) override
+    {
+        next_column().push_null();
+    }
+
+    void do_null_value(const parsing_context&) override
+    {
+        next_column().push_null();
+    }
+
+    void do_double_value(double val, uint8_t, const parsing_context&) override
+    {
+        next_column().push_double(val);
+    }
+
+    void do_integer_value(int64_t val, const parsing_context&) override
+    {
+        next_column().push_integer(val);
+    }
+
+    void do_uinteger_value(uint64_t val, const parsing_context&) override
+    {
+        next_column().push_integer(static_cast<int64_t>(val));
+    }
+
+    void do_bool_value(bool val, const parsing_context&) override
+    {
+        next_column().push_bool(val);
+    }
+
+    basic_csv_column<CharT>& next_column()
+    {
+        if (header_row_)
+        {
+            // A header name that the parser converted by its column type
+            columns_.emplace_back();
+            ++column_;
+            return columns_.back();
+        }
+        if (column_ == columns_.size())
+        {
+            columns_.emplace_back();
+            columns_.back().resize(rows_);
+        }
+        return columns_[column_++];
+    }
+};
+
+}
+
+// basic_csv_column_reader
+
+// Reads CSV text into a basic_csv_column for each column, without building a basic_json
+// for each value. The fields are converted by the column_types parameters, and those of
+// columns without a type are strings. The columns are named from the header or the
+// column_names parameter. Rows with fewer fields than there are columns are filled with
+// nulls.
+
+template <class CharT = char>
+class basic_csv_column_reader
+{
+    typedef detail::csv_column_handler<CharT> handler_type;
+
+    basic_csv_column_reader(const basic_csv_column_reader&) = delete;
+    basic_csv_column_reader& operator=(const basic_csv_column_reader&) = delete;
+
+    std::basic_istream<CharT>& is_;
+    basic_csv_parameters<CharT> parameters_;
+public:
+    basic_csv_column_reader(std::basic_istream<CharT>& is)
+        : basic_csv_column_reader(is, basic_csv_parameters<CharT>())
+    {
+    }
+
+    basic_csv_column_reader(std::basic_istream<CharT>& is,
+                            const basic_csv_parameters<CharT>& params)
+       : is_(is), parameters_(params)
+    {
+        parameters_.mapping(mapping_type::n_rows);
+        for (const auto& t : parameters_.column_types())
+        {
+            if (t.first == csv_column_type::repeat_t || t.second > 0)
+            {
+                JSONCONS_THROW_EXCEPTION(std::invalid_argument,"Column types with arrays in a field are not held in columns");
+            }
+        }
+    }
+
+    // Appends the columns of the CSV text to columns, which should be empty
+    void read(std::vector<basic_csv_column<CharT>>& columns)
+    {
+        // The parser writes a header row when it reads or is given the column names, and only
+        // the projected columns
+        bool header_row = parameters_.header_lines() > 0 &&
+                          (parameters_.assume_header() || parameters_.column_names().size() > 0);
+        std::vector<std::basic_string<CharT>> names;
+        if (!header_row && parameters_.column_projection().size() == 0)
+        {
+            names = parameters_.column_names();
+        }
+        handler_type handler(columns, names, header_row);
+        basic_csv_reader<CharT> reader(is_, handler, parameters_);
+        reader.read();
+    }
+
+    std::vector<basic_csv_column<CharT>> read()
+    {
+        std::vector<basic_csv_column<CharT>> columns;
+        read(columns);
+        return columns;
+    }
+};
+
+typedef basic_csv_column_reader<char> csv_column_reader;
+typedef basic_csv_column_reader<wchar_t> wcsv_column_reader;
+
+// Reads all the columns of the CSV text in is
+template <class CharT>
+std::vector<basic_csv_column<CharT>> decode_csv_columns(std::basic_istream<CharT>& is,
+                                                        const basic_csv_parameters<CharT>& params = basic_csv_parameters<CharT>())
+{
+    basic_csv_column_reader<CharT> reader(is, params);
+    return reader.read();
+}
+
+}}
+
+#endif
@@ -18,7 +18,9 @@ namespace jsoncons { namespace csv {
         unexpected_eof = 1,
         expected_quote = 2,
         invalid_csv_text = 3,
-        invalid_state = 4
+        invalid_state = 4,
+        source_error = 5,
+        invalid_field_value = 6
     };
 
 class csv_error_category_impl
@@ -39,6 +41,10 @@ public:
             return "Expected quote character";
         case csv_parser_errc::invalid_csv_text:
             return "Invalid CSV text";
+        case csv_parser_errc::source_error:
+            return "Source error";
+        case csv_parser_errc::invalid_field_value:
+            return "Field value is not a value of the member type";
         default:
             return "Unknown JSON parser error";
         }
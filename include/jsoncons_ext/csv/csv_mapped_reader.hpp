@@ -0,0 +1,576 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_CSV_CSV_MAPPED_READER_HPP
+#define JSONCONS_CSV_CSV_MAPPED_READER_HPP
+
+#include <string>
+#include <vector>
+#include <exception>
+#include <algorithm>
+#include <system_error>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/json_input_handler.hpp>
+#include <jsoncons/parse_error_handler.hpp>
+#include <jsoncons/detail/mapped_file.hpp>
+#include <jsoncons/detail/parallel_workers.hpp>
+#include <jsoncons_ext/csv/csv_error_category.hpp>
+#include <jsoncons_ext/csv/csv_parameters.hpp>
+#include <jsoncons_ext/csv/csv_parser.hpp>
+
+namespace jsoncons { namespace csv {
+
+// Opts in to reading a memory mapped CSV file on more than one thread. The records
+// after the header are split into up to max_threads chunks of at least min_chunk_size
+// bytes each.
+
+class parallel_options
+{
+    size_t max_threads_;
+    size_t min_chunk_size_;
+public:
+    static const size_t default_min_chunk_size = 1024*1024;
+
+    parallel_options()
+        : max_threads_((std::max)(std::thread::hardware_concurrency(), 1u)),
+          min_chunk_size_(default_min_chunk_size)
+    {
+    }
+
+//  Accessors
+
+    size_t max_threads() const
+    {
+        return max_threads_;
+    }
+
+    size_t min_chunk_size() const
+    {
+        return min_chunk_size_;
+    }
+
+//  Modifiers
+
+    parallel_options& max_threads(size_t value)
+    {
+        max_threads_ = value;
+        return *this;
+    }
+
+    parallel_options& min_chunk_size(size_t value)
+    {
+        min_chunk_size_ = value;
+        return *this;
+    }
+};
+
+namespace detail {
+
+// Records the events a chunk of records is parsed into, so that they can be passed
+// on in the order of the chunks. Nothing is recorded before start(), and the array the
+// parser ends the chunk with, and end_json, are left out.
+
+template <class CharT>
+class csv_event_buffer : public basic_json_input_handler<CharT>
+{
+public:
+    using typename basic_json_input_handler<CharT>::string_view_type;
+private:
+    enum class event_kind : uint8_t {begin_object,end_object,begin_array,end_array,name,
+                                     string_value,byte_string_value,null_value,double_value,
+                                     integer_value,uinteger_value,bool_value};
+    struct event
+    {
+        event_kind kind;
+        uint8_t precision;
+        size_t offset;
+        size_t length;
+        union
+        {
+            int64_t integer_val;
+            uint64_t uinteger_val;
+            double double_val;
+            bool bool_val;
+        };
+    };
+
+    std::vector<event> events_;
+    std::basic_string<CharT> chars_;
+    std::vector<uint8_t> bytes_;
+    bool recording_;
+    size_t depth_;
+public:
+    csv_event_buffer()
+        : recording_(false), depth_(0)
+    {
+    }
+
+    void start()
+    {
+        recording_ = true;
+        depth_ = 0;
+    }
+
+    void replay(basic_json_input_handler<CharT>& handler, const parsing_context& context) const
+    {
+        for (const auto& e : events_)
+        {
+            switch (e.kind)
+            {
+            case event_kind::begin_object:
+                handler.begin_object(context);
+                break;
+            case event_kind::end_object:
+                handler.end_object(context);
+                break;
+            case event_kind::begin_array:
+                handler.begin_array(context);
+                break;
+            case event_kind::end_array:
+                handler.end_array(context);
+                break;
+            case event_kind::name:
+                handler.name(string_view_type(chars_.data() + e.offset, e.length), context);
+                break;
+            case event_kind::string_value:
+                handler.string_value(string_view_type(chars_.data() + e.offset, e.length), context);
+                break;
+            case event_kind::byte_string_value:
+                handler.byte_string_value(bytes_.data() + e.offset, e.length, context);
+                break;
+            case event_kind::null_value:
+                handler.null_value(context);
+                break;
+            case event_kind::double_value:
+                handler.double_value(e.double_val, e.precision, context);
+                break;
+            case event_kind::integer_value:
+                handler.integer_value(e.integer_val, context);
+                break;
+            case event_kind::uinteger_value:
+                handler.uinteger_value(e.uinteger_val, context);
+                break;
+            case event_kind::bool_value:
+                handler.bool_value(e.bool_val, context);
+                break;
+            }
+        }
+    }
+private:
+    event& push(event_kind kind)
+    {
+        events_.emplace_back();
+        event& e = events_.back();
+        e.kind = kind;
+        e.precision = 0;
+        e.offset = 0;
+        e.length = 0;
+        e.uinteger_val = 0;
+        return e;
+    }
+
+    void push_chars(event_kind kind, const string_view_type& s)
+    {
+        event& e = push(kind);
+        e.offset = chars_.size();
+        e.length = s.length();
+        chars_.append(s.data(), s.length());
+    }
+
+    void begin_structure(event_kind kind)
+    {
+        if (recording_)
+        {
+            ++depth_;
+            push(kind);
+        }
+    }
+
+    void end_structure(event_kind kind)
+    {
+        if (recording_ && depth_ > 0)
+        {
+            --depth_;
+            push(kind);
+        }
+    }
+
+    void do_begin_json() override
+    {
+    }
+
+    void do_end_json() override
+    {
+    }
+
+    void do_begin_object(const parsing_context&) override
+    {
+        begin_structure(event_kind::begin_object);
+    }
+
+    void do_end_object(const parsing_context&) override
+    {
+        end_structure(event_kind::end_object);
+    }
+
+    void do_begin_array(const parsing_context&) override
+    {
+        begin_structure(event_kind::begin_array);
+    }
+
+    void do_end_array(const parsing_context&) override
+    {
+        end_structure(event_kind::end_array);
+    }
+
+    void do_name(const string_view_type& name, const parsing_context&) override
+    {
+        if (recording_)
+        {
+            push_chars(event_kind::name, name);
+        }
+    }
+
+    void do_string_value(const string_view_type& value, const parsing_context&) override
+    {
+        if (recording_)
+        {
+            push_chars(event_kind::string_value, value);
+        }
+    }
+
+    void do_byte_string_value(const uint8_t* data, size_t length, const parsing_context&) override
+    {
+        if (recording_)
+        {
+            event& e = push(event_kind::byte_string_value);
+            e.offset = bytes_.size();
+            e.length = length;
+            bytes_.insert(bytes_.end(), data, data + length);
+        }
+    }
+
+    void do_null_value(const parsing_context&) override
+    {
+        if (recording_)
+        {
+            push(event_kind::null_value);
+        }
+    }
+
+    void do_double_value(double value, uint8_t precision, const parsing_context&) override
+    {
+        if (recording_)
+        {
+            event& e = push(event_kind::double_value);
+            e.double_val = value;
+            e.precision = precision;
+        }
+    }
+
+    void do_integer_value(int64_t value, const parsing_context&) override
+    {
+        if (recording_)
+        {
+            push(event_kind::integer_value).integer_val = value;
+        }
+    }
+
+    void do_uinteger_value(uint64_t value, const parsing_context&) override
+    {
+        if (recording_)
+        {
+            push(event_kind::uinteger_value).uinteger_val = value;
+        }
+    }
+
+    void do_bool_value(bool value, const parsing_context&) override
+    {
+        if (recording_)
+        {
+            push(event_kind::bool_value).bool_val = value;
+        }
+    }
+};
+
+}
+
+// Reads CSV text from a memory mapped file. Without parallel_options, or when the file
+// is too small to split, the whole mapping is passed to the parser at once.
+//
+// With parallel_options, the records after the header are split into chunks that are
+// parsed on their own threads, and the events of each chunk are passed to the handler
+// in order, on the calling thread, so that the handler sees the same events as it would
+// reading the file on one thread. A chunk boundary must fall at the end of a record, and
+// a line end inside a quoted value is not one, so the quote characters before each
+// boundary are counted first, also in parallel, to know whether it falls inside quotes.
+// That requires the escape character to be the quote character, and no comment lines.
+// The file is read on one thread when that isn't so, and for mapping_type::m_columns
+// or a max_lines limit.
+
+template<class CharT>
+class basic_csv_mapped_reader
+{
+    std::error_code open_ec_;
+    jsoncons::detail::mapped_file file_;
+    basic_json_input_handler<CharT>& handler_;
+    basic_csv_parameters<CharT> parameters_;
+    parallel_options options_;
+    bool parallel_;
+    basic_csv_parser<CharT> parser_;
+
+    // Noncopyable and nonmoveable
+    basic_csv_mapped_reader(const basic_csv_mapped_reader&) = delete;
+    basic_csv_mapped_reader& operator=(const basic_csv_mapped_reader&) = delete;
+
+public:
+    basic_csv_mapped_reader(const std::string& filename,
+                            basic_json_input_handler<CharT>& handler)
+        : file_(filename, open_ec_),
+          handler_(handler),
+          parallel_(false),
+          parser_(handler)
+    {
+    }
+
+    basic_csv_mapped_reader(const std::string& filename,
+                            basic_json_input_handler<CharT>& handler,
+                            basic_csv_parameters<CharT> params)
+        : file_(filename, open_ec_),
+          handler_(handler),
+          parameters_(params),
+          parallel_(false),
+          parser_(handler,params)
+    {
+    }
+
+    basic_csv_mapped_reader(const std::string& filename,
+                            basic_json_input_handler<CharT>& handler,
+                            basic_csv_parameters<CharT> params,
+                            const parallel_options& options)
+        : file_(filename, open_ec_),
+          handler_(handler),
+          parameters_(params),
+          options_(options),
+          parallel_(true),
+          parser_(handler,params)
+    {
+    }
+
+    // The error the file could not be opened or mapped with, if any
+    std::error_code open_error() const
+    {
+        return open_ec_;
+    }
+
+    void read()
+    {
+        if (open_ec_)
+        {
+            throw parse_error(csv_parser_errc::source_error,0,0);
+        }
+        const CharT* p = reinterpret_cast<const CharT*>(file_.data());
+        const size_t length = file_.size()/sizeof(CharT);
+
+        parser_.reset();
+        size_t chunks = 1;
+        size_t header_end = 0;
+        if (parallel_ && can_split() && options_.min_chunk_size() > 0)
+        {
+            header_end = find_header_end(p, length);
+            chunks = (std::min)(options_.max_threads(), (length - header_end) / options_.min_chunk_size());
+        }
+        if (chunks <= 1)
+        {
+            parser_.parse(p, 0, length);
+            parser_.end_parse();
+            return;
+        }
+
+        parser_.parse(p, 0, header_end);
+        std::vector<size_t> boundaries = find_boundaries(p, header_end, length, chunks);
+
+        std::vector<detail::csv_event_buffer<CharT>> buffers(chunks);
+        std::vector<std::exception_ptr> errors(chunks);
+        auto run = [&](size_t i)
+        {
+            try
+            {
+                basic_csv_parser<CharT> parser(buffers[i], parameters_);
+                parser.reset();
+                parser.parse(p, 0, header_end);
+                buffers[i].start();
+                parser.parse(p, boundaries[i], boundaries[i+1]);
+                parser.end_parse();
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        };
+        jsoncons::detail::joining_threads threads(chunks - 1);
+        for (size_t i = 1; i < chunks; ++i)
+        {
+            threads.start(run, i);
+        }
+        run(0);
+
+        // The events of each chunk are passed on as soon as it and those before it are parsed
+        std::exception_ptr error;
+        for (size_t i = 0; i < chunks; ++i)
+        {
+            if (i > 0)
+            {
+                threads.join(i-1);
+            }
+            if (!error)
+            {
+                if (errors[i])
+                {
+                    error = errors[i];
+                }
+                else
+                {
+                    try
+                    {
+                        buffers[i].replay(handler_, parser_.parsing_context());
+                    }
+                    catch (...)
+                    {
+                        error = std::current_exception();
+                    }
+                }
+            }
+            buffers[i] = detail::csv_event_buffer<CharT>();
+        }
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+        parser_.end_parse();
+    }
+
+private:
+    bool can_split() const
+    {
+        return parameters_.mapping() != mapping_type::m_columns &&
+               parameters_.max_lines() == (std::numeric_limits<unsigned long>::max)() &&
+               parameters_.quote_escape_char() == parameters_.quote_char() &&
+               parameters_.comment_starter() == '\0';
+    }
+
+    // Returns the position after the line end of the last header line, counted
+    // as the parser counts them
+    size_t find_header_end(const CharT* p, size_t length) const
+    {
+        const size_t header_lines = parameters_.header_lines();
+        if (header_lines == 0)
+        {
+            return 0;
+        }
+        const CharT quote = parameters_.quote_char();
+        bool quoted = false;
+        size_t line = 1;
+        for (size_t i = 0; i < length; ++i)
+        {
+            if (p[i] == quote)
+            {
+                quoted = !quoted;
+            }
+            else if (p[i] == '\r' || p[i] == '\n')
+            {
+                if (!quoted && line >= header_lines)
+                {
+                    return past_line_end(p, i, length);
+                }
+                if (p[i] == '\n' || i + 1 == length || p[i+1] != '\n')
+                {
+                    ++line;
+                }
+            }
+        }
+        return length;
+    }
+
+    // Returns the chunk boundaries, the first at header_end and the last at length, each
+    // after the first line end outside quotes at or after an even split of the records
+    std::vector<size_t> find_boundaries(const CharT* p, size_t header_end, size_t length, size_t chunks) const
+    {
+        const CharT quote = parameters_.quote_char();
+        std::vector<size_t> starts(chunks + 1);
+        for (size_t i = 0; i <= chunks; ++i)
+        {
+            starts[i] = header_end + (length - header_end)*i/chunks;
+        }
+
+        // The number of quote characters in each split is odd when it changes
+        // whether the next one begins inside quotes
+        std::vector<size_t> quotes(chunks);
+        for_each_chunk(chunks, [&](size_t i)
+        {
+            quotes[i] = static_cast<size_t>(std::count(p + starts[i], p + starts[i+1], quote));
+        });
+
+        std::vector<size_t> boundaries(chunks + 1);
+        boundaries[0] = header_end;
+        boundaries[chunks] = length;
+        std::vector<bool> quoted(chunks);
+        size_t count = 0;
+        for (size_t i = 1; i < chunks; ++i)
+        {
+            count += quotes[i-1];
+            quoted[i] = (count % 2) != 0;
+        }
+        for_each_chunk(chunks, [&](size_t i)
+        {
+            if (i == 0)
+            {
+                return;
+            }
+            bool in_quotes = quoted[i];
+            size_t j = starts[i];
+            for (; j < length; ++j)
+            {
+                if (p[j] == quote)
+                {
+                    in_quotes = !in_quotes;
+                }
+                else if (!in_quotes && (p[j] == '\r' || p[j] == '\n'))
+                {
+                    break;
+                }
+            }
+            boundaries[i] = j < length ? past_line_end(p, j, length) : length;
+        });
+        for (size_t i = 1; i < chunks; ++i)
+        {
+            boundaries[i] = (std::max)(boundaries[i], boundaries[i-1]);
+        }
+        return boundaries;
+    }
+
+    static size_t past_line_end(const CharT* p, size_t i, size_t length)
+    {
+        return (p[i] == '\r' && i + 1 < length && p[i+1] == '\n') ? i + 2 : i + 1;
+    }
+
+    template <class F>
+    static void for_each_chunk(size_t chunks, F f)
+    {
+        jsoncons::detail::joining_threads threads(chunks - 1);
+        for (size_t i = 1; i < chunks; ++i)
+        {
+            threads.start(f, i);
+        }
+        f(0);
+    }
+};
+
+typedef basic_csv_mapped_reader<char> csv_mapped_reader;
+
+}}
+
+#endif
@@ -307,6 +307,7 @@ public:
         quote_style_(quote_style_type::minimal),
         mapping_({mapping_type::n_rows,false}),
         max_lines_((std::numeric_limits<unsigned long>::max)()),
+        max_column_memory_((std::numeric_limits<size_t>::max)()),
         header_lines_(0)
     {
         line_delimiter_.push_back('\n');
@@ -500,6 +501,19 @@ public:
         return *this;
     }
 
+    // The columns to read, by name or by zero based index, in a comma separated list.
+    // The other columns are scanned past, and produce no events.
+    std::vector<std::basic_string<CharT>> column_projection() const
+    {
+        return column_projection_;
+    }
+
+    basic_csv_parameters<CharT>& column_projection(const std::basic_string<CharT>& columns)
+    {
+        column_projection_ = detail::parse_column_names(columns);
+        return *this;
+    }
+
     CharT field_delimiter() const
     {
         return field_delimiter_;
@@ -588,6 +602,19 @@ public:
         return *this;
     }
 
+    // For mapping_type::m_columns, the bytes of values held in memory before they are
+    // written to a temporary file
+    size_t max_column_memory() const
+    {
+        return max_column_memory_;
+    }
+
+    basic_csv_parameters<CharT>& max_column_memory(size_t value)
+    {
+        max_column_memory_ = value;
+        return *this;
+    }
+
 private:
     bool assume_header_;
     bool ignore_empty_values_;
@@ -603,6 +630,7 @@ private:
     quote_style_type quote_style_;
     std::pair<mapping_type,bool> mapping_;
     unsigned long max_lines_;
+    size_t max_column_memory_;
     size_t header_lines_;
     std::basic_string<CharT> line_delimiter_;
     std::basic_string<CharT> header_;
@@ -611,6 +639,7 @@ private:
     std::vector<std::basic_string<CharT>> column_names_;
     std::vector<std::pair<csv_column_type,size_t>> column_types_;
     std::vector<std::basic_string<CharT>> column_defaults_;
+    std::vector<std::basic_string<CharT>> column_projection_;
 };
 
 typedef basic_csv_parameters<char> csv_parameters;
@@ -16,16 +16,251 @@
 #include <stdexcept>
 #include <system_error>
 #include <cctype>
+#include <cstdio>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/json_input_handler.hpp>
 #include <jsoncons/parse_error_handler.hpp>
 #include <jsoncons/json_reader.hpp>
 #include <jsoncons/json_filter.hpp>
+#include <jsoncons/detail/string_scan.hpp>
 #include <jsoncons_ext/csv/csv_error_category.hpp>
 #include <jsoncons_ext/csv/csv_parameters.hpp>
 
 namespace jsoncons { namespace csv {
 
+namespace detail {
+
+// Converts the text of an integer_t cell, an optional sign and decimal digits, 
+// returns false if it is anything else or does not fit in an int64_t
+template <class CharT>
+bool try_cell_to_integer(const CharT* s, size_t length, int64_t& val)
+{
+    const CharT* p = s;
+    const CharT* last = s + length;
+    bool negative = false;
+    if (p < last && (*p == '-' || *p == '+'))
+    {
+        negative = *p == '-';
+        ++p;
+    }
+    if (p == last)
+    {
+        return false;
+    }
+    static const uint64_t max_magnitude = uint64_t(1) << 63;
+    uint64_t n = 0;
+    for (; p < last; ++p)
+    {
+        if (*p < '0' || *p > '9')
+        {
+            return false;
+        }
+        const uint64_t x = static_cast<uint64_t>(*p - '0');
+        if (n > (max_magnitude - x) / 10)
+        {
+            return false;
+        }
+        n = n*10 + x;
+    }
+    if (n == max_magnitude)
+    {
+        if (!negative)
+        {
+            return false;
+        }
+        val = (std::numeric_limits<int64_t>::min)();
+    }
+    else
+    {
+        val = negative ? -static_cast<int64_t>(n) : static_cast<int64_t>(n);
+    }
+    return true;
+}
+
+// Converts the text of a float_t cell with the json parser's decimal conversion,
+// returns false if it is not a plain decimal number or needs strtod
+template <class CharT>
+bool try_cell_to_double(const CharT* s, size_t length, double& val)
+{
+    char buffer[64];
+    if (length > sizeof(buffer))
+    {
+        return false;
+    }
+    for (size_t i = 0; i < length; ++i)
+    {
+        if (static_cast<uint32_t>(s[i]) > 127)
+        {
+            return false;
+        }
+        buffer[i] = static_cast<char>(s[i]);
+    }
+    return jsoncons::detail::try_decimal_to_double(buffer, length, val);
+}
+
+inline
+bool try_cell_to_double(const char* s, size_t length, double& val)
+{
+    return jsoncons::detail::try_decimal_to_double(s, length, val);
+}
+
+// The values of the columns of mapping_type::m_columns, which are only written when the
+// last line has been read. The values of a column are held as their characters one after
+// the other and their lengths. When they take more than max_memory bytes, the values of
+// every column are appended to a temporary file as a chunk, and the memory reused, so
+// that a file of many lines takes little more memory than max_memory. The chunks of a
+// column are read back from the file in order.
+
+template <class CharT>
+class csv_column_store
+{
+#if !defined(JSONCONS_HAS_STRING_VIEW)
+    typedef Basic_string_view_<CharT> string_view_type;
+#else
+    typedef std::basic_string_view<CharT> string_view_type;
+#endif
+    struct chunk
+    {
+        int64_t offset;
+        size_t count;
+        size_t length;
+    };
+
+    struct column
+    {
+        std::basic_string<CharT> chars;
+        std::vector<size_t> lengths;
+        std::vector<chunk> chunks;
+    };
+
+    std::vector<column> columns_;
+    size_t max_memory_;
+    size_t memory_;
+    std::FILE* file_;
+    int64_t file_length_;
+
+    // Noncopyable and nonmoveable
+    csv_column_store(const csv_column_store&) = delete;
+    csv_column_store& operator=(const csv_column_store&) = delete;
+public:
+    csv_column_store(size_t max_memory)
+        : max_memory_(max_memory), memory_(0), file_(nullptr), file_length_(0)
+    {
+    }
+
+    ~csv_column_store()
+    {
+        if (file_ != nullptr)
+        {
+            std::fclose(file_);
+        }
+    }
+
+    size_t size() const
+    {
+        return columns_.size();
+    }
+
+    void resize(size_t n)
+    {
+        columns_.resize(n);
+    }
+
+    void push_back(size_t i, const CharT* p, size_t length)
+    {
+        columns_[i].chars.append(p, length);
+        columns_[i].lengths.push_back(length);
+        memory_ += length*sizeof(CharT) + sizeof(size_t);
+        if (memory_ > max_memory_)
+        {
+            spill();
+        }
+    }
+
+    // Calls f with each value of column i, in order
+    template <class F>
+    void for_each(size_t i, F f)
+    {
+        const column& c = columns_[i];
+        if (!c.chunks.empty())
+        {
+            std::basic_string<CharT> chars;
+            std::vector<size_t> lengths;
+            for (const auto& ch : c.chunks)
+            {
+                lengths.resize(ch.count);
+                chars.resize(ch.length);
+                if (!seek(ch.offset) || 
+                    std::fread(&lengths[0], sizeof(size_t), ch.count, file_) != ch.count || 
+                    std::fread(&chars[0], sizeof(CharT), ch.length, file_) != ch.length)
+                {
+                    JSONCONS_THROW_EXCEPTION(std::runtime_error,"Cannot read column values from temporary file");
+                }
+                each_value(chars, lengths, f);
+            }
+        }
+        each_value(c.chars, c.lengths, f);
+    }
+private:
+    template <class F>
+    static void each_value(const std::basic_string<CharT>& chars, const std::vector<size_t>& lengths, F& f)
+    {
+        size_t pos = 0;
+        for (size_t length : lengths)
+        {
+            f(string_view_type(chars.data() + pos, length));
+            pos += length;
+        }
+    }
+
+    void spill()
+    {
+        if (file_ == nullptr)
+        {
+            file_ = std::tmpfile();
+            if (file_ == nullptr)
+            {
+                JSONCONS_THROW_EXCEPTION(std::runtime_error,"Cannot create temporary file for column values");
+            }
+        }
+        if (!seek(file_length_))
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Cannot write column values to temporary file");
+        }
+        for (auto& c : columns_)
+        {
+            if (c.lengths.empty())
+            {
+                continue;
+            }
+            if (std::fwrite(c.lengths.data(), sizeof(size_t), c.lengths.size(), file_) != c.lengths.size() || 
+                std::fwrite(c.chars.data(), sizeof(CharT), c.chars.size(), file_) != c.chars.size())
+            {
+                JSONCONS_THROW_EXCEPTION(std::runtime_error,"Cannot write column values to temporary file");
+            }
+            c.chunks.push_back(chunk{file_length_, c.lengths.size(), c.chars.size()});
+            file_length_ += static_cast<int64_t>(c.lengths.size()*sizeof(size_t) + c.chars.size()*sizeof(CharT));
+            c.chars.clear();
+            c.lengths.clear();
+        }
+        memory_ = 0;
+    }
+
+    bool seek(int64_t offset)
+    {
+#if defined(_MSC_VER)
+        return _fseeki64(file_, offset, SEEK_SET) == 0;
+#else
+        return fseeko(file_, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+    }
+};
+
+}
+
 enum class csv_mode_type 
 {
     initial,
@@ -61,6 +296,7 @@ class basic_csv_parser : private parsing_context
     typedef std::basic_string_view<CharT> string_view_type;
 #endif
     static const int default_depth = 3;
+    static const size_t max_selected_columns = 65536;
 
     default_parse_error_handler default_err_handler_;
     csv_state_type state_;
@@ -74,12 +310,21 @@ class basic_csv_parser : private parsing_context
     int curr_char_;
     int prev_char_;
     std::basic_string<CharT> value_buffer_;
+    // An unquoted field that ends in the current input chunk is not copied
+    // into value_buffer_, field_ views it in the input instead
+    string_view_type field_;
+    bool in_place_field_;
     int depth_;
     basic_csv_parameters<CharT> parameters_;
     std::vector<std::basic_string<CharT>> column_names_;
-    std::vector<std::vector<std::basic_string<CharT>>> column_values_;
+    detail::csv_column_store<CharT> column_values_;
     std::vector<std::pair<csv_column_type,size_t>> column_types_;
     std::vector<std::basic_string<CharT>> column_defaults_;
+    // With a column_projection, the columns to read, by index
+    bool projected_;
+    std::vector<bool> selected_columns_;
+    // Selected indexes past max_selected_columns, sorted
+    std::vector<size_t> far_selected_columns_;
     size_t column_index_;
     basic_json_fragment_filter<CharT> filter_;
     size_t level_;
@@ -92,6 +337,9 @@ public:
          handler_(handler),
          err_handler_(default_err_handler_),
          index_(0),
+         in_place_field_(false),
+         column_values_(parameters_.max_column_memory()),
+         projected_(false),
          filter_(handler),
          level_(0),
          offset_(0)
@@ -111,7 +359,10 @@ public:
          handler_(handler),
          err_handler_(default_err_handler_),
          index_(0),
+         in_place_field_(false),
          parameters_(params),
+         column_values_(parameters_.max_column_memory()),
+         projected_(false),
          filter_(handler),
          level_(0),
          offset_(0)
@@ -131,6 +382,9 @@ public:
          handler_(handler),
          err_handler_(err_handler),
          index_(0),
+         in_place_field_(false),
+         column_values_(parameters_.max_column_memory()),
+         projected_(false),
          filter_(handler),
          level_(0),
          offset_(0)
@@ -151,7 +405,10 @@ public:
          handler_(handler),
          err_handler_(err_handler),
          index_(0),
+         in_place_field_(false),
          parameters_(params),
+         column_values_(parameters_.max_column_memory()),
+         projected_(false),
          filter_(handler),
          level_(0),
          offset_(0)
@@ -228,6 +485,7 @@ public:
             {
                 flip(csv_mode_type::header, csv_mode_type::data);
             }
+            resolve_projection();
             column_values_.resize(column_names_.size());
             switch (parameters_.mapping())
             {
@@ -235,9 +493,12 @@ public:
                 if (column_names_.size() > 0)
                 {
                     handler_.begin_array(*this);
-                    for (const auto& name : column_names_)
+                    for (size_t i = 0; i < column_names_.size(); ++i)
                     {
-                        end_value(name,column_index_);
+                        if (is_selected(i))
+                        {
+                            end_value(column_names_[i],column_index_);
+                        }
                     }
                     handler_.end_array(*this);
                 }
@@ -280,6 +541,8 @@ public:
         {
             column_defaults_ = parameters_.column_defaults();
         }
+        projected_ = parameters_.column_projection().size() > 0;
+        resolve_projection();
         if (parameters_.header_lines() > 0)
         {
             push_mode(csv_mode_type::header);
@@ -356,7 +619,10 @@ all_csv_states:
                 {
                     if (curr_char_ == parameters_.quote_char())
                     {
-                        value_buffer_.push_back(static_cast<CharT>(curr_char_));
+                        if (!skipped())
+                        {
+                            value_buffer_.push_back(static_cast<CharT>(curr_char_));
+                        }
                         state_ = csv_state_type::quoted_string;
                     }
                     else if (parameters_.quote_escape_char() == parameters_.quote_char())
@@ -384,9 +650,27 @@ all_csv_states:
                         after_field();
                         state_ = csv_state_type::between_fields;
                     }
+                    else if (curr_char_ == '\r' || curr_char_ == '\n')
+                    {
+                        if (!skipped())
+                        {
+                            value_buffer_.push_back(static_cast<CharT>(curr_char_));
+                        }
+                    }
                     else
                     {
-                        value_buffer_.push_back(static_cast<CharT>(curr_char_));
+                        // Append the run of characters up to the next quote, escape or line end
+                        const CharT* first = p + index_;
+                        const CharT* last = jsoncons::detail::find_one_of(first + 1, p + length,
+                                                                          parameters_.quote_escape_char(),
+                                                                          parameters_.quote_char(),
+                                                                          static_cast<CharT>('\r'), 
+                                                                          static_cast<CharT>('\n'));
+                        if (!skipped())
+                        {
+                            value_buffer_.append(first, last - first);
+                        }
+                        skip_run(first, last);
                     }
                 }
                 break;
@@ -408,8 +692,9 @@ all_csv_states:
                             end_unquoted_string_value();
                             after_field();
                             after_record();
-                            state_ = csv_state_type::expect_value;
                         }
+                        // The LF of a CR LF ends nothing, and does not begin a value 
+                        state_ = csv_state_type::expect_value;
                     }
                     else if (curr_char_ == parameters_.field_delimiter())
                     {
@@ -421,11 +706,33 @@ all_csv_states:
                     else if (curr_char_ == parameters_.quote_char())
                     {
                         value_buffer_.clear();
+                        in_place_field_ = false;
                         state_ = csv_state_type::quoted_string;
                     }
                     else
                     {
-                        value_buffer_.push_back(static_cast<CharT>(curr_char_));
+                        // The rest of the field is the run of characters up to the next 
+                        // delimiter, quote or line end
+                        const CharT* first = p + index_;
+                        const CharT* last = jsoncons::detail::find_one_of(first + 1, p + length,
+                                                                          parameters_.field_delimiter(),
+                                                                          parameters_.quote_char(),
+                                                                          static_cast<CharT>('\r'), 
+                                                                          static_cast<CharT>('\n'));
+                        if (skipped())
+                        {
+                            // A column left out of the projection is only scanned past
+                        }
+                        else if (value_buffer_.empty() && last < p + length)
+                        {
+                            field_ = string_view_type(first, last - first);
+                            in_place_field_ = true;
+                        }
+                        else
+                        {
+                            value_buffer_.append(first, last - first);
+                        }
+                        skip_run(first, last);
                     }
                 }
                 break;
@@ -510,12 +817,13 @@ all_csv_states:
             handler_.begin_object(*this);
             for (size_t i = 0; i < column_values_.size(); ++i)
             {
-                handler_.name(string_view_type(column_names_[i].data(),column_names_[i].size()),*this);
-                handler_.begin_array(*this);
-                for (const auto& val : column_values_[i])
+                if (!is_selected(i))
                 {
-                    end_value(val,i);
+                    continue;
                 }
+                handler_.name(string_view_type(column_names_[i].data(),column_names_[i].size()),*this);
+                handler_.begin_array(*this);
+                column_values_.for_each(i, [&](const string_view_type& val){end_value(val,i);});
                 handler_.end_array(*this);
             }
             handler_.end_object(*this);
@@ -544,16 +852,101 @@ all_csv_states:
     }
 private:
 
-    void trim_string_buffer(bool trim_leading, bool trim_trailing)
+    // Moves index_ to the last character of the run [first,last), which holds no line ends,
+    // and updates the column as though the characters before it had been read one by one
+    void skip_run(const CharT* first, const CharT* last)
+    {
+        size_t n = last - first;
+        index_ += n - 1;
+        column_ += static_cast<unsigned long>(n - 1);
+        curr_char_ = last[-1];
+    }
+
+    bool is_selected(size_t column_index) const
+    {
+        if (!projected_)
+        {
+            return true;
+        }
+        if (column_index < selected_columns_.size())
+        {
+            return selected_columns_[column_index];
+        }
+        return std::binary_search(far_selected_columns_.begin(), far_selected_columns_.end(), column_index);
+    }
+
+    // True for the characters of a data field that is not in the projection
+    bool skipped() const
+    {
+        return projected_ && stack_[top_] == csv_mode_type::data && !is_selected(column_index_);
+    }
+
+    // Projected columns that are decimal numbers are indexes, the others are names,
+    // found in the column names once they are known
+    void resolve_projection()
+    {
+        selected_columns_.clear();
+        far_selected_columns_.clear();
+        for (const auto& column : parameters_.column_projection())
+        {
+            bool is_index = column.length() > 0;
+            size_t index = 0;
+            for (auto c : column)
+            {
+                const size_t digit = static_cast<size_t>(c - '0');
+                if (c < '0' || c > '9' || index > ((std::numeric_limits<size_t>::max)() - digit)/10)
+                {
+                    // Not a number, or a column that cannot exist
+                    is_index = false;
+                    break;
+                }
+                index = index*10 + digit;
+            }
+            if (is_index)
+            {
+                select_column(index);
+            }
+            else
+            {
+                for (size_t i = 0; i < column_names_.size(); ++i)
+                {
+                    if (column_names_[i] == column)
+                    {
+                        select_column(i);
+                    }
+                }
+            }
+        }
+    }
+
+    void select_column(size_t index)
+    {
+        if (index >= max_selected_columns)
+        {
+            auto it = std::lower_bound(far_selected_columns_.begin(), far_selected_columns_.end(), index);
+            if (it == far_selected_columns_.end() || *it != index)
+            {
+                far_selected_columns_.insert(it, index);
+            }
+            return;
+        }
+        if (index >= selected_columns_.size())
+        {
+            selected_columns_.resize(index + 1, false);
+        }
+        selected_columns_[index] = true;
+    }
+
+    static string_view_type trim_string_view(const string_view_type& value, bool trim_leading, bool trim_trailing)
     {
         size_t start = 0;
-        size_t length = value_buffer_.length();
+        size_t length = value.length();
         if (trim_leading)
         {
             bool done = false;
-            while (!done && start < value_buffer_.length())
+            while (!done && start < length)
             {
-                if ((value_buffer_[start] < 256) && std::isspace(value_buffer_[start]))
+                if ((value[start] < 256) && std::isspace(value[start]))
                 {
                     ++start;
                 }
@@ -568,7 +961,7 @@ private:
             bool done = false;
             while (!done && length > 0)
             {
-                if ((value_buffer_[length-1] < 256) && std::isspace(value_buffer_[length-1]))
+                if (length > start && (value[length-1] < 256) && std::isspace(value[length-1]))
                 {
                     --length;
                 }
@@ -578,52 +971,55 @@ private:
                 }
             }
         }
-        if (start != 0 || length != value_buffer_.size())
-        {
-            value_buffer_ = value_buffer_.substr(start,length-start);
-        }
+        return string_view_type(value.data() + start, length - start);
     }
 
     void end_unquoted_string_value() 
     {
+        if (skipped())
+        {
+            state_ = csv_state_type::expect_value;
+            return;
+        }
+        string_view_type value = in_place_field_ ? field_ : string_view_type(value_buffer_.data(), value_buffer_.length());
         if (parameters_.trim_leading() | parameters_.trim_trailing())
         {
-            trim_string_buffer(parameters_.trim_leading(),parameters_.trim_trailing());
+            value = trim_string_view(value, parameters_.trim_leading(),parameters_.trim_trailing());
         }
         switch (stack_[top_])
         {
         case csv_mode_type::header:
             if (parameters_.assume_header() && line_ == 1)
             {
-                column_names_.push_back(value_buffer_);
+                column_names_.push_back(std::basic_string<CharT>(value.data(), value.length()));
             }
             break;
         case csv_mode_type::data:
             switch (parameters_.mapping())
             {
             case mapping_type::n_rows:
-                if (parameters_.unquoted_empty_value_is_null() && value_buffer_.length() == 0)
+                if (parameters_.unquoted_empty_value_is_null() && value.length() == 0)
                 {
                     handler_.null_value(*this);
                 }
                 else
                 {
-                    end_value(value_buffer_,column_index_);
+                    end_value(value,column_index_);
                 }
                 break;
             case mapping_type::n_objects:
-                if (!(parameters_.ignore_empty_values() && value_buffer_.size() == 0))
+                if (!(parameters_.ignore_empty_values() && value.length() == 0))
                 {
                     if (column_index_ < column_names_.size())
                     {
                         handler_.name(column_names_[column_index_], *this);
-                        if (parameters_.unquoted_empty_value_is_null() && value_buffer_.length() == 0)
+                        if (parameters_.unquoted_empty_value_is_null() && value.length() == 0)
                         {
                             handler_.null_value(*this);
                         }
                         else
                         {
-                            end_value(value_buffer_,column_index_);
+                            end_value(value,column_index_);
                         }
                     }
                 }
@@ -631,7 +1027,7 @@ private:
             case mapping_type::m_columns:
                 if (column_index_ < column_values_.size())
                 {
-                    column_values_[column_index_].push_back(value_buffer_);
+                    column_values_.push_back(column_index_, value.data(), value.length());
                 }
                 break;
             }
@@ -641,39 +1037,50 @@ private:
         }
         state_ = csv_state_type::expect_value;
         value_buffer_.clear();
+        in_place_field_ = false;
     }
 
     void end_quoted_string_value(std::error_code& ec) 
     {
+        if (skipped())
+        {
+            state_ = csv_state_type::expect_value;
+            return;
+        }
+        string_view_type value(value_buffer_.data(), value_buffer_.length());
         if (parameters_.trim_leading_inside_quotes() | parameters_.trim_trailing_inside_quotes())
         {
-            trim_string_buffer(parameters_.trim_leading_inside_quotes(),parameters_.trim_trailing_inside_quotes());
+            value = trim_string_view(value, parameters_.trim_leading_inside_quotes(),parameters_.trim_trailing_inside_quotes());
         }
         switch (stack_[top_])
         {
         case csv_mode_type::header:
             if (parameters_.assume_header() && line_ == 1)
             {
-                column_names_.push_back(value_buffer_);
+                column_names_.push_back(std::basic_string<CharT>(value.data(), value.length()));
             }
             break;
         case csv_mode_type::data:
             switch (parameters_.mapping())
             {
             case mapping_type::n_rows:
-                end_value(value_buffer_,column_index_);
+                end_value(value,column_index_);
                 break;
             case mapping_type::n_objects:
-                if (!(parameters_.ignore_empty_values() && value_buffer_.size() == 0))
+                if (!(parameters_.ignore_empty_values() && value.length() == 0))
                 {
                     if (column_index_ < column_names_.size())
                     {
                         handler_.name(column_names_[column_index_], *this);
-                        end_value(value_buffer_,column_index_);
+                        end_value(value,column_index_);
                     }
                 }
                 break;
             case mapping_type::m_columns:
+                if (column_index_ < column_values_.size())
+                {
+                    column_values_.push_back(column_index_, value.data(), value.length());
+                }
                 break;
             }
             break;
@@ -716,8 +1123,13 @@ private:
             {
             case csv_column_type::integer_t:
                 {
-                    std::istringstream iss(value);
                     int64_t val;
+                    if (detail::try_cell_to_integer(value.data(), value.length(), val))
+                    {
+                        handler_.integer_value(val, *this);
+                        break;
+                    }
+                    std::istringstream iss(value);
                     iss >> val;
                     if (!iss.fail())
                     {
@@ -740,8 +1152,13 @@ private:
                 break;
             case csv_column_type::float_t:
                 {
-                    std::istringstream iss(value);
                     double val;
+                    if (detail::try_cell_to_double(value.data(), value.length(), val))
+                    {
+                        handler_.double_value(val, *this);
+                        break;
+                    }
+                    std::istringstream iss(value);
                     iss >> val;
                     if (!iss.fail())
                     {
@@ -810,7 +1227,7 @@ private:
                     }
                     else
                     {
-                        handler_.string_value(string_view_type(), *this);
+                        handler_.string_value(value, *this);
                     }
                 }
                 break;  
@@ -843,7 +1260,7 @@ private:
         stack_[top_] = mode;
     }
 
-    int peek()
+    csv_mode_type peek()
     {
         return stack_[top_];
     }
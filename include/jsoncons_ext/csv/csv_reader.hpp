@@ -20,6 +20,7 @@
 #include <jsoncons_ext/csv/csv_parser.hpp>
 #include <jsoncons/json.hpp>
 #include <jsoncons/json_reader.hpp>
+#include <jsoncons/input_source.hpp>
 #include <jsoncons_ext/csv/csv_parameters.hpp>
 
 namespace jsoncons { namespace csv {
@@ -40,7 +41,8 @@ class basic_csv_reader
     basic_csv_reader& operator = (const basic_csv_reader&) = delete; 
 
     basic_csv_parser<CharT> parser_;
-    std::basic_istream<CharT>& is_;
+    basic_stream_source<CharT> stream_source_;
+    basic_input_source<CharT>* source_;
     std::vector<CharT> buffer_;
     size_t buffer_length_;
     size_t buffer_position_;
@@ -58,7 +60,8 @@ public:
                      basic_json_input_handler<CharT>& handler)
 
        : parser_(handler),
-         is_(is),
+         stream_source_(is),
+         source_(std::addressof(stream_source_)),
          buffer_length_(default_max_buffer_length),
          buffer_position_(0),
          eof_(false),
@@ -72,7 +75,8 @@ public:
                      basic_csv_parameters<CharT> params)
 
        : parser_(handler,params),
-         is_(is),
+         stream_source_(is),
+         source_(std::addressof(stream_source_)),
          buffer_length_(default_max_buffer_length),
          buffer_position_(0),
          eof_(false),
@@ -86,7 +90,8 @@ public:
                      parse_error_handler& err_handler)
        :
          parser_(handler,err_handler),
-         is_(is),
+         stream_source_(is),
+         source_(std::addressof(stream_source_)),
          buffer_length_(default_max_buffer_length),
          buffer_position_(0),
          eof_(false),
@@ -101,7 +106,65 @@ public:
                      basic_csv_parameters<CharT> params)
        :
          parser_(handler,err_handler,params),
-         is_(is),
+         stream_source_(is),
+         source_(std::addressof(stream_source_)),
+         buffer_length_(default_max_buffer_length),
+         buffer_position_(0),
+         eof_(false),
+         index_(0)
+    {
+        buffer_.reserve(buffer_length_);
+    }
+
+    // Reads from a source, which fills the reader's buffer directly
+    basic_csv_reader(basic_input_source<CharT>& source,
+                     basic_json_input_handler<CharT>& handler)
+
+       : parser_(handler),
+         source_(std::addressof(source)),
+         buffer_length_(default_max_buffer_length),
+         buffer_position_(0),
+         eof_(false),
+         index_(0)
+    {
+        buffer_.reserve(buffer_length_);
+    }
+
+    basic_csv_reader(basic_input_source<CharT>& source,
+                     basic_json_input_handler<CharT>& handler,
+                     basic_csv_parameters<CharT> params)
+
+       : parser_(handler,params),
+         source_(std::addressof(source)),
+         buffer_length_(default_max_buffer_length),
+         buffer_position_(0),
+         eof_(false),
+         index_(0)
+    {
+        buffer_.reserve(buffer_length_);
+    }
+
+    basic_csv_reader(basic_input_source<CharT>& source,
+                     basic_json_input_handler<CharT>& handler,
+                     parse_error_handler& err_handler)
+       :
+         parser_(handler,err_handler),
+         source_(std::addressof(source)),
+         buffer_length_(default_max_buffer_length),
+         buffer_position_(0),
+         eof_(false),
+         index_(0)
+    {
+        buffer_.reserve(buffer_length_);
+    }
+
+    basic_csv_reader(basic_input_source<CharT>& source,
+                     basic_json_input_handler<CharT>& handler,
+                     parse_error_handler& err_handler,
+                     basic_csv_parameters<CharT> params)
+       :
+         parser_(handler,err_handler,params),
+         source_(std::addressof(source)),
          buffer_length_(default_max_buffer_length),
          buffer_position_(0),
          eof_(false),
@@ -121,12 +184,15 @@ public:
         {
             if (!(index_ < buffer_.size()))
             {
-                if (!is_.eof())
+                if (!source_->eof())
                 {
                     buffer_.clear();
                     buffer_.resize(buffer_length_);
-                    is_.read(buffer_.data(), buffer_length_);
-                    buffer_.resize(static_cast<size_t>(is_.gcount()));
+                    buffer_.resize(source_->read(buffer_.data(), buffer_length_));
+                    if (source_->fail())
+                    {
+                        throw parse_error(csv_parser_errc::source_error,0,0);
+                    }
                     if (buffer_.size() == 0)
                     {
                         eof_ = true;
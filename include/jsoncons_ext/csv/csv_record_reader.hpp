@@ -0,0 +1,516 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_CSV_CSV_RECORD_READER_HPP
+#define JSONCONS_CSV_CSV_RECORD_READER_HPP
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <istream>
+#include <limits>
+#include <locale>
+#include <type_traits>
+#include <utility>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/json_input_handler.hpp>
+#include <jsoncons/json_type_traits.hpp>
+#include <jsoncons_ext/csv/csv_error_category.hpp>
+#include <jsoncons_ext/csv/csv_parameters.hpp>
+#include <jsoncons_ext/csv/csv_parser.hpp>
+#include <jsoncons_ext/csv/csv_reader.hpp>
+
+namespace jsoncons { namespace csv {
+
+// csv_record_traits
+
+// Maps the columns of a CSV record onto the members of T. A specialization defines
+//
+//     template <class Visitor>
+//     static void members(Visitor& visitor)
+//     {
+//         visitor("author", &book::author);
+//         visitor("price", &book::price);
+//     }
+//
+// naming each member and its column. When the CSV text has no column names, the
+// members are the columns in the order given.
+
+template <class T, class Enable = void>
+struct csv_record_traits
+{
+    static const bool is_specialized = false;
+};
+
+// csv_field_traits
+
+// Converts the characters of a field to a member of type T, returns false if they
+// are not a value of T. Strings, integers, floating point numbers and bools are
+// converted in place, other types from a json string with json_type_traits.
+
+template <class T, class CharT, class Enable = void>
+struct csv_field_traits
+{
+    static bool assign(const CharT* s, size_t length, T& val)
+    {
+        basic_json<CharT> j(s, length);
+        if (!j.template is<T>())
+        {
+            return false;
+        }
+        val = j.template as<T>();
+        return true;
+    }
+};
+
+template <class CharT, class Traits, class Allocator>
+struct csv_field_traits<std::basic_string<CharT,Traits,Allocator>, CharT>
+{
+    static bool assign(const CharT* s, size_t length, std::basic_string<CharT,Traits,Allocator>& val)
+    {
+        val.assign(s, length);
+        return true;
+    }
+};
+
+template <class T, class CharT>
+struct csv_field_traits<T, CharT,
+                        typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value &&
+                                                !std::is_same<T,CharT>::value>::type>
+{
+    static bool assign(const CharT* s, size_t length, T& val)
+    {
+        int64_t n;
+        if (!detail::try_cell_to_integer(s, length, n) ||
+            n < static_cast<int64_t>((std::numeric_limits<T>::min)()) ||
+            n > static_cast<int64_t>((std::numeric_limits<T>::max)()))
+        {
+            return false;
+        }
+        val = static_cast<T>(n);
+        return true;
+    }
+};
+
+template <class T, class CharT>
+struct csv_field_traits<T, CharT,
+                        typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value &&
+                                                !std::is_same<T,bool>::value && !std::is_same<T,CharT>::value>::type>
+{
+    static bool assign(const CharT* s, size_t length, T& val)
+    {
+        const CharT* p = s;
+        const CharT* last = s + length;
+        if (p < last && *p == '+')
+        {
+            ++p;
+        }
+        if (p == last)
+        {
+            return false;
+        }
+        const uint64_t max_value = static_cast<uint64_t>((std::numeric_limits<T>::max)());
+        uint64_t n = 0;
+        for (; p < last; ++p)
+        {
+            if (*p < '0' || *p > '9')
+            {
+                return false;
+            }
+            const uint64_t x = static_cast<uint64_t>(*p - '0');
+            if (n > (max_value - x) / 10)
+            {
+                return false;
+            }
+            n = n*10 + x;
+        }
+        val = static_cast<T>(n);
+        return true;
+    }
+};
+
+template <class T, class CharT>
+struct csv_field_traits<T, CharT,
+                        typename std::enable_if<std::is_floating_point<T>::value>::type>
+{
+    static bool assign(const CharT* s, size_t length, T& val)
+    {
+        double d;
+        if (!detail::try_cell_to_double(s, length, d))
+        {
+            std::basic_istringstream<CharT> iss(std::basic_string<CharT>(s, length));
+            iss.imbue(std::locale::classic());
+            iss >> d;
+            if (iss.fail() || iss.peek() != std::char_traits<CharT>::eof())
+            {
+                return false;
+            }
+        }
+        val = static_cast<T>(d);
+        return true;
+    }
+};
+
+template <class CharT>
+struct csv_field_traits<bool, CharT>
+{
+    // 0, 1, true or false in any case, as for the boolean column type
+    static bool assign(const CharT* s, size_t length, bool& val)
+    {
+        if (length == 1 && (s[0] == '0' || s[0] == '1'))
+        {
+            val = s[0] == '1';
+            return true;
+        }
+        else if (length == 4 && equals_ignore_case(s, "true", 4))
+        {
+            val = true;
+            return true;
+        }
+        else if (length == 5 && equals_ignore_case(s, "false", 5))
+        {
+            val = false;
+            return true;
+        }
+        return false;
+    }
+private:
+    static bool equals_ignore_case(const CharT* s, const char* lower, size_t length)
+    {
+        for (size_t i = 0; i < length; ++i)
+        {
+            if (s[i] != lower[i] && s[i] != lower[i] - ('a' - 'A'))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+namespace detail {
+
+// Receives the events of mapping_type::n_rows and fills a T for each row. The
+// fields are converted to their members as the parser reports them, while their
+// characters are still in the parser's buffer.
+
+template <class T, class CharT>
+class csv_record_handler : public basic_json_input_handler<CharT>
+{
+public:
+    using typename basic_json_input_handler<CharT>::string_view_type;
+    typedef void (*emit_function)(void*, T&&);
+private:
+    static const size_t npos = static_cast<size_t>(-1);
+
+    struct name_collector
+    {
+        std::vector<std::basic_string<CharT>>& names;
+
+        template <class S, class M>
+        void operator()(const S& name, M T::*)
+        {
+            names.push_back(std::basic_string<CharT>(name));
+        }
+    };
+
+    struct field_assigner
+    {
+        T& record;
+        size_t target;
+        size_t index;
+        const CharT* data;
+        size_t length;
+        bool ok;
+
+        template <class S, class M>
+        void operator()(const S&, M T::*member)
+        {
+            if (index++ == target)
+            {
+                ok = csv_field_traits<M,CharT>::assign(data, length, record.*member);
+            }
+        }
+    };
+
+    std::vector<std::basic_string<CharT>> member_names_;
+    std::vector<size_t> member_index_;
+    std::vector<std::basic_string<CharT>> header_names_;
+    bool header_row_;
+    size_t level_;
+    size_t column_;
+    T record_;
+    emit_function emit_;
+    void* context_;
+public:
+    csv_record_handler(const std::vector<std::basic_string<CharT>>& column_names, bool header_row)
+        : header_row_(header_row), level_(0), column_(0), emit_(nullptr), context_(nullptr)
+    {
+        name_collector collector{member_names_};
+        csv_record_traits<T>::members(collector);
+        if (column_names.size() > 0)
+        {
+            map_columns(column_names);
+        }
+        else
+        {
+            for (size_t i = 0; i < member_names_.size(); ++i)
+            {
+                member_index_.push_back(i);
+            }
+        }
+    }
+
+    const std::vector<std::basic_string<CharT>>& member_names() const
+    {
+        return member_names_;
+    }
+
+    void emit(emit_function f, void* context)
+    {
+        emit_ = f;
+        context_ = context;
+    }
+private:
+    void map_columns(const std::vector<std::basic_string<CharT>>& column_names)
+    {
+        member_index_.assign(column_names.size(), static_cast<size_t>(npos));
+        for (size_t i = 0; i < column_names.size(); ++i)
+        {
+            for (size_t j = 0; j < member_names_.size(); ++j)
+            {
+                if (column_names[i] == member_names_[j])
+                {
+                    member_index_[i] = j;
+                    break;
+                }
+            }
+        }
+    }
+
+    void do_begin_json() override
+    {
+    }
+
+    void do_end_json() override
+    {
+    }
+
+    void do_begin_object(const parsing_context& context) override
+    {
+        throw parse_error(csv_parser_errc::invalid_state, context.line_number(), context.column_number());
+    }
+
+    void do_end_object(const parsing_context&) override
+    {
+    }
+
+    void do_begin_array(const parsing_context&) override
+    {
+        if (++level_ == 2)
+        {
+            column_ = 0;
+            if (!header_row_)
+            {
+                record_ = T();
+            }
+        }
+    }
+
+    void do_end_array(const parsing_context&) override
+    {
+        if (level_-- == 2)
+        {
+            if (header_row_)
+            {
+                map_columns(header_names_);
+                header_names_.clear();
+                header_row_ = false;
+            }
+            else
+            {
+                emit_(context_, std::move(record_));
+            }
+        }
+    }
+
+    void do_name(const string_view_type&, const parsing_context&) override
+    {
+    }
+
+    void do_string_value(const string_view_type& value, const parsing_context& context) override
+    {
+        if (header_row_)
+        {
+            header_names_.push_back(std::basic_string<CharT>(value.data(), value.length()));
+            return;
+        }
+        field(value.data(), value.length(), context);
+    }
+
+    void do_byte_string_value(const uint8_t*, size_t, const parsing_context&) override
+    {
+        ++column_;
+    }
+
+    void do_null_value(const parsing_context&) override
+    {
+        ++column_;
+    }
+
+    void do_double_value(double, uint8_t, const parsing_context&) override
+    {
+        ++column_;
+    }
+
+    void do_integer_value(int64_t, const parsing_context&) override
+    {
+        ++column_;
+    }
+
+    void do_uinteger_value(uint64_t, const parsing_context&) override
+    {
+        ++column_;
+    }
+
+    void do_bool_value(bool, const parsing_context&) override
+    {
+        ++column_;
+    }
+
+    void field(const CharT* data, size_t length, const parsing_context& context)
+    {
+        const size_t column = column_++;
+        if (length > 0 && column < member_index_.size() && member_index_[column] != npos)
+        {
+            field_assigner assigner{record_, member_index_[column], 0, data, length, true};
+            csv_record_traits<T>::members(assigner);
+            if (!assigner.ok)
+            {
+                throw parse_error(csv_parser_errc::invalid_field_value, context.line_number(), context.column_number());
+            }
+        }
+    }
+};
+
+}
+
+// basic_csv_record_reader
+
+// Reads CSV text into objects of a type T that has a specialization of csv_record_traits,
+// without building a basic_json for each record. The columns are matched to the members
+// by name when the text has a header or column_names are given, otherwise by position.
+// Columns without a member are skipped, and when the names of the members are plain, the
+// parser is given them as a column_projection so that it does not buffer the others.
+// Empty fields leave their members default constructed.
+
+template <class T, class CharT = char>
+class basic_csv_record_reader
+{
+    typedef detail::csv_record_handler<T,CharT> handler_type;
+
+    basic_csv_record_reader(const basic_csv_record_reader&) = delete;
+    basic_csv_record_reader& operator=(const basic_csv_record_reader&) = delete;
+
+    basic_csv_parameters<CharT> parameters_;
+    handler_type handler_;
+    basic_csv_reader<CharT> reader_;
+public:
+    basic_csv_record_reader(std::basic_istream<CharT>& is)
+        : basic_csv_record_reader(is, basic_csv_parameters<CharT>())
+    {
+    }
+
+    basic_csv_record_reader(std::basic_istream<CharT>& is,
+                            const basic_csv_parameters<CharT>& params)
+       : parameters_(params),
+         handler_(params.header_lines() > 0 ? std::vector<std::basic_string<CharT>>() : params.column_names(),
+                  params.header_lines() > 0),
+         reader_(is, handler_, record_parameters(params, handler_.member_names()))
+    {
+    }
+
+    // Calls f with each record, as an rvalue
+    template <class Function>
+    void read(Function f)
+    {
+        handler_.emit(&call<Function>, &f);
+        reader_.read();
+    }
+
+    void read(std::vector<T>& records)
+    {
+        read([&records](T&& record){records.push_back(std::move(record));});
+    }
+private:
+    template <class Function>
+    static void call(void* context, T&& record)
+    {
+        (*static_cast<Function*>(context))(std::move(record));
+    }
+
+    static basic_csv_parameters<CharT> record_parameters(basic_csv_parameters<CharT> params,
+                                                         const std::vector<std::basic_string<CharT>>& names)
+    {
+        params.mapping(mapping_type::n_rows);
+        params.column_types(std::basic_string<CharT>());
+        if (params.header_lines() > 0 && params.column_names().size() == 0 &&
+            params.column_projection().size() == 0 && names.size() > 0)
+        {
+            std::basic_string<CharT> projection;
+            for (const auto& name : names)
+            {
+                if (!is_plain_name(name))
+                {
+                    return params;
+                }
+                if (!projection.empty())
+                {
+                    projection.push_back(',');
+                }
+                projection.append(name);
+            }
+            params.column_projection(projection);
+        }
+        return params;
+    }
+
+    // A name that column_projection reads back as the same name, not as an index
+    static bool is_plain_name(const std::basic_string<CharT>& name)
+    {
+        if (name.empty() || (name[0] >= '0' && name[0] <= '9'))
+        {
+            return false;
+        }
+        for (auto c : name)
+        {
+            if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_'))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+template <class T>
+using csv_record_reader = basic_csv_record_reader<T,char>;
+
+// Reads all the records of the CSV text in is
+template <class T, class CharT>
+std::vector<T> decode_csv_records(std::basic_istream<CharT>& is,
+                                  const basic_csv_parameters<CharT>& params = basic_csv_parameters<CharT>())
+{
+    std::vector<T> records;
+    basic_csv_record_reader<T,CharT> reader(is, params);
+    reader.read(records);
+    return records;
+}
+
+}}
+
+#endif
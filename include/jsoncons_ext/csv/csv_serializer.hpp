@@ -14,10 +14,14 @@
 #include <cstdlib>
 #include <map>
 #include <limits> // std::numeric_limits
+#include <initializer_list>
+#include <type_traits>
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/serialization_options.hpp>
 #include <jsoncons/json_output_handler.hpp>
-#include <jsoncons/detail/osequencestream.hpp>
+#include <jsoncons/output_sink.hpp>
+#include <jsoncons/json_type_traits.hpp>
+#include <jsoncons/detail/string_scan.hpp>
 #include <jsoncons_ext/csv/csv_parameters.hpp>
 
 namespace jsoncons { namespace csv {
@@ -28,20 +32,21 @@ void escape_string(const CharT* s,
                    CharT quote_char, CharT quote_escape_char,
                    buffered_output<CharT>& os)
 {
-    const CharT* begin = s;
+    // The characters between quotes are written a run at a time
+    const CharT* p = s;
     const CharT* end = s + length;
-    for (const CharT* it = begin; it != end; ++it)
+    while (p < end)
     {
-        CharT c = *it;
-        if (c == quote_char)
+        const CharT* q = std::char_traits<CharT>::find(p, end - p, quote_char);
+        if (q == nullptr)
         {
-            os.put(quote_escape_char); 
-            os.put(quote_char);
-        }
-        else
-        {
-            os.put(c);
+            os.write(p, end - p);
+            break;
         }
+        os.write(p, q - p);
+        os.put(quote_escape_char); 
+        os.put(quote_char);
+        p = q + 1;
     }
 }
 
@@ -51,6 +56,8 @@ class basic_csv_serializer : public basic_json_output_handler<CharT>
 public:
     using typename basic_json_output_handler<CharT>::string_view_type                                 ;
 private:
+    static const size_t npos = static_cast<size_t>(-1);
+
     struct stack_item
     {
         stack_item(bool is_object)
@@ -64,7 +71,11 @@ private:
 
         bool is_object_;
         size_t count_;
-        std::basic_string<CharT> name_;
+    };
+    struct double_cell
+    {
+        double value;
+        uint8_t precision;
     };
     buffered_output<CharT> os_;
     basic_csv_parameters<CharT> parameters_;
@@ -72,7 +83,20 @@ private:
     std::vector<stack_item> stack_;
     print_double<CharT> fp_;
     std::vector<std::basic_string<CharT>> column_names_;
-    std::map<std::basic_string<CharT>,std::basic_string<CharT>> buffered_line_;
+    std::map<std::basic_string<CharT>,size_t> column_indexes_;
+    bool header_written_;
+
+    // The members of an object row are written straight to os_ while they come in the
+    // order of the columns. A value that comes early, and the values of the first row when
+    // the column names are taken from it, are formatted into cell_ and kept in row_values_
+    // until the columns before it have been written.
+    size_t column_;
+    size_t next_column_;
+    std::vector<std::basic_string<CharT>> row_values_;
+    std::vector<bool> has_row_value_;
+    std::basic_string<CharT> cell_;
+    basic_string_sink<std::basic_string<CharT>> cell_sink_;
+    buffered_output<CharT> cell_os_;
 
     // Noncopyable and nonmoveable
     basic_csv_serializer(const basic_csv_serializer&) = delete;
@@ -84,8 +108,14 @@ public:
        options_(),
        stack_(),
        fp_(options_.precision()),
-       column_names_(parameters_.column_names())
+       column_names_(parameters_.column_names()),
+       header_written_(false),
+       column_(npos),
+       next_column_(0),
+       cell_sink_(cell_),
+       cell_os_(cell_sink_, 256)
     {
+        index_column_names();
     }
 
     basic_csv_serializer(std::basic_ostream<CharT>& os,
@@ -96,12 +126,108 @@ public:
        options_(),
        stack_(),
        fp_(options_.precision()),
-       column_names_(parameters_.column_names())
+       column_names_(parameters_.column_names()),
+       header_written_(false),
+       column_(npos),
+       next_column_(0),
+       cell_sink_(cell_),
+       cell_os_(cell_sink_, 256)
+    {
+        index_column_names();
+    }
+
+    basic_csv_serializer(basic_output_sink<CharT>& sink)
+       :
+       os_(sink),
+       options_(),
+       stack_(),
+       fp_(options_.precision()),
+       column_names_(parameters_.column_names()),
+       header_written_(false),
+       column_(npos),
+       next_column_(0),
+       cell_sink_(cell_),
+       cell_os_(cell_sink_, 256)
+    {
+        index_column_names();
+    }
+
+    basic_csv_serializer(basic_output_sink<CharT>& sink,
+                         basic_csv_parameters<CharT> params)
+       :
+       os_(sink),
+       parameters_(params),
+       options_(),
+       stack_(),
+       fp_(options_.precision()),
+       column_names_(parameters_.column_names()),
+       header_written_(false),
+       column_(npos),
+       next_column_(0),
+       cell_sink_(cell_),
+       cell_os_(cell_sink_, 256)
+    {
+        index_column_names();
+    }
+
+    // Writes a row of fields without going through json events, each a string,
+    // an integer, a floating point number or a bool, followed by the line delimiter.
+    // Before the first row, writes the column_names, if there are any.
+    template <class Iterator>
+    void write_row(Iterator first, Iterator last)
+    {
+        write_header();
+        for (Iterator it = first; it != last; ++it)
+        {
+            if (it != first)
+            {
+                os_.put(parameters_.field_delimiter());
+            }
+            write_field(*it, os_);
+        }
+        os_.write(parameters_.line_delimiter());
+    }
+
+    void write_row(std::initializer_list<string_view_type> fields)
     {
+        write_row(fields.begin(), fields.end());
+    }
+
+    void flush()
+    {
+        os_.flush();
     }
 
 private:
 
+    void index_column_names()
+    {
+        for (size_t i = 0; i < column_names_.size(); ++i)
+        {
+            column_indexes_.insert(std::make_pair(column_names_[i], i));
+        }
+    }
+
+    void write_header()
+    {
+        if (!header_written_)
+        {
+            for (size_t i = 0; i < column_names_.size(); ++i)
+            {
+                if (i > 0)
+                {
+                    os_.put(parameters_.field_delimiter());
+                }
+                os_.write(column_names_[i]);
+            }
+            if (column_names_.size() > 0)
+            {
+                os_.write(parameters_.line_delimiter());
+            }
+            header_written_ = true;
+        }
+    }
+
     void do_begin_json() override
     {
     }
@@ -114,14 +240,24 @@ private:
     void do_begin_object() override
     {
         stack_.push_back(stack_item(true));
+        if (stack_.size() == 2)
+        {
+            if (parameters_.column_names().size() > 0)
+            {
+                write_header();
+            }
+            column_ = npos;
+            next_column_ = 0;
+        }
     }
 
     void do_end_object() override
     {
         if (stack_.size() == 2)
         {
-            if (stack_[0].count_ == 0)
+            if (!header_written_)
             {
+                // The first row, whose names are the column names
                 for (size_t i = 0; i < column_names_.size(); ++i)
                 {
                     if (i > 0)
@@ -131,18 +267,18 @@ private:
                     os_.write(column_names_[i]);
                 }
                 os_.write(parameters_.line_delimiter());
+                header_written_ = true;
             }
-            for (size_t i = 0; i < column_names_.size(); ++i)
+            for (size_t i = next_column_; i < column_names_.size(); ++i)
             {
                 if (i > 0)
                 {
                     os_.put(parameters_.field_delimiter());
                 }
-                auto it = buffered_line_.find(column_names_[i]);
-                if (it != buffered_line_.end())
+                if (i < has_row_value_.size() && has_row_value_[i])
                 {
-                    os_.write(it->second);
-                    it->second.clear();
+                    os_.write(row_values_[i]);
+                    has_row_value_[i] = false;
                 }
             }
             os_.write(parameters_.line_delimiter());
@@ -157,21 +293,7 @@ private:
         stack_.push_back(stack_item(false));
         if (stack_.size() == 2)
         {
-            if (stack_[0].count_ == 0)
-            {
-                for (size_t i = 0; i < column_names_.size(); ++i)
-                {
-                    if (i > 0)
-                    {
-                        os_.put(parameters_.field_delimiter());
-                    }
-                    os_.write(column_names_[i]);
-                }
-                if (column_names_.size() > 0)
-                {
-                    os_.write(parameters_.line_delimiter());
-                }
-            }
+            write_header();
         }
     }
 
@@ -190,77 +312,120 @@ private:
     {
         if (stack_.size() == 2)
         {
-            stack_.back().name_ = name;
-            buffered_line_[name] = std::basic_string<CharT>();
-            if (stack_[0].count_ == 0 && parameters_.column_names().size() == 0)
+            // Members usually come in the order of the columns
+            if (column_ + 1 < column_names_.size() && 
+                column_names_[column_ + 1].compare(0, std::basic_string<CharT>::npos, name.data(), name.length()) == 0)
+            {
+                ++column_;
+                return;
+            }
+            std::basic_string<CharT> key(name.data(), name.length());
+            auto it = column_indexes_.find(key);
+            if (it != column_indexes_.end())
+            {
+                column_ = it->second;
+            }
+            else if (!header_written_ && parameters_.column_names().size() == 0)
+            {
+                column_ = column_names_.size();
+                column_names_.push_back(key);
+                column_indexes_.insert(std::make_pair(key, column_));
+            }
+            else
             {
-                column_names_.push_back(name);
+                column_ = npos;
             }
         }
     }
 
     void write_string(const CharT* s, size_t length, buffered_output<CharT>& os)
     {
+        const CharT* last = s + length;
+        const CharT* special = jsoncons::detail::find_one_of(s, last, 
+                                                             parameters_.field_delimiter(), 
+                                                             parameters_.quote_char(),
+                                                             static_cast<CharT>('\r'), 
+                                                             static_cast<CharT>('\n'));
         bool quote = false;
         if (parameters_.quote_style() == quote_style_type::all || parameters_.quote_style() == quote_style_type::nonnumeric ||
-            (parameters_.quote_style() == quote_style_type::minimal &&
-            (std::char_traits<CharT>::find(s, length, parameters_.field_delimiter()) != nullptr || std::char_traits<CharT>::find(s, length, parameters_.quote_char()) != nullptr)))
+            (parameters_.quote_style() == quote_style_type::minimal && special != last))
         {
             quote = true;
             os.put(parameters_.quote_char());
         }
-        jsoncons::csv::escape_string<CharT>(s, length, parameters_.quote_char(), parameters_.quote_escape_char(), os);
+        if (special == last)
+        {
+            // Nothing to escape
+            os.write(s, length);
+        }
+        else
+        {
+            jsoncons::csv::escape_string<CharT>(s, length, parameters_.quote_char(), parameters_.quote_escape_char(), os);
+        }
         if (quote)
         {
             os.put(parameters_.quote_char());
         }
-
     }
 
-    void do_null_value() override
+    // A value in a row. Values in object rows go to their column, and
+    // values below the rows are left out.
+    template <class T>
+    void row_value(const T& val)
     {
-        if (stack_.size() == 2)
+        if (stack_.size() != 2)
+        {
+            return;
+        }
+        if (!stack_.back().is_object())
         {
-            if (stack_.back().is_object())
+            begin_value(os_);
+            write_field(val, os_);
+            end_value();
+        }
+        else if (column_ != npos && column_ >= next_column_)
+        {
+            if (header_written_ && column_ == next_column_)
             {
-                auto it = buffered_line_.find(stack_.back().name_);
-                if (it != buffered_line_.end())
+                if (column_ > 0)
+                {
+                    os_.put(parameters_.field_delimiter());
+                }
+                write_field(val, os_);
+                ++next_column_;
+                // Values that came early may now be next
+                while (next_column_ < has_row_value_.size() && has_row_value_[next_column_])
                 {
-                    basic_osequencestream<CharT> ss;
-                    buffered_output<CharT> bo(ss,10);
-                    do_null_value(bo);
-                    bo.flush();
-                    it->second = std::basic_string<CharT>(ss.data(),ss.length());
+                    os_.put(parameters_.field_delimiter());
+                    os_.write(row_values_[next_column_]);
+                    has_row_value_[next_column_] = false;
+                    ++next_column_;
                 }
             }
             else
             {
-                do_null_value(os_);
+                if (column_ >= row_values_.size())
+                {
+                    row_values_.resize(column_ + 1);
+                    has_row_value_.resize(column_ + 1, false);
+                }
+                write_field(val, cell_os_);
+                cell_os_.flush();
+                row_values_[column_].assign(cell_);
+                has_row_value_[column_] = true;
+                cell_.clear();
             }
         }
     }
 
+    void do_null_value() override
+    {
+        row_value(null_type());
+    }
+
     void do_string_value(const string_view_type& val) override
     {
-        if (stack_.size() == 2)
-        {
-            if (stack_.back().is_object())
-            {
-                auto it = buffered_line_.find(stack_.back().name_);
-                if (it != buffered_line_.end())
-                {
-                    basic_osequencestream<CharT> ss;
-                    buffered_output<CharT> bo(ss,1000);
-                    value(val,bo);
-                    bo.flush();
-                    it->second = std::basic_string<CharT>(ss.data(),ss.length());
-                }
-            }
-            else
-            {
-                value(val,os_);
-            }
-        }
+        row_value(val);
     }
 
     void do_byte_string_value(const uint8_t*, size_t) override
@@ -270,109 +435,53 @@ private:
 
     void do_double_value(double val, uint8_t precision) override
     {
-        (void)precision;
-
-        if (stack_.size() == 2)
-        {
-            if (stack_.back().is_object())
-            {
-                auto it = buffered_line_.find(stack_.back().name_);
-                if (it != buffered_line_.end())
-                {
-                    basic_osequencestream<CharT> ss;
-                    buffered_output<CharT> bo(ss,30);
-                    value(val,bo);
-                    bo.flush();
-                    it->second = std::basic_string<CharT>(ss.data(),ss.length());
-                }
-            }
-            else
-            {
-                value(val,os_);
-            }
-        }
+        row_value(double_cell{val, precision});
     }
 
     void do_integer_value(int64_t val) override
     {
-        if (stack_.size() == 2)
-        {
-            if (stack_.back().is_object())
-            {
-                auto it = buffered_line_.find(stack_.back().name_);
-                if (it != buffered_line_.end())
-                {
-                    basic_osequencestream<CharT> ss;
-                    buffered_output<CharT> bo(ss,30);
-                    value(val,bo);
-                    bo.flush();
-                    it->second = std::basic_string<CharT>(ss.data(),ss.length());
-                }
-            }
-            else
-            {
-                value(val,os_);
-            }
-        }
+        row_value(val);
     }
 
     void do_uinteger_value(uint64_t val) override
     {
-        if (stack_.size() == 2)
-        {
-            if (stack_.back().is_object())
-            {
-                auto it = buffered_line_.find(stack_.back().name_);
-                if (it != buffered_line_.end())
-                {
-                    basic_osequencestream<CharT> ss;
-                    buffered_output<CharT> bo(ss,30);
-                    value(val,bo);
-                    bo.flush();
-                    it->second = std::basic_string<CharT>(ss.data(),ss.length());
-                }
-            }
-            else
-            {
-                value(val,os_);
-            }
-        }
+        row_value(val);
     }
 
     void do_bool_value(bool val) override
     {
-        if (stack_.size() == 2)
-        {
-            if (stack_.back().is_object())
-            {
-                auto it = buffered_line_.find(stack_.back().name_);
-                if (it != buffered_line_.end())
-                {
-                    basic_osequencestream<CharT> ss;
-                    buffered_output<CharT> bo(ss,30);
-                    value(val,bo);
-                    bo.flush();
-                    it->second = std::basic_string<CharT>(ss.data(),ss.length());
-                }
-            }
-            else
-            {
-                value(val,os_);
-            }
-        }
+        row_value(val);
     }
 
-    void value(const string_view_type& value, buffered_output<CharT>& os)
+    void write_field(const string_view_type& value, buffered_output<CharT>& os)
     {
-        begin_value(os);
         write_string(value.data(),value.length(),os);
-        end_value();
     }
 
-    void value(double val, buffered_output<CharT>& os)
+    void write_field(const std::basic_string<CharT>& value, buffered_output<CharT>& os)
     {
-        begin_value(os);
+        write_string(value.data(),value.length(),os);
+    }
 
+    void write_field(const CharT* value, buffered_output<CharT>& os)
+    {
+        write_string(value,std::char_traits<CharT>::length(value),os);
+    }
+
+    template <class T>
+    typename std::enable_if<std::is_floating_point<T>::value>::type
+    write_field(T value, buffered_output<CharT>& os)
+    {
+        write_double(static_cast<double>(value), std::numeric_limits<double>::digits10, os);
+    }
+
+    void write_field(const double_cell& cell, buffered_output<CharT>& os)
+    {
+        write_double(cell.value, cell.precision, os);
+    }
+
+    void write_double(double val, uint8_t precision, buffered_output<CharT>& os)
+    {
         if ((std::isnan)(val))
         {
             os.write(options_.nan_replacement());
@@ -387,39 +496,26 @@ private:
         }
         else
         {
-            fp_(val,options_.precision(),os);
+            fp_(val,precision,os);
         }
-
-        end_value();
-
     }
 
-    void value(int64_t val, buffered_output<CharT>& os)
+    template <class T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+    write_field(T value, buffered_output<CharT>& os)
     {
-        begin_value(os);
-
-        std::basic_ostringstream<CharT> ss;
-        ss << val;
-        os.write(ss.str());
-
-        end_value();
+        print_integer(static_cast<int64_t>(value), os);
     }
 
-    void value(uint64_t val, buffered_output<CharT>& os)
+    template <class T>
+    typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value && !std::is_same<T,bool>::value>::type
+    write_field(T value, buffered_output<CharT>& os)
     {
-        begin_value(os);
-
-        std::basic_ostringstream<CharT> ss;
-        ss << val;
-        os.write(ss.str());
-
-        end_value();
+        print_uinteger(static_cast<uint64_t>(value), os);
     }
 
-    void value(bool val, buffered_output<CharT>& os) 
+    void write_field(bool val, buffered_output<CharT>& os) 
     {
-        begin_value(os);
-
         if (val)
         {
             auto buf = jsoncons::detail::true_literal<CharT>();
@@ -430,17 +526,12 @@ private:
             auto buf = jsoncons::detail::false_literal<CharT>();
             os.write(buf,5);
         }
-
-        end_value();
     }
 
-    void do_null_value(buffered_output<CharT>& os) 
+    void write_field(null_type, buffered_output<CharT>& os) 
     {
-        begin_value(os);
         auto buf = jsoncons::detail::null_literal<CharT>();
         os.write(buf,4);
-        end_value();
-
     }
 
     void begin_value(buffered_output<CharT>& os)
@@ -0,0 +1,48 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_CSV_CSV_TRANSCODE_HPP
+#define JSONCONS_CSV_CSV_TRANSCODE_HPP
+
+#include <istream>
+#include <ostream>
+#include <jsoncons/json_filter.hpp>
+#include <jsoncons/input_source.hpp>
+#include <jsoncons/output_sink.hpp>
+#include <jsoncons_ext/csv/csv_parameters.hpp>
+#include <jsoncons_ext/csv/csv_reader.hpp>
+#include <jsoncons_ext/cbor/cbor_serializer.hpp>
+
+namespace jsoncons { namespace csv {
+
+// Reads CSV text and writes it as a CBOR data item, an array of the records as
+// csv_reader reports them, passing the reader's events straight to a cbor_serializer
+// without a json value. Records are written as they are read, so memory use does not
+// grow with the number of records. Throws a parse_error if the input is not valid.
+
+inline
+void csv_to_cbor(std::istream& is, std::ostream& os, 
+                 const csv_parameters& params = csv_parameters())
+{
+    cbor::cbor_serializer serializer(os);
+    basic_json_input_output_handler_adapter<char> adapter(serializer);
+    csv_reader reader(is, adapter, params);
+    reader.read();
+}
+
+inline
+void csv_to_cbor(input_source& source, output_sink& sink, 
+                 const csv_parameters& params = csv_parameters())
+{
+    cbor::cbor_serializer serializer(sink);
+    basic_json_input_output_handler_adapter<char> adapter(serializer);
+    csv_reader reader(source, adapter, params);
+    reader.read();
+}
+
+}}
+
+#endif
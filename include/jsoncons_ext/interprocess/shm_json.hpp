@@ -0,0 +1,77 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_INTERPROCESS_SHM_JSON_HPP
+#define JSONCONS_INTERPROCESS_SHM_JSON_HPP
+
+#include <utility>
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/allocators/allocator.hpp>
+#include <boost/interprocess/containers/vector.hpp>
+#include <boost/interprocess/containers/string.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/json_parser.hpp>
+
+namespace jsoncons { namespace interprocess {
+
+// basic_json values whose storage is in a Boost.Interprocess managed segment. Everything a
+// value points to is held through the allocator's offset pointers, in containers that hold
+// theirs the same way, so a value built by one process can be read by any other process that
+// maps the segment, at whatever address it is mapped.
+
+typedef boost::interprocess::managed_shared_memory::segment_manager shm_segment_manager;
+typedef boost::interprocess::allocator<char,shm_segment_manager> shm_allocator;
+
+struct shm_sorted_policy : public sorted_policy
+{
+    template <class T,class Allocator>
+    using object_storage = boost::interprocess::vector<T,Allocator>;
+
+    template <class T,class Allocator>
+    using array_storage = boost::interprocess::vector<T,Allocator>;
+
+    template <class CharT, class CharTraits, class Allocator>
+    using key_storage = boost::interprocess::basic_string<CharT,CharTraits,Allocator>;
+
+    template <class CharT, class CharTraits, class Allocator>
+    using string_storage = boost::interprocess::basic_string<CharT,CharTraits,Allocator>;
+};
+
+struct shm_preserve_order_policy : public shm_sorted_policy
+{
+    static const bool preserve_order = true;
+};
+
+typedef basic_json<char,shm_sorted_policy,shm_allocator> shm_json;
+typedef basic_json<char,shm_preserve_order_policy,shm_allocator> shm_ojson;
+
+// Parses a JSON text into a value constructed in segment with the given name, and returns it.
+// Other processes find it with segment.find<Json>(name). Throws parse_error if the text is
+// not valid JSON, and boost::interprocess::bad_alloc if the segment is full.
+
+template <class Json>
+Json* construct_parsed(boost::interprocess::managed_shared_memory& segment,
+                       const char* name,
+                       const typename Json::string_view_type& text)
+{
+    typename Json::allocator_type allocator(segment.get_segment_manager());
+    json_decoder<Json> decoder(allocator);
+    basic_json_parser<typename Json::char_type> parser(decoder);
+    parser.set_source(text.data(), text.length());
+    parser.parse();
+    parser.end_parse();
+    parser.check_done();
+    if (!decoder.is_valid())
+    {
+        JSONCONS_THROW_EXCEPTION(std::runtime_error,"Failed to parse json string");
+    }
+    return segment.construct<Json>(name)(decoder.get_result());
+}
+
+}}
+
+#endif
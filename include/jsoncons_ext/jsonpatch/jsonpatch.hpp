@@ -13,12 +13,25 @@
 #include <istream>
 #include <cstdlib>
 #include <memory>
+#include <utility>
+#include <atomic>
+#include <mutex>
+#include <exception>
 #include <jsoncons/json.hpp>
+#include <jsoncons/json_hash.hpp>
+#include <jsoncons/parallel_array_options.hpp>
+#include <jsoncons/detail/parallel_workers.hpp>
 #include <jsoncons_ext/jsonpointer/jsonpointer.hpp>
 #include <jsoncons_ext/jsonpatch/jsonpatch_error_category.hpp>
 
 namespace jsoncons { namespace jsonpatch {
 
+// How diff compares arrays. by_position compares the elements at the same index, and adds or
+// removes elements at the end. minimal keeps the elements of a longest common subsequence,
+// so that an element inserted or removed anywhere is one add or remove operation.
+
+enum class array_diff {by_position, minimal};
+
 namespace detail {
 
     JSONCONS_DEFINE_LITERAL(test_literal,"test");
@@ -32,20 +45,37 @@ namespace detail {
     JSONCONS_DEFINE_LITERAL(from_literal,"from");
     JSONCONS_DEFINE_LITERAL(value_literal,"value");
 
-    enum class op_type {add,remove,replace};
+    enum class op_type {add,remove,replace,move};
     enum class state_type {begin,abort,commit};
 
+    // Returns the value the pointer refers to, or null if there is none
+    template <class Json>
+    Json* find(Json& root, const jsonpointer::basic_json_pointer<typename Json::char_type>& ptr)
+    {
+        jsonpointer::detail::json_pointer_evaluator<Json,Json&> evaluator(root);
+        return evaluator.get(ptr) == jsonpointer::jsonpointer_errc() ? std::addressof(evaluator.current()) : nullptr;
+    }
+
+    // The undo log holds the values that operations removed or replaced, moved out of
+    // the target rather than copied, and moves them back if the patch fails. A move 
+    // operation is undone by moving the value at path back to from.
+
     template <class Json>
     struct operation_unwinder
     {
+        typedef typename Json::char_type char_type;
         typedef typename Json::string_type string_type;
         typedef typename Json::string_view_type string_view_type;
+        typedef jsonpointer::basic_json_pointer<char_type> pointer_type;
 
         struct entry
         {
             op_type op;
             string_type path;
             Json value;
+            string_type from;
+            // For move, whether the value at path replaced value
+            bool replaced;
         };
 
         Json& target;
@@ -59,135 +89,707 @@ namespace detail {
 
         ~operation_unwinder()
         {
-            //std::cout << "state: " << std::boolalpha << (state == state_type::commit) << ", stack size: " << stack.size() << std::endl;
             if (state != state_type::commit)
             {
                 for (auto it = stack.rbegin(); it != stack.rend(); ++it)
                 {
+                    pointer_type ptr(it->path);
                     if (it->op == op_type::add)
                     {
-                        if (jsonpointer::insert_or_assign(target,it->path,it->value) != jsonpointer::jsonpointer_errc())
+                        if (jsonpointer::insert_or_assign(target,ptr,std::move(it->value)) != jsonpointer::jsonpointer_errc())
                         {
-                            //std::cout << "add: " << it->path << std::endl;
                             break;
                         }
                     }
                     else if (it->op == op_type::remove)
                     {
-                        if (jsonpointer::remove(target,it->path) != jsonpointer::jsonpointer_errc())
+                        if (jsonpointer::remove(target,ptr) != jsonpointer::jsonpointer_errc())
                         {
-                            //std::cout << "remove: " << it->path << std::endl;
                             break;
                         }
                     }
                     else if (it->op == op_type::replace)
                     {
-                        if (jsonpointer::replace(target,it->path,it->value) != jsonpointer::jsonpointer_errc())
+                        if (jsonpointer::replace(target,ptr,std::move(it->value)) != jsonpointer::jsonpointer_errc())
+                        {
+                            break;
+                        }
+                    }
+                    else if (it->op == op_type::move)
+                    {
+                        Json* p = find(target,ptr);
+                        if (p == nullptr)
+                        {
+                            break;
+                        }
+                        Json val = std::move(*p);
+                        if (it->replaced)
+                        {
+                            *p = std::move(it->value);
+                        }
+                        else if (jsonpointer::remove(target,ptr) != jsonpointer::jsonpointer_errc())
+                        {
+                            break;
+                        }
+                        if (jsonpointer::insert_or_assign(target,pointer_type(it->from),std::move(val)) != jsonpointer::jsonpointer_errc())
                         {
-                            //std::cout << "replace: " << it->path << std::endl;
                             break;
                         }
                     }
                 }
             }
         }
+
+        void push(op_type op, const string_type& path, Json&& value)
+        {
+            stack.push_back(entry{op,path,std::move(value),string_type(),false});
+        }
+
+        void push_move(const string_type& path, const string_type& from, Json&& value, bool replaced)
+        {
+            stack.push_back(entry{op_type::move,path,std::move(value),from,replaced});
+        }
+    };
+
+    // Adds value at ptr, or if ptr is an object member that exists, replaces its value,
+    // and records how to undo that. The value at an empty pointer is left as it is.
+    template <class Json, class T>
+    jsonpatch_errc add(operation_unwinder<Json>& unwinder, 
+                       const jsonpointer::basic_json_pointer<typename Json::char_type>& ptr, 
+                       T&& value, jsonpatch_errc failed)
+    {
+        auto insert_ec = jsonpointer::insert(unwinder.target,ptr,std::forward<T>(value)); // try insert without replace
+        if (insert_ec == jsonpointer::jsonpointer_errc::key_already_exists) // try a replace
+        {
+            Json* p = find(unwinder.target,ptr);
+            if (p == nullptr) // shouldn't happen
+            {
+                return failed;
+            }
+            Json orig_val = std::move(*p);
+            // value has not been moved from, insert does that only when it succeeds
+            *p = std::forward<T>(value);
+            unwinder.push(op_type::replace,ptr.string(),std::move(orig_val));
+        }
+        else if (insert_ec == jsonpointer::jsonpointer_errc())
+        {
+            unwinder.push(op_type::remove,ptr.string(),Json());
+        }
+        else
+        {
+            return failed;
+        }
+        return jsonpatch_errc();
+    }
+
+    template <class Json>
+    class array_lcs;
+
+    // Writes the operations of a diff into one array, as it walks the two values, with
+    // the path to the current value built up in one buffer.
+    //
+    // To plan a parallel diff, the accumulator is given a list of jobs and the number of
+    // runs to split the elements or members of an array or object into. It then walks the
+    // two values without comparing them, and leaves the diffs of each run as a job, with its
+    // path and the place in the result where its operations go. A source element or member
+    // with more elements or members than there are in a run, and at least as many as there
+    // are runs, is walked in turn.
+
+    template <class Json>
+    struct diff_job
+    {
+        typedef typename Json::string_type string_type;
+        typedef typename Json::const_object_iterator const_object_iterator;
+
+        size_t position;
+        string_type path;
+        const Json* source;
+        const Json* target;
+        // The members [first,last) of source, or the elements source[i+n] and target[j+n]
+        // at index k+n, for n in [0,count)
+        bool members;
+        const_object_iterator first;
+        const_object_iterator last;
+        size_t i;
+        size_t j;
+        size_t k;
+        size_t count;
+        Json result;
     };
 
     template <class Json>
-    Json diff(const Json& source, const Json& target, const typename Json::string_type& path)
+    class diff_accumulator
     {
         typedef typename Json::char_type char_type;
         typedef typename Json::string_type string_type;
         typedef typename Json::string_view_type string_view_type;
+        typedef typename Json::const_object_iterator const_object_iterator;
+
+        Json& result_;
+        array_diff mode_;
+        string_type path_;
+        std::vector<diff_job<Json>>* jobs_;
+        size_t runs_;
+    public:
+        diff_accumulator(Json& result, array_diff mode)
+            : result_(result), mode_(mode), jobs_(nullptr), runs_(0)
+        {
+        }
+
+        diff_accumulator(Json& result, array_diff mode, const string_type& path)
+            : result_(result), mode_(mode), path_(path), jobs_(nullptr), runs_(0)
+        {
+        }
+
+        diff_accumulator(Json& result, array_diff mode, std::vector<diff_job<Json>>& jobs, size_t runs)
+            : result_(result), mode_(mode), jobs_(std::addressof(jobs)), runs_(runs)
+        {
+        }
+
+        void diff(const Json& source, const Json& target)
+        {
+            if (source == target)
+            {
+                return;
+            }
+            diff_values(source, target);
+        }
 
-        Json result = typename Json::array();
+        // Plans the diff of two arrays or two objects, diffs other values
+        void plan(const Json& source, const Json& target)
+        {
+            if (same_structure(source, target))
+            {
+                diff_values(source, target);
+            }
+            else
+            {
+                diff(source, target);
+            }
+        }
 
-        if (source == target)
+        // Diffs the elements source[i+n] and target[j+n], at index k+n in the array as the
+        // operations before have left it, for n in [0,count)
+        void diff_elements(const Json& source, const Json& target, size_t i, size_t j, size_t k, size_t count)
         {
-            return result;
+            if (jobs_ != nullptr)
+            {
+                plan_elements(source, target, i, j, k, count);
+                return;
+            }
+            for (size_t n = 0; n < count; ++n)
+            {
+                size_t length = push_index(k + n);
+                diff(source[i+n],target[j+n]);
+                path_.resize(length);
+            }
         }
 
-        if (source.is_array() && target.is_array())
+        // Diffs the members [first,last) of source with those of target, or removes them
+        void diff_members(const Json& source, const Json& target, const_object_iterator first, const_object_iterator last)
+        {
+            if (jobs_ != nullptr)
+            {
+                plan_members(source, target, first, last);
+                return;
+            }
+            for (auto it = first; it != last; ++it)
+            {
+                size_t length = push_key(it->key());
+                auto t = target.find(it->key());
+                if (t != target.object_range().end())
+                {
+                    diff(it->value(),t->value());
+                }
+                else
+                {
+                    remove();
+                }
+                path_.resize(length);
+            }
+        }
+    private:
+        void diff_values(const Json& source, const Json& target)
         {
-            size_t common = (std::min)(source.size(),target.size());
-            for (size_t i = 0; i < common; ++i)
+            if (source.is_array() && target.is_array())
+            {
+                if (mode_ == array_diff::minimal)
+                {
+                    diff_minimal(source, target);
+                }
+                else
+                {
+                    diff_by_position(source, target);
+                }
+            }
+            else if (source.is_object() && target.is_object())
             {
-                std::basic_ostringstream<char_type> ss; 
-                ss << path << '/' << i;
-                auto temp_diff = diff(source[i],target[i],ss.str());
-                result.insert(result.array_range().end(),temp_diff.array_range().begin(),temp_diff.array_range().end());
+                diff_members(source, target, source.object_range().begin(), source.object_range().end());
+                for (const auto& a : target.object_range())
+                {
+                    auto it = source.find(a.key());
+                    if (it == source.object_range().end())
+                    {
+                        size_t length = push_key(a.key());
+                        add(a.value());
+                        path_.resize(length);
+                    }
+                }
             }
-            // Element in source, not in target - remove
-            for (size_t i = target.size(); i < source.size(); ++i)
+            else
             {
-                std::basic_ostringstream<char_type> ss; 
-                ss << path << '/' << i;
                 Json val = typename Json::object();
-                val.insert_or_assign(op_literal<char_type>(), remove_literal<char_type>());
-                val.insert_or_assign(path_literal<char_type>(), ss.str());
-                result.push_back(std::move(val));
+                val.insert_or_assign(op_literal<char_type>(), replace_literal<char_type>());
+                val.insert_or_assign(path_literal<char_type>(), path_);
+                val.insert_or_assign(value_literal<char_type>(), target);
+                result_.push_back(std::move(val));
+            }
+        }
+
+        void diff_by_position(const Json& source, const Json& target)
+        {
+            diff_elements(source, target, 0, 0, 0, (std::min)(source.size(),target.size()));
+            // Element in source, not in target - remove, from the last, so that the
+            // indices of those still to be removed do not change
+            for (size_t i = source.size(); i-- > target.size(); )
+            {
+                size_t length = push_index(i);
+                remove();
+                path_.resize(length);
             }
             // Element in target, not in source - add, 
             // Fix contributed by Alexander rog13
             for (size_t i = source.size(); i < target.size(); ++i)
             {
-                const auto& a = target[i];
-                std::basic_ostringstream<char_type> ss; 
-                ss << path << '/' << i;
-                Json val = typename Json::object();
-                val.insert_or_assign(op_literal<char_type>(), add_literal<char_type>());
-                val.insert_or_assign(path_literal<char_type>(), ss.str());
-                val.insert_or_assign(value_literal<char_type>(), a);
-                result.push_back(std::move(val));
+                size_t length = push_index(i);
+                add(target[i]);
+                path_.resize(length);
             }
         }
-        else if (source.is_object() && target.is_object())
+
+        // Elements of a longest common subsequence are kept where they are. In each run
+        // of the other elements, changed elements are diffed pairwise, then the rest of
+        // the source elements are removed or the rest of the target elements added. The
+        // indices are those of the array as the operations before have left it.
+        void diff_minimal(const Json& source, const Json& target)
         {
-            for (const auto& a : source.object_range())
+            std::vector<std::pair<size_t,size_t>> matches = array_lcs<Json>(source, target).matches();
+            matches.push_back(std::make_pair(source.size(), target.size()));
+
+            size_t i = 0;
+            size_t j = 0;
+            size_t k = 0;
+            for (const auto& m : matches)
             {
-                std::basic_ostringstream<char_type> ss; 
-                ss << path << '/';
-                jsonpointer::escape(a.key(),ss);
-                auto it = target.find(a.key());
-                if (it != target.object_range().end())
+                size_t pairs = (std::min)(m.first - i, m.second - j);
+                diff_elements(source, target, i, j, k, pairs);
+                k += pairs;
+                for (size_t n = i + pairs; n < m.first; ++n)
                 {
-                    auto temp_diff = diff(a.value(),it->value(),ss.str());
-                    result.insert(result.array_range().end(),temp_diff.array_range().begin(),temp_diff.array_range().end());
+                    size_t length = push_index(k);
+                    remove();
+                    path_.resize(length);
                 }
-                else
+                for (size_t n = j + pairs; n < m.second; ++n, ++k)
+                {
+                    size_t length = push_index(k);
+                    add(target[n]);
+                    path_.resize(length);
+                }
+                i = m.first + 1;
+                j = m.second + 1;
+                ++k;
+            }
+        }
+
+        static bool same_structure(const Json& source, const Json& target)
+        {
+            return (source.is_array() && target.is_array()) || (source.is_object() && target.is_object());
+        }
+
+        // The elements or members in a run of those of an array or object of size n
+        size_t run_length(size_t n) const
+        {
+            return (std::max)((n + runs_ - 1) / runs_, size_t(1));
+        }
+
+        bool is_large(const Json& source, size_t run) const
+        {
+            return (source.is_array() || source.is_object()) && source.size() > run && source.size() >= runs_;
+        }
+
+        bool walks(const Json& source, const Json& target, size_t run) const
+        {
+            return is_large(source, run) && same_structure(source, target);
+        }
+
+        void plan_elements(const Json& source, const Json& target, size_t i, size_t j, size_t k, size_t count)
+        {
+            const size_t run = run_length((std::max)(source.size(), target.size()));
+            size_t start = 0;
+            for (size_t n = 0; n < count; ++n)
+            {
+                if (walks(source[i+n], target[j+n], run))
                 {
-                    Json val = typename Json::object();
-                    val.insert_or_assign(op_literal<char_type>(), remove_literal<char_type>());
-                    val.insert_or_assign(path_literal<char_type>(), ss.str());
-                    result.push_back(std::move(val));
+                    push_elements_job(source, target, i + start, j + start, k + start, n - start);
+                    size_t length = push_index(k + n);
+                    diff_values(source[i+n], target[j+n]);
+                    path_.resize(length);
+                    start = n + 1;
+                }
+                else if (n + 1 - start == run)
+                {
+                    push_elements_job(source, target, i + start, j + start, k + start, n + 1 - start);
+                    start = n + 1;
                 }
             }
-            for (const auto& a : target.object_range())
+            push_elements_job(source, target, i + start, j + start, k + start, count - start);
+        }
+
+        void plan_members(const Json& source, const Json& target, const_object_iterator first, const_object_iterator last)
+        {
+            const size_t run = run_length((std::max)(source.size(), target.size()));
+            auto start = first;
+            size_t count = 0;
+            for (auto it = first; it != last; ++it)
             {
-                auto it = source.find(a.key());
-                if (it == source.object_range().end())
+                auto t = is_large(it->value(), run) ? target.find(it->key()) : target.object_range().end();
+                if (t != target.object_range().end() && same_structure(it->value(), t->value()))
                 {
-                    std::basic_ostringstream<char_type> ss; 
-                    ss << path << '/';
-                    jsonpointer::escape(a.key(),ss);
-                    Json val = typename Json::object();
-                    val.insert_or_assign(op_literal<char_type>(), add_literal<char_type>());
-                    val.insert_or_assign(path_literal<char_type>(), ss.str());
-                    val.insert_or_assign(value_literal<char_type>(), a.value());
-                    result.push_back(std::move(val));
+                    push_members_job(source, target, start, it);
+                    size_t length = push_key(it->key());
+                    diff_values(it->value(), t->value());
+                    path_.resize(length);
+                    start = it;
+                    ++start;
+                    count = 0;
+                }
+                else if (++count == run)
+                {
+                    auto next = it;
+                    ++next;
+                    push_members_job(source, target, start, next);
+                    start = next;
+                    count = 0;
                 }
             }
+            push_members_job(source, target, start, last);
         }
-        else
+
+        void push_elements_job(const Json& source, const Json& target, size_t i, size_t j, size_t k, size_t count)
+        {
+            if (count > 0)
+            {
+                diff_job<Json> job;
+                job.position = result_.size();
+                job.path = path_;
+                job.source = std::addressof(source);
+                job.target = std::addressof(target);
+                job.members = false;
+                job.i = i;
+                job.j = j;
+                job.k = k;
+                job.count = count;
+                jobs_->push_back(std::move(job));
+            }
+        }
+
+        void push_members_job(const Json& source, const Json& target, const_object_iterator first, const_object_iterator last)
+        {
+            if (first != last)
+            {
+                diff_job<Json> job;
+                job.position = result_.size();
+                job.path = path_;
+                job.source = std::addressof(source);
+                job.target = std::addressof(target);
+                job.members = true;
+                job.first = first;
+                job.last = last;
+                jobs_->push_back(std::move(job));
+            }
+        }
+
+        void add(const Json& value)
+        {
+            Json val = typename Json::object();
+            val.insert_or_assign(op_literal<char_type>(), add_literal<char_type>());
+            val.insert_or_assign(path_literal<char_type>(), path_);
+            val.insert_or_assign(value_literal<char_type>(), value);
+            result_.push_back(std::move(val));
+        }
+
+        void remove()
         {
             Json val = typename Json::object();
-            val.insert_or_assign(op_literal<char_type>(), replace_literal<char_type>());
-            val.insert_or_assign(path_literal<char_type>(), path);
-            val.insert_or_assign(value_literal<char_type>(), target);
-            result.push_back(std::move(val));
+            val.insert_or_assign(op_literal<char_type>(), remove_literal<char_type>());
+            val.insert_or_assign(path_literal<char_type>(), path_);
+            result_.push_back(std::move(val));
+        }
+
+        // Append a reference token to the path and return the length before it
+        size_t push_index(size_t index)
+        {
+            size_t length = path_.length();
+            path_.push_back('/');
+            std::string s = std::to_string(index);
+            for (auto c : s)
+            {
+                path_.push_back(c);
+            }
+            return length;
+        }
+
+        size_t push_key(const string_view_type& key)
+        {
+            size_t length = path_.length();
+            path_.push_back('/');
+            for (auto c : key)
+            {
+                if (c == '~')
+                {
+                    path_.push_back('~');
+                    path_.push_back('0');
+                }
+                else if (c == '/')
+                {
+                    path_.push_back('~');
+                    path_.push_back('1');
+                }
+                else
+                {
+                    path_.push_back(c);
+                }
+            }
+            return length;
+        }
+    };
+
+    // A longest common subsequence of the elements of two arrays, found with the linear
+    // space refinement of Myers' O(ND) difference algorithm (Myers 1986, "An O(ND)
+    // Difference Algorithm and Its Variations"). Common leading and trailing elements
+    // are matched first, and the rest is split at a middle snake, recursively.
+
+    template <class Json>
+    class array_lcs
+    {
+        const Json& a_;
+        const Json& b_;
+        json_hash_cache<Json> hashes_;
+        std::vector<std::pair<size_t,size_t>> matches_;
+        std::vector<ptrdiff_t> vf_;
+        std::vector<ptrdiff_t> vb_;
+    public:
+        array_lcs(const Json& a, const Json& b)
+            : a_(a), b_(b)
+        {
+            compare(0, a.size(), 0, b.size());
+        }
+
+        // Pairs of source and target indices of equal elements, in increasing order
+        const std::vector<std::pair<size_t,size_t>>& matches() const
+        {
+            return matches_;
+        }
+    private:
+        // The search compares the same elements many times, elements with different
+        // structural hashes are not compared again
+        bool equal(size_t i, size_t j)
+        {
+            return hashes_.equal(a_[i], b_[j]);
+        }
+
+        struct snake
+        {
+            size_t x;
+            size_t y;
+            size_t u;
+            size_t v;
+        };
+
+        void compare(size_t a_lo, size_t a_hi, size_t b_lo, size_t b_hi)
+        {
+            while (a_lo < a_hi && b_lo < b_hi && a_[a_lo] == b_[b_lo])
+            {
+                matches_.push_back(std::make_pair(a_lo++, b_lo++));
+            }
+            size_t suffix = 0;
+            while (a_lo < a_hi - suffix && b_lo < b_hi - suffix && a_[a_hi-suffix-1] == b_[b_hi-suffix-1])
+            {
+                ++suffix;
+            }
+            a_hi -= suffix;
+            b_hi -= suffix;
+
+            if (a_lo < a_hi && b_lo < b_hi)
+            {
+                snake s = middle_snake(a_lo, a_hi, b_lo, b_hi);
+                compare(a_lo, s.x, b_lo, s.y);
+                for (size_t x = s.x, y = s.y; x < s.u; ++x, ++y)
+                {
+                    matches_.push_back(std::make_pair(x, y));
+                }
+                compare(s.u, a_hi, s.v, b_hi);
+            }
+
+            for (size_t n = 0; n < suffix; ++n)
+            {
+                matches_.push_back(std::make_pair(a_hi + n, b_hi + n));
+            }
+        }
+
+        // Finds the snake in the middle of a shortest edit script, searching from both
+        // ends at once until the furthest reaching paths on some diagonal overlap.
+        // The first and last elements of the ranges differ, so the script has at least
+        // two edits and the ranges either side of the snake are smaller.
+        snake middle_snake(size_t a_lo, size_t a_hi, size_t b_lo, size_t b_hi)
+        {
+            const ptrdiff_t n = static_cast<ptrdiff_t>(a_hi - a_lo);
+            const ptrdiff_t m = static_cast<ptrdiff_t>(b_hi - b_lo);
+            const ptrdiff_t delta = n - m;
+            const bool odd = (delta & 1) != 0;
+            const ptrdiff_t max_d = (n + m + 1) / 2;
+            const ptrdiff_t offset = max_d + 1;
+
+            vf_.assign(2*max_d + 3, 0);
+            vb_.assign(2*max_d + 3, 0);
+
+            for (ptrdiff_t d = 0; d <= max_d; ++d)
+            {
+                for (ptrdiff_t k = -d; k <= d; k += 2)
+                {
+                    ptrdiff_t x = (k == -d || (k != d && vf_[offset+k-1] < vf_[offset+k+1])) 
+                                  ? vf_[offset+k+1] : vf_[offset+k-1] + 1;
+                    ptrdiff_t y = x - k;
+                    ptrdiff_t x0 = x;
+                    ptrdiff_t y0 = y;
+                    while (x < n && y < m && equal(a_lo+x, b_lo+y))
+                    {
+                        ++x;
+                        ++y;
+                    }
+                    vf_[offset+k] = x;
+                    if (odd && delta - k >= -(d-1) && delta - k <= d-1 && x + vb_[offset+delta-k] >= n)
+                    {
+                        return snake{a_lo+x0, b_lo+y0, a_lo+x, b_lo+y};
+                    }
+                }
+                // Backward, x and y count from the ends of the ranges
+                for (ptrdiff_t k = -d; k <= d; k += 2)
+                {
+                    ptrdiff_t x = (k == -d || (k != d && vb_[offset+k-1] < vb_[offset+k+1])) 
+                                  ? vb_[offset+k+1] : vb_[offset+k-1] + 1;
+                    ptrdiff_t y = x - k;
+                    ptrdiff_t x0 = x;
+                    ptrdiff_t y0 = y;
+                    while (x < n && y < m && equal(a_hi-x-1, b_hi-y-1))
+                    {
+                        ++x;
+                        ++y;
+                    }
+                    vb_[offset+k] = x;
+                    if (!odd && delta - k >= -d && delta - k <= d && x + vf_[offset+delta-k] >= n)
+                    {
+                        return snake{a_hi-x, b_hi-y, a_hi-x0, b_hi-y0};
+                    }
+                }
+            }
+            // Not reached, the paths overlap by d == max_d
+            return snake{a_lo, b_lo, a_lo, b_lo};
+        }
+    };
+
+    // Runs the jobs of a planned diff on up to max_threads threads, the calling thread
+    // among them, and puts the operations of each job in the result at its place. An
+    // exception thrown by a job stops the others, and is rethrown once they have finished.
+    template <class Json>
+    void run_diff_jobs(Json& result, std::vector<diff_job<Json>>& jobs, array_diff mode, size_t max_threads)
+    {
+        std::atomic<size_t> next(0);
+        std::atomic<bool> stop(false);
+        std::mutex mutex;
+        std::exception_ptr error;
+
+        auto work = [&]()
+        {
+            for (size_t i = next++; i < jobs.size() && !stop; i = next++)
+            {
+                diff_job<Json>& job = jobs[i];
+                try
+                {
+                    job.result = typename Json::array();
+                    diff_accumulator<Json> accumulator(job.result, mode, job.path);
+                    if (job.members)
+                    {
+                        accumulator.diff_members(*job.source, *job.target, job.first, job.last);
+                    }
+                    else
+                    {
+                        accumulator.diff_elements(*job.source, *job.target, job.i, job.j, job.k, job.count);
+                    }
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error)
+                    {
+                        error = std::current_exception();
+                    }
+                    stop = true;
+                }
+            }
+        };
+
+        const size_t workers = (std::min)(max_threads, jobs.size());
+        {
+            jsoncons::detail::joining_threads threads(workers - 1);
+            try
+            {
+                for (size_t i = 1; i < workers; ++i)
+                {
+                    threads.start(work);
+                }
+            }
+            catch (...)
+            {
+                stop = true;
+                throw;
+            }
+            work();
+        }
+        if (error)
+        {
+            std::rethrow_exception(error);
         }
 
-        return result;
+        size_t count = result.size();
+        for (const auto& job : jobs)
+        {
+            count += job.result.size();
+        }
+        Json merged = typename Json::array();
+        merged.reserve(count);
+        size_t position = 0;
+        for (auto& job : jobs)
+        {
+            for (; position < job.position; ++position)
+            {
+                merged.push_back(std::move(result[position]));
+            }
+            if (job.result.is_array())
+            {
+                for (auto& op : job.result.array_range())
+                {
+                    merged.push_back(std::move(op));
+                }
+                Json().swap(job.result);
+            }
+        }
+        for (; position < result.size(); ++position)
+        {
+            merged.push_back(std::move(result[position]));
+        }
+        result.swap(merged);
     }
 }
 
@@ -197,6 +799,7 @@ std::tuple<jsonpatch_errc,typename Json::string_type> patch(Json& target, const
     typedef typename Json::char_type char_type;
     typedef typename Json::string_type string_type;
     typedef typename Json::string_view_type string_view_type;
+    typedef jsonpointer::basic_json_pointer<char_type> pointer_type;
 
     detail::operation_unwinder<Json> unwinder(target);
 
@@ -217,13 +820,12 @@ std::tuple<jsonpatch_errc,typename Json::string_type> patch(Json& target, const
         {
             const string_view_type op = operation.at(detail::op_literal<char_type>()).as_string_view();
             const string_view_type path = operation.at(detail::path_literal<char_type>()).as_string_view();
+            const pointer_type ptr(path);
 
             if (op == detail::test_literal<char_type>())
             {
-                Json val;
-                jsonpointer::jsonpointer_errc ec;
-                std::tie(val,ec) = jsonpointer::get(target,path);
-                if (ec != jsonpointer::jsonpointer_errc())
+                const Json* p = detail::find(target,ptr);
+                if (p == nullptr)
                 {
                     patch_ec = jsonpatch_errc::test_failed;
                     unwinder.state = detail::state_type::abort;
@@ -233,7 +835,7 @@ std::tuple<jsonpatch_errc,typename Json::string_type> patch(Json& target, const
                     patch_ec = jsonpatch_errc::invalid_patch;
                     unwinder.state = detail::state_type::abort;
                 }
-                else if (val != operation.at(detail::value_literal<char_type>()))
+                else if (*p != operation.at(detail::value_literal<char_type>()))
                 {
                     patch_ec = jsonpatch_errc::test_failed;
                     unwinder.state = detail::state_type::abort;
@@ -248,70 +850,41 @@ std::tuple<jsonpatch_errc,typename Json::string_type> patch(Json& target, const
                 }
                 else
                 {
-                    Json val = operation.at(detail::value_literal<char_type>());
-                    auto npath = jsonpointer::normalized_path(target,path);
-                    auto insert_ec = jsonpointer::insert(target,npath,val); // try insert without replace
-                    if (insert_ec == jsonpointer::jsonpointer_errc::key_already_exists) // try a replace
-                    {
-                        Json orig_val;
-                        jsonpointer::jsonpointer_errc select_ec;
-                        std::tie(orig_val,select_ec) = jsonpointer::get(target,npath);
-                        if (select_ec != jsonpointer::jsonpointer_errc()) // shouldn't happen
-                        {
-                            patch_ec = jsonpatch_errc::add_failed;
-                            unwinder.state = detail::state_type::abort;
-                        }
-                        else if (jsonpointer::replace(target,npath,val) != jsonpointer::jsonpointer_errc())
-                        {
-                            patch_ec = jsonpatch_errc::add_failed;
-                            unwinder.state = detail::state_type::abort;
-                        }
-                        else
-                        {
-                            unwinder.stack.push_back({detail::op_type::replace,npath,orig_val});
-                        }
-                    }
-                    else if (insert_ec == jsonpointer::jsonpointer_errc())
+                    pointer_type npath(jsonpointer::normalized_path(target,ptr));
+                    patch_ec = detail::add(unwinder,npath,operation.at(detail::value_literal<char_type>()),jsonpatch_errc::add_failed);
+                    if (patch_ec != jsonpatch_errc())
                     {
-                        unwinder.stack.push_back({detail::op_type::remove,npath,Json::null()});
-                    }
-                    else
-                    {
-                        patch_ec = jsonpatch_errc::add_failed;
                         unwinder.state = detail::state_type::abort;
                     }
                 }
             }
             else if (op == detail::remove_literal<char_type>())
             {
-                Json val;
-                jsonpointer::jsonpointer_errc ec;
-                std::tie(val,ec) = jsonpointer::get(target,path);
-                if (ec != jsonpointer::jsonpointer_errc())
+                Json* p = detail::find(target,ptr);
+                if (p == nullptr)
                 {
                     patch_ec = jsonpatch_errc::remove_failed;
                     unwinder.state = detail::state_type::abort;
                 }
                 else
                 {
-                    ec = jsonpointer::remove(target,path);
-                    if (ec != jsonpointer::jsonpointer_errc())
+                    Json val = ptr.tokens().empty() ? Json::null() : std::move(*p);
+                    if (jsonpointer::remove(target,ptr) != jsonpointer::jsonpointer_errc())
                     {
+                        *p = std::move(val);
                         patch_ec = jsonpatch_errc::remove_failed;
                         unwinder.state = detail::state_type::abort;
                     }
                     else
                     {
-                        unwinder.stack.push_back({detail::op_type::add,path,val});
+                        unwinder.push(detail::op_type::add,ptr.string(),std::move(val));
                     }
                 }
             }
             else if (op == detail::replace_literal<char_type>())
             {
-                Json val;
-                jsonpointer::jsonpointer_errc ec;
-                std::tie(val,ec) = jsonpointer::get(target,path);
-                if (ec != jsonpointer::jsonpointer_errc())
+                Json* p = detail::find(target,ptr);
+                if (p == nullptr)
                 {
                     patch_ec = jsonpatch_errc::replace_failed;
                     unwinder.state = detail::state_type::abort;
@@ -321,14 +894,11 @@ std::tuple<jsonpatch_errc,typename Json::string_type> patch(Json& target, const
                     patch_ec = jsonpatch_errc::invalid_patch;
                     unwinder.state = detail::state_type::abort;
                 }
-                else if (jsonpointer::replace(target,path,operation.at(detail::value_literal<char_type>())) != jsonpointer::jsonpointer_errc())
-                {
-                    patch_ec = jsonpatch_errc::replace_failed;
-                    unwinder.state = detail::state_type::abort;
-                }
-                else
+                else if (!ptr.tokens().empty())
                 {
-                    unwinder.stack.push_back({detail::op_type::replace,path,val});
+                    Json val = std::move(*p);
+                    *p = operation.at(detail::value_literal<char_type>());
+                    unwinder.push(detail::op_type::replace,ptr.string(),std::move(val));
                 }
             }
             else if (op == detail::move_literal<char_type>())
@@ -340,55 +910,55 @@ std::tuple<jsonpatch_errc,typename Json::string_type> patch(Json& target, const
                 }
                 else
                 {
-                    Json val;
-                    jsonpointer::jsonpointer_errc ec;
-                    string_view_type from = operation.at(detail::from_literal<char_type>()).as_string_view();
-                    std::tie(val,ec) = jsonpointer::get(target,from);
-                    if (ec != jsonpointer::jsonpointer_errc())
-                    {
-                        patch_ec = jsonpatch_errc::move_failed;
-                        unwinder.state = detail::state_type::abort;
-                    }
-                    else if (jsonpointer::remove(target,from) != jsonpointer::jsonpointer_errc())
+                    pointer_type from(operation.at(detail::from_literal<char_type>()).as_string_view());
+                    Json* p = detail::find(target,from);
+                    if (p == nullptr || from.tokens().empty())
                     {
                         patch_ec = jsonpatch_errc::move_failed;
                         unwinder.state = detail::state_type::abort;
                     }
                     else
                     {
-                        unwinder.stack.push_back({detail::op_type::add,from,val});
-                        // add
-                        auto npath = jsonpointer::normalized_path(target,path);
-                        auto insert_ec = jsonpointer::insert(target,npath,val); // try insert without replace
-                        if (insert_ec == jsonpointer::jsonpointer_errc::key_already_exists) // try a replace
+                        Json val = std::move(*p);
+                        if (jsonpointer::remove(target,from) != jsonpointer::jsonpointer_errc())
+                        {
+                            *p = std::move(val);
+                            patch_ec = jsonpatch_errc::move_failed;
+                            unwinder.state = detail::state_type::abort;
+                        }
+                        else
                         {
+                            pointer_type npath(jsonpointer::normalized_path(target,ptr));
+                            auto insert_ec = npath.tokens().empty() ? jsonpointer::jsonpointer_errc()
+                                           : jsonpointer::insert(target,npath,std::move(val)); // try insert without replace
                             Json orig_val;
-                            jsonpointer::jsonpointer_errc select_ec;
-                            std::tie(orig_val,select_ec) = jsonpointer::get(target,npath);
-                            if (select_ec != jsonpointer::jsonpointer_errc()) // shouldn't happen
+                            bool replaced = false;
+                            if (insert_ec == jsonpointer::jsonpointer_errc::key_already_exists) // try a replace
                             {
-                                patch_ec = jsonpatch_errc::copy_failed;
-                                unwinder.state = detail::state_type::abort;
+                                Json* q = detail::find(target,npath);
+                                if (q != nullptr)
+                                {
+                                    orig_val = std::move(*q);
+                                    *q = std::move(val);
+                                    replaced = true;
+                                    insert_ec = jsonpointer::jsonpointer_errc();
+                                }
                             }
-                            else if (jsonpointer::replace(target,npath,val) != jsonpointer::jsonpointer_errc())
+                            if (insert_ec != jsonpointer::jsonpointer_errc())
                             {
+                                jsonpointer::insert_or_assign(target,from,std::move(val));
                                 patch_ec = jsonpatch_errc::copy_failed;
                                 unwinder.state = detail::state_type::abort;
                             }
+                            else if (npath.tokens().empty())
+                            {
+                                unwinder.push(detail::op_type::add,from.string(),std::move(val));
+                            }
                             else
                             {
-                                unwinder.stack.push_back({detail::op_type::replace,npath,orig_val});
+                                unwinder.push_move(npath.string(),from.string(),std::move(orig_val),replaced);
                             }
                         }
-                        else if (insert_ec == jsonpointer::jsonpointer_errc())
-                        {
-                            unwinder.stack.push_back({detail::op_type::remove,npath,Json::null()});
-                        }
-                        else
-                        {
-                            patch_ec = jsonpatch_errc::copy_failed;
-                            unwinder.state = detail::state_type::abort;
-                        }
                     }           
                 }
             }
@@ -401,47 +971,21 @@ std::tuple<jsonpatch_errc,typename Json::string_type> patch(Json& target, const
                 }
                 else
                 {
-                    Json val;
-                    jsonpointer::jsonpointer_errc ec;
-                    string_view_type from = operation.at(detail::from_literal<char_type>()).as_string_view();
-                    std::tie(val,ec) = jsonpointer::get(target,from);
-                    if (ec != jsonpointer::jsonpointer_errc())
+                    pointer_type from(operation.at(detail::from_literal<char_type>()).as_string_view());
+                    const Json* p = detail::find(target,from);
+                    if (p == nullptr)
                     {
                         patch_ec = jsonpatch_errc::copy_failed;
                         unwinder.state = detail::state_type::abort;
                     }
                     else
                     {
-                        // add
-                        auto npath = jsonpointer::normalized_path(target,path);
-                        auto insert_ec = jsonpointer::insert(target,npath,val); // try insert without replace
-                        if (insert_ec == jsonpointer::jsonpointer_errc::key_already_exists) // try a replace
-                        {
-                            Json orig_val;
-                            jsonpointer::jsonpointer_errc select_ec;
-                            std::tie(orig_val,select_ec) = jsonpointer::get(target,npath);
-                            if (select_ec != jsonpointer::jsonpointer_errc()) // shouldn't happen
-                            {
-                                patch_ec = jsonpatch_errc::copy_failed;
-                                unwinder.state = detail::state_type::abort;
-                            }
-                            else if (jsonpointer::replace(target,npath,val) != jsonpointer::jsonpointer_errc())
-                            {
-                                patch_ec = jsonpatch_errc::copy_failed;
-                                unwinder.state = detail::state_type::abort;
-                            }
-                            else
-                            {
-                                unwinder.stack.push_back({detail::op_type::replace,npath,orig_val});
-                            }
-                        }
-                        else if (insert_ec == jsonpointer::jsonpointer_errc())
+                        // The copy is the one the new value needs
+                        Json val = *p;
+                        pointer_type npath(jsonpointer::normalized_path(target,ptr));
+                        patch_ec = detail::add(unwinder,npath,std::move(val),jsonpatch_errc::copy_failed);
+                        if (patch_ec != jsonpatch_errc())
                         {
-                            unwinder.stack.push_back({detail::op_type::remove,npath,Json::null()});
-                        }
-                        else
-                        {
-                            patch_ec = jsonpatch_errc::copy_failed;
                             unwinder.state = detail::state_type::abort;
                         }
                     }
@@ -464,12 +1008,42 @@ std::tuple<jsonpatch_errc,typename Json::string_type> patch(Json& target, const
     return std::make_tuple(patch_ec,bad_path);
 }
 
+template <class Json>
+Json diff(const Json& source, const Json& target, array_diff mode = array_diff::by_position)
+{
+    Json result = typename Json::array();
+    detail::diff_accumulator<Json> accumulator(result, mode);
+    accumulator.diff(source, target);
+    return result;
+}
+
+// The same diff, on up to parallel.max_threads() threads. The elements or members of source
+// and target are split into 8*parallel.max_threads() runs, diffed independently, as are
+// those of an element or member with more of them than a run. The operations are those of
+// diff, in the same order.
+
+template <class Json>
+Json diff(const Json& source, const Json& target, array_diff mode, const parallel_array_options& parallel)
+{
+    if (parallel.max_threads() <= 1)
+    {
+        return diff(source, target, mode);
+    }
+    Json result = typename Json::array();
+    std::vector<detail::diff_job<Json>> jobs;
+    detail::diff_accumulator<Json> planner(result, mode, jobs, 8*parallel.max_threads());
+    planner.plan(source, target);
+    if (!jobs.empty())
+    {
+        detail::run_diff_jobs(result, jobs, mode, parallel.max_threads());
+    }
+    return result;
+}
 
 template <class Json>
-Json diff(const Json& source, const Json& target)
+Json diff(const Json& source, const Json& target, const parallel_array_options& parallel)
 {
-    typename Json::string_type path;
-    return detail::diff(source, target, path);
+    return diff(source, target, array_diff::by_position, parallel);
 }
 
 }}
@@ -0,0 +1,535 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSONPATCH_JSONPATCH_FILTER_HPP
+#define JSONCONS_JSONPATCH_JSONPATCH_FILTER_HPP
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_filter.hpp>
+#include <jsoncons_ext/jsonpointer/jsonpointer.hpp>
+#include <jsoncons_ext/jsonpatch/jsonpatch.hpp>
+#include <jsoncons_ext/jsonpatch/jsonpatch_error_category.hpp>
+
+namespace jsoncons { namespace jsonpatch {
+
+// Applies the add, remove and replace operations of a JSON Patch to the events of a
+// document as they pass, without the document. The paths of the operations are compiled
+// into a tree, and the filter keeps a frame for each array and object it is in, with the
+// node of the tree for its path, if there is one. Values that are removed or replaced are
+// dropped event by event, and the values of the patch are written in their place or, for
+// members and elements that are added, before the element at their index or at the end of
+// their object or array. Memory is proportional to the depth of the document and the size
+// of the patch.
+//
+// The paths and array indices of the operations are those of the document as it is read,
+// rather than as the operations before have left it, so a path may have one operation, other
+// than any number of adds at "-", and a path that has one may not be inside another that
+// does. Operations whose values are not in the document are reported by error() once it has
+// been read, the others are still applied.
+
+template <class Json>
+class patch_filter : public basic_json_filter<typename Json::char_type>
+{
+public:
+    typedef typename Json::char_type char_type;
+    typedef typename Json::string_type string_type;
+    using typename basic_json_filter<char_type>::string_view_type;
+private:
+    enum class op_kind {none, add, remove, replace};
+
+    struct node
+    {
+        op_kind op;
+        bool applied;
+        Json value;
+        string_type path;
+        std::map<string_type,std::unique_ptr<node>> children;
+        // The children whose names are array indices, by index
+        std::vector<std::pair<size_t,node*>> elements;
+        // The values added at "-", in order
+        std::vector<Json> appended;
+        string_type append_path;
+        bool appended_applied;
+
+        node()
+            : op(op_kind::none), applied(false), appended_applied(false)
+        {
+        }
+
+        bool has_operations() const
+        {
+            return op != op_kind::none || !children.empty() || !appended.empty();
+        }
+    };
+
+    struct frame
+    {
+        node* n;
+        bool is_object;
+        size_t index;
+        size_t next_element;
+        node* member;
+    };
+
+    node root_;
+    std::vector<frame> stack_;
+    size_t skip_;
+    jsonpatch_errc ec_;
+    string_type bad_path_;
+    basic_json_output_input_handler_adapter<char_type> value_handler_;
+
+    // noncopyable and nonmoveable
+    patch_filter(const patch_filter&) = delete;
+    patch_filter& operator=(const patch_filter&) = delete;
+public:
+    patch_filter(const Json& patch, basic_json_output_handler<char_type>& handler)
+        : basic_json_filter<char_type>(handler),
+          skip_(0), ec_(jsonpatch_errc()), value_handler_(this->downstream_handler())
+    {
+        compile(patch);
+    }
+
+    patch_filter(const Json& patch, basic_json_input_handler<char_type>& handler)
+        : basic_json_filter<char_type>(handler),
+          skip_(0), ec_(jsonpatch_errc()), value_handler_(this->downstream_handler())
+    {
+        compile(patch);
+    }
+
+    // After construction, invalid_patch if the patch is not an array of add, remove and
+    // replace operations, or the failed code of an operation and its path if it cannot be
+    // applied in a stream, and then no operations are applied. After a document has been
+    // read, the failed code and path of the first operation that was not applied.
+    std::tuple<jsonpatch_errc,string_type> error() const
+    {
+        return std::make_tuple(ec_, bad_path_);
+    }
+private:
+    void compile(const Json& patch)
+    {
+        if (!patch.is_array())
+        {
+            fail(jsonpatch_errc::invalid_patch, string_type());
+            return;
+        }
+        for (const auto& operation : patch.array_range())
+        {
+            if (!operation.is_object() || operation.count(detail::op_literal<char_type>()) != 1 ||
+                operation.count(detail::path_literal<char_type>()) != 1 ||
+                !operation.at(detail::op_literal<char_type>()).is_string() ||
+                !operation.at(detail::path_literal<char_type>()).is_string())
+            {
+                fail(jsonpatch_errc::invalid_patch, string_type());
+                return;
+            }
+            const string_type op = operation.at(detail::op_literal<char_type>()).template as<string_type>();
+            const string_type path = operation.at(detail::path_literal<char_type>()).template as<string_type>();
+
+            op_kind kind;
+            jsonpatch_errc failed;
+            if (op == detail::add_literal<char_type>())
+            {
+                kind = op_kind::add;
+                failed = jsonpatch_errc::add_failed;
+            }
+            else if (op == detail::remove_literal<char_type>())
+            {
+                kind = op_kind::remove;
+                failed = jsonpatch_errc::remove_failed;
+            }
+            else if (op == detail::replace_literal<char_type>())
+            {
+                kind = op_kind::replace;
+                failed = jsonpatch_errc::replace_failed;
+            }
+            else
+            {
+                fail(jsonpatch_errc::invalid_patch, path);
+                return;
+            }
+            if (kind != op_kind::remove && operation.count(detail::value_literal<char_type>()) != 1)
+            {
+                fail(jsonpatch_errc::invalid_patch, path);
+                return;
+            }
+
+            jsonpointer::basic_json_pointer<char_type> ptr(path);
+            if (ptr.errc() != jsonpointer::jsonpointer_errc() || (kind == op_kind::remove && ptr.tokens().empty()))
+            {
+                fail(failed, path);
+                return;
+            }
+            node* n = &root_;
+            for (const auto& token : ptr.tokens())
+            {
+                if (n->op != op_kind::none)
+                {
+                    fail(failed, path);
+                    return;
+                }
+                if (token.is_dash)
+                {
+                    if (kind != op_kind::add)
+                    {
+                        fail(failed, path);
+                        return;
+                    }
+                    n->appended.push_back(operation.at(detail::value_literal<char_type>()));
+                    n->append_path = path;
+                    n = nullptr;
+                    break;
+                }
+                if (token.name_errc != jsonpointer::jsonpointer_errc())
+                {
+                    fail(failed, path);
+                    return;
+                }
+                std::unique_ptr<node>& child = n->children[string_type(token.name.data(), token.name.length())];
+                if (!child)
+                {
+                    child.reset(new node());
+                    if (token.index_errc == jsonpointer::jsonpointer_errc())
+                    {
+                        n->elements.push_back(std::make_pair(token.index, child.get()));
+                    }
+                }
+                n = child.get();
+            }
+            if (n != nullptr)
+            {
+                if (n->has_operations())
+                {
+                    fail(failed, path);
+                    return;
+                }
+                n->op = kind;
+                n->path = path;
+                if (kind != op_kind::remove)
+                {
+                    n->value = operation.at(detail::value_literal<char_type>());
+                }
+            }
+        }
+        sort_elements(root_);
+    }
+
+    static void sort_elements(node& n)
+    {
+        std::sort(n.elements.begin(), n.elements.end(),
+                  [](const std::pair<size_t,node*>& a, const std::pair<size_t,node*>& b) {return a.first < b.first;});
+        for (auto& child : n.children)
+        {
+            sort_elements(*child.second);
+        }
+    }
+
+    void fail(jsonpatch_errc ec, const string_type& path)
+    {
+        ec_ = ec;
+        bad_path_ = path;
+        root_.children.clear();
+        root_.elements.clear();
+        root_.appended.clear();
+        root_.op = op_kind::none;
+    }
+
+    static void reset(node& n)
+    {
+        n.applied = false;
+        n.appended_applied = false;
+        for (auto& child : n.children)
+        {
+            reset(*child.second);
+        }
+    }
+
+    // The first operation in n that was not applied
+    static const node* unapplied(const node& n)
+    {
+        if ((n.op != op_kind::none && !n.applied) || (!n.appended.empty() && !n.appended_applied))
+        {
+            return &n;
+        }
+        for (const auto& child : n.children)
+        {
+            const node* p = unapplied(*child.second);
+            if (p != nullptr)
+            {
+                return p;
+            }
+        }
+        return nullptr;
+    }
+
+    void write_value(node& n)
+    {
+        n.applied = true;
+        n.value.dump_fragment(value_handler_);
+    }
+
+    // Called at the start of each value, with whether it begins an array or an object. Returns
+    // whether its events are passed on, and pushes the frame of an array or object that is
+    bool begin_value(bool is_container, bool is_object)
+    {
+        if (skip_ > 0)
+        {
+            if (is_container)
+            {
+                ++skip_;
+            }
+            return false;
+        }
+        node* n = nullptr;
+        if (stack_.empty())
+        {
+            n = &root_;
+        }
+        else
+        {
+            frame& f = stack_.back();
+            if (f.is_object)
+            {
+                n = f.member;
+                f.member = nullptr;
+            }
+            else
+            {
+                n = element(f);
+                ++f.index;
+            }
+        }
+        if (n != nullptr && n->op != op_kind::none)
+        {
+            // Removed, or replaced, or a member or the root that an add replaces
+            if (n->op == op_kind::remove)
+            {
+                n->applied = true;
+            }
+            else
+            {
+                write_value(*n);
+            }
+            skip_ = is_container ? 1 : 0;
+            return false;
+        }
+        if (is_container)
+        {
+            stack_.push_back(frame{n != nullptr && n->has_operations() ? n : nullptr, is_object, 0, 0, nullptr});
+        }
+        return true;
+    }
+
+    // The node of the element at f.index, after writing the value added before it
+    node* element(frame& f)
+    {
+        if (f.n == nullptr || f.next_element == f.n->elements.size() || f.n->elements[f.next_element].first != f.index)
+        {
+            return nullptr;
+        }
+        node* n = f.n->elements[f.next_element++].second;
+        if (n->op == op_kind::add)
+        {
+            write_value(*n);
+            return nullptr;
+        }
+        return n;
+    }
+
+    // Called at the end of each array or object. Returns whether the event is passed on,
+    // after writing the members or elements added at the end
+    bool end_value(const parsing_context& context)
+    {
+        if (skip_ > 0)
+        {
+            --skip_;
+            return false;
+        }
+        frame& f = stack_.back();
+        if (f.n != nullptr)
+        {
+            if (f.is_object)
+            {
+                for (auto& child : f.n->children)
+                {
+                    if (child.second->op == op_kind::add && !child.second->applied)
+                    {
+                        this->downstream_handler().name(child.first, context);
+                        write_value(*child.second);
+                    }
+                }
+            }
+            else
+            {
+                node* n = element(f);
+                if (n != nullptr)
+                {
+                    // Replaced or removed past the end, not applied
+                    --f.next_element;
+                }
+                for (const auto& val : f.n->appended)
+                {
+                    val.dump_fragment(value_handler_);
+                }
+                f.n->appended_applied = true;
+            }
+        }
+        stack_.pop_back();
+        return true;
+    }
+
+    void do_begin_json() override
+    {
+        stack_.clear();
+        skip_ = 0;
+        reset(root_);
+        this->downstream_handler().begin_json();
+    }
+
+    void do_end_json() override
+    {
+        this->downstream_handler().end_json();
+        const node* n = unapplied(root_);
+        if (n != nullptr && ec_ == jsonpatch_errc())
+        {
+            if (n->op == op_kind::none || n->op == op_kind::add)
+            {
+                ec_ = jsonpatch_errc::add_failed;
+                bad_path_ = n->op == op_kind::none ? n->append_path : n->path;
+            }
+            else
+            {
+                ec_ = n->op == op_kind::remove ? jsonpatch_errc::remove_failed : jsonpatch_errc::replace_failed;
+                bad_path_ = n->path;
+            }
+        }
+    }
+
+    void do_begin_object(const parsing_context& context) override
+    {
+        if (begin_value(true, true))
+        {
+            this->downstream_handler().begin_object(context);
+        }
+    }
+
+    void do_end_object(const parsing_context& context) override
+    {
+        if (end_value(context))
+        {
+            this->downstream_handler().end_object(context);
+        }
+    }
+
+    void do_begin_array(const parsing_context& context) override
+    {
+        if (begin_value(true, false))
+        {
+            this->downstream_handler().begin_array(context);
+        }
+    }
+
+    void do_end_array(const parsing_context& context) override
+    {
+        if (end_value(context))
+        {
+            this->downstream_handler().end_array(context);
+        }
+    }
+
+    void do_name(const string_view_type& name, const parsing_context& context) override
+    {
+        if (skip_ > 0)
+        {
+            return;
+        }
+        frame& f = stack_.back();
+        if (f.n != nullptr)
+        {
+            auto it = f.n->children.find(string_type(name.data(), name.length()));
+            f.member = it != f.n->children.end() ? it->second.get() : nullptr;
+            if (f.member != nullptr && f.member->op == op_kind::remove)
+            {
+                return;
+            }
+        }
+        this->downstream_handler().name(name, context);
+    }
+
+    void do_string_value(const string_view_type& value, const parsing_context& context) override
+    {
+        if (begin_value(false, false))
+        {
+            this->downstream_handler().string_value(value, context);
+        }
+    }
+
+    void do_byte_string_value(const uint8_t* data, size_t length, const parsing_context& context) override
+    {
+        if (begin_value(false, false))
+        {
+            this->downstream_handler().byte_string_value(data, length, context);
+        }
+    }
+
+    void do_double_value(double value, uint8_t precision, const parsing_context& context) override
+    {
+        if (begin_value(false, false))
+        {
+            this->downstream_handler().double_value(value, precision, context);
+        }
+    }
+
+    void do_integer_value(int64_t value, const parsing_context& context) override
+    {
+        if (begin_value(false, false))
+        {
+            this->downstream_handler().integer_value(value, context);
+        }
+    }
+
+    void do_uinteger_value(uint64_t value, const parsing_context& context) override
+    {
+        if (begin_value(false, false))
+        {
+            this->downstream_handler().uinteger_value(value, context);
+        }
+    }
+
+    void do_number_value(const string_view_type& text, const parsing_context& context) override
+    {
+        if (begin_value(false, false))
+        {
+            this->downstream_handler().number_value(text, context);
+        }
+    }
+
+    void do_bool_value(bool value, const parsing_context& context) override
+    {
+        if (begin_value(false, false))
+        {
+            this->downstream_handler().bool_value(value, context);
+        }
+    }
+
+    void do_null_value(const parsing_context& context) override
+    {
+        if (begin_value(false, false))
+        {
+            this->downstream_handler().null_value(context);
+        }
+    }
+};
+
+}}
+
+#endif
@@ -13,7 +13,16 @@
 #include <istream>
 #include <cstdlib>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <exception>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <cstdint>
 #include <jsoncons/json.hpp>
+#include <jsoncons/detail/parallel_workers.hpp>
 #include "jsonpath_filter.hpp"
 #include "jsonpath_error_category.hpp"
 
@@ -21,30 +30,55 @@ namespace jsoncons { namespace jsonpath {
 
 enum class result_type {value,path};
 
-template<class Json>
-Json json_query(const Json& root, const typename Json::string_view_type& path, result_type result_t = result_type::value)
+// Opts in to evaluating a jsonpath_expression on more than one thread. A step is
+// split across up to max_threads threads when it has at least min_chunk_size nodes,
+// array elements or children per thread.
+
+class parallel_options
 {
-    if (result_t == result_type::value)
+    size_t max_threads_;
+    size_t min_chunk_size_;
+public:
+    static const size_t default_min_chunk_size = 4096;
+
+    parallel_options()
+        : max_threads_((std::max)(std::thread::hardware_concurrency(), 1u)),
+          min_chunk_size_(default_min_chunk_size)
     {
-        detail::jsonpath_evaluator<Json,const Json&,detail::VoidPathConstructor<Json>> evaluator;
-        evaluator.evaluate(root,path.data(),path.length());
-        return evaluator.get_values();
     }
-    else
+
+//  Accessors
+
+    size_t max_threads() const
     {
-        detail::jsonpath_evaluator<Json,const Json&,detail::PathConstructor<Json>> evaluator;
-        evaluator.evaluate(root,path.data(),path.length());
-        return evaluator.get_normalized_paths();
+        return max_threads_;
     }
-}
 
-template<class Json, class T>
-void json_replace(Json& root, const typename Json::string_view_type& path, T&& new_value)
-{
-    detail::jsonpath_evaluator<Json,Json&,detail::VoidPathConstructor<Json>> evaluator;
-    evaluator.evaluate(root,path.data(),path.length());
-    evaluator.replace(std::forward<T>(new_value));
-}
+    size_t min_chunk_size() const
+    {
+        return min_chunk_size_;
+    }
+
+//  Modifiers
+
+    parallel_options& max_threads(size_t value)
+    {
+        max_threads_ = value;
+        return *this;
+    }
+
+    parallel_options& min_chunk_size(size_t value)
+    {
+        min_chunk_size_ = value;
+        return *this;
+    }
+};
+
+template <class Json>
+class member_index;
+
+template <class Json>
+class jsonpath_expression_set;
 
 namespace detail {
 
@@ -125,298 +159,412 @@ enum class path_state
     dot
 };
 
-template<class Json,
-         class JsonReference=const Json&,
-         class PathCons=PathConstructor<Json>>
-class jsonpath_evaluator : private parsing_context
+template <class Json>
+class jsonpath_evaluator;
+
+// Selects from one node, for one of the comma separated items inside square brackets
+
+template <class Json>
+class selector
+{
+public:
+    typedef typename Json::string_type string_type;
+
+    virtual ~selector()
+    {
+    }
+    virtual void select(jsonpath_evaluator<Json>& evaluator, const string_type& path, const Json& val) const = 0;
+
+    // True if the selector selects the same nodes as other, from any node
+    virtual bool is_same(const selector<Json>&) const
+    {
+        return false;
+    }
+};
+
+template <class Json>
+typename Json::string_view_type length_literal() 
 {
-private:
     typedef typename Json::char_type char_type;
-    typedef typename Json::char_traits_type char_traits_type;
-    typedef std::basic_string<char_type,char_traits_type> string_type;
-    typedef typename Json::key_storage_type key_storage_type;
+    static const char_type data[] = {'l','e','n','g','t','h'};
+    return typename Json::string_view_type{data,sizeof(data)/sizeof(char_type)};
+}
+
+template <class Json>
+class name_selector : public selector<Json>
+{
+public:
+    typedef typename Json::string_type string_type;
     typedef typename Json::string_view_type string_view_type;
-    typedef JsonReference reference;
-    using pointer = typename std::conditional<std::is_const<typename std::remove_reference<JsonReference>::type>::value,typename Json::const_pointer,typename Json::pointer>::type;
-    typedef std::pair<string_type,pointer> node_type;
-    typedef std::vector<node_type> node_set;
+private:
+    string_type name_;
+public:
+    name_selector(const string_view_type& name)
+        : name_(name)
+    {
+    }
 
-    static string_view_type length_literal() 
+    const string_type& name() const
     {
-        static const char_type data[] = {'l','e','n','g','t','h'};
-        return string_view_type{data,sizeof(data)/sizeof(char_type)};
+        return name_;
     }
 
-    class selector
+    bool is_same(const selector<Json>& other) const override
     {
-    public:
-        virtual ~selector()
-        {
-        }
-        virtual void select(const string_type& path, reference val, 
-                            node_set& nodes, std::vector<std::shared_ptr<Json>>& temp_json_values) = 0;
-    };
+        auto p = dynamic_cast<const name_selector<Json>*>(&other);
+        return p != nullptr && p->name_ == name_;
+    }
 
-    class expr_selector : public selector
+    void select(jsonpath_evaluator<Json>& evaluator, const string_type& path, const Json& val) const override
     {
-    private:
-         jsonpath_filter_expr<Json> result_;
-    public:
-        expr_selector(const jsonpath_filter_expr<Json>& result)
-            : result_(result)
+        bool positive_start = true;
+        if (val.is_object() && val.count(name_) > 0)
         {
+            evaluator.add_node(evaluator.child_path(path,name_),std::addressof(val.at(name_)));
         }
-
-        void select(const string_type& path, reference val, 
-                    node_set& nodes, std::vector<std::shared_ptr<Json>>& temp_json_values) override
+        else if (val.is_array())
         {
-            auto index = result_.eval(val);
-            if (index.template is<size_t>())
+            size_t pos = 0;
+            if (try_string_to_index(name_.data(), name_.size(), &pos, &positive_start))
             {
-                size_t start = index. template as<size_t>();
-                if (val.is_array() && start < val.size())
+                size_t index = positive_start ? pos : val.size() - pos;
+                if (index < val.size())
                 {
-                    nodes.emplace_back(PathCons()(path,start),std::addressof(val[start]));
+                    evaluator.add_node(evaluator.child_path(path,index),std::addressof(val[index]));
                 }
             }
-            else if (index.is_string())
+            else if (name_ == length_literal<Json>() && val.size() > 0)
             {
-                name_selector selector(index.as_string_view(),true);
-                selector.select(path, val, nodes, temp_json_values);
+                evaluator.add_temp_node(evaluator.child_path(path,name_),Json(val.size()));
             }
         }
-    };
-
-    class filter_selector : public selector
-    {
-    private:
-         jsonpath_filter_expr<Json> result_;
-    public:
-        filter_selector(const jsonpath_filter_expr<Json>& result)
-            : result_(result)
-        {
-        }
-
-        void select(const string_type& path, reference val, node_set& nodes, std::vector<std::shared_ptr<Json>>&) override
+        else if (val.is_string())
         {
-            if (val.is_array())
+            size_t pos = 0;
+            string_view_type sv = val.as_string_view();
+            if (try_string_to_index(name_.data(), name_.size(), &pos, &positive_start))
             {
-                for (size_t i = 0; i < val.size(); ++i)
+                size_t index = positive_start ? pos : sv.size() - pos;
+                auto sequence = unicons::sequence_at(sv.data(), sv.data() + sv.size(), index);
+                if (sequence.length() > 0)
                 {
-                    if (result_.exists(val[i]))
-                    {
-                        nodes.emplace_back(PathCons()(path,i),std::addressof(val[i]));
-                    }
+                    evaluator.add_temp_node(evaluator.child_path(path,index),Json(sequence.begin(),sequence.length()));
                 }
             }
-            else if (val.is_object())
+            else if (name_ == length_literal<Json>() && sv.size() > 0)
             {
-                if (result_.exists(val))
-                {
-                    nodes.emplace_back(path, std::addressof(val));
-                }
+                size_t count = unicons::u32_length(sv.begin(),sv.end());
+                evaluator.add_temp_node(evaluator.child_path(path,name_),Json(count));
             }
         }
-    };
+    }
+};
 
-    class name_selector : public selector
+template <class Json>
+class expr_selector : public selector<Json>
+{
+public:
+    typedef typename Json::string_type string_type;
+private:
+     jsonpath_filter_expr<Json> result_;
+public:
+    expr_selector(const jsonpath_filter_expr<Json>& result)
+        : result_(result)
+    {
+    }
+
+    const jsonpath_filter_expr<Json>& expr() const
+    {
+        return result_;
+    }
+
+    void select(jsonpath_evaluator<Json>& evaluator, const string_type& path, const Json& val) const override
     {
-    private:
-        string_type name_;
-        bool positive_start_;
-    public:
-        name_selector(const string_view_type& name, bool positive_start)
-            : name_(name), positive_start_(positive_start)
+        auto index = result_.eval(evaluator.root(), val);
+        if (index.template is<size_t>())
+        {
+            size_t start = index. template as<size_t>();
+            if (val.is_array() && start < val.size())
+            {
+                evaluator.add_node(evaluator.child_path(path,start),std::addressof(val[start]));
+            }
+        }
+        else if (index.is_string())
         {
+            name_selector<Json> selector(index.as_string_view());
+            selector.select(evaluator, path, val);
         }
+    }
+};
 
-        void select(const string_type& path, reference val,
-            node_set& nodes,
-            std::vector<std::shared_ptr<Json>>& temp_json_values) override
+template <class Json>
+class filter_selector : public selector<Json>
+{
+public:
+    typedef typename Json::string_type string_type;
+private:
+     jsonpath_filter_expr<Json> result_;
+public:
+    filter_selector(const jsonpath_filter_expr<Json>& result)
+        : result_(result)
+    {
+    }
+
+    const jsonpath_filter_expr<Json>& filter() const
+    {
+        return result_;
+    }
+
+    void select(jsonpath_evaluator<Json>& evaluator, const string_type& path, const Json& val) const override
+    {
+        if (val.is_array())
         {
-            if (val.is_object() && val.count(name_) > 0)
+            // An equality on an indexed member tests only the elements the index finds
+            const string_type* name = nullptr;
+            const Json* value = nullptr;
+            const std::vector<size_t>* positions = nullptr;
+            if (evaluator.index() != nullptr && result_.member_equality(name, value))
             {
-                nodes.emplace_back(PathCons()(path,name_),std::addressof(val.at(name_)));
+                positions = evaluator.index()->find(val, *name, *value);
             }
-            else if (val.is_array())
+            if (positions != nullptr)
             {
-                size_t pos = 0;
-                if (try_string_to_index(name_.data(), name_.size(), &pos, &positive_start_))
+                for (size_t i : *positions)
                 {
-                    size_t index = positive_start_ ? pos : val.size() - pos;
-                    if (index < val.size())
+                    if (result_.exists(evaluator.root(), val[i]))
                     {
-                        nodes.emplace_back(PathCons()(path,index),std::addressof(val[index]));
+                        evaluator.add_node(evaluator.child_path(path,i),std::addressof(val[i]));
                     }
                 }
-                else if (name_ == length_literal() && val.size() > 0)
-                {
-                    auto temp = std::make_shared<Json>(val.size());
-                    temp_json_values.push_back(temp);
-                    nodes.emplace_back(PathCons()(path,name_),temp.get());
-                }
+                return;
             }
-            else if (val.is_string())
+            evaluator.for_range(val.size(), [&](jsonpath_evaluator<Json>& e, size_t first, size_t last)
             {
-                size_t pos = 0;
-                string_view_type sv = val.as_string_view();
-                if (try_string_to_index(name_.data(), name_.size(), &pos, &positive_start_))
+                for (size_t i = first; i < last; ++i)
                 {
-                    size_t index = positive_start_ ? pos : sv.size() - pos;
-                    auto sequence = unicons::sequence_at(sv.data(), sv.data() + sv.size(), index);
-                    if (sequence.length() > 0)
+                    if (result_.exists(e.root(), val[i]))
                     {
-                        auto temp = std::make_shared<Json>(sequence.begin(),sequence.length());
-                        temp_json_values.push_back(temp);
-                        nodes.emplace_back(PathCons()(path,index),temp.get());
+                        e.add_node(e.child_path(path,i),std::addressof(val[i]));
                     }
                 }
-                else if (name_ == length_literal() && sv.size() > 0)
-                {
-                    size_t count = unicons::u32_length(sv.begin(),sv.end());
-                    auto temp = std::make_shared<Json>(count);
-                    temp_json_values.push_back(temp);
-                    nodes.emplace_back(PathCons()(path,name_),temp.get());
-                }
-            }
+            });
         }
-    };
-
-    class array_slice_selector : public selector
-    {
-    private:
-        size_t start_;
-        bool positive_start_;
-        size_t end_;
-        bool positive_end_;
-        bool undefined_end_;
-        size_t step_;
-        bool positive_step_;
-    public:
-        array_slice_selector(size_t start, bool positive_start, 
-                             size_t end, bool positive_end,
-                             size_t step, bool positive_step,
-                             bool undefined_end)
-            : start_(start), positive_start_(positive_start),
-              end_(end), positive_end_(positive_end),undefined_end_(undefined_end),
-              step_(step), positive_step_(positive_step) 
-        {
-        }
-
-        void select(const string_type& path, 
-                    reference val,
-                    node_set& nodes,
-                    std::vector<std::shared_ptr<Json>>&) override
-        {
-            if (positive_step_)
+        else if (val.is_object())
+        {
+            if (result_.exists(evaluator.root(), val))
             {
-                end_array_slice1(path, val, nodes);
+                evaluator.add_node(path, std::addressof(val));
             }
-            else
+        }
+    }
+};
+
+template <class Json>
+class array_slice_selector : public selector<Json>
+{
+public:
+    typedef typename Json::string_type string_type;
+private:
+    size_t start_;
+    bool positive_start_;
+    size_t end_;
+    bool positive_end_;
+    bool undefined_end_;
+    size_t step_;
+    bool positive_step_;
+public:
+    array_slice_selector(size_t start, bool positive_start, 
+                         size_t end, bool positive_end,
+                         size_t step, bool positive_step,
+                         bool undefined_end)
+        : start_(start), positive_start_(positive_start),
+          end_(end), positive_end_(positive_end),undefined_end_(undefined_end),
+          step_(step), positive_step_(positive_step) 
+    {
+    }
+
+    bool is_same(const selector<Json>& other) const override
+    {
+        auto p = dynamic_cast<const array_slice_selector<Json>*>(&other);
+        return p != nullptr && 
+               p->start_ == start_ && p->positive_start_ == positive_start_ &&
+               p->end_ == end_ && p->positive_end_ == positive_end_ && p->undefined_end_ == undefined_end_ &&
+               p->step_ == step_ && p->positive_step_ == positive_step_;
+    }
+
+    void select(jsonpath_evaluator<Json>& evaluator, const string_type& path, const Json& val) const override
+    {
+        if (val.is_array())
+        {
+            for_each_position(val.size(), [&](size_t j)
             {
-                end_array_slice2(path, val, nodes);
-            }
+                evaluator.add_node(evaluator.child_path(path,j),std::addressof(val[j]));
+            });
         }
+    }
 
-        void end_array_slice1(const string_type& path, reference val, node_set& nodes)
+    // Calls f with each position the slice selects from an array of size elements, in order
+    template <class F>
+    void for_each_position(size_t size, F f) const
+    {
+        size_t start = positive_start_ ? start_ : size - start_;
+        size_t end;
+        if (!undefined_end_)
         {
-            if (val.is_array())
+            end = positive_end_ ? end_ : size - end_;
+        }
+        else
+        {
+            end = size;
+        }
+        if (positive_step_)
+        {
+            for (size_t j = start; j < end; j += step_)
             {
-                size_t start = positive_start_ ? start_ : val.size() - start_;
-                size_t end;
-                if (!undefined_end_)
-                {
-                    end = positive_end_ ? end_ : val.size() - end_;
-                }
-                else
-                {
-                    end = val.size();
-                }
-                for (size_t j = start; j < end; j += step_)
+                if (j < size)
                 {
-                    if (j < val.size())
-                    {
-                        nodes.emplace_back(PathCons()(path,j),std::addressof(val[j]));
-                    }
+                    f(j);
                 }
             }
         }
-
-        void end_array_slice2(const string_type& path, reference val, node_set& nodes)
+        else
         {
-            if (val.is_array())
+            size_t j = end + step_ - 1;
+            while (j > (start+step_-1))
             {
-                size_t start = positive_start_ ? start_ : val.size() - start_;
-                size_t end;
-                if (!undefined_end_)
-                {
-                    end = positive_end_ ? end_ : val.size() - end_;
-                }
-                else
+                j -= step_;
+                if (j < size)
                 {
-                    end = val.size();
+                    f(j);
                 }
+            }
+        }
+    }
+};
 
-                size_t j = end + step_ - 1;
-                while (j > (start+step_-1))
-                {
-                    j -= step_;
-                    if (j < val.size())
-                    {
-                        nodes.emplace_back(PathCons()(path,j),std::addressof(val[j]));
-                    }
-                }
+// One step of a compiled path, from the nodes selected so far to the next ones:
+// a wildcard, an unquoted name, or the selectors inside square brackets, either
+// of the children or, after "..", of all the descendants
+
+template <class Json>
+struct path_step
+{
+    typedef typename Json::string_type string_type;
+
+    bool recursive_descent;
+    bool wildcard;
+    string_type name;
+    std::vector<std::shared_ptr<const selector<Json>>> selectors;
+
+    // True if the step selects the same nodes as other
+    bool is_same(const path_step<Json>& other) const
+    {
+        if (recursive_descent != other.recursive_descent || wildcard != other.wildcard || 
+            name != other.name || selectors.size() != other.selectors.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < selectors.size(); ++i)
+        {
+            if (!selectors[i]->is_same(*other.selectors[i]))
+            {
+                return false;
             }
         }
-    };
+        return true;
+    }
+};
 
-    default_parse_error_handler default_err_handler_;
-    parse_error_handler *err_handler_;
-    path_state state_;
-    string_type buffer_;
-    size_t start_;
-    bool positive_start_;
-    size_t end_;
-    bool positive_end_;
-    bool undefined_end_;
-    size_t step_;
-    bool positive_step_;
+// The state of one evaluation of a compiled path, so that a jsonpath_expression
+// can be evaluated on many threads at once. With parallel_options, the nodes of a
+// step, the elements of an array being filtered, and the children of a container
+// being descended into, are split across threads once there are enough of them.
+// Each thread adds to its own evaluator, and their nodes are appended in order, so
+// the result is the same as evaluating on one thread.
+
+template <class Json>
+class jsonpath_evaluator
+{
+public:
+    typedef typename Json::string_type string_type;
+    typedef typename Json::string_view_type string_view_type;
+    typedef std::pair<string_type,const Json*> node_type;
+    typedef std::vector<node_type> node_set;
+private:
+    const Json& root_;
+    bool normalized_paths_;
+    const parallel_options* options_;
+    const member_index<Json>* index_;
     bool recursive_descent_;
+    node_set stack_;
     node_set nodes_;
-    std::vector<node_set> stack_;
     std::vector<std::shared_ptr<Json>> temp_json_values_;
-    size_t line_;
-    size_t column_;
-    const char_type* begin_input_;
-    const char_type* end_input_;
-    const char_type* p_;
-    std::vector<std::shared_ptr<selector>> selectors_;
-
 public:
-    jsonpath_evaluator()
-        : err_handler_(&default_err_handler_),
-          state_(path_state::start),
-          start_(0), positive_start_(true), 
-          end_(0), positive_end_(true), undefined_end_(false),
-          step_(0), positive_step_(true),
-          recursive_descent_(false),
-          line_(0), column_(0),
-          begin_input_(nullptr), end_input_(nullptr),
-          p_(nullptr)
+    jsonpath_evaluator(const Json& root, bool normalized_paths, 
+                       const parallel_options* options = nullptr, const member_index<Json>* index = nullptr)
+        : root_(root), normalized_paths_(normalized_paths), options_(options), index_(index), recursive_descent_(false)
+    {
+    }
+
+    jsonpath_evaluator(jsonpath_evaluator&&) = default;
+
+    const Json& root() const
+    {
+        return root_;
+    }
+
+    const member_index<Json>* index() const
+    {
+        return index_;
+    }
+
+    void evaluate(const std::vector<path_step<Json>>& steps)
     {
+        select_root();
+        for (const auto& step : steps)
+        {
+            evaluate(step);
+        }
+    }
+
+    // Replaces the selected nodes with the nodes that step selects from them
+    void evaluate(const path_step<Json>& step)
+    {
+        recursive_descent_ = step.recursive_descent;
+        if (step.wildcard)
+        {
+            end_all();
+        }
+        apply_unquoted_string(step.name);
+        apply_selectors(step.selectors);
+        transfer_nodes();
+    }
+
+    void select_root()
+    {
+        string_type s;
+        s.push_back('$');
+        stack_.clear();
+        stack_.emplace_back(std::move(s),std::addressof(root_));
+    }
+
+    const node_set& selected() const
+    {
+        return stack_;
+    }
+
+    void selected(const node_set& nodes)
+    {
+        stack_ = nodes;
     }
 
     Json get_values() const
     {
         Json result = typename Json::array();
-
-        if (stack_.size() > 0)
+        result.reserve(stack_.size());
+        for (const auto& p : stack_)
         {
-            result.reserve(stack_.back().size());
-            for (const auto& p : stack_.back())
-            {
-                result.push_back(*(p.second));
-            }
+            result.push_back(*(p.second));
         }
         return result;
     }
@@ -424,54 +572,714 @@ public:
     Json get_normalized_paths() const
     {
         Json result = typename Json::array();
-        if (stack_.size() > 0)
+        result.reserve(stack_.size());
+        for (const auto& p : stack_)
         {
-            result.reserve(stack_.back().size());
-            for (const auto& p : stack_.back())
-            {
-                result.push_back(p.first);
-            }
+            result.push_back(p.first);
         }
         return result;
     }
 
+    template <class Callback>
+    void for_each_node(Callback callback) const
+    {
+        for (const auto& p : stack_)
+        {
+            callback(*(p.second));
+        }
+    }
+
+    // The nodes were selected from a root passed as a non-const reference
     template <class T>
     void replace(T&& new_value)
     {
-        if (stack_.size() > 0)
+        for (size_t i = 0; i < stack_.size(); ++i)
         {
-            for (size_t i = 0; i < stack_.back().size(); ++i)
-            {
-                *(stack_.back()[i].second) = new_value;
-            }
+            *(const_cast<Json*>(stack_[i].second)) = new_value;
         }
     }
 
-    void evaluate(reference root, const string_view_type& path)
-    {
-        evaluate(root,path.data(),path.length());
-    }
-    void evaluate(reference root, const char_type* path)
+    // Calls callback with each node that is part of the root, once, the nodes having been
+    // selected from a root passed as a non-const reference. The nodes are visited in the
+    // reverse of the order they were selected in, so that a node is visited before the
+    // nodes it is part of, and changing it does not move a node that is yet to be visited
+    template <class Callback>
+    void transform(Callback callback)
+    {
+        std::unordered_set<const Json*> visited(temp_json_values_.size() + stack_.size());
+        for (const auto& temp : temp_json_values_)
+        {
+            visited.insert(temp.get());
+        }
+        for (size_t i = stack_.size(); i-- > 0;)
+        {
+            if (visited.insert(stack_[i].second).second)
+            {
+                callback(*(const_cast<Json*>(stack_[i].second)));
+            }
+        }
+    }
+
+    string_type child_path(const string_type& path, size_t index) const
+    {
+        return normalized_paths_ ? PathConstructor<Json>()(path,index) : string_type();
+    }
+
+    string_type child_path(const string_type& path, const string_view_type& name) const
+    {
+        return normalized_paths_ ? PathConstructor<Json>()(path,name) : string_type();
+    }
+
+    void add_node(string_type&& path, const Json* p)
+    {
+        nodes_.emplace_back(std::move(path),p);
+    }
+
+    void add_node(const string_type& path, const Json* p)
+    {
+        nodes_.emplace_back(path,p);
+    }
+
+    // A node that is not part of the root, such as the length of an array, lives
+    // as long as the evaluation
+    void add_temp_node(string_type&& path, Json&& val)
+    {
+        auto temp = std::make_shared<Json>(std::move(val));
+        temp_json_values_.push_back(temp);
+        nodes_.emplace_back(std::move(path),temp.get());
+    }
+
+    // Calls f(evaluator, first, last) to add the nodes for positions first to last
+    // of n, either with this evaluator, or split across threads
+    template <class F>
+    void for_range(size_t n, F f)
+    {
+        size_t chunks = options_ == nullptr || options_->min_chunk_size() == 0 ? 1 
+                        : (std::min)(options_->max_threads(), n / options_->min_chunk_size());
+        if (chunks <= 1)
+        {
+            f(*this, 0, n);
+            return;
+        }
+
+        std::vector<jsonpath_evaluator<Json>> evaluators;
+        evaluators.reserve(chunks);
+        for (size_t i = 0; i < chunks; ++i)
+        {
+            evaluators.emplace_back(root_, normalized_paths_, nullptr, index_);
+            evaluators.back().recursive_descent_ = recursive_descent_;
+        }
+        std::vector<std::exception_ptr> errors(chunks);
+        auto run = [&](size_t i)
+        {
+            try
+            {
+                f(evaluators[i], n*i/chunks, n*(i+1)/chunks);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        };
+        {
+            jsoncons::detail::joining_threads threads(chunks - 1);
+            for (size_t i = 1; i < chunks; ++i)
+            {
+                threads.start(run, i);
+            }
+            run(0);
+        }
+
+        for (size_t i = 0; i < chunks; ++i)
+        {
+            if (errors[i])
+            {
+                std::rethrow_exception(errors[i]);
+            }
+        }
+        for (auto& e : evaluators)
+        {
+            nodes_.insert(nodes_.end(), std::make_move_iterator(e.nodes_.begin()), std::make_move_iterator(e.nodes_.end()));
+            temp_json_values_.insert(temp_json_values_.end(), e.temp_json_values_.begin(), e.temp_json_values_.end());
+        }
+    }
+
+private:
+    void end_all()
+    {
+        for (size_t i = 0; i < stack_.size(); ++i)
+        {
+            const auto& path = stack_[i].first;
+            const Json* p = stack_[i].second;
+
+            if (p->is_array())
+            {
+                for (auto it = p->array_range().begin(); it != p->array_range().end(); ++it)
+                {
+                    nodes_.emplace_back(child_path(path,it - p->array_range().begin()),std::addressof(*it));
+                }
+            }
+            else if (p->is_object())
+            {
+                for (auto it = p->object_range().begin(); it != p->object_range().end(); ++it)
+                {
+                    nodes_.emplace_back(child_path(path,it->key()),std::addressof(it->value()));
+                }
+            }
+
+        }
+    }
+
+    void apply_unquoted_string(const string_view_type& name)
+    {
+        if (name.length() > 0)
+        {
+            for_range(stack_.size(), [&](jsonpath_evaluator<Json>& evaluator, size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
+                {
+                    evaluator.apply_unquoted_string(stack_[i].first, *(stack_[i].second), name);
+                }
+            });
+        }
+    }
+
+    void apply_unquoted_string(const string_type& path, const Json& val, const string_view_type& name)
+    {
+        bool positive_start = true;
+        if (val.is_object())
+        {
+            if (val.count(name) > 0)
+            {
+                nodes_.emplace_back(child_path(path,name),std::addressof(val.at(name)));
+            }
+            if (recursive_descent_)
+            {
+                auto members = val.object_range();
+                for_range(val.size(), [&](jsonpath_evaluator<Json>& evaluator, size_t first, size_t last)
+                {
+                    for (auto it = members.begin() + first; it != members.begin() + last; ++it)
+                    {
+                        if (it->value().is_object() || it->value().is_array())
+                        {
+                            evaluator.apply_unquoted_string(path, it->value(), name);
+                        }
+                    }
+                });
+            }
+        }
+        else if (val.is_array())
+        {
+            size_t pos = 0;
+            if (try_string_to_index(name.data(),name.size(),&pos, &positive_start))
+            {
+                size_t index = positive_start ? pos : val.size() - pos;
+                if (index < val.size())
+                {
+                    nodes_.emplace_back(child_path(path,index),std::addressof(val[index]));
+                }
+            }
+            else if (name == length_literal<Json>() && val.size() > 0)
+            {
+                add_temp_node(child_path(path,name),Json(val.size()));
+            }
+            if (recursive_descent_)
+            {
+                auto elements = val.array_range();
+                for_range(val.size(), [&](jsonpath_evaluator<Json>& evaluator, size_t first, size_t last)
+                {
+                    for (auto it = elements.begin() + first; it != elements.begin() + last; ++it)
+                    {
+                        if (it->is_object() || it->is_array())
+                        {
+                            evaluator.apply_unquoted_string(path, *it, name);
+                        }
+                    }
+                });
+            }
+        }
+        else if (val.is_string())
+        {
+            string_view_type sv = val.as_string_view();
+            size_t pos = 0;
+            if (try_string_to_index(name.data(),name.size(),&pos, &positive_start))
+            {
+                auto sequence = unicons::sequence_at(sv.data(), sv.data() + sv.size(), pos);
+                if (sequence.length() > 0)
+                {
+                    add_temp_node(child_path(path,pos),Json(sequence.begin(),sequence.length()));
+                }
+            }
+            else if (name == length_literal<Json>() && sv.size() > 0)
+            {
+                size_t count = unicons::u32_length(sv.begin(),sv.end());
+                add_temp_node(child_path(path,name),Json(count));
+            }
+        }
+    }
+
+    void apply_selectors(const std::vector<std::shared_ptr<const selector<Json>>>& selectors)
+    {
+        if (selectors.size() > 0)
+        {
+            for_range(stack_.size(), [&](jsonpath_evaluator<Json>& evaluator, size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
+                {
+                    evaluator.apply_selectors(selectors, stack_[i].first, *(stack_[i].second));
+                }
+            });
+        }
+    }
+
+    void apply_selectors(const std::vector<std::shared_ptr<const selector<Json>>>& selectors, 
+                         const string_type& path, const Json& val)
+    {
+        for (const auto& selector : selectors)
+        {
+            selector->select(*this, path, val);
+        }
+        if (recursive_descent_)
+        {
+            if (val.is_object())
+            {
+                auto members = val.object_range();
+                for_range(val.size(), [&](jsonpath_evaluator<Json>& evaluator, size_t first, size_t last)
+                {
+                    for (auto it = members.begin() + first; it != members.begin() + last; ++it)
+                    {
+                        if (it->value().is_object() || it->value().is_array())
+                        {
+                            evaluator.apply_selectors(selectors, path, it->value());
+                        }
+                    }
+                });
+            }
+            else if (val.is_array())
+            {
+                auto elements = val.array_range();
+                for_range(val.size(), [&](jsonpath_evaluator<Json>& evaluator, size_t first, size_t last)
+                {
+                    for (auto it = elements.begin() + first; it != elements.begin() + last; ++it)
+                    {
+                        if (it->is_object() || it->is_array())
+                        {
+                            evaluator.apply_selectors(selectors, path, *it);
+                        }
+                    }
+                });
+            }
+        }
+    }
+
+    void transfer_nodes()
+    {
+        stack_.swap(nodes_);
+        nodes_.clear();
+        recursive_descent_ = false;
+    }
+};
+
+// True for a read-only view of an encoded document, such as a cbor_view or msgpack_view,
+// with is_array, is_object, size, at, has_key, key, value, indexed and as<Json>()
+
+template <class T, class Enable = void>
+struct is_encoded_view : std::false_type {};
+
+template <class T>
+struct is_encoded_view<T,typename std::enable_if<std::is_same<decltype(std::declval<const T&>().buffer()),const uint8_t*>::value &&
+                                                 std::is_same<decltype(std::declval<const T&>().indexed()),T>::value>::type> 
+    : std::true_type {};
+
+// Evaluates a compiled path on a view of an encoded document by navigating the encoded
+// bytes. The nodes are views of the items selected, so nothing is decoded to select them.
+// A filter or an expression in brackets decodes the node it tests, and the root only if
+// it has an aggregate function of a path from the root. A step applied to a scalar, or
+// to a value that is not part of the root, such as the length of an array, decodes it
+// and is evaluated as on a Json value. The children of a container are visited through
+// an indexed view of it, so that walking them takes linear time.
+
+template <class Json, class View>
+class jsonpath_view_evaluator
+{
+public:
+    typedef typename Json::string_type string_type;
+    typedef typename Json::string_view_type string_view_type;
+
+    struct node_type
+    {
+        string_type path;
+        View view;
+        // A value that is not part of the root, or null
+        std::shared_ptr<Json> value;
+    };
+private:
+    const View& root_;
+    bool normalized_paths_;
+    bool recursive_descent_;
+    std::shared_ptr<Json> root_value_;
+    std::vector<node_type> stack_;
+    std::vector<node_type> nodes_;
+public:
+    jsonpath_view_evaluator(const View& root, bool normalized_paths)
+        : root_(root), normalized_paths_(normalized_paths), recursive_descent_(false)
+    {
+    }
+
+    void evaluate(const std::vector<path_step<Json>>& steps)
+    {
+        stack_.clear();
+        if (root_.buflen() > 0)
+        {
+            string_type s;
+            s.push_back('$');
+            stack_.push_back(node_type{std::move(s), root_, std::shared_ptr<Json>()});
+        }
+        for (const auto& step : steps)
+        {
+            evaluate(step);
+        }
+    }
+
+    Json get_values() const
+    {
+        Json result = typename Json::array();
+        result.reserve(stack_.size());
+        for (const auto& node : stack_)
+        {
+            if (node.value)
+            {
+                result.push_back(*node.value);
+            }
+            else
+            {
+                result.push_back(node.view.template as<Json>());
+            }
+        }
+        return result;
+    }
+
+    Json get_normalized_paths() const
+    {
+        Json result = typename Json::array();
+        result.reserve(stack_.size());
+        for (const auto& node : stack_)
+        {
+            result.push_back(node.path);
+        }
+        return result;
+    }
+
+private:
+    void evaluate(const path_step<Json>& step)
+    {
+        recursive_descent_ = step.recursive_descent;
+        for (size_t i = 0; i < stack_.size(); ++i)
+        {
+            const node_type& node = stack_[i];
+            if (node.value)
+            {
+                evaluate_value(step, node.path, *node.value);
+            }
+            else if (!node.view.is_array() && !node.view.is_object())
+            {
+                evaluate_value(step, node.path, node.view.template as<Json>());
+            }
+            else
+            {
+                if (step.wildcard)
+                {
+                    for_each_child(node.path, node.view, [&](string_type&& path, const View& child)
+                    {
+                        add_node(std::move(path), child);
+                    });
+                }
+                if (step.name.length() > 0)
+                {
+                    apply_name(node.path, node.view, step.name);
+                }
+                if (step.selectors.size() > 0)
+                {
+                    apply_selectors(step.selectors, node.path, node.view);
+                }
+            }
+        }
+        stack_.swap(nodes_);
+        nodes_.clear();
+        recursive_descent_ = false;
+    }
+
+    void evaluate_value(const path_step<Json>& step, const string_type& path, const Json& val)
+    {
+        bool uses_root = false;
+        for (const auto& selector : step.selectors)
+        {
+            uses_root = uses_root || selector_uses_root(*selector);
+        }
+        jsonpath_evaluator<Json> evaluator(uses_root ? root_value() : val, normalized_paths_);
+        typename jsonpath_evaluator<Json>::node_set nodes;
+        nodes.emplace_back(path, std::addressof(val));
+        evaluator.selected(nodes);
+        evaluator.evaluate(step);
+        for (const auto& p : evaluator.selected())
+        {
+            add_temp_node(string_type(p.first), Json(*p.second));
+        }
+    }
+
+    void apply_name(const string_type& path, const View& val, const string_view_type& name)
+    {
+        select_name(path, val, name);
+        if (recursive_descent_)
+        {
+            for_each_child(path, val, [&](string_type&& child_path, const View& child)
+            {
+                if (child.is_object() || child.is_array())
+                {
+                    apply_name(child_path, child, name);
+                }
+            });
+        }
+    }
+
+    void apply_selectors(const std::vector<std::shared_ptr<const selector<Json>>>& selectors, 
+                         const string_type& path, const View& val)
+    {
+        for (const auto& selector : selectors)
+        {
+            apply_selector(*selector, path, val);
+        }
+        if (recursive_descent_)
+        {
+            for_each_child(path, val, [&](string_type&& child_path, const View& child)
+            {
+                if (child.is_object() || child.is_array())
+                {
+                    apply_selectors(selectors, child_path, child);
+                }
+            });
+        }
+    }
+
+    // val is an array or object
+    void apply_selector(const selector<Json>& sel, const string_type& path, const View& val)
+    {
+        if (auto p = dynamic_cast<const name_selector<Json>*>(&sel))
+        {
+            select_name(path, val, p->name());
+        }
+        else if (auto p = dynamic_cast<const array_slice_selector<Json>*>(&sel))
+        {
+            if (val.is_array())
+            {
+                View elements = val.indexed();
+                p->for_each_position(elements.size(), [&](size_t j)
+                {
+                    add_node(child_path(path,j), elements.value(j));
+                });
+            }
+        }
+        else if (auto p = dynamic_cast<const filter_selector<Json>*>(&sel))
+        {
+            const auto& filter = p->filter();
+            if (val.is_array())
+            {
+                View elements = val.indexed();
+                for (size_t i = 0; i < elements.size(); ++i)
+                {
+                    View element = elements.value(i);
+                    Json context = element.template as<Json>();
+                    if (filter.exists(filter.uses_root() ? root_value() : context, context))
+                    {
+                        add_node(child_path(path,i), element);
+                    }
+                }
+            }
+            else
+            {
+                Json context = val.template as<Json>();
+                if (filter.exists(filter.uses_root() ? root_value() : context, context))
+                {
+                    add_node(string_type(path), val);
+                }
+            }
+        }
+        else if (auto p = dynamic_cast<const expr_selector<Json>*>(&sel))
+        {
+            const auto& expr = p->expr();
+            Json context = val.template as<Json>();
+            auto index = expr.eval(expr.uses_root() ? root_value() : context, context);
+            if (index.template is<size_t>())
+            {
+                size_t start = index. template as<size_t>();
+                if (val.is_array() && start < val.size())
+                {
+                    add_node(child_path(path,start), val.at(start));
+                }
+            }
+            else if (index.is_string())
+            {
+                select_name(path, val, index.as_string_view());
+            }
+        }
+    }
+
+    // val is an array or object
+    void select_name(const string_type& path, const View& val, const string_view_type& name)
+    {
+        if (val.is_object())
+        {
+            if (val.has_key(name))
+            {
+                add_node(child_path(path,name), val.at(name));
+            }
+        }
+        else
+        {
+            size_t pos = 0;
+            bool positive_start = true;
+            if (try_string_to_index(name.data(), name.size(), &pos, &positive_start))
+            {
+                const size_t size = val.size();
+                size_t index = positive_start ? pos : size - pos;
+                if (index < size)
+                {
+                    add_node(child_path(path,index), val.at(index));
+                }
+            }
+            else if (name == length_literal<Json>())
+            {
+                const size_t size = val.size();
+                if (size > 0)
+                {
+                    add_temp_node(child_path(path,name), Json(size));
+                }
+            }
+        }
+    }
+
+    // Calls f(path, child) for each element of an array, or member value of an object
+    template <class F>
+    void for_each_child(const string_type& path, const View& val, F f)
+    {
+        View container = val.indexed();
+        const bool is_object = container.is_object();
+        const size_t size = container.size();
+        for (size_t i = 0; i < size; ++i)
+        {
+            f(is_object ? child_path(path,container.key(i)) : child_path(path,i), container.value(i));
+        }
+    }
+
+    bool selector_uses_root(const selector<Json>& sel) const
+    {
+        if (auto p = dynamic_cast<const filter_selector<Json>*>(&sel))
+        {
+            return p->filter().uses_root();
+        }
+        if (auto p = dynamic_cast<const expr_selector<Json>*>(&sel))
+        {
+            return p->expr().uses_root();
+        }
+        return false;
+    }
+
+    // The root, decoded the first time a filter needs it
+    const Json& root_value()
+    {
+        if (!root_value_)
+        {
+            root_value_ = std::make_shared<Json>(root_.template as<Json>());
+        }
+        return *root_value_;
+    }
+
+    string_type child_path(const string_type& path, size_t index) const
+    {
+        return normalized_paths_ ? PathConstructor<Json>()(path,index) : string_type();
+    }
+
+    string_type child_path(const string_type& path, const string_view_type& name) const
+    {
+        return normalized_paths_ ? PathConstructor<Json>()(path,name) : string_type();
+    }
+
+    void add_node(string_type&& path, const View& val)
+    {
+        nodes_.push_back(node_type{std::move(path), val, std::shared_ptr<Json>()});
+    }
+
+    void add_temp_node(string_type&& path, Json&& val)
+    {
+        nodes_.push_back(node_type{std::move(path), View(), std::make_shared<Json>(std::move(val))});
+    }
+};
+
+// Parses a path once into the steps of a jsonpath_expression
+
+template<class Json>
+class jsonpath_compiler : private parsing_context
+{
+private:
+    typedef typename Json::char_type char_type;
+    typedef typename Json::char_traits_type char_traits_type;
+    typedef std::basic_string<char_type,char_traits_type> string_type;
+    typedef typename Json::string_view_type string_view_type;
+
+    default_parse_error_handler default_err_handler_;
+    parse_error_handler *err_handler_;
+    path_state state_;
+    string_type buffer_;
+    size_t start_;
+    bool positive_start_;
+    size_t end_;
+    bool positive_end_;
+    bool undefined_end_;
+    size_t step_;
+    bool positive_step_;
+    bool recursive_descent_;
+    bool wildcard_;
+    string_type name_;
+    std::vector<std::shared_ptr<const selector<Json>>> selectors_;
+    bool has_root_;
+    std::vector<path_step<Json>> steps_;
+    size_t line_;
+    size_t column_;
+    const char_type* begin_input_;
+    const char_type* end_input_;
+    const char_type* p_;
+
+public:
+    jsonpath_compiler()
+        : err_handler_(&default_err_handler_),
+          state_(path_state::start),
+          start_(0), positive_start_(true), 
+          end_(0), positive_end_(true), undefined_end_(false),
+          step_(0), positive_step_(true),
+          recursive_descent_(false),
+          wildcard_(false),
+          has_root_(false),
+          line_(0), column_(0),
+          begin_input_(nullptr), end_input_(nullptr),
+          p_(nullptr)
     {
-        evaluate(root,path,char_traits_type::length(path));
     }
 
-    void evaluate(reference root, 
-                  const char_type* path, 
-                  size_t length)
+    jsonpath_expression<Json> compile(const char_type* path, 
+                                      size_t length)
     {
         std::error_code ec;
-        evaluate(root, path, length, ec);
+        jsonpath_expression<Json> expr = compile(path, length, ec);
         if (ec)
         {
             throw parse_error(ec,line_,column_);
         }
+        return expr;
     }
 
-    void evaluate(reference root, 
-                  const char_type* path, 
-                  size_t length,
-                  std::error_code& ec)
+    jsonpath_expression<Json> compile(const char_type* path, 
+                                      size_t length,
+                                      std::error_code& ec)
     {
         path_state pre_line_break_state = path_state::start;
 
@@ -484,6 +1292,11 @@ public:
         state_ = path_state::start;
 
         recursive_descent_ = false;
+        wildcard_ = false;
+        name_.clear();
+        selectors_.clear();
+        has_root_ = false;
+        steps_.clear();
 
         clear_index();
 
@@ -518,20 +1331,13 @@ public:
                     break;
                 case '$':
                 case '@':
-                    {
-                        string_type s;
-                        s.push_back('$');
-                        node_set v;
-                        v.emplace_back(std::move(s),std::addressof(root));
-                        stack_.push_back(v);
-
-                        state_ = path_state::expect_dot_or_left_bracket;
-                    }
+                    has_root_ = true;
+                    state_ = path_state::expect_dot_or_left_bracket;
                     break;
                 default:
                     err_handler_->fatal_error(jsonpath_parser_errc::expected_root, *this);
                     ec = jsonpath_parser_errc::expected_root;
-                    return;
+                    return jsonpath_expression<Json>();
                 };
                 ++p_;
                 ++column_;
@@ -556,10 +1362,10 @@ public:
                 case '.':
                     err_handler_->fatal_error(jsonpath_parser_errc::expected_name, *this);
                     ec = jsonpath_parser_errc::expected_name;
-                    return;
+                    return jsonpath_expression<Json>();
                 case '*':
-                    end_all();
-                    transfer_nodes();
+                    add_wildcard();
+                    end_step();
                     state_ = path_state::expect_dot_or_left_bracket;
                     ++p_;
                     ++column_;
@@ -589,7 +1395,7 @@ public:
                 default:
                     err_handler_->fatal_error(jsonpath_parser_errc::expected_separator, *this);
                     ec = jsonpath_parser_errc::expected_separator;
-                    return;
+                    return jsonpath_expression<Json>();
                 };
                 ++p_;
                 ++column_;
@@ -601,8 +1407,7 @@ public:
                     state_ = path_state::left_bracket;
                     break;
                 case ']':
-                    apply_selectors();
-                    transfer_nodes();
+                    end_step();
                     state_ = path_state::expect_dot_or_left_bracket;
                     break;
                 case ' ':case '\t':
@@ -610,7 +1415,7 @@ public:
                 default:
                     err_handler_->fatal_error(jsonpath_parser_errc::expected_right_bracket, *this);
                     ec = jsonpath_parser_errc::expected_right_bracket;
-                    return;
+                    return jsonpath_expression<Json>();
                 }
                 ++p_;
                 ++column_;
@@ -625,20 +1430,20 @@ public:
                 case '(':
                     {
                         jsonpath_filter_parser<Json> parser(line_,column_);
-                        auto result = parser.parse(root, p_,end_input_,&p_);
+                        auto result = parser.parse(p_,end_input_,&p_);
                         line_ = parser.line();
                         column_ = parser.column();
-                        selectors_.push_back(std::make_shared<expr_selector>(result));
+                        selectors_.push_back(std::make_shared<expr_selector<Json>>(result));
                         state_ = path_state::expect_comma_or_right_bracket;
                     }
                     break;
                 case '?':
                     {
                         jsonpath_filter_parser<Json> parser(line_,column_);
-                        auto result = parser.parse(root,p_,end_input_,&p_);
+                        auto result = parser.parse(p_,end_input_,&p_);
                         line_ = parser.line();
                         column_ = parser.column();
-                        selectors_.push_back(std::make_shared<filter_selector>(result));
+                        selectors_.push_back(std::make_shared<filter_selector<Json>>(result));
                         state_ = path_state::expect_comma_or_right_bracket;
                     }
                     break;                   
@@ -649,7 +1454,7 @@ public:
                     ++column_;
                     break;
                 case '*':
-                    end_all();
+                    add_wildcard();
                     state_ = path_state::expect_comma_or_right_bracket;
                     ++p_;
                     ++column_;
@@ -681,20 +1486,19 @@ public:
                     {
                         err_handler_->fatal_error(jsonpath_parser_errc::expected_index, *this);
                         ec = jsonpath_parser_errc::expected_index;
-                        return;
+                        return jsonpath_expression<Json>();
                     }
                     state_ = path_state::left_bracket_end;
                     break;
                 case ',':
-                    selectors_.push_back(std::make_shared<name_selector>(buffer_,positive_start_));
+                    selectors_.push_back(std::make_shared<name_selector<Json>>(buffer_));
                     buffer_.clear();
                     state_ = path_state::left_bracket;
                     break;
                 case ']':
-                    selectors_.push_back(std::make_shared<name_selector>(buffer_,positive_start_));
+                    selectors_.push_back(std::make_shared<name_selector<Json>>(buffer_));
                     buffer_.clear();
-                    apply_selectors();
-                    transfer_nodes();
+                    end_step();
                     state_ = path_state::expect_dot_or_left_bracket;
                     break;
                 default:
@@ -721,13 +1525,12 @@ public:
                     state_ = path_state::left_bracket_end2;
                     break;
                 case ',':
-                    selectors_.push_back(std::make_shared<array_slice_selector>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
+                    selectors_.push_back(std::make_shared<array_slice_selector<Json>>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
                     state_ = path_state::left_bracket;
                     break;
                 case ']':
-                    selectors_.push_back(std::make_shared<array_slice_selector>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
-                    apply_selectors();
-                    transfer_nodes();
+                    selectors_.push_back(std::make_shared<array_slice_selector<Json>>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
+                    end_step();
                     state_ = path_state::expect_dot_or_left_bracket;
                     break;
                 }
@@ -746,13 +1549,12 @@ public:
                     end_ = end_*10 + static_cast<size_t>(*p_-'0');
                     break;
                 case ',':
-                    selectors_.push_back(std::make_shared<array_slice_selector>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
+                    selectors_.push_back(std::make_shared<array_slice_selector<Json>>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
                     state_ = path_state::left_bracket;
                     break;
                 case ']':
-                    selectors_.push_back(std::make_shared<array_slice_selector>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
-                    apply_selectors();
-                    transfer_nodes();
+                    selectors_.push_back(std::make_shared<array_slice_selector<Json>>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
+                    end_step();
                     state_ = path_state::expect_dot_or_left_bracket;
                     break;
                 }
@@ -771,13 +1573,12 @@ public:
                     state_ = path_state::left_bracket_step2;
                     break;
                 case ',':
-                    selectors_.push_back(std::make_shared<array_slice_selector>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
+                    selectors_.push_back(std::make_shared<array_slice_selector<Json>>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
                     state_ = path_state::left_bracket;
                     break;
                 case ']':
-                    selectors_.push_back(std::make_shared<array_slice_selector>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
-                    apply_selectors();
-                    transfer_nodes();
+                    selectors_.push_back(std::make_shared<array_slice_selector<Json>>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
+                    end_step();
                     state_ = path_state::expect_dot_or_left_bracket;
                     break;
                 }
@@ -791,13 +1592,12 @@ public:
                     step_ = step_*10 + static_cast<size_t>(*p_-'0');
                     break;
                 case ',':
-                    selectors_.push_back(std::make_shared<array_slice_selector>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
+                    selectors_.push_back(std::make_shared<array_slice_selector<Json>>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
                     state_ = path_state::left_bracket;
                     break;
                 case ']':
-                    selectors_.push_back(std::make_shared<array_slice_selector>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
-                    apply_selectors();
-                    transfer_nodes();
+                    selectors_.push_back(std::make_shared<array_slice_selector<Json>>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
+                    end_step();
                     state_ = path_state::expect_dot_or_left_bracket;
                     break;
                 }
@@ -808,30 +1608,30 @@ public:
                 switch (*p_)
                 {
                 case '[':
-                    apply_unquoted_string(buffer_);
-                    transfer_nodes();
+                    add_name();
+                    end_step();
                     start_ = 0;
                     state_ = path_state::left_bracket;
                     break;
                 case '.':
-                    apply_unquoted_string(buffer_);
-                    transfer_nodes();
+                    add_name();
+                    end_step();
                     state_ = path_state::dot;
                     break;
                 case ' ':case '\t':
-                    apply_unquoted_string(buffer_);
-                    transfer_nodes();
+                    add_name();
+                    end_step();
                     state_ = path_state::expect_dot_or_left_bracket;
                     break;
                 case '\r':
-                    apply_unquoted_string(buffer_);
-                    transfer_nodes();
+                    add_name();
+                    end_step();
                     pre_line_break_state = path_state::expect_dot_or_left_bracket;
                     state_= path_state::cr;
                     break;
                 case '\n':
-                    apply_unquoted_string(buffer_);
-                    transfer_nodes();
+                    add_name();
+                    end_step();
                     pre_line_break_state = path_state::expect_dot_or_left_bracket;
                     state_= path_state::lf;
                     break;
@@ -846,7 +1646,7 @@ public:
                 switch (*p_)
                 {
                 case '\'':
-                    selectors_.push_back(std::make_shared<name_selector>(buffer_,positive_start_));
+                    selectors_.push_back(std::make_shared<name_selector<Json>>(buffer_));
                     buffer_.clear();
                     state_ = path_state::expect_comma_or_right_bracket;
                     break;
@@ -870,7 +1670,7 @@ public:
                 switch (*p_)
                 {
                 case '\"':
-                    selectors_.push_back(std::make_shared<name_selector>(buffer_,positive_start_));
+                    selectors_.push_back(std::make_shared<name_selector<Json>>(buffer_));
                     buffer_.clear();
                     state_ = path_state::expect_comma_or_right_bracket;
                     break;
@@ -900,13 +1700,14 @@ public:
         {
         case path_state::unquoted_name: 
             {
-                apply_unquoted_string(buffer_);
-                transfer_nodes();
+                add_name();
+                end_step();
             }
             break;
         default:
             break;
         }
+        return jsonpath_expression<Json>(has_root_, std::move(steps_));
     }
 
     void clear_index()
@@ -921,177 +1722,492 @@ public:
         positive_step_ = true;
     }
 
-    void end_all()
+    void add_wildcard()
     {
-        for (size_t i = 0; i < stack_.back().size(); ++i)
-        {
-            const auto& path = stack_.back()[i].first;
-            pointer p = stack_.back()[i].second;
+        wildcard_ = true;
+        start_ = 0;
+    }
 
-            if (p->is_array())
-            {
-                for (auto it = p->array_range().begin(); it != p->array_range().end(); ++it)
-                {
-                    nodes_.emplace_back(PathCons()(path,it - p->array_range().begin()),std::addressof(*it));
-                }
-            }
-            else if (p->is_object())
+    void add_name()
+    {
+        name_ = buffer_;
+        buffer_.clear();
+    }
+
+    void end_step()
+    {
+        path_step<Json> step;
+        step.recursive_descent = recursive_descent_;
+        step.wildcard = wildcard_;
+        step.name = std::move(name_);
+        step.selectors = std::move(selectors_);
+        steps_.push_back(std::move(step));
+
+        recursive_descent_ = false;
+        wildcard_ = false;
+        name_.clear();
+        selectors_.clear();
+    }
+
+    size_t do_line_number() const override
+    {
+        return line_;
+    }
+
+    size_t do_column_number() const override
+    {
+        return column_;
+    }
+};
+
+}
+
+// A compiled path. It is not changed by evaluation, so one expression may be
+// evaluated against any number of roots, on any number of threads at once.
+
+template <class Json>
+class jsonpath_expression
+{
+    friend class detail::jsonpath_compiler<Json>;
+    friend class detail::path_term<Json>;
+    friend class jsonpath_expression_set<Json>;
+
+    typedef typename Json::string_type string_type;
+
+    bool has_root_;
+    std::vector<detail::path_step<Json>> steps_;
+
+    jsonpath_expression(bool has_root, std::vector<detail::path_step<Json>>&& steps)
+        : has_root_(has_root), steps_(std::move(steps))
+    {
+    }
+
+    // True if each step of the path is a name alone, as in @.a.b, with names set
+    // to the names
+    bool member_names(std::vector<string_type>& names) const
+    {
+        if (!has_root_)
+        {
+            return false;
+        }
+        for (const auto& step : steps_)
+        {
+            if (step.recursive_descent || step.wildcard || step.name.empty() || step.selectors.size() > 0)
             {
-                for (auto it = p->object_range().begin(); it != p->object_range().end(); ++it)
-                {
-                    nodes_.emplace_back(PathCons()(path,it->key()),std::addressof(it->value()));
-                }
+                return false;
             }
+            names.push_back(step.name);
+        }
+        return true;
+    }
+public:
+    // Selects nothing
+    jsonpath_expression()
+        : has_root_(false)
+    {
+    }
 
+    Json evaluate(const Json& root, result_type result_t = result_type::value) const
+    {
+        detail::jsonpath_evaluator<Json> evaluator(root, result_t == result_type::path);
+        if (has_root_)
+        {
+            evaluator.evaluate(steps_);
         }
-        start_ = 0;
+        return result_t == result_type::value ? evaluator.get_values() : evaluator.get_normalized_paths();
     }
 
-    void apply_unquoted_string(const string_view_type& name)
+    // Evaluates the expression on up to options.max_threads() threads. The result is
+    // the same as evaluate(root, result_t), in the same order
+    Json evaluate(const Json& root, result_type result_t, const parallel_options& options) const
     {
-        if (name.length() > 0)
+        detail::jsonpath_evaluator<Json> evaluator(root, result_t == result_type::path, &options);
+        if (has_root_)
         {
-            for (size_t i = 0; i < stack_.back().size(); ++i)
-            {
-                apply_unquoted_string(stack_.back()[i].first, *(stack_.back()[i].second), name);
-            }
+            evaluator.evaluate(steps_);
         }
-        buffer_.clear();
+        return result_t == result_type::value ? evaluator.get_values() : evaluator.get_normalized_paths();
     }
 
-    void apply_unquoted_string(const string_type& path, reference val, const string_view_type& name)
+    // Calls callback with each value matching the expression, without copying it.
+    // Values that are not part of root, such as the length of an array, last until
+    // select returns
+    template <class Callback>
+    void select(const Json& root, Callback callback) const
     {
-        if (val.is_object())
+        detail::jsonpath_evaluator<Json> evaluator(root, false);
+        if (has_root_)
         {
-            if (val.count(name) > 0)
-            {
-                nodes_.emplace_back(PathCons()(path,name),std::addressof(val.at(name)));
-            }
-            if (recursive_descent_)
-            {
-                for (auto it = val.object_range().begin(); it != val.object_range().end(); ++it)
-                {
-                    if (it->value().is_object() || it->value().is_array())
-                    {
-                        apply_unquoted_string(path, it->value(), name);
-                    }
-                }
-            }
+            evaluator.evaluate(steps_);
         }
-        else if (val.is_array())
+        evaluator.for_each_node(callback);
+    }
+
+    // Selects the values on up to options.max_threads() threads, then calls callback
+    // with each of them, in order, on the calling thread
+    template <class Callback>
+    void select(const Json& root, Callback callback, const parallel_options& options) const
+    {
+        detail::jsonpath_evaluator<Json> evaluator(root, false, &options);
+        if (has_root_)
         {
-            size_t pos = 0;
-            if (try_string_to_index(name.data(),name.size(),&pos, &positive_start_))
-            {
-                size_t index = positive_start_ ? pos : val.size() - pos;
-                if (index < val.size())
-                {
-                    nodes_.emplace_back(PathCons()(path,index),std::addressof(val[index]));
-                }
-            }
-            else if (name == length_literal() && val.size() > 0)
+            evaluator.evaluate(steps_);
+        }
+        evaluator.for_each_node(callback);
+    }
+
+    // Evaluates the expression with the index for filters that test an indexed
+    // member for equality. The result is the same as evaluate(root, result_t)
+    Json evaluate(const Json& root, const member_index<Json>& index, result_type result_t = result_type::value) const
+    {
+        detail::jsonpath_evaluator<Json> evaluator(root, result_t == result_type::path, nullptr, &index);
+        if (has_root_)
+        {
+            evaluator.evaluate(steps_);
+        }
+        return result_t == result_type::value ? evaluator.get_values() : evaluator.get_normalized_paths();
+    }
+
+    template <class Callback>
+    void select(const Json& root, Callback callback, const member_index<Json>& index) const
+    {
+        detail::jsonpath_evaluator<Json> evaluator(root, false, nullptr, &index);
+        if (has_root_)
+        {
+            evaluator.evaluate(steps_);
+        }
+        evaluator.for_each_node(callback);
+    }
+
+    // Evaluates the expression on a read-only view of an encoded document, a cbor_view or
+    // msgpack_view, without decoding the document. Only the values in the result are
+    // decoded, and the nodes a filter tests; with result_type::path, only those.
+    template <class View>
+    typename std::enable_if<detail::is_encoded_view<View>::value,Json>::type
+    evaluate(const View& root, result_type result_t = result_type::value) const
+    {
+        detail::jsonpath_view_evaluator<Json,View> evaluator(root, result_t == result_type::path);
+        if (has_root_)
+        {
+            evaluator.evaluate(steps_);
+        }
+        return result_t == result_type::value ? evaluator.get_values() : evaluator.get_normalized_paths();
+    }
+
+    template <class T>
+    void replace(Json& root, T&& new_value) const
+    {
+        detail::jsonpath_evaluator<Json> evaluator(root, false);
+        if (has_root_)
+        {
+            evaluator.evaluate(steps_);
+        }
+        evaluator.replace(std::forward<T>(new_value));
+    }
+
+    // Calls callback with a reference to each value matching the expression, so that it
+    // can change them in place
+    template <class Callback>
+    void transform(Json& root, Callback callback) const
+    {
+        detail::jsonpath_evaluator<Json> evaluator(root, false);
+        if (has_root_)
+        {
+            evaluator.evaluate(steps_);
+        }
+        evaluator.transform(callback);
+    }
+};
+
+template<class Json>
+jsonpath_expression<Json> compile(const typename Json::string_view_type& path)
+{
+    detail::jsonpath_compiler<Json> compiler;
+    return compiler.compile(path.data(),path.length());
+}
+
+template<class Json>
+jsonpath_expression<Json> compile(const typename Json::string_view_type& path, std::error_code& ec)
+{
+    detail::jsonpath_compiler<Json> compiler;
+    try
+    {
+        return compiler.compile(path.data(),path.length(),ec);
+    }
+    catch (const parse_error& e)
+    {
+        ec = e.code();
+        return jsonpath_expression<Json>();
+    }
+}
+
+// A hash index of the elements of the arrays that a path selects, by the value of one
+// of their members. A jsonpath_expression evaluated with the index tests only the
+// elements it finds for a filter that compares that member with a literal for equality,
+// as in $.users[?(@.id == 12345)], in place of every element. The index refers to the
+// arrays of the root, and must be built again when they change, an array whose size
+// has changed is scanned.
+
+template <class Json>
+class member_index
+{
+public:
+    typedef typename Json::string_type string_type;
+    typedef typename Json::string_view_type string_view_type;
+private:
+    struct array_positions
+    {
+        size_t size;
+        std::unordered_map<size_t,std::vector<size_t>> positions;
+    };
+
+    string_type name_;
+    std::unordered_map<const Json*,array_positions> arrays_;
+public:
+    member_index(const Json& root, const string_view_type& path, const string_view_type& name)
+        : name_(name.data(), name.length())
+    {
+        // A name that is an index or length may select from array and string elements
+        size_t pos;
+        bool positive_start;
+        bool names_element = detail::try_string_to_index(name_.data(), name_.size(), &pos, &positive_start) || 
+                             name_ == detail::length_literal<Json>();
+
+        compile<Json>(path).select(root, [&](const Json& val)
+        {
+            if (!val.is_array() || arrays_.count(std::addressof(val)) > 0)
             {
-                auto temp = std::make_shared<Json>(val.size());
-                temp_json_values_.push_back(temp);
-                nodes_.emplace_back(PathCons()(path,name),temp.get());
+                return;
             }
-            if (recursive_descent_)
+            array_positions a;
+            a.size = val.size();
+            for (size_t i = 0; i < val.size(); ++i)
             {
-                for (auto it = val.array_range().begin(); it != val.array_range().end(); ++it)
+                const Json& element = val[i];
+                if (element.is_object())
                 {
-                    if (it->is_object() || it->is_array())
+                    auto it = element.find(name_);
+                    if (it != element.object_range().end())
                     {
-                        apply_unquoted_string(path, *it, name);
+                        a.positions[hash_value(it->value())].push_back(i);
                     }
                 }
-            }
-        }
-        else if (val.is_string())
-        {
-            string_view_type sv = val.as_string_view();
-            size_t pos = 0;
-            if (try_string_to_index(name.data(),name.size(),&pos, &positive_start_))
-            {
-                auto sequence = unicons::sequence_at(sv.data(), sv.data() + sv.size(), pos);
-                if (sequence.length() > 0)
+                else if (names_element && (element.is_array() || element.is_string()))
                 {
-                    auto temp = std::make_shared<Json>(sequence.begin(),sequence.length());
-                    temp_json_values_.push_back(temp);
-                    nodes_.emplace_back(PathCons()(path,pos),temp.get());
+                    return;
                 }
             }
-            else if (name == length_literal() && sv.size() > 0)
-            {
-                size_t count = unicons::u32_length(sv.begin(),sv.end());
-                auto temp = std::make_shared<Json>(count);
-                temp_json_values_.push_back(temp);
-                nodes_.emplace_back(PathCons()(path,name),temp.get());
-            }
-        }
+            arrays_.emplace(std::addressof(val), std::move(a));
+        });
+    }
+
+    const string_type& name() const
+    {
+        return name_;
     }
 
-    void apply_selectors()
+    // The positions, in order, of the elements of the array with a member name that may
+    // equal value, or null if the array is not indexed by name
+    const std::vector<size_t>* find(const Json& array, const string_type& name, const Json& value) const
     {
-        if (selectors_.size() > 0)
+        static const std::vector<size_t> none;
+
+        if (name != name_)
         {
-            for (size_t i = 0; i < stack_.back().size(); ++i)
-            {
-                apply_selectors(stack_.back()[i].first, *(stack_.back()[i].second));
-            }
-            selectors_.clear();
+            return nullptr;
+        }
+        auto it = arrays_.find(std::addressof(array));
+        if (it == arrays_.end() || it->second.size != array.size())
+        {
+            return nullptr;
+        }
+        auto p = it->second.positions.find(hash_value(value));
+        return p != it->second.positions.end() ? &(p->second) : &none;
+    }
+private:
+    // Equal values have equal hashes, numbers are hashed by their double value
+    static size_t hash_value(const Json& val)
+    {
+        if (val.is_string())
+        {
+            return jsoncons::key_intern_table<string_type>::hash(val.as_string_view());
+        }
+        else if (val.is_number())
+        {
+            double d = val.as_double();
+            return d == 0 ? 0 : std::hash<double>()(d);
         }
+        else if (val.is_bool())
+        {
+            return val.as_bool() ? 1 : 2;
+        }
+        else if (val.is_null())
+        {
+            return 3;
+        }
+        return 4;
+    }
+};
+
+// A set of JSONPath expressions evaluated together against one root. The steps that
+// begin more than one expression, such as $.header in $.header.id and $.header.type,
+// are merged into a trie, and evaluated once for all of them. Steps with filters or
+// expressions in square brackets are shared only within one expression.
+
+template <class Json>
+class jsonpath_expression_set
+{
+public:
+    typedef typename Json::string_type string_type;
+    typedef typename Json::string_view_type string_view_type;
+private:
+    // Node 0 is the root, any other node is step step_index of expressions_[expression_index],
+    // from the nodes of its parent
+    struct trie_node
+    {
+        size_t expression_index;
+        size_t step_index;
+        std::vector<size_t> children;
+        std::vector<size_t> expressions;
+    };
+
+    std::vector<jsonpath_expression<Json>> expressions_;
+    std::vector<trie_node> nodes_;
+public:
+    jsonpath_expression_set()
+        : nodes_(1)
+    {
+    }
+
+    // Compiles path and adds it, returns its position in the set
+    size_t add(const string_view_type& path)
+    {
+        return add(compile<Json>(path));
     }
 
-    void apply_selectors(const string_type& path, reference val)
+    size_t add(const jsonpath_expression<Json>& expr)
     {
-        for (const auto& selector : selectors_)
+        size_t index = expressions_.size();
+        expressions_.push_back(expr);
+        if (!expr.has_root_)
         {
-            selector->select(path, val, nodes_, temp_json_values_);
+            return index;
         }
-        if (recursive_descent_)
+
+        size_t node = 0;
+        for (size_t i = 0; i < expr.steps_.size(); ++i)
         {
-            if (val.is_object())
+            size_t next = nodes_.size();
+            for (size_t child : nodes_[node].children)
             {
-                for (auto it = val.object_range().begin(); it != val.object_range().end(); ++it)
+                if (step(child).is_same(expr.steps_[i]))
                 {
-                    if (it->value().is_object() || it->value().is_array())
-                    {
-                        apply_selectors(path,it->value());
-                    }
+                    next = child;
+                    break;
                 }
             }
-            else if (val.is_array())
+            if (next == nodes_.size())
             {
-                for (auto it = val.array_range().begin(); it != val.array_range().end(); ++it)
-                {
-                    if (it->is_object() || it->is_array())
-                    {
-                        apply_selectors(path, *it);
-                    }
-                }
+                trie_node n;
+                n.expression_index = index;
+                n.step_index = i;
+                nodes_.push_back(std::move(n));
+                nodes_[node].children.push_back(next);
             }
+            node = next;
         }
+        nodes_[node].expressions.push_back(index);
+        return index;
     }
 
-    void transfer_nodes()
+    size_t size() const
     {
-        stack_.push_back(nodes_);
-        nodes_.clear();
-        recursive_descent_ = false;
+        return expressions_.size();
     }
 
-    size_t do_line_number() const override
+    // Returns an array of values or normalized paths for each expression, in the order
+    // they were added
+    std::vector<Json> evaluate(const Json& root, result_type result_t = result_type::value) const
     {
-        return line_;
+        std::vector<Json> results(expressions_.size(), Json(typename Json::array()));
+        detail::jsonpath_evaluator<Json> evaluator(root, result_t == result_type::path);
+        evaluator.select_root();
+        auto f = [&](size_t index, const detail::jsonpath_evaluator<Json>& e)
+        {
+            results[index] = result_t == result_type::value ? e.get_values() : e.get_normalized_paths();
+        };
+        visit(evaluator, 0, f);
+        return results;
     }
 
-    size_t do_column_number() const override
+    // Calls callback with the position of an expression and each value matching it, 
+    // without copying the values. Values that are not part of root, such as the length
+    // of an array, are valid until select returns
+    template <class Callback>
+    void select(const Json& root, Callback callback) const
     {
-        return column_;
+        detail::jsonpath_evaluator<Json> evaluator(root, false);
+        evaluator.select_root();
+        auto f = [&](size_t index, const detail::jsonpath_evaluator<Json>& e)
+        {
+            e.for_each_node([&](const Json& val){callback(index, val);});
+        };
+        visit(evaluator, 0, f);
+    }
+private:
+    const detail::path_step<Json>& step(size_t node) const
+    {
+        return expressions_[nodes_[node].expression_index].steps_[nodes_[node].step_index];
     }
 
+    // The evaluator holds the nodes selected by the steps to node
+    template <class F>
+    void visit(detail::jsonpath_evaluator<Json>& evaluator, size_t node, F& f) const
+    {
+        for (size_t index : nodes_[node].expressions)
+        {
+            f(index, evaluator);
+        }
+        if (nodes_[node].children.empty())
+        {
+            return;
+        }
+        auto selected = evaluator.selected();
+        for (size_t child : nodes_[node].children)
+        {
+            evaluator.selected(selected);
+            evaluator.evaluate(step(child));
+            visit(evaluator, child, f);
+        }
+    }
 };
 
+template<class Json>
+typename std::enable_if<!detail::is_encoded_view<Json>::value,Json>::type
+json_query(const Json& root, const typename Json::string_view_type& path, result_type result_t = result_type::value)
+{
+    return compile<Json>(path).evaluate(root, result_t);
+}
+
+// Queries a cbor_view or msgpack_view without decoding it, e.g. json_query(v, "$..id"),
+// or json_query<ojson>(v, "$..id") for the result as an ojson
+template<class Json = json, class View>
+typename std::enable_if<detail::is_encoded_view<View>::value,Json>::type
+json_query(const View& root, const typename View::string_view_type& path, result_type result_t = result_type::value)
+{
+    return compile<Json>(path).evaluate(root, result_t);
+}
+
+template<class Json, class T>
+void json_replace(Json& root, const typename Json::string_view_type& path, T&& new_value)
+{
+    compile<Json>(path).replace(root, std::forward<T>(new_value));
+}
+
+template<class Json, class Callback>
+void json_transform(Json& root, const typename Json::string_view_type& path, Callback callback)
+{
+    compile<Json>(path).transform(root, callback);
 }
 
 }}
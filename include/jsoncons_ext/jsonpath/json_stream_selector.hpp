@@ -0,0 +1,569 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSONPATH_JSON_STREAM_SELECTOR_HPP
+#define JSONCONS_JSONPATH_JSON_STREAM_SELECTOR_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_input_handler.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include "json_query.hpp"
+#include "jsonpath_error_category.hpp"
+
+namespace jsoncons { namespace jsonpath {
+
+namespace detail {
+
+// One step of a streaming path, matching the members or elements of a container,
+// or after "..", of a container and all its descendants
+
+template <class StringT>
+struct stream_step
+{
+    bool recursive_descent;
+    bool wildcard;
+    std::vector<StringT> names;
+    std::vector<size_t> indices;
+
+    stream_step()
+        : recursive_descent(false), wildcard(false)
+    {
+    }
+
+    bool is_same(const stream_step& other) const
+    {
+        return recursive_descent == other.recursive_descent && wildcard == other.wildcard &&
+               names == other.names && indices == other.indices;
+    }
+};
+
+}
+
+// Matches a JSONPath expression, or several, against parse events, and builds a Json
+// value of each matching subtree, so that only the matches are held in memory. Supports
+// the forward only part of JSONPath: names, wildcards and non-negative indices, in dot
+// or bracket notation, with unions and recursive descent. Matches are passed to the
+// callback in document order, a match nested in another after the outer one. The steps
+// that begin more than one of several paths are matched once for all of them.
+
+template <class Json>
+class json_stream_selector : public basic_json_input_handler<typename Json::char_type>
+{
+public:
+    typedef typename Json::char_type char_type;
+    typedef typename Json::string_type string_type;
+    using typename basic_json_input_handler<char_type>::string_view_type;
+    typedef std::function<void(const Json&)> callback_type;
+    typedef std::function<void(size_t,const Json&)> indexed_callback_type;
+private:
+    typedef detail::stream_step<string_type> step_type;
+
+    // Node 0 is the root, any other node matches step from the values its parent matches.
+    // paths are the positions of the paths that end at the node
+    struct node
+    {
+        step_type step;
+        std::vector<size_t> children;
+        std::vector<size_t> paths;
+    };
+
+    // The states of the children of a container are states_[states_begin] to the
+    // states_begin of the next frame, or the end of states_
+    struct frame
+    {
+        bool is_object;
+        size_t index;
+        size_t states_begin;
+    };
+
+    struct match
+    {
+        size_t depth;
+        size_t result_index;
+    };
+
+    std::vector<node> nodes_;
+    indexed_callback_type callback_;
+    std::vector<frame> frames_;
+    std::vector<size_t> states_;
+    string_type name_;
+    std::vector<match> matches_;
+    std::vector<std::unique_ptr<json_decoder<Json>>> decoders_;
+    std::vector<std::pair<size_t,Json>> results_;
+    std::vector<size_t> child_states_;
+    size_t paths_count_;
+
+    // Noncopyable and nonmoveable
+    json_stream_selector(const json_stream_selector&) = delete;
+    json_stream_selector& operator=(const json_stream_selector&) = delete;
+public:
+    json_stream_selector(const string_view_type& path, callback_type callback)
+        : nodes_(1), callback_([callback](size_t, const Json& val){callback(val);}), paths_count_(0)
+    {
+        add_path(path);
+    }
+
+    // Calls callback with the position of a path in paths and each value matching it
+    json_stream_selector(const std::vector<string_view_type>& paths, indexed_callback_type callback)
+        : nodes_(1), callback_(callback), paths_count_(0)
+    {
+        for (const auto& path : paths)
+        {
+            add_path(path);
+        }
+    }
+
+private:
+    void do_begin_json() override
+    {
+        frames_.clear();
+        states_.clear();
+        matches_.clear();
+        results_.clear();
+    }
+
+    void do_end_json() override
+    {
+    }
+
+    void do_begin_object(const parsing_context& context) override
+    {
+        begin_value(true, true);
+        for (size_t i = 0; i < matches_.size(); ++i)
+        {
+            decoders_[i]->begin_object(context);
+        }
+    }
+
+    void do_end_object(const parsing_context& context) override
+    {
+        for (size_t i = 0; i < matches_.size(); ++i)
+        {
+            decoders_[i]->end_object(context);
+        }
+        end_container();
+    }
+
+    void do_begin_array(const parsing_context& context) override
+    {
+        begin_value(true, false);
+        for (size_t i = 0; i < matches_.size(); ++i)
+        {
+            decoders_[i]->begin_array(context);
+        }
+    }
+
+    void do_end_array(const parsing_context& context) override
+    {
+        for (size_t i = 0; i < matches_.size(); ++i)
+        {
+            decoders_[i]->end_array(context);
+        }
+        end_container();
+    }
+
+    void do_name(const string_view_type& name, const parsing_context& context) override
+    {
+        name_.assign(name.data(), name.length());
+        for (size_t i = 0; i < matches_.size(); ++i)
+        {
+            decoders_[i]->name(name, context);
+        }
+    }
+
+    void do_string_value(const string_view_type& value, const parsing_context& context) override
+    {
+        begin_value(false, false);
+        for (size_t i = 0; i < matches_.size(); ++i)
+        {
+            decoders_[i]->string_value(value, context);
+        }
+        end_scalar();
+    }
+
+    void do_byte_string_value(const uint8_t* data, size_t length, const parsing_context& context) override
+    {
+        begin_value(false, false);
+        for (size_t i = 0; i < matches_.size(); ++i)
+        {
+            decoders_[i]->byte_string_value(data, length, context);
+        }
+        end_scalar();
+    }
+
+    void do_double_value(double value, uint8_t precision, const parsing_context& context) override
+    {
+        begin_value(false, false);
+        for (size_t i = 0; i < matches_.size(); ++i)
+        {
+            decoders_[i]->double_value(value, precision, context);
+        }
+        end_scalar();
+    }
+
+    void do_integer_value(int64_t value, const parsing_context& context) override
+    {
+        begin_value(false, false);
+        for (size_t i = 0; i < matches_.size(); ++i)
+        {
+            decoders_[i]->integer_value(value, context);
+        }
+        end_scalar();
+    }
+
+    void do_uinteger_value(uint64_t value, const parsing_context& context) override
+    {
+        begin_value(false, false);
+        for (size_t i = 0; i < matches_.size(); ++i)
+        {
+            decoders_[i]->uinteger_value(value, context);
+        }
+        end_scalar();
+    }
+
+    void do_bool_value(bool value, const parsing_context& context) override
+    {
+        begin_value(false, false);
+        for (size_t i = 0; i < matches_.size(); ++i)
+        {
+            decoders_[i]->bool_value(value, context);
+        }
+        end_scalar();
+    }
+
+    void do_null_value(const parsing_context& context) override
+    {
+        begin_value(false, false);
+        for (size_t i = 0; i < matches_.size(); ++i)
+        {
+            decoders_[i]->null_value(context);
+        }
+        end_scalar();
+    }
+
+    // A state of a value is 2*n for the node n it matches, or 2*n + 1 when it is a
+    // descendant of a value that matches n, and may only match the children of n that
+    // follow "..". A value that matches a node at the end of a path is a match, and
+    // begins a decoder, which is then sent the events of the value along with those of
+    // any enclosing match.
+    void begin_value(bool is_container, bool is_object)
+    {
+        child_states_.clear();
+        if (frames_.empty())
+        {
+            child_states_.push_back(0);
+        }
+        else
+        {
+            frame& parent = frames_.back();
+            size_t index = parent.index++;
+            for (size_t i = parent.states_begin; i < states_.size(); ++i)
+            {
+                size_t n = states_[i] / 2;
+                bool descendant = states_[i] % 2 != 0;
+                for (size_t child : nodes_[n].children)
+                {
+                    const step_type& step = nodes_[child].step;
+                    if (step.recursive_descent)
+                    {
+                        add_state(2*n + 1);
+                    }
+                    else if (descendant)
+                    {
+                        continue;
+                    }
+                    if (step.wildcard ||
+                        (parent.is_object && std::find(step.names.begin(), step.names.end(), name_) != step.names.end()) ||
+                        (!parent.is_object && std::find(step.indices.begin(), step.indices.end(), index) != step.indices.end()))
+                    {
+                        add_state(2*child);
+                    }
+                }
+            }
+        }
+
+        for (size_t state : child_states_)
+        {
+            if (state % 2 == 0 && !nodes_[state / 2].paths.empty())
+            {
+                begin_match(state / 2);
+            }
+        }
+        if (is_container)
+        {
+            frame f;
+            f.is_object = is_object;
+            f.index = 0;
+            f.states_begin = states_.size();
+            frames_.push_back(f);
+            states_.insert(states_.end(), child_states_.begin(), child_states_.end());
+        }
+    }
+
+    void add_state(size_t k)
+    {
+        if (std::find(child_states_.begin(), child_states_.end(), k) == child_states_.end())
+        {
+            child_states_.push_back(k);
+        }
+    }
+
+    void begin_match(size_t n)
+    {
+        if (decoders_.size() == matches_.size())
+        {
+            decoders_.push_back(std::unique_ptr<json_decoder<Json>>(new json_decoder<Json>()));
+        }
+        json_decoder<Json>& decoder = *decoders_[matches_.size()];
+        decoder.reset();
+        decoder.begin_json();
+
+        match m;
+        m.depth = frames_.size();
+        m.result_index = results_.size();
+        matches_.push_back(m);
+        results_.emplace_back(n, Json());
+    }
+
+    void end_container()
+    {
+        states_.resize(frames_.back().states_begin);
+        frames_.pop_back();
+        end_matches();
+    }
+
+    void end_scalar()
+    {
+        end_matches();
+    }
+
+    void end_matches()
+    {
+        while (!matches_.empty() && matches_.back().depth == frames_.size())
+        {
+            json_decoder<Json>& decoder = *decoders_[matches_.size()-1];
+            decoder.end_json();
+            results_[matches_.back().result_index].second = decoder.get_result();
+            matches_.pop_back();
+        }
+        if (matches_.empty() && !results_.empty())
+        {
+            for (const auto& result : results_)
+            {
+                for (size_t path_index : nodes_[result.first].paths)
+                {
+                    callback_(path_index, result.second);
+                }
+            }
+            results_.clear();
+        }
+    }
+
+    // Adds the steps of the path to the nodes, as the children of the nodes of the steps
+    // before them
+    void add_path(const string_view_type& path)
+    {
+        std::vector<step_type> steps;
+        parse_path(path, steps);
+
+        size_t n = 0;
+        for (auto& step : steps)
+        {
+            size_t next = nodes_.size();
+            for (size_t child : nodes_[n].children)
+            {
+                if (nodes_[child].step.is_same(step))
+                {
+                    next = child;
+                    break;
+                }
+            }
+            if (next == nodes_.size())
+            {
+                nodes_.emplace_back();
+                nodes_.back().step = std::move(step);
+                nodes_[n].children.push_back(next);
+            }
+            n = next;
+        }
+        nodes_[n].paths.push_back(paths_count_++);
+    }
+
+    void parse_path(const string_view_type& path, std::vector<step_type>& steps)
+    {
+        const char_type* begin = path.data();
+        const char_type* end = path.data() + path.length();
+        const char_type* p = begin;
+
+        while (p < end && (*p == ' ' || *p == '\t'))
+        {
+            ++p;
+        }
+        if (p == end || (*p != '$' && *p != '@'))
+        {
+            throw parse_error(jsonpath_parser_errc::expected_root,1,static_cast<size_t>(p-begin+1));
+        }
+        ++p;
+        while (p < end)
+        {
+            step_type step;
+            if (*p == '.')
+            {
+                ++p;
+                if (p < end && *p == '.')
+                {
+                    step.recursive_descent = true;
+                    ++p;
+                }
+                if (p < end && *p == '[')
+                {
+                    p = parse_bracket(begin, p, end, step);
+                }
+                else if (p < end && *p == '*')
+                {
+                    step.wildcard = true;
+                    ++p;
+                }
+                else
+                {
+                    const char_type* name = p;
+                    while (p < end && *p != '.' && *p != '[')
+                    {
+                        ++p;
+                    }
+                    if (p == name)
+                    {
+                        throw parse_error(jsonpath_parser_errc::expected_name,1,static_cast<size_t>(p-begin+1));
+                    }
+                    add_name(string_type(name,p), step);
+                }
+            }
+            else if (*p == '[')
+            {
+                p = parse_bracket(begin, p, end, step);
+            }
+            else if (*p == ' ' || *p == '\t')
+            {
+                ++p;
+                continue;
+            }
+            else
+            {
+                throw parse_error(jsonpath_parser_errc::expected_separator,1,static_cast<size_t>(p-begin+1));
+            }
+            steps.push_back(std::move(step));
+        }
+    }
+
+    // Parses the comma separated items inside square brackets, *, quoted names or
+    // unquoted names and indices
+    const char_type* parse_bracket(const char_type* begin, const char_type* p, const char_type* end, step_type& step)
+    {
+        ++p;
+        bool done = false;
+        while (!done)
+        {
+            while (p < end && (*p == ' ' || *p == '\t'))
+            {
+                ++p;
+            }
+            if (p == end)
+            {
+                throw parse_error(jsonpath_parser_errc::expected_right_bracket,1,static_cast<size_t>(p-begin+1));
+            }
+            switch (*p)
+            {
+            case '*':
+                step.wildcard = true;
+                ++p;
+                break;
+            case '\'':
+            case '\"':
+                {
+                    char_type quote = *p++;
+                    string_type name;
+                    while (p < end && *p != quote)
+                    {
+                        if (*p == '\\' && p+1 < end)
+                        {
+                            ++p;
+                        }
+                        name.push_back(*p++);
+                    }
+                    if (p == end)
+                    {
+                        throw parse_error(jsonpath_parser_errc::expected_right_bracket,1,static_cast<size_t>(p-begin+1));
+                    }
+                    ++p;
+                    add_name(name, step);
+                }
+                break;
+            case '?':
+            case '(':
+            case ':':
+            case '-':
+                throw parse_error(jsonpath_parser_errc::unsupported_in_stream,1,static_cast<size_t>(p-begin+1));
+            default:
+                {
+                    const char_type* name = p;
+                    while (p < end && *p != ',' && *p != ']' && *p != ' ' && *p != '\t')
+                    {
+                        if (*p == ':')
+                        {
+                            throw parse_error(jsonpath_parser_errc::unsupported_in_stream,1,static_cast<size_t>(p-begin+1));
+                        }
+                        ++p;
+                    }
+                    add_name(string_type(name,p), step);
+                }
+                break;
+            }
+            while (p < end && (*p == ' ' || *p == '\t'))
+            {
+                ++p;
+            }
+            if (p == end)
+            {
+                throw parse_error(jsonpath_parser_errc::expected_right_bracket,1,static_cast<size_t>(p-begin+1));
+            }
+            switch (*p)
+            {
+            case ',':
+                ++p;
+                break;
+            case ']':
+                ++p;
+                done = true;
+                break;
+            default:
+                throw parse_error(jsonpath_parser_errc::expected_right_bracket,1,static_cast<size_t>(p-begin+1));
+            }
+        }
+        return p;
+    }
+
+    // A name matches a member, and if it is a non-negative integer, also an element
+    static void add_name(const string_type& name, step_type& step)
+    {
+        size_t index = 0;
+        bool positive = true;
+        if (detail::try_string_to_index(name.data(), name.size(), &index, &positive) && positive)
+        {
+            step.indices.push_back(index);
+        }
+        step.names.push_back(name);
+    }
+};
+
+}}
+
+#endif
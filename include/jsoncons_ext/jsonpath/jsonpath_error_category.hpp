@@ -26,7 +26,8 @@ enum class jsonpath_parser_errc
     invalid_filter_expected_primary = 10,
     expected_index = 11,
     expected_left_bracket_token = 12,
-    unexpected_operator = 13
+    unexpected_operator = 13,
+    unsupported_in_stream = 14
 };
 
 class jsonpath_error_category_impl
@@ -65,6 +66,8 @@ public:
             return "Invalid path filter, expected primary expression.";
         case jsonpath_parser_errc::expected_left_bracket_token:
             return "Expected ?,',\",0-9,*";
+        case jsonpath_parser_errc::unsupported_in_stream:
+            return "Filters, slices and negative indices are not supported by a streaming selector";
         default:
             return "Unknown jsonpath parser error";
         }
@@ -16,11 +16,18 @@
 #include <memory>
 #include <regex>
 #include <functional>
+#include <mutex>
+#include <deque>
 #include <cmath> 
 #include <jsoncons/json.hpp>
 #include "jsonpath_error_category.hpp"
 
-namespace jsoncons { namespace jsonpath { namespace detail {
+namespace jsoncons { namespace jsonpath {
+
+template <class Json>
+class jsonpath_expression;
+
+namespace detail {
 
 JSONCONS_DEFINE_LITERAL(eqtilde_literal,"=~");
 JSONCONS_DEFINE_LITERAL(star_literal,"*");
@@ -47,20 +54,15 @@ struct PathConstructor
 
     string_type operator()(const string_type& path, size_t index) const
     {
-        char_type buf[255];
-        char_type* p = buf;
-        do
-        {
-            *p++ = static_cast<char_type>(48 + index % 10);
-        } while (index /= 10);
+        char_type buf[max_integer_chars];
+        char_type* last = buf + max_integer_chars;
+        char_type* first = format_uinteger(index, last);
 
         string_type s;
+        s.reserve(path.length() + (last - first) + 2);
         s.append(path);
         s.push_back('[');
-        while (--p >= buf)
-        {
-            s.push_back(*p);
-        }
+        s.append(first, last);
         s.push_back(']');
         return s;
     }
@@ -78,28 +80,8 @@ struct PathConstructor
     }
 };
 
-template<class Json>
-struct VoidPathConstructor
-{
-    typedef typename Json::char_type char_type;
-    typedef typename Json::string_view_type string_view_type;
-    typedef typename Json::string_type string_type;
-
-    string_type operator()(const string_type&, size_t) const
-    {
-        return string_type{};
-    }
-
-    string_type operator()(const string_type&, string_view_type) const
-    {
-        return string_type{};
-    }
-};
-
-template <class Json,
-          class JsonReference,
-          class PathCons>
-class jsonpath_evaluator;
+template <class Json>
+class jsonpath_compiler;
 
 enum class filter_state
 {
@@ -130,6 +112,23 @@ enum class token_type
     rparen
 };
 
+// The operators that a jsonpath_filter_expr evaluates directly against the
+// nodes of the context node
+enum class filter_op
+{
+    none,
+    exclaim,
+    lt,
+    lte,
+    gt,
+    gte,
+    eq,
+    ne,
+    eqtilde,
+    ampamp,
+    pipepipe
+};
+
 template <class Json>
 class term
 {
@@ -139,9 +138,38 @@ public:
 
     virtual ~term() {}
 
-    virtual void initialize(const Json&)
+    // The term with the values of its paths, for an evaluation against a root
+    // and a context node, or null if it has none
+    virtual std::shared_ptr<term<Json>> bind(const Json&, const Json&) const
+    {
+        return std::shared_ptr<term<Json>>();
+    }
+
+    // The value of a literal, or null
+    virtual const Json* literal() const
+    {
+        return nullptr;
+    }
+
+    // The member names of a path that selects at most one member of the context
+    // node, or null
+    virtual const std::vector<string_type>* member_names() const
     {
+        return nullptr;
     }
+
+    // The pattern of a regular expression, or null
+    virtual const std::basic_regex<char_type>* regex() const
+    {
+        return nullptr;
+    }
+
+    // True if binding the term reads the root, not only the context node
+    virtual bool uses_root() const
+    {
+        return false;
+    }
+
     virtual bool accept_single_node() const
     {
         throw parse_error(jsonpath_parser_errc::invalid_filter_unsupported_operator,1,1);
@@ -174,7 +202,7 @@ public:
     {
         throw parse_error(jsonpath_parser_errc::invalid_filter_unsupported_operator,1,1);
     }
-    virtual bool regex2(const string_type&) const
+    virtual bool regex2(const Json&) const
     {
         throw parse_error(jsonpath_parser_errc::invalid_filter_unsupported_operator,1,1);
     }
@@ -269,6 +297,7 @@ struct operator_properties
     size_t precedence_level;
     bool is_right_associative;
     operator_type op;
+    filter_op code;
 };
 
 template <class Json>
@@ -289,6 +318,7 @@ class token
     size_t precedence_level_;
     bool is_right_associative_;
     bool is_aggregate_;
+    filter_op code_;
     std::shared_ptr<term<Json>> operand_ptr_;
     std::function<Json(const term<Json>&)> unary_operator_;
     std::function<Json(const term<Json>&, const term<Json>&)> operator_;
@@ -296,31 +326,33 @@ public:
     typedef std::function<Json(const term<Json>&)> unary_operator_type;
     typedef std::function<Json(const term<Json>&, const term<Json>&)> operator_type;
 
-    Json operator()(const term<Json>& a)
+    Json operator()(const term<Json>& a) const
     {
         return unary_operator_(a);
     }
 
-    Json operator()(const term<Json>& a, const term<Json>& b)
+    Json operator()(const term<Json>& a, const term<Json>& b) const
     {
         return operator_(a,b);
     }
 
     token(token_type type)
-        : type_(type),precedence_level_(0),is_right_associative_(false),is_aggregate_(false)
+        : type_(type),precedence_level_(0),is_right_associative_(false),is_aggregate_(false),code_(filter_op::none)
     {
     }
     token(token_type type, std::shared_ptr<term<Json>> term_ptr)
-        : type_(type),precedence_level_(0),is_right_associative_(false),is_aggregate_(false),operand_ptr_(term_ptr)
+        : type_(type),precedence_level_(0),is_right_associative_(false),is_aggregate_(false),code_(filter_op::none),operand_ptr_(term_ptr)
     {
     }
     token(size_t precedence_level, 
           bool is_right_associative,
-          std::function<Json(const term<Json>&)> unary_operator)
+          std::function<Json(const term<Json>&)> unary_operator,
+          filter_op code = filter_op::none)
         : type_(token_type::unary_operator), 
           precedence_level_(precedence_level), 
           is_right_associative_(is_right_associative),
           is_aggregate_(false), 
+          code_(code),
           unary_operator_(unary_operator)
     {
     }
@@ -329,6 +361,7 @@ public:
           precedence_level_(properties.precedence_level), 
           is_right_associative_(properties.is_right_associative),
           is_aggregate_(false), 
+          code_(properties.code),
           operator_(properties.op)
     {
     }
@@ -337,6 +370,7 @@ public:
           precedence_level_(properties.precedence_level), 
           is_right_associative_(properties.is_right_associative), 
           is_aggregate_(properties.is_aggregate),
+          code_(filter_op::none),
           unary_operator_(properties.op)
     {
     }
@@ -391,18 +425,28 @@ public:
         return is_aggregate_;
     }
 
-    const term<Json>& operand()
+    filter_op code() const
+    {
+        return code_;
+    }
+
+    const term<Json>& operand() const
     {
         JSONCONS_ASSERT(type_ == token_type::operand && operand_ptr_ != nullptr);
         return *operand_ptr_;
     }
 
-    void initialize(const Json& context_node)
+    token<Json> bind(const Json& root, const Json& context_node) const
     {
         if (operand_ptr_.get() != nullptr)
         {
-            operand_ptr_->initialize(context_node);
+            auto term_ptr = operand_ptr_->bind(root, context_node);
+            if (term_ptr.get() != nullptr)
+            {
+                return token<Json>(token_type::operand, term_ptr);
+            }
         }
+        return *this;
     }
 };
 
@@ -549,6 +593,11 @@ public:
     {
     }
 
+    const Json* literal() const override
+    {
+        return std::addressof(value_);
+    }
+
     bool accept_single_node() const override
     {
         return value_.as_bool();
@@ -584,7 +633,7 @@ public:
     }
     Json regex_term(const term<Json>& rhs) const override
     {
-        return rhs.regex2(value_.as_string());
+        return rhs.regex2(value_);
     }
     bool ampamp_term(const term<Json>& rhs) const override
     {
@@ -674,42 +723,150 @@ public:
     }
 };
 
+// Compiled regular expressions, shared by the filters that use the same pattern and
+// flags, so that json_query does not compile a pattern each time it parses a path.
+// The cache holds up to capacity patterns, and forgets the oldest first.
+
+template <class CharT>
+class regex_cache
+{
+public:
+    typedef std::basic_string<CharT> string_type;
+    typedef std::basic_regex<CharT> regex_type;
+
+    static const size_t capacity = 128;
+private:
+    typedef std::pair<string_type,std::regex::flag_type> key_type;
+
+    std::mutex mutex_;
+    std::map<key_type,std::shared_ptr<const regex_type>> patterns_;
+    std::deque<key_type> order_;
+public:
+    static regex_cache<CharT>& instance()
+    {
+        static regex_cache<CharT> cache;
+        return cache;
+    }
+
+    std::shared_ptr<const regex_type> get(const string_type& pattern, std::regex::flag_type flags)
+    {
+        key_type key(pattern,flags);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = patterns_.find(key);
+            if (it != patterns_.end())
+            {
+                return it->second;
+            }
+        }
+
+        // Compiled without the lock, a pattern compiled twice at once is kept once
+        auto re = std::make_shared<const regex_type>(pattern,flags);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto result = patterns_.insert(std::make_pair(key,re));
+        if (result.second)
+        {
+            order_.push_back(key);
+            if (order_.size() > capacity)
+            {
+                patterns_.erase(order_.front());
+                order_.pop_front();
+            }
+        }
+        return result.first->second;
+    }
+};
+
+// Matches a string value as it is, and other values as their JSON text
+template <class Json>
+bool regex_match_value(const Json& val, const std::basic_regex<typename Json::char_type>& pattern)
+{
+    if (val.is_string())
+    {
+        auto sv = val.as_string_view();
+        return std::regex_match(sv.data(), sv.data() + sv.length(), pattern);
+    }
+    return std::regex_match(val.as_string(), pattern);
+}
+
 template <class Json>
 class regex_term : public term<Json>
 {
     typedef typename Json::char_type char_type;
     typedef typename Json::string_type string_type;
-    const std::basic_regex<char_type> pattern_;
+    std::shared_ptr<const std::basic_regex<char_type>> pattern_;
 public:
     regex_term(const string_type& pattern, std::regex::flag_type flags)
-        : pattern_(pattern,flags)
+        : pattern_(regex_cache<char_type>::instance().get(pattern,flags))
     {
     }
 
-    bool regex2(const string_type& subject) const override
+    const std::basic_regex<char_type>* regex() const override
     {
-        return std::regex_match(subject, pattern_);
+        return pattern_.get();
+    }
+
+    bool regex2(const Json& subject) const override
+    {
+        return regex_match_value(subject, *pattern_);
     }
 };
 
+// The argument of an aggregate function, a path evaluated against the root
+
+template <class Json>
+class aggregate_argument_term : public term<Json>
+{
+    std::shared_ptr<const jsonpath_expression<Json>> path_;
+public:
+    aggregate_argument_term(std::shared_ptr<const jsonpath_expression<Json>> path)
+        : path_(path)
+    {
+    }
+
+    std::shared_ptr<term<Json>> bind(const Json& root, const Json&) const override
+    {
+        return std::make_shared<value_term<Json>>(path_->evaluate(root));
+    }
+
+    bool uses_root() const override
+    {
+        return true;
+    }
+};
+
+// A path evaluated against the context node. The compiled path is shared with
+// the bound terms, which hold the selected values
+
 template <class Json>
 class path_term : public term<Json>
 {
     typedef typename Json::string_type string_type;
 
-    string_type path_;
+    std::shared_ptr<const jsonpath_expression<Json>> path_;
     Json nodes_;
+    std::vector<string_type> member_names_;
+    bool is_member_path_;
 public:
-    path_term(const string_type& path)
-        : path_(path)
+    path_term(std::shared_ptr<const jsonpath_expression<Json>> path)
+        : path_(path), is_member_path_(path_->member_names(member_names_))
+    {
+    }
+
+    path_term(std::shared_ptr<const jsonpath_expression<Json>> path, Json&& nodes)
+        : path_(path), nodes_(std::move(nodes)), is_member_path_(false)
     {
     }
 
-    void initialize(const Json& context_node) override
+    const std::vector<string_type>* member_names() const override
     {
-        jsonpath_evaluator<Json,const Json&,VoidPathConstructor<Json>> evaluator;
-        evaluator.evaluate(context_node,path_);
-        nodes_ = evaluator.get_values();
+        return is_member_path_ ? &member_names_ : nullptr;
+    }
+
+    std::shared_ptr<term<Json>> bind(const Json&, const Json& context_node) const override
+    {
+        return std::make_shared<path_term<Json>>(path_, path_->evaluate(context_node));
     }
 
     bool accept_single_node() const override
@@ -790,7 +947,7 @@ public:
             result = true;
             for (size_t i = 0; result && i < nodes_.size(); ++i)
             {
-                result = rhs.regex2(nodes_[i].as_string());
+                result = rhs.regex2(nodes_[i]);
             }
         }
         return result;
@@ -966,18 +1123,14 @@ public:
 };
 
 template <class Json>
-token<Json> evaluate(const Json& context, std::vector<token<Json>>& tokens)
+token<Json> evaluate(const Json& root, const Json& context, const std::vector<token<Json>>& tokens)
 {
-    for (auto it= tokens.begin(); it != tokens.end(); ++it)
-    {
-        it->initialize(context);
-    }
     std::vector<token<Json>> stack;
-    for (auto t : tokens)
+    for (const auto& t : tokens)
     {
         if (t.is_operand())
         {
-            stack.push_back(t);
+            stack.push_back(t.bind(root, context));
         }
         else if (t.is_unary_operator())
         {
@@ -1004,25 +1157,56 @@ token<Json> evaluate(const Json& context, std::vector<token<Json>>& tokens)
     return stack.back();
 }
 
+// A node of a compiled filter: a path, a literal, a regular expression, the comparison
+// of a path with a literal, the match of a path with a regular expression, or the !,
+// && or || of other nodes
+
+template <class Json>
+struct filter_node
+{
+    filter_op op;
+    const std::vector<typename Json::string_type>* names;
+    const Json* value;
+    const std::basic_regex<typename Json::char_type>* pattern;
+    bool path_on_left;
+    size_t lhs;
+    size_t rhs;
+};
+
+// A filter made only of comparisons of member paths such as @.price with literals, and
+// matches of them with regular expressions, combined with !, && and ||, is also compiled
+// to a tree of filter_node, that evaluates by looking up the members of the context node,
+// without binding terms or making temporary values, and that stops at the first operand
+// of && or || that decides the result. Other filters, and context nodes with an array or
+// string on a path, where a name may be an index or length, are evaluated by tokens.
+
 template <class Json>
 class jsonpath_filter_expr
 {
 public:
+    typedef typename Json::string_type string_type;
+
     std::vector<token<Json>> tokens_;
     size_t line_;
     size_t column_;
+private:
+    std::vector<filter_node<Json>> nodes_;
 public:
 
     jsonpath_filter_expr(const std::vector<token<Json>>& tokens, size_t line, size_t column)
         : tokens_(tokens), line_(line), column_(column)
     {
+        if (!compile_nodes())
+        {
+            nodes_.clear();
+        }
     }
 
-    Json eval(const Json& context_node)
+    Json eval(const Json& root, const Json& context_node) const
     {
         try
         {
-            auto t = evaluate(context_node,tokens_);
+            auto t = evaluate(root,context_node,tokens_);
 
             return t.operand().evaluate_single_node();
 
@@ -1033,11 +1217,20 @@ public:
         }
     }
 
-    bool exists(const Json& context_node)
+    bool exists(const Json& root, const Json& context_node) const
     {
+        if (nodes_.size() > 0)
+        {
+            bool resolved = true;
+            bool result = evaluate_node(nodes_.back(), context_node, resolved);
+            if (resolved)
+            {
+                return result;
+            }
+        }
         try
         {
-            auto t = evaluate(context_node,tokens_);
+            auto t = evaluate(root,context_node,tokens_);
             return t.operand().accept_single_node();
         }
         catch (const parse_error& e)
@@ -1045,6 +1238,208 @@ public:
             throw parse_error(e.code(),line_,column_);
         }
     }
+
+    // The context node is also the root
+    Json eval(const Json& context_node) const
+    {
+        return eval(context_node,context_node);
+    }
+
+    bool exists(const Json& context_node) const
+    {
+        return exists(context_node,context_node);
+    }
+    // True if evaluating the filter reads the root, as the argument of an aggregate
+    // function does, not only the context node
+    bool uses_root() const
+    {
+        for (const auto& t : tokens_)
+        {
+            if (t.is_operand() && t.operand().uses_root())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // True if the filter compares one member of the context node with a literal for
+    // equality, as in @.id == 12345, with name and value set to the member name and
+    // the literal
+    bool member_equality(const string_type*& name, const Json*& value) const
+    {
+        if (nodes_.size() == 3 && nodes_.back().op == filter_op::eq && nodes_.back().names->size() == 1)
+        {
+            name = &nodes_.back().names->front();
+            value = nodes_.back().value;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    bool compile_nodes()
+    {
+        std::vector<size_t> stack;
+        for (const auto& t : tokens_)
+        {
+            if (t.is_operand())
+            {
+                filter_node<Json> node = {filter_op::none, t.operand().member_names(), t.operand().literal(), t.operand().regex(), false, 0, 0};
+                if (node.names == nullptr && node.value == nullptr && node.pattern == nullptr)
+                {
+                    return false;
+                }
+                stack.push_back(nodes_.size());
+                nodes_.push_back(node);
+            }
+            else if (t.is_unary_operator())
+            {
+                if (t.code() != filter_op::exclaim || stack.empty() || !(is_path(stack.back()) || is_condition(stack.back())))
+                {
+                    return false;
+                }
+                filter_node<Json> node = {filter_op::exclaim, nullptr, nullptr, nullptr, false, stack.back(), 0};
+                stack.back() = nodes_.size();
+                nodes_.push_back(node);
+            }
+            else if (t.is_binary_operator())
+            {
+                if (t.code() == filter_op::none || stack.size() < 2)
+                {
+                    return false;
+                }
+                size_t rhs = stack.back();
+                stack.pop_back();
+                size_t lhs = stack.back();
+
+                filter_node<Json> node = {t.code(), nullptr, nullptr, nullptr, false, lhs, rhs};
+                if (t.code() == filter_op::ampamp || t.code() == filter_op::pipepipe)
+                {
+                    if (!is_condition(lhs) || !is_condition(rhs))
+                    {
+                        return false;
+                    }
+                }
+                else if (t.code() == filter_op::eqtilde)
+                {
+                    if (!is_path(lhs) || nodes_[rhs].op != filter_op::none || nodes_[rhs].pattern == nullptr)
+                    {
+                        return false;
+                    }
+                    node.names = nodes_[lhs].names;
+                    node.pattern = nodes_[rhs].pattern;
+                }
+                else if (is_path(lhs) && is_literal(rhs))
+                {
+                    node.names = nodes_[lhs].names;
+                    node.value = nodes_[rhs].value;
+                    node.path_on_left = true;
+                }
+                else if (is_literal(lhs) && is_path(rhs))
+                {
+                    node.names = nodes_[rhs].names;
+                    node.value = nodes_[lhs].value;
+                }
+                else
+                {
+                    return false;
+                }
+                stack.back() = nodes_.size();
+                nodes_.push_back(node);
+            }
+        }
+        return stack.size() == 1 && (is_path(stack.back()) || is_condition(stack.back()));
+    }
+
+    bool is_path(size_t i) const
+    {
+        return nodes_[i].op == filter_op::none && nodes_[i].names != nullptr;
+    }
+
+    bool is_literal(size_t i) const
+    {
+        return nodes_[i].op == filter_op::none && nodes_[i].value != nullptr;
+    }
+
+    bool is_condition(size_t i) const
+    {
+        return nodes_[i].op != filter_op::none;
+    }
+
+    // The member at the path, or null if there is none. Sets resolved to false if the
+    // path reaches an array or string
+    static const Json* find_member(const std::vector<string_type>& names, const Json& context_node, bool& resolved)
+    {
+        const Json* p = std::addressof(context_node);
+        for (const auto& name : names)
+        {
+            if (p->is_object())
+            {
+                auto it = p->find(name);
+                if (it == p->object_range().end())
+                {
+                    return nullptr;
+                }
+                p = std::addressof(it->value());
+            }
+            else
+            {
+                if (p->is_array() || p->is_string())
+                {
+                    resolved = false;
+                }
+                return nullptr;
+            }
+        }
+        return p;
+    }
+
+    bool evaluate_node(const filter_node<Json>& node, const Json& context_node, bool& resolved) const
+    {
+        switch (node.op)
+        {
+        case filter_op::none:
+            return find_member(*node.names, context_node, resolved) != nullptr;
+        case filter_op::exclaim:
+            return !evaluate_node(nodes_[node.lhs], context_node, resolved);
+        case filter_op::ampamp:
+            return evaluate_node(nodes_[node.lhs], context_node, resolved) && evaluate_node(nodes_[node.rhs], context_node, resolved);
+        case filter_op::pipepipe:
+            return evaluate_node(nodes_[node.lhs], context_node, resolved) || evaluate_node(nodes_[node.rhs], context_node, resolved);
+        default:
+            break;
+        }
+
+        const Json* p = find_member(*node.names, context_node, resolved);
+        if (p == nullptr)
+        {
+            return false;
+        }
+        if (node.op == filter_op::eqtilde)
+        {
+            return regex_match_value(*p, *node.pattern);
+        }
+        const Json& lhs = node.path_on_left ? *p : *node.value;
+        const Json& rhs = node.path_on_left ? *node.value : *p;
+        switch (node.op)
+        {
+        case filter_op::lt:
+            return jsoncons::jsonpath::detail::lt(lhs,rhs);
+        case filter_op::lte:
+            return jsoncons::jsonpath::detail::lt(lhs,rhs) || lhs == rhs;
+        case filter_op::gt:
+            return jsoncons::jsonpath::detail::gt(lhs,rhs);
+        case filter_op::gte:
+            return jsoncons::jsonpath::detail::gt(lhs,rhs) || lhs == rhs;
+        case filter_op::eq:
+            return lhs == rhs;
+        case filter_op::ne:
+            return lhs != rhs;
+        default:
+            return false;
+        }
+    }
 };
 
 template <class Json>
@@ -1125,19 +1520,19 @@ class jsonpath_filter_parser
 
         const binary_operator_map operators =
         {
-            {eqtilde_literal<char_type>(),{2,false,[](const term<Json>& a, const term<Json>& b) {return a.regex_term(b); }}},
-            {star_literal<char_type>(),{3,false,[](const term<Json>& a, const term<Json>& b) {return a.mult_term(b); }}},
-            {forwardslash_literal<char_type>(),{3,false,[](const term<Json>& a, const term<Json>& b) {return a.div_term(b); }}},
-            {plus_literal<char_type>(),{4,false,[](const term<Json>& a, const term<Json>& b) {return a.plus_term(b); }}},
-            {minus_literal<char_type>(),{4,false,[](const term<Json>& a, const term<Json>& b) {return a.minus_term(b); }}},
-            {lt_literal<char_type>(),{5,false,[](const term<Json>& a, const term<Json>& b) {return a.lt_term(b); }}},
-            {lte_literal<char_type>(),{5,false,[](const term<Json>& a, const term<Json>& b) {return a.lt_term(b) || a.eq_term(b); }}},
-            {gt_literal<char_type>(),{5,false,[](const term<Json>& a, const term<Json>& b) {return a.gt_term(b); }}},
-            {gte_literal<char_type>(),{5,false,[](const term<Json>& a, const term<Json>& b) {return a.gt_term(b) || a.eq_term(b); }}},
-            {eq_literal<char_type>(),{6,false,[](const term<Json>& a, const term<Json>& b) {return a.eq_term(b); }}},
-            {ne_literal<char_type>(),{6,false,[](const term<Json>& a, const term<Json>& b) {return a.ne_term(b); }}},
-            {ampamp_literal<char_type>(),{7,false,[](const term<Json>& a, const term<Json>& b) {return a.ampamp_term(b); }}},
-            {pipepipe_literal<char_type>(),{8,false,[](const term<Json>& a, const term<Json>& b) {return a.pipepipe_term(b); }}}
+            {eqtilde_literal<char_type>(),{2,false,[](const term<Json>& a, const term<Json>& b) {return a.regex_term(b); },filter_op::eqtilde}},
+            {star_literal<char_type>(),{3,false,[](const term<Json>& a, const term<Json>& b) {return a.mult_term(b); },filter_op::none}},
+            {forwardslash_literal<char_type>(),{3,false,[](const term<Json>& a, const term<Json>& b) {return a.div_term(b); },filter_op::none}},
+            {plus_literal<char_type>(),{4,false,[](const term<Json>& a, const term<Json>& b) {return a.plus_term(b); },filter_op::none}},
+            {minus_literal<char_type>(),{4,false,[](const term<Json>& a, const term<Json>& b) {return a.minus_term(b); },filter_op::none}},
+            {lt_literal<char_type>(),{5,false,[](const term<Json>& a, const term<Json>& b) {return a.lt_term(b); },filter_op::lt}},
+            {lte_literal<char_type>(),{5,false,[](const term<Json>& a, const term<Json>& b) {return a.lt_term(b) || a.eq_term(b); },filter_op::lte}},
+            {gt_literal<char_type>(),{5,false,[](const term<Json>& a, const term<Json>& b) {return a.gt_term(b); },filter_op::gt}},
+            {gte_literal<char_type>(),{5,false,[](const term<Json>& a, const term<Json>& b) {return a.gt_term(b) || a.eq_term(b); },filter_op::gte}},
+            {eq_literal<char_type>(),{6,false,[](const term<Json>& a, const term<Json>& b) {return a.eq_term(b); },filter_op::eq}},
+            {ne_literal<char_type>(),{6,false,[](const term<Json>& a, const term<Json>& b) {return a.ne_term(b); },filter_op::ne}},
+            {ampamp_literal<char_type>(),{7,false,[](const term<Json>& a, const term<Json>& b) {return a.ampamp_term(b); },filter_op::ampamp}},
+            {pipepipe_literal<char_type>(),{8,false,[](const term<Json>& a, const term<Json>& b) {return a.pipepipe_term(b); },filter_op::pipepipe}}
         };
 
     public:
@@ -1151,8 +1546,31 @@ class jsonpath_filter_parser
         }
     };
 
-    function_table functions_;
-    binary_operator_table binary_operators_;
+    // The tables are built once, and shared by all parsers
+    static const function_table& functions()
+    {
+        static const function_table table = function_table();
+        return table;
+    }
+
+    static const binary_operator_table& binary_operators()
+    {
+        static const binary_operator_table table = binary_operator_table();
+        return table;
+    }
+
+    std::shared_ptr<const jsonpath_expression<Json>> compile_path(const string_type& path) const
+    {
+        try
+        {
+            jsonpath_compiler<Json> compiler;
+            return std::make_shared<jsonpath_expression<Json>>(compiler.compile(path.data(),path.length()));
+        }
+        catch (const parse_error& e)
+        {
+            throw parse_error(e.code(),line_,column_);
+        }
+    }
 
 public:
     jsonpath_filter_parser()
@@ -1174,9 +1592,20 @@ public:
         return column_;
     }
 
-    jsonpath_filter_expr<Json> parse(const Json& root, const char_type* p, size_t length, const char_type** end_ptr)
+    jsonpath_filter_expr<Json> parse(const char_type* p, size_t length, const char_type** end_ptr)
     {
-        return parse(root, p,p+length, end_ptr);
+        return parse(p,p+length, end_ptr);
+    }
+
+    // Paths are evaluated against the root and context node passed to eval and exists
+    jsonpath_filter_expr<Json> parse(const Json&, const char_type* p, size_t length, const char_type** end_ptr)
+    {
+        return parse(p,p+length, end_ptr);
+    }
+
+    jsonpath_filter_expr<Json> parse(const Json&, const char_type* p, const char_type* end_expr, const char_type** end_ptr)
+    {
+        return parse(p,end_expr, end_ptr);
     }
 
     void push_state(filter_state state)
@@ -1248,7 +1677,7 @@ public:
         }
     }
 
-    jsonpath_filter_expr<Json> parse(const Json& root, const char_type* p, const char_type* end_expr, const char_type** end_ptr)
+    jsonpath_filter_expr<Json> parse(const char_type* p, const char_type* end_expr, const char_type** end_ptr)
     {
         output_stack_.clear();
         operator_stack_.clear();
@@ -1329,22 +1758,11 @@ public:
                         {
                             if (operator_stack_.back().is_aggregate())
                             {
-                                try
-                                {
-                                    // path, parse against root, get value
-                                    jsonpath_evaluator<Json,const Json&,detail::VoidPathConstructor<Json>> evaluator;
-                                    evaluator.evaluate(root,buffer.data(),buffer.length());
-                                    auto result = evaluator.get_values();
-                                    add_token(token<Json>(token_type::operand,std::make_shared<value_term<Json>>(result)));
-                                }
-                                catch (const parse_error& e)
-                                {
-                                    throw parse_error(e.code(),line_,column_);
-                                }
+                                add_token(token<Json>(token_type::operand,std::make_shared<aggregate_argument_term<Json>>(compile_path(buffer))));
                             }
                             else
                             {
-                                add_token(token<Json>(token_type::operand,std::make_shared<path_term<Json>>(buffer)));
+                                add_token(token<Json>(token_type::operand,std::make_shared<path_term<Json>>(compile_path(buffer))));
                             }
                             buffer.clear();
                             state = filter_state::expect_oper_or_right_round_bracket;
@@ -1366,8 +1784,8 @@ public:
                         buffer.push_back(*p);
                         ++p;
                         ++column_;
-                        auto it = binary_operators_.find(buffer);
-                        if (it == binary_operators_.end())
+                        auto it = binary_operators().find(buffer);
+                        if (it == binary_operators().end())
                         {
                             throw parse_error(jsonpath_parser_errc::invalid_filter_unsupported_operator, line_, column_);
                         }
@@ -1383,8 +1801,8 @@ public:
                         buffer.push_back(*p);
                         ++p;
                         ++column_;
-                        auto it = binary_operators_.find(buffer);
-                        if (it == binary_operators_.end())
+                        auto it = binary_operators().find(buffer);
+                        if (it == binary_operators().end())
                         {
                             throw parse_error(jsonpath_parser_errc::invalid_filter_unsupported_operator, line_, column_);
                         }
@@ -1395,8 +1813,8 @@ public:
                     break;
                 default:
                     {
-                        auto it = binary_operators_.find(buffer);
-                        if (it == binary_operators_.end())
+                        auto it = binary_operators().find(buffer);
+                        if (it == binary_operators().end())
                         {
                             throw parse_error(jsonpath_parser_errc::invalid_filter_unsupported_operator, line_, column_);
                         }
@@ -1430,8 +1848,8 @@ public:
                         break; 
                     case '(':
                     {
-                        auto it = functions_.find(buffer);
-                        if (it == functions_.end())
+                        auto it = functions().find(buffer);
+                        if (it == functions().end())
                         {
                             throw parse_error(jsonpath_parser_errc::invalid_filter_unsupported_operator,line_,column_);
                         }
@@ -1604,7 +2022,7 @@ public:
                 case '!':
                 {
                     std::function<Json(const term<Json>&)> f = [](const term<Json>& b) {return b.exclaim();};
-                    add_token(token<Json>(1, true, f));
+                    add_token(token<Json>(1, true, f, filter_op::exclaim));
                     ++p;
                     ++column_;
                     break;
@@ -1750,7 +2168,7 @@ public:
                     {
                         if (buffer.length() > 0)
                         {
-                            add_token(token<Json>(token_type::operand,std::make_shared<path_term<Json>>(buffer)));
+                            add_token(token<Json>(token_type::operand,std::make_shared<path_term<Json>>(compile_path(buffer))));
                             buffer.clear();
                         }
                         buffer.push_back(*p);
@@ -1762,7 +2180,7 @@ public:
                 case ')':
                     if (buffer.length() > 0)
                     {
-                        add_token(token<Json>(token_type::operand,std::make_shared<path_term<Json>>(buffer)));
+                        add_token(token<Json>(token_type::operand,std::make_shared<path_term<Json>>(compile_path(buffer))));
                         add_token(token<Json>(token_type::rparen));
                         buffer.clear();
                     }
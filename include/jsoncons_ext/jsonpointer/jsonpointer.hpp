@@ -13,7 +13,12 @@
 #include <istream>
 #include <cstdlib>
 #include <memory>
+#include <tuple>
+#include <utility>
+#include <deque>
+#include <unordered_map>
 #include <jsoncons/json.hpp>
+#include <jsoncons/json_hash.hpp>
 #include <jsoncons_ext/jsonpointer/jsonpointer_error_category.hpp>
 
 namespace jsoncons { namespace jsonpointer {
@@ -220,11 +225,9 @@ public:
         if (state_ == jsonpointer::detail::pointer_state::after_last_array_reference_token)
         {
             string_type p = path.substr(0,path.length()-1);
-            std::string s = std::to_string(current_.back().get().size());
-            for (auto c : s)
-            {
-                p.push_back(c);
-            }
+            char_type buf[max_integer_chars];
+            char_type* last = buf + max_integer_chars;
+            p.append(format_uinteger(current_.back().get().size(), last), last);
             return p;
         }
         else
@@ -632,6 +635,418 @@ private:
 
 }
 
+// A JSON Pointer parsed once into its reference tokens, with the escapes ~0 and ~1
+// replaced and array indices converted, to be applied to any number of documents.
+// Whether a token is a name or an index depends on the value it is applied to, so
+// each token keeps both readings. A pointer that is not valid is still constructed,
+// and the operations return the same error for it as for the pointer as a string.
+
+template <class CharT>
+class basic_json_pointer
+{
+public:
+    typedef CharT char_type;
+    typedef std::char_traits<char_type> char_traits_type;
+#if !defined(JSONCONS_HAS_STRING_VIEW)
+    typedef Basic_string_view_<char_type,char_traits_type> string_view_type;
+#else
+    typedef std::basic_string_view<char_type,char_traits_type> string_view_type;
+#endif
+    typedef std::basic_string<char_type,char_traits_type> string_type;
+
+    struct token
+    {
+        // The token read as an object member name
+        string_type name;
+        jsonpointer_errc name_errc;
+        // As an array index, or "-" at the end of the pointer
+        size_t index;
+        bool is_dash;
+        jsonpointer_errc index_errc;
+    };
+private:
+    string_type path_;
+    jsonpointer_errc errc_;
+    std::vector<token> tokens_;
+public:
+    explicit basic_json_pointer(const string_view_type& path)
+        : path_(path.data(), path.length()), errc_(jsonpointer_errc())
+    {
+        parse();
+    }
+
+    explicit basic_json_pointer(const char_type* path)
+        : path_(path), errc_(jsonpointer_errc())
+    {
+        parse();
+    }
+
+    explicit basic_json_pointer(const string_type& path)
+        : path_(path), errc_(jsonpointer_errc())
+    {
+        parse();
+    }
+
+    const string_type& string() const
+    {
+        return path_;
+    }
+
+    // Not ok if the pointer is not empty and does not begin with /
+    jsonpointer_errc errc() const
+    {
+        return errc_;
+    }
+
+    const std::vector<token>& tokens() const
+    {
+        return tokens_;
+    }
+private:
+    void parse()
+    {
+        const char_type* p = path_.data();
+        const char_type* end = path_.data() + path_.length();
+        if (p == end)
+        {
+            return;
+        }
+        if (*p != '/')
+        {
+            errc_ = jsonpointer_errc::expected_slash;
+            return;
+        }
+        while (p < end)
+        {
+            ++p;
+            const char_type* q = p;
+            while (q < end && *q != '/')
+            {
+                ++q;
+            }
+            tokens_.push_back(make_token(p, q, q == end));
+            p = q;
+        }
+    }
+
+    // Errors are those the evaluator of a pointer as a string reports at the first
+    // character of the token that is not valid
+    static token make_token(const char_type* p, const char_type* end, bool is_last)
+    {
+        token t;
+        t.name_errc = jsonpointer_errc();
+        t.index = 0;
+        t.is_dash = false;
+        t.index_errc = jsonpointer_errc();
+
+        for (const char_type* q = p; q < end && t.name_errc == jsonpointer_errc(); ++q)
+        {
+            if (*q != '~')
+            {
+                t.name.push_back(*q);
+            }
+            else if (q + 1 == end)
+            {
+                t.name_errc = is_last ? jsonpointer_errc::end_of_input : jsonpointer_errc::expected_0_or_1;
+            }
+            else if (*(q+1) == '0' || *(q+1) == '1')
+            {
+                t.name.push_back(*(++q) == '0' ? '~' : '/');
+            }
+            else
+            {
+                t.name_errc = jsonpointer_errc::expected_0_or_1;
+            }
+        }
+
+        if (p == end)
+        {
+            t.index_errc = is_last ? jsonpointer_errc::end_of_input : jsonpointer_errc::expected_digit_or_dash;
+        }
+        else if (*p == '-')
+        {
+            if (p + 1 != end)
+            {
+                t.index_errc = jsonpointer_errc::expected_slash;
+            }
+            else if (is_last)
+            {
+                t.is_dash = true;
+            }
+            else
+            {
+                t.index_errc = jsonpointer_errc::index_exceeds_array_size;
+            }
+        }
+        else if (*p == '0')
+        {
+            if (p + 1 != end)
+            {
+                char_type c = *(p+1);
+                t.index_errc = c >= '0' && c <= '9' ? jsonpointer_errc::unexpected_leading_zero 
+                             : c == '-' ? jsonpointer_errc::index_exceeds_array_size 
+                             : jsonpointer_errc::expected_digit_or_dash;
+            }
+        }
+        else if (*p >= '1' && *p <= '9')
+        {
+            for (const char_type* q = p; q < end && t.index_errc == jsonpointer_errc(); ++q)
+            {
+                if (*q >= '0' && *q <= '9')
+                {
+                    t.index = t.index*10 + static_cast<size_t>(*q - '0');
+                }
+                else
+                {
+                    t.index_errc = *q == '-' ? jsonpointer_errc::index_exceeds_array_size : jsonpointer_errc::expected_digit_or_dash;
+                }
+            }
+        }
+        else
+        {
+            t.index_errc = jsonpointer_errc::expected_digit_or_dash;
+        }
+        return t;
+    }
+};
+
+typedef basic_json_pointer<char> json_pointer;
+typedef basic_json_pointer<wchar_t> wjson_pointer;
+
+namespace detail {
+
+// Applies the tokens of a basic_json_pointer. The value that the last token refers into
+// is found once, then the operation is applied to it with the last token
+
+template<class Json,class JsonReference>
+class json_pointer_evaluator
+{
+    typedef basic_json_pointer<typename Json::char_type> pointer_type;
+    typedef typename pointer_type::token token_type;
+    using reference = JsonReference;
+
+    json_wrapper<Json,JsonReference> current_;
+public:
+    json_pointer_evaluator(reference root)
+        : current_(root)
+    {
+    }
+
+    Json get_result() 
+    {
+        return current_.get();
+    }
+
+    // The value found by get
+    reference current() const
+    {
+        return current_.get();
+    }
+
+    jsonpointer_errc get(const pointer_type& ptr)
+    {
+        const token_type* last = nullptr;
+        jsonpointer_errc ec = resolve_parent(ptr, last);
+        if (ec != jsonpointer_errc() || last == nullptr)
+        {
+            return ec;
+        }
+        if (current_.get().is_array())
+        {
+            if (last->is_dash)
+            {
+                return jsonpointer_errc::end_of_input;
+            }
+            if (last->index >= current_.get().size())
+            {
+                return jsonpointer_errc::index_exceeds_array_size;
+            }
+            current_ = current_.get().at(last->index);
+        }
+        else
+        {
+            if (!current_.get().has_key(last->name))
+            {
+                return jsonpointer_errc::name_not_found;
+            }
+            current_ = current_.get().at(last->name);
+        }
+        return ec;
+    }
+
+    typename Json::string_type normalized_path(const pointer_type& ptr)
+    {
+        const token_type* last = nullptr;
+        jsonpointer_errc ec = resolve_parent(ptr, last);
+        if (ec == jsonpointer_errc() && last != nullptr && last->is_dash && current_.get().is_array())
+        {
+            typename Json::string_type p = ptr.string().substr(0,ptr.string().length()-1);
+            typename Json::char_type buf[max_integer_chars];
+            typename Json::char_type* end = buf + max_integer_chars;
+            p.append(format_uinteger(current_.get().size(), end), end);
+            return p;
+        }
+        return ptr.string();
+    }
+
+    template <class T>
+    jsonpointer_errc insert_or_assign(const pointer_type& ptr, T&& value)
+    {
+        return add(ptr, std::forward<T>(value), false);
+    }
+
+    template <class T>
+    jsonpointer_errc insert(const pointer_type& ptr, T&& value)
+    {
+        return add(ptr, std::forward<T>(value), true);
+    }
+
+    jsonpointer_errc remove(const pointer_type& ptr)
+    {
+        const token_type* last = nullptr;
+        jsonpointer_errc ec = resolve_parent(ptr, last);
+        if (ec != jsonpointer_errc() || last == nullptr)
+        {
+            return ec;
+        }
+        if (current_.get().is_array())
+        {
+            if (last->is_dash || last->index >= current_.get().size())
+            {
+                return jsonpointer_errc::index_exceeds_array_size;
+            }
+            current_.get().erase(current_.get().array_range().begin()+last->index);
+        }
+        else
+        {
+            if (!current_.get().has_key(last->name))
+            {
+                return jsonpointer_errc::name_not_found;
+            }
+            current_.get().erase(last->name);
+        }
+        return ec;
+    }
+
+    template <class T>
+    jsonpointer_errc replace(const pointer_type& ptr, T&& value)
+    {
+        const token_type* last = nullptr;
+        jsonpointer_errc ec = resolve_parent(ptr, last);
+        if (ec != jsonpointer_errc() || last == nullptr)
+        {
+            return ec;
+        }
+        if (current_.get().is_array())
+        {
+            if (last->is_dash || last->index >= current_.get().size())
+            {
+                return jsonpointer_errc::index_exceeds_array_size;
+            }
+            (current_.get())[last->index] = std::forward<T>(value);
+        }
+        else
+        {
+            if (!current_.get().has_key(last->name))
+            {
+                return jsonpointer_errc::name_not_found;
+            }
+            current_.get().insert_or_assign(last->name,std::forward<T>(value));
+        }
+        return ec;
+    }
+private:
+    template <class T>
+    jsonpointer_errc add(const pointer_type& ptr, T&& value, bool insert_only)
+    {
+        const token_type* last = nullptr;
+        jsonpointer_errc ec = resolve_parent(ptr, last);
+        if (ec != jsonpointer_errc() || last == nullptr)
+        {
+            return ec;
+        }
+        if (current_.get().is_array())
+        {
+            if (last->is_dash || last->index == current_.get().size())
+            {
+                current_.get().push_back(std::forward<T>(value));
+            }
+            else if (last->index > current_.get().size())
+            {
+                return jsonpointer_errc::index_exceeds_array_size;
+            }
+            else
+            {
+                current_.get().insert(current_.get().array_range().begin()+last->index,std::forward<T>(value));
+            }
+        }
+        else if (insert_only && current_.get().has_key(last->name))
+        {
+            return jsonpointer_errc::key_already_exists;
+        }
+        else
+        {
+            current_.get().insert_or_assign(last->name,std::forward<T>(value));
+        }
+        return ec;
+    }
+
+    // Goes to the value that the last token refers into, and checks that the last token
+    // can be read as an index or name of it. last is null for the empty pointer
+    jsonpointer_errc resolve_parent(const pointer_type& ptr, const token_type*& last)
+    {
+        if (ptr.errc() != jsonpointer_errc())
+        {
+            return ptr.errc();
+        }
+        const auto& tokens = ptr.tokens();
+        for (size_t i = 0; i < tokens.size(); ++i)
+        {
+            const token_type& t = tokens[i];
+            if (current_.get().is_array())
+            {
+                if (t.index_errc != jsonpointer_errc())
+                {
+                    return t.index_errc;
+                }
+                if (i + 1 == tokens.size())
+                {
+                    break;
+                }
+                if (t.index >= current_.get().size())
+                {
+                    return jsonpointer_errc::index_exceeds_array_size;
+                }
+                current_ = current_.get().at(t.index);
+            }
+            else if (current_.get().is_object())
+            {
+                if (t.name_errc != jsonpointer_errc())
+                {
+                    return t.name_errc;
+                }
+                if (i + 1 == tokens.size())
+                {
+                    break;
+                }
+                if (!current_.get().has_key(t.name))
+                {
+                    return jsonpointer_errc::name_not_found;
+                }
+                current_ = current_.get().at(t.name);
+            }
+            else
+            {
+                return jsonpointer_errc::expected_object_or_array;
+            }
+        }
+        last = tokens.empty() ? nullptr : &tokens.back();
+        return jsonpointer_errc();
+    }
+};
+
+}
+
 template<class Json>
 typename Json::string_type normalized_path(const Json& root, const typename Json::string_view_type& path)
 {
@@ -647,6 +1062,21 @@ std::tuple<Json,jsonpointer_errc> get(const Json& root, const typename Json::str
     return std::make_tuple(evaluator.get_result(),ec);
 }
 
+// Sets ec, and returns a null value, if the path is not found, rather than throw
+template<class Json>
+Json get(const Json& root, const typename Json::string_view_type& path, std::error_code& ec)
+{
+    detail::jsonpointer_evaluator<Json,const Json&> evaluator;
+    jsonpointer_errc result = evaluator.get(root,path);
+    if (result != jsonpointer_errc())
+    {
+        ec = result;
+        return Json::null();
+    }
+    ec.clear();
+    return evaluator.get_result();
+}
+
 template<class Json>
 bool contains(const Json& root, const typename Json::string_view_type& path)
 {
@@ -687,6 +1117,198 @@ jsonpointer_errc replace(Json& root, const typename Json::string_view_type& path
     return evaluator.replace(root,path,value);
 }
 
+// Overloads for a pointer parsed once
+
+template<class Json>
+typename Json::string_type normalized_path(const Json& root, const basic_json_pointer<typename Json::char_type>& ptr)
+{
+    detail::json_pointer_evaluator<Json,const Json&> evaluator(root);
+    return evaluator.normalized_path(ptr);
+}
+
+template<class Json>
+std::tuple<Json,jsonpointer_errc> get(const Json& root, const basic_json_pointer<typename Json::char_type>& ptr)
+{
+    detail::json_pointer_evaluator<Json,const Json&> evaluator(root);
+    jsonpointer_errc ec = evaluator.get(ptr);
+    return std::make_tuple(ec == jsonpointer_errc() ? evaluator.get_result() : Json::null(),ec);
+}
+
+template<class Json>
+Json get(const Json& root, const basic_json_pointer<typename Json::char_type>& ptr, std::error_code& ec)
+{
+    detail::json_pointer_evaluator<Json,const Json&> evaluator(root);
+    jsonpointer_errc result = evaluator.get(ptr);
+    if (result != jsonpointer_errc())
+    {
+        ec = result;
+        return Json::null();
+    }
+    ec.clear();
+    return evaluator.get_result();
+}
+
+template<class Json>
+bool contains(const Json& root, const basic_json_pointer<typename Json::char_type>& ptr)
+{
+    detail::json_pointer_evaluator<Json,const Json&> evaluator(root);
+    return evaluator.get(ptr) == jsonpointer_errc();
+}
+
+template<class Json>
+jsonpointer_errc insert_or_assign(Json& root, const basic_json_pointer<typename Json::char_type>& ptr, const Json& value)
+{
+    detail::json_pointer_evaluator<Json,Json&> evaluator(root);
+    return evaluator.insert_or_assign(ptr,value);
+}
+
+template<class Json>
+jsonpointer_errc insert_or_assign(Json& root, const basic_json_pointer<typename Json::char_type>& ptr, Json&& value)
+{
+    detail::json_pointer_evaluator<Json,Json&> evaluator(root);
+    return evaluator.insert_or_assign(ptr,std::move(value));
+}
+
+template<class Json>
+jsonpointer_errc insert(Json& root, const basic_json_pointer<typename Json::char_type>& ptr, const Json& value)
+{
+    detail::json_pointer_evaluator<Json,Json&> evaluator(root);
+    return evaluator.insert(ptr,value);
+}
+
+template<class Json>
+jsonpointer_errc insert(Json& root, const basic_json_pointer<typename Json::char_type>& ptr, Json&& value)
+{
+    detail::json_pointer_evaluator<Json,Json&> evaluator(root);
+    return evaluator.insert(ptr,std::move(value));
+}
+
+template<class Json>
+jsonpointer_errc remove(Json& root, const basic_json_pointer<typename Json::char_type>& ptr)
+{
+    detail::json_pointer_evaluator<Json,Json&> evaluator(root);
+    return evaluator.remove(ptr);
+}
+
+template<class Json>
+jsonpointer_errc replace(Json& root, const basic_json_pointer<typename Json::char_type>& ptr, const Json& value)
+{
+    detail::json_pointer_evaluator<Json,Json&> evaluator(root);
+    return evaluator.replace(ptr,value);
+}
+
+template<class Json>
+jsonpointer_errc replace(Json& root, const basic_json_pointer<typename Json::char_type>& ptr, Json&& value)
+{
+    detail::json_pointer_evaluator<Json,Json&> evaluator(root);
+    return evaluator.replace(ptr,std::move(value));
+}
+
+// The values at pointers into a document that is not modified, each found by walking the
+// document the first time it is asked for, and after that by one hash lookup of the pointer.
+// Pointers that are not found are kept with their error, so that they are not walked again.
+// The index keeps the addresses of values in the document, and clear() must be called after
+// the document is modified.
+
+template <class Json>
+class json_pointer_index
+{
+public:
+    typedef typename Json::char_type char_type;
+    typedef typename Json::string_type string_type;
+    typedef typename Json::string_view_type string_view_type;
+private:
+    struct entry
+    {
+        const Json* value;
+        jsonpointer_errc ec;
+    };
+
+    struct path_hash
+    {
+        size_t operator()(const string_view_type& path) const
+        {
+            return jsoncons::detail::hash_chars(path.data(), path.length());
+        }
+    };
+
+    const Json* root_;
+    // Owns the pointers the map keys view, a deque so that they do not move
+    std::deque<string_type> paths_;
+    std::unordered_map<string_view_type,entry,path_hash> entries_;
+public:
+    explicit json_pointer_index(const Json& root)
+        : root_(std::addressof(root))
+    {
+    }
+
+    json_pointer_index(const json_pointer_index&) = delete;
+    json_pointer_index& operator=(const json_pointer_index&) = delete;
+
+    const Json& root() const
+    {
+        return *root_;
+    }
+
+    // Returns the value at path, or nullptr and sets ec if there is none
+    const Json* find(const string_view_type& path, jsonpointer_errc& ec)
+    {
+        auto it = entries_.find(path);
+        if (it == entries_.end())
+        {
+            paths_.emplace_back(path.data(), path.length());
+            const string_type& key = paths_.back();
+
+            entry e;
+            basic_json_pointer<char_type> ptr(string_view_type(key.data(), key.length()));
+            detail::json_pointer_evaluator<Json,const Json&> evaluator(*root_);
+            e.ec = evaluator.get(ptr);
+            e.value = e.ec == jsonpointer_errc() ? std::addressof(evaluator.current()) : nullptr;
+            it = entries_.insert(std::make_pair(string_view_type(key.data(), key.length()), e)).first;
+        }
+        ec = it->second.ec;
+        return it->second.value;
+    }
+
+    const Json* find(const string_view_type& path)
+    {
+        jsonpointer_errc ec;
+        return find(path, ec);
+    }
+
+    bool contains(const string_view_type& path)
+    {
+        return find(path) != nullptr;
+    }
+
+    // Sets ec, and returns a null value, if the path is not found, rather than throw
+    Json get(const string_view_type& path, std::error_code& ec)
+    {
+        jsonpointer_errc result;
+        const Json* value = find(path, result);
+        if (value == nullptr)
+        {
+            ec = result;
+            return Json::null();
+        }
+        ec.clear();
+        return *value;
+    }
+
+    // The number of pointers kept, found or not
+    size_t size() const
+    {
+        return entries_.size();
+    }
+
+    // Forgets the pointers, to be called after the document has been modified
+    void clear()
+    {
+        entries_.clear();
+        paths_.clear();
+    }
+};
+
 #if !defined(JSONCONS_NO_DEPRECATED)
 
 template<class Json>
@@ -15,8 +15,14 @@
 #include <memory>
 #include <limits>
 #include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <tuple>
 #include <jsoncons/json.hpp>
+#include <jsoncons/detail/string_scan.hpp>
 #include <jsoncons_ext/binary/binary_utilities.hpp>
+#include <jsoncons_ext/binary/view_index.hpp>
+#include <jsoncons_ext/msgpack/msgpack_error_category.hpp>
 
 namespace jsoncons { namespace msgpack {
   
@@ -25,6 +31,9 @@ namespace msgpack_format
     const uint8_t nil_cd = 0xc0;
     const uint8_t false_cd = 0xc2;
     const uint8_t true_cd = 0xc3;
+    const uint8_t bin8_cd = 0xc4;
+    const uint8_t bin16_cd = 0xc5;
+    const uint8_t bin32_cd = 0xc6;
     const uint8_t float32_cd = 0xca;
     const uint8_t float64_cd = 0xcb;
     const uint8_t uint8_cd = 0xcc;
@@ -44,12 +53,554 @@ namespace msgpack_format
     const uint8_t map32_cd = 0xdf;
 }
 
+namespace detail {
+
+    // Steps over n bytes, throwing if fewer remain
+    inline
+    const uint8_t* skip(const uint8_t* it, const uint8_t* end, size_t n)
+    {
+        if (static_cast<size_t>(end - it) < n)
+        {
+            JSONCONS_THROW_EXCEPTION(std::invalid_argument,"eof");
+        }
+        return it + n;
+    }
+
+    inline
+    bool is_array(uint8_t b)
+    {
+        return (b >= 0x90 && b <= 0x9f) || b == msgpack_format::array16_cd || b == msgpack_format::array32_cd;
+    }
+
+    inline
+    bool is_object(uint8_t b)
+    {
+        return (b >= 0x80 && b <= 0x8f) || b == msgpack_format::map16_cd || b == msgpack_format::map32_cd;
+    }
+
+    // The number of elements of an array or members of a map, and the position of the first
+    inline
+    std::tuple<size_t,const uint8_t*> size(const uint8_t* it, const uint8_t* end)
+    {
+        const uint8_t* pos = it++;
+        if ((*pos >= 0x80 && *pos <= 0x9f))
+        {
+            return std::make_tuple(static_cast<size_t>(*pos & 0x0f), it);
+        }
+        switch (*pos)
+        {
+            case msgpack_format::array16_cd:
+            case msgpack_format::map16_cd:
+                return std::make_tuple(static_cast<size_t>(binary::detail::from_big_endian<uint16_t>(it,end)), it + sizeof(uint16_t));
+            case msgpack_format::array32_cd:
+            case msgpack_format::map32_cd:
+                return std::make_tuple(static_cast<size_t>(binary::detail::from_big_endian<uint32_t>(it,end)), it + sizeof(uint32_t));
+            default:
+                return std::make_tuple(static_cast<size_t>(0), end);
+        }
+    }
+
+    // Reads a fixstr, str 8, str 16 or str 32
+    inline
+    std::tuple<std::string,const uint8_t*> get_string(const uint8_t* it, const uint8_t* end)
+    {
+        const uint8_t* pos = it++;
+        size_t len;
+        if (*pos >= 0xa0 && *pos <= 0xbf)
+        {
+            len = *pos & 0x1f;
+        }
+        else
+        {
+            switch (*pos)
+            {
+                case msgpack_format::str8_cd:
+                    len = binary::detail::from_big_endian<uint8_t>(it,end);
+                    it += sizeof(uint8_t);
+                    break;
+                case msgpack_format::str16_cd:
+                    len = binary::detail::from_big_endian<uint16_t>(it,end);
+                    it += sizeof(uint16_t);
+                    break;
+                case msgpack_format::str32_cd:
+                    len = binary::detail::from_big_endian<uint32_t>(it,end);
+                    it += sizeof(uint32_t);
+                    break;
+                default:
+                    JSONCONS_THROW_EXCEPTION(std::invalid_argument,"Map key is not a string");
+            }
+        }
+        const uint8_t* last = skip(it, end, len);
+        return std::make_tuple(std::string(reinterpret_cast<const char*>(it), len), last);
+    }
+
+    // Returns the position past the data item at it
+    inline
+    const uint8_t* walk(const uint8_t* it, const uint8_t* end)
+    {
+        if (it >= end)
+        {
+            return end;
+        }
+        const uint8_t* pos = it++;
+        if (*pos <= 0x7f || *pos >= 0xe0)
+        {
+            // positive and negative fixint
+            return it;
+        }
+        if (*pos <= 0x9f)
+        {
+            // fixmap and fixarray
+            size_t len;
+            std::tie(len, it) = size(pos, end);
+            const size_t n = *pos <= 0x8f ? 2*len : len;
+            for (size_t i = 0; i < n; ++i)
+            {
+                it = walk(it, end);
+            }
+            return it;
+        }
+        if (*pos <= 0xbf)
+        {
+            // fixstr
+            return skip(it, end, *pos & 0x1f);
+        }
+        switch (*pos)
+        {
+            case msgpack_format::nil_cd:
+            case msgpack_format::false_cd:
+            case msgpack_format::true_cd:
+                return it;
+            case msgpack_format::uint8_cd:
+            case msgpack_format::int8_cd:
+                return skip(it, end, 1);
+            case msgpack_format::uint16_cd:
+            case msgpack_format::int16_cd:
+            case 0xd4: // fixext 1
+                return skip(it, end, 2);
+            case 0xd5: // fixext 2
+                return skip(it, end, 3);
+            case msgpack_format::float32_cd:
+            case msgpack_format::uint32_cd:
+            case msgpack_format::int32_cd:
+                return skip(it, end, 4);
+            case 0xd6: // fixext 4
+                return skip(it, end, 5);
+            case msgpack_format::float64_cd:
+            case msgpack_format::uint64_cd:
+            case msgpack_format::int64_cd:
+                return skip(it, end, 8);
+            case 0xd7: // fixext 8
+                return skip(it, end, 9);
+            case 0xd8: // fixext 16
+                return skip(it, end, 17);
+            case msgpack_format::str8_cd:
+            case 0xc4: // bin 8
+                return skip(it + 1, end, binary::detail::from_big_endian<uint8_t>(it,end));
+            case msgpack_format::str16_cd:
+            case 0xc5: // bin 16
+                return skip(it + 2, end, binary::detail::from_big_endian<uint16_t>(it,end));
+            case msgpack_format::str32_cd:
+            case 0xc6: // bin 32
+                return skip(it + 4, end, binary::detail::from_big_endian<uint32_t>(it,end));
+            case 0xc7: // ext 8, a length and a type follow
+                return skip(skip(it, end, 2), end, binary::detail::from_big_endian<uint8_t>(it,end));
+            case 0xc8: // ext 16
+                return skip(skip(it, end, 3), end, binary::detail::from_big_endian<uint16_t>(it,end));
+            case 0xc9: // ext 32
+                return skip(skip(it, end, 5), end, binary::detail::from_big_endian<uint32_t>(it,end));
+            case msgpack_format::array16_cd:
+            case msgpack_format::array32_cd:
+            case msgpack_format::map16_cd:
+            case msgpack_format::map32_cd:
+            {
+                size_t len;
+                std::tie(len, it) = size(pos, end);
+                const size_t n = is_object(*pos) ? 2*len : len;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    it = walk(it, end);
+                }
+                return it;
+            }
+            default:
+                JSONCONS_THROW_EXCEPTION_1(std::invalid_argument,"Error decoding a message pack at position %s", std::to_string(end-pos));
+        }
+    }
+
+    // The offsets of the items of a MessagePack array or map, and for a map a hash table of its keys
+    class msgpack_view_index : public binary::detail::view_index
+    {
+    public:
+        msgpack_view_index(const uint8_t* buffer, size_t buflen)
+            : view_index(is_object(buffer[0]))
+        {
+            const uint8_t* end = buffer + buflen;
+            size_t len;
+            const uint8_t* it;
+            std::tie(len, it) = detail::size(buffer, end);
+            // Each item takes at least a byte, so a length larger than what is left is not trusted
+            offsets_.reserve(stride_*(std::min)(len, static_cast<size_t>(end - it)) + 1);
+            for (size_t i = 0; i < len; ++i)
+            {
+                if (it >= end)
+                {
+                    JSONCONS_THROW_EXCEPTION(std::invalid_argument,"eof");
+                }
+                if (stride_ == 2)
+                {
+                    offsets_.push_back(it - buffer);
+                    std::string key;
+                    std::tie(key,it) = get_string(it, end);
+                    keys_.push_back(std::move(key));
+                }
+                offsets_.push_back(it - buffer);
+                it = walk(it, end);
+            }
+            offsets_.push_back(it - buffer);
+            index_keys();
+        }
+    };
+}
+
+class msgpack_view;
+
+template<class Json>
+Json decode_msgpack(const msgpack_view& v);
+
+namespace detail {
+    template <class T, class Enable = void>
+    struct msgpack_view_as;
+}
+
+// msgpack_view
+
+// A view of MessagePack encoded bytes, that navigates arrays and maps without decoding them.
+// The bytes are not copied, they must outlive the view and any views taken from it.
+
+class msgpack_view 
+{
+    const uint8_t* buffer_;
+    size_t buflen_; 
+    std::shared_ptr<const detail::msgpack_view_index> index_;
+public:
+    typedef msgpack_view value_type;
+    typedef msgpack_view& reference;
+    typedef const msgpack_view& const_reference;
+    typedef msgpack_view* pointer;
+    typedef const msgpack_view* const_pointer;
+    typedef std::string string_type;
+    typedef char char_type;
+    typedef std::char_traits<char_type> char_traits_type;
+#if !defined(JSONCONS_HAS_STRING_VIEW)
+    typedef Basic_string_view_<char_type,char_traits_type> string_view_type;
+#else
+    typedef std::basic_string_view<char_type,char_traits_type> string_view_type;
+#endif
+
+    msgpack_view()
+        : buffer_(nullptr), buflen_(0)
+    {
+    }
+
+    msgpack_view(const uint8_t* buffer, size_t buflen)
+        : buffer_(buffer), buflen_(buflen)
+    {
+    }
+
+    msgpack_view(const std::vector<uint8_t>& v)
+        : buffer_(v.data()), buflen_(v.size())
+    {
+    }
+
+    msgpack_view(const msgpack_view& other) = default;
+
+    msgpack_view(msgpack_view&& other)
+        : buffer_(nullptr), buflen_(0)
+    {
+        std::swap(buffer_,other.buffer_);
+        std::swap(buflen_,other.buflen_);
+        index_.swap(other.index_);
+    }
+
+    msgpack_view& operator=(const msgpack_view&) = default;
+
+    msgpack_view& operator=(msgpack_view&& other)
+    {
+        if (this != &other)
+        {
+            std::swap(buffer_,other.buffer_);
+            std::swap(buflen_,other.buflen_);
+            index_.swap(other.index_);
+        }
+        return *this;
+    }
+
+    // Returns a view of the same array or map with an index of the offsets of its items,
+    // and for a map a hash table of its keys, so that size, at and has_key take constant
+    // rather than linear time. As for cbor_view, the index is built here, is shared by
+    // copies of the returned view, and views of the items are not indexed.
+    msgpack_view indexed() const
+    {
+        msgpack_view v(*this);
+        if (buflen_ > 0 && (is_array() || is_object()) && !index_)
+        {
+            v.index_ = std::make_shared<detail::msgpack_view_index>(buffer_, buflen_);
+        }
+        return v;
+    }
+
+    bool is_indexed() const
+    {
+        return index_ != nullptr;
+    }
+
+    const uint8_t* buffer() const
+    {
+        return buffer_;
+    }
+
+    size_t buflen() const
+    {
+        return buflen_;
+    }
+
+    bool is_array() const
+    {
+        JSONCONS_ASSERT(buflen_ > 0);
+        return detail::is_array(buffer_[0]);
+    }
+
+    bool is_object() const
+    {
+        JSONCONS_ASSERT(buflen_ > 0);
+        return detail::is_object(buffer_[0]);
+    }
+
+    size_t size() const
+    {
+        if (index_)
+        {
+            return index_->size();
+        }
+        size_t len;
+        const uint8_t* it;
+        std::tie(len, it) = detail::size(buffer_,buffer_+buflen_);
+        return len;
+    }
+
+    msgpack_view at(size_t index) const
+    {
+        JSONCONS_ASSERT(is_array());
+        if (index_)
+        {
+            if (index >= index_->size())
+            {
+                JSONCONS_THROW_EXCEPTION(std::out_of_range,"Invalid array subscript");
+            }
+            return item(index);
+        }
+        size_t len;
+        const uint8_t* it;
+        const uint8_t* end = buffer_ + buflen_;
+        std::tie(len, it) = detail::size(buffer_, end);
+        if (index >= len)
+        {
+            JSONCONS_THROW_EXCEPTION(std::out_of_range,"Invalid array subscript");
+        }
+        for (size_t i = 0; i < index; ++i)
+        {
+            it = detail::walk(it, end);
+        }
+        const uint8_t* last = detail::walk(it,end);
+        return msgpack_view(it,last-it);
+    }
+
+    msgpack_view at(const string_view_type& key) const
+    {
+        JSONCONS_ASSERT(is_object());
+        if (index_)
+        {
+            const size_t pos = index_->find(key);
+            if (pos == index_->size())
+            {
+                JSONCONS_THROW_EXCEPTION(std::runtime_error,"Key not found");
+            }
+            return item(pos);
+        }
+        const uint8_t* it = find(key);
+        if (it == nullptr)
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Key not found");
+        }
+        const uint8_t* last = detail::walk(it, buffer_ + buflen_);
+        return msgpack_view(it,last-it);
+    }
+
+    bool has_key(const string_view_type& key) const
+    {
+        if (!is_object())
+        {
+            return false;
+        }
+        if (index_)
+        {
+            return index_->find(key) != index_->size();
+        }
+        return find(key) != nullptr;
+    }
+
+    // The key of the member at position pos of a map, in encoded order
+    string_type key(size_t pos) const
+    {
+        JSONCONS_ASSERT(is_object());
+        if (index_)
+        {
+            check_position(pos, index_->size());
+            return index_->key(pos);
+        }
+        string_type a_key;
+        const uint8_t* it = nth(pos);
+        std::tie(a_key,it) = detail::get_string(it, buffer_ + buflen_);
+        return a_key;
+    }
+
+    // A view of the element at position pos of an array, or of the value of the member
+    // at position pos of a map. Iterating over the members of a map with key and value
+    // takes linear time with an indexed view, and quadratic time without.
+    msgpack_view value(size_t pos) const
+    {
+        JSONCONS_ASSERT(is_array() || is_object());
+        if (index_)
+        {
+            check_position(pos, index_->size());
+            return item(pos);
+        }
+        const uint8_t* end = buffer_ + buflen_;
+        const uint8_t* it = nth(pos);
+        if (is_object())
+        {
+            it = detail::walk(it, end);
+        }
+        const uint8_t* last = detail::walk(it, end);
+        return msgpack_view(it,last-it);
+    }
+
+    // Decodes the data item, e.g. as<int64_t>() or as<std::string>()
+    template <class T>
+    T as() const
+    {
+        return detail::msgpack_view_as<T>::as(*this);
+    }
+private:
+    msgpack_view item(size_t pos) const
+    {
+        auto offsets = index_->value(pos);
+        return msgpack_view(buffer_ + offsets.first, offsets.second - offsets.first);
+    }
+
+    static void check_position(size_t pos, size_t size)
+    {
+        if (pos >= size)
+        {
+            JSONCONS_THROW_EXCEPTION(std::out_of_range,"Invalid position");
+        }
+    }
+
+    // The position of the element at pos of an array, or of the key of the member at pos of a map
+    const uint8_t* nth(size_t pos) const
+    {
+        size_t len;
+        const uint8_t* it;
+        const uint8_t* end = buffer_ + buflen_;
+        std::tie(len, it) = detail::size(buffer_, end);
+        check_position(pos, len);
+        const bool is_map = is_object();
+        for (size_t i = 0; i < pos; ++i)
+        {
+            if (is_map)
+            {
+                it = detail::walk(it, end);
+            }
+            it = detail::walk(it, end);
+        }
+        return it;
+    }
+
+    // The position of the value of the first member with the key, or null
+    const uint8_t* find(const string_view_type& key) const
+    {
+        size_t len;
+        const uint8_t* it;
+        const uint8_t* end = buffer_ + buflen_;
+        std::tie(len, it) = detail::size(buffer_, end);
+        for (size_t i = 0; i < len; ++i)
+        {
+            std::string a_key;
+            std::tie(a_key,it) = detail::get_string(it, end);
+            if (a_key.size() == key.size() && 
+                std::char_traits<char>::compare(a_key.data(), key.data(), key.size()) == 0)
+            {
+                return it;
+            }
+            it = detail::walk(it, end);
+        }
+        return nullptr;
+    }
+};
+
+namespace detail {
+    template <class T, class Enable>
+    struct msgpack_view_as
+    {
+        static T as(const msgpack_view& v)
+        {
+            return decode_msgpack<json>(v).template as<T>();
+        }
+    };
+
+    // Decodes straight into any basic_json, e.g. ojson, rather than through json
+    template <class T>
+    struct msgpack_view_as<T,typename std::enable_if<jsoncons::detail::is_basic_json<T>::value>::type>
+    {
+        static T as(const msgpack_view& v)
+        {
+            return decode_msgpack<T>(v);
+        }
+    };
+}
+
+// Appends to a vector in one pass, without sizing the output first
 struct Encode_msgpack_
 {
     template <typename T>
-    void operator()(T val, std::vector<uint8_t>& v)
+    void operator()(T val, binary::detail::output_buffer& out)
     {
-        binary::detail::to_big_endian(val,v);
+        out.put(val);
+    }
+
+    void operator()(const uint8_t* data, size_t length, binary::detail::output_buffer& out)
+    {
+        out.write(data, length);
+    }
+};
+
+// Writes into memory already sized with Calculate_size_
+struct Write_msgpack_
+{
+    template <typename T>
+    void operator()(T val, uint8_t*& p)
+    {
+        binary::detail::to_big_endian(val,p);
+    }
+
+    void operator()(const uint8_t* data, size_t length, uint8_t*& p)
+    {
+        if (length > 0)
+        {
+            std::memcpy(p, data, length);
+            p += length;
+        }
     }
 };
 
@@ -60,6 +611,11 @@ struct Calculate_size_
     {
         size += sizeof(T);
     }
+
+    void operator()(const uint8_t*, size_t length, size_t& size)
+    {
+        size += length;
+    }
 };
 
 template<class Json>
@@ -207,13 +763,42 @@ public:
                 break;
             }
 
+            case json_type_tag::small_number_t:
+            case json_type_tag::number_t:
+            {
+                // A number kept as text is encoded as the integer or double it converts to
+                auto text = jval.number_text();
+                jsoncons::detail::number_text_value value = jsoncons::detail::read_number_text(text.data(), text.length());
+                switch (value.kind)
+                {
+                    case jsoncons::detail::number_text_kind::integer:
+                        encode(Json(value.integer), action, v);
+                        break;
+                    case jsoncons::detail::number_text_kind::uinteger:
+                        encode(Json(value.uinteger), action, v);
+                        break;
+                    default:
+                        encode(Json(value.floating_point), action, v);
+                        break;
+                }
+                break;
+            }
+
             case json_type_tag::small_string_t:
             case json_type_tag::string_t:
+            case json_type_tag::string_view_t:
+            case json_type_tag::escaped_string_t:
             {
                 encode_string(jval.as_string_view(), action, v);
                 break;
             }
 
+            case json_type_tag::byte_string_t:
+            {
+                encode_byte_string(jval.as_byte_string_view(), action, v);
+                break;
+            }
+
             case json_type_tag::array_t:
             {
                 const auto length = jval.array_value().size();
@@ -282,6 +867,23 @@ public:
 
     template <class Action, class Result>
     static void encode_string(const string_view_type& sv, Action action, Result& v)
+    {
+        encode_string(sv, action, v, std::integral_constant<bool,sizeof(typename Json::char_type) == sizeof(uint8_t)>());
+    }
+
+    // UTF-8 strings are written as they are, once validated
+    template <class Action, class Result>
+    static void encode_string(const string_view_type& sv, Action action, Result& v, std::true_type)
+    {
+        if (!jsoncons::detail::is_valid_utf8(sv.data(), sv.length()))
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Illegal unicode");
+        }
+        encode_utf8(reinterpret_cast<const uint8_t*>(sv.data()), sv.length(), action, v);
+    }
+
+    template <class Action, class Result>
+    static void encode_string(const string_view_type& sv, Action action, Result& v, std::false_type)
     {
         std::basic_string<uint8_t> target;
         auto result = unicons::convert(
@@ -291,8 +893,36 @@ public:
         {
             JSONCONS_THROW_EXCEPTION(std::runtime_error,"Illegal unicode");
         }
+        encode_utf8(target.data(), target.length(), action, v);
+    }
 
+    // The bytes are written from the view, without a copy
+    template <class Action, class Result>
+    static void encode_byte_string(const byte_string_view& target, Action action, Result& v)
+    {
         const size_t length = target.length();
+        if (length <= (std::numeric_limits<uint8_t>::max)())
+        {
+            action(static_cast<uint8_t>(msgpack_format::bin8_cd), v);
+            action(static_cast<uint8_t>(length), v);
+        }
+        else if (length <= (std::numeric_limits<uint16_t>::max)())
+        {
+            action(static_cast<uint8_t>(msgpack_format::bin16_cd), v);
+            action(static_cast<uint16_t>(length), v);
+        }
+        else
+        {
+            action(static_cast<uint8_t>(msgpack_format::bin32_cd), v);
+            action(static_cast<uint32_t>(length),v);
+        }
+
+        action(target.data(), length, v);
+    }
+
+    template <class Action, class Result>
+    static void encode_utf8(const uint8_t* data, size_t length, Action action, Result& v)
+    {
         if (length <= 31)
         {
             // fixstr stores a byte array whose length is upto 31 bytes
@@ -317,10 +947,7 @@ public:
             action(static_cast<uint32_t>(length),v);
         }
 
-        for (size_t i = 0; i < length; ++i)
-        {
-            action(static_cast<uint8_t>(target.data()[i]), v);
-        }
+        action(data, length, v);
     }
 };
 
@@ -332,16 +959,29 @@ class Decode_msgpack_
     const uint8_t* begin_;
     const uint8_t* end_;
     const uint8_t* it_;
+    binary::decode_limits limits_;
+    size_t depth_;
 public:
     typedef typename Json::char_type char_type;
+    typedef typename Json::key_value_pair_type key_value_pair_type;
+    typedef typename Json::key_storage_type key_storage_type;
 
     Decode_msgpack_(const uint8_t* begin, const uint8_t* end)
-        : begin_(begin), end_(end), it_(begin)
+        : begin_(begin), end_(end), it_(begin), depth_(0)
+    {
+    }
+
+    Decode_msgpack_(const uint8_t* begin, const uint8_t* end, const binary::decode_limits& limits)
+        : begin_(begin), end_(end), it_(begin), limits_(limits), depth_(0)
     {
     }
 
     Json decode()
     {
+        if (it_ >= end_)
+        {
+            error(msgpack_parser_errc::unexpected_eof, it_);
+        }
         // store && increment index
         const uint8_t* pos = it_++;
 
@@ -355,44 +995,17 @@ public:
             else if (*pos <= 0x8f) 
             {
                 // fixmap
-                Json result;
-                const size_t len = *pos & 0x0f;
-                result.reserve(len);
-                for (size_t i = 0; i < len; ++i)
-                {
-                    auto j = decode();
-                    result.set(j.as_string_view(),decode());
-                }
-                return result;
+                return get_fixed_length_map(pos, *pos & 0x0f);
             }
             else if (*pos <= 0x9f) 
             {
                 // fixarray
-                Json result = typename Json::array();
-                const size_t len = *pos & 0x0f;
-                result.reserve(len);
-                for (size_t i = 0; i < len; ++i)
-                {
-                    result.push_back(decode());
-                }
-                return result;
+                return get_fixed_length_array(pos, *pos & 0x0f);
             }
             else 
             {
                 // fixstr
-                const size_t len = *pos & 0x1f;
-                const uint8_t* first = &(*it_);
-                const uint8_t* last = first + len;
-                it_ += len; 
-
-                std::basic_string<char_type> target;
-                auto result = unicons::convert(
-                    first, last,std::back_inserter(target),unicons::conv_flags::strict);
-                if (result.ec != unicons::conv_errc())
-                {
-                    JSONCONS_THROW_EXCEPTION(std::runtime_error,"Illegal unicode");
-                }
-                return Json(target);
+                return get_string(pos, it_, *pos & 0x1f);
             }
         }
         else if (*pos >= 0xe0) 
@@ -488,107 +1101,75 @@ public:
 
                 case msgpack_format::str8_cd: 
                 {
-                    const auto len = binary::detail::from_big_endian<int8_t>(it_,end_);
-                    const uint8_t* first = &(*(pos + 2));
-                    const uint8_t* last = first + len;
-                    it_ += len+1; 
-
-                    std::basic_string<char_type> target;
-                    auto result = unicons::convert(
-                        first, last,std::back_inserter(target),unicons::conv_flags::strict);
-                    if (result.ec != unicons::conv_errc())
-                    {
-                        JSONCONS_THROW_EXCEPTION(std::runtime_error,"Illegal unicode");
-                    }
-                    return target;
+                    const auto len = binary::detail::from_big_endian<uint8_t>(it_,end_);
+                    return get_string(pos, pos + 2, len);
                 }
 
                 case msgpack_format::str16_cd: 
                 {
-                    const auto len = binary::detail::from_big_endian<int16_t>(it_,end_);
-                    const uint8_t* first = &(*(pos + 3));
-                    const uint8_t* last = first + len;
-                    it_ += len + 2; 
-
-                    std::basic_string<char_type> target;
-                    auto result = unicons::convert(
-                        first, last,std::back_inserter(target),unicons::conv_flags::strict);
-                    if (result.ec != unicons::conv_errc())
-                    {
-                        JSONCONS_THROW_EXCEPTION(std::runtime_error,"Illegal unicode");
-                    }
-                    return target;
+                    const auto len = binary::detail::from_big_endian<uint16_t>(it_,end_);
+                    return get_string(pos, pos + 3, len);
                 }
 
                 case msgpack_format::str32_cd: 
                 {
-                    const auto len = binary::detail::from_big_endian<int32_t>(it_,end_);
-                    const uint8_t* first = &(*(pos + 5));
-                    const uint8_t* last = first + len;
-                    it_ += len + 4; 
+                    const auto len = binary::detail::from_big_endian<uint32_t>(it_,end_);
+                    return get_string(pos, pos + 5, len);
+                }
 
-                    std::basic_string<char_type> target;
-                    auto result = unicons::convert(
-                        first, last,std::back_inserter(target),unicons::conv_flags::strict);
-                    if (result.ec != unicons::conv_errc())
-                    {
-                        JSONCONS_THROW_EXCEPTION(std::runtime_error,"Illegal unicode");
-                    }
-                    return target;
+                case msgpack_format::bin8_cd: 
+                {
+                    const auto len = binary::detail::from_big_endian<uint8_t>(it_,end_);
+                    const uint8_t* first = it_ + 1;
+                    check_string_length(len, pos);
+                    it_ = detail::skip(first, end_, len);
+                    return Json(first, len);
+                }
+
+                case msgpack_format::bin16_cd: 
+                {
+                    const auto len = binary::detail::from_big_endian<uint16_t>(it_,end_);
+                    const uint8_t* first = it_ + 2;
+                    check_string_length(len, pos);
+                    it_ = detail::skip(first, end_, len);
+                    return Json(first, len);
+                }
+
+                case msgpack_format::bin32_cd: 
+                {
+                    const auto len = binary::detail::from_big_endian<uint32_t>(it_,end_);
+                    const uint8_t* first = it_ + 4;
+                    check_string_length(len, pos);
+                    it_ = detail::skip(first, end_, len);
+                    return Json(first, len);
                 }
 
                 case msgpack_format::array16_cd: 
                 {
-                    Json result = typename Json::array();
                     const auto len = binary::detail::from_big_endian<uint16_t>(it_,end_);
                     it_ += 2; 
-                    result.reserve(len);
-                    for (size_t i = 0; i < len; ++i)
-                    {
-                        result.push_back(decode());
-                    }
-                    return result;
+                    return get_fixed_length_array(pos, len);
                 }
 
                 case msgpack_format::array32_cd: 
                 {
-                    Json result = typename Json::array();
                     const auto len = binary::detail::from_big_endian<uint32_t>(it_,end_);
                     it_ += 4; 
-                    result.reserve(len);
-                    for (size_t i = 0; i < len; ++i)
-                    {
-                        result.push_back(decode());
-                    }
-                    return result;
+                    return get_fixed_length_array(pos, len);
                 }
 
                 case msgpack_format::map16_cd : 
                 {
                     const auto len = binary::detail::from_big_endian<uint16_t>(it_,end_);
                     it_ += 2; 
-                    Json result = typename Json::object();
-                    result.reserve(len);
-                    for (size_t i = 0; i < len; ++i)
-                    {
-                        auto j = decode();
-                        result.set(j.as_string_view(),decode());
-                    }
-                    return result;
+                    return get_fixed_length_map(pos, len);
                 }
 
                 case msgpack_format::map32_cd : 
                 {
-                    Json result = typename Json::object();
                     const auto len = binary::detail::from_big_endian<uint32_t>(it_,end_);
                     it_ += 4; 
-                    result.reserve(len);
-                    for (size_t i = 0; i < len; ++i)
-                    {
-                        auto key = decode().as_string_view();
-                        result.set(key,decode());
-                    }
-                    return result;
+                    return get_fixed_length_map(pos, len);
                 }
 
                 default:
@@ -598,25 +1179,179 @@ public:
             }
         }
     }
+private:
+    Json get_string(const uint8_t* pos, const uint8_t* first, size_t len)
+    {
+        check_string_length(len, pos);
+        it_ = detail::skip(first, end_, len);
+
+        std::basic_string<char_type> target;
+        auto result = unicons::convert(
+            first, it_,std::back_inserter(target),unicons::conv_flags::strict);
+        if (result.ec != unicons::conv_errc())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Illegal unicode");
+        }
+        return Json(target);
+    }
+
+    Json get_fixed_length_array(const uint8_t* pos, size_t len)
+    {
+        begin_container(pos, len);
+        // Each element takes at least one byte
+        Json result = typename Json::array();
+        result.reserve((std::min)(len, static_cast<size_t>(end_ - it_)));
+        for (size_t i = 0; i < len; ++i)
+        {
+            result.push_back(decode());
+        }
+        --depth_;
+        return result;
+    }
+
+    // Builds the object with one sort of all the members, the last of duplicates wins
+    Json get_fixed_length_map(const uint8_t* pos, size_t len)
+    {
+        begin_container(pos, len);
+        // Each member takes at least two bytes
+        std::vector<key_value_pair_type> members;
+        members.reserve((std::min)(len, static_cast<size_t>(end_ - it_)/2));
+        for (size_t i = 0; i < len; ++i)
+        {
+            key_storage_type key = decode_key();
+            members.emplace_back(std::move(key), decode());
+        }
+        --depth_;
+        Json result = typename Json::object();
+        result.object_value().insert(std::make_move_iterator(members.begin()), std::make_move_iterator(members.end()),
+                                     [](key_value_pair_type&& member){return std::move(member);});
+        return result;
+    }
+
+    // Reads a string key straight into the key storage, without a temporary Json. 
+    // Keys of other kinds are decoded, and must be strings.
+    key_storage_type decode_key()
+    {
+        if (it_ >= end_)
+        {
+            error(msgpack_parser_errc::unexpected_eof, it_);
+        }
+        const uint8_t* pos = it_;
+        size_t len;
+        const uint8_t* first;
+        if (*pos >= 0xa0 && *pos <= 0xbf)
+        {
+            // fixstr
+            len = *pos & 0x1f;
+            first = pos + 1;
+        }
+        else if (*pos == msgpack_format::str8_cd)
+        {
+            len = binary::detail::from_big_endian<uint8_t>(pos + 1,end_);
+            first = pos + 2;
+        }
+        else if (*pos == msgpack_format::str16_cd)
+        {
+            len = binary::detail::from_big_endian<uint16_t>(pos + 1,end_);
+            first = pos + 3;
+        }
+        else if (*pos == msgpack_format::str32_cd)
+        {
+            len = binary::detail::from_big_endian<uint32_t>(pos + 1,end_);
+            first = pos + 5;
+        }
+        else
+        {
+            auto j = decode();
+            auto name = j.as_string_view();
+            return key_storage_type(name.begin(), name.end());
+        }
+        check_string_length(len, pos);
+        it_ = detail::skip(first, end_, len);
+        key_storage_type key;
+        if (!binary::detail::assign_utf8(key, first, it_))
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Illegal unicode");
+        }
+        return key;
+    }
+
+    void begin_container(const uint8_t* pos, size_t len)
+    {
+        if (++depth_ > limits_.max_nesting_depth)
+        {
+            error(msgpack_parser_errc::max_depth_exceeded, pos);
+        }
+        if (len > limits_.max_items)
+        {
+            error(msgpack_parser_errc::max_items_exceeded, pos);
+        }
+    }
+
+    void check_string_length(size_t length, const uint8_t* pos) const
+    {
+        if (length > limits_.max_string_length)
+        {
+            error(msgpack_parser_errc::max_string_length_exceeded, pos);
+        }
+    }
+
+    void error(msgpack_parser_errc ec, const uint8_t* pos) const
+    {
+        throw parse_error(ec, 1, (pos - begin_) + 1);
+    }
 };
 
 template<class Json>
-std::vector<uint8_t> encode_msgpack(const Json& j)
+size_t encoded_msgpack_size(const Json& j)
 {
-    size_t n = 0;
-    msgpack_Encoder_<Json>::encode(j,Calculate_size_(),n);
-    std::vector<uint8_t> v;
-    v.reserve(n);
-    //v.reserve(msgpack_Encoder_<Json>::calculate_size(j));
+    return msgpack_Encoder_<Json>::calculate_size(j);
+}
 
-    msgpack_Encoder_<Json>::encode(j,Encode_msgpack_(),v);
+template<class Json>
+std::vector<uint8_t> encode_msgpack(const Json& j)
+{
+    const size_t n = msgpack_Encoder_<Json>::calculate_size(j);
+    std::vector<uint8_t> v(n);
+    uint8_t* p = v.data();
+    msgpack_Encoder_<Json>::encode(j,Write_msgpack_(),p);
     return v;
 }
 
+// Appends the encoding to v in one pass. v grows by doubling and is then trimmed
+// to the encoding, so a vector that is cleared and reused does not reallocate.
+template<class Json>
+void encode_msgpack(const Json& j, std::vector<uint8_t>& v)
+{
+    binary::detail::output_buffer out(v);
+    msgpack_Encoder_<Json>::encode(j,Encode_msgpack_(),out);
+    out.commit();
+}
+
+// Returns the encoded size. If it is greater than capacity, nothing is written.
+template<class Json>
+size_t encode_msgpack(const Json& j, uint8_t* data, size_t capacity)
+{
+    const size_t n = msgpack_Encoder_<Json>::calculate_size(j);
+    if (n <= capacity)
+    {
+        uint8_t* p = data;
+        msgpack_Encoder_<Json>::encode(j,Write_msgpack_(),p);
+    }
+    return n;
+}
+
+template<class Json>
+Json decode_msgpack(const msgpack_view& v)
+{
+    Decode_msgpack_<Json> decoder(v.buffer(),v.buffer()+v.buflen());
+    return decoder.decode();
+}
+
 template<class Json>
-Json decode_msgpack(const std::vector<uint8_t>& v)
+Json decode_msgpack(const msgpack_view& v, const binary::decode_limits& limits)
 {
-    Decode_msgpack_<Json> decoder(v.data(),v.data()+v.size());
+    Decode_msgpack_<Json> decoder(v.buffer(),v.buffer()+v.buflen(),limits);
     return decoder.decode();
 }
 
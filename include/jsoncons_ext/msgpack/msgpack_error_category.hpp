@@ -0,0 +1,87 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_MSGPACK_MSGPACK_ERROR_CATEGORY_HPP
+#define JSONCONS_MSGPACK_MSGPACK_ERROR_CATEGORY_HPP
+
+#include <system_error>
+#include <jsoncons/json_exception.hpp>
+
+namespace jsoncons { namespace msgpack {
+
+    enum class msgpack_parser_errc : int
+    {
+        ok = 0,
+        unexpected_eof = 1,
+        source_error = 2,
+        invalid_format = 3,
+        invalid_key = 4,
+        invalid_utf8 = 5,
+        max_depth_exceeded = 6,
+        extra_data = 7,
+        max_items_exceeded = 8,
+        max_string_length_exceeded = 9
+    };
+
+class msgpack_error_category_impl
+   : public std::error_category
+{
+public:
+    virtual const char* name() const JSONCONS_NOEXCEPT
+    {
+        return "msgpack";
+    }
+    virtual std::string message(int ev) const
+    {
+        switch (static_cast<msgpack_parser_errc>(ev))
+        {
+        case msgpack_parser_errc::unexpected_eof:
+            return "Unexpected end of file";
+        case msgpack_parser_errc::source_error:
+            return "Source error";
+        case msgpack_parser_errc::invalid_format:
+            return "Invalid MessagePack format byte";
+        case msgpack_parser_errc::invalid_key:
+            return "Map key is not a string or an integer";
+        case msgpack_parser_errc::invalid_utf8:
+            return "Illegal UTF-8 in a string";
+        case msgpack_parser_errc::max_depth_exceeded:
+            return "Maximum nesting depth exceeded";
+        case msgpack_parser_errc::extra_data:
+            return "Unexpected data after the end of the MessagePack object";
+        case msgpack_parser_errc::max_items_exceeded:
+            return "Maximum number of array elements or map members exceeded";
+        case msgpack_parser_errc::max_string_length_exceeded:
+            return "Maximum string length exceeded";
+        default:
+            return "Unknown MessagePack parser error";
+        }
+    }
+};
+
+inline
+const std::error_category& msgpack_error_category()
+{
+  static msgpack_error_category_impl instance;
+  return instance;
+}
+
+inline
+std::error_code make_error_code(msgpack_parser_errc result)
+{
+    return std::error_code(static_cast<int>(result),msgpack_error_category());
+}
+
+}}
+
+namespace std {
+    template<>
+    struct is_error_code_enum<jsoncons::msgpack::msgpack_parser_errc> : public true_type
+    {
+    };
+}
+
+#endif
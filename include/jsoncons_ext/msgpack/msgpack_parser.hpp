@@ -0,0 +1,678 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_MSGPACK_MSGPACK_PARSER_HPP
+#define JSONCONS_MSGPACK_MSGPACK_PARSER_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <system_error>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/jsoncons_utilities.hpp>
+#include <jsoncons/json_input_handler.hpp>
+#include <jsoncons/parse_error_handler.hpp>
+#include <jsoncons/detail/string_scan.hpp>
+#include <jsoncons_ext/msgpack/msgpack_error_category.hpp>
+
+namespace jsoncons { namespace msgpack {
+
+enum class msgpack_parse_state : uint8_t
+{
+    start,
+    format,
+    argument,
+    payload,
+    done
+};
+
+// Parses a MessagePack object incrementally and reports it to a basic_json_input_handler
+// as it goes, as cbor_parser does for CBOR. Input is passed in pieces with set_source, and
+// parse consumes as much of each piece as it can, an object may be split across pieces at
+// any byte. Strings that lie wholly within one piece are passed to the handler without
+// copying, only strings that span pieces are gathered in a buffer. bin is reported as a
+// byte string, as is the data of ext, whose type is dropped.
+
+class msgpack_parser : private parsing_context
+{
+    typedef basic_json_input_handler<char>::string_view_type string_view_type;
+
+    static const size_t initial_stack_capacity_ = 64;
+
+    struct container
+    {
+        bool is_map_;
+        uint64_t length_;
+        uint64_t count_;
+
+        container(bool is_map, uint64_t length)
+            : is_map_(is_map), length_(length), count_(0)
+        {
+        }
+
+        bool expects_key() const
+        {
+            return is_map_ && count_ % 2 == 0;
+        }
+    };
+
+    basic_null_json_input_handler<char> default_input_handler_;
+    basic_json_input_handler<char>& handler_;
+
+    msgpack_parse_state state_;
+    std::vector<container> stack_;
+    int nesting_depth_;
+    int peak_nesting_depth_;
+    int max_depth_;
+
+    const uint8_t* begin_input_;
+    const uint8_t* end_input_;
+    const uint8_t* p_;
+    size_t source_offset_;
+
+    uint8_t format_;
+    size_t argument_remaining_;
+    uint64_t argument_;
+    uint64_t payload_remaining_;
+    std::string buffer_;
+
+    // Noncopyable and nonmoveable
+    msgpack_parser(const msgpack_parser&) = delete;
+    msgpack_parser& operator=(const msgpack_parser&) = delete;
+
+public:
+    msgpack_parser()
+        : handler_(default_input_handler_)
+    {
+        init();
+    }
+
+    msgpack_parser(basic_json_input_handler<char>& handler)
+        : handler_(handler)
+    {
+        init();
+    }
+
+    ~msgpack_parser()
+    {
+    }
+
+    const parsing_context& parsing_context() const
+    {
+        return *this;
+    }
+
+    size_t max_nesting_depth() const
+    {
+        return static_cast<size_t>(max_depth_);
+    }
+
+    // The deepest nesting of arrays and maps since the last reset
+    size_t peak_nesting_depth() const
+    {
+        return static_cast<size_t>(peak_nesting_depth_);
+    }
+
+    void max_nesting_depth(size_t max_nesting_depth)
+    {
+        max_depth_ = static_cast<int>((std::min)(max_nesting_depth,static_cast<size_t>((std::numeric_limits<int>::max)())));
+    }
+
+    bool done() const
+    {
+        return state_ == msgpack_parse_state::done;
+    }
+
+    bool source_exhausted() const
+    {
+        return p_ == end_input_;
+    }
+
+    // The number of bytes consumed since the parser was constructed or reset
+    size_t position() const
+    {
+        return source_offset_ + static_cast<size_t>(p_ - begin_input_);
+    }
+
+    size_t line_number() const
+    {
+        return 1;
+    }
+
+    // One more than the position, as for cbor_parser
+    size_t column_number() const
+    {
+        return position() + 1;
+    }
+
+    msgpack_parse_state state() const
+    {
+        return state_;
+    }
+
+    // Readies the parser for the next object, from the rest of the current source or
+    // from a new one passed to set_source. The stack and the string buffer keep their capacity.
+    void reset()
+    {
+        stack_.clear();
+        state_ = msgpack_parse_state::start;
+        nesting_depth_ = 0;
+        peak_nesting_depth_ = 0;
+        source_offset_ = 0;
+        begin_input_ = p_;
+        argument_remaining_ = 0;
+        argument_ = 0;
+        payload_remaining_ = 0;
+        buffer_.clear();
+    }
+
+    // The bytes are not copied, they must stay valid until parse has consumed them
+    void set_source(const uint8_t* input, size_t length)
+    {
+        source_offset_ += static_cast<size_t>(p_ - begin_input_);
+        begin_input_ = input;
+        end_input_ = input + length;
+        p_ = begin_input_;
+    }
+
+    void parse()
+    {
+        std::error_code ec;
+        parse(ec);
+        if (ec)
+        {
+            throw parse_error(ec,line_number(),column_number());
+        }
+    }
+
+    // Consumes the source until it is exhausted or the object is complete
+    void parse(std::error_code& ec)
+    {
+        while (p_ < end_input_ && state_ != msgpack_parse_state::done)
+        {
+            switch (state_)
+            {
+            case msgpack_parse_state::start:
+                handler_.begin_json();
+                state_ = msgpack_parse_state::format;
+                break;
+            case msgpack_parse_state::format:
+                parse_format(ec);
+                if (ec) return;
+                break;
+            case msgpack_parse_state::argument:
+                while (p_ < end_input_ && argument_remaining_ > 0)
+                {
+                    argument_ = (argument_ << 8) | *p_++;
+                    --argument_remaining_;
+                }
+                if (argument_remaining_ == 0)
+                {
+                    parse_item(ec);
+                    if (ec) return;
+                }
+                break;
+            case msgpack_parse_state::payload:
+                {
+                    size_t n = static_cast<size_t>((std::min)(payload_remaining_, static_cast<uint64_t>(end_input_ - p_)));
+                    buffer_.append(reinterpret_cast<const char*>(p_), n);
+                    p_ += n;
+                    payload_remaining_ -= n;
+                    if (payload_remaining_ == 0)
+                    {
+                        state_ = msgpack_parse_state::format;
+                        string_value(reinterpret_cast<const uint8_t*>(buffer_.data()), buffer_.length(), ec);
+                        if (ec) return;
+                        buffer_.clear();
+                    }
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    void end_parse()
+    {
+        std::error_code ec;
+        end_parse(ec);
+        if (ec)
+        {
+            throw parse_error(ec,line_number(),column_number());
+        }
+    }
+
+    // Reaching the end of the source before an object has begun is not an error
+    void end_parse(std::error_code& ec)
+    {
+        if (!(state_ == msgpack_parse_state::done || state_ == msgpack_parse_state::start))
+        {
+            ec = msgpack_parser_errc::unexpected_eof;
+        }
+    }
+
+    void check_done()
+    {
+        std::error_code ec;
+        check_done(ec);
+        if (ec)
+        {
+            throw parse_error(ec,line_number(),column_number());
+        }
+    }
+
+    // Checks that the object is complete and that nothing follows it in the source
+    void check_done(std::error_code& ec)
+    {
+        if (state_ != msgpack_parse_state::done)
+        {
+            ec = msgpack_parser_errc::unexpected_eof;
+        }
+        else if (p_ != end_input_)
+        {
+            ec = msgpack_parser_errc::extra_data;
+        }
+    }
+
+private:
+    void init()
+    {
+        state_ = msgpack_parse_state::start;
+        nesting_depth_ = 0;
+        peak_nesting_depth_ = 0;
+        max_depth_ = (std::numeric_limits<int>::max)();
+        begin_input_ = nullptr;
+        end_input_ = nullptr;
+        p_ = nullptr;
+        source_offset_ = 0;
+        format_ = 0;
+        argument_remaining_ = 0;
+        argument_ = 0;
+        payload_remaining_ = 0;
+        stack_.reserve(initial_stack_capacity_);
+    }
+
+    // The number of bytes that follow a format byte before its payload, if any. For
+    // ext these are the length and the type, for fixext the type alone.
+    static size_t argument_length(uint8_t format)
+    {
+        switch (format)
+        {
+        case 0xc4: // bin 8
+        case 0xd0: // int 8
+        case 0xcc: // uint 8
+        case 0xd9: // str 8
+        case 0xd4: // fixext 1
+        case 0xd5: // fixext 2
+        case 0xd6: // fixext 4
+        case 0xd7: // fixext 8
+        case 0xd8: // fixext 16
+            return 1;
+        case 0xc5: // bin 16
+        case 0xc7: // ext 8
+        case 0xcd: // uint 16
+        case 0xd1: // int 16
+        case 0xda: // str 16
+        case 0xdc: // array 16
+        case 0xde: // map 16
+            return 2;
+        case 0xc8: // ext 16
+            return 3;
+        case 0xc6: // bin 32
+        case 0xca: // float 32
+        case 0xce: // uint 32
+        case 0xd2: // int 32
+        case 0xdb: // str 32
+        case 0xdd: // array 32
+        case 0xdf: // map 32
+            return 4;
+        case 0xc9: // ext 32
+            return 5;
+        case 0xcb: // float 64
+        case 0xcf: // uint 64
+        case 0xd3: // int 64
+            return 8;
+        default:
+            return 0;
+        }
+    }
+
+    void parse_format(std::error_code& ec)
+    {
+        format_ = *p_++;
+        argument_ = 0;
+        argument_remaining_ = argument_length(format_);
+        if (argument_remaining_ > 0)
+        {
+            state_ = msgpack_parse_state::argument;
+        }
+        else
+        {
+            parse_item(ec);
+        }
+    }
+
+    // Handles a MessagePack object once its format byte and the bytes after it have been read
+    void parse_item(std::error_code& ec)
+    {
+        state_ = msgpack_parse_state::format;
+        const uint8_t format = format_;
+        if (format <= 0x7f)
+        {
+            uinteger_value(format);
+        }
+        else if (format <= 0x8f)
+        {
+            begin_map(format & 0x0f, ec);
+        }
+        else if (format <= 0x9f)
+        {
+            begin_array(format & 0x0f, ec);
+        }
+        else if (format <= 0xbf)
+        {
+            begin_payload(format & 0x1f, ec);
+        }
+        else if (format >= 0xe0)
+        {
+            integer_value(static_cast<int8_t>(format));
+        }
+        else
+        {
+            switch (format)
+            {
+            case 0xc0:
+            case 0xc2:
+            case 0xc3:
+            case 0xca:
+            case 0xcb:
+                scalar_value(ec);
+                break;
+            case 0xcc:
+            case 0xcd:
+            case 0xce:
+            case 0xcf:
+                uinteger_value(argument_);
+                break;
+            case 0xd0:
+                integer_value(static_cast<int8_t>(argument_));
+                break;
+            case 0xd1:
+                integer_value(static_cast<int16_t>(argument_));
+                break;
+            case 0xd2:
+                integer_value(static_cast<int32_t>(argument_));
+                break;
+            case 0xd3:
+                integer_value(static_cast<int64_t>(argument_));
+                break;
+            case 0xd4:
+            case 0xd5:
+            case 0xd6:
+            case 0xd7:
+            case 0xd8:
+                begin_payload(static_cast<uint64_t>(1) << (format - 0xd4), ec);
+                break;
+            case 0xc7:
+            case 0xc8:
+            case 0xc9:
+                // The type follows the length
+                begin_payload(argument_ >> 8, ec);
+                break;
+            case 0xc4:
+            case 0xc5:
+            case 0xc6:
+            case 0xd9:
+            case 0xda:
+            case 0xdb:
+                begin_payload(argument_, ec);
+                break;
+            case 0xdc:
+            case 0xdd:
+                begin_array(argument_, ec);
+                break;
+            case 0xde:
+            case 0xdf:
+                begin_map(argument_, ec);
+                break;
+            default:
+                ec = msgpack_parser_errc::invalid_format;
+                break;
+            }
+        }
+    }
+
+    // nil, true, false and floats, which cannot be keys
+    void scalar_value(std::error_code& ec)
+    {
+        if (expects_key())
+        {
+            ec = msgpack_parser_errc::invalid_key;
+            return;
+        }
+        switch (format_)
+        {
+        case 0xc0:
+            handler_.null_value(*this);
+            break;
+        case 0xc2:
+            handler_.bool_value(false, *this);
+            break;
+        case 0xc3:
+            handler_.bool_value(true, *this);
+            break;
+        case 0xca:
+            {
+                uint32_t bits = static_cast<uint32_t>(argument_);
+                float value;
+                std::memcpy(&value, &bits, sizeof(value));
+                handler_.double_value(value, 0, *this);
+            }
+            break;
+        default:
+            {
+                double value;
+                std::memcpy(&value, &argument_, sizeof(value));
+                handler_.double_value(value, 0, *this);
+            }
+            break;
+        }
+        end_item();
+    }
+
+    void uinteger_value(uint64_t value)
+    {
+        if (expects_key())
+        {
+            std::string name = std::to_string(value);
+            handler_.name(string_view_type(name.data(), name.length()), *this);
+        }
+        else
+        {
+            handler_.uinteger_value(value, *this);
+        }
+        end_item();
+    }
+
+    void integer_value(int64_t value)
+    {
+        if (expects_key())
+        {
+            std::string name = std::to_string(value);
+            handler_.name(string_view_type(name.data(), name.length()), *this);
+        }
+        else
+        {
+            handler_.integer_value(value, *this);
+        }
+        end_item();
+    }
+
+    void begin_payload(uint64_t length, std::error_code& ec)
+    {
+        if (expects_key() && !is_str())
+        {
+            ec = msgpack_parser_errc::invalid_key;
+            return;
+        }
+        if (length <= static_cast<uint64_t>(end_input_ - p_))
+        {
+            // The string lies within the source, pass it on in place
+            const uint8_t* data = p_;
+            p_ += static_cast<size_t>(length);
+            string_value(data, static_cast<size_t>(length), ec);
+        }
+        else
+        {
+            buffer_.clear();
+            payload_remaining_ = length;
+            state_ = msgpack_parse_state::payload;
+        }
+    }
+
+    void begin_array(uint64_t length, std::error_code& ec)
+    {
+        if (expects_key())
+        {
+            ec = msgpack_parser_errc::invalid_key;
+            return;
+        }
+        if (++nesting_depth_ > peak_nesting_depth_)
+        {
+            peak_nesting_depth_ = nesting_depth_;
+        }
+        if (nesting_depth_ > max_depth_)
+        {
+            ec = msgpack_parser_errc::max_depth_exceeded;
+            return;
+        }
+        handler_.begin_array(*this);
+        stack_.push_back(container(false, length));
+        if (length == 0)
+        {
+            end_container();
+        }
+    }
+
+    void begin_map(uint64_t length, std::error_code& ec)
+    {
+        if (expects_key())
+        {
+            ec = msgpack_parser_errc::invalid_key;
+            return;
+        }
+        if (++nesting_depth_ > peak_nesting_depth_)
+        {
+            peak_nesting_depth_ = nesting_depth_;
+        }
+        if (nesting_depth_ > max_depth_)
+        {
+            ec = msgpack_parser_errc::max_depth_exceeded;
+            return;
+        }
+        handler_.begin_object(*this);
+        stack_.push_back(container(true, 2*length));
+        if (length == 0)
+        {
+            end_container();
+        }
+    }
+
+    // Closes the array or map on top of the stack, which is itself an item of its parent
+    void end_container()
+    {
+        if (stack_.back().is_map_)
+        {
+            handler_.end_object(*this);
+        }
+        else
+        {
+            handler_.end_array(*this);
+        }
+        stack_.pop_back();
+        --nesting_depth_;
+        end_item();
+    }
+
+    // Counts a completed object against its container, closing containers that are full
+    void end_item()
+    {
+        while (!stack_.empty())
+        {
+            container& top = stack_.back();
+            ++top.count_;
+            if (top.count_ < top.length_)
+            {
+                return;
+            }
+            if (top.is_map_)
+            {
+                handler_.end_object(*this);
+            }
+            else
+            {
+                handler_.end_array(*this);
+            }
+            stack_.pop_back();
+            --nesting_depth_;
+        }
+        state_ = msgpack_parse_state::done;
+        handler_.end_json();
+    }
+
+    void string_value(const uint8_t* data, size_t length, std::error_code& ec)
+    {
+        if (!is_str())
+        {
+            handler_.byte_string_value(data, length, *this);
+            end_item();
+            return;
+        }
+        if (!jsoncons::detail::is_valid_utf8(reinterpret_cast<const char*>(data), length))
+        {
+            ec = msgpack_parser_errc::invalid_utf8;
+            return;
+        }
+        if (expects_key())
+        {
+            handler_.name(string_view_type(reinterpret_cast<const char*>(data), length), *this);
+        }
+        else
+        {
+            handler_.string_value(string_view_type(reinterpret_cast<const char*>(data), length), *this);
+        }
+        end_item();
+    }
+
+    // fixstr, str 8, str 16 or str 32, rather than bin or ext
+    bool is_str() const
+    {
+        return (format_ >= 0xa0 && format_ <= 0xbf) || (format_ >= 0xd9 && format_ <= 0xdb);
+    }
+
+    bool expects_key() const
+    {
+        return !stack_.empty() && stack_.back().expects_key();
+    }
+
+    size_t do_line_number() const override
+    {
+        return line_number();
+    }
+
+    size_t do_column_number() const override
+    {
+        return column_number();
+    }
+};
+
+}}
+
+#endif
@@ -0,0 +1,275 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_MSGPACK_MSGPACK_READER_HPP
+#define JSONCONS_MSGPACK_MSGPACK_READER_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <istream>
+#include <system_error>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/json_input_handler.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/input_source.hpp>
+#include <jsoncons/json_trace.hpp>
+#include <jsoncons_ext/msgpack/msgpack_parser.hpp>
+
+namespace jsoncons { namespace msgpack {
+
+// Reads MessagePack objects from a stream a buffer at a time, so memory use
+// depends on the buffer length and the nesting depth, not on the size of the object.
+
+class msgpack_reader
+{
+    static const size_t default_max_buffer_length = 16384;
+
+    msgpack_parser parser_;
+    stream_source stream_source_;
+    input_source* source_;
+    bool eof_;
+    std::vector<uint8_t> buffer_;
+    size_t buffer_length_;
+    jsoncons::detail::trace_recorder trace_;
+
+    // Noncopyable and nonmoveable
+    msgpack_reader(const msgpack_reader&) = delete;
+    msgpack_reader& operator=(const msgpack_reader&) = delete;
+
+public:
+
+    msgpack_reader(std::istream& is)
+        : parser_(),
+          stream_source_(is),
+          source_(std::addressof(stream_source_)),
+          eof_(false),
+          buffer_length_(default_max_buffer_length),
+          trace_("msgpack_reader")
+    {
+        buffer_.reserve(buffer_length_);
+    }
+
+    msgpack_reader(std::istream& is,
+                basic_json_input_handler<char>& handler)
+        : parser_(handler),
+          stream_source_(is),
+          source_(std::addressof(stream_source_)),
+          eof_(false),
+          buffer_length_(default_max_buffer_length),
+          trace_("msgpack_reader")
+    {
+        buffer_.reserve(buffer_length_);
+    }
+
+    // Reads from a source, which fills the reader's buffer directly
+    msgpack_reader(input_source& source)
+        : parser_(),
+          source_(std::addressof(source)),
+          eof_(false),
+          buffer_length_(default_max_buffer_length),
+          trace_("msgpack_reader")
+    {
+        buffer_.reserve(buffer_length_);
+    }
+
+    msgpack_reader(input_source& source,
+                   basic_json_input_handler<char>& handler)
+        : parser_(handler),
+          source_(std::addressof(source)),
+          eof_(false),
+          buffer_length_(default_max_buffer_length),
+          trace_("msgpack_reader")
+    {
+        buffer_.reserve(buffer_length_);
+    }
+
+    // Readies the reader to read from another stream, keeping the parser's and the
+    // reader's buffers. The input handler given at construction is kept.
+    void reset(std::istream& is)
+    {
+        stream_source_.reset(is);
+        reset(stream_source_);
+    }
+
+    // Readies the reader to read from another source
+    void reset(input_source& source)
+    {
+        source_ = std::addressof(source);
+        eof_ = false;
+        buffer_.clear();
+        parser_.set_source(buffer_.data(), 0);
+        parser_.reset();
+    }
+
+    size_t buffer_length() const
+    {
+        return buffer_length_;
+    }
+
+    void buffer_length(size_t length)
+    {
+        buffer_length_ = length;
+        buffer_.reserve(buffer_length_);
+    }
+
+    size_t max_nesting_depth() const
+    {
+        return parser_.max_nesting_depth();
+    }
+
+    void max_nesting_depth(size_t depth)
+    {
+        parser_.max_nesting_depth(depth);
+    }
+
+    // The number of bytes of the current object consumed so far
+    size_t position() const
+    {
+        return parser_.position();
+    }
+
+    bool eof() const
+    {
+        return eof_;
+    }
+
+    // The tracer is given a record for each data item read by read_next, with the bytes
+    // and reads taken from the source, the time spent reading, and the deepest nesting
+    json_tracer* tracer() const
+    {
+        return trace_.tracer();
+    }
+
+    void tracer(json_tracer* tracer)
+    {
+        trace_.tracer(tracer);
+    }
+
+    void read_next()
+    {
+        std::error_code ec;
+        read_next(ec);
+        if (ec)
+        {
+            throw parse_error(ec,parser_.line_number(),parser_.column_number());
+        }
+    }
+
+    // Reads one object, the stream may hold more
+    void read_next(std::error_code& ec)
+    {
+        trace_.begin();
+        parse_next(ec);
+        if (trace_.active())
+        {
+            trace_.record().max_depth = parser_.peak_nesting_depth();
+            trace_.end();
+        }
+    }
+
+    void check_done()
+    {
+        std::error_code ec;
+        check_done(ec);
+        if (ec)
+        {
+            throw parse_error(ec,parser_.line_number(),parser_.column_number());
+        }
+    }
+
+    // Checks that nothing follows the object in the stream
+    void check_done(std::error_code& ec)
+    {
+        if (!eof_ && parser_.source_exhausted())
+        {
+            read_buffer(ec);
+            if (ec) return;
+        }
+        parser_.check_done(ec);
+    }
+
+    void read()
+    {
+        read_next();
+        check_done();
+    }
+
+    void read(std::error_code& ec)
+    {
+        read_next(ec);
+        if (!ec)
+        {
+            check_done(ec);
+        }
+    }
+
+private:
+    void parse_next(std::error_code& ec)
+    {
+        parser_.reset();
+        while (!eof_ && !parser_.done())
+        {
+            if (parser_.source_exhausted())
+            {
+                read_buffer(ec);
+                if (ec) return;
+            }
+            if (!eof_)
+            {
+                parser_.parse(ec);
+                if (ec) return;
+            }
+        }
+        if (eof_)
+        {
+            parser_.end_parse(ec);
+        }
+    }
+
+    void read_buffer(std::error_code& ec)
+    {
+        if (source_->eof())
+        {
+            eof_ = true;
+            return;
+        }
+        if (source_->fail())
+        {
+            ec = msgpack_parser_errc::source_error;
+            return;
+        }
+        buffer_.clear();
+        buffer_.resize(buffer_length_);
+        char* data = reinterpret_cast<char*>(buffer_.data());
+        buffer_.resize(trace_.active() ? trace_.read(*source_, data, buffer_length_)
+                                       : source_->read(data, buffer_length_));
+        if (source_->fail())
+        {
+            ec = msgpack_parser_errc::source_error;
+            return;
+        }
+        if (buffer_.size() == 0)
+        {
+            eof_ = true;
+        }
+        parser_.set_source(buffer_.data(),buffer_.size());
+    }
+};
+
+// Decodes a MessagePack object read from a stream
+template<class Json>
+Json decode_msgpack(std::istream& is)
+{
+    json_decoder<Json> decoder;
+    msgpack_reader reader(is, decoder);
+    reader.read();
+    return decoder.get_result();
+}
+
+}}
+
+#endif
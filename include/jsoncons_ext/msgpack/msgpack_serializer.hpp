@@ -0,0 +1,372 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_MSGPACK_MSGPACK_SERIALIZER_HPP
+#define JSONCONS_MSGPACK_MSGPACK_SERIALIZER_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/jsoncons_utilities.hpp>
+#include <jsoncons/json_output_handler.hpp>
+#include <jsoncons/json_trace.hpp>
+#include <jsoncons/output_sink.hpp>
+#include <jsoncons/detail/string_scan.hpp>
+#include <jsoncons_ext/binary/binary_utilities.hpp>
+#include <jsoncons_ext/msgpack/msgpack.hpp>
+
+namespace jsoncons { namespace msgpack {
+
+// Writes MessagePack as the events arrive, without a json value. MessagePack has no
+// indefinite lengths, so a map or array header cannot be written until it ends. Each
+// top level object is encoded into a buffer, with five bytes held for the header of
+// each map and array. When one ends its header is written in as few bytes as the
+// length fits and its items moved down to follow it, and when the top level object
+// is complete the buffer is written out. The output is the same as encode_msgpack's,
+// and memory grows with the largest top level object rather than the whole output.
+
+class msgpack_serializer : public basic_json_output_handler<char>
+{
+public:
+    using basic_json_output_handler<char>::string_view_type;
+private:
+    static const size_t max_header_length = 5;
+
+    struct container
+    {
+        bool is_map_;
+        size_t offset_;
+        size_t count_;
+
+        container(bool is_map, size_t offset)
+            : is_map_(is_map), offset_(offset), count_(0)
+        {
+        }
+    };
+
+    buffered_output<char> bos_;
+    jsoncons::detail::trace_recorder trace_;
+    std::vector<container> stack_;
+    std::vector<uint8_t> buffer_;
+
+    // Noncopyable and nonmoveable
+    msgpack_serializer(const msgpack_serializer&) = delete;
+    msgpack_serializer& operator=(const msgpack_serializer&) = delete;
+public:
+    msgpack_serializer(std::ostream& os)
+       : bos_(os),
+         trace_("msgpack_serializer")
+    {
+    }
+
+    msgpack_serializer(basic_output_sink<char>& sink)
+       : bos_(sink),
+         trace_("msgpack_serializer")
+    {
+    }
+
+    ~msgpack_serializer()
+    {
+    }
+
+    // The tracer is given a record for each data item, with the bytes written, the writes
+    // to the stream or sink, the names and values, the deepest nesting, and the time from
+    // begin_json to end_json
+    json_tracer* tracer() const
+    {
+        return trace_.tracer();
+    }
+
+    void tracer(json_tracer* tracer)
+    {
+        trace_.tracer(tracer);
+    }
+
+    // Writes the encoded data item as it is, in place of a value, so that the parts of
+    // a record that pass through unchanged are copied rather than decoded and encoded
+    void encoded_value(const msgpack_view& v)
+    {
+        buffer_.insert(buffer_.end(), v.buffer(), v.buffer() + v.buflen());
+        end_value();
+    }
+
+private:
+    void do_begin_json() override
+    {
+        trace_.begin(bos_);
+    }
+
+    void do_end_json() override
+    {
+        bos_.flush();
+        trace_.end(bos_);
+    }
+
+    void do_begin_object() override
+    {
+        trace_.token();
+        trace_.begin_container();
+        begin_container(true);
+    }
+
+    void do_end_object() override
+    {
+        trace_.end_container();
+        end_container();
+    }
+
+    void do_begin_array() override
+    {
+        trace_.token();
+        trace_.begin_container();
+        begin_container(false);
+    }
+
+    void do_end_array() override
+    {
+        trace_.end_container();
+        end_container();
+    }
+
+    void do_name(const string_view_type& name) override
+    {
+        trace_.token();
+        write_string(name);
+    }
+
+    void do_null_value() override
+    {
+        trace_.token();
+        buffer_.push_back(0xc0);
+        end_value();
+    }
+
+    void do_string_value(const string_view_type& value) override
+    {
+        trace_.token();
+        write_string(value);
+        end_value();
+    }
+
+    void do_byte_string_value(const uint8_t* data, size_t length) override
+    {
+        trace_.token();
+        if (length <= (std::numeric_limits<uint8_t>::max)())
+        {
+            buffer_.push_back(0xc4);
+            binary::detail::to_big_endian(static_cast<uint8_t>(length), buffer_);
+        }
+        else if (length <= (std::numeric_limits<uint16_t>::max)())
+        {
+            buffer_.push_back(0xc5);
+            binary::detail::to_big_endian(static_cast<uint16_t>(length), buffer_);
+        }
+        else
+        {
+            buffer_.push_back(0xc6);
+            binary::detail::to_big_endian(static_cast<uint32_t>(length), buffer_);
+        }
+        buffer_.insert(buffer_.end(), data, data + length);
+        end_value();
+    }
+
+    void do_double_value(double value, uint8_t) override
+    {
+        trace_.token();
+        buffer_.push_back(0xcb);
+        binary::detail::to_big_endian(value, buffer_);
+        end_value();
+    }
+
+    // As encode_msgpack, the shortest format, and int 64 for positive values over 32 bits
+    void do_integer_value(int64_t value) override
+    {
+        trace_.token();
+        if (value >= 0)
+        {
+            if (value <= (std::numeric_limits<uint32_t>::max)())
+            {
+                write_uinteger(static_cast<uint64_t>(value));
+            }
+            else
+            {
+                buffer_.push_back(0xd3);
+                binary::detail::to_big_endian(value, buffer_);
+            }
+        }
+        else if (value >= -32)
+        {
+            // negative fixint
+            buffer_.push_back(static_cast<uint8_t>(value));
+        }
+        else if (value >= (std::numeric_limits<int8_t>::min)())
+        {
+            buffer_.push_back(0xd0);
+            binary::detail::to_big_endian(static_cast<int8_t>(value), buffer_);
+        }
+        else if (value >= (std::numeric_limits<int16_t>::min)())
+        {
+            buffer_.push_back(0xd1);
+            binary::detail::to_big_endian(static_cast<int16_t>(value), buffer_);
+        }
+        else if (value >= (std::numeric_limits<int32_t>::min)())
+        {
+            buffer_.push_back(0xd2);
+            binary::detail::to_big_endian(static_cast<int32_t>(value), buffer_);
+        }
+        else
+        {
+            buffer_.push_back(0xd3);
+            binary::detail::to_big_endian(value, buffer_);
+        }
+        end_value();
+    }
+
+    void do_uinteger_value(uint64_t value) override
+    {
+        trace_.token();
+        if (value <= (std::numeric_limits<uint32_t>::max)())
+        {
+            write_uinteger(value);
+        }
+        else
+        {
+            buffer_.push_back(0xcf);
+            binary::detail::to_big_endian(value, buffer_);
+        }
+        end_value();
+    }
+
+    void do_bool_value(bool value) override
+    {
+        trace_.token();
+        buffer_.push_back(value ? 0xc3 : 0xc2);
+        end_value();
+    }
+
+    // positive fixint, uint 8, uint 16 or uint 32
+    void write_uinteger(uint64_t value)
+    {
+        if (value <= (std::numeric_limits<int8_t>::max)())
+        {
+            buffer_.push_back(static_cast<uint8_t>(value));
+        }
+        else if (value <= (std::numeric_limits<uint8_t>::max)())
+        {
+            buffer_.push_back(0xcc);
+            binary::detail::to_big_endian(static_cast<uint8_t>(value), buffer_);
+        }
+        else if (value <= (std::numeric_limits<uint16_t>::max)())
+        {
+            buffer_.push_back(0xcd);
+            binary::detail::to_big_endian(static_cast<uint16_t>(value), buffer_);
+        }
+        else
+        {
+            buffer_.push_back(0xce);
+            binary::detail::to_big_endian(static_cast<uint32_t>(value), buffer_);
+        }
+    }
+
+    // UTF-8 strings are written as they are, once validated
+    void write_string(const string_view_type& sv)
+    {
+        if (!jsoncons::detail::is_valid_utf8(sv.data(), sv.length()))
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Illegal unicode");
+        }
+        const size_t length = sv.length();
+        if (length <= 31)
+        {
+            buffer_.push_back(static_cast<uint8_t>(0xa0 | length));
+        }
+        else if (length <= (std::numeric_limits<uint8_t>::max)())
+        {
+            buffer_.push_back(0xd9);
+            binary::detail::to_big_endian(static_cast<uint8_t>(length), buffer_);
+        }
+        else if (length <= (std::numeric_limits<uint16_t>::max)())
+        {
+            buffer_.push_back(0xda);
+            binary::detail::to_big_endian(static_cast<uint16_t>(length), buffer_);
+        }
+        else
+        {
+            buffer_.push_back(0xdb);
+            binary::detail::to_big_endian(static_cast<uint32_t>(length), buffer_);
+        }
+        buffer_.insert(buffer_.end(), sv.data(), sv.data() + length);
+    }
+
+    void begin_container(bool is_map)
+    {
+        stack_.push_back(container(is_map, buffer_.size()));
+        buffer_.resize(buffer_.size() + max_header_length);
+    }
+
+    // Writes the header of the map or array on top of the stack over the bytes held for
+    // it, and moves its items down if the header is shorter
+    void end_container()
+    {
+        JSONCONS_ASSERT(!stack_.empty());
+        const container top = stack_.back();
+        stack_.pop_back();
+
+        uint8_t header[max_header_length];
+        size_t header_length;
+        if (top.count_ <= 15)
+        {
+            header[0] = static_cast<uint8_t>((top.is_map_ ? 0x80 : 0x90) | top.count_);
+            header_length = 1;
+        }
+        else if (top.count_ <= (std::numeric_limits<uint16_t>::max)())
+        {
+            header[0] = top.is_map_ ? 0xde : 0xdc;
+            uint8_t* p = header + 1;
+            binary::detail::to_big_endian(static_cast<uint16_t>(top.count_), p);
+            header_length = 3;
+        }
+        else
+        {
+            header[0] = top.is_map_ ? 0xdf : 0xdd;
+            uint8_t* p = header + 1;
+            binary::detail::to_big_endian(static_cast<uint32_t>(top.count_), p);
+            header_length = 5;
+        }
+
+        uint8_t* first = buffer_.data() + top.offset_;
+        if (header_length < max_header_length)
+        {
+            const size_t items_length = buffer_.size() - top.offset_ - max_header_length;
+            std::memmove(first + header_length, first + max_header_length, items_length);
+            buffer_.resize(buffer_.size() - (max_header_length - header_length));
+        }
+        std::memcpy(first, header, header_length);
+        end_value();
+    }
+
+    // Counts a value against its array, or a member against its map, or writes out
+    // the buffer if the value is at the top level
+    void end_value()
+    {
+        if (!stack_.empty())
+        {
+            ++stack_.back().count_;
+            return;
+        }
+        bos_.write(reinterpret_cast<const char*>(buffer_.data()), buffer_.size());
+        buffer_.clear();
+    }
+};
+
+}}
+
+#endif
@@ -0,0 +1,142 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_MSGPACK_MSGPACK_TRANSCODE_HPP
+#define JSONCONS_MSGPACK_MSGPACK_TRANSCODE_HPP
+
+#include <istream>
+#include <ostream>
+#include <system_error>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/json_filter.hpp>
+#include <jsoncons/json_reader.hpp>
+#include <jsoncons/json_serializer.hpp>
+#include <jsoncons/serialization_options.hpp>
+#include <jsoncons/input_source.hpp>
+#include <jsoncons/output_sink.hpp>
+#include <jsoncons_ext/msgpack/msgpack_reader.hpp>
+#include <jsoncons_ext/msgpack/msgpack_serializer.hpp>
+
+namespace jsoncons { namespace msgpack {
+
+// Transcode between JSON text and MessagePack by passing the reader's events straight to
+// the serializer, without a json value. MessagePack writes the length of a map or array
+// before its items, so msgpack_serializer holds each top level object until it ends, and
+// json_to_msgpack needs memory for the largest one, in MessagePack, not for a json value.
+// msgpack_to_json depends only on the buffers and the nesting depth. Input and output are
+// streams, or a source and a sink. The overloads without an error code throw a parse_error
+// if the input is not valid.
+
+namespace detail {
+
+    template <class Input, class Output>
+    void json_to_msgpack(Input& input, Output& output)
+    {
+        msgpack_serializer serializer(output);
+        basic_json_input_output_handler_adapter<char> adapter(serializer);
+        json_reader reader(input, adapter);
+        reader.read();
+    }
+
+    template <class Input, class Output>
+    void json_to_msgpack(Input& input, Output& output, std::error_code& ec)
+    {
+        msgpack_serializer serializer(output);
+        basic_json_input_output_handler_adapter<char> adapter(serializer);
+        json_reader reader(input, adapter);
+        reader.read(ec);
+    }
+
+    template <class Input, class Output>
+    void msgpack_to_json(Input& input, Output& output, const serialization_options& options)
+    {
+        json_serializer serializer(output, options);
+        basic_json_input_output_handler_adapter<char> adapter(serializer);
+        msgpack_reader reader(input, adapter);
+        reader.read();
+    }
+
+    template <class Input, class Output>
+    void msgpack_to_json(Input& input, Output& output, const serialization_options& options, std::error_code& ec)
+    {
+        json_serializer serializer(output, options);
+        basic_json_input_output_handler_adapter<char> adapter(serializer);
+        msgpack_reader reader(input, adapter);
+        reader.read(ec);
+    }
+}
+
+// Reads a JSON text and writes it as a MessagePack object, as encode_msgpack would
+
+inline
+void json_to_msgpack(std::istream& is, std::ostream& os)
+{
+    detail::json_to_msgpack(is, os);
+}
+
+inline
+void json_to_msgpack(std::istream& is, std::ostream& os, std::error_code& ec)
+{
+    detail::json_to_msgpack(is, os, ec);
+}
+
+inline
+void json_to_msgpack(input_source& source, output_sink& sink)
+{
+    detail::json_to_msgpack(source, sink);
+}
+
+inline
+void json_to_msgpack(input_source& source, output_sink& sink, std::error_code& ec)
+{
+    detail::json_to_msgpack(source, sink, ec);
+}
+
+// Reads a MessagePack object and writes it as JSON text
+
+inline
+void msgpack_to_json(std::istream& is, std::ostream& os, 
+                  const serialization_options& options = serialization_options())
+{
+    detail::msgpack_to_json(is, os, options);
+}
+
+inline
+void msgpack_to_json(std::istream& is, std::ostream& os, std::error_code& ec)
+{
+    detail::msgpack_to_json(is, os, serialization_options(), ec);
+}
+
+inline
+void msgpack_to_json(std::istream& is, std::ostream& os, 
+                  const serialization_options& options, std::error_code& ec)
+{
+    detail::msgpack_to_json(is, os, options, ec);
+}
+
+inline
+void msgpack_to_json(input_source& source, output_sink& sink, 
+                  const serialization_options& options = serialization_options())
+{
+    detail::msgpack_to_json(source, sink, options);
+}
+
+inline
+void msgpack_to_json(input_source& source, output_sink& sink, std::error_code& ec)
+{
+    detail::msgpack_to_json(source, sink, serialization_options(), ec);
+}
+
+inline
+void msgpack_to_json(input_source& source, output_sink& sink, 
+                  const serialization_options& options, std::error_code& ec)
+{
+    detail::msgpack_to_json(source, sink, options, ec);
+}
+
+}}
+
+#endif
@@ -1,31 +1,11 @@
-#include <boost/interprocess/managed_shared_memory.hpp>
-#include <boost/interprocess/containers/vector.hpp>
-#include <boost/interprocess/allocators/allocator.hpp>
-#include <boost/interprocess/containers/string.hpp>
 #include <cstdlib> //std::system
 #include <jsoncons/json.hpp>
+#include <jsoncons_ext/interprocess/shm_json.hpp>
 
 using namespace jsoncons;
+using namespace jsoncons::interprocess;
 
-typedef boost::interprocess::allocator<int,
-        boost::interprocess::managed_shared_memory::segment_manager> shmem_allocator;
-
-struct boost_sorted_policy : public sorted_policy
-{
-    template <class T,class Allocator>
-    using object_storage = boost::interprocess::vector<T,Allocator>;
-
-    template <class T, class Allocator>
-    using array_storage = boost::interprocess::vector<T,Allocator>;
-
-    template <class CharT, class CharTraits, class Allocator>
-    using key_storage = boost::interprocess::basic_string<CharT, CharTraits, Allocator>;
-
-    template <class CharT, class CharTraits, class Allocator>
-    using string_storage = boost::interprocess::basic_string<CharT, CharTraits, Allocator>;
-};
-
-typedef basic_json<char,boost_sorted_policy,shmem_allocator> shm_json;
+typedef shm_allocator shmem_allocator;
 
 int main(int argc, char *argv[])
 {
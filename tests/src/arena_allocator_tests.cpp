@@ -0,0 +1,110 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/json_parser.hpp>
+#include <jsoncons/arena_allocator.hpp>
+#include <sstream>
+#include <cstring>
+#include <vector>
+#include <utility>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(arena_allocator_tests)
+
+typedef basic_json<char,sorted_policy,arena_allocator<char>> arena_json;
+typedef basic_json<char,preserve_order_policy,arena_allocator<char>> arena_ojson;
+
+template <class Json>
+Json decode(const std::string& s, arena& a)
+{
+    arena_allocator<char> alloc(a);
+    json_decoder<Json> decoder(alloc);
+    json_parser parser(decoder);
+    parser.set_source(s.data(), s.length());
+    parser.parse();
+    parser.end_parse();
+    parser.check_done();
+    return decoder.get_result();
+}
+
+BOOST_AUTO_TEST_CASE(test_arena_allocate)
+{
+    arena a(64);
+    void* p1 = a.allocate(10, 1);
+    void* p2 = a.allocate(8, 8);
+    BOOST_CHECK(p1 != p2);
+    BOOST_CHECK_EQUAL(0, reinterpret_cast<uintptr_t>(p2) % 8);
+
+    // Larger than the block size
+    void* p3 = a.allocate(1000, 16);
+    BOOST_CHECK(p3 != nullptr);
+    BOOST_CHECK_EQUAL(0, reinterpret_cast<uintptr_t>(p3) % 16);
+    BOOST_CHECK_EQUAL(1018, a.bytes_allocated());
+
+    a.release();
+    BOOST_CHECK_EQUAL(0, a.bytes_allocated());
+}
+
+BOOST_AUTO_TEST_CASE(test_arena_odd_block_size)
+{
+    // The block ends short of the next 8 byte boundary, so aligning the
+    // position goes past the end of the block
+    arena a(100);
+    a.allocate(100 - 2*sizeof(void*) - 1, 1);
+    char* p = static_cast<char*>(a.allocate(8, 8));
+    BOOST_CHECK_EQUAL(0, reinterpret_cast<uintptr_t>(p) % 8);
+    std::memset(p, 0xff, 8);
+    BOOST_CHECK_EQUAL(100 - 2*sizeof(void*) - 1 + 8, a.bytes_allocated());
+}
+
+BOOST_AUTO_TEST_CASE(test_decode_with_arena)
+{
+    std::string s = "{\"name\":\"a string that is too long for the short string buffer\",\"items\":[1,-2,3.5,true,null,{\"key\":\"value\"}]}";
+
+    arena a;
+    {
+        arena_json j = decode<arena_json>(s, a);
+        BOOST_CHECK(a.bytes_allocated() > 0);
+
+        BOOST_CHECK_EQUAL(std::string("a string that is too long for the short string buffer"), j["name"].as<std::string>());
+        BOOST_REQUIRE_EQUAL(6, j["items"].size());
+        BOOST_CHECK_EQUAL(-2, j["items"][1].as<int>());
+        BOOST_CHECK_EQUAL(std::string("value"), j["items"][5]["key"].as<std::string>());
+
+        std::ostringstream os;
+        os << j;
+        BOOST_CHECK_EQUAL(json::parse(s), json::parse(os.str()));
+    }
+    a.release();
+}
+
+BOOST_AUTO_TEST_CASE(test_ojson_decode_with_arena)
+{
+    std::string s = "{\"b\":1,\"a\":[\"x\",\"y\"],\"c\":{}}";
+
+    arena a;
+    arena_ojson j = decode<arena_ojson>(s, a);
+    BOOST_CHECK_EQUAL(std::string("b"), j.object_range().begin()->key());
+    BOOST_CHECK(j["c"].object_range().begin() == j["c"].object_range().end());
+}
+
+BOOST_AUTO_TEST_CASE(test_build_with_arena)
+{
+    arena a;
+    arena_allocator<char> alloc(a);
+
+    arena_json j = arena_json::object(alloc);
+    j["field1"] = arena_json::array(alloc);
+    j["field1"].push_back(arena_json("another string that is too long for the short string buffer", alloc));
+    j.insert_or_assign("field2", 10);
+
+    arena_json k(j, alloc);
+    BOOST_CHECK(j == k);
+    BOOST_CHECK_EQUAL(2, k.size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,255 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/async_json_reader.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(async_json_reader_tests)
+
+namespace {
+
+// Hands out a string a few characters at a time, through post, which decides when the
+// read completes
+class chunked_connection
+{
+public:
+    typedef std::function<void(std::function<void()>)> post_function;
+private:
+    std::string text_;
+    size_t chunk_;
+    size_t pos_;
+    post_function post_;
+public:
+    chunked_connection(const std::string& text, size_t chunk, post_function post)
+        : text_(text), chunk_(chunk), pos_(0), post_(post)
+    {
+    }
+
+    void read_some(char* data, size_t length, async_json_reader::read_handler handler)
+    {
+        post_([this,data,length,handler]()
+        {
+            size_t n = (std::min)((std::min)(length, chunk_), text_.size() - pos_);
+            std::copy(text_.data() + pos_, text_.data() + pos_ + n, data);
+            pos_ += n;
+            handler(n, std::error_code());
+        });
+    }
+};
+
+// Reads every text of a connection, asking for the next from the completion handler
+struct session
+{
+    chunked_connection connection;
+    json_decoder<json> decoder;
+    async_json_reader reader;
+    std::vector<json> values;
+    std::error_code ec;
+    bool done;
+
+    session(const std::string& text, size_t chunk, chunked_connection::post_function post)
+        : connection(text, chunk, post),
+          reader([this](char* data, size_t length, async_json_reader::read_handler handler)
+                 {connection.read_some(data, length, handler);},
+                 decoder),
+          done(false)
+    {
+    }
+
+    void start(std::function<void()> on_done = std::function<void()>())
+    {
+        reader.async_read_next([this,on_done](const std::error_code& e)
+        {
+            if (e || reader.eof())
+            {
+                ec = e;
+                done = true;
+                if (on_done)
+                {
+                    on_done();
+                }
+                return;
+            }
+            values.push_back(decoder.get_result());
+            start(on_done);
+        });
+    }
+};
+
+std::string make_lines(size_t n)
+{
+    std::string s;
+    for (size_t i = 0; i < n; ++i)
+    {
+        s += "{\"id\":" + std::to_string(i) + ",\"name\":\"line " + std::to_string(i) + "\",\"values\":[1,2.5,\"three\"]}\n";
+    }
+    return s;
+}
+
+void check_lines(const std::vector<json>& values, size_t n)
+{
+    BOOST_REQUIRE_EQUAL(n, values.size());
+    for (size_t i = 0; i < n; ++i)
+    {
+        BOOST_CHECK_EQUAL(i, values[i]["id"].as<size_t>());
+    }
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(test_async_json_reader_inline_reads)
+{
+    // Reads that complete inside the read function, one character at a time
+    auto now = [](std::function<void()> f) {f();};
+    session s(make_lines(2000), 1, now);
+    s.reader.buffer_length(7);
+    s.start();
+    BOOST_CHECK(s.done);
+    BOOST_CHECK(!s.ec);
+    check_lines(s.values, 2000);
+
+    session t(make_lines(2000), 100000, now);
+    t.start();
+    BOOST_CHECK(t.done);
+    check_lines(t.values, 2000);
+}
+
+BOOST_AUTO_TEST_CASE(test_async_json_reader_event_loop)
+{
+    // Many connections served by one loop, reads completing in turn
+    std::deque<std::function<void()>> ready;
+    auto post = [&ready](std::function<void()> f) {ready.push_back(f);};
+
+    std::vector<std::unique_ptr<session>> sessions;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        sessions.emplace_back(new session(make_lines(i), 1 + i % 37, post));
+        sessions.back()->reader.buffer_length(16 + i);
+        sessions.back()->start();
+    }
+    BOOST_CHECK(!ready.empty());
+    while (!ready.empty())
+    {
+        std::function<void()> f = ready.front();
+        ready.pop_front();
+        f();
+    }
+    for (size_t i = 0; i < sessions.size(); ++i)
+    {
+        BOOST_CHECK(sessions[i]->done);
+        BOOST_CHECK(!sessions[i]->ec);
+        check_lines(sessions[i]->values, i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_async_json_reader_thread_pool)
+{
+    // Reads completing on any of several threads
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::function<void()>> ready;
+    bool stop = false;
+    size_t finished = 0;
+
+    auto post = [&](std::function<void()> f)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ready.push_back(f);
+        }
+        cv.notify_one();
+    };
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&]()
+        {
+            for (;;)
+            {
+                std::function<void()> f;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [&]{return stop || !ready.empty();});
+                    if (ready.empty())
+                    {
+                        return;
+                    }
+                    f = ready.front();
+                    ready.pop_front();
+                }
+                f();
+            }
+        });
+    }
+
+    std::vector<std::unique_ptr<session>> sessions;
+    for (size_t i = 0; i < 50; ++i)
+    {
+        sessions.emplace_back(new session(make_lines(20 + i), 5 + i, post));
+        sessions.back()->reader.buffer_length(64);
+    }
+    for (auto& s : sessions)
+    {
+        s->start([&]()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (++finished == sessions.size())
+            {
+                stop = true;
+                cv.notify_all();
+            }
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    for (size_t i = 0; i < sessions.size(); ++i)
+    {
+        BOOST_CHECK(!sessions[i]->ec);
+        check_lines(sessions[i]->values, 20 + i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_async_json_reader_errors)
+{
+    auto now = [](std::function<void()> f) {f();};
+
+    session numbers("1 2\n 42", 2, now);
+    numbers.start();
+    BOOST_CHECK(!numbers.ec);
+    BOOST_REQUIRE_EQUAL(3, numbers.values.size());
+    BOOST_CHECK_EQUAL(42, numbers.values[2].as<int>());
+
+    session truncated("{\"a\":1}\n{\"b\":", 3, now);
+    truncated.start();
+    BOOST_CHECK_EQUAL(1, truncated.values.size());
+    BOOST_CHECK(truncated.ec == json_parser_errc::unexpected_eof);
+
+    session invalid("[1,2]\n[1,,2]", 4, now);
+    invalid.start();
+    BOOST_CHECK_EQUAL(1, invalid.values.size());
+    BOOST_CHECK(invalid.ec == json_parser_errc::expected_value);
+
+    json_decoder<json> decoder;
+    async_json_reader reader([](char*, size_t, async_json_reader::read_handler handler)
+                             {handler(0, std::make_error_code(std::errc::connection_reset));},
+                             decoder);
+    std::error_code ec;
+    reader.async_read_next([&ec](const std::error_code& e) {ec = e;});
+    BOOST_CHECK(ec == std::errc::connection_reset);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
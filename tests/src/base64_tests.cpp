@@ -54,6 +54,120 @@ BOOST_AUTO_TEST_CASE(test_decode_base64)
     BOOST_CHECK_EQUAL("foobar", decode_base64("Zm9vYmFy"));
 }
 
+BOOST_AUTO_TEST_CASE(test_encode_base64url)
+{
+    const uint8_t data[] = {'f','o','o','b','a','r',0xfb,0xff};
+    std::string result;
+    encode_base64url(data, data + 4, result);
+    BOOST_CHECK_EQUAL("Zm9vYg", result);
+
+    result.clear();
+    encode_base64url(data + 4, data + 8, result);
+    BOOST_CHECK_EQUAL("YXL7_w", result);
+
+    std::vector<uint8_t> v(data, data + 8);
+    result.clear();
+    encode_base64url(v.begin(), v.end(), result);
+    BOOST_CHECK_EQUAL("Zm9vYmFy-_8", result);
+}
+
+BOOST_AUTO_TEST_CASE(test_base64_caller_buffer)
+{
+    const uint8_t data[] = {'f','o','o','b','a'};
+    char buf[8];
+    BOOST_REQUIRE_EQUAL(8, encoded_base64_length(sizeof(data)));
+    BOOST_CHECK_EQUAL(8, encode_base64(data, sizeof(data), buf));
+    BOOST_CHECK_EQUAL("Zm9vYmE=", std::string(buf, 8));
+    BOOST_REQUIRE_EQUAL(7, encoded_base64url_length(sizeof(data)));
+    BOOST_CHECK_EQUAL(7, encode_base64url(data, sizeof(data), buf));
+    BOOST_CHECK_EQUAL("Zm9vYmE", std::string(buf, 7));
+
+    uint8_t bytes[5];
+    BOOST_REQUIRE(decoded_base64_max_length(7) <= sizeof(bytes));
+    BOOST_CHECK_EQUAL(5, decode_base64url(buf, 7, bytes));
+    BOOST_CHECK(std::equal(data, data + 5, bytes));
+    BOOST_CHECK_EQUAL(5, decode_base64("Zm9vYmE=", 8, bytes));
+    BOOST_CHECK(std::equal(data, data + 5, bytes));
+}
+
+// Lengths either side of the 12 and 24 byte blocks of the vector kernels, with bytes
+// that encode to every character
+BOOST_AUTO_TEST_CASE(test_base64_round_trip)
+{
+    std::vector<uint8_t> data(200);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<uint8_t>(i*89 + 7);
+    }
+    for (size_t length = 0; length <= data.size(); ++length)
+    {
+        std::string expected;
+        encode_base64(data.begin(), data.begin() + length, base64_alphabet, expected);
+        std::string result;
+        encode_base64(data.data(), data.data() + length, result);
+        BOOST_CHECK_EQUAL(expected, result);
+
+        std::vector<uint8_t> decoded(decoded_base64_max_length(result.size()));
+        decoded.resize(decode_base64(result.data(), result.size(), decoded.data()));
+        BOOST_CHECK(std::equal(data.begin(), data.begin() + length, decoded.begin()) && decoded.size() == length);
+
+        std::string url;
+        encode_base64url(data.data(), data.data() + length, url);
+        BOOST_CHECK_EQUAL(encoded_base64url_length(length), url.size());
+        std::wstring wurl;
+        encode_base64url(data.data(), data.data() + length, wurl);
+        BOOST_CHECK(std::equal(url.begin(), url.end(), wurl.begin()) && wurl.size() == url.size());
+
+        decoded.assign(decoded_base64_max_length(url.size()), 0);
+        decoded.resize(decode_base64url(url.data(), url.size(), decoded.data()));
+        BOOST_CHECK(std::equal(data.begin(), data.begin() + length, decoded.begin()) && decoded.size() == length);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_decode_base64_invalid)
+{
+    // A character outside the alphabet, in a block long enough for the vector kernels
+    std::string s(48, 'A');
+    std::vector<uint8_t> buf(36);
+    for (size_t pos : {size_t(0), size_t(17), size_t(47)})
+    {
+        for (char c : {'-', '_', '*', ' ', '\x80'})
+        {
+            std::string t = s;
+            t[pos] = c;
+            BOOST_CHECK_THROW(decode_base64(t.data(), t.size(), buf.data()), std::runtime_error);
+        }
+        for (char c : {'+', '/', '*', ' ', '\x80'})
+        {
+            std::string t = s;
+            t[pos] = c;
+            BOOST_CHECK_THROW(decode_base64url(t.data(), t.size(), buf.data()), std::runtime_error);
+        }
+    }
+    BOOST_CHECK_THROW(decode_base64("Zm9v!mFy"), std::runtime_error);
+
+    // Decoding stops at the fill character
+    std::string t = s;
+    t[20] = '=';
+    BOOST_CHECK_EQUAL(15, decode_base64(t.data(), t.size(), buf.data()));
+}
+
+BOOST_AUTO_TEST_CASE(test_serialize_byte_string)
+{
+    std::vector<uint8_t> data(1000);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<uint8_t>(i*31);
+    }
+    json j(data.data(), data.size());
+
+    std::string expected;
+    encode_base64url(data.data(), data.data() + data.size(), expected);
+    std::ostringstream os;
+    os << j;
+    BOOST_CHECK_EQUAL("\"" + expected + "\"", os.str());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
@@ -0,0 +1,190 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_filter.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/cbor/cbor_parser.hpp>
+#include <jsoncons_ext/cbor/cbor_reader.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <limits>
+
+using namespace jsoncons;
+using namespace jsoncons::cbor;
+
+BOOST_AUTO_TEST_SUITE(cbor_parser_tests)
+
+// Parses v passed to the parser piece_length bytes at a time
+template <class Json>
+Json parse_in_pieces(const std::vector<uint8_t>& v, size_t piece_length)
+{
+    json_decoder<Json> decoder;
+    cbor_parser parser(decoder);
+    for (size_t i = 0; i < v.size() && !parser.done(); i += piece_length)
+    {
+        parser.set_source(v.data() + i, (std::min)(piece_length, v.size() - i));
+        parser.parse();
+    }
+    parser.end_parse();
+    parser.check_done();
+    return decoder.get_result();
+}
+
+BOOST_AUTO_TEST_CASE(cbor_parser_matches_decode_cbor)
+{
+    ojson j = ojson::parse(R"(
+    {
+       "application": "hiking",
+       "reputons": [
+       {
+           "rater": "HikingAsylum.example.com",
+           "assertion": "is-good",
+           "rated": "sk",
+           "rating": 0.90,
+           "votes": [-1, 0, 23, 24, 255, 256, 65536, 4294967296, -4294967297]
+         }
+       ],
+       "empty array": [],
+       "empty object": {},
+       "flags": [true, false, null],
+       "a string long enough to need a one byte length": "and a value of more than twenty three bytes"
+    }
+    )");
+    j["bytes"] = ojson(byte_string({'H','e','l','l','o'}));
+
+    std::vector<uint8_t> v = encode_cbor(j);
+    ojson expected = decode_cbor<ojson>(v);
+
+    for (size_t piece_length : {v.size(), size_t(1), size_t(2), size_t(7)})
+    {
+        ojson result = parse_in_pieces<ojson>(v, piece_length);
+        BOOST_CHECK_MESSAGE(expected == result, piece_length);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cbor_parser_indefinite_lengths)
+{
+    // {_ "a": [_ 1, (_ h'0102', h'03')], "b": (_ "st", "ream")}
+    std::vector<uint8_t> v = {0xbf,
+                              0x61,'a',0x9f,0x01,0x5f,0x42,0x01,0x02,0x41,0x03,0xff,0xff,
+                              0x61,'b',0x7f,0x62,'s','t',0x64,'r','e','a','m',0xff,
+                              0xff};
+    for (size_t piece_length : {v.size(), size_t(1), size_t(3)})
+    {
+        json result = parse_in_pieces<json>(v, piece_length);
+        BOOST_REQUIRE(result.is_object());
+        BOOST_CHECK_EQUAL(std::string("stream"), result["b"].as<std::string>());
+        BOOST_REQUIRE_EQUAL(2, result["a"].size());
+        BOOST_CHECK_EQUAL(1, result["a"][0].as<int>());
+        BOOST_CHECK(result["a"][1].as<byte_string>() == byte_string({0x01,0x02,0x03}));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cbor_parser_scalars_and_keys)
+{
+    // Half, single and double precision floats, undefined, a tag, and an integer key
+    std::vector<uint8_t> v = {0xa5,
+                              0x61,'h',0xf9,0x3e,0x00,
+                              0x61,'s',0xfa,0x47,0xc3,0x50,0x00,
+                              0x61,'d',0xfb,0x3f,0xf1,0x99,0x99,0x99,0x99,0x99,0x9a,
+                              0x61,'u',0xf7,
+                              0x0a,0xc1,0x1a,0x51,0x4b,0x67,0xb0};
+    json result = parse_in_pieces<json>(v, 1);
+    BOOST_CHECK_EQUAL(1.5, result["h"].as<double>());
+    BOOST_CHECK_EQUAL(100000.0, result["s"].as<double>());
+    BOOST_CHECK_EQUAL(1.1, result["d"].as<double>());
+    BOOST_CHECK(result["u"].is_null());
+    BOOST_CHECK_EQUAL(1363896240, result["10"].as<int64_t>());
+}
+
+BOOST_AUTO_TEST_CASE(cbor_parser_transcode_to_json)
+{
+    json j = json::parse(R"({"a":[1,2.5,"three",{"b":null}],"c":true})");
+    std::vector<uint8_t> v = encode_cbor(j);
+
+    std::ostringstream os;
+    json_serializer serializer(os);
+    basic_json_input_output_handler_adapter<char> adapter(serializer);
+    cbor_parser parser(adapter);
+    for (size_t i = 0; i < v.size(); ++i)
+    {
+        parser.set_source(v.data() + i, 1);
+        parser.parse();
+    }
+    parser.check_done();
+    BOOST_CHECK(json::parse(os.str()) == j);
+}
+
+BOOST_AUTO_TEST_CASE(cbor_reader_test)
+{
+    json j = json::parse(R"([{"name":"first","values":[1,2,3]},{"name":"second","values":[]}])");
+    std::vector<uint8_t> v = encode_cbor(j);
+    std::vector<uint8_t> u = encode_cbor(json("next"));
+
+    std::string s(v.begin(), v.end());
+    s.append(u.begin(), u.end());
+    std::istringstream is(s);
+
+    json_decoder<json> decoder;
+    cbor_reader reader(is, decoder);
+    reader.buffer_length(5);
+    reader.read_next();
+    BOOST_CHECK(decoder.get_result() == j);
+    reader.read_next();
+    BOOST_CHECK(decoder.get_result() == json("next"));
+    reader.check_done();
+    reader.read_next();
+    BOOST_CHECK(reader.eof());
+
+    std::istringstream is2(std::string(v.begin(), v.end()));
+    BOOST_CHECK(decode_cbor<json>(is2) == j);
+}
+
+BOOST_AUTO_TEST_CASE(cbor_parser_errors)
+{
+    struct test_case
+    {
+        std::vector<uint8_t> v;
+        cbor_parser_errc expected;
+    };
+    std::vector<test_case> cases = {
+        {{0x82,0x01}, cbor_parser_errc::unexpected_eof},
+        {{0x62,'a'}, cbor_parser_errc::unexpected_eof},
+        {{0x1c}, cbor_parser_errc::invalid_initial_byte},
+        {{0x1f}, cbor_parser_errc::invalid_initial_byte},
+        {{0xff}, cbor_parser_errc::unexpected_break},
+        {{0x81,0xff}, cbor_parser_errc::unexpected_break},
+        {{0xbf,0x61,'a',0xff}, cbor_parser_errc::unexpected_break},
+        {{0x7f,0x41,'a',0xff}, cbor_parser_errc::invalid_string_chunk},
+        {{0xa1,0xf5,0x01}, cbor_parser_errc::invalid_key},
+        {{0xa1,0x80,0x01}, cbor_parser_errc::invalid_key},
+        {{0x01,0x02}, cbor_parser_errc::extra_data}
+    };
+    for (const auto& c : cases)
+    {
+        cbor_parser parser;
+        parser.set_source(c.v.data(), c.v.size());
+        std::error_code ec;
+        parser.parse(ec);
+        if (!ec)
+        {
+            parser.check_done(ec);
+        }
+        BOOST_CHECK_EQUAL(make_error_code(c.expected), ec);
+    }
+
+    cbor_parser parser;
+    parser.max_nesting_depth(2);
+    std::vector<uint8_t> v = {0x81,0x81,0x81,0x01};
+    parser.set_source(v.data(), v.size());
+    BOOST_CHECK_THROW(parser.parse(), parse_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,138 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_filter.hpp>
+#include <jsoncons/json_reader.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/cbor/cbor_serializer.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <limits>
+#include <algorithm>
+
+using namespace jsoncons;
+using namespace jsoncons::cbor;
+
+BOOST_AUTO_TEST_SUITE(cbor_serializer_tests)
+
+std::vector<uint8_t> to_bytes(const std::string& s)
+{
+    return std::vector<uint8_t>(s.begin(), s.end());
+}
+
+BOOST_AUTO_TEST_CASE(cbor_serializer_bytes)
+{
+    std::ostringstream os;
+    cbor_serializer serializer(os);
+    serializer.begin_json();
+    serializer.begin_array();
+    serializer.value(0);
+    serializer.value(23);
+    serializer.value(24);
+    serializer.value(-1);
+    serializer.value(-25);
+    serializer.uinteger_value(65536);
+    serializer.value("a");
+    serializer.begin_object();
+    serializer.name("b");
+    serializer.value(true);
+    serializer.end_object();
+    serializer.null_value();
+    serializer.end_array();
+    serializer.end_json();
+
+    std::vector<uint8_t> expected = {0x9f,0x00,0x17,0x18,0x18,0x20,0x38,0x18,0x1a,0x00,0x01,0x00,0x00,
+                                     0x61,'a',0xbf,0x61,'b',0xf5,0xff,0xf6,0xff};
+    BOOST_CHECK(expected == to_bytes(os.str()));
+}
+
+BOOST_AUTO_TEST_CASE(cbor_serializer_dump)
+{
+    ojson j = ojson::parse(R"(
+    {
+       "application": "hiking",
+       "reputons": [
+       {
+           "rater": "HikingAsylum.example.com",
+           "assertion": "is-good",
+           "rated": "sk",
+           "rating": 0.90,
+           "votes": [-1, 0, 255, 65536, -4294967297, 18446744073709551615]
+         }
+       ],
+       "empty": [{}, []]
+    }
+    )");
+    j["bytes"] = ojson(byte_string({'H','e','l','l','o'}));
+
+    std::ostringstream os;
+    cbor_serializer serializer(os);
+    j.dump(serializer);
+
+    BOOST_CHECK(decode_cbor<ojson>(to_bytes(os.str())) == j);
+}
+
+BOOST_AUTO_TEST_CASE(cbor_serializer_transcode_json)
+{
+    std::string text = R"([{"name":"first","values":[1,2.5,-3]},{"name":"second","values":[],"flag":false}])";
+
+    std::istringstream is(text);
+    std::ostringstream os;
+    cbor_serializer serializer(os);
+    basic_json_input_output_handler_adapter<char> adapter(serializer);
+    json_reader reader(is, adapter);
+    reader.read();
+
+    BOOST_CHECK(decode_cbor<json>(to_bytes(os.str())) == json::parse(text));
+}
+
+BOOST_AUTO_TEST_CASE(cbor_serializer_illegal_unicode)
+{
+    std::ostringstream os;
+    cbor_serializer serializer(os);
+    serializer.begin_json();
+    BOOST_CHECK_THROW(serializer.value("\xff"), std::runtime_error);
+}
+
+// Rewrites one member of a record, and copies the others as they are encoded
+BOOST_AUTO_TEST_CASE(cbor_serializer_encoded_value)
+{
+    ojson record = ojson::parse(R"({"id":7,"payload":{"samples":[1.5,2.5,3.5],"source":"sensor"},"status":"new"})");
+    std::vector<uint8_t> v = encode_cbor(record);
+    cbor_view view = cbor_view(v).indexed();
+
+    std::ostringstream os;
+    cbor_serializer serializer(os);
+    serializer.begin_json();
+    serializer.begin_object();
+    for (size_t i = 0; i < view.size(); ++i)
+    {
+        serializer.name(view.key(i));
+        if (view.key(i) == "status")
+        {
+            serializer.value("done");
+        }
+        else
+        {
+            serializer.encoded_value(view.value(i));
+        }
+    }
+    serializer.end_object();
+    serializer.end_json();
+
+    std::vector<uint8_t> result = to_bytes(os.str());
+    record["status"] = "done";
+    BOOST_CHECK(decode_cbor<ojson>(result) == record);
+
+    cbor_view payload = view.at("payload");
+    BOOST_CHECK(std::search(result.begin(), result.end(), payload.buffer(), payload.buffer() + payload.buflen()) != result.end());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,80 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/cbor/cbor_transcode.hpp>
+#include <sstream>
+#include <vector>
+#include <string>
+
+using namespace jsoncons;
+using namespace jsoncons::cbor;
+
+BOOST_AUTO_TEST_SUITE(cbor_transcode_tests)
+
+BOOST_AUTO_TEST_CASE(json_to_cbor_round_trip_test)
+{
+    std::string text = R"({"a":[1,-2,3.5,"four",true,null],"b":{"c":"été","d":[]},"e":18446744073709551615})";
+    json expected = json::parse(text);
+
+    std::istringstream is(text);
+    std::ostringstream os;
+    json_to_cbor(is, os);
+    std::string s = os.str();
+    std::vector<uint8_t> buffer(s.begin(), s.end());
+    BOOST_CHECK(decode_cbor<json>(cbor_view(buffer)) == expected);
+
+    std::istringstream is2(s);
+    std::ostringstream os2;
+    cbor_to_json(is2, os2);
+    BOOST_CHECK(json::parse(os2.str()) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(cbor_to_json_source_sink_test)
+{
+    json j = json::parse(R"([{"id":1,"name":"x"},{"id":2,"name":"y"}])");
+    std::vector<uint8_t> buffer = encode_cbor(j);
+    std::string s(buffer.begin(), buffer.end());
+
+    std::istringstream is(s);
+    stream_source source(is);
+    std::string out;
+    string_sink sink(out);
+    cbor_to_json(source, sink);
+    BOOST_CHECK_EQUAL(std::string(R"([{"id":1,"name":"x"},{"id":2,"name":"y"}])"), out);
+
+    std::istringstream is2(s);
+    std::ostringstream os2;
+    serialization_options options;
+    options.indent(2);
+    cbor_to_json(is2, os2, options);
+    BOOST_CHECK(json::parse(os2.str()) == j);
+}
+
+BOOST_AUTO_TEST_CASE(transcode_error_test)
+{
+    std::istringstream is("[1,2");
+    std::ostringstream os;
+    std::error_code ec;
+    json_to_cbor(is, os, ec);
+    BOOST_CHECK(ec);
+
+    std::istringstream is2("{\"a\" 1}");
+    std::ostringstream os2;
+    BOOST_CHECK_THROW(json_to_cbor(is2, os2), parse_error);
+
+    // An array of 3 items with only 1
+    std::string truncated = {'\x83', '\x01'};
+    std::istringstream is3(truncated);
+    std::ostringstream os3;
+    cbor_to_json(is3, os3, ec);
+    BOOST_CHECK(ec);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,145 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/cbor/cbor_parser.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <limits>
+
+using namespace jsoncons;
+using namespace jsoncons::cbor;
+
+BOOST_AUTO_TEST_SUITE(cbor_typed_array_tests)
+
+json parse_with_cbor_parser(const std::vector<uint8_t>& v)
+{
+    json_decoder<json> decoder;
+    cbor_parser parser(decoder);
+    for (size_t i = 0; i < v.size(); ++i)
+    {
+        parser.set_source(v.data() + i, 1);
+        parser.parse();
+    }
+    parser.check_done();
+    return decoder.get_result();
+}
+
+BOOST_AUTO_TEST_CASE(cbor_typed_array_double_test)
+{
+    std::vector<double> values;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        values.push_back(i*0.25 - 100);
+    }
+    std::vector<uint8_t> v = encode_cbor(values);
+
+    // A one byte tag, a byte string with a two byte length, and the doubles
+    BOOST_REQUIRE_EQUAL(2 + 3 + 8*values.size(), v.size());
+    BOOST_CHECK_EQUAL(0xd8, v[0]);
+    BOOST_CHECK_EQUAL(binary::detail::is_little_endian() ? 86 : 82, v[1]);
+
+    BOOST_CHECK(cbor_view(v).as<std::vector<double>>() == values);
+
+    json j = decode_cbor<json>(v);
+    BOOST_REQUIRE(j.is_array());
+    BOOST_REQUIRE_EQUAL(values.size(), j.size());
+    BOOST_CHECK_EQUAL(values[999], j[999].as<double>());
+    BOOST_CHECK(parse_with_cbor_parser(v) == j);
+
+    std::vector<float> floats = cbor_view(v).as<std::vector<float>>();
+    BOOST_REQUIRE_EQUAL(values.size(), floats.size());
+    BOOST_CHECK_EQUAL(-100.0f, floats[0]);
+}
+
+BOOST_AUTO_TEST_CASE(cbor_typed_array_integer_test)
+{
+    std::vector<int32_t> values = {0, -1, 1, (std::numeric_limits<int32_t>::min)(), (std::numeric_limits<int32_t>::max)()};
+    std::vector<uint8_t> v;
+    v.push_back(0x9f);
+    encode_cbor(values, v);
+    v.push_back(0xff);
+
+    // Views over a typed array within an array
+    cbor_view array(v);
+    cbor_view item = array.at(0);
+    BOOST_CHECK(item.as<std::vector<int32_t>>() == values);
+    BOOST_CHECK(item.as<std::vector<int64_t>>() == std::vector<int64_t>(values.begin(), values.end()));
+
+    json j = decode_cbor<json>(v);
+    BOOST_REQUIRE_EQUAL(1, j.size());
+    BOOST_CHECK_EQUAL((std::numeric_limits<int32_t>::min)(), j[0][3].as<int32_t>());
+    BOOST_CHECK(parse_with_cbor_parser(v) == j);
+
+    std::vector<uint8_t> bytes = {1, 2, 255};
+    BOOST_CHECK(cbor_view(encode_cbor(bytes)).as<std::vector<uint8_t>>() == bytes);
+    BOOST_CHECK(cbor_view(encode_cbor(std::vector<uint64_t>())).as<std::vector<uint64_t>>().empty());
+}
+
+BOOST_AUTO_TEST_CASE(cbor_typed_array_byte_orders_test)
+{
+    struct test_case
+    {
+        std::vector<uint8_t> v;
+        json expected;
+    };
+    std::vector<test_case> cases = {
+        // uint16 big endian, uint16 little endian
+        {{0xd8,0x41,0x44,0x01,0x02,0x03,0x04}, json::parse("[258,772]")},
+        {{0xd8,0x45,0x44,0x01,0x02,0x03,0x04}, json::parse("[513,1027]")},
+        // sint16 big endian, sint32 little endian
+        {{0xd8,0x49,0x42,0xff,0xfe}, json::parse("[-2]")},
+        {{0xd8,0x4e,0x44,0xfe,0xff,0xff,0xff}, json::parse("[-2]")},
+        // uint8 clamped, sint8
+        {{0xd8,0x44,0x42,0x00,0xff}, json::parse("[0,255]")},
+        {{0xd8,0x48,0x42,0x00,0xff}, json::parse("[0,-1]")},
+        // float16 big endian, float32 little endian, float64 big endian
+        {{0xd8,0x50,0x42,0x3e,0x00}, json::parse("[1.5]")},
+        {{0xd8,0x55,0x44,0x00,0x00,0xc0,0x3f}, json::parse("[1.5]")},
+        {{0xd8,0x52,0x48,0x3f,0xf8,0x00,0x00,0x00,0x00,0x00,0x00}, json::parse("[1.5]")},
+        // An indefinite length byte string
+        {{0xd8,0x41,0x5f,0x41,0x01,0x43,0x02,0x03,0x04,0xff}, json::parse("[258,772]")},
+        // Other tags are skipped
+        {{0x82,0xc1,0x1a,0x51,0x4b,0x67,0xb0,0xd8,0x20,0x61,'a'}, json::parse(R"([1363896240,"a"])")}
+    };
+    for (const auto& c : cases)
+    {
+        BOOST_CHECK_EQUAL(c.expected, decode_cbor<json>(c.v));
+        BOOST_CHECK_EQUAL(c.expected, parse_with_cbor_parser(c.v));
+    }
+
+    std::vector<uint8_t> v = {0xd8,0x41,0x44,0x01,0x02,0x03,0x04};
+    BOOST_CHECK(cbor_view(v).as<std::vector<uint16_t>>() == std::vector<uint16_t>({258,772}));
+
+    std::vector<uint8_t> tagged = {0x82,0xc1,0x01,0x02};
+    BOOST_CHECK_EQUAL(2, cbor_view(tagged).at(1).as<int>());
+    BOOST_CHECK(cbor_view(tagged).as<std::vector<int>>() == std::vector<int>({1,2}));
+}
+
+BOOST_AUTO_TEST_CASE(cbor_typed_array_errors_test)
+{
+    // uint16 with three bytes
+    std::vector<uint8_t> v = {0xd8,0x41,0x43,0x01,0x02,0x03};
+    BOOST_CHECK_THROW(decode_cbor<json>(v), std::invalid_argument);
+
+    cbor_parser parser;
+    parser.set_source(v.data(), v.size());
+    std::error_code ec;
+    parser.parse(ec);
+    BOOST_CHECK_EQUAL(make_error_code(cbor_parser_errc::invalid_typed_array), ec);
+
+    // An array header with a length far past the end of the input
+    std::vector<uint8_t> huge = {0x9b,0x00,0x00,0x00,0x10,0x00,0x00,0x00,0x00};
+    BOOST_CHECK_THROW(cbor_view(huge).as<std::vector<int64_t>>(), parse_error);
+    std::vector<uint8_t> truncated = {0x9a,0x08,0x00,0x00,0x00,0x01,0x02};
+    BOOST_CHECK_THROW(cbor_view(truncated).as<std::vector<int64_t>>(), parse_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
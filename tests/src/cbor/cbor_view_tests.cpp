@@ -9,6 +9,7 @@
 #include <jsoncons/json.hpp>
 #include <jsoncons_ext/cbor/cbor.hpp>
 #include <jsoncons_ext/jsonpointer/jsonpointer.hpp>
+#include <jsoncons_ext/jsonpath/json_query.hpp>
 #include <sstream>
 #include <vector>
 #include <utility>
@@ -87,5 +88,233 @@ BOOST_AUTO_TEST_CASE(jsonpointer_test)
 
 }
 
+
+BOOST_AUTO_TEST_CASE(cbor_view_index_test)
+{
+    json j;
+    json a = json::array();
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        a.add(i % 3 == 0 ? json(std::string(i % 40, 'x')) : json(i));
+    }
+    j["array"] = a;
+    j["map"] = json();
+    for (size_t i = 0; i < 300; ++i)
+    {
+        j["map"]["key" + std::to_string(i)] = i;
+    }
+    auto buffer = encode_cbor(j);
+    cbor_view v(buffer);
+
+    cbor_view array = v.at("array");
+    cbor_view indexed_array = array.indexed();
+    BOOST_CHECK(!array.is_indexed());
+    BOOST_CHECK(indexed_array.is_indexed());
+    BOOST_REQUIRE_EQUAL(1000, indexed_array.size());
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        BOOST_CHECK(decode_cbor<json>(indexed_array.at(i)) == a[i]);
+        BOOST_CHECK_EQUAL(array.at(i).buflen(), indexed_array.at(i).buflen());
+    }
+    BOOST_CHECK_THROW(indexed_array.at(1000), std::out_of_range);
+
+    cbor_view map = v.at("map").indexed();
+    cbor_view copy(map);
+    BOOST_CHECK(copy.is_indexed());
+    BOOST_CHECK_EQUAL(300, map.size());
+    for (size_t i = 0; i < 300; ++i)
+    {
+        BOOST_CHECK_EQUAL(i, decode_cbor<json>(copy.at("key" + std::to_string(i))).as<size_t>());
+    }
+    BOOST_CHECK(map.has_key("key299"));
+    BOOST_CHECK(!map.has_key("key300"));
+    BOOST_CHECK_THROW(map.at("key300"), std::runtime_error);
+
+    cbor_view root = v.indexed();
+    cbor_view value;
+    jsonpointer::jsonpointer_errc ec;
+    std::tie(value,ec) = jsonpointer::get(root,"/map/key42");
+    BOOST_CHECK_EQUAL(ec,jsonpointer::jsonpointer_errc());
+    BOOST_CHECK_EQUAL(42, decode_cbor<json>(value).as<int>());
+}
+
+BOOST_AUTO_TEST_CASE(cbor_view_index_indefinite_length_test)
+{
+    // [_ 1, [2, 3]] and {_ "a": 1, "b": [2], "a": 3}, the first of duplicate keys is found
+    std::vector<uint8_t> array = {0x9f,0x01,0x82,0x02,0x03,0xff};
+    cbor_view a = cbor_view(array).indexed();
+    BOOST_REQUIRE_EQUAL(2, a.size());
+    BOOST_CHECK_EQUAL(1, decode_cbor<json>(a.at(0)).as<int>());
+    BOOST_CHECK(decode_cbor<json>(a.at(1)) == json::parse("[2,3]"));
+
+    std::vector<uint8_t> map = {0xbf,0x61,'a',0x01,0x61,'b',0x81,0x02,0x61,'a',0x03,0xff};
+    cbor_view m = cbor_view(map).indexed();
+    BOOST_CHECK(m.is_object());
+    BOOST_REQUIRE_EQUAL(3, m.size());
+    BOOST_CHECK_EQUAL(1, decode_cbor<json>(m.at("a")).as<int>());
+    BOOST_CHECK(decode_cbor<json>(m.at("b")) == json::parse("[2]"));
+}
+
+BOOST_AUTO_TEST_CASE(cbor_view_indefinite_length_test)
+{
+    // [_ [_ 1], 2] and {_ "a": [_ ], "b": 3}
+    std::vector<uint8_t> array = {0x9f,0x9f,0x01,0xff,0x02,0xff};
+    cbor_view a(array);
+    BOOST_REQUIRE_EQUAL(2, a.size());
+    BOOST_CHECK(decode_cbor<json>(a.at(0)) == json::parse("[1]"));
+    BOOST_CHECK_EQUAL(2, decode_cbor<json>(a.at(1)).as<int>());
+
+    std::vector<uint8_t> map = {0xbf,0x61,'a',0x9f,0xff,0x61,'b',0x03,0xff};
+    cbor_view m(map);
+    BOOST_REQUIRE_EQUAL(2, m.size());
+    BOOST_CHECK(m.has_key("b"));
+    BOOST_CHECK_EQUAL(3, decode_cbor<json>(m.at("b")).as<int>());
+}
+
+BOOST_AUTO_TEST_CASE(cbor_view_byte_string_test)
+{
+    // ["abc" as bytes, (_ h'01', h'0203'), (_ h'0405'), (_ ), 1]
+    std::vector<uint8_t> v = {0x85,0x43,0x61,0x62,0x63,
+                              0x5f,0x41,0x01,0x42,0x02,0x03,0xff,
+                              0x5f,0x42,0x04,0x05,0xff,
+                              0x5f,0xff,
+                              0x01};
+    cbor_view a(v);
+
+    cbor_view definite = a.at(0);
+    BOOST_CHECK(definite.is_byte_string());
+    byte_string_view bs = definite.as_byte_string_view();
+    BOOST_CHECK(bs == byte_string_view(v.data() + 2, 3));
+    BOOST_CHECK(bs.data() == v.data() + 2);
+
+    // The bytes of more than one chunk are not together in the buffer
+    cbor_view chunks = a.at(1);
+    BOOST_CHECK(chunks.is_byte_string());
+    BOOST_CHECK_THROW(chunks.as_byte_string_view(), std::invalid_argument);
+    BOOST_CHECK(chunks.as<byte_string>() == byte_string({0x01,0x02,0x03}));
+    BOOST_CHECK(decode_cbor<json>(chunks).as<byte_string>() == byte_string({0x01,0x02,0x03}));
+
+    cbor_view one_chunk = a.at(2);
+    BOOST_CHECK(one_chunk.as_byte_string_view().data() == v.data() + 14);
+    BOOST_CHECK(one_chunk.as<byte_string>() == byte_string({0x04,0x05}));
+    BOOST_CHECK(decode_cbor<json>(one_chunk).as<byte_string>() == byte_string({0x04,0x05}));
+
+    BOOST_CHECK_EQUAL(0, a.at(3).as_byte_string_view().length());
+    BOOST_CHECK(decode_cbor<json>(a.at(3)).as<byte_string>() == byte_string());
+
+    BOOST_CHECK(!a.at(4).is_byte_string());
+    BOOST_CHECK_THROW(a.at(4).as_byte_string_view(), std::invalid_argument);
+
+    json j = decode_cbor<json>(a);
+    BOOST_REQUIRE_EQUAL(5, j.size());
+    BOOST_CHECK(j[0].as<byte_string>() == byte_string("abc"));
+    BOOST_CHECK_EQUAL(1, j[4].as<int>());
+}
+
+BOOST_AUTO_TEST_CASE(cbor_view_members_test)
+{
+    ojson j = ojson::parse(R"({"b":[1,2],"a":"x","c":{"d":null}})");
+    std::vector<uint8_t> v = encode_cbor(j);
+    // {_ "b": 1, "a": [_ 2]}
+    std::vector<uint8_t> u = {0xbf,0x61,'b',0x01,0x61,'a',0x9f,0x02,0xff,0xff};
+
+    for (const cbor_view& view : {cbor_view(v), cbor_view(v).indexed()})
+    {
+        BOOST_REQUIRE_EQUAL(3, view.size());
+        for (size_t i = 0; i < view.size(); ++i)
+        {
+            BOOST_CHECK_EQUAL(j.object_range().begin()[i].key(), view.key(i));
+            BOOST_CHECK(decode_cbor<ojson>(view.value(i)) == j.object_range().begin()[i].value());
+        }
+        BOOST_CHECK_EQUAL(2, view.value(0).value(1).as<int>());
+        BOOST_CHECK_THROW(view.key(3), std::out_of_range);
+        BOOST_CHECK_THROW(view.value(3), std::out_of_range);
+    }
+    for (const cbor_view& view : {cbor_view(u), cbor_view(u).indexed()})
+    {
+        BOOST_REQUIRE_EQUAL(2, view.size());
+        BOOST_CHECK_EQUAL(std::string("a"), view.key(1));
+        BOOST_CHECK_EQUAL(1, view.value(0).as<int>());
+        BOOST_CHECK_EQUAL(2, view.value(1).value(0).as<int>());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cbor_view_jsonpointer_nested_test)
+{
+    json j = json::parse(R"({"a":{"b":[10,11,12,{"id":7}]}})");
+    std::vector<uint8_t> buffer = encode_cbor(j);
+    cbor_view v(buffer);
+
+    cbor_view item;
+    jsonpointer::jsonpointer_errc ec;
+    std::tie(item,ec) = jsonpointer::get(v,"/a/b/3/id");
+    BOOST_CHECK_EQUAL(ec,jsonpointer::jsonpointer_errc());
+    BOOST_CHECK_EQUAL(7, item.as<int>());
+
+    std::tie(item,ec) = jsonpointer::get(v,"/a/b/4");
+    BOOST_CHECK(ec != jsonpointer::jsonpointer_errc());
+}
+
+BOOST_AUTO_TEST_CASE(cbor_view_jsonpath_test)
+{
+    ojson j = ojson::parse(R"(
+    {
+        "store": {
+            "book": [
+                {"id": 1, "category": "reference", "title": "Sayings of the Century", "price": 8.95},
+                {"id": 2, "category": "fiction", "title": "Sword of Honour", "price": 12.99},
+                {"id": 3, "category": "fiction", "title": "Moby Dick", "isbn": "0-553-21311-3", "price": 8.99}
+            ],
+            "bicycle": {"id": 4, "color": "red", "price": 19.95}
+        }
+    }
+    )");
+    std::vector<uint8_t> buffer = encode_cbor(j);
+
+    const std::vector<std::string> paths = {
+        "$.store.book[1].title",
+        "$.store.book[-1].id",
+        "$.store.book.length",
+        "$.store.book[0:2].title",
+        "$.store.book[::-1].id",
+        "$.store.book[0,2].price",
+        "$.store.book[*].title",
+        "$.store.*",
+        "$['store']['bicycle']['color']",
+        "$.store.book[?(@.price < 10)].title",
+        "$.store.book[?(@.price < max($.store.book[*].price))].title",
+        "$.store.book[?(@.isbn)].id",
+        "$.store.book[(@.length-1)].title",
+        "$.store.bicycle.color[0]",
+        "$.store.bicycle.color.length",
+        "$.missing",
+        "$..id",
+        "$..price",
+        "$..book[1]",
+        "$..[?(@.price > 10)].id",
+        "$..*"
+    };
+    for (const cbor_view& v : {cbor_view(buffer), cbor_view(buffer).indexed()})
+    {
+        for (const auto& path : paths)
+        {
+            ojson expected = jsonpath::json_query(j, path);
+            ojson result = jsonpath::json_query<ojson>(v, path);
+            BOOST_CHECK_MESSAGE(result == expected, path << ": " << result << " != " << expected);
+        }
+    }
+
+    cbor_view v(buffer);
+    json paths1 = jsonpath::json_query(v, "$.store.book[?(@.price < 10)].title", jsonpath::result_type::path);
+    json expected1 = json::parse(R"(["$['store']['book'][0]['title']","$['store']['book'][2]['title']"])");
+    BOOST_CHECK(paths1 == expected1);
+
+    json paths2 = jsonpath::json_query(v, "$..id", jsonpath::result_type::path);
+    json expected2 = json::parse(R"(["$['store']['book'][0]['id']","$['store']['book'][1]['id']","$['store']['book'][2]['id']","$['store']['bicycle']['id']"])");
+    BOOST_CHECK(paths2 == expected2);
+
+    BOOST_CHECK(jsonpath::json_query(cbor_view(), "$..id") == json::array());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
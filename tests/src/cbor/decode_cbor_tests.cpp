@@ -140,6 +140,113 @@ BOOST_AUTO_TEST_CASE(cbor_arrays_and_maps)
 
     check_decode({0xa1,0x62,'o','c',0x81,'\0'}, json::parse("{\"oc\": [0]}"));
     check_decode({0xa1,0x62,'o','c',0x84,'\0','\1','\2','\3'}, json::parse("{\"oc\": [0, 1, 2, 3]}"));
+
+    // Members out of order, and duplicates, where the last wins
+    check_decode({0xa3,0x61,'b','\1',0x61,'a','\2',0x61,'b','\3'}, json::parse("{\"a\":2,\"b\":3}"));
+    check_decode({0xbf,0x61,'b','\1',0x61,'a','\2',0x61,'b','\3',0xff}, json::parse("{\"a\":2,\"b\":3}"));
+    std::vector<uint8_t> v = {0xa3,0x61,'b','\1',0x61,'a','\2',0x61,'b','\3'};
+    BOOST_CHECK_EQUAL(ojson::parse("{\"b\":1,\"a\":2,\"b\":3}").to_string(), decode_cbor<ojson>(v).to_string());
+
+    // Nested indefinite length items, each ended by its own break
+    check_decode({0x9f,0x9f,0xff,0xbf,0x61,'a',0x9f,0x01,0xff,0xff,0x7f,0x62,'a','b',0x61,'c',0xff,0x02,0xff},
+                 json::parse(R"([[],{"a":[1]},"abc",2])"));
+}
+
+BOOST_AUTO_TEST_CASE(cbor_large_map)
+{
+    json j;
+    for (size_t i = 0; i < 500; ++i)
+    {
+        j[std::to_string((i*7919) % 500)] = i;
+    }
+    std::vector<uint8_t> v = encode_cbor(j);
+    BOOST_CHECK(decode_cbor<json>(v) == j);
+    ojson o = ojson::parse(j.to_string());
+    BOOST_CHECK(decode_cbor<ojson>(encode_cbor(o)) == o);
+}
+
+BOOST_AUTO_TEST_CASE(cbor_decode_map_keys)
+{
+    // Short, long and multibyte keys, read straight into the key storage
+    json j;
+    j["a"] = 1;
+    j[std::string(300, 'k')] = 2;
+    j["\xce\xbb\xe2\x82\xac"] = 3;
+    std::vector<uint8_t> v = encode_cbor(j);
+    BOOST_CHECK(decode_cbor<json>(v) == j);
+    BOOST_CHECK(decode_cbor<ojson>(v) == ojson::parse(j.to_string()));
+
+    wjson w = decode_cbor<wjson>(v);
+    BOOST_CHECK_EQUAL(3, w.at(L"\u03bb\u20ac").as<int>());
+    BOOST_CHECK_EQUAL(2, w.at(std::wstring(300, L'k')).as<int>());
+
+    // Indefinite length keys are decoded as strings
+    check_decode({0xa1,0x7f,0x61,'a',0x61,'b',0xff,0x01}, json::parse("{\"ab\":1}"));
+
+    std::vector<uint8_t> invalid = {0xa1,0x62,0xce,'a',0x01};
+    BOOST_CHECK_THROW(decode_cbor<json>(invalid), std::runtime_error);
+    std::vector<uint8_t> truncated = {0xa1,0x65,'a','b',0x01};
+    BOOST_CHECK_THROW(decode_cbor<json>(truncated), std::invalid_argument);
+    std::vector<uint8_t> not_a_string = {0xa1,0x01,0x01};
+    BOOST_CHECK_THROW(decode_cbor<json>(not_a_string), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(cbor_decode_byte_strings)
+{
+    check_decode({0x40}, json(byte_string()));
+    check_decode({0x43,0x01,0x02,0x03}, json(byte_string({0x01,0x02,0x03})));
+    check_decode({0x5f,0x42,0x01,0x02,0x41,0x03,0xff}, json(byte_string({0x01,0x02,0x03})));
+
+    std::vector<uint8_t> data(70000);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<uint8_t>(i*7);
+    }
+    json j(data.data(), data.size());
+    std::vector<uint8_t> v = encode_cbor(j);
+    BOOST_CHECK(decode_cbor<json>(v) == j);
+
+    std::vector<uint8_t> truncated = {0x59,0x01,0x00,0x01};
+    BOOST_CHECK_THROW(decode_cbor<json>(truncated), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(cbor_decode_limits)
+{
+    std::vector<uint8_t> v = encode_cbor(json::parse("{\"a\":[[1,2,3]],\"bc\":\"defg\"}"));
+    binary::decode_limits limits;
+    limits.max_nesting_depth = 3;
+    limits.max_items = 3;
+    limits.max_string_length = 4;
+    BOOST_CHECK(decode_cbor<json>(v, limits) == decode_cbor<json>(v));
+
+    limits.max_nesting_depth = 2;
+    BOOST_CHECK_THROW(decode_cbor<json>(v, limits), parse_error);
+    limits.max_nesting_depth = 3;
+    limits.max_items = 2;
+    BOOST_CHECK_THROW(decode_cbor<json>(v, limits), parse_error);
+    limits.max_items = 3;
+    limits.max_string_length = 3;
+    BOOST_CHECK_THROW(decode_cbor<json>(v, limits), parse_error);
+
+    // Declared lengths that the data can't hold don't reserve for them
+    std::vector<uint8_t> huge_array = {0x9b,0x00,0x00,0x00,0x7f,0xff,0xff,0xff,0xff,0x01};
+    BOOST_CHECK_THROW(decode_cbor<json>(huge_array), parse_error);
+    limits = binary::decode_limits();
+    limits.max_items = 1000;
+    try
+    {
+        decode_cbor<json>(huge_array, limits);
+        BOOST_CHECK(false);
+    }
+    catch (const parse_error& e)
+    {
+        BOOST_CHECK(e.code() == cbor_parser_errc::max_items_exceeded);
+    }
+
+    // Indefinite length arrays are counted as they are read
+    std::vector<uint8_t> indefinite = {0x9f,0x01,0x02,0x03,0xff};
+    limits.max_items = 2;
+    BOOST_CHECK_THROW(decode_cbor<json>(indefinite, limits), parse_error);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -30,6 +30,12 @@ void check_encode(const std::vector<uint8_t>& expected, const json& j)
     {
         BOOST_REQUIRE_MESSAGE(expected[i] == result[i], j.to_string());
     }
+
+    // Appended in one pass after what the vector already holds
+    std::vector<uint8_t> appended = {0xaa};
+    encode_cbor(j, appended);
+    BOOST_REQUIRE_MESSAGE(appended.size() == expected.size() + 1 && appended[0] == 0xaa, j.to_string());
+    BOOST_CHECK_MESSAGE(std::equal(expected.begin(), expected.end(), appended.begin() + 1), j.to_string());
 }
 
 BOOST_AUTO_TEST_CASE(cbor_encoder_test)
@@ -115,5 +121,28 @@ BOOST_AUTO_TEST_CASE(cbor_arrays_and_maps)
     check_encode({0xa1,0x62,'o','c',0x84,'\0','\1','\2','\3'}, json::parse("{\"oc\": [0, 1, 2, 3]}"));
 }
 
+BOOST_AUTO_TEST_CASE(cbor_encode_into_reused_buffer)
+{
+    json j = json::parse(R"({"name":"a name that takes more than sixty four bytes to encode, with its value","values":[1,256,65536,4294967296,-1.5]})");
+    std::vector<uint8_t> expected = encode_cbor(j);
+
+    std::vector<uint8_t> v;
+    encode_cbor(j, v);
+    BOOST_CHECK(v == expected);
+    const uint8_t* data = v.data();
+    for (int i = 0; i < 3; ++i)
+    {
+        v.clear();
+        encode_cbor(j, v);
+        BOOST_CHECK(v == expected);
+    }
+    BOOST_CHECK(v.data() == data);
+
+    // A failed encode leaves the vector as it was
+    json bad = json::array({json(1), json("\xff")});
+    BOOST_CHECK_THROW(encode_cbor(bad, v), std::runtime_error);
+    BOOST_CHECK(v == expected);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
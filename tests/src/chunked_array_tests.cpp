@@ -0,0 +1,132 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/detail/block_vector.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+typedef basic_json<char,chunked_array_policy> chunked_json;
+
+BOOST_AUTO_TEST_SUITE(chunked_array_tests)
+
+BOOST_AUTO_TEST_CASE(test_block_vector_matches_vector)
+{
+    detail::block_vector<std::string> v;
+    std::vector<std::string> expected;
+    uint32_t state = 2463534242u;
+    for (int i = 0; i < 20000; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        size_t pos = expected.empty() ? 0 : state % (expected.size() + 1);
+        if (state % 5 == 0)
+        {
+            pos = 0;
+        }
+        else if (state % 5 == 1)
+        {
+            pos = expected.size();
+        }
+        if (expected.size() > 100 && state % 16 == 2)
+        {
+            pos = pos % expected.size();
+            size_t n = (std::min)(size_t(state % 700), expected.size() - pos);
+            expected.erase(expected.begin() + pos, expected.begin() + (pos + n));
+            auto it = v.erase(v.begin() + pos, v.begin() + (pos + n));
+            BOOST_CHECK(it == v.begin() + pos);
+        }
+        else
+        {
+            expected.insert(expected.begin() + pos, std::to_string(i));
+            auto it = v.emplace(v.cbegin() + pos, std::to_string(i));
+            BOOST_CHECK_EQUAL(std::to_string(i), *it);
+        }
+    }
+    BOOST_REQUIRE_EQUAL(expected.size(), v.size());
+    BOOST_CHECK(std::equal(expected.begin(), expected.end(), v.begin()));
+    BOOST_CHECK(std::equal(expected.rbegin(), expected.rend(), v.rbegin()));
+    for (size_t i = 0; i < expected.size(); i += 7)
+    {
+        BOOST_CHECK_EQUAL(expected[i], v[i]);
+    }
+
+    std::vector<std::string> source(expected.begin(), expected.begin() + (expected.size()/2));
+    expected.insert(expected.begin() + 5, source.begin(), source.end());
+    v.insert(v.cbegin() + 5, source.begin(), source.end());
+    BOOST_CHECK(std::equal(expected.begin(), expected.end(), v.begin()));
+
+    detail::block_vector<std::string> copy(v);
+    BOOST_CHECK(copy == v);
+    detail::block_vector<std::string> moved(std::move(copy));
+    BOOST_CHECK(moved == v);
+    BOOST_CHECK(copy.empty());
+
+    v.resize(10);
+    v.shrink_to_fit();
+    BOOST_CHECK_EQUAL(1, v.block_count());
+    v.clear();
+    BOOST_CHECK(v.begin() == v.end());
+    BOOST_CHECK_EQUAL(0, v.block_count());
+}
+
+BOOST_AUTO_TEST_CASE(test_block_vector_stable_references)
+{
+    detail::block_vector<int> v;
+    v.push_back(1);
+    v.push_back(2);
+    int* p = &v[1];
+    for (int i = 0; i < 10000; ++i)
+    {
+        v.push_back(i);
+        v.emplace(v.cbegin(), -i);
+    }
+    BOOST_CHECK(p == &v[10001]);
+    BOOST_CHECK_EQUAL(2, *p);
+    BOOST_CHECK_EQUAL(-9999, v.front());
+    BOOST_CHECK_EQUAL(9999, v.back());
+    BOOST_CHECK(v.capacity() >= v.size());
+    BOOST_CHECK(v.capacity() - v.size() < 2*detail::block_vector<int>::block_size);
+}
+
+BOOST_AUTO_TEST_CASE(test_chunked_array_parse_and_modify)
+{
+    std::string text = "[1,\"two\",[3,4],{\"a\":[5,6]},null]";
+    chunked_json j = chunked_json::parse(text);
+    BOOST_CHECK_EQUAL(json::parse(text).to_string(), j.to_string());
+
+    chunked_json a = chunked_json::array();
+    json expected = json::array();
+    for (int i = 0; i < 1000; ++i)
+    {
+        a.push_back(i);
+        expected.push_back(i);
+    }
+    a.insert(a.array_range().begin(), -1);
+    expected.insert(expected.array_range().begin(), -1);
+    a.insert(a.array_range().begin() + 500, "middle");
+    expected.insert(expected.array_range().begin() + 500, "middle");
+    a.erase(a.array_range().begin() + 10, a.array_range().begin() + 20);
+    expected.erase(expected.array_range().begin() + 10, expected.array_range().begin() + 20);
+    BOOST_CHECK_EQUAL(expected.to_string(), a.to_string());
+    BOOST_CHECK_EQUAL(std::string("middle"), a[490].as<std::string>());
+
+    chunked_json copy = a;
+    BOOST_CHECK(copy == a);
+    copy[0] = 0;
+    BOOST_CHECK(copy != a);
+
+    a.resize(3);
+    a.shrink_to_fit();
+    BOOST_CHECK_EQUAL(std::string("[-1,0,1]"), a.to_string());
+
+    chunked_json bytes(byte_string({'H','i'}));
+    BOOST_CHECK(bytes.as<byte_string>() == byte_string({'H','i'}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,116 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/detail/chunked_vector.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+typedef basic_json<char,chunked_object_policy> chunked_json;
+
+BOOST_AUTO_TEST_SUITE(chunked_object_tests)
+
+BOOST_AUTO_TEST_CASE(test_chunked_vector_matches_vector)
+{
+    detail::chunked_vector<int> v;
+    std::vector<int> expected;
+    uint32_t state = 2463534242u;
+    for (int i = 0; i < 5000; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        size_t pos = expected.empty() ? 0 : state % (expected.size() + 1);
+        if (expected.size() > 100 && state % 16 == 0)
+        {
+            pos = pos % expected.size();
+            size_t n = (std::min)(size_t(state % 20), expected.size() - pos);
+            expected.erase(expected.begin() + pos, expected.begin() + (pos + n));
+            auto it = v.erase(v.begin() + pos, v.begin() + (pos + n));
+            BOOST_CHECK(it == v.begin() + pos);
+        }
+        else
+        {
+            expected.insert(expected.begin() + pos, i);
+            auto it = v.emplace(v.cbegin() + pos, i);
+            BOOST_CHECK_EQUAL(i, *it);
+        }
+    }
+    BOOST_REQUIRE_EQUAL(expected.size(), v.size());
+    BOOST_CHECK(v.chunk_count() > 1);
+    BOOST_CHECK(std::equal(expected.begin(), expected.end(), v.begin()));
+    BOOST_CHECK(std::equal(expected.rbegin(), expected.rend(), v.rbegin()));
+    for (size_t i = 0; i < expected.size(); i += 7)
+    {
+        BOOST_CHECK_EQUAL(expected[i], v[i]);
+        BOOST_CHECK_EQUAL(expected.end() - (expected.begin() + i), v.end() - (v.begin() + i));
+    }
+
+    std::sort(expected.begin(), expected.end());
+    std::stable_sort(v.begin(), v.end());
+    BOOST_CHECK(std::equal(expected.begin(), expected.end(), v.begin()));
+    BOOST_CHECK(std::lower_bound(v.begin(), v.end(), 2500) - v.begin() ==
+                std::lower_bound(expected.begin(), expected.end(), 2500) - expected.begin());
+
+    detail::chunked_vector<int> copy(v);
+    BOOST_CHECK(copy == v);
+    v.erase(v.begin(), v.end());
+    BOOST_CHECK(v.empty());
+    BOOST_CHECK(v.begin() == v.end());
+    BOOST_CHECK_EQUAL(0, v.chunk_count());
+}
+
+BOOST_AUTO_TEST_CASE(test_chunked_object_insert_or_assign)
+{
+    chunked_json j;
+    json expected;
+    for (int i = 0; i < 10000; ++i)
+    {
+        // Names arrive in no particular order
+        std::string name = "k" + std::to_string((i * 7919) % 10000);
+        j.insert_or_assign(name, i);
+        expected.insert_or_assign(name, i);
+    }
+    j["k17"] = "seventeen";
+    expected["k17"] = "seventeen";
+    BOOST_CHECK_EQUAL(10000, j.size());
+    BOOST_CHECK_EQUAL(expected.to_string(), j.to_string());
+    BOOST_CHECK(std::is_sorted(j.object_range().begin(), j.object_range().end(),
+                               [](const chunked_json::key_value_pair_type& a, const chunked_json::key_value_pair_type& b){return a.key() < b.key();}));
+    BOOST_CHECK_EQUAL(std::string("seventeen"), j["k17"].as<std::string>());
+    BOOST_CHECK(j.has_key("k9999"));
+    BOOST_CHECK(!j.has_key("k10000"));
+
+    j.erase("k5000");
+    BOOST_CHECK(!j.has_key("k5000"));
+    BOOST_CHECK_EQUAL(9999, j.size());
+
+    chunked_json copy = j;
+    BOOST_CHECK(copy == j);
+    copy["k1"] = 0;
+    BOOST_CHECK(copy != j);
+}
+
+BOOST_AUTO_TEST_CASE(test_chunked_object_parse_and_merge)
+{
+    std::string text = "{\"c\":1,\"a\":2,\"b\":{\"y\":1,\"x\":2},\"a\":3}";
+    chunked_json j = chunked_json::parse(text);
+    BOOST_CHECK_EQUAL(json::parse(text).to_string(), j.to_string());
+
+    chunked_json source;
+    for (int i = 0; i < 500; ++i)
+    {
+        source.insert_or_assign("m" + std::to_string(i), i);
+    }
+    j.merge(source);
+    BOOST_CHECK_EQUAL(503, j.size());
+    j.merge_or_update(chunked_json::parse("{\"a\":\"updated\",\"m7\":-7}"));
+    BOOST_CHECK_EQUAL(std::string("updated"), j["a"].as<std::string>());
+    BOOST_CHECK_EQUAL(-7, j["m7"].as<int>());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
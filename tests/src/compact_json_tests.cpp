@@ -0,0 +1,242 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/compact_json.hpp>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <new>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(compact_json_tests)
+
+// A stateless allocator that fails once a given number of allocations have been made
+static size_t allocations_left = 0;
+static size_t blocks_in_use = 0;
+
+template <class T>
+struct failing_allocator
+{
+    typedef T value_type;
+
+    failing_allocator() = default;
+    template <class U>
+    failing_allocator(const failing_allocator<U>&) {}
+
+    T* allocate(size_t n)
+    {
+        if (allocations_left == 0)
+        {
+            throw std::bad_alloc();
+        }
+        --allocations_left;
+        ++blocks_in_use;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        --blocks_in_use;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    friend bool operator==(const failing_allocator&, const failing_allocator&) {return true;}
+    friend bool operator!=(const failing_allocator&, const failing_allocator&) {return false;}
+};
+
+BOOST_AUTO_TEST_CASE(test_compact_json_size)
+{
+    BOOST_CHECK_EQUAL(8, sizeof(compact_json));
+    BOOST_CHECK_EQUAL(16, sizeof(compact_json::member));
+}
+
+BOOST_AUTO_TEST_CASE(test_compact_json_scalars)
+{
+    compact_json n;
+    BOOST_CHECK(n.is_null());
+    BOOST_CHECK_EQUAL(std::string("null"), n.to_string());
+
+    BOOST_CHECK(compact_json(true).as_bool());
+    BOOST_CHECK(!compact_json(false).as<bool>());
+    BOOST_CHECK(compact_json(true).is_bool());
+
+    compact_json small(-7);
+    BOOST_CHECK(small.is_integer());
+    BOOST_CHECK(!small.is_uinteger());
+    BOOST_CHECK_EQUAL(-7, small.as<int>());
+
+    // Integers past 48 bits are held on the heap
+    for (int64_t i : {(int64_t(1) << 47) - 1, -(int64_t(1) << 47), int64_t(1) << 47, -(int64_t(1) << 47) - 1,
+                      (std::numeric_limits<int64_t>::min)(), (std::numeric_limits<int64_t>::max)()})
+    {
+        compact_json c(i);
+        BOOST_CHECK(c.is_integer());
+        BOOST_CHECK_EQUAL(i, c.as_integer());
+        BOOST_CHECK_EQUAL(json(i).to_string(), c.to_string());
+    }
+    compact_json big((std::numeric_limits<uint64_t>::max)());
+    BOOST_CHECK(big.is_uinteger());
+    BOOST_CHECK(!big.is_integer());
+    BOOST_CHECK_EQUAL((std::numeric_limits<uint64_t>::max)(), big.as<uint64_t>());
+    BOOST_CHECK_EQUAL(std::string("18446744073709551615"), big.to_string());
+
+    compact_json d(1.5);
+    BOOST_CHECK(d.is_double());
+    BOOST_CHECK(d.is_number());
+    BOOST_CHECK_EQUAL(1.5, d.as<double>());
+    BOOST_CHECK(compact_json(-0.0).is_double());
+    BOOST_CHECK(compact_json(std::numeric_limits<double>::infinity()).is_double());
+    compact_json nan(std::numeric_limits<double>::quiet_NaN());
+    BOOST_CHECK(nan.is_double());
+    BOOST_CHECK(nan.as_double() != nan.as_double());
+    compact_json negative_nan(-std::numeric_limits<double>::quiet_NaN());
+    BOOST_CHECK(negative_nan.is_double());
+    BOOST_CHECK(!negative_nan.is_null());
+
+    BOOST_CHECK(compact_json(3) == compact_json(3.0));
+    BOOST_CHECK(compact_json(uint64_t(3)) == compact_json(int64_t(3)));
+    BOOST_CHECK(compact_json(3) != compact_json("3"));
+}
+
+BOOST_AUTO_TEST_CASE(test_compact_json_strings)
+{
+    for (std::string s : {"", "a", "abcde", "abcdef", "a longer string, held in a block"})
+    {
+        compact_json c(s);
+        BOOST_CHECK(c.is_string());
+        BOOST_CHECK(c.as_string_view() == s);
+        BOOST_CHECK_EQUAL(s, c.as<std::string>());
+
+        compact_json copy(c);
+        BOOST_CHECK(copy == c);
+        compact_json moved(std::move(copy));
+        BOOST_CHECK(moved == c);
+        BOOST_CHECK(copy.is_null());
+    }
+    BOOST_CHECK(compact_json("abc") != compact_json("abd"));
+
+    wcompact_json w(L"wide");
+    BOOST_CHECK(w.as_string_view() == L"wide");
+}
+
+BOOST_AUTO_TEST_CASE(test_compact_json_parse)
+{
+    std::string text = "{\"zeta\":1,\"alpha\":{\"b\":[1,2,{\"c\":\"d\"}],\"a\":{}},\"mid\":[],\"beta\":\"x\",\"zeta\":2}";
+    compact_json c = compact_json::parse(text);
+    BOOST_REQUIRE(c.is_object());
+    BOOST_CHECK_EQUAL(4, c.size());
+    BOOST_CHECK_EQUAL(2, c["zeta"].as<int>());
+    BOOST_CHECK_EQUAL(std::string("x"), c.at("beta").as<std::string>());
+    BOOST_CHECK_EQUAL(std::string("d"), c["alpha"]["b"][2]["c"].as<std::string>());
+    BOOST_CHECK(c["alpha"]["a"].is_object());
+    BOOST_CHECK(c["alpha"]["a"].empty());
+    BOOST_CHECK(c["mid"].is_array());
+    BOOST_CHECK(c.has_key("mid"));
+    BOOST_CHECK(!c.has_key("mi"));
+    BOOST_CHECK_THROW(c.at("zz"), std::out_of_range);
+    BOOST_CHECK_THROW(c["alpha"]["b"].at(3), std::out_of_range);
+
+    json j = json::parse(text);
+    BOOST_CHECK_EQUAL(j.to_string(), c.to_string());
+    BOOST_CHECK(c.as<json>() == j);
+    BOOST_CHECK(compact(j) == c);
+
+    std::vector<std::string> names;
+    for (const auto& m : c.members())
+    {
+        names.push_back(std::string(m.key().data(), m.key().length()));
+    }
+    BOOST_CHECK((names == std::vector<std::string>{"alpha", "beta", "mid", "zeta"}));
+
+    std::istringstream is(text);
+    BOOST_CHECK(compact_json::parse(is) == c);
+
+    BOOST_CHECK_THROW(compact_json::parse("[1,2"), parse_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_compact_json_modify)
+{
+    compact_json a = compact_json::make_array();
+    for (int i = 0; i < 100; ++i)
+    {
+        a.push_back(compact_json(i));
+    }
+    a.push_back(compact_json("a string long enough for a block"));
+    BOOST_CHECK_EQUAL(101, a.size());
+    int64_t sum = 0;
+    for (const auto& element : a.elements())
+    {
+        if (element.is_integer())
+        {
+            sum += element.as_integer();
+        }
+    }
+    BOOST_CHECK_EQUAL(4950, sum);
+
+    compact_json o = compact_json::make_object();
+    o.insert_or_assign("c", compact_json(3));
+    o.insert_or_assign("a", std::move(a));
+    o.insert_or_assign("b", compact_json(true));
+    o.insert_or_assign("c", compact_json("three"));
+    BOOST_CHECK_EQUAL(3, o.size());
+    BOOST_CHECK_EQUAL(std::string("three"), o["c"].as<std::string>());
+    BOOST_CHECK_EQUAL(101, o["a"].size());
+
+    compact_json copy = o;
+    BOOST_CHECK(copy == o);
+    copy["a"][0] = compact_json(-1);
+    BOOST_CHECK(copy != o);
+    BOOST_CHECK_EQUAL(0, o["a"][0].as<int>());
+
+    o.erase("b");
+    BOOST_CHECK_EQUAL(2, o.size());
+    BOOST_CHECK(!o.has_key("b"));
+    BOOST_CHECK(o.has_key("c"));
+
+    o.swap(copy);
+    BOOST_CHECK_EQUAL(3, o.size());
+    BOOST_CHECK_EQUAL(-1, o["a"][0].as<int>());
+}
+
+BOOST_AUTO_TEST_CASE(test_compact_json_byte_strings)
+{
+    json j(byte_string({'H','e','l','l','o'}));
+    compact_json c = compact(j);
+    BOOST_CHECK(c.is_string());
+    BOOST_CHECK_EQUAL(j.to_string(), c.to_string());
+}
+
+BOOST_AUTO_TEST_CASE(test_compact_json_copy_failure)
+{
+    typedef basic_compact_json<char,failing_allocator<char>> failing_json;
+
+    allocations_left = 100;
+    {
+        failing_json a = failing_json::make_array();
+        failing_json o = failing_json::make_object();
+        for (int i = 0; i < 10; ++i)
+        {
+            a.push_back(failing_json("a string long enough for a block"));
+            o.insert_or_assign("key" + std::to_string(i), failing_json("another string in a block"));
+        }
+        a.push_back(o);
+        const size_t in_use = blocks_in_use;
+
+        for (size_t left : {size_t(0), size_t(1), size_t(5), size_t(12), size_t(20)})
+        {
+            allocations_left = left;
+            BOOST_CHECK_THROW(failing_json copy(a), std::bad_alloc);
+            BOOST_CHECK_EQUAL(in_use, blocks_in_use);
+        }
+        allocations_left = 100;
+        failing_json copy(a);
+        BOOST_CHECK(copy == a);
+    }
+    BOOST_CHECK_EQUAL(0, blocks_in_use);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
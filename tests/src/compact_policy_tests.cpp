@@ -0,0 +1,181 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/compact_string.hpp>
+#include <jsoncons/counting_allocator.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/msgpack/msgpack.hpp>
+#include <jsoncons_ext/jsonpath/json_query.hpp>
+#include <jsoncons_ext/jsonpointer/jsonpointer.hpp>
+#include <jsoncons_ext/jsonpatch/jsonpatch.hpp>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(compact_policy_tests)
+
+typedef basic_json<char,compact_policy,std::allocator<char>> c_json;
+typedef basic_json<char,preserve_order_compact_policy,std::allocator<char>> c_ojson;
+
+std::string make_records(size_t n)
+{
+    std::ostringstream os;
+    os << "[";
+    for (size_t i = 0; i < n; ++i)
+    {
+        os << (i > 0 ? "," : "") << "{\"id\":" << i << ",\"name\":\"r" << i << "\",\"active\":true,"
+           << "\"tags\":[\"a\",\"b\"],\"score\":" << i << ".5,\"a_longer_member_name\":null}";
+    }
+    os << "]";
+    return os.str();
+}
+
+BOOST_AUTO_TEST_CASE(test_compact_string)
+{
+    BOOST_CHECK_EQUAL(16, sizeof(compact_string));
+    BOOST_CHECK_EQUAL(14, compact_string::inline_capacity);
+
+    compact_string empty;
+    BOOST_CHECK(empty.empty());
+    BOOST_CHECK_EQUAL(std::string(""), std::string(empty.c_str()));
+
+    for (std::string s : {"a", "fourteen chars", "fifteen chars!!", "a name long enough to need the heap"})
+    {
+        compact_string a(s.data(), s.length());
+        BOOST_CHECK_EQUAL(s.length() <= 14, a.is_inline());
+        BOOST_CHECK_EQUAL(s, std::string(a.c_str()));
+        BOOST_CHECK_EQUAL(s.length(), a.size());
+
+        compact_string b(a);
+        BOOST_CHECK(a == b);
+        compact_string c(std::move(b));
+        BOOST_CHECK(b.empty());
+        BOOST_CHECK(c == a);
+        c = compact_string("other");
+        BOOST_CHECK(c != a);
+        c = a;
+        BOOST_CHECK_EQUAL(0, c.compare(a));
+        c.swap(b);
+        BOOST_CHECK(b == a);
+        BOOST_CHECK(c.empty());
+    }
+    BOOST_CHECK(compact_string("abc") < compact_string("abd"));
+
+    wcompact_string w(L"ab");
+    BOOST_CHECK(w.is_inline());
+    wcompact_string wl(L"abc");
+    BOOST_CHECK(!wl.is_inline());
+    BOOST_CHECK(std::wstring(wl.c_str()) == L"abc");
+}
+
+BOOST_AUTO_TEST_CASE(test_compact_string_allocations)
+{
+    allocation_stats stats;
+    counting_allocator<char> alloc(stats);
+    {
+        typedef basic_compact_string<char,std::char_traits<char>,counting_allocator<char>> counted_string;
+        counted_string a("short", alloc);
+        counted_string b(a);
+        BOOST_CHECK_EQUAL(0, stats.allocations);
+        counted_string c("a name long enough to need the heap", alloc);
+        counted_string d(c, alloc);
+        counted_string e(std::move(d), alloc);
+        BOOST_CHECK_EQUAL(2, stats.allocations);
+    }
+    BOOST_CHECK_EQUAL(2, stats.deallocations);
+    BOOST_CHECK_EQUAL(0, stats.bytes_in_use);
+}
+
+BOOST_AUTO_TEST_CASE(test_compact_policy_documents)
+{
+    std::string s = make_records(50);
+    c_json j = c_json::parse(s);
+    json expected = json::parse(s);
+    BOOST_REQUIRE_EQUAL(50, j.size());
+    BOOST_CHECK_EQUAL(expected.to_string(), j.to_string());
+    BOOST_CHECK_EQUAL(std::string("r7"), j[7]["name"].as<std::string>());
+    BOOST_CHECK(j[7]["a_longer_member_name"].is_null());
+
+    c_json k = j;
+    BOOST_CHECK(k == j);
+    k[0].insert_or_assign("new", 1);
+    k[0].erase("tags");
+    BOOST_CHECK(k != j);
+    BOOST_CHECK(k[0].has_key("new"));
+    BOOST_CHECK(!k[0].has_key("tags"));
+
+    c_ojson o = c_ojson::parse(s);
+    BOOST_CHECK_EQUAL(ojson::parse(s).to_string(), o.to_string());
+
+    std::map<std::string,int> m = c_json::parse("{\"one\":1,\"two\":2}").as<std::map<std::string,int>>();
+    BOOST_CHECK_EQUAL(2, m["two"]);
+}
+
+BOOST_AUTO_TEST_CASE(test_compact_policy_extensions)
+{
+    c_json j = c_json::parse(make_records(3));
+
+    std::vector<uint8_t> buffer;
+    cbor::encode_cbor(j, buffer);
+    BOOST_CHECK(cbor::decode_cbor<c_json>(buffer) == j);
+
+    std::vector<uint8_t> packed;
+    msgpack::encode_msgpack(j, packed);
+    BOOST_CHECK(msgpack::decode_msgpack<c_json>(packed) == j);
+
+    c_json names = jsonpath::json_query(j, "$[*].name");
+    BOOST_CHECK_EQUAL(std::string("[\"r0\",\"r1\",\"r2\"]"), names.to_string());
+
+    c_json tag;
+    jsonpointer::jsonpointer_errc ec;
+    std::tie(tag, ec) = jsonpointer::get(j, "/1/tags/1");
+    BOOST_CHECK_EQUAL(std::string("b"), tag.as<std::string>());
+
+    c_json target = j;
+    target[2]["name"] = "changed";
+    c_json patch = jsonpatch::diff(j, target);
+    jsonpatch::patch(j, patch);
+    BOOST_CHECK(j == target);
+}
+
+BOOST_AUTO_TEST_CASE(test_compact_policy_footprint)
+{
+    std::string s = make_records(100);
+
+    allocation_stats sorted_stats;
+    size_t sorted_bytes;
+    {
+        typedef basic_json<char,sorted_policy,counting_allocator<char>> counted_json;
+        counting_allocator<char> alloc(sorted_stats);
+        json_decoder<counted_json> decoder(alloc);
+        json_parser parser(decoder);
+        parser.set_source(s.data(), s.length());
+        parser.parse();
+        parser.end_parse();
+        counted_json j = decoder.get_result();
+        sorted_bytes = sorted_stats.bytes_in_use;
+    }
+
+    allocation_stats compact_stats;
+    size_t compact_bytes;
+    {
+        typedef basic_json<char,compact_policy,counting_allocator<char>> counted_json;
+        counting_allocator<char> alloc(compact_stats);
+        json_decoder<counted_json> decoder(alloc);
+        json_parser parser(decoder);
+        parser.set_source(s.data(), s.length());
+        parser.parse();
+        parser.end_parse();
+        counted_json j = decoder.get_result();
+        compact_bytes = compact_stats.bytes_in_use;
+    }
+    BOOST_CHECK(compact_stats.allocations <= sorted_stats.allocations);
+    BOOST_CHECK(compact_bytes < sorted_bytes);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
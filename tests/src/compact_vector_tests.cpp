@@ -0,0 +1,154 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/counting_allocator.hpp>
+#include <jsoncons/detail/compact_vector.hpp>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <utility>
+
+using namespace jsoncons;
+using jsoncons::detail::compact_vector;
+
+BOOST_AUTO_TEST_SUITE(compact_vector_tests)
+
+template <class V>
+std::vector<std::string> to_vector(const V& v)
+{
+    return std::vector<std::string>(v.begin(), v.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_compact_vector_operations)
+{
+    compact_vector<std::string> v;
+    std::vector<std::string> expected;
+    BOOST_CHECK_EQUAL(0, v.size());
+    BOOST_CHECK_EQUAL(0, v.capacity());
+    BOOST_CHECK(v.begin() == v.end());
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+        std::string s(i, static_cast<char>('a' + i % 26));
+        v.push_back(s);
+        expected.push_back(s);
+    }
+    BOOST_CHECK(to_vector(v) == expected);
+
+    v.emplace(v.begin(), "front");
+    expected.emplace(expected.begin(), "front");
+    v.emplace(v.begin() + 50, "middle");
+    expected.emplace(expected.begin() + 50, "middle");
+    v.insert(v.end(), "back");
+    expected.insert(expected.end(), "back");
+    BOOST_CHECK(to_vector(v) == expected);
+
+    // Inserting an element of the vector into itself
+    v.emplace(v.begin() + 3, v.back());
+    expected.emplace(expected.begin() + 3, expected.back());
+    v.emplace_back(v.front());
+    expected.emplace_back(expected.front());
+    BOOST_CHECK(to_vector(v) == expected);
+
+    std::vector<std::string> more = {"x","y","z"};
+    v.insert(v.begin() + 10, more.begin(), more.end());
+    expected.insert(expected.begin() + 10, more.begin(), more.end());
+    BOOST_CHECK(to_vector(v) == expected);
+
+    v.erase(v.begin() + 5);
+    expected.erase(expected.begin() + 5);
+    v.erase(v.begin() + 20, v.begin() + 40);
+    expected.erase(expected.begin() + 20, expected.begin() + 40);
+    BOOST_CHECK(to_vector(v) == expected);
+
+    v.resize(10);
+    expected.resize(10);
+    BOOST_CHECK(to_vector(v) == expected);
+    v.resize(15, "filler");
+    expected.resize(15, "filler");
+    BOOST_CHECK(to_vector(v) == expected);
+
+    v.pop_back();
+    expected.pop_back();
+    BOOST_CHECK(to_vector(v) == expected);
+    BOOST_CHECK(std::vector<std::string>(v.rbegin(), v.rend()) == std::vector<std::string>(expected.rbegin(), expected.rend()));
+
+    v.shrink_to_fit();
+    BOOST_CHECK_EQUAL(v.size(), v.capacity());
+    BOOST_CHECK(to_vector(v) == expected);
+
+    compact_vector<std::string> copy(v);
+    BOOST_CHECK(copy == v);
+    compact_vector<std::string> moved(std::move(copy));
+    BOOST_CHECK(moved == v);
+    BOOST_CHECK_EQUAL(0, copy.size());
+
+    compact_vector<std::string> w = {"a","b"};
+    w.swap(moved);
+    BOOST_CHECK(w == v);
+    BOOST_CHECK_EQUAL(2, moved.size());
+    moved = w;
+    BOOST_CHECK(moved == v);
+
+    v.clear();
+    BOOST_CHECK(v.empty());
+    v.shrink_to_fit();
+    BOOST_CHECK_EQUAL(0, v.capacity());
+}
+
+BOOST_AUTO_TEST_CASE(test_compact_vector_size)
+{
+    BOOST_CHECK_EQUAL(sizeof(void*), sizeof(compact_vector<json>));
+    BOOST_CHECK_EQUAL(sizeof(void*), sizeof(json::array));
+    BOOST_CHECK_EQUAL(sizeof(void*), sizeof(json::object));
+}
+
+BOOST_AUTO_TEST_CASE(test_container_allocations)
+{
+    typedef basic_json<char,sorted_policy,counting_allocator<char>> counted_json;
+
+    allocation_stats stats;
+    counting_allocator<char> alloc(stats);
+    {
+        // An allocator with state makes the array too big to hold in the json value, so
+        // the array is allocated, and its elements are allocated once
+        counted_json a = counted_json::make_array(counted_json::array(alloc), alloc);
+        size_t before = stats.allocations;
+        a.add(1);
+        a.add(2);
+        a.add(3);
+        BOOST_CHECK_EQUAL(before + 1, stats.allocations);
+        BOOST_CHECK_EQUAL(3, a.size());
+        BOOST_CHECK_EQUAL(2, a[1].as<int>());
+
+        counted_json o(alloc);
+        o.set("a", 1);
+        o.set("b", a);
+        BOOST_CHECK(o["b"] == a);
+    }
+    BOOST_CHECK_EQUAL(stats.allocations, stats.deallocations);
+    BOOST_CHECK_EQUAL(0, stats.bytes_in_use);
+}
+
+BOOST_AUTO_TEST_CASE(test_json_containers)
+{
+    json j = json::parse(R"({"b":[1,2,3],"a":{"c":[],"d":{}},"e":"text"})");
+    BOOST_CHECK_EQUAL(3, j["b"].size());
+    j["b"].insert(j["b"].array_range().begin(), json("first"));
+    j["b"].erase(j["b"].array_range().begin() + 1);
+    BOOST_CHECK_EQUAL(std::string(R"(["first",2,3])"), j["b"].to_string());
+
+    json k = j;
+    BOOST_CHECK(k == j);
+    json& a = k.at("a");
+    j.swap(a);
+    BOOST_CHECK(k["a"]["b"].size() == 3);
+    BOOST_CHECK(j.has_key("c"));
+
+    ojson o = ojson::parse(R"({"z":1,"y":[true,false],"x":null})");
+    BOOST_CHECK_EQUAL(std::string(R"({"z":1,"y":[true,false],"x":null})"), o.to_string());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,273 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_reader.hpp>
+#include <jsoncons/input_source.hpp>
+#include <jsoncons/output_sink.hpp>
+#include <jsoncons_ext/csv/csv_reader.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/cbor/cbor_reader.hpp>
+#if defined(JSONCONS_HAS_ZLIB)
+#include <jsoncons_ext/compression/gzip.hpp>
+#endif
+#if defined(JSONCONS_HAS_ZSTD)
+#include <jsoncons_ext/compression/zstd.hpp>
+#endif
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(compression_tests)
+
+namespace {
+
+// Hands out its text a few characters at a time, and can fail part way
+class piecewise_source : public input_source
+{
+    std::string text_;
+    size_t piece_;
+    size_t fail_at_;
+    size_t pos_;
+    bool eof_;
+public:
+    piecewise_source(const std::string& text, size_t piece, size_t fail_at = std::string::npos)
+        : text_(text), piece_(piece), fail_at_(fail_at), pos_(0), eof_(false)
+    {
+    }
+
+private:
+    size_t do_read(char* data, size_t length) override
+    {
+        size_t n = (std::min)((std::min)(length, piece_), text_.size() - pos_);
+        if (fail_at_ < pos_ + n)
+        {
+            n = fail_at_ - pos_;
+        }
+        std::copy(text_.data() + pos_, text_.data() + pos_ + n, data);
+        pos_ += n;
+        eof_ = pos_ == text_.size();
+        return n;
+    }
+
+    bool do_eof() const override
+    {
+        return eof_;
+    }
+
+    bool do_fail() const override
+    {
+        return pos_ == fail_at_;
+    }
+};
+
+std::string make_records(size_t n)
+{
+    std::ostringstream os;
+    os << "[";
+    for (size_t i = 0; i < n; ++i)
+    {
+        os << (i > 0 ? "," : "") << "{\"id\":" << i << ",\"name\":\"record " << i << "\",\"tags\":[\"a\",\"b\"]}";
+    }
+    os << "]";
+    return os.str();
+}
+
+json read_json(input_source& source, std::error_code& ec)
+{
+    json_decoder<json> decoder;
+    json_reader reader(source, decoder);
+    reader.buffer_length(1000);
+    reader.read(ec);
+    return ec ? json() : decoder.get_result();
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(test_input_source_readers)
+{
+    std::string text = make_records(50);
+    std::error_code ec;
+
+    piecewise_source source(text, text.size());
+    json j = read_json(source, ec);
+    BOOST_REQUIRE(!ec);
+    BOOST_CHECK(j == json::parse(text));
+
+    piecewise_source failing(text, text.size(), 1500);
+    read_json(failing, ec);
+    BOOST_CHECK(ec == json_parser_errc::source_error);
+
+    std::string csv_text = "id,name\n1,one\n2,two\n";
+    piecewise_source csv_source(csv_text, csv_text.size());
+    json_decoder<ojson> csv_decoder;
+    csv::csv_parameters params;
+    params.assume_header(true);
+    csv::csv_reader csv_reader(csv_source, csv_decoder, params);
+    csv_reader.read();
+    BOOST_CHECK_EQUAL(std::string("[{\"id\":\"1\",\"name\":\"one\"},{\"id\":\"2\",\"name\":\"two\"}]"), csv_decoder.get_result().to_string());
+
+    std::vector<uint8_t> v;
+    cbor::encode_cbor(j, v);
+    std::string bytes(v.begin(), v.end());
+    piecewise_source cbor_source(bytes, bytes.size());
+    json_decoder<json> cbor_decoder;
+    cbor::cbor_reader cbor_reader(cbor_source, cbor_decoder);
+    cbor_reader.read();
+    BOOST_CHECK(cbor_decoder.get_result() == j);
+}
+
+#if defined(JSONCONS_HAS_ZLIB)
+
+BOOST_AUTO_TEST_CASE(test_gzip_round_trip)
+{
+    std::string text = make_records(2000);
+    json j = json::parse(text);
+
+    std::ostringstream os;
+    {
+        compression::gzip_sink sink(os);
+        json_serializer serializer(sink);
+        j.dump(serializer);
+        sink.finish();
+        BOOST_CHECK(!sink.error());
+    }
+    std::string compressed = os.str();
+    BOOST_CHECK(compressed.size()*5 < text.size());
+    BOOST_CHECK_EQUAL(0x1f, static_cast<uint8_t>(compressed[0]));
+
+    std::istringstream is(compressed);
+    compression::gzip_source source(is);
+    std::error_code ec;
+    BOOST_CHECK(read_json(source, ec) == j);
+    BOOST_CHECK(!ec);
+    BOOST_CHECK(!source.error());
+
+    // Members that follow one another, from memory
+    std::string twice = compressed + compressed;
+    compression::gzip_source source2(reinterpret_cast<const uint8_t*>(twice.data()), twice.size());
+    json_decoder<json> decoder;
+    json_reader reader(source2, decoder);
+    reader.read_next();
+    BOOST_CHECK(decoder.get_result() == j);
+    reader.read_next();
+    BOOST_CHECK(decoder.get_result() == j);
+    reader.check_done();
+}
+
+BOOST_AUTO_TEST_CASE(test_gzip_errors)
+{
+    std::string compressed;
+    {
+        string_sink out(compressed);
+        compression::gzip_sink sink(out, 1);
+        json_serializer serializer(sink);
+        json::parse(make_records(100)).dump(serializer);
+    }
+
+    std::error_code ec;
+    compression::gzip_source truncated(reinterpret_cast<const uint8_t*>(compressed.data()), compressed.size()/2);
+    read_json(truncated, ec);
+    BOOST_CHECK(ec == json_parser_errc::source_error);
+    BOOST_CHECK(truncated.error() == compression::compression_errc::unexpected_eof);
+
+    std::string corrupt = compressed;
+    corrupt[0] = 'x';
+    compression::gzip_source corrupted(reinterpret_cast<const uint8_t*>(corrupt.data()), corrupt.size());
+    read_json(corrupted, ec);
+    BOOST_CHECK(ec == json_parser_errc::source_error);
+    BOOST_CHECK(corrupted.error() == compression::compression_errc::invalid_data);
+}
+
+BOOST_AUTO_TEST_CASE(test_gzip_csv_and_cbor)
+{
+    std::string csv_text = "id,name\n";
+    for (int i = 0; i < 1000; ++i)
+    {
+        csv_text += std::to_string(i) + ",name " + std::to_string(i) + "\n";
+    }
+    std::string compressed;
+    {
+        string_sink out(compressed);
+        compression::gzip_sink sink(out);
+        sink.write(csv_text.data(), csv_text.size());
+    }
+    compression::gzip_source source(reinterpret_cast<const uint8_t*>(compressed.data()), compressed.size());
+    json_decoder<ojson> decoder;
+    csv::csv_parameters params;
+    params.assume_header(true);
+    csv::csv_reader reader(source, decoder, params);
+    reader.read();
+    ojson rows = decoder.get_result();
+    BOOST_REQUIRE_EQUAL(1000, rows.size());
+    BOOST_CHECK_EQUAL(std::string("name 999"), rows[999]["name"].as<std::string>());
+
+    json j = json::parse(make_records(500));
+    std::vector<uint8_t> v;
+    cbor::encode_cbor(j, v);
+    std::string cbor_compressed;
+    {
+        string_sink out(cbor_compressed);
+        compression::gzip_sink sink(out);
+        sink.write(reinterpret_cast<const char*>(v.data()), v.size());
+    }
+    std::istringstream is(cbor_compressed);
+    compression::gzip_source cbor_source(is);
+    json_decoder<json> cbor_decoder;
+    cbor::cbor_reader cbor_reader(cbor_source, cbor_decoder);
+    cbor_reader.read();
+    BOOST_CHECK(cbor_decoder.get_result() == j);
+}
+
+#endif
+
+#if defined(JSONCONS_HAS_ZSTD)
+
+BOOST_AUTO_TEST_CASE(test_zstd_round_trip)
+{
+    std::string text = make_records(2000);
+    json j = json::parse(text);
+
+    std::ostringstream os;
+    {
+        compression::zstd_sink sink(os);
+        json_serializer serializer(sink);
+        j.dump(serializer);
+    }
+    std::string compressed = os.str();
+    BOOST_CHECK(compressed.size()*5 < text.size());
+
+    std::istringstream is(compressed);
+    compression::zstd_source source(is);
+    std::error_code ec;
+    BOOST_CHECK(read_json(source, ec) == j);
+    BOOST_CHECK(!ec);
+
+    std::string twice = compressed + compressed;
+    compression::zstd_source source2(reinterpret_cast<const uint8_t*>(twice.data()), twice.size());
+    json_decoder<json> decoder;
+    json_reader reader(source2, decoder);
+    reader.read_next();
+    BOOST_CHECK(decoder.get_result() == j);
+    reader.read_next();
+    BOOST_CHECK(decoder.get_result() == j);
+    reader.check_done();
+
+    compression::zstd_source truncated(reinterpret_cast<const uint8_t*>(compressed.data()), compressed.size() - 3);
+    read_json(truncated, ec);
+    BOOST_CHECK(ec == json_parser_errc::source_error);
+    BOOST_CHECK(truncated.error() == compression::compression_errc::unexpected_eof);
+
+    std::string corrupt(compressed.size(), 'x');
+    compression::zstd_source corrupted(reinterpret_cast<const uint8_t*>(corrupt.data()), corrupt.size());
+    read_json(corrupted, ec);
+    BOOST_CHECK(corrupted.error() == compression::compression_errc::invalid_data);
+}
+
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
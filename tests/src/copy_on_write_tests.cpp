@@ -0,0 +1,152 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace jsoncons;
+
+typedef basic_json<char,copy_on_write_policy,std::allocator<char>> cow_json;
+typedef basic_json<char,preserve_order_copy_on_write_policy,std::allocator<char>> cow_ojson;
+
+BOOST_AUTO_TEST_SUITE(copy_on_write_tests)
+
+BOOST_AUTO_TEST_CASE(test_copy_shares)
+{
+    cow_json a = cow_json::parse("{\"x\":[1,2,3],\"y\":{\"z\":\"a string that is not short\"}}");
+    cow_json b = a;
+
+    const cow_json& ca = a;
+    const cow_json& cb = b;
+    BOOST_CHECK(&ca.at("x") == &cb.at("x"));
+    BOOST_CHECK(&ca.at("y").at("z") == &cb.at("y").at("z"));
+    BOOST_CHECK(a == b);
+}
+
+BOOST_AUTO_TEST_CASE(test_modified_copy)
+{
+    cow_json a = cow_json::parse("{\"x\":[1,2,3],\"y\":{\"z\":[4,5]}}");
+    cow_json b = a;
+
+    b["x"].add(4);
+
+    const cow_json& ca = a;
+    const cow_json& cb = b;
+    BOOST_CHECK_EQUAL(3, ca.at("x").size());
+    BOOST_CHECK_EQUAL(4, cb.at("x").size());
+    BOOST_CHECK(ca.at("x") == cow_json::parse("[1,2,3]"));
+
+    // The top level object and "x" were copied, "y" is still shared
+    BOOST_CHECK(&ca.at("x") != &cb.at("x"));
+    BOOST_CHECK(&ca.at("y").at("z") == &cb.at("y").at("z"));
+
+    b["y"]["z"][0] = 10;
+    BOOST_CHECK_EQUAL(4, ca.at("y").at("z").at(0).as<int>());
+    BOOST_CHECK_EQUAL(10, cb.at("y").at("z").at(0).as<int>());
+
+    a.erase("y");
+    BOOST_CHECK(!ca.has_key("y"));
+    BOOST_CHECK(cb.has_key("y"));
+}
+
+BOOST_AUTO_TEST_CASE(test_assign_and_swap)
+{
+    cow_ojson a = cow_ojson::parse("{\"b\":[1],\"a\":[2]}");
+    cow_ojson b;
+    b = a;
+    cow_ojson c = std::move(b);
+    c["a"].add(3);
+    BOOST_CHECK_EQUAL(std::string("{\"b\":[1],\"a\":[2]}"), a.to_string());
+    BOOST_CHECK_EQUAL(std::string("{\"b\":[1],\"a\":[2,3]}"), c.to_string());
+
+    cow_ojson d = cow_ojson::array();
+    swap(c, d);
+    BOOST_CHECK(c.is_array());
+    BOOST_CHECK_EQUAL(2, d.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_string_copies_share)
+{
+    cow_json a("a string too long to be stored in place");
+    cow_json b = a;
+    BOOST_CHECK(a.as_string_view().data() == b.as_string_view().data());
+    a = "another string too long to be stored in place";
+    BOOST_CHECK_EQUAL(std::string("a string too long to be stored in place"), b.as<std::string>());
+
+    // A copy with another allocator has its own characters
+    cow_json c(b, std::allocator<char>());
+    BOOST_CHECK(c == b);
+}
+
+BOOST_AUTO_TEST_CASE(test_decoder_intern_strings)
+{
+    std::string text = "[";
+    for (int i = 0; i < 100; ++i)
+    {
+        if (i > 0)
+        {
+            text += ",";
+        }
+        text += "{\"status\":\"" + std::string(i % 3 == 0 ? "pending_verification" : "completed_successfully") + "\","
+                "\"id\":\"record identifier number " + std::to_string(i) + "\",\"short\":\"ok\"}";
+    }
+    text += "]";
+
+    json_decoder<cow_json> decoder;
+    decoder.intern_strings(true);
+    std::istringstream is(text);
+    json_reader reader(is, decoder);
+    reader.read();
+    cow_json j = decoder.get_result();
+
+    BOOST_CHECK_EQUAL(102, decoder.interned_string_count());
+    BOOST_CHECK(j[0]["status"].as_string_view().data() == j[3]["status"].as_string_view().data());
+    BOOST_CHECK(j[1]["status"].as_string_view().data() == j[2]["status"].as_string_view().data());
+    BOOST_CHECK(j[0]["status"].as_string_view().data() != j[1]["status"].as_string_view().data());
+    BOOST_CHECK_EQUAL(std::string("completed_successfully"), j[98]["status"].as<std::string>());
+    BOOST_CHECK_EQUAL(std::string("record identifier number 42"), j[42]["id"].as<std::string>());
+    BOOST_CHECK_EQUAL(json::parse(text).to_string(), j.to_string());
+
+    decoder.intern_strings(false);
+    BOOST_CHECK_EQUAL(0, decoder.interned_string_count());
+}
+
+BOOST_AUTO_TEST_CASE(test_copies_on_threads)
+{
+    cow_json doc = cow_json::parse("{\"settings\":{\"a\":[1,2,3],\"b\":{\"c\":true}},\"count\":0}");
+    const cow_json& source = doc;
+
+    std::vector<std::thread> threads;
+    std::vector<cow_json> results(8);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        threads.emplace_back([&source,&results,i]()
+        {
+            for (int j = 0; j < 1000; ++j)
+            {
+                cow_json copy = source;
+                copy["count"] = j;
+                copy["settings"]["a"].add(static_cast<int>(i));
+                results[i] = std::move(copy);
+            }
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    BOOST_CHECK_EQUAL(3, source.at("settings").at("a").size());
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(999, results[i].at("count").as<int>());
+        BOOST_CHECK_EQUAL(4, results[i].at("settings").at("a").size());
+        BOOST_CHECK_EQUAL(i, results[i].at("settings").at("a").at(3).as<size_t>());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,124 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/json_parser.hpp>
+#include <jsoncons/counting_allocator.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(counting_allocator_tests)
+
+typedef basic_json<char,sorted_policy,counting_allocator<char>> counted_json;
+
+BOOST_AUTO_TEST_CASE(test_count_decode)
+{
+    std::string s = "{\"name\":\"a string that is too long for the short string buffer\",\"items\":[1,-2,3.5,true,null,{\"key\":\"value\"}]}";
+
+    allocation_stats stats;
+    counting_allocator<char> alloc(stats);
+    {
+        json_decoder<counted_json> decoder(alloc);
+        json_parser parser(decoder);
+        parser.set_source(s.data(), s.length());
+        parser.parse();
+        parser.end_parse();
+        parser.check_done();
+
+        counted_json j = decoder.get_result();
+        BOOST_CHECK_EQUAL(std::string("value"), j["items"][5]["key"].as<std::string>());
+
+        BOOST_CHECK(stats.allocations > 0);
+        BOOST_CHECK(stats.bytes_in_use > 0);
+        BOOST_CHECK(stats.peak_bytes_in_use >= stats.bytes_in_use);
+        BOOST_CHECK(stats.bytes_allocated >= stats.peak_bytes_in_use);
+    }
+    // Everything allocated has been returned
+    BOOST_CHECK_EQUAL(stats.allocations, stats.deallocations);
+    BOOST_CHECK_EQUAL(0, stats.bytes_in_use);
+
+    stats.reset();
+    BOOST_CHECK_EQUAL(0, stats.allocations);
+    BOOST_CHECK_EQUAL(0, stats.peak_bytes_in_use);
+}
+
+BOOST_AUTO_TEST_CASE(test_proxy_reads_dont_allocate)
+{
+    allocation_stats stats;
+    counting_allocator<char> alloc(stats);
+    {
+        json_decoder<counted_json> decoder(alloc);
+        std::string s = "{\"a member name that is too long for the short string buffer\":{\"another long member name for the test\":{\"c\":7}}}";
+        json_parser parser(decoder);
+        parser.set_source(s.data(), s.length());
+        parser.parse();
+        parser.end_parse();
+        parser.check_done();
+        counted_json j = decoder.get_result();
+
+        // A read through a chain of proxies copies no names
+        size_t allocations = stats.allocations;
+        BOOST_CHECK(j["a member name that is too long for the short string buffer"]["another long member name for the test"]["c"].is_integer());
+        BOOST_CHECK_EQUAL(7, j["a member name that is too long for the short string buffer"]["another long member name for the test"]["c"].as<int>());
+        BOOST_CHECK_EQUAL(allocations, stats.allocations);
+
+        // A write copies the name into the new member
+        j["a member name that is too long for the short string buffer"]["a new member name that is also too long"] = 1;
+        BOOST_CHECK(stats.allocations > allocations);
+        BOOST_CHECK_EQUAL(1, j["a member name that is too long for the short string buffer"]["a new member name that is also too long"].as<int>());
+    }
+    BOOST_CHECK_EQUAL(stats.allocations, stats.deallocations);
+}
+
+BOOST_AUTO_TEST_CASE(test_decoder_stats)
+{
+    std::string s = "{\"a\":[1,-2,3.5,true,null,{\"b\":[[]]}],\"c\":\"x\",\"d\":18446744073709551615}";
+
+    json_decoder<json> decoder;
+    BOOST_CHECK(!decoder.collect_stats());
+    decoder.collect_stats(true);
+
+    json_parser parser(decoder);
+    parser.set_source(s.data(), s.length());
+    parser.parse();
+    parser.end_parse();
+    parser.check_done();
+
+    const json_decoder_stats& stats = decoder.stats();
+    BOOST_CHECK_EQUAL(2, stats.objects);
+    BOOST_CHECK_EQUAL(3, stats.arrays);
+    BOOST_CHECK_EQUAL(4, stats.names);
+    BOOST_CHECK_EQUAL(1, stats.strings);
+    BOOST_CHECK_EQUAL(1, stats.integers);
+    BOOST_CHECK_EQUAL(2, stats.uintegers);
+    BOOST_CHECK_EQUAL(1, stats.doubles);
+    BOOST_CHECK_EQUAL(1, stats.bools);
+    BOOST_CHECK_EQUAL(1, stats.nulls);
+    BOOST_CHECK_EQUAL(5, stats.max_depth);
+    BOOST_CHECK_EQUAL(12, stats.value_count());
+}
+
+BOOST_AUTO_TEST_CASE(test_decoder_stats_per_text)
+{
+    std::istringstream is("[1,[2]] 3");
+
+    json_decoder<json> decoder;
+    decoder.collect_stats(true);
+    json_reader reader(is, decoder);
+
+    reader.read_next();
+    BOOST_CHECK_EQUAL(2, decoder.stats().arrays);
+    BOOST_CHECK_EQUAL(2, decoder.stats().max_depth);
+
+    reader.read_next();
+    BOOST_CHECK_EQUAL(0, decoder.stats().arrays);
+    BOOST_CHECK_EQUAL(1, decoder.stats().uintegers);
+    BOOST_CHECK_EQUAL(0, decoder.stats().max_depth);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
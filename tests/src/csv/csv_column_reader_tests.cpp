@@ -0,0 +1,142 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons_ext/csv/csv_column_reader.hpp>
+#include <sstream>
+#include <vector>
+#include <string>
+
+using namespace jsoncons;
+using namespace jsoncons::csv;
+
+BOOST_AUTO_TEST_SUITE(csv_column_reader_tests)
+
+BOOST_AUTO_TEST_CASE(test_typed_columns)
+{
+    std::string s = "id,price,name,in_stock\n1,9.5,apple,true\n2,,\"pear, ripe\",0\n3,12,plum,x\n";
+    std::istringstream is(s);
+
+    csv_parameters params;
+    params.assume_header(true)
+          .column_types("integer,float,string,boolean");
+    std::vector<csv_column> columns = decode_csv_columns(is, params);
+
+    BOOST_REQUIRE_EQUAL(4, columns.size());
+    BOOST_CHECK_EQUAL(std::string("id"), columns[0].name());
+    BOOST_CHECK(columns[0].type() == csv_column_type::integer_t);
+    BOOST_CHECK(columns[0].integers() == std::vector<int64_t>({1,2,3}));
+    BOOST_CHECK_EQUAL(0, columns[0].null_count());
+
+    BOOST_CHECK(columns[1].type() == csv_column_type::float_t);
+    BOOST_CHECK(columns[1].doubles() == std::vector<double>({9.5,0.0,12.0}));
+    BOOST_CHECK(!columns[1].is_null(0));
+    BOOST_CHECK(columns[1].is_null(1));
+    BOOST_CHECK_EQUAL(1, columns[1].null_count());
+
+    BOOST_CHECK(columns[2].type() == csv_column_type::string_t);
+    BOOST_CHECK_EQUAL(std::string("applepear, ripeplum"), columns[2].chars());
+    BOOST_CHECK(columns[2].offsets() == std::vector<size_t>({0,5,15,19}));
+    BOOST_CHECK(columns[2].string_at(1) == "pear, ripe");
+
+    BOOST_CHECK(columns[3].type() == csv_column_type::boolean_t);
+    BOOST_CHECK(columns[3].booleans() == std::vector<uint8_t>({1,0,0}));
+    BOOST_CHECK(columns[3].is_null(2));
+
+    for (const auto& c : columns)
+    {
+        BOOST_CHECK_EQUAL(3, c.size());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_columns_match_m_columns)
+{
+    std::string s = "a,b,c\n1,x,2.5\n-7,y,\n4,z,1e3\n";
+    csv_parameters params;
+    params.assume_header(true)
+          .column_types("integer,string,float")
+          .column_defaults("0,,-1");
+
+    std::istringstream is1(s);
+    std::vector<csv_column> columns = decode_csv_columns(is1, params);
+
+    params.mapping(mapping_type::m_columns);
+    std::istringstream is2(s);
+    json_decoder<ojson> decoder;
+    csv_reader reader(is2, decoder, params);
+    reader.read();
+    ojson expected = decoder.get_result();
+
+    BOOST_REQUIRE_EQUAL(expected.size(), columns.size());
+    for (const auto& c : columns)
+    {
+        const ojson& values = expected.at(c.name());
+        BOOST_REQUIRE_EQUAL(values.size(), c.size());
+        for (size_t i = 0; i < c.size(); ++i)
+        {
+            switch (c.type())
+            {
+            case csv_column_type::integer_t:
+                BOOST_CHECK_EQUAL(values[i].as<int64_t>(), c.integers()[i]);
+                break;
+            case csv_column_type::float_t:
+                BOOST_CHECK_EQUAL(values[i].as<double>(), c.doubles()[i]);
+                break;
+            default:
+                BOOST_CHECK_EQUAL(values[i].as<std::string>(), std::string(c.string_at(i)));
+                break;
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_untyped_and_ragged_rows)
+{
+    // No header, no column types: columns of strings, short rows filled with nulls
+    std::string s = "1,2,3\n4\n5,6,7,8\n";
+    std::istringstream is(s);
+    csv_column_reader reader(is);
+    std::vector<csv_column> columns = reader.read();
+
+    BOOST_REQUIRE_EQUAL(4, columns.size());
+    BOOST_CHECK(columns[0].type() == csv_column_type::string_t);
+    BOOST_CHECK_EQUAL(std::string("145"), columns[0].chars());
+    BOOST_CHECK_EQUAL(3, columns[1].size());
+    BOOST_CHECK(columns[1].is_null(1));
+    BOOST_CHECK(columns[1].string_at(1) == "");
+    BOOST_CHECK_EQUAL(3, columns[3].size());
+    BOOST_CHECK(columns[3].is_null(0));
+    BOOST_CHECK(columns[3].is_null(1));
+    BOOST_CHECK(!columns[3].is_null(2));
+    BOOST_CHECK(columns[3].string_at(2) == "8");
+}
+
+BOOST_AUTO_TEST_CASE(test_column_projection)
+{
+    std::string s = "a,b,c\n1,2,3\n4,5,6\n";
+    std::istringstream is(s);
+    csv_parameters params;
+    params.assume_header(true)
+          .column_types("integer,integer,integer")
+          .column_projection("c,a");
+    std::vector<csv_column> columns = decode_csv_columns(is, params);
+
+    BOOST_REQUIRE_EQUAL(2, columns.size());
+    BOOST_CHECK_EQUAL(std::string("a"), columns[0].name());
+    BOOST_CHECK(columns[0].integers() == std::vector<int64_t>({1,4}));
+    BOOST_CHECK_EQUAL(std::string("c"), columns[1].name());
+    BOOST_CHECK(columns[1].integers() == std::vector<int64_t>({3,6}));
+}
+
+BOOST_AUTO_TEST_CASE(test_nested_column_types)
+{
+    std::string s = "1,2\n";
+    std::istringstream is(s);
+    csv_parameters params;
+    params.column_types("integer,[integer]*");
+    BOOST_CHECK_THROW(csv_column_reader(is, params), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
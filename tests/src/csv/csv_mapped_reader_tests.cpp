@@ -0,0 +1,99 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons_ext/csv/csv_reader.hpp>
+#include <jsoncons_ext/csv/csv_mapped_reader.hpp>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+using namespace jsoncons;
+using namespace jsoncons::csv;
+
+BOOST_AUTO_TEST_SUITE(csv_mapped_reader_tests)
+
+static json read_stream(const std::string& text, const csv_parameters& params)
+{
+    json_decoder<json> decoder;
+    std::istringstream is(text);
+    csv_reader reader(is, decoder, params);
+    reader.read();
+    return decoder.get_result();
+}
+
+static json read_mapped(const char* filename, const csv_parameters& params, size_t max_threads)
+{
+    json_decoder<json> decoder;
+    csv_mapped_reader reader(filename, decoder, params,
+                             parallel_options().max_threads(max_threads).min_chunk_size(1));
+    reader.read();
+    return decoder.get_result();
+}
+
+// Quoted values with delimiters, quotes and line ends in them, so that most
+// of the even splits of the file fall inside quotes
+static std::string quoted_text(size_t lines)
+{
+    std::string text = "id,\"name\",price\r\n";
+    for (size_t i = 0; i < lines; ++i)
+    {
+        std::string s = std::to_string(i);
+        text += s + ",\"" + s + (i % 3 == 0 ? ",\r\n\"\"x\"\"\n" : "\"\"") + "\"," + s + ".5" + (i % 2 ? "\n" : "\r\n");
+    }
+    return text;
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_same_as_serial)
+{
+    const char* filename = "csv_mapped_reader_quoted.csv";
+    std::string text = quoted_text(500);
+    {
+        std::ofstream os(filename, std::ios_base::binary);
+        os << text;
+    }
+
+    std::vector<csv_parameters> params(4);
+    params[0].assume_header(true);
+    params[1].assume_header(true).mapping(mapping_type::n_rows).column_types("integer,string,float");
+    params[2].header_lines(2).mapping(mapping_type::n_rows);
+    params[3].assume_header(true).mapping(mapping_type::m_columns);
+
+    for (const auto& p : params)
+    {
+        json expected = read_stream(text, p);
+        for (size_t max_threads : {size_t(1), size_t(2), size_t(7), size_t(64)})
+        {
+            BOOST_CHECK_EQUAL(expected, read_mapped(filename, p, max_threads));
+        }
+    }
+    std::remove(filename);
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_short_files)
+{
+    const char* filename = "csv_mapped_reader_short.csv";
+    csv_parameters params;
+    params.assume_header(true);
+    for (std::string text : {"", "a,b", "a,b\r\n", "a,b\n1,2", "a,b\n1,\"2\n3\"\n4,5\n"})
+    {
+        {
+            std::ofstream os(filename, std::ios_base::binary);
+            os << text;
+        }
+        BOOST_CHECK_EQUAL(read_stream(text, params), read_mapped(filename, params, 8));
+    }
+    std::remove(filename);
+}
+
+BOOST_AUTO_TEST_CASE(test_mapped_reader_missing_file)
+{
+    json_decoder<json> decoder;
+    csv_mapped_reader reader("input/no-such-file.csv", decoder);
+    BOOST_CHECK(reader.open_error());
+    BOOST_CHECK_THROW(reader.read(), parse_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,151 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons_ext/csv/csv_record_reader.hpp>
+#include <sstream>
+#include <vector>
+#include <string>
+
+using namespace jsoncons;
+using namespace jsoncons::csv;
+
+namespace {
+
+struct book
+{
+    std::string author;
+    std::string title;
+    double price;
+    int32_t year;
+    uint16_t copies;
+    bool in_print;
+
+    book()
+        : price(0), year(0), copies(0), in_print(false)
+    {
+    }
+};
+
+}
+
+namespace jsoncons { namespace csv {
+
+template <>
+struct csv_record_traits<book>
+{
+    template <class Visitor>
+    static void members(Visitor& visitor)
+    {
+        visitor("author", &book::author);
+        visitor("title", &book::title);
+        visitor("price", &book::price);
+        visitor("year", &book::year);
+        visitor("copies", &book::copies);
+        visitor("in_print", &book::in_print);
+    }
+};
+
+}}
+
+BOOST_AUTO_TEST_SUITE(csv_record_reader_tests)
+
+BOOST_AUTO_TEST_CASE(test_records_by_header_names)
+{
+    // Columns in a different order from the members, and a column without a member
+    std::string text = "year,title,isbn,author,price,in_print,copies\n"
+                       "1851,\"Moby Dick\",0-19-,Herman Melville,12.5,TRUE,300\n"
+                       "2003,\"Beyond, \"\"Good\"\" and Evil\",,Friedrich Nietzsche,,0,\n"
+                       "1999,Short\n";
+    std::istringstream is(text);
+    csv_parameters params;
+    params.assume_header(true);
+    std::vector<book> books = decode_csv_records<book>(is, params);
+
+    BOOST_REQUIRE_EQUAL(3, books.size());
+    BOOST_CHECK_EQUAL("Herman Melville", books[0].author);
+    BOOST_CHECK_EQUAL("Moby Dick", books[0].title);
+    BOOST_CHECK_EQUAL(12.5, books[0].price);
+    BOOST_CHECK_EQUAL(1851, books[0].year);
+    BOOST_CHECK_EQUAL(300, books[0].copies);
+    BOOST_CHECK(books[0].in_print);
+
+    BOOST_CHECK_EQUAL("Friedrich Nietzsche", books[1].author);
+    BOOST_CHECK_EQUAL("Beyond, \"Good\" and Evil", books[1].title);
+    BOOST_CHECK_EQUAL(0.0, books[1].price);
+    BOOST_CHECK_EQUAL(0, books[1].copies);
+    BOOST_CHECK(!books[1].in_print);
+
+    BOOST_CHECK_EQUAL("", books[2].author);
+    BOOST_CHECK_EQUAL("Short", books[2].title);
+    BOOST_CHECK_EQUAL(1999, books[2].year);
+}
+
+BOOST_AUTO_TEST_CASE(test_records_by_position)
+{
+    std::string text = "Jane Austen,Emma,7.25,1815,12,false\r\n"
+                       "Leo Tolstoy,War and Peace,,-1,,1\r\n";
+    std::istringstream is(text);
+
+    std::vector<book> books;
+    csv_record_reader<book> reader(is);
+    reader.read([&books](book&& b){books.push_back(std::move(b));});
+
+    BOOST_REQUIRE_EQUAL(2, books.size());
+    BOOST_CHECK_EQUAL("Emma", books[0].title);
+    BOOST_CHECK_EQUAL(7.25, books[0].price);
+    BOOST_CHECK_EQUAL(1815, books[0].year);
+    BOOST_CHECK_EQUAL(12, books[0].copies);
+    BOOST_CHECK(!books[0].in_print);
+    BOOST_CHECK_EQUAL("Leo Tolstoy", books[1].author);
+    BOOST_CHECK_EQUAL(-1, books[1].year);
+    BOOST_CHECK(books[1].in_print);
+}
+
+BOOST_AUTO_TEST_CASE(test_records_same_as_json)
+{
+    std::string text = "author,title,price\nA,B,1.5\nC,\"D\nE\",2e3\n";
+    csv_parameters params;
+    params.column_names("author,title,price");
+    params.header_lines(1);
+
+    std::istringstream is1(text);
+    std::vector<book> books = decode_csv_records<book>(is1, params);
+
+    std::istringstream is2(text);
+    params.mapping(mapping_type::n_objects).column_types("string,string,float");
+    json_decoder<ojson> decoder;
+    csv_reader reader(is2, decoder, params);
+    reader.read();
+    ojson j = decoder.get_result();
+
+    BOOST_REQUIRE_EQUAL(j.size(), books.size());
+    for (size_t i = 0; i < books.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(j[i]["author"].as<std::string>(), books[i].author);
+        BOOST_CHECK_EQUAL(j[i]["title"].as<std::string>(), books[i].title);
+        BOOST_CHECK_EQUAL(j[i]["price"].as<double>(), books[i].price);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_records_invalid_field)
+{
+    std::string text = "author,copies\nA,70000\n";
+    std::istringstream is(text);
+    csv_parameters params;
+    params.assume_header(true);
+    try
+    {
+        decode_csv_records<book>(is, params);
+        BOOST_FAIL("Expected parse_error");
+    }
+    catch (const parse_error& e)
+    {
+        BOOST_CHECK(e.code() == csv_parser_errc::invalid_field_value);
+        BOOST_CHECK_EQUAL(2, e.line_number());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -63,6 +63,175 @@ BOOST_AUTO_TEST_CASE(n_columns_test)
     BOOST_CHECK(3 == val3["5Y"].size());
 }
 
+// Values spilled to a temporary file are read back in order, quoted values are kept
+BOOST_AUTO_TEST_CASE(m_columns_max_column_memory_test)
+{
+    std::string text = "a,b,c\n";
+    json expected = json::parse(R"({"a":[],"b":[],"c":[]})");
+    for (int i = 0; i < 1000; ++i)
+    {
+        std::string s = std::to_string(i);
+        text += s + ",\"q" + s + ",x\"," + std::string(i % 7, 'z') + "\n";
+        expected["a"].push_back(i);
+        expected["b"].push_back("q" + s + ",x");
+        expected["c"].push_back(std::string(i % 7, 'z'));
+    }
+
+    csv_parameters params;
+    params.assume_header(true)
+          .column_types("integer,string,string")
+          .mapping(mapping_type::m_columns);
+    for (size_t max_memory : {size_t(100000000), size_t(1000), size_t(1)})
+    {
+        params.max_column_memory(max_memory);
+        json_decoder<json> decoder;
+        std::istringstream is(text);
+        csv_reader reader(is, decoder, params);
+        reader.read();
+        BOOST_CHECK_EQUAL(expected, decoder.get_result());
+    }
+}
+
+// Fields that are longer than the vector blocks, or cross the end of a buffer
+BOOST_AUTO_TEST_CASE(csv_long_fields_across_buffers)
+{
+    std::string text = "name,value,note\r\n";
+    json expected = json::array();
+    for (int i = 0; i < 200; ++i)
+    {
+        std::string s = std::to_string(i);
+        std::string name = std::string(i % 41, 'n') + s;
+        std::string note = "line " + s + "\r\n" + std::string(i % 37, 'x') + "\"\"" + s;
+        text += "  " + name + " ," + s + ",\"" + note + "\"" + (i % 2 ? "\n" : "\r\n");
+
+        json row;
+        row["name"] = name;
+        row["value"] = i;
+        row["note"] = "line " + s + "\r\n" + std::string(i % 37, 'x') + "\"" + s;
+        expected.push_back(row);
+    }
+
+    csv_parameters params;
+    params.assume_header(true)
+          .trim(true)
+          .column_types("string,integer,string");
+    for (size_t buffer_length : {size_t(1), size_t(5), size_t(33), size_t(100), size_t(16384)})
+    {
+        json_decoder<json> decoder;
+        std::istringstream is(text);
+        csv_reader reader(is, decoder, params);
+        reader.buffer_length(buffer_length);
+        reader.read();
+        BOOST_CHECK_EQUAL(expected, decoder.get_result());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(csv_column_projection)
+{
+    std::string input = "a,b,c,d\n"
+                        "1,\"x,\n\"\"y\",3,true\n"
+                        "4,  z  ,6,false\n";
+
+    csv_parameters params;
+    params.assume_header(true)
+          .trim(true)
+          .column_types("integer,string,integer,boolean")
+          .column_projection("d,0");
+
+    std::vector<std::pair<mapping_type,std::string>> expected =
+    {
+        {mapping_type::n_objects, R"([{"a":1,"d":true},{"a":4,"d":false}])"},
+        {mapping_type::n_rows, R"([["a","d"],[1,true],[4,false]])"},
+        {mapping_type::m_columns, R"({"a":[1,4],"d":[true,false]})"}
+    };
+    for (const auto& item : expected)
+    {
+        params.mapping(item.first);
+        json_decoder<json> decoder;
+        std::istringstream is(input);
+        csv_reader reader(is, decoder, params);
+        reader.read();
+        BOOST_CHECK_EQUAL(json::parse(item.second), decoder.get_result());
+    }
+
+    // Without a header, by index, and names that are not columns are left out
+    csv_parameters params2;
+    params2.column_projection("1,e,3");
+    json_decoder<json> decoder;
+    std::istringstream is(input);
+    csv_reader reader(is, decoder, params2);
+    reader.read();
+    BOOST_CHECK_EQUAL(json::parse(R"([["b","d"],["x,\n\"y","true"],["  z  ","false"]])"), decoder.get_result());
+
+    // Large indexes select columns without a flag for every column before them
+    std::string wide;
+    for (size_t i = 0; i < 70000; ++i)
+    {
+        wide += (i > 0 ? "," : "") + std::to_string(i);
+    }
+    wide += "\n";
+    csv_parameters params3;
+    params3.column_projection("69999,4000000000,99999999999999999999999,1");
+    json_decoder<json> decoder3;
+    std::istringstream is3(wide);
+    csv_reader reader3(is3, decoder3, params3);
+    reader3.read();
+    BOOST_CHECK_EQUAL(json::parse(R"([["1","69999"]])"), decoder3.get_result());
+}
+
+BOOST_AUTO_TEST_CASE(csv_crlf_at_end)
+{
+    csv_parameters params;
+    params.assume_header(true);
+
+    json_decoder<json> decoder;
+    std::istringstream is("a,b\r\n1,2\r\n");
+    csv_reader reader(is, decoder, params);
+    reader.read();
+    BOOST_CHECK_EQUAL(json::parse(R"([{"a":"1","b":"2"}])"), decoder.get_result());
+}
+
+BOOST_AUTO_TEST_CASE(csv_typed_number_cells)
+{
+    std::string input = "i,f\n"
+                        "0,0\n"
+                        "-17,-0.5\n"
+                        "+42,1e-3\n"
+                        "9223372036854775807,12345678901234567890.5\n"
+                        "-9223372036854775808,\"2.5E+10\"\n"
+                        "9223372036854775808,+1.5\n"
+                        " 7,x\n";
+
+    csv_parameters params;
+    params.assume_header(true)
+          .mapping(mapping_type::n_rows)
+          .column_types("integer,float")
+          .column_defaults("-1,-1.0");
+
+    json_decoder<json> decoder;
+    std::istringstream is(input);
+    csv_reader reader(is, decoder, params);
+    reader.read();
+    json val = decoder.get_result();
+
+    BOOST_REQUIRE_EQUAL(8, val.size());
+    BOOST_CHECK_EQUAL(0, val[1][0].as<int64_t>());
+    BOOST_CHECK(val[1][1].is_double());
+    BOOST_CHECK_EQUAL(-17, val[2][0].as<int64_t>());
+    BOOST_CHECK_EQUAL(-0.5, val[2][1].as<double>());
+    BOOST_CHECK_EQUAL(42, val[3][0].as<int64_t>());
+    BOOST_CHECK_EQUAL(1e-3, val[3][1].as<double>());
+    BOOST_CHECK_EQUAL((std::numeric_limits<int64_t>::max)(), val[4][0].as<int64_t>());
+    BOOST_CHECK_EQUAL(12345678901234567890.5, val[4][1].as<double>());
+    BOOST_CHECK_EQUAL((std::numeric_limits<int64_t>::min)(), val[5][0].as<int64_t>());
+    BOOST_CHECK_EQUAL(2.5e10, val[5][1].as<double>());
+    // Cells that are not plain numbers are converted as before
+    BOOST_CHECK_EQUAL(-1, val[6][0].as<int64_t>());
+    BOOST_CHECK_EQUAL(1.5, val[6][1].as<double>());
+    BOOST_CHECK_EQUAL(7, val[7][0].as<int64_t>());
+    BOOST_CHECK_EQUAL(-1.0, val[7][1].as<double>());
+}
+
 BOOST_AUTO_TEST_CASE(csv_test_empty_values)
 {
     std::string input = "bool-f,int-f,float-f,string-f"
@@ -730,6 +899,51 @@ BOOST_AUTO_TEST_CASE(test_tab_delimited_file)
     BOOST_CHECK_EQUAL(std::string("00000004"),employees[3]["employee-no"].as<std::string>());
 }
 
+// Members that come out of the order of the columns, or are missing
+BOOST_AUTO_TEST_CASE(serialize_object_rows_out_of_order)
+{
+    ojson rows = ojson::parse(R"(
+    [
+        {"a":1,"b":"x,y","c":true},
+        {"c":false,"a":2},
+        {"b":"say \"hi\"","d":4,"a":3,"c":null},
+        {"a":"line\nbreak","b":[1,2],"c":-5}
+    ]
+    )");
+
+    std::ostringstream os;
+    csv_serializer serializer(os);
+    rows.dump(serializer);
+    BOOST_CHECK_EQUAL(std::string("a,b,c\n1,\"x,y\",true\n2,,false\n3,\"say \"\"hi\"\"\",null\n\"line\nbreak\",,-5\n"), os.str());
+
+    csv_parameters params;
+    params.column_names("c,a");
+    std::ostringstream os2;
+    csv_serializer serializer2(os2, params);
+    rows.dump(serializer2);
+    BOOST_CHECK_EQUAL(std::string("c,a\ntrue,1\nfalse,2\nnull,3\n-5,\"line\nbreak\"\n"), os2.str());
+}
+
+BOOST_AUTO_TEST_CASE(serialize_write_row)
+{
+    csv_parameters params;
+    params.column_names("id,name,price");
+
+    std::ostringstream os;
+    {
+        csv_serializer serializer(os, params);
+        serializer.write_row({"1", "a \"b\"", "2.5"});
+        std::vector<double> prices = {1.5, -2, 1e20};
+        serializer.write_row(prices.begin(), prices.end());
+        std::vector<int64_t> ids = {-1, 9223372036854775807LL};
+        serializer.write_row(ids.begin(), ids.end());
+        std::vector<std::string> names = {"x", "", "y;z"};
+        serializer.write_row(names.begin(), names.end());
+        serializer.flush();
+    }
+    BOOST_CHECK_EQUAL(std::string("id,name,price\n1,\"a \"\"b\"\"\",2.5\n1.5,-2.0,1.0e+20\n-1,9223372036854775807\nx,,y;z\n"), os.str());
+}
+
 BOOST_AUTO_TEST_CASE(serialize_tab_delimited_file)
 {
     std::string in_file = "input/employees.json";
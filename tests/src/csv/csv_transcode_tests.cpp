@@ -0,0 +1,60 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/csv/csv_transcode.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <sstream>
+#include <vector>
+#include <string>
+
+using namespace jsoncons;
+using namespace jsoncons::csv;
+
+BOOST_AUTO_TEST_SUITE(csv_transcode_tests)
+
+BOOST_AUTO_TEST_CASE(csv_to_cbor_test)
+{
+    const std::string bond_yields = R"(Date,1Y,2Y
+2017-01-09,0.0062,0.0075
+2017-01-08,0.0063,0.0076
+)";
+
+    csv_parameters params;
+    params.assume_header(true)
+          .column_types("string,float,float")
+          .mapping(mapping_type::n_objects);
+
+    std::istringstream is(bond_yields);
+    std::ostringstream os;
+    csv_to_cbor(is, os, params);
+    std::string s = os.str();
+    std::vector<uint8_t> buffer(s.begin(), s.end());
+
+    json_decoder<ojson> decoder;
+    std::istringstream is2(bond_yields);
+    csv_reader reader(is2, decoder, params);
+    reader.read();
+    ojson expected = decoder.get_result();
+
+    BOOST_CHECK(cbor::decode_cbor<ojson>(cbor::cbor_view(buffer)) == expected);
+    BOOST_CHECK_EQUAL(0.0076, cbor::cbor_view(buffer).at(1).at("2Y").as<double>());
+}
+
+BOOST_AUTO_TEST_CASE(csv_to_cbor_source_sink_test)
+{
+    std::istringstream is("a,b\n1,2\n3,4\n");
+    stream_source source(is);
+    std::string out;
+    string_sink sink(out);
+    csv_to_cbor(source, sink);
+    std::vector<uint8_t> buffer(out.begin(), out.end());
+    BOOST_CHECK(cbor::decode_cbor<json>(cbor::cbor_view(buffer)) == json::parse(R"([["a","b"],["1","2"],["3","4"]])"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
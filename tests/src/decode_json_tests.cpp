@@ -0,0 +1,128 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/decode_json.hpp>
+#include <array>
+#include <list>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+using namespace jsoncons;
+
+namespace {
+
+struct point
+{
+    double x;
+    double y;
+
+    point()
+        : x(0), y(0)
+    {
+    }
+};
+
+}
+
+JSONCONS_MEMBER_TRAITS_DECL(point, x, y)
+
+BOOST_AUTO_TEST_SUITE(decode_json_tests)
+
+BOOST_AUTO_TEST_CASE(test_decode_vector)
+{
+    std::vector<double> v = decode_json<std::vector<double>>(std::string("[1,-2,3.5,1e3]"));
+    BOOST_REQUIRE_EQUAL(4, v.size());
+    BOOST_CHECK_EQUAL(1.0, v[0]);
+    BOOST_CHECK_EQUAL(-2.0, v[1]);
+    BOOST_CHECK_EQUAL(3.5, v[2]);
+    BOOST_CHECK_EQUAL(1000.0, v[3]);
+
+    std::vector<bool> b = decode_json<std::vector<bool>>(std::string("[true,false,true]"));
+    BOOST_CHECK(b == std::vector<bool>({true,false,true}));
+
+    std::list<std::string> l = decode_json<std::list<std::string>>(std::string("[\"a\",\"b\"]"));
+    BOOST_CHECK(l == std::list<std::string>({"a","b"}));
+
+    BOOST_CHECK(decode_json<std::vector<int>>(std::string("[]")).empty());
+    BOOST_CHECK_THROW(decode_json<std::vector<int>>(std::string("[1,\"2\"]")), parse_error);
+    BOOST_CHECK_THROW(decode_json<std::vector<int>>(std::string("{}")), parse_error);
+    BOOST_CHECK_THROW(decode_json<std::vector<bool>>(std::string("[[true]]")), parse_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_decode_nested)
+{
+    std::string text = "{\"a\":[[1,2],[3]],\"b\":[],\"c\":[[]]}";
+    auto m = decode_json<std::map<std::string,std::vector<std::vector<int>>>>(text);
+    BOOST_REQUIRE_EQUAL(3, m.size());
+    BOOST_CHECK(m["a"] == std::vector<std::vector<int>>({{1,2},{3}}));
+    BOOST_CHECK(m["b"].empty());
+    BOOST_REQUIRE_EQUAL(1, m["c"].size());
+    BOOST_CHECK(m["c"][0].empty());
+
+    auto points = decode_json<std::vector<point>>(std::string("[{\"x\":1,\"y\":2},{\"y\":4,\"x\":3}]"));
+    BOOST_REQUIRE_EQUAL(2, points.size());
+    BOOST_CHECK_EQUAL(3.0, points[1].x);
+    BOOST_CHECK_EQUAL(4.0, points[1].y);
+
+    std::istringstream is("{\"p\":{\"x\":5,\"y\":6},\"q\":{\"x\":7}}");
+    auto named = decode_json<std::unordered_map<std::string,point>>(is);
+    BOOST_CHECK_EQUAL(6.0, named["p"].y);
+    BOOST_CHECK_EQUAL(7.0, named["q"].x);
+    BOOST_CHECK_EQUAL(0.0, named["q"].y);
+
+    // Other element types go through json_type_traits
+    auto j = decode_json<std::vector<json>>(std::string("[{\"a\":1},null,[2]]"));
+    BOOST_REQUIRE_EQUAL(3, j.size());
+    BOOST_CHECK(j[0] == json::parse("{\"a\":1}"));
+    BOOST_CHECK(j[1].is_null());
+    BOOST_CHECK(j[2] == json::parse("[2]"));
+}
+
+BOOST_AUTO_TEST_CASE(test_decode_array_and_tuple)
+{
+    auto a = decode_json<std::array<int,3>>(std::string("[1,2,3]"));
+    BOOST_CHECK(a == (std::array<int,3>{{1,2,3}}));
+    BOOST_CHECK_THROW((decode_json<std::array<int,3>>(std::string("[1,2]"))), parse_error);
+    BOOST_CHECK_THROW((decode_json<std::array<int,3>>(std::string("[1,2,3,4]"))), parse_error);
+
+    auto t = decode_json<std::tuple<std::string,int,std::vector<double>,point>>(
+        std::string("[\"a\",1,[2.5],{\"x\":1,\"y\":2}]"));
+    BOOST_CHECK_EQUAL(std::string("a"), std::get<0>(t));
+    BOOST_CHECK_EQUAL(1, std::get<1>(t));
+    BOOST_CHECK(std::get<2>(t) == std::vector<double>({2.5}));
+    BOOST_CHECK_EQUAL(2.0, std::get<3>(t).y);
+    BOOST_CHECK_THROW((decode_json<std::tuple<int,int>>(std::string("[1]"))), parse_error);
+    BOOST_CHECK_THROW((decode_json<std::tuple<int,int>>(std::string("[1,\"2\"]"))), parse_error);
+
+    auto pairs = decode_json<std::vector<std::pair<std::string,uint64_t>>>(
+        std::string("[[\"a\",1],[\"b\",18446744073709551615]]"));
+    BOOST_REQUIRE_EQUAL(2, pairs.size());
+    BOOST_CHECK_EQUAL(std::string("b"), pairs[1].first);
+    BOOST_CHECK_EQUAL((std::numeric_limits<uint64_t>::max)(), pairs[1].second);
+}
+
+BOOST_AUTO_TEST_CASE(test_decode_large_array)
+{
+    std::string text = "[";
+    for (size_t i = 0; i < 10000; ++i)
+    {
+        if (i > 0)
+        {
+            text.push_back(',');
+        }
+        text.append(std::to_string(i));
+        text.append(".5");
+    }
+    text.push_back(']');
+    auto v = decode_json<std::vector<double>>(text);
+    BOOST_REQUIRE_EQUAL(10000, v.size());
+    BOOST_CHECK(v == json::parse(text).as<std::vector<double>>());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -12,6 +12,8 @@
 #include <vector>
 #include <utility>
 #include <ctime>
+#include <cstring>
+#include <iomanip>
 
 using namespace jsoncons;
 
@@ -30,6 +32,18 @@ std::basic_string<CharT> float_to_string(double val, uint8_t precision)
     return ss.str();
 }
 
+template<class CharT>
+std::basic_string<CharT> shortest_to_string(double val, uint8_t precision)
+{
+    std::basic_ostringstream<CharT> ss;
+    {
+        buffered_output<CharT> os(ss);
+        print_double<CharT> print(0);
+        print(val, precision, os);
+    }
+    return ss.str();
+}
+
 const serialization_options options;
 
 BOOST_AUTO_TEST_CASE(test_double_to_string)
@@ -173,5 +187,77 @@ BOOST_AUTO_TEST_CASE(test_double_to_wstring)
     s = float_to_string<wchar_t>(x, std::numeric_limits<double>::digits10);
     BOOST_CHECK(s == std::wstring(L"-11.0"));
 }
+
+BOOST_AUTO_TEST_CASE(test_shortest_double_to_string)
+{
+    const uint8_t digits10 = std::numeric_limits<double>::digits10;
+
+    BOOST_CHECK_EQUAL(std::string("0.1"), shortest_to_string<char>(0.1, digits10));
+    BOOST_CHECK_EQUAL(std::string("0.30000000000000004"), shortest_to_string<char>(0.1+0.2, digits10));
+    BOOST_CHECK_EQUAL(std::string("1.1"), shortest_to_string<char>(1.1, 2));
+    BOOST_CHECK_EQUAL(std::string("1.0e+100"), shortest_to_string<char>(1.0e100, digits10));
+    BOOST_CHECK_EQUAL(std::string("-1.0e-100"), shortest_to_string<char>(-1.0e-100, digits10));
+    BOOST_CHECK_EQUAL(std::string("1.23456789e-101"), shortest_to_string<char>(0.123456789e-100, digits10));
+    BOOST_CHECK_EQUAL(std::string("1.234563e-07"), shortest_to_string<char>(0.0000001234563, digits10));
+    BOOST_CHECK_EQUAL(std::string("0.0001234563"), shortest_to_string<char>(0.0001234563, digits10));
+    BOOST_CHECK_EQUAL(std::string("1234563.0"), shortest_to_string<char>(1234563, digits10));
+    BOOST_CHECK_EQUAL(std::string("-10.0"), shortest_to_string<char>(-10, digits10));
+    BOOST_CHECK_EQUAL(std::string("0.0"), shortest_to_string<char>(0, digits10));
+    BOOST_CHECK_EQUAL(std::string("-0.0"), shortest_to_string<char>(-0.0, digits10));
+    BOOST_CHECK_EQUAL(std::string("1.7976931348623157e+308"), shortest_to_string<char>((std::numeric_limits<double>::max)(), digits10));
+    BOOST_CHECK_EQUAL(std::string("2.2250738585072014e-308"), shortest_to_string<char>((std::numeric_limits<double>::min)(), digits10));
+    BOOST_CHECK_EQUAL(std::string("5.0e-324"), shortest_to_string<char>(std::numeric_limits<double>::denorm_min(), digits10));
+    BOOST_CHECK(std::wstring(L"12.5") == shortest_to_string<wchar_t>(12.5, digits10));
+
+    // More digits than a precision that was asked for, rounded as before
+    BOOST_CHECK_EQUAL(float_to_string<char>(1234563, 6), shortest_to_string<char>(1234563, 6));
+    BOOST_CHECK_EQUAL(float_to_string<char>(0.1+0.2, 3), shortest_to_string<char>(0.1+0.2, 3));
+    BOOST_CHECK_EQUAL(std::string("1.1000000000000001"), shortest_to_string<char>(1.1, 17));
+}
+
+BOOST_AUTO_TEST_CASE(test_shortest_double_round_trip)
+{
+    uint64_t state = 88172645463325252ull;
+    for (size_t i = 0; i < 100000; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        double x;
+        std::memcpy(&x, &state, sizeof(x));
+        if (!(std::isfinite)(x))
+        {
+            continue;
+        }
+        std::string s = shortest_to_string<char>(x, std::numeric_limits<double>::digits10);
+        double y = std::strtod(s.c_str(), nullptr);
+        BOOST_CHECK_MESSAGE(x == y, s);
+        BOOST_CHECK(s.length() <= 24);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_shortest_same_as_rounded)
+{
+    // For decimals of fewer than digits10 digits the shortest digits are the rounded digits
+    uint64_t state = 2463534242ull;
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        uint8_t precision = static_cast<uint8_t>(1 + state % (std::numeric_limits<double>::digits10 - 1));
+        int exponent = static_cast<int>((state >> 8) % 80) - 40;
+        double mantissa = static_cast<double>((state >> 16) % 1000000000000000ull);
+
+        std::ostringstream os;
+        os.imbue(std::locale::classic());
+        os << std::setprecision(precision) << mantissa << "e" << exponent;
+        double x = std::strtod(os.str().c_str(), nullptr);
+
+        BOOST_CHECK_EQUAL(float_to_string<char>(x, precision), shortest_to_string<char>(x, precision));
+    }
+}
 BOOST_AUTO_TEST_SUITE_END()
 
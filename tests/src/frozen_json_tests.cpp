@@ -0,0 +1,246 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/frozen_json.hpp>
+#include <jsoncons_ext/jsonpointer/jsonpointer.hpp>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(frozen_json_tests)
+
+BOOST_AUTO_TEST_CASE(test_freeze_scalars)
+{
+    json j = json::parse("[null,true,false,-7,18446744073709551615,1.5,\"a string\",\"\"]");
+    frozen_json f = freeze(j);
+    BOOST_REQUIRE(f.is_array());
+    BOOST_REQUIRE_EQUAL(8, f.size());
+    BOOST_CHECK(f[0].is_null());
+    BOOST_CHECK(f[1].as<bool>());
+    BOOST_CHECK(!f[2].as<bool>());
+    BOOST_CHECK_EQUAL(-7, f[3].as<int>());
+    BOOST_CHECK(f[4].is_uinteger());
+    BOOST_CHECK_EQUAL((std::numeric_limits<uint64_t>::max)(), f[4].as<uint64_t>());
+    BOOST_CHECK_EQUAL(1.5, f[5].as<double>());
+    BOOST_CHECK_EQUAL(std::string("a string"), f[6].as<std::string>());
+    BOOST_CHECK(f[6].as_string_view() == "a string");
+    BOOST_CHECK(f[7].is_string());
+    BOOST_CHECK(f[7].as_string_view().empty());
+    BOOST_CHECK_THROW(f.at(8), std::out_of_range);
+    BOOST_CHECK_THROW(f[6].at(0), std::runtime_error);
+
+    BOOST_CHECK_EQUAL(j.to_string(), f.to_string());
+    BOOST_CHECK(f.as<json>() == j);
+
+    frozen_json n;
+    BOOST_CHECK(n.is_null());
+    BOOST_CHECK_EQUAL(std::string("null"), n.to_string());
+}
+
+BOOST_AUTO_TEST_CASE(test_objects)
+{
+    std::string text = "{\"zeta\":1,\"alpha\":{\"b\":[1,2,{\"c\":\"d\"}],\"a\":{}},\"mid\":[],\"beta\":\"x\"}";
+    frozen_json f = frozen_json::parse(text);
+    BOOST_REQUIRE(f.is_object());
+    BOOST_CHECK_EQUAL(4, f.size());
+    BOOST_CHECK_EQUAL(1, f["zeta"].as<int>());
+    BOOST_CHECK_EQUAL(std::string("x"), f.at("beta").as<std::string>());
+    BOOST_CHECK_EQUAL(std::string("d"), f["alpha"]["b"][2]["c"].as<std::string>());
+    BOOST_CHECK(f["alpha"]["a"].is_object());
+    BOOST_CHECK(f["alpha"]["a"].empty());
+    BOOST_CHECK(f["mid"].is_array());
+    BOOST_CHECK(f.has_key("mid"));
+    BOOST_CHECK(!f.has_key("mi"));
+    BOOST_CHECK(!f.has_key("zz"));
+    BOOST_CHECK_EQUAL(0, f.count("gamma"));
+    BOOST_CHECK_THROW(f.at("gamma"), std::out_of_range);
+    BOOST_CHECK(f.find("gamma") == f.members().end());
+    BOOST_CHECK_EQUAL(std::string("x"), (*f.find("beta")).value().as<std::string>());
+
+    // Members iterate in document order
+    std::vector<std::string> names;
+    for (auto member : f.members())
+    {
+        names.push_back(std::string(member.key().data(), member.key().length()));
+    }
+    BOOST_CHECK(names == std::vector<std::string>({"zeta","alpha","mid","beta"}));
+    BOOST_CHECK_EQUAL(text, f.to_string());
+
+    ojson o = f.as<ojson>();
+    BOOST_CHECK_EQUAL(text, o.to_string());
+    BOOST_CHECK(f.as<json>() == json::parse(text));
+
+    std::istringstream is(text);
+    frozen_json g = frozen_json::parse(is);
+    BOOST_CHECK_EQUAL(text, g.to_string());
+}
+
+BOOST_AUTO_TEST_CASE(test_elements)
+{
+    frozen_json f = freeze(json::parse("[[1,2],{\"a\":3},4,[]]"));
+    std::vector<std::string> items;
+    for (auto e : f.elements())
+    {
+        items.push_back(e.to_string());
+    }
+    BOOST_CHECK(items == std::vector<std::string>({"[1,2]","{\"a\":3}","4","[]"}));
+
+    // Views stay valid as long as a copy of the document does
+    frozen_json_view last;
+    {
+        frozen_json g = frozen_json::parse("[\"abc\",\"def\"]");
+        auto elements = g.elements();
+        auto it = elements.begin();
+        ++it;
+        last = *it;
+        BOOST_CHECK(++it == elements.end());
+        f = g;
+    }
+    BOOST_CHECK_EQUAL(std::string("def"), last.as<std::string>());
+    BOOST_CHECK_EQUAL(std::string("[\"abc\",\"def\"]"), f.to_string());
+
+    frozen_json moved = std::move(f);
+    BOOST_CHECK(f.is_null());
+    BOOST_CHECK_EQUAL(2, moved.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_large_array)
+{
+    json j = json::array();
+    for (int i = 0; i < 1000; ++i)
+    {
+        json item;
+        item["id"] = i;
+        item["name"] = std::string("item ") + std::to_string(i);
+        j.add(std::move(item));
+    }
+    frozen_json f = freeze(j);
+    BOOST_REQUIRE_EQUAL(1000, f.size());
+    BOOST_CHECK_EQUAL(737, f[737]["id"].as<int>());
+    BOOST_CHECK_EQUAL(std::string("item 999"), f[999]["name"].as<std::string>());
+    BOOST_CHECK(f.as<json>() == j);
+}
+
+BOOST_AUTO_TEST_CASE(test_wide_object)
+{
+    // Objects with more than a few members are searched through their sorted table
+    ojson j;
+    for (int i = 40; i > 0; --i)
+    {
+        j[std::string(static_cast<size_t>(i % 7) + 1, 'k') + std::to_string(i)] = i;
+    }
+    frozen_json f = freeze(j);
+    BOOST_REQUIRE_EQUAL(40, f.size());
+    for (const auto& member : j.members())
+    {
+        BOOST_CHECK(f.has_key(member.key()));
+        BOOST_CHECK_EQUAL(member.value().as<int>(), f[member.key()].as<int>());
+    }
+    BOOST_CHECK(!f.has_key("k"));
+    BOOST_CHECK(!f.has_key("kkkkkkkkk"));
+    BOOST_CHECK_EQUAL(j.to_string(), f.to_string());
+}
+
+BOOST_AUTO_TEST_CASE(test_wide_and_byte_strings)
+{
+    wfrozen_json w = wfrozen_json::parse(L"{\"b\":[1,\"two\"],\"a\":null}");
+    BOOST_CHECK(w[L"b"][1].as<std::wstring>() == L"two");
+    BOOST_CHECK(w.to_string() == L"{\"b\":[1,\"two\"],\"a\":null}");
+
+    std::vector<uint8_t> bytes = {'H','e','l','l','o'};
+    json j;
+    j["data"] = json(bytes.data(), bytes.size());
+    frozen_json f = freeze(j);
+    BOOST_REQUIRE(f["data"].is_byte_string());
+    BOOST_CHECK_EQUAL(5, f["data"].byte_string_length());
+    BOOST_CHECK(std::equal(bytes.begin(), bytes.end(), f["data"].byte_string_data()));
+    BOOST_CHECK(f.as<json>() == j);
+}
+
+BOOST_AUTO_TEST_CASE(test_jsonpointer)
+{
+    frozen_json f = frozen_json::parse("{\"a\":{\"b\":[10,20,{\"c~d\":\"e\"}]}}");
+    frozen_json_view result;
+    jsonpointer::jsonpointer_errc ec;
+
+    std::tie(result, ec) = jsonpointer::get(f.view(), "/a/b/1");
+    BOOST_CHECK(ec == jsonpointer::jsonpointer_errc());
+    BOOST_CHECK_EQUAL(20, result.as<int>());
+
+    std::tie(result, ec) = jsonpointer::get(f.view(), "/a/b/2/c~0d");
+    BOOST_CHECK(ec == jsonpointer::jsonpointer_errc());
+    BOOST_CHECK_EQUAL(std::string("e"), result.as<std::string>());
+
+    std::tie(result, ec) = jsonpointer::get(f.view(), "/a/x");
+    BOOST_CHECK(ec == jsonpointer::jsonpointer_errc::name_not_found);
+
+    std::tie(result, ec) = jsonpointer::get(f.view(), "/a/b/3");
+    BOOST_CHECK(ec == jsonpointer::jsonpointer_errc::index_exceeds_array_size);
+}
+
+BOOST_AUTO_TEST_CASE(test_snapshot)
+{
+    std::string text = "{\"zeta\":[1,-2,3.5,true,null],\"alpha\":{\"name\":\"a string that is not short\",\"n\":18446744073709551615},\"mid\":\"\"}";
+    frozen_json f = frozen_json::parse(text);
+
+    std::stringstream ss;
+    f.save(ss);
+    frozen_json loaded = frozen_json::load(ss);
+    BOOST_CHECK_EQUAL(text, loaded.to_string());
+    BOOST_CHECK_EQUAL(std::string("a string that is not short"), loaded["alpha"]["name"].as<std::string>());
+
+    const std::string filename = "./output/frozen_json_snapshot.bin";
+    {
+        std::ofstream os(filename, std::ios::binary);
+        f.save(os);
+    }
+    {
+        frozen_json mapped = frozen_json::map(filename);
+        BOOST_CHECK_EQUAL(text, mapped.to_string());
+        BOOST_CHECK(mapped["zeta"][2].as<double>() == 3.5);
+        BOOST_CHECK_EQUAL((std::numeric_limits<uint64_t>::max)(), mapped["alpha"]["n"].as<uint64_t>());
+
+        // Mutable copies are built from the tape, in either order
+        BOOST_CHECK(mapped.as<json>() == json::parse(text));
+        BOOST_CHECK_EQUAL(text, mapped.as<ojson>().to_string());
+
+        frozen_json copy = mapped;
+        frozen_json_view view = copy["alpha"];
+        mapped = frozen_json();
+        BOOST_CHECK_EQUAL(2, view.size());
+    }
+    std::remove(filename.c_str());
+
+    std::stringstream empty;
+    frozen_json().save(empty);
+    BOOST_CHECK(frozen_json::load(empty).is_null());
+}
+
+BOOST_AUTO_TEST_CASE(test_snapshot_errors)
+{
+    std::stringstream ss;
+    frozen_json::parse("[1,2,3]").save(ss);
+    std::string image = ss.str();
+
+    std::istringstream truncated(image.substr(0, image.size() - 8));
+    BOOST_CHECK_THROW(frozen_json::load(truncated), std::runtime_error);
+
+    std::string corrupt = image;
+    corrupt[0] = 'x';
+    std::istringstream not_snapshot(corrupt);
+    BOOST_CHECK_THROW(frozen_json::load(not_snapshot), std::runtime_error);
+
+    // A snapshot of a char document isn't a wchar_t one
+    std::istringstream narrow(image);
+    BOOST_CHECK_THROW(wfrozen_json::load(narrow), std::runtime_error);
+
+    BOOST_CHECK_THROW(frozen_json::map("./output/no_such_snapshot.bin"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
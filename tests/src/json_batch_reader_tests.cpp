@@ -0,0 +1,164 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_batch_reader.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/json_filter.hpp>
+#include <jsoncons/json_reader.hpp>
+#include <jsoncons/json_serializer.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/cbor/cbor_serializer.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(json_batch_reader_tests)
+
+// Strings that span buffers, strings with escapes, and numbers of each kind
+std::string make_text()
+{
+    std::string s = "{\"values\":[";
+    for (size_t i = 0; i < 500; ++i)
+    {
+        if (i > 0)
+        {
+            s.push_back(',');
+        }
+        s += "{\"id\":" + std::to_string(i) + ",\"name\":\"item " + std::to_string(i) +
+             "\",\"ratio\":" + std::to_string(i) + ".25,\"big\":18446744073709551615,\"neg\":-" + std::to_string(i) +
+             ",\"flag\":" + (i % 2 == 0 ? "true" : "false") + ",\"none\":null,\"escaped\":\"a\\tb\\u00e9\"}";
+    }
+    s += "],\"long\":\"" + std::string(1000, 'x') + "\"}";
+    return s;
+}
+
+BOOST_AUTO_TEST_CASE(test_decoder)
+{
+    std::string text = make_text();
+    json expected = json::parse(text);
+
+    for (size_t length : {16, 100, 16384})
+    {
+        std::istringstream is(text);
+        json_decoder<json> decoder;
+        json_batch_reader reader(is, decoder);
+        reader.buffer_length(length);
+        reader.read();
+        BOOST_REQUIRE(decoder.is_valid());
+        BOOST_CHECK_EQUAL(expected, decoder.get_result());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_serializer)
+{
+    std::string text = make_text();
+    std::ostringstream expected;
+    {
+        std::istringstream is(text);
+        json_serializer serializer(expected);
+        basic_json_input_output_handler_adapter<char> adapter(serializer);
+        json_reader reader(is, adapter);
+        reader.read();
+    }
+
+    std::ostringstream os;
+    std::istringstream is(text);
+    json_serializer serializer(os);
+    basic_json_input_output_handler_adapter<char> adapter(serializer);
+    json_batch_reader reader(is, adapter);
+    reader.buffer_length(100);
+    reader.read();
+    BOOST_CHECK_EQUAL(expected.str(), os.str());
+}
+
+BOOST_AUTO_TEST_CASE(test_cbor_serializer)
+{
+    std::string text = make_text();
+    std::ostringstream os;
+    std::istringstream is(text);
+    cbor::cbor_serializer serializer(os);
+    basic_json_input_output_handler_adapter<char> adapter(serializer);
+    json_batch_reader reader(is, adapter);
+    reader.read();
+
+    std::string s = os.str();
+    std::vector<uint8_t> buffer(s.begin(), s.end());
+    BOOST_CHECK_EQUAL(json::parse(text), cbor::decode_cbor<json>(cbor::cbor_view(buffer)));
+}
+
+class upper_case_names : public json_filter
+{
+public:
+    upper_case_names(json_input_handler& handler)
+        : json_filter(handler)
+    {
+    }
+private:
+    void do_name(const string_view_type& name, const parsing_context& context) override
+    {
+        std::string s(name.data(), name.length());
+        for (auto& c : s)
+        {
+            c = static_cast<char>(toupper(c));
+        }
+        this->downstream_handler().name(s, context);
+    }
+};
+
+BOOST_AUTO_TEST_CASE(test_filter_replays_events)
+{
+    // A handler without do_events is given the events one by one
+    std::istringstream is(R"({"a":1,"b":{"c":[true,"d"]}})");
+    json_decoder<json> decoder;
+    upper_case_names filter(decoder);
+    json_batch_reader reader(is, filter);
+    reader.read();
+    BOOST_CHECK_EQUAL(json::parse(R"({"A":1,"B":{"C":[true,"d"]}})"), decoder.get_result());
+}
+
+BOOST_AUTO_TEST_CASE(test_tape)
+{
+    std::string text = R"(["in source","with \"escape\"",1.5,-2,null])";
+    json_event_tape tape;
+    tape.source(text.data(), text.length());
+    basic_json_parser<char,json_event_tape> parser(tape);
+    parser.set_source(text.data(), text.length());
+    parser.parse();
+    parser.end_parse();
+
+    BOOST_REQUIRE_EQUAL(9, tape.size());
+    BOOST_CHECK(tape.kind(0) == tape_event_kind::begin_json);
+    BOOST_CHECK(tape.kind(1) == tape_event_kind::begin_array);
+    BOOST_CHECK(tape.kind(2) == tape_event_kind::string_value);
+    BOOST_CHECK(tape.text(2) == "in source");
+    BOOST_CHECK(tape.text(2).data() >= text.data() && tape.text(2).data() < text.data() + text.length());
+    BOOST_CHECK(tape.text(3) == "with \"escape\"");
+    BOOST_CHECK(tape.kind(4) == tape_event_kind::double_value);
+    BOOST_CHECK_EQUAL(1.5, tape.floating_point(4));
+    BOOST_CHECK_EQUAL(-2, tape.integer(5));
+    BOOST_CHECK(tape.kind(6) == tape_event_kind::null_value);
+    BOOST_CHECK(tape.kind(8) == tape_event_kind::end_json);
+
+    json_decoder<json> decoder;
+    decoder.events(tape);
+    BOOST_CHECK_EQUAL(json::parse(text), decoder.get_result());
+
+    tape.clear();
+    BOOST_CHECK(tape.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_error)
+{
+    std::istringstream is(R"({"a":[1,2})");
+    json_decoder<json> decoder;
+    json_batch_reader reader(is, decoder);
+    std::error_code ec;
+    reader.read(ec);
+    BOOST_CHECK(ec == json_parser_errc::expected_comma_or_right_bracket);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,188 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/json_cursor.hpp>
+
+using namespace jsoncons;
+
+namespace {
+
+// Writes the events of a cursor, one per line
+std::string events_of(json_cursor& cursor)
+{
+    std::ostringstream os;
+    for (; !cursor.done(); cursor.next())
+    {
+        const auto& event = cursor.current();
+        switch (event.event_type())
+        {
+            case json_event_type::begin_object: os << "{\n"; break;
+            case json_event_type::end_object: os << "}\n"; break;
+            case json_event_type::begin_array: os << "[\n"; break;
+            case json_event_type::end_array: os << "]\n"; break;
+            case json_event_type::name: os << "name " << event.as_string() << "\n"; break;
+            case json_event_type::string_value: os << "string " << event.as_string() << "\n"; break;
+            case json_event_type::int64_value: os << "int64 " << event.as_integer() << "\n"; break;
+            case json_event_type::uint64_value: os << "uint64 " << event.as_uinteger() << "\n"; break;
+            case json_event_type::double_value: os << "double " << event.as_double() << "\n"; break;
+            case json_event_type::bool_value: os << "bool " << event.as_bool() << "\n"; break;
+            case json_event_type::null_value: os << "null\n"; break;
+        }
+    }
+    return os.str();
+}
+
+const std::string text = "\xEF\xBB\xBF{\"books\":[{\"title\":\"Pulp \\\"Fiction\\\"\",\"price\":9.5,\"count\":-3},\n"
+                         "{\"title\":\"Hamlet\",\"tags\":[[1],[2,[3]]],\"count\":18446744073709551615}],\"ok\":true,\"none\":null}";
+
+const std::string expected = "{\nname books\n[\n{\nname title\nstring Pulp \"Fiction\"\nname price\ndouble 9.5\nname count\nint64 -3\n}\n"
+                             "{\nname title\nstring Hamlet\nname tags\n[\n[\nuint64 1\n]\n[\nuint64 2\n[\nuint64 3\n]\n]\n]\n"
+                             "name count\nuint64 18446744073709551615\n}\n]\nname ok\nbool 1\nname none\nnull\n}\n";
+
+}
+
+BOOST_AUTO_TEST_SUITE(json_cursor_tests)
+
+BOOST_AUTO_TEST_CASE(test_cursor_events)
+{
+    json_cursor cursor(text);
+    BOOST_CHECK_EQUAL(expected, events_of(cursor));
+    cursor.check_done();
+
+    // The same events with the text read a few characters at a time
+    for (size_t length = 1; length <= 8; ++length)
+    {
+        std::istringstream is(text);
+        json_cursor cursor2(is);
+        cursor2.buffer_length(length);
+        BOOST_CHECK_EQUAL(expected, events_of(cursor2));
+        cursor2.check_done();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_cursor_scalars)
+{
+    json_cursor cursor1("  42  ");
+    BOOST_REQUIRE(!cursor1.done());
+    BOOST_CHECK(cursor1.current().event_type() == json_event_type::uint64_value);
+    BOOST_CHECK_EQUAL(42.0, cursor1.current().as_double());
+    cursor1.next();
+    BOOST_CHECK(cursor1.done());
+
+    std::istringstream is("\"a string\"");
+    json_cursor cursor2(is);
+    BOOST_CHECK_EQUAL(std::string("a string"), cursor2.current().as_string());
+    BOOST_CHECK_THROW(cursor2.current().as_integer(), std::runtime_error);
+    cursor2.next();
+    BOOST_CHECK(cursor2.done());
+}
+
+BOOST_AUTO_TEST_CASE(test_cursor_skip)
+{
+    std::istringstream is(text);
+    json_cursor cursor(is);
+    cursor.buffer_length(5);
+
+    std::vector<std::string> titles;
+    bool ok = false;
+    for (; !cursor.done(); cursor.next())
+    {
+        const auto& event = cursor.current();
+        if (event.event_type() == json_event_type::name)
+        {
+            if (event.as_string_view() == "title")
+            {
+                cursor.next();
+                titles.push_back(cursor.current().as_string());
+            }
+            else if (event.as_string_view() == "ok")
+            {
+                cursor.next();
+                ok = cursor.current().as_bool();
+            }
+            else if (event.as_string_view() != "books")
+            {
+                cursor.skip();
+            }
+        }
+    }
+    BOOST_REQUIRE_EQUAL(2, titles.size());
+    BOOST_CHECK_EQUAL(std::string("Pulp \"Fiction\""), titles[0]);
+    BOOST_CHECK_EQUAL(std::string("Hamlet"), titles[1]);
+    BOOST_CHECK(ok);
+
+    // Skipping an array leaves the cursor at its end
+    json_cursor cursor2("[[1,{\"a\":[2]}],3]");
+    cursor2.next();
+    BOOST_CHECK(cursor2.current().event_type() == json_event_type::begin_array);
+    cursor2.skip();
+    BOOST_CHECK(cursor2.current().event_type() == json_event_type::end_array);
+    cursor2.next();
+    BOOST_CHECK_EQUAL(3, cursor2.current().as_integer());
+    cursor2.next();
+    BOOST_CHECK(cursor2.current().event_type() == json_event_type::end_array);
+    cursor2.next();
+    BOOST_CHECK(cursor2.done());
+}
+
+BOOST_AUTO_TEST_CASE(test_cursor_read_to)
+{
+    std::istringstream is(text);
+    json_cursor cursor(is);
+    cursor.buffer_length(7);
+
+    // Read the books one at a time
+    std::vector<json> books;
+    cursor.next();
+    cursor.next();
+    BOOST_REQUIRE(cursor.current().event_type() == json_event_type::begin_array);
+    for (cursor.next(); cursor.current().event_type() != json_event_type::end_array; cursor.next())
+    {
+        json_decoder<json> decoder;
+        cursor.read_to(decoder);
+        books.push_back(decoder.get_result());
+    }
+    BOOST_REQUIRE_EQUAL(2, books.size());
+    BOOST_CHECK_EQUAL(json::parse(text)["books"][0], books[0]);
+    BOOST_CHECK_EQUAL(json::parse(text)["books"][1], books[1]);
+    BOOST_CHECK_EQUAL(std::string("9.5"), books[0]["price"].to_string());
+
+    cursor.next();
+    BOOST_CHECK_EQUAL(std::string("ok"), cursor.current().as_string());
+    cursor.next();
+    json_decoder<json> decoder;
+    cursor.read_to(decoder);
+    BOOST_CHECK(decoder.get_result().as<bool>());
+}
+
+BOOST_AUTO_TEST_CASE(test_cursor_errors)
+{
+    json_cursor cursor("[1,2,");
+    cursor.next();
+    cursor.next();
+    BOOST_CHECK_EQUAL(2, cursor.current().as_integer());
+    std::error_code ec;
+    cursor.next(ec);
+    BOOST_CHECK(ec == json_parser_errc::unexpected_eof);
+
+    BOOST_CHECK_THROW({json_cursor cursor1("[1,]"); while (!cursor1.done()) cursor1.next();}, parse_error);
+
+    json_cursor cursor2("{\"a\":[1,2");
+    cursor2.next();
+    json_decoder<json> decoder;
+    std::error_code ec2;
+    cursor2.read_to(decoder, ec2);
+    BOOST_CHECK(ec2 == json_parser_errc::unexpected_eof);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,123 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/json_parser.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/msgpack/msgpack.hpp>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(json_decoder_borrow_tests)
+
+static json decode_borrowed(const std::string& s)
+{
+    json_decoder<json> decoder;
+    decoder.borrow_strings(s.data(), s.length());
+    BOOST_CHECK(decoder.borrow_strings());
+    json_parser parser(decoder);
+    parser.set_source(s.data(), s.length());
+    parser.parse();
+    parser.end_parse();
+    parser.check_done();
+    return decoder.get_result();
+}
+
+BOOST_AUTO_TEST_CASE(test_borrowed_strings)
+{
+    std::string text = "{\"a long member name, always copied\":\"a long string without escapes\","
+                       "\"short\":\"abc\",\"escaped\":\"a long string with an \\\"escape\\\"\","
+                       "\"items\":[\"another long string in an array\",1,true]}";
+    json j = decode_borrowed(text);
+    BOOST_CHECK(j == json::parse(text));
+
+    const json& borrowed = j["a long member name, always copied"];
+    BOOST_CHECK(borrowed.is_string());
+    BOOST_CHECK(borrowed.is_string_view());
+    BOOST_CHECK(borrowed.as_string_view().data() >= text.data());
+    BOOST_CHECK(borrowed.as_string_view().data() < text.data() + text.length());
+    BOOST_CHECK_EQUAL(std::string("a long string without escapes"), borrowed.as<std::string>());
+    BOOST_CHECK(j["items"][0].is_string_view());
+
+    BOOST_CHECK(j["short"].is_string());
+    BOOST_CHECK(!j["short"].is_string_view());
+    BOOST_CHECK(j["escaped"].is_string());
+    BOOST_CHECK(!j["escaped"].is_string_view());
+    BOOST_CHECK_EQUAL(std::string("a long string with an \"escape\""), j["escaped"].as<std::string>());
+
+    std::ostringstream os;
+    os << j;
+    BOOST_CHECK(json::parse(os.str()) == j);
+
+    std::vector<uint8_t> cbor;
+    cbor::encode_cbor(j, cbor);
+    BOOST_CHECK(cbor::decode_cbor<json>(cbor) == j);
+    std::vector<uint8_t> msgpack;
+    msgpack::encode_msgpack(j, msgpack);
+    BOOST_CHECK(msgpack::decode_msgpack<json>(msgpack) == j);
+}
+
+BOOST_AUTO_TEST_CASE(test_string_view_copy_and_swap)
+{
+    std::string s = "a string that is not owned by the value";
+    json view = json::make_string_view(s);
+    BOOST_CHECK(view.is_string_view());
+    BOOST_CHECK(view == json(s));
+    BOOST_CHECK(json(s) == view);
+    BOOST_CHECK_THROW(view.as_cstring(), std::exception);
+
+    json copy(view);
+    BOOST_CHECK(copy.is_string_view());
+    BOOST_CHECK_EQUAL(s.data(), copy.as_string_view().data());
+
+    json moved(std::move(copy));
+    BOOST_CHECK(moved.is_string_view());
+    BOOST_CHECK(moved == view);
+
+    json other = json::parse("[1,\"an owned string that is long enough\",{\"a\":2}]");
+    json expected = other;
+    view.swap(other);
+    BOOST_CHECK(other.is_string_view());
+    BOOST_CHECK(view == expected);
+    other.swap(view);
+    BOOST_CHECK(view.is_string_view());
+    BOOST_CHECK(other == expected);
+
+    json a = json::make_string_view(s);
+    json b = json::make_string_view("another view, of a string literal");
+    a.swap(b);
+    BOOST_CHECK_EQUAL(std::string("another view, of a string literal"), a.as<std::string>());
+    BOOST_CHECK_EQUAL(s, b.as<std::string>());
+
+    other = view;
+    BOOST_CHECK(other.is_string_view());
+    json arr = json::array();
+    arr.add(view);
+    arr.add(std::move(other));
+    BOOST_CHECK_EQUAL(2, arr.size());
+    BOOST_CHECK(arr[0] == arr[1]);
+}
+
+BOOST_AUTO_TEST_CASE(test_borrowing_off)
+{
+    std::string text = "[\"a long string without escapes\"]";
+    json_decoder<json> decoder;
+    decoder.borrow_strings(text.data(), text.length());
+    decoder.borrow_strings(nullptr, 0);
+    BOOST_CHECK(!decoder.borrow_strings());
+    json_parser parser(decoder);
+    parser.set_source(text.data(), text.length());
+    parser.parse();
+    parser.end_parse();
+    parser.check_done();
+    json j = decoder.get_result();
+    BOOST_CHECK(!j[0].is_string_view());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
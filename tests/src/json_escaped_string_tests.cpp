@@ -0,0 +1,191 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/json_parser.hpp>
+#include <jsoncons/json_serializer.hpp>
+#include <jsoncons/json_filter.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(json_escaped_string_tests)
+
+static const std::string text = "{\"path\":\"C:\\\\Program Files\\\\jsoncons\\\\include\\\\json.hpp\","
+                                "\"doc\":\"{\\\"a\\\":[1,2,3],\\\"b\\\":\\\"\\\\u00e9t\\\\u00e9\\\"}\","
+                                "\"short\":\"a\\tb\",\"plain\":\"no escapes at all in this one\","
+                                "\"emoji\":\"\\ud83d\\ude00 and \\u00e9 and \\u20ac and \\/ here\",\"na\\u006de\":\"v\"}";
+
+static json parse_keeping_escapes(const std::string& s)
+{
+    json_decoder<json> decoder;
+    json_parser parser(decoder);
+    parser.keep_escaped_strings(true);
+    BOOST_CHECK(parser.keep_escaped_strings());
+    parser.set_source(s.data(), s.length());
+    std::error_code ec;
+    BOOST_REQUIRE(parser.parse_indexed(ec));
+    BOOST_REQUIRE(!ec);
+    parser.end_parse();
+    parser.check_done();
+    return decoder.get_result();
+}
+
+BOOST_AUTO_TEST_CASE(test_escaped_string_written_verbatim)
+{
+    json j = parse_keeping_escapes(text);
+    BOOST_CHECK(j["path"].type_id() == json_type_tag::escaped_string_t);
+    BOOST_CHECK(j["short"].type_id() == json_type_tag::small_string_t);
+    BOOST_CHECK(j["plain"].type_id() == json_type_tag::string_t);
+    BOOST_CHECK(j.has_key("name"));
+
+    std::string expected = "{\"doc\":\"{\\\"a\\\":[1,2,3],\\\"b\\\":\\\"\\\\u00e9t\\\\u00e9\\\"}\","
+                           "\"emoji\":\"\\ud83d\\ude00 and \\u00e9 and \\u20ac and \\/ here\",\"name\":\"v\","
+                           "\"path\":\"C:\\\\Program Files\\\\jsoncons\\\\include\\\\json.hpp\","
+                           "\"plain\":\"no escapes at all in this one\",\"short\":\"a\\tb\"}";
+    BOOST_CHECK_EQUAL(expected, j.to_string());
+    BOOST_CHECK(j["path"].type_id() == json_type_tag::escaped_string_t);
+
+    // Options that ask for escapes the text may not have write the unescaped string
+    serialization_options options;
+    options.escape_all_non_ascii(true);
+    BOOST_CHECK_EQUAL(json::parse(text).to_string(options), j.to_string(options));
+}
+
+BOOST_AUTO_TEST_CASE(test_escaped_string_unescaped_on_access)
+{
+    json j = parse_keeping_escapes(text);
+    json expected = json::parse(text);
+
+    BOOST_CHECK(j["path"].is_string());
+    BOOST_CHECK(j == expected);
+    BOOST_CHECK(expected == j);
+    BOOST_CHECK(!j["doc"].empty());
+
+    BOOST_CHECK_EQUAL(std::string("C:\\Program Files\\jsoncons\\include\\json.hpp"), j["path"].as<std::string>());
+    BOOST_CHECK(j["path"].type_id() == json_type_tag::string_t);
+    BOOST_CHECK(j["emoji"].as_string_view() == expected["emoji"].as_string_view());
+
+    json doc = json::parse(j["doc"].as<std::string>());
+    BOOST_CHECK_EQUAL(std::string("\xC3\xA9t\xC3\xA9"), doc["b"].as<std::string>());
+}
+
+BOOST_AUTO_TEST_CASE(test_escaped_string_copy_swap_and_cbor)
+{
+    json j = parse_keeping_escapes(text);
+
+    json copy = j;
+    BOOST_CHECK(copy["path"].type_id() == json_type_tag::escaped_string_t);
+
+    json a = copy["path"];
+    json b = json(1);
+    a.swap(b);
+    BOOST_CHECK(b.type_id() == json_type_tag::escaped_string_t);
+    BOOST_CHECK(a == json(1));
+    BOOST_CHECK_EQUAL(std::string("C:\\Program Files\\jsoncons\\include\\json.hpp"), b.as<std::string>());
+    BOOST_CHECK(copy == j);
+
+    std::vector<uint8_t> encoded;
+    cbor::encode_cbor(j, encoded);
+    std::vector<uint8_t> expected_encoded;
+    cbor::encode_cbor(json::parse(text), expected_encoded);
+    BOOST_CHECK(encoded == expected_encoded);
+}
+
+BOOST_AUTO_TEST_CASE(test_escaped_string_errors)
+{
+    for (std::string s : {"[\"ab\\qcdefghijklmnopqrstuvwxyz\"]", "[\"\\ud83d abcdefghijklmnopqrstuvwxyz\"]",
+                          "[\"\\u12G4abcdefghijklmnopqrstuvwxyz\"]"})
+    {
+        json_decoder<json> decoder;
+        json_parser parser(decoder);
+        parser.keep_escaped_strings(true);
+        parser.set_source(s.data(), s.length());
+        std::error_code ec;
+        parser.parse_indexed(ec);
+        BOOST_CHECK(ec);
+    }
+
+    // The limit is on the length of the unescaped string
+    std::string s = "[\"\\u00e9\\u00e9\\u00e9\\u00e9\\u00e9\\u00e9\\u00e9\\u00e9\\u00e9\\u00e9\"]";
+    json_decoder<json> decoder;
+    json_parser parser(decoder);
+    parser.keep_escaped_strings(true);
+    parser.max_string_length(20);
+    parser.set_source(s.data(), s.length());
+    std::error_code ec;
+    BOOST_CHECK(parser.parse_indexed(ec));
+    BOOST_CHECK(!ec);
+    BOOST_CHECK_EQUAL(20u, decoder.get_result()[0].as_string_view().length());
+}
+
+struct string_collector
+{
+    typedef char char_type;
+    typedef json_input_handler::string_view_type string_view_type;
+
+    std::vector<std::string> strings;
+
+    void begin_json() {}
+    void end_json() {}
+    void begin_object(const parsing_context&) {}
+    void end_object(const parsing_context&) {}
+    void begin_array(const parsing_context&) {}
+    void end_array(const parsing_context&) {}
+    void name(const string_view_type&, const parsing_context&) {}
+    void string_value(const string_view_type& s, const parsing_context&)
+    {
+        strings.emplace_back(s.data(), s.length());
+    }
+    void byte_string_value(const uint8_t*, size_t, const parsing_context&) {}
+    void integer_value(int64_t, const parsing_context&) {}
+    void uinteger_value(uint64_t, const parsing_context&) {}
+    void double_value(double, uint8_t, const parsing_context&) {}
+    void bool_value(bool, const parsing_context&) {}
+    void null_value(const parsing_context&) {}
+};
+
+BOOST_AUTO_TEST_CASE(test_escaped_string_to_handler_without_escaped_string_value)
+{
+    std::string s = "[\"a\\nb\",\"plain\"]";
+    string_collector collector;
+    basic_json_parser<char,string_collector> parser(collector);
+    parser.keep_escaped_strings(true);
+    parser.set_source(s.data(), s.length());
+    std::error_code ec;
+    BOOST_CHECK(parser.parse_indexed(ec));
+    BOOST_CHECK(!ec);
+    BOOST_REQUIRE_EQUAL(2, collector.strings.size());
+    BOOST_CHECK_EQUAL(std::string("a\nb"), collector.strings[0]);
+    BOOST_CHECK_EQUAL(std::string("plain"), collector.strings[1]);
+}
+
+BOOST_AUTO_TEST_CASE(test_escaped_string_through_serializer)
+{
+    std::string s = "[\"a \\\"quoted\\\" string, long enough to be kept\",\"\\u00e9\"]";
+    std::ostringstream os;
+    json_serializer serializer(os);
+    basic_json_input_output_handler_adapter<char> adapter(serializer);
+    json_parser parser(adapter);
+    parser.keep_escaped_strings(true);
+    parser.set_source(s.data(), s.length());
+    std::error_code ec;
+    BOOST_CHECK(parser.parse_indexed(ec));
+    BOOST_CHECK(!ec);
+    parser.end_parse();
+    BOOST_CHECK_EQUAL(s, os.str());
+}
+
+BOOST_AUTO_TEST_CASE(test_escaped_strings_off_by_default)
+{
+    json j = json::parse(text);
+    BOOST_CHECK(j["path"].type_id() == json_type_tag::string_t);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -11,6 +11,7 @@
 #include <utility>
 #include <ctime>
 #include <new>
+#include <algorithm>
 #include <jsoncons/json_serializer.hpp>
 #include <jsoncons/json_filter.hpp>
 #include <jsoncons/json_reader.hpp>
@@ -171,4 +172,98 @@ BOOST_AUTO_TEST_CASE(test_chained_filters)
     BOOST_CHECK(j2["fourth"] == 4);
 }
 
+// Passes on the top level members with the given names, and the parser skips the rest
+class select_members_filter : public json_filter
+{
+    std::vector<std::string> names_;
+    size_t depth_;
+public:
+    select_members_filter(const std::vector<std::string>& names, json_input_handler& handler)
+        : json_filter(handler), names_(names), depth_(0)
+    {
+    }
+
+private:
+    void do_begin_object(const parsing_context& context) override
+    {
+        ++depth_;
+        this->downstream_handler().begin_object(context);
+    }
+
+    void do_end_object(const parsing_context& context) override
+    {
+        --depth_;
+        this->downstream_handler().end_object(context);
+    }
+
+    void do_begin_array(const parsing_context& context) override
+    {
+        this->downstream_handler().begin_array(context);
+        if (depth_ == 1)
+        {
+            // Arrays at the top level keep only their brackets
+            context.skip_value();
+        }
+    }
+
+    void do_name(const string_view_type& name, const parsing_context& context) override
+    {
+        if (depth_ == 1 && std::find(names_.begin(), names_.end(), std::string(name.data(), name.length())) == names_.end())
+        {
+            context.skip_value();
+        }
+        else
+        {
+            this->downstream_handler().name(name, context);
+        }
+    }
+};
+
+BOOST_AUTO_TEST_CASE(test_skip_value)
+{
+    const std::string s = "{\"a\":{\"x\":[1,2,{\"y\":\"}],\\\"\"}]},\n\"b\":\"keep\",\n\"c\":[1,\n 2,\"[\"],\n\"d\":12345678901234567890123e-4,\n\"e\":{\"f\":true},\n\"g\":[]}";
+    const json expected = json::parse("{\"b\":\"keep\",\"c\":[],\"e\":{\"f\":true}}");
+
+    {
+        json_decoder<json> decoder;
+        select_members_filter filter({"b","c","e"}, decoder);
+        json_parser parser(filter);
+        parser.set_source(s.data(), s.length());
+        BOOST_CHECK(parser.parse_indexed());
+        parser.check_done();
+        BOOST_CHECK_EQUAL(expected, decoder.get_result());
+    }
+
+    // Through a small buffer, skipping across reads
+    for (size_t length = 1; length < 20; length += 3)
+    {
+        std::istringstream is(s);
+        json_decoder<json> decoder;
+        select_members_filter filter({"b","c","e"}, decoder);
+        json_reader reader(is, filter);
+        reader.buffer_length(length);
+        reader.read();
+        BOOST_CHECK_EQUAL(expected, decoder.get_result());
+    }
+
+    // Errors after a skipped value have the right line number
+    std::istringstream is("{\"a\":[1,\n2,\n3],\n\"b\":x}");
+    json_decoder<json> decoder;
+    select_members_filter filter({"b"}, decoder);
+    json_reader reader(is, filter);
+    std::error_code ec;
+    reader.read(ec);
+    BOOST_CHECK(ec == json_parser_errc::expected_value);
+    BOOST_CHECK_EQUAL(4, reader.line_number());
+
+    // An unterminated skipped value is still an error
+    std::istringstream truncated("{\"a\":[1,2");
+    json_decoder<json> decoder2;
+    select_members_filter filter2({"b"}, decoder2);
+    json_reader reader2(truncated, filter2);
+    std::error_code ec2;
+    reader2.read(ec2);
+    BOOST_CHECK(ec2 == json_parser_errc::unexpected_eof);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,115 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_hash.hpp>
+#include <vector>
+#include <utility>
+#include <unordered_set>
+#include <unordered_map>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(json_hash_tests)
+
+// Values that are equal have equal hashes
+BOOST_AUTO_TEST_CASE(test_equal_values)
+{
+    json_hash_cache<json> jh;
+    BOOST_CHECK_EQUAL(jh.hash(json(1)), jh.hash(json(1.0)));
+    BOOST_CHECK_EQUAL(jh.hash(json(1)), jh.hash(json(uint64_t(1))));
+    BOOST_CHECK_EQUAL(jh.hash(json(0.0)), jh.hash(json(-0.0)));
+    BOOST_CHECK_EQUAL(jh.hash(json::object()), jh.hash(json::parse("{}")));
+
+    json a = json::parse(R"({"a":[1,2,{"x":"y"}],"b":null,"c":true})");
+    json b = json::parse(R"({"c":true,"b":null,"a":[1.0,2,{"x":"y"}]})");
+    BOOST_CHECK_EQUAL(jh.hash(a), jh.hash(b));
+    BOOST_CHECK(jh.equal(a, b));
+
+    json_hash_cache<ojson> ojh;
+    ojson oa = ojson::parse(R"({"a":1,"b":[2,3]})");
+    ojson ob = ojson::parse(R"({"b":[2,3],"a":1})");
+    BOOST_CHECK_EQUAL(ojh.hash(oa), ojh.hash(ob));
+    BOOST_CHECK(ojh.equal(oa, ob));
+}
+
+BOOST_AUTO_TEST_CASE(test_different_values)
+{
+    json_hash_cache<json> jh;
+    std::vector<json> values = {json::parse("null"), json(true), json(false), json(1), json(2.5), json("1"), json(""),
+                                json::parse("[]"), json::parse("{}"), json::parse("[1,2]"), json::parse("[2,1]"),
+                                json::parse(R"({"a":1})"), json::parse(R"({"a":2})"), json::parse(R"({"b":1})"),
+                                json::parse(R"([[1],2])"), json::parse(R"([1,[2]])")};
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        for (size_t j = 0; j < values.size(); ++j)
+        {
+            BOOST_CHECK_EQUAL(i == j, jh.equal(values[i], values[j]));
+            if (i != j)
+            {
+                BOOST_CHECK(jh.hash(values[i]) != jh.hash(values[j]));
+            }
+        }
+    }
+}
+
+// std::hash is the hash of the cache, computed afresh
+BOOST_AUTO_TEST_CASE(test_std_hash)
+{
+    json a = json::parse(R"({"a":[1,2,{"x":"y"}],"b":null,"c":true})");
+    json b = json::parse(R"({"c":true,"b":null,"a":[1.0,2,{"x":"y"}]})");
+
+    json_hash_cache<json> jh;
+    BOOST_CHECK_EQUAL(jh.hash(a), std::hash<json>()(a));
+    BOOST_CHECK_EQUAL(std::hash<json>()(a), std::hash<json>()(b));
+    BOOST_CHECK_EQUAL(std::hash<json>()(json(1)), std::hash<json>()(json(1.0)));
+
+    ojson oa = ojson::parse(R"({"a":1,"b":[2,3]})");
+    ojson ob = ojson::parse(R"({"b":[2,3],"a":1})");
+    BOOST_CHECK_EQUAL(std::hash<ojson>()(oa), std::hash<ojson>()(ob));
+    BOOST_CHECK_EQUAL(json_hash<ojson>()(oa), std::hash<ojson>()(oa));
+
+    // Modifying a value changes its hash
+    size_t before = std::hash<json>()(a);
+    a["a"][2]["x"] = "z";
+    BOOST_CHECK(std::hash<json>()(a) != before);
+}
+
+BOOST_AUTO_TEST_CASE(test_unordered_containers)
+{
+    json records = json::parse(R"([{"id":1,"tags":["a","b"]},{"id":2},{"tags":["a","b"],"id":1.0},[1,2],[1,2],"x",{"id":2}])");
+
+    std::unordered_set<json> distinct;
+    for (const auto& record : records.array_range())
+    {
+        distinct.insert(record);
+    }
+    BOOST_CHECK_EQUAL(4, distinct.size());
+    BOOST_CHECK(distinct.count(json::parse(R"({"id":1.0,"tags":["a","b"]})")) == 1);
+    BOOST_CHECK(distinct.count(json::parse(R"({"id":3})")) == 0);
+
+    std::unordered_map<ojson,int> counts;
+    ++counts[ojson::parse(R"({"a":1,"b":2})")];
+    ++counts[ojson::parse(R"({"b":2,"a":1})")];
+    BOOST_CHECK_EQUAL(1, counts.size());
+    BOOST_CHECK_EQUAL(2, counts.begin()->second);
+}
+
+// Objects in a different member order are equal
+BOOST_AUTO_TEST_CASE(test_ojson_equal_in_any_order)
+{
+    ojson a = ojson::parse(R"({"a":1,"b":2,"c":[3]})");
+    BOOST_CHECK(a == ojson::parse(R"({"a":1,"b":2,"c":[3]})"));
+    BOOST_CHECK(a == ojson::parse(R"({"c":[3],"a":1,"b":2})"));
+    BOOST_CHECK(a == ojson::parse(R"({"a":1,"c":[3],"b":2})"));
+    BOOST_CHECK(a != ojson::parse(R"({"a":1,"c":[3],"d":2})"));
+    BOOST_CHECK(a != ojson::parse(R"({"a":1,"b":2,"c":[4]})"));
+    BOOST_CHECK(a == a);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
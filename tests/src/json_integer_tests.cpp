@@ -62,5 +62,39 @@ BOOST_AUTO_TEST_CASE(test_integer_limits)
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_print_integers)
+{
+    std::vector<int64_t> values = {0,7,-7,10,-10,99,100,-100,999,1000,123456789,-987654321,
+                                   (std::numeric_limits<int64_t>::max)(),(std::numeric_limits<int64_t>::min)()};
+    for (int64_t value : values)
+    {
+        std::ostringstream os;
+        {
+            buffered_output<char> bos(os);
+            print_integer(value, bos);
+        }
+        BOOST_CHECK_EQUAL(std::to_string(value), os.str());
+    }
+
+    uint64_t u = 1;
+    for (int i = 0; i < 20; ++i)
+    {
+        for (uint64_t value : {u - 1, u, u + 1, u*9})
+        {
+            std::wostringstream os;
+            {
+                buffered_output<wchar_t> bos(os);
+                print_uinteger(value, bos);
+            }
+            BOOST_CHECK(std::to_wstring(value) == os.str());
+        }
+        u *= 10;
+    }
+
+    wchar_t buf[max_integer_chars];
+    wchar_t* last = buf + max_integer_chars;
+    BOOST_CHECK(std::wstring(format_uinteger((std::numeric_limits<uint64_t>::max)(), last), last) == L"18446744073709551615");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -0,0 +1,110 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/json_mapped_reader.hpp>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(json_mapped_reader_tests)
+
+BOOST_AUTO_TEST_CASE(test_mapped_reader)
+{
+    json_decoder<json> decoder;
+    json_mapped_reader reader("input/address-book.json", decoder);
+    reader.read();
+    BOOST_REQUIRE(decoder.is_valid());
+
+    std::ifstream is("input/address-book.json");
+    json expected = json::parse(is);
+    BOOST_CHECK_EQUAL(expected, decoder.get_result());
+    BOOST_CHECK(reader.eof());
+}
+
+BOOST_AUTO_TEST_CASE(test_mapped_reader_multiple_texts)
+{
+    const char* filename = "mapped_reader_multiple_texts.json";
+    {
+        std::ofstream os(filename);
+        os << "\xEF\xBB\xBF{\"a\":1} [2,3] 4";
+    }
+
+    std::vector<json> values;
+    {
+        json_decoder<json> decoder;
+        json_mapped_reader reader(filename, decoder);
+        while (!reader.eof())
+        {
+            reader.read_next();
+            if (decoder.is_valid())
+            {
+                values.push_back(decoder.get_result());
+            }
+        }
+    }
+    std::remove(filename);
+
+    BOOST_REQUIRE_EQUAL(3, values.size());
+    BOOST_CHECK_EQUAL(json::parse("{\"a\":1}"), values[0]);
+    BOOST_CHECK_EQUAL(json::parse("[2,3]"), values[1]);
+    BOOST_CHECK_EQUAL(4, values[2].as<int>());
+}
+
+BOOST_AUTO_TEST_CASE(test_mapped_reader_empty_file)
+{
+    const char* filename = "mapped_reader_empty.json";
+    {
+        std::ofstream os(filename);
+    }
+
+    std::error_code ec;
+    {
+        json_decoder<json> decoder;
+        json_mapped_reader reader(filename, decoder);
+        reader.read(ec);
+    }
+    std::remove(filename);
+
+    BOOST_CHECK(ec == json_parser_errc::unexpected_eof);
+}
+
+BOOST_AUTO_TEST_CASE(test_mapped_reader_missing_file)
+{
+    json_decoder<json> decoder;
+    json_mapped_reader reader("input/does-not-exist.json", decoder);
+    BOOST_CHECK(reader.open_error());
+
+    std::error_code ec;
+    reader.read(ec);
+    BOOST_CHECK(ec == reader.open_error());
+    BOOST_CHECK(ec == std::errc::no_such_file_or_directory);
+}
+
+BOOST_AUTO_TEST_CASE(test_wmapped_reader_truncated)
+{
+    const char* filename = "wmapped_reader_truncated.json";
+    const std::wstring text = L"[1]";
+    {
+        std::ofstream os(filename, std::ios::binary);
+        os.write(reinterpret_cast<const char*>(text.data()), text.size()*sizeof(wchar_t));
+        os.put('\0');
+    }
+
+    std::error_code ec;
+    {
+        json_decoder<wjson> decoder;
+        wjson_mapped_reader reader(filename, decoder);
+        BOOST_CHECK(!reader.open_error());
+        reader.read(ec);
+    }
+    std::remove(filename);
+
+    BOOST_CHECK(ec == json_parser_errc::unexpected_eof);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,155 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_member_traits.hpp>
+#include <jsoncons/decode_json.hpp>
+#include <sstream>
+#include <vector>
+#include <string>
+
+using namespace jsoncons;
+
+namespace ns {
+
+struct publisher
+{
+    std::string name;
+    std::string city;
+};
+
+struct wpublisher
+{
+    std::wstring name;
+    std::wstring city;
+};
+
+struct book
+{
+    std::string author;
+    std::string title;
+    double price;
+    int32_t year;
+    uint16_t copies;
+    bool in_print;
+    publisher imprint;
+    std::vector<std::string> tags;
+
+    book()
+        : price(0), year(0), copies(0), in_print(false)
+    {
+    }
+};
+
+}
+
+JSONCONS_MEMBER_TRAITS_DECL(ns::publisher, name, city)
+JSONCONS_MEMBER_TRAITS_DECL(ns::wpublisher, name, city)
+JSONCONS_MEMBER_TRAITS_DECL(ns::book, author, title, price, year, copies, in_print, imprint, tags)
+
+BOOST_AUTO_TEST_SUITE(json_member_traits_tests)
+
+BOOST_AUTO_TEST_CASE(test_member_count_and_hash)
+{
+    BOOST_CHECK_EQUAL(8, static_cast<size_t>(json_member_traits<ns::book>::member_count));
+    BOOST_CHECK_EQUAL(detail::member_name_hash("author"), detail::member_name_hash("author", 6));
+    BOOST_CHECK_EQUAL(detail::member_name_hash("author"), detail::member_name_hash(L"author", 6));
+    BOOST_CHECK(detail::member_name_hash("author") != detail::member_name_hash("autho"));
+}
+
+BOOST_AUTO_TEST_CASE(test_dump_struct)
+{
+    ns::book b;
+    b.author = "Haruki Murakami";
+    b.title = "Kafka on the Shore";
+    b.price = 25.17;
+    b.year = 2002;
+    b.copies = 50;
+    b.in_print = true;
+    b.imprint.name = "Shinchosha";
+    b.imprint.city = "Tokyo";
+    b.tags = {"novel","fiction"};
+
+    std::ostringstream os;
+    dump(b, os);
+    BOOST_CHECK_EQUAL(std::string("{\"author\":\"Haruki Murakami\",\"title\":\"Kafka on the Shore\",\"price\":25.17,"
+                                  "\"year\":2002,\"copies\":50,\"in_print\":true,"
+                                  "\"imprint\":{\"name\":\"Shinchosha\",\"city\":\"Tokyo\"},"
+                                  "\"tags\":[\"novel\",\"fiction\"]}"), os.str());
+
+    json j = b;
+    BOOST_CHECK(j == json::parse(os.str()));
+    BOOST_CHECK(j.is<ns::book>());
+    ns::book b2 = j.as<ns::book>();
+    BOOST_CHECK_EQUAL(b.author, b2.author);
+    BOOST_CHECK_EQUAL(b.copies, b2.copies);
+    BOOST_CHECK_EQUAL(b.imprint.city, b2.imprint.city);
+    BOOST_CHECK(b.tags == b2.tags);
+
+    j.erase("year");
+    BOOST_CHECK(!j.is<ns::book>());
+}
+
+BOOST_AUTO_TEST_CASE(test_decode_struct)
+{
+    std::string text = "{\"title\":\"Women: A Novel\",\"isbn\":{\"a\":[1,{\"b\":2}],\"c\":[]},"
+                       "\"author\":\"Charles Bukowski\",\"price\":12,\"copies\":7,\"in_print\":false,"
+                       "\"imprint\":{\"city\":\"Santa Rosa\",\"founded\":1966,\"name\":\"Black Sparrow\"},"
+                       "\"tags\":[\"novel\"],\"year\":1978}";
+    ns::book b = decode_json<ns::book>(text);
+    BOOST_CHECK_EQUAL(std::string("Charles Bukowski"), b.author);
+    BOOST_CHECK_EQUAL(std::string("Women: A Novel"), b.title);
+    BOOST_CHECK_EQUAL(12.0, b.price);
+    BOOST_CHECK_EQUAL(1978, b.year);
+    BOOST_CHECK_EQUAL(7, b.copies);
+    BOOST_CHECK(!b.in_print);
+    BOOST_CHECK_EQUAL(std::string("Black Sparrow"), b.imprint.name);
+    BOOST_CHECK_EQUAL(std::string("Santa Rosa"), b.imprint.city);
+    BOOST_CHECK_EQUAL(1, b.tags.size());
+
+    std::istringstream is(text);
+    ns::book b2 = decode_json<ns::book>(is);
+    BOOST_CHECK_EQUAL(b.author, b2.author);
+    BOOST_CHECK_EQUAL(b.imprint.city, b2.imprint.city);
+
+    // Missing members are left default constructed
+    ns::book b3 = decode_json<ns::book>(std::string("{\"title\":\"Untitled\"}"));
+    BOOST_CHECK_EQUAL(std::string("Untitled"), b3.title);
+    BOOST_CHECK_EQUAL(0, b3.year);
+    BOOST_CHECK(b3.author.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_decode_invalid_value)
+{
+    BOOST_CHECK_THROW(decode_json<ns::book>(std::string("{\"year\":\"1978\"}")), parse_error);
+    BOOST_CHECK_THROW(decode_json<ns::book>(std::string("{\"copies\":-1}")), parse_error);
+    BOOST_CHECK_THROW(decode_json<ns::book>(std::string("{\"copies\":70000}")), parse_error);
+    BOOST_CHECK_THROW(decode_json<ns::book>(std::string("[]")), parse_error);
+    try
+    {
+        decode_json<ns::book>(std::string("{\"title\":\"A\",\n\"in_print\":1}"));
+        BOOST_CHECK(false);
+    }
+    catch (const parse_error& e)
+    {
+        BOOST_CHECK(e.code() == json_parser_errc::invalid_value);
+        BOOST_CHECK_EQUAL(2, e.line_number());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_wide_struct)
+{
+    ns::wpublisher p = decode_json<ns::wpublisher>(std::wstring(L"{\"city\":\"London\",\"name\":\"Penguin\"}"));
+    BOOST_CHECK(p.name == L"Penguin");
+    BOOST_CHECK(p.city == L"London");
+
+    std::wostringstream os;
+    dump(p, os);
+    BOOST_CHECK(os.str() == L"{\"name\":\"Penguin\",\"city\":\"London\"}");
+    wjson j = p;
+    BOOST_CHECK(j.is<ns::wpublisher>());
+    BOOST_CHECK(j.as<ns::wpublisher>().city == L"London");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,143 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/counting_allocator.hpp>
+#include <sstream>
+#include <string>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(json_memory_usage_tests)
+
+std::string make_records(size_t n)
+{
+    std::ostringstream os;
+    os << "[";
+    for (size_t i = 0; i < n; ++i)
+    {
+        os << (i > 0 ? "," : "") << "{\"id\":" << i << ",\"description\":\"a description that is too long for a small string\","
+           << "\"a_member_name_that_is_long\":[1,2,3],\"flag\":true}";
+    }
+    os << "]";
+    return os.str();
+}
+
+BOOST_AUTO_TEST_CASE(test_scalar_memory_usage)
+{
+    BOOST_CHECK_EQUAL(0, json().memory_usage().total());
+    BOOST_CHECK_EQUAL(0, json(10).memory_usage().total());
+    BOOST_CHECK_EQUAL(0, json("short").memory_usage().total());
+
+    std::string s = "a string too long to be held in place";
+    json_memory_usage usage = json(s).memory_usage();
+    BOOST_CHECK(usage.string_bytes > s.length());
+    BOOST_CHECK_EQUAL(usage.string_bytes, usage.total());
+
+    std::vector<uint8_t> bytes(100, 7);
+    usage = json(byte_string_view(bytes.data(), bytes.size())).memory_usage();
+    BOOST_CHECK(usage.string_bytes >= bytes.size());
+    BOOST_CHECK(usage.node_bytes > 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_array_slack_and_shrink_to_fit)
+{
+    json j = json::array();
+    for (int i = 0; i < 100; ++i)
+    {
+        j.push_back(i);
+    }
+    json_memory_usage before = j.memory_usage();
+    BOOST_CHECK_EQUAL(100*sizeof(json), before.node_bytes);
+    BOOST_CHECK(before.slack_bytes > 0);
+    BOOST_CHECK_EQUAL(j.capacity() - j.size(), before.slack_bytes/sizeof(json));
+
+    j.shrink_to_fit();
+    json_memory_usage after = j.memory_usage();
+    BOOST_CHECK_EQUAL(0, after.slack_bytes);
+    BOOST_CHECK_EQUAL(before.node_bytes, after.node_bytes);
+}
+
+BOOST_AUTO_TEST_CASE(test_object_keys_and_subtrees)
+{
+    json j;
+    j["short"] = 1;
+    BOOST_CHECK_EQUAL(0, j.memory_usage().key_bytes);
+    j["a_member_name_long_enough_for_the_heap"] = json::array{1,2,3};
+    BOOST_CHECK(j.memory_usage().key_bytes > 0);
+
+    json_memory_usage member = j["a_member_name_long_enough_for_the_heap"].memory_usage();
+    BOOST_CHECK(member.node_bytes >= 3*sizeof(json));
+    BOOST_CHECK(j.memory_usage().node_bytes > member.node_bytes);
+
+    json_memory_usage sum;
+    for (const auto& m : j.object_range())
+    {
+        sum += m.value().memory_usage();
+    }
+    BOOST_CHECK(sum.total() < j.memory_usage().total());
+}
+
+BOOST_AUTO_TEST_CASE(test_ojson_index)
+{
+    ojson small;
+    ojson large;
+    for (int i = 0; i < 64; ++i)
+    {
+        large["m" + std::to_string(i)] = i;
+        if (i < 8)
+        {
+            small["m" + std::to_string(i)] = i;
+        }
+    }
+    // Objects of 32 or more members keep a hash index
+    size_t small_overhead = small.memory_usage().node_bytes - 8*sizeof(ojson::key_value_pair_type);
+    size_t large_overhead = large.memory_usage().node_bytes - 64*sizeof(ojson::key_value_pair_type);
+    BOOST_CHECK(large_overhead > small_overhead);
+}
+
+BOOST_AUTO_TEST_CASE(test_memory_usage_against_allocator)
+{
+    typedef basic_json<char,sorted_policy,counting_allocator<char>> counted_json;
+
+    std::string s = make_records(200);
+    allocation_stats stats;
+    counting_allocator<char> alloc(stats);
+    json_decoder<counted_json> decoder(alloc);
+    json_parser parser(decoder);
+    parser.set_source(s.data(), s.length());
+    parser.parse();
+    parser.end_parse();
+    counted_json j = decoder.get_result();
+
+    // A copy, whose blocks are its own
+    size_t before_copy = stats.bytes_in_use;
+    {
+        counted_json copy(j, alloc);
+        size_t copy_bytes = stats.bytes_in_use - before_copy;
+        json_memory_usage usage = copy.memory_usage();
+        BOOST_CHECK(usage.total() <= copy_bytes);
+        // The headers at the start of array and object blocks are not counted
+        BOOST_CHECK(usage.total() >= copy_bytes*9/10);
+        BOOST_CHECK(usage.string_bytes > 0);
+        BOOST_CHECK(usage.key_bytes > 0);
+
+        copy.shrink_to_fit();
+        BOOST_CHECK_EQUAL(0, copy.memory_usage().slack_bytes);
+        BOOST_CHECK(stats.bytes_in_use - before_copy <= copy_bytes);
+    }
+
+    for (int i = 4; i <= 10; ++i)
+    {
+        j[0]["a_member_name_that_is_long"].push_back(i);
+    }
+    json_memory_usage before = j.memory_usage();
+    BOOST_CHECK(before.slack_bytes > 0);
+    j.shrink_to_fit();
+    json_memory_usage after = j.memory_usage();
+    BOOST_CHECK_EQUAL(0, after.slack_bytes);
+    BOOST_CHECK_EQUAL(before.total() - before.slack_bytes, after.total());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
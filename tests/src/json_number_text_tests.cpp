@@ -0,0 +1,135 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/json_parser.hpp>
+#include <jsoncons/json_reader.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(json_number_text_tests)
+
+static const std::string text = "{\"a\":1.50,\"b\":-0,\"c\":123456789012345678901234567890,\"d\":1e+5,"
+                                "\"e\":42,\"f\":-7,\"g\":3.14159265358979323846264338327950288,\"h\":[0.1,2E-3,18446744073709551615]}";
+
+static json parse_indexed_keeping_text(const std::string& s)
+{
+    json_decoder<json> decoder;
+    json_parser parser(decoder);
+    parser.keep_number_text(true);
+    BOOST_CHECK(parser.keep_number_text());
+    parser.set_source(s.data(), s.length());
+    std::error_code ec;
+    BOOST_REQUIRE(parser.parse_indexed(ec));
+    BOOST_REQUIRE(!ec);
+    parser.end_parse();
+    parser.check_done();
+    return decoder.get_result();
+}
+
+static json read_keeping_text(const std::string& s, size_t buffer_length)
+{
+    std::istringstream is(s);
+    json_decoder<json> decoder;
+    json_reader reader(is, decoder);
+    reader.buffer_length(buffer_length);
+    reader.keep_number_text(true);
+    reader.read();
+    return decoder.get_result();
+}
+
+BOOST_AUTO_TEST_CASE(test_number_text_round_trip)
+{
+    json j = parse_indexed_keeping_text(text);
+    BOOST_CHECK_EQUAL(text, j.to_string());
+
+    for (size_t length : {1, 3, 7, 4096})
+    {
+        json k = read_keeping_text(text, length);
+        BOOST_CHECK_EQUAL(text, k.to_string());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_number_text_access)
+{
+    json j = parse_indexed_keeping_text(text);
+
+    BOOST_CHECK(j["a"].is_number_text());
+    BOOST_CHECK(j["a"].is_number());
+    BOOST_CHECK(j["a"].is_double());
+    BOOST_CHECK(!j["a"].is_string());
+    BOOST_CHECK(j["a"].number_text() == json::string_view_type("1.50"));
+    BOOST_CHECK_EQUAL(1.5, j["a"].as<double>());
+
+    BOOST_CHECK(j["e"].is_integer());
+    BOOST_CHECK(j["e"].is_uinteger());
+    BOOST_CHECK_EQUAL(42, j["e"].as<int>());
+    BOOST_CHECK_EQUAL(42u, j["e"].as<uint64_t>());
+    BOOST_CHECK(j["f"].is_integer());
+    BOOST_CHECK(!j["f"].is_uinteger());
+    BOOST_CHECK_EQUAL(-7, j["f"].as<int64_t>());
+    BOOST_CHECK_EQUAL(100000.0, j["d"].as<double>());
+    BOOST_CHECK(j["c"].is_double());
+    BOOST_CHECK(j["h"][2].is_uinteger());
+    BOOST_CHECK_EQUAL((std::numeric_limits<uint64_t>::max)(), j["h"][2].as<uint64_t>());
+
+    BOOST_CHECK(j["e"].as<bool>());
+    BOOST_CHECK(!j["b"].as<bool>());
+    BOOST_CHECK_THROW(json(1).number_text(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_number_text_equals_converted_value)
+{
+    json j = parse_indexed_keeping_text(text);
+    json expected = json::parse(text);
+
+    BOOST_CHECK(j == expected);
+    BOOST_CHECK(expected == j);
+    BOOST_CHECK(j["a"] == json(1.5));
+    BOOST_CHECK(j["e"] == json(42));
+    BOOST_CHECK(j["e"] != json("42"));
+    BOOST_CHECK(j["e"] != j["f"]);
+
+    std::vector<uint8_t> encoded;
+    cbor::encode_cbor(j, encoded);
+    std::vector<uint8_t> expected_encoded;
+    cbor::encode_cbor(expected, expected_encoded);
+    BOOST_CHECK(encoded == expected_encoded);
+}
+
+BOOST_AUTO_TEST_CASE(test_number_text_copy_and_swap)
+{
+    json j = parse_indexed_keeping_text(text);
+
+    json copy = j;
+    BOOST_CHECK_EQUAL(text, copy.to_string());
+
+    json a = j["c"];
+    json b = json("a string long enough to be held on the heap");
+    a.swap(b);
+    BOOST_CHECK(b.is_number_text());
+    BOOST_CHECK(b.number_text() == json::string_view_type("123456789012345678901234567890"));
+    BOOST_CHECK(a.is_string());
+
+    json c = std::move(b);
+    BOOST_CHECK(c.is_number_text());
+    j["e"] = 43;
+    BOOST_CHECK(!j["e"].is_number_text());
+    BOOST_CHECK(j["f"].is_number_text());
+}
+
+BOOST_AUTO_TEST_CASE(test_number_text_off_by_default)
+{
+    json j = json::parse(text);
+    BOOST_CHECK(!j["a"].is_number_text());
+    BOOST_CHECK(!j["e"].is_number_text());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
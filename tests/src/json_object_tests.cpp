@@ -1173,5 +1173,164 @@ ojson expected = ojson::parse(R"(
     //std::cout << "(2)\n" << source << std::endl;
 }
 
+BOOST_AUTO_TEST_CASE(test_json_merge_or_update_interleaved)
+{
+    json j;
+    json source;
+    for (int i = 0; i < 100; ++i)
+    {
+        j[std::to_string(1000 + 2*i)] = i;
+        source[std::to_string(1000 + 3*i)] = -i;
+    }
+    json j2 = j;
+    json source2 = source;
+
+    j.merge(source);
+    j2.merge_or_update(std::move(source2));
+    BOOST_CHECK_EQUAL(166, j.size());
+    BOOST_CHECK_EQUAL(166, j2.size());
+
+    std::string prev;
+    for (const auto& member : j2.object_range())
+    {
+        BOOST_CHECK(prev < member.key());
+        prev = member.key();
+    }
+    // "1000" and "1006" are in both, "1003" only in source
+    BOOST_CHECK_EQUAL(3, j["1006"].as<int>());
+    BOOST_CHECK_EQUAL(-2, j2["1006"].as<int>());
+    BOOST_CHECK_EQUAL(-1, j2["1003"].as<int>());
+}
+
+BOOST_AUTO_TEST_CASE(test_merge_self)
+{
+    json j = json::parse(R"({"c":3,"a":1,"b":2})");
+    json expected = j;
+    j.merge(j);
+    BOOST_CHECK_EQUAL(expected, j);
+    j.merge_or_update(j);
+    BOOST_CHECK_EQUAL(expected, j);
+
+    ojson oj;
+    for (int i = 0; i < 100; ++i)
+    {
+        oj.insert_or_assign(std::to_string(100 - i), i);
+    }
+    ojson oexpected = oj;
+    oj.merge(oj);
+    BOOST_CHECK(oexpected == oj);
+    oj.merge_or_update(oj);
+    BOOST_CHECK(oexpected == oj);
+    oj.merge(oj.object_range().begin() + 1, oj);
+    BOOST_CHECK(oexpected == oj);
+    oj.merge_or_update(oj.object_range().begin() + 1, oj);
+    BOOST_CHECK(oexpected == oj);
+}
+
+BOOST_AUTO_TEST_CASE(test_ojson_merge_or_update_indexed)
+{
+    ojson j;
+    ojson source;
+    for (int i = 0; i < 100; ++i)
+    {
+        j.insert_or_assign(std::to_string(2*i), i);
+        source.insert_or_assign(std::to_string(3*i), -i);
+    }
+    ojson j2 = j;
+    ojson source2 = source;
+
+    j.merge_or_update(std::move(source));
+    BOOST_CHECK_EQUAL(166, j.size());
+    BOOST_CHECK_EQUAL(-2, j["6"].as<int>());
+    BOOST_CHECK_EQUAL(-1, j["3"].as<int>());
+    // New members follow in the order of source
+    auto range = j.object_range();
+    BOOST_CHECK_EQUAL(std::string("198"), (range.begin() + 99)->key());
+    BOOST_CHECK_EQUAL(std::string("3"), (range.begin() + 100)->key());
+    BOOST_CHECK_EQUAL(std::string("9"), (range.begin() + 101)->key());
+
+    j2.merge(j2.object_range().begin() + 1, source2);
+    BOOST_CHECK_EQUAL(166, j2.size());
+    BOOST_CHECK_EQUAL(3, j2["6"].as<int>());
+    auto range2 = j2.object_range();
+    BOOST_CHECK_EQUAL(std::string("0"), range2.begin()->key());
+    BOOST_CHECK_EQUAL(std::string("3"), (range2.begin() + 1)->key());
+    BOOST_CHECK_EQUAL(std::string("9"), (range2.begin() + 2)->key());
+    BOOST_CHECK_EQUAL(std::string("2"), (range2.begin() + 67)->key());
+    BOOST_CHECK_EQUAL(-33, j2["99"].as<int>());
+}
+
+
+BOOST_AUTO_TEST_CASE(test_find_small_and_large_objects)
+{
+    // Small objects are searched linearly, larger ones with a binary search
+    const size_t sizes[] = {1, 7, 8, 9, 100};
+    for (size_t n : sizes)
+    {
+        json j;
+        for (size_t i = 0; i < n; ++i)
+        {
+            j[std::string(i % 3, 'k') + std::to_string(i)] = i;
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            std::string name = std::string(i % 3, 'k') + std::to_string(i);
+            BOOST_REQUIRE(j.has_key(name));
+            BOOST_CHECK_EQUAL(i, j.at(name).as<size_t>());
+            BOOST_CHECK(j.object_value().find(name)->key() == name);
+        }
+        BOOST_CHECK(!j.has_key(""));
+        BOOST_CHECK(!j.has_key("k"));
+        BOOST_CHECK(!j.has_key("kk1"));
+        BOOST_CHECK_EQUAL(-1, j.get_with_default("missing", -1));
+    }
+
+    json e = json::object();
+    BOOST_CHECK(!e.has_key(""));
+    e[""] = 1;
+    BOOST_CHECK(e.has_key(""));
+}
+
+template <class Proxy>
+size_t size_after_writes(Proxy&& proxy)
+{
+    BOOST_CHECK(proxy["b"].has_key("c"));
+    const size_t before = proxy.size();
+    proxy["b"]["f"] = 2;
+    BOOST_CHECK_EQUAL(2, proxy["b"].size());
+    proxy["g"] = 3;
+    BOOST_CHECK_EQUAL(3, proxy["g"].template as<int>());
+    return proxy.size() - before;
+}
+
+BOOST_AUTO_TEST_CASE(test_proxy_chains)
+{
+    json j;
+    j["a"]["b"]["c"] = 1;
+    BOOST_CHECK_EQUAL(1, j["a"]["b"]["c"].as<int>());
+
+    std::string name = "d";
+    j["a"][name]["e"] = "x";
+    BOOST_CHECK_EQUAL(std::string("x"), j["a"]["d"]["e"].as<std::string>());
+
+    // Reads, writes and reads again through one proxy, within the expression that makes it
+    BOOST_CHECK_EQUAL(1, size_after_writes(j["a"]));
+    BOOST_CHECK_EQUAL(2, j["a"]["b"]["f"].as<int>());
+    BOOST_CHECK_EQUAL(3, j["a"]["g"].as<int>());
+
+    // A temporary name lasts as long as the proxy made from it
+    BOOST_CHECK_EQUAL(1, j[std::string("a")][std::string("b")][std::string("c")].as<int>());
+    j[std::string("a")][std::string("h")] = 4;
+    BOOST_CHECK_EQUAL(4, j["a"]["h"].as<int>());
+
+    j["a"]["b"] = json::array();
+    BOOST_CHECK(j["a"]["b"].is_array());
+    j["a"]["b"].add(3);
+    BOOST_CHECK_EQUAL(3, j["a"]["b"][0].as<int>());
+
+    BOOST_CHECK_THROW(j["a"]["missing"].as<int>(), std::out_of_range);
+    BOOST_CHECK_THROW(j["a"]["b"]["g"] = 1, std::runtime_error);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
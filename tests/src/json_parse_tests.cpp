@@ -5,6 +5,7 @@
 #include <jsoncons/json.hpp>
 #include <jsoncons/json_serializer.hpp>
 #include <jsoncons/json_reader.hpp>
+#include <jsoncons/detail/compact_vector.hpp>
 #include <sstream>
 #include <vector>
 #include <utility>
@@ -191,6 +192,123 @@ BOOST_AUTO_TEST_CASE(test_multiple)
     }
 }
 
+
+// Containers and keys that count their copies
+
+struct copy_count
+{
+    static size_t containers;
+    static size_t keys;
+};
+
+size_t copy_count::containers = 0;
+size_t copy_count::keys = 0;
+
+template <class T, class Allocator>
+class copy_counting_vector : public jsoncons::detail::compact_vector<T,Allocator>
+{
+    typedef jsoncons::detail::compact_vector<T,Allocator> base_type;
+public:
+    using base_type::base_type;
+
+    copy_counting_vector() = default;
+    copy_counting_vector(const copy_counting_vector& other)
+        : base_type(other)
+    {
+        ++copy_count::containers;
+    }
+    copy_counting_vector(const copy_counting_vector& other, const Allocator& a)
+        : base_type(other, a)
+    {
+        ++copy_count::containers;
+    }
+    copy_counting_vector(copy_counting_vector&&) = default;
+    copy_counting_vector(copy_counting_vector&& other, const Allocator& a)
+        : base_type(std::move(other), a)
+    {
+    }
+    copy_counting_vector& operator=(const copy_counting_vector& other)
+    {
+        ++copy_count::containers;
+        base_type::operator=(other);
+        return *this;
+    }
+    copy_counting_vector& operator=(copy_counting_vector&&) = default;
+};
+
+template <class CharT, class CharTraits, class Allocator>
+class copy_counting_string : public std::basic_string<CharT,CharTraits,Allocator>
+{
+    typedef std::basic_string<CharT,CharTraits,Allocator> base_type;
+public:
+    using base_type::base_type;
+
+    copy_counting_string() = default;
+    copy_counting_string(const copy_counting_string& other)
+        : base_type(other)
+    {
+        ++copy_count::keys;
+    }
+    copy_counting_string(copy_counting_string&&) = default;
+    copy_counting_string& operator=(const copy_counting_string& other)
+    {
+        ++copy_count::keys;
+        base_type::operator=(other);
+        return *this;
+    }
+    copy_counting_string& operator=(copy_counting_string&&) = default;
+};
+
+struct copy_counting_policy : public sorted_policy
+{
+    template <class T,class Allocator>
+    using object_storage = copy_counting_vector<T,Allocator>;
+
+    template <class T,class Allocator>
+    using array_storage = copy_counting_vector<T,Allocator>;
+
+    template <class CharT, class CharTraits, class Allocator>
+    using key_storage = copy_counting_string<CharT, CharTraits,Allocator>;
+};
+
+struct preserve_order_copy_counting_policy : public copy_counting_policy
+{
+    static const bool preserve_order = true;
+};
+
+template <class Json>
+void check_parse_without_copies(const std::string& s)
+{
+    copy_count::containers = 0;
+    copy_count::keys = 0;
+    Json j = Json::parse(s);
+    BOOST_CHECK_EQUAL(0, copy_count::containers);
+    BOOST_CHECK_EQUAL(0, copy_count::keys);
+
+    Json k = j;
+    BOOST_CHECK(copy_count::containers > 0);
+    BOOST_CHECK(copy_count::keys > 0);
+    BOOST_CHECK(k == j);
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_moves_values)
+{
+    // Enough values to grow the decoder's stack, nested objects with duplicate names, and
+    // long names and strings
+    std::ostringstream os;
+    os << "{\"records\":[";
+    for (size_t i = 0; i < 3000; ++i)
+    {
+        os << (i > 0 ? "," : "") << "{\"a name too long for the small string buffer\":" << i 
+           << ",\"b\":[\"a string too long for the small string buffer\",{\"c\":[]}],\"b\":" << i << "}";
+    }
+    os << "],\"z\":{\"y\":{\"x\":[[[{}]]]}}}";
+    const std::string s = os.str();
+
+    check_parse_without_copies<basic_json<char,copy_counting_policy,std::allocator<char>>>(s);
+    check_parse_without_copies<basic_json<char,preserve_order_copy_counting_policy,std::allocator<char>>>(s);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
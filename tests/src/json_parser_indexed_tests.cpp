@@ -0,0 +1,229 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_serializer.hpp>
+#include <jsoncons/json_parser.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/detail/structural_index.hpp>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <utility>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(json_parser_indexed_tests)
+
+static json parse_linear(const std::string& s)
+{
+    json_decoder<json> decoder;
+    json_parser parser(decoder);
+    parser.set_source(s.data(),s.length());
+    parser.parse();
+    parser.end_parse();
+    parser.check_done();
+    return decoder.get_result();
+}
+
+static json parse_two_stage(const std::string& s, std::error_code& ec)
+{
+    json_decoder<json> decoder;
+    json_parser parser(decoder);
+    parser.set_source(s.data(),s.length());
+    BOOST_REQUIRE(parser.parse_indexed(ec));
+    if (ec)
+    {
+        return json::null();
+    }
+    parser.check_done(ec);
+    return decoder.is_valid() ? decoder.get_result() : json::null();
+}
+
+BOOST_AUTO_TEST_CASE(test_structural_index)
+{
+    std::string s = "{\"a\\\"{\": [1, true,null],\"b\":-2.5e3}";
+    std::vector<uint32_t> positions;
+    BOOST_REQUIRE(detail::build_structural_index(s.data(), s.length(), positions));
+
+    std::vector<uint32_t> expected = {0,1,7,9,10,11,13,17,18,22,23,24,27,28,34};
+    BOOST_CHECK(expected == positions);
+}
+
+BOOST_AUTO_TEST_CASE(test_structural_index_not_indexable)
+{
+    std::vector<uint32_t> positions;
+    std::string comment = "[1, /* one */ 2]";
+    BOOST_CHECK(!detail::build_structural_index(comment.data(), comment.length(), positions));
+
+    std::string unterminated = "[\"abc]";
+    BOOST_CHECK(!detail::build_structural_index(unterminated.data(), unterminated.length(), positions));
+
+    std::string slash_in_string = "[\"a/b\"]";
+    BOOST_CHECK(detail::build_structural_index(slash_in_string.data(), slash_in_string.length(), positions));
+}
+
+BOOST_AUTO_TEST_CASE(test_indexed_same_as_linear)
+{
+    std::vector<std::string> inputs = {
+        "{}", "[]", "\"\"", "0", "-0", "true", " null ", "[false]",
+        "{\"first\" : 1, \"second\" : [ -1, 1.5, -2.25e-3, 1E10, 10.0 ] }",
+        "[18446744073709551615, 18446744073709551616, -9223372036854775808, -9223372036854775809]",
+        "[\"\\u00e9\\ud834\\udd1e\\\"\\\\\\/\\b\\f\\n\\r\\t\", \"\xc3\xa9\"]",
+        "{\"a\":{\"b\":{\"c\":[[[]],{}]}}}",
+        "[\r\n  1,\r\n  2\n]"
+    };
+
+    // Inputs longer than one 64 byte block, with strings straddling the block boundaries
+    std::string long_input = "[";
+    for (size_t i = 0; i < 100; ++i)
+    {
+        if (i > 0)
+        {
+            long_input.push_back(',');
+        }
+        long_input += "{\"key" + std::to_string(i) + "\":\"" + std::string(i, 'x') + "\\\\\\\"" + "\"}";
+    }
+    long_input += "]";
+    inputs.push_back(long_input);
+    inputs.push_back(std::string(63, ' ') + "\"" + std::string(64, '\\') + "\"");
+
+    for (const auto& s : inputs)
+    {
+        std::error_code ec;
+        json j1 = parse_two_stage(s, ec);
+        BOOST_CHECK_MESSAGE(!ec, s);
+        json j2 = parse_linear(s);
+        BOOST_CHECK_MESSAGE(j1 == j2, s);
+        BOOST_CHECK_EQUAL(j2.to_string(), j1.to_string());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_indexed_errors)
+{
+    std::vector<std::pair<std::string,json_parser_errc>> inputs = {
+        {"[1,2", json_parser_errc::unexpected_eof},
+        {"[1,]", json_parser_errc::extra_comma},
+        {"{\"a\":1,}", json_parser_errc::extra_comma},
+        {"{\"a\" 1}", json_parser_errc::expected_colon},
+        {"{1:1}", json_parser_errc::expected_name},
+        {"[1 2]", json_parser_errc::expected_comma_or_right_bracket},
+        {"{\"a\":1]", json_parser_errc::expected_comma_or_right_brace},
+        {"[tru]", json_parser_errc::invalid_value},
+        {"[01]", json_parser_errc::leading_zero},
+        {"[1.]", json_parser_errc::invalid_number},
+        {"[1e]", json_parser_errc::expected_value},
+        {"[1a]", json_parser_errc::invalid_number},
+        {"[\"\\q\"]", json_parser_errc::illegal_escaped_character},
+        {"[\"\\u12g4\"]", json_parser_errc::invalid_hex_escape_sequence},
+        {"[\"a\tb\"]", json_parser_errc::illegal_character_in_string},
+        {"[\"\xc3" "A\"]", json_parser_errc::expected_continuation_byte}
+    };
+
+    for (const auto& item : inputs)
+    {
+        std::error_code ec;
+        parse_two_stage(item.first, ec);
+        BOOST_CHECK_MESSAGE(ec == item.second, item.first);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_indexed_extra_character)
+{
+    std::string s = "[1] 2";
+    json_decoder<json> decoder;
+    json_parser parser(decoder);
+    parser.set_source(s.data(),s.length());
+    std::error_code ec;
+    BOOST_CHECK(parser.parse_indexed(ec));
+    BOOST_CHECK(ec == json_parser_errc::extra_character);
+    BOOST_CHECK_EQUAL(1, parser.line_number());
+    BOOST_CHECK_EQUAL(5, parser.column_number());
+}
+
+BOOST_AUTO_TEST_CASE(test_indexed_max_depth)
+{
+    std::string s = "[[[1]]]";
+    json_decoder<json> decoder;
+    json_parser parser(decoder);
+    parser.max_nesting_depth(3);
+    parser.set_source(s.data(),s.length());
+    std::error_code ec;
+    BOOST_CHECK(parser.parse_indexed(ec));
+    BOOST_CHECK(ec == json_parser_errc::max_depth_exceeded);
+}
+
+BOOST_AUTO_TEST_CASE(test_indexed_error_position)
+{
+    std::string s = "[1,\n 2,\n x]";
+    json_decoder<json> decoder;
+    json_parser parser(decoder);
+    parser.set_source(s.data(),s.length());
+    std::error_code ec;
+    parser.parse_indexed(ec);
+    BOOST_CHECK(ec == json_parser_errc::expected_value);
+    BOOST_CHECK_EQUAL(3, parser.line_number());
+    BOOST_CHECK_EQUAL(2, parser.column_number());
+}
+
+BOOST_AUTO_TEST_CASE(test_json_parse_falls_back)
+{
+    // Comments are not indexed
+    json j = json::parse("[1, /* one */ 2]");
+    BOOST_CHECK_EQUAL(2, j.size());
+
+    // Errors are reported by the character by character parser
+    try
+    {
+        json::parse("[1,\n 2,\n x]");
+        BOOST_FAIL("Expected parse_error");
+    }
+    catch (const parse_error& e)
+    {
+        BOOST_CHECK(e.code() == json_parser_errc::expected_value);
+        BOOST_CHECK_EQUAL(3, e.line_number());
+    }
+}
+
+// The outcome of parsing s, a value or an error with its position
+static std::string parse_outcome(const std::string& s, bool stream)
+{
+    try
+    {
+        if (stream)
+        {
+            std::istringstream is(s);
+            return json::parse(is).to_string();
+        }
+        return json::parse(s).to_string();
+    }
+    catch (const parse_error& e)
+    {
+        return e.code().message() + " at " + std::to_string(e.line_number()) + ":" + std::to_string(e.column_number());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_json_parse_trailing_characters)
+{
+    // Text after the value is reported as the stream parser reports it
+    for (const char* s : {"\n\n  12 x", "\n-5}0", "-796, ", "[1,2]\n  x", "{\"a\":1}\n\n }",
+                          "\"s\"\n\t1", "true  ,", "null\r\n\r\n]", "[1] 2", "  7 \n"})
+    {
+        BOOST_CHECK_EQUAL(parse_outcome(s, true), parse_outcome(s, false));
+    }
+
+    try
+    {
+        json::parse("\n\n  12 x");
+        BOOST_FAIL("Expected parse_error");
+    }
+    catch (const parse_error& e)
+    {
+        BOOST_CHECK(e.code() == json_parser_errc::extra_character);
+        BOOST_CHECK_EQUAL(3, e.line_number());
+        BOOST_CHECK_EQUAL(6, e.column_number());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
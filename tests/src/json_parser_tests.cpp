@@ -10,6 +10,7 @@
 #include <vector>
 #include <utility>
 #include <ctime>
+#include <cctype>
 
 using namespace jsoncons;
 
@@ -214,6 +215,323 @@ BOOST_AUTO_TEST_CASE(test_array_string)
     json j = decoder.get_result();
 }
 
+BOOST_AUTO_TEST_CASE(test_integer_lengths)
+{
+    std::vector<std::string> inputs = {
+        "0", "-0", "7", "-7", "1234567890123456789", "-1234567890123456789",
+        "9223372036854775807", "-9223372036854775808", "-9223372036854775809", "-9999999999999999999",
+        "9999999999999999999", "18446744073709551615", "18446744073709551616", "123456789012345678901234",
+        "-0.5", "0e1", "1234567890123456789.5", "12345678901234567890e-1", "-12e2"
+    };
+
+    for (const auto& s : inputs)
+    {
+        std::string text = "[" + s + "," + s + "]";
+
+        // All at once, and one character at a time
+        jsoncons::json_decoder<json> decoder1;
+        json_parser parser1(decoder1);
+        parser1.set_source(text.data(),text.length());
+        parser1.parse();
+        parser1.end_parse();
+        json j1 = decoder1.get_result();
+
+        jsoncons::json_decoder<json> decoder2;
+        json_parser parser2(decoder2);
+        for (size_t i = 0; i < text.length(); ++i)
+        {
+            parser2.set_source(text.data() + i, 1);
+            parser2.parse();
+        }
+        parser2.end_parse();
+        json j2 = decoder2.get_result();
+
+        // A number at the end of the input
+        jsoncons::json_decoder<json> decoder3;
+        json_parser parser3(decoder3);
+        parser3.set_source(s.data(),s.length());
+        parser3.parse();
+        parser3.end_parse();
+        json j3 = decoder3.get_result();
+
+        json expected = json::parse(text);
+        BOOST_CHECK_MESSAGE(expected == j1, s);
+        BOOST_CHECK_MESSAGE(expected == j2, s);
+        BOOST_CHECK_MESSAGE(expected[0] == j3, s);
+        BOOST_CHECK_EQUAL(expected.to_string(), j1.to_string());
+        BOOST_CHECK_EQUAL(expected[0].to_string(), j3.to_string());
+    }
+
+    jsoncons::json_decoder<json> decoder;
+    json_parser parser(decoder);
+    std::string s = "[-9223372036854775808,18446744073709551615,-9223372036854775809]";
+    parser.set_source(s.data(),s.length());
+    parser.parse();
+    parser.end_parse();
+    json j = decoder.get_result();
+    BOOST_CHECK(j[0].is_integer());
+    BOOST_CHECK_EQUAL((std::numeric_limits<int64_t>::min)(), j[0].as<int64_t>());
+    BOOST_CHECK(j[1].is_uinteger());
+    BOOST_CHECK_EQUAL((std::numeric_limits<uint64_t>::max)(), j[1].as<uint64_t>());
+    BOOST_CHECK(j[2].is_double());
+}
+
+
+BOOST_AUTO_TEST_CASE(test_reuse_parser_and_decoder)
+{
+    jsoncons::json_decoder<json> decoder;
+    json_parser parser(decoder);
+
+    std::vector<std::string> texts = {"{\"a\":[1,2.5,\"three\"]}", "[true,false,null]", "\"text\"", "-17"};
+    for (size_t round = 0; round < 2; ++round)
+    {
+        for (const auto& s : texts)
+        {
+            parser.reset();
+            decoder.reset();
+            parser.set_source(s.data(),s.length());
+            parser.parse();
+            parser.end_parse();
+            parser.check_done();
+            BOOST_REQUIRE(decoder.is_valid());
+            BOOST_CHECK_EQUAL(s, decoder.get_result().to_string());
+        }
+    }
+
+    // A text that fails part way leaves nothing behind for the next one
+    std::string bad = "{\"a\":[1,2,{\"b\":";
+    parser.reset();
+    decoder.reset();
+    parser.set_source(bad.data(),bad.length());
+    parser.parse();
+    std::error_code ec;
+    parser.end_parse(ec);
+    BOOST_CHECK(ec);
+    BOOST_CHECK(!decoder.is_valid());
+
+    std::string good = "[1,2]";
+    parser.reset();
+    decoder.reset();
+    parser.set_source(good.data(),good.length());
+    parser.parse();
+    parser.end_parse();
+    parser.check_done();
+    BOOST_CHECK(decoder.is_valid());
+    BOOST_CHECK_EQUAL(good, decoder.get_result().to_string());
+}
+
+BOOST_AUTO_TEST_CASE(test_reuse_reader)
+{
+    jsoncons::json_decoder<json> decoder;
+    std::istringstream is1("[1,2,3]");
+    json_reader reader(is1, decoder);
+    reader.read_next();
+    reader.check_done();
+    BOOST_CHECK_EQUAL(std::string("[1,2,3]"), decoder.get_result().to_string());
+
+    std::istringstream is2("\xEF\xBB\xBF{\"a\":1}");
+    reader.reset(is2);
+    decoder.reset();
+    reader.read_next();
+    reader.check_done();
+    BOOST_CHECK_EQUAL(std::string("{\"a\":1}"), decoder.get_result().to_string());
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_reuses_thread_state)
+{
+    // Errors leave the per thread parser ready for the next call
+    BOOST_CHECK_THROW(json::parse("{\"a\":[1,2"), parse_error);
+    BOOST_CHECK_THROW(json::parse("[1,2]]"), parse_error);
+    for (size_t i = 0; i < 3; ++i)
+    {
+        json j = json::parse("{\"a\":[1,2],\"b\":\"c\"}");
+        BOOST_CHECK_EQUAL(2, j["a"].size());
+        BOOST_CHECK_EQUAL(std::string("c"), j["b"].as<std::string>());
+    }
+    ojson o = ojson::parse("{\"z\":1,\"a\":2}");
+    BOOST_CHECK_EQUAL(std::string("{\"z\":1,\"a\":2}"), o.to_string());
+    wjson w = wjson::parse(L"[\"wide\"]");
+    BOOST_CHECK(w[0].as<std::wstring>() == L"wide");
+}
+
+namespace {
+
+// A filter known at compile time, that passes the events on to Next with the names in upper case
+template <class Next>
+struct upper_case_names_filter
+{
+    typedef json_input_handler::string_view_type string_view_type;
+
+    Next& next;
+    std::string buffer;
+
+    upper_case_names_filter(Next& next)
+        : next(next)
+    {
+    }
+
+    void begin_json() { next.begin_json(); }
+    void end_json() { next.end_json(); }
+    void begin_object(const parsing_context& context) { next.begin_object(context); }
+    void end_object(const parsing_context& context) { next.end_object(context); }
+    void begin_array(const parsing_context& context) { next.begin_array(context); }
+    void end_array(const parsing_context& context) { next.end_array(context); }
+    void name(const string_view_type& name, const parsing_context& context)
+    {
+        buffer.assign(name.data(), name.length());
+        for (auto& c : buffer)
+        {
+            c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+        next.name(string_view_type(buffer.data(), buffer.length()), context);
+    }
+    void string_value(const string_view_type& value, const parsing_context& context) { next.string_value(value, context); }
+    void integer_value(int64_t value, const parsing_context& context) { next.integer_value(value, context); }
+    void uinteger_value(uint64_t value, const parsing_context& context) { next.uinteger_value(value, context); }
+    void double_value(double value, uint8_t precision, const parsing_context& context) { next.double_value(value, precision, context); }
+    void bool_value(bool value, const parsing_context& context) { next.bool_value(value, context); }
+    void null_value(const parsing_context& context) { next.null_value(context); }
+};
+
+}
+
+BOOST_AUTO_TEST_CASE(test_parser_static_handler)
+{
+    std::string s = "{\"a\":[1,-2,18446744073709551615,2.50,\"x\\ty\",true,false,null],\"bc\":{\"d\":{}}}";
+    json expected = json::parse(s);
+
+    // The same result through the indexed and the character by character paths
+    for (int indexed = 0; indexed < 2; ++indexed)
+    {
+        json_decoder<json> decoder;
+        basic_json_parser<char,json_decoder<json>> parser(decoder);
+        parser.set_source(s.data(), s.length());
+        if (!indexed || !parser.parse_indexed())
+        {
+            parser.parse();
+        }
+        parser.end_parse();
+        parser.check_done();
+        BOOST_CHECK_EQUAL(expected, decoder.get_result());
+    }
+
+    json_decoder<json> decoder;
+    upper_case_names_filter<json_decoder<json>> filter(decoder);
+    basic_json_parser<char,upper_case_names_filter<json_decoder<json>>> parser(filter);
+    parser.set_source(s.data(), s.length());
+    parser.parse();
+    parser.end_parse();
+    parser.check_done();
+    BOOST_CHECK_EQUAL(json::parse("{\"A\":[1,-2,18446744073709551615,2.50,\"x\\ty\",true,false,null],\"BC\":{\"D\":{}}}"),
+                      decoder.get_result());
+}
+
+namespace {
+
+// Parses s through the indexed path, or character by character, with the limits set by set_limits
+template <class F>
+std::error_code parse_with_limits(const std::string& s, bool indexed, F set_limits)
+{
+    json_decoder<json> decoder;
+    json_parser parser(decoder);
+    set_limits(parser);
+    parser.set_source(s.data(), s.length());
+    std::error_code ec;
+    if (!indexed || !parser.parse_indexed(ec))
+    {
+        parser.parse(ec);
+        if (!ec)
+        {
+            parser.end_parse(ec);
+        }
+    }
+    return ec;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(test_parser_limits)
+{
+    const std::string s = "{\"a\":[1,2,3],\"b\":\"abcd\",\"c\\u0064\":{\"x\":[],\"y\":[4,5,6,7]}}";
+    for (int indexed = 0; indexed < 2; ++indexed)
+    {
+        BOOST_CHECK(!parse_with_limits(s, indexed != 0, [](json_parser& p){p.max_items(4); p.max_string_length(4);}));
+        BOOST_CHECK(parse_with_limits(s, indexed != 0, [](json_parser& p){p.max_items(3);}) == json_parser_errc::max_items_exceeded);
+        BOOST_CHECK(parse_with_limits(s, indexed != 0, [](json_parser& p){p.max_string_length(3);}) == json_parser_errc::max_string_length_exceeded);
+        BOOST_CHECK(!parse_with_limits(s, indexed != 0, [&](json_parser& p){p.max_input_length(s.length());}));
+        BOOST_CHECK(parse_with_limits(s, indexed != 0, [&](json_parser& p){p.max_input_length(s.length()-1);}) == json_parser_errc::max_input_length_exceeded);
+        BOOST_CHECK(!parse_with_limits("[\"a\"]", indexed != 0, [](json_parser& p){p.max_items(0);}));
+    }
+
+    // A string that grows across reads is stopped when it passes the limit
+    std::istringstream is("[\"" + std::string(1000, 'x') + "\"]");
+    json_decoder<json> decoder;
+    json_reader reader(is, decoder);
+    reader.buffer_length(16);
+    reader.max_string_length(100);
+    std::error_code ec;
+    reader.read(ec);
+    BOOST_CHECK(ec == json_parser_errc::max_string_length_exceeded);
+    BOOST_CHECK(reader.column_number() < 200);
+}
+
+// Lines, columns and offsets of errors are the same however the text is divided into sources
+BOOST_AUTO_TEST_CASE(test_parser_error_positions)
+{
+    struct expected_position
+    {
+        std::string text;
+        size_t line;
+        size_t column;
+        size_t offset;
+    };
+    std::vector<expected_position> cases = {
+        {"[1,2,}", 1, 6, 5},
+        {"{\"a\":\r\n  [1,]}", 2, 6, 12},
+        {"[\"ab\ncd\"]", 1, 5, 4},
+        {"[\"abc", 1, 6, 5},
+        {"[\"a\xff\"]", 1, 4, 3},
+        {"{\"a\":1}\n\n  x", 3, 3, 11},
+        {"\n\n\n  [1 2]", 4, 6, 8}
+    };
+
+    for (const auto& c : cases)
+    {
+        for (size_t chunk : {c.text.length(), size_t(1), size_t(3)})
+        {
+            json_decoder<json> decoder;
+            json_parser parser(decoder);
+            std::error_code ec;
+            size_t pos = 0;
+            while (!ec && !parser.done() && pos < c.text.length())
+            {
+                size_t n = (std::min)(chunk, c.text.length() - pos);
+                parser.set_source(c.text.data() + pos, n);
+                pos += n;
+                parser.parse(ec);
+            }
+            if (!ec && !parser.done())
+            {
+                parser.end_parse(ec);
+            }
+            if (!ec)
+            {
+                parser.check_done(ec);
+            }
+            if (!ec)
+            {
+                parser.set_source(c.text.data() + pos, c.text.length() - pos);
+                parser.check_done(ec);
+            }
+            BOOST_CHECK_MESSAGE(ec, c.text);
+            BOOST_CHECK_EQUAL(c.line, parser.line_number());
+            BOOST_CHECK_EQUAL(c.column, parser.column_number());
+            BOOST_CHECK_EQUAL(c.offset, parser.offset());
+            BOOST_CHECK_EQUAL(c.offset, parser.parsing_context().offset());
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
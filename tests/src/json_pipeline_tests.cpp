@@ -0,0 +1,147 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+#include <string>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/json_filter.hpp>
+#include <jsoncons/json_reader.hpp>
+#include <jsoncons/json_parser.hpp>
+#include <jsoncons/json_pipeline.hpp>
+
+using namespace jsoncons;
+
+namespace {
+
+// Replaces null values with 0
+class null_to_zero_stage : public json_pipeline_stage
+{
+public:
+    template <class Next>
+    void null_value(const parsing_context& context, Next& next)
+    {
+        next.integer_value(0, context);
+    }
+};
+
+// Counts the names that pass through it
+class name_counter_stage : public json_pipeline_stage
+{
+public:
+    size_t count = 0;
+
+    template <class Next>
+    void name(const string_view_type& name, const parsing_context& context, Next& next)
+    {
+        ++count;
+        next.name(name, context);
+    }
+};
+
+class test_parsing_context : public parsing_context
+{
+    size_t do_line_number() const override { return 0; }
+
+    size_t do_column_number() const override { return 0; }
+};
+
+const std::string text = R"({"first":1,"second":null,"third":{"first":[null,"a"]},"fourth":true})";
+
+}
+
+BOOST_AUTO_TEST_SUITE(json_pipeline_tests)
+
+BOOST_AUTO_TEST_CASE(test_pipeline_with_reader)
+{
+    json_decoder<json> decoder;
+    auto pipeline = rename_members_stage({{"first","1st"},{"third","3rd"}})
+                    | null_to_zero_stage()
+                    | rename_members_stage("fourth","4th")
+                    | decoder;
+
+    std::istringstream is(text);
+    json_reader reader(is, pipeline);
+    reader.read();
+
+    json expected = json::parse(R"({"1st":1,"second":0,"3rd":{"1st":[0,"a"]},"4th":true})");
+    BOOST_CHECK_EQUAL(expected, decoder.get_result());
+}
+
+BOOST_AUTO_TEST_CASE(test_pipeline_with_parser)
+{
+    json_decoder<json> decoder;
+    auto pipeline = name_counter_stage() | rename_members_stage("second","2nd") | decoder;
+    typedef decltype(pipeline) pipeline_type;
+
+    // The pipeline is the parser's handler, and is called without virtual dispatch
+    basic_json_parser<char,pipeline_type> parser(pipeline);
+    parser.set_source(text.data(), text.length());
+    parser.parse();
+    parser.end_parse();
+    parser.check_done();
+
+    BOOST_CHECK_EQUAL(5, pipeline.stage<0>().count);
+    json expected = json::parse(R"({"first":1,"2nd":null,"third":{"first":[null,"a"]},"fourth":true})");
+    BOOST_CHECK_EQUAL(expected, decoder.get_result());
+}
+
+BOOST_AUTO_TEST_CASE(test_pipeline_same_as_filters)
+{
+    // The runtime filters
+    json_decoder<json> decoder1;
+    rename_object_member_filter filter2("third", "3rd", decoder1);
+    rename_object_member_filter filter1("first", "1st", filter2);
+    std::istringstream is1(text);
+    json_reader reader1(is1, filter1);
+    reader1.read();
+
+    json_decoder<json> decoder2;
+    auto pipeline = rename_members_stage("first","1st") | rename_members_stage("third","3rd") | decoder2;
+    std::istringstream is2(text);
+    json_reader reader2(is2, pipeline);
+    reader2.read();
+
+    BOOST_CHECK_EQUAL(decoder1.get_result(), decoder2.get_result());
+
+    // A fragment stage drops the begin_json and end_json of each value
+    json_decoder<json> decoder3;
+    auto fragments = fragment_stage() | decoder3;
+    test_parsing_context context;
+    decoder3.begin_json();
+    decoder3.begin_array(context);
+    std::istringstream is3("[1,2] {\"a\":3}");
+    json_reader reader3(is3, fragments);
+    reader3.read_next();
+    reader3.read_next();
+    decoder3.end_array(context);
+    decoder3.end_json();
+    BOOST_CHECK_EQUAL(json::parse("[[1,2],{\"a\":3}]"), decoder3.get_result());
+}
+
+BOOST_AUTO_TEST_CASE(test_rename_members_stage)
+{
+    // Names of the same length, and long names
+    std::string long_name(100, 'x');
+    json_decoder<json> decoder;
+    auto pipeline = rename_members_stage({{"ab","AB"},{"cd","CD"},{long_name,"long"}}) | name_counter_stage() | decoder;
+    std::istringstream is(std::string("{\"ab\":1,\"cd\":2,\"ef\":3,\"") + long_name + "\":4,\"" + long_name + "y\":5}");
+    json_reader reader(is, pipeline);
+    reader.read();
+
+    json expected;
+    expected["AB"] = 1;
+    expected["CD"] = 2;
+    expected["ef"] = 3;
+    expected["long"] = 4;
+    expected[long_name + "y"] = 5;
+    BOOST_CHECK_EQUAL(expected, decoder.get_result());
+    BOOST_CHECK_EQUAL(5, pipeline.stage<1>().count);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
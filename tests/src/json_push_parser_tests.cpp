@@ -0,0 +1,177 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/json_push_parser.hpp>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+namespace {
+
+// Records whether the names and strings it is given are views into the current chunk
+class chunk_view_handler : public json_input_handler
+{
+public:
+    const char* first;
+    const char* last;
+    std::vector<std::pair<std::string,bool>> strings;
+
+    chunk_view_handler()
+        : first(nullptr), last(nullptr)
+    {
+    }
+private:
+    void record(const string_view_type& s)
+    {
+        strings.push_back(std::make_pair(std::string(s.data(), s.length()),
+                                         s.data() >= first && s.data() + s.length() <= last));
+    }
+
+    void do_begin_json() override {}
+    void do_end_json() override {}
+    void do_begin_object(const parsing_context&) override {}
+    void do_end_object(const parsing_context&) override {}
+    void do_begin_array(const parsing_context&) override {}
+    void do_end_array(const parsing_context&) override {}
+    void do_name(const string_view_type& name, const parsing_context&) override
+    {
+        record(name);
+    }
+    void do_null_value(const parsing_context&) override {}
+    void do_string_value(const string_view_type& value, const parsing_context&) override
+    {
+        record(value);
+    }
+    void do_byte_string_value(const uint8_t*, size_t, const parsing_context&) override {}
+    void do_double_value(double, uint8_t, const parsing_context&) override {}
+    void do_integer_value(int64_t, const parsing_context&) override {}
+    void do_uinteger_value(uint64_t, const parsing_context&) override {}
+    void do_bool_value(bool, const parsing_context&) override {}
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE(json_push_parser_tests)
+
+BOOST_AUTO_TEST_CASE(test_push_every_split)
+{
+    std::string text = "{\"name\":\"Jane \\\"J\\\" Roe\",\"items\":[1,-2.5e3,true,null,\"\\u00e9t\\u00e9\"],\"n\":12345678901234567890}";
+    json expected = json::parse(text);
+
+    for (size_t i = 0; i <= text.length(); ++i)
+    {
+        json_decoder<json> decoder;
+        json_push_parser parser(decoder);
+        std::string first = text.substr(0, i);
+        std::string second = text.substr(i);
+        BOOST_CHECK_EQUAL(first.length(), parser.update(first.data(), first.length()));
+        BOOST_CHECK(!parser.done() || second.empty());
+        BOOST_CHECK_EQUAL(second.length(), parser.update(second.data(), second.length()));
+        parser.finish();
+        BOOST_CHECK(parser.done());
+        BOOST_CHECK_EQUAL(expected, decoder.get_result());
+    }
+
+    // One character at a time, from a buffer that is overwritten after each update
+    json_decoder<json> decoder;
+    json_push_parser parser(decoder);
+    char c;
+    for (size_t i = 0; i < text.length(); ++i)
+    {
+        c = text[i];
+        BOOST_CHECK_EQUAL(1, parser.update(&c, 1));
+        c = '!';
+    }
+    parser.finish();
+    BOOST_CHECK_EQUAL(expected, decoder.get_result());
+}
+
+BOOST_AUTO_TEST_CASE(test_push_views_into_chunk)
+{
+    std::string chunk1 = "{\"inside\":\"value\",\"spl";
+    std::string chunk2 = "it\":\"esc\\naped\",\"last\":\"x\"}";
+
+    chunk_view_handler handler;
+    json_push_parser parser(handler);
+    handler.first = chunk1.data();
+    handler.last = chunk1.data() + chunk1.length();
+    parser.update(chunk1.data(), chunk1.length());
+    handler.first = chunk2.data();
+    handler.last = chunk2.data() + chunk2.length();
+    parser.update(chunk2.data(), chunk2.length());
+    parser.finish();
+
+    BOOST_REQUIRE_EQUAL(6, handler.strings.size());
+    BOOST_CHECK(handler.strings[0] == std::make_pair(std::string("inside"), true));
+    BOOST_CHECK(handler.strings[1] == std::make_pair(std::string("value"), true));
+    BOOST_CHECK(handler.strings[2] == std::make_pair(std::string("split"), false));
+    BOOST_CHECK(handler.strings[3] == std::make_pair(std::string("esc\naped"), false));
+    BOOST_CHECK(handler.strings[4] == std::make_pair(std::string("last"), true));
+    BOOST_CHECK(handler.strings[5] == std::make_pair(std::string("x"), true));
+}
+
+BOOST_AUTO_TEST_CASE(test_push_several_texts)
+{
+    std::string chunk1 = "\xEF\xBB\xBF{\"a\":1}\n[2,";
+    std::string chunk2 = "3] {} 4";
+
+    std::vector<json> values;
+    json_decoder<json> decoder;
+    json_push_parser parser(decoder);
+    for (const std::string* chunk : {&chunk1, &chunk2})
+    {
+        const char* p = chunk->data();
+        size_t length = chunk->length();
+        while (length > 0)
+        {
+            size_t n = parser.update(p, length);
+            p += n;
+            length -= n;
+            if (parser.done())
+            {
+                values.push_back(decoder.get_result());
+                parser.reset();
+            }
+        }
+    }
+    parser.finish();
+    values.push_back(decoder.get_result());
+
+    BOOST_REQUIRE_EQUAL(4, values.size());
+    BOOST_CHECK_EQUAL(json::parse("{\"a\":1}"), values[0]);
+    BOOST_CHECK_EQUAL(json::parse("[2,3]"), values[1]);
+    BOOST_CHECK_EQUAL(json::parse("{}"), values[2]);
+    BOOST_CHECK_EQUAL(4, values[3].as<int>());
+}
+
+BOOST_AUTO_TEST_CASE(test_push_errors)
+{
+    {
+        json_decoder<json> decoder;
+        json_push_parser parser(decoder);
+        std::string text = "[1,}";
+        std::error_code ec;
+        parser.update(text.data(), text.length(), ec);
+        BOOST_CHECK(ec);
+    }
+    {
+        json_decoder<json> decoder;
+        json_push_parser parser(decoder);
+        std::string text = "[1,";
+        parser.update(text.data(), text.length());
+        std::error_code ec;
+        parser.finish(ec);
+        BOOST_CHECK(ec == json_parser_errc::unexpected_eof);
+    }
+    {
+        json_decoder<json> decoder;
+        json_push_parser parser(decoder);
+        BOOST_CHECK_THROW(parser.finish(), parse_error);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -247,7 +247,7 @@ BOOST_AUTO_TEST_CASE(test_exception)
     BOOST_CHECK_EXCEPTION(json::parse(input),
                           parse_error,
                           [](const parse_error& e)
-                            {return e.code() == json_parser_errc::unexpected_eof && e.line_number() == 2 && e.column_number() == 9;}
+                            {return e.code() == json_parser_errc::unexpected_eof && e.line_number() == 2 && e.column_number() == 8;}
                          );
 }
 
@@ -0,0 +1,119 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_serialization_cache.hpp>
+#include <sstream>
+#include <string>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(json_serialization_cache_tests)
+
+template <class Json>
+std::string cached_dump(json_serialization_cache<Json>& cache, const Json& val)
+{
+    std::string s;
+    cache.dump(val, s);
+    return s;
+}
+
+template <class Json>
+std::string plain_dump(const Json& val)
+{
+    std::ostringstream os;
+    os << val;
+    return os.str();
+}
+
+BOOST_AUTO_TEST_CASE(test_serialization_cache_reuse)
+{
+    json j = json::parse(R"({"a":{"b":[1,2,{"c":"d"}],"e":{}},"f":[[true,null],[]],"g":1.5})");
+
+    json_serialization_cache<json> cache;
+    BOOST_CHECK_EQUAL(plain_dump(j), cached_dump(cache, j));
+    BOOST_CHECK_EQUAL(0, cache.reused());
+    // The root, a, a.b, a.b[2], f and f[0], not the empty e and f[1]
+    BOOST_CHECK_EQUAL(6, cache.size());
+
+    BOOST_CHECK_EQUAL(plain_dump(j), cached_dump(cache, j));
+    BOOST_CHECK_EQUAL(1, cache.reused());
+    BOOST_CHECK_EQUAL(6, cache.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_serialization_cache_invalidate)
+{
+    json j = json::parse(R"({"a":{"b":[1,2,{"c":"d"}]},"f":[[true,null],{"x":1}]})");
+
+    json_serialization_cache<json> cache;
+    cached_dump(cache, j);
+    BOOST_CHECK_EQUAL(7, cache.size());
+
+    // Modifying a value in a.b[2] forgets it, a.b, a and the root, and keeps f and what is in it
+    j["a"]["b"][2]["c"] = "changed";
+    cache.invalidate(j.at("a").at("b").at(2));
+    BOOST_CHECK_EQUAL(3, cache.size());
+    BOOST_CHECK_EQUAL(plain_dump(j), cached_dump(cache, j));
+    BOOST_CHECK_EQUAL(1, cache.reused());
+    BOOST_CHECK_EQUAL(7, cache.size());
+
+    // Erasing an element moves the elements after it, so what was in f is forgotten too
+    j["f"].erase(j["f"].array_range().begin());
+    cache.invalidate(j.at("f"));
+    BOOST_CHECK_EQUAL(3, cache.size());
+    BOOST_CHECK_EQUAL(plain_dump(j), cached_dump(cache, j));
+    BOOST_CHECK_EQUAL(1, cache.reused());
+
+    // A member inserted into the root
+    j["g"] = json::array{1,2};
+    cache.invalidate(j);
+    BOOST_CHECK_EQUAL(0, cache.size());
+    BOOST_CHECK_EQUAL(plain_dump(j), cached_dump(cache, j));
+
+    cache.clear();
+    BOOST_CHECK_EQUAL(0, cache.size());
+    BOOST_CHECK_EQUAL(plain_dump(j), cached_dump(cache, j));
+}
+
+BOOST_AUTO_TEST_CASE(test_serialization_cache_invalidate_empty)
+{
+    json j = json::parse(R"({"a":[],"b":{"c":{}}})");
+
+    json_serialization_cache<json> cache;
+    BOOST_CHECK_EQUAL(plain_dump(j), cached_dump(cache, j));
+
+    // Containers that were empty have no text, and invalidating them forgets the values
+    // that contain them
+    j["a"].push_back(1);
+    cache.invalidate(j.at("a"));
+    j["b"]["c"]["d"] = 2;
+    cache.invalidate(j.at("b").at("c"));
+    BOOST_CHECK_EQUAL(0, cache.size());
+    BOOST_CHECK_EQUAL(std::string(R"({"a":[1],"b":{"c":{"d":2}}})"), cached_dump(cache, j));
+    BOOST_CHECK_EQUAL(plain_dump(j), cached_dump(cache, j));
+}
+
+BOOST_AUTO_TEST_CASE(test_serialization_cache_options)
+{
+    ojson j = ojson::parse(R"({"z":[1.25,"é"],"a":{"b":0.1}})");
+
+    serialization_options options;
+    options.escape_all_non_ascii(true);
+    json_serialization_cache<ojson> cache(options);
+
+    std::ostringstream expected;
+    j.dump(expected, options);
+    BOOST_CHECK_EQUAL(expected.str(), cached_dump(cache, j));
+
+    std::ostringstream os;
+    cache.dump(j, os);
+    BOOST_CHECK_EQUAL(expected.str(), os.str());
+    BOOST_CHECK_EQUAL(1, cache.reused());
+
+    // Scalars and empty containers are written without keeping anything
+    BOOST_CHECK_EQUAL(std::string("3"), cached_dump(cache, ojson(3)));
+    BOOST_CHECK_EQUAL(std::string("[]"), cached_dump(cache, ojson(ojson::array())));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
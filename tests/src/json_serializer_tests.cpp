@@ -214,6 +214,85 @@ BOOST_AUTO_TEST_CASE(test_serialization_1)
     BOOST_CHECK_EQUAL(expected7,os7.str());
 }
 
+BOOST_AUTO_TEST_CASE(test_escape_string_runs)
+{
+    struct escape_case
+    {
+        std::string text;
+        bool escape_solidus;
+        bool escape_all_non_ascii;
+        std::string expected;
+    };
+    const escape_case cases[] = {
+        {"\"", false, false, "\\\""},
+        {"\\", false, false, "\\\\"},
+        {"\n", false, false, "\\n"},
+        {"\x01", false, false, "\\u0001"},
+        {"\x7f", false, false, "\\u007F"},
+        {"/", false, false, "/"},
+        {"/", true, false, "\\/"},
+        {"\xc3\xa9", false, false, "\xc3\xa9"},
+        {"\xc3\xa9", false, true, "\\u00E9"},
+        {"\xf0\x9f\x98\x80", false, true, "\\uD83D\\uDE00"}
+    };
+
+    // Each case at every position of strings longer and shorter than a vector block
+    for (const auto& c : cases)
+    {
+        serialization_options options;
+        options.escape_solidus(c.escape_solidus);
+        options.escape_all_non_ascii(c.escape_all_non_ascii);
+        for (size_t length = 0; length < 70; ++length)
+        {
+            for (size_t pos = 0; pos <= length; ++pos)
+            {
+                std::string s = std::string(pos, 'a') + c.text + std::string(length - pos, 'b');
+                std::string expected = std::string(pos, 'a') + c.expected + std::string(length - pos, 'b');
+
+                std::ostringstream os;
+                {
+                    buffered_output<char> bos(os);
+                    escape_string<char>(s.data(), s.length(), options, bos);
+                }
+                BOOST_CHECK_EQUAL(expected, os.str());
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_buffered_output_reserve)
+{
+    std::ostringstream os;
+    {
+        buffered_output<char> bos(os, 8);
+        bos.write("abcdef", 6);
+
+        // Not enough room left, the buffer is written out first
+        char* p = bos.reserve(4);
+        *p++ = 'g';
+        *p++ = 'h';
+        bos.commit(p);
+        BOOST_CHECK_EQUAL(std::string("abcdef"), os.str());
+
+        // More than the buffer holds, the buffer grows
+        p = bos.reserve(20);
+        for (int i = 0; i < 20; ++i)
+        {
+            *p++ = static_cast<char>('0' + i % 10);
+        }
+        bos.commit(p);
+        bos.put('!');
+    }
+    BOOST_CHECK_EQUAL(std::string("abcdefgh0123456789012345678" "9!"), os.str());
+
+    // Indentation deeper than the buffer
+    serialization_options options;
+    options.indent(20000);
+    std::ostringstream pretty;
+    json::parse("{\"a\":1}").dump(pretty, options, true);
+    BOOST_CHECK_EQUAL(std::string("{\n") + std::string(20000, ' ') + "\"a\": 1\n}", pretty.str());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
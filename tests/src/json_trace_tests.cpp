@@ -0,0 +1,160 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_reader.hpp>
+#include <jsoncons/json_serializer.hpp>
+#include <jsoncons/json_trace.hpp>
+#include <jsoncons_ext/cbor/cbor_reader.hpp>
+#include <jsoncons_ext/cbor/cbor_serializer.hpp>
+#include <jsoncons_ext/msgpack/msgpack_reader.hpp>
+#include <jsoncons_ext/msgpack/msgpack_serializer.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+namespace {
+
+class recording_tracer : public json_tracer
+{
+public:
+    std::vector<json_trace_record> records;
+private:
+    void do_trace(const json_trace_record& record) override
+    {
+        records.push_back(record);
+    }
+};
+
+const std::string text = "{\"a\":[1,2,{\"b\":null}],\"c\":\"x\"}";
+
+}
+
+BOOST_AUTO_TEST_SUITE(json_trace_tests)
+
+BOOST_AUTO_TEST_CASE(test_trace_json_reader_and_decoder)
+{
+    recording_tracer tracer;
+    std::istringstream is(text);
+    json_decoder<json> decoder;
+    decoder.tracer(&tracer);
+    json_reader reader(is, decoder);
+    reader.tracer(&tracer);
+    reader.buffer_length(8);
+    reader.read();
+
+    BOOST_CHECK(decoder.get_result() == json::parse(text));
+    BOOST_REQUIRE_EQUAL(2, tracer.records.size());
+
+    const json_trace_record& decoded = tracer.records[0];
+    BOOST_CHECK_EQUAL(std::string("json_decoder"), decoded.component);
+    BOOST_CHECK_EQUAL(10, decoded.tokens);
+    BOOST_CHECK_EQUAL(3, decoded.max_depth);
+
+    const json_trace_record& read = tracer.records[1];
+    BOOST_CHECK_EQUAL(std::string("json_reader"), read.component);
+    BOOST_CHECK_EQUAL(text.length(), read.bytes);
+    BOOST_CHECK(read.buffer_refills >= text.length()/8);
+    BOOST_CHECK_EQUAL(3, read.max_depth);
+    BOOST_CHECK(read.io_time <= read.elapsed);
+
+    // Counting for the trace leaves the stats as they are asked for
+    BOOST_CHECK(!decoder.collect_stats());
+}
+
+BOOST_AUTO_TEST_CASE(test_trace_json_serializer)
+{
+    recording_tracer tracer;
+    std::ostringstream os;
+    json_serializer serializer(os);
+    serializer.tracer(&tracer);
+    json::parse(text).dump(serializer);
+
+    BOOST_REQUIRE_EQUAL(1, tracer.records.size());
+    const json_trace_record& record = tracer.records[0];
+    BOOST_CHECK_EQUAL(std::string("json_serializer"), record.component);
+    BOOST_CHECK_EQUAL(os.str().length(), record.bytes);
+    BOOST_CHECK_EQUAL(1, record.buffer_refills);
+    BOOST_CHECK_EQUAL(10, record.tokens);
+    BOOST_CHECK_EQUAL(3, record.max_depth);
+
+    // Batches of integers count one token each
+    tracer.records.clear();
+    std::vector<int64_t> v = {1,2,3,4,5};
+    serializer.begin_json();
+    serializer.begin_array();
+    serializer.integer_values(v.data(), v.size());
+    serializer.end_array();
+    serializer.end_json();
+    BOOST_REQUIRE_EQUAL(1, tracer.records.size());
+    BOOST_CHECK_EQUAL(6, tracer.records[0].tokens);
+    BOOST_CHECK_EQUAL(std::string("[1,2,3,4,5]").length(), tracer.records[0].bytes);
+}
+
+BOOST_AUTO_TEST_CASE(test_trace_cbor_and_msgpack)
+{
+    recording_tracer tracer;
+    json j = json::parse(text);
+
+    std::ostringstream cbor_os;
+    cbor::cbor_serializer cbor_serializer(cbor_os);
+    cbor_serializer.tracer(&tracer);
+    j.dump(cbor_serializer);
+
+    std::ostringstream msgpack_os;
+    msgpack::msgpack_serializer msgpack_serializer(msgpack_os);
+    msgpack_serializer.tracer(&tracer);
+    j.dump(msgpack_serializer);
+
+    BOOST_REQUIRE_EQUAL(2, tracer.records.size());
+    BOOST_CHECK_EQUAL(std::string("cbor_serializer"), tracer.records[0].component);
+    BOOST_CHECK_EQUAL(cbor_os.str().length(), tracer.records[0].bytes);
+    BOOST_CHECK_EQUAL(10, tracer.records[0].tokens);
+    BOOST_CHECK_EQUAL(3, tracer.records[0].max_depth);
+    BOOST_CHECK_EQUAL(std::string("msgpack_serializer"), tracer.records[1].component);
+    BOOST_CHECK_EQUAL(msgpack_os.str().length(), tracer.records[1].bytes);
+    BOOST_CHECK_EQUAL(10, tracer.records[1].tokens);
+    BOOST_CHECK_EQUAL(3, tracer.records[1].max_depth);
+
+    tracer.records.clear();
+    std::istringstream cbor_is(cbor_os.str());
+    json_decoder<json> cbor_decoder;
+    cbor::cbor_reader cbor_reader(cbor_is, cbor_decoder);
+    cbor_reader.tracer(&tracer);
+    cbor_reader.read();
+    BOOST_CHECK(cbor_decoder.get_result() == j);
+
+    std::istringstream msgpack_is(msgpack_os.str());
+    json_decoder<json> msgpack_decoder;
+    msgpack::msgpack_reader msgpack_reader(msgpack_is, msgpack_decoder);
+    msgpack_reader.tracer(&tracer);
+    msgpack_reader.read();
+    BOOST_CHECK(msgpack_decoder.get_result() == j);
+
+    BOOST_REQUIRE_EQUAL(2, tracer.records.size());
+    BOOST_CHECK_EQUAL(std::string("cbor_reader"), tracer.records[0].component);
+    BOOST_CHECK_EQUAL(cbor_os.str().length(), tracer.records[0].bytes);
+    BOOST_CHECK_EQUAL(3, tracer.records[0].max_depth);
+    BOOST_CHECK_EQUAL(std::string("msgpack_reader"), tracer.records[1].component);
+    BOOST_CHECK_EQUAL(msgpack_os.str().length(), tracer.records[1].bytes);
+    BOOST_CHECK_EQUAL(3, tracer.records[1].max_depth);
+}
+
+BOOST_AUTO_TEST_CASE(test_trace_off)
+{
+    recording_tracer tracer;
+    std::istringstream is(text);
+    json_decoder<json> decoder;
+    decoder.tracer(&tracer);
+    decoder.tracer(nullptr);
+    json_reader reader(is, decoder);
+    reader.read();
+    BOOST_CHECK(decoder.get_result() == json::parse(text));
+    BOOST_CHECK(tracer.records.empty());
+    BOOST_CHECK(reader.tracer() == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,160 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_traversal.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(json_traversal_tests)
+
+typedef basic_json<char,copy_on_write_policy,std::allocator<char>> cow_json;
+
+// Arrays nested depth deep, each with a number and, at every other level, an object
+template <class Json>
+Json make_deep(size_t depth)
+{
+    Json root = typename Json::array();
+    Json* p = &root;
+    for (size_t i = 0; i < depth; ++i)
+    {
+        p->push_back(Json(i));
+        if (i % 2 == 1)
+        {
+            Json o;
+            o["k"] = typename Json::array();
+            o["k"].push_back(Json(i));
+            p->push_back(std::move(o));
+        }
+        p->push_back(typename Json::array());
+        p = &(*p)[p->size() - 1];
+    }
+    return root;
+}
+
+template <class Json>
+void check_deep()
+{
+    // Far deeper than the call stack would allow by recursion
+    const size_t depth = 200000;
+    Json j = make_deep<Json>(depth);
+    Json copy = j;
+    BOOST_CHECK(copy == j);
+
+    Json* p = &copy;
+    for (size_t i = 0; i < depth / 2; ++i)
+    {
+        p = &(*p)[p->size() - 1];
+    }
+    p->push_back(Json(true));
+    BOOST_CHECK(copy != j);
+
+    Json assigned;
+    assigned = j;
+    BOOST_CHECK(assigned == j);
+
+    size_t count = 0;
+    size_t max_depth = 0;
+    for (auto it = depth_first(j).begin(); it != depth_first(j).end(); ++it)
+    {
+        ++count;
+        if (it.depth() > max_depth)
+        {
+            max_depth = it.depth();
+        }
+    }
+    // Each level has an array and a number, and every other one an object, its array and number
+    BOOST_CHECK_EQUAL(depth * 2 + (depth / 2) * 3 + 1, count);
+    // The number in the object in the last level
+    BOOST_CHECK_EQUAL(depth + 2, max_depth);
+}
+
+BOOST_AUTO_TEST_CASE(test_deep_copy_compare_destroy)
+{
+    check_deep<json>();
+    check_deep<ojson>();
+    check_deep<cow_json>();
+}
+
+BOOST_AUTO_TEST_CASE(test_copy_compare)
+{
+    json j = json::parse(R"({"a":[1,{"b":[2,3,{"c":null}]},[]],"d":"a string too long for the short string buffer","e":{}})");
+    json copy = j;
+    BOOST_CHECK(copy == j);
+    BOOST_CHECK_EQUAL(j.to_string(), copy.to_string());
+
+    copy["a"][1]["b"][2]["c"] = 1;
+    BOOST_CHECK(copy != j);
+
+    // Members in different orders
+    ojson o1 = ojson::parse(R"({"x":[1,{"y":2,"z":[3]}],"w":true})");
+    ojson o2 = ojson::parse(R"({"w":true,"x":[1,{"z":[3],"y":2}]})");
+    BOOST_CHECK(o1 == o2);
+    ojson o3 = ojson::parse(R"({"w":true,"x":[1,{"z":[4],"y":2}]})");
+    BOOST_CHECK(o1 != o3);
+
+    // Numbers compare by value
+    BOOST_CHECK(json::parse("[[1],{\"a\":[2.0]}]") == json::parse("[[1.0],{\"a\":[2]}]"));
+}
+
+BOOST_AUTO_TEST_CASE(test_depth_first_order)
+{
+    ojson j = ojson::parse(R"({"a":[1,{"b":2}],"c":{"d":[]},"e":3})");
+
+    std::vector<std::string> visited;
+    for (auto it = depth_first(j).begin(); it != depth_first(j).end(); ++it)
+    {
+        std::string entry = std::to_string(it.depth()) + ":";
+        entry += it.is_member() ? std::string(it.key()) : std::to_string(it.index());
+        entry += "=" + it->to_string();
+        visited.push_back(entry);
+    }
+    std::vector<std::string> expected = {
+        "0:0=" + j.to_string(),
+        "1:a=[1,{\"b\":2}]",
+        "2:0=1",
+        "2:1={\"b\":2}",
+        "3:b=2",
+        "1:c={\"d\":[]}",
+        "2:d=[]",
+        "1:e=3"
+    };
+    BOOST_CHECK(expected == visited);
+
+    // A scalar is the only value visited
+    json one(1);
+    size_t count = 0;
+    for (const auto& val : depth_first(one))
+    {
+        BOOST_CHECK_EQUAL(1, val.as<int>());
+        ++count;
+    }
+    BOOST_CHECK_EQUAL(1, count);
+}
+
+BOOST_AUTO_TEST_CASE(test_depth_first_skip_children)
+{
+    json j = json::parse(R"({"a":[1,[2,3]],"b":{"c":4},"d":5})");
+
+    std::vector<std::string> visited;
+    for (auto it = depth_first(j).begin(); it != depth_first(j).end(); ++it)
+    {
+        visited.push_back(it->to_string());
+        if (it.key() == "b")
+        {
+            it.skip_children();
+        }
+        else if (it.parent() != nullptr && it.parent()->is_array() && it->is_array())
+        {
+            it.skip_children();
+        }
+    }
+    std::vector<std::string> expected = {j.to_string(), "[1,[2,3]]", "1", "[2,3]", "{\"c\":4}", "5"};
+    BOOST_CHECK(expected == visited);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
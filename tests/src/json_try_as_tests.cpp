@@ -0,0 +1,129 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/jsonpointer/jsonpointer.hpp>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(json_try_as_tests)
+
+BOOST_AUTO_TEST_CASE(test_try_as)
+{
+    json j = json::parse(R"({"id":42,"price":10,"ratio":0.5,"name":"widget","tags":["a","b"],"big":300})");
+    std::error_code ec;
+
+    BOOST_CHECK_EQUAL(42, j["id"].try_as<int>(ec));
+    BOOST_CHECK(!ec);
+    BOOST_CHECK_EQUAL(std::string("widget"), j["name"].try_as<std::string>(ec));
+    BOOST_CHECK(!ec);
+    // Integers convert to floating point
+    BOOST_CHECK_EQUAL(10.0, j["price"].try_as<double>(ec));
+    BOOST_CHECK(!ec);
+    std::vector<std::string> tags = j["tags"].try_as<std::vector<std::string>>(ec);
+    BOOST_CHECK(!ec);
+    BOOST_CHECK_EQUAL(2, tags.size());
+
+    BOOST_CHECK_EQUAL(0, j["name"].try_as<int>(ec));
+    BOOST_CHECK(ec == json_errc::not_convertible);
+    BOOST_CHECK_EQUAL(0, j["big"].try_as<int8_t>(ec));
+    BOOST_CHECK(ec == json_errc::not_convertible);
+    BOOST_CHECK(j["tags"].try_as<std::vector<int>>(ec).empty());
+    BOOST_CHECK(ec == json_errc::not_convertible);
+
+    // A missing member
+    BOOST_CHECK_EQUAL(0, j["missing"].try_as<int>(ec));
+    BOOST_CHECK(ec == json_errc::key_not_found);
+    BOOST_CHECK_EQUAL(std::string(), j["missing"]["deeper"].try_as<std::string>(ec));
+    BOOST_CHECK(ec == json_errc::key_not_found);
+    BOOST_CHECK_EQUAL(std::string("Key not found"), ec.message());
+}
+
+BOOST_AUTO_TEST_CASE(test_at_with_error_code)
+{
+    json j = json::parse(R"({"a":{"b":[1,2,3]},"s":"text"})");
+    std::error_code ec;
+
+    const json& b = j.at("a", ec).at("b", ec);
+    BOOST_CHECK(!ec);
+    BOOST_CHECK_EQUAL(3, b.at(2, ec).as<int>());
+    BOOST_CHECK(!ec);
+
+    BOOST_CHECK(b.at(3, ec).is_null());
+    BOOST_CHECK(ec == json_errc::index_out_of_range);
+    BOOST_CHECK(j.at("x", ec).is_null());
+    BOOST_CHECK(ec == json_errc::key_not_found);
+    BOOST_CHECK(j.at("s", ec).at("t", ec).is_null());
+    BOOST_CHECK(ec == json_errc::not_an_object);
+    BOOST_CHECK(j.at("s", ec).at(0, ec).is_null());
+    BOOST_CHECK(ec == json_errc::not_an_array);
+    BOOST_CHECK(json().at("x", ec).is_null());
+    BOOST_CHECK(ec == json_errc::key_not_found);
+
+    BOOST_CHECK_EQUAL(2, j["a"]["b"].at(1, ec).as<int>());
+    BOOST_CHECK(!ec);
+    BOOST_CHECK(j["a"]["c"].at(1, ec).is_null());
+    BOOST_CHECK(ec == json_errc::key_not_found);
+}
+
+#if defined(JSONCONS_HAS_OPTIONAL)
+BOOST_AUTO_TEST_CASE(test_as_optional)
+{
+    json j = json::parse(R"({"id":42,"name":"widget"})");
+    BOOST_CHECK(j["id"].as_optional<int>() == 42);
+    BOOST_CHECK(!j["name"].as_optional<int>());
+    BOOST_CHECK(!j["missing"].as_optional<int>());
+    BOOST_CHECK(j.at("name").as_optional<std::string>() == std::string("widget"));
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(test_jsonpointer_get_with_error_code)
+{
+    json j = json::parse(R"({"a":{"b":[1,2,3]}})");
+    std::error_code ec;
+
+    json val = jsonpointer::get(j, "/a/b/1", ec);
+    BOOST_CHECK(!ec);
+    BOOST_CHECK_EQUAL(2, val.as<int>());
+
+    val = jsonpointer::get(j, "/a/c", ec);
+    BOOST_CHECK(ec == jsonpointer::jsonpointer_errc::name_not_found);
+    BOOST_CHECK(val.is_null());
+
+    val = jsonpointer::get(j, jsonpointer::json_pointer("/a/b/7"), ec);
+    BOOST_CHECK(ec == jsonpointer::jsonpointer_errc::index_exceeds_array_size);
+    val = jsonpointer::get(j, jsonpointer::json_pointer("/a/b/0"), ec);
+    BOOST_CHECK(!ec);
+    BOOST_CHECK_EQUAL(1, val.as<int>());
+}
+
+BOOST_AUTO_TEST_CASE(test_cbor_view_at_with_error_code)
+{
+    json j = json::parse(R"({"a":[1,2,3],"b":"text"})");
+    std::vector<uint8_t> buffer;
+    cbor::encode_cbor(j, buffer);
+    std::error_code ec;
+
+    for (const cbor::cbor_view& v : {cbor::cbor_view(buffer), cbor::cbor_view(buffer).indexed()})
+    {
+        cbor::cbor_view a = v.at("a", ec);
+        BOOST_CHECK(!ec);
+        BOOST_CHECK_EQUAL(3, a.at(2, ec).as<int64_t>());
+        BOOST_CHECK(!ec);
+
+        v.at("c", ec);
+        BOOST_CHECK(ec == json_errc::key_not_found);
+        a.at(3, ec);
+        BOOST_CHECK(ec == json_errc::index_out_of_range);
+        a.at("x", ec);
+        BOOST_CHECK(ec == json_errc::not_an_object);
+        v.at("b", ec).at(0, ec);
+        BOOST_CHECK(ec == json_errc::not_an_array);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
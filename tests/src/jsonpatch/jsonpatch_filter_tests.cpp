@@ -0,0 +1,154 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_reader.hpp>
+#include <jsoncons/json_serializer.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/cbor/cbor_serializer.hpp>
+#include <jsoncons_ext/jsonpatch/jsonpatch_filter.hpp>
+
+using namespace jsoncons;
+using namespace jsoncons::literals;
+
+BOOST_AUTO_TEST_SUITE(jsonpatch_filter_tests)
+
+// Reads source through a patch_filter into a json
+json stream_patch(const std::string& source, const json& patch,
+                  jsonpatch::jsonpatch_errc& ec, std::string& path)
+{
+    json_decoder<json> decoder;
+    jsonpatch::patch_filter<json> filter(patch, decoder);
+    std::istringstream is(source);
+    json_reader reader(is, filter);
+    reader.read();
+    std::tie(ec,path) = filter.error();
+    return decoder.get_result();
+}
+
+void check_stream_patch(const std::string& source, const json& patch)
+{
+    json expected = json::parse(source);
+    jsonpatch::jsonpatch_errc ec;
+    std::string path;
+    std::tie(ec,path) = jsonpatch::patch(expected, patch);
+    BOOST_REQUIRE(ec == jsonpatch::jsonpatch_errc());
+
+    json result = stream_patch(source, patch, ec, path);
+    BOOST_CHECK(ec == jsonpatch::jsonpatch_errc());
+    BOOST_CHECK_EQUAL(expected, result);
+}
+
+BOOST_AUTO_TEST_CASE(test_add_remove_replace)
+{
+    std::string source = R"({"baz":"qux","foo":"bar","list":[1,2,3],"nested":{"a":{"b":[true,false]}}})";
+
+    check_stream_patch(source, R"([{"op":"add","path":"/hello","value":["world"]}])"_json);
+    check_stream_patch(source, R"([{"op":"add","path":"/foo","value":{"x":1}}])"_json);
+    check_stream_patch(source, R"([{"op":"remove","path":"/baz"}])"_json);
+    check_stream_patch(source, R"([{"op":"replace","path":"/nested/a","value":null}])"_json);
+    check_stream_patch(source, R"([{"op":"replace","path":"/list/1","value":[20,21]}])"_json);
+    check_stream_patch(source, R"([{"op":"add","path":"/list/0","value":0}])"_json);
+    check_stream_patch(source, R"([{"op":"add","path":"/list/3","value":4}])"_json);
+    check_stream_patch(source, R"([{"op":"add","path":"/list/-","value":4}])"_json);
+    check_stream_patch(source, R"([{"op":"remove","path":"/nested/a/b/0"}])"_json);
+    check_stream_patch(source, R"([{"op":"remove","path":"/list"},{"op":"add","path":"/nested/a/c","value":"d"}])"_json);
+
+    // The whole document
+    jsonpatch::jsonpatch_errc ec;
+    std::string path;
+    json result = stream_patch(source, R"([{"op":"replace","path":"","value":[1]}])"_json, ec, path);
+    BOOST_CHECK(ec == jsonpatch::jsonpatch_errc());
+    BOOST_CHECK_EQUAL(json::parse("[1]"), result);
+}
+
+BOOST_AUTO_TEST_CASE(test_indices_of_source)
+{
+    // Indices are those of the source document, not of the document as patched so far
+    std::string source = R"(["a","b","c","d"])";
+    json patch = R"([{"op":"remove","path":"/1"},{"op":"replace","path":"/2","value":"C"},{"op":"add","path":"/3","value":"x"},{"op":"add","path":"/-","value":"e"},{"op":"add","path":"/-","value":"f"}])"_json;
+
+    jsonpatch::jsonpatch_errc ec;
+    std::string path;
+    json result = stream_patch(source, patch, ec, path);
+    BOOST_CHECK(ec == jsonpatch::jsonpatch_errc());
+    BOOST_CHECK_EQUAL(json::parse(R"(["a","C","x","d","e","f"])"), result);
+}
+
+BOOST_AUTO_TEST_CASE(test_serializer)
+{
+    std::string source = R"({"a":[1,{"b":2}],"c":"d"})";
+    json patch = R"([{"op":"replace","path":"/a/1/b","value":[3,4]},{"op":"remove","path":"/c"},{"op":"add","path":"/e","value":{"f":null}}])"_json;
+
+    std::ostringstream os;
+    json_serializer serializer(os);
+    jsonpatch::patch_filter<json> filter(patch, serializer);
+    std::istringstream is(source);
+    json_reader reader(is, filter);
+    reader.read();
+    BOOST_CHECK(std::get<0>(filter.error()) == jsonpatch::jsonpatch_errc());
+    BOOST_CHECK_EQUAL(std::string(R"({"a":[1,{"b":[3,4]}],"e":{"f":null}})"), os.str());
+}
+
+BOOST_AUTO_TEST_CASE(test_cbor_transcoding)
+{
+    std::string source = R"({"name":"x","values":[1.5,2.5,3.5],"tags":["a","b"]})";
+    json patch = R"([{"op":"replace","path":"/values/2","value":-1},{"op":"add","path":"/tags/-","value":"c"}])"_json;
+
+    std::ostringstream os;
+    cbor::cbor_serializer serializer(os);
+    jsonpatch::patch_filter<json> filter(patch, serializer);
+    std::istringstream is(source);
+    json_reader reader(is, filter);
+    reader.read();
+
+    json expected = json::parse(source);
+    jsonpatch::patch(expected, patch);
+    std::string s = os.str();
+    std::vector<uint8_t> buffer(s.begin(), s.end());
+    BOOST_CHECK_EQUAL(expected, cbor::decode_cbor<json>(cbor::cbor_view(buffer)));
+}
+
+BOOST_AUTO_TEST_CASE(test_errors)
+{
+    jsonpatch::jsonpatch_errc ec;
+    std::string path;
+    std::string source = R"({"a":[1,2],"b":{}})";
+
+    // Values that are not in the document
+    json result = stream_patch(source, R"([{"op":"remove","path":"/x"},{"op":"add","path":"/c","value":3}])"_json, ec, path);
+    BOOST_CHECK(ec == jsonpatch::jsonpatch_errc::remove_failed);
+    BOOST_CHECK_EQUAL(std::string("/x"), path);
+    BOOST_CHECK_EQUAL(json::parse(R"({"a":[1,2],"b":{},"c":3})"), result);
+
+    stream_patch(source, R"([{"op":"replace","path":"/a/5","value":3}])"_json, ec, path);
+    BOOST_CHECK(ec == jsonpatch::jsonpatch_errc::replace_failed);
+    BOOST_CHECK_EQUAL(std::string("/a/5"), path);
+
+    stream_patch(source, R"([{"op":"add","path":"/b/c/d","value":3}])"_json, ec, path);
+    BOOST_CHECK(ec == jsonpatch::jsonpatch_errc::add_failed);
+
+    // Operations that cannot be applied in a stream leave the document unchanged
+    result = stream_patch(source, R"([{"op":"remove","path":"/a"},{"op":"replace","path":"/a/0","value":3}])"_json, ec, path);
+    BOOST_CHECK(ec == jsonpatch::jsonpatch_errc::replace_failed);
+    BOOST_CHECK_EQUAL(std::string("/a/0"), path);
+    BOOST_CHECK_EQUAL(json::parse(source), result);
+
+    stream_patch(source, R"([{"op":"move","from":"/a","path":"/c"}])"_json, ec, path);
+    BOOST_CHECK(ec == jsonpatch::jsonpatch_errc::invalid_patch);
+
+    stream_patch(source, R"([{"op":"remove","path":""}])"_json, ec, path);
+    BOOST_CHECK(ec == jsonpatch::jsonpatch_errc::remove_failed);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
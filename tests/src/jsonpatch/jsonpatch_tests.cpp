@@ -434,6 +434,47 @@ BOOST_AUTO_TEST_CASE(test_move_copy_replace_remove_fail)
 
 }
 
+// Removed and replaced values are moved out of the target and moved back when a later
+// operation fails, replaced object members keep their place
+BOOST_AUTO_TEST_CASE(test_undo_moved_values)
+{
+    ojson target = ojson::parse(R"(
+        {
+            "a": {"x": [1,2,3], "y": {"z": "deep"}},
+            "b": [{"c": 1}, {"d": 2}],
+            "e": "last"
+        }
+    )");
+
+    ojson patch = ojson::parse(R"(
+        [
+            { "op": "remove", "path": "/a/y" },
+            { "op": "replace", "path": "/b/0", "value": "replaced" },
+            { "op": "move", "from": "/a/x", "path": "/e" },
+            { "op": "move", "from": "/b/1", "path": "/b/0" },
+            { "op": "add", "path": "/a", "value": 5 },
+            { "op": "copy", "from": "/e", "path": "/f" },
+            { "op": "test", "path": "/f", "value": [1,2,3] },
+            { "op": "test", "path": "/e", "value": "last" } // fails
+        ]
+    )");
+
+    ojson expected = target;
+
+    jsonpatch::jsonpatch_errc ec;
+    std::string path;
+    std::tie(ec,path) = jsonpatch::patch(target,patch);
+    BOOST_CHECK(ec == jsonpatch::jsonpatch_errc::test_failed);
+    BOOST_CHECK_EQUAL(std::string("/e"),path);
+    BOOST_CHECK_EQUAL(expected,target);
+    BOOST_CHECK_EQUAL(expected.to_string(),target.to_string());
+
+    patch.erase(patch.array_range().end()-1);
+    std::tie(ec,path) = jsonpatch::patch(target,patch);
+    BOOST_CHECK(ec == jsonpatch::jsonpatch_errc());
+    BOOST_CHECK_EQUAL(ojson::parse(R"({"a":5,"b":[{"d":2},"replaced"],"e":[1,2,3],"f":[1,2,3]})"),target);
+}
+
 BOOST_AUTO_TEST_CASE(test_diff1)
 {
     json source = R"(
@@ -500,6 +541,208 @@ BOOST_AUTO_TEST_CASE(add_when_new_items_in_target_array2)
     check_patch(source,patch,jsonpatch::jsonpatch_errc(),target);
 }
 
+BOOST_AUTO_TEST_CASE(test_diff_remove_from_end)
+{
+    json source = json::parse(R"({"foo":[1,2,3,4,5]})");
+    json target = json::parse(R"({"foo":[1,2]})");
+
+    auto patch = jsonpatch::diff(source, target);
+    BOOST_CHECK_EQUAL(json::parse(R"([{"op":"remove","path":"/foo/4"},{"op":"remove","path":"/foo/3"},{"op":"remove","path":"/foo/2"}])"),patch);
+
+    check_patch(source,patch,jsonpatch::jsonpatch_errc(),target);
+}
+
+BOOST_AUTO_TEST_CASE(test_minimal_array_diff)
+{
+    json source = json::array();
+    for (int i = 0; i < 10000; ++i)
+    {
+        source.push_back(i);
+    }
+    json target = source;
+    target.insert(target.array_range().begin(), -1);
+    target.erase(target.array_range().begin()+5001);
+
+    auto patch = jsonpatch::diff(source, target, jsonpatch::array_diff::minimal);
+    BOOST_CHECK_EQUAL(json::parse(R"([{"op":"add","path":"/0","value":-1},{"op":"remove","path":"/5001"}])"),patch);
+    check_patch(source,patch,jsonpatch::jsonpatch_errc(),target);
+
+    // Changed elements are diffed in place
+    json source2 = json::parse(R"({"a":[{"id":1,"v":"x"},{"id":2,"v":"y"},{"id":3,"v":"z"}]})");
+    json target2 = json::parse(R"({"a":[{"id":0},{"id":1,"v":"x"},{"id":2,"v":"w"},{"id":3,"v":"z"}]})");
+    patch = jsonpatch::diff(source2, target2, jsonpatch::array_diff::minimal);
+    BOOST_CHECK_EQUAL(json::parse(R"([{"op":"add","path":"/a/0","value":{"id":0}},{"op":"replace","path":"/a/2/v","value":"w"}])"),patch);
+    check_patch(source2,patch,jsonpatch::jsonpatch_errc(),target2);
+}
+
+BOOST_AUTO_TEST_CASE(test_minimal_array_diff_random)
+{
+    std::srand(7);
+    for (int t = 0; t < 200; ++t)
+    {
+        json source = json::array();
+        json target = json::array();
+        size_t n = std::rand() % 30;
+        size_t m = std::rand() % 30;
+        for (size_t i = 0; i < n; ++i)
+        {
+            source.push_back(std::rand() % 5);
+        }
+        for (size_t i = 0; i < m; ++i)
+        {
+            target.push_back(std::rand() % 5);
+        }
+
+        // No more operations than the edits that a longest common subsequence leaves
+        std::vector<std::vector<size_t>> lcs(n+1, std::vector<size_t>(m+1, 0));
+        for (size_t i = 1; i <= n; ++i)
+        {
+            for (size_t j = 1; j <= m; ++j)
+            {
+                lcs[i][j] = source[i-1] == target[j-1] ? lcs[i-1][j-1] + 1 : (std::max)(lcs[i-1][j], lcs[i][j-1]);
+            }
+        }
+
+        BOOST_CHECK_EQUAL(lcs[n][m], jsonpatch::detail::array_lcs<json>(source, target).matches().size());
+
+        auto patch = jsonpatch::diff(source, target, jsonpatch::array_diff::minimal);
+        BOOST_CHECK(patch.size() <= n + m - 2*lcs[n][m]);
+        check_patch(source,patch,jsonpatch::jsonpatch_errc(),target);
+    }
+}
+
+template <class Json>
+Json random_value(size_t depth)
+{
+    switch (depth == 0 ? std::rand() % 3 : std::rand() % 5)
+    {
+    case 0:
+        return Json(std::rand() % 4);
+    case 1:
+        return Json("s" + std::to_string(std::rand() % 4));
+    case 2:
+        return Json::null();
+    case 3:
+        {
+            Json a = typename Json::array();
+            size_t n = std::rand() % 40;
+            for (size_t i = 0; i < n; ++i)
+            {
+                a.push_back(random_value<Json>(depth - 1));
+            }
+            return a;
+        }
+    default:
+        {
+            Json o;
+            size_t n = std::rand() % 40;
+            for (size_t i = 0; i < n; ++i)
+            {
+                o.insert_or_assign("k" + std::to_string(std::rand() % 50), random_value<Json>(depth - 1));
+            }
+            return o;
+        }
+    }
+}
+
+// Changes, adds and removes values at random
+template <class Json>
+void mutate(Json& val, size_t depth)
+{
+    if (val.is_array())
+    {
+        for (size_t i = 0; i < val.size(); ++i)
+        {
+            switch (std::rand() % 20)
+            {
+            case 0:
+                val[i] = random_value<Json>(depth);
+                break;
+            case 1:
+                val.erase(val.array_range().begin() + i);
+                break;
+            case 2:
+                val.insert(val.array_range().begin() + i, random_value<Json>(depth));
+                break;
+            default:
+                mutate(val[i], depth);
+                break;
+            }
+        }
+    }
+    else if (val.is_object())
+    {
+        std::vector<std::string> keys;
+        for (const auto& member : val.object_range())
+        {
+            keys.push_back(std::string(member.key()));
+        }
+        for (const auto& key : keys)
+        {
+            switch (std::rand() % 20)
+            {
+            case 0:
+                val.erase(key);
+                break;
+            case 1:
+                val[key + "x"] = random_value<Json>(depth);
+                break;
+            default:
+                mutate(val.at(key), depth);
+                break;
+            }
+        }
+    }
+}
+
+template <class Json>
+void check_parallel_diff()
+{
+    std::srand(11);
+    for (int t = 0; t < 20; ++t)
+    {
+        Json source = typename Json::array();
+        for (size_t i = 0; i < 200; ++i)
+        {
+            source.push_back(random_value<Json>(3));
+        }
+        Json doc;
+        doc["records"] = source;
+        doc["config"] = random_value<Json>(3);
+        Json target = doc;
+        mutate(target, 2);
+
+        for (auto mode : {jsonpatch::array_diff::by_position, jsonpatch::array_diff::minimal})
+        {
+            Json expected = jsonpatch::diff(doc, target, mode);
+            for (size_t threads : {2, 3, 8})
+            {
+                Json patch = jsonpatch::diff(doc, target, mode, parallel_array_options().max_threads(threads));
+                BOOST_CHECK(expected == patch);
+            }
+            Json patched = doc;
+            jsonpatch::jsonpatch_errc ec;
+            std::string path;
+            std::tie(ec,path) = jsonpatch::patch(patched, expected);
+            BOOST_CHECK(ec == jsonpatch::jsonpatch_errc());
+            BOOST_CHECK(patched == target);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_diff)
+{
+    check_parallel_diff<json>();
+    check_parallel_diff<ojson>();
+
+    // Values that are not arrays or objects, and arrays of other sizes
+    json a = json::parse(R"([1,{"a":[1,2,3]},3])");
+    json b = json::parse(R"([1,{"a":[1,2,4,5]}])");
+    BOOST_CHECK(jsonpatch::diff(a, b) == jsonpatch::diff(a, b, parallel_array_options().max_threads(4)));
+    BOOST_CHECK(jsonpatch::diff(json(1), json("x")) == jsonpatch::diff(json(1), json("x"), parallel_array_options().max_threads(4)));
+    BOOST_CHECK_EQUAL(0, jsonpatch::diff(a, a, parallel_array_options().max_threads(4)).size());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
@@ -0,0 +1,145 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_reader.hpp>
+#include <jsoncons_ext/jsonpath/json_query.hpp>
+#include <jsoncons_ext/jsonpath/json_stream_selector.hpp>
+
+using namespace jsoncons;
+using namespace jsoncons::jsonpath;
+
+BOOST_AUTO_TEST_SUITE(json_stream_selector_tests)
+
+const std::string store_text = R"(
+{
+    "store": {
+        "book": [
+            {
+                "category": "reference",
+                "author": "Nigel Rees",
+                "title": "Sayings of the Century",
+                "price": 8.95
+            },
+            {
+                "category": "fiction",
+                "author": "Evelyn Waugh",
+                "title": "Sword of Honour",
+                "price": 12.99
+            },
+            {
+                "category": "fiction",
+                "author": "Herman Melville",
+                "title": "Moby Dick",
+                "isbn": "0-553-21311-3",
+                "price": 8.99
+            }
+        ],
+        "bicycle": {
+            "color": "red",
+            "price": 19.95
+        }
+    }
+}
+)";
+
+json stream_query(const std::string& text, const std::string& path)
+{
+    json result = json::array();
+    json_stream_selector<json> selector(path, [&](const json& val){result.push_back(val);});
+    std::istringstream is(text);
+    json_reader reader(is, selector);
+    reader.read();
+    return result;
+}
+
+BOOST_AUTO_TEST_CASE(test_names_and_wildcards)
+{
+    BOOST_CHECK_EQUAL(json::parse(R"(["Nigel Rees","Evelyn Waugh","Herman Melville"])"),
+                      stream_query(store_text, "$.store.book[*].author"));
+    BOOST_CHECK_EQUAL(json::parse(R"(["Nigel Rees","Evelyn Waugh","Herman Melville"])"),
+                      stream_query(store_text, "$['store']['book'].*[\"author\"]"));
+    BOOST_CHECK_EQUAL(json::parse(R"(["Sword of Honour"])"),
+                      stream_query(store_text, "$.store.book[1].title"));
+    BOOST_CHECK_EQUAL(json::parse(R"(["Moby Dick"])"),
+                      stream_query(store_text, "$.store.book.2.title"));
+    BOOST_CHECK_EQUAL(json::parse(R"(["Sayings of the Century","Moby Dick"])"),
+                      stream_query(store_text, "$.store.book[0, 2].title"));
+    BOOST_CHECK_EQUAL(json::parse(R"([{"color":"red","price":19.95}])"),
+                      stream_query(store_text, "$.store.bicycle"));
+    BOOST_CHECK_EQUAL(json(json::array()), stream_query(store_text, "$.store.book[3]"));
+
+    json root = json::parse(store_text);
+    BOOST_CHECK_EQUAL(json_query(root,"$"), stream_query(store_text, "$"));
+}
+
+// Matches are in document order
+BOOST_AUTO_TEST_CASE(test_recursive_descent)
+{
+    BOOST_CHECK_EQUAL(json::parse(R"([8.95,12.99,8.99,19.95])"),
+                      stream_query(store_text, "$..price"));
+    BOOST_CHECK_EQUAL(json::parse(R"(["Herman Melville"])"),
+                      stream_query(store_text, "$..book[2].author"));
+    BOOST_CHECK_EQUAL(json::parse(R"([[1,[2]],1,[2],2,{"a":[3]},[3],3,4])"),
+                      stream_query(R"([[1,[2]],{"a":[3]},4])", "$..*"));
+}
+
+// An outer match is passed before the matches nested in it
+BOOST_AUTO_TEST_CASE(test_nested_matches)
+{
+    std::string text = R"({"id":1,"child":{"id":{"id":2},"other":[{"id":3}]}})";
+
+    BOOST_CHECK_EQUAL(json::parse(R"([1,{"id":2},2,3])"), stream_query(text, "$..id"));
+    BOOST_CHECK_EQUAL(json::parse(R"([{"id":{"id":2},"other":[{"id":3}]},{"id":3}])"),
+                      stream_query(text, "$..['child',0]"));
+}
+
+// Each path gets the same matches as it does alone
+BOOST_AUTO_TEST_CASE(test_several_paths)
+{
+    std::vector<std::string> paths = {"$.store.book[*].author", "$.store.book[1].title", "$..price",
+                                      "$.store.bicycle", "$['store']['book'].*['author']", "$", "$.store..color"};
+
+    std::vector<json> results(paths.size(), json::array());
+    std::vector<json_stream_selector<json>::string_view_type> views(paths.begin(), paths.end());
+    json_stream_selector<json> selector(views, [&](size_t index, const json& val){results[index].push_back(val);});
+    std::istringstream is(store_text);
+    json_reader reader(is, selector);
+    reader.read();
+
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(stream_query(store_text, paths[i]), results[i]);
+    }
+    BOOST_CHECK_EQUAL(json::parse(R"(["red"])"), results[6]);
+}
+
+BOOST_AUTO_TEST_CASE(test_unsupported_path)
+{
+    BOOST_CHECK_THROW(stream_query(store_text, "$.store.book[?(@.price < 10)]"), parse_error);
+    BOOST_CHECK_THROW(stream_query(store_text, "$.store.book[-1]"), parse_error);
+    BOOST_CHECK_THROW(stream_query(store_text, "$.store.book[0:2]"), parse_error);
+    BOOST_CHECK_THROW(stream_query(store_text, "store.book"), parse_error);
+    BOOST_CHECK_THROW(stream_query(store_text, "$.store.book[0"), parse_error);
+
+    try
+    {
+        json_stream_selector<json> selector("$.store.book[?(@.price < 10)]", [](const json&){});
+        BOOST_FAIL("Expected parse_error");
+    }
+    catch (const parse_error& e)
+    {
+        BOOST_CHECK(e.code() == jsonpath_parser_errc::unsupported_in_stream);
+        BOOST_CHECK_EQUAL(14,e.column_number());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -493,5 +493,64 @@ BOOST_AUTO_TEST_CASE(test_jsonpath_filter_regex)
     BOOST_CHECK_EQUAL(json(true),result3);
 }
 
+#if defined(__GNUC__) && (__GNUC__ == 4 && __GNUC_MINOR__ < 9)
+BOOST_AUTO_TEST_CASE_EXPECTED_FAILURES(test_jsonpath_filter_regex_cache, 3)
+#endif
+
+// Filters with the same pattern and flags share the compiled pattern
+BOOST_AUTO_TEST_CASE(test_jsonpath_filter_regex_cache)
+{
+    auto& cache = regex_cache<char>::instance();
+    auto re1 = cache.get("Sword.*", std::regex_constants::ECMAScript);
+    auto re2 = cache.get("Sword.*", std::regex_constants::ECMAScript);
+    auto re3 = cache.get("Sword.*", std::regex_constants::ECMAScript | std::regex_constants::icase);
+    BOOST_CHECK(re1 == re2);
+    BOOST_CHECK(re1 != re3);
+
+    json books = json::parse(R"([{"title":"Sword of Honour","id":12},{"title":"Moby Dick","id":7},{"id":"x"}])");
+    BOOST_CHECK_EQUAL(json::parse(R"([{"title":"Sword of Honour","id":12}])"), json_query(books, "$[?(@.title =~ /sword.*/i)]"));
+    BOOST_CHECK_EQUAL(json::parse(R"([{"title":"Moby Dick","id":7}])"), json_query(books, "$[?(@.id =~ /[0-9]/ && !(@.title =~ /Sword.*/))]"));
+}
+
+// exists on a filter of member comparisons agrees with eval, which evaluates it by tokens
+BOOST_AUTO_TEST_CASE(test_jsonpath_filter_member_comparisons)
+{
+    const char* pend;
+    jsonpath_filter_parser<json> parser;
+
+    json contexts = json::parse(R"(
+    [
+        {"price":8.95,"qty":2,"name":"a","item":{"size":3}},
+        {"price":12,"qty":0,"name":"b","item":{"size":"large"}},
+        {"price":"unknown","name":"c"},
+        {"price":10,"qty":-1,"item":[{"size":3}],"tags":["x","y"]},
+        {"qty":5,"item":{"size":null},"tags":[]},
+        {"price":10.0,"qty":1,"item":"small"}
+    ]
+    )");
+
+    std::vector<std::string> exprs = {
+        "(@.price < 10)", "(@.price <= 10)", "(@.price > 10)", "(@.price >= 10)",
+        "(@.price == 10)", "(@.price != 10)", "(10 > @.price)", "(@.name == 'b')",
+        "(@.price < 10 && @.qty > 0)", "(@.price < 10 || @.qty > 0)", "(!(@.qty > 0))",
+        "(!@.qty)", "(@.item.size == 3)", "(@.item.size != null)", "(@.tags.length > 1)",
+        "(@.item.0.size == 3 || @.name == 'a')", "(@.qty > 0 && !(@.item.size == 'large'))",
+        "(@.name =~ /[ab]/)", "(@.price =~ /1.*/ || @.item.size =~ /l.*/)"
+    };
+    for (const auto& expr : exprs)
+    {
+        auto filter = parser.parse(expr.c_str(), expr.c_str() + expr.length(), &pend);
+        for (const auto& context : contexts.array_range())
+        {
+            BOOST_CHECK_MESSAGE(filter.eval(context).as_bool() == filter.exists(context), expr << " " << context);
+        }
+    }
+
+    json books = json::parse(R"([{"price":8},{"price":12,"qty":1},{"qty":3},{"price":5,"qty":0}])");
+    BOOST_CHECK_EQUAL(json::parse(R"([{"price":12,"qty":1}])"), json_query(books, "$[?(@.price > 10 && @.qty > 0)]"));
+    BOOST_CHECK_EQUAL(json::parse(R"([{"price":8},{"price":5,"qty":0}])"), json_query(books, "$[?(@.price < 10)]"));
+    BOOST_CHECK_EQUAL(json::parse(R"([{"price":8},{"qty":3}])"), json_query(books, "$[?(!@.qty || @.qty > 2)]"));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
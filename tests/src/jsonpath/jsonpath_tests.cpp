@@ -1108,6 +1108,48 @@ BOOST_AUTO_TEST_CASE(test_replace)
     //std::cout << ("2\n") << pretty_print(j) << std::endl;
 }
 
+BOOST_AUTO_TEST_CASE(test_transform)
+{
+    json j = json::parse(R"(
+{"store": {"book": [{"price": 10.0}, {"price": 20.0, "sale": {"price": 5.0}}], "price": 1.0}}
+    )");
+
+    json_transform(j, "$..price", [](json& price) {price = price.as<double>() * 2;});
+    BOOST_CHECK_EQUAL(20.0, j["store"]["book"][0]["price"].as<double>());
+    BOOST_CHECK_EQUAL(40.0, j["store"]["book"][1]["price"].as<double>());
+    BOOST_CHECK_EQUAL(10.0, j["store"]["book"][1]["sale"]["price"].as<double>());
+    BOOST_CHECK_EQUAL(2.0, j["store"]["price"].as<double>());
+
+    // A value selected more than once is transformed once
+    size_t count = 0;
+    json_transform(j, "$.store.book[0,0,1].price", [&](json& price) {price = price.as<double>() + 1; ++count;});
+    BOOST_CHECK_EQUAL(2, count);
+    BOOST_CHECK_EQUAL(21.0, j["store"]["book"][0]["price"].as<double>());
+
+    // Values that are not part of the root are not passed to the callback
+    count = 0;
+    json_transform(j, "$.store.book.length", [&](json&) {++count;});
+    BOOST_CHECK_EQUAL(0, count);
+
+    // The parts of a value are visited before it, so replacing it leaves nothing dangling
+    json nested = json::parse(R"({"b": {"b": {"b": 1}}})");
+    std::vector<std::string> visited;
+    json_transform(nested, "$..b", [&](json& val) 
+    {
+        visited.push_back(val.to_string());
+        val = visited.size();
+    });
+    BOOST_REQUIRE_EQUAL(3, visited.size());
+    BOOST_CHECK_EQUAL(std::string("1"), visited[0]);
+    BOOST_CHECK_EQUAL(std::string("{\"b\":1}"), visited[1]);
+    BOOST_CHECK_EQUAL(std::string("{\"b\":2}"), visited[2]);
+    BOOST_CHECK_EQUAL(json::parse(R"({"b": 3})"), nested);
+
+    auto expr = jsonpath::compile<json>("$.store.book[?(@.price > 30)].price");
+    expr.transform(j, [](json& price) {price = "expensive";});
+    BOOST_CHECK_EQUAL(std::string("expensive"), j["store"]["book"][1]["price"].as<std::string>());
+}
+
 BOOST_AUTO_TEST_CASE(test_max_pre)
 {
     std::string path = "$.store.book[*].price";
@@ -1156,6 +1198,184 @@ BOOST_AUTO_TEST_CASE(test_ws1)
     BOOST_CHECK_EQUAL(expected,result);
 }
 
+BOOST_AUTO_TEST_CASE(test_compile)
+{
+    auto expr = jsonpath::compile<json>("$.store.book[?(@.price > 10)].title");
+
+    json expected1 = json::parse(R"(
+["Sword of Honour","The Lord of the Rings"]
+    )");
+    BOOST_CHECK_EQUAL(expected1,expr.evaluate(store));
+    BOOST_CHECK_EQUAL(expected1,expr.evaluate(store));
+
+    json root2 = json::parse(R"(
+{"store":{"book":[{"title":"A","price":11},{"title":"B","price":9}]}}
+    )");
+    json expected2 = json::parse(R"(["A"])");
+    BOOST_CHECK_EQUAL(expected2,expr.evaluate(root2));
+
+    json expected3 = json::parse(R"(["$['store']['book'][0]['title']"])");
+    BOOST_CHECK_EQUAL(expected3,expr.evaluate(root2,result_type::path));
+}
+
+// The argument of an aggregate function is evaluated against each root
+BOOST_AUTO_TEST_CASE(test_compile_max)
+{
+    auto expr = jsonpath::compile<json>("$.store.book[?(@.price < max($.store.book[*].price))].title");
+
+    json expected1 = json::parse(R"(
+["Sayings of the Century","Sword of Honour","Moby Dick"]
+    )");
+    BOOST_CHECK_EQUAL(expected1,expr.evaluate(store));
+
+    json root2 = json::parse(R"(
+{"store":{"book":[{"title":"A","price":30},{"title":"B","price":40}]}}
+    )");
+    json expected2 = json::parse(R"(["A"])");
+    BOOST_CHECK_EQUAL(expected2,expr.evaluate(root2));
+}
+
+BOOST_AUTO_TEST_CASE(test_compile_replace)
+{
+    auto expr = jsonpath::compile<json>("$..price");
+
+    json root = store;
+    expr.replace(root, 10.0);
+    BOOST_CHECK_EQUAL(json::parse("[10.0,10.0,10.0,10.0,10.0]"),expr.evaluate(root));
+    BOOST_CHECK(expr.evaluate(store) != expr.evaluate(root));
+}
+
+BOOST_AUTO_TEST_CASE(test_compile_select)
+{
+    auto expr = jsonpath::compile<json>("$..price");
+
+    std::vector<const json*> matches;
+    expr.select(store, [&](const json& val){matches.push_back(std::addressof(val));});
+
+    BOOST_REQUIRE_EQUAL(5,matches.size());
+    BOOST_CHECK(matches[0] == std::addressof(store["store"]["bicycle"]["price"]));
+    json values = expr.evaluate(store);
+    for (size_t i = 0; i < matches.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(values[i],*matches[i]);
+    }
+
+    size_t length = 0;
+    jsonpath::compile<json>("$.store.book.length").select(store, [&](const json& val){length = val.as<size_t>();});
+    BOOST_CHECK_EQUAL(4,length);
+}
+
+BOOST_AUTO_TEST_CASE(test_compile_error)
+{
+    BOOST_CHECK_THROW(jsonpath::compile<json>("$.store...price"), parse_error);
+
+    std::error_code ec;
+    auto expr = jsonpath::compile<json>("$.store...price", ec);
+    BOOST_CHECK(ec == jsonpath_parser_errc::expected_name);
+    BOOST_CHECK_EQUAL(json(json::array()),expr.evaluate(store));
+}
+
+// Each expression of a set selects the same nodes as it does alone
+BOOST_AUTO_TEST_CASE(test_expression_set)
+{
+    std::vector<std::string> paths = {"$.store.book[*].author", "$.store.book[?(@.price < 10)].title", 
+                                      "$.store.book[0:2].title", "$.store.book[0:2].price", "$..price",
+                                      "$['store']['book'][1]", "$.store.book.length", "$", "$.store['bicycle'].color"};
+
+    jsonpath_expression_set<json> expressions;
+    for (const auto& path : paths)
+    {
+        expressions.add(path);
+    }
+    BOOST_CHECK_EQUAL(paths.size(), expressions.size());
+
+    std::vector<json> values = expressions.evaluate(store);
+    std::vector<json> normalized_paths = expressions.evaluate(store, result_type::path);
+    std::vector<json> selected(paths.size(), json::array());
+    expressions.select(store, [&](size_t index, const json& val){selected[index].push_back(val);});
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(json_query(store, paths[i]), values[i]);
+        BOOST_CHECK_EQUAL(json_query(store, paths[i], result_type::path), normalized_paths[i]);
+        BOOST_CHECK_EQUAL(values[i], selected[i]);
+    }
+
+    BOOST_CHECK_THROW(expressions.add("$.store...price"), parse_error);
+}
+
+// With an index, an equality filter on the indexed member finds the same nodes
+BOOST_AUTO_TEST_CASE(test_member_index)
+{
+    json root = json::parse(R"(
+    {
+        "users": [
+            {"id":12345,"name":"a"},
+            {"id":"12345","name":"b"},
+            {"id":7,"name":"c"},
+            {"name":"d"},
+            {"id":12345.0,"name":"e"},
+            42,
+            {"id":true,"name":"f"}
+        ],
+        "groups": {"admins": [{"id":7,"name":"g"}]}
+    }
+    )");
+
+    member_index<json> index(root, "$..*", "id");
+
+    const char* paths[] = {"$.users[?(@.id == 12345)]", "$.users[?(@.id == '12345')]", "$..[?(@.id == 7)]",
+                           "$.users[?(@.id == true)]", "$.users[?(@.id == 8)]", "$.users[?(@.id != 7)]",
+                           "$.users[?(12345 == @.id)].name"};
+    for (const char* path : paths)
+    {
+        auto expr = jsonpath::compile<json>(path);
+        BOOST_CHECK_EQUAL(expr.evaluate(root), expr.evaluate(root, index));
+        BOOST_CHECK_EQUAL(expr.evaluate(root, result_type::path), expr.evaluate(root, index, result_type::path));
+    }
+    BOOST_CHECK_EQUAL(json::parse(R"(["a","e"])"), jsonpath::compile<json>("$.users[?(@.id == 12345)].name").evaluate(root, index));
+
+    // An array that has grown since it was indexed is scanned
+    root["users"].push_back(json::parse(R"({"id":7,"name":"h"})"));
+    BOOST_CHECK_EQUAL(json::parse(R"(["c","h"])"), jsonpath::compile<json>("$.users[?(@.id == 7)].name").evaluate(root, index));
+}
+
+// Evaluated on several threads, the nodes are the same and in the same order
+BOOST_AUTO_TEST_CASE(test_compile_parallel)
+{
+    json root = json::array();
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        json item;
+        item["id"] = i;
+        item["price"] = (i * 7) % 100;
+        item["tags"] = json::array{i % 3, i % 5};
+        if (i % 10 == 0)
+        {
+            item["inner"] = json::array{json::object{{"id", i + 1000}}};
+        }
+        root.push_back(std::move(item));
+    }
+
+    parallel_options options;
+    options.max_threads(4).min_chunk_size(16);
+
+    const char* paths[] = {"$[?(@.price < 20)].id", "$..id", "$[*].tags[0]", "$..[?(@.id > 1500)]", "$..tags.length"};
+    for (const char* path : paths)
+    {
+        auto expr = jsonpath::compile<json>(path);
+        BOOST_CHECK_EQUAL(expr.evaluate(root), expr.evaluate(root, result_type::value, options));
+        BOOST_CHECK_EQUAL(expr.evaluate(root, result_type::path), expr.evaluate(root, result_type::path, options));
+    }
+
+    auto expr = jsonpath::compile<json>("$..id");
+    std::vector<const json*> sequential;
+    std::vector<const json*> parallel;
+    expr.select(root, [&](const json& val){sequential.push_back(&val);});
+    expr.select(root, [&](const json& val){parallel.push_back(&val);}, options);
+    BOOST_CHECK_EQUAL(1100, parallel.size());
+    BOOST_CHECK(sequential == parallel);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
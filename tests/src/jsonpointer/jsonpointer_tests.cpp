@@ -210,6 +210,99 @@ BOOST_AUTO_TEST_CASE(test_replace_array_value)
     check_replace(example,"/foo/1", json("qux"), expected);
 }
 
+// A pointer parsed once gives the same results and errors as the pointer as a string
+BOOST_AUTO_TEST_CASE(test_json_pointer)
+{
+    const json doc = json::parse(R"({"a":[{"b":1},[0,1,2]],"c/d":{"~":"t"},"e":true,"":{"":2}})");
+
+    std::vector<std::string> pointers = {"", "/a", "/a/0/b", "/a/1/2", "/c~1d/~0", "//", "/", "/e/x",
+                                         "a", "/a/3", "/a/-", "/a/-/b", "/a/01", "/a/0-", "/a/x", "/a/-x",
+                                         "/a/0/c", "/c~1d/~2", "/c~1d/~", "/a/", "/a//b", "/a/12-"};
+    for (const auto& s : pointers)
+    {
+        jsonpointer::json_pointer ptr(s);
+        BOOST_CHECK_EQUAL(ptr.string(), s);
+
+        json expected, result;
+        jsonpointer::jsonpointer_errc expected_ec, ec;
+        std::tie(expected,expected_ec) = jsonpointer::get(doc,s);
+        std::tie(result,ec) = jsonpointer::get(doc,ptr);
+        BOOST_CHECK_MESSAGE(expected_ec == ec, s);
+        if (ec == jsonpointer::jsonpointer_errc())
+        {
+            BOOST_CHECK_EQUAL(expected,result);
+        }
+        BOOST_CHECK_EQUAL(jsonpointer::contains(doc,s), jsonpointer::contains(doc,ptr));
+        BOOST_CHECK_EQUAL(jsonpointer::normalized_path(doc,s), jsonpointer::normalized_path(doc,ptr));
+
+        json j1 = doc, j2 = doc;
+        BOOST_CHECK_MESSAGE(jsonpointer::insert_or_assign(j1,s,json("v")) == jsonpointer::insert_or_assign(j2,ptr,json("v")), s);
+        BOOST_CHECK_EQUAL(j1,j2);
+        BOOST_CHECK_MESSAGE(jsonpointer::insert(j1,s,json("w")) == jsonpointer::insert(j2,ptr,json("w")), s);
+        BOOST_CHECK_EQUAL(j1,j2);
+        BOOST_CHECK_MESSAGE(jsonpointer::replace(j1,s,json(1)) == jsonpointer::replace(j2,ptr,json(1)), s);
+        BOOST_CHECK_EQUAL(j1,j2);
+        BOOST_CHECK_MESSAGE(jsonpointer::remove(j1,s) == jsonpointer::remove(j2,ptr), s);
+        BOOST_CHECK_EQUAL(j1,j2);
+    }
+
+    jsonpointer::json_pointer ptr("/a/1/0");
+    BOOST_CHECK_EQUAL(3,ptr.tokens().size());
+    BOOST_CHECK_EQUAL(std::string("1"),ptr.tokens()[1].name);
+    BOOST_CHECK_EQUAL(1,ptr.tokens()[1].index);
+    BOOST_CHECK(jsonpointer::json_pointer("x").errc() == jsonpointer::jsonpointer_errc::expected_slash);
+}
+
+BOOST_AUTO_TEST_CASE(test_json_pointer_index)
+{
+    json doc = json::parse(R"({"a/b":{"c":[1,2,{"d":"x"}]},"e":{}})");
+    jsonpointer::json_pointer_index<json> index(doc);
+
+    const json* value = index.find("/a~1b/c/2/d");
+    BOOST_REQUIRE(value != nullptr);
+    BOOST_CHECK_EQUAL(std::string("x"), value->as<std::string>());
+    BOOST_CHECK(value == &doc.at("a/b").at("c").at(2).at("d"));
+    BOOST_CHECK(index.find("/a~1b/c/2/d") == value);
+    BOOST_CHECK(index.find("") == &doc);
+    BOOST_CHECK(index.contains("/e"));
+
+    jsonpointer::jsonpointer_errc ec;
+    BOOST_CHECK(index.find("/a~1b/c/3", ec) == nullptr);
+    BOOST_CHECK(ec == jsonpointer::jsonpointer_errc::index_exceeds_array_size);
+    BOOST_CHECK(index.find("/x", ec) == nullptr);
+    BOOST_CHECK(ec == jsonpointer::jsonpointer_errc::name_not_found);
+    BOOST_CHECK(index.find("x", ec) == nullptr);
+    BOOST_CHECK(ec == jsonpointer::jsonpointer_errc::expected_slash);
+    BOOST_CHECK_EQUAL(6, index.size());
+
+    std::error_code error;
+    BOOST_CHECK_EQUAL(json(2), index.get("/a~1b/c/1", error));
+    BOOST_CHECK(!error);
+    BOOST_CHECK(index.get("/x", error).is_null());
+    BOOST_CHECK(error == jsonpointer::jsonpointer_errc::name_not_found);
+
+    // After the document is modified
+    doc["x"] = 1;
+    index.clear();
+    BOOST_CHECK_EQUAL(0, index.size());
+    BOOST_REQUIRE(index.find("/x") != nullptr);
+    BOOST_CHECK_EQUAL(json(1), *index.find("/x"));
+
+    // Found in any order of pointers, with ojson
+    ojson odoc = ojson::parse(R"({"b":[10,20],"a":{"c":true}})");
+    jsonpointer::json_pointer_index<ojson> oindex(odoc);
+    std::vector<std::string> paths = {"/b/1", "/a/c", "/b/0", "/a", "/b/1"};
+    for (const auto& path : paths)
+    {
+        ojson expected;
+        jsonpointer::jsonpointer_errc expected_ec;
+        std::tie(expected,expected_ec) = jsonpointer::get(odoc, path);
+        BOOST_REQUIRE(oindex.find(path) != nullptr);
+        BOOST_CHECK_EQUAL(expected, *oindex.find(path));
+    }
+    BOOST_CHECK_EQUAL(4, oindex.size());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
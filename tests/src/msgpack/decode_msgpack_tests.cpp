@@ -119,6 +119,80 @@ BOOST_AUTO_TEST_CASE(decode_msgpack_arrays_and_maps)
 
     check_decode({0x81,0xa2,'o','c',0x91,'\0'}, json::parse("{\"oc\": [0]}"));
     check_decode({0x81,0xa2,'o','c',0x94,'\0','\1','\2','\3'}, json::parse("{\"oc\": [0, 1, 2, 3]}"));
+
+    // Members out of order, and duplicates, where the last wins
+    check_decode({0x83,0xa1,'b','\1',0xa1,'a','\2',0xa1,'b','\3'}, json::parse("{\"a\":2,\"b\":3}"));
+    check_decode({0xde,0x00,0x03,0xa1,'b','\1',0xa1,'a','\2',0xa1,'b','\3'}, json::parse("{\"a\":2,\"b\":3}"));
+    check_decode({0xdf,0x00,0x00,0x00,0x02,0xa1,'b','\1',0xa1,'a','\2'}, json::parse("{\"a\":2,\"b\":1}"));
+}
+
+BOOST_AUTO_TEST_CASE(decode_msgpack_long_strings)
+{
+    // str 8, str 16 and str 32 lengths are unsigned
+    const size_t lengths[] = {200, 40000, 70000};
+    for (size_t length : lengths)
+    {
+        json j(std::string(length, 'a'));
+        std::vector<uint8_t> v = encode_msgpack(j);
+        BOOST_CHECK(decode_msgpack<json>(v) == j);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(decode_msgpack_map_keys)
+{
+    // fixstr, str 8 and str 16 keys, read straight into the key storage
+    json j;
+    j["a"] = 1;
+    j[std::string(200, 'k')] = 2;
+    j[std::string(300, 'm')] = 3;
+    j["\xce\xbb\xe2\x82\xac"] = 4;
+    std::vector<uint8_t> v = encode_msgpack(j);
+    BOOST_CHECK(decode_msgpack<json>(v) == j);
+    BOOST_CHECK(decode_msgpack<ojson>(v) == ojson::parse(j.to_string()));
+
+    wjson w = decode_msgpack<wjson>(v);
+    BOOST_CHECK_EQUAL(4, w.at(L"\u03bb\u20ac").as<int>());
+    BOOST_CHECK_EQUAL(3, w.at(std::wstring(300, L'm')).as<int>());
+
+    std::vector<uint8_t> invalid = {0x81,0xa2,0xce,'a',0x01};
+    BOOST_CHECK_THROW(decode_msgpack<json>(invalid), std::runtime_error);
+    std::vector<uint8_t> truncated = {0x81,0xa5,'a','b',0x01};
+    BOOST_CHECK_THROW(decode_msgpack<json>(truncated), std::invalid_argument);
+    std::vector<uint8_t> not_a_string = {0x81,0x01,0x01};
+    BOOST_CHECK_THROW(decode_msgpack<json>(not_a_string), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(decode_msgpack_limits)
+{
+    std::vector<uint8_t> v = encode_msgpack(json::parse("{\"a\":[[1,2,3]],\"bc\":\"defg\"}"));
+    binary::decode_limits limits;
+    limits.max_nesting_depth = 3;
+    limits.max_items = 3;
+    limits.max_string_length = 4;
+    BOOST_CHECK(decode_msgpack<json>(v, limits) == decode_msgpack<json>(v));
+
+    limits.max_nesting_depth = 2;
+    BOOST_CHECK_THROW(decode_msgpack<json>(v, limits), parse_error);
+    limits.max_nesting_depth = 3;
+    limits.max_items = 2;
+    BOOST_CHECK_THROW(decode_msgpack<json>(v, limits), parse_error);
+    limits.max_items = 3;
+    limits.max_string_length = 3;
+    try
+    {
+        decode_msgpack<json>(v, limits);
+        BOOST_CHECK(false);
+    }
+    catch (const parse_error& e)
+    {
+        BOOST_CHECK(e.code() == msgpack_parser_errc::max_string_length_exceeded);
+    }
+
+    // Declared lengths past the end of the data
+    std::vector<uint8_t> huge_array = {0xdd,0xff,0xff,0xff,0xff,0x01};
+    BOOST_CHECK_THROW(decode_msgpack<json>(huge_array), parse_error);
+    std::vector<uint8_t> short_string = {0xa5,'a','b'};
+    BOOST_CHECK_THROW(decode_msgpack<json>(short_string), std::invalid_argument);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -38,6 +38,12 @@ void check_encode(const std::vector<uint8_t>& expected, const json& j)
         }
         BOOST_REQUIRE_MESSAGE(expected[i] == result[i], j.to_string());
     }
+
+    // Appended in one pass after what the vector already holds
+    std::vector<uint8_t> appended = {0xaa};
+    encode_msgpack(j, appended);
+    BOOST_REQUIRE_MESSAGE(appended.size() == expected.size() + 1 && appended[0] == 0xaa, j.to_string());
+    BOOST_CHECK_MESSAGE(std::equal(expected.begin(), expected.end(), appended.begin() + 1), j.to_string());
 }
 
 BOOST_AUTO_TEST_CASE(encode_msgpack_test)
@@ -126,5 +132,48 @@ BOOST_AUTO_TEST_CASE(encode_msgpack_arrays_and_maps)
     check_encode({0x81,0xa2,'o','c',0x94,'\0','\1','\2','\3'}, json::parse("{\"oc\": [0, 1, 2, 3]}"));
 }
 
+BOOST_AUTO_TEST_CASE(encode_msgpack_into_reused_buffer)
+{
+    json j = json::parse(R"({"name":"a name that takes more than sixty four bytes to encode, with its value","values":[1,256,65536,4294967296,-1.5]})");
+    std::vector<uint8_t> expected = encode_msgpack(j);
+
+    std::vector<uint8_t> v;
+    for (int i = 0; i < 3; ++i)
+    {
+        v.clear();
+        encode_msgpack(j, v);
+        BOOST_CHECK(v == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(encode_msgpack_byte_string)
+{
+    check_encode({0xc4,0x00}, json(byte_string()));
+    check_encode({0xc4,0x03,0x01,0x02,0x03}, json(byte_string({0x01,0x02,0x03})));
+
+    // bin 16 and bin 32, matching msgpack_serializer
+    for (size_t length : {size_t(300), size_t(70000)})
+    {
+        std::vector<uint8_t> data(length);
+        for (size_t i = 0; i < length; ++i)
+        {
+            data[i] = static_cast<uint8_t>(i*7);
+        }
+        json j = json::array();
+        j.push_back(json(data.data(), data.size()));
+
+        std::vector<uint8_t> v = encode_msgpack(j);
+        BOOST_REQUIRE_EQUAL(length + (length <= 65535 ? 4 : 6), v.size());
+        BOOST_CHECK_EQUAL(length <= 65535 ? 0xc5 : 0xc6, v[1]);
+
+        json result = decode_msgpack<json>(v);
+        BOOST_CHECK(result == j);
+        BOOST_CHECK(result[0].as_byte_string_view() == byte_string_view(data.data(), data.size()));
+    }
+
+    std::vector<uint8_t> truncated = {0xc5,0x01,0x00,0x01};
+    BOOST_CHECK_THROW(decode_msgpack<json>(truncated), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
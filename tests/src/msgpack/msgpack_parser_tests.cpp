@@ -0,0 +1,158 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_filter.hpp>
+#include <jsoncons_ext/msgpack/msgpack.hpp>
+#include <jsoncons_ext/msgpack/msgpack_parser.hpp>
+#include <jsoncons_ext/msgpack/msgpack_reader.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <limits>
+
+using namespace jsoncons;
+using namespace jsoncons::msgpack;
+
+BOOST_AUTO_TEST_SUITE(msgpack_parser_tests)
+
+// Parses v passed to the parser piece_length bytes at a time
+template <class Json>
+Json parse_in_pieces(const std::vector<uint8_t>& v, size_t piece_length)
+{
+    json_decoder<Json> decoder;
+    msgpack_parser parser(decoder);
+    for (size_t i = 0; i < v.size() && !parser.done(); i += piece_length)
+    {
+        parser.set_source(v.data() + i, (std::min)(piece_length, v.size() - i));
+        parser.parse();
+    }
+    parser.end_parse();
+    parser.check_done();
+    return decoder.get_result();
+}
+
+BOOST_AUTO_TEST_CASE(msgpack_parser_matches_decode_msgpack)
+{
+    ojson j = ojson::parse(R"(
+    {
+       "application": "hiking",
+       "reputons": [
+       {
+           "rater": "HikingAsylum.example.com",
+           "assertion": "is-good",
+           "rated": "sk",
+           "rating": 0.90,
+           "votes": [-1, -33, -129, -32769, -2147483649, 0, 127, 128, 256, 65536, 4294967296, 18446744073709551615]
+         }
+       ],
+       "empty array": [],
+       "empty object": {},
+       "flags": [true, false, null],
+       "a string long enough to need a one byte length": "and a value of more than thirty one bytes"
+    }
+    )");
+    ojson many;
+    for (size_t i = 0; i < 20; ++i)
+    {
+        many.set(std::to_string(i), i);
+    }
+    j["many"] = std::move(many);
+
+    std::vector<uint8_t> v = encode_msgpack(j);
+    ojson expected = decode_msgpack<ojson>(v);
+
+    for (size_t piece_length : {v.size(), size_t(1), size_t(2), size_t(7)})
+    {
+        ojson result = parse_in_pieces<ojson>(v, piece_length);
+        BOOST_CHECK_MESSAGE(expected == result, piece_length);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(msgpack_parser_bin_ext_and_keys)
+{
+    // {"b": bin 8 [1,2], "e": fixext 1 (type 5) [9], "f": float 32 1.5, 3: ext 8 (type 1) [7,8]}
+    std::vector<uint8_t> v = {0x84,
+                              0xa1,'b',0xc4,0x02,0x01,0x02,
+                              0xa1,'e',0xd4,0x05,0x09,
+                              0xa1,'f',0xca,0x3f,0xc0,0x00,0x00,
+                              0x03,0xc7,0x02,0x01,0x07,0x08};
+    for (size_t piece_length : {v.size(), size_t(1), size_t(3)})
+    {
+        json result = parse_in_pieces<json>(v, piece_length);
+        BOOST_CHECK(result["b"].as<byte_string>() == byte_string({0x01,0x02}));
+        BOOST_CHECK(result["e"].as<byte_string>() == byte_string({0x09}));
+        BOOST_CHECK_EQUAL(1.5, result["f"].as<double>());
+        BOOST_CHECK(result["3"].as<byte_string>() == byte_string({0x07,0x08}));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(msgpack_reader_test)
+{
+    json j = json::parse(R"([{"name":"first","values":[1,2,3]},{"name":"second","values":[]}])");
+    std::vector<uint8_t> v = encode_msgpack(j);
+    std::vector<uint8_t> u = encode_msgpack(json("next"));
+
+    std::string s(v.begin(), v.end());
+    s.append(u.begin(), u.end());
+    std::istringstream is(s);
+
+    json_decoder<json> decoder;
+    msgpack_reader reader(is, decoder);
+    reader.buffer_length(5);
+    reader.read_next();
+    BOOST_CHECK(decoder.get_result() == j);
+    reader.read_next();
+    BOOST_CHECK(decoder.get_result() == json("next"));
+    reader.check_done();
+    reader.read_next();
+    BOOST_CHECK(reader.eof());
+
+    std::istringstream is2(std::string(v.begin(), v.end()));
+    BOOST_CHECK(decode_msgpack<json>(is2) == j);
+}
+
+BOOST_AUTO_TEST_CASE(msgpack_parser_errors)
+{
+    struct test_case
+    {
+        std::vector<uint8_t> v;
+        msgpack_parser_errc expected;
+    };
+    std::vector<test_case> cases = {
+        {{0x92,0x01}, msgpack_parser_errc::unexpected_eof},
+        {{0xa2,'a'}, msgpack_parser_errc::unexpected_eof},
+        {{0xcd,0x01}, msgpack_parser_errc::unexpected_eof},
+        {{0xc1}, msgpack_parser_errc::invalid_format},
+        {{0x81,0xc0,0x01}, msgpack_parser_errc::invalid_key},
+        {{0x81,0x90,0x01}, msgpack_parser_errc::invalid_key},
+        {{0x81,0xc4,0x01,'a',0x01}, msgpack_parser_errc::invalid_key},
+        {{0xa1,0xff}, msgpack_parser_errc::invalid_utf8},
+        {{0x01,0x02}, msgpack_parser_errc::extra_data}
+    };
+    for (const auto& c : cases)
+    {
+        msgpack_parser parser;
+        parser.set_source(c.v.data(), c.v.size());
+        std::error_code ec;
+        parser.parse(ec);
+        if (!ec)
+        {
+            parser.check_done(ec);
+        }
+        BOOST_CHECK_EQUAL(make_error_code(c.expected), ec);
+    }
+
+    msgpack_parser parser;
+    parser.max_nesting_depth(2);
+    std::vector<uint8_t> v = {0x91,0x91,0x91,0x01};
+    parser.set_source(v.data(), v.size());
+    BOOST_CHECK_THROW(parser.parse(), parse_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,151 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_filter.hpp>
+#include <jsoncons/json_reader.hpp>
+#include <jsoncons_ext/msgpack/msgpack.hpp>
+#include <jsoncons_ext/msgpack/msgpack_serializer.hpp>
+#include <jsoncons_ext/msgpack/msgpack_parser.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/cbor/cbor_serializer.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <limits>
+
+using namespace jsoncons;
+using namespace jsoncons::msgpack;
+
+BOOST_AUTO_TEST_SUITE(msgpack_serializer_tests)
+
+std::vector<uint8_t> to_bytes(const std::string& s)
+{
+    return std::vector<uint8_t>(s.begin(), s.end());
+}
+
+BOOST_AUTO_TEST_CASE(msgpack_serializer_matches_encode_msgpack)
+{
+    ojson j = ojson::parse(R"(
+    {
+       "application": "hiking",
+       "reputons": [
+       {
+           "rater": "HikingAsylum.example.com",
+           "assertion": "is-good",
+           "rated": "sk",
+           "rating": 0.90,
+           "votes": [-1, -33, -129, -32769, -2147483649, 0, 127, 128, 256, 65536, 4294967296, 18446744073709551615]
+         }
+       ],
+       "empty": [{}, []],
+       "flags": [true, false, null]
+    }
+    )");
+    ojson a = ojson::array();
+    for (size_t i = 0; i < 70000; ++i)
+    {
+        a.add(i % 3);
+    }
+    j["long array"] = std::move(a);
+    ojson many;
+    for (size_t i = 0; i < 20; ++i)
+    {
+        many.set(std::string(i*5, 'k') + std::to_string(i), i);
+    }
+    j["many"] = std::move(many);
+
+    std::ostringstream os;
+    msgpack_serializer serializer(os);
+    j.dump(serializer);
+
+    BOOST_CHECK(encode_msgpack(j) == to_bytes(os.str()));
+}
+
+BOOST_AUTO_TEST_CASE(msgpack_serializer_byte_string)
+{
+    std::ostringstream os;
+    msgpack_serializer serializer(os);
+    serializer.begin_json();
+    serializer.begin_array();
+    const uint8_t data[] = {'H','i'};
+    serializer.byte_string_value(data, sizeof(data));
+    serializer.end_array();
+    serializer.end_json();
+
+    std::vector<uint8_t> expected = {0x91,0xc4,0x02,'H','i'};
+    BOOST_CHECK(expected == to_bytes(os.str()));
+}
+
+// JSON text to MessagePack to CBOR, with events and no json value in between
+BOOST_AUTO_TEST_CASE(msgpack_transcode_pipeline)
+{
+    std::string text = R"([{"name":"first","values":[1,2.5,-3]},{"name":"second","values":[],"flag":false}])";
+
+    std::istringstream is(text);
+    std::ostringstream msgpack_os;
+    msgpack_serializer serializer(msgpack_os);
+    basic_json_input_output_handler_adapter<char> adapter(serializer);
+    json_reader reader(is, adapter);
+    reader.read();
+
+    std::vector<uint8_t> v = to_bytes(msgpack_os.str());
+    BOOST_CHECK(decode_msgpack<json>(v) == json::parse(text));
+
+    std::ostringstream cbor_os;
+    cbor::cbor_serializer cbor_serializer(cbor_os);
+    basic_json_input_output_handler_adapter<char> cbor_adapter(cbor_serializer);
+    msgpack_parser parser(cbor_adapter);
+    parser.set_source(v.data(), v.size());
+    parser.parse();
+    parser.check_done();
+
+    BOOST_CHECK(cbor::decode_cbor<json>(to_bytes(cbor_os.str())) == json::parse(text));
+}
+
+BOOST_AUTO_TEST_CASE(msgpack_serializer_illegal_unicode)
+{
+    std::ostringstream os;
+    msgpack_serializer serializer(os);
+    serializer.begin_json();
+    BOOST_CHECK_THROW(serializer.value("\xff"), std::runtime_error);
+}
+
+// Rewrites one member of a record, and copies the others as they are encoded
+BOOST_AUTO_TEST_CASE(msgpack_serializer_encoded_value)
+{
+    ojson record = ojson::parse(R"({"id":7,"payload":{"samples":[1.5,2.5,3.5],"source":"sensor"},"status":"new"})");
+    std::vector<uint8_t> v = encode_msgpack(record);
+    msgpack_view view = msgpack_view(v).indexed();
+
+    std::ostringstream os;
+    msgpack_serializer serializer(os);
+    serializer.begin_json();
+    serializer.begin_object();
+    for (size_t i = 0; i < view.size(); ++i)
+    {
+        serializer.name(view.key(i));
+        if (view.key(i) == "status")
+        {
+            ojson status = ojson::parse(R"({"state":"done","attempts":[1,2]})");
+            status.dump_fragment(serializer);
+        }
+        else
+        {
+            serializer.encoded_value(view.value(i));
+        }
+    }
+    serializer.end_object();
+    serializer.end_json();
+
+    record["status"] = ojson::parse(R"({"state":"done","attempts":[1,2]})");
+    std::string s = os.str();
+    BOOST_CHECK(std::vector<uint8_t>(s.begin(), s.end()) == encode_msgpack(record));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
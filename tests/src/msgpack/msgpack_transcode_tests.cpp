@@ -0,0 +1,76 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/msgpack/msgpack.hpp>
+#include <jsoncons_ext/msgpack/msgpack_transcode.hpp>
+#include <sstream>
+#include <vector>
+#include <string>
+
+using namespace jsoncons;
+using namespace jsoncons::msgpack;
+
+BOOST_AUTO_TEST_SUITE(msgpack_transcode_tests)
+
+BOOST_AUTO_TEST_CASE(json_to_msgpack_round_trip_test)
+{
+    std::string text = R"({"a":[1,-2,3.5,"four",true,null],"b":{"c":"été","d":[]},"e":300})";
+    json expected = json::parse(text);
+
+    std::istringstream is(text);
+    std::ostringstream os;
+    json_to_msgpack(is, os);
+    std::string s = os.str();
+    // The same bytes as encode_msgpack
+    std::vector<uint8_t> buffer(s.begin(), s.end());
+    BOOST_CHECK(buffer == encode_msgpack(expected));
+
+    std::istringstream is2(s);
+    std::ostringstream os2;
+    msgpack_to_json(is2, os2);
+    BOOST_CHECK(json::parse(os2.str()) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(msgpack_to_json_source_sink_test)
+{
+    json j = json::parse(R"([{"id":1,"name":"x"},{"id":2,"name":"y"}])");
+    std::vector<uint8_t> buffer = encode_msgpack(j);
+    std::string s(buffer.begin(), buffer.end());
+
+    std::istringstream is(s);
+    stream_source source(is);
+    std::string out;
+    string_sink sink(out);
+    msgpack_to_json(source, sink);
+    BOOST_CHECK_EQUAL(std::string(R"([{"id":1,"name":"x"},{"id":2,"name":"y"}])"), out);
+
+    std::istringstream is2(s);
+    msgpack_reader reader(is2);
+    BOOST_CHECK_NO_THROW(reader.read());
+}
+
+BOOST_AUTO_TEST_CASE(msgpack_transcode_error_test)
+{
+    std::istringstream is("[1,2");
+    std::ostringstream os;
+    std::error_code ec;
+    json_to_msgpack(is, os, ec);
+    BOOST_CHECK(ec);
+
+    // An array of 3 items with only 1
+    std::string truncated = {'\x93', '\x01'};
+    std::istringstream is2(truncated);
+    std::ostringstream os2;
+    msgpack_to_json(is2, os2, ec);
+    BOOST_CHECK(ec);
+    std::istringstream is3(truncated);
+    BOOST_CHECK_THROW(msgpack_to_json(is3, os2), parse_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
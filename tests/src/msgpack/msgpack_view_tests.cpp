@@ -0,0 +1,195 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/msgpack/msgpack.hpp>
+#include <jsoncons_ext/jsonpointer/jsonpointer.hpp>
+#include <jsoncons_ext/jsonpath/json_query.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <limits>
+
+using namespace jsoncons;
+using namespace jsoncons::msgpack;
+
+BOOST_AUTO_TEST_SUITE(msgpack_view_tests)
+
+BOOST_AUTO_TEST_CASE(msgpack_view_test)
+{
+    ojson j1 = ojson::parse(R"(
+    {
+       "application": "hiking",
+       "reputons": [
+       {
+           "rater": "HikingAsylum.example.com",
+           "assertion": "is-good",
+           "rated": "sk",
+           "rating": 0.90,
+           "votes": [-1, 0, 255, 65536, -4294967297]
+         }
+       ]
+    }
+    )");
+
+    std::vector<uint8_t> buffer = encode_msgpack(j1);
+    msgpack_view v(buffer);
+    BOOST_CHECK(v.is_object());
+    BOOST_CHECK(!v.is_array());
+    BOOST_CHECK_EQUAL(2, v.size());
+    BOOST_CHECK(v.has_key("reputons"));
+    BOOST_CHECK(!v.has_key("ratings"));
+
+    BOOST_CHECK_EQUAL(std::string("hiking"), v.at("application").as<std::string>());
+
+    msgpack_view reputons = v.at("reputons");
+    BOOST_CHECK(reputons.is_array());
+    BOOST_REQUIRE_EQUAL(1, reputons.size());
+    msgpack_view reputon = reputons.at(0);
+    BOOST_CHECK_EQUAL(0.90, reputon.at("rating").as<double>());
+    BOOST_CHECK_THROW(reputons.at(1), std::out_of_range);
+    BOOST_CHECK_THROW(reputon.at("none"), std::runtime_error);
+
+    msgpack_view votes = reputon.at("votes");
+    BOOST_REQUIRE_EQUAL(5, votes.size());
+    BOOST_CHECK_EQUAL(-1, votes.at(0).as<int64_t>());
+    BOOST_CHECK_EQUAL(255, votes.at(2).as<int64_t>());
+    BOOST_CHECK_EQUAL(-4294967297, votes.at(4).as<int64_t>());
+
+    BOOST_CHECK(decode_msgpack<ojson>(reputon) == j1["reputons"][0]);
+}
+
+BOOST_AUTO_TEST_CASE(msgpack_view_skips_binary_and_ext_test)
+{
+    // [bin 8 "ab", fixext 1, ext 8 (3 bytes), 0xca float, "x"]
+    std::vector<uint8_t> buffer = {0x95,
+                                   0xc4,0x02,'a','b',
+                                   0xd4,0x01,0x00,
+                                   0xc7,0x03,0x01,0x00,0x00,0x00,
+                                   0xca,0x3f,0xc0,0x00,0x00,
+                                   0xa1,'x'};
+    msgpack_view v(buffer);
+    BOOST_REQUIRE_EQUAL(5, v.size());
+    BOOST_CHECK_EQUAL(std::string("x"), v.at(4).as<std::string>());
+    BOOST_CHECK_EQUAL(std::string("x"), v.indexed().at(4).as<std::string>());
+    BOOST_CHECK_EQUAL(5, v.at(3).buflen());
+
+    // A truncated array
+    std::vector<uint8_t> truncated = {0x92,0xc4,0x05,'a'};
+    BOOST_CHECK_THROW(msgpack_view(truncated).at(1), std::invalid_argument);
+
+    // An ext 8 without its type byte
+    std::vector<uint8_t> truncated_ext = {0x91,0xc7,0x05};
+    BOOST_CHECK_THROW(msgpack_view(truncated_ext).at(0), std::invalid_argument);
+
+    // Lengths larger than the bytes that follow
+    std::vector<uint8_t> long_map = {0xdf,0xff,0xff,0xff,0xff};
+    BOOST_CHECK_THROW(msgpack_view(long_map).indexed(), std::invalid_argument);
+    std::vector<uint8_t> long_array = {0xdd,0xff,0xff,0xff,0xff,0x01};
+    BOOST_CHECK_THROW(msgpack_view(long_array).indexed(), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(msgpack_view_index_test)
+{
+    json a = json::array();
+    json m;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        a.add(json(std::string(i % 40, 'x') + std::to_string(i)));
+        m["key" + std::to_string(i)] = i;
+    }
+    json j;
+    j["array"] = a;
+    j["map"] = m;
+    std::vector<uint8_t> buffer = encode_msgpack(j);
+    msgpack_view v(buffer);
+
+    msgpack_view array = v.at("array");
+    msgpack_view indexed_array = array.indexed();
+    BOOST_CHECK(!array.is_indexed());
+    BOOST_CHECK(indexed_array.is_indexed());
+    BOOST_REQUIRE_EQUAL(1000, indexed_array.size());
+    for (size_t i = 0; i < 1000; i += 37)
+    {
+        BOOST_CHECK(decode_msgpack<json>(indexed_array.at(i)) == a[i]);
+        BOOST_CHECK_EQUAL(array.at(i).buflen(), indexed_array.at(i).buflen());
+    }
+    BOOST_CHECK_THROW(indexed_array.at(1000), std::out_of_range);
+
+    msgpack_view map = v.at("map").indexed();
+    msgpack_view copy = map;
+    BOOST_CHECK(copy.is_indexed());
+    BOOST_REQUIRE_EQUAL(1000, map.size());
+    for (size_t i = 0; i < 1000; i += 37)
+    {
+        BOOST_CHECK_EQUAL(i, map.at("key" + std::to_string(i)).as<size_t>());
+    }
+    BOOST_CHECK(!map.has_key("key1000"));
+    BOOST_CHECK_THROW(map.at("key1000"), std::runtime_error);
+
+    msgpack_view root = v.indexed();
+    msgpack_view value;
+    jsonpointer::jsonpointer_errc ec;
+    std::tie(value,ec) = jsonpointer::get(root,"/map/key42");
+    BOOST_CHECK_EQUAL(ec,jsonpointer::jsonpointer_errc());
+    BOOST_CHECK_EQUAL(42, value.as<int>());
+    std::tie(value,ec) = jsonpointer::get(root,"/array/999");
+    BOOST_CHECK_EQUAL(ec,jsonpointer::jsonpointer_errc());
+    BOOST_CHECK(value.as<std::string>() == a[999].as<std::string>());
+}
+
+BOOST_AUTO_TEST_CASE(msgpack_view_duplicate_keys_test)
+{
+    // {"a": 1, "b": 2, "a": 3}
+    std::vector<uint8_t> buffer = {0x83,0xa1,'a',0x01,0xa1,'b',0x02,0xa1,'a',0x03};
+    msgpack_view v(buffer);
+    BOOST_CHECK_EQUAL(1, v.at("a").as<int>());
+    BOOST_CHECK_EQUAL(1, v.indexed().at("a").as<int>());
+    BOOST_CHECK_EQUAL(3, v.indexed().size());
+}
+
+BOOST_AUTO_TEST_CASE(msgpack_view_members_test)
+{
+    ojson j = ojson::parse(R"({"b":[1,2],"a":"x","c":{"d":null}})");
+    std::vector<uint8_t> v = encode_msgpack(j);
+
+    for (const msgpack_view& view : {msgpack_view(v), msgpack_view(v).indexed()})
+    {
+        BOOST_REQUIRE_EQUAL(3, view.size());
+        for (size_t i = 0; i < view.size(); ++i)
+        {
+            BOOST_CHECK_EQUAL(j.object_range().begin()[i].key(), view.key(i));
+            BOOST_CHECK(decode_msgpack<ojson>(view.value(i)) == j.object_range().begin()[i].value());
+        }
+        BOOST_CHECK_EQUAL(2, view.value(0).value(1).as<int>());
+        BOOST_CHECK_THROW(view.key(3), std::out_of_range);
+        BOOST_CHECK_THROW(view.value(3), std::out_of_range);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(msgpack_view_jsonpointer_jsonpath_test)
+{
+    json j = json::parse(R"({"a":{"b":[10,11,12,{"id":7}]},"c":[{"id":8},{"id":9,"x":[{"id":10}]}]})");
+    std::vector<uint8_t> buffer = encode_msgpack(j);
+    msgpack_view v(buffer);
+
+    msgpack_view item;
+    jsonpointer::jsonpointer_errc ec;
+    std::tie(item,ec) = jsonpointer::get(v,"/a/b/3/id");
+    BOOST_CHECK_EQUAL(ec,jsonpointer::jsonpointer_errc());
+    BOOST_CHECK_EQUAL(7, item.as<int>());
+
+    for (const char* path : {"$..id", "$.a.b[1:3]", "$.c[?(@.id > 8)].x[*].id", "$..[0]", "$.a.b.length"})
+    {
+        json expected = jsonpath::json_query(j, path);
+        json result = jsonpath::json_query(v, path);
+        BOOST_CHECK_MESSAGE(result == expected, path << ": " << result << " != " << expected);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
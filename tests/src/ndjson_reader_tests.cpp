@@ -0,0 +1,131 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/ndjson_reader.hpp>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(ndjson_reader_tests)
+
+static std::string log_lines(size_t count)
+{
+    std::string text;
+    for (size_t i = 0; i < count; ++i)
+    {
+        text += "{\"seq\":" + std::to_string(i) + ",\"msg\":\"line\\nbreak " + std::to_string(i) + "\",\"tags\":[1,2]}";
+        text += i % 3 == 0 ? "\r\n" : "\n";
+        if (i % 7 == 0)
+        {
+            text += "  \n";
+        }
+    }
+    return text;
+}
+
+BOOST_AUTO_TEST_CASE(test_ndjson_in_order)
+{
+    std::string text = log_lines(1000);
+
+    ndjson_reader<json> serial(text.data(), text.length());
+    std::vector<json> expected = serial.read();
+    BOOST_REQUIRE_EQUAL(1000, expected.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(i, expected[i]["seq"].as<size_t>());
+    }
+
+    for (size_t threads : {size_t(1), size_t(2), size_t(7)})
+    {
+        ndjson_reader<json> reader(text.data(), text.length(),
+                                   ndjson_options().max_threads(threads).batch_size(100));
+        BOOST_CHECK(expected == reader.read());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_ndjson_unordered)
+{
+    std::string text = log_lines(1000);
+    ndjson_reader<json> reader(text.data(), text.length(),
+                               ndjson_options().max_threads(4).batch_size(64).ordered(false));
+    std::vector<json> values = reader.read();
+    BOOST_REQUIRE_EQUAL(1000, values.size());
+
+    std::vector<size_t> seqs;
+    for (const auto& val : values)
+    {
+        seqs.push_back(val["seq"].as<size_t>());
+    }
+    std::sort(seqs.begin(), seqs.end());
+    for (size_t i = 0; i < seqs.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(i, seqs[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_ndjson_error_line)
+{
+    std::string text = log_lines(200);
+    // The 10th text, with three blank lines before it
+    size_t pos = 0;
+    for (size_t i = 0; i < 12; ++i)
+    {
+        pos = text.find('\n', pos) + 1;
+    }
+    text.insert(pos, "{\"bad\":}\n");
+
+    for (size_t threads : {size_t(1), size_t(3)})
+    {
+        for (bool ordered : {true, false})
+        {
+            size_t count = 0;
+            ndjson_reader<json> reader(text.data(), text.length(),
+                                       ndjson_options().max_threads(threads).batch_size(50).ordered(ordered));
+            try
+            {
+                reader.read([&count](json&&){++count;});
+                BOOST_FAIL("Expected parse_error");
+            }
+            catch (const parse_error& e)
+            {
+                BOOST_CHECK_EQUAL(13, e.line_number());
+                BOOST_CHECK_EQUAL(8, e.column_number());
+            }
+            if (ordered)
+            {
+                BOOST_CHECK_EQUAL(10, count);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_ndjson_mapped_file)
+{
+    const char* filename = "ndjson_reader_test.ndjson";
+    std::string text = log_lines(300) + "[\"no line end at the end\"]";
+    {
+        std::ofstream os(filename, std::ios_base::binary);
+        os << text;
+    }
+    std::vector<json> values;
+    {
+        ndjson_reader<json> reader(filename, ndjson_options().max_threads(3).batch_size(1000));
+        BOOST_CHECK(!reader.open_error());
+        values = reader.read();
+    }
+    std::remove(filename);
+    BOOST_REQUIRE_EQUAL(301, values.size());
+    BOOST_CHECK_EQUAL(std::string("no line end at the end"), values.back()[0].as<std::string>());
+
+    ndjson_reader<json> missing("input/no-such-file.ndjson");
+    BOOST_CHECK(missing.open_error());
+    BOOST_CHECK_THROW(missing.read(), parse_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,140 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/ndjson_writer.hpp>
+#include <jsoncons/ndjson_reader.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <list>
+#include <limits>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(ndjson_writer_tests)
+
+static std::vector<json> records(size_t count)
+{
+    std::vector<json> values;
+    for (size_t i = 0; i < count; ++i)
+    {
+        switch (i % 4)
+        {
+            case 0:
+                values.push_back(json::parse("{\"seq\":" + std::to_string(i) + ",\"msg\":\"line\\nbreak\",\"tags\":[1,2]}"));
+                break;
+            case 1:
+                values.push_back(json(i));
+                break;
+            case 2:
+                values.push_back(json::parse("[\"" + std::string(i % 50, 'x') + "\",{\"a\":null},[]]"));
+                break;
+            default:
+                values.push_back(json("text " + std::to_string(i)));
+                break;
+        }
+    }
+    return values;
+}
+
+static std::string expected_text(const std::vector<json>& values)
+{
+    std::string text;
+    for (const auto& val : values)
+    {
+        text += val.to_string();
+        text.push_back('\n');
+    }
+    return text;
+}
+
+BOOST_AUTO_TEST_CASE(test_ndjson_writer)
+{
+    std::vector<json> values = records(1000);
+    std::string expected = expected_text(values);
+
+    std::ostringstream os;
+    {
+        ndjson_writer<json> writer(os);
+        for (const auto& val : values)
+        {
+            writer.write(val);
+        }
+    }
+    BOOST_CHECK_EQUAL(expected, os.str());
+
+    ndjson_reader<json> reader(expected.data(), expected.length());
+    BOOST_CHECK(values == reader.read());
+}
+
+BOOST_AUTO_TEST_CASE(test_ndjson_writer_buffer_length)
+{
+    std::vector<json> values = records(100);
+    std::string expected = expected_text(values);
+
+    std::ostringstream os;
+    ndjson_writer<json> writer(os);
+    writer.write(values[0]);
+    BOOST_CHECK(os.str().empty());
+    writer.flush();
+    BOOST_CHECK_EQUAL(values[0].to_string() + "\n", os.str());
+
+    writer.buffer_length(64);
+    std::list<json> rest(values.begin() + 1, values.end());
+    writer.write(rest.begin(), rest.end());
+    BOOST_CHECK(os.str().size() >= expected.size() - 64);
+    writer.flush();
+    BOOST_CHECK_EQUAL(expected, os.str());
+}
+
+BOOST_AUTO_TEST_CASE(test_ndjson_writer_parallel)
+{
+    std::vector<json> values = records(1000);
+    std::string expected = expected_text(values);
+
+    for (size_t threads : {size_t(1), size_t(2), size_t(7)})
+    {
+        std::ostringstream os;
+        {
+            ndjson_writer<json> writer(os, serialization_options(),
+                                       ndjson_options().max_threads(threads).batch_size(100));
+            writer.write(values.begin(), values.begin() + 1);
+            writer.write(values.begin() + 1, values.end());
+            writer.write(values.end(), values.end());
+        }
+        BOOST_CHECK_EQUAL(expected, os.str());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_ndjson_writer_options)
+{
+    serialization_options options;
+    options.nan_replacement("\"NaN\"");
+    std::vector<json> values = {json(std::numeric_limits<double>::quiet_NaN()), json::parse("[1.5]")};
+
+    std::ostringstream os;
+    {
+        ndjson_writer<json> writer(os, options, ndjson_options().max_threads(2).batch_size(1));
+        writer.write(values.begin(), values.end());
+    }
+    BOOST_CHECK_EQUAL(std::string("\"NaN\"\n[1.5]\n"), os.str());
+}
+
+BOOST_AUTO_TEST_CASE(test_wndjson_writer)
+{
+    std::wostringstream os;
+    {
+        ndjson_writer<wjson> writer(os);
+        writer.write(wjson::parse(L"{\"a\":[1,2]}"));
+        writer.write(wjson(L"b"));
+    }
+    BOOST_CHECK(os.str() == L"{\"a\":[1,2]}\n\"b\"\n");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
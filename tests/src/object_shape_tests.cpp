@@ -0,0 +1,114 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_parser.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/shared_key.hpp>
+#include <sstream>
+#include <string>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(object_shape_tests)
+
+typedef basic_json<char,shared_key_policy,std::allocator<char>> sk_json;
+
+std::string make_records(size_t n)
+{
+    std::ostringstream os;
+    os << "[";
+    for (size_t i = 0; i < n; ++i)
+    {
+        os << (i > 0 ? "," : "") << "{\"id\":" << i << ",\"name\":\"r" << i
+           << "\",\"active\":true,\"owner\":{\"zeta\":1,\"alpha\":" << i << "}}";
+    }
+    os << "]";
+    return os.str();
+}
+
+template <class Json>
+Json decode(json_decoder<Json>& decoder, const std::string& s)
+{
+    json_parser parser(decoder);
+    parser.set_source(s.data(), s.length());
+    parser.parse();
+    parser.end_parse();
+    parser.check_done();
+    return decoder.get_result();
+}
+
+template <class Json>
+Json decode(const std::string& s, bool cache_shapes, size_t* shape_hits = nullptr)
+{
+    json_decoder<Json> decoder;
+    decoder.cache_shapes(cache_shapes);
+    decoder.collect_stats(true);
+    Json result = decode(decoder, s);
+    if (shape_hits != nullptr)
+    {
+        *shape_hits = decoder.stats().shape_hits;
+    }
+    return result;
+}
+
+BOOST_AUTO_TEST_CASE(test_cache_shapes_records)
+{
+    const std::string s = make_records(100);
+
+    // Each depth learns from its first object, the other 99 at each depth hit
+    size_t hits = 0;
+    json j = decode<json>(s, true, &hits);
+    BOOST_CHECK(j == decode<json>(s, false));
+    BOOST_CHECK_EQUAL(198, hits);
+    BOOST_CHECK_EQUAL(std::string("active"), std::string(j[5].object_range().begin()->key()));
+    BOOST_CHECK_EQUAL(5, j[5]["owner"]["alpha"].as<int>());
+
+    ojson o = decode<ojson>(s, true, &hits);
+    BOOST_CHECK_EQUAL(decode<ojson>(s, false).to_string(), o.to_string());
+    BOOST_CHECK_EQUAL(198, hits);
+    BOOST_CHECK_EQUAL(std::string("id"), std::string(o[5].object_range().begin()->key()));
+
+    sk_json k = decode<sk_json>(s, true);
+    BOOST_CHECK(k[1].object_range().begin()->key().data() == k[2].object_range().begin()->key().data());
+}
+
+BOOST_AUTO_TEST_CASE(test_cache_shapes_misses)
+{
+    // Different names, more or fewer members, and duplicate names, which the shape never holds
+    const std::string s = R"([{"a":1,"b":2},{"a":1,"c":2},{"a":1,"c":2},{"a":1},{"a":1,"c":2,"d":3},
+                              {"b":1,"b":2},{"b":1,"b":2},{"a":1,"b":2},{"a":3,"b":4}])";
+    size_t hits = 0;
+    json j = decode<json>(s, true, &hits);
+    BOOST_CHECK(j == decode<json>(s, false));
+    BOOST_CHECK_EQUAL(2, hits);
+    BOOST_CHECK_EQUAL(1, j[5].size());
+    BOOST_CHECK_EQUAL(2, j[6]["b"].as<int>());
+
+    ojson o = decode<ojson>(s, true);
+    BOOST_CHECK_EQUAL(decode<ojson>(s, false).to_string(), o.to_string());
+}
+
+BOOST_AUTO_TEST_CASE(test_cache_shapes_across_texts)
+{
+    json_decoder<json> decoder;
+    decoder.cache_shapes(true);
+    decoder.collect_stats(true);
+    BOOST_CHECK_EQUAL(0, decoder.cached_shape_count());
+
+    decode(decoder, "{\"b\":1,\"a\":{\"c\":2}}");
+    BOOST_CHECK_EQUAL(2, decoder.cached_shape_count());
+    BOOST_CHECK_EQUAL(0, decoder.stats().shape_hits);
+
+    json j = decode(decoder, "{\"b\":3,\"a\":{\"c\":4}}");
+    BOOST_CHECK_EQUAL(2, decoder.stats().shape_hits);
+    BOOST_CHECK(j == json::parse("{\"a\":{\"c\":4},\"b\":3}"));
+
+    decoder.cache_shapes(false);
+    BOOST_CHECK_EQUAL(0, decoder.cached_shape_count());
+    decode(decoder, "{\"b\":3,\"a\":{\"c\":4}}");
+    BOOST_CHECK_EQUAL(0, decoder.stats().shape_hits);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
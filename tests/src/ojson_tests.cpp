@@ -107,5 +107,96 @@ BOOST_AUTO_TEST_CASE(test_object_emplace)
     o.erase("unit_type");
 }
 
+BOOST_AUTO_TEST_CASE(test_large_object_lookup)
+{
+    // Large enough that lookups go through the hash index
+    const size_t n = 200;
+
+    ojson o;
+    for (size_t i = 0; i < n; ++i)
+    {
+        o.insert_or_assign("key" + std::to_string(n - i), i);
+    }
+    BOOST_REQUIRE_EQUAL(n, o.size());
+
+    // Insertion order is preserved
+    size_t count = 0;
+    for (const auto& member : o.object_range())
+    {
+        BOOST_CHECK_EQUAL("key" + std::to_string(n - count), member.key());
+        BOOST_CHECK_EQUAL(count, member.value().as<size_t>());
+        ++count;
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        BOOST_CHECK(o.has_key("key" + std::to_string(n - i)));
+        BOOST_CHECK_EQUAL(i, o.at("key" + std::to_string(n - i)).as<size_t>());
+    }
+    BOOST_CHECK(!o.has_key("key0"));
+    BOOST_CHECK(o.find("key0") == o.object_range().end());
+
+    // Assignment does not add a member
+    o.insert_or_assign("key1", "last");
+    BOOST_CHECK_EQUAL(n, o.size());
+    BOOST_CHECK_EQUAL("last", o["key1"].as<std::string>());
+    BOOST_CHECK_EQUAL("key1", (o.object_range().end()-1)->key());
+
+    // Erasing shifts positions
+    o.erase("key" + std::to_string(n));
+    o.erase("key100");
+    BOOST_CHECK_EQUAL(n - 2, o.size());
+    BOOST_CHECK(!o.has_key("key100"));
+    for (size_t i = 1; i < n; ++i)
+    {
+        if (i != 100)
+        {
+            BOOST_CHECK(o.has_key("key" + std::to_string(i)));
+        }
+    }
+    BOOST_CHECK_EQUAL(1, o.at("key" + std::to_string(n - 1)).as<size_t>());
+
+    // Inserting with a hint
+    auto it = o.insert_or_assign(o.object_range().begin(), "first", "value");
+    BOOST_CHECK_EQUAL("first", it->key());
+    BOOST_CHECK_EQUAL("value", o.at("first").as<std::string>());
+    BOOST_CHECK_EQUAL(1, o.at("key" + std::to_string(n - 1)).as<size_t>());
+
+    ojson copy = o;
+    BOOST_CHECK(copy == o);
+    BOOST_CHECK_EQUAL(1, copy.at("key" + std::to_string(n - 1)).as<size_t>());
+
+    // Shrinking below the threshold falls back to linear search
+    while (o.size() > 3)
+    {
+        o.erase(o.object_range().begin()->key());
+    }
+    BOOST_CHECK_EQUAL(3, o.size());
+    BOOST_CHECK_EQUAL("key2", o.object_range().begin()->key());
+    BOOST_CHECK(o.has_key("key1"));
+    BOOST_CHECK(o.has_key("first"));
+    BOOST_CHECK(!o.has_key("key3"));
+}
+
+BOOST_AUTO_TEST_CASE(test_large_object_parse)
+{
+    std::string s = "{";
+    for (size_t i = 0; i < 100; ++i)
+    {
+        if (i > 0)
+        {
+            s.push_back(',');
+        }
+        s += "\"k" + std::to_string(i) + "\":" + std::to_string(i);
+    }
+    s += ",\"k50\":\"duplicate\"}";
+
+    ojson o = ojson::parse(s);
+    BOOST_CHECK_EQUAL(100, o.size());
+    BOOST_CHECK_EQUAL("duplicate", o["k50"].as<std::string>());
+    BOOST_CHECK_EQUAL(99, o["k99"].as<int>());
+    BOOST_CHECK_EQUAL("k0", o.object_range().begin()->key());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
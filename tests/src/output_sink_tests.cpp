@@ -0,0 +1,190 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_serializer.hpp>
+#include <jsoncons/output_sink.hpp>
+#include <jsoncons_ext/csv/csv_serializer.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <cstdio>
+#include <fstream>
+#include <csignal>
+#include <cerrno>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(output_sink_tests)
+
+// Long enough to fill the serializer's buffer several times, with long strings that are
+// written past the buffer
+json make_document()
+{
+    json j = json::array();
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        json item;
+        item["id"] = i;
+        item["name"] = std::string(i % 100 == 0 ? 20000 : 10, 'a' + static_cast<char>(i % 26));
+        item["value"] = 0.5 * i;
+        j.push_back(std::move(item));
+    }
+    return j;
+}
+
+std::string stream_output(const json& j)
+{
+    std::ostringstream os;
+    j.dump(os);
+    return os.str();
+}
+
+BOOST_AUTO_TEST_CASE(test_string_sink)
+{
+    json j = make_document();
+    const std::string expected = stream_output(j);
+
+    std::string s = "prefix";
+    {
+        string_sink sink(s);
+        json_serializer serializer(sink);
+        j.dump(serializer);
+    }
+    BOOST_CHECK(s == "prefix" + expected);
+
+    std::vector<char> v;
+    {
+        basic_string_sink<std::vector<char>> sink(v);
+        json_serializer serializer(sink);
+        j.dump(serializer);
+    }
+    BOOST_CHECK(std::string(v.begin(), v.end()) == expected);
+
+    BOOST_CHECK(j.to_string() == expected);
+    std::string dumped = "replaced";
+    j.dump(dumped);
+    BOOST_CHECK(dumped == expected);
+}
+
+BOOST_AUTO_TEST_CASE(test_buffer_sink)
+{
+    json j = json::parse("{\"a\":[1,2,3],\"b\":\"text\"}");
+    const std::string expected = stream_output(j);
+
+    char buffer[100];
+    {
+        buffer_sink sink(buffer, sizeof(buffer));
+        {
+            json_serializer serializer(sink);
+            j.dump(serializer);
+        }
+        BOOST_CHECK(!sink.overflow());
+        BOOST_CHECK(std::string(sink.data(), sink.size()) == expected);
+    }
+    {
+        buffer_sink sink(buffer, 5);
+        {
+            json_serializer serializer(sink);
+            j.dump(serializer);
+        }
+        BOOST_CHECK(sink.overflow());
+        BOOST_CHECK(std::string(sink.data(), sink.size()) == expected.substr(0, 5));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_callback_sink)
+{
+    json j = make_document();
+    const std::string expected = stream_output(j);
+
+    std::string s;
+    size_t calls = 0;
+    {
+        callback_sink sink([&](const char* data, size_t length)
+        {
+            s.append(data, length);
+            ++calls;
+        });
+        json_serializer serializer(sink, true);
+        j.dump(serializer);
+    }
+    std::ostringstream os;
+    j.dump(os, true);
+    BOOST_CHECK(s == os.str());
+    BOOST_CHECK(calls > 1);
+}
+
+#if !defined(_WIN32)
+BOOST_AUTO_TEST_CASE(test_fd_sink)
+{
+    json j = make_document();
+    const std::string expected = stream_output(j);
+
+    const char* filename = "fd_sink_test.json";
+    int fd = ::open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    BOOST_REQUIRE(fd != -1);
+    {
+        fd_sink sink(fd);
+        {
+            json_serializer serializer(sink);
+            j.dump(serializer);
+        }
+        BOOST_CHECK(!sink.error());
+    }
+    ::close(fd);
+
+    std::ifstream is(filename, std::ios::binary);
+    std::ostringstream contents;
+    contents << is.rdbuf();
+    is.close();
+    std::remove(filename);
+    BOOST_CHECK(contents.str() == expected);
+}
+
+BOOST_AUTO_TEST_CASE(test_fd_sink_keeps_first_error)
+{
+    int fds[2];
+    BOOST_REQUIRE(::pipe(fds) == 0);
+    ::close(fds[0]);
+    void (*handler)(int) = std::signal(SIGPIPE, SIG_IGN);
+
+    fd_sink sink(fds[1]);
+    sink.write("a", 1);
+    BOOST_CHECK(sink.error() == std::error_code(EPIPE, std::system_category()));
+
+    // Writes after the first error are discarded, and do not replace it
+    ::close(fds[1]);
+    sink.write("b", 1, "c", 1);
+    sink.write("d", 1);
+    BOOST_CHECK(sink.error() == std::error_code(EPIPE, std::system_category()));
+
+    std::signal(SIGPIPE, handler);
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(test_csv_serializer_sink)
+{
+    json j = json::parse("[[\"a\",\"b\"],[1,2]]");
+
+    std::ostringstream os;
+    {
+        csv::csv_serializer serializer(os);
+        j.dump(serializer);
+    }
+
+    std::string s;
+    {
+        string_sink sink(s);
+        csv::csv_serializer serializer(sink);
+        j.dump(serializer);
+    }
+    BOOST_CHECK_EQUAL(os.str(), s);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,129 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/parallel_array_reader.hpp>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(parallel_array_reader_tests)
+
+static std::string records(size_t count)
+{
+    std::string text = "\xEF\xBB\xBF [\n";
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (i > 0)
+        {
+            text += i % 5 == 0 ? ",\n" : ",";
+        }
+        // Commas, brackets and escaped quotes inside strings must not end an element
+        text += "{\"seq\":" + std::to_string(i) + ",\"msg\":\"a, \\\"b\\\" ] } [ \\\\\",\"nested\":[[1,{\"x\":[]}],2]}";
+        if (i % 9 == 0)
+        {
+            text += ",\"str\\\\\"";
+        }
+    }
+    text += "\n]\n";
+    return text;
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_array_same_as_parse)
+{
+    std::string text = records(1000);
+    json expected = json::parse(text);
+
+    for (size_t threads : {size_t(1), size_t(2), size_t(5)})
+    {
+        parallel_array_reader<json> reader(text.data(), text.length(),
+                                           parallel_array_options().max_threads(threads).chunk_size(200));
+        BOOST_CHECK(expected == reader.read());
+    }
+
+    std::vector<json> values;
+    parallel_array_reader<json> reader(text.data(), text.length(),
+                                       parallel_array_options().max_threads(3).chunk_size(1));
+    reader.read([&values](json&& val){values.push_back(std::move(val));});
+    BOOST_REQUIRE_EQUAL(expected.size(), values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        BOOST_CHECK(expected[i] == values[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_array_not_an_array)
+{
+    for (std::string text : {"{\"a\":[1,2]}", "[]", " [1] ", "17"})
+    {
+        parallel_array_reader<json> reader(text.data(), text.length(),
+                                           parallel_array_options().max_threads(4).chunk_size(1));
+        BOOST_CHECK(json::parse(text) == reader.read());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_array_errors)
+{
+    std::string text = records(100);
+    // At the start of line 5, after the 15 records and 2 strings on the lines before it
+    size_t pos = 0;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        pos = text.find('\n', pos) + 1;
+    }
+    text.insert(pos, "{\"bad\":},");
+
+    size_t count = 0;
+    parallel_array_reader<json> reader(text.data(), text.length(),
+                                       parallel_array_options().max_threads(3).chunk_size(100));
+    try
+    {
+        reader.read([&count](json&&){++count;});
+        BOOST_FAIL("Expected parse_error");
+    }
+    catch (const parse_error& e)
+    {
+        BOOST_CHECK_EQUAL(5, e.line_number());
+        BOOST_CHECK_EQUAL(8, e.column_number());
+    }
+    BOOST_CHECK_EQUAL(17, count);
+
+    // Malformed structure is left to the serial parse
+    std::string unbalanced = "[1,2,{\"a\":3]";
+    parallel_array_reader<json> reader2(unbalanced.data(), unbalanced.length(),
+                                        parallel_array_options().max_threads(2).chunk_size(1));
+    BOOST_CHECK_THROW(reader2.read(), parse_error);
+
+    std::string extra_comma = "[1,2,3,]";
+    parallel_array_reader<json> reader3(extra_comma.data(), extra_comma.length(),
+                                        parallel_array_options().max_threads(2).chunk_size(1));
+    BOOST_CHECK_THROW(reader3.read(), parse_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_array_mapped_file)
+{
+    const char* filename = "parallel_array_reader_test.json";
+    std::string text = records(300);
+    {
+        std::ofstream os(filename, std::ios_base::binary);
+        os << text;
+    }
+    json j;
+    {
+        parallel_array_reader<json> reader(filename, parallel_array_options().max_threads(3).chunk_size(1000));
+        BOOST_CHECK(!reader.open_error());
+        j = reader.read();
+    }
+    std::remove(filename);
+    BOOST_CHECK(json::parse(text) == j);
+
+    parallel_array_reader<json> missing("input/no-such-file.json");
+    BOOST_CHECK(missing.open_error());
+    BOOST_CHECK_THROW(missing.read(), parse_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,120 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/parallel_array_writer.hpp>
+#include <jsoncons/detail/parallel_workers.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(parallel_array_writer_tests)
+
+static json records(size_t count)
+{
+    json a = json::array();
+    a.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        json record;
+        record["seq"] = i;
+        record["msg"] = "a \"quoted\", \xC3\xA9 string " + std::to_string(i);
+        record["ratio"] = i / 7.0;
+        record["nested"] = json::array{1, json::array(), json()};
+        a.push_back(std::move(record));
+    }
+    return a;
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_dump_same_as_dump)
+{
+    json a = records(5000);
+    std::vector<serialization_options> all(2);
+    all[1].escape_all_non_ascii(true);
+    all[1].precision(3);
+
+    for (const auto& options : all)
+    {
+        std::ostringstream expected;
+        a.dump(expected, options);
+
+        for (size_t chunk_size : {size_t(1), size_t(100), size_t(10000), parallel_array_options::default_chunk_size})
+        {
+            std::ostringstream os;
+            parallel_dump(a, os, options, parallel_array_options().max_threads(4).chunk_size(chunk_size));
+            BOOST_CHECK_EQUAL(expected.str(), os.str());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_dump_small_and_non_arrays)
+{
+    parallel_array_options parallel = parallel_array_options().max_threads(4).chunk_size(1);
+    for (const json& val : {json(json::array()), json(json::array{1}), json(json::array{1,2,3}), json::parse("{\"a\":[1,2]}"), json("text"), json(10)})
+    {
+        std::ostringstream os;
+        parallel_dump(val, os, parallel);
+        BOOST_CHECK_EQUAL(val.to_string(), os.str());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_encode_cbor_same_as_encode_cbor)
+{
+    for (size_t count : {size_t(0), size_t(5), size_t(17), size_t(300), size_t(70000)})
+    {
+        json a = count == 70000 ? json::make_array(count, 1) : records(count);
+        std::vector<uint8_t> expected;
+        cbor::encode_cbor(a, expected);
+
+        for (size_t chunk_size : {size_t(1), size_t(1000), parallel_array_options::default_chunk_size})
+        {
+            std::vector<uint8_t> v = {0xff};
+            cbor::encode_cbor(a, v, parallel_array_options().max_threads(4).chunk_size(chunk_size));
+            BOOST_REQUIRE_EQUAL(expected.size() + 1, v.size());
+            BOOST_CHECK(std::equal(expected.begin(), expected.end(), v.begin() + 1));
+        }
+    }
+    std::vector<uint8_t> v;
+    cbor::encode_cbor(json("text"), v, parallel_array_options());
+    BOOST_CHECK(cbor::decode_cbor<json>(v) == json("text"));
+}
+
+BOOST_AUTO_TEST_CASE(test_run_ordered)
+{
+    const size_t count = 200;
+    std::vector<size_t> produced(count);
+    std::vector<size_t> consumed;
+    detail::run_ordered(count, 4,
+                        [&](size_t i){produced[i] = i*i;},
+                        [&](size_t i){consumed.push_back(produced[i]); return true;});
+    BOOST_REQUIRE_EQUAL(count, consumed.size());
+    for (size_t i = 0; i < count; ++i)
+    {
+        BOOST_CHECK_EQUAL(i*i, consumed[i]);
+    }
+
+    consumed.clear();
+    detail::run_ordered(count, 4,
+                        [](size_t){},
+                        [&](size_t i){consumed.push_back(i); return i < 9;});
+    BOOST_CHECK_EQUAL(10, consumed.size());
+
+    consumed.clear();
+    BOOST_CHECK_THROW(detail::run_ordered(count, 4,
+                                          [](size_t i){if (i == 50) throw std::runtime_error("produce");},
+                                          [&](size_t i){consumed.push_back(i); return true;}),
+                      std::runtime_error);
+    BOOST_CHECK_EQUAL(50, consumed.size());
+
+    BOOST_CHECK_THROW(detail::run_ordered(count, 4,
+                                          [](size_t){},
+                                          [](size_t i) -> bool {if (i == 3) throw std::runtime_error("consume"); return true;}),
+                      std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
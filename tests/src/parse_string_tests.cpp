@@ -134,6 +134,58 @@ BOOST_AUTO_TEST_CASE(test_parse_big_string2)
     //}
 }
 
-BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_CASE(test_parse_long_string_special_char_offsets)
+{
+    // Place a special character at every offset of a long run of plain characters,
+    // so that it falls inside and across the blocks of the vectorized scan
+    const std::string specials[] = {"\\\"", "\\\\", "\\n", "\\u00e9", "\xc3\xa9"};
+    const std::string expected_specials[] = {"\"", "\\", "\n", "\xc3\xa9", "\xc3\xa9"};
+
+    for (size_t k = 0; k < 5; ++k)
+    {
+        for (size_t i = 0; i < 70; ++i)
+        {
+            std::string plain(70, 'a');
+            std::string input = "\"" + plain.substr(0,i) + specials[k] + plain.substr(i) + "\"";
+            std::string expected = plain.substr(0,i) + expected_specials[k] + plain.substr(i);
+
+            json j = json::parse(input);
+            BOOST_CHECK_EQUAL(expected, j.as<std::string>());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_long_string_buffer_boundaries)
+{
+    std::string plain(100, 'b');
+    std::string input = "[\"" + plain + "\\t" + plain + "\"]";
+
+    for (size_t i = 1; i < input.length(); i += 7)
+    {
+        std::istringstream is(input);
+        json_decoder<json> decoder;
+        json_reader reader(is, decoder);
+        reader.buffer_length(i);
+        reader.read_next();
+        BOOST_REQUIRE(decoder.is_valid());
+        BOOST_CHECK_EQUAL(plain + "\t" + plain, decoder.get_result()[0].as<std::string>());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_long_string_control_character)
+{
+    std::string input = "\"" + std::string(40, 'c') + "\x01" + std::string(40, 'c') + "\"";
 
+    std::error_code ec;
+    try
+    {
+        json::parse(input);
+    }
+    catch (const parse_error& e)
+    {
+        ec = e.code();
+    }
+    BOOST_CHECK(ec == json_parser_errc::illegal_control_character);
+}
 
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,182 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/json_parser.hpp>
+#include <jsoncons/pool_allocator.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(pool_allocator_tests)
+
+typedef basic_json<char,sorted_policy,pool_allocator<char>> pool_json;
+typedef basic_json<char,preserve_order_policy,pool_allocator<char>> pool_ojson;
+
+template <class Json>
+Json make_records(size_t count)
+{
+    Json records = typename Json::array();
+    for (size_t i = 0; i < count; ++i)
+    {
+        Json record;
+        record["id"] = i;
+        record["name"] = "a name that is too long for the short string buffer " + std::to_string(i);
+        record["tags"] = typename Json::array();
+        record["tags"].push_back("x");
+        records.push_back(std::move(record));
+    }
+    return records;
+}
+
+template <class Json>
+std::string to_text(const Json& val)
+{
+    std::ostringstream os;
+    os << val;
+    return os.str();
+}
+
+size_t free_block_count()
+{
+    size_t count = 0;
+    for (size_t i = 0; i < pool_resource::size_class_count; ++i)
+    {
+        count += pool_resource::instance().free_block_count(i);
+    }
+    return count;
+}
+
+BOOST_AUTO_TEST_CASE(test_pool_resource_size_classes)
+{
+    pool_resource& pool = pool_resource::instance();
+
+    void* p1 = pool.allocate(1);
+    void* p2 = pool.allocate(16);
+    void* p3 = pool.allocate(pool_resource::max_pooled_size);
+    void* p4 = pool.allocate(pool_resource::max_pooled_size + 1);
+    BOOST_CHECK_EQUAL(0, reinterpret_cast<uintptr_t>(p1) % pool_resource::granularity);
+    BOOST_CHECK_EQUAL(0, reinterpret_cast<uintptr_t>(p3) % pool_resource::granularity);
+    BOOST_CHECK(p1 != p2);
+    BOOST_CHECK_EQUAL(0, pool_resource::size_class_index(16));
+    BOOST_CHECK_EQUAL(1, pool_resource::size_class_index(17));
+    BOOST_CHECK_EQUAL(pool_resource::size_class_count - 1, pool_resource::size_class_index(pool_resource::max_pooled_size));
+
+    // A freed block is the next one allocated from its class
+    pool.deallocate(p2, 16);
+    BOOST_CHECK(p2 == pool.allocate(9));
+
+    pool.deallocate(p1, 1);
+    pool.deallocate(p2, 9);
+    pool.deallocate(p3, pool_resource::max_pooled_size);
+    pool.deallocate(p4, pool_resource::max_pooled_size + 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_pool_json)
+{
+    pool_json j = pool_json::parse(R"({"name":"a string that is too long for the short string buffer","items":[1,-2,3.5,true,null,{"key":"value"}]})");
+    BOOST_CHECK_EQUAL(std::string("a string that is too long for the short string buffer"), j["name"].as<std::string>());
+    BOOST_CHECK_EQUAL(6, j["items"].size());
+
+    j["items"].erase(j["items"].array_range().begin());
+    j["more"] = pool_json::array{1,2,3};
+    pool_json copy = j;
+    BOOST_CHECK(copy == j);
+    BOOST_CHECK_EQUAL(to_text(j), json::parse(to_text(j)).to_string());
+
+    json_decoder<pool_ojson> decoder;
+    json_parser parser(decoder);
+    std::string s = R"({"b":1,"a":[true,"x"]})";
+    parser.set_source(s.data(), s.length());
+    parser.parse();
+    parser.end_parse();
+    parser.check_done();
+    pool_ojson o = decoder.get_result();
+    BOOST_CHECK_EQUAL(s, to_text(o));
+}
+
+BOOST_AUTO_TEST_CASE(test_pool_reuse)
+{
+    // Building and destroying the same document again takes no more chunks
+    {
+        pool_json records = make_records<pool_json>(1000);
+    }
+    const size_t reserved = pool_resource::instance().bytes_reserved();
+    for (size_t i = 0; i < 10; ++i)
+    {
+        pool_json records = make_records<pool_json>(1000);
+        BOOST_CHECK_EQUAL(1000, records.size());
+    }
+    BOOST_CHECK_EQUAL(reserved, pool_resource::instance().bytes_reserved());
+}
+
+BOOST_AUTO_TEST_CASE(test_pool_cross_thread_free)
+{
+    // Documents built on some threads and destroyed on others
+    const size_t threads = 4;
+    std::vector<pool_json> documents(threads);
+    for (size_t round = 0; round < 5; ++round)
+    {
+        std::vector<std::thread> builders;
+        for (size_t i = 0; i < threads; ++i)
+        {
+            builders.emplace_back([&documents, i]() { documents[i] = make_records<pool_json>(500); });
+        }
+        for (auto& t : builders)
+        {
+            t.join();
+        }
+
+        std::vector<std::thread> destroyers;
+        for (size_t i = 0; i < threads; ++i)
+        {
+            pool_json doc = std::move(documents[(i + 1) % threads]);
+            BOOST_CHECK_EQUAL(500, doc.size());
+            destroyers.emplace_back([](pool_json d)
+            {
+                d.push_back(1);
+                d.resize(10);
+            }, std::move(doc));
+        }
+        for (auto& t : destroyers)
+        {
+            t.join();
+        }
+    }
+
+    // The blocks the exited threads freed are back in the pool, and this thread can give its own
+    const size_t before = free_block_count();
+    BOOST_CHECK(before > 0);
+    {
+        pool_json records = make_records<pool_json>(100);
+    }
+    pool_resource::instance().release_thread_cache();
+    BOOST_CHECK(free_block_count() >= before);
+}
+
+struct thread_local_document
+{
+    pool_json value;
+};
+
+BOOST_AUTO_TEST_CASE(test_pool_free_after_thread_cache)
+{
+    // A thread_local constructed before the thread's cache is destroyed after it, and the
+    // blocks it frees then go to the free lists shared by all threads
+    const size_t before = free_block_count();
+    std::thread t([]()
+    {
+        static thread_local thread_local_document doc;
+        doc.value = make_records<pool_json>(500);
+    });
+    t.join();
+    BOOST_CHECK(free_block_count() >= before);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -10,6 +10,8 @@
 #include <utility>
 #include <ctime>
 #include <cstdint>
+#include <cmath>
+#include <jsoncons/json.hpp>
 
 using boost::numeric::ublas::matrix;
 
@@ -166,6 +168,114 @@ BOOST_AUTO_TEST_CASE(test_pair)
     std::cout << oss.str() << std::endl;
 }
 
+namespace {
+
+// Writes v one element at a time through the DOM, as the encoder did before bulk writes
+template <class T>
+std::string dump_as_json(const T& v, const serialization_options& options)
+{
+    std::ostringstream os;
+    json(v).dump(os, options);
+    return os.str();
+}
+
+template <class T>
+std::string dump_direct(const T& v, const serialization_options& options)
+{
+    std::ostringstream os;
+    dump(v, options, os);
+    return os.str();
+}
+
+template <class T>
+void check_bulk_matches(const T& v)
+{
+    serialization_options compact;
+    BOOST_CHECK_EQUAL(dump_as_json(v, compact), dump_direct(v, compact));
+
+    serialization_options pretty;
+    pretty.indent(4);
+    std::ostringstream os;
+    dump(v, pretty, os, true);
+    std::ostringstream expected;
+    json(v).dump(expected, pretty, true);
+    BOOST_CHECK_EQUAL(expected.str(), os.str());
+
+    serialization_options multi_line;
+    multi_line.array_array_split_lines(line_split_kind::multi_line)
+              .object_array_split_lines(line_split_kind::multi_line);
+    std::ostringstream os2;
+    dump(v, multi_line, os2, true);
+    std::ostringstream expected2;
+    json(v).dump(expected2, multi_line, true);
+    BOOST_CHECK_EQUAL(expected2.str(), os2.str());
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(test_bulk_integer_vectors)
+{
+    std::vector<int> a = {1,-2,3,0,-2147483647-1,2147483647};
+    BOOST_CHECK_EQUAL(std::string("[1,-2,3,0,-2147483648,2147483647]"), dump_direct(a, serialization_options()));
+    check_bulk_matches(a);
+
+    std::vector<long long> b = {(std::numeric_limits<long long>::min)(),(std::numeric_limits<long long>::max)(),-1};
+    BOOST_CHECK_EQUAL(std::string("[-9223372036854775808,9223372036854775807,-1]"), dump_direct(b, serialization_options()));
+    check_bulk_matches(b);
+
+    std::vector<uint64_t> c = {0,(std::numeric_limits<uint64_t>::max)(),10};
+    BOOST_CHECK_EQUAL(std::string("[0,18446744073709551615,10]"), dump_direct(c, serialization_options()));
+    check_bulk_matches(c);
+
+    std::vector<uint16_t> d = {65535,0};
+    check_bulk_matches(d);
+
+    BOOST_CHECK_EQUAL(std::string("[]"), dump_direct(std::vector<int>(), serialization_options()));
+    BOOST_CHECK_EQUAL(std::string("[7]"), dump_direct(std::vector<int>{7}, serialization_options()));
+}
+
+BOOST_AUTO_TEST_CASE(test_bulk_floating_point_vectors)
+{
+    std::vector<double> a = {1.5,-2.25,0,1e300,0.1};
+    check_bulk_matches(a);
+
+    std::vector<float> b = {1.5f,-0.25f,3};
+    check_bulk_matches(b);
+
+    std::array<double,3> c{{1,2,3}};
+    check_bulk_matches(c);
+
+    std::vector<double> d = {1,std::nan(""),-std::numeric_limits<double>::infinity()};
+    serialization_options options;
+    options.nan_replacement("\"NaN\"").neg_inf_replacement("\"-Inf\"");
+    BOOST_CHECK_EQUAL(std::string("[1.0,\"NaN\",\"-Inf\"]"), dump_direct(d, options));
+    BOOST_CHECK_EQUAL(std::string("[1.0,null,null]"), dump_direct(d, serialization_options()));
+}
+
+BOOST_AUTO_TEST_CASE(test_bulk_large_and_nested)
+{
+    // Crosses the serializer's batch and the encoder's chunk boundaries
+    std::vector<int64_t> a;
+    std::vector<double> b;
+    std::vector<uint8_t> c;
+    for (int64_t i = 0; i < 5000; ++i)
+    {
+        a.push_back(i % 3 == 0 ? -i*1000003 : i*1000003);
+        b.push_back(static_cast<double>(i)/7);
+        c.push_back(static_cast<uint8_t>(i));
+    }
+    check_bulk_matches(a);
+    check_bulk_matches(b);
+    check_bulk_matches(c);
+    BOOST_CHECK(json::parse(dump_direct(a, serialization_options())).as<std::vector<int64_t>>() == a);
+
+    std::map<std::string,std::vector<int>> m = {{"a",{1,2,3}},{"b",{}},{"c",{4}}};
+    check_bulk_matches(m);
+
+    std::vector<std::vector<double>> v = {{1,2},{},{3.5}};
+    check_bulk_matches(v);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
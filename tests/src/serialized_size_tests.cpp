@@ -0,0 +1,124 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/msgpack/msgpack.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(serialized_size_tests)
+
+json make_document()
+{
+    json j = json::parse(R"(
+    {
+        "text": "Quotes \" and \\ backslashes, a tab\t, a solidus / and café",
+        "numbers": [0, -1, 18446744073709551615, -9223372036854775808, 0.1, 1e300, -2.5e-7],
+        "literals": [true, false, null],
+        "nested": {"empty": {}, "array": [[]]}
+    }
+    )");
+    j["bytes"] = json(byte_string({'H','e','l','l','o'}));
+    j["long"] = std::string(70000, 'x');
+    return j;
+}
+
+BOOST_AUTO_TEST_CASE(test_serialized_size)
+{
+    json j = make_document();
+
+    BOOST_CHECK_EQUAL(j.to_string().length(), serialized_size(j));
+
+    serialization_options options;
+    options.escape_all_non_ascii(true)
+           .escape_solidus(true);
+    std::ostringstream os;
+    j.dump(os, options);
+    BOOST_CHECK_EQUAL(os.str().length(), serialized_size(j, options));
+}
+
+BOOST_AUTO_TEST_CASE(test_dump_to_buffer)
+{
+    json j = make_document();
+    const std::string expected = j.to_string();
+
+    std::vector<char> buffer(serialized_size(j));
+    size_t length = j.dump(buffer.data(), buffer.size());
+    BOOST_CHECK_EQUAL(expected.length(), length);
+    BOOST_CHECK(std::string(buffer.data(), length) == expected);
+
+    // Too small, the beginning is written and the length needed is returned
+    char small[10];
+    length = j.dump(small, sizeof(small));
+    BOOST_CHECK_EQUAL(expected.length(), length);
+    BOOST_CHECK(std::string(small, sizeof(small)) == expected.substr(0, sizeof(small)));
+
+    length = j["text"].dump(small, sizeof(small));
+    BOOST_CHECK_EQUAL(j["text"].to_string().length(), length);
+}
+
+BOOST_AUTO_TEST_CASE(test_encode_cbor_to_buffer)
+{
+    json j = make_document();
+
+    std::vector<uint8_t> v = cbor::encode_cbor(j);
+    BOOST_CHECK_EQUAL(v.size(), cbor::encoded_cbor_size(j));
+    BOOST_CHECK(cbor::decode_cbor<json>(v) == j);
+
+    std::vector<uint8_t> buffer(v.size());
+    BOOST_CHECK_EQUAL(v.size(), cbor::encode_cbor(j, buffer.data(), buffer.size()));
+    BOOST_CHECK(buffer == v);
+
+    uint8_t small[4] = {0,0,0,0};
+    BOOST_CHECK_EQUAL(v.size(), cbor::encode_cbor(j, small, sizeof(small)));
+    BOOST_CHECK_EQUAL(0, small[0]);
+}
+
+BOOST_AUTO_TEST_CASE(test_encode_msgpack_to_buffer)
+{
+    json j = make_document();
+    j.erase("bytes");
+
+    std::vector<uint8_t> v = msgpack::encode_msgpack(j);
+    BOOST_CHECK_EQUAL(v.size(), msgpack::encoded_msgpack_size(j));
+    BOOST_CHECK(msgpack::decode_msgpack<json>(v) == j);
+
+    std::vector<uint8_t> buffer(v.size());
+    BOOST_CHECK_EQUAL(v.size(), msgpack::encode_msgpack(j, buffer.data(), buffer.size()));
+    BOOST_CHECK(buffer == v);
+}
+
+BOOST_AUTO_TEST_CASE(test_encode_invalid_utf8)
+{
+    json j("\xff\xfe");
+    BOOST_CHECK_THROW(cbor::encode_cbor(j), std::runtime_error);
+    BOOST_CHECK_THROW(msgpack::encode_msgpack(j), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_encode_empty_strings_to_buffer)
+{
+    json j;
+    j[""] = "";
+    j["bytes"] = json(byte_string());
+
+    BOOST_CHECK_EQUAL(j.to_string().length(), j.dump(nullptr, 0));
+
+    std::vector<uint8_t> v = cbor::encode_cbor(j);
+    std::vector<uint8_t> buffer(v.size());
+    BOOST_CHECK_EQUAL(v.size(), cbor::encode_cbor(j, buffer.data(), buffer.size()));
+    BOOST_CHECK(buffer == v);
+    BOOST_CHECK(cbor::decode_cbor<json>(buffer) == j);
+
+    j.erase("bytes");
+    v = msgpack::encode_msgpack(j);
+    buffer.assign(v.size(), 0);
+    BOOST_CHECK_EQUAL(v.size(), msgpack::encode_msgpack(j, buffer.data(), buffer.size()));
+    BOOST_CHECK(buffer == v);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,138 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/json_parser.hpp>
+#include <jsoncons/shared_key.hpp>
+#include <jsoncons/counting_allocator.hpp>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <utility>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(shared_key_tests)
+
+typedef basic_json<char,shared_key_policy,std::allocator<char>> sk_json;
+typedef basic_json<char,preserve_order_shared_key_policy,std::allocator<char>> sk_ojson;
+
+std::string make_records(size_t n)
+{
+    std::ostringstream os;
+    os << "[";
+    for (size_t i = 0; i < n; ++i)
+    {
+        os << (i > 0 ? "," : "") << "{\"identifier\":" << i << ",\"description_of_record\":\"r" << i << "\",\"is_active\":true}";
+    }
+    os << "]";
+    return os.str();
+}
+
+template <class Json>
+Json decode(const std::string& s, bool intern)
+{
+    json_decoder<Json> decoder;
+    decoder.intern_keys(intern);
+    json_parser parser(decoder);
+    parser.set_source(s.data(), s.length());
+    parser.parse();
+    parser.end_parse();
+    parser.check_done();
+    if (intern)
+    {
+        BOOST_CHECK_EQUAL(3, decoder.interned_key_count());
+    }
+    return decoder.get_result();
+}
+
+BOOST_AUTO_TEST_CASE(test_shared_key)
+{
+    shared_key empty;
+    BOOST_CHECK(empty.empty());
+    BOOST_CHECK_EQUAL(std::string(""), std::string(empty.c_str()));
+
+    shared_key a("description_of_record");
+    BOOST_CHECK_EQUAL(1, a.use_count());
+    shared_key b(a);
+    BOOST_CHECK(a.shares_with(b));
+    BOOST_CHECK_EQUAL(2, a.use_count());
+    BOOST_CHECK(a == b);
+
+    shared_key c(std::string("description_of_record"));
+    BOOST_CHECK(!a.shares_with(c));
+    BOOST_CHECK(a == c);
+    BOOST_CHECK_EQUAL(0, a.compare(c));
+    BOOST_CHECK(shared_key("abc") < shared_key("abd"));
+
+    c = b;
+    BOOST_CHECK(c.shares_with(a));
+    BOOST_CHECK_EQUAL(3, a.use_count());
+    shared_key d(std::move(c));
+    BOOST_CHECK(c.empty());
+    BOOST_CHECK_EQUAL(3, a.use_count());
+    d = shared_key("other");
+    BOOST_CHECK_EQUAL(2, a.use_count());
+    BOOST_CHECK_EQUAL(std::string("other"), std::string(d.data(), d.size()));
+}
+
+BOOST_AUTO_TEST_CASE(test_shared_key_allocations)
+{
+    allocation_stats stats;
+    counting_allocator<char> alloc(stats);
+    {
+        typedef basic_shared_key<char,std::char_traits<char>,counting_allocator<char>> counted_key;
+        counted_key a("a name long enough to need the heap", alloc);
+        counted_key b(a);
+        counted_key c(b, alloc);
+        BOOST_CHECK_EQUAL(1, stats.allocations);
+        BOOST_CHECK(c.shares_with(a));
+    }
+    BOOST_CHECK_EQUAL(1, stats.deallocations);
+    BOOST_CHECK_EQUAL(0, stats.bytes_in_use);
+}
+
+BOOST_AUTO_TEST_CASE(test_intern_keys)
+{
+    std::string s = make_records(100);
+
+    sk_json j = decode<sk_json>(s, true);
+    BOOST_REQUIRE_EQUAL(100, j.size());
+    BOOST_CHECK_EQUAL(std::string("r42"), j[42]["description_of_record"].as<std::string>());
+    auto first = j[0].object_range().begin();
+    auto other = j[99].object_range().begin();
+    BOOST_CHECK(first->key().data() == other->key().data());
+
+    // Without interning each member has its own key
+    sk_json k = decode<sk_json>(s, false);
+    BOOST_CHECK(k[0].object_range().begin()->key().data() != k[99].object_range().begin()->key().data());
+    BOOST_CHECK(j == k);
+
+    // Interning with std::basic_string keys copies the interned key
+    json l = decode<json>(s, true);
+    BOOST_CHECK(l == json::parse(s));
+    BOOST_CHECK_EQUAL(j.to_string(), l.to_string());
+
+    sk_ojson o = decode<sk_ojson>(s, true);
+    BOOST_CHECK_EQUAL(ojson::parse(s).to_string(), o.to_string());
+}
+
+BOOST_AUTO_TEST_CASE(test_shared_key_json)
+{
+    sk_json j;
+    j["name"] = "value";
+    j.set("a longer member name that is on the heap", 1);
+    BOOST_CHECK(j.has_key("name"));
+    BOOST_CHECK_EQUAL(1, j["a longer member name that is on the heap"].as<int>());
+
+    sk_json k = j;
+    BOOST_CHECK(k == j);
+    BOOST_CHECK(k.object_range().begin()->key().data() == j.object_range().begin()->key().data());
+    k.erase("name");
+    BOOST_CHECK(j.has_key("name"));
+    BOOST_CHECK(!k.has_key("name"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,151 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/interprocess/shm_json.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+#if !defined(_WIN32)
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace jsoncons;
+using namespace jsoncons::interprocess;
+namespace bip = boost::interprocess;
+
+namespace {
+
+const char* segment_name = "jsoncons_shm_json_tests";
+
+struct segment_remover
+{
+    segment_remover() { bip::shared_memory_object::remove(segment_name); }
+    ~segment_remover() { bip::shared_memory_object::remove(segment_name); }
+};
+
+std::string make_text()
+{
+    json j;
+    j["name"] = "a string that is too long for the short string buffer";
+    j["items"] = json::parse("[1,-2,3.5,true,null,{\"key\":\"value\"},[]]");
+    json wide;
+    for (int i = 0; i < 40; ++i)
+    {
+        wide[std::string("member ") + std::to_string(i)] = i;
+    }
+    j["wide"] = std::move(wide);
+    return j.to_string();
+}
+
+// to_string would return a string allocated in the segment
+template <class Json>
+std::string dump_to_string(const Json& val)
+{
+    std::string s;
+    val.dump(s);
+    return s;
+}
+
+// Reads the documents through a mapping of the segment of its own
+bool check_documents(const std::string& text)
+{
+    bip::managed_shared_memory segment(bip::open_read_only, segment_name);
+    const shm_json* j = segment.find<shm_json>("sorted").first;
+    const shm_ojson* o = segment.find<shm_ojson>("ordered").first;
+    return j != nullptr && o != nullptr &&
+           dump_to_string(*j) == json::parse(text).to_string() &&
+           dump_to_string(*o) == ojson::parse(text).to_string() &&
+           j->at("wide").at("member 37").as<int>() == 37 &&
+           o->at("wide").at("member 37").as<int>() == 37 &&
+           o->at("items").at(5).at("key").as<std::string>() == "value";
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(shm_json_tests)
+
+BOOST_AUTO_TEST_CASE(test_shm_json_other_mapping)
+{
+    segment_remover remover;
+    const std::string text = make_text();
+
+    bip::managed_shared_memory segment(bip::create_only, segment_name, 1 << 20);
+    shm_json* j = construct_parsed<shm_json>(segment, "sorted", text);
+    construct_parsed<shm_ojson>(segment, "ordered", text);
+    BOOST_CHECK_EQUAL(json::parse(text).to_string(), dump_to_string(*j));
+
+    // Values built in place with the segment's allocator
+    shm_allocator allocator(segment.get_segment_manager());
+    shm_json* a = segment.construct<shm_json>("array")(shm_json::array(allocator));
+    a->push_back(10);
+    shm_json o(allocator);
+    o.insert_or_assign("title", "Sayings of the Century");
+    a->push_back(std::move(o));
+
+    // A second mapping is at a different address in this process
+    bip::managed_shared_memory other(bip::open_read_only, segment_name);
+    BOOST_CHECK(other.get_address() != segment.get_address());
+    const shm_json* b = other.find<shm_json>("array").first;
+    BOOST_REQUIRE(b != nullptr);
+    BOOST_CHECK_EQUAL(std::string("[10,{\"title\":\"Sayings of the Century\"}]"), dump_to_string(*b));
+
+    BOOST_CHECK(check_documents(text));
+    BOOST_CHECK_THROW(construct_parsed<shm_json>(segment, "bad", "[1,"), parse_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_shm_json_concurrent_readers)
+{
+    segment_remover remover;
+    const std::string text = make_text();
+
+    bip::managed_shared_memory segment(bip::create_only, segment_name, 1 << 20);
+    construct_parsed<shm_json>(segment, "sorted", text);
+    construct_parsed<shm_ojson>(segment, "ordered", text);
+
+    std::vector<std::thread> threads;
+    std::vector<int> results(4, 0);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        threads.emplace_back([&text,&results,i]()
+        {
+            bool ok = true;
+            for (int k = 0; k < 20; ++k)
+            {
+                ok = check_documents(text) && ok;
+            }
+            results[i] = ok ? 1 : 0;
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    BOOST_CHECK(results == std::vector<int>(results.size(), 1));
+
+#if !defined(_WIN32)
+    // Processes that map the segment read the same documents
+    std::vector<pid_t> children;
+    for (int i = 0; i < 2; ++i)
+    {
+        pid_t pid = ::fork();
+        BOOST_REQUIRE(pid != -1);
+        if (pid == 0)
+        {
+            ::_exit(check_documents(text) ? 0 : 1);
+        }
+        children.push_back(pid);
+    }
+    for (pid_t pid : children)
+    {
+        int status = 0;
+        BOOST_REQUIRE_EQUAL(pid, ::waitpid(pid, &status, 0));
+        BOOST_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END()
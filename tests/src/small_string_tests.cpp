@@ -9,6 +9,7 @@
 #include <jsoncons/json.hpp>
 #include <jsoncons/json_serializer.hpp>
 #include <jsoncons/json_filter.hpp>
+#include <jsoncons/counting_allocator.hpp>
 #include <sstream>
 #include <vector>
 #include <utility>
@@ -36,5 +37,78 @@ BOOST_AUTO_TEST_CASE(test_small_string)
     BOOST_CHECK(q.as<std::string>() == std::string("ABCD"));
 }
 
+BOOST_AUTO_TEST_CASE(test_small_string_max_length)
+{
+    const size_t max_length = json::variant::small_string_data::max_length;
+
+    std::string longest(max_length,'a');
+    json s(longest.c_str());
+    BOOST_CHECK(s.type_id() == jsoncons::json_type_tag::small_string_t);
+    BOOST_CHECK(s.as<std::string>() == longest);
+
+    std::string too_long(max_length+1,'a');
+    json t(too_long.c_str());
+    BOOST_CHECK(t.type_id() == jsoncons::json_type_tag::string_t);
+    BOOST_CHECK(t.as<std::string>() == too_long);
+#if defined(JSONCONS_WIDE_SMALL_STRING)
+    BOOST_CHECK_EQUAL(21, max_length);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(test_long_string)
+{
+    for (size_t length = json::variant::small_string_data::max_length+1; length < 100; ++length)
+    {
+        std::string expected;
+        for (size_t i = 0; i < length; ++i)
+        {
+            expected.push_back(static_cast<char>('a' + i % 26));
+        }
+        json s(expected.data(), expected.length());
+        BOOST_CHECK(s.type_id() == jsoncons::json_type_tag::string_t);
+        BOOST_CHECK(s.as<std::string>() == expected);
+        BOOST_CHECK_EQUAL(expected.length(), std::char_traits<char>::length(s.as_cstring()));
+
+        json t(s);
+        BOOST_CHECK(t.as<std::string>() == expected);
+
+        json u(std::move(t));
+        BOOST_CHECK(u.as<std::string>() == expected);
+        BOOST_CHECK(u == s);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_long_string_single_allocation)
+{
+    typedef basic_json<char,sorted_policy,counting_allocator<char>> counted_json;
+
+    allocation_stats stats;
+    counting_allocator<char> alloc(stats);
+    {
+        std::string expected = "A string that does not fit in a json value";
+        counted_json s(expected.c_str(), alloc);
+        BOOST_CHECK(s.type_id() == jsoncons::json_type_tag::string_t);
+        BOOST_CHECK_EQUAL(1, stats.allocations);
+        BOOST_CHECK(s.as<std::string>() == expected);
+
+        counted_json t(s);
+        BOOST_CHECK_EQUAL(2, stats.allocations);
+        BOOST_CHECK(t.as<std::string>() == expected);
+    }
+    BOOST_CHECK_EQUAL(stats.allocations, stats.deallocations);
+    BOOST_CHECK_EQUAL(0, stats.bytes_in_use);
+}
+
+BOOST_AUTO_TEST_CASE(test_long_wstring)
+{
+    std::wstring expected = L"A wide string that does not fit in a wjson value";
+    wjson s(expected.c_str());
+    BOOST_CHECK(s.type_id() == jsoncons::json_type_tag::string_t);
+    BOOST_CHECK(s.as<std::wstring>() == expected);
+
+    wjson t = s;
+    BOOST_CHECK(t.as<std::wstring>() == expected);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -0,0 +1,125 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <jsoncons/json.hpp>
+#include <jsoncons/frozen_json.hpp>
+#include <jsoncons/static_json.hpp>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(static_json_tests)
+
+#if defined(JSONCONS_HAS_CONSTEXPR_PARSE)
+
+// The words of the tape of a frozen_json, without the snapshot header
+template <class CharT>
+std::vector<uint64_t> frozen_words(const std::basic_string<CharT>& text)
+{
+    std::ostringstream os;
+    basic_frozen_json<CharT>::parse(text).save(os);
+    std::string s = os.str();
+    std::vector<uint64_t> words(s.size()/sizeof(uint64_t) - 4);
+    std::memcpy(words.data(), s.data() + 4*sizeof(uint64_t), words.size()*sizeof(uint64_t));
+    return words;
+}
+
+template <class StaticJson>
+std::vector<uint64_t> static_words(const StaticJson& doc)
+{
+    return std::vector<uint64_t>(doc.data(), doc.data() + doc.word_count());
+}
+
+static constexpr char config_text[] = R"({
+    "name": "service",
+    "port": 8080,
+    "timeout": -30,
+    "ratio": 0.25,
+    "scale": 1.5e3,
+    "tiny": 12e-7,
+    "negative zero": -0.0,
+    "big": 18446744073709551615,
+    "bigger": 1e30,
+    "long": 100000000000000000000000.0e-1,
+    "enabled": true,
+    "disabled": false,
+    "none": null,
+    "escapes": "tab\t quote\" solidus\/ \u00e9 \u20ac \ud83d\ude00",
+    "unicode": "caf\u00e9 é",
+    "tags": ["a", "bb", "ccc", "a long string of more than eight characters"],
+    "nested": {"z": [1, [2, [3]]], "a": {}, "m": [], "ab": 1, "aa": 2, "b": 3, "": 4,
+               "c": 5, "d": 6, "e": 7, "f": 8, "g": 9}
+})";
+
+static constexpr auto config = JSONCONS_STATIC_JSON(config_text);
+
+BOOST_AUTO_TEST_CASE(test_same_tape_as_frozen_json)
+{
+    BOOST_CHECK(static_words(config) == frozen_words(std::string(config_text)));
+
+    constexpr auto scalar = JSONCONS_STATIC_JSON("  \"x\"  ");
+    BOOST_CHECK(static_words(scalar) == frozen_words(std::string("\"x\"")));
+
+    constexpr auto empty = JSONCONS_STATIC_JSON("[]");
+    BOOST_CHECK(static_words(empty) == frozen_words(std::string("[]")));
+}
+
+BOOST_AUTO_TEST_CASE(test_view)
+{
+    frozen_json_view root = config.view();
+    BOOST_CHECK(root.is_object());
+    BOOST_CHECK_EQUAL(std::string("service"), root["name"].as_string());
+    BOOST_CHECK_EQUAL(8080, root["port"].as<int>());
+    BOOST_CHECK_EQUAL(-30, root["timeout"].as_integer());
+    BOOST_CHECK_EQUAL(0.25, root["ratio"].as_double());
+    BOOST_CHECK_EQUAL(1500.0, root["scale"].as_double());
+    BOOST_CHECK_EQUAL(12e-7, root["tiny"].as_double());
+    BOOST_CHECK(root["enabled"].as_bool());
+    BOOST_CHECK(root["none"].is_null());
+    BOOST_CHECK_EQUAL(std::string("caf\xC3\xA9 \xC3\xA9"), root["unicode"].as_string());
+    BOOST_CHECK_EQUAL(4, root["tags"].size());
+    BOOST_CHECK_EQUAL(3, root["nested"]["z"][1][1][0].as<int>());
+    BOOST_CHECK(root["nested"].has_key(""));
+    BOOST_CHECK_EQUAL(9, root["nested"]["g"].as<int>());
+    BOOST_CHECK(!root["nested"].has_key("h"));
+
+    BOOST_CHECK_EQUAL(json::parse(config_text), root.as<json>());
+}
+
+BOOST_AUTO_TEST_CASE(test_wide)
+{
+    constexpr auto doc = JSONCONS_STATIC_JSON(L"{\"b\":[1,\"\\u00e9\\ud83d\\ude00\"],\"a\":\"wide\"}");
+    wfrozen_json_view root = doc.view();
+    BOOST_CHECK(root[L"a"].as_string() == L"wide");
+    BOOST_CHECK(static_words(doc) == frozen_words(std::wstring(L"{\"b\":[1,\"\\u00e9\\ud83d\\ude00\"],\"a\":\"wide\"}")));
+}
+
+BOOST_AUTO_TEST_CASE(test_constant_expressions)
+{
+    static_assert(detail::static_json_words("null") == 1, "");
+    static_assert(detail::static_json_words("[1,2]") == 3 + 4 + 2, "");
+    static_assert(detail::static_json_words("\"123456789\"") == 1 + 2, "");
+    static_assert(config.data()[0] != 0, "");
+}
+
+BOOST_AUTO_TEST_CASE(test_run_time_errors)
+{
+    // Evaluated at run time, the parser throws on text that would not compile
+    BOOST_CHECK_THROW(detail::static_json_words("[1,2"), std::invalid_argument);
+    BOOST_CHECK_THROW(detail::static_json_words("{\"a\" 1}"), std::invalid_argument);
+    BOOST_CHECK_THROW(detail::static_json_words("[01]"), std::invalid_argument);
+    BOOST_CHECK_THROW(detail::static_json_words("\"\\ud83d\""), std::invalid_argument);
+    BOOST_CHECK_THROW(detail::static_json_words("1e400"), std::invalid_argument);
+    BOOST_CHECK_THROW(detail::static_json_words("[1] x"), std::invalid_argument);
+}
+
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -9,6 +9,8 @@
 #include <utility>
 #include <ctime>
 #include <cwchar>
+#include <cstring>
+#include <cstdio>
 
 using namespace jsoncons;
 
@@ -53,5 +55,76 @@ BOOST_AUTO_TEST_CASE(test_exponent)
     //std::cout << std::numeric_limits<double>::max() << std::endl;
 }
 
+BOOST_AUTO_TEST_CASE(test_decimal_to_double)
+{
+    std::vector<std::string> inputs = {
+        "0", "-0", "0.0", "1", "-1", "0.1", "0.3", "1e22", "1e23", "-1.5e-3",
+        "9007199254740993", "9007199254740992.5", "18446744073709551615",
+        "2.2250738585072011e-308", "2.2250738585072014e-308", "4.9406564584124654e-324",
+        "2.4703282292062327e-324", "2.4703282292062328e-324", "1e-400", "1.7976931348623157e308",
+        "1.7976931348623158e308", "1.7976931348623159e308", "1e309", "7.2057594037927933e16",
+        "1.00000000000000011102230246251565404236316680908203125", "0.000000000000000000000000123"
+    };
+    string_to_double to_double;
+    for (const auto& s : inputs)
+    {
+        double expected = std::strtod(s.c_str(), nullptr);
+        double val = to_double(s.c_str(), s.length());
+        BOOST_CHECK_MESSAGE(std::memcmp(&expected, &val, sizeof(double)) == 0, s);
+    }
+
+    double val;
+    BOOST_CHECK(!detail::try_decimal_to_double("1.", 2, val));
+    BOOST_CHECK(!detail::try_decimal_to_double("1e", 2, val));
+    BOOST_CHECK(!detail::try_decimal_to_double("1x", 2, val));
+    BOOST_CHECK(!detail::try_decimal_to_double("-", 1, val));
+    // More than 19 significant digits is left to the caller
+    BOOST_CHECK(!detail::try_decimal_to_double("12345678901234567890", 20, val));
+    BOOST_CHECK(detail::try_decimal_to_double("0.00001234567890123456789", 25, val));
+}
+
+BOOST_AUTO_TEST_CASE(test_decimal_to_double_random)
+{
+    uint64_t state = 88172645463325252ull;
+    char buf[64];
+    for (size_t i = 0; i < 200000; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        int length;
+        if (i % 2 == 0)
+        {
+            // Any double, with enough digits to read back exactly
+            double x;
+            std::memcpy(&x, &state, sizeof(x));
+            if (!(std::isfinite)(x))
+            {
+                continue;
+            }
+            length = std::snprintf(buf, sizeof(buf), "%.17g", x);
+        }
+        else
+        {
+            // Short decimals, most of which are not exact doubles
+            int precision = 2 + static_cast<int>(state % 18);
+            int exponent = static_cast<int>((state >> 8) % 660) - 340;
+            length = std::snprintf(buf, sizeof(buf), "%.*se%d", precision, "1234567890123456789", exponent);
+            std::memmove(buf + 2, buf + 1, length);
+            buf[1] = '.';
+            ++length;
+            buf[0] = static_cast<char>('1' + (state >> 20) % 9);
+        }
+
+        double expected = std::strtod(buf, nullptr);
+        double val;
+        if (detail::try_decimal_to_double(buf, length, val))
+        {
+            BOOST_CHECK_MESSAGE(std::memcmp(&expected, &val, sizeof(double)) == 0, buf);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
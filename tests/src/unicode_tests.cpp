@@ -12,6 +12,9 @@
 #include <utility>
 #include <ctime>
 #include <string>
+#include <random>
+#include <jsoncons/detail/string_scan.hpp>
+#include <jsoncons/json_decoder.hpp>
 
 using namespace jsoncons;
 
@@ -76,5 +79,92 @@ BOOST_AUTO_TEST_CASE( test1 )
     json copy(root);
 }
 #endif
+static bool validates(const std::string& s)
+{
+    return unicons::validate(s.begin(), s.end()).ec == unicons::conv_errc();
+}
+
+BOOST_AUTO_TEST_CASE(test_is_valid_utf8_same_as_validate)
+{
+    // Every one and two byte sequence, and three and four byte sequences around the
+    // boundaries of the lead bytes and continuation ranges, at every offset in a block
+    const uint8_t edges[] = {0x00, 0x7f, 0x80, 0x8f, 0x90, 0x9f, 0xa0, 0xbf, 0xc0, 0xc1, 0xc2, 0xdf,
+                             0xe0, 0xe1, 0xec, 0xed, 0xee, 0xef, 0xf0, 0xf1, 0xf3, 0xf4, 0xf5, 0xff};
+    std::vector<std::string> cases;
+    for (unsigned a = 0; a < 256; ++a)
+    {
+        cases.push_back(std::string(1, static_cast<char>(a)));
+        for (unsigned b = 0; b < 256; ++b)
+        {
+            cases.push_back(std::string{static_cast<char>(a), static_cast<char>(b)});
+        }
+    }
+    for (uint8_t a : edges)
+    {
+        for (uint8_t b : edges)
+        {
+            for (uint8_t c : edges)
+            {
+                cases.push_back(std::string{static_cast<char>(a), static_cast<char>(b), static_cast<char>(c)});
+                for (uint8_t d : {0x41, 0x80, 0xbf, 0xc0})
+                {
+                    cases.push_back(std::string{static_cast<char>(a), static_cast<char>(b), static_cast<char>(c), static_cast<char>(d)});
+                }
+            }
+        }
+    }
+    for (const auto& sequence : cases)
+    {
+        for (size_t offset : {0, 1, 13, 15, 29, 31, 40})
+        {
+            // Valid padding, two byte sequences of U+00E9 and an ASCII letter
+            std::string s(offset % 2, 'a');
+            for (size_t i = 0; i < offset / 2; ++i)
+            {
+                s += "\xc3\xa9";
+            }
+            s += sequence;
+            BOOST_CHECK_EQUAL(validates(s), detail::is_valid_utf8(s.data(), s.length()));
+            std::string t = s + std::string(offset, 'z');
+            BOOST_CHECK_EQUAL(validates(t), detail::is_valid_utf8(t.data(), t.length()));
+        }
+    }
+
+    std::mt19937 gen(2017);
+    std::uniform_int_distribution<int> dist(0, 255);
+    const std::string valid = "\xc3\xa9t\xe2\x82\xac\xf0\x9f\x98\x80 plain text \xed\x9f\xbf\xf4\x8f\xbf\xbf";
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        std::string s;
+        for (size_t j = 0; j < 1 + i % 97; ++j)
+        {
+            s += valid;
+        }
+        BOOST_CHECK(detail::is_valid_utf8(s.data(), s.length()));
+        s[static_cast<size_t>(dist(gen)) % s.length()] = static_cast<char>(dist(gen));
+        BOOST_CHECK_EQUAL(validates(s), detail::is_valid_utf8(s.data(), s.length()));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_invalid_utf8)
+{
+    // Well formed text is validated up front, so strings are checked one at a time only
+    // when the text is not
+    std::string valid = "[\"caf\xc3\xa9\",{\"\xe2\x82\xac\":\"\xf0\x9f\x98\x80\"}]";
+    json j = json::parse(valid);
+    BOOST_CHECK_EQUAL(std::string("caf\xc3\xa9"), j[0].as<std::string>());
+
+    for (std::string bad : {"[\"ab\xc3\"]", "[\"\xed\xa0\x80\"]", "{\"\xc0\xaf\":1}", "[\"\xf4\x90\x80\x80\"]"})
+    {
+        std::error_code ec;
+        json_decoder<json> decoder;
+        json_parser parser(decoder);
+        parser.set_source(bad.data(), bad.length());
+        parser.parse(ec);
+        BOOST_CHECK(ec);
+        BOOST_CHECK_THROW(json::parse(bad), parse_error);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -0,0 +1,301 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_reader.hpp>
+#include <jsoncons/json_serializer.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/input_source.hpp>
+#include <jsoncons/output_sink.hpp>
+#include <jsoncons/detail/utf_transcode.hpp>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(utf_transcode_tests)
+
+// Runs of ASCII longer and shorter than a block, between characters of each length
+std::string make_utf8_text()
+{
+    const char* pieces[] = {"a", "\xC3\xA9", "abcdefghijklmnopqrstuvwxyz", "\xE2\x82\xAC", "0123456789012345",
+                            "\xF0\x9F\x98\x80", "xy", "\xD0\x96\xD0\xB8", "\xF4\x8F\xBF\xBF", "\"quoted\" text"};
+    std::string s;
+    for (size_t i = 0; i < 40; ++i)
+    {
+        s += pieces[(i * 7) % 10];
+        s += std::string(i % 19, 'z');
+    }
+    return s;
+}
+
+// The first length bytes of text, and the rest of the sequence that they end in
+std::string prefix(const std::string& text, size_t length)
+{
+    while (length < text.length() && (static_cast<uint8_t>(text[length]) & 0xC0) == 0x80)
+    {
+        ++length;
+    }
+    return text.substr(0, length);
+}
+
+template <class WCharT>
+void check_round_trip(const std::string& utf8)
+{
+    std::basic_string<WCharT> expected;
+    unicons::convert(utf8.begin(), utf8.end(), std::back_inserter(expected), unicons::conv_flags::strict);
+
+    std::basic_string<WCharT> wide(detail::max_wide_length<WCharT>(utf8.length()), 0);
+    auto result = detail::utf8_to_wide(utf8.data(), utf8.data() + utf8.length(), &wide[0]);
+    BOOST_REQUIRE(result.ec == unicons::conv_errc());
+    BOOST_CHECK(result.it == utf8.data() + utf8.length());
+    wide.resize(result.length);
+    BOOST_CHECK(expected == wide);
+
+    std::string narrow(detail::max_utf8_length<WCharT>(wide.length()), 0);
+    auto result2 = detail::wide_to_utf8(wide.data(), wide.data() + wide.length(), &narrow[0]);
+    BOOST_REQUIRE(result2.ec == unicons::conv_errc());
+    narrow.resize(result2.length);
+    BOOST_CHECK_EQUAL(utf8, narrow);
+}
+
+BOOST_AUTO_TEST_CASE(test_round_trip)
+{
+    std::string text = make_utf8_text();
+    for (size_t length = 0; length <= text.length(); length += 13)
+    {
+        check_round_trip<wchar_t>(prefix(text, length));
+        check_round_trip<char16_t>(prefix(text, length));
+        check_round_trip<char32_t>(prefix(text, length));
+    }
+    check_round_trip<char16_t>(std::string(100, 'q'));
+}
+
+BOOST_AUTO_TEST_CASE(test_invalid_utf8)
+{
+    struct test_case
+    {
+        std::string text;
+        size_t position;
+        unicons::conv_errc ec;
+    };
+    test_case cases[] = {
+        {"abcdefghijklmnopqrstuvwxyz\xE2\x82", 26, unicons::conv_errc::source_exhausted},
+        {"ab\xC3(cd", 2, unicons::conv_errc::expected_continuation_byte},
+        {"ab\xC0\xAF", 2, unicons::conv_errc::source_illegal},
+        {"ab\xED\xA0\x80", 2, unicons::conv_errc::source_illegal},
+        {"ab\xF4\x90\x80\x80", 2, unicons::conv_errc::source_illegal},
+        {"ab\x80", 2, unicons::conv_errc::source_illegal},
+        {"ab\xF8\x88\x80\x80\x80", 2, unicons::conv_errc::over_long_utf8_sequence}
+    };
+    for (const auto& c : cases)
+    {
+        std::u16string wide(c.text.length(), 0);
+        auto result = detail::utf8_to_wide(c.text.data(), c.text.data() + c.text.length(), &wide[0]);
+        BOOST_CHECK(result.ec == c.ec);
+        BOOST_CHECK_EQUAL(c.position, static_cast<size_t>(result.it - c.text.data()));
+        BOOST_CHECK_EQUAL(c.position, result.length);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_invalid_wide)
+{
+    char out[64];
+
+    std::u16string s1 = u"abc\xD83D";
+    auto r1 = detail::wide_to_utf8(s1.data(), s1.data() + s1.length(), out);
+    BOOST_CHECK(r1.ec == unicons::conv_errc::source_exhausted);
+    BOOST_CHECK_EQUAL(3, r1.length);
+
+    std::u16string s2 = u"abc\xD83Dx";
+    auto r2 = detail::wide_to_utf8(s2.data(), s2.data() + s2.length(), out);
+    BOOST_CHECK(r2.ec == unicons::conv_errc::unpaired_high_surrogate);
+
+    std::u16string s3 = u"abc\xDE00";
+    auto r3 = detail::wide_to_utf8(s3.data(), s3.data() + s3.length(), out);
+    BOOST_CHECK(r3.ec == unicons::conv_errc::source_illegal);
+
+    std::u32string s4 = U"abc";
+    s4.push_back(0xD800);
+    auto r4 = detail::wide_to_utf8(s4.data(), s4.data() + s4.length(), out);
+    BOOST_CHECK(r4.ec == unicons::conv_errc::illegal_surrogate_value);
+
+    std::u32string s5 = U"abc";
+    s5.push_back(0x110000);
+    auto r5 = detail::wide_to_utf8(s5.data(), s5.data() + s5.length(), out);
+    BOOST_CHECK(r5.ec == unicons::conv_errc::source_illegal);
+}
+
+// Gives out its text a few bytes at a time, so that sequences are split between reads
+class trickle_source : public input_source
+{
+    std::string text_;
+    size_t pos_;
+    size_t step_;
+public:
+    trickle_source(const std::string& text, size_t step)
+        : text_(text), pos_(0), step_(step)
+    {
+    }
+private:
+    size_t do_read(char* data, size_t length) override
+    {
+        size_t n = (std::min)((std::min)(length, step_), text_.size() - pos_);
+        std::copy(text_.data() + pos_, text_.data() + pos_ + n, data);
+        pos_ += n;
+        return n;
+    }
+    bool do_eof() const override
+    {
+        return pos_ == text_.size();
+    }
+    bool do_fail() const override
+    {
+        return false;
+    }
+};
+
+std::string make_utf8_json()
+{
+    std::string text = make_utf8_text();
+    std::string s = "{\"" + prefix(text, 20) + "\":[";
+    for (size_t i = 0; i < 50; ++i)
+    {
+        if (i > 0)
+        {
+            s.push_back(',');
+        }
+        s += "\"" + prefix(text, (i * 11) % 60) + "\"," + std::to_string(i);
+    }
+    s += "]}";
+    return s;
+}
+
+wjson expected_wjson(const std::string& utf8)
+{
+    json j = json::parse(utf8);
+    std::wstring name;
+    std::string key = j.object_range().begin()->key();
+    unicons::convert(key.begin(), key.end(), std::back_inserter(name), unicons::conv_flags::strict);
+    wjson result = wjson::object();
+    wjson values = wjson::array();
+    for (const auto& item : j[key].array_range())
+    {
+        if (item.is_string())
+        {
+            std::wstring ws;
+            std::string s = item.as<std::string>();
+            unicons::convert(s.begin(), s.end(), std::back_inserter(ws), unicons::conv_flags::strict);
+            values.add(ws);
+        }
+        else
+        {
+            values.add(item.as<int64_t>());
+        }
+    }
+    result.set(name, values);
+    return result;
+}
+
+BOOST_AUTO_TEST_CASE(test_utf8_source)
+{
+    std::string text = make_utf8_json();
+    wjson expected = expected_wjson(text);
+
+    {
+        std::istringstream is(text);
+        wutf8_source source(is);
+        json_decoder<wjson> decoder;
+        wjson_reader reader(source, decoder);
+        reader.read();
+        BOOST_CHECK(expected == decoder.get_result());
+    }
+    for (size_t step : {1, 2, 3, 5, 7, 100})
+    {
+        trickle_source bytes(text, step);
+        wutf8_source source(bytes);
+        json_decoder<wjson> decoder;
+        wjson_reader reader(source, decoder);
+        reader.read();
+        BOOST_CHECK(expected == decoder.get_result());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_utf8_source_error)
+{
+    std::istringstream is("[\"ab\xC3(\"]");
+    wutf8_source source(is);
+    json_decoder<wjson> decoder;
+    wjson_reader reader(source, decoder);
+    std::error_code ec;
+    reader.read(ec);
+    BOOST_CHECK(ec == json_parser_errc::source_error);
+    BOOST_CHECK(source.error() == unicons::conv_errc::expected_continuation_byte);
+
+    std::istringstream is2("[\"ab\xE2\x82");
+    wutf8_source source2(is2);
+    json_decoder<wjson> decoder2;
+    wjson_reader reader2(source2, decoder2);
+    reader2.read(ec);
+    BOOST_CHECK(source2.error() == unicons::conv_errc::source_exhausted);
+}
+
+BOOST_AUTO_TEST_CASE(test_utf8_sink)
+{
+    std::string text = make_utf8_json();
+    wjson j = expected_wjson(text);
+
+    std::string s;
+    {
+        string_sink bytes(s);
+        wutf8_sink sink(bytes);
+        wjson_serializer serializer(sink);
+        j.dump(serializer);
+    }
+    BOOST_CHECK(json::parse(text) == json::parse(s));
+
+    std::ostringstream os;
+    {
+        wutf8_sink sink(os);
+        wjson_serializer serializer(sink);
+        j.dump(serializer);
+    }
+    BOOST_CHECK_EQUAL(s, os.str());
+}
+
+BOOST_AUTO_TEST_CASE(test_utf8_sink_split_surrogates)
+{
+    std::string s;
+    string_sink bytes(s);
+    basic_utf8_sink<char16_t> sink(bytes);
+    std::u16string text = u"a\U0001F600b";
+    sink.write(text.data(), 2);
+    sink.write(text.data() + 2, 2);
+    sink.flush();
+    BOOST_CHECK(!sink.error());
+    BOOST_CHECK_EQUAL(std::string("a\xF0\x9F\x98\x80" "b"), s);
+
+    std::u16string lone = u"\xDE00";
+    sink.write(lone.data(), lone.length());
+    BOOST_CHECK(sink.error() == unicons::conv_errc::source_illegal);
+}
+
+BOOST_AUTO_TEST_CASE(test_utf8_other_input_handler_adapter)
+{
+    std::string text = make_utf8_json();
+    json_decoder<wjson> decoder;
+    json_utf8_other_input_handler_adapter<wchar_t> adapter(decoder);
+    std::istringstream is(text);
+    json_reader reader(is, adapter);
+    reader.read();
+    BOOST_CHECK(expected_wjson(text) == decoder.get_result());
+}
+
+BOOST_AUTO_TEST_SUITE_END()